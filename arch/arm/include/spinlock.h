@@ -70,8 +70,19 @@
 
 /* Spinlock states */
 
-#define SP_UNLOCKED 0  /* The Un-locked state */
-#define SP_LOCKED   1  /* The Locked state */
+#ifdef CONFIG_SPINLOCK_TICKET
+/* A ticket spinlock holds the next ticket to be issued in the upper 16-bits
+ * and the ticket currently being served in the lower 16-bits.  The lock is
+ * free when the two are equal.  SP_LOCKED is the state with one ticket
+ * issued and none served.
+ */
+
+#  define SP_UNLOCKED 0x00000000  /* The Un-locked state */
+#  define SP_LOCKED   0x00010000  /* The Locked state */
+#else
+#  define SP_UNLOCKED 0  /* The Un-locked state */
+#  define SP_LOCKED   1  /* The Locked state */
+#endif
 
 /* Memory barriers for use with NuttX spinlock logic
  *
@@ -118,7 +129,11 @@
  * of SWP and SWPB.
  */
 
+#ifdef CONFIG_SPINLOCK_TICKET
+typedef uint32_t spinlock_t;
+#else
 typedef uint8_t spinlock_t;
+#endif
 
 /****************************************************************************
  * Public Functions
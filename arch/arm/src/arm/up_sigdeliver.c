@@ -91,7 +91,7 @@ void up_sigdeliver(void)
    * EINTR).
    */
 
-  int saved_errno = rtcb->pterrno;
+  int saved_errno = TCB_ERRNO(rtcb);
 
   board_autoled_on(LED_SIGNAL);
 
@@ -128,7 +128,7 @@ void up_sigdeliver(void)
 
   sinfo("Resuming\n");
   (void)up_irq_save();
-  rtcb->pterrno = saved_errno;
+  TCB_ERRNO(rtcb) = saved_errno;
 
   /* Then restore the correct state for this thread of execution. */
 
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_perf.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* PMCR bits */
+
+#define PMCR_E             (1 << 0)  /* Enable all counters */
+#define PMCR_C             (1 << 2)  /* Cycle counter reset */
+#define PMCR_D             (1 << 3)  /* Clock divider (count every 64 cycles) */
+
+/* PMCNTENSET bits */
+
+#define PMCNTENSET_C       (1 << 31) /* Cycle counter enable */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_cpu_freq;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_init
+ *
+ * Description:
+ *   Reset and enable the PMU cycle counter (PMCCNTR).  The argument is the
+ *   frequency of the processor clock in Hz cast to a pointer.
+ *
+ ****************************************************************************/
+
+void up_perf_init(FAR void *arg)
+{
+  uint32_t pmcr;
+
+  g_cpu_freq = (uint32_t)(uintptr_t)arg;
+
+  /* Enable the PMU, count every cycle and reset the cycle counter */
+
+  __asm__ __volatile__
+    (
+      "\tmrc p15, 0, %0, c9, c12, 0\n"   /* PMCR */
+      : "=r" (pmcr)
+      :
+      : "memory"
+    );
+
+  pmcr &= ~PMCR_D;
+  pmcr |= (PMCR_E | PMCR_C);
+
+  __asm__ __volatile__
+    (
+      "\tmcr p15, 0, %0, c9, c12, 0\n"   /* PMCR */
+      "\tmcr p15, 0, %1, c9, c12, 1\n"   /* PMCNTENSET */
+      :
+      : "r" (pmcr), "r" (PMCNTENSET_C)
+      : "memory"
+    );
+}
+
+/****************************************************************************
+ * Name: up_perf_gettime
+ *
+ * Description:
+ *   Return the current value of the free-running PMU cycle counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_gettime(void)
+{
+  uint32_t cycles;
+
+  __asm__ __volatile__
+    (
+      "\tmrc p15, 0, %0, c9, c13, 0\n"   /* PMCCNTR */
+      : "=r" (cycles)
+    );
+
+  return cycles;
+}
+
+/****************************************************************************
+ * Name: up_perf_getfreq
+ *
+ * Description:
+ *   Return the frequency of the cycle counter in Hz.
+ *
+ ****************************************************************************/
+
+uint32_t up_perf_getfreq(void)
+{
+  return g_cpu_freq;
+}
+
+#endif /* CONFIG_ARCH_HAVE_PERF_EVENTS */
@@ -572,6 +572,23 @@
 #define NVIC_SYSHCON_BUSFAULTENA        (1 << 17) /* Bit 17: BusFault enabled */
 #define NVIC_SYSHCON_USGFAULTENA        (1 << 18) /* Bit 18: UsageFault enabled */
 
+/* Configurable fault status register (CFAULTS) */
+
+#define NVIC_CFAULTS_NOCP               (1 << 19) /* Bit 19: Usage fault, no coprocessor */
+
+/* Hard fault status register (HFAULTS) */
+
+#define NVIC_HFAULTS_VECTTBL            (1 << 1)  /* Bit 1:  Vector table read fault */
+#define NVIC_HFAULTS_FORCED             (1 << 30) /* Bit 30: Escalated configurable fault */
+
+/* Coprocessor Access Control Register (CPACR) */
+
+#define NVIC_CPACR_CP_SHIFT(n)          (2 * (n))
+#define NVIC_CPACR_CP_MASK(n)           (3 << NVIC_CPACR_CP_SHIFT(n))
+#  define NVIC_CPACR_CP_DENY(n)         (0 << NVIC_CPACR_CP_SHIFT(n))
+#  define NVIC_CPACR_CP_PRIV(n)         (1 << NVIC_CPACR_CP_SHIFT(n))
+#  define NVIC_CPACR_CP_FULL(n)         (3 << NVIC_CPACR_CP_SHIFT(n))
+
 /* Cache Level ID register (Cortex-M7) */
 
 #define NVIC_CLIDR_L1CT_SHIFT           (0)      /* Bits 0-2: Level 1 cache type */
@@ -47,6 +47,7 @@
 #include <nuttx/board.h>
 #include <arch/board/board.h>
 
+#include "sched/sched.h"
 #include "up_arch.h"
 #include "up_internal.h"
 
@@ -91,6 +92,15 @@ uint32_t *up_doirq(int irq, uint32_t *regs)
    * switch occurred during interrupt processing.
    */
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* Move the stack guard to the thread that we are switching to */
+
+  if (regs != (uint32_t *)CURRENT_REGS)
+    {
+      up_stackguard(this_task());
+    }
+#endif
+
   regs = (uint32_t *)CURRENT_REGS;
 
   /* Restore the previous value of CURRENT_REGS.  NULL would indicate that
@@ -86,6 +86,17 @@ int up_hardfault(int irq, FAR void *context, FAR void *arg)
   uint32_t *regs = (uint32_t *)context;
 #endif
 
+#ifdef CONFIG_ARMV7M_LAZYFPU_TRAP
+  /* A floating point instruction executed by a thread that does not own the
+   * FPU.  Hand over the FPU and restart the instruction.
+   */
+
+  if (up_lazyfpu_trap((uint32_t *)context))
+    {
+      return OK;
+    }
+
+#endif
   /* Get the value of the program counter where the fault occurred */
 
 #ifndef CONFIG_ARMV7M_USEBASEPRI
@@ -0,0 +1,261 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_lazyfpu.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+#include "cache.h"
+#include "nvic.h"
+#include "psr.h"
+#include "up_arch.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7M_LAZYFPU_TRAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The FPU is coprocessors 10 and 11 */
+
+#define CPACR_FPU_MASK   (NVIC_CPACR_CP_MASK(10) | NVIC_CPACR_CP_MASK(11))
+#define CPACR_FPU_ENABLE (NVIC_CPACR_CP_FULL(10) | NVIC_CPACR_CP_FULL(11))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The thread whose floating point registers are currently held in the FPU,
+ * or NULL if no thread owns the FPU.
+ */
+
+static FAR struct tcb_s *g_fpu_owner;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lazyfpu_enable
+ *
+ * Description:
+ *   Enable or disable access to the FPU from the current context.
+ *
+ ****************************************************************************/
+
+static inline void lazyfpu_enable(bool enable)
+{
+  uint32_t regval;
+
+  regval  = getreg32(NVIC_CPACR) & ~CPACR_FPU_MASK;
+  if (enable)
+    {
+      regval |= CPACR_FPU_ENABLE;
+    }
+
+  putreg32(regval, NVIC_CPACR);
+  ARM_DSB();
+  ARM_ISB();
+}
+
+/****************************************************************************
+ * Name: lazyfpu_claim
+ *
+ * Description:
+ *   Give the FPU to 'rtcb':  Save the registers of the previous owner into
+ *   its TCB and load the floating point registers from 'regs'.
+ *
+ ****************************************************************************/
+
+static void lazyfpu_claim(FAR struct tcb_s *rtcb, FAR const uint32_t *regs)
+{
+  lazyfpu_enable(true);
+
+  if (g_fpu_owner != NULL && g_fpu_owner != rtcb)
+    {
+      up_savefpu(g_fpu_owner->xcp.regs);
+    }
+
+  up_restorefpu(regs);
+  g_fpu_owner = rtcb;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_lazyfpu_initialize
+ *
+ * Description:
+ *   The FPU was enabled by the chip start-up logic.  Whatever is in the FPU
+ *   now belongs to the IDLE thread.
+ *
+ ****************************************************************************/
+
+void up_lazyfpu_initialize(void)
+{
+  g_fpu_owner = this_task();
+}
+
+/****************************************************************************
+ * Name: up_lazyfpu_switch
+ *
+ * Description:
+ *   Called on the return path of an exception that switches contexts, after
+ *   this_task() has become the thread that is about to run.  The FPU is
+ *   left enabled only if that thread still owns it.
+ *
+ *   If the context being restored does not lie in the TCB, as when
+ *   up_sigdeliver() returns through up_fullcontextrestore(), then the
+ *   floating point registers in that context must be loaded now.
+ *
+ * Input Parameters:
+ *   regs - The register save area that will be restored.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void up_lazyfpu_switch(FAR const uint32_t *regs)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  if (regs != rtcb->xcp.regs)
+    {
+      lazyfpu_claim(rtcb, regs);
+    }
+  else
+    {
+      lazyfpu_enable(g_fpu_owner == rtcb);
+    }
+}
+
+/****************************************************************************
+ * Name: up_lazyfpu_trap
+ *
+ * Description:
+ *   Called from the hard fault handler.  If the fault is a floating point
+ *   instruction executed by a thread that does not own the FPU, then hand
+ *   the FPU over to the current thread so that the instruction can be
+ *   restarted.
+ *
+ * Input Parameters:
+ *   regs - The register state at the time of the fault.
+ *
+ * Returned Value:
+ *   true if the fault was handled.
+ *
+ ****************************************************************************/
+
+bool up_lazyfpu_trap(FAR uint32_t *regs)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  /* Only the escalated no-coprocessor usage fault from thread mode is ours.
+   * Floating point operations are not permitted in interrupt handlers.
+   */
+
+  if ((getreg32(NVIC_CFAULTS) & NVIC_CFAULTS_NOCP) == 0 ||
+      (regs[REG_XPSR] & ARMV7M_XPSR_ISR_MASK) != 0)
+    {
+      return false;
+    }
+
+  putreg32(NVIC_CFAULTS_NOCP, NVIC_CFAULTS);
+  putreg32(NVIC_HFAULTS_FORCED, NVIC_HFAULTS);
+
+  lazyfpu_claim(rtcb, rtcb->xcp.regs);
+  return true;
+}
+
+/****************************************************************************
+ * Name: up_lazyfpu_save
+ *
+ * Description:
+ *   Save the floating point registers of 'tcb' into 'regs'.  If 'tcb' owns
+ *   the FPU they are taken from the FPU.  Otherwise the copy in the TCB is
+ *   current.
+ *
+ ****************************************************************************/
+
+void up_lazyfpu_save(FAR struct tcb_s *tcb, FAR uint32_t *regs)
+{
+  if (g_fpu_owner == tcb)
+    {
+      up_savefpu(regs);
+    }
+  else if (regs != tcb->xcp.regs)
+    {
+      memcpy(&regs[REG_S0], &tcb->xcp.regs[REG_S0],
+             SW_FPU_REGS * sizeof(uint32_t));
+    }
+}
+
+/****************************************************************************
+ * Name: up_lazyfpu_release
+ *
+ * Description:
+ *   The thread is being deleted.  Forget it if it owns the FPU.
+ *
+ ****************************************************************************/
+
+void up_lazyfpu_release(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags = up_irq_save();
+
+  if (g_fpu_owner == tcb)
+    {
+      g_fpu_owner = NULL;
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_ARMV7M_LAZYFPU_TRAP */
@@ -43,7 +43,9 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/tls.h>
 
+#include "sched/sched.h"
 #include "up_arch.h"
 #include "nvic.h"
 #include "up_internal.h"
@@ -86,6 +88,22 @@ int up_memfault(int irq, FAR void *context, FAR void *arg)
   mfinfo("  IRQ: %d context: %p\n", irq, regs);
   _alert("  CFAULTS: %08x MMFAR: %08x\n",
         getreg32(NVIC_CFAULTS), getreg32(NVIC_MEMMANAGE_ADDR));
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  {
+    uintptr_t mmfar = getreg32(NVIC_MEMMANAGE_ADDR);
+    uintptr_t guard = (uintptr_t)this_task()->stack_alloc_ptr;
+
+#ifdef CONFIG_TLS
+    guard += sizeof(struct tls_info_s);
+#endif
+    guard = STACKGUARD_BASE(guard);
+
+    if (mmfar >= guard && mmfar < guard + CONFIG_ARMV7M_STACKGUARD_SIZE)
+      {
+        _alert("  Stack overflow in PID %d\n", this_task()->pid);
+      }
+  }
+#endif
   mfinfo("  BASEPRI: %08x PRIMASK: %08x IPSR: %08x CONTROL: %08x\n",
          getbasepri(), getprimask(), getipsr(), getcontrol());
   mfinfo("  R0: %08x %08x %08x %08x %08x %08x %08x %08x\n",
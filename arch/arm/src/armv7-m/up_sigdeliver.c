@@ -79,7 +79,7 @@ void up_sigdeliver(void)
    * EINTR).
    */
 
-  int saved_errno = rtcb->pterrno;
+  int saved_errno = TCB_ERRNO(rtcb);
 
   board_autoled_on(LED_SIGNAL);
 
@@ -89,6 +89,11 @@ void up_sigdeliver(void)
 
   /* Save the real return state on the stack. */
 
+#ifdef CONFIG_ARMV7M_LAZYFPU_TRAP
+  /* The FPU registers in the TCB are stale if this thread owns the FPU */
+
+  up_lazyfpu_save(rtcb, rtcb->xcp.regs);
+#endif
   up_copyfullstate(regs, rtcb->xcp.regs);
   regs[REG_PC]         = rtcb->xcp.saved_pc;
 #ifdef CONFIG_ARMV7M_USEBASEPRI
@@ -137,7 +142,7 @@ void up_sigdeliver(void)
   sinfo("Resuming\n");
 
   (void)up_irq_save();
-  rtcb->pterrno = saved_errno;
+  TCB_ERRNO(rtcb) = saved_errno;
 
   /* Then restore the correct state for this thread of
    * execution.
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_stackguard.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/tls.h>
+
+#include "mpu.h"
+#include "up_arch.h"
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_ARMV7M_STACKGUARD_SIZE < 32 || \
+    (CONFIG_ARMV7M_STACKGUARD_SIZE & (CONFIG_ARMV7M_STACKGUARD_SIZE - 1)) != 0
+#  error CONFIG_ARMV7M_STACKGUARD_SIZE must be a power of two >= 32
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The MPU region reserved for the guard of the running thread */
+
+static uint8_t g_guard_region;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_stackguard_initialize
+ *
+ * Description:
+ *   Reserve the MPU region used for the stack guard, protect the stack of
+ *   the IDLE thread and enable the MPU.  This must be called after all
+ *   other MPU regions have been allocated so that the guard region has the
+ *   highest region number and takes priority over the others.
+ *
+ ****************************************************************************/
+
+void up_stackguard_initialize(void)
+{
+  g_guard_region = (uint8_t)mpu_allocregion();
+  up_stackguard(this_task());
+
+  /* Keep the default memory map as the background region for privileged
+   * accesses in case no other regions were configured.
+   */
+
+  mpu_control(true, false, true);
+}
+
+/****************************************************************************
+ * Name: up_stackguard
+ *
+ * Description:
+ *   Move the guard region to the bottom of the stack of the thread that is
+ *   about to run.  Any access to the guard, normally by a stack overflow,
+ *   then causes a memory management fault.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is about to run.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void up_stackguard(FAR struct tcb_s *tcb)
+{
+  uintptr_t base;
+  uintptr_t top;
+  uint32_t  regval;
+  uint8_t   l2size;
+
+  putreg32(g_guard_region, MPU_RNR);
+
+  base = (uintptr_t)tcb->stack_alloc_ptr;
+  top  = base + tcb->adj_stack_size;
+
+#ifdef CONFIG_TLS
+  /* Leave the TLS data at the bottom of the stack accessible */
+
+  base += sizeof(struct tls_info_s);
+#endif
+
+  base = STACKGUARD_BASE(base);
+
+  /* Disable the guard if there is no room for it, such as for a thread
+   * whose stack was provided by the caller and is too small.
+   */
+
+  if (tcb->stack_alloc_ptr == NULL ||
+      base + 2 * CONFIG_ARMV7M_STACKGUARD_SIZE > top)
+    {
+      putreg32(0, MPU_RASR);
+      return;
+    }
+
+  l2size = mpu_log2regionceil(CONFIG_ARMV7M_STACKGUARD_SIZE);
+
+  putreg32((base & MPU_RBAR_ADDR_MASK) | g_guard_region, MPU_RBAR);
+
+  regval = MPU_RASR_ENABLE                              | /* Enable region */
+           MPU_RASR_SIZE_LOG2((uint32_t)l2size)         | /* Region size   */
+           MPU_RASR_XN                                  | /* No execute    */
+           MPU_RASR_AP_NONO;                              /* P:None U:None */
+  putreg32(regval, MPU_RASR);
+}
+
+#endif /* CONFIG_ARMV7M_STACKGUARD */
@@ -52,6 +52,7 @@
 #  include <syscall.h>
 #endif
 
+#include "sched/sched.h"
 #include "svcall.h"
 #include "exc_return.h"
 #include "up_internal.h"
@@ -179,7 +180,9 @@ int up_svcall(int irq, FAR void *context, FAR void *arg)
         {
           DEBUGASSERT(regs[REG_R1] != 0);
           memcpy((uint32_t *)regs[REG_R1], regs, XCPTCONTEXT_SIZE);
-#if defined(CONFIG_ARCH_FPU) && \
+#if defined(CONFIG_ARMV7M_LAZYFPU_TRAP)
+          up_lazyfpu_save(this_task(), (uint32_t *)regs[REG_R1]);
+#elif defined(CONFIG_ARCH_FPU) && \
     (!defined(CONFIG_ARMV7M_CMNVECTOR) || defined(CONFIG_ARMV7M_LAZYFPU))
           up_savefpu((uint32_t *)regs[REG_R1]);
 #endif
@@ -228,7 +231,13 @@ int up_svcall(int irq, FAR void *context, FAR void *arg)
         {
           DEBUGASSERT(regs[REG_R1] != 0 && regs[REG_R2] != 0);
           memcpy((uint32_t *)regs[REG_R1], regs, XCPTCONTEXT_SIZE);
-#if defined(CONFIG_ARCH_FPU) && \
+
+
+          /* With CONFIG_ARMV7M_LAZYFPU_TRAP, the registers of the outgoing
+           * thread stay in the FPU until another thread uses it.
+           */
+
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARMV7M_LAZYFPU_TRAP) && \
     (!defined(CONFIG_ARMV7M_CMNVECTOR) || defined(CONFIG_ARMV7M_LAZYFPU))
           up_savefpu((uint32_t *)regs[REG_R1]);
 #endif
@@ -58,7 +58,7 @@
  * Private Function Prototypes
  ****************************************************************************/
 
-static size_t do_stackcheck(uintptr_t alloc, size_t size);
+static size_t do_stackcheck(uintptr_t alloc, size_t size, FAR size_t *hwm);
 
 /****************************************************************************
  * Name: do_stackcheck
@@ -71,13 +71,15 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size);
  * Input Parameters:
  *   alloc - Allocation base address of the stack
  *   size - The size of the stack in bytes
+ *   hwm - The high-water mark found by the previous check, updated on
+ *     return.  Zero if the stack has not been checked yet.
  *
  * Returned value:
  *   The estimated amount of stack space used.
  *
  ****************************************************************************/
 
-static size_t do_stackcheck(uintptr_t alloc, size_t size)
+static size_t do_stackcheck(uintptr_t alloc, size_t size, FAR size_t *hwm)
 {
   FAR uintptr_t start;
   FAR uintptr_t end;
@@ -94,13 +96,27 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size)
 #ifdef CONFIG_TLS
   /* Skip over the TLS data structure at the bottom of the stack */
 
+#ifdef CONFIG_TLS_ALIGNED
   DEBUGASSERT((alloc & TLS_STACK_MASK) == 0);
+#endif
   start = alloc + sizeof(struct tls_info_s);
 #else
   start = alloc & ~3;
 #endif
   end   = (alloc + size + 3) & ~3;
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* Skip over the MPU guard region.  It cannot be read while the thread is
+   * running.
+   */
+
+  start = STACKGUARD_BASE(start) + CONFIG_ARMV7M_STACKGUARD_SIZE;
+  if (start >= end)
+    {
+      return 0;
+    }
+#endif
+
   /* Get the adjusted size based on the top and bottom of the stack */
 
   size  = end - start;
@@ -111,9 +127,43 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size)
    * that does not have the magic value is the high water mark.
    */
 
-  for (ptr = (FAR uint32_t *)start, mark = (size >> 2);
-       *ptr == STACK_COLOR && mark > 0;
-       ptr++, mark--);
+#if CONFIG_STACK_HWM_WINDOW > 0
+  /* The high-water mark never moves back up, so if we already know it then
+   * we only need to look at the stack below it.  Search downward from the
+   * previous mark and stop once a window of untouched words is found.
+   * This avoids rescanning all of the unused stack on every check.
+   */
+
+  mark = *hwm >> 2;
+  if (mark > 0 && mark <= (size >> 2))
+    {
+      FAR uint32_t *bottom = (FAR uint32_t *)start;
+      size_t nclean = 0;
+
+      ptr = (FAR uint32_t *)end - mark;
+      while (ptr > bottom && nclean < (CONFIG_STACK_HWM_WINDOW >> 2))
+        {
+          ptr--;
+          if (*ptr == STACK_COLOR)
+            {
+              nclean++;
+            }
+          else
+            {
+              mark   = (FAR uint32_t *)end - ptr;
+              nclean = 0;
+            }
+        }
+    }
+  else
+#endif
+    {
+      for (ptr = (FAR uint32_t *)start, mark = (size >> 2);
+           *ptr == STACK_COLOR && mark > 0;
+           ptr++, mark--);
+    }
+
+  *hwm = mark << 2;
 
   /* If the stack is completely used, then this might mean that the stack
    * overflowed from above (meaning that the stack is too small), or may
@@ -181,7 +231,8 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size)
 
 size_t up_check_tcbstack(FAR struct tcb_s *tcb)
 {
-  return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size);
+  return do_stackcheck((uintptr_t)tcb->stack_alloc_ptr, tcb->adj_stack_size,
+                       &tcb->stack_hwm);
 }
 
 ssize_t up_check_tcbstack_remain(FAR struct tcb_s *tcb)
@@ -202,7 +253,10 @@ ssize_t up_check_stack_remain(void)
 #if CONFIG_ARCH_INTERRUPTSTACK > 3
 size_t up_check_intstack(void)
 {
-  return do_stackcheck((uintptr_t)&g_intstackalloc, (CONFIG_ARCH_INTERRUPTSTACK & ~3));
+  static size_t intstack_hwm;
+
+  return do_stackcheck((uintptr_t)&g_intstackalloc,
+                       (CONFIG_ARCH_INTERRUPTSTACK & ~3), &intstack_hwm);
 }
 
 size_t up_check_intstack_remain(void)
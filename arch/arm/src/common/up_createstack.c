@@ -122,11 +122,20 @@
 
 int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 {
+#ifdef CONFIG_ARMV7M_STACKGUARD
+  /* Make room for the MPU guard region at the bottom of the stack.  The
+   * guard must be aligned to its size so it may take up to twice that.
+   */
+
+  stack_size += 2 * CONFIG_ARMV7M_STACKGUARD_SIZE;
+#endif
+
 #ifdef CONFIG_TLS
    /* Add the size of the TLS information structure */
 
    stack_size += sizeof(struct tls_info_s);
 
+#ifdef CONFIG_TLS_ALIGNED
    /* The allocated stack size must not exceed the maximum possible for the
     * TLS feature.
     */
@@ -136,6 +145,7 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
      {
        stack_size = TLS_MAXSTACK;
      }
+#endif
 #endif
 
   /* Is there already a stack allocated of a different size?  Because of
@@ -156,17 +166,18 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
     {
       /* Allocate the stack.  If DEBUG is enabled (but not stack debug),
        * then create a zeroed stack to make stack dumps easier to trace.
-       * If TLS is enabled, then we must allocate aligned stacks.
+       * If TLS_ALIGNED is enabled, then we must allocate aligned stacks.
        */
 
-#ifdef CONFIG_TLS
+#ifdef CONFIG_TLS_ALIGNED
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
           tcb->stack_alloc_ptr =
-            (uint32_t *)kmm_memalign(TLS_STACK_ALIGN, stack_size);
+            (uint32_t *)kmm_memalign_hint(TLS_STACK_ALIGN, stack_size,
+                                          MM_PLACE_STACK);
         }
       else
 #endif
@@ -174,25 +185,28 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
           /* Use the user-space allocator if this is a task or pthread */
 
           tcb->stack_alloc_ptr =
-            (uint32_t *)kumm_memalign(TLS_STACK_ALIGN, stack_size);
+            (uint32_t *)kumm_memalign_hint(TLS_STACK_ALIGN, stack_size,
+                                           MM_PLACE_STACK);
         }
 
-#else /* CONFIG_TLS */
+#else /* CONFIG_TLS_ALIGNED */
 #ifdef HAVE_KERNEL_HEAP
       /* Use the kernel allocator if this is a kernel thread */
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = (uint32_t *)kmm_malloc(stack_size);
+          tcb->stack_alloc_ptr =
+            (uint32_t *)kmm_malloc_hint(stack_size, MM_PLACE_STACK);
         }
       else
 #endif
         {
           /* Use the user-space allocator if this is a task or pthread */
 
-          tcb->stack_alloc_ptr = (uint32_t *)kumm_malloc(stack_size);
+          tcb->stack_alloc_ptr =
+            (uint32_t *)kumm_malloc_hint(stack_size, MM_PLACE_STACK);
         }
-#endif /* CONFIG_TLS */
+#endif /* CONFIG_TLS_ALIGNED */
 
 #ifdef CONFIG_DEBUG_FEATURES
       /* Was the allocation successful? */
@@ -270,6 +284,12 @@ int up_create_stack(FAR struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 #endif /* CONFIG_STACK_COLORATION */
 #endif /* CONFIG_TLS */
 
+#ifdef CONFIG_STACK_COLORATION
+      /* Forget any high-water mark left by a previous stack */
+
+      tcb->stack_hwm = 0;
+#endif
+
       board_autoled_on(LED_STACKCREATED);
       return OK;
     }
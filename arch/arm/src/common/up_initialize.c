@@ -161,6 +161,16 @@ void up_initialize(void)
 
   up_irqinitialize();
 
+  /* Enable the MPU stack guard.  All other MPU regions were set up by the
+   * chip start-up logic before the OS was started.
+   */
+
+  up_stackguard_initialize();
+
+  /* The FPU registers now belong to the IDLE thread */
+
+  up_lazyfpu_initialize();
+
 #ifdef CONFIG_PM
   /* Initialize the power management subsystem.  This MCU-specific function
    * must be called *very* early in the initialization sequence *before* any
@@ -46,6 +46,7 @@
 #  include <nuttx/compiler.h>
 #  include <sys/types.h>
 #  include <stdint.h>
+#  include <stdbool.h>
 #endif
 
 /****************************************************************************
@@ -201,6 +202,16 @@
 #define INTSTACK_COLOR 0xdeadbeef
 #define HEAP_COLOR     'h'
 
+/* The MPU stack guard region sits at the first address above the bottom of
+ * the stack that is aligned to the size of the guard.
+ */
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  define STACKGUARD_BASE(a) \
+     (((uintptr_t)(a) + CONFIG_ARMV7M_STACKGUARD_SIZE - 1) & \
+      ~(uintptr_t)(CONFIG_ARMV7M_STACKGUARD_SIZE - 1))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -460,6 +471,18 @@ void up_restorefpu(const uint32_t *regs);
 #  define up_restorefpu(regs)
 #endif
 
+#ifdef CONFIG_ARMV7M_LAZYFPU_TRAP
+struct tcb_s;
+void up_lazyfpu_initialize(void);
+void up_lazyfpu_switch(FAR const uint32_t *regs);
+bool up_lazyfpu_trap(FAR uint32_t *regs);
+void up_lazyfpu_save(FAR struct tcb_s *tcb, FAR uint32_t *regs);
+void up_lazyfpu_release(FAR struct tcb_s *tcb);
+#else
+#  define up_lazyfpu_initialize()
+#  define up_lazyfpu_release(tcb)
+#endif
+
 /* System timer *************************************************************/
 
 void arm_timer_initialize(void);
@@ -549,6 +572,14 @@ void up_usbuninitialize(void);
 void up_stack_color(FAR void *stackbase, size_t nbytes);
 #endif
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+struct tcb_s;
+void up_stackguard_initialize(void);
+void up_stackguard(FAR struct tcb_s *tcb);
+#else
+# define up_stackguard_initialize()
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -95,6 +95,10 @@
 
 void up_release_stack(FAR struct tcb_s *dtcb, uint8_t ttype)
 {
+  /* The thread is being deleted and can no longer own the FPU */
+
+  up_lazyfpu_release(dtcb);
+
   /* Is there a stack allocated? */
 
   if (dtcb->stack_alloc_ptr)
@@ -105,7 +105,7 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
   size_t top_of_stack;
   size_t size_of_stack;
 
-#ifdef CONFIG_TLS
+#ifdef CONFIG_TLS_ALIGNED
   /* Make certain that the user provided stack is properly aligned */
 
   DEBUGASSERT(((uintptr_t)stack & TLS_STACK_MASK) == 0);
@@ -170,6 +170,8 @@ int up_use_stack(struct tcb_s *tcb, void *stack, size_t stack_size)
 #else
   up_stack_color(tcb->stack_alloc_ptr, tcb->adj_stack_size);
 #endif
+
+  tcb->stack_hwm = 0;
 #endif
 
   return OK;
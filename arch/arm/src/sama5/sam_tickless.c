@@ -87,6 +87,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <arch/board/board.h>
 
 #include "sam_oneshot.h"
 #include "sam_freerun.h"
@@ -297,6 +298,12 @@ void arm_timer_initialize(void)
     }
 
   DEBUGASSERT(FREERUN_INITIALIZED(&g_tickless.freerun));
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  /* Start the free-running cycle counter */
+
+  up_perf_init((FAR void *)BOARD_PCK_FREQUENCY);
+#endif
 }
 
 /****************************************************************************
@@ -151,4 +151,10 @@ void arm_timer_initialize(void)
   /* And enable the timer interrupt */
 
   up_enable_irq(SAM_IRQ_PIT);
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  /* Start the free-running cycle counter */
+
+  up_perf_init((FAR void *)BOARD_PCK_FREQUENCY);
+#endif
 }
@@ -317,7 +317,8 @@ void up_addregion(void)
 
   /* Add the region */
 
-  kumm_addregion((FAR void *)SAM_SDRAMCS_BASE, CONFIG_SAMV7_SDRAMSIZE);
+  kumm_addregion_attr((FAR void *)SAM_SDRAMCS_BASE, CONFIG_SAMV7_SDRAMSIZE,
+                      MM_REGION_SLOW);
 
 #endif /* HAVE_SDRAM_REGION */
 
@@ -328,7 +329,8 @@ void up_addregion(void)
 
   /* Add the region */
 
-  kumm_addregion((FAR void *)SAM_EXTCS0_BASE, CONFIG_SAMV7_EXTSRAM0SIZE);
+  kumm_addregion_attr((FAR void *)SAM_EXTCS0_BASE, CONFIG_SAMV7_EXTSRAM0SIZE,
+                      MM_REGION_SLOW);
 
 #endif /* HAVE_EXTSRAM0_REGION */
 
@@ -339,7 +341,8 @@ void up_addregion(void)
 
   /* Add the region */
 
-  kumm_addregion((FAR void *)SAM_EXTCS1_BASE, CONFIG_SAMV7_EXTSRAM1SIZE);
+  kumm_addregion_attr((FAR void *)SAM_EXTCS1_BASE, CONFIG_SAMV7_EXTSRAM1SIZE,
+                      MM_REGION_SLOW);
 
 #endif /* HAVE_EXTSRAM0_REGION */
 
@@ -350,7 +353,8 @@ void up_addregion(void)
 
   /* Add the region */
 
-  kumm_addregion((FAR void *)SAM_EXTCS2_BASE, CONFIG_SAMV7_EXTSRAM2SIZE);
+  kumm_addregion_attr((FAR void *)SAM_EXTCS2_BASE, CONFIG_SAMV7_EXTSRAM2SIZE,
+                      MM_REGION_SLOW);
 
 #endif /* HAVE_EXTSRAM0_REGION */
 
@@ -361,7 +365,8 @@ void up_addregion(void)
 
   /* Add the region */
 
-  kumm_addregion((FAR void *)SAM_EXTCS3_BASE, CONFIG_SAMV7_EXTSRAM3SIZE);
+  kumm_addregion_attr((FAR void *)SAM_EXTCS3_BASE, CONFIG_SAMV7_EXTSRAM3SIZE,
+                      MM_REGION_SLOW);
 
 #endif /* HAVE_EXTSRAM0_REGION */
 }
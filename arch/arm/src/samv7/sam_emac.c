@@ -69,6 +69,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/dmaheap.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/net/mii.h>
 #include <nuttx/net/arp.h>
@@ -391,6 +392,19 @@
 
 #endif
 
+/* Allocated descriptors and buffers come from the DMA heap, if there is
+ * one, rather than from the general heap.  The DMA heap needs the size of
+ * each allocation when it is freed.
+ */
+
+#ifdef CONFIG_MM_DMAHEAP
+#  define emac_memalign(s)   dmaheap_alloc(s, DMAHEAP_DMA)
+#  define emac_dmafree(p,s)  dmaheap_free(p, s)
+#else
+#  define emac_memalign(s)   kmm_memalign(EMAC_ALIGN, s)
+#  define emac_dmafree(p,s)  kmm_free(p)
+#endif
+
 /* Buffer sizes.
  *
  * RX buffer size if fixed at 128 bytes since fragmented incoming packets
@@ -1167,7 +1181,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   /* Allocate Queue 0 buffers */
 
   allocsize = EMAC_ALIGN_UP(priv->attr->ntxbuffers * sizeof(struct emac_txdesc_s));
-  priv->xfrq[0].txdesc = (struct emac_txdesc_s *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[0].txdesc = (struct emac_txdesc_s *)emac_memalign(allocsize);
   if (!priv->xfrq[0].txdesc)
     {
       nerr("ERROR: Failed to allocate TX descriptors\n");
@@ -1178,7 +1192,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   priv->xfrq[0].ntxbuffers = priv->attr->ntxbuffers;
 
   allocsize = EMAC_ALIGN_UP(priv->attr->nrxbuffers * sizeof(struct emac_rxdesc_s));
-  priv->xfrq[0].rxdesc = (struct emac_rxdesc_s *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[0].rxdesc = (struct emac_rxdesc_s *)emac_memalign(allocsize);
   if (!priv->xfrq[0].rxdesc)
     {
       nerr("ERROR: Failed to allocate RX descriptors\n");
@@ -1190,7 +1204,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   priv->xfrq[0].nrxbuffers = priv->attr->nrxbuffers;
 
   allocsize = priv->attr->ntxbuffers * EMAC_TX_UNITSIZE;
-  priv->xfrq[0].txbuffer = (uint8_t *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[0].txbuffer = (uint8_t *)emac_memalign(allocsize);
   if (!priv->xfrq[0].txbuffer)
     {
       nerr("ERROR: Failed to allocate TX buffer\n");
@@ -1201,7 +1215,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   priv->xfrq[0].txbufsize = EMAC_TX_UNITSIZE;
 
   allocsize = priv->attr->nrxbuffers * EMAC_RX_UNITSIZE;
-  priv->xfrq[0].rxbuffer = (uint8_t *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[0].rxbuffer = (uint8_t *)emac_memalign(allocsize);
   if (!priv->xfrq[0].rxbuffer)
     {
       nerr("ERROR: Failed to allocate RX buffer\n");
@@ -1214,7 +1228,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   /* Allocate Queue 1 buffers */
 
   allocsize = EMAC_ALIGN_UP(DUMMY_NBUFFERS * sizeof(struct emac_txdesc_s));
-  priv->xfrq[1].txdesc = (struct emac_txdesc_s *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[1].txdesc = (struct emac_txdesc_s *)emac_memalign(allocsize);
   if (!priv->xfrq[1].txdesc)
     {
       nerr("ERROR: Failed to allocate TX descriptors\n");
@@ -1225,7 +1239,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   priv->xfrq[1].ntxbuffers = DUMMY_NBUFFERS;
 
   allocsize = EMAC_ALIGN_UP(DUMMY_NBUFFERS * sizeof(struct emac_rxdesc_s));
-  priv->xfrq[1].rxdesc = (struct emac_rxdesc_s *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[1].rxdesc = (struct emac_rxdesc_s *)emac_memalign(allocsize);
   if (!priv->xfrq[1].rxdesc)
     {
       nerr("ERROR: Failed to allocate RX descriptors\n");
@@ -1237,7 +1251,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   priv->xfrq[1].nrxbuffers = DUMMY_NBUFFERS;
 
   allocsize = DUMMY_NBUFFERS * DUMMY_BUFSIZE;
-  priv->xfrq[1].txbuffer = (uint8_t *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[1].txbuffer = (uint8_t *)emac_memalign(allocsize);
   if (!priv->xfrq[1].txbuffer)
     {
       nerr("ERROR: Failed to allocate TX buffer\n");
@@ -1248,7 +1262,7 @@ static int sam_buffer_allocate(struct sam_emac_s *priv)
   priv->xfrq[1].txbufsize = DUMMY_BUFSIZE;
 
   allocsize = DUMMY_NBUFFERS * DUMMY_BUFSIZE;
-  priv->xfrq[1].rxbuffer = (uint8_t *)kmm_memalign(EMAC_ALIGN, allocsize);
+  priv->xfrq[1].rxbuffer = (uint8_t *)emac_memalign(allocsize);
   if (!priv->xfrq[1].rxbuffer)
     {
       nerr("ERROR: Failed to allocate RX buffer\n");
@@ -1323,25 +1337,31 @@ static void sam_buffer_free(struct sam_emac_s *priv)
         {
           if (xfrq->txdesc)
             {
-              kmm_free(xfrq->txdesc);
+              emac_dmafree(xfrq->txdesc,
+                           EMAC_ALIGN_UP(xfrq->ntxbuffers *
+                                         sizeof(struct emac_txdesc_s)));
               xfrq->txdesc = NULL;
             }
 
           if (xfrq->rxdesc)
             {
-              kmm_free(xfrq->rxdesc);
+              emac_dmafree(xfrq->rxdesc,
+                           EMAC_ALIGN_UP(xfrq->nrxbuffers *
+                                         sizeof(struct emac_rxdesc_s)));
               xfrq->rxdesc = NULL;
             }
 
           if (xfrq->txbuffer)
             {
-              kmm_free(xfrq->txbuffer);
+              emac_dmafree(xfrq->txbuffer,
+                           xfrq->ntxbuffers * xfrq->txbufsize);
               xfrq->txbuffer = NULL;
             }
 
           if (xfrq->rxbuffer)
             {
-              kmm_free(xfrq->rxbuffer);
+              emac_dmafree(xfrq->rxbuffer,
+                           xfrq->nrxbuffers * xfrq->rxbufsize);
               xfrq->rxbuffer = NULL;
             }
         }
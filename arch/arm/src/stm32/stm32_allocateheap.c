@@ -679,7 +679,8 @@ void up_addregion(void)
 
   /* Add the STM32F20xxx/STM32F40xxx CCM SRAM user heap region. */
 
-  kumm_addregion((FAR void *)SRAM2_START, SRAM2_END-SRAM2_START);
+  kumm_addregion_attr((FAR void *)SRAM2_START, SRAM2_END-SRAM2_START,
+                      MM_REGION_FAST | MM_REGION_NODMA);
 #endif
 
 #ifdef CONFIG_STM32_FSMC_SRAM
@@ -697,7 +698,8 @@ void up_addregion(void)
 
   /* Add the external FSMC SRAM user heap region. */
 
-  kumm_addregion((FAR void *)CONFIG_HEAP2_BASE, CONFIG_HEAP2_SIZE);
+  kumm_addregion_attr((FAR void *)CONFIG_HEAP2_BASE, CONFIG_HEAP2_SIZE,
+                      MM_REGION_SLOW);
 #endif
 }
 #endif
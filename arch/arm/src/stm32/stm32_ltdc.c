@@ -595,6 +595,19 @@ static int stm32_getvideoinfo(FAR struct fb_vtable_s *vtable,
 static int stm32_getplaneinfo(FAR struct fb_vtable_s *vtable,
                               int planeno, struct fb_planeinfo_s *pinfo);
 
+/* The following are provided only if the DMA2D accelerates the framebuffer
+ * operations
+ */
+
+#ifdef CONFIG_STM32_DMA2D_FBACCEL
+static int stm32_fillarea_fb(FAR struct fb_vtable_s *vtable, int planeno,
+                             FAR const struct fb_area_s *area,
+                             uint32_t color);
+static int stm32_movearea_fb(FAR struct fb_vtable_s *vtable, int planeno,
+                             FAR const struct fb_area_s *area,
+                             fb_coord_t destx, fb_coord_t desty);
+#endif
+
 /* The following is provided only if the video hardware supports RGB color
  * mapping
  */
@@ -692,6 +705,11 @@ static const struct fb_vtable_s g_vtable =
   .getcmap      = stm32_getcmap,
   .putcmap       = stm32_putcmap
 #endif
+#ifdef CONFIG_STM32_DMA2D_FBACCEL
+  ,
+  .fillarea      = stm32_fillarea_fb,
+  .movearea      = stm32_movearea_fb
+#endif
 };
 
 /* The LTDC semaphore that enforces mutually exclusive access */
@@ -2247,6 +2265,118 @@ static int stm32_getplaneinfo(struct fb_vtable_s *vtable, int planeno,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: stm32_fillarea_fb
+ *
+ * Description:
+ *   Fill an area of the framebuffer with a color using the DMA2D
+ *
+ * Parameter:
+ *   vtable  - The framebuffer driver object
+ *   planeno - The color plane (always 0)
+ *   area    - The area to fill
+ *   color   - The color formatted according to the layer pixel format
+ *
+ * Return:
+ *   On success - OK
+ *   On error   - -EINVAL or -ECANCELED
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32_DMA2D_FBACCEL
+static int stm32_fillarea_fb(FAR struct fb_vtable_s *vtable, int planeno,
+                             FAR const struct fb_area_s *area,
+                             uint32_t color)
+{
+#ifdef CONFIG_STM32_LTDC_L2
+  FAR struct stm32_layer_s *layer = &LAYER_L2;
+#else
+  FAR struct stm32_layer_s *layer = &LAYER_L1;
+#endif
+  struct ltdc_area_s darea;
+  int ret;
+
+  if (planeno != 0)
+    {
+      return -EINVAL;
+    }
+
+  darea.xpos = area->x;
+  darea.ypos = area->y;
+  darea.xres = area->w;
+  darea.yres = area->h;
+
+  sem_wait(layer->state.lock);
+  ret = layer->dma2d->fillarea(layer->dma2d, &darea, color);
+  sem_post(layer->state.lock);
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: stm32_movearea_fb
+ *
+ * Description:
+ *   Move an area of the framebuffer using the DMA2D.  The DMA2D copies from
+ *   the top row down, so overlapping moves are performed only if the
+ *   destination is above the source (or to the left of it on the same
+ *   rows); the caller falls back to software for the other cases.
+ *
+ * Parameter:
+ *   vtable  - The framebuffer driver object
+ *   planeno - The color plane (always 0)
+ *   area    - The source area
+ *   destx   - X position of the destination
+ *   desty   - Y position of the destination
+ *
+ * Return:
+ *   On success - OK
+ *   On error   - -EINVAL, -ENOSYS or -ECANCELED
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STM32_DMA2D_FBACCEL
+static int stm32_movearea_fb(FAR struct fb_vtable_s *vtable, int planeno,
+                             FAR const struct fb_area_s *area,
+                             fb_coord_t destx, fb_coord_t desty)
+{
+#ifdef CONFIG_STM32_LTDC_L2
+  FAR struct stm32_layer_s *layer = &LAYER_L2;
+#else
+  FAR struct stm32_layer_s *layer = &LAYER_L1;
+#endif
+  struct ltdc_area_s srcarea;
+  bool overlap;
+  int ret;
+
+  if (planeno != 0)
+    {
+      return -EINVAL;
+    }
+
+  overlap = destx < area->x + area->w && area->x < destx + area->w &&
+            desty < area->y + area->h && area->y < desty + area->h;
+
+  if (overlap && (desty > area->y || (desty == area->y && destx > area->x)))
+    {
+      return -ENOSYS;
+    }
+
+  srcarea.xpos = area->x;
+  srcarea.ypos = area->y;
+  srcarea.xres = area->w;
+  srcarea.yres = area->h;
+
+  sem_wait(layer->state.lock);
+  ret = layer->dma2d->blit(layer->dma2d, destx, desty, layer->dma2d,
+                           &srcarea);
+  sem_post(layer->state.lock);
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: stm32_getcmap
  *
@@ -85,6 +85,7 @@
 #include <assert.h>
 
 #include <nuttx/arch.h>
+#include <arch/board/board.h>
 #include <debug.h>
 
 #include "up_arch.h"
@@ -583,6 +584,12 @@ void arm_timer_initialize(void)
 
   STM32_TIM_ACKINT(g_tickless.tch, 0);
   STM32_TIM_ENABLEINT(g_tickless.tch, 0);
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  /* Start the free-running cycle counter */
+
+  up_perf_init((FAR void *)STM32_HCLK_FREQUENCY);
+#endif
 }
 
 /****************************************************************************
@@ -412,7 +412,8 @@ void up_addregion(void)
 
   /* Add the DTCM user heap region. */
 
-  kumm_addregion((FAR void *)DTCM_START, DTCM_END-DTCM_START);
+  kumm_addregion_attr((FAR void *)DTCM_START, DTCM_END-DTCM_START,
+                      MM_REGION_FAST);
 #endif
 
 #ifdef CONFIG_ARCH_HAVE_HEAP2
@@ -430,7 +431,8 @@ void up_addregion(void)
 
   /* Add the external FMC RAM user heap region. */
 
-  kumm_addregion((FAR void *)CONFIG_HEAP2_BASE, CONFIG_HEAP2_SIZE);
+  kumm_addregion_attr((FAR void *)CONFIG_HEAP2_BASE, CONFIG_HEAP2_SIZE,
+                      MM_REGION_SLOW);
 #endif
 }
 #endif
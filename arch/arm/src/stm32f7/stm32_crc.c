@@ -0,0 +1,144 @@
+/****************************************************************************
+ * arch/arm/src/stm32f7/stm32_crc.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <crc32.h>
+
+#include <nuttx/irq.h>
+
+#include "up_arch.h"
+#include "chip/stm32_crc.h"
+
+#ifdef CONFIG_STM32F7_CRC_LIBC
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32_bitrev32
+ *
+ * Description:
+ *   Reverse the order of the bits in a 32-bit value.
+ *
+ ****************************************************************************/
+
+static inline uint32_t stm32_bitrev32(uint32_t value)
+{
+  uint32_t result;
+
+  __asm__ ("rbit %0, %1" : "=r"(result) : "r"(value));
+  return result;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   Continue CRC calculation on a part of the buffer using the CRC unit.
+ *
+ *   The unit computes the CRC-32 polynomial 0x04c11db7 MSB first.  With the
+ *   input bits reversed and the output reversed, this is the same as the
+ *   reflected (0xedb88320) byte-wise table algorithm of the C library
+ *   where the CRC register holds the bit-reversed running value.  So the
+ *   running value is loaded (reversed) into the INIT register and the
+ *   result read back from DR needs no further adjustment.
+ *
+ *   The unit is shared, so the calculation is done in a critical section.
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  irqstate_t flags;
+  uint32_t cr;
+
+  flags = enter_critical_section();
+
+  /* Load the running value and select the standard polynomial */
+
+  putreg32(CRC_POL_DEFAULT, STM32_CRC_POL);
+  putreg32(stm32_bitrev32(crc32val), STM32_CRC_INIT);
+
+  cr = CRC_CR_POLYSIZE_32 | CRC_CR_REVIN_BYTE | CRC_CR_REVOUT;
+  putreg32(cr | CRC_CR_RESET, STM32_CRC_CR);
+
+  /* Feed single bytes until the source is word aligned */
+
+  for (; len > 0 && ((uintptr_t)src & 3) != 0; len--)
+    {
+      putreg8(*src++, STM32_CRC_DR);
+    }
+
+  /* Then whole words.  A little-endian word with all 32 bits reversed
+   * presents the first byte first (and bit-reversed) to the unit.
+   */
+
+  if (len >= 4)
+    {
+      putreg32((cr & ~CRC_CR_REVIN_MASK) | CRC_CR_REVIN_WORD, STM32_CRC_CR);
+
+      for (; len >= 4; len -= 4, src += 4)
+        {
+          putreg32(*(FAR const uint32_t *)src, STM32_CRC_DR);
+        }
+
+      putreg32(cr, STM32_CRC_CR);
+    }
+
+  /* And any remaining bytes */
+
+  for (; len > 0; len--)
+    {
+      putreg8(*src++, STM32_CRC_DR);
+    }
+
+  crc32val = getreg32(STM32_CRC_DR);
+  leave_critical_section(flags);
+  return crc32val;
+}
+
+#endif /* CONFIG_STM32F7_CRC_LIBC */
@@ -324,6 +324,10 @@ static int      qspi_memory(struct qspi_dev_s *dev,
                   struct qspi_meminfo_s *meminfo);
 static FAR void *qspi_alloc(FAR struct qspi_dev_s *dev, size_t buflen);
 static void     qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer);
+static FAR void *qspi_memmap(FAR struct qspi_dev_s *dev,
+                  FAR const struct qspi_meminfo_s *meminfo);
+static void     qspi_entermemmap(struct stm32l4_qspidev_s *priv,
+                  const struct qspi_meminfo_s *meminfo, uint32_t lpto);
 
 /* Initialization */
 
@@ -345,6 +349,7 @@ static const struct qspi_ops_s g_qspi0ops =
   .memory            = qspi_memory,
   .alloc             = qspi_alloc,
   .free              = qspi_free,
+  .memmap            = qspi_memmap,
 };
 
 /* This is the overall state of the QSPI0 controller */
@@ -2318,6 +2323,125 @@ static void qspi_free(FAR struct qspi_dev_s *dev, FAR void *buffer)
     }
 }
 
+/****************************************************************************
+ * Name: qspi_entermemmap
+ *
+ * Description:
+ *   Put the QSPI device into memory mapped mode.  The caller holds the lock.
+ *
+ * Input Parameters:
+ *   priv    - Device state structure.
+ *   meminfo - parameters like for a memory transfer used for reading
+ *   lpto    - number of cycles to wait to automatically de-assert CS
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void qspi_entermemmap(struct stm32l4_qspidev_s *priv,
+                             const struct qspi_meminfo_s *meminfo,
+                             uint32_t lpto)
+{
+  uint32_t regval;
+  struct qspi_xctnspec_s xctn;
+
+  if (priv->memmap)
+    {
+      return;
+    }
+
+  /* Abort anything in-progress */
+
+  qspi_abort(priv);
+
+  /* Wait till BUSY flag reset */
+
+  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
+
+  /* if we want the 'low-power timeout counter' */
+
+  if (lpto > 0)
+    {
+      /* Set the Low Power Timeout value (automatically de-assert
+       * CS if memory is not accessed for a while)
+       */
+
+      qspi_putreg(priv, lpto, STM32L4_QUADSPI_LPTR_OFFSET);
+
+      /* Clear Timeout interrupt */
+
+      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32L4_QUADSPI_FCR);
+
+#ifdef STM32L4_QSPI_INTERRUPTS
+      /* Enable Timeout interrupt */
+
+      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
+      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
+      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
+#endif
+    }
+  else
+    {
+      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
+      regval &= ~QSPI_CR_TCEN;
+      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
+    }
+
+  /* create a transaction object */
+
+  qspi_setupxctnfrommem(&xctn, meminfo);
+
+#ifdef STM32L4_QSPI_INTERRUPTS
+  priv->xctn = NULL;
+#endif
+
+  /* set it into the ccr */
+
+  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
+  priv->memmap = true;
+
+  /* we should be in memory mapped mode now */
+
+  qspi_dumpregs(priv, "After memory mapped:");
+}
+
+/****************************************************************************
+ * Name: qspi_memmap
+ *
+ * Description:
+ *   Enter or leave memory mapped mode
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - The read command to use in memory mapped mode, or NULL to
+ *             leave memory mapped mode.
+ *
+ * Returned Value:
+ *   The address of the QUADSPI bank on entry, NULL on exit.
+ *
+ ****************************************************************************/
+
+static FAR void *qspi_memmap(FAR struct qspi_dev_s *dev,
+                             FAR const struct qspi_meminfo_s *meminfo)
+{
+  struct stm32l4_qspidev_s *priv = (struct stm32l4_qspidev_s *)dev;
+
+  /* The caller holds the lock */
+
+  if (meminfo == NULL)
+    {
+      /* A simple abort is sufficient */
+
+      qspi_abort(priv);
+      priv->memmap = false;
+      return NULL;
+    }
+
+  qspi_entermemmap(priv, meminfo, 0);
+  return (FAR void *)STM32L4_QSPI_BANK;
+}
+
 /****************************************************************************
  * Name: qspi_hw_initialize
  *
@@ -2603,73 +2727,10 @@ void stm32l4_qspi_enter_memorymapped(struct qspi_dev_s* dev,
                                      const struct qspi_meminfo_s *meminfo,
                                      uint32_t lpto)
 {
-  struct stm32l4_qspidev_s *priv = (struct stm32l4_qspidev_s *)dev;
-  uint32_t regval;
-  struct qspi_xctnspec_s xctn;
-
   /* lock during this mode change */
 
   qspi_lock(dev, true);
-
-  if (priv->memmap)
-    {
-      qspi_lock(dev, false);
-      return;
-    }
-
-  /* Abort anything in-progress */
-
-  qspi_abort(priv);
-
-  /* Wait till BUSY flag reset */
-
-  qspi_waitstatusflags(priv, QSPI_SR_BUSY, 0);
-
-  /* if we want the 'low-power timeout counter' */
-
-  if (lpto > 0)
-    {
-      /* Set the Low Power Timeout value (automatically de-assert
-       * CS if memory is not accessed for a while)
-       */
-
-      qspi_putreg(priv, lpto, STM32L4_QUADSPI_LPTR_OFFSET);
-
-      /* Clear Timeout interrupt */
-
-      qspi_putreg(&g_qspi0dev, QSPI_FCR_CTOF, STM32L4_QUADSPI_FCR);
-
-#ifdef STM32L4_QSPI_INTERRUPTS
-      /* Enable Timeout interrupt */
-
-      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
-      regval |= (QSPI_CR_TCEN | QSPI_CR_TOIE);
-      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
-#endif
-    }
-  else
-    {
-      regval  = qspi_getreg(priv, STM32L4_QUADSPI_CR_OFFSET);
-      regval &= ~QSPI_CR_TCEN;
-      qspi_putreg(priv, regval, STM32L4_QUADSPI_CR_OFFSET);
-    }
-
-  /* create a transaction object */
-
-  qspi_setupxctnfrommem(&xctn, meminfo);
-
-#ifdef STM32L4_QSPI_INTERRUPTS
-  priv->xctn = NULL;
-#endif
-
-  /* set it into the ccr */
-
-  qspi_ccrconfig(priv, &xctn, CCR_FMODE_MEMMAP);
-  priv->memmap = true;
-
-  /* we should be in memory mapped mode now */
-
-  qspi_dumpregs(priv, "After memory mapped:");
+  qspi_entermemmap((struct stm32l4_qspidev_s *)dev, meminfo, lpto);
 
   /* finished this mode change */
 
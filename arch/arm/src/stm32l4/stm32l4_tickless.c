@@ -87,6 +87,7 @@
 #include <stdbool.h>
 
 #include <nuttx/arch.h>
+#include <arch/board/board.h>
 #include <debug.h>
 
 #include "stm32l4_oneshot.h"
@@ -238,6 +239,12 @@ void arm_timer_initialize(void)
       tmrerr("ERROR: stm32l4_freerun_initialize failed\n");
       PANIC();
     }
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  /* Start the free-running cycle counter */
+
+  up_perf_init((FAR void *)STM32L4_HCLK_FREQUENCY);
+#endif
 }
 
 /****************************************************************************
@@ -158,5 +158,11 @@ void arm_timer_initialize(void)
   /* And enable the timer interrupt */
 
   up_enable_irq(STM32L4_IRQ_SYSTICK);
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  /* Start the free-running cycle counter */
+
+  up_perf_init((FAR void *)STM32L4_HCLK_FREQUENCY);
+#endif
 }
 
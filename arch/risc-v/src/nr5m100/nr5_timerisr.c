@@ -155,5 +155,11 @@ void riscv_timer_initialize(void)
   /* And enable the timer interrupt */
 
   up_enable_irq(NR5_IRQ_SYSTICK);
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  /* Start the free-running cycle counter */
+
+  up_perf_init((FAR void *)NR5_HCLK_FREQUENCY);
+#endif
 }
 
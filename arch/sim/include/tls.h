@@ -45,7 +45,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/tls.h>
 
-#ifdef CONFIG_TLS
+#ifdef CONFIG_TLS_ALIGNED
 
 /****************************************************************************
  * Inline Functions
@@ -56,8 +56,8 @@
  *
  * Description:
  *   Return the TLS information structure for the currently executing thread.
- *   When TLS is enabled, up_createstack() will align allocated stacks to
- *   the TLS_STACK_ALIGN value.  An instance of the following structure will
+ *   When CONFIG_TLS_ALIGNED is enabled, up_createstack() will align
+ *   allocated stacks to the TLS_STACK_ALIGN value.  An instance of the following structure will
  *   be implicitly positioned at the "lower" end of the stack.  Assuming a
  *   "push down" stack, this is at the "far" end of the stack (and can be
  *   clobbered if the stack overflows).
@@ -84,5 +84,5 @@ static inline FAR struct tls_info_s *up_tls_info(void)
   return TLS_INFO((uintptr_t)__builtin_frame_address(0));
 }
 
-#endif /* CONFIG_TLS */
+#endif /* CONFIG_TLS_ALIGNED */
 #endif /* __ARCH_SIM_INCLUDE_TLS_H */
@@ -83,6 +83,17 @@
 #  error "Unsupported BPP"
 #endif
 
+/* Number of screen buffers in the framebuffer memory */
+
+#ifdef CONFIG_FB_PANDISPLAY
+#  ifndef CONFIG_FB_NBUFFERS
+#    define CONFIG_FB_NBUFFERS 2
+#  endif
+#  define FB_NBUFFERS CONFIG_FB_NBUFFERS
+#else
+#  define FB_NBUFFERS 1
+#endif
+
 /* Framebuffer characteristics in bytes */
 
 #define FB_WIDTH ((CONFIG_SIM_FBWIDTH * CONFIG_SIM_FBBPP + 7) / 8)
@@ -112,6 +123,13 @@ static int up_getcursor(FAR struct fb_vtable_s *vtable, FAR struct fb_cursorattr
 static int up_setcursor(FAR struct fb_vtable_s *vtable, FAR struct fb_setcursor_s *setttings);
 #endif
 
+  /* The following is provided only if page flipping is supported */
+
+#ifdef CONFIG_FB_PANDISPLAY
+static int up_pandisplay(FAR struct fb_vtable_s *vtable, int planeno,
+                         FAR const struct fb_planeinfo_s *pinfo);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -119,7 +137,7 @@ static int up_setcursor(FAR struct fb_vtable_s *vtable, FAR struct fb_setcursor_
 /* The simulated framebuffer memory */
 
 #ifndef CONFIG_SIM_X11FB
-static uint8_t g_fb[FB_SIZE];
+static uint8_t g_fb[FB_SIZE * FB_NBUFFERS];
 #endif
 
 /* This structure describes the simulated video controller */
@@ -138,10 +156,13 @@ static const struct fb_videoinfo_s g_videoinfo =
 static const struct fb_planeinfo_s g_planeinfo =
 {
   .fbmem    = (FAR void *)&g_fb,
-  .fblen    = FB_SIZE,
+  .fblen    = FB_SIZE * FB_NBUFFERS,
   .stride   = FB_WIDTH,
   .display  = 0,
   .bpp      = CONFIG_SIM_FBBPP,
+#ifdef CONFIG_FB_PANDISPLAY
+  .yres_virtual = CONFIG_SIM_FBHEIGHT * FB_NBUFFERS,
+#endif
 };
 #else
 /* This structure describes the single, X11 color plane */
@@ -161,6 +182,12 @@ static struct fb_cursorsize_s g_csize;
 #endif
 #endif
 
+/* The first row that is displayed */
+
+#ifdef CONFIG_FB_PANDISPLAY
+static fb_coord_t g_yoffset;
+#endif
+
 /* The framebuffer object -- There is no private state information in this simple
  * framebuffer simulation.
  */
@@ -177,6 +204,9 @@ struct fb_vtable_s g_fbobject =
   .getcursor     = up_getcursor,
   .setcursor     = up_setcursor,
 #endif
+#ifdef CONFIG_FB_PANDISPLAY
+  .pandisplay    = up_pandisplay,
+#endif
 };
 
 /****************************************************************************
@@ -216,6 +246,9 @@ static int up_getplaneinfo(FAR struct fb_vtable_s *vtable, int planeno,
   if (vtable && planeno == 0 && pinfo)
     {
       memcpy(pinfo, &g_planeinfo, sizeof(struct fb_planeinfo_s));
+#ifdef CONFIG_FB_PANDISPLAY
+      pinfo->yoffset = g_yoffset;
+#endif
       return OK;
     }
 
@@ -346,6 +379,36 @@ static int up_setcursor(FAR struct fb_vtable_s *vtable,
 }
 #endif
 
+/****************************************************************************
+ * Name: up_pandisplay
+ *
+ * Description:
+ *   Select the buffer to be displayed.  There is no scan out to wait for in
+ *   the simulation so the pan completes immediately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PANDISPLAY
+static int up_pandisplay(FAR struct fb_vtable_s *vtable, int planeno,
+                         FAR const struct fb_planeinfo_s *pinfo)
+{
+  _info("vtable=%p planeno=%d pinfo=%p\n", vtable, planeno, pinfo);
+  if (vtable && planeno == 0 && pinfo &&
+      pinfo->yoffset <= CONFIG_SIM_FBHEIGHT * (FB_NBUFFERS - 1))
+    {
+      g_yoffset = pinfo->yoffset;
+#ifdef CONFIG_SIM_X11FB
+      up_x11pan(g_yoffset);
+#endif
+      fb_notify_vsync(vtable);
+      return OK;
+    }
+
+  _err("ERROR: Returning EINVAL\n");
+  return -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -369,9 +432,13 @@ static int up_setcursor(FAR struct fb_vtable_s *vtable,
 int up_fbinitialize(int display)
 {
 #ifdef CONFIG_SIM_X11FB
+#ifdef CONFIG_FB_PANDISPLAY
+  g_planeinfo.yres_virtual = CONFIG_SIM_FBHEIGHT * FB_NBUFFERS;
+#endif
   return up_x11initialize(CONFIG_SIM_FBWIDTH, CONFIG_SIM_FBHEIGHT,
-                          &g_planeinfo.fbmem, &g_planeinfo.fblen,
-                          &g_planeinfo.bpp, &g_planeinfo.stride);
+                          FB_NBUFFERS, &g_planeinfo.fbmem,
+                          &g_planeinfo.fblen, &g_planeinfo.bpp,
+                          &g_planeinfo.stride);
 #else
   return OK;
 #endif
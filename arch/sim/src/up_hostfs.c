@@ -304,6 +304,30 @@ int host_readdir(void* dirp, struct nuttx_dirent_s* entry)
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: host_readdirs
+ *
+ * Description:
+ *   Read up to 'nentries' directory entries in one call.  Returns the
+ *   number of entries read, zero at the end of the directory.
+ *
+ ****************************************************************************/
+
+int host_readdirs(void *dirp, struct nuttx_dirent_s *entries, int nentries)
+{
+  int i;
+
+  for (i = 0; i < nentries; i++)
+    {
+      if (host_readdir(dirp, &entries[i]) < 0)
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
 /****************************************************************************
  * Name: host_rewinddir
  ****************************************************************************/
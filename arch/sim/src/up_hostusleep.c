@@ -37,6 +37,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
+#include <time.h>
 #include <unistd.h>
 
 /****************************************************************************
@@ -51,3 +53,19 @@ int up_hostusleep(unsigned int usec)
 {
   return usleep(usec);
 }
+
+/****************************************************************************
+ * Name: up_hosttime
+ *
+ * Description:
+ *   Return the host monotonic time in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t up_hosttime(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
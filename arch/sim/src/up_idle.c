@@ -39,10 +39,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <pthread.h>
 #include <time.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 
 #ifdef CONFIG_PM
 #  include <nuttx/power/pm.h>
@@ -60,6 +62,13 @@
 
 #define PM_IDLE_DOMAIN 0 /* Revisit */
 
+/* With CONFIG_SIM_WALLTIME, timer ticks that were missed while the CPU(s)
+ * were busy are processed late.  After a longer stall (such as a stop in
+ * the debugger), the timer just restarts from the current time.
+ */
+
+#define SIM_MAXLAG_NSEC  (1000000000ull)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -68,12 +77,19 @@
 static int g_x11refresh = 0;
 #endif
 
+#ifdef CONFIG_SIM_WALLTIME
+static uint64_t g_nexttick;  /* Host time of the next timer tick */
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
 #if defined(CONFIG_SIM_WALLTIME) || defined(CONFIG_SIM_X11FB)
 extern int up_hostusleep(unsigned int usec);
+#ifdef CONFIG_SIM_WALLTIME
+extern uint64_t up_hosttime(void);
+#endif
 #ifdef CONFIG_SIM_X11FB
 extern void up_x11update(void);
 #endif
@@ -120,7 +136,32 @@ void up_idle(void)
     }
 #endif
 
+#ifdef CONFIG_SIM_WALLTIME
+  /* Process one timer tick for each tick period of host time that has
+   * passed.  The system time then follows the wall clock even if the CPU(s)
+   * did not get to the IDLE loop for several tick periods.
+   */
+
+  {
+    uint64_t now = up_hosttime();
+
+    if (g_nexttick == 0 ||
+        (now > g_nexttick && now - g_nexttick > SIM_MAXLAG_NSEC))
+      {
+        g_nexttick = now;
+      }
+
+    while (now >= g_nexttick)
+      {
 #ifdef CONFIG_SCHED_TICKLESS
+        up_timer_update();
+#else
+        sched_process_timer();
+#endif
+        g_nexttick += NSEC_PER_TICK;
+      }
+  }
+#elif defined(CONFIG_SCHED_TICKLESS)
   /* Driver the simulated interval timer */
 
   up_timer_update();
@@ -171,7 +212,18 @@ void up_idle(void)
    * correct rate.
    */
 
+#ifdef CONFIG_SIM_WALLTIME
+  {
+    uint64_t now = up_hosttime();
+
+    if (g_nexttick > now)
+      {
+        (void)up_hostusleep((unsigned int)((g_nexttick - now) / 1000));
+      }
+  }
+#else
   (void)up_hostusleep(1000000 / CLK_TCK);
+#endif
 
   /* Handle X11-related events */
 
@@ -289,8 +289,10 @@ unsigned long up_getwalltime( void );
 
 #ifdef CONFIG_SIM_X11FB
 int up_x11initialize(unsigned short width, unsigned short height,
-                     void **fbmem, unsigned int *fblen, unsigned char *bpp,
+                     unsigned short nbuffers, void **fbmem,
+                     unsigned int *fblen, unsigned char *bpp,
                      unsigned short *stride);
+void up_x11pan(unsigned short yoffset);
 #ifdef CONFIG_FB_CMAP
 int up_x11cmap(unsigned short first, unsigned short len,
                unsigned char *red, unsigned char *green,
@@ -334,13 +336,22 @@ FAR struct ioexpander_dev_s *sim_ioexpander_initialize(void);
 
 #if defined(CONFIG_NET_ETHERNET) && !defined(__CYGWIN__)
 void tapdev_init(void);
-unsigned int tapdev_read(unsigned char *buf, unsigned int buflen);
+void tapdev_rxstart(unsigned char *bufs, unsigned int nbufs,
+                    unsigned int bufsize);
+unsigned char *tapdev_rxframe(unsigned int *len, unsigned int usec);
+void tapdev_rxrelease(void);
 void tapdev_send(unsigned char *buf, unsigned int buflen);
 void tapdev_ifup(in_addr_t ifaddr);
 void tapdev_ifdown(void);
 
+/* Received frames are queued by a host thread and handled in place */
+
+#  define SIM_NETDEV_RXQUEUE      1
+
 #  define netdev_init()           tapdev_init()
-#  define netdev_read(buf,buflen) tapdev_read(buf,buflen)
+#  define netdev_rxstart(b,n,s)   tapdev_rxstart(b,n,s)
+#  define netdev_rxframe(len,us)  tapdev_rxframe(len,us)
+#  define netdev_rxrelease()      tapdev_rxrelease()
 #  define netdev_send(buf,buflen) tapdev_send(buf,buflen)
 #  define netdev_ifup(ifaddr)     tapdev_ifup(ifaddr)
 #  define netdev_ifdown()         tapdev_ifdown()
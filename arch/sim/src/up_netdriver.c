@@ -68,6 +68,15 @@
 
 #define BUF ((struct eth_hdr_s *)g_sim_dev.d_buf)
 
+#ifndef CONFIG_SIM_NET_RXBUFFERS
+#  define CONFIG_SIM_NET_RXBUFFERS 16
+#endif
+
+/* The size of one receive buffer, rounded up to keep the buffers aligned */
+
+#define SIM_RXBUFSIZE \
+  ((MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE + 3) & ~3)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -84,10 +93,16 @@ struct timer
 
 static struct timer g_periodic_timer;
 
-/* A single packet buffer is used */
+/* A single packet buffer is used for transmission */
 
 static uint8_t g_pktbuf[MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE];
 
+#ifdef SIM_NETDEV_RXQUEUE
+/* Frames are received into these buffers by the host */
+
+static uint32_t g_rxbufs[CONFIG_SIM_NET_RXBUFFERS][SIM_RXBUFSIZE / 4];
+#endif
+
 /* Ethernet peripheral state */
 
 static struct net_driver_s g_sim_dev;
@@ -164,161 +179,214 @@ static int sim_txpoll(struct net_driver_s *dev)
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: sim_receive
+ *
+ * Description:
+ *   Handle the frame in g_sim_dev.d_buf.
+ *
  ****************************************************************************/
 
-void netdriver_loop(void)
+static void sim_receive(void)
 {
   FAR struct eth_hdr_s *eth;
 
-  /* Check for new frames.  If so, then poll the network for new XMIT data */
-
-  net_lock();
-  (void)devif_poll(&g_sim_dev, sim_txpoll);
-  net_unlock();
-
-  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
-
-  g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
-                                CONFIG_NET_ETH_MTU);
-
-  /* Disable preemption through to the following so that it behaves a little more
-   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
-   * oddly.
+  /* Data received event.  Check for valid Ethernet header with destination == our
+   * MAC address
    */
 
-  sched_lock();
-  if (g_sim_dev.d_len > 0)
+  eth = BUF;
+  if (g_sim_dev.d_len > ETH_HDRLEN)
     {
-      /* Data received event.  Check for valid Ethernet header with destination == our
-       * MAC address
-       */
+     int is_ours;
 
-      eth = BUF;
-      if (g_sim_dev.d_len > ETH_HDRLEN)
-        {
-         int is_ours;
-
-         /* Figure out if this ethernet frame is addressed to us.  This affects
-           * what we're willing to receive.   Note that in promiscuous mode, the
-           * up_comparemac will always return 0.
-           */
+     /* Figure out if this ethernet frame is addressed to us.  This affects
+       * what we're willing to receive.   Note that in promiscuous mode, the
+       * up_comparemac will always return 0.
+       */
 
-         is_ours = (up_comparemac(eth->dest, &g_sim_dev.d_mac.ether) == 0);
+     is_ours = (up_comparemac(eth->dest, &g_sim_dev.d_mac.ether) == 0);
 
 #ifdef CONFIG_NET_PKT
-          /* When packet sockets are enabled, feed the frame into the packet
-           * tap.
-           */
+      /* When packet sockets are enabled, feed the frame into the packet
+       * tap.
+       */
 
-          if (is_ours)
-            {
-              pkt_input(&g_sim_dev);
-            }
+      if (is_ours)
+        {
+          pkt_input(&g_sim_dev);
+        }
 #endif /* CONFIG_NET_PKT */
 
-          /* We only accept IP packets of the configured type and ARP packets */
+      /* We only accept IP packets of the configured type and ARP packets */
 
 #ifdef CONFIG_NET_IPv4
-          if (eth->type == HTONS(ETHTYPE_IP) && is_ours)
-            {
-              ninfo("IPv4 frame\n");
+      if (eth->type == HTONS(ETHTYPE_IP) && is_ours)
+        {
+          ninfo("IPv4 frame\n");
 
-              /* Handle ARP on input then give the IPv4 packet to the network
-               * layer
-               */
+          /* Handle ARP on input then give the IPv4 packet to the network
+           * layer
+           */
 
-              arp_ipin(&g_sim_dev);
-              ipv4_input(&g_sim_dev);
+          arp_ipin(&g_sim_dev);
+          ipv4_input(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+            {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv6
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
 #endif
-                    {
-                      arp_out(&g_sim_dev);
-                    }
+                {
+                  arp_out(&g_sim_dev);
+                }
 #ifdef CONFIG_NET_IPv6
-                  else
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+              else
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
+        }
+      else
 #endif /* CONFIG_NET_IPv4 */
 #ifdef CONFIG_NET_IPv6
-          if (eth->type == HTONS(ETHTYPE_IP6) && is_ours)
-            {
-              ninfo("Iv6 frame\n");
+      if (eth->type == HTONS(ETHTYPE_IP6) && is_ours)
+        {
+          ninfo("Iv6 frame\n");
 
-              /* Give the IPv6 packet to the network layer */
+          /* Give the IPv6 packet to the network layer */
 
-              ipv6_input(&g_sim_dev);
+          ipv6_input(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-               {
-                  /* Update the Ethernet header with the correct MAC address */
+          if (g_sim_dev.d_len > 0)
+           {
+              /* Update the Ethernet header with the correct MAC address */
 
 #ifdef CONFIG_NET_IPv4
-                  if (IFF_IS_IPv4(g_sim_dev.d_flags))
-                    {
-                      arp_out(&g_sim_dev);
-                    }
-                  else
+              if (IFF_IS_IPv4(g_sim_dev.d_flags))
+                {
+                  arp_out(&g_sim_dev);
+                }
+              else
 #endif
 #ifdef CONFIG_NET_IPv6
-                    {
-                      neighbor_out(&g_sim_dev);
-                    }
+                {
+                  neighbor_out(&g_sim_dev);
+                }
 #endif /* CONFIG_NET_IPv6 */
 
-                  /* And send the packet */
+              /* And send the packet */
 
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
+        }
+      else
 #endif/* CONFIG_NET_IPv6 */
 #ifdef CONFIG_NET_ARP
-          if (eth->type == htons(ETHTYPE_ARP))
-            {
-              arp_arpin(&g_sim_dev);
+      if (eth->type == htons(ETHTYPE_ARP))
+        {
+          arp_arpin(&g_sim_dev);
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+          /* If the above function invocation resulted in data that
+           * should be sent out on the network, the global variable
+           * d_len is set to a value > 0.
+           */
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
+          if (g_sim_dev.d_len > 0)
+            {
+              netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
             }
-          else
-#endif
-           {
-             nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
-           }
         }
+      else
+#endif
+       {
+         nwarn("WARNING: Unsupported Ethernet type %u\n", eth->type);
+       }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void netdriver_loop(void)
+{
+#ifdef SIM_NETDEV_RXQUEUE
+  FAR unsigned char *frame;
+  unsigned int len;
+  int i;
+#endif
+
+  /* Check for new frames.  If so, then poll the network for new XMIT data */
+
+  net_lock();
+  (void)devif_poll(&g_sim_dev, sim_txpoll);
+  net_unlock();
+
+#ifdef SIM_NETDEV_RXQUEUE
+  /* Wait up to 1 ms for the host RX thread to queue a frame */
+
+  frame = netdev_rxframe(&len, 1000);
+
+  /* Disable preemption through to the following so that it behaves a little more
+   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
+   * oddly.
+   */
+
+  sched_lock();
+
+  /* Handle all of the frames that are queued.  Each frame is handled in its
+   * receive buffer; replies are built in the same buffer.
+   */
+
+  for (i = 0; frame != NULL && i < CONFIG_SIM_NET_RXBUFFERS; i++)
+    {
+      g_sim_dev.d_buf = frame;
+      g_sim_dev.d_len = len;
+      sim_receive();
+      netdev_rxrelease();
+
+      frame = netdev_rxframe(&len, 0);
+    }
+
+  g_sim_dev.d_buf = g_pktbuf;
+
+  if (timer_expired(&g_periodic_timer))
+    {
+      timer_reset(&g_periodic_timer);
+      devif_timer(&g_sim_dev, sim_txpoll);
+    }
+#else
+  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
+
+  g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
+                                CONFIG_NET_ETH_MTU);
+
+  /* Disable preemption through to the following so that it behaves a little more
+   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
+   * oddly.
+   */
+
+  sched_lock();
+  if (g_sim_dev.d_len > 0)
+    {
+      sim_receive();
     }
 
   /* Otherwise, it must be a timeout event */
@@ -328,6 +396,7 @@ void netdriver_loop(void)
       timer_reset(&g_periodic_timer);
       devif_timer(&g_sim_dev, sim_txpoll);
     }
+#endif
 
   sched_unlock();
 }
@@ -351,6 +420,11 @@ int netdriver_init(void)
   timer_set(&g_periodic_timer, 500);
   netdev_init();
 
+#ifdef SIM_NETDEV_RXQUEUE
+  netdev_rxstart((FAR unsigned char *)g_rxbufs, CONFIG_SIM_NET_RXBUFFERS,
+                 SIM_RXBUFSIZE);
+#endif
+
   /* Set callbacks */
 
   g_sim_dev.d_buf    = g_pktbuf;         /* Single packet buffer */
@@ -53,6 +53,14 @@
 #define SP_UNLOCKED   0   /* The Un-locked state */
 #define SP_LOCKED     1   /* The Locked state */
 
+/* up_cpu_pause() busy-waits this many times for the other CPU to respond
+ * before it starts yielding the host CPU.  Yielding at once makes the
+ * latency of the pause request depend on the host scheduler rather than
+ * on the CPU being paused.
+ */
+
+#define SIM_PAUSE_SPINS 100000
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -108,6 +116,51 @@ void sim_smp_hook(void);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sim_cpu_bind
+ *
+ * Description:
+ *   Bind the thread of the simulated CPU 'cpu' to one host CPU so that the
+ *   simulated CPUs really run in parallel and do not migrate between host
+ *   CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_CPU_AFFINITY
+static void sim_cpu_bind(int cpu)
+{
+  cpu_set_t cpuset;
+  int ncpus;
+  int i;
+
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) != 0)
+    {
+      return;
+    }
+
+  /* Pick the (cpu % ncpus)th of the host CPUs that we may run on */
+
+  ncpus = CPU_COUNT(&cpuset);
+  if (ncpus > 0)
+    {
+      cpu %= ncpus;
+      for (i = 0; i < CPU_SETSIZE; i++)
+        {
+          if (CPU_ISSET(i, &cpuset) && cpu-- == 0)
+            {
+              CPU_ZERO(&cpuset);
+              CPU_SET(i, &cpuset);
+              (void)pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                           &cpuset);
+              break;
+            }
+        }
+    }
+}
+#else
+#  define sim_cpu_bind(cpu)
+#endif
+
 /****************************************************************************
  * Name: sim_cpu0_trampoline
  *
@@ -136,6 +189,8 @@ static void *sim_cpu0_trampoline(void *arg)
       return NULL;
     }
 
+  sim_cpu_bind(0);
+
   /* Make sure the SIGUSR1 is not masked */
 
   sigemptyset(&set);
@@ -190,6 +245,8 @@ static void *sim_idle_trampoline(void *arg)
       return NULL;
     }
 
+  sim_cpu_bind(cpuinfo->cpu);
+
   /* Make sure the SIGUSR1 is not masked */
 
   sigemptyset(&set);
@@ -456,6 +513,8 @@ errout_with_mutex:
 
 int up_cpu_pause(int cpu)
 {
+  int spins = 0;
+
   /* Take the spinlock that will prevent the CPU thread from running */
 
   g_cpu_wait[cpu]   = SP_LOCKED;
@@ -469,7 +528,14 @@ int up_cpu_pause(int cpu)
 
   while (g_cpu_paused[cpu] != 0)
     {
-      pthread_yield();
+      if (spins < SIM_PAUSE_SPINS)
+        {
+          spins++;
+        }
+      else
+        {
+          pthread_yield();
+        }
     }
 
   return 0;
@@ -52,10 +52,13 @@
 #include <sys/socket.h>
 
 #include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
 #include <time.h>
 
 #ifdef CONFIG_SIM_NET_HOST_ROUTE
@@ -113,6 +116,21 @@ static int  gdrop = 0;
 static int  gtapdevfd;
 static char gdevname[IFNAMSIZ];
 
+/* Receive queue.  The RX thread reads frames into the buffers provided by
+ * the network driver; the driver takes them in order with tapdev_rxframe()
+ * and gives them back with tapdev_rxrelease().
+ */
+
+static pthread_t       g_rxthread;
+static pthread_mutex_t g_rxlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  g_rxcond = PTHREAD_COND_INITIALIZER;
+static unsigned char  *g_rxbufs;     /* The receive buffers */
+static unsigned int   *g_rxlen;      /* Length of the frame in each buffer */
+static unsigned int    g_rxnbufs;    /* Number of receive buffers */
+static unsigned int    g_rxbufsize;  /* Size of each receive buffer */
+static unsigned int    g_rxhead;     /* Oldest queued frame */
+static unsigned int    g_rxcount;    /* Number of queued frames */
+
 #ifdef CONFIG_SIM_NET_HOST_ROUTE
 static struct rtentry ghostroute;
 #endif
@@ -139,6 +157,60 @@ static inline void dump_ethhdr(const char *msg, unsigned char *buf, int buflen)
 #  define dump_ethhdr(m,b,l)
 #endif
 
+static void *tapdev_rxthread(void *arg)
+{
+  unsigned int slot;
+  sigset_t set;
+  int ret;
+
+  /* The signals used by the simulation must be handled by the threads of
+   * the simulated CPUs.
+   */
+
+  sigfillset(&set);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  for (; ; )
+    {
+      /* Wait for a free buffer */
+
+      pthread_mutex_lock(&g_rxlock);
+      while (g_rxcount >= g_rxnbufs)
+        {
+          pthread_cond_wait(&g_rxcond, &g_rxlock);
+        }
+
+      slot = (g_rxhead + g_rxcount) % g_rxnbufs;
+      pthread_mutex_unlock(&g_rxlock);
+
+      /* Read the next frame directly into the free buffer.  The buffer is
+       * not visible to the driver until it is counted below.
+       */
+
+      ret = read(gtapdevfd, g_rxbufs + slot * g_rxbufsize, g_rxbufsize);
+      if (ret <= 0)
+        {
+          if (ret < 0 && errno != EINTR && errno != EAGAIN)
+            {
+              syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+              usleep(1000);
+            }
+
+          continue;
+        }
+
+      dump_ethhdr("read", g_rxbufs + slot * g_rxbufsize, ret);
+
+      pthread_mutex_lock(&g_rxlock);
+      g_rxlen[slot] = ret;
+      g_rxcount++;
+      pthread_cond_broadcast(&g_rxcond);
+      pthread_mutex_unlock(&g_rxlock);
+    }
+
+  return NULL;
+}
+
 static int up_setmacaddr(void)
 {
   unsigned char mac[7];
@@ -240,42 +312,85 @@ void tapdev_init(void)
   up_setmacaddr();
 }
 
-unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
+void tapdev_rxstart(unsigned char *bufs, unsigned int nbufs,
+                    unsigned int bufsize)
 {
-  fd_set                fdset;
-  struct timeval        tv;
-  int                   ret;
+  int ret;
 
   /* We can't do anything if we failed to open the tap device */
 
-  if (gtapdevfd < 0)
+  if (gtapdevfd < 0 || nbufs == 0)
+    {
+      return;
+    }
+
+  g_rxlen = (unsigned int *)calloc(nbufs, sizeof(unsigned int));
+  if (g_rxlen == NULL)
+    {
+      return;
+    }
+
+  g_rxbufs    = bufs;
+  g_rxnbufs   = nbufs;
+  g_rxbufsize = bufsize;
+  g_rxhead    = 0;
+  g_rxcount   = 0;
+
+  ret = pthread_create(&g_rxthread, NULL, tapdev_rxthread, NULL);
+  if (ret != 0)
     {
-      return 0;
+      syslog(LOG_ERR, "TAPDEV: Can't start RX thread: %d\n", -ret);
+      g_rxnbufs = 0;
     }
+}
 
-  /* Wait for data on the tap device (or a timeout) */
+unsigned char *tapdev_rxframe(unsigned int *len, unsigned int usec)
+{
+  unsigned char *frame = NULL;
+  struct timespec abstime;
 
-  tv.tv_sec  = 0;
-  tv.tv_usec = 1000;
+  pthread_mutex_lock(&g_rxlock);
 
-  FD_ZERO(&fdset);
-  FD_SET(gtapdevfd, &fdset);
+  /* Wait (at most 'usec' microseconds) for a frame to be queued */
 
-  ret = select(gtapdevfd + 1, &fdset, NULL, NULL, &tv);
-  if (ret == 0)
+  if (g_rxcount == 0 && usec > 0)
     {
-      return 0;
+      clock_gettime(CLOCK_REALTIME, &abstime);
+      abstime.tv_nsec += (long)usec * 1000;
+      abstime.tv_sec  += abstime.tv_nsec / 1000000000;
+      abstime.tv_nsec %= 1000000000;
+
+      while (g_rxcount == 0)
+        {
+          if (pthread_cond_timedwait(&g_rxcond, &g_rxlock,
+                                     &abstime) == ETIMEDOUT)
+            {
+              break;
+            }
+        }
     }
 
-  ret = read(gtapdevfd, buf, buflen);
-  if (ret < 0)
+  if (g_rxcount > 0)
     {
-      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
-      return 0;
+      *len  = g_rxlen[g_rxhead];
+      frame = g_rxbufs + g_rxhead * g_rxbufsize;
     }
 
-  dump_ethhdr("read", buf, ret);
-  return ret;
+  pthread_mutex_unlock(&g_rxlock);
+  return frame;
+}
+
+void tapdev_rxrelease(void)
+{
+  pthread_mutex_lock(&g_rxlock);
+  if (g_rxcount > 0)
+    {
+      g_rxhead = (g_rxhead + 1) % g_rxnbufs;
+      g_rxcount--;
+      pthread_cond_broadcast(&g_rxcond);
+    }
+
+  pthread_mutex_unlock(&g_rxlock);
 }
 
 void tapdev_send(unsigned char *buf, unsigned int buflen)
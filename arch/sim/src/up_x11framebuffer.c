@@ -75,6 +75,8 @@ static XImage *g_image;
 static unsigned char *g_framebuffer;
 static unsigned short g_fbpixelwidth;
 static unsigned short g_fbpixelheight;
+static unsigned short g_fbnbuffers;
+static unsigned short g_fbyoffset;
 static int g_shmcheckpoint = 0;
 static int b_useshm;
 
@@ -276,7 +278,8 @@ static inline int up_x11mapsharedmem(int depth, unsigned int fblen)
       up_x11traperrors();
       g_image = XShmCreateImage(g_display, DefaultVisual(g_display, g_screen),
                                 depth, ZPixmap, NULL, &g_xshminfo,
-                                g_fbpixelwidth, g_fbpixelheight);
+                                g_fbpixelwidth,
+                                g_fbpixelheight * g_fbnbuffers);
       if (up_x11untraperrors())
         {
           up_x11uninitialize();
@@ -333,8 +336,8 @@ shmerror:
       g_framebuffer = (unsigned char *)malloc(fblen);
 
       g_image = XCreateImage(g_display, DefaultVisual(g_display, g_screen), depth,
-                             ZPixmap, 0, (char *)g_framebuffer, g_fbpixelwidth, g_fbpixelheight,
-                             8, 0);
+                             ZPixmap, 0, (char *)g_framebuffer, g_fbpixelwidth,
+                             g_fbpixelheight * g_fbnbuffers, 8, 0);
 
       if (g_image == NULL)
          {
@@ -355,12 +358,14 @@ shmerror:
  * Name: up_x11initialize
  *
  * Description:
- *   Make an X11 window look like a frame buffer.
+ *   Make an X11 window look like a frame buffer.  The frame buffer holds
+ *   nbuffers screens; up_x11pan() selects the one shown in the window.
  *
  ****************************************************************************/
 
 int up_x11initialize(unsigned short width, unsigned short height,
-                     void **fbmem, unsigned int *fblen, unsigned char *bpp,
+                     unsigned short nbuffers, void **fbmem,
+                     unsigned int *fblen, unsigned char *bpp,
                      unsigned short *stride)
 {
   XWindowAttributes windowAttributes;
@@ -375,6 +380,7 @@ int up_x11initialize(unsigned short width, unsigned short height,
 
       g_fbpixelwidth  = width;
       g_fbpixelheight = height;
+      g_fbnbuffers    = nbuffers;
 
       /* Create the X11 window */
 
@@ -401,7 +407,7 @@ int up_x11initialize(unsigned short width, unsigned short height,
 
       *bpp    = depth;
       *stride = (depth * width / 8);
-      *fblen  = (*stride * height);
+      *fblen  = (*stride * height * nbuffers);
 
       /* Map the window to shared memory */
 
@@ -454,6 +460,19 @@ int up_x11cmap(unsigned short first, unsigned short len,
   return 0;
 }
 
+/****************************************************************************
+ * Name: up_x11pan
+ *
+ * Description:
+ *   Select the first row of the frame buffer that is shown in the window.
+ *
+ ****************************************************************************/
+
+void up_x11pan(unsigned short yoffset)
+{
+  g_fbyoffset = yoffset;
+}
+
 /****************************************************************************
  * Name: up_x11update
  ****************************************************************************/
@@ -463,13 +482,13 @@ void up_x11update(void)
 #ifndef CONFIG_SIM_X11NOSHM
   if (b_useshm)
     {
-      XShmPutImage(g_display, g_window, g_gc, g_image, 0, 0, 0, 0,
+      XShmPutImage(g_display, g_window, g_gc, g_image, 0, g_fbyoffset, 0, 0,
                    g_fbpixelwidth, g_fbpixelheight, 0);
     }
   else
 #endif
     {
-      XPutImage(g_display, g_window, g_gc, g_image, 0, 0, 0, 0,
+      XPutImage(g_display, g_window, g_gc, g_image, 0, g_fbyoffset, 0, 0,
                 g_fbpixelwidth, g_fbpixelheight);
     }
 
@@ -94,7 +94,9 @@ static size_t do_stackcheck(uintptr_t alloc, size_t size)
 #ifdef CONFIG_TLS
   /* Skip over the TLS data structure at the bottom of the stack */
 
+#ifdef CONFIG_TLS_ALIGNED
   DEBUGASSERT((alloc & TLS_STACK_MASK) == 0);
+#endif
   start = alloc + sizeof(struct tls_info_s);
 #else
   start = alloc & ~3;
@@ -0,0 +1,1083 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_AUDIO_MIXER_NINPUTS
+#  define CONFIG_AUDIO_MIXER_NINPUTS 2
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_NBUFFERS
+#  define CONFIG_AUDIO_MIXER_NBUFFERS 2
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_BUFSIZE
+#  define CONFIG_AUDIO_MIXER_BUFSIZE 2048
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_SAMPRATE
+#  define CONFIG_AUDIO_MIXER_SAMPRATE 48000
+#endif
+
+#define MIXER_NAMELEN     32
+
+/* Mixing is performed on the low priority work queue, if available */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define MIXER_WORK LPWORK
+#else
+#  define MIXER_WORK HPWORK
+#endif
+
+/* The output is always 16-bit stereo */
+
+#define MIXER_FRAMESIZE   4
+
+/* Sample rate conversion steps and gains are fixed point values */
+
+#define MIXER_UNITY       0x00010000  /* Step of 1.0 (16.16) */
+#define MIXER_GAIN_UNITY  0x00008000  /* Gain of 1.0 (Q15) */
+
+/* States of the output (hardware) stream */
+
+#define MIXER_HW_IDLE     0           /* Hardware stopped */
+#define MIXER_HW_RUNNING  1           /* Hardware streaming */
+#define MIXER_HW_DRAINING 2           /* Final buffer sent; waiting for
+                                       * completion */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of one input stream.  The struct
+ * audio_lowerhalf_s must appear at the beginning of the definition so that
+ * you can freely cast between the two types.
+ */
+
+struct audio_mixer_s;
+struct mixer_input_s
+{
+  struct audio_lowerhalf_s export;   /* Lower half seen by the upper half */
+  FAR struct audio_mixer_s *mixer;   /* The containing mixer */
+  dq_queue_t pendq;                  /* Enqueued, unconsumed buffers */
+  uint32_t step;                     /* Input frames per output frame */
+  uint32_t frac;                     /* Position between cur and next */
+  int32_t  gain;                     /* Volume (Q15) */
+  int16_t  cur[2];                   /* Frame at the current position */
+  int16_t  next[2];                  /* Following frame */
+  uint8_t  partial[MIXER_FRAMESIZE]; /* Frame split between buffers */
+  uint8_t  npartial;                 /* Bytes in partial[] */
+  uint8_t  nchannels;                /* Mono=1, Stereo=2 */
+  bool     reserved;                 /* Reserved by an upper half */
+  bool     running;                  /* Started */
+  bool     paused;                   /* Paused */
+  bool     eos;                      /* Final buffer has been consumed */
+};
+
+/* This structure describes the state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *hw;  /* Lower half of the output device */
+  sem_t exclsem;                     /* Mutually exclusive access */
+  struct work_s work;                /* Mixing work */
+  dq_queue_t freeq;                  /* Output buffers to be filled */
+  volatile uint8_t hwstate;          /* See MIXER_HW_* definitions */
+
+  struct mixer_input_s inputs[CONFIG_AUDIO_MIXER_NINPUTS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Input lower half methods */
+
+static int  mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+              FAR struct audio_caps_s *caps);
+static int  mixer_configure(FAR struct audio_lowerhalf_s *dev,
+              FAR const struct audio_caps_s *caps);
+static int  mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int  mixer_start(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int  mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int  mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int  mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int  mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+              FAR struct ap_buffer_s *apb);
+static int  mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+              FAR struct ap_buffer_s *apb);
+static int  mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+              unsigned long arg);
+static int  mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int  mixer_release(FAR struct audio_lowerhalf_s *dev);
+
+/* Mixing */
+
+static void mixer_worker(FAR void *arg);
+static void mixer_hwcallback(FAR void *arg, uint16_t reason,
+              FAR struct ap_buffer_s *apb, uint16_t status);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_mixerops =
+{
+  mixer_getcaps,        /* getcaps        */
+  mixer_configure,      /* configure      */
+  mixer_shutdown,       /* shutdown       */
+  mixer_start,          /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  mixer_stop,           /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  mixer_pause,          /* pause          */
+  mixer_resume,         /* resume         */
+#endif
+  NULL,                 /* allocbuffer    */
+  NULL,                 /* freebuffer     */
+  mixer_enqueuebuffer,  /* enqueue_buffer */
+  mixer_cancelbuffer,   /* cancel_buffer  */
+  mixer_ioctl,          /* ioctl          */
+  NULL,                 /* read           */
+  NULL,                 /* write          */
+  mixer_reserve,        /* reserve        */
+  mixer_release         /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mixer_takesem
+ ****************************************************************************/
+
+static void mixer_takesem(FAR struct audio_mixer_s *priv)
+{
+  while (sem_wait(&priv->exclsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+#define mixer_givesem(p) sem_post(&(p)->exclsem)
+
+/****************************************************************************
+ * Name: mixer_qadd16
+ *
+ * Description:
+ *   Add the two signed 16-bit halves of two words with saturation.  This is
+ *   a single instruction on cores with the ARMv7E-M DSP extension.
+ *
+ ****************************************************************************/
+
+static inline uint32_t mixer_qadd16(uint32_t a, uint32_t b)
+{
+#if defined(CONFIG_ARCH_CORTEXM4) || defined(CONFIG_ARCH_CORTEXM7)
+  uint32_t result;
+
+  __asm__ ("qadd16 %0, %1, %2" : "=r" (result) : "r" (a), "r" (b));
+  return result;
+#else
+  int32_t lo = (int32_t)(int16_t)a + (int16_t)b;
+  int32_t hi = (int32_t)(int16_t)(a >> 16) + (int16_t)(b >> 16);
+
+  lo = lo > INT16_MAX ? INT16_MAX : (lo < INT16_MIN ? INT16_MIN : lo);
+  hi = hi > INT16_MAX ? INT16_MAX : (hi < INT16_MIN ? INT16_MIN : hi);
+  return ((uint32_t)hi << 16) | ((uint32_t)lo & 0xffff);
+#endif
+}
+
+/****************************************************************************
+ * Name: mixer_schedule
+ *
+ * Description:
+ *   Schedule the mixing work.  May be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static inline void mixer_schedule(FAR struct audio_mixer_s *priv)
+{
+  (void)work_queue(MIXER_WORK, &priv->work, mixer_worker, priv, 0);
+}
+
+/****************************************************************************
+ * Name: mixer_retire
+ *
+ * Description:
+ *   Return a consumed input buffer to the upper half of the input.
+ *
+ ****************************************************************************/
+
+static void mixer_retire(FAR struct mixer_input_s *input,
+                         FAR struct ap_buffer_s *apb)
+{
+  dq_rem((FAR dq_entry_t *)apb, &input->pendq);
+
+  if ((apb->flags & AUDIO_APB_FINAL) != 0)
+    {
+      input->eos = true;
+    }
+
+  apb_free(apb);
+  input->export.upper(input->export.priv, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+}
+
+/****************************************************************************
+ * Name: mixer_flush
+ *
+ * Description:
+ *   Return all queued buffers of an input and report completion.
+ *
+ ****************************************************************************/
+
+static void mixer_flush(FAR struct mixer_input_s *input)
+{
+  FAR struct ap_buffer_s *apb;
+  bool running = input->running;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&input->pendq)) != NULL)
+    {
+      mixer_retire(input, apb);
+    }
+
+  input->npartial = 0;
+  input->running  = false;
+  input->paused   = false;
+  input->eos      = false;
+
+  if (running)
+    {
+      input->export.upper(input->export.priv, AUDIO_CALLBACK_COMPLETE,
+                          NULL, OK);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_decode
+ *
+ * Description:
+ *   Decode one little-endian 16-bit input frame as a stereo pair.
+ *
+ ****************************************************************************/
+
+static inline void mixer_decode(FAR struct mixer_input_s *input,
+                                FAR const uint8_t *src, FAR int16_t *frame)
+{
+  frame[0] = (int16_t)((uint16_t)src[0] | (uint16_t)src[1] << 8);
+  if (input->nchannels == 1)
+    {
+      frame[1] = frame[0];
+    }
+  else
+    {
+      frame[1] = (int16_t)((uint16_t)src[2] | (uint16_t)src[3] << 8);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_getframe
+ *
+ * Description:
+ *   Get the next input frame as a stereo pair.  Input buffers are returned
+ *   to the upper half as soon as their last frame has been taken.  Returns
+ *   false if no more input data is available.
+ *
+ ****************************************************************************/
+
+static bool mixer_getframe(FAR struct mixer_input_s *input,
+                           FAR int16_t *frame)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const uint8_t *src;
+  unsigned int framesize = 2 * input->nchannels;
+  unsigned int avail;
+  unsigned int ncopy;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&input->pendq)) != NULL)
+    {
+      avail = apb->nbytes - apb->curbyte;
+      src   = &apb->samp[apb->curbyte];
+
+      if (input->npartial == 0 && avail >= framesize)
+        {
+          /* Common case: the whole frame is in this buffer */
+
+          mixer_decode(input, src, frame);
+
+          apb->curbyte += framesize;
+          if (apb->curbyte >= apb->nbytes)
+            {
+              mixer_retire(input, apb);
+            }
+
+          return true;
+        }
+
+      /* The frame is split between buffers (or the buffer is empty) */
+
+      ncopy = framesize - input->npartial;
+      if (ncopy > avail)
+        {
+          ncopy = avail;
+        }
+
+      memcpy(&input->partial[input->npartial], src, ncopy);
+      input->npartial += ncopy;
+      apb->curbyte    += ncopy;
+
+      if (apb->curbyte >= apb->nbytes)
+        {
+          mixer_retire(input, apb);
+        }
+
+      if (input->npartial >= framesize)
+        {
+          input->npartial = 0;
+          mixer_decode(input, input->partial, frame);
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mixer_mix
+ *
+ * Description:
+ *   Resample the data of one input to the output rate and add it to the
+ *   output frames.  Input that is not available is treated as silence.
+ *
+ ****************************************************************************/
+
+static void mixer_mix(FAR struct mixer_input_s *input, FAR int16_t *out,
+                      unsigned int nframes)
+{
+  int16_t frame[2];
+  int32_t frac;
+  uint32_t packed;
+
+  for (; nframes > 0; nframes--, out += 2)
+    {
+      if (input->step == MIXER_UNITY)
+        {
+          /* No rate conversion */
+
+          if (!mixer_getframe(input, frame))
+            {
+              return;
+            }
+        }
+      else
+        {
+          /* Advance to the pair of input frames surrounding the output
+           * frame.  If the input runs dry, the position is kept and the
+           * advance is retried with the next output buffer.
+           */
+
+          while (input->frac >= MIXER_UNITY)
+            {
+              input->cur[0] = input->next[0];
+              input->cur[1] = input->next[1];
+
+              if (!mixer_getframe(input, input->next))
+                {
+                  return;
+                }
+
+              input->frac -= MIXER_UNITY;
+            }
+
+          /* Linear interpolation with a 15-bit fraction */
+
+          frac     = (int32_t)(input->frac >> 1);
+          frame[0] = input->cur[0] +
+            (int16_t)(((int32_t)(input->next[0] - input->cur[0]) * frac)
+                      >> 15);
+          frame[1] = input->cur[1] +
+            (int16_t)(((int32_t)(input->next[1] - input->cur[1]) * frac)
+                      >> 15);
+
+          input->frac += input->step;
+        }
+
+      if (input->gain != MIXER_GAIN_UNITY)
+        {
+          frame[0] = (int16_t)(((int32_t)frame[0] * input->gain) >> 15);
+          frame[1] = (int16_t)(((int32_t)frame[1] * input->gain) >> 15);
+        }
+
+      packed = mixer_qadd16((uint32_t)(uint16_t)out[0] |
+                              (uint32_t)(uint16_t)out[1] << 16,
+                            (uint32_t)(uint16_t)frame[0] |
+                              (uint32_t)(uint16_t)frame[1] << 16);
+      out[0] = (int16_t)(packed & 0xffff);
+      out[1] = (int16_t)(packed >> 16);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_fill
+ *
+ * Description:
+ *   Fill one output buffer from all running inputs.  Returns the number of
+ *   inputs that are still running.
+ *
+ ****************************************************************************/
+
+static int mixer_fill(FAR struct audio_mixer_s *priv,
+                      FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_input_s *input;
+  FAR int16_t *out = (FAR int16_t *)apb->samp;
+  unsigned int nframes = apb->nmaxbytes / MIXER_FRAMESIZE;
+  int nrunning = 0;
+  int i;
+
+  DEBUGASSERT(((uintptr_t)out & 1) == 0);
+
+  memset(out, 0, nframes * MIXER_FRAMESIZE);
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NINPUTS; i++)
+    {
+      input = &priv->inputs[i];
+      if (!input->running)
+        {
+          continue;
+        }
+
+      if (!input->paused)
+        {
+          mixer_mix(input, out, nframes);
+        }
+
+      /* Has the final buffer of the input stream been consumed? */
+
+      if (input->eos && dq_empty(&input->pendq))
+        {
+          mixer_flush(input);
+        }
+      else
+        {
+          nrunning++;
+        }
+    }
+
+  apb->curbyte = 0;
+  apb->nbytes  = nframes * MIXER_FRAMESIZE;
+  apb->flags   = 0;
+  return nrunning;
+}
+
+/****************************************************************************
+ * Name: mixer_active
+ ****************************************************************************/
+
+static bool mixer_active(FAR struct audio_mixer_s *priv)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NINPUTS; i++)
+    {
+      if (priv->inputs[i].running)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mixer_hwstart
+ *
+ * Description:
+ *   Configure and start the output device.
+ *
+ ****************************************************************************/
+
+static int mixer_hwstart(FAR struct audio_mixer_s *priv)
+{
+  FAR struct audio_lowerhalf_s *hw = priv->hw;
+  struct audio_caps_s caps;
+  int ret;
+
+  memset(&caps, 0, sizeof(struct audio_caps_s));
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = 2;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPRATE;
+  caps.ac_controls.b[2]  = 16;
+
+  ret = hw->ops->configure(hw, &caps);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to configure the output: %d\n", ret);
+      return ret;
+    }
+
+  priv->hwstate = MIXER_HW_RUNNING;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_worker
+ *
+ * Description:
+ *   Fill all free output buffers and pass them to the output device,
+ *   starting and draining the output device as inputs come and go.
+ *
+ ****************************************************************************/
+
+static void mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *priv = (FAR struct audio_mixer_s *)arg;
+  FAR struct audio_lowerhalf_s *hw = priv->hw;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  bool start = false;
+  int ret;
+
+  mixer_takesem(priv);
+
+  if (priv->hwstate == MIXER_HW_IDLE)
+    {
+      if (!mixer_active(priv) || mixer_hwstart(priv) < 0)
+        {
+          mixer_givesem(priv);
+          return;
+        }
+
+      start = true;
+    }
+
+  while (priv->hwstate == MIXER_HW_RUNNING)
+    {
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&priv->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      /* When the last input has finished, send what is left as the final
+       * buffer.  The output device reports completion when it has played.
+       */
+
+      if (mixer_fill(priv, apb) == 0)
+        {
+          apb->flags   |= AUDIO_APB_FINAL;
+          priv->hwstate = MIXER_HW_DRAINING;
+        }
+
+      ret = hw->ops->enqueuebuffer(hw, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to enqueue output buffer: %d\n", ret);
+
+          flags = enter_critical_section();
+          dq_addlast((FAR dq_entry_t *)apb, &priv->freeq);
+          leave_critical_section(flags);
+          break;
+        }
+    }
+
+  if (start)
+    {
+      ret = hw->ops->start(hw);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to start the output: %d\n", ret);
+          priv->hwstate = MIXER_HW_IDLE;
+        }
+    }
+
+  mixer_givesem(priv);
+}
+
+/****************************************************************************
+ * Name: mixer_hwcallback
+ *
+ * Description:
+ *   Callback from the output device.  May be called from an interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+static void mixer_hwcallback(FAR void *arg, uint16_t reason,
+                             FAR struct ap_buffer_s *apb, uint16_t status)
+{
+  FAR struct audio_mixer_s *priv = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast((FAR dq_entry_t *)apb, &priv->freeq);
+        leave_critical_section(flags);
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+
+        /* The output has stopped.  The worker restarts it if an input was
+         * started while the output was draining.
+         */
+
+        priv->hwstate = MIXER_HW_IDLE;
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: Output I/O error: %d\n", status);
+        return;
+
+      default:
+        return;
+    }
+
+  mixer_schedule(priv);
+}
+
+/****************************************************************************
+ * Name: mixer_getcaps
+ *
+ * Description:
+ *   The capabilities reported are those of the output device.
+ *
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_lowerhalf_s *hw = input->mixer->hw;
+
+  return hw->ops->getcaps(hw, type, caps);
+}
+
+/****************************************************************************
+ * Name: mixer_configure
+ *
+ * Description:
+ *   Configure the format of the input stream.  Any sample rate is accepted
+ *   and converted to the output rate.
+ *
+ ****************************************************************************/
+
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+  int ret = OK;
+
+  DEBUGASSERT(caps);
+
+  mixer_takesem(priv);
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            uint16_t volume = caps->ac_controls.hw[0];
+
+            if (volume <= 1000)
+              {
+                input->gain = (int32_t)volume * MIXER_GAIN_UNITY / 1000;
+              }
+            else
+              {
+                ret = -EDOM;
+              }
+          }
+        break;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        if ((caps->ac_channels != 1 && caps->ac_channels != 2) ||
+            caps->ac_controls.b[2] != 16 || caps->ac_controls.hw[0] == 0)
+          {
+            auderr("ERROR: Unsupported format: %u ch %u bits %u Hz\n",
+                   caps->ac_channels, caps->ac_controls.b[2],
+                   caps->ac_controls.hw[0]);
+            ret = -ERANGE;
+            break;
+          }
+
+        input->nchannels = caps->ac_channels;
+        input->step      = ((uint32_t)caps->ac_controls.hw[0] << 16) /
+                           CONFIG_AUDIO_MIXER_SAMPRATE;
+        break;
+
+      default:
+        break;
+    }
+
+  mixer_givesem(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_shutdown
+ ****************************************************************************/
+
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+
+  mixer_takesem(priv);
+  mixer_flush(input);
+  input->nchannels = 2;
+  input->step      = MIXER_UNITY;
+  input->gain      = MIXER_GAIN_UNITY;
+  mixer_givesem(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_start
+ ****************************************************************************/
+
+static int mixer_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+
+  mixer_takesem(priv);
+  input->running  = true;
+  input->paused   = false;
+  input->eos      = false;
+  input->npartial = 0;
+  input->frac     = MIXER_UNITY;
+  input->next[0]  = 0;
+  input->next[1]  = 0;
+  mixer_givesem(priv);
+
+  /* Start the output if it is not already running */
+
+  mixer_schedule(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+
+  mixer_takesem(priv);
+  mixer_flush(input);
+  mixer_givesem(priv);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_pause and mixer_resume
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+
+  input->paused = true;
+  return OK;
+}
+
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+
+  input->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_enqueuebuffer
+ *
+ * Description:
+ *   Queue an input buffer.  The buffer is returned to the upper half when
+ *   all of its data has been mixed into an output buffer.
+ *
+ ****************************************************************************/
+
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+
+  DEBUGASSERT(apb);
+
+  apb_reference(apb);
+
+  mixer_takesem(priv);
+  dq_addlast((FAR dq_entry_t *)apb, &input->pendq);
+  mixer_givesem(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_cancelbuffer
+ ****************************************************************************/
+
+static int mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                              FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_ioctl
+ ****************************************************************************/
+
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: mixer_reserve and mixer_release
+ *
+ * Description:
+ *   Each input may be used by only one client at a time.
+ *
+ ****************************************************************************/
+
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+  int ret = OK;
+
+  mixer_takesem(priv);
+  if (input->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      input->reserved = true;
+    }
+
+  mixer_givesem(priv);
+  return ret;
+}
+
+static int mixer_release(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct mixer_input_s *input = (FAR struct mixer_input_s *)dev;
+  FAR struct audio_mixer_s *priv = input->mixer;
+
+  mixer_takesem(priv);
+  input->reserved = false;
+  mixer_givesem(priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a software mixer in front of an audio output device and register
+ *   its inputs as audio devices named <name>0, <name>1, ...
+ *
+ * Input Parameters:
+ *   dev  - The lower half of the output device.  The mixer takes exclusive
+ *          ownership of the device.
+ *   name - The base name of the input devices.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev,
+                           FAR const char *name)
+{
+  FAR struct audio_mixer_s *priv;
+  FAR struct mixer_input_s *input;
+  struct audio_buf_desc_s bufdesc;
+  FAR struct ap_buffer_s *apb;
+  char devname[MIXER_NAMELEN];
+  int ret;
+  int i;
+
+  DEBUGASSERT(dev && dev->ops && name);
+
+  priv = (FAR struct audio_mixer_s *)kmm_zalloc(sizeof(struct audio_mixer_s));
+  if (!priv)
+    {
+      auderr("ERROR: Failed to allocate the mixer\n");
+      return -ENOMEM;
+    }
+
+  sem_init(&priv->exclsem, 0, 1);
+  priv->hw = dev;
+
+  /* Reserve the output device for the mixer and take its callbacks */
+
+  ret = dev->ops->reserve(dev);
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to reserve the output device: %d\n", ret);
+      goto errout_with_priv;
+    }
+
+  dev->upper = mixer_hwcallback;
+  dev->priv  = priv;
+
+  /* Allocate the output buffers, from the output device if it has a
+   * preference (DMA-capable memory, for example).
+   */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      bufdesc.numbytes   = CONFIG_AUDIO_MIXER_BUFSIZE;
+      bufdesc.u.ppBuffer = &apb;
+
+      if (dev->ops->allocbuffer)
+        {
+          ret = dev->ops->allocbuffer(dev, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to allocate output buffer: %d\n", ret);
+          goto errout_with_buffers;
+        }
+
+      dq_addlast((FAR dq_entry_t *)apb, &priv->freeq);
+    }
+
+  /* Initialize and register the inputs */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NINPUTS; i++)
+    {
+      input             = &priv->inputs[i];
+      input->export.ops = &g_mixerops;
+      input->mixer      = priv;
+      input->nchannels  = 2;
+      input->step       = MIXER_UNITY;
+      input->gain       = MIXER_GAIN_UNITY;
+
+      snprintf(devname, MIXER_NAMELEN, "%s%d", name, i);
+      ret = audio_register(devname, &input->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+
+errout_with_buffers:
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&priv->freeq)) != NULL)
+    {
+      if (dev->ops->freebuffer)
+        {
+          bufdesc.u.pBuffer = apb;
+          (void)dev->ops->freebuffer(dev, &bufdesc);
+        }
+      else
+        {
+          apb_free(apb);
+        }
+    }
+
+  (void)dev->ops->release(dev);
+
+errout_with_priv:
+  sem_destroy(&priv->exclsem);
+  kmm_free(priv);
+  return ret;
+}
+
+#endif /* CONFIG_AUDIO_MIXER */
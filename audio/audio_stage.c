@@ -0,0 +1,584 @@
+/****************************************************************************
+ * audio/audio_stage.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_stage.h>
+
+#ifdef CONFIG_AUDIO_STAGE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the internal state of one processing stage */
+
+struct audio_stage_s
+{
+  /* This is is our our appearance to the outside world.  This *MUST* be the
+   * first element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct audio_stage_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  /* Our operations.  These are writeable because the buffer allocation
+   * methods are provided only if the lower level driver supports them.
+   */
+
+  struct audio_ops_s ops;
+
+  /* This is the contained lower half device or the next stage */
+
+  FAR struct audio_lowerhalf_s *lower;
+
+  /* The processing performed by this stage */
+
+  FAR const struct audio_stageops_s *stageops;
+  FAR void *arg;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  stage_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+              FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int  stage_configure(FAR struct audio_lowerhalf_s *dev,
+              FAR void *session, FAR const struct audio_caps_s *caps);
+#else
+static int  stage_configure(FAR struct audio_lowerhalf_s *dev,
+              FAR const struct audio_caps_s *caps);
+#endif
+static int  stage_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int  stage_start(FAR struct audio_lowerhalf_s *dev, FAR void *session);
+#else
+static int  stage_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int  stage_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session);
+#else
+static int  stage_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int  stage_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session);
+static int  stage_resume(FAR struct audio_lowerhalf_s *dev,
+              FAR void *session);
+#else
+static int  stage_pause(FAR struct audio_lowerhalf_s *dev);
+static int  stage_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int  stage_allocbuffer(FAR struct audio_lowerhalf_s *dev,
+              FAR struct audio_buf_desc_s *apb);
+static int  stage_freebuffer(FAR struct audio_lowerhalf_s *dev,
+              FAR struct audio_buf_desc_s *apb);
+static int  stage_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+              FAR struct ap_buffer_s *apb);
+static int  stage_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+              FAR struct ap_buffer_s *apb);
+static int  stage_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+              unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int  stage_reserve(FAR struct audio_lowerhalf_s *dev,
+              FAR void **session);
+static int  stage_release(FAR struct audio_lowerhalf_s *dev,
+              FAR void *session);
+#else
+static int  stage_reserve(FAR struct audio_lowerhalf_s *dev);
+static int  stage_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void stage_callback(FAR void *arg, uint16_t reason,
+              FAR struct ap_buffer_s *apb, uint16_t status,
+              FAR void *session);
+#else
+static void stage_callback(FAR void *arg, uint16_t reason,
+              FAR struct ap_buffer_s *apb, uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stage_reset
+ *
+ * Description:
+ *   Discard any processing state carried from one buffer to the next.
+ *
+ ****************************************************************************/
+
+static inline void stage_reset(FAR struct audio_stage_s *priv)
+{
+  if (priv->stageops->reset)
+    {
+      priv->stageops->reset(priv->arg);
+    }
+}
+
+/****************************************************************************
+ * Name: stage_getcaps
+ *
+ * Description:
+ *   Return the capabilities of the lower level device.  A processing stage
+ *   does not change the capabilities.
+ *
+ ****************************************************************************/
+
+static int stage_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->getcaps);
+  return lower->ops->getcaps(lower, type, caps);
+}
+
+/****************************************************************************
+ * Name: stage_configure
+ *
+ * Description:
+ *   Let the stage see the configuration, then pass it to the lower level.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps)
+#else
+static int stage_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+  int ret;
+
+  DEBUGASSERT(lower && lower->ops->configure);
+
+  if (priv->stageops->configure)
+    {
+      ret = priv->stageops->configure(priv->arg, caps);
+      if (ret < 0)
+        {
+          auderr("ERROR: Stage configure failed: %d\n", ret);
+          return ret;
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->configure(lower, session, caps);
+#else
+  return lower->ops->configure(lower, caps);
+#endif
+}
+
+/****************************************************************************
+ * Name: stage_shutdown
+ ****************************************************************************/
+
+static int stage_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->shutdown);
+
+  stage_reset(priv);
+  return lower->ops->shutdown(lower);
+}
+
+/****************************************************************************
+ * Name: stage_start
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_start(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int stage_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->start);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->start(lower, session);
+#else
+  return lower->ops->start(lower);
+#endif
+}
+
+/****************************************************************************
+ * Name: stage_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int stage_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->stop);
+
+  stage_reset(priv);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->stop(lower, session);
+#else
+  return lower->ops->stop(lower);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: stage_pause and stage_resume
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int stage_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->pause);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->pause(lower, session);
+#else
+  return lower->ops->pause(lower);
+#endif
+}
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_resume(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int stage_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->resume);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->resume(lower, session);
+#else
+  return lower->ops->resume(lower);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: stage_allocbuffer and stage_freebuffer
+ *
+ * Description:
+ *   Buffer allocation is deferred to the lower level so that buffers
+ *   allocated by a DMA-capable lower half pass through all stages.
+ *
+ ****************************************************************************/
+
+static int stage_allocbuffer(FAR struct audio_lowerhalf_s *dev,
+                             FAR struct audio_buf_desc_s *apb)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->allocbuffer);
+  return lower->ops->allocbuffer(lower, apb);
+}
+
+static int stage_freebuffer(FAR struct audio_lowerhalf_s *dev,
+                            FAR struct audio_buf_desc_s *apb)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->freebuffer);
+  return lower->ops->freebuffer(lower, apb);
+}
+
+/****************************************************************************
+ * Name: stage_enqueuebuffer
+ *
+ * Description:
+ *   Process the buffer in place, then give the same buffer to the lower
+ *   level.  The lower level returns the buffer through stage_callback when
+ *   it is done with it.
+ *
+ ****************************************************************************/
+
+static int stage_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+  int ret;
+
+  DEBUGASSERT(lower && lower->ops->enqueuebuffer && apb);
+
+  ret = priv->stageops->process(priv->arg, apb);
+  if (ret < 0)
+    {
+      auderr("ERROR: Stage process failed: %d\n", ret);
+      return ret;
+    }
+
+  DEBUGASSERT(apb->curbyte <= apb->nbytes && apb->nbytes <= apb->nmaxbytes);
+
+  audinfo("Pass to lower enqueuebuffer: apb=%p curbyte=%d nbytes=%d\n",
+          apb, apb->curbyte, apb->nbytes);
+
+  return lower->ops->enqueuebuffer(lower, apb);
+}
+
+/****************************************************************************
+ * Name: stage_cancelbuffer
+ ****************************************************************************/
+
+static int stage_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                              FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->cancelbuffer);
+  return lower->ops->cancelbuffer(lower, apb);
+}
+
+/****************************************************************************
+ * Name: stage_ioctl
+ ****************************************************************************/
+
+static int stage_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->ioctl);
+  return lower->ops->ioctl(lower, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: stage_reserve and stage_release
+ *
+ * Description:
+ *   Reserving the stage reserves the lower level device.  With multiple
+ *   sessions, the session of the lower level is passed through unchanged.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session)
+#else
+static int stage_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->reserve);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->reserve(lower, session);
+#else
+  return lower->ops->reserve(lower);
+#endif
+}
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int stage_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session)
+#else
+static int stage_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+
+  DEBUGASSERT(lower && lower->ops->release);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  return lower->ops->release(lower, session);
+#else
+  return lower->ops->release(lower);
+#endif
+}
+
+/****************************************************************************
+ * Name: stage_callback
+ *
+ * Description:
+ *   Lower-to-upper level callback.  The buffers belong to the upper level;
+ *   just forward the event to the next level up.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void stage_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session)
+#else
+static void stage_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+#endif
+{
+  FAR struct audio_stage_s *priv = (FAR struct audio_stage_s *)arg;
+
+  DEBUGASSERT(priv && priv->export.upper);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  priv->export.upper(priv->export.priv, reason, apb, status, session);
+#else
+  priv->export.upper(priv->export.priv, reason, apb, status);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_stage_initialize
+ *
+ * Description:
+ *   Create an audio processing stage in front of a lower half audio device.
+ *
+ * Input Parameters:
+ *   dev - The lower half audio device (or the next stage) that receives
+ *         the processed audio buffers.
+ *   ops - The processing operations of the new stage.
+ *   arg - An opaque argument passed to each processing operation.
+ *
+ * Returned Value:
+ *   On success, a new audio device instance is returned that wraps the
+ *   lower half device.  NULL is returned on failure.
+ *
+ ****************************************************************************/
+
+FAR struct audio_lowerhalf_s *
+  audio_stage_initialize(FAR struct audio_lowerhalf_s *dev,
+                         FAR const struct audio_stageops_s *ops,
+                         FAR void *arg)
+{
+  FAR struct audio_stage_s *priv;
+  FAR struct audio_ops_s *aops;
+
+  DEBUGASSERT(dev && ops && ops->process);
+
+  /* Allocate an instance of our private data structure */
+
+  priv = (FAR struct audio_stage_s *)kmm_zalloc(sizeof(struct audio_stage_s));
+  if (!priv)
+    {
+      auderr("ERROR: Failed to allocate stage structure\n");
+      return NULL;
+    }
+
+  /* Setup our operations */
+
+  aops                  = &priv->ops;
+  aops->getcaps         = stage_getcaps;
+  aops->configure       = stage_configure;
+  aops->shutdown        = stage_shutdown;
+  aops->start           = stage_start;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  aops->stop            = stage_stop;
+#endif
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  aops->pause           = stage_pause;
+  aops->resume          = stage_resume;
+#endif
+
+  if (dev->ops->allocbuffer)
+    {
+      DEBUGASSERT(dev->ops->freebuffer);
+      aops->allocbuffer = stage_allocbuffer;
+      aops->freebuffer  = stage_freebuffer;
+    }
+
+  aops->enqueuebuffer   = stage_enqueuebuffer;
+  aops->cancelbuffer    = stage_cancelbuffer;
+  aops->ioctl           = stage_ioctl;
+  aops->reserve         = stage_reserve;
+  aops->release         = stage_release;
+
+  priv->export.ops      = &priv->ops;
+  priv->stageops        = ops;
+  priv->arg             = arg;
+
+  /* Save the lower level device and intercept its callbacks */
+
+  priv->lower           = dev;
+  dev->upper            = stage_callback;
+  dev->priv             = priv;
+
+  return &priv->export;
+}
+
+#endif /* CONFIG_AUDIO_STAGE */
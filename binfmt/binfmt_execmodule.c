@@ -159,7 +159,8 @@ int exec_module(FAR const struct binary_s *binp)
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)kmm_zalloc_hint(sizeof(struct task_tcb_s),
+                                                MM_PLACE_TCB);
   if (!tcb)
     {
       errcode = ENOMEM;
@@ -0,0 +1,256 @@
+/****************************************************************************
+ * binfmt/binfmt_sharedtext.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/binfmt/binfmt.h>
+
+#include "binfmt.h"
+
+#if !defined(CONFIG_BINFMT_DISABLE) && defined(CONFIG_BINFMT_SHARED_TEXT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Text regions available for sharing, protected by g_text_sem */
+
+static FAR struct binfmt_text_s *g_text_list;
+static sem_t g_text_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_text_takesem
+ ****************************************************************************/
+
+static void binfmt_text_takesem(void)
+{
+  while (sem_wait(&g_text_sem) != 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_text_find
+ *
+ * Description:
+ *   Look for the registered text region of an earlier instance of the
+ *   program file 'filename' that was bound against the same symbol table
+ *   and that has not been modified since.  If found, a reference is added
+ *   that must be dropped with binfmt_text_release().
+ *
+ ****************************************************************************/
+
+FAR struct binfmt_text_s *
+binfmt_text_find(FAR const char *filename,
+                 FAR const struct symtab_s *exports, int nexports)
+{
+  FAR struct binfmt_text_s *text;
+  struct stat buf;
+
+  if (stat(filename, &buf) < 0)
+    {
+      return NULL;
+    }
+
+  binfmt_text_takesem();
+
+  for (text = g_text_list; text != NULL; text = text->flink)
+    {
+      if (text->filesize == buf.st_size && text->mtime == buf.st_mtime &&
+          text->exports == exports && text->nexports == nexports &&
+          strcmp(text->filename, filename) == 0)
+        {
+          DEBUGASSERT(text->crefs > 0 && text->crefs < INT16_MAX);
+          text->crefs++;
+          break;
+        }
+    }
+
+  sem_post(&g_text_sem);
+
+  if (text != NULL)
+    {
+      binfo("Sharing text of %s at %p (%d users)\n",
+            filename, text->addr, text->crefs);
+    }
+
+  return text;
+}
+
+/****************************************************************************
+ * Name: binfmt_text_alloc
+ *
+ * Description:
+ *   Create the descriptor of a newly loaded text region.  The descriptor
+ *   takes over the region (which is freed with kumm_free() or munmap()
+ *   according to 'mapped') and holds one reference to it.  The region is
+ *   not visible to binfmt_text_find() until binfmt_text_share() is called.
+ *
+ ****************************************************************************/
+
+FAR struct binfmt_text_s *
+binfmt_text_alloc(FAR const char *filename,
+                  FAR const struct symtab_s *exports, int nexports,
+                  FAR void *addr, size_t size, bool mapped)
+{
+  FAR struct binfmt_text_s *text;
+  struct stat buf;
+  size_t namelen;
+
+  if (stat(filename, &buf) < 0)
+    {
+      return NULL;
+    }
+
+  /* Allocate the descriptor and the copy of the file name together */
+
+  namelen = strlen(filename) + 1;
+  text    = (FAR struct binfmt_text_s *)
+    kmm_zalloc(sizeof(struct binfmt_text_s) + namelen);
+
+  if (text == NULL)
+    {
+      return NULL;
+    }
+
+  text->filename = (FAR char *)&text[1];
+  memcpy(text->filename, filename, namelen);
+
+  text->filesize = buf.st_size;
+  text->mtime    = buf.st_mtime;
+  text->exports  = exports;
+  text->nexports = nexports;
+  text->addr     = addr;
+  text->size     = size;
+  text->mapped   = mapped;
+  text->crefs    = 1;
+  return text;
+}
+
+/****************************************************************************
+ * Name: binfmt_text_share
+ *
+ * Description:
+ *   Make a text region created by binfmt_text_alloc() available to later
+ *   instances of the same program.
+ *
+ ****************************************************************************/
+
+void binfmt_text_share(FAR struct binfmt_text_s *text)
+{
+  DEBUGASSERT(text != NULL && !text->shared);
+
+  binfmt_text_takesem();
+  text->shared = true;
+  text->flink  = g_text_list;
+  g_text_list  = text;
+  sem_post(&g_text_sem);
+}
+
+/****************************************************************************
+ * Name: binfmt_text_release
+ *
+ * Description:
+ *   Drop one reference to a text region.  The region is freed when the
+ *   last reference is dropped.
+ *
+ ****************************************************************************/
+
+void binfmt_text_release(FAR struct binfmt_text_s *text)
+{
+  FAR struct binfmt_text_s **pprev;
+  bool last;
+
+  DEBUGASSERT(text != NULL && text->crefs > 0);
+
+  binfmt_text_takesem();
+
+  last = (--text->crefs == 0);
+  if (last && text->shared)
+    {
+      for (pprev = &g_text_list; *pprev != NULL; pprev = &(*pprev)->flink)
+        {
+          if (*pprev == text)
+            {
+              *pprev = text->flink;
+              break;
+            }
+        }
+    }
+
+  sem_post(&g_text_sem);
+
+  if (last)
+    {
+      binfo("Freeing text of %s at %p\n", text->filename, text->addr);
+
+      if (text->mapped)
+        {
+          munmap(text->addr, text->size);
+        }
+      else
+        {
+          kumm_free(text->addr);
+        }
+
+      kmm_free(text);
+    }
+}
+
+#endif /* !CONFIG_BINFMT_DISABLE && CONFIG_BINFMT_SHARED_TEXT */
@@ -203,6 +203,16 @@ int unload_module(FAR struct binary_s *binp)
             }
         }
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+      /* Drop this instance's reference to the (possibly shared) text */
+
+      if (binp->text)
+        {
+          binfmt_text_release(binp->text);
+          binp->text = NULL;
+        }
+
+#endif
       /* Notice that the address environment is not destroyed.  This should
        * happen automatically when the task exits.
        */
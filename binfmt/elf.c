@@ -118,6 +118,10 @@ static void elf_dumploadinfo(FAR struct elf_loadinfo_s *loadinfo)
   berr("LOAD_INFO:\n");
   berr("  textalloc:    %08lx\n", (long)loadinfo->textalloc);
   berr("  dataalloc:    %08lx\n", (long)loadinfo->dataalloc);
+  berr("  textbase:     %08lx\n", (long)loadinfo->textbase);
+#ifdef CONFIG_ELF_XIP
+  berr("  xipbase:      %08lx\n", (long)loadinfo->xipbase);
+#endif
   berr("  textsize:     %ld\n",   (long)loadinfo->textsize);
   berr("  datasize:     %ld\n",   (long)loadinfo->datasize);
   berr("  filelen:      %ld\n",   (long)loadinfo->filelen);
@@ -241,6 +245,13 @@ static int elf_loadbinary(FAR struct binary_s *binp)
       goto errout;
     }
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  /* Reuse the text of a running instance of the same file, if any */
+
+  loadinfo.text = binfmt_text_find(binp->filename, binp->exports,
+                                   binp->nexports);
+#endif
+
   /* Load the program binary */
 
   ret = elf_load(&loadinfo);
@@ -262,7 +273,7 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   /* Return the load information */
 
-  binp->entrypt   = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
+  binp->entrypt   = (main_t)(loadinfo.textbase + loadinfo.ehdr.e_entry);
   binp->stacksize = CONFIG_ELF_STACKSIZE;
 
   /* Add the ELF allocation to the alloc[] only if there is no address
@@ -275,6 +286,34 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
 #ifdef CONFIG_ARCH_ADDRENV
 #  warning "REVISIT"
+#elif defined(CONFIG_BINFMT_SHARED_TEXT)
+  /* The text is held by a reference counted descriptor.  It is offered to
+   * later instances of the same file unless it refers to the data of this
+   * instance.
+   */
+
+  if (loadinfo.text == NULL && loadinfo.textalloc != 0)
+    {
+      loadinfo.text = binfmt_text_alloc(binp->filename, binp->exports,
+                                        binp->nexports,
+                                        (FAR void *)loadinfo.textalloc,
+                                        loadinfo.textsize, false);
+      if (loadinfo.text == NULL)
+        {
+          berr("Failed to allocate the text descriptor\n");
+          ret = -ENOMEM;
+          goto errout_with_load;
+        }
+
+      if (!loadinfo.textprivate)
+        {
+          binfmt_text_share(loadinfo.text);
+        }
+    }
+
+  binp->text      = loadinfo.text;
+  binp->alloc[0]  = (FAR void *)loadinfo.dataalloc;
+  loadinfo.text   = NULL;
 #else
   binp->alloc[0]  = (FAR void *)loadinfo.textalloc;
 #endif
@@ -46,8 +46,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <limits.h>
+#include <sched.h>
 #include <errno.h>
 
 #include <nuttx/binfmt/builtin.h>
@@ -56,6 +59,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#if defined(CONFIG_BUILTIN_HASHED) && \
+    (!defined(CONFIG_BUILTIN_HASHSIZE) || CONFIG_BUILTIN_HASHSIZE < 1)
+#  undef CONFIG_BUILTIN_HASHSIZE
+#  define CONFIG_BUILTIN_HASHSIZE 64
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,10 +77,91 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_BUILTIN_HASHED
+/* Open addressed hash table of the builtin names.  Each slot holds the
+ * index of an application plus one; zero marks an empty slot.  The table
+ * of builtin applications is fixed at link time, so the hash table is
+ * built once on the first look-up and never changes afterward.
+ */
+
+static int16_t g_builtin_hash[CONFIG_BUILTIN_HASHSIZE];
+static volatile bool g_builtin_hashed;   /* The hash table is usable */
+static volatile bool g_builtin_linear;   /* Too many builtins for the table */
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: builtin_hash
+ *
+ * Description:
+ *   Return the (FNV-1a) hash of the first NAME_MAX characters of 'name'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILTIN_HASHED
+static uint32_t builtin_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < NAME_MAX && name[i] != '\0'; i++)
+    {
+      hash ^= (uint8_t)name[i];
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: builtin_buildhash
+ *
+ * Description:
+ *   Enter every builtin application into g_builtin_hash[].  If there are
+ *   too many applications for the table, fall back to the linear search.
+ *
+ ****************************************************************************/
+
+static void builtin_buildhash(void)
+{
+  FAR const char *name;
+  unsigned int slot;
+  int i;
+
+  /* Only one thread builds the table */
+
+  sched_lock();
+  if (!g_builtin_hashed && !g_builtin_linear)
+    {
+      for (i = 0; (name = builtin_getname(i)) != NULL; i++)
+        {
+          /* Keep at least one slot empty so that look-ups terminate */
+
+          if (i >= CONFIG_BUILTIN_HASHSIZE - 1 || i >= INT16_MAX)
+            {
+              g_builtin_linear = true;
+              break;
+            }
+
+          slot = builtin_hash(name) % CONFIG_BUILTIN_HASHSIZE;
+          while (g_builtin_hash[slot] != 0)
+            {
+              slot = (slot + 1) % CONFIG_BUILTIN_HASHSIZE;
+            }
+
+          g_builtin_hash[slot] = i + 1;
+        }
+
+      g_builtin_hashed = !g_builtin_linear;
+    }
+
+  sched_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -90,6 +180,33 @@ int builtin_isavail(FAR const char *appname)
   FAR const char *name;
   int i;
 
+#ifdef CONFIG_BUILTIN_HASHED
+  unsigned int slot;
+
+  if (!g_builtin_hashed && !g_builtin_linear)
+    {
+      builtin_buildhash();
+    }
+
+  if (g_builtin_hashed)
+    {
+      slot = builtin_hash(appname) % CONFIG_BUILTIN_HASHSIZE;
+      while ((i = g_builtin_hash[slot]) != 0)
+        {
+          name = builtin_getname(i - 1);
+          if (!strncmp(name, appname, NAME_MAX))
+            {
+              return i - 1;
+            }
+
+          slot = (slot + 1) % CONFIG_BUILTIN_HASHSIZE;
+        }
+
+      set_errno(ENOENT);
+      return ERROR;
+    }
+#endif
+
   for (i = 0; (name = builtin_getname(i)); i++)
     {
       if (!strncmp(name, appname, NAME_MAX))
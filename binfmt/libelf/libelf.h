@@ -43,10 +43,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <elf32.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/binfmt/elf.h>
+#include <nuttx/binfmt/symtab.h>
 
 /****************************************************************************
  * Public Function Prototypes
@@ -224,6 +226,47 @@ int elf_allocbuffer(FAR struct elf_loadinfo_s *loadinfo);
 
 int elf_reallocbuffer(FAR struct elf_loadinfo_s *loadinfo, size_t increment);
 
+/****************************************************************************
+ * Name: elf_symcache_attach
+ *
+ * Description:
+ *   Find (or create) the cache of imported symbol values for the memory-
+ *   mapped ELF file described by 'loadinfo' when bound against 'exports'.
+ *   On return loadinfo->symcache is NULL if no cache could be claimed; the
+ *   binding then simply proceeds without one.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+void elf_symcache_attach(FAR struct elf_loadinfo_s *loadinfo,
+                         FAR const struct symtab_s *exports, int nexports);
+
+/****************************************************************************
+ * Name: elf_symcache_detach
+ *
+ * Description:
+ *   Release the cache claimed by elf_symcache_attach().
+ *
+ ****************************************************************************/
+
+void elf_symcache_detach(FAR struct elf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: elf_symcache_lookup and elf_symcache_store
+ *
+ * Description:
+ *   Get or set the cached value of the imported symbol at index 'symidx' of
+ *   the ELF symbol table.  elf_symcache_lookup() returns false if the value
+ *   is not (yet) known.
+ *
+ ****************************************************************************/
+
+bool elf_symcache_lookup(FAR struct elf_loadinfo_s *loadinfo, int symidx,
+                         FAR Elf32_Word *value);
+void elf_symcache_store(FAR struct elf_loadinfo_s *loadinfo, int symidx,
+                        Elf32_Word value);
+#endif
+
 /****************************************************************************
  * Name: elf_findctors
  *
@@ -44,6 +44,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/binfmt/binfmt.h>
 
 #include "libelf.h"
 
@@ -74,6 +75,10 @@
  *   either case, there will be a unique instance of textalloc and dataalloc
  *   (and stack) for each instance of a process.
  *
+ *   If CONFIG_BINFMT_SHARED_TEXT=y, textalloc and dataalloc are separate
+ *   allocations and textalloc may instead be the text of another running
+ *   instance of the same file (loadinfo->text).
+ *
  * Input Parameters:
  *   loadinfo - Load state information
  *   textsize - The size (in bytes) of the .text address environment needed
@@ -127,6 +132,47 @@ int elf_addrenv_alloc(FAR struct elf_loadinfo_s *loadinfo, size_t textsize,
 
   loadinfo->textalloc = (uintptr_t)vtext;
   loadinfo->dataalloc = (uintptr_t)vdata;
+  return OK;
+#elif defined(CONFIG_BINFMT_SHARED_TEXT)
+  /* The text and data are allocated separately so that the text can be
+   * shared with other instances.  Reuse the text of a running instance of
+   * the file if one was found and it has the expected layout.
+   */
+
+  if (loadinfo->text != NULL && loadinfo->text->size != textsize)
+    {
+      binfmt_text_release(loadinfo->text);
+      loadinfo->text = NULL;
+    }
+
+  if (loadinfo->text != NULL)
+    {
+      loadinfo->textalloc = (uintptr_t)loadinfo->text->addr;
+    }
+  else if (textsize > 0)
+    {
+      loadinfo->textalloc = (uintptr_t)kumm_zalloc(textsize);
+      if (!loadinfo->textalloc)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (datasize > 0)
+    {
+      loadinfo->dataalloc = (uintptr_t)kumm_zalloc(datasize);
+      if (!loadinfo->dataalloc)
+        {
+          if (loadinfo->text == NULL && loadinfo->textalloc != 0)
+            {
+              kumm_free((FAR void *)loadinfo->textalloc);
+            }
+
+          loadinfo->textalloc = 0;
+          return -ENOMEM;
+        }
+    }
+
   return OK;
 #else
   /* Allocate memory to hold the ELF image */
@@ -172,6 +218,23 @@ void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo)
     {
       berr("ERROR: up_addrenv_destroy failed: %d\n", ret);
     }
+#elif defined(CONFIG_BINFMT_SHARED_TEXT)
+  /* Drop the reference to shared text or free the private copy */
+
+  if (loadinfo->text != NULL)
+    {
+      binfmt_text_release(loadinfo->text);
+      loadinfo->text = NULL;
+    }
+  else if (loadinfo->textalloc != 0)
+    {
+      kumm_free((FAR void *)loadinfo->textalloc);
+    }
+
+  if (loadinfo->dataalloc != 0)
+    {
+      kumm_free((FAR void *)loadinfo->dataalloc);
+    }
 #else
   /* If there is an allocation for the ELF image, free it */
 
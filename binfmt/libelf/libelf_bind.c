@@ -40,12 +40,14 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <elf32.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -67,6 +69,22 @@
 #  define CONFIG_ELF_BUFFERSIZE 128
 #endif
 
+#if !defined(CONFIG_ELF_RELOCATION_BUFFERCOUNT) || \
+    CONFIG_ELF_RELOCATION_BUFFERCOUNT < 1
+#  undef CONFIG_ELF_RELOCATION_BUFFERCOUNT
+#  define CONFIG_ELF_RELOCATION_BUFFERCOUNT 32
+#endif
+
+#if !defined(CONFIG_ELF_SYMBOL_CACHECOUNT) || \
+    CONFIG_ELF_SYMBOL_CACHECOUNT < 1
+#  undef CONFIG_ELF_SYMBOL_CACHECOUNT
+#  define CONFIG_ELF_SYMBOL_CACHECOUNT 32
+#endif
+
+#ifndef MIN
+#  define MIN(x,y) ((x) < (y) ? (x) : (y))
+#endif
+
 #ifdef CONFIG_ELF_DUMPBUFFER
 # define elf_dumpbuffer(m,b,n) binfodumpbuffer(m,b,n)
 #else
@@ -77,6 +95,23 @@
  * Private Types
  ****************************************************************************/
 
+/* A resolved symbol table entry */
+
+struct elf_symslot_s
+{
+  int symidx;                 /* Symbol table index (-1: slot unused) */
+  bool nameless;              /* Undefined symbol without a name */
+  Elf32_Sym sym;              /* Symbol with its value resolved */
+};
+
+/* Working buffers of elf_bind() */
+
+struct elf_relocbuf_s
+{
+  Elf32_Rel rels[CONFIG_ELF_RELOCATION_BUFFERCOUNT];
+  struct elf_symslot_s syms[CONFIG_ELF_SYMBOL_CACHECOUNT];
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -85,43 +120,17 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: elf_readrel
- *
- * Description:
- *   Read the ELF32_Rel structure into memory.
- *
- ****************************************************************************/
-
-static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
-                              FAR const Elf32_Shdr *relsec,
-                              int index, FAR Elf32_Rel *rel)
-{
-  off_t offset;
-
-  /* Verify that the symbol table index lies within symbol table */
-
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
-    {
-      berr("Bad relocation symbol index: %d\n", index);
-      return -EINVAL;
-    }
-
-  /* Get the file offset to the symbol table entry */
-
-  offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
-
-  /* And, finally, read the symbol table entry into memory */
-
-  return elf_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
-}
-
 /****************************************************************************
  * Name: elf_relocate and elf_relocateadd
  *
  * Description:
  *   Perform all relocations associated with a section.
  *
+ *   Relocation entries are read CONFIG_ELF_RELOCATION_BUFFERCOUNT at a time
+ *   and resolved symbols are kept in a small direct-mapped cache, since
+ *   most relocations refer to a handful of section symbols and to the same
+ *   few imported functions.
+ *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
  *   failure.
@@ -129,15 +138,21 @@ static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
-                        FAR const struct symtab_s *exports, int nexports)
+                        FAR const struct symtab_s *exports, int nexports,
+                        FAR struct elf_relocbuf_s *buf)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
-  Elf32_Sym       sym;
+  FAR struct elf_symslot_s *slot;
+  FAR Elf32_Rel  *rel;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+  Elf32_Word      value;
+#endif
+  unsigned int    nrels;
+  unsigned int    nread;
   int             symidx;
   int             ret;
   int             i;
@@ -147,79 +162,134 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx,
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
-    {
-      psym = &sym;
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
 
-      /* Read the relocation entry into memory */
+  for (i = 0; i < nrels; i++)
+    {
+      /* Read the next batch of relocation entries into memory */
 
-      ret = elf_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if ((i % CONFIG_ELF_RELOCATION_BUFFERCOUNT) == 0)
         {
-          berr("Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          nread = MIN(nrels - i, CONFIG_ELF_RELOCATION_BUFFERCOUNT);
+
+          ret = elf_read(loadinfo, (FAR uint8_t *)buf->rels,
+                         nread * sizeof(Elf32_Rel),
+                         relsec->sh_offset + i * sizeof(Elf32_Rel));
+          if (ret < 0)
+            {
+              berr("Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              return ret;
+            }
         }
 
+      rel = &buf->rels[i % CONFIG_ELF_RELOCATION_BUFFERCOUNT];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
+      slot   = &buf->syms[symidx % CONFIG_ELF_SYMBOL_CACHECOUNT];
 
-      /* Read the symbol table entry into memory */
-
-      ret = elf_readsym(loadinfo, symidx, &sym);
-      if (ret < 0)
+      if (slot->symidx != symidx)
         {
-          berr("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-               relidx, i, symidx, ret);
-          return ret;
-        }
+          /* Read the symbol table entry into memory */
 
-      /* Get the value of the symbol (in sym.st_value) */
+          slot->symidx = -1;
 
-      ret = elf_symvalue(loadinfo, &sym, exports, nexports);
-      if (ret < 0)
-        {
-          /* The special error -ESRCH is returned only in one condition:  The
-           * symbol has no name.
-           *
-           * There are a few relocations for a few architectures that do
-           * no depend upon a named symbol.  We don't know if that is the
-           * case here, but we will use a NULL symbol pointer to indicate
-           * that case to up_relocate().  That function can then do what
-           * is best.
-           */
-
-          if (ret == -ESRCH)
+          ret = elf_readsym(loadinfo, symidx, &slot->sym);
+          if (ret < 0)
             {
-              berr("Section %d reloc %d: Undefined symbol[%d] has no name: %d\n",
-                  relidx, i, symidx, ret);
-              psym = NULL;
+              berr("Section %d reloc %d: Failed to read symbol[%d]: %d\n",
+                   relidx, i, symidx, ret);
+              return ret;
+            }
+
+          /* Get the value of the symbol (in sym.st_value) */
+
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+          if (slot->sym.st_shndx == SHN_UNDEF &&
+              elf_symcache_lookup(loadinfo, symidx, &value))
+            {
+              /* Already resolved by an earlier launch */
+
+              slot->sym.st_value += value;
+              ret = OK;
             }
           else
             {
-              berr("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
-                  relidx, i, symidx, ret);
-              return ret;
+              value = slot->sym.st_value;
+              ret = elf_symvalue(loadinfo, &slot->sym, exports, nexports);
+              if (ret == OK && slot->sym.st_shndx == SHN_UNDEF)
+                {
+                  elf_symcache_store(loadinfo, symidx,
+                                     slot->sym.st_value - value);
+                }
             }
+#else
+          ret = elf_symvalue(loadinfo, &slot->sym, exports, nexports);
+#endif
+          if (ret < 0)
+            {
+              /* The special error -ESRCH is returned only in one condition:
+               * The symbol has no name.
+               *
+               * There are a few relocations for a few architectures that do
+               * no depend upon a named symbol.  We don't know if that is the
+               * case here, but we will use a NULL symbol pointer to indicate
+               * that case to up_relocate().  That function can then do what
+               * is best.
+               */
+
+              if (ret == -ESRCH)
+                {
+                  berr("Section %d reloc %d: Undefined symbol[%d] has no name: %d\n",
+                      relidx, i, symidx, ret);
+                }
+              else
+                {
+                  berr("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
+                      relidx, i, symidx, ret);
+                  return ret;
+                }
+            }
+
+          slot->symidx   = symidx;
+          slot->nameless = (ret == -ESRCH);
+        }
+
+      psym = slot->nameless ? NULL : &slot->sym;
+
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+      /* Text that refers to per-instance data (or to something that we
+       * cannot identify) differs between instances and may not be shared.
+       */
+
+      if ((dstsec->sh_flags & SHF_WRITE) == 0 &&
+          (psym == NULL ||
+           (psym->st_shndx != SHN_UNDEF &&
+            psym->st_shndx < loadinfo->ehdr.e_shnum &&
+            (loadinfo->shdr[psym->st_shndx].sh_flags & SHF_WRITE) != 0)))
+        {
+          loadinfo->textprivate = true;
         }
+#endif
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           berr("Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           berr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
@@ -257,6 +327,7 @@ static int elf_relocateadd(FAR struct elf_loadinfo_s *loadinfo, int relidx,
 int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
              FAR const struct symtab_s *exports, int nexports)
 {
+  FAR struct elf_relocbuf_s *buf;
 #ifdef CONFIG_ARCH_ADDRENV
   int status;
 #endif
@@ -271,6 +342,14 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return ret;
     }
 
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+  /* Claim the cache of imported symbol values for this image.  It is
+   * released by elf_uninit().
+   */
+
+  elf_symcache_attach(loadinfo, exports, nexports);
+#endif
+
   /* Allocate an I/O buffer.  This buffer is used by elf_symname() to
    * accumulate the variable length symbol name.
    */
@@ -282,6 +361,20 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return -ENOMEM;
     }
 
+  /* Allocate the relocation buffer and the resolved symbol cache */
+
+  buf = (FAR struct elf_relocbuf_s *)kmm_malloc(sizeof(struct elf_relocbuf_s));
+  if (buf == NULL)
+    {
+      berr("Failed to allocate relocation buffer\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_ELF_SYMBOL_CACHECOUNT; i++)
+    {
+      buf->syms[i].symidx = -1;
+    }
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* If CONFIG_ARCH_ADDRENV=y, then the loaded ELF lies in a virtual address
    * space that may not be in place now.  elf_addrenv_select() will
@@ -292,6 +385,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
   if (ret < 0)
     {
       berr("ERROR: elf_addrenv_select() failed: %d\n", ret);
+      kmm_free(buf);
       return ret;
     }
 #endif
@@ -317,11 +411,21 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
           continue;
         }
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+      /* Shared text was already relocated by the instance that loaded it */
+
+      if (loadinfo->text != NULL &&
+          (loadinfo->shdr[infosec].sh_flags & SHF_WRITE) == 0)
+        {
+          continue;
+        }
+#endif
+
       /* Process the relocations by type */
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = elf_relocate(loadinfo, i, exports, nexports);
+          ret = elf_relocate(loadinfo, i, exports, nexports, buf);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
@@ -334,6 +438,8 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
         }
     }
 
+  kmm_free(buf);
+
 #if defined(CONFIG_ARCH_ADDRENV)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
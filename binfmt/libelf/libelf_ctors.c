@@ -192,10 +192,10 @@ int elf_loadctors(FAR struct elf_loadinfo_s *loadinfo)
               FAR uintptr_t *ptr = (uintptr_t *)((FAR void *)(&loadinfo->ctors)[i]);
 
               binfo("ctor %d: %08lx + %08lx = %08lx\n",
-                    i, *ptr, (unsigned long)loadinfo->textalloc,
-                    (unsigned long)(*ptr + loadinfo->textalloc));
+                    i, *ptr, (unsigned long)loadinfo->textbase,
+                    (unsigned long)(*ptr + loadinfo->textbase));
 
-              *ptr += loadinfo->textalloc;
+              *ptr += loadinfo->textbase;
             }
         }
       else
@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
 #include <string.h>
@@ -48,6 +50,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/binfmt/elf.h>
 
 #include "libelf.h"
@@ -124,6 +127,45 @@ static inline int elf_filelen(FAR struct elf_loadinfo_s *loadinfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: elf_xipmap
+ *
+ * Description:
+ *  Get the address of the ELF file if it lies in memory-mapped storage.
+ *
+ *  Only ROMFS is trusted for this:  Other file systems may support
+ *  FIOC_MMAP on memory that can move or be freed while the program is
+ *  still running from it (tmpfs, for example).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static inline void elf_xipmap(FAR struct elf_loadinfo_s *loadinfo)
+{
+  struct statfs buf;
+  FAR void *addr;
+  int ret;
+
+  loadinfo->xipbase = 0;
+
+  ret = fstatfs(loadinfo->filfd, &buf);
+  if (ret < 0 || buf.f_type != ROMFS_MAGIC)
+    {
+      return;
+    }
+
+  ret = ioctl(loadinfo->filfd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+  if (ret < 0)
+    {
+      binfo("File is not memory mapped: %d\n", errno);
+      return;
+    }
+
+  binfo("ELF file mapped at %p\n", addr);
+  loadinfo->xipbase = (uintptr_t)addr;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -170,6 +212,12 @@ int elf_init(FAR const char *filename, FAR struct elf_loadinfo_s *loadinfo)
       return -errval;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* Find out if the file can be accessed (and executed) in place */
+
+  elf_xipmap(loadinfo);
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = elf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr, sizeof(Elf32_Ehdr), 0);
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -79,6 +80,52 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_xipsection
+ *
+ * Description:
+ *   Return true if section 'index' can be used in place in memory-mapped
+ *   storage:  It must be read-only, have data in the file, be suitably
+ *   aligned there, and there must be no relocations to apply to it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static bool elf_xipsection(FAR struct elf_loadinfo_s *loadinfo, int index)
+{
+  FAR Elf32_Shdr *shdr = &loadinfo->shdr[index];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == 0 || (shdr->sh_flags & SHF_WRITE) != 0 ||
+      shdr->sh_type == SHT_NOBITS)
+    {
+      return false;
+    }
+
+  addr = loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr & (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf32_Shdr *relsec = &loadinfo->shdr[i];
+
+      if ((relsec->sh_type == SHT_REL || relsec->sh_type == SHT_RELA) &&
+          relsec->sh_info == index && relsec->sh_size > 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define elf_xipsection(l,i) false
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -110,7 +157,7 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
        * execution.
        */
 
-      if ((shdr->sh_flags & SHF_ALLOC) != 0)
+      if ((shdr->sh_flags & SHF_ALLOC) != 0 && !elf_xipsection(loadinfo, i))
         {
           /* SHF_WRITE indicates that the section address space is write-
            * able
@@ -151,6 +198,7 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
   FAR uint8_t *text;
   FAR uint8_t *data;
   FAR uint8_t **pptr;
+  bool first;
   int ret;
   int i;
 
@@ -160,6 +208,9 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
   text = (FAR uint8_t *)loadinfo->textalloc;
   data = (FAR uint8_t *)loadinfo->dataalloc;
 
+  loadinfo->textbase = loadinfo->textalloc;
+  first = true;
+
   for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
     {
       FAR Elf32_Shdr *shdr = &loadinfo->shdr[i];
@@ -172,6 +223,28 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           continue;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Read-only sections that need no relocation are simply used where
+       * they are in memory-mapped storage.
+       */
+
+      if (elf_xipsection(loadinfo, i))
+        {
+          binfo("%d. %08lx->%08lx (in place)\n", i,
+                (unsigned long)shdr->sh_addr,
+                (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+          shdr->sh_addr = loadinfo->xipbase + shdr->sh_offset;
+          if (first)
+            {
+              loadinfo->textbase = shdr->sh_addr;
+              first = false;
+            }
+
+          continue;
+        }
+#endif
+
       /* SHF_WRITE indicates that the section address space is write-
        * able
        */
@@ -183,12 +256,29 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
       else
         {
           pptr = &text;
+
+          /* The entry point is relative to the first .text section */
+
+          if (first)
+            {
+              loadinfo->textbase = (uintptr_t)text;
+              first = false;
+            }
         }
 
       /* SHT_NOBITS indicates that there is no data in the file for the
        * section.
        */
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+      /* Read-only sections of shared text are already in place */
+
+      if (pptr == &text && loadinfo->text != NULL)
+        {
+          binfo("%d. Shared with a running instance\n", i);
+        }
+      else
+#endif
       if (shdr->sh_type != SHT_NOBITS)
         {
           /* Read the section data from sh_offset to the memory region */
@@ -117,6 +117,25 @@ int elf_read(FAR struct elf_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %ld bytes from offset %ld\n", (long)readsize, (long)offset);
 
+#ifdef CONFIG_ELF_XIP
+  /* If the file is memory mapped, this is just a copy */
+
+  if (loadinfo->xipbase != 0)
+    {
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
+        {
+          berr("Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, (FAR const uint8_t *)loadinfo->xipbase + offset,
+             readsize);
+      elf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
   /* Loop until all of the requested data has been read. */
 
   while (readsize > 0)
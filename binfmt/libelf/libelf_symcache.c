@@ -0,0 +1,326 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_symcache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <semaphore.h>
+#include <elf32.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/binfmt/elf.h>
+#include <nuttx/binfmt/symtab.h>
+
+#include "libelf.h"
+
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cache of imported symbol values of one memory-mapped ELF image.
+ *
+ * Resolving an imported symbol means reading its name from the string table
+ * and searching the exported symbol table for it.  The result depends only
+ * on the image and on the symbol table it is bound against, so it is kept
+ * here and reused by every later relocation against the same symbol, both
+ * within one load and across repeated launches of the same program.
+ *
+ * An image is identified by its address in memory-mapped storage, its
+ * length and the location of its symbol and string tables.
+ */
+
+struct elf_symcache_s
+{
+  FAR struct elf_symcache_s *flink;     /* Supports a singly linked list */
+  FAR const struct symtab_s *exports;   /* Symbol table bound against */
+  int nexports;                         /* Number of symbols in exports */
+  uintptr_t xipbase;                    /* Address of the mapped ELF file */
+  off_t filelen;                        /* Length of the ELF file */
+  off_t symoffset;                      /* File offset of .symtab */
+  off_t stroffset;                      /* File offset of .strtab */
+  unsigned int nsyms;                   /* Number of entries in .symtab */
+  bool busy;                            /* Claimed by a loader */
+  FAR uint32_t *valid;                  /* Bitmap of cached values */
+  Elf32_Word values[1];                 /* Cached values (nsyms entries) */
+};
+
+#define SIZEOF_ELF_SYMCACHE_S(n) \
+  (offsetof(struct elf_symcache_s, values) + (n) * sizeof(Elf32_Word) + \
+   (((n) + 31) >> 5) * sizeof(uint32_t))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Cached images, most recently used first */
+
+static FAR struct elf_symcache_s *g_symcache;
+static unsigned int g_nsymcache;
+static sem_t g_symcache_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_symcache_takesem
+ ****************************************************************************/
+
+static void elf_symcache_takesem(void)
+{
+  while (sem_wait(&g_symcache_sem) != 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_symcache_attach
+ *
+ * Description:
+ *   Find (or create) the cache of imported symbol values for the memory-
+ *   mapped ELF file described by 'loadinfo' when bound against 'exports'.
+ *   On return loadinfo->symcache is NULL if no cache could be claimed; the
+ *   binding then simply proceeds without one.
+ *
+ ****************************************************************************/
+
+void elf_symcache_attach(FAR struct elf_loadinfo_s *loadinfo,
+                         FAR const struct symtab_s *exports, int nexports)
+{
+  FAR struct elf_symcache_s *curr;
+  FAR struct elf_symcache_s *prev;
+  FAR struct elf_symcache_s *victim;
+  FAR struct elf_symcache_s *vprev;
+  FAR Elf32_Shdr *symtab;
+  FAR Elf32_Shdr *strtab;
+  unsigned int nsyms;
+
+  loadinfo->symcache = NULL;
+
+  if (loadinfo->xipbase == 0)
+    {
+      return;
+    }
+
+  symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  nsyms  = symtab->sh_size / sizeof(Elf32_Sym);
+
+  elf_symcache_takesem();
+
+  /* Look for the image, remembering the least recently used idle entry
+   * in case we need to make room for it.
+   */
+
+  victim = NULL;
+  vprev  = NULL;
+
+  for (prev = NULL, curr = g_symcache; curr != NULL;
+       prev = curr, curr = curr->flink)
+    {
+      if (curr->xipbase == loadinfo->xipbase &&
+          curr->filelen == loadinfo->filelen &&
+          curr->symoffset == symtab->sh_offset &&
+          curr->stroffset == strtab->sh_offset &&
+          curr->nsyms == nsyms &&
+          curr->exports == exports &&
+          curr->nexports == nexports)
+        {
+          break;
+        }
+
+      if (!curr->busy)
+        {
+          victim = curr;
+          vprev  = prev;
+        }
+    }
+
+  if (curr != NULL)
+    {
+      /* Found it.  If another task is binding the same image right now,
+       * just do without the cache this time.
+       */
+
+      if (curr->busy)
+        {
+          curr = NULL;
+          goto errout_with_sem;
+        }
+
+      if (prev != NULL)
+        {
+          prev->flink = curr->flink;
+        }
+      else
+        {
+          g_symcache = curr->flink;
+        }
+    }
+  else
+    {
+      /* Not cached.  Evict the least recently used entry if the cache is
+       * full.
+       */
+
+      if (g_nsymcache >= CONFIG_ELF_XIP_NSYMCACHE)
+        {
+          if (victim == NULL)
+            {
+              goto errout_with_sem;
+            }
+
+          if (vprev != NULL)
+            {
+              vprev->flink = victim->flink;
+            }
+          else
+            {
+              g_symcache = victim->flink;
+            }
+
+          kmm_free(victim);
+          g_nsymcache--;
+        }
+
+      curr = (FAR struct elf_symcache_s *)
+        kmm_zalloc(SIZEOF_ELF_SYMCACHE_S(nsyms));
+
+      if (curr == NULL)
+        {
+          berr("ERROR: Failed to allocate symbol cache\n");
+          goto errout_with_sem;
+        }
+
+      curr->exports   = exports;
+      curr->nexports  = nexports;
+      curr->xipbase   = loadinfo->xipbase;
+      curr->filelen   = loadinfo->filelen;
+      curr->symoffset = symtab->sh_offset;
+      curr->stroffset = strtab->sh_offset;
+      curr->nsyms     = nsyms;
+      curr->valid     = (FAR uint32_t *)&curr->values[nsyms];
+      g_nsymcache++;
+    }
+
+  /* Claim the entry and make it the most recently used */
+
+  curr->busy  = true;
+  curr->flink = g_symcache;
+  g_symcache  = curr;
+
+errout_with_sem:
+  sem_post(&g_symcache_sem);
+  loadinfo->symcache = curr;
+}
+
+/****************************************************************************
+ * Name: elf_symcache_detach
+ *
+ * Description:
+ *   Release the cache claimed by elf_symcache_attach().
+ *
+ ****************************************************************************/
+
+void elf_symcache_detach(FAR struct elf_loadinfo_s *loadinfo)
+{
+  if (loadinfo->symcache != NULL)
+    {
+      elf_symcache_takesem();
+      loadinfo->symcache->busy = false;
+      sem_post(&g_symcache_sem);
+
+      loadinfo->symcache = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: elf_symcache_lookup and elf_symcache_store
+ *
+ * Description:
+ *   Get or set the cached value of the imported symbol at index 'symidx' of
+ *   the ELF symbol table.  elf_symcache_lookup() returns false if the value
+ *   is not (yet) known.
+ *
+ *   No locking is needed:  The entry is owned by this loader until it is
+ *   detached.
+ *
+ ****************************************************************************/
+
+bool elf_symcache_lookup(FAR struct elf_loadinfo_s *loadinfo, int symidx,
+                         FAR Elf32_Word *value)
+{
+  FAR struct elf_symcache_s *cache = loadinfo->symcache;
+
+  if (cache == NULL || symidx < 0 ||
+      (unsigned int)symidx >= cache->nsyms ||
+      (cache->valid[symidx >> 5] & ((uint32_t)1 << (symidx & 31))) == 0)
+    {
+      return false;
+    }
+
+  *value = cache->values[symidx];
+  return true;
+}
+
+void elf_symcache_store(FAR struct elf_loadinfo_s *loadinfo, int symidx,
+                        Elf32_Word value)
+{
+  FAR struct elf_symcache_s *cache = loadinfo->symcache;
+
+  if (cache != NULL && symidx >= 0 && (unsigned int)symidx < cache->nsyms)
+    {
+      cache->values[symidx] = value;
+      cache->valid[symidx >> 5] |= ((uint32_t)1 << (symidx & 31));
+    }
+}
+
+#endif /* CONFIG_ELF_XIP && CONFIG_ELF_XIP_NSYMCACHE > 0 */
@@ -83,6 +83,12 @@ int elf_uninit(struct elf_loadinfo_s *loadinfo)
 
   elf_freebuffers(loadinfo);
 
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+  /* Release the imported symbol cache so that the next launch can use it */
+
+  elf_symcache_detach(loadinfo);
+#endif
+
   /* Close the ELF file */
 
   if (loadinfo->filfd >= 0)
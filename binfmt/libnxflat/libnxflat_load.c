@@ -50,6 +50,7 @@
 
 #include <arpa/inet.h>
 
+#include <nuttx/binfmt/binfmt.h>
 #include <nuttx/binfmt/nxflat.h>
 
 #include "libnxflat.h"
@@ -146,15 +147,33 @@ int nxflat_load(struct nxflat_loadinfo_s *loadinfo)
    * resides as long as it is fully initialized and ready to execute.
    */
 
-  loadinfo->ispace = (uint32_t)mmap(NULL, loadinfo->isize, PROT_READ,
-                                    MAP_SHARED | MAP_FILE, loadinfo->filfd, 0);
-  if (loadinfo->ispace == (uint32_t)MAP_FAILED)
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  /* ISpace is never modified after it is mapped so, if another instance of
+   * the same file is running, just reuse its mapping.
+   */
+
+  if (loadinfo->text != NULL)
     {
-      berr("Failed to map NXFLAT ISpace: %d\n", errno);
-      return -errno;
+      loadinfo->ispace = (uintptr_t)loadinfo->text->addr;
+      binfo("Sharing ISpace (%d bytes) at %08x\n",
+            loadinfo->isize, loadinfo->ispace);
+    }
+  else
+#endif
+    {
+      loadinfo->ispace = (uint32_t)mmap(NULL, loadinfo->isize, PROT_READ,
+                                        MAP_SHARED | MAP_FILE,
+                                        loadinfo->filfd, 0);
+      if (loadinfo->ispace == (uint32_t)MAP_FAILED)
+        {
+          berr("Failed to map NXFLAT ISpace: %d\n", errno);
+          loadinfo->ispace = 0;
+          return -errno;
+        }
+
+      binfo("Mapped ISpace (%d bytes) at %08x\n",
+            loadinfo->isize, loadinfo->ispace);
     }
-
-  binfo("Mapped ISpace (%d bytes) at %08x\n", loadinfo->isize, loadinfo->ispace);
 
   /* The following call allocate D-Space memory and will provide a pointer
    * to the allocated (but still uninitialized) D-Space memory.
@@ -45,6 +45,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/binfmt/binfmt.h>
 #include <nuttx/binfmt/nxflat.h>
 
 #include "libnxflat.h"
@@ -84,6 +85,15 @@ int nxflat_unload(FAR struct nxflat_loadinfo_s *loadinfo)
   /* Release the memory segments */
   /* Release the I-Space mmap'ed file */
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  if (loadinfo->text)
+    {
+      binfmt_text_release(loadinfo->text);
+      loadinfo->text   = NULL;
+      loadinfo->ispace = 0;
+    }
+#endif
+
   if (loadinfo->ispace)
     {
       munmap((FAR void *)loadinfo->ispace, loadinfo->isize);
@@ -163,6 +163,12 @@ static int nxflat_loadbinary(struct binary_s *binp)
       goto errout;
     }
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  /* Reuse the ISpace of a running instance of the same file, if any */
+
+  loadinfo.text = binfmt_text_find(binp->filename, NULL, 0);
+#endif
+
   /* Load the program binary */
 
   ret = nxflat_load(&loadinfo);
@@ -187,10 +193,37 @@ static int nxflat_loadbinary(struct binary_s *binp)
    */
 
   binp->entrypt   = (main_t)(loadinfo.ispace + loadinfo.entryoffs);
-  binp->mapped    = (FAR void *)loadinfo.ispace;
-  binp->mapsize   = loadinfo.isize;
   binp->stacksize = loadinfo.stacksize;
 
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  /* Hand the ISpace over to a reference counted text descriptor so that
+   * later instances of the same file can share it.
+   */
+
+  if (loadinfo.text == NULL)
+    {
+      loadinfo.text =
+        binfmt_text_alloc(binp->filename, NULL, 0,
+                          (FAR void *)loadinfo.ispace, loadinfo.isize, true);
+      if (loadinfo.text != NULL)
+        {
+          binfmt_text_share(loadinfo.text);
+        }
+    }
+
+  if (loadinfo.text != NULL)
+    {
+      binp->text     = loadinfo.text;
+      loadinfo.text  = NULL;
+    }
+  else
+#endif
+    {
+      binp->mapped   = (FAR void *)loadinfo.ispace;
+      binp->mapsize  = loadinfo.isize;
+    }
+
+
   /* Add the ELF allocation to the alloc[] only if there is no address
    * enironment.  If there is an address environment, it will automatically
    * be freed when the function exits
@@ -222,6 +255,13 @@ static int nxflat_loadbinary(struct binary_s *binp)
 errout_with_load:
   nxflat_unload(&loadinfo);
 errout_with_init:
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  if (loadinfo.text != NULL)
+    {
+      binfmt_text_release(loadinfo.text);
+    }
+
+#endif
   nxflat_uninit(&loadinfo);
 errout:
   return ret;
@@ -46,6 +46,7 @@
 
 #include <nuttx/board.h>
 #include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/timers/oneshot.h>
 #include <nuttx/wireless/pktradio.h>
@@ -127,6 +128,11 @@ int sim_bringup(void)
 
       sched_oneshot_extclk(oneshot);
 
+#elif defined(CONFIG_HRTIMER)
+      /* Use the oneshot timer to drive the high resolution timers */
+
+      hrtimer_initialize(oneshot);
+
 #else
       /* Initialize the simulated oneshot driver */
 
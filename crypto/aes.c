@@ -34,11 +34,6 @@
  *
  ****************************************************************************/
 
-/* TODO: Adapt interfaces so that they are consistent with H/W AES
- * implemenations.  This needs to support up_aesinitialize() and
- * aes_cypher() per include/nuttx/crypto/crypto.h.
- */
-
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -46,13 +41,42 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
 
+#include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/aes.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROTR8(x)   (((x) >> 8)  | ((x) << 24))
+#define ROTR16(x)  (((x) >> 16) | ((x) << 16))
+#define ROTR24(x)  (((x) >> 24) | ((x) << 8))
+#define ROTL8(x)   ROTR24(x)
+#define ROTL16(x)  ROTR16(x)
+#define ROTL24(x)  ROTR8(x)
+
+#define BYTE0(x)   ((x) & 0xff)
+#define BYTE1(x)   (((x) >> 8) & 0xff)
+#define BYTE2(x)   (((x) >> 16) & 0xff)
+#define BYTE3(x)   ((x) >> 24)
+
+/* Multiply each of the four bytes of a word by 2 in GF(2^8) without
+ * branches.
+ */
+
+#define XTIME32(x) \
+  ((((x) & 0x7f7f7f7f) << 1) ^ ((((x) >> 7) & 0x01010101) * 0x1b))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_AES_TTABLE
 /* Forward sbox */
 
 static const uint8_t g_sbox[256] =
@@ -98,6 +122,110 @@ static const uint8_t g_rsbox[256] =
   0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
 };
 
+/* Forward table: SubBytes combined with the MixColumns contribution of
+ * row 0, i.e. {2, 1, 1, 3} * S[x] with row 0 in the least significant
+ * byte.  Rows 1-3 use the same table rotated left by 8, 16 and 24 bits.
+ */
+
+static const uint32_t g_te[256] =
+{
+  0xa56363c6, 0x847c7cf8, 0x997777ee, 0x8d7b7bf6, 0x0df2f2ff, 0xbd6b6bd6,
+  0xb16f6fde, 0x54c5c591, 0x50303060, 0x03010102, 0xa96767ce, 0x7d2b2b56,
+  0x19fefee7, 0x62d7d7b5, 0xe6abab4d, 0x9a7676ec, 0x45caca8f, 0x9d82821f,
+  0x40c9c989, 0x877d7dfa, 0x15fafaef, 0xeb5959b2, 0xc947478e, 0x0bf0f0fb,
+  0xecadad41, 0x67d4d4b3, 0xfda2a25f, 0xeaafaf45, 0xbf9c9c23, 0xf7a4a453,
+  0x967272e4, 0x5bc0c09b, 0xc2b7b775, 0x1cfdfde1, 0xae93933d, 0x6a26264c,
+  0x5a36366c, 0x413f3f7e, 0x02f7f7f5, 0x4fcccc83, 0x5c343468, 0xf4a5a551,
+  0x34e5e5d1, 0x08f1f1f9, 0x937171e2, 0x73d8d8ab, 0x53313162, 0x3f15152a,
+  0x0c040408, 0x52c7c795, 0x65232346, 0x5ec3c39d, 0x28181830, 0xa1969637,
+  0x0f05050a, 0xb59a9a2f, 0x0907070e, 0x36121224, 0x9b80801b, 0x3de2e2df,
+  0x26ebebcd, 0x6927274e, 0xcdb2b27f, 0x9f7575ea, 0x1b090912, 0x9e83831d,
+  0x742c2c58, 0x2e1a1a34, 0x2d1b1b36, 0xb26e6edc, 0xee5a5ab4, 0xfba0a05b,
+  0xf65252a4, 0x4d3b3b76, 0x61d6d6b7, 0xceb3b37d, 0x7b292952, 0x3ee3e3dd,
+  0x712f2f5e, 0x97848413, 0xf55353a6, 0x68d1d1b9, 0x00000000, 0x2cededc1,
+  0x60202040, 0x1ffcfce3, 0xc8b1b179, 0xed5b5bb6, 0xbe6a6ad4, 0x46cbcb8d,
+  0xd9bebe67, 0x4b393972, 0xde4a4a94, 0xd44c4c98, 0xe85858b0, 0x4acfcf85,
+  0x6bd0d0bb, 0x2aefefc5, 0xe5aaaa4f, 0x16fbfbed, 0xc5434386, 0xd74d4d9a,
+  0x55333366, 0x94858511, 0xcf45458a, 0x10f9f9e9, 0x06020204, 0x817f7ffe,
+  0xf05050a0, 0x443c3c78, 0xba9f9f25, 0xe3a8a84b, 0xf35151a2, 0xfea3a35d,
+  0xc0404080, 0x8a8f8f05, 0xad92923f, 0xbc9d9d21, 0x48383870, 0x04f5f5f1,
+  0xdfbcbc63, 0xc1b6b677, 0x75dadaaf, 0x63212142, 0x30101020, 0x1affffe5,
+  0x0ef3f3fd, 0x6dd2d2bf, 0x4ccdcd81, 0x140c0c18, 0x35131326, 0x2fececc3,
+  0xe15f5fbe, 0xa2979735, 0xcc444488, 0x3917172e, 0x57c4c493, 0xf2a7a755,
+  0x827e7efc, 0x473d3d7a, 0xac6464c8, 0xe75d5dba, 0x2b191932, 0x957373e6,
+  0xa06060c0, 0x98818119, 0xd14f4f9e, 0x7fdcdca3, 0x66222244, 0x7e2a2a54,
+  0xab90903b, 0x8388880b, 0xca46468c, 0x29eeeec7, 0xd3b8b86b, 0x3c141428,
+  0x79dedea7, 0xe25e5ebc, 0x1d0b0b16, 0x76dbdbad, 0x3be0e0db, 0x56323264,
+  0x4e3a3a74, 0x1e0a0a14, 0xdb494992, 0x0a06060c, 0x6c242448, 0xe45c5cb8,
+  0x5dc2c29f, 0x6ed3d3bd, 0xefacac43, 0xa66262c4, 0xa8919139, 0xa4959531,
+  0x37e4e4d3, 0x8b7979f2, 0x32e7e7d5, 0x43c8c88b, 0x5937376e, 0xb76d6dda,
+  0x8c8d8d01, 0x64d5d5b1, 0xd24e4e9c, 0xe0a9a949, 0xb46c6cd8, 0xfa5656ac,
+  0x07f4f4f3, 0x25eaeacf, 0xaf6565ca, 0x8e7a7af4, 0xe9aeae47, 0x18080810,
+  0xd5baba6f, 0x887878f0, 0x6f25254a, 0x722e2e5c, 0x241c1c38, 0xf1a6a657,
+  0xc7b4b473, 0x51c6c697, 0x23e8e8cb, 0x7cdddda1, 0x9c7474e8, 0x211f1f3e,
+  0xdd4b4b96, 0xdcbdbd61, 0x868b8b0d, 0x858a8a0f, 0x907070e0, 0x423e3e7c,
+  0xc4b5b571, 0xaa6666cc, 0xd8484890, 0x05030306, 0x01f6f6f7, 0x120e0e1c,
+  0xa36161c2, 0x5f35356a, 0xf95757ae, 0xd0b9b969, 0x91868617, 0x58c1c199,
+  0x271d1d3a, 0xb99e9e27, 0x38e1e1d9, 0x13f8f8eb, 0xb398982b, 0x33111122,
+  0xbb6969d2, 0x70d9d9a9, 0x898e8e07, 0xa7949433, 0xb69b9b2d, 0x221e1e3c,
+  0x92878715, 0x20e9e9c9, 0x49cece87, 0xff5555aa, 0x78282850, 0x7adfdfa5,
+  0x8f8c8c03, 0xf8a1a159, 0x80898909, 0x170d0d1a, 0xdabfbf65, 0x31e6e6d7,
+  0xc6424284, 0xb86868d0, 0xc3414182, 0xb0999929, 0x772d2d5a, 0x110f0f1e,
+  0xcbb0b07b, 0xfc5454a8, 0xd6bbbb6d, 0x3a16162c
+};
+
+/* Inverse table: InvSubBytes combined with the InvMixColumns contribution
+ * of row 0, i.e. {14, 9, 13, 11} * IS[x].
+ */
+
+static const uint32_t g_td[256] =
+{
+  0x50a7f451, 0x5365417e, 0xc3a4171a, 0x965e273a, 0xcb6bab3b, 0xf1459d1f,
+  0xab58faac, 0x9303e34b, 0x55fa3020, 0xf66d76ad, 0x9176cc88, 0x254c02f5,
+  0xfcd7e54f, 0xd7cb2ac5, 0x80443526, 0x8fa362b5, 0x495ab1de, 0x671bba25,
+  0x980eea45, 0xe1c0fe5d, 0x02752fc3, 0x12f04c81, 0xa397468d, 0xc6f9d36b,
+  0xe75f8f03, 0x959c9215, 0xeb7a6dbf, 0xda595295, 0x2d83bed4, 0xd3217458,
+  0x2969e049, 0x44c8c98e, 0x6a89c275, 0x78798ef4, 0x6b3e5899, 0xdd71b927,
+  0xb64fe1be, 0x17ad88f0, 0x66ac20c9, 0xb43ace7d, 0x184adf63, 0x82311ae5,
+  0x60335197, 0x457f5362, 0xe07764b1, 0x84ae6bbb, 0x1ca081fe, 0x942b08f9,
+  0x58684870, 0x19fd458f, 0x876cde94, 0xb7f87b52, 0x23d373ab, 0xe2024b72,
+  0x578f1fe3, 0x2aab5566, 0x0728ebb2, 0x03c2b52f, 0x9a7bc586, 0xa50837d3,
+  0xf2872830, 0xb2a5bf23, 0xba6a0302, 0x5c8216ed, 0x2b1ccf8a, 0x92b479a7,
+  0xf0f207f3, 0xa1e2694e, 0xcdf4da65, 0xd5be0506, 0x1f6234d1, 0x8afea6c4,
+  0x9d532e34, 0xa055f3a2, 0x32e18a05, 0x75ebf6a4, 0x39ec830b, 0xaaef6040,
+  0x069f715e, 0x51106ebd, 0xf98a213e, 0x3d06dd96, 0xae053edd, 0x46bde64d,
+  0xb58d5491, 0x055dc471, 0x6fd40604, 0xff155060, 0x24fb9819, 0x97e9bdd6,
+  0xcc434089, 0x779ed967, 0xbd42e8b0, 0x888b8907, 0x385b19e7, 0xdbeec879,
+  0x470a7ca1, 0xe90f427c, 0xc91e84f8, 0x00000000, 0x83868009, 0x48ed2b32,
+  0xac70111e, 0x4e725a6c, 0xfbff0efd, 0x5638850f, 0x1ed5ae3d, 0x27392d36,
+  0x64d90f0a, 0x21a65c68, 0xd1545b9b, 0x3a2e3624, 0xb1670a0c, 0x0fe75793,
+  0xd296eeb4, 0x9e919b1b, 0x4fc5c080, 0xa220dc61, 0x694b775a, 0x161a121c,
+  0x0aba93e2, 0xe52aa0c0, 0x43e0223c, 0x1d171b12, 0x0b0d090e, 0xadc78bf2,
+  0xb9a8b62d, 0xc8a91e14, 0x8519f157, 0x4c0775af, 0xbbdd99ee, 0xfd607fa3,
+  0x9f2601f7, 0xbcf5725c, 0xc53b6644, 0x347efb5b, 0x7629438b, 0xdcc623cb,
+  0x68fcedb6, 0x63f1e4b8, 0xcadc31d7, 0x10856342, 0x40229713, 0x2011c684,
+  0x7d244a85, 0xf83dbbd2, 0x1132f9ae, 0x6da129c7, 0x4b2f9e1d, 0xf330b2dc,
+  0xec52860d, 0xd0e3c177, 0x6c16b32b, 0x99b970a9, 0xfa489411, 0x2264e947,
+  0xc48cfca8, 0x1a3ff0a0, 0xd82c7d56, 0xef903322, 0xc74e4987, 0xc1d138d9,
+  0xfea2ca8c, 0x360bd498, 0xcf81f5a6, 0x28de7aa5, 0x268eb7da, 0xa4bfad3f,
+  0xe49d3a2c, 0x0d927850, 0x9bcc5f6a, 0x62467e54, 0xc2138df6, 0xe8b8d890,
+  0x5ef7392e, 0xf5afc382, 0xbe805d9f, 0x7c93d069, 0xa92dd56f, 0xb31225cf,
+  0x3b99acc8, 0xa77d1810, 0x6e639ce8, 0x7bbb3bdb, 0x097826cd, 0xf418596e,
+  0x01b79aec, 0xa89a4f83, 0x656e95e6, 0x7ee6ffaa, 0x08cfbc21, 0xe6e815ef,
+  0xd99be7ba, 0xce366f4a, 0xd4099fea, 0xd67cb029, 0xafb2a431, 0x31233f2a,
+  0x3094a5c6, 0xc066a235, 0x37bc4e74, 0xa6ca82fc, 0xb0d090e0, 0x15d8a733,
+  0x4a9804f1, 0xf7daec41, 0x0e50cd7f, 0x2ff69117, 0x8dd64d76, 0x4db0ef43,
+  0x544daacc, 0xdf0496e4, 0xe3b5d19e, 0x1b886a4c, 0xb81f2cc1, 0x7f516546,
+  0x04ea5e9d, 0x5d358c01, 0x737487fa, 0x2e410bfb, 0x5a1d67b3, 0x52d2db92,
+  0x335610e9, 0x1347d66d, 0x8c61d79a, 0x7a0ca137, 0x8e14f859, 0x893c13eb,
+  0xee27a9ce, 0x35c961b7, 0xede51ce1, 0x3cb1477a, 0x59dfd29c, 0x3f73f255,
+  0x79ce1418, 0xbf37c773, 0xeacdf753, 0x5baafd5f, 0x146f3ddf, 0x86db4478,
+  0x81f3afca, 0x3ec468b9, 0x2c342438, 0x5f40a3c2, 0x72c31d16, 0x0c25e2bc,
+  0x8b493c28, 0x41950dff, 0x7101a839, 0xdeb30c08, 0x9ce4b4d8, 0x90c15664,
+  0x6184cb7b, 0x70b632d5, 0x745c6c48, 0x4257b8d0
+};
+#endif /* CONFIG_CRYPTO_AES_TTABLE */
+
 /* Round constant */
 
 static const uint8_t g_rcon[11] =
@@ -105,445 +233,775 @@ static const uint8_t g_rcon[11] =
   0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
 };
 
-static uint8_t g_expanded_key[176];
+/* Expanded key of the legacy aes_encrypt() and aes_decrypt() interfaces */
+
+static struct aes_context_s g_legacy_ctx;
+
+#if defined(CONFIG_CRYPTO_AES) && !defined(CONFIG_CRYPTO_AES_ARCH)
+/* aes_cypher() keeps the key schedule of the last key that it was called
+ * with.  Most users (such as BCH encryption) use the same key over and
+ * over again.
+ */
+
+static sem_t g_aes_lock = SEM_INITIALIZER(1);
+static struct aes_context_s g_aes_ctx;
+static uint8_t g_aes_key[AES256_KEY_SIZE];
+static uint8_t g_aes_keylen;
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: expand_key
+ * Name: aes_getword and aes_putword
  *
  * Description:
- *   Expend a 16 bytes key for AES128 implementation
+ *   Load and store a column of the state.  Row 0 is the least significant
+ *   byte.  The buffers need not be aligned.
  *
- * Input Parameters:
- *  key          AES128 key - 16 bytes
- *  expanded_key expanded AES128 key
+ ****************************************************************************/
+
+static inline uint32_t aes_getword(FAR const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static inline void aes_putword(FAR uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+#ifdef CONFIG_CRYPTO_AES_CT
+/****************************************************************************
+ * Name: aes_gfmul
  *
- * Returned Value:
- *  None
+ * Description:
+ *   Bitsliced multiplication in GF(2^8):  Bit n of word i is bit i of lane
+ *   n, so each AND/XOR operates on 32 field elements in parallel.
  *
  ****************************************************************************/
 
-static void expand_key(FAR uint8_t *expanded_key, FAR const uint8_t *key)
+static void aes_gfreduce(FAR uint32_t *r, FAR uint32_t *c)
 {
-  uint16_t buf1;
-  uint16_t ii;
+  int k;
+
+  /* x^8 = x^4 + x^3 + x + 1 */
 
-  for (ii = 0; ii < 16; ii++)
+  for (k = 14; k >= 8; k--)
     {
-      expanded_key[ii] = key[ii];
+      c[k - 4] ^= c[k];
+      c[k - 5] ^= c[k];
+      c[k - 7] ^= c[k];
+      c[k - 8] ^= c[k];
     }
 
-  for (ii = 1; ii < 11; ii++)
+  for (k = 0; k < 8; k++)
     {
-      buf1 = expanded_key[ii*16 - 4];
-      expanded_key[ii * 16 + 0] = g_sbox[expanded_key[ii *16 - 3]] ^ expanded_key[(ii - 1) * 16 + 0] ^ g_rcon[ii];
-      expanded_key[ii * 16 + 1] = g_sbox[expanded_key[ii *16 - 2]] ^ expanded_key[(ii - 1) * 16 + 1];
-      expanded_key[ii * 16 + 2] = g_sbox[expanded_key[ii *16 - 1]] ^ expanded_key[(ii - 1) * 16 + 2];
-      expanded_key[ii * 16 + 3] = g_sbox[buf1] ^ expanded_key[(ii - 1) * 16 + 3];
-      expanded_key[ii * 16 + 4] = expanded_key[(ii - 1) * 16 + 4] ^ expanded_key[ii * 16 + 0];
-      expanded_key[ii * 16 + 5] = expanded_key[(ii - 1) * 16 + 5] ^ expanded_key[ii * 16 + 1];
-      expanded_key[ii * 16 + 6] = expanded_key[(ii - 1) * 16 + 6] ^ expanded_key[ii * 16 + 2];
-      expanded_key[ii * 16 + 7] = expanded_key[(ii - 1) * 16 + 7] ^ expanded_key[ii * 16 + 3];
-      expanded_key[ii * 16 + 8] = expanded_key[(ii - 1) * 16 + 8] ^ expanded_key[ii * 16 + 4];
-      expanded_key[ii * 16 + 9] = expanded_key[(ii - 1) * 16 + 9] ^ expanded_key[ii * 16 + 5];
-      expanded_key[ii * 16 +10] = expanded_key[(ii - 1) * 16 +10] ^ expanded_key[ii * 16 + 6];
-      expanded_key[ii * 16 +11] = expanded_key[(ii - 1) * 16 +11] ^ expanded_key[ii * 16 + 7];
-      expanded_key[ii * 16 +12] = expanded_key[(ii - 1) * 16 +12] ^ expanded_key[ii * 16 + 8];
-      expanded_key[ii * 16 +13] = expanded_key[(ii - 1) * 16 +13] ^ expanded_key[ii * 16 + 9];
-      expanded_key[ii * 16 +14] = expanded_key[(ii - 1) * 16 +14] ^ expanded_key[ii * 16 +10];
-      expanded_key[ii * 16 +15] = expanded_key[(ii - 1) * 16 +15] ^ expanded_key[ii * 16 +11];
+      r[k] = c[k];
     }
 }
 
-/******************************************************************************
- * Name: galois_mul2
+static void aes_gfmul(FAR uint32_t *r, FAR const uint32_t *a,
+                      FAR const uint32_t *b)
+{
+  uint32_t c[15];
+  int i;
+  int j;
+
+  memset(c, 0, sizeof(c));
+  for (i = 0; i < 8; i++)
+    {
+      for (j = 0; j < 8; j++)
+        {
+          c[i + j] ^= a[i] & b[j];
+        }
+    }
+
+  aes_gfreduce(r, c);
+}
+
+/****************************************************************************
+ * Name: aes_gfsqr
  *
  * Description:
- *    Multiply by 2 in the galois field
+ *   Bitsliced squaring, which is linear in GF(2^8).
  *
- * Input Parameters:
- *  value    argument to multiply
+ ****************************************************************************/
+
+static void aes_gfsqr(FAR uint32_t *r, FAR const uint32_t *a)
+{
+  uint32_t c[15];
+  int i;
+
+  memset(c, 0, sizeof(c));
+  for (i = 0; i < 8; i++)
+    {
+      c[2 * i] = a[i];
+    }
+
+  aes_gfreduce(r, c);
+}
+
+/****************************************************************************
+ * Name: aes_transpose8
+ *
+ * Description:
+ *   Transpose an 8x8 bit matrix:  Bit j of byte i becomes bit i of byte j.
+ *   The transposition is its own inverse.
  *
- * Returned Value:
- *  Multiplied argument
+ ****************************************************************************/
+
+static inline uint64_t aes_transpose8(uint64_t x)
+{
+  uint64_t t;
+
+  t = (x ^ (x >> 7))  & 0x00aa00aa00aa00aaull;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000cccc0000ccccull;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ull;
+  x = x ^ t ^ (t << 28);
+  return x;
+}
+
+/****************************************************************************
+ * Name: aes_ctsbox
+ *
+ * Description:
+ *   Apply the S-box (or its inverse) to 'nwords' words (4 * nwords bytes)
+ *   without any table lookups or data dependent branches.  The bytes are
+ *   transposed into bitsliced form, inverted in GF(2^8) as x^254 and
+ *   passed through the affine transformation.
  *
- ******************************************************************************/
+ ****************************************************************************/
 
-static uint8_t galois_mul2(uint8_t value)
+static void aes_ctsbox(FAR uint32_t *s, int nwords, bool inverse)
 {
-  if (value >> 7)
+  uint32_t x[8];
+  uint32_t x2[8];
+  uint32_t x3[8];
+  uint32_t x12[8];
+  uint32_t y[8];
+  uint64_t v;
+  int i;
+  int b;
+
+  /* Transpose into bitsliced form, eight bytes at a time */
+
+  memset(x, 0, sizeof(x));
+  for (i = 0; i < nwords; i += 2)
     {
-      value = value << 1;
-      return (value ^ 0x1b);
+      v = s[i];
+      if (i + 1 < nwords)
+        {
+          v |= (uint64_t)s[i + 1] << 32;
+        }
+
+      v = aes_transpose8(v);
+      for (b = 0; b < 8; b++)
+        {
+          x[b] |= (uint32_t)((v >> (8 * b)) & 0xff) << (4 * i);
+        }
     }
-  else
+
+  if (inverse)
+    {
+      /* Inverse affine transformation:  x_i = y_(i+2) ^ y_(i+5) ^ y_(i+7)
+       * ^ 0x05
+       */
+
+      for (b = 0; b < 8; b++)
+        {
+          y[b] = x[(b + 2) & 7] ^ x[(b + 5) & 7] ^ x[(b + 7) & 7];
+        }
+
+      y[0] = ~y[0];
+      y[2] = ~y[2];
+      memcpy(x, y, sizeof(x));
+    }
+
+  /* x^254 = x^-1 (and 0 for 0):  x^2, x^3, x^12, x^15, x^14, x^240, then
+   * x^254 = x^240 * x^14.
+   */
+
+  aes_gfsqr(x2, x);
+  aes_gfmul(x3, x2, x);
+  aes_gfsqr(x12, x3);
+  aes_gfsqr(x12, x12);
+  aes_gfmul(y, x12, x3);        /* x^15 */
+  aes_gfmul(x12, x12, x2);      /* x^14 */
+  aes_gfsqr(y, y);
+  aes_gfsqr(y, y);
+  aes_gfsqr(y, y);
+  aes_gfsqr(y, y);              /* x^240 */
+  aes_gfmul(x, y, x12);         /* x^254 */
+
+  if (!inverse)
     {
-      return value << 1;
+      /* Affine transformation:  y_i = x_i ^ x_(i+4) ^ x_(i+5) ^ x_(i+6) ^
+       * x_(i+7) ^ 0x63
+       */
+
+      for (b = 0; b < 8; b++)
+        {
+          y[b] = x[b] ^ x[(b + 4) & 7] ^ x[(b + 5) & 7] ^ x[(b + 6) & 7] ^
+                 x[(b + 7) & 7];
+        }
+
+      y[0] = ~y[0];
+      y[1] = ~y[1];
+      y[5] = ~y[5];
+      y[6] = ~y[6];
+      memcpy(x, y, sizeof(x));
+    }
+
+  /* Transpose back */
+
+  for (i = 0; i < nwords; i += 2)
+    {
+      v = 0;
+      for (b = 0; b < 8; b++)
+        {
+          v |= (uint64_t)((x[b] >> (4 * i)) & 0xff) << (8 * b);
+        }
+
+      v = aes_transpose8(v);
+      s[i] = (uint32_t)v;
+      if (i + 1 < nwords)
+        {
+          s[i + 1] = (uint32_t)(v >> 32);
+        }
     }
 }
 
-/******************************************************************************
- * Name: aes_encr
+/****************************************************************************
+ * Name: aes_ctmixcolumn and aes_ctinvmixcolumn
  *
  * Description:
- *  Internal implementation of AES128 encryption.
- *  Straight forward aes encryption implementation. First the group of
- *  operations:
+ *   MixColumns and InvMixColumns of one column:
  *
- *    - addRoundKey
- *    - subbytes
- *    - shiftrows
- *    - mixcolums
+ *     r_k = 2 * (a_k + a_(k+1)) + a_(k+1) + a_(k+2) + a_(k+3)
  *
- *  is executed 9 times, after this addroundkey to finish the 9th round, after
- *  that the 10th round without mixcolums no further subfunctions to save
- *  cycles for function calls no structuring with "for (....)" to save cycles.
+ *   InvMixColumns first adds 4 * (a_k + a_(k+2)) to each byte (Barreto's
+ *   decomposition) and then applies MixColumns.
  *
- * Input Parameters:
- *  expanded_key expanded AES128 key
- *  state        16 bytes of plain text and cipher text
+ ****************************************************************************/
+
+static inline uint32_t aes_ctmixcolumn(uint32_t w)
+{
+  uint32_t r8 = ROTR8(w);
+  return XTIME32(w ^ r8) ^ r8 ^ ROTR16(w) ^ ROTR24(w);
+}
+
+static inline uint32_t aes_ctinvmixcolumn(uint32_t w)
+{
+  uint32_t t = w ^ ROTR16(w);
+
+  t = XTIME32(t);
+  t = XTIME32(t);
+  return aes_ctmixcolumn(w ^ t);
+}
+#endif /* CONFIG_CRYPTO_AES_CT */
+
+/****************************************************************************
+ * Name: aes_subword
  *
- * Returned Value:
- *  None
+ * Description:
+ *   SubBytes of one key schedule word.
  *
- ******************************************************************************/
+ ****************************************************************************/
 
-static void aes_encr(FAR uint8_t *state, FAR const uint8_t *expanded_key)
+static uint32_t aes_subword(uint32_t w)
 {
-  uint8_t buf1;
-  uint8_t buf2;
-  uint8_t buf3;
-  uint8_t round;
+#ifdef CONFIG_CRYPTO_AES_TTABLE
+  return (uint32_t)g_sbox[BYTE0(w)] | ((uint32_t)g_sbox[BYTE1(w)] << 8) |
+         ((uint32_t)g_sbox[BYTE2(w)] << 16) |
+         ((uint32_t)g_sbox[BYTE3(w)] << 24);
+#else
+  aes_ctsbox(&w, 1, false);
+  return w;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_ctx_setkey
+ *
+ * Description:
+ *   Compute the encryption and decryption key schedules of a 128, 192 or
+ *   256-bit AES key.
+ *
+ ****************************************************************************/
+
+int aes_ctx_setkey(FAR struct aes_context_s *ctx, FAR const uint8_t *key,
+                   size_t keylen)
+{
+  FAR uint32_t *ek = ctx->ek;
+  uint32_t temp;
+  int nk;
+  int nwords;
+  int i;
+
+  if (keylen != AES128_KEY_SIZE && keylen != AES192_KEY_SIZE &&
+      keylen != AES256_KEY_SIZE)
+    {
+      return -EINVAL;
+    }
+
+  nk            = keylen / 4;
+  ctx->nrounds  = nk + 6;
+  nwords        = 4 * (ctx->nrounds + 1);
+
+  for (i = 0; i < nk; i++)
+    {
+      ek[i] = aes_getword(&key[4 * i]);
+    }
+
+  for (; i < nwords; i++)
+    {
+      temp = ek[i - 1];
+      if (i % nk == 0)
+        {
+          temp = aes_subword(ROTR8(temp)) ^ g_rcon[i / nk];
+        }
+      else if (nk > 6 && i % nk == 4)
+        {
+          temp = aes_subword(temp);
+        }
+
+      ek[i] = ek[i - nk] ^ temp;
+    }
 
-  for (round = 0; round < 9; round ++)
+#ifdef CONFIG_CRYPTO_AES_TTABLE
+  /* The equivalent inverse cipher uses the round keys in reverse order
+   * with InvMixColumns applied to all but the first and the last.
+   * g_td[g_sbox[x]] is InvMixColumns of x alone.
+   */
+
+  for (i = 0; i < nwords; i += 4)
     {
-      /* addroundkey, sbox and shiftrows */
-      /* Row 0 */
-
-      state[0]   = g_sbox[(state[0]  ^ expanded_key[(round * 16)])];
-      state[4]   = g_sbox[(state[4]  ^ expanded_key[(round * 16) +  4])];
-      state[8]   = g_sbox[(state[8]  ^ expanded_key[(round * 16) +  8])];
-      state[12]  = g_sbox[(state[12] ^ expanded_key[(round * 16) + 12])];
-
-      /* Row 1 */
-
-      buf1       = state[1] ^ expanded_key[(round * 16) + 1];
-      state[1]   = g_sbox[(state[5]  ^ expanded_key[(round * 16) +  5])];
-      state[5]   = g_sbox[(state[9]  ^ expanded_key[(round * 16) +  9])];
-      state[9]   = g_sbox[(state[13] ^ expanded_key[(round * 16) + 13])];
-      state[13]  = g_sbox[buf1];
-
-      /* Row 2 */
-
-      buf1       = state[2] ^ expanded_key[(round * 16) + 2];
-      buf2       = state[6] ^ expanded_key[(round * 16) + 6];
-      state[2]   = g_sbox[(state[10] ^ expanded_key[(round * 16) + 10])];
-      state[6]   = g_sbox[(state[14] ^ expanded_key[(round * 16) + 14])];
-      state[10]  = g_sbox[buf1];
-      state[14]  = g_sbox[buf2];
-
-      /* Row 3 */
-
-      buf1       = state[15] ^ expanded_key[(round * 16) + 15];
-      state[15]  = g_sbox[(state[11] ^ expanded_key[(round * 16) + 11])];
-      state[11]  = g_sbox[(state[7]  ^ expanded_key[(round * 16) +  7])];
-      state[7]   = g_sbox[(state[3]  ^ expanded_key[(round * 16) +  3])];
-      state[3]   = g_sbox[buf1];
-
-      /* mixcolums */
-      /* Col1 */
-
-      buf1 = state[0] ^ state[1] ^ state[2] ^ state[3];
-      buf2 = state[0];
-      buf3 = state[0] ^ state[1]; buf3 = galois_mul2(buf3); state[0] = state[0] ^ buf3 ^ buf1;
-      buf3 = state[1] ^ state[2]; buf3 = galois_mul2(buf3); state[1] = state[1] ^ buf3 ^ buf1;
-      buf3 = state[2] ^ state[3]; buf3 = galois_mul2(buf3); state[2] = state[2] ^ buf3 ^ buf1;
-      buf3 = state[3] ^ buf2;     buf3 = galois_mul2(buf3); state[3] = state[3] ^ buf3 ^ buf1;
-
-      /* Col2 */
-
-      buf1 = state[4] ^ state[5] ^ state[6] ^ state[7];
-      buf2 = state[4];
-      buf3 = state[4] ^ state[5]; buf3 = galois_mul2(buf3); state[4] = state[4] ^ buf3 ^ buf1;
-      buf3 = state[5] ^ state[6]; buf3 = galois_mul2(buf3); state[5] = state[5] ^ buf3 ^ buf1;
-      buf3 = state[6] ^ state[7]; buf3 = galois_mul2(buf3); state[6] = state[6] ^ buf3 ^ buf1;
-      buf3 = state[7] ^ buf2;     buf3 = galois_mul2(buf3); state[7] = state[7] ^ buf3 ^ buf1;
-
-      /* Col3 */
-
-      buf1 = state[8] ^ state[9] ^ state[10] ^ state[11];
-      buf2 = state[8];
-      buf3 = state[8] ^ state[9];   buf3 = galois_mul2(buf3); state[8] = state[8] ^ buf3 ^ buf1;
-      buf3 = state[9] ^ state[10];  buf3 = galois_mul2(buf3); state[9] = state[9] ^ buf3 ^ buf1;
-      buf3 = state[10] ^ state[11]; buf3 = galois_mul2(buf3); state[10] = state[10] ^ buf3 ^ buf1;
-      buf3 = state[11] ^ buf2;      buf3 = galois_mul2(buf3); state[11] = state[11] ^ buf3 ^ buf1;
-
-      /* Col4 */
-
-      buf1 = state[12] ^ state[13] ^ state[14] ^ state[15];
-      buf2 = state[12];
-      buf3 = state[12] ^ state[13]; buf3 = galois_mul2(buf3); state[12] = state[12] ^ buf3 ^ buf1;
-      buf3 = state[13] ^ state[14]; buf3 = galois_mul2(buf3); state[13] = state[13] ^ buf3 ^ buf1;
-      buf3 = state[14] ^ state[15]; buf3 = galois_mul2(buf3); state[14] = state[14] ^ buf3 ^ buf1;
-      buf3 = state[15] ^ buf2;      buf3 = galois_mul2(buf3); state[15] = state[15] ^ buf3 ^ buf1;
+      FAR const uint32_t *rk = &ek[nwords - 4 - i];
+      FAR uint32_t *dk = &ctx->dk[i];
+      int j;
+
+      for (j = 0; j < 4; j++)
+        {
+          temp = rk[j];
+          if (i > 0 && i < nwords - 4)
+            {
+              temp = g_td[g_sbox[BYTE0(temp)]] ^
+                     ROTL8(g_td[g_sbox[BYTE1(temp)]]) ^
+                     ROTL16(g_td[g_sbox[BYTE2(temp)]]) ^
+                     ROTL24(g_td[g_sbox[BYTE3(temp)]]);
+            }
+
+          dk[j] = temp;
+        }
     }
+#endif
 
-  /* 10th round without mixcols */
-
-  state[0]   = g_sbox[(state[0]  ^ expanded_key[(round * 16)])];
-  state[4]   = g_sbox[(state[4]  ^ expanded_key[(round * 16) +  4])];
-  state[8]   = g_sbox[(state[8]  ^ expanded_key[(round * 16) +  8])];
-  state[12]  = g_sbox[(state[12] ^ expanded_key[(round * 16) + 12])];
-
-  /* Row 1 */
-
-  buf1       = state[1] ^ expanded_key[(round * 16) + 1];
-  state[1]   = g_sbox[(state[5]  ^ expanded_key[(round * 16) +  5])];
-  state[5]   = g_sbox[(state[9]  ^ expanded_key[(round * 16) +  9])];
-  state[9]   = g_sbox[(state[13] ^ expanded_key[(round * 16) + 13])];
-  state[13]  = g_sbox[buf1];
-
-  /* Row 2 */
-
-  buf1       = state[2] ^ expanded_key[(round * 16) + 2];
-  buf2       = state[6] ^ expanded_key[(round * 16) + 6];
-  state[2]   = g_sbox[(state[10] ^ expanded_key[(round * 16) + 10])];
-  state[6]   = g_sbox[(state[14] ^ expanded_key[(round * 16) + 14])];
-  state[10]  = g_sbox[buf1];
-  state[14]  = g_sbox[buf2];
-
-  /* Row 3 */
-
-  buf1       = state[15] ^ expanded_key[(round * 16) + 15];
-  state[15]  = g_sbox[(state[11] ^ expanded_key[(round * 16) + 11])];
-  state[11]  = g_sbox[(state[7]  ^ expanded_key[(round * 16) +  7])];
-  state[7]   = g_sbox[(state[3]  ^ expanded_key[(round * 16) +  3])];
-  state[3]   = g_sbox[buf1];
-
-  /* Last addroundkey */
-
-  state[0]  ^= expanded_key[160];
-  state[1]  ^= expanded_key[161];
-  state[2]  ^= expanded_key[162];
-  state[3]  ^= expanded_key[163];
-  state[4]  ^= expanded_key[164];
-  state[5]  ^= expanded_key[165];
-  state[6]  ^= expanded_key[166];
-  state[7]  ^= expanded_key[167];
-  state[8]  ^= expanded_key[168];
-  state[9]  ^= expanded_key[169];
-  state[10] ^= expanded_key[170];
-  state[11] ^= expanded_key[171];
-  state[12] ^= expanded_key[172];
-  state[13] ^= expanded_key[173];
-  state[14] ^= expanded_key[174];
-  state[15] ^= expanded_key[175];
+  return OK;
 }
 
-/******************************************************************************
- * Name: aes_decr
+/****************************************************************************
+ * Name: aes_ctx_encrypt
  *
  * Description:
- *  Internal implementation of AES128 decryption.
- *  Straight forward aes decryption implementation.  The order of substeps is
- *  the exact reverse of decryption inverse functions:
+ *   Encrypt one 16 byte block with an expanded key.
  *
- *     - addRoundKey is its own inverse
- *     - rsbox is inverse of sbox
- *     - rightshift instead of leftshift
- *     - invMixColumns = barreto + mixColumns
+ ****************************************************************************/
+
+void aes_ctx_encrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                     FAR const uint8_t *in)
+{
+  FAR const uint32_t *rk = ctx->ek;
+  uint32_t s0;
+  uint32_t s1;
+  uint32_t s2;
+  uint32_t s3;
+  uint32_t t0;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  int round;
+
+  s0 = aes_getword(in)      ^ rk[0];
+  s1 = aes_getword(in + 4)  ^ rk[1];
+  s2 = aes_getword(in + 8)  ^ rk[2];
+  s3 = aes_getword(in + 12) ^ rk[3];
+
+#ifdef CONFIG_CRYPTO_AES_TTABLE
+  /* Each column of the next state is the XOR of four table look-ups that
+   * perform SubBytes, ShiftRows and MixColumns at once.
+   */
+
+  for (round = 1; round < ctx->nrounds; round++)
+    {
+      rk += 4;
+      t0 = g_te[BYTE0(s0)] ^ ROTL8(g_te[BYTE1(s1)]) ^
+           ROTL16(g_te[BYTE2(s2)]) ^ ROTL24(g_te[BYTE3(s3)]) ^ rk[0];
+      t1 = g_te[BYTE0(s1)] ^ ROTL8(g_te[BYTE1(s2)]) ^
+           ROTL16(g_te[BYTE2(s3)]) ^ ROTL24(g_te[BYTE3(s0)]) ^ rk[1];
+      t2 = g_te[BYTE0(s2)] ^ ROTL8(g_te[BYTE1(s3)]) ^
+           ROTL16(g_te[BYTE2(s0)]) ^ ROTL24(g_te[BYTE3(s1)]) ^ rk[2];
+      t3 = g_te[BYTE0(s3)] ^ ROTL8(g_te[BYTE1(s0)]) ^
+           ROTL16(g_te[BYTE2(s1)]) ^ ROTL24(g_te[BYTE3(s2)]) ^ rk[3];
+
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+
+  /* The last round has no MixColumns */
+
+  rk += 4;
+  t0 = (uint32_t)g_sbox[BYTE0(s0)] | ((uint32_t)g_sbox[BYTE1(s1)] << 8) |
+       ((uint32_t)g_sbox[BYTE2(s2)] << 16) |
+       ((uint32_t)g_sbox[BYTE3(s3)] << 24);
+  t1 = (uint32_t)g_sbox[BYTE0(s1)] | ((uint32_t)g_sbox[BYTE1(s2)] << 8) |
+       ((uint32_t)g_sbox[BYTE2(s3)] << 16) |
+       ((uint32_t)g_sbox[BYTE3(s0)] << 24);
+  t2 = (uint32_t)g_sbox[BYTE0(s2)] | ((uint32_t)g_sbox[BYTE1(s3)] << 8) |
+       ((uint32_t)g_sbox[BYTE2(s0)] << 16) |
+       ((uint32_t)g_sbox[BYTE3(s1)] << 24);
+  t3 = (uint32_t)g_sbox[BYTE0(s3)] | ((uint32_t)g_sbox[BYTE1(s0)] << 8) |
+       ((uint32_t)g_sbox[BYTE2(s1)] << 16) |
+       ((uint32_t)g_sbox[BYTE3(s2)] << 24);
+
+#else /* CONFIG_CRYPTO_AES_CT */
+  for (round = 1; ; round++)
+    {
+      uint32_t s[4];
+
+      s[0] = s0;
+      s[1] = s1;
+      s[2] = s2;
+      s[3] = s3;
+      aes_ctsbox(s, 4, false);
+
+      /* ShiftRows:  Row r of column c comes from column c + r */
+
+      t0 = (s[0] & 0x000000ff) | (s[1] & 0x0000ff00) |
+           (s[2] & 0x00ff0000) | (s[3] & 0xff000000);
+      t1 = (s[1] & 0x000000ff) | (s[2] & 0x0000ff00) |
+           (s[3] & 0x00ff0000) | (s[0] & 0xff000000);
+      t2 = (s[2] & 0x000000ff) | (s[3] & 0x0000ff00) |
+           (s[0] & 0x00ff0000) | (s[1] & 0xff000000);
+      t3 = (s[3] & 0x000000ff) | (s[0] & 0x0000ff00) |
+           (s[1] & 0x00ff0000) | (s[2] & 0xff000000);
+
+      rk += 4;
+      if (round == ctx->nrounds)
+        {
+          break;
+        }
+
+      s0 = aes_ctmixcolumn(t0) ^ rk[0];
+      s1 = aes_ctmixcolumn(t1) ^ rk[1];
+      s2 = aes_ctmixcolumn(t2) ^ rk[2];
+      s3 = aes_ctmixcolumn(t3) ^ rk[3];
+    }
+#endif
+
+  aes_putword(out,      t0 ^ rk[0]);
+  aes_putword(out + 4,  t1 ^ rk[1]);
+  aes_putword(out + 8,  t2 ^ rk[2]);
+  aes_putword(out + 12, t3 ^ rk[3]);
+}
+
+/****************************************************************************
+ * Name: aes_ctx_decrypt
  *
- *  No further subfunctions to save cycles for function calls no structuring
- *  with "for (....)" to save cycles
+ * Description:
+ *   Decrypt one 16 byte block with an expanded key.
  *
- * Input Parameters:
- *  expanded_key expanded AES128 key
- *  state        16 bytes of cipher text and plain text
+ ****************************************************************************/
+
+void aes_ctx_decrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                     FAR const uint8_t *in)
+{
+#ifdef CONFIG_CRYPTO_AES_TTABLE
+  FAR const uint32_t *rk = ctx->dk;
+#else
+  FAR const uint32_t *rk = &ctx->ek[4 * ctx->nrounds];
+#endif
+  uint32_t s0;
+  uint32_t s1;
+  uint32_t s2;
+  uint32_t s3;
+  uint32_t t0;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  int round;
+
+  s0 = aes_getword(in)      ^ rk[0];
+  s1 = aes_getword(in + 4)  ^ rk[1];
+  s2 = aes_getword(in + 8)  ^ rk[2];
+  s3 = aes_getword(in + 12) ^ rk[3];
+
+#ifdef CONFIG_CRYPTO_AES_TTABLE
+  /* InvShiftRows takes row r of column c from column c - r */
+
+  for (round = 1; round < ctx->nrounds; round++)
+    {
+      rk += 4;
+      t0 = g_td[BYTE0(s0)] ^ ROTL8(g_td[BYTE1(s3)]) ^
+           ROTL16(g_td[BYTE2(s2)]) ^ ROTL24(g_td[BYTE3(s1)]) ^ rk[0];
+      t1 = g_td[BYTE0(s1)] ^ ROTL8(g_td[BYTE1(s0)]) ^
+           ROTL16(g_td[BYTE2(s3)]) ^ ROTL24(g_td[BYTE3(s2)]) ^ rk[1];
+      t2 = g_td[BYTE0(s2)] ^ ROTL8(g_td[BYTE1(s1)]) ^
+           ROTL16(g_td[BYTE2(s0)]) ^ ROTL24(g_td[BYTE3(s3)]) ^ rk[2];
+      t3 = g_td[BYTE0(s3)] ^ ROTL8(g_td[BYTE1(s2)]) ^
+           ROTL16(g_td[BYTE2(s1)]) ^ ROTL24(g_td[BYTE3(s0)]) ^ rk[3];
+
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+
+  rk += 4;
+  t0 = (uint32_t)g_rsbox[BYTE0(s0)] | ((uint32_t)g_rsbox[BYTE1(s3)] << 8) |
+       ((uint32_t)g_rsbox[BYTE2(s2)] << 16) |
+       ((uint32_t)g_rsbox[BYTE3(s1)] << 24);
+  t1 = (uint32_t)g_rsbox[BYTE0(s1)] | ((uint32_t)g_rsbox[BYTE1(s0)] << 8) |
+       ((uint32_t)g_rsbox[BYTE2(s3)] << 16) |
+       ((uint32_t)g_rsbox[BYTE3(s2)] << 24);
+  t2 = (uint32_t)g_rsbox[BYTE0(s2)] | ((uint32_t)g_rsbox[BYTE1(s1)] << 8) |
+       ((uint32_t)g_rsbox[BYTE2(s0)] << 16) |
+       ((uint32_t)g_rsbox[BYTE3(s3)] << 24);
+  t3 = (uint32_t)g_rsbox[BYTE0(s3)] | ((uint32_t)g_rsbox[BYTE1(s2)] << 8) |
+       ((uint32_t)g_rsbox[BYTE2(s1)] << 16) |
+       ((uint32_t)g_rsbox[BYTE3(s0)] << 24);
+
+#else /* CONFIG_CRYPTO_AES_CT */
+  /* The straightforward inverse cipher with the round keys in reverse
+   * order.
+   */
+
+  for (round = 1; ; round++)
+    {
+      uint32_t s[4];
+
+      s[0] = (s0 & 0x000000ff) | (s3 & 0x0000ff00) |
+             (s2 & 0x00ff0000) | (s1 & 0xff000000);
+      s[1] = (s1 & 0x000000ff) | (s0 & 0x0000ff00) |
+             (s3 & 0x00ff0000) | (s2 & 0xff000000);
+      s[2] = (s2 & 0x000000ff) | (s1 & 0x0000ff00) |
+             (s0 & 0x00ff0000) | (s3 & 0xff000000);
+      s[3] = (s3 & 0x000000ff) | (s2 & 0x0000ff00) |
+             (s1 & 0x00ff0000) | (s0 & 0xff000000);
+      aes_ctsbox(s, 4, true);
+
+      t0 = s[0];
+      t1 = s[1];
+      t2 = s[2];
+      t3 = s[3];
+
+      rk -= 4;
+      if (round == ctx->nrounds)
+        {
+          break;
+        }
+
+      s0 = aes_ctinvmixcolumn(t0 ^ rk[0]);
+      s1 = aes_ctinvmixcolumn(t1 ^ rk[1]);
+      s2 = aes_ctinvmixcolumn(t2 ^ rk[2]);
+      s3 = aes_ctinvmixcolumn(t3 ^ rk[3]);
+    }
+#endif
+
+  aes_putword(out,      t0 ^ rk[0]);
+  aes_putword(out + 4,  t1 ^ rk[1]);
+  aes_putword(out + 8,  t2 ^ rk[2]);
+  aes_putword(out + 12, t3 ^ rk[3]);
+}
+
+/****************************************************************************
+ * Name: aes_ctx_cypher
  *
- * Returned Value:
- *  None
+ * Description:
+ *   Encrypt or decrypt a buffer in ECB, CBC, CTR or CFB mode.
  *
- ******************************************************************************/
+ ****************************************************************************/
 
-static void aes_decr(FAR uint8_t *state, FAR const uint8_t *expanded_key)
+#ifdef CONFIG_CRYPTO_AES
+int aes_ctx_cypher(FAR const struct aes_context_s *ctx, FAR void *out,
+                   FAR const void *in, uint32_t size, FAR const void *iv,
+                   int mode, int encrypt)
 {
-  uint8_t buf1;
-  uint8_t buf2;
-  uint8_t buf3;
-  int8_t round;
-
-  round = 9;
-
-  /* Initial addroundkey */
-
-  state[0]  ^= expanded_key[160];
-  state[1]  ^= expanded_key[161];
-  state[2]  ^= expanded_key[162];
-  state[3]  ^= expanded_key[163];
-  state[4]  ^= expanded_key[164];
-  state[5]  ^= expanded_key[165];
-  state[6]  ^= expanded_key[166];
-  state[7]  ^= expanded_key[167];
-  state[8]  ^= expanded_key[168];
-  state[9]  ^= expanded_key[169];
-  state[10] ^= expanded_key[170];
-  state[11] ^= expanded_key[171];
-  state[12] ^= expanded_key[172];
-  state[13] ^= expanded_key[173];
-  state[14] ^= expanded_key[174];
-  state[15] ^= expanded_key[175];
-
-  /* 10th round without mixcols */
-
-  state[0]   = g_rsbox[state[0]]  ^ expanded_key[(round * 16)];
-  state[4]   = g_rsbox[state[4]]  ^ expanded_key[(round * 16) +  4];
-  state[8]   = g_rsbox[state[8]]  ^ expanded_key[(round * 16) +  8];
-  state[12]  = g_rsbox[state[12]] ^ expanded_key[(round * 16) + 12];
-
-  /* Row 1 */
-
-  buf1       = g_rsbox[state[13]] ^ expanded_key[(round * 16) +  1];
-  state[13]  = g_rsbox[state[9]]  ^ expanded_key[(round * 16) + 13];
-  state[9]   = g_rsbox[state[5]]  ^ expanded_key[(round * 16) +  9];
-  state[5]   = g_rsbox[state[1]]  ^ expanded_key[(round * 16) +  5];
-  state[1]   = buf1;
-
-  /* Row 2 */
-
-  buf1       = g_rsbox[state[2]]  ^ expanded_key[(round * 16) + 10];
-  buf2       = g_rsbox[state[6]]  ^ expanded_key[(round * 16) + 14];
-  state[2]   = g_rsbox[state[10]] ^ expanded_key[(round * 16) +  2];
-  state[6]   = g_rsbox[state[14]] ^ expanded_key[(round * 16) +  6];
-  state[10]  = buf1;
-  state[14]  = buf2;
-
-  /* Row 3 */
-
-  buf1       = g_rsbox[state[3]]  ^ expanded_key[(round * 16) + 15];
-  state[3]   = g_rsbox[state[7]]  ^ expanded_key[(round * 16) +  3];
-  state[7]   = g_rsbox[state[11]] ^ expanded_key[(round * 16) +  7];
-  state[11]  = g_rsbox[state[15]] ^ expanded_key[(round * 16) + 11];
-  state[15]  = buf1;
-
-  for (round = 8; round >= 0; round--)
+  FAR uint8_t *dst = (FAR uint8_t *)out;
+  FAR const uint8_t *src = (FAR const uint8_t *)in;
+  uint8_t chain[AES_BLOCK_SIZE];
+  uint8_t block[AES_BLOCK_SIZE];
+  int i;
+
+  if ((size & (AES_BLOCK_SIZE - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (iv != NULL)
+    {
+      memcpy(chain, iv, AES_BLOCK_SIZE);
+    }
+  else
     {
-      /* barreto */
-      /* Col1 */
-
-      buf1       = galois_mul2(galois_mul2(state[0] ^ state[2]));
-      buf2       = galois_mul2(galois_mul2(state[1] ^ state[3]));
-      state[0]  ^= buf1;
-      state[1]  ^= buf2;
-      state[2]  ^= buf1;
-      state[3]  ^= buf2;
-
-      /* Col2 */
-
-      buf1       = galois_mul2(galois_mul2(state[4] ^ state[6]));
-      buf2       = galois_mul2(galois_mul2(state[5] ^ state[7]));
-      state[4]  ^= buf1;
-      state[5]  ^= buf2;
-      state[6]  ^= buf1;
-      state[7]  ^= buf2;
-
-      /* Col3 */
-
-      buf1       = galois_mul2(galois_mul2(state[8] ^ state[10]));
-      buf2       = galois_mul2(galois_mul2(state[9] ^ state[11]));
-      state[8]  ^= buf1;
-      state[9]  ^= buf2;
-      state[10] ^= buf1;
-      state[11] ^= buf2;
-
-      /* Col4 */
-
-      buf1       = galois_mul2(galois_mul2(state[12] ^ state[14]));
-      buf2       = galois_mul2(galois_mul2(state[13] ^ state[15]));
-      state[12] ^= buf1;
-      state[13] ^= buf2;
-      state[14] ^= buf1;
-      state[15] ^= buf2;
-
-      /* mixcolums */
-      /* Col1 */
-
-      buf1 = state[0]  ^ state[1] ^ state[2] ^ state[3];
-      buf2 = state[0];
-      buf3 = state[0]  ^ state[1]; buf3 = galois_mul2(buf3); state[0] = state[0] ^ buf3 ^ buf1;
-      buf3 = state[1]  ^ state[2]; buf3 = galois_mul2(buf3); state[1] = state[1] ^ buf3 ^ buf1;
-      buf3 = state[2]  ^ state[3]; buf3 = galois_mul2(buf3); state[2] = state[2] ^ buf3 ^ buf1;
-      buf3 = state[3]  ^ buf2;     buf3 = galois_mul2(buf3); state[3] = state[3] ^ buf3 ^ buf1;
-
-      /* Col2 */
-
-      buf1 = state[4]  ^ state[5] ^ state[6] ^ state[7];
-      buf2 = state[4];
-      buf3 = state[4]  ^ state[5]; buf3 = galois_mul2(buf3); state[4] = state[4] ^ buf3 ^ buf1;
-      buf3 = state[5]  ^ state[6]; buf3 = galois_mul2(buf3); state[5] = state[5] ^ buf3 ^ buf1;
-      buf3 = state[6]  ^ state[7]; buf3 = galois_mul2(buf3); state[6] = state[6] ^ buf3 ^ buf1;
-      buf3 = state[7]  ^ buf2;     buf3 = galois_mul2(buf3); state[7] = state[7] ^ buf3 ^ buf1;
-
-      /* Col3 */
-
-      buf1 = state[8]  ^ state[9] ^ state[10] ^ state[11];
-      buf2 = state[8];
-      buf3 = state[8]  ^ state[9];  buf3 = galois_mul2(buf3); state[8] = state[8] ^ buf3 ^ buf1;
-      buf3 = state[9]  ^ state[10]; buf3 = galois_mul2(buf3); state[9] = state[9] ^ buf3 ^ buf1;
-      buf3 = state[10] ^ state[11]; buf3 = galois_mul2(buf3); state[10] = state[10] ^ buf3 ^ buf1;
-      buf3 = state[11] ^ buf2;      buf3 = galois_mul2(buf3); state[11] = state[11] ^ buf3 ^ buf1;
-
-      /* Col4 */
-
-      buf1 = state[12] ^ state[13] ^ state[14] ^ state[15];
-      buf2 = state[12];
-      buf3 = state[12] ^ state[13]; buf3 = galois_mul2(buf3); state[12] = state[12] ^ buf3 ^ buf1;
-      buf3 = state[13] ^ state[14]; buf3 = galois_mul2(buf3); state[13] = state[13] ^ buf3 ^ buf1;
-      buf3 = state[14] ^ state[15]; buf3 = galois_mul2(buf3); state[14] = state[14] ^ buf3 ^ buf1;
-      buf3 = state[15] ^ buf2;      buf3 = galois_mul2(buf3); state[15] = state[15] ^ buf3 ^ buf1;
-
-      /* addroundkey, rsbox and shiftrows */
-      /* Row 0 */
-
-      state[0]   = g_rsbox[state[0]]  ^ expanded_key[(round * 16)];
-      state[4]   = g_rsbox[state[4]]  ^ expanded_key[(round * 16) +  4];
-      state[8]   = g_rsbox[state[8]]  ^ expanded_key[(round * 16) +  8];
-      state[12]  = g_rsbox[state[12]] ^ expanded_key[(round * 16) + 12];
-
-      /* Row 1 */
-
-      buf1       = g_rsbox[state[13]] ^ expanded_key[(round * 16) +  1];
-      state[13]  = g_rsbox[state[9]]  ^ expanded_key[(round * 16) + 13];
-      state[9]   = g_rsbox[state[5]]  ^ expanded_key[(round * 16) +  9];
-      state[5]   = g_rsbox[state[1]]  ^ expanded_key[(round * 16) +  5];
-      state[1]   = buf1;
-
-      /* Row 2 */
-
-      buf1       = g_rsbox[state[2]]  ^ expanded_key[(round * 16) + 10];
-      buf2       = g_rsbox[state[6]]  ^ expanded_key[(round * 16) + 14];
-      state[2]   = g_rsbox[state[10]] ^ expanded_key[(round * 16) +  2];
-      state[6]   = g_rsbox[state[14]] ^ expanded_key[(round * 16) +  6];
-      state[10]  = buf1;
-      state[14]  = buf2;
-
-      /* Row 3 */
-
-      buf1       = g_rsbox[state[3]]  ^ expanded_key[(round * 16) + 15];
-      state[3]   = g_rsbox[state[7]]  ^ expanded_key[(round * 16) +  3];
-      state[7]   = g_rsbox[state[11]] ^ expanded_key[(round * 16) +  7];
-      state[11]  = g_rsbox[state[15]] ^ expanded_key[(round * 16) + 11];
-      state[15]  = buf1;
+      memset(chain, 0, AES_BLOCK_SIZE);
     }
+
+  mode &= AES_MODE_MASK;
+  if (mode < AES_MODE_MIN || mode > AES_MODE_MAX)
+    {
+      return -EINVAL;
+    }
+
+  for (; size > 0; size -= AES_BLOCK_SIZE,
+       src += AES_BLOCK_SIZE, dst += AES_BLOCK_SIZE)
+    {
+      switch (mode)
+        {
+        case AES_MODE_ECB:
+          if (encrypt)
+            {
+              aes_ctx_encrypt(ctx, dst, src);
+            }
+          else
+            {
+              aes_ctx_decrypt(ctx, dst, src);
+            }
+          break;
+
+        case AES_MODE_CBC:
+          if (encrypt)
+            {
+              for (i = 0; i < AES_BLOCK_SIZE; i++)
+                {
+                  block[i] = src[i] ^ chain[i];
+                }
+
+              aes_ctx_encrypt(ctx, dst, block);
+              memcpy(chain, dst, AES_BLOCK_SIZE);
+            }
+          else
+            {
+              /* Keep the cipher text; dst may be the same as src */
+
+              memcpy(block, src, AES_BLOCK_SIZE);
+              aes_ctx_decrypt(ctx, dst, src);
+              for (i = 0; i < AES_BLOCK_SIZE; i++)
+                {
+                  dst[i] ^= chain[i];
+                }
+
+              memcpy(chain, block, AES_BLOCK_SIZE);
+            }
+          break;
+
+        case AES_MODE_CTR:
+
+          /* Encrypt the big-endian counter block and increment it */
+
+          aes_ctx_encrypt(ctx, block, chain);
+          for (i = 0; i < AES_BLOCK_SIZE; i++)
+            {
+              dst[i] = src[i] ^ block[i];
+            }
+
+          for (i = AES_BLOCK_SIZE - 1; i >= 0 && ++chain[i] == 0; i--)
+            {
+            }
+          break;
+
+        case AES_MODE_CFB:
+          aes_ctx_encrypt(ctx, block, chain);
+          if (encrypt)
+            {
+              for (i = 0; i < AES_BLOCK_SIZE; i++)
+                {
+                  dst[i] = src[i] ^ block[i];
+                }
+
+              memcpy(chain, dst, AES_BLOCK_SIZE);
+            }
+          else
+            {
+              memcpy(chain, src, AES_BLOCK_SIZE);
+              for (i = 0; i < AES_BLOCK_SIZE; i++)
+                {
+                  dst[i] = chain[i] ^ block[i];
+                }
+            }
+          break;
+        }
+    }
+
+  return OK;
 }
+#endif
 
 /****************************************************************************
- * Public Functions
+ * Name: up_aesinitialize and aes_cypher
+ *
+ * Description:
+ *   The software implementation of the AES interfaces of
+ *   include/nuttx/crypto/crypto.h for architectures without an AES
+ *   peripheral.
+ *
  ****************************************************************************/
 
- /****************************************************************************
+#if defined(CONFIG_CRYPTO_AES) && !defined(CONFIG_CRYPTO_AES_ARCH)
+int up_aesinitialize(void)
+{
+  return OK;
+}
+
+int aes_cypher(FAR void *out, FAR const void *in, uint32_t size,
+               FAR const void *iv, FAR const void *key, uint32_t keysize,
+               int mode, int encrypt)
+{
+  int ret;
+
+  ret = sem_wait(&g_aes_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Only compute the key schedule when the key changes */
+
+  if (keysize != g_aes_keylen || memcmp(key, g_aes_key, keysize) != 0)
+    {
+      g_aes_keylen = 0;
+      ret = aes_ctx_setkey(&g_aes_ctx, key, keysize);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      memcpy(g_aes_key, key, keysize);
+      g_aes_keylen = keysize;
+    }
+
+  ret = aes_ctx_cypher(&g_aes_ctx, out, in, size, iv, mode, encrypt);
+
+out:
+  sem_post(&g_aes_lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
  * Name: aes_encrypt
  *
  * Description:
@@ -562,10 +1020,8 @@ static void aes_decr(FAR uint8_t *state, FAR const uint8_t *expanded_key)
 
 void aes_encrypt(FAR uint8_t *state, FAR const uint8_t *key)
 {
-  /* Expand the key into 176 bytes */
-
-  expand_key(g_expanded_key, key);
-  aes_encr(state, g_expanded_key);
+  (void)aes_ctx_setkey(&g_legacy_ctx, key, AES128_KEY_SIZE);
+  aes_ctx_encrypt(&g_legacy_ctx, state, state);
 }
 
 /****************************************************************************
@@ -587,8 +1043,6 @@ void aes_encrypt(FAR uint8_t *state, FAR const uint8_t *key)
 
 void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key)
 {
-  /* Expand the key into 176 bytes */
-
-  expand_key(g_expanded_key, key);
-  aes_decr(state, g_expanded_key);
+  (void)aes_ctx_setkey(&g_legacy_ctx, key, AES128_KEY_SIZE);
+  aes_ctx_decrypt(&g_legacy_ctx, state, state);
 }
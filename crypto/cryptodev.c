@@ -33,6 +33,7 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
@@ -42,23 +43,96 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <semaphore.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <queue.h>
 #include <errno.h>
+#include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/cryptodev.h>
+#include <nuttx/crypto/aes.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* Asynchronous operations are performed on the low priority work queue if
+ * there is one.
+ */
+
+#  ifdef CONFIG_SCHED_LPWORK
+#    define CRYPTODEV_WORK LPWORK
+#  else
+#    define CRYPTODEV_WORK HPWORK
+#  endif
+
+#  ifndef CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS
+#    define CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS 2
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
 #ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+/* The kernel side of a session.  When AES is done in software, the key
+ * schedule is computed once when the session is created.  AES hardware
+ * loads the key for every operation so only the key itself is kept.
+ */
+
+struct cryptodev_session_s
+{
+  int mode;                         /* AES_MODE_* */
+#ifdef CONFIG_CRYPTO_AES_ARCH
+  uint32_t keylen;                  /* Size of the key in bytes */
+  uint8_t key[AES256_KEY_SIZE];     /* The key */
+#else
+  struct aes_context_s ctx;         /* The expanded key */
+#endif
+};
+#endif
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* One queued operation */
+
+struct cryptodev_job_s
+{
+  FAR struct cryptodev_job_s *flink;
+  FAR struct crypt_op *uop;         /* The caller's operation (the cookie) */
+  struct crypt_op op;               /* Copy of the operation */
+  int status;                       /* Result of the operation */
+};
+
+/* The state of one open file.  Jobs are moved from the pending list to the
+ * done list by the worker and removed by CIOCASYNCFETCH.
+ */
+
+struct cryptodev_file_s
+{
+  sem_t exclsem;                    /* Protects the lists and flags */
+  sem_t donesem;                    /* Wakes up blocked CIOCASYNCFETCH */
+  sem_t idlesem;                    /* Wakes up close() */
+  sq_queue_t pending;               /* Jobs waiting to be processed */
+  sq_queue_t done;                  /* Completed jobs */
+  uint16_t njobs;                   /* Number of jobs in both lists */
+  uint8_t nwaiters;                 /* Number of threads waiting on donesem */
+  bool busy;                        /* Worker is scheduled or running */
+  bool closing;                     /* The file is being closed */
+  struct work_s work;               /* Work queue support */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS];
+#endif
+};
 #endif
 
 /****************************************************************************
@@ -67,12 +141,20 @@
 
 /* Character driver methods */
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_open(FAR struct file *filep);
+static int cryptodev_close(FAR struct file *filep);
+#endif
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
                                size_t len);
 static int cryptodev_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
+#if defined(CONFIG_CRYPTO_CRYPTODEV_ASYNC) && !defined(CONFIG_DISABLE_POLL)
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -80,15 +162,24 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd,
 
 static const struct file_operations g_cryptodevops =
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
+#else
   0,                  /* open   */
   0,                  /* close  */
+#endif
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   0,                  /* seek   */
   cryptodev_ioctl     /* ioctl  */
 #ifndef CONFIG_DISABLE_POLL
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  , cryptodev_poll    /* poll   */
+#else
   , 0                 /* poll   */
 #endif
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , 0                 /* unlink */
 #endif
@@ -98,6 +189,405 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_crypt
+ *
+ * Description:
+ *   Perform one operation in the context of the caller.  This is where
+ *   AES hardware (see CONFIG_CRYPTO_AES_ARCH) takes over.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_AES
+static int cryptodev_crypt(FAR struct crypt_op *op)
+{
+  FAR struct cryptodev_session_s *sess =
+    (FAR struct cryptodev_session_s *)(uintptr_t)op->ses;
+  int encrypt;
+
+  switch (op->op)
+    {
+    case COP_ENCRYPT:
+      encrypt = CYPHER_ENCRYPT;
+      break;
+
+    case COP_DECRYPT:
+      encrypt = CYPHER_DECRYPT;
+      break;
+
+    default:
+      return -EINVAL;
+    }
+
+  if (sess == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_CRYPTO_AES_ARCH
+  return aes_cypher(op->dst, op->src, op->len, op->iv, sess->key,
+                    sess->keylen, sess->mode, encrypt);
+#else
+  return aes_ctx_cypher(&sess->ctx, op->dst, op->src, op->len, op->iv,
+                        sess->mode, encrypt);
+#endif
+}
+#endif
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/****************************************************************************
+ * Name: cryptodev_takesem
+ ****************************************************************************/
+
+static void cryptodev_takesem(FAR sem_t *sem)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_pollnotify
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void cryptodev_pollnotify(FAR struct cryptodev_file_s *priv,
+                                 pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+    {
+      fds = priv->fds[i];
+      if (fds)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              sem_post(fds->sem);
+            }
+        }
+    }
+}
+#else
+#  define cryptodev_pollnotify(priv,event)
+#endif
+
+/****************************************************************************
+ * Name: cryptodev_worker
+ *
+ * Description:
+ *   Process the pending jobs of one file on the work queue.  The lock is
+ *   dropped while an operation is in progress so that more jobs can be
+ *   submitted and completed jobs fetched in the meantime.
+ *
+ ****************************************************************************/
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct cryptodev_file_s *priv = (FAR struct cryptodev_file_s *)arg;
+  FAR struct cryptodev_job_s *job;
+
+  cryptodev_takesem(&priv->exclsem);
+  while ((job = (FAR struct cryptodev_job_s *)sq_remfirst(&priv->pending))
+         != NULL)
+    {
+      if (priv->closing)
+        {
+          job->status = -ECANCELED;
+        }
+      else
+        {
+          sem_post(&priv->exclsem);
+          job->status = cryptodev_crypt(&job->op);
+          cryptodev_takesem(&priv->exclsem);
+        }
+
+      sq_addlast((FAR sq_entry_t *)job, &priv->done);
+
+      /* Wake up anyone waiting for a completion */
+
+      while (priv->nwaiters > 0)
+        {
+          priv->nwaiters--;
+          sem_post(&priv->donesem);
+        }
+
+      cryptodev_pollnotify(priv, POLLIN);
+    }
+
+  priv->busy = false;
+  if (priv->closing)
+    {
+      sem_post(&priv->idlesem);
+    }
+
+  sem_post(&priv->exclsem);
+}
+
+/****************************************************************************
+ * Name: cryptodev_submit
+ *
+ * Description:
+ *   CIOCASYNCCRYPT:  Queue all operations of a batch or none of them.
+ *
+ ****************************************************************************/
+
+static int cryptodev_submit(FAR struct cryptodev_file_s *priv,
+                            FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_job_s *job;
+  sq_queue_t jobs;
+  unsigned i;
+  int ret = OK;
+
+  if (mop->count == 0)
+    {
+      return OK;
+    }
+
+  /* Build the jobs before taking the lock */
+
+  sq_init(&jobs);
+  for (i = 0; i < mop->count; i++)
+    {
+      job = (FAR struct cryptodev_job_s *)
+        kmm_malloc(sizeof(struct cryptodev_job_s));
+      if (job == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      job->uop    = &mop->ops[i];
+      job->status = -EINPROGRESS;
+      memcpy(&job->op, &mop->ops[i], sizeof(struct crypt_op));
+      sq_addlast((FAR sq_entry_t *)job, &jobs);
+    }
+
+  cryptodev_takesem(&priv->exclsem);
+  if (priv->njobs + mop->count > CONFIG_CRYPTO_CRYPTODEV_MAXJOBS)
+    {
+      sem_post(&priv->exclsem);
+      ret = -EAGAIN;
+      goto errout;
+    }
+
+  priv->njobs += mop->count;
+  while ((job = (FAR struct cryptodev_job_s *)sq_remfirst(&jobs)) != NULL)
+    {
+      sq_addlast((FAR sq_entry_t *)job, &priv->pending);
+    }
+
+  if (!priv->busy)
+    {
+      priv->busy = true;
+      ret = work_queue(CRYPTODEV_WORK, &priv->work, cryptodev_worker, priv,
+                       0);
+      DEBUGASSERT(ret == OK);
+    }
+
+  sem_post(&priv->exclsem);
+  return ret;
+
+errout:
+  while ((job = (FAR struct cryptodev_job_s *)sq_remfirst(&jobs)) != NULL)
+    {
+      kmm_free(job);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cryptodev_fetch
+ *
+ * Description:
+ *   CIOCASYNCFETCH:  Return completed operations.  Unless the file was
+ *   opened with O_NONBLOCK, wait for at least one if there are operations
+ *   in progress.
+ *
+ ****************************************************************************/
+
+static int cryptodev_fetch(FAR struct file *filep,
+                           FAR struct cryptodev_file_s *priv,
+                           FAR struct crypt_fetch *fetch)
+{
+  FAR struct cryptodev_job_s *job;
+  unsigned count = 0;
+
+  cryptodev_takesem(&priv->exclsem);
+
+  while (sq_empty(&priv->done) && !sq_empty(&priv->pending) &&
+         (filep->f_oflags & O_NONBLOCK) == 0)
+    {
+      priv->nwaiters++;
+      sem_post(&priv->exclsem);
+      cryptodev_takesem(&priv->donesem);
+      cryptodev_takesem(&priv->exclsem);
+    }
+
+  while (count < fetch->count &&
+         (job = (FAR struct cryptodev_job_s *)sq_remfirst(&priv->done))
+         != NULL)
+    {
+      fetch->results[count].op     = job->uop;
+      fetch->results[count].status = job->status;
+      count++;
+
+      priv->njobs--;
+      kmm_free(job);
+    }
+
+  sem_post(&priv->exclsem);
+
+  fetch->count = count;
+  if (count == 0 && (filep->f_oflags & O_NONBLOCK) != 0 && priv->njobs > 0)
+    {
+      return -EAGAIN;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_open
+ ****************************************************************************/
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv;
+
+  priv = (FAR struct cryptodev_file_s *)
+    kmm_zalloc(sizeof(struct cryptodev_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  sem_init(&priv->exclsem, 0, 1);
+  sem_init(&priv->donesem, 0, 0);
+  sem_init(&priv->idlesem, 0, 0);
+  sq_init(&priv->pending);
+  sq_init(&priv->done);
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_close
+ *
+ * Description:
+ *   Wait for the operation in progress (if any), cancel all others and
+ *   discard the results that were never fetched.
+ *
+ ****************************************************************************/
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv =
+    (FAR struct cryptodev_file_s *)filep->f_priv;
+  FAR struct cryptodev_job_s *job;
+
+  DEBUGASSERT(priv != NULL);
+
+  cryptodev_takesem(&priv->exclsem);
+  priv->closing = true;
+
+  if (priv->busy)
+    {
+      sem_post(&priv->exclsem);
+      cryptodev_takesem(&priv->idlesem);
+      cryptodev_takesem(&priv->exclsem);
+    }
+
+  while ((job = (FAR struct cryptodev_job_s *)sq_remfirst(&priv->done))
+         != NULL)
+    {
+      kmm_free(job);
+    }
+
+  sem_post(&priv->exclsem);
+
+  sem_destroy(&priv->exclsem);
+  sem_destroy(&priv->donesem);
+  sem_destroy(&priv->idlesem);
+  kmm_free(priv);
+
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_poll
+ *
+ * Description:
+ *   POLLIN is reported when there are completed operations to fetch.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int cryptodev_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct cryptodev_file_s *priv =
+    (FAR struct cryptodev_file_s *)filep->f_priv;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(priv != NULL);
+
+  cryptodev_takesem(&priv->exclsem);
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+        {
+          if (!priv->fds[i])
+            {
+              priv->fds[i] = fds;
+              fds->priv    = &priv->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (!sq_empty(&priv->done))
+        {
+          cryptodev_pollnotify(priv, POLLIN);
+        }
+    }
+  else if (fds->priv)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  sem_post(&priv->exclsem);
+  return ret;
+}
+#endif
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len)
 {
@@ -117,50 +607,124 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   case CIOCGSESSION:
     {
       FAR struct session_op *ses = (FAR struct session_op *)arg;
+#ifdef CONFIG_CRYPTO_AES
+      FAR struct cryptodev_session_s *sess;
+      int mode;
+      int ret;
+
+      switch (ses->cipher)
+        {
+        case CRYPTO_AES_ECB:
+          mode = AES_MODE_ECB;
+          break;
+
+        case CRYPTO_AES_CBC:
+          mode = AES_MODE_CBC;
+          break;
+
+        case CRYPTO_AES_CTR:
+          mode = AES_MODE_CTR;
+          break;
+
+        default:
+          return -EINVAL;
+        }
+
+      if (ses->keylen != AES128_KEY_SIZE && ses->keylen != AES192_KEY_SIZE &&
+          ses->keylen != AES256_KEY_SIZE)
+        {
+          return -EINVAL;
+        }
+
+      sess = (FAR struct cryptodev_session_s *)
+        kmm_zalloc(sizeof(struct cryptodev_session_s));
+      if (sess == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      sess->mode = mode;
+#ifdef CONFIG_CRYPTO_AES_ARCH
+      sess->keylen = ses->keylen;
+      memcpy(sess->key, ses->key, ses->keylen);
+      ret = OK;
+#else
+      ret = aes_ctx_setkey(&sess->ctx, (FAR const uint8_t *)ses->key,
+                           ses->keylen);
+#endif
+      if (ret < 0)
+        {
+          kmm_free(sess);
+          return ret;
+        }
+
+      ses->ses = (uint32_t)(uintptr_t)sess;
+#else
       ses->ses = (uint32_t)ses;
+#endif
       return OK;
     }
 
   case CIOCFSESSION:
     {
+#ifdef CONFIG_CRYPTO_AES
+      FAR uint32_t *ses = (FAR uint32_t *)arg;
+      FAR struct cryptodev_session_s *sess =
+        (FAR struct cryptodev_session_s *)(uintptr_t)*ses;
+
+      if (sess != NULL)
+        {
+          /* Don't leave the key behind in the heap */
+
+          memset(sess, 0, sizeof(struct cryptodev_session_s));
+          kmm_free(sess);
+        }
+#endif
       return OK;
     }
 
 #ifdef CONFIG_CRYPTO_AES
   case CIOCCRYPT:
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      return cryptodev_crypt((FAR struct crypt_op *)arg);
+    }
 
-      switch (op->op)
-        {
-        case COP_ENCRYPT:
-          encrypt = 1;
-          break;
+  case CIOCCRYPTM:
+    {
+      FAR struct crypt_mop *mop = (FAR struct crypt_mop *)arg;
+      unsigned i;
+      int ret;
 
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
+      /* Perform the operations in order and stop at the first failure.
+       * count is set to the number of successful operations.
+       */
 
-        default:
-          return -EINVAL;
-        }
-
-      switch (ses->cipher)
+      for (i = 0; i < mop->count; i++)
         {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
+          ret = cryptodev_crypt(&mop->ops[i]);
+          if (ret < 0)
+            {
+              mop->count = i;
+              return ret;
+            }
+        }
 
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+      return OK;
+    }
+#endif
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  case CIOCASYNCCRYPT:
+    {
+      return cryptodev_submit((FAR struct cryptodev_file_s *)filep->f_priv,
+                              (FAR struct crypt_mop *)arg);
+    }
 
-        default:
-           return -EINVAL;
-        }
+  case CIOCASYNCFETCH:
+    {
+      return cryptodev_fetch(filep,
+                             (FAR struct cryptodev_file_s *)filep->f_priv,
+                             (FAR struct crypt_fetch *)arg);
     }
 #endif
 
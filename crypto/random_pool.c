@@ -49,6 +49,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 
@@ -65,6 +66,29 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  ifdef CONFIG_SMP
+#    define CRNG_NCPUS   CONFIG_SMP_NCPUS
+#  else
+#    define CRNG_NCPUS   1
+#  endif
+
+#  define CRNG_KEYWORDS  8   /* 256-bit ChaCha20 key */
+#  define CRNG_KEYBYTES  (CRNG_KEYWORDS * 4)
+#  define CRNG_BLKWORDS  16  /* 512-bit ChaCha20 block */
+#  define CRNG_BLKBYTES  (CRNG_BLKWORDS * 4)
+
+#  define CHACHA_QR(a,b,c,d) \
+     do \
+       { \
+         a += b; d ^= a; d = ROTL_32(d, 16); \
+         c += d; b ^= c; b = ROTL_32(b, 12); \
+         a += b; d ^= a; d = ROTL_32(d, 8); \
+         c += d; b ^= c; b = ROTL_32(b, 7); \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -89,10 +113,26 @@ struct rng_s
   volatile uint8_t rd_rotate;
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  volatile uint32_t rd_generation; /* Incremented on every pool reseed */
+#endif
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* Per-CPU ChaCha20 output generator.  Only ever touched by its own CPU
+ * with local interrupts disabled, so no lock is needed.
+ */
+
+struct crng_s
+{
+  uint32_t key[CRNG_KEYWORDS];
+  uint32_t generation; /* Pool generation the key was last mixed with */
+  bool seeded;
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -108,6 +148,10 @@ enum
 
 static struct rng_s g_rng;
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct crng_s g_crng[CRNG_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -313,6 +357,9 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  g_rng.rd_generation++;
+#endif
 }
 
 static void rng_buf_internal(FAR void *bytes, size_t nbytes)
@@ -380,6 +427,143 @@ static void rng_init(void)
    */
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/****************************************************************************
+ * Name: chacha20_block
+ *
+ * Description:
+ *   Compute one ChaCha20 block (RFC 7539) with an all-zero nonce.  Every
+ *   key given to this function is used for a single output stream only,
+ *   so the nonce carries no information here.
+ *
+ ****************************************************************************/
+
+static void chacha20_block(FAR const uint32_t *key, uint32_t counter,
+                           FAR uint32_t *out)
+{
+  uint32_t x[CRNG_BLKWORDS];
+  int i;
+
+  x[0]  = 0x61707865; /* "expand 32-byte k" */
+  x[1]  = 0x3320646e;
+  x[2]  = 0x79622d32;
+  x[3]  = 0x6b206574;
+  memcpy(&x[4], key, CRNG_KEYBYTES);
+  x[12] = counter;
+  x[13] = 0;
+  x[14] = 0;
+  x[15] = 0;
+
+  memcpy(out, x, sizeof(x));
+
+  for (i = 0; i < 10; i++)
+    {
+      CHACHA_QR(x[0], x[4], x[8],  x[12]);
+      CHACHA_QR(x[1], x[5], x[9],  x[13]);
+      CHACHA_QR(x[2], x[6], x[10], x[14]);
+      CHACHA_QR(x[3], x[7], x[11], x[15]);
+      CHACHA_QR(x[0], x[5], x[10], x[15]);
+      CHACHA_QR(x[1], x[6], x[11], x[12]);
+      CHACHA_QR(x[2], x[7], x[8],  x[13]);
+      CHACHA_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+  for (i = 0; i < CRNG_BLKWORDS; i++)
+    {
+      out[i] += x[i];
+    }
+
+  explicit_bzero(x, sizeof(x));
+}
+
+/****************************************************************************
+ * Name: crng_output
+ *
+ * Description:
+ *   Serialize ChaCha20 output words to the byte order defined by RFC 7539.
+ *
+ ****************************************************************************/
+
+static void crng_output(FAR uint8_t *dest, FAR const uint32_t *words,
+                        size_t nbytes)
+{
+  size_t i;
+
+  for (i = 0; i < nbytes; i++)
+    {
+      dest[i] = (uint8_t)(words[i >> 2] >> ((i & 3) << 3));
+    }
+}
+
+/****************************************************************************
+ * Name: crng_reseed
+ *
+ * Description:
+ *   Mix fresh output of the central pool into the current CPU's key if the
+ *   pool has been reseeded since the key was last refreshed, or if enough
+ *   new entropy has accumulated to warrant a pool reseed.
+ *
+ *   Only the very first seeding of a CPU waits for the pool lock.  After
+ *   that the refresh is opportunistic: if another thread holds the pool,
+ *   the caller just keeps going with its current (still secret) key and
+ *   tries again on the next request.
+ *
+ ****************************************************************************/
+
+static void crng_reseed(void)
+{
+  FAR struct crng_s *crng;
+  uint32_t seed[CRNG_KEYWORDS];
+  uint32_t generation;
+  irqstate_t flags;
+  int i;
+
+  crng = &g_crng[up_cpu_index()];
+  if (crng->seeded && crng->generation == g_rng.rd_generation &&
+      g_rng.rd_newentr < MAX_SEED_NEW_ENTROPY_WORDS)
+    {
+      return;
+    }
+
+  if (crng->seeded)
+    {
+      if (sem_trywait(&g_rng.rd_sem) != OK)
+        {
+          return;
+        }
+    }
+  else
+    {
+      while (sem_wait(&g_rng.rd_sem) != 0)
+        {
+          assert(errno == EINTR);
+        }
+    }
+
+  rng_buf_internal(seed, sizeof(seed));
+  generation = g_rng.rd_generation;
+  sem_post(&g_rng.rd_sem);
+
+  /* We may have migrated while holding the pool; seed whichever CPU we
+   * are running on now.
+   */
+
+  flags = up_irq_save();
+  crng  = &g_crng[up_cpu_index()];
+
+  for (i = 0; i < CRNG_KEYWORDS; i++)
+    {
+      crng->key[i] ^= seed[i];
+    }
+
+  crng->generation = generation;
+  crng->seeded     = true;
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_PERCPU */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -551,6 +735,69 @@ void up_randompool_initialize(void)
 
 void getrandom(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  FAR struct crng_s *crng;
+  FAR uint8_t *dest = bytes;
+  uint32_t block[CRNG_BLKWORDS];
+  uint32_t key[CRNG_KEYWORDS];
+  uint32_t counter;
+  irqstate_t flags;
+
+  /* Step this CPU's generator once with local interrupts disabled: the
+   * first half of the block replaces the CPU key (so earlier output cannot
+   * be reconstructed from the current state) and the second half becomes
+   * a one-time key for this request.  Retry if a migration left us on a CPU
+   * that has not been seeded yet.
+   */
+
+  for (; ; )
+    {
+      crng_reseed();
+
+      flags = up_irq_save();
+      crng  = &g_crng[up_cpu_index()];
+      if (crng->seeded)
+        {
+          break;
+        }
+
+      up_irq_restore(flags);
+    }
+
+  chacha20_block(crng->key, 0, block);
+  memcpy(crng->key, block, CRNG_KEYBYTES);
+  up_irq_restore(flags);
+
+  if (nbytes <= CRNG_KEYBYTES)
+    {
+      /* Small requests (sequence numbers, nonces) are served directly */
+
+      crng_output(dest, &block[CRNG_KEYWORDS], nbytes);
+    }
+  else
+    {
+      /* Generate the keystream of the one-time key without holding
+       * anything.
+       */
+
+      memcpy(key, &block[CRNG_KEYWORDS], CRNG_KEYBYTES);
+
+      for (counter = 0; nbytes > 0; counter++)
+        {
+          size_t block_size = MIN(nbytes, CRNG_BLKBYTES);
+
+          chacha20_block(key, counter, block);
+          crng_output(dest, block, block_size);
+
+          dest   += block_size;
+          nbytes -= block_size;
+        }
+
+      explicit_bzero(key, sizeof(key));
+    }
+
+  explicit_bzero(block, sizeof(block));
+#else
   while (sem_wait(&g_rng.rd_sem) != 0)
     {
       assert(errno == EINTR);
@@ -558,4 +805,5 @@ void getrandom(FAR void *bytes, size_t nbytes)
 
   rng_buf_internal(bytes, nbytes);
   sem_post(&g_rng.rd_sem);
+#endif
 }
@@ -58,8 +58,11 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/analog/adc.h>
+#include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
 
 #include <nuttx/irq.h>
@@ -76,6 +79,17 @@ static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
 static void    adc_notify(FAR struct adc_dev_s *dev);
+#ifdef CONFIG_ADC_STREAM
+static int     adc_waitblock(FAR struct file *filep,
+                             FAR struct adc_dev_s *dev);
+static ssize_t adc_readblocks(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev, FAR char *buffer,
+                              size_t buflen);
+static int     adc_streamstart(FAR struct adc_dev_s *dev);
+static int     adc_streamstop(FAR struct adc_dev_s *dev);
+static int     adc_receiveblock(FAR struct adc_dev_s *dev,
+                                FAR const uint16_t *data, size_t nsamples);
+#endif
 #ifndef CONFIG_DISABLE_POLL
 static int     adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup);
 #endif
@@ -102,7 +116,10 @@ static const struct file_operations g_adc_fops =
 
 static const struct adc_callback_s g_adc_callback =
 {
-  adc_receive   /* au_receive */
+  adc_receive         /* au_receive */
+#ifdef CONFIG_ADC_STREAM
+  , adc_receiveblock  /* au_receiveblock */
+#endif
 };
 
 /****************************************************************************
@@ -216,6 +233,12 @@ static int adc_close(FAR struct file *filep)
 
           dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_STREAM
+          /* Stop streaming and free the ring of blocks */
+
+          (void)adc_streamstop(dev);
+#endif
+
           /* Free the IRQ and disable the ADC device */
 
           flags = enter_critical_section();       /* Disable interrupts */
@@ -244,6 +267,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_STREAM
+  /* While streaming, whole blocks of samples are returned */
+
+  if (dev->ad_blocks != NULL)
+    {
+      return adc_readblocks(filep, dev, buffer, buflen);
+    }
+#endif
+
   /* Determine size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -409,6 +441,239 @@ return_with_irqdisabled:
   return ret;
 }
 
+/****************************************************************************
+ * Name: adc_waitblock
+ *
+ * Description:
+ *   Wait until the ring of streamed blocks is not empty.
+ *
+ * Returned Value:
+ *   OK if a block is available; -ENODATA if streaming is not (or no
+ *   longer) active; another negated errno value on failure.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static int adc_waitblock(FAR struct file *filep, FAR struct adc_dev_s *dev)
+{
+  int ret;
+
+  while (dev->ad_bhead == dev->ad_btail || dev->ad_blocks == NULL)
+    {
+      /* Has streaming been stopped? */
+
+      if (dev->ad_blocks == NULL)
+        {
+          return -ENODATA;
+        }
+
+      /* The ring is empty -- was non-blocking mode selected? */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      /* Wait for a block to be received */
+
+      dev->ad_nrxwaiters++;
+      ret = sem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          return -errno;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_readblocks
+ *
+ * Description:
+ *   Read whole blocks of streamed samples.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static ssize_t adc_readblocks(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct adc_block_s *block;
+  irqstate_t flags;
+  size_t nread;
+  int ret;
+
+  /* As in the sample-by-sample case, the caller must provide room for at
+   * least one block.
+   */
+
+  if (buflen < sizeof(struct adc_block_s))
+    {
+      return 0;
+    }
+
+  flags = enter_critical_section();
+  ret   = adc_waitblock(filep, dev);
+  if (ret < 0)
+    {
+      /* End of the stream if streaming was stopped */
+
+      if (ret == -ENODATA)
+        {
+          ret = 0;
+        }
+
+      goto return_with_irqdisabled;
+    }
+
+  /* The oldest block may not be read while the application holds it */
+
+  if (dev->ad_bheld)
+    {
+      ret = -EBUSY;
+      goto return_with_irqdisabled;
+    }
+
+  /* Copy all of the blocks that will fit in the user buffer */
+
+  nread = 0;
+  do
+    {
+      block = &dev->ad_blocks[dev->ad_bhead];
+
+      /* Feed ADC data to entropy pool */
+
+      add_sensor_randomness(block->ab_data[0]);
+
+      memcpy(&buffer[nread], block, sizeof(struct adc_block_s));
+      nread += sizeof(struct adc_block_s);
+
+      if (++dev->ad_bhead >= CONFIG_ADC_STREAM_NBLOCKS)
+        {
+          dev->ad_bhead = 0;
+        }
+    }
+  while (dev->ad_bhead != dev->ad_btail &&
+         nread + sizeof(struct adc_block_s) <= buflen);
+
+  ret = nread;
+
+return_with_irqdisabled:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_streamstart
+ *
+ * Description:
+ *   Allocate the ring of blocks and start streaming in the lower half.
+ *
+ * Assumptions:
+ *   The caller holds ad_closesem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static int adc_streamstart(FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_block_s *blocks;
+  irqstate_t flags;
+  int ret;
+
+  if (dev->ad_blocks != NULL)
+    {
+      return -EBUSY;
+    }
+
+  blocks = (FAR struct adc_block_s *)
+    kmm_malloc(CONFIG_ADC_STREAM_NBLOCKS * sizeof(struct adc_block_s));
+  if (blocks == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flags          = enter_critical_section();
+  dev->ad_bhead  = 0;
+  dev->ad_btail  = 0;
+  dev->ad_bheld  = false;
+  dev->ad_seqno  = 0;
+  dev->ad_blocks = blocks;
+  leave_critical_section(flags);
+
+  /* Then start the continuous conversion in the lower half */
+
+  ret = dev->ad_ops->ao_ioctl(dev, ANIOC_STREAM_START, 0);
+  if (ret < 0)
+    {
+      aerr("ERROR: Lower half failed to start streaming: %d\n", ret);
+
+      flags          = enter_critical_section();
+      dev->ad_blocks = NULL;
+      leave_critical_section(flags);
+
+      kmm_free(blocks);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: adc_streamstop
+ *
+ * Description:
+ *   Stop streaming in the lower half and free the ring of blocks.  Any
+ *   block held through ANIOC_STREAM_GETBLOCK is released too.
+ *
+ * Assumptions:
+ *   The caller holds ad_closesem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static int adc_streamstop(FAR struct adc_dev_s *dev)
+{
+  FAR struct adc_block_s *blocks;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  if (dev->ad_blocks == NULL)
+    {
+      return OK;
+    }
+
+  ret = dev->ad_ops->ao_ioctl(dev, ANIOC_STREAM_STOP, 0);
+
+  flags          = enter_critical_section();
+  blocks         = dev->ad_blocks;
+  dev->ad_blocks = NULL;
+  dev->ad_bhead  = dev->ad_btail;
+  dev->ad_bheld  = false;
+
+  /* Wake up any readers waiting for blocks that will never come */
+
+  for (i = 0; i < dev->ad_nrxwaiters; i++)
+    {
+      sem_post(&dev->ad_recv.af_sem);
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(blocks);
+  return ret;
+}
+#endif
+
 /************************************************************************************
  * Name: adc_ioctl
  ************************************************************************************/
@@ -417,9 +682,105 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct adc_dev_s *dev = inode->i_private;
+#ifdef CONFIG_ADC_STREAM_ZEROCOPY
+  irqstate_t flags;
+#endif
   int ret;
 
-  ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+  switch (cmd)
+    {
+#ifdef CONFIG_ADC_STREAM
+      /* ANIOC_STREAM_START/ANIOC_STREAM_STOP:  Start or stop streaming
+       * blocks of samples.
+       */
+
+      case ANIOC_STREAM_START:
+      case ANIOC_STREAM_STOP:
+        if (sem_wait(&dev->ad_closesem) != OK)
+          {
+            ret = -errno;
+            break;
+          }
+
+        if (cmd == ANIOC_STREAM_START)
+          {
+            ret = adc_streamstart(dev);
+          }
+        else
+          {
+            ret = adc_streamstop(dev);
+          }
+
+        sem_post(&dev->ad_closesem);
+        break;
+
+#ifdef CONFIG_ADC_STREAM_ZEROCOPY
+      /* ANIOC_STREAM_GETBLOCK:  Return a reference to the oldest block in
+       * the ring.  The block remains valid until ANIOC_STREAM_PUTBLOCK or
+       * ANIOC_STREAM_STOP.  Argument is a pointer to the block pointer.
+       */
+
+      case ANIOC_STREAM_GETBLOCK:
+        {
+          FAR struct adc_block_s **blockp =
+            (FAR struct adc_block_s **)((uintptr_t)arg);
+
+          DEBUGASSERT(blockp != NULL);
+
+          flags = enter_critical_section();
+          ret   = adc_waitblock(filep, dev);
+          if (ret >= 0)
+            {
+              if (dev->ad_bheld)
+                {
+                  ret = -EBUSY;
+                }
+              else
+                {
+                  *blockp       = &dev->ad_blocks[dev->ad_bhead];
+                  dev->ad_bheld = true;
+                }
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      /* ANIOC_STREAM_PUTBLOCK:  Return the block obtained with
+       * ANIOC_STREAM_GETBLOCK to the ring.
+       */
+
+      case ANIOC_STREAM_PUTBLOCK:
+        flags = enter_critical_section();
+        if (!dev->ad_bheld)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            if (++dev->ad_bhead >= CONFIG_ADC_STREAM_NBLOCKS)
+              {
+                dev->ad_bhead = 0;
+              }
+
+            dev->ad_bheld = false;
+            ret = OK;
+          }
+
+        leave_critical_section(flags);
+        break;
+#endif
+#endif
+
+      /* Not a "built-in" ioctl command.. perhaps it is unique to this
+       * lower-half, device driver.
+       */
+
+      default:
+        ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+        break;
+    }
+
   return ret;
 }
 
@@ -464,6 +825,75 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
   return errcode;
 }
 
+/****************************************************************************
+ * Name: adc_receiveblock
+ *
+ * Description:
+ *   Called by the lower half when one half of its DMA buffer is full.  The
+ *   samples are copied into time-stamped blocks at the tail of the ring.
+ *   If the ring is full, the samples are dropped but the sequence number is
+ *   still advanced so that the reader can detect the loss.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ADC_STREAM
+static int adc_receiveblock(FAR struct adc_dev_s *dev,
+                            FAR const uint16_t *data, size_t nsamples)
+{
+  FAR struct adc_block_s *block;
+  struct timespec         ts;
+  size_t                  nchunk;
+  int                     nexttail;
+  int                     errcode = OK;
+
+  if (dev->ad_blocks == NULL)
+    {
+      return -EIO;
+    }
+
+  (void)clock_systimespec(&ts);
+
+  while (nsamples > 0)
+    {
+      nchunk = nsamples;
+      if (nchunk > CONFIG_ADC_STREAM_BLOCKSIZE)
+        {
+          nchunk = CONFIG_ADC_STREAM_BLOCKSIZE;
+        }
+
+      nexttail = dev->ad_btail + 1;
+      if (nexttail >= CONFIG_ADC_STREAM_NBLOCKS)
+        {
+          nexttail = 0;
+        }
+
+      if (nexttail == dev->ad_bhead)
+        {
+          /* The ring is full.  Drop the samples */
+
+          errcode = -ENOMEM;
+        }
+      else
+        {
+          block              = &dev->ad_blocks[dev->ad_btail];
+          block->ab_time     = ts;
+          block->ab_seqno    = dev->ad_seqno;
+          block->ab_nsamples = nchunk;
+          memcpy(block->ab_data, data, nchunk * sizeof(uint16_t));
+
+          dev->ad_btail = nexttail;
+        }
+
+      dev->ad_seqno++;
+      data     += nchunk;
+      nsamples -= nchunk;
+    }
+
+  adc_notify(dev);
+  return errcode;
+}
+#endif
+
 /****************************************************************************
  * Name: adc_pollnotify
  ****************************************************************************/
@@ -571,6 +1001,12 @@ static int adc_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
         {
           adc_pollnotify(dev, POLLIN);
         }
+#ifdef CONFIG_ADC_STREAM
+      else if (dev->ad_blocks != NULL && dev->ad_bhead != dev->ad_btail)
+        {
+          adc_pollnotify(dev, POLLIN);
+        }
+#endif
     }
   else if (fds->priv)
     {
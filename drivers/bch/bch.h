@@ -47,6 +47,7 @@
 #include <stdbool.h>
 #include <semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/drivers/blkcache.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -55,6 +56,18 @@
 #define bchlib_semgive(d) sem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
+/* Sector transfers to and from the contained block driver */
+
+#ifdef CONFIG_BCH_BLKCACHE
+#  define bchlib_devread(b,buf,s,n)  blkcache_read(&(b)->cache, s, n, buf)
+#  define bchlib_devwrite(b,buf,s,n) blkcache_write(&(b)->cache, s, n, buf)
+#else
+#  define bchlib_devread(b,buf,s,n) \
+     (b)->inode->u.i_bops->read((b)->inode, buf, s, n)
+#  define bchlib_devwrite(b,buf,s,n) \
+     (b)->inode->u.i_bops->write((b)->inode, buf, s, n)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -71,6 +84,13 @@ struct bchlib_s
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
   FAR uint8_t *buffer;     /* One sector buffer */
+#ifndef CONFIG_BCH_ENCRYPTION
+  FAR const uint8_t *membase; /* Device content if held in memory (or NULL) */
+#endif
+
+#ifdef CONFIG_BCH_BLKCACHE
+  struct blkcache_s cache; /* Shared block cache of the block driver */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
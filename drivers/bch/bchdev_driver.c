@@ -73,6 +73,10 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
+#ifdef CONFIG_FS_AIO_DRIVER
+static int     bch_aiosubmit(FAR struct bchlib_s *bch,
+                 FAR struct aio_request_s *req);
+#endif
 static int     bch_ioctl(FAR struct file *filep, int cmd,
                  unsigned long arg);
 #ifndef CONFIG_DISABLE_POLL
@@ -180,6 +184,9 @@ static int bch_close(FAR struct file *filep)
 
   bchlib_semtake(bch);
   (void)bchlib_flushsector(bch);
+#ifdef CONFIG_BCH_BLKCACHE
+  (void)blkcache_flush(&bch->cache);
+#endif
 
   /* Decrement the reference count (I don't use bchlib_decref() because I
    * want the entire close operation to be atomic wrt other driver
@@ -341,6 +348,80 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer, size_t
   return ret;
 }
 
+/****************************************************************************
+ * Name: bch_aiosubmit
+ *
+ * Description:
+ *   Convert an asynchronous transfer request to sectors and offer it to the
+ *   contained block driver.  The sector buffer is flushed and invalidated
+ *   first so that it cannot hold stale data after the transfer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_DRIVER
+static int bch_aiosubmit(FAR struct bchlib_s *bch,
+                         FAR struct aio_request_s *req)
+{
+#ifdef CONFIG_BCH_ENCRYPTION
+  /* Encrypted data must always pass through the sector buffer */
+
+  return -ENOTTY;
+#else
+  FAR struct inode *bchinode = bch->inode;
+  int ret;
+
+  if (bchinode->u.i_bops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  /* Only whole sectors can be transferred directly */
+
+  if (req == NULL || req->ar_offset < 0 || req->ar_nbytes == 0 ||
+      (req->ar_offset % bch->sectsize) != 0 ||
+      (req->ar_nbytes % bch->sectsize) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (req->ar_write && bch->readonly)
+    {
+      return -EACCES;
+    }
+
+  req->ar_sector   = req->ar_offset / bch->sectsize;
+  req->ar_nsectors = req->ar_nbytes / bch->sectsize;
+
+  if (req->ar_sector + req->ar_nsectors > bch->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  bchlib_semtake(bch);
+  ret = bchlib_flushsector(bch);
+#ifdef CONFIG_BCH_BLKCACHE
+  if (ret >= 0)
+    {
+      /* The block cache must not hold stale copies either */
+
+      ret = blkcache_flush(&bch->cache);
+      blkcache_invalidate(&bch->cache, req->ar_sector, req->ar_nsectors);
+    }
+#endif
+
+  if (ret >= 0)
+    {
+      bch->sector = (size_t)-1;
+      ret = bchinode->u.i_bops->ioctl(bchinode, BIOC_AIOSUBMIT,
+                                      (unsigned long)((uintptr_t)req));
+    }
+
+  bchlib_semgive(bch);
+  return ret;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: bch_ioctl
  *
@@ -388,6 +469,15 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+#ifdef CONFIG_FS_AIO_DRIVER
+  /* Is this a request to start an asynchronous transfer? */
+
+  else if (cmd == BIOC_AIOSUBMIT)
+    {
+      ret = bch_aiosubmit(bch, (FAR struct aio_request_s *)((uintptr_t)arg));
+    }
+#endif
+
   /* Otherwise, pass the IOCTL command on to the contained block driver */
 
   else
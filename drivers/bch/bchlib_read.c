@@ -106,6 +106,38 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       return 0;
     }
 
+#ifndef CONFIG_BCH_ENCRYPTION
+  /* If the device content is held in memory, then any range of bytes can
+   * be copied directly.  Modified data that has not yet been written to
+   * the device must be written back first.
+   */
+
+  if (bch->membase != NULL)
+    {
+      ret = bchlib_flushsector(bch);
+#ifdef CONFIG_BCH_BLKCACHE
+      if (ret >= 0)
+        {
+          ret = blkcache_flush(&bch->cache);
+        }
+#endif
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
+      if (len > bch->nsectors * bch->sectsize - offset)
+        {
+          len = bch->nsectors * bch->sectsize - offset;
+        }
+
+      memcpy(buffer, &bch->membase[offset], len);
+      return len;
+    }
+#endif
+
   /* Read the initial partial sector */
 
   bytesread = 0;
@@ -154,13 +186,48 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
+#if defined(CONFIG_BCH_ENCRYPTION)
+      /* Encrypted sectors must be decrypted one at a time in the sector
+       * buffer.
+       */
+
+      for (nbytes = 0; nbytes < nsectors; nbytes++)
+        {
+          ret = bchlib_readsector(bch, sector + nbytes);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return ret;
+            }
+
+          memcpy(&buffer[nbytes * bch->sectsize], bch->buffer,
+                 bch->sectsize);
+        }
+#else
+      /* If the sector buffer holds modified data for one of these sectors,
+       * then write it to the media first.
+       */
+
+      if (bch->dirty && bch->sector >= sector &&
+          bch->sector < sector + nsectors)
+        {
+          ret = bchlib_flushsector(bch);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
+        }
+
+      /* Then transfer all of the sectors with a single, multi-sector read */
+
+      ret = bchlib_devread(bch, (FAR uint8_t *)buffer, sector, nsectors);
       if (ret < 0)
         {
-          ferr("ERROR: Read failed: %d\n");
+          ferr("ERROR: Read failed: %d\n", ret);
           return ret;
         }
+#endif
 
       /* Adjust pointers and counts */
 
@@ -51,9 +51,40 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "bch.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_reload and bchlib_flush
+ *
+ * Description:
+ *   Block cache callouts that access the contained block driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BCH_BLKCACHE
+static ssize_t bchlib_reload(FAR void *dev, FAR uint8_t *buffer,
+                             off_t startblock, size_t nblocks)
+{
+  FAR struct inode *inode = ((FAR struct bchlib_s *)dev)->inode;
+
+  return inode->u.i_bops->read(inode, buffer, startblock, nblocks);
+}
+
+static ssize_t bchlib_flush(FAR void *dev, FAR const uint8_t *buffer,
+                            off_t startblock, size_t nblocks)
+{
+  FAR struct inode *inode = ((FAR struct bchlib_s *)dev)->inode;
+
+  return inode->u.i_bops->write(inode, buffer, startblock, nblocks);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -124,6 +155,24 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
+#ifndef CONFIG_BCH_ENCRYPTION
+  /* If the device content is held in memory, then reads can be satisfied
+   * by copying from that memory without staging through the sector buffer.
+   */
+
+  if (bch->inode->u.i_bops->ioctl != NULL)
+    {
+      FAR void *membase;
+
+      ret = bch->inode->u.i_bops->ioctl(bch->inode, BIOC_MEMBASE,
+                                        (unsigned long)((uintptr_t)&membase));
+      if (ret >= 0)
+        {
+          bch->membase = (FAR const uint8_t *)membase;
+        }
+    }
+#endif
+
   /* Allocate the sector I/O buffer */
 
   bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
@@ -134,6 +183,25 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
       goto errout_with_bch;
     }
 
+#ifdef CONFIG_BCH_BLKCACHE
+  /* Attach the block driver to the shared block cache */
+
+  bch->cache.blocksize   = bch->sectsize;
+  bch->cache.nblocks     = bch->nsectors;
+  bch->cache.wrmaxblocks = 1;
+  bch->cache.dev         = bch;
+  bch->cache.reload      = bchlib_reload;
+  bch->cache.flush       = readonly ? NULL : bchlib_flush;
+
+  ret = blkcache_attach(&bch->cache);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to attach the block cache: %d\n", ret);
+      kmm_free(bch->buffer);
+      goto errout_with_bch;
+    }
+#endif
+
   *handle = bch;
   return OK;
 
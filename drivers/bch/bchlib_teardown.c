@@ -79,6 +79,10 @@ int bchlib_teardown(FAR void *handle)
 
   bchlib_flushsector(bch);
 
+#ifdef CONFIG_BCH_BLKCACHE
+  (void)blkcache_detach(&bch->cache);
+#endif
+
   /* Close the block driver */
 
   (void)close_blockdriver(bch->inode);
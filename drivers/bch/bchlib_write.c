@@ -141,15 +141,51 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Write the contiguous sectors */
+#if defined(CONFIG_BCH_ENCRYPTION)
+      /* Encrypted sectors must be encrypted one at a time in the sector
+       * buffer.
+       */
 
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
+      for (nbytes = 0; nbytes < nsectors; nbytes++)
+        {
+          ret = bchlib_flushsector(bch);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
+
+          memcpy(bch->buffer, &buffer[nbytes * bch->sectsize],
+                 bch->sectsize);
+          bch->sector = sector + nbytes;
+          bch->dirty  = true;
+        }
+
+      ret = bchlib_flushsector(bch);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+#else
+      /* The sector buffer will be stale if it holds one of these sectors */
+
+      if (bch->sector >= sector && bch->sector < sector + nsectors)
+        {
+          bch->sector = (size_t)-1;
+          bch->dirty  = false;
+        }
+
+      /* Write the contiguous sectors with a single, multi-sector write */
+
+      ret = bchlib_devwrite(bch, (FAR const uint8_t *)buffer, sector,
+                            nsectors);
       if (ret < 0)
         {
           ferr("ERROR: Write failed: %d\n", ret);
           return ret;
         }
+#endif
 
       /* Adjust pointers and counts */
 
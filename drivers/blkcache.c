@@ -0,0 +1,950 @@
+/****************************************************************************
+ * drivers/blkcache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <queue.h>
+#include <assert.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/drivers/blkcache.h>
+
+#ifdef CONFIG_DRVR_BLKCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SCHED_WORKQUEUE
+#  error "Worker thread support is required (CONFIG_SCHED_WORKQUEUE)"
+#endif
+
+#ifndef CONFIG_DRVR_BLKCACHE_SIZE
+#  define CONFIG_DRVR_BLKCACHE_SIZE 8192
+#endif
+
+#ifndef CONFIG_DRVR_BLKCACHE_NHASH
+#  define CONFIG_DRVR_BLKCACHE_NHASH 32
+#endif
+
+#if (CONFIG_DRVR_BLKCACHE_NHASH & (CONFIG_DRVR_BLKCACHE_NHASH - 1)) != 0
+#  error "CONFIG_DRVR_BLKCACHE_NHASH must be a power of two"
+#endif
+
+#ifndef CONFIG_DRVR_BLKCACHE_WRDELAY
+#  define CONFIG_DRVR_BLKCACHE_WRDELAY 500
+#endif
+
+/* Transfers larger than this (in bytes) bypass the cache so that a large
+ * sequential transfer neither flushes the rest of the cache nor loses its
+ * multi-block access to the media.
+ */
+
+#define BLKCACHE_BYPASS (CONFIG_DRVR_BLKCACHE_SIZE / 4)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached block */
+
+struct blkcache_entry_s
+{
+  dq_entry_t lru;                      /* Must be first: LRU list link */
+  FAR struct blkcache_entry_s *flink;  /* Hash chain link */
+  FAR struct blkcache_s *cache;        /* The device owning the block */
+  off_t      block;                    /* The block number on the device */
+  uint16_t   size;                     /* Size of the data buffer */
+  bool       dirty;                    /* Not yet written to the media */
+  FAR uint8_t *data;                   /* The block data (follows) */
+};
+
+/* The shared pool of cached blocks.  The pool may be re-entered by its
+ * holder when the callout of one cached device accesses another cached
+ * device (for example, a BCH device on top of an FTL device).
+ */
+
+struct blkcache_pool_s
+{
+  sem_t      sem;                      /* Exclusive access to the pool */
+  pid_t      holder;                   /* The thread holding the pool */
+  uint16_t   count;                    /* Number of nested holds */
+  dq_queue_t lru;                      /* Most recently used first */
+  size_t     used;                     /* Bytes of block data allocated */
+  struct work_s work;                  /* Delayed write back of dirty data */
+  FAR struct blkcache_entry_s *hash[CONFIG_DRVR_BLKCACHE_NHASH];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct blkcache_pool_s g_blkcache =
+{
+  SEM_INITIALIZER(1),
+  INVALID_PROCESS_ID
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_semtake
+ *
+ * Description:
+ *   Get exclusive access to the pool.  Returns true if the calling thread
+ *   already held the pool.  The lists of the pool must not be modified in
+ *   that case because the outer caller may be traversing them.
+ *
+ ****************************************************************************/
+
+static bool blkcache_semtake(void)
+{
+  pid_t me = getpid();
+
+  if (g_blkcache.holder == me)
+    {
+      g_blkcache.count++;
+      return true;
+    }
+
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(&g_blkcache.sem) != 0)
+    {
+      /* The only case that an error should occur here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+
+  g_blkcache.holder = me;
+  g_blkcache.count  = 1;
+  return false;
+}
+
+/****************************************************************************
+ * Name: blkcache_semgive
+ ****************************************************************************/
+
+static void blkcache_semgive(void)
+{
+  DEBUGASSERT(g_blkcache.holder == getpid() && g_blkcache.count > 0);
+
+  if (--g_blkcache.count == 0)
+    {
+      g_blkcache.holder = INVALID_PROCESS_ID;
+      sem_post(&g_blkcache.sem);
+    }
+}
+
+/****************************************************************************
+ * Name: blkcache_hash
+ ****************************************************************************/
+
+static inline unsigned int blkcache_hash(FAR struct blkcache_s *cache,
+                                         off_t block)
+{
+  uintptr_t key = ((uintptr_t)cache >> 4) ^ (uintptr_t)block;
+
+  return (unsigned int)(key ^ (key >> 8)) &
+         (CONFIG_DRVR_BLKCACHE_NHASH - 1);
+}
+
+/****************************************************************************
+ * Name: blkcache_find
+ *
+ * Description:
+ *   Return the cache entry holding a block or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s *
+  blkcache_find(FAR struct blkcache_s *cache, off_t block)
+{
+  FAR struct blkcache_entry_s *entry;
+
+  for (entry = g_blkcache.hash[blkcache_hash(cache, block)];
+       entry != NULL;
+       entry = entry->flink)
+    {
+      if (entry->cache == cache && entry->block == block)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: blkcache_touch
+ *
+ * Description:
+ *   Make an entry the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void blkcache_touch(FAR struct blkcache_entry_s *entry)
+{
+  if (g_blkcache.lru.head != &entry->lru)
+    {
+      dq_rem(&entry->lru, &g_blkcache.lru);
+      dq_addfirst(&entry->lru, &g_blkcache.lru);
+    }
+}
+
+/****************************************************************************
+ * Name: blkcache_insert
+ *
+ * Description:
+ *   Add an unused entry to the cache as the most recently used entry.
+ *
+ ****************************************************************************/
+
+static void blkcache_insert(FAR struct blkcache_s *cache,
+                            FAR struct blkcache_entry_s *entry, off_t block)
+{
+  unsigned int ndx = blkcache_hash(cache, block);
+
+  entry->cache          = cache;
+  entry->block          = block;
+  entry->dirty          = false;
+  entry->flink          = g_blkcache.hash[ndx];
+  g_blkcache.hash[ndx]  = entry;
+
+  dq_addfirst(&entry->lru, &g_blkcache.lru);
+  cache->ncached++;
+}
+
+/****************************************************************************
+ * Name: blkcache_remove
+ *
+ * Description:
+ *   Remove an entry from the cache.  Any dirty data is lost.
+ *
+ ****************************************************************************/
+
+static void blkcache_remove(FAR struct blkcache_entry_s *entry)
+{
+  FAR struct blkcache_entry_s **pprev;
+  FAR struct blkcache_s *cache = entry->cache;
+
+  pprev = &g_blkcache.hash[blkcache_hash(cache, entry->block)];
+  while (*pprev != entry)
+    {
+      DEBUGASSERT(*pprev != NULL);
+      pprev = &(*pprev)->flink;
+    }
+
+  *pprev = entry->flink;
+  dq_rem(&entry->lru, &g_blkcache.lru);
+
+  if (entry->dirty)
+    {
+      cache->ndirty--;
+    }
+
+  cache->ncached--;
+  entry->cache = NULL;
+}
+
+/****************************************************************************
+ * Name: blkcache_free
+ ****************************************************************************/
+
+static void blkcache_free(FAR struct blkcache_entry_s *entry)
+{
+  g_blkcache.used -= entry->size;
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Name: blkcache_writeback
+ *
+ * Description:
+ *   Write a dirty block back to the media together with the dirty blocks
+ *   around it, up to wrmaxblocks contiguous blocks at a time.
+ *
+ ****************************************************************************/
+
+static int blkcache_writeback(FAR struct blkcache_entry_s *entry)
+{
+  FAR struct blkcache_s *cache = entry->cache;
+  FAR struct blkcache_entry_s *first = entry;
+  FAR struct blkcache_entry_s *next;
+  FAR const uint8_t *buffer;
+  size_t nblocks;
+  ssize_t ret;
+  off_t block;
+
+  DEBUGASSERT(entry->dirty && cache->flush != NULL);
+
+  if (cache->wrbuffer == NULL)
+    {
+      buffer  = entry->data;
+      nblocks = 1;
+    }
+  else
+    {
+      /* Find the beginning of the run of dirty blocks */
+
+      for (nblocks = 1; nblocks < cache->wrmaxblocks && first->block > 0;
+           nblocks++)
+        {
+          next = blkcache_find(cache, first->block - 1);
+          if (next == NULL || !next->dirty)
+            {
+              break;
+            }
+
+          first = next;
+        }
+
+      /* Then collect the run in the staging buffer */
+
+      memcpy(cache->wrbuffer, first->data, cache->blocksize);
+      for (nblocks = 1; nblocks < cache->wrmaxblocks; nblocks++)
+        {
+          next = blkcache_find(cache, first->block + nblocks);
+          if (next == NULL || !next->dirty)
+            {
+              break;
+            }
+
+          memcpy(&cache->wrbuffer[nblocks * cache->blocksize], next->data,
+                 cache->blocksize);
+        }
+
+      buffer = cache->wrbuffer;
+    }
+
+  ret = cache->flush(cache->dev, buffer, first->block, nblocks);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write of %u blocks at %lu failed: %d\n",
+           (unsigned int)nblocks, (unsigned long)first->block, (int)ret);
+      return (int)ret;
+    }
+
+  /* The blocks are now in sync with the media */
+
+  for (block = first->block; block < first->block + nblocks; block++)
+    {
+      next = (block == entry->block) ? entry : blkcache_find(cache, block);
+      if (next != NULL && next->dirty)
+        {
+          next->dirty = false;
+          cache->ndirty--;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkcache_flushdev
+ *
+ * Description:
+ *   Write back all dirty blocks of one device or, if cache is NULL, of all
+ *   devices.  The first error is returned but all blocks are attempted.
+ *
+ ****************************************************************************/
+
+static int blkcache_flushdev(FAR struct blkcache_s *cache)
+{
+  FAR struct blkcache_entry_s *entry;
+  int result = OK;
+  int ret;
+
+  for (entry = (FAR struct blkcache_entry_s *)g_blkcache.lru.tail;
+       entry != NULL;
+       entry = (FAR struct blkcache_entry_s *)entry->lru.blink)
+    {
+      if (entry->dirty && (cache == NULL || entry->cache == cache))
+        {
+          ret = blkcache_writeback(entry);
+          if (ret < 0 && result == OK)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: blkcache_worker
+ *
+ * Description:
+ *   Write back dirty blocks from the low priority work queue after a
+ *   period of write activity.
+ *
+ ****************************************************************************/
+
+static void blkcache_worker(FAR void *arg)
+{
+  (void)blkcache_semtake();
+  (void)blkcache_flushdev(NULL);
+  blkcache_semgive();
+}
+
+/****************************************************************************
+ * Name: blkcache_alloc
+ *
+ * Description:
+ *   Get an entry for a new block of the device.  A new entry is allocated
+ *   while the total size of the cache is below CONFIG_DRVR_BLKCACHE_SIZE.
+ *   Otherwise, the least recently used entries of any device are replaced,
+ *   writing their data back first if they are dirty.  Returns NULL if no
+ *   entry could be found; the caller should then access the media
+ *   directly.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s *
+  blkcache_alloc(FAR struct blkcache_s *cache)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR struct blkcache_entry_s *prev;
+  FAR struct blkcache_entry_s *alloc;
+
+  entry = (FAR struct blkcache_entry_s *)g_blkcache.lru.tail;
+  for (; ; )
+    {
+      if (g_blkcache.used + cache->blocksize <= CONFIG_DRVR_BLKCACHE_SIZE)
+        {
+          alloc = (FAR struct blkcache_entry_s *)
+            kmm_malloc(sizeof(struct blkcache_entry_s) + cache->blocksize);
+
+          if (alloc != NULL)
+            {
+              alloc->data      = (FAR uint8_t *)&alloc[1];
+              alloc->size      = cache->blocksize;
+              alloc->cache     = NULL;
+              g_blkcache.used += cache->blocksize;
+              return alloc;
+            }
+        }
+
+      /* Replace the next least recently used entry */
+
+      if (entry == NULL)
+        {
+          return NULL;
+        }
+
+      prev = (FAR struct blkcache_entry_s *)entry->lru.blink;
+      if (entry->dirty && blkcache_writeback(entry) < 0)
+        {
+          /* Keep data that could not be written */
+
+          entry = prev;
+          continue;
+        }
+
+      blkcache_remove(entry);
+      if (entry->size == cache->blocksize)
+        {
+          return entry;
+        }
+
+      blkcache_free(entry);
+      entry = prev;
+    }
+}
+
+/****************************************************************************
+ * Name: blkcache_nestedread
+ *
+ * Description:
+ *   Read blocks without modifying the pool (see blkcache_semtake()).
+ *   Cached copies are used where they exist because they may be newer than
+ *   the media.
+ *
+ ****************************************************************************/
+
+static ssize_t blkcache_nestedread(FAR struct blkcache_s *cache,
+                                   off_t startblock, size_t nblocks,
+                                   FAR uint8_t *rdbuffer)
+{
+  FAR struct blkcache_entry_s *entry;
+  size_t nread = 0;
+  size_t run;
+  ssize_t ret;
+
+  while (nread < nblocks)
+    {
+      entry = blkcache_find(cache, startblock + nread);
+      if (entry != NULL)
+        {
+          memcpy(&rdbuffer[nread * cache->blocksize], entry->data,
+                 cache->blocksize);
+          nread++;
+          continue;
+        }
+
+      for (run = 1;
+           nread + run < nblocks &&
+           blkcache_find(cache, startblock + nread + run) == NULL;
+           run++);
+
+      ret = cache->reload(cache->dev, &rdbuffer[nread * cache->blocksize],
+                          startblock + nread, run);
+      if (ret <= 0)
+        {
+          return nread > 0 ? (ssize_t)nread : ret;
+        }
+
+      nread += ret;
+      if ((size_t)ret < run)
+        {
+          break;
+        }
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: blkcache_update
+ *
+ * Description:
+ *   Update the cached copies of blocks that were written directly to the
+ *   media.  The copies are now clean.
+ *
+ ****************************************************************************/
+
+static void blkcache_update(FAR struct blkcache_s *cache, off_t startblock,
+                            size_t nblocks, FAR const uint8_t *wrbuffer)
+{
+  FAR struct blkcache_entry_s *entry;
+  size_t i;
+
+  for (i = 0; i < nblocks && cache->ncached > 0; i++)
+    {
+      entry = blkcache_find(cache, startblock + i);
+      if (entry != NULL)
+        {
+          memcpy(entry->data, &wrbuffer[i * cache->blocksize],
+                 cache->blocksize);
+
+          if (entry->dirty)
+            {
+              entry->dirty = false;
+              cache->ndirty--;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_attach
+ *
+ * Description:
+ *   Start caching the blocks of a device.
+ *
+ ****************************************************************************/
+
+int blkcache_attach(FAR struct blkcache_s *cache)
+{
+  DEBUGASSERT(cache != NULL && cache->reload != NULL);
+
+  if (cache->blocksize == 0 ||
+      cache->blocksize > CONFIG_DRVR_BLKCACHE_SIZE)
+    {
+      ferr("ERROR: Unsupported block size: %u\n", cache->blocksize);
+      return -EINVAL;
+    }
+
+  cache->wrbuffer = NULL;
+  cache->ncached  = 0;
+  cache->ndirty   = 0;
+
+  /* Allocate a staging buffer if contiguous dirty blocks are to be written
+   * together.
+   */
+
+  if (cache->flush != NULL && cache->wrmaxblocks > 1)
+    {
+      cache->wrbuffer = (FAR uint8_t *)
+        kmm_malloc(cache->wrmaxblocks * cache->blocksize);
+
+      if (cache->wrbuffer == NULL)
+        {
+          ferr("ERROR: Failed to allocate the staging buffer\n");
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkcache_detach
+ *
+ * Description:
+ *   Write back all dirty blocks of the device, then release its cached
+ *   blocks and stop caching.  The dirty blocks are discarded (and an error
+ *   returned) if they cannot be written.
+ *
+ ****************************************************************************/
+
+int blkcache_detach(FAR struct blkcache_s *cache)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR struct blkcache_entry_s *next;
+  int ret;
+
+  if (blkcache_semtake())
+    {
+      /* Not supported from within the callouts of the cache */
+
+      DEBUGPANIC();
+    }
+
+  ret = blkcache_flushdev(cache);
+
+  for (entry = (FAR struct blkcache_entry_s *)g_blkcache.lru.head;
+       entry != NULL && cache->ncached > 0;
+       entry = next)
+    {
+      next = (FAR struct blkcache_entry_s *)entry->lru.flink;
+      if (entry->cache == cache)
+        {
+          blkcache_remove(entry);
+          blkcache_free(entry);
+        }
+    }
+
+  if (cache->wrbuffer != NULL)
+    {
+      kmm_free(cache->wrbuffer);
+      cache->wrbuffer = NULL;
+    }
+
+  blkcache_semgive();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_read
+ *
+ * Description:
+ *   Read blocks through the cache.  Blocks that are not cached are read
+ *   from the media and are added to the cache unless the transfer is large
+ *   compared to the size of the cache.  Returns the number of blocks read
+ *   or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct blkcache_s *cache, off_t startblock,
+                      size_t nblocks, FAR uint8_t *rdbuffer)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR uint8_t *buffer;
+  size_t nread = 0;
+  size_t run;
+  size_t i;
+  ssize_t ret;
+
+  if (blkcache_semtake())
+    {
+      ret = blkcache_nestedread(cache, startblock, nblocks, rdbuffer);
+      blkcache_semgive();
+      return ret;
+    }
+
+  while (nread < nblocks)
+    {
+      buffer = &rdbuffer[nread * cache->blocksize];
+
+      entry = blkcache_find(cache, startblock + nread);
+      if (entry != NULL)
+        {
+          /* Cache hit */
+
+          memcpy(buffer, entry->data, cache->blocksize);
+          blkcache_touch(entry);
+          nread++;
+          continue;
+        }
+
+      /* Read the run of blocks that are not in the cache with one access
+       * to the media.
+       */
+
+      for (run = 1;
+           nread + run < nblocks &&
+           blkcache_find(cache, startblock + nread + run) == NULL;
+           run++);
+
+      ret = cache->reload(cache->dev, buffer, startblock + nread, run);
+      if (ret <= 0)
+        {
+          ferr("ERROR: Read of %u blocks at %lu failed: %d\n",
+               (unsigned int)run, (unsigned long)(startblock + nread),
+               (int)ret);
+
+          blkcache_semgive();
+          return nread > 0 ? (ssize_t)nread : ret;
+        }
+
+      /* And keep a copy of them in the cache */
+
+      if (ret * cache->blocksize <= BLKCACHE_BYPASS)
+        {
+          for (i = 0; i < (size_t)ret; i++)
+            {
+              entry = blkcache_alloc(cache);
+              if (entry == NULL)
+                {
+                  break;
+                }
+
+              memcpy(entry->data, &buffer[i * cache->blocksize],
+                     cache->blocksize);
+              blkcache_insert(cache, entry, startblock + nread + i);
+            }
+        }
+
+      nread += ret;
+      if ((size_t)ret < run)
+        {
+          break;
+        }
+    }
+
+  blkcache_semgive();
+  return nread;
+}
+
+/****************************************************************************
+ * Name: blkcache_write
+ *
+ * Description:
+ *   Write blocks through the cache.  Small writes are only placed in the
+ *   cache and are written back to the media later, either when the blocks
+ *   are replaced or after CONFIG_DRVR_BLKCACHE_WRDELAY milliseconds on the
+ *   low priority work queue.  Large writes are passed straight to the
+ *   media.  Returns the number of blocks written or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct blkcache_s *cache, off_t startblock,
+                       size_t nblocks, FAR const uint8_t *wrbuffer)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR const uint8_t *buffer;
+  ssize_t ret = nblocks;
+  size_t i;
+
+  if (cache->flush == NULL)
+    {
+      return -EACCES;
+    }
+
+  if (blkcache_semtake() || nblocks * cache->blocksize > BLKCACHE_BYPASS)
+    {
+      /* Write large transfers (and nested writes) directly, then update
+       * any cached copies.
+       */
+
+      ret = cache->flush(cache->dev, wrbuffer, startblock, nblocks);
+      if (ret > 0)
+        {
+          blkcache_update(cache, startblock, ret, wrbuffer);
+        }
+
+      blkcache_semgive();
+      return ret;
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      buffer = &wrbuffer[i * cache->blocksize];
+
+      entry = blkcache_find(cache, startblock + i);
+      if (entry == NULL)
+        {
+          entry = blkcache_alloc(cache);
+          if (entry == NULL)
+            {
+              /* No room in the cache; write the block directly */
+
+              ret = cache->flush(cache->dev, buffer, startblock + i, 1);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
+          blkcache_insert(cache, entry, startblock + i);
+        }
+      else
+        {
+          blkcache_touch(entry);
+        }
+
+      memcpy(entry->data, buffer, cache->blocksize);
+      if (!entry->dirty)
+        {
+          entry->dirty = true;
+          cache->ndirty++;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      ret = nblocks;
+    }
+  else if (i > 0)
+    {
+      ret = i;
+    }
+
+#if CONFIG_DRVR_BLKCACHE_WRDELAY > 0
+  /* Start the delayed write back of the dirty blocks */
+
+  if (cache->ndirty > 0 && work_available(&g_blkcache.work))
+    {
+      (void)work_queue(LPWORK, &g_blkcache.work, blkcache_worker, NULL,
+                       MSEC2TICK(CONFIG_DRVR_BLKCACHE_WRDELAY));
+    }
+#else
+  /* No delayed write back:  Write the blocks now */
+
+  if (ret > 0)
+    {
+      int result = blkcache_flushdev(cache);
+      if (result < 0)
+        {
+          ret = result;
+        }
+    }
+#endif
+
+  blkcache_semgive();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write back all dirty blocks of the device.  The blocks remain cached.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct blkcache_s *cache)
+{
+  int ret = OK;
+
+  (void)blkcache_semtake();
+  if (cache->ndirty > 0)
+    {
+      ret = blkcache_flushdev(cache);
+    }
+
+  blkcache_semgive();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_invalidate
+ *
+ * Description:
+ *   Discard any cached copies of a range of blocks, including unwritten
+ *   modifications.  Used when the media is modified without going through
+ *   the cache.
+ *
+ ****************************************************************************/
+
+void blkcache_invalidate(FAR struct blkcache_s *cache, off_t startblock,
+                         size_t nblocks)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR struct blkcache_entry_s *next;
+
+  if (blkcache_semtake())
+    {
+      /* Not supported from within the callouts of the cache */
+
+      DEBUGPANIC();
+    }
+
+  for (entry = (FAR struct blkcache_entry_s *)g_blkcache.lru.head;
+       entry != NULL;
+       entry = next)
+    {
+      next = (FAR struct blkcache_entry_s *)entry->lru.flink;
+      if (entry->cache == cache && entry->block >= startblock &&
+          entry->block < startblock + (off_t)nblocks)
+        {
+          blkcache_remove(entry);
+          blkcache_free(entry);
+        }
+    }
+
+  blkcache_semgive();
+}
+
+#endif /* CONFIG_DRVR_BLKCACHE */
@@ -55,6 +55,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/can/can.h>
@@ -124,6 +125,9 @@ static void           can_pollnotify(FAR struct can_dev_s *dev,
 /* CAN helpers */
 
 static uint8_t        can_dlc2bytes(uint8_t dlc);
+#ifdef CONFIG_CAN_TIMESTAMP
+static void           can_timestamp(FAR struct can_hdr_s *hdr);
+#endif
 #if 0 /* Not used */
 static uint8_t        can_bytes2dlc(uint8_t nbytes);
 #endif
@@ -280,6 +284,31 @@ static uint8_t can_dlc2bytes(uint8_t dlc)
   return dlc;
 }
 
+/****************************************************************************
+ * Name: can_timestamp
+ *
+ * Description:
+ *   Record the current time in the ch_ts field of a CAN message header.
+ *
+ * Input Parameter:
+ *   hdr    - The CAN message header to be time stamped
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CAN_TIMESTAMP
+static void can_timestamp(FAR struct can_hdr_s *hdr)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  hdr->ch_ts.tv_sec  = ts.tv_sec;
+  hdr->ch_ts.tv_usec = ts.tv_nsec / 1000;
+}
+#endif
+
 /****************************************************************************
  * Name: can_bytes2dlc
  *
@@ -606,6 +635,9 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
           msg->cm_hdr.ch_extid  = 0;
 #endif
           msg->cm_hdr.ch_unused = 0;
+#ifdef CONFIG_CAN_TIMESTAMP
+          can_timestamp(&msg->cm_hdr);
+#endif
           memset(&(msg->cm_data), 0, CAN_ERROR_DLC);
           msg->cm_data[5]       = dev->cd_error;
 
@@ -665,7 +697,7 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 
           /* Increment the head of the circular message buffer */
 
-          if (++dev->cd_recv.rx_head >= CONFIG_CAN_FIFOSIZE)
+          if (++dev->cd_recv.rx_head >= CONFIG_CAN_RXFIFOSIZE)
             {
               dev->cd_recv.rx_head = 0;
             }
@@ -1220,19 +1252,22 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
                 FAR uint8_t *data)
 {
   FAR struct can_rxfifo_s *fifo = &dev->cd_recv;
-  FAR uint8_t             *dest;
+  FAR struct can_msg_s    *dest;
   int                      nexttail;
+  int                      nbytes;
   int                      errcode = -ENOMEM;
   int                      i;
 
   caninfo("ID: %d DLC: %d\n", hdr->ch_id, hdr->ch_dlc);
 
+  nbytes = can_dlc2bytes(hdr->ch_dlc);
+
   /* Check if adding this new message would over-run the drivers ability to
    * enqueue read data.
    */
 
   nexttail = fifo->rx_tail + 1;
-  if (nexttail >= CONFIG_CAN_FIFOSIZE)
+  if (nexttail >= CONFIG_CAN_RXFIFOSIZE)
     {
       nexttail = 0;
     }
@@ -1258,17 +1293,13 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
           if (msg && hdr->ch_id == rtr->cr_id)
             {
-              int nbytes;
-
               /* We have the response... copy the data to the user's buffer */
 
               memcpy(&msg->cm_hdr, hdr, sizeof(struct can_hdr_s));
-
-              nbytes = can_dlc2bytes(hdr->ch_dlc);
-              for (i = 0, dest = msg->cm_data; i < nbytes; i++)
-                {
-                  *dest++ = *data++;
-                }
+              memcpy(msg->cm_data, data, nbytes);
+#ifdef CONFIG_CAN_TIMESTAMP
+              can_timestamp(&msg->cm_hdr);
+#endif
 
               /* Mark the entry unused */
 
@@ -1286,8 +1317,6 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
   if (nexttail != fifo->rx_head)
     {
-      int nbytes;
-
       /* Add the new, decoded CAN message at the tail of the FIFO.
        *
        * REVISIT:  In the CAN FD format, the coding of the DLC differs from
@@ -1298,20 +1327,19 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
        *   9->12, 10->16, 11->20, 12->24, 13->32, 14->48, 15->64
        */
 
-      memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr, sizeof(struct can_hdr_s));
-
-      nbytes = can_dlc2bytes(hdr->ch_dlc);
-      for (i = 0, dest = fifo->rx_buffer[fifo->rx_tail].cm_data; i < nbytes; i++)
-        {
-          *dest++ = *data++;
-        }
+      dest = &fifo->rx_buffer[fifo->rx_tail];
+      memcpy(&dest->cm_hdr, hdr, sizeof(struct can_hdr_s));
+      memcpy(dest->cm_data, data, nbytes);
+#ifdef CONFIG_CAN_TIMESTAMP
+      can_timestamp(&dest->cm_hdr);
+#endif
 
       /* Increment the tail of the circular buffer */
 
       fifo->rx_tail = nexttail;
 
       /* The increment the counting semaphore. The maximum value should be
-       * CONFIG_CAN_FIFOSIZE -- one possible count for each allocated
+       * CONFIG_CAN_RXFIFOSIZE -- one possible count for each allocated
        * message buffer.
        */
 
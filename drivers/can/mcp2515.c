@@ -220,6 +220,8 @@ static void mcp2515_readregs(FAR struct mcp2515_can_s *priv, uint8_t regaddr,
               FAR uint8_t *buffer, uint8_t len);
 static void mcp2515_writeregs(FAR struct mcp2515_can_s *priv, uint8_t regaddr,
               FAR const uint8_t *buffer, uint8_t len);
+static void mcp2515_readrxbuf(FAR struct mcp2515_can_s *priv, uint8_t cmd,
+              FAR uint8_t *buffer, uint8_t len);
 static void mcp2515_modifyreg(FAR struct mcp2515_can_s *priv, uint8_t regaddr,
               uint8_t mask, uint8_t value);
 #ifdef CONFIG_MCP2515_REGDEBUG
@@ -264,7 +266,7 @@ static bool mcp2515_txempty(FAR struct can_dev_s *dev);
 static void mcp2515_error(FAR struct can_dev_s *dev, uint8_t status,
               uint8_t oldstatus);
 #endif
-static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t offset);
+static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t cmd);
 static int  mcp2515_interrupt(FAR struct mcp2515_config_s *config,
              FAR void *arg);
 
@@ -400,6 +402,50 @@ static void mcp2515_writeregs(FAR struct mcp2515_can_s *priv, uint8_t regaddr,
   (void)SPI_LOCK(config->spi, false);
 }
 
+/****************************************************************************
+ * Name: mcp2515_readrxbuf
+ *
+ * Description:
+ *   Read a received message with a single READ RX BUFFER command.  The
+ *   transfer starts at RXBnSIDH and the MCP2515 clears the RXnIF flag of the
+ *   buffer when the chip select is released.
+ *
+ * Input Parameters:
+ *   priv   - A reference to the MCP2515 peripheral state
+ *   cmd    - MCP2515_READ_RX0 or MCP2515_READ_RX1
+ *   buffer - The location to return the registers
+ *   len    - The number of registers to read
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void mcp2515_readrxbuf(FAR struct mcp2515_can_s *priv, uint8_t cmd,
+                              FAR uint8_t *buffer, uint8_t len)
+{
+  FAR struct mcp2515_config_s *config = priv->config;
+
+  (void)SPI_LOCK(config->spi, true);
+
+  /* Select the MCP2515 */
+
+  SPI_SELECT(config->spi, SPIDEV_CANBUS(0), true);
+
+  /* Send the READ RX BUFFER command and get the bytes read back */
+
+  (void)SPI_SEND(config->spi, cmd);
+  SPI_RECVBLOCK(config->spi, buffer, len);
+
+  /* Deselect the MCP2515.  This clears the RXnIF interrupt flag. */
+
+  SPI_SELECT(config->spi, SPIDEV_CANBUS(0), false);
+
+  /* Unlock bus */
+
+  (void)SPI_LOCK(config->spi, false);
+}
+
 /****************************************************************************
  * Name: mcp2515_modifyreg
  *
@@ -2073,79 +2119,72 @@ static void mcp2515_error(FAR struct can_dev_s *dev, uint8_t status,
  * Name: mcp2515_receive
  *
  * Description:
- *   Receive an MCP2515 messages
+ *   Receive an MCP2515 messages.  The identifier, DLC and data of the
+ *   message are read from the RX buffer in a single SPI transfer.
  *
  * Input Parameters:
- *   dev      - CAN-common state data
- *   rxbuffer - The RX buffer containing the received messages
+ *   dev - CAN-common state data
+ *   cmd - The READ RX BUFFER command for the RX buffer containing the
+ *         received message (MCP2515_READ_RX0 or MCP2515_READ_RX1)
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t offset)
+static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t cmd)
 {
   FAR struct mcp2515_can_s *priv;
   struct can_hdr_s hdr;
   int ret;
-  uint8_t regval;
-  uint8_t data[CAN_MAXDATALEN];
+  uint8_t rxbuf[MCP2515_RXBUF_SIZE];
+  uint8_t sidl;
+  uint8_t dlc;
 
   DEBUGASSERT(dev);
   priv = dev->cd_priv;
   DEBUGASSERT(priv);
 
-  /* Format the CAN header */
+  /* Read RXBnSIDH through RXBnD7.  This also clears the RXnIF flag. */
+
+  mcp2515_readrxbuf(priv, cmd, rxbuf, MCP2515_RXBUF_SIZE);
 
-  /* Get the CAN identifier. */
+  /* Format the CAN header */
 
-  mcp2515_readregs(priv, MCP2515_RXB0SIDL + offset, &regval, 1);
+  sidl = rxbuf[MCP2515_RXBUF_SIDL];
+  dlc  = rxbuf[MCP2515_RXBUF_DLC];
 
 #ifdef CONFIG_CAN_EXTID
-  if ((regval & RXBSIDL_IDE) != 0)
+  if ((sidl & RXBSIDL_IDE) != 0)
     {
+      /* Save the extended ID of the newly received message:
+       *
+       *   STD10 - STD3: SIDH
+       *   STD2 - STD0:  SIDL<7:5>
+       *   EID17 - EID16: SIDL<1:0>
+       *   EID15 - EID8: EID8
+       *   EID7 - EID0:  EID0
+       */
 
-      /* Save the extended ID of the newly received message */
-
-      /* EID7 - EID0 */
-
-      mcp2515_readregs(priv, MCP2515_RXB0EID0 + offset, &regval, 1);
-      hdr.ch_id    = regval ;
-
-      /* EID15 - EID8 */
-
-      mcp2515_readregs(priv, MCP2515_RXB0EID8 + offset, &regval, 1);
-      hdr.ch_id    = hdr.ch_id | (regval << 8);
-
-      /* EID17 and EID16 */
-
-      mcp2515_readregs(priv, MCP2515_RXB0SIDL + offset, &regval, 1);
-      hdr.ch_id    = hdr.ch_id | ((regval & RXBSIDL_EID_MASK) << 16);
-
-      /* STD2 - STD0 */
-
-      hdr.ch_id = hdr.ch_id | ((regval >> 5) << 18);
-
-      /* STD10 - STD3 */
-
-      mcp2515_readregs(priv, MCP2515_RXB0SIDH + offset, &regval, 1);
-      hdr.ch_id = hdr.ch_id | (regval << 21);
+      hdr.ch_id    = (uint32_t)rxbuf[MCP2515_RXBUF_EID0] |
+                     ((uint32_t)rxbuf[MCP2515_RXBUF_EID8] << 8) |
+                     ((uint32_t)(sidl & RXBSIDL_EID_MASK) << 16) |
+                     ((uint32_t)(sidl >> 5) << 18) |
+                     ((uint32_t)rxbuf[MCP2515_RXBUF_SIDH] << 21);
       hdr.ch_extid = true;
+      hdr.ch_rtr   = (dlc & RXBDLC_RTR) != 0;
     }
   else
     {
       /* Save the standard ID of the newly received message */
 
-      mcp2515_readregs(priv, MCP2515_RXB0SIDH + offset, &regval, 1);
-      hdr.ch_id = regval;
-      mcp2515_readregs(priv, MCP2515_RXB0SIDL + offset, &regval, 1);
-      hdr.ch_id = (hdr.ch_id << 3) | (regval >> 5);
+      hdr.ch_id    = ((uint32_t)rxbuf[MCP2515_RXBUF_SIDH] << 3) | (sidl >> 5);
       hdr.ch_extid = false;
+      hdr.ch_rtr   = (sidl & RXBSIDL_SRR) != 0;
     }
 
 #else
-  if ((regval & RXBSIDL_IDE) != 0)
+  if ((sidl & RXBSIDL_IDE) != 0)
     {
       /* Drop any messages with extended IDs */
 
@@ -2156,10 +2195,8 @@ static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t offset)
 
   /* Save the standard ID of the newly received message */
 
-  mcp2515_readregs(priv, MCP2515_RXB0SIDH + offset, &regval, 1);
-  hdr.ch_id = regval;
-  mcp2515_readregs(priv, MCP2515_RXB0SIDL + offset, &regval, 1);
-  hdr.ch_id = (hdr.ch_id << 3) | (regval >> 5);
+  hdr.ch_id  = ((uint16_t)rxbuf[MCP2515_RXBUF_SIDH] << 3) | (sidl >> 5);
+  hdr.ch_rtr = (sidl & RXBSIDL_SRR) != 0;
 #endif
 
 #ifdef CONFIG_CAN_ERRORS
@@ -2167,21 +2204,15 @@ static void mcp2515_receive(FAR struct can_dev_s *dev, uint8_t offset)
 #endif
   hdr.ch_unused = 0;
 
-  /* Extract the RTR bit */
-
-  mcp2515_readregs(priv, MCP2515_RXB0CTRL, &regval, 1);
-  hdr.ch_rtr = (regval & RXBCTRL_RXRTR) != 0;
-
-  /* Get the DLC */
-
-  mcp2515_readregs(priv, MCP2515_RXB0DLC, &regval, 1);
-  hdr.ch_dlc = (regval & RXBDLC_DLC_MASK) >> RXBDLC_DLC_SHIFT;
-
-  /* Save the message data */
+  /* Get the DLC.  The MCP2515 never receives more than 8 data bytes. */
 
-  mcp2515_readregs(priv, MCP2515_RXB0D0, data, (uint8_t) hdr.ch_dlc);
+  hdr.ch_dlc = (dlc & RXBDLC_DLC_MASK) >> RXBDLC_DLC_SHIFT;
+  if (hdr.ch_dlc > 8)
+    {
+      hdr.ch_dlc = 8;
+    }
 
-  ret = can_receive(dev, &hdr, (FAR uint8_t *) data);
+  ret = can_receive(dev, &hdr, &rxbuf[MCP2515_RXBUF_D0]);
 
   if (ret < 0)
     {
@@ -2207,8 +2238,7 @@ static int mcp2515_interrupt(FAR struct mcp2515_config_s *config, FAR void *arg)
 {
   FAR struct can_dev_s *dev = (FAR struct can_dev_s *)arg;
   FAR struct mcp2515_can_s *priv;
-  uint8_t ir;
-  uint8_t ie;
+  uint8_t regs[2];  /* CANINTE and CANINTF */
   uint8_t pending;
   bool    handled;
 
@@ -2223,10 +2253,9 @@ static int mcp2515_interrupt(FAR struct mcp2515_config_s *config, FAR void *arg)
     {
       /* Get the set of pending interrupts. */
 
-      mcp2515_readregs(priv, MCP2515_CANINTF, &ir, 1);
-      mcp2515_readregs(priv, MCP2515_CANINTE, &ie, 1);
+      mcp2515_readregs(priv, MCP2515_CANINTE, regs, 2);
 
-      pending = (ir & ie);
+      pending = (regs[1] & regs[0]);
       handled = false;
 
       /* Check for any errors */
@@ -2318,29 +2347,20 @@ static int mcp2515_interrupt(FAR struct mcp2515_config_s *config, FAR void *arg)
 
       if ((pending & MCP2515_RXBUFFER_INTS) != 0)
         {
-          /* RX Buffer 0 is the "high priority" buffer:  We will process
-           * all messages in RXB0 before processing any message from RX
-           * RXB1.
+          /* RX Buffer 0 is the "high priority" buffer:  Empty it first,
+           * then RXB1, so that both buffers are drained on each pass.
+           * Reading a buffer with the READ RX BUFFER command also clears
+           * its interrupt flag.
            */
 
           if ((pending & MCP2515_INT_RX0) != 0)
             {
-              mcp2515_receive(dev, MCP2515_RX0_OFFSET);
-
-              /* Clear RX0 interrupt */
-
-              mcp2515_modifyreg(priv, MCP2515_CANINTF, MCP2515_INT_RX0, ~MCP2515_INT_RX0);
+              mcp2515_receive(dev, MCP2515_READ_RX0);
             }
-          else
-            {
-              if ((pending & MCP2515_INT_RX1) != 0)
-                {
-                  mcp2515_receive(dev, MCP2515_RX1_OFFSET);
 
-                  /* Clear RX1 interrupt */
-
-                  mcp2515_modifyreg(priv, MCP2515_CANINTF, MCP2515_INT_RX1, ~MCP2515_INT_RX1);
-                }
+          if ((pending & MCP2515_INT_RX1) != 0)
+            {
+              mcp2515_receive(dev, MCP2515_READ_RX1);
             }
 
           /* Acknowledge reading the FIFO entry */
@@ -162,6 +162,16 @@
 #define MCP2515_RX0_OFFSET   0x00
 #define MCP2515_RX1_OFFSET   0x10
 
+/* Layout of the data returned by the READ RX BUFFER commands */
+
+#define MCP2515_RXBUF_SIDH   0
+#define MCP2515_RXBUF_SIDL   1
+#define MCP2515_RXBUF_EID8   2
+#define MCP2515_RXBUF_EID0   3
+#define MCP2515_RXBUF_DLC    4
+#define MCP2515_RXBUF_D0     5
+#define MCP2515_RXBUF_SIZE   13
+
 /* Offset to simplify mcp2515_send() function */
 
 #define MCP2515_TX0_OFFSET   0x00
@@ -0,0 +1,155 @@
+/****************************************************************************
+ * drivers/i2c/i2c_submit.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* I2C_TRANSFER blocks until the transfer completes, so prefer the low
+ * priority work queue if it is available.
+ */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define I2CWORK LPWORK
+#else
+#  define I2CWORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_submit_worker
+ *
+ * Description:
+ *   Perform a batch that the I2C driver could not run itself, one request
+ *   after the other.
+ *
+ ****************************************************************************/
+
+static void i2c_submit_worker(FAR void *arg)
+{
+  FAR struct i2c_request_s *req = (FAR struct i2c_request_s *)arg;
+  FAR struct i2c_request_s *next;
+  FAR struct i2c_master_s *dev = req->dev;
+  int ret;
+
+  while (req != NULL)
+    {
+      /* The callback may re-use the request, so get the link first */
+
+      next = req->flink;
+      ret  = I2C_TRANSFER(dev, req->msgv, req->msgc);
+      if (ret < 0)
+        {
+          i2cerr("ERROR: I2C_TRANSFER failed: %d\n", ret);
+        }
+
+      req->callback(req, ret);
+      req = next;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_submit
+ *
+ * Description:
+ *   Queue a batch of transfer requests and return without waiting for
+ *   them.  The requests are performed in order and the callback of each
+ *   is called when it has completed.  Sensor drivers can so overlap their
+ *   processing with the bus transfers instead of blocking a thread on
+ *   each transfer.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The first request of the batch, linked through 'flink'
+ *
+ * Returned Value:
+ *   Zero (OK) if the batch was queued; a negated errno value on failure.
+ *   No callback is called if the batch was not queued.
+ *
+ ****************************************************************************/
+
+int i2c_submit(FAR struct i2c_master_s *dev, FAR struct i2c_request_s *req)
+{
+  FAR struct i2c_request_s *curr;
+  int ret;
+
+  DEBUGASSERT(dev != NULL && req != NULL);
+
+  for (curr = req; curr != NULL; curr = curr->flink)
+    {
+      DEBUGASSERT(curr->msgv != NULL && curr->callback != NULL);
+      curr->dev = dev;
+    }
+
+  /* Let the I2C driver run the batch from its interrupt handler if it
+   * can.
+   */
+
+  ret = I2C_SUBMIT(dev, req);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+
+  /* Otherwise perform the batch on the work queue.  Batches queued one
+   * after the other are performed in the same order.
+   */
+
+  return work_queue(I2CWORK, &req->work, i2c_submit_worker, req, 0);
+}
+
+#endif /* CONFIG_I2C_ASYNC */
@@ -72,7 +72,6 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/random.h>
 
-#include <nuttx/semaphore.h>
 #include <nuttx/input/touchscreen.h>
 #include <nuttx/input/ads7843e.h>
 
@@ -104,11 +103,7 @@ static uint16_t ads7843e_sendcmd(FAR struct ads7843e_dev_s *priv, uint8_t cmd);
 
 /* Interrupts and data sampling */
 
-static void ads7843e_notify(FAR struct ads7843e_dev_s *priv);
-static int ads7843e_sample(FAR struct ads7843e_dev_s *priv,
-                           FAR struct ads7843e_sample_s *sample);
-static int ads7843e_waitsample(FAR struct ads7843e_dev_s *priv,
-                               FAR struct ads7843e_sample_s *sample);
+static void ads7843e_report(FAR struct ads7843e_dev_s *priv);
 static void ads7843e_worker(FAR void *arg);
 static int ads7843e_interrupt(int irq, FAR void *context, FAR void *arg);
 
@@ -286,181 +281,72 @@ static uint16_t ads7843e_sendcmd(FAR struct ads7843e_dev_s *priv, uint8_t cmd)
 }
 
 /****************************************************************************
- * Name: ads7843e_notify
+ * Name: ads7843e_report
+ *
+ * Description:
+ *   Queue a touch report for the current sample and advance the contact
+ *   state.
+ *
  ****************************************************************************/
 
-static void ads7843e_notify(FAR struct ads7843e_dev_s *priv)
+static void ads7843e_report(FAR struct ads7843e_dev_s *priv)
 {
-#ifndef CONFIG_DISABLE_POLL
-  int i;
-#endif
+  FAR struct ads7843e_sample_s *sample = &priv->sample;
+  struct touch_sample_s report;
 
-  /* If there are threads waiting for read data, then signal one of them
-   * that the read data is available.
-   */
+  memset(&report, 0, sizeof(struct touch_sample_s));
+  report.npoints            = 1;
+  report.point[0].id        = sample->id;
+  report.point[0].x         = sample->x;
+  report.point[0].y         = sample->y;
+  report.point[0].timestamp = input_timestamp();
 
-  if (priv->nwaiters > 0)
+  /* Report the appropriate flags */
+
+  if (sample->contact == CONTACT_UP)
     {
-      /* After posting this semaphore, we need to exit because the ADS7843E
-       * is no longer available.
+      /* Pen is now up.  Is the positional data valid?  This is important to
+       * know because the release will be sent to the window based on its
+       * last positional data.
        */
 
-      sem_post(&priv->waitsem);
-    }
-
-  /* If there are threads waiting on poll() for ADS7843E data to become available,
-   * then wake them up now.  NOTE: we wake up all waiting threads because we
-   * do not know that they are going to do.  If they all try to read the data,
-   * then some make end up blocking after all.
-   */
-
-#ifndef CONFIG_DISABLE_POLL
-  for (i = 0; i < CONFIG_ADS7843E_NPOLLWAITERS; i++)
-    {
-      struct pollfd *fds = priv->fds[i];
-      if (fds)
+      if (sample->valid)
         {
-          fds->revents |= POLLIN;
-          iinfo("Report events: %02x\n", fds->revents);
-          sem_post(fds->sem);
+          report.point[0].flags = TOUCH_UP | TOUCH_ID_VALID | TOUCH_POS_VALID;
         }
-    }
-#endif
-}
-
-/****************************************************************************
- * Name: ads7843e_sample
- ****************************************************************************/
-
-static int ads7843e_sample(FAR struct ads7843e_dev_s *priv,
-                          FAR struct ads7843e_sample_s *sample)
-{
-  irqstate_t flags;
-  int ret = -EAGAIN;
-
-  /* Interrupts me be disabled when this is called to (1) prevent posting
-   * of semaphores from interrupt handlers, and (2) to prevent sampled data
-   * from changing until it has been reported.
-   */
-
-  flags = enter_critical_section();
-
-  /* Is there new ADS7843E sample data available? */
-
-  if (priv->penchange)
-    {
-      /* Yes.. the state has changed in some way.  Return a copy of the
-       * sampled data.
-       */
-
-      memcpy(sample, &priv->sample, sizeof(struct ads7843e_sample_s));
-
-      /* Now manage state transitions */
-
-      if (sample->contact == CONTACT_UP)
+      else
         {
-          /* Next.. no contact.  Increment the ID so that next contact ID
-           * will be unique.  X/Y positions are no longer valid.
-           */
-
-          priv->sample.contact = CONTACT_NONE;
-          priv->sample.valid   = false;
-          priv->id++;
+          report.point[0].flags = TOUCH_UP | TOUCH_ID_VALID;
         }
-      else if (sample->contact == CONTACT_DOWN)
-       {
-          /* First report -- next report will be a movement */
 
-         priv->sample.contact = CONTACT_MOVE;
-       }
+      /* Next.. no contact.  Increment the ID so that next contact ID will be
+       * unique.  X/Y positions are no longer valid.
+       */
 
-      priv->penchange = false;
-      ret = OK;
+      sample->contact = CONTACT_NONE;
+      sample->valid   = false;
+      priv->id++;
     }
-
-  leave_critical_section(flags);
-  return ret;
-}
-
-/****************************************************************************
- * Name: ads7843e_waitsample
- ****************************************************************************/
-
-static int ads7843e_waitsample(FAR struct ads7843e_dev_s *priv,
-                               FAR struct ads7843e_sample_s *sample)
-{
-  irqstate_t flags;
-  int ret;
-
-  /* Interrupts me be disabled when this is called to (1) prevent posting
-   * of semaphores from interrupt handlers, and (2) to prevent sampled data
-   * from changing until it has been reported.
-   *
-   * In addition, we will also disable pre-emption to prevent other threads
-   * from getting control while we muck with the semaphores.
-   */
-
-  sched_lock();
-  flags = enter_critical_section();
-
-  /* Now release the semaphore that manages mutually exclusive access to
-   * the device structure.  This may cause other tasks to become ready to
-   * run, but they cannot run yet because pre-emption is disabled.
-   */
-
-  sem_post(&priv->devsem);
-
-  /* Try to get the a sample... if we cannot, then wait on the semaphore
-   * that is posted when new sample data is available.
-   */
-
-  while (ads7843e_sample(priv, sample) < 0)
+  else if (sample->contact == CONTACT_DOWN)
     {
-      /* Wait for a change in the ADS7843E state */
-
-      iinfo("Waiting..\n");
-      priv->nwaiters++;
-      ret = sem_wait(&priv->waitsem);
-      priv->nwaiters--;
+      /* First contact.  The next report will be a movement */
 
-      if (ret < 0)
-        {
-          /* If we are awakened by a signal, then we need to return
-           * the failure now.
-           */
-
-          ierr("ERROR: sem_wait: %d\n", errno);
-          DEBUGASSERT(errno == EINTR);
-          ret = -EINTR;
-          goto errout;
-        }
+      report.point[0].flags = TOUCH_DOWN | TOUCH_ID_VALID | TOUCH_POS_VALID;
+      sample->contact       = CONTACT_MOVE;
     }
+  else /* if (sample->contact == CONTACT_MOVE) */
+    {
+      /* Movement of the same contact */
 
-  iinfo("Sampled\n");
-
-  /* Re-acquire the semaphore that manages mutually exclusive access to
-   * the device structure.  We may have to wait here.  But we have our sample.
-   * Interrupts and pre-emption will be re-enabled while we wait.
-   */
-
-  ret = sem_wait(&priv->devsem);
-
-errout:
-  /* Then re-enable interrupts.  We might get interrupt here and there
-   * could be a new sample.  But no new threads will run because we still
-   * have pre-emption disabled.
-   */
-
-  leave_critical_section(flags);
+      report.point[0].flags = TOUCH_MOVE | TOUCH_ID_VALID | TOUCH_POS_VALID;
+    }
 
-  /* Restore pre-emption.  We might get suspended here but that is okay
-   * because we already have our sample.  Note:  this means that if there
-   * were two threads reading from the ADS7843E for some reason, the data
-   * might be read out of order.
-   */
+  iinfo("  id:      %d\n", report.point[0].id);
+  iinfo("  flags:   %02x\n", report.point[0].flags);
+  iinfo("  x:       %d\n", report.point[0].x);
+  iinfo("  y:       %d\n", report.point[0].y);
 
-  sched_unlock();
-  return ret;
+  input_queue_put(&priv->queue, &report);
 }
 
 /****************************************************************************
@@ -577,40 +463,22 @@ static void ads7843e_worker(FAR void *arg)
       priv->threshx = INVALID_THRESHOLD;
       priv->threshy = INVALID_THRESHOLD;
 
-      /* Ignore the interrupt if the pen was already up (CONTACT_NONE == pen up
-       * and already reported; CONTACT_UP == pen up, but not reported)
+      /* Ignore the interrupt if the pen was already up (CONTACT_NONE == pen
+       * up and already reported).
        */
 
-      if (priv->sample.contact == CONTACT_NONE ||
-          priv->sample.contact == CONTACT_UP)
+      if (priv->sample.contact == CONTACT_NONE)
         {
           goto ignored;
         }
 
       /* The pen is up.  NOTE: We know from a previous test, that this is a
        * loss of contact condition.  This will be changed to CONTACT_NONE
-       * after the loss of contact is sampled.
+       * when the loss of contact is reported.
        */
 
        priv->sample.contact = CONTACT_UP;
     }
-
-  /* It is a pen down event.  If the last loss-of-contact event has not been
-   * processed yet, then we have to ignore the pen down event (or else it will
-   * look like a drag event)
-   */
-
-  else if (priv->sample.contact == CONTACT_UP)
-    {
-      /* If we have not yet processed the last pen up event, then we
-       * cannot handle this pen down event. We will have to discard it.  That
-       * should be okay because we will set the timer to to sample again
-       * later.
-       */
-
-       wd_start(priv->wdog, ADS7843E_WDOG_DELAY, ads7843e_wdog, 1, (uint32_t)priv);
-       goto ignored;
-    }
   else
     {
       /* Handle pen down events.  First, sample positional values. NOTE:
@@ -675,14 +543,10 @@ static void ads7843e_worker(FAR void *arg)
         }
     }
 
-  /* Indicate the availability of new sample data for this ID */
+  /* Queue the new sample data for this ID and wake up any readers */
 
   priv->sample.id = priv->id;
-  priv->penchange = true;
-
-  /* Notify any waiters that new ADS7843E data is available */
-
-  ads7843e_notify(priv);
+  ads7843e_report(priv);
 
   /* Exit, re-enabling ADS7843E interrupts */
 
@@ -853,9 +717,6 @@ static ssize_t ads7843e_read(FAR struct file *filep, FAR char *buffer, size_t le
 {
   FAR struct inode          *inode;
   FAR struct ads7843e_dev_s *priv;
-  FAR struct touch_sample_s *report;
-  struct ads7843e_sample_s   sample;
-  int                        ret;
 
   iinfo("buffer:%p len:%d\n", buffer, len);
   DEBUGASSERT(filep);
@@ -878,100 +739,12 @@ static ssize_t ads7843e_read(FAR struct file *filep, FAR char *buffer, size_t le
       return -ENOSYS;
     }
 
-  /* Get exclusive access to the driver data structure */
-
-  ret = sem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      ierr("ERROR: sem_wait: %d\n", errno);
-      DEBUGASSERT(errno == EINTR);
-      return -EINTR;
-    }
-
-  /* Try to read sample data. */
-
-  ret = ads7843e_sample(priv, &sample);
-  if (ret < 0)
-    {
-      /* Sample data is not available now.  We would ave to wait to get
-       * receive sample data.  If the user has specified the O_NONBLOCK
-       * option, then just return an error.
-       */
-
-      iinfo("Sample data is not available\n");
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          ret = -EAGAIN;
-          goto errout;
-       }
-
-      /* Wait for sample data */
-
-      ret = ads7843e_waitsample(priv, &sample);
-      if (ret < 0)
-        {
-          /* We might have been awakened by a signal */
-
-          ierr("ERROR: ads7843e_waitsample: %d\n", ret);
-          goto errout;
-        }
-    }
-
-  /* In any event, we now have sampled ADS7843E data that we can report
-   * to the caller.
+  /* Return as many of the buffered touch samples as fit in the user buffer,
+   * waiting for a sample unless the O_NONBLOCK option was specified.
    */
 
-  report = (FAR struct touch_sample_s *)buffer;
-  memset(report, 0, SIZEOF_TOUCH_SAMPLE_S(1));
-  report->npoints            = 1;
-  report->point[0].id        = sample.id;
-  report->point[0].x         = sample.x;
-  report->point[0].y         = sample.y;
-
-  /* Report the appropriate flags */
-
-  if (sample.contact == CONTACT_UP)
-    {
-      /* Pen is now up.  Is the positional data valid?  This is important to
-       * know because the release will be sent to the window based on its
-       * last positional data.
-       */
-
-      if (sample.valid)
-        {
-          report->point[0].flags  = TOUCH_UP | TOUCH_ID_VALID | TOUCH_POS_VALID;
-        }
-      else
-        {
-          report->point[0].flags  = TOUCH_UP | TOUCH_ID_VALID;
-        }
-    }
-  else if (sample.contact == CONTACT_DOWN)
-    {
-      /* First contact */
-
-      report->point[0].flags  = TOUCH_DOWN | TOUCH_ID_VALID | TOUCH_POS_VALID;
-    }
-  else /* if (sample->contact == CONTACT_MOVE) */
-    {
-      /* Movement of the same contact */
-
-      report->point[0].flags  = TOUCH_MOVE | TOUCH_ID_VALID | TOUCH_POS_VALID;
-    }
-
-  iinfo("  id:      %d\n", report->point[0].id);
-  iinfo("  flags:   %02x\n", report->point[0].flags);
-  iinfo("  x:       %d\n", report->point[0].x);
-  iinfo("  y:       %d\n", report->point[0].y);
-
-  ret = SIZEOF_TOUCH_SAMPLE_S(1);
-
-errout:
-  sem_post(&priv->devsem);
-  iinfo("Returning: %d\n", ret);
-  return ret;
+  return input_queue_read(&priv->queue, buffer, len,
+                          (filep->f_oflags & O_NONBLOCK) != 0);
 }
 
 /****************************************************************************
@@ -1041,8 +814,6 @@ static int ads7843e_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct inode *inode;
   FAR struct ads7843e_dev_s *priv;
-  int ret;
-  int i;
 
   iinfo("setup: %d\n", (int)setup);
   DEBUGASSERT(filep && fds);
@@ -1051,75 +822,7 @@ static int ads7843e_poll(FAR struct file *filep, FAR struct pollfd *fds,
   DEBUGASSERT(inode && inode->i_private);
   priv  = (FAR struct ads7843e_dev_s *)inode->i_private;
 
-  /* Are we setting up the poll?  Or tearing it down? */
-
-  ret = sem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      DEBUGASSERT(errno == EINTR);
-      return -EINTR;
-    }
-
-  if (setup)
-    {
-      /* Ignore waits that do not include POLLIN */
-
-      if ((fds->events & POLLIN) == 0)
-        {
-          ret = -EDEADLK;
-          goto errout;
-        }
-
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
-
-      for (i = 0; i < CONFIG_ADS7843E_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!priv->fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              priv->fds[i] = fds;
-              fds->priv    = &priv->fds[i];
-              break;
-            }
-        }
-
-      if (i >= CONFIG_ADS7843E_NPOLLWAITERS)
-        {
-          fds->priv    = NULL;
-          ret          = -EBUSY;
-          goto errout;
-        }
-
-      /* Should we immediately notify on any of the requested events? */
-
-      if (priv->penchange)
-        {
-          ads7843e_notify(priv);
-        }
-    }
-  else if (fds->priv)
-    {
-      /* This is a request to tear down the poll. */
-
-      struct pollfd **slot = (struct pollfd **)fds->priv;
-      DEBUGASSERT(slot != NULL);
-
-      /* Remove all memory of the poll setup */
-
-      *slot                = NULL;
-      fds->priv            = NULL;
-    }
-
-errout:
-  sem_post(&priv->devsem);
-  return ret;
+  return input_queue_poll(&priv->queue, fds, setup);
 }
 #endif
 
@@ -1191,13 +894,17 @@ int ads7843e_register(FAR struct spi_dev_s *spi,
   /* Initialize semaphores */
 
   sem_init(&priv->devsem,  0, 1);    /* Initialize device structure semaphore */
-  sem_init(&priv->waitsem, 0, 0);    /* Initialize pen event wait semaphore */
 
-  /* The pen event semaphore is used for signaling and, hence, should not
-   * have priority inheritance enabled.
-   */
+  /* Allocate the buffer of touch samples */
 
-  sem_setprotocol(&priv->waitsem, SEM_PRIO_NONE);
+  ret = input_queue_initialize(&priv->queue, SIZEOF_TOUCH_SAMPLE_S(1),
+                               CONFIG_ADS7843E_NEVENTS,
+                               CONFIG_ADS7843E_NPOLLWAITERS);
+  if (ret < 0)
+    {
+      ierr("ERROR: Failed to allocate the sample buffer\n");
+      goto errout_with_sem;
+    }
 
   /* Make sure that interrupts are disabled */
 
@@ -1267,6 +974,9 @@ int ads7843e_register(FAR struct spi_dev_s *spi,
   return OK;
 
 errout_with_priv:
+  input_queue_uninitialize(&priv->queue);
+
+errout_with_sem:
   sem_destroy(&priv->devsem);
 #ifdef CONFIG_ADS7843E_MULTIPLE
   kmm_free(priv);
@@ -60,6 +60,7 @@
 #include <nuttx/wdog.h>
 #include <nuttx/clock.h>
 #include <nuttx/spi/spi.h>
+#include <nuttx/input/input_queue.h>
 #include <nuttx/input/ads7843e.h>
 
 /********************************************************************************************
@@ -137,28 +138,17 @@ struct ads7843e_dev_s
 #ifdef CONFIG_ADS7843E_REFCNT
   uint8_t crefs;                        /* Number of times the device has been opened */
 #endif
-  uint8_t nwaiters;                     /* Number of threads waiting for ADS7843E data */
   uint8_t id;                           /* Current touch point ID */
-  volatile bool penchange;              /* An unreported event is buffered */
   uint16_t threshx;                     /* Thresholding X value */
   uint16_t threshy;                     /* Thresholding Y value */
   sem_t devsem;                         /* Manages exclusive access to this structure */
-  sem_t waitsem;                        /* Used to wait for the availability of data */
 
   FAR struct ads7843e_config_s *config; /* Board configuration data */
   FAR struct spi_dev_s *spi;            /* Saved SPI driver instance */
   struct work_s work;                   /* Supports the interrupt handling "bottom half" */
   struct ads7843e_sample_s sample;      /* Last sampled touch point data */
   WDOG_ID wdog;                         /* Poll the position while the pen is down */
-
-  /* The following is a list if poll structures of threads waiting for
-   * driver events. The 'struct pollfd' reference for each open is also
-   * retained in the f_priv field of the 'struct file'.
-   */
-
-#ifndef CONFIG_DISABLE_POLL
-  struct pollfd *fds[CONFIG_ADS7843E_NPOLLWAITERS];
-#endif
+  struct input_queue_s queue;           /* Touch samples waiting to be read */
 };
 
 /********************************************************************************************
@@ -0,0 +1,373 @@
+/****************************************************************************
+ * drivers/input/input_queue.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/input/input_queue.h>
+
+#ifdef CONFIG_INPUT_QUEUE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: input_queue_pollnotify
+ *
+ * Description:
+ *   Wake up all threads waiting in poll() for input.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void input_queue_pollnotify(FAR struct input_queue_s *queue)
+{
+  int i;
+
+  for (i = 0; i < queue->iq_npollwaiters; i++)
+    {
+      FAR struct pollfd *fds = queue->iq_fds[i];
+      if (fds)
+        {
+          fds->revents |= POLLIN;
+          iinfo("Report events: %02x\n", fds->revents);
+          sem_post(fds->sem);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: input_queue_initialize
+ *
+ * Description:
+ *   Initialize an input event queue and allocate its storage.
+ *
+ ****************************************************************************/
+
+int input_queue_initialize(FAR struct input_queue_s *queue, size_t evsize,
+                           unsigned int nevents, unsigned int npollwaiters)
+{
+  DEBUGASSERT(queue != NULL && evsize > 0 && evsize <= UINT16_MAX &&
+              nevents > 0 && nevents <= UINT16_MAX);
+
+  memset(queue, 0, sizeof(struct input_queue_s));
+
+  queue->iq_buffer = (FAR uint8_t *)kmm_malloc(evsize * nevents);
+  if (queue->iq_buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  if (npollwaiters > 0)
+    {
+      queue->iq_fds = (FAR struct pollfd **)
+        kmm_zalloc(npollwaiters * sizeof(FAR struct pollfd *));
+      if (queue->iq_fds == NULL)
+        {
+          kmm_free(queue->iq_buffer);
+          queue->iq_buffer = NULL;
+          return -ENOMEM;
+        }
+
+      queue->iq_npollwaiters = npollwaiters;
+    }
+#endif
+
+  queue->iq_evsize  = evsize;
+  queue->iq_nevents = nevents;
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_init(&queue->iq_waitsem, 0, 0);
+  sem_setprotocol(&queue->iq_waitsem, SEM_PRIO_NONE);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: input_queue_uninitialize
+ *
+ * Description:
+ *   Release the resources of an input event queue.
+ *
+ ****************************************************************************/
+
+void input_queue_uninitialize(FAR struct input_queue_s *queue)
+{
+  sem_destroy(&queue->iq_waitsem);
+
+#ifndef CONFIG_DISABLE_POLL
+  if (queue->iq_fds != NULL)
+    {
+      kmm_free(queue->iq_fds);
+      queue->iq_fds = NULL;
+    }
+#endif
+
+  if (queue->iq_buffer != NULL)
+    {
+      kmm_free(queue->iq_buffer);
+      queue->iq_buffer = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: input_queue_put
+ *
+ * Description:
+ *   Add one event to the queue, discarding the oldest event if the queue is
+ *   full, and wake up any readers.
+ *
+ ****************************************************************************/
+
+void input_queue_put(FAR struct input_queue_s *queue, FAR const void *event)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* If the queue is full, then the oldest event is lost */
+
+  if (queue->iq_count >= queue->iq_nevents)
+    {
+      queue->iq_count--;
+      queue->iq_overruns++;
+      iwarn("WARNING: Input event lost: %u\n", queue->iq_overruns);
+    }
+
+  memcpy(&queue->iq_buffer[queue->iq_head * queue->iq_evsize], event,
+         queue->iq_evsize);
+
+  if (++queue->iq_head >= queue->iq_nevents)
+    {
+      queue->iq_head = 0;
+    }
+
+  queue->iq_count++;
+
+  /* Wake up one thread waiting in read() and all threads waiting in
+   * poll().
+   */
+
+  if (queue->iq_nwaiters > 0)
+    {
+      sem_post(&queue->iq_waitsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  input_queue_pollnotify(queue);
+#endif
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: input_queue_read
+ *
+ * Description:
+ *   Remove as many whole events as fit in the buffer, waiting for the first
+ *   event if necessary.
+ *
+ ****************************************************************************/
+
+ssize_t input_queue_read(FAR struct input_queue_s *queue, FAR char *buffer,
+                         size_t len, bool nonblock)
+{
+  irqstate_t flags;
+  unsigned int tail;
+  ssize_t nread;
+  int ret;
+
+  if (len < queue->iq_evsize)
+    {
+      return -EINVAL;
+    }
+
+  /* Interrupts are disabled so that events cannot be added while the queue
+   * indices are examined and while the events are copied.  The critical
+   * section is released while waiting.
+   */
+
+  flags = enter_critical_section();
+
+  while (queue->iq_count == 0)
+    {
+      if (nonblock)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      queue->iq_nwaiters++;
+      ret = sem_wait(&queue->iq_waitsem);
+      queue->iq_nwaiters--;
+
+      if (ret < 0)
+        {
+          /* We were awakened by a signal */
+
+          DEBUGASSERT(get_errno() == EINTR);
+          leave_critical_section(flags);
+          return -EINTR;
+        }
+    }
+
+  /* Copy out the oldest events first */
+
+  nread = 0;
+  while (queue->iq_count > 0 && len - nread >= queue->iq_evsize)
+    {
+      tail = queue->iq_head + queue->iq_nevents - queue->iq_count;
+      if (tail >= queue->iq_nevents)
+        {
+          tail -= queue->iq_nevents;
+        }
+
+      memcpy(&buffer[nread], &queue->iq_buffer[tail * queue->iq_evsize],
+             queue->iq_evsize);
+
+      nread += queue->iq_evsize;
+      queue->iq_count--;
+    }
+
+  leave_critical_section(flags);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: input_queue_poll
+ *
+ * Description:
+ *   Set up or tear down a poll() on the queue.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int input_queue_poll(FAR struct input_queue_s *queue, FAR struct pollfd *fds,
+                     bool setup)
+{
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(queue != NULL && fds != NULL);
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      /* Ignore waits that do not include POLLIN */
+
+      if ((fds->events & POLLIN) == 0)
+        {
+          ierr("ERROR: Missing POLLIN: revents: %08x\n", fds->revents);
+          ret = -EDEADLK;
+          goto errout;
+        }
+
+      /* This is a request to set up the poll.  Find an available slot for
+       * the poll structure reference.
+       */
+
+      for (i = 0; i < queue->iq_npollwaiters; i++)
+        {
+          if (!queue->iq_fds[i])
+            {
+              /* Bind the poll structure and this slot */
+
+              queue->iq_fds[i] = fds;
+              fds->priv        = &queue->iq_fds[i];
+              break;
+            }
+        }
+
+      if (i >= queue->iq_npollwaiters)
+        {
+          ierr("ERROR: No available slot found: %d\n", i);
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout;
+        }
+
+      /* Should we immediately notify on any of the requested events? */
+
+      if (queue->iq_count > 0)
+        {
+          fds->revents |= POLLIN;
+          sem_post(fds->sem);
+        }
+    }
+  else if (fds->priv)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      /* Remove all memory of the poll setup */
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_INPUT_QUEUE */
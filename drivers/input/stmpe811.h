@@ -51,6 +51,7 @@
 #include <nuttx/wdog.h>
 #include <nuttx/clock.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/input/input_queue.h>
 #include <nuttx/input/stmpe811.h>
 
 #if defined(CONFIG_INPUT) && defined(CONFIG_INPUT_STMPE811)
@@ -151,27 +152,16 @@ struct stmpe811_dev_s
 #ifdef CONFIG_STMPE811_REFCNT
   uint8_t crefs;                       /* Number of times the device has been opened */
 #endif
-  uint8_t nwaiters;                    /* Number of threads waiting for STMPE811 data */
   uint8_t id;                          /* Current touch point ID */
   uint8_t minor;                       /* Touchscreen minor device number */
-  volatile bool penchange;             /* An unreported event is buffered */
 
   uint16_t threshx;                    /* Thresholded X value */
   uint16_t threshy;                    /* Thresholded Y value */
-  sem_t waitsem;                       /* Used to wait for the availability of data */
 
   struct work_s timeout;               /* Supports tiemeout work */
   WDOG_ID wdog;                        /* Timeout to detect missing pen down events */
   struct stmpe811_sample_s sample;     /* Last sampled touch point data */
-
-  /* The following is a list if poll structures of threads waiting for
-   * driver events. The 'struct pollfd' reference for each open is also
-   * retained in the f_priv field of the 'struct file'.
-   */
-
-#ifndef CONFIG_DISABLE_POLL
-  struct pollfd *fds[CONFIG_STMPE811_NPOLLWAITERS];
-#endif
+  struct input_queue_s queue;          /* Touch samples waiting to be read */
 #endif
 
   /* Fields that may be disabled to save size of GPIO support is not used */
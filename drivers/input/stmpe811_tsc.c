@@ -66,6 +66,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/input/touchscreen.h>
+#include <nuttx/input/input_queue.h>
 #include <nuttx/input/stmpe811.h>
 
 #include "stmpe811.h"
@@ -111,11 +112,7 @@
  ****************************************************************************/
 /* Internal logic */
 
-static void     stmpe811_notify(FAR struct stmpe811_dev_s *priv);
-static int      stmpe811_sample(FAR struct stmpe811_dev_s *priv,
-                  FAR struct stmpe811_sample_s *sample);
-static inline int stmpe811_waitsample(FAR struct stmpe811_dev_s *priv,
-                  FAR struct stmpe811_sample_s *sample);
+static void     stmpe811_report(FAR struct stmpe811_dev_s *priv);
 
 /* Character driver methods */
 
@@ -157,189 +154,76 @@ static const struct file_operations g_stmpe811fops =
  * Private Functions
  ****************************************************************************/
 /****************************************************************************
- * Name: stmpe811_notify
+ * Name: stmpe811_report
  *
  * Description:
- *   Notify any threads waiting on touchscreen data that data is now
- *   available for reading.
+ *   Queue a touch report for the current sample and advance the contact
+ *   state.
  *
  ****************************************************************************/
 
-static void stmpe811_notify(FAR struct stmpe811_dev_s *priv)
+static void stmpe811_report(FAR struct stmpe811_dev_s *priv)
 {
-#ifndef CONFIG_DISABLE_POLL
-  int i;
-#endif
-
-  /* If there are threads waiting for read data, then signal one of them
-   * that the read data is available.
-   */
-
-  if (priv->nwaiters > 0)
-    {
-      /* After posting this semaphore, we need to exit because the STMPE811
-       * is no longer available.
-       */
-
-      sem_post(&priv->waitsem);
-    }
-
-  /* If there are threads waiting on poll() for STMPE811 data to become available,
-   * then wake them up now.  NOTE: we wake up all waiting threads because we
-   * do not know that they are going to do.  If they all try to read the data,
-   * then some make end up blocking after all.
-   */
-
-#ifndef CONFIG_DISABLE_POLL
-  for (i = 0; i < CONFIG_STMPE811_NPOLLWAITERS; i++)
-    {
-      struct pollfd *fds = priv->fds[i];
-      if (fds)
-        {
-          fds->revents |= POLLIN;
-          iinfo("Report events: %02x\n", fds->revents);
-          sem_post(fds->sem);
-        }
-    }
-#endif
-}
+  FAR struct stmpe811_sample_s *sample = &priv->sample;
+  struct touch_sample_s report;
 
-/****************************************************************************
- * Name: stmpe811_sample
- *
- * Description:
- *   Check if touchscreen sample data is available now and, if so, return
- *   the sample data.  This is part of the stmpe811_read logic.
- *
- * Assumption:
- *   Pre-emption is disable to prevent the worker thread from running.
- *   Otherwise, sampled data may continue to change.
- *
- ****************************************************************************/
+  memset(&report, 0, sizeof(struct touch_sample_s));
+  report.npoints            = 1;
+  report.point[0].id        = sample->id;
+  report.point[0].x         = sample->x;
+  report.point[0].y         = sample->y;
+  report.point[0].pressure  = sample->z;
+  report.point[0].timestamp = input_timestamp();
 
-static int stmpe811_sample(FAR struct stmpe811_dev_s *priv,
-                           FAR struct stmpe811_sample_s *sample)
-{
-  int ret = -EAGAIN;
+  add_ui_randomness((sample->x << 16) ^ (sample->y << 8) ^ sample->z);
 
-  /* Is there new STMPE811 sample data available? */
+  /* Report the appropriate flags */
 
-  if (priv->penchange)
+  if (sample->contact == CONTACT_UP)
     {
-      /* Yes.. the state has changed in some way.  Return a copy of the
-       * sampled data.
+      /* Pen is now up.  Is the positional data valid?  This is important to
+       * know because the release will be sent to the window based on its
+       * last positional data.
        */
 
-      memcpy(sample, &priv->sample, sizeof(struct stmpe811_sample_s));
-
-      /* Now manage state transitions */
-
-      if (sample->contact == CONTACT_UP)
+      if (sample->valid)
         {
-          /* The sampling logic has detected pen-up in some condition other
-           * than CONTACT_NONE.  Set the next state to CONTACT_NONE:  Further
-           * pen-down reports will be ignored.  Increment the ID so that
-           * next contact ID will be unique
-           */
-
-          priv->sample.contact = CONTACT_NONE;
-          priv->sample.valid   = false;
-          priv->id++;
+          report.point[0].flags  = TOUCH_UP | TOUCH_ID_VALID |
+                                   TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
+        }
+      else
+        {
+          report.point[0].flags  = TOUCH_UP | TOUCH_ID_VALID;
         }
-      else if (sample->contact == CONTACT_DOWN)
-       {
-          /* The sampling logic has detected pen-up in some condition other
-           * than CONTACT_MOVE. Set the next state to CONTACT_MOVE:  Further
-           * samples collected while the pen is down will reported as movement
-           * events.
-           */
 
-         priv->sample.contact = CONTACT_MOVE;
-       }
+      /* Set the next state to CONTACT_NONE:  Further pen-down reports will
+       * be ignored.  Increment the ID so that next contact ID will be
+       * unique.
+       */
 
-      priv->penchange = false;
-      ret = OK;
+      sample->contact = CONTACT_NONE;
+      sample->valid   = false;
+      priv->id++;
     }
-
-  return ret;
-}
-
-/****************************************************************************
- * Name: stmpe811_waitsample
- *
- * Description:
- *   Wait for a sample to become available (this is really part of the
- *   stmpe811_read logic).
- *
- ****************************************************************************/
-
-static inline int stmpe811_waitsample(FAR struct stmpe811_dev_s *priv,
-                                      FAR struct stmpe811_sample_s *sample)
-{
-  int ret;
-
-  /* Disable pre-emption to prevent the worker thread from running
-   * asynchronously.
-   */
-
-  sched_lock();
-
-  /* Now release the semaphore that manages mutually exclusive access to
-   * the device structure.  This may cause other tasks to become ready to
-   * run, but they cannot run yet because pre-emption is disabled.
-   */
-
-  sem_post(&priv->exclsem);
-
-  /* Try to get the a sample... if we cannot, then wait on the semaphore
-   * that is posted when new sample data is available.
-   */
-
-  while (stmpe811_sample(priv, sample) < 0)
+  else if (sample->contact == CONTACT_DOWN)
     {
-      /* Wait for a change in the STMPE811 state */
-
-      priv->nwaiters++;
-      ret = sem_wait(&priv->waitsem);
-      priv->nwaiters--;
-
-      /* When we are re-awakened, pre-emption will again be disabled */
-
-      if (ret < 0)
-        {
-#if defined(CONFIG_DEBUG_INPUT_ERROR) || defined(CONFIG_DEBUG_ASSERTIONS)
-          /* Sample the errno (debug output could change it) */
-
-          int errval = errno;
-
-          /* If we are awakened by a signal, then we need to return
-           * the failure now.
-           */
+      /* First contact.  Further samples collected while the pen is down
+       * will be reported as movement events.
+       */
 
-          ierr("ERROR: sem_wait failed: %d\n", errval);
-          DEBUGASSERT(errval == EINTR);
-#endif
-          ret = -EINTR;
-          goto errout;
-        }
+      report.point[0].flags  = TOUCH_DOWN | TOUCH_ID_VALID |
+                               TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
+      sample->contact        = CONTACT_MOVE;
     }
+  else /* if (sample->contact == CONTACT_MOVE) */
+    {
+      /* Movement of the same contact */
 
-  /* Re-acquire the semaphore that manages mutually exclusive access to
-   * the device structure.  We may have to wait here.  But we have our sample.
-   * Interrupts and pre-emption will be re-enabled while we wait.
-   */
-
-  ret = sem_wait(&priv->exclsem);
-
-errout:
-  /* Restore pre-emption.  We might get suspended here but that is okay
-   * because we already have our sample.  Note:  this means that if there
-   * were two threads reading from the STMPE811 for some reason, the data
-   * might be read out of order.
-   */
+      report.point[0].flags  = TOUCH_MOVE | TOUCH_ID_VALID |
+                               TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
+    }
 
-  sched_unlock();
-  return ret;
+  input_queue_put(&priv->queue, &report);
 }
 
 /****************************************************************************
@@ -461,9 +345,6 @@ static ssize_t stmpe811_read(FAR struct file *filep, FAR char *buffer, size_t le
 {
   FAR struct inode          *inode;
   FAR struct stmpe811_dev_s  *priv;
-  FAR struct touch_sample_s *report;
-  struct stmpe811_sample_s   sample;
-  int                        ret;
 
   iinfo("len=%d\n", len);
   DEBUGASSERT(filep);
@@ -485,97 +366,12 @@ static ssize_t stmpe811_read(FAR struct file *filep, FAR char *buffer, size_t le
       return -ENOSYS;
     }
 
-  /* Get exclusive access to the driver data structure */
-
-  ret = sem_wait(&priv->exclsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was canceled by an signal */
-
-      DEBUGASSERT(errno == EINTR);
-      return -EINTR;
-    }
-
-  /* Try to read sample data. */
-
-  ret = stmpe811_sample(priv, &sample);
-  if (ret < 0)
-    {
-      /* Sample data is not available now.  We would ave to wait to get
-       * receive sample data.  If the user has specified the O_NONBLOCK
-       * option, then just return an error.
-       */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          ret = -EAGAIN;
-          goto errout;
-       }
-
-      /* Wait for sample data */
-
-      ret = stmpe811_waitsample(priv, &sample);
-      if (ret < 0)
-        {
-          /* We might have been awakened by a signal */
-
-          goto errout;
-        }
-    }
-
-  /* In any event, we now have sampled STMPE811 data that we can report
-   * to the caller.
+  /* Return as many of the buffered touch samples as fit in the user buffer,
+   * waiting for a sample unless the O_NONBLOCK option was specified.
    */
 
-  report = (FAR struct touch_sample_s *)buffer;
-  memset(report, 0, SIZEOF_TOUCH_SAMPLE_S(1));
-  report->npoints            = 1;
-  report->point[0].id        = sample.id;
-  report->point[0].x         = sample.x;
-  report->point[0].y         = sample.y;
-  report->point[0].pressure  = sample.z;
-
-  add_ui_randomness((sample.x << 16) ^ (sample.y << 8) ^ sample.z);
-
-  /* Report the appropriate flags */
-
-  if (sample.contact == CONTACT_UP)
-    {
-      /* Pen is now up.  Is the positional data valid?  This is important to
-       * know because the release will be sent to the window based on its
-       * last positional data.
-       */
-
-      if (sample.valid)
-        {
-          report->point[0].flags  = TOUCH_UP | TOUCH_ID_VALID |
-                                    TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
-        }
-      else
-        {
-          report->point[0].flags  = TOUCH_UP | TOUCH_ID_VALID;
-        }
-    }
-  else if (sample.contact == CONTACT_DOWN)
-    {
-      /* First contact */
-
-      report->point[0].flags  = TOUCH_DOWN | TOUCH_ID_VALID |
-                                TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
-    }
-  else /* if (sample->contact == CONTACT_MOVE) */
-    {
-      /* Movement of the same contact */
-
-      report->point[0].flags  = TOUCH_MOVE | TOUCH_ID_VALID |
-                                TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
-    }
-
-  ret = SIZEOF_TOUCH_SAMPLE_S(1);
-
-errout:
-  sem_post(&priv->exclsem);
-  return ret;
+  return input_queue_read(&priv->queue, buffer, len,
+                          (filep->f_oflags & O_NONBLOCK) != 0);
 }
 
 /****************************************************************************
@@ -653,8 +449,6 @@ static int stmpe811_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct inode          *inode;
   FAR struct stmpe811_dev_s *priv;
-  int                        ret;
-  int                        i;
 
   iinfo("setup: %d\n", (int)setup);
   DEBUGASSERT(filep && fds);
@@ -663,77 +457,7 @@ static int stmpe811_poll(FAR struct file *filep, FAR struct pollfd *fds,
   DEBUGASSERT(inode && inode->i_private);
   priv  = (FAR struct stmpe811_dev_s *)inode->i_private;
 
-  /* Are we setting up the poll?  Or tearing it down? */
-
-  ret = sem_wait(&priv->exclsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was canceled by an signal */
-
-      DEBUGASSERT(errno == EINTR);
-      return -EINTR;
-    }
-
-  if (setup)
-    {
-      /* Ignore waits that do not include POLLIN */
-
-      if ((fds->events & POLLIN) == 0)
-        {
-          ierr("ERROR: Missing POLLIN: revents: %08x\n", fds->revents);
-          ret = -EDEADLK;
-          goto errout;
-        }
-
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
-
-      for (i = 0; i < CONFIG_STMPE811_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!priv->fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              priv->fds[i] = fds;
-              fds->priv    = &priv->fds[i];
-              break;
-            }
-        }
-
-      if (i >= CONFIG_STMPE811_NPOLLWAITERS)
-        {
-          ierr("ERROR: No available slot found: %d\n", i);
-          fds->priv    = NULL;
-          ret          = -EBUSY;
-          goto errout;
-        }
-
-      /* Should we immediately notify on any of the requested events? */
-
-      if (priv->penchange)
-        {
-          stmpe811_notify(priv);
-        }
-    }
-  else if (fds->priv)
-    {
-      /* This is a request to tear down the poll. */
-
-      struct pollfd **slot = (struct pollfd **)fds->priv;
-      DEBUGASSERT(slot != NULL);
-
-      /* Remove all memory of the poll setup */
-
-      *slot                = NULL;
-      fds->priv            = NULL;
-    }
-
-errout:
-  sem_post(&priv->exclsem);
-  return ret;
+  return input_queue_poll(&priv->queue, fds, setup);
 }
 #endif
 
@@ -926,16 +650,28 @@ int stmpe811_register(STMPE811_HANDLE handle, int minor)
   /* Initialize the TS structure fields to their default values */
 
   priv->minor     = minor;
-  priv->penchange = false;
   priv->threshx   = 0;
   priv->threshy   = 0;
 
+  /* Allocate the buffer of touch samples */
+
+  ret = input_queue_initialize(&priv->queue, SIZEOF_TOUCH_SAMPLE_S(1),
+                               CONFIG_STMPE811_NEVENTS,
+                               CONFIG_STMPE811_NPOLLWAITERS);
+  if (ret < 0)
+    {
+      ierr("ERROR: Failed to allocate the sample buffer\n");
+      sem_post(&priv->exclsem);
+      return ret;
+    }
+
   /* Create a timer for catching missed pen up conditions */
 
   priv->wdog      = wd_create();
   if (!priv->wdog)
     {
       ierr("ERROR: Failed to create a watchdog\n", errno);
+      input_queue_uninitialize(&priv->queue);
       sem_post(&priv->exclsem);
       return -ENOSPC;
     }
@@ -947,6 +683,7 @@ int stmpe811_register(STMPE811_HANDLE handle, int minor)
   if (ret < 0)
     {
       ierr("ERROR: Failed to register driver %s: %d\n", devname, ret);
+      input_queue_uninitialize(&priv->queue);
       sem_post(&priv->exclsem);
       return ret;
     }
@@ -1003,18 +740,17 @@ void stmpe811_tscworker(FAR struct stmpe811_dev_s *priv, uint8_t intsta)
       priv->threshy = 0;
 
       /* Ignore the interrupt if the pen was already up (CONTACT_NONE == pen up and
-       * already reported; CONTACT_UP == pen up, but not reported)
+       * already reported)
        */
 
-      if (priv->sample.contact == CONTACT_NONE ||
-          priv->sample.contact == CONTACT_UP)
+      if (priv->sample.contact == CONTACT_NONE)
         {
           goto ignored;
         }
 
       /* A pen-down to up transition has been detected.  CONTACT_UP indicates the
        * initial loss of contact.  The state will be changed to CONTACT_NONE
-       * after the loss of contact is sampled.
+       * when the loss of contact is reported.
        */
 
        priv->sample.contact = CONTACT_UP;
@@ -1034,25 +770,6 @@ void stmpe811_tscworker(FAR struct stmpe811_dev_s *priv, uint8_t intsta)
       y = stmpe811_getreg16(priv, STMPE811_TSC_DATAX);
 #endif
 
-      /* If we have not yet processed the last pen up event, then we
-       * cannot handle this pen down event. We will have to discard it.  That
-       * should be okay because there will be another FIFO event right behind
-       * this one.  Other kinds of data overruns are not harmful.
-       *
-       * Hmm.. a better design might be to disable FIFO interrupts when we
-       * detect pen up.  Then re-enable them when CONTACT_UP is reported.
-       * That would save processing interrupts just to discard the data.
-       */
-
-      if (priv->sample.contact == CONTACT_UP)
-        {
-          /* We have not closed the loop on the last touch ... don't report
-           * anything.
-           */
-
-          goto ignored;
-        }
-
       /* Perform a thresholding operation so that the results will be more stable.
        * If the difference from the last sample is small, then ignore the event.
        * REVISIT:  Should a large change in pressure also generate a event?
@@ -1106,16 +823,12 @@ void stmpe811_tscworker(FAR struct stmpe811_dev_s *priv, uint8_t intsta)
     }
 
   /* We get here if (1) we just went from a pen down to a pen up state OR (2)
-   * We just get a measurement from the FIFO in a pen down state.  Indicate
-   * the availability of new sample data for this ID.
+   * We just get a measurement from the FIFO in a pen down state.  Queue the
+   * new sample data for this ID and wake up any readers.
    */
 
   priv->sample.id = priv->id;
-  priv->penchange = true;
-
-  /* Notify any waiters that new STMPE811 data is available */
-
-  stmpe811_notify(priv);
+  stmpe811_report(priv);
 
   /* If we think that the pen is still down, the start/re-start the pen up
    * timer.
@@ -71,6 +71,7 @@
 #include <nuttx/random.h>
 
 #include <nuttx/input/touchscreen.h>
+#include <nuttx/input/input_queue.h>
 #include <nuttx/input/tsc2007.h>
 
 #include "tsc2007.h"
@@ -160,36 +161,21 @@ struct tsc2007_dev_s
 #ifdef CONFIG_TSC2007_REFCNT
   uint8_t crefs;                       /* Number of times the device has been opened */
 #endif
-  uint8_t nwaiters;                    /* Number of threads waiting for TSC2007 data */
   uint8_t id;                          /* Current touch point ID */
-  volatile bool penchange;             /* An unreported event is buffered */
   sem_t devsem;                        /* Manages exclusive access to this structure */
-  sem_t waitsem;                       /* Used to wait for the availability of data */
 
   FAR struct tsc2007_config_s *config; /* Board configuration data */
   FAR struct i2c_master_s *i2c;        /* Saved I2C driver instance */
   struct work_s work;                  /* Supports the interrupt handling "bottom half" */
   struct tsc2007_sample_s sample;      /* Last sampled touch point data */
-
-  /* The following is a list if poll structures of threads waiting for
-   * driver events. The 'struct pollfd' reference for each open is also
-   * retained in the f_priv field of the 'struct file'.
-   */
-
-#ifndef CONFIG_DISABLE_POLL
-  struct pollfd *fds[CONFIG_TSC2007_NPOLLWAITERS];
-#endif
+  struct input_queue_s queue;          /* Touch samples waiting to be read */
 };
 
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static void tsc2007_notify(FAR struct tsc2007_dev_s *priv);
-static int tsc2007_sample(FAR struct tsc2007_dev_s *priv,
-                          FAR struct tsc2007_sample_s *sample);
-static int tsc2007_waitsample(FAR struct tsc2007_dev_s *priv,
-                              FAR struct tsc2007_sample_s *sample);
+static void tsc2007_report(FAR struct tsc2007_dev_s *priv);
 #ifdef CONFIG_TSC2007_ACTIVATE
 static int tsc2007_activate(FAR struct tsc2007_dev_s *priv, uint8_t cmd);
 #endif
@@ -244,177 +230,79 @@ static struct tsc2007_dev_s *g_tsc2007list;
  ****************************************************************************/
 
 /****************************************************************************
- * Name: tsc2007_notify
+ * Name: tsc2007_report
+ *
+ * Description:
+ *   Queue a touch report for the current sample and advance the contact
+ *   state.
+ *
  ****************************************************************************/
 
-static void tsc2007_notify(FAR struct tsc2007_dev_s *priv)
+static void tsc2007_report(FAR struct tsc2007_dev_s *priv)
 {
-#ifndef CONFIG_DISABLE_POLL
-  int i;
-#endif
+  FAR struct tsc2007_sample_s *sample = &priv->sample;
+  struct touch_sample_s report;
 
-  /* If there are threads waiting for read data, then signal one of them
-   * that the read data is available.
-   */
+  memset(&report, 0, sizeof(struct touch_sample_s));
+  report.npoints            = 1;
+  report.point[0].id        = sample->id;
+  report.point[0].x         = sample->x;
+  report.point[0].y         = sample->y;
+  report.point[0].pressure  = sample->pressure;
+  report.point[0].timestamp = input_timestamp();
+
+  /* Report the appropriate flags */
 
-  if (priv->nwaiters > 0)
+  if (sample->contact == CONTACT_UP)
     {
-      /* After posting this semaphore, we need to exit because the TSC2007
-       * is no longer available.
+      /* Pen is now up.  Is the positional data valid?  This is important to
+       * know because the release will be sent to the window based on its
+       * last positional data.
        */
 
-      sem_post(&priv->waitsem);
-    }
-
-  /* If there are threads waiting on poll() for TSC2007 data to become available,
-   * then wake them up now.  NOTE: we wake up all waiting threads because we
-   * do not know that they are going to do.  If they all try to read the data,
-   * then some make end up blocking after all.
-   */
-
-#ifndef CONFIG_DISABLE_POLL
-  for (i = 0; i < CONFIG_TSC2007_NPOLLWAITERS; i++)
-    {
-      struct pollfd *fds = priv->fds[i];
-      if (fds)
+      if (sample->valid)
         {
-          fds->revents |= POLLIN;
-          iinfo("Report events: %02x\n", fds->revents);
-          sem_post(fds->sem);
+          report.point[0].flags  = TOUCH_UP | TOUCH_ID_VALID |
+                                   TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
         }
-    }
-#endif
-}
-
-/****************************************************************************
- * Name: tsc2007_sample
- ****************************************************************************/
-
-static int tsc2007_sample(FAR struct tsc2007_dev_s *priv,
-                          FAR struct tsc2007_sample_s *sample)
-{
-  irqstate_t flags;
-  int ret = -EAGAIN;
-
-  /* Interrupts me be disabled when this is called to (1) prevent posting
-   * of semaphores from interrupt handlers, and (2) to prevent sampled data
-   * from changing until it has been reported.
-   */
-
-  flags = enter_critical_section();
-
-  /* Is there new TSC2007 sample data available? */
-
-  if (priv->penchange)
-    {
-      /* Yes.. the state has changed in some way.  Return a copy of the
-       * sampled data.
-       */
-
-      memcpy(sample, &priv->sample, sizeof(struct tsc2007_sample_s));
-
-      /* Now manage state transitions */
-
-      if (sample->contact == CONTACT_UP)
+      else
         {
-          /* Next.. no contact.  Increment the ID so that next contact ID
-           * will be unique.  X/Y positions are no longer valid.
-           */
-
-          priv->sample.contact = CONTACT_NONE;
-          priv->sample.valid   = false;
-          priv->id++;
+          report.point[0].flags  = TOUCH_UP | TOUCH_ID_VALID;
         }
-      else if (sample->contact == CONTACT_DOWN)
-       {
-          /* First report -- next report will be a movement */
 
-         priv->sample.contact = CONTACT_MOVE;
-       }
+      /* Next.. no contact.  Increment the ID so that next contact ID will be
+       * unique.  X/Y positions are no longer valid.
+       */
 
-      priv->penchange = false;
-      ret = OK;
+      sample->contact = CONTACT_NONE;
+      sample->valid   = false;
+      priv->id++;
     }
-
-  leave_critical_section(flags);
-  return ret;
-}
-
-/****************************************************************************
- * Name: tsc2007_waitsample
- ****************************************************************************/
-
-static int tsc2007_waitsample(FAR struct tsc2007_dev_s *priv,
-                              FAR struct tsc2007_sample_s *sample)
-{
-  irqstate_t flags;
-  int ret;
-
-  /* Interrupts me be disabled when this is called to (1) prevent posting
-   * of semaphores from interrupt handlers, and (2) to prevent sampled data
-   * from changing until it has been reported.
-   *
-   * In addition, we will also disable pre-emption to prevent other threads
-   * from getting control while we muck with the semaphores.
-   */
-
-  sched_lock();
-  flags = enter_critical_section();
-
-  /* Now release the semaphore that manages mutually exclusive access to
-   * the device structure.  This may cause other tasks to become ready to
-   * run, but they cannot run yet because pre-emption is disabled.
-   */
-
-  sem_post(&priv->devsem);
-
-  /* Try to get the a sample... if we cannot, then wait on the semaphore
-   * that is posted when new sample data is available.
-   */
-
-  while (tsc2007_sample(priv, sample) < 0)
+  else
     {
-      /* Wait for a change in the TSC2007 state */
-
-      priv->nwaiters++;
-      ret = sem_wait(&priv->waitsem);
-      priv->nwaiters--;
-
-      if (ret < 0)
+      if (sample->contact == CONTACT_DOWN)
         {
-          /* If we are awakened by a signal, then we need to return
-           * the failure now.
-           */
+          /* First contact.  The next report will be a movement */
 
-          DEBUGASSERT(errno == EINTR);
-          ret = -EINTR;
-          goto errout;
+          report.point[0].flags  = TOUCH_DOWN | TOUCH_ID_VALID | TOUCH_POS_VALID;
+          sample->contact        = CONTACT_MOVE;
         }
-    }
-
-  /* Re-acquire the semaphore that manages mutually exclusive access to
-   * the device structure.  We may have to wait here.  But we have our sample.
-   * Interrupts and pre-emption will be re-enabled while we wait.
-   */
-
-  ret = sem_wait(&priv->devsem);
+      else /* if (sample->contact == CONTACT_MOVE) */
+        {
+          /* Movement of the same contact */
 
-errout:
-  /* Then re-enable interrupts.  We might get interrupt here and there
-   * could be a new sample.  But no new threads will run because we still
-   * have pre-emption disabled.
-   */
+          report.point[0].flags  = TOUCH_MOVE | TOUCH_ID_VALID | TOUCH_POS_VALID;
+        }
 
-  leave_critical_section(flags);
+      /* A pressure measurement of zero means that pressure is not available */
 
-  /* Restore pre-emption.  We might get suspended here but that is okay
-   * because we already have our sample.  Note:  this means that if there
-   * were two threads reading from the TSC2007 for some reason, the data
-   * might be read out of order.
-   */
+      if (report.point[0].pressure != 0)
+        {
+          report.point[0].flags |= TOUCH_PRESSURE_VALID;
+        }
+    }
 
-  sched_unlock();
-  return ret;
+  input_queue_put(&priv->queue, &report);
 }
 
 /****************************************************************************
@@ -587,8 +475,8 @@ static void tsc2007_worker(FAR void *arg)
 
   if (!pendown)
     {
-      /* Ignore the interrupt if the pen was already down (CONTACT_NONE == pen up and
-       * already reported.  CONTACT_UP == pen up, but not reported)
+      /* Ignore the interrupt if the pen was already up (CONTACT_NONE == pen
+       * up and already reported).
        */
 
       if (priv->sample.contact == CONTACT_NONE)
@@ -596,16 +484,6 @@ static void tsc2007_worker(FAR void *arg)
           goto errout;
         }
     }
-
-  /* It is a pen down event.  If the last loss-of-contact event has not been
-   * processed yet, then we have to ignore the pen down event (or else it will
-   * look like a drag event)
-   */
-
-  else if (priv->sample.contact == CONTACT_UP)
-    {
-       goto errout;
-    }
   else
     {
       /* Handle all pen down events.  First, sample X, Y, Z1, and Z2 values.
@@ -723,20 +601,16 @@ static void tsc2007_worker(FAR void *arg)
     {
       /* The pen is up.  NOTE: We know from a previous test, that this is a
        * loss of contact condition.  This will be changed to CONTACT_NONE
-       * after the loss of contact is sampled.
+       * when the loss of contact is reported.
        */
 
        priv->sample.contact = CONTACT_UP;
     }
 
-  /* Indicate the availability of new sample data for this ID */
+  /* Queue the new sample data for this ID and wake up any readers */
 
   priv->sample.id = priv->id;
-  priv->penchange = true;
-
-  /* Notify any waiters that new TSC2007 data is available */
-
-  tsc2007_notify(priv);
+  tsc2007_report(priv);
 
   /* Exit, re-enabling TSC2007 interrupts */
 
@@ -902,9 +776,6 @@ static ssize_t tsc2007_read(FAR struct file *filep, FAR char *buffer, size_t len
 {
   FAR struct inode          *inode;
   FAR struct tsc2007_dev_s  *priv;
-  FAR struct touch_sample_s *report;
-  struct tsc2007_sample_s    sample;
-  int                        ret;
 
   DEBUGASSERT(filep);
   inode = filep->f_inode;
@@ -925,103 +796,12 @@ static ssize_t tsc2007_read(FAR struct file *filep, FAR char *buffer, size_t len
       return -ENOSYS;
     }
 
-  /* Get exclusive access to the driver data structure */
-
-  ret = sem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      DEBUGASSERT(errno == EINTR);
-      return -EINTR;
-    }
-
-  /* Try to read sample data. */
-
-  ret = tsc2007_sample(priv, &sample);
-  if (ret < 0)
-    {
-      /* Sample data is not available now.  We would ave to wait to get
-       * receive sample data.  If the user has specified the O_NONBLOCK
-       * option, then just return an error.
-       */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          ret = -EAGAIN;
-          goto errout;
-       }
-
-      /* Wait for sample data */
-
-      ret = tsc2007_waitsample(priv, &sample);
-      if (ret < 0)
-        {
-          /* We might have been awakened by a signal */
-
-          goto errout;
-        }
-    }
-
-  /* In any event, we now have sampled TSC2007 data that we can report
-   * to the caller.
+  /* Return as many of the buffered touch samples as fit in the user buffer,
+   * waiting for a sample unless the O_NONBLOCK option was specified.
    */
 
-  report = (FAR struct touch_sample_s *)buffer;
-  memset(report, 0, SIZEOF_TOUCH_SAMPLE_S(1));
-  report->npoints            = 1;
-  report->point[0].id        = priv->id;
-  report->point[0].x         = sample.x;
-  report->point[0].y         = sample.y;
-  report->point[0].pressure  = sample.pressure;
-
-  /* Report the appropriate flags */
-
-  if (sample.contact == CONTACT_UP)
-    {
-      /* Pen is now up.  Is the positional data valid?  This is important to
-       * know because the release will be sent to the window based on its
-       * last positional data.
-       */
-
-      if (sample.valid)
-        {
-          report->point[0].flags  = TOUCH_UP | TOUCH_ID_VALID |
-                                    TOUCH_POS_VALID | TOUCH_PRESSURE_VALID;
-        }
-      else
-        {
-          report->point[0].flags  = TOUCH_UP | TOUCH_ID_VALID;
-        }
-    }
-  else
-    {
-      if (sample.contact == CONTACT_DOWN)
-        {
-          /* Loss of contact */
-
-          report->point[0].flags  = TOUCH_DOWN | TOUCH_ID_VALID | TOUCH_POS_VALID;
-        }
-      else /* if (sample->contact == CONTACT_MOVE) */
-        {
-          /* Movement of the same contact */
-
-          report->point[0].flags  = TOUCH_MOVE | TOUCH_ID_VALID | TOUCH_POS_VALID;
-        }
-
-      /* A pressure measurement of zero means that pressure is not available */
-
-      if (report->point[0].pressure != 0)
-        {
-          report->point[0].flags  |= TOUCH_PRESSURE_VALID;
-        }
-    }
-
-  ret = SIZEOF_TOUCH_SAMPLE_S(1);
-
-errout:
-  sem_post(&priv->devsem);
-  return ret;
+  return input_queue_read(&priv->queue, buffer, len,
+                          (filep->f_oflags & O_NONBLOCK) != 0);
 }
 
 /****************************************************************************
@@ -1107,8 +887,6 @@ static int tsc2007_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct inode         *inode;
   FAR struct tsc2007_dev_s *priv;
-  int                       ret;
-  int                       i;
 
   iinfo("setup: %d\n", (int)setup);
   DEBUGASSERT(filep && fds);
@@ -1117,77 +895,7 @@ static int tsc2007_poll(FAR struct file *filep, FAR struct pollfd *fds,
   DEBUGASSERT(inode && inode->i_private);
   priv  = (FAR struct tsc2007_dev_s *)inode->i_private;
 
-  /* Are we setting up the poll?  Or tearing it down? */
-
-  ret = sem_wait(&priv->devsem);
-  if (ret < 0)
-    {
-      /* This should only happen if the wait was cancelled by an signal */
-
-      DEBUGASSERT(errno == EINTR);
-      return -EINTR;
-    }
-
-  if (setup)
-    {
-      /* Ignore waits that do not include POLLIN */
-
-      if ((fds->events & POLLIN) == 0)
-        {
-          ierr("ERROR: Missing POLLIN: revents: %08x\n", fds->revents);
-          ret = -EDEADLK;
-          goto errout;
-        }
-
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
-
-      for (i = 0; i < CONFIG_TSC2007_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!priv->fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              priv->fds[i] = fds;
-              fds->priv    = &priv->fds[i];
-              break;
-            }
-        }
-
-      if (i >= CONFIG_TSC2007_NPOLLWAITERS)
-        {
-          ierr("ERROR: No available slot found: %d\n", i);
-          fds->priv    = NULL;
-          ret          = -EBUSY;
-          goto errout;
-        }
-
-      /* Should we immediately notify on any of the requested events? */
-
-      if (priv->penchange)
-        {
-          tsc2007_notify(priv);
-        }
-    }
-  else if (fds->priv)
-    {
-      /* This is a request to tear down the poll. */
-
-      struct pollfd **slot = (struct pollfd **)fds->priv;
-      DEBUGASSERT(slot != NULL);
-
-      /* Remove all memory of the poll setup */
-
-      *slot                = NULL;
-      fds->priv            = NULL;
-    }
-
-errout:
-  sem_post(&priv->devsem);
-  return ret;
+  return input_queue_poll(&priv->queue, fds, setup);
 }
 #endif
 
@@ -1256,7 +964,17 @@ int tsc2007_register(FAR struct i2c_master_s *dev,
   priv->i2c    = dev;             /* Save the I2C device handle */
   priv->config = config;          /* Save the board configuration */
   sem_init(&priv->devsem,  0, 1); /* Initialize device structure semaphore */
-  sem_init(&priv->waitsem, 0, 0); /* Initialize pen event wait semaphore */
+
+  /* Allocate the buffer of touch samples */
+
+  ret = input_queue_initialize(&priv->queue, SIZEOF_TOUCH_SAMPLE_S(1),
+                               CONFIG_TSC2007_NEVENTS,
+                               CONFIG_TSC2007_NPOLLWAITERS);
+  if (ret < 0)
+    {
+      ierr("ERROR: Failed to allocate the sample buffer\n");
+      goto errout_with_sem;
+    }
 
   /* Make sure that interrupts are disabled */
 
@@ -1323,6 +1041,9 @@ int tsc2007_register(FAR struct i2c_master_s *dev,
   return OK;
 
 errout_with_priv:
+  input_queue_uninitialize(&priv->queue);
+
+errout_with_sem:
   sem_destroy(&priv->devsem);
 #ifdef CONFIG_TSC2007_MULTIPLE
   kmm_free(priv);
@@ -389,6 +389,12 @@ struct ili9341_dev_s
 
   int (*putrun)(fb_coord_t row, fb_coord_t col,
                 FAR const uint8_t * buffer, size_t npixels);
+
+  /* Driver specific putarea function */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
   /* Driver specific getrun function */
 
@@ -430,6 +436,10 @@ static inline uint16_t ili9341_getyres(FAR struct ili9341_dev_s *dev);
 
 static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col,
                          FAR const uint8_t * buffer, size_t npixels);
+static int ili9341_putarea(int devno, fb_coord_t row_start,
+                           fb_coord_t row_end, fb_coord_t col_start,
+                           fb_coord_t col_end, FAR const uint8_t *buffer,
+                           size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
 static int ili9341_getrun(int devno, fb_coord_t row, fb_coord_t col,
                          FAR uint8_t * buffer, size_t npixels);
@@ -448,6 +458,17 @@ static int ili9341_putrun1(fb_coord_t row, fb_coord_t col,
                             FAR const uint8_t * buffer, size_t npixsels);
 #endif
 
+#ifdef CONFIG_LCD_ILI9341_IFACE0
+static int ili9341_putarea0(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride);
+#endif
+#ifdef CONFIG_LCD_ILI9341_IFACE1
+static int ili9341_putarea1(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride);
+#endif
+
 #ifndef CONFIG_LCD_NOGETRUN
 # ifdef CONFIG_LCD_ILI9341_IFACE0
 static int ili9341_getrun0(fb_coord_t row, fb_coord_t col,
@@ -492,6 +513,7 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] =
   {
     .lcd              = 0,
     .putrun           = ili9341_putrun0,
+    .putarea          = ili9341_putarea0,
 # ifndef CONFIG_LCD_NOGETRUN
     .getrun           = ili9341_getrun0,
 # endif
@@ -506,6 +528,7 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] =
   {
     .lcd              = 0,
     .putrun           = ili9341_putrun1,
+    .putarea          = ili9341_putarea1,
 # ifndef CONFIG_LCD_NOGETRUN
     .getrun           = ili9341_getrun1,
 # endif
@@ -674,6 +697,86 @@ static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col,
 }
 
 
+/****************************************************************************
+ * Name:  ili9341_putarea
+ *
+ * Description:
+ *   Write a rectangular area to the LCD.  The area is selected once and all
+ *   pixels are streamed with a single memory write command, so a contiguous
+ *   buffer goes out as one sendgram() (and one DMA transfer if the lower
+ *   half supports it) instead of one transfer per row.
+ *
+ * Parameters:
+ *   devno     - Number of lcd device
+ *   row_start - Starting row to write to (range: 0 <= row < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row < yres)
+ *   col_start - Starting column to write to (range: 0 <= col < xres)
+ *   col_end   - Ending column to write to (range: col_start <= col < xres)
+ *   buffer    - The buffer containing the area to be written to the LCD
+ *   stride    - Number of bytes between the first pixels of two rows or
+ *               zero to repeat the first row
+ *
+ * Returned Value:
+ *
+ *   On success - OK
+ *   On error   - -EINVAL
+ *
+ ****************************************************************************/
+
+static int ili9341_putarea(int devno, fb_coord_t row_start,
+                           fb_coord_t row_end, fb_coord_t col_start,
+                           fb_coord_t col_end, FAR const uint8_t *buffer,
+                           size_t stride)
+{
+  FAR struct ili9341_dev_s *dev = &g_lcddev[devno];
+  FAR struct ili9341_lcd_s *lcd = dev->lcd;
+  size_t ncols = col_end - col_start + 1;
+  size_t nrows = row_end - row_start + 1;
+
+  DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0 && (stride & 1) == 0);
+
+  /* Check if area outside of the display */
+
+  if (row_end < row_start || col_end < col_start ||
+      col_end >= ili9341_getxres(dev) || row_end >= ili9341_getyres(dev))
+    {
+      return -EINVAL;
+    }
+
+  /* Select lcd driver */
+
+  lcd->select(lcd);
+
+  /* Select the whole area; the controller wraps to the next row itself */
+
+  ili9341_selectarea(lcd, col_start, row_start, col_end, row_end);
+
+  /* Send memory write cmd */
+
+  lcd->sendcmd(lcd, ILI9341_MEMORY_WRITE);
+
+  /* Send pixel to gram */
+
+  if (stride == ncols * sizeof(uint16_t))
+    {
+      lcd->sendgram(lcd, (FAR const uint16_t *)buffer, ncols * nrows);
+    }
+  else
+    {
+      for (; nrows > 0; nrows--, buffer += stride)
+        {
+          lcd->sendgram(lcd, (FAR const uint16_t *)buffer, ncols);
+        }
+    }
+
+  /* Deselect the lcd driver */
+
+  lcd->deselect(lcd);
+
+  return OK;
+}
+
+
 /****************************************************************************
  * Name:  ili9341_getrun
  *
@@ -870,6 +973,48 @@ static int ili9341_putrun1(fb_coord_t row, fb_coord_t col,
 #endif
 
 
+/****************************************************************************
+ * Name:  ili9341_putareax
+ *
+ * Description:
+ *   Write a rectangular area to the LCD.
+ *
+ * Parameters:
+ *   row_start - Starting row to write to (range: 0 <= row < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row < yres)
+ *   col_start - Starting column to write to (range: 0 <= col < xres)
+ *   col_end   - Ending column to write to (range: col_start <= col < xres)
+ *   buffer    - The buffer containing the area to be written to the LCD
+ *   stride    - Number of bytes between two rows or zero to repeat a row
+ *
+ * Returned Value:
+ *
+ *   On success - OK
+ *   On error   - -EINVAL
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_ILI9341_IFACE0
+static int ili9341_putarea0(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride)
+{
+  return ili9341_putarea(0, row_start, row_end, col_start, col_end,
+                         buffer, stride);
+}
+#endif
+
+#ifdef CONFIG_LCD_ILI9341_IFACE1
+static int ili9341_putarea1(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride)
+{
+  return ili9341_putarea(1, row_start, row_end, col_start, col_end,
+                         buffer, stride);
+}
+#endif
+
+
 /****************************************************************************
  * Name:  ili9341_getrunx
  *
@@ -972,12 +1117,13 @@ static int ili9341_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int planeno,
     {
       FAR struct ili9341_dev_s *priv = (FAR struct ili9341_dev_s *)dev;
 
-      pinfo->putrun = priv->putrun;
+      pinfo->putrun  = priv->putrun;
+      pinfo->putarea = priv->putarea;
 #ifndef CONFIG_LCD_NOGETRUN
-      pinfo->getrun = priv->getrun;
+      pinfo->getrun  = priv->getrun;
 #endif
-      pinfo->bpp    = priv->bpp;
-      pinfo->buffer = (FAR uint8_t *)priv->runbuffer;  /* Run scratch buffer */
+      pinfo->bpp     = priv->bpp;
+      pinfo->buffer  = (FAR uint8_t *)priv->runbuffer;  /* Run scratch buffer */
 
       lcdinfo("planeno: %d bpp: %d\n", planeno, pinfo->bpp);
 
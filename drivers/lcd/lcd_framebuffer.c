@@ -63,6 +63,17 @@
 
 #define VIDEO_PLANE 0
 
+/* Number of screen buffers in the framebuffer memory */
+
+#ifdef CONFIG_FB_PANDISPLAY
+#  ifndef CONFIG_FB_NBUFFERS
+#    define CONFIG_FB_NBUFFERS 2
+#  endif
+#  define LCDFB_NBUFFERS CONFIG_FB_NBUFFERS
+#else
+#  define LCDFB_NBUFFERS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -80,6 +91,9 @@ struct lcdfb_dev_s
   fb_coord_t xres;                  /* Horizontal resolution in pixel columns */
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
+#ifdef CONFIG_FB_PANDISPLAY
+  fb_coord_t yoffset;               /* First row that is displayed */
+#endif
   uint8_t display;                  /* Display number */
 };
 
@@ -123,6 +137,13 @@ static int lcdfb_setcursor(FAR struct fb_vtable_s *vtable,
              FAR struct fb_setcursor_s *settings);
 #endif
 
+/* The following is provided only if page flipping is supported */
+
+#ifdef CONFIG_FB_PANDISPLAY
+static int lcdfb_pandisplay(FAR struct fb_vtable_s *vtable, int planeno,
+             FAR const struct fb_planeinfo_s *pinfo);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -217,9 +238,21 @@ static void lcdfb_update(FAR struct lcdfb_dev_s *priv,
 
   /* Get the starting position in the framebuffer */
 
+#ifdef CONFIG_FB_PANDISPLAY
+  run  = priv->fbmem + (starty + priv->yoffset) * priv->stride;
+#else
   run  = priv->fbmem + starty * priv->stride;
+#endif
   run += (startx * pinfo->bpp + 7) >> 3;
 
+  /* Write the whole area in one operation if the LCD supports it */
+
+  if (pinfo->putarea != NULL)
+    {
+      pinfo->putarea(starty, endy, startx, endx, run, priv->stride);
+      return;
+    }
+
   for (row = starty; row <= endy; row++)
     {
       /* REVISIT: Some LCD hardware certain aligment requirements on DMA
@@ -287,6 +320,10 @@ static int lcdfb_getplaneinfo(FAR struct fb_vtable_s *vtable, int planeno,
       pinfo->stride  = priv->stride;
       pinfo->display = priv->display;
       pinfo->bpp     = priv->pinfo.bpp;
+#ifdef CONFIG_FB_PANDISPLAY
+      pinfo->yres_virtual = priv->yres * LCDFB_NBUFFERS;
+      pinfo->yoffset = priv->yoffset;
+#endif
 
       ret = OK;
     }
@@ -431,6 +468,46 @@ static int lcdfb_setcursor(FAR struct fb_vtable_s *vtable,
 }
 #endif
 
+/****************************************************************************
+ * Name: lcdfb_pandisplay
+ *
+ * Description:
+ *   Select the buffer to be displayed.  The LCD has no scan out of its
+ *   own so the whole selected buffer is written to the LCD and the pan is
+ *   complete on return.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PANDISPLAY
+static int lcdfb_pandisplay(FAR struct fb_vtable_s *vtable, int planeno,
+                            FAR const struct fb_planeinfo_s *pinfo)
+{
+  FAR struct lcdfb_dev_s *priv;
+  struct nxgl_rect_s rect;
+
+  lcdinfo("vtable=%p planeno=%d pinfo=%p\n", vtable, planeno, pinfo);
+
+  DEBUGASSERT(vtable != NULL && planeno == VIDEO_PLANE && pinfo != NULL);
+  priv = (FAR struct lcdfb_dev_s *)vtable;
+
+  if (pinfo->yoffset > priv->yres * (LCDFB_NBUFFERS - 1))
+    {
+      return -EINVAL;
+    }
+
+  priv->yoffset = pinfo->yoffset;
+
+  rect.pt1.x = 0;
+  rect.pt1.y = 0;
+  rect.pt2.x = priv->xres - 1;
+  rect.pt2.y = priv->yres - 1;
+
+  lcdfb_update(priv, &rect);
+  fb_notify_vsync(vtable);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -485,6 +562,9 @@ int up_fbinitialize(int display)
   priv->vtable.getcursor    = lcdfb_getcursor,
   priv->vtable.setcursor    = lcdfb_setcursor,
 #endif
+#ifdef CONFIG_FB_PANDISPLAY
+  priv->vtable.pandisplay   = lcdfb_pandisplay,
+#endif
 
   /* Initialize the LCD device */
 
@@ -531,7 +611,7 @@ int up_fbinitialize(int display)
   /* Allocate (and clear) the framebuffer */
 
   priv->stride = ((size_t)priv->xres * priv->pinfo.bpp + 7) >> 3;
-  priv->fblen  = priv->stride * priv->yres;
+  priv->fblen  = priv->stride * priv->yres * LCDFB_NBUFFERS;
 
   priv->fbmem  = (FAR uint8_t *)kmm_zalloc(priv->fblen);
   if (priv->fbmem == NULL)
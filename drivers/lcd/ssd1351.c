@@ -436,6 +436,9 @@ static void ssd1351_write(FAR struct ssd1351_dev_s *priv, uint8_t cmd,
 
 static int ssd1351_putrun(fb_coord_t row, fb_coord_t col,
                           FAR const uint8_t *buffer, size_t npixels);
+static int ssd1351_putarea(fb_coord_t row_start, fb_coord_t row_end,
+                           fb_coord_t col_start, fb_coord_t col_end,
+                           FAR const uint8_t *buffer, size_t stride);
 static int ssd1351_getrun(fb_coord_t row, fb_coord_t col,
                           FAR uint8_t *buffer, size_t npixels);
 
@@ -670,45 +673,62 @@ static void ssd1351_write(FAR struct ssd1351_dev_s *priv, uint8_t cmd,
 #endif
 
 /****************************************************************************
- * Name: ssd1351_setcursor
+ * Name: ssd1351_setwindow
  *
  * Description:
- *   Set the cursor position.
+ *   Set the window that subsequent RAM writes and reads will fill.  The
+ *   cursor is placed at the upper left corner and wraps to the next row at
+ *   the right edge of the window.
  *
  ****************************************************************************/
 
-static void ssd1351_setcursor(FAR struct ssd1351_dev_s *priv, uint8_t col,
-                              uint8_t row)
+static void ssd1351_setwindow(FAR struct ssd1351_dev_s *priv,
+                              uint8_t col_start, uint8_t row_start,
+                              uint8_t col_end, uint8_t row_end)
 {
   uint8_t buf[2];
 
 #if defined(CONFIG_LCD_LANDSCAPE) || defined(CONFIG_LCD_RLANDSCAPE)
-  /* Set the column address to the column */
+  /* Set the column address to the columns */
 
-  buf[0] = col;
-  buf[1] = SSD1351_XRES - 1;
+  buf[0] = col_start;
+  buf[1] = col_end;
   ssd1351_write(priv, SSD1351_CMD_COLADDR, buf, 2);
 
-  /* Set the row address to the row */
+  /* Set the row address to the rows */
 
-  buf[0] = row;
-  buf[1] = SSD1351_YRES - 1;
+  buf[0] = row_start;
+  buf[1] = row_end;
   ssd1351_write(priv, SSD1351_CMD_ROWADDR, buf, 2);
 #elif defined(CONFIG_LCD_PORTRAIT) || defined(CONFIG_LCD_RPORTRAIT)
-  /* Set the column address to the row */
+  /* Set the column address to the rows */
 
-  buf[0] = row;
-  buf[1] = SSD1351_YRES - 1;
+  buf[0] = row_start;
+  buf[1] = row_end;
   ssd1351_write(priv, SSD1351_CMD_COLADDR, buf, 2);
 
-  /* Set the row address to the column */
+  /* Set the row address to the columns */
 
-  buf[0] = col;
-  buf[1] = SSD1351_XRES - 1;
+  buf[0] = col_start;
+  buf[1] = col_end;
   ssd1351_write(priv, SSD1351_CMD_ROWADDR, buf, 2);
 #endif
 }
 
+/****************************************************************************
+ * Name: ssd1351_setcursor
+ *
+ * Description:
+ *   Set the cursor position.
+ *
+ ****************************************************************************/
+
+static void ssd1351_setcursor(FAR struct ssd1351_dev_s *priv, uint8_t col,
+                              uint8_t row)
+{
+  ssd1351_setwindow(priv, col, row, SSD1351_XRES - 1, SSD1351_YRES - 1);
+}
+
 /****************************************************************************
  * Name: ssd1351_putrun
  *
@@ -755,6 +775,76 @@ static int ssd1351_putrun(fb_coord_t row, fb_coord_t col,
   return OK;
 }
 
+/****************************************************************************
+ * Name: ssd1351_putarea
+ *
+ * Description:
+ *   This method can be used to write a rectangular area to the LCD.  The
+ *   area is programmed as the RAM window once, so a contiguous buffer is
+ *   sent with a single RAM write.
+ *
+ * Input Parameters:
+ *   row_start - Starting row to write to (range: 0 <= row < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row < yres)
+ *   col_start - Starting column to write to (range: 0 <= col < xres)
+ *   col_end   - Ending column to write to (range: col_start <= col < xres)
+ *   buffer    - The buffer containing the area to be written to the LCD
+ *   stride    - Number of bytes between the first pixels of two rows or
+ *               zero to repeat the first row
+ *
+ ****************************************************************************/
+
+static int ssd1351_putarea(fb_coord_t row_start, fb_coord_t row_end,
+                           fb_coord_t col_start, fb_coord_t col_end,
+                           FAR const uint8_t *buffer, size_t stride)
+{
+  FAR struct ssd1351_dev_s *priv = &g_lcddev;
+  size_t ncols = col_end - col_start + 1;
+  fb_coord_t row;
+
+  /* Sanity check */
+
+  DEBUGASSERT(buffer != NULL && ((uintptr_t)buffer & 1) == 0 &&
+              col_start >= 0 && col_start <= col_end &&
+              col_end < SSD1351_XRES &&
+              row_start >= 0 && row_start <= row_end &&
+              row_end < SSD1351_YRES);
+
+  /* Select and lock the device */
+
+  ssd1351_select(priv);
+
+#ifndef CONFIG_SSD1351_SPI3WIRE
+  if (stride == SSD1351_PIX2BYTES(ncols))
+    {
+      /* The rows are contiguous, send the whole area at once */
+
+      ssd1351_setwindow(priv, col_start, row_start, col_end, row_end);
+      ssd1351_write(priv, SSD1351_CMD_RAMWRITE, buffer,
+                    SSD1351_PIX2BYTES(ncols * (row_end - row_start + 1)));
+    }
+  else
+#endif
+    {
+      /* Send one row at a time.  The 3-wire interface has to go this way
+       * since every byte is expanded into the row buffer first.
+       */
+
+      for (row = row_start; row <= row_end; row++, buffer += stride)
+        {
+          ssd1351_setwindow(priv, col_start, row, col_end, row);
+          ssd1351_write(priv, SSD1351_CMD_RAMWRITE, buffer,
+                        SSD1351_PIX2BYTES(ncols));
+        }
+    }
+
+  /* Unlock and de-select the device */
+
+  ssd1351_deselect(priv);
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: ssd1351_getrun
  *
@@ -844,10 +934,11 @@ static int ssd1351_getplaneinfo(FAR struct lcd_dev_s *dev,
 
   DEBUGASSERT(dev != NULL && pinfo != NULL && planeno == 0);
 
-  pinfo->putrun = ssd1351_putrun;
-  pinfo->getrun = ssd1351_getrun;
-  pinfo->buffer = (uint8_t *)priv->runbuffer;
-  pinfo->bpp    = SSD1351_BPP;
+  pinfo->putrun  = ssd1351_putrun;
+  pinfo->putarea = ssd1351_putarea;
+  pinfo->getrun  = ssd1351_getrun;
+  pinfo->buffer  = (uint8_t *)priv->runbuffer;
+  pinfo->bpp     = SSD1351_BPP;
 
   ginfo("planeno: %u bpp: %u\n", planeno, pinfo->bpp);
   return OK;
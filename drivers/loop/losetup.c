@@ -82,6 +82,7 @@ struct loop_struct_s
   bool         writeenabled; /* true: can write to device */
 #endif
   int          fd;           /* Descriptor of char device/file */
+  FAR const uint8_t *membase; /* Address of sector 0 if the file is mapped */
 };
 
 /****************************************************************************
@@ -100,6 +101,8 @@ static ssize_t loop_write(FAR struct inode *inode,
 #endif
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -116,7 +119,7 @@ static const struct block_operations g_bops =
   NULL,          /* write */
 #endif
   loop_geometry, /* geometry */
-  NULL           /* ioctl */
+  loop_ioctl     /* ioctl */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL         /* unlink */
 #endif
@@ -146,7 +149,7 @@ static int loop_semtake(FAR struct loop_struct_s *dev)
        */
 
       ASSERT(errcode == EINTR);
-      return -ret;
+      return -errcode;
     }
 
   return OK;
@@ -238,6 +241,8 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbytesread;
+  size_t nbytes;
+  size_t ntotal;
   off_t offset;
   int ret;
 
@@ -250,32 +255,73 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
+  nbytes = nsectors * dev->sectsize;
+
+  /* If the file content is directly accessible in memory, then the whole
+   * transfer is a single copy.
+   */
+
+  if (dev->membase != NULL)
+    {
+      memcpy(buffer, &dev->membase[start_sector * dev->sectsize], nbytes);
+      return nsectors;
+    }
+
+  /* Otherwise, the seek and the reads that follow must not be interleaved
+   * with the transfers of other users of the device.
+   */
+
+  ret = loop_semtake(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Calculate the offset to read the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
-  ret = lseek(dev->fd, offset, SEEK_SET);
-  if (ret == (off_t)-1)
+  if (lseek(dev->fd, offset, SEEK_SET) == (off_t)-1)
     {
       _err("ERROR: Seek failed for offset=%d: %d\n", (int)offset, get_errno());
-      return -EIO;
+      ret = -EIO;
+      goto errout_with_sem;
     }
 
-  /* Then read the requested number of sectors from that position */
+  /* Then read the whole extent from that position.  The file system may
+   * return fewer bytes than requested (for example, at a cluster boundary),
+   * so keep reading until everything has been transferred.
+   */
 
-  do
+  for (ntotal = 0; ntotal < nbytes; ntotal += nbytesread)
     {
-      nbytesread = read(dev->fd, buffer, nsectors * dev->sectsize);
-      if (nbytesread < 0 && get_errno() != EINTR)
+      nbytesread = read(dev->fd, &buffer[ntotal], nbytes - ntotal);
+      if (nbytesread < 0)
         {
+          if (get_errno() == EINTR)
+            {
+              nbytesread = 0;
+              continue;
+            }
+
           _err("ERROR: Read failed: %d\n", get_errno());
-          return -get_errno();
+          ret = -get_errno();
+          goto errout_with_sem;
+        }
+      else if (nbytesread == 0)
+        {
+          break;
         }
     }
-  while (nbytesread < 0);
+
+  loop_semgive(dev);
 
   /* Return the number of sectors read */
 
-  return nbytesread / dev->sectsize;
+  return ntotal / dev->sectsize;
+
+errout_with_sem:
+  loop_semgive(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -292,37 +338,70 @@ static ssize_t loop_write(FAR struct inode *inode,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbyteswritten;
+  size_t nbytes;
+  size_t ntotal;
   off_t offset;
   int ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
 
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      _err("ERROR: Write past end of file\n");
+      return -EIO;
+    }
+
+  nbytes = nsectors * dev->sectsize;
+
+  ret = loop_semtake(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Calculate the offset to write the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
-  ret = lseek(dev->fd, offset, SEEK_SET);
-  if (ret == (off_t)-1)
+  if (lseek(dev->fd, offset, SEEK_SET) == (off_t)-1)
     {
       _err("ERROR: Seek failed for offset=%d: %d\n", (int)offset, get_errno());
+      ret = -EIO;
+      goto errout_with_sem;
     }
 
-  /* Then write the requested number of sectors to that position */
+  /* Then write the whole extent to that position */
 
-  do
+  for (ntotal = 0; ntotal < nbytes; ntotal += nbyteswritten)
     {
-      nbyteswritten = write(dev->fd, buffer, nsectors * dev->sectsize);
-      if (nbyteswritten < 0 && get_errno() != EINTR)
+      nbyteswritten = write(dev->fd, &buffer[ntotal], nbytes - ntotal);
+      if (nbyteswritten < 0)
         {
+          if (get_errno() == EINTR)
+            {
+              nbyteswritten = 0;
+              continue;
+            }
+
           _err("ERROR: Write failed: %d\n", get_errno());
-          return -get_errno();
+          ret = -get_errno();
+          goto errout_with_sem;
+        }
+      else if (nbyteswritten == 0)
+        {
+          break;
         }
     }
-  while (nbyteswritten < 0);
+
+  loop_semgive(dev);
 
   /* Return the number of sectors written */
 
-  return nbyteswritten / dev->sectsize;
+  return ntotal / dev->sectsize;
+
+errout_with_sem:
+  loop_semgive(dev);
+  return ret;
 }
 #endif
 
@@ -357,6 +436,31 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description:
+ *   Return the address of the file content if it is mapped in memory
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  if ((cmd == BIOC_XIPBASE || cmd == BIOC_MEMBASE) && dev->membase && ppv)
+    {
+      *ppv = (FAR void *)dev->membase;
+      return OK;
+    }
+
+  return -ENOTTY;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -442,7 +546,7 @@ int losetup(FAR const char *devname, FAR const char *filename,
     {
       /* If that fails, then try to open the device read-only */
 
-      dev->fd = open(filename, O_RDWR);
+      dev->fd = open(filename, O_RDONLY);
       if (dev->fd < 0)
         {
           _err("ERROR: Failed to open %s: %d\n", filename, get_errno());
@@ -451,6 +555,24 @@ int losetup(FAR const char *devname, FAR const char *filename,
         }
     }
 
+  /* A read-only file whose content is directly accessible in memory (such
+   * as a ROMFS file on XIP media) does not need to go through the file
+   * system at all.  Writable files are not mapped because the file system
+   * may move the data of a file that is still open for writing.
+   */
+
+#ifdef CONFIG_FS_WRITABLE
+  if (!dev->writeenabled)
+#endif
+    {
+      FAR uint8_t *addr;
+
+      if (ioctl(dev->fd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr)) >= 0)
+        {
+          dev->membase = addr + offset;
+        }
+    }
+
   /* Inode private data will be reference to the loop device structure */
 
   ret = register_blockdriver(devname, &g_bops, 0, dev);
@@ -121,6 +121,7 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+  uint8_t setblkcount:1;           /* true: card supports CMD23, SET_BLOCK_COUNT (MMC) */
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -195,6 +196,8 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 size_t nblocks);
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
@@ -579,6 +582,12 @@ static void mmcsd_decodeCSD(FAR struct mmcsd_state_s *priv, uint32_t csd[4])
    *   TRANSFER_RATE_UNIT 2:0 Rate mantissa
    */
 
+  /* MMC cards from spec version 3.1 on support CMD23, SET_BLOCK_COUNT,
+   * which saves the CMD12 that otherwise ends each multiple block transfer.
+   */
+
+  priv->setblkcount = IS_MMC(priv->type) && ((csd[0] >> 26) & 0x0f) >= 3;
+
 #ifdef CONFIG_DEBUG_FS_INFO
   memset(&decoded, 0, sizeof(struct mmcsd_csd_s));
   decoded.csdstructure               =  csd[0] >> 30;
@@ -1239,6 +1248,37 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send CMD23, SET_BLOCK_COUNT, before a multiple block transfer to an MMC
+ *   card.  The transfer then ends by itself after 'nblocks' blocks and no
+ *   STOP_TRANSMISSION is needed.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               size_t nblocks)
+{
+  int ret;
+
+  /* The block count is in bits 15:0 */
+
+  DEBUGASSERT(nblocks <= 0xffff);
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD23, (uint32_t)nblocks);
+  ret = mmcsd_recvR1(priv, MMC_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1421,6 +1461,7 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
 {
   size_t nbytes;
   off_t  offset;
+  bool   closed = false;
   int ret;
 
   finfo("startblock=%d nblocks=%d\n", startblock, nblocks);
@@ -1489,6 +1530,19 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
     return ret;
   }
 
+  /* Tell an MMC card how many blocks will follow if it supports that */
+
+  if (priv->setblkcount && nblocks <= 0xffff)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+
+      closed = true;
+    }
+
   /* Configure SDIO controller hardware for the read transfer */
 
   SDIO_BLOCKSETUP(priv->dev, priv->blocksize, nblocks);
@@ -1534,12 +1588,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the block count was set */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (ret != OK)
+  if (!closed)
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+        }
     }
 
   /* On success, return the number of blocks read */
@@ -1791,6 +1848,7 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 {
   off_t  offset;
   size_t nbytes;
+  bool   closed = false;
   int ret;
 
   finfo("startblock=%d nblocks=%d\n", startblock, nblocks);
@@ -1864,7 +1922,8 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
   /* If this is an SD card, then send ACMD23 (SET_WR_BLK_COUNT) just before
    * sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of write
    * blocks to be pre-erased and might make the following multiple block write
-   * command faster.
+   * command faster.  An MMC card is instead told the exact block count with
+   * CMD23 (SET_BLOCK_COUNT) if it supports that.
    */
 
   if (IS_SD(priv->type))
@@ -1881,7 +1940,7 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
       /* Send CMD23, SET_WR_BLK_COUNT, and verify that good R1 status is returned */
 
-      mmcsd_sendcmdpoll(priv, SD_ACMD23, 0);
+      mmcsd_sendcmdpoll(priv, SD_ACMD23, (uint32_t)nblocks & 0x007fffff);
       ret = mmcsd_recvR1(priv, SD_ACMD23);
       if (ret != OK)
         {
@@ -1889,6 +1948,16 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
           return ret;
         }
     }
+  else if (priv->setblkcount && nblocks <= 0xffff)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+
+      closed = true;
+    }
 
   /* Configure SDIO controller hardware for the write transfer */
 
@@ -1939,13 +2008,16 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION unless the block count was set */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (ret != OK)
+  if (!closed)
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
-      return ret;
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+          return ret;
+        }
     }
 
   /* On success, return the number of blocks written */
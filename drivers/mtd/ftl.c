@@ -54,6 +54,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
+#include <nuttx/drivers/blkcache.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -73,11 +74,18 @@ struct ftl_struct_s
   struct mtd_geometry_s geo;     /* Device geometry */
 #ifdef FTL_HAVE_RWBUFFER
   struct rwbuffer_s     rwb;     /* Read-ahead/write buffer support */
+#endif
+#ifdef CONFIG_FTL_BLKCACHE
+  struct blkcache_s     cache;   /* Shared block cache support */
 #endif
   uint16_t              blkper;  /* R/W blocks per erase block */
 #ifdef CONFIG_FS_WRITABLE
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
+#ifdef CONFIG_FTL_EBCACHE
+  off_t                 cached;  /* Erase block held in eblock (or -1) */
+  bool                  dirty;   /* eblock differs from the FLASH */
+#endif
 };
 
 /****************************************************************************
@@ -90,7 +98,12 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
                  size_t start_sector, unsigned int nsectors);
+#ifdef CONFIG_FTL_EBCACHE
+static int     ftl_commit(FAR struct ftl_struct_s *dev);
+#endif
 #ifdef CONFIG_FS_WRITABLE
+static int     ftl_modify(FAR struct ftl_struct_s *dev, off_t eraseblock,
+                 off_t offset, FAR const uint8_t *buffer, size_t nbytes);
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
@@ -146,8 +159,35 @@ static int ftl_open(FAR struct inode *inode)
 
 static int ftl_close(FAR struct inode *inode)
 {
+#if defined(CONFIG_FTL_BLKCACHE) || defined(CONFIG_FTL_EBCACHE)
+  FAR struct ftl_struct_s *dev;
+  int ret = OK;
+
+  finfo("Entry\n");
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct ftl_struct_s *)inode->i_private;
+
+#ifdef CONFIG_FTL_BLKCACHE
+  /* Write back any dirty blocks held in the block cache */
+
+  ret = blkcache_flush(&dev->cache);
+#endif
+
+#ifdef CONFIG_FTL_EBCACHE
+  /* Then the cached erase block */
+
+  if (ret >= 0)
+    {
+      ret = ftl_commit(dev);
+    }
+#endif
+
+  return ret;
+#else
   finfo("Entry\n");
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -172,6 +212,25 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
             nblocks, startblock, nread);
     }
 
+#ifdef CONFIG_FTL_EBCACHE
+  /* The cached erase block may be newer than the FLASH */
+
+  else if (dev->dirty)
+    {
+      off_t first = dev->cached * dev->blkper;
+      off_t last  = first + dev->blkper;
+      off_t start = startblock > first ? startblock : first;
+      off_t end   = startblock + nblocks < last ? startblock + nblocks : last;
+
+      if (start < end)
+        {
+          memcpy(buffer + (start - startblock) * dev->geo.blocksize,
+                 dev->eblock + (start - first) * dev->geo.blocksize,
+                 (end - start) * dev->geo.blocksize);
+        }
+    }
+#endif
+
   return nread;
 }
 
@@ -192,13 +251,134 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
   DEBUGASSERT(inode && inode->i_private);
 
   dev = (FAR struct ftl_struct_s *)inode->i_private;
-#ifdef CONFIG_FTL_READAHEAD
+#if defined(CONFIG_FTL_READAHEAD)
   return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
+#elif defined(CONFIG_FTL_BLKCACHE)
+  return blkcache_read(&dev->cache, start_sector, nsectors, buffer);
 #else
   return ftl_reload(dev, buffer, start_sector, nsectors);
 #endif
 }
 
+/****************************************************************************
+ * Name: ftl_commit
+ *
+ * Description: Erase and rewrite the cached erase block if it is dirty
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_EBCACHE
+static int ftl_commit(FAR struct ftl_struct_s *dev)
+{
+  off_t  rwblock;
+  size_t nxfrd;
+  int    ret;
+
+  if (!dev->dirty)
+    {
+      return OK;
+    }
+
+  ret = MTD_ERASE(dev->mtd, dev->cached, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", dev->cached, ret);
+      return ret;
+    }
+
+  rwblock = dev->cached * dev->blkper;
+  nxfrd   = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+
+  dev->dirty = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_modify
+ *
+ * Description:
+ *   Replace part of one erase block.  Without the erase block cache, the
+ *   erase block is read, erased and written back right away.  With it, the
+ *   change is merged into the cached copy and written back only when
+ *   another erase block is modified or the cache is flushed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int ftl_modify(FAR struct ftl_struct_s *dev, off_t eraseblock,
+                      off_t offset, FAR const uint8_t *buffer, size_t nbytes)
+{
+  off_t  rwblock = eraseblock * dev->blkper;
+  size_t nxfrd;
+  int    ret;
+
+#ifdef CONFIG_FTL_EBCACHE
+  if (dev->cached != eraseblock)
+    {
+      /* Write back the erase block that is cached now */
+
+      ret = ftl_commit(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      dev->cached = -1;
+#endif
+
+      /* Read the full erase block into the buffer */
+
+      nxfrd = MTD_BREAD(dev->mtd, rwblock, dev->blkper, dev->eblock);
+      if (nxfrd != dev->blkper)
+        {
+          ferr("ERROR: Read erase block %d failed: %d\n", rwblock, nxfrd);
+          return -EIO;
+        }
+
+#ifdef CONFIG_FTL_EBCACHE
+      dev->cached = eraseblock;
+    }
+#endif
+
+  /* Copy the user data into the buffered erase block */
+
+  finfo("Copy %d bytes into erase block=%d at offset=%d\n",
+         nbytes, eraseblock, offset);
+
+  memcpy(dev->eblock + offset, buffer, nbytes);
+
+#ifdef CONFIG_FTL_EBCACHE
+  dev->dirty = true;
+#else
+  /* Then erase the erase block */
+
+  ret = MTD_ERASE(dev->mtd, eraseblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
+      return ret;
+    }
+
+  /* And write the erase block back to flash */
+
+  nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
+      return -EIO;
+    }
+#endif
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_flush
  *
@@ -213,7 +393,6 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   off_t  alignedblock;
   off_t  mask;
-  off_t  rwblock;
   off_t  eraseblock;
   off_t  offset;
   size_t remaining;
@@ -238,29 +417,10 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 
       bool short_write = (remaining < (alignedblock - startblock));
 
-      /* Read the full erase block into the buffer */
-
-      rwblock = startblock & ~mask;
-      nxfrd   = MTD_BREAD(dev->mtd, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Read erase block %d failed: %d\n", rwblock, nxfrd);
-          return -EIO;
-        }
-
-      /* Then erase the erase block */
-
-      eraseblock = rwblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
-      if (ret < 0)
-        {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-          return ret;
-        }
-
       /* Copy the user data at the end of the buffered erase block */
 
-      offset = (startblock & mask) * dev->geo.blocksize;
+      eraseblock = startblock / dev->blkper;
+      offset     = (startblock & mask) * dev->geo.blocksize;
 
       if (short_write)
         {
@@ -271,18 +431,10 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
           nbytes = dev->geo.erasesize - offset;
         }
 
-      finfo("Copy %d bytes into erase block=%d at offset=%d\n",
-             nbytes, eraseblock, offset);
-
-      memcpy(dev->eblock + offset, buffer, nbytes);
-
-      /* And write the erase block back to flash */
-
-      nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
+      ret = ftl_modify(dev, eraseblock, offset, buffer, nbytes);
+      if (ret < 0)
         {
-          ferr("ERROR: Write erase block %d failed: %d\n", rwblock, nxfrd);
-          return -EIO;
+          return ret;
         }
 
       /* Then update for amount written */
@@ -306,7 +458,18 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
       /* Erase the erase block */
 
       eraseblock = alignedblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+
+#ifdef CONFIG_FTL_EBCACHE
+      /* The cached copy of this erase block is about to be replaced */
+
+      if (dev->cached == eraseblock)
+        {
+          dev->cached = -1;
+          dev->dirty  = false;
+        }
+#endif
+
+      ret = MTD_ERASE(dev->mtd, eraseblock, 1);
       if (ret < 0)
         {
           ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
@@ -336,40 +499,16 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 
   if (remaining > 0)
     {
-      /* Read the full erase block into the buffer */
-
-     nxfrd = MTD_BREAD(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Read erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
-        }
-
-      /* Then erase the erase block */
+      /* Copy the user data at the beginning the buffered erase block */
 
       eraseblock = alignedblock / dev->blkper;
-      ret        = MTD_ERASE(dev->mtd, eraseblock, 1);
+      nbytes     = remaining * dev->geo.blocksize;
+
+      ret = ftl_modify(dev, eraseblock, 0, buffer, nbytes);
       if (ret < 0)
         {
-          ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
           return ret;
         }
-
-      /* Copy the user data at the beginning the buffered erase block */
-
-      nbytes = remaining * dev->geo.blocksize;
-      finfo("Copy %d bytes into erase block=%d at offset=0\n",
-             nbytes, alignedblock);
-      memcpy(dev->eblock, buffer, nbytes);
-
-      /* And write the erase back to flash */
-
-      nxfrd = MTD_BWRITE(dev->mtd, alignedblock, dev->blkper, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          ferr("ERROR: Write erase block %d failed: %d\n", alignedblock, nxfrd);
-          return -EIO;
-        }
     }
 
   return nblocks;
@@ -393,8 +532,10 @@ static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (struct ftl_struct_s *)inode->i_private;
-#ifdef CONFIG_FTL_WRITEBUFFER
+#if defined(CONFIG_FTL_WRITEBUFFER)
   return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
+#elif defined(CONFIG_FTL_BLKCACHE)
+  return blkcache_write(&dev->cache, start_sector, nsectors, buffer);
 #else
   return ftl_flush(dev, buffer, start_sector, nsectors);
 #endif
@@ -453,9 +594,27 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
   finfo("Entry\n");
   DEBUGASSERT(inode && inode->i_private);
+  dev = (struct ftl_struct_s *)inode->i_private;
+
+  /* BIOC_FLUSH writes back anything buffered in this layer */
 
-  /* Only one block driver ioctl command is supported by this driver (and
-   * that command is just passed on to the MTD driver in a slightly
+  if (cmd == BIOC_FLUSH)
+    {
+      ret = OK;
+#ifdef CONFIG_FTL_BLKCACHE
+      ret = blkcache_flush(&dev->cache);
+#endif
+#ifdef CONFIG_FTL_EBCACHE
+      if (ret >= 0)
+        {
+          ret = ftl_commit(dev);
+        }
+#endif
+      return ret;
+    }
+
+  /* Only one other block driver ioctl command is supported by this driver
+   * (and that command is just passed on to the MTD driver in a slightly
    * different form).
    */
 
@@ -484,7 +643,6 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
    * to the MTD driver (unchanged).
    */
 
-  dev = (struct ftl_struct_s *)inode->i_private;
   ret = MTD_IOCTL(dev->mtd, cmd, arg);
   if (ret < 0)
     {
@@ -534,6 +692,9 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       /* Initialize the FTL device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_FTL_EBCACHE
+      dev->cached = -1;
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -594,6 +755,32 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
         }
 #endif
 
+#ifdef CONFIG_FTL_BLKCACHE
+      /* Attach to the shared block cache.  Dirty blocks are written back
+       * up to one erase block at a time.
+       */
+
+      dev->cache.blocksize   = dev->geo.blocksize;
+      dev->cache.nblocks     = dev->geo.neraseblocks * dev->blkper;
+      dev->cache.dev         = (FAR void *)dev;
+      dev->cache.reload      = ftl_reload;
+#ifdef CONFIG_FS_WRITABLE
+      dev->cache.wrmaxblocks = dev->blkper;
+      dev->cache.flush       = ftl_flush;
+#endif
+
+      ret = blkcache_attach(&dev->cache);
+      if (ret < 0)
+        {
+          ferr("ERROR: blkcache_attach failed: %d\n", ret);
+#ifdef CONFIG_FS_WRITABLE
+          kmm_free(dev->eblock);
+#endif
+          kmm_free(dev);
+          return ret;
+        }
+#endif
+
       /* Create a MTD block device name */
 
       snprintf(devname, 16, "/dev/mtdblock%d", minor);
@@ -604,6 +791,9 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
+#ifdef CONFIG_FTL_BLKCACHE
+          (void)blkcache_detach(&dev->cache);
+#endif
 #ifdef CONFIG_FS_WRITABLE
           kmm_free(dev->eblock);
 #endif
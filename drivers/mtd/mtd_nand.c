@@ -825,6 +825,44 @@ static int nand_ioctl(struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+      case MTDIOC_ISBAD:
+        {
+          /* Report the bad block marker of one erase block */
+
+          if (arg >= nandmodel_getdevblocks(model))
+            {
+              break;
+            }
+
+          nand_lock(nand);
+          ret = (nand_checkblock(nand, (off_t)arg) != GOODBLOCK);
+          nand_unlock(nand);
+        }
+        break;
+
+      case MTDIOC_MARKBAD:
+        {
+          FAR const struct nand_scheme_s *scheme;
+          uint8_t spare[CONFIG_MTD_NAND_MAXPAGESPARESIZE];
+
+          /* Write the bad block marker into the spare area of page 0 */
+
+          if (arg >= nandmodel_getdevblocks(model))
+            {
+              break;
+            }
+
+          scheme = nandmodel_getscheme(model);
+          memset(spare, 0xff, CONFIG_MTD_NAND_MAXPAGESPARESIZE);
+          nandscheme_writebadblockmarker(scheme, spare,
+                                         NAND_BLOCKSTATUS_BAD);
+
+          nand_lock(nand);
+          ret = NAND_WRITEPAGE(raw, (off_t)arg, 0, 0, spare);
+          nand_unlock(nand);
+        }
+        break;
+
       case MTDIOC_XIPBASE:
       default:
         ret = -ENOTTY; /* Bad command */
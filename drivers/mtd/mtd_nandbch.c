@@ -0,0 +1,646 @@
+/****************************************************************************
+ * drivers/mtd/mtd_nandbch.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Software binary BCH code over GF(2^13) for 512-byte ECC steps.
+ *
+ * The 4096 data bits and the 13 * t ECC bits of a step form a shortened
+ * BCH codeword.  The first data byte holds the highest powers, most
+ * significant bit first, and the ECC bits follow in the same order.
+ *
+ * - Encoding divides the data by the generator polynomial g(x), eight bits
+ *   at a time through a 256-entry table of 32-bit words, so the inner loop
+ *   works on whole words instead of single bits.
+ * - Decoding recomputes the remainder and adds it to the stored ECC.  If
+ *   the sum is zero, the step is clean.  Otherwise 2t syndromes are
+ *   computed from it, Berlekamp-Massey finds the error locator polynomial
+ *   and a Chien search finds its roots, which are the positions in error.
+ * - The ECC is stored inverted relative to the ECC of an erased step, so
+ *   that an erased page (all 0xff, data and ECC) is a valid codeword.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/mtd/nand_config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mtd/nand_ecc.h>
+
+#ifdef CONFIG_MTD_NAND_BCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BCH_M          13                  /* Galois field GF(2^13) */
+#define BCH_N          ((1 << BCH_M) - 1)  /* Length of the full code */
+#define BCH_POLY       0x201b              /* x^13 + x^4 + x^3 + x + 1 */
+#define BCH_STEPSIZE   512                 /* Data bytes per step */
+#define BCH_DATABITS   (8 * BCH_STEPSIZE)
+#define BCH_MAXT       8                   /* Maximum correctable bits */
+#define BCH_MAXWORDS   4                   /* Words of the widest remainder */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nandbch_s
+{
+  struct nand_eccengine_s engine;          /* Must be first */
+  bool     initialized;                    /* Tables have been built */
+  uint8_t  nwords;                         /* Words per remainder */
+  uint16_t r;                              /* ECC bits (degree of g(x)) */
+  uint32_t mask[BCH_MAXWORDS];             /* Inverted ECC of erased data */
+  uint32_t table[256][BCH_MAXWORDS];       /* v(x) * x^r mod g(x) */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void nandbch_calculate(FAR const struct nand_eccengine_s *engine,
+                              FAR const uint8_t *data, FAR uint8_t *ecc);
+static int  nandbch_correct(FAR const struct nand_eccengine_s *engine,
+                            FAR uint8_t *data, FAR const uint8_t *ecc);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* GF(2^13) antilog and log tables */
+
+static uint16_t g_alpha[BCH_N];
+static uint16_t g_log[BCH_N + 1];
+static bool     g_gfinitialized;
+
+/* The supported engines */
+
+static struct nandbch_s g_bch4 =
+{
+  {
+    BCH_STEPSIZE,                          /* stepsize */
+    (4 * BCH_M + 7) / 8,                   /* eccbytes */
+    4,                                     /* strength */
+    nandbch_calculate,                     /* calculate */
+    nandbch_correct                        /* correct */
+  }
+};
+
+static struct nandbch_s g_bch8 =
+{
+  {
+    BCH_STEPSIZE,                          /* stepsize */
+    (8 * BCH_M + 7) / 8,                   /* eccbytes */
+    8,                                     /* strength */
+    nandbch_calculate,                     /* calculate */
+    nandbch_correct                        /* correct */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gf_mul and gf_div
+ *
+ * Description:
+ *   Multiply and divide elements of GF(2^13)
+ *
+ ****************************************************************************/
+
+static inline uint16_t gf_mul(uint16_t a, uint16_t b)
+{
+  if (a == 0 || b == 0)
+    {
+      return 0;
+    }
+
+  return g_alpha[(g_log[a] + g_log[b]) % BCH_N];
+}
+
+static inline uint16_t gf_div(uint16_t a, uint16_t b)
+{
+  if (a == 0)
+    {
+      return 0;
+    }
+
+  return g_alpha[(g_log[a] + BCH_N - g_log[b]) % BCH_N];
+}
+
+/****************************************************************************
+ * Name: nandbch_gfinit
+ *
+ * Description:
+ *   Build the GF(2^13) tables
+ *
+ ****************************************************************************/
+
+static void nandbch_gfinit(void)
+{
+  unsigned int x = 1;
+  unsigned int i;
+
+  for (i = 0; i < BCH_N; i++)
+    {
+      g_alpha[i] = (uint16_t)x;
+      g_log[x]   = (uint16_t)i;
+
+      x <<= 1;
+      if ((x & (1 << BCH_M)) != 0)
+        {
+          x ^= BCH_POLY;
+        }
+    }
+
+  g_log[0] = 0;
+  g_gfinitialized = true;
+}
+
+/****************************************************************************
+ * Name: nandbch_shift1
+ *
+ * Description:
+ *   Shift a left-aligned remainder by one bit, folding in g(x) if the bit
+ *   shifted out (plus the input bit) is set.
+ *
+ ****************************************************************************/
+
+static void nandbch_shift1(FAR struct nandbch_s *bch, FAR uint32_t *rem,
+                           FAR const uint32_t *gpoly, unsigned int bit)
+{
+  unsigned int fb = (rem[0] >> 31) ^ bit;
+  int i;
+
+  for (i = 0; i < bch->nwords - 1; i++)
+    {
+      rem[i] = (rem[i] << 1) | (rem[i + 1] >> 31);
+    }
+
+  rem[bch->nwords - 1] <<= 1;
+
+  if (fb)
+    {
+      for (i = 0; i < bch->nwords; i++)
+        {
+          rem[i] ^= gpoly[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_remainder
+ *
+ * Description:
+ *   Compute data(x) * x^r mod g(x) for one step, eight bits at a time.
+ *   The remainder is left-aligned in bch->nwords words.
+ *
+ ****************************************************************************/
+
+static void nandbch_remainder(FAR const struct nandbch_s *bch,
+                              FAR const uint8_t *data, FAR uint32_t *rem)
+{
+  FAR const uint32_t *entry;
+  unsigned int nbytes = BCH_STEPSIZE;
+  int last = bch->nwords - 1;
+  int i;
+
+  memset(rem, 0, bch->nwords * sizeof(uint32_t));
+  while (nbytes-- > 0)
+    {
+      entry = bch->table[(rem[0] >> 24) ^ *data++];
+
+      for (i = 0; i < last; i++)
+        {
+          rem[i] = ((rem[i] << 8) | (rem[i + 1] >> 24)) ^ entry[i];
+        }
+
+      rem[last] = (rem[last] << 8) ^ entry[last];
+    }
+}
+
+/****************************************************************************
+ * Name: nandbch_init
+ *
+ * Description:
+ *   Build the generator polynomial, the encoding table and the erased mask
+ *   of one engine.
+ *
+ ****************************************************************************/
+
+static void nandbch_init(FAR struct nandbch_s *bch)
+{
+  uint16_t roots[BCH_MAXT * BCH_M];
+  uint16_t gfpoly[BCH_MAXT * BCH_M + 1];
+  uint32_t gpoly[BCH_MAXWORDS];
+  uint8_t  erased[BCH_STEPSIZE];
+  unsigned int nroots = 0;
+  unsigned int t = bch->engine.strength;
+  unsigned int root;
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+  unsigned int v;
+
+  if (!g_gfinitialized)
+    {
+      nandbch_gfinit();
+    }
+
+  /* The roots of g(x) are alpha^i for i = 1..2t and their conjugates,
+   * i.e. the cyclotomic cosets of the odd i.
+   */
+
+  for (i = 1; i < 2 * t; i += 2)
+    {
+      root = i;
+      do
+        {
+          for (k = 0; k < nroots; k++)
+            {
+              if (roots[k] == root)
+                {
+                  break;
+                }
+            }
+
+          if (k == nroots)
+            {
+              roots[nroots++] = (uint16_t)root;
+            }
+
+          root = (root * 2) % BCH_N;
+        }
+      while (root != i);
+    }
+
+  /* Multiply out g(x) = product of (x + alpha^root) */
+
+  memset(gfpoly, 0, sizeof(gfpoly));
+  gfpoly[0] = 1;
+
+  for (k = 0; k < nroots; k++)
+    {
+      for (j = k + 1; j > 0; j--)
+        {
+          gfpoly[j] = gfpoly[j - 1] ^ gf_mul(gfpoly[j], g_alpha[roots[k]]);
+        }
+
+      gfpoly[0] = gf_mul(gfpoly[0], g_alpha[roots[k]]);
+    }
+
+  /* The coefficients are all 0 or 1.  Store g(x) without x^r, left-aligned
+   * so that x^(r-1) is the most significant bit.
+   */
+
+  bch->r      = (uint16_t)nroots;
+  bch->nwords = (uint8_t)((nroots + 31) / 32);
+
+  memset(gpoly, 0, sizeof(gpoly));
+  for (i = 0; i < nroots; i++)
+    {
+      if (gfpoly[i] != 0)
+        {
+          j = nroots - 1 - i;
+          gpoly[j / 32] |= (uint32_t)1 << (31 - (j % 32));
+        }
+    }
+
+  /* The encoding table holds v(x) * x^r mod g(x) for every byte v */
+
+  for (v = 0; v < 256; v++)
+    {
+      memset(bch->table[v], 0, sizeof(bch->table[v]));
+      for (i = 0; i < 8; i++)
+        {
+          nandbch_shift1(bch, bch->table[v], gpoly, (v >> (7 - i)) & 1);
+        }
+    }
+
+  /* Store the ECC inverted relative to that of an erased step */
+
+  memset(erased, 0xff, BCH_STEPSIZE);
+  nandbch_remainder(bch, erased, bch->mask);
+
+  for (i = 0; i < nroots; i++)
+    {
+      bch->mask[i / 32] ^= (uint32_t)1 << (31 - (i % 32));
+    }
+
+  bch->initialized = true;
+
+  finfo("BCH-%u: %u ECC bits per %u bytes\n",
+        t, nroots, BCH_STEPSIZE);
+}
+
+/****************************************************************************
+ * Name: nandbch_calculate
+ *
+ * Description:
+ *   Compute the ECC of one step
+ *
+ ****************************************************************************/
+
+static void nandbch_calculate(FAR const struct nand_eccengine_s *engine,
+                              FAR const uint8_t *data, FAR uint8_t *ecc)
+{
+  FAR const struct nandbch_s *bch = (FAR const struct nandbch_s *)engine;
+  uint32_t rem[BCH_MAXWORDS];
+  unsigned int i;
+
+  nandbch_remainder(bch, data, rem);
+
+  for (i = 0; i < engine->eccbytes; i++)
+    {
+      ecc[i] = (uint8_t)((rem[i / 4] ^ bch->mask[i / 4]) >>
+                         (24 - 8 * (i % 4)));
+    }
+
+  /* Leave the unused bits of the last byte erased */
+
+  ecc[i - 1] |= (uint8_t)(0xff >> (bch->r - 8 * (i - 1)));
+}
+
+/****************************************************************************
+ * Name: nandbch_correct
+ *
+ * Description:
+ *   Check one step against its ECC and correct it in place
+ *
+ ****************************************************************************/
+
+static int nandbch_correct(FAR const struct nand_eccengine_s *engine,
+                           FAR uint8_t *data, FAR const uint8_t *ecc)
+{
+  FAR const struct nandbch_s *bch = (FAR const struct nandbch_s *)engine;
+  uint32_t rem[BCH_MAXWORDS];
+  uint32_t stored[BCH_MAXWORDS];
+  uint16_t syn[2 * BCH_MAXT + 1];
+  uint16_t lambda[2 * BCH_MAXT + 1];
+  uint16_t prev[2 * BCH_MAXT + 1];
+  uint16_t tmp[2 * BCH_MAXT + 1];
+  uint16_t index[2 * BCH_MAXT + 1];
+  unsigned int t = engine->strength;
+  unsigned int nbits = BCH_DATABITS + bch->r;
+  unsigned int nerrors;
+  unsigned int len;
+  unsigned int m;
+  unsigned int n;
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+  uint16_t discrepancy;
+  uint16_t pdiscrepancy;
+  uint16_t coef;
+  uint16_t sum;
+  bool clean = true;
+
+  /* s(x) = (data(x) * x^r mod g(x)) + stored ECC.  This is the remainder of
+   * the error polynomial; it is zero if there are no errors.
+   */
+
+  nandbch_remainder(bch, data, rem);
+
+  memset(stored, 0, sizeof(stored));
+  for (i = 0; i < engine->eccbytes; i++)
+    {
+      stored[i / 4] |= (uint32_t)ecc[i] << (24 - 8 * (i % 4));
+    }
+
+  for (i = 0; i < bch->nwords; i++)
+    {
+      rem[i] ^= stored[i] ^ bch->mask[i];
+    }
+
+  /* Ignore the unused bits at the end */
+
+  if ((bch->r % 32) != 0)
+    {
+      rem[bch->nwords - 1] &= ~(0xffffffff >> (bch->r % 32));
+    }
+
+  for (i = 0; i < bch->nwords; i++)
+    {
+      if (rem[i] != 0)
+        {
+          clean = false;
+        }
+    }
+
+  if (clean)
+    {
+      return 0;
+    }
+
+  /* Syndromes S(j) = s(alpha^j) for j = 1..2t.  Only the odd ones need to
+   * be evaluated: S(2j) = S(j)^2.
+   */
+
+  memset(syn, 0, sizeof(syn));
+  for (i = 0; i < bch->r; i++)
+    {
+      if ((rem[i / 32] & ((uint32_t)1 << (31 - (i % 32)))) != 0)
+        {
+          /* Bit i from the top is the coefficient of x^(r-1-i) */
+
+          k = bch->r - 1 - i;
+          for (j = 1; j < 2 * t; j += 2)
+            {
+              syn[j] ^= g_alpha[(k * j) % BCH_N];
+            }
+        }
+    }
+
+  for (j = 2; j <= 2 * t; j += 2)
+    {
+      syn[j] = gf_mul(syn[j / 2], syn[j / 2]);
+    }
+
+  /* Berlekamp-Massey: find the error locator polynomial lambda(x) */
+
+  memset(lambda, 0, sizeof(lambda));
+  memset(prev, 0, sizeof(prev));
+  lambda[0]    = 1;
+  prev[0]      = 1;
+  len          = 0;
+  m            = 1;
+  pdiscrepancy = 1;
+
+  for (n = 0; n < 2 * t; n++)
+    {
+      discrepancy = syn[n + 1];
+      for (i = 1; i <= len; i++)
+        {
+          discrepancy ^= gf_mul(lambda[i], syn[n + 1 - i]);
+        }
+
+      if (discrepancy == 0)
+        {
+          m++;
+          continue;
+        }
+
+      coef = gf_div(discrepancy, pdiscrepancy);
+      memcpy(tmp, lambda, sizeof(tmp));
+
+      for (i = 0; i + m <= 2 * t; i++)
+        {
+          lambda[i + m] ^= gf_mul(coef, prev[i]);
+        }
+
+      if (2 * len <= n)
+        {
+          len          = n + 1 - len;
+          pdiscrepancy = discrepancy;
+          memcpy(prev, tmp, sizeof(prev));
+          m            = 1;
+        }
+      else
+        {
+          m++;
+        }
+    }
+
+  if (len > t)
+    {
+      return -EBADMSG;
+    }
+
+  /* Chien search: x^k is in error if lambda(alpha^-k) = 0.  index[i]
+   * tracks the logarithm of lambda[i] * alpha^(-k * i).
+   */
+
+  for (i = 0; i <= len; i++)
+    {
+      index[i] = lambda[i] != 0 ? g_log[lambda[i]] : 0;
+    }
+
+  nerrors = 0;
+  for (k = 0; k < nbits && nerrors < len; k++)
+    {
+      sum = 0;
+      for (i = 0; i <= len; i++)
+        {
+          if (lambda[i] != 0)
+            {
+              sum ^= g_alpha[index[i]];
+              index[i] = (uint16_t)((index[i] + BCH_N - i) % BCH_N);
+            }
+        }
+
+      if (sum == 0)
+        {
+          /* Data bits hold the powers r..nbits-1, first byte highest.
+           * Errors in the ECC itself need no correction.
+           */
+
+          if (k >= bch->r)
+            {
+              j = nbits - 1 - k;
+              data[j >> 3] ^= (uint8_t)(0x80 >> (j & 7));
+            }
+
+          nerrors++;
+        }
+    }
+
+  /* All roots must lie within the shortened code */
+
+  if (nerrors != len)
+    {
+      return -EBADMSG;
+    }
+
+  return (int)nerrors;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandecc_bch_initialize
+ *
+ * Description:
+ *   Return the software BCH ECC engine that corrects up to 'strength' bit
+ *   errors in every 512 bytes of data.
+ *
+ * Input parameters:
+ *   strength - Number of correctable bit errors per 512 bytes: 4 or 8.
+ *
+ * Returned value.
+ *   The ECC engine; NULL if the strength is not supported.
+ *
+ ****************************************************************************/
+
+FAR const struct nand_eccengine_s *nandecc_bch_initialize(int strength)
+{
+  FAR struct nandbch_s *bch;
+
+  switch (strength)
+    {
+      case 4:
+        bch = &g_bch4;
+        break;
+
+      case 8:
+        bch = &g_bch8;
+        break;
+
+      default:
+        ferr("ERROR: Unsupported BCH strength: %d\n", strength);
+        return NULL;
+    }
+
+  if (!bch->initialized)
+    {
+      nandbch_init(bch);
+    }
+
+  return &bch->engine;
+}
+
+#endif /* CONFIG_MTD_NAND_BCH */
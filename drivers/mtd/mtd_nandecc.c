@@ -62,6 +62,42 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* ECC engine data is stored at the end of the spare area, clear of the bad
+ * block marker at the beginning.
+ */
+
+#define NANDECC_SPARE_RESERVED 6
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandecc_layout
+ *
+ * Description:
+ *   Return the offset in the spare area of the ECC produced by an ECC
+ *   engine for one page.
+ *
+ ****************************************************************************/
+
+static int nandecc_layout(FAR const struct nand_eccengine_s *engine,
+                          unsigned int pagesize, unsigned int sparesize)
+{
+  unsigned int eccsize;
+
+  eccsize = (pagesize / engine->stepsize) * engine->eccbytes;
+  if ((pagesize % engine->stepsize) != 0 ||
+      eccsize + NANDECC_SPARE_RESERVED > sparesize)
+    {
+      ferr("ERROR: %u bytes of ECC do not fit in the spare area\n",
+           eccsize);
+      return -EINVAL;
+    }
+
+  return (int)(sparesize - eccsize);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -138,6 +174,53 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
       return ret;
     }
 
+  /* Check and correct each step with the ECC engine, if there is one.
+   * There is nothing to check if only the spare area was requested.
+   */
+
+  if (raw->engine != NULL)
+    {
+      FAR const struct nand_eccengine_s *engine = raw->engine;
+      FAR uint8_t *ecc;
+      FAR uint8_t *step;
+      unsigned int nsteps;
+      int nflips = 0;
+
+      ret = nandecc_layout(engine, pagesize, sparesize);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ecc  = (FAR uint8_t *)spare + ret;
+      step = (FAR uint8_t *)data;
+
+      for (nsteps = data ? pagesize / engine->stepsize : 0;
+           nsteps > 0;
+           nsteps--)
+        {
+          ret = engine->correct(engine, step, ecc);
+          if (ret < 0)
+            {
+              ferr("ERROR: Block=%d page=%d Unrecoverable error\n",
+                   block, page);
+              return -EIO;
+            }
+
+          nflips += ret;
+          step   += engine->stepsize;
+          ecc    += engine->eccbytes;
+        }
+
+      if (nflips > 0)
+        {
+          finfo("Block=%d page=%d: corrected %d bit errors\n",
+                block, page, nflips);
+        }
+
+      return OK;
+    }
+
   /* Retrieve ECC information from page */
 
   scheme = nandmodel_getscheme(model);
@@ -202,6 +285,53 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
   pagesize  = nandmodel_getpagesize(model);
   sparesize = nandmodel_getsparesize(model);
 
+  /* Store code in spare buffer, either the buffer provided by the caller or
+   * the scatch buffer in the raw NAND structure.
+   */
+
+  if (!spare)
+    {
+      spare = raw->spare;
+      memset(spare, 0xff, sparesize);
+    }
+
+  /* Compute the ECC of each step with the ECC engine, if there is one.
+   * Without new data, the existing ECC bytes are kept (0xff).
+   */
+
+  if (raw->engine != NULL)
+    {
+      FAR const struct nand_eccengine_s *engine = raw->engine;
+      FAR const uint8_t *step;
+      FAR uint8_t *ecc;
+      unsigned int nsteps;
+
+      ret = nandecc_layout(engine, pagesize, sparesize);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ecc  = (FAR uint8_t *)spare + ret;
+      step = (FAR const uint8_t *)data;
+
+      if (data)
+        {
+          for (nsteps = pagesize / engine->stepsize; nsteps > 0; nsteps--)
+            {
+              engine->calculate(engine, step, ecc);
+              step += engine->stepsize;
+              ecc  += engine->eccbytes;
+            }
+        }
+      else
+        {
+          memset(ecc, 0xff, sparesize - ret);
+        }
+
+      goto write;
+    }
+
   /* Set hamming code set to 0xffff.. to keep existing bytes */
 
   memset(raw->ecc, 0xff, CONFIG_MTD_NAND_MAXSPAREECCBYTES);
@@ -215,16 +345,6 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
       hamming_compute256x(data, pagesize, raw->ecc);
     }
 
-  /* Store code in spare buffer, either the buffer provided by the caller or
-   * the scatch buffer in the raw NAND structure.
-   */
-
-  if (!spare)
-    {
-      spare = raw->spare;
-      memset(spare, 0xff, sparesize);
-    }
-
   /* Write the ECC */
 
   scheme = nandmodel_getscheme(model);
@@ -232,6 +352,7 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   /* Perform page write operation */
 
+write:
   ret = NAND_RAWWRITE(nand->raw, block, page, data, spare);
   if (ret < 0)
     {
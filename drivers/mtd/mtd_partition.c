@@ -48,10 +48,15 @@
 #include <string.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <semaphore.h>
 #include <sys/stat.h>
 
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+#include <nuttx/wqueue.h>
+#endif
 #include <nuttx/fs/ioctl.h>
 #ifdef CONFIG_FS_PROCFS
 #include <nuttx/fs/procfs.h>
@@ -89,6 +94,18 @@ struct mtd_partition_s
   off_t blocksize;              /* The size of one read/write block */
   uint16_t blkpererase;         /* Number of R/W blocks in one erase block */
 
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+  /* Background erase.  'bgsem' is held from the time that an erase is
+   * submitted until the worker has erased the last block.
+   */
+
+  struct work_s bgwork;         /* Background erase work */
+  sem_t bgsem;                  /* Held while an erase is in progress */
+  off_t bgnext;                 /* Next erase block to be erased */
+  off_t bgend;                  /* First erase block beyond the erase */
+  int bgresult;                 /* Deferred result of the last erase */
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_PROCFS_EXCLUDE_PARTITIONS)
   struct mtd_partition_s  *pnext; /* Pointer to next partition struct */
 #endif
@@ -215,6 +232,70 @@ static bool part_bytecheck(FAR struct mtd_partition_s *priv, off_t byoff)
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: part_bgworker
+ *
+ * Description:
+ *   Erase the blocks of a background erase one erase block at a time.
+ *   Each erase of the parent takes the parent's lock only briefly, so that
+ *   accesses to other partitions of the same FLASH may proceed between the
+ *   erasures of the individual blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+static void part_bgworker(FAR void *arg)
+{
+  FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)arg;
+  int ret = OK;
+
+  while (priv->bgnext < priv->bgend)
+    {
+      ret = priv->parent->erase(priv->parent, priv->bgnext, 1);
+      if (ret < 0)
+        {
+          ferr("ERROR: Erase of block %ld failed: %d\n",
+               (long)priv->bgnext, ret);
+          break;
+        }
+
+      priv->bgnext++;
+    }
+
+  priv->bgresult = ret < 0 ? ret : OK;
+  sem_post(&priv->bgsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: part_bgwait
+ *
+ * Description:
+ *   Wait for any background erase of the partition to complete.  The
+ *   result of a failed erase is returned (once) to the next caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+static int part_bgwait(FAR struct mtd_partition_s *priv)
+{
+  int ret;
+
+  while (sem_wait(&priv->bgsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  ret            = priv->bgresult;
+  priv->bgresult = OK;
+
+  sem_post(&priv->bgsem);
+  return ret;
+}
+#else
+#  define part_bgwait(p) (OK)
+#endif
+
 /****************************************************************************
  * Name: part_erase
  *
@@ -228,6 +309,9 @@ static int part_erase(FAR struct mtd_dev_s *dev, off_t startblock,
 {
   FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
   off_t eoffset;
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+  int ret;
+#endif
 
   DEBUGASSERT(priv);
 
@@ -248,7 +332,41 @@ static int part_erase(FAR struct mtd_dev_s *dev, off_t startblock,
   eoffset = priv->firstblock / priv->blkpererase;
   DEBUGASSERT(eoffset * priv->blkpererase == priv->firstblock);
 
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+  /* Queue the erase for the worker and return immediately.  Subsequent
+   * accesses to this partition will wait for the erase to complete;
+   * accesses to other partitions will not.
+   */
+
+  while (sem_wait(&priv->bgsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  ret = priv->bgresult;
+  if (ret < 0)
+    {
+      /* Report the failure of the previous erase */
+
+      priv->bgresult = OK;
+      sem_post(&priv->bgsem);
+      return ret;
+    }
+
+  priv->bgnext = startblock + eoffset;
+  priv->bgend  = startblock + eoffset + nblocks;
+
+  ret = work_queue(LPWORK, &priv->bgwork, part_bgworker, priv, 0);
+  if (ret < 0)
+    {
+      sem_post(&priv->bgsem);
+      return ret;
+    }
+
+  return (int)nblocks;
+#else
   return priv->parent->erase(priv->parent, startblock + eoffset, nblocks);
+#endif
 }
 
 /****************************************************************************
@@ -263,6 +381,7 @@ static ssize_t part_bread(FAR struct mtd_dev_s *dev, off_t startblock,
                           size_t nblocks, FAR uint8_t *buf)
 {
   FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
+  int ret;
 
   DEBUGASSERT(priv && (buf || nblocks == 0));
 
@@ -274,6 +393,14 @@ static ssize_t part_bread(FAR struct mtd_dev_s *dev, off_t startblock,
       return -ENXIO;
     }
 
+  /* Wait for any erase of the partition in progress */
+
+  ret = part_bgwait(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Just add the partition offset to the requested block and let the
    * underlying MTD driver perform the read.
    */
@@ -294,6 +421,7 @@ static ssize_t part_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
                            size_t nblocks, FAR const uint8_t *buf)
 {
   FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
+  int ret;
 
   DEBUGASSERT(priv && (buf || nblocks == 0));
 
@@ -305,6 +433,14 @@ static ssize_t part_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
       return -ENXIO;
     }
 
+  /* Wait for any erase of the partition in progress */
+
+  ret = part_bgwait(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Just add the partition offset to the requested block and let the
    * underlying MTD driver perform the write.
    */
@@ -326,6 +462,7 @@ static ssize_t part_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
 {
   FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
   off_t newoffset;
+  int ret;
 
   DEBUGASSERT(priv && (buffer || nbytes == 0));
 
@@ -341,6 +478,14 @@ static ssize_t part_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
           return -ENXIO;
         }
 
+      /* Wait for any erase of the partition in progress */
+
+      ret = part_bgwait(priv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       /* Just add the partition offset to the requested block and let the
        * underlying MTD driver perform the read.
        */
@@ -364,6 +509,7 @@ static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes
 {
   FAR struct mtd_partition_s *priv = (FAR struct mtd_partition_s *)dev;
   off_t newoffset;
+  int ret;
 
   DEBUGASSERT(priv && (buffer || nbytes == 0));
 
@@ -379,6 +525,14 @@ static ssize_t part_write(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes
           return -ENXIO;
         }
 
+      /* Wait for any erase of the partition in progress */
+
+      ret = part_bgwait(priv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       /* Just add the partition offset to the requested block and let the
        * underlying MTD driver perform the write.
        */
@@ -450,17 +604,26 @@ static int part_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         {
           /* Erase the entire partition */
 
-          ret = priv->parent->erase(priv->parent,
-                                    priv->firstblock / priv->blkpererase,
-                                    priv->neraseblocks);
+          ret = part_erase(dev, 0, priv->neraseblocks);
+          if (ret > 0)
+            {
+              ret = OK;
+            }
         }
         break;
 
       default:
         {
-          /* Pass any unhandled ioctl() calls to the underlying driver */
+          /* Pass any unhandled ioctl() calls to the underlying driver once
+           * any erase of the partition has completed.  BIOC_FLUSH thus
+           * waits for the erase and returns the result of a failed erase.
+           */
 
-          ret = priv->parent->ioctl(priv->parent, cmd, arg);
+          ret = part_bgwait(priv);
+          if (ret >= 0)
+            {
+              ret = priv->parent->ioctl(priv->parent, cmd, arg);
+            }
         }
         break;
     }
@@ -859,6 +1022,13 @@ FAR struct mtd_dev_s *mtd_partition(FAR struct mtd_dev_s *mtd, off_t firstblock,
   part->blocksize    = geo.blocksize;
   part->blkpererase  = blkpererase;
 
+#ifdef CONFIG_MTD_PARTITION_BGERASE
+  /* This semaphore is taken by the submitter and given by the worker */
+
+  sem_init(&part->bgsem, 0, 1);
+  sem_setprotocol(&part->bgsem, SEM_PRIO_NONE);
+#endif
+
 #ifdef CONFIG_MTD_PARTITION_NAMES
   part->name         = NULL;
 #endif
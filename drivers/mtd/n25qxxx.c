@@ -276,6 +276,10 @@ struct n25qxxx_dev_s
   FAR uint8_t           *cmdbuf;      /* Allocated command buffer */
   FAR uint8_t           *readbuf;     /* Allocated status read buffer */
 
+#ifdef CONFIG_N25QXXX_XIP
+  FAR const uint8_t     *xipbase;     /* Memory-mapped window (NULL if none) */
+#endif
+
 #ifdef CONFIG_N25QXXX_SECTOR512
   uint8_t                flags;       /* Buffered sector flags */
   uint16_t               esectno;     /* Erase sector number in the cache */
@@ -289,8 +293,11 @@ struct n25qxxx_dev_s
 
 /* Locking */
 
-static void n25qxxx_lock(FAR struct qspi_dev_s *qspi);
-static inline void n25qxxx_unlock(FAR struct qspi_dev_s *qspi);
+static void n25qxxx_lock(FAR struct n25qxxx_dev_s *priv);
+static void n25qxxx_unlock(FAR struct n25qxxx_dev_s *priv);
+#ifdef CONFIG_N25QXXX_XIP
+static void n25qxxx_memmap(FAR struct n25qxxx_dev_s *priv);
+#endif
 
 /* Low-level message helpers */
 
@@ -349,8 +356,10 @@ static int  n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
  * Name: n25qxxx_lock
  ************************************************************************************/
 
-static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
+static void n25qxxx_lock(FAR struct n25qxxx_dev_s *priv)
 {
+  FAR struct qspi_dev_s *qspi = priv->qspi;
+
   /* On QuadSPI buses where there are multiple devices, it will be necessary to
    * lock QuadSPI to have exclusive access to the buses for a sequence of
    * transfers.  The bus should be locked before the chip is selected.
@@ -368,6 +377,15 @@ static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
    * an incompatible state.
    */
 
+#ifdef CONFIG_N25QXXX_XIP
+  /* Commands cannot be issued while the QuadSPI is memory-mapped */
+
+  if (priv->xipbase != NULL)
+    {
+      (void)QSPI_MEMMAP(qspi, NULL);
+    }
+#endif
+
   QSPI_SETMODE(qspi, CONFIG_N25QXXX_QSPIMODE);
   QSPI_SETBITS(qspi, 8);
   (void)QSPI_SETFREQUENCY(qspi, CONFIG_N25QXXX_QSPI_FREQUENCY);
@@ -377,10 +395,47 @@ static void n25qxxx_lock(FAR struct qspi_dev_s *qspi)
  * Name: n25qxxx_unlock
  ************************************************************************************/
 
-static inline void n25qxxx_unlock(FAR struct qspi_dev_s *qspi)
+static void n25qxxx_unlock(FAR struct n25qxxx_dev_s *priv)
+{
+#ifdef CONFIG_N25QXXX_XIP
+  /* Return to memory-mapped reads */
+
+  if (priv->xipbase != NULL)
+    {
+      n25qxxx_memmap(priv);
+    }
+#endif
+
+  (void)QSPI_LOCK(priv->qspi, false);
+}
+
+/************************************************************************************
+ * Name: n25qxxx_memmap
+ *
+ * Description:
+ *   Put the QuadSPI into memory-mapped mode using the same Quad I/O fast read
+ *   as n25qxxx_read_byte().  The bus must be locked.  Sets priv->xipbase to the
+ *   memory-mapped window, or to NULL if the controller cannot do this.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_N25QXXX_XIP
+static void n25qxxx_memmap(FAR struct n25qxxx_dev_s *priv)
 {
-  (void)QSPI_LOCK(qspi, false);
+  struct qspi_meminfo_s meminfo;
+
+  meminfo.flags   = QSPIMEM_READ | QSPIMEM_QUADIO;
+  meminfo.addrlen = 3;
+  meminfo.dummies = CONFIG_N25QXXX_DUMMIES;
+  meminfo.buflen  = 0;
+  meminfo.cmd     = N25QXXX_FAST_READ_QUADIO;
+  meminfo.addr    = 0;
+  meminfo.key     = 0;
+  meminfo.buffer  = NULL;
+
+  priv->xipbase = (FAR const uint8_t *)QSPI_MEMMAP(priv->qspi, &meminfo);
 }
+#endif
 
 /************************************************************************************
  * Name: n25qxxx_command
@@ -556,7 +611,7 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
 {
   /* Lock the QuadSPI bus and configure the bus. */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
   /* Read the JEDEC ID */
 
@@ -564,7 +619,7 @@ static inline int n25qxxx_readid(struct n25qxxx_dev_s *priv)
 
   /* Unlock the bus */
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   finfo("Manufacturer: %02x Device Type %02x, Capacity: %02x\n",
         priv->cmdbuf[0], priv->cmdbuf[1], priv->cmdbuf[2]);
@@ -1164,7 +1219,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
 
   /* Lock access to the SPI bus until we complete the erase */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
   while (blocksleft-- > 0)
     {
@@ -1188,7 +1243,7 @@ static int n25qxxx_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nbl
     }
 #endif
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   return (int)nblocks;
 }
@@ -1242,7 +1297,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
 
   /* Lock the QuadSPI bus and write all of the pages to FLASH */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
 
 #if defined(CONFIG_N25QXXX_SECTOR512)
   ret = n25qxxx_write_cache(priv, buffer, startblock, nblocks);
@@ -1260,7 +1315,7 @@ static ssize_t n25qxxx_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
     }
 #endif
 
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   return ret < 0 ? ret : nblocks;
 }
@@ -1277,11 +1332,25 @@ static ssize_t n25qxxx_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbyt
 
   finfo("offset: %08lx nbytes: %d\n", (long)offset, (int)nbytes);
 
+#ifdef CONFIG_N25QXXX_XIP
+  if (priv->xipbase != NULL)
+    {
+      /* Copy from the memory-mapped window.  Holding the bus lock keeps it
+       * mapped.
+       */
+
+      (void)QSPI_LOCK(priv->qspi, true);
+      memcpy(buffer, priv->xipbase + offset, nbytes);
+      (void)QSPI_LOCK(priv->qspi, false);
+      return (ssize_t)nbytes;
+    }
+#endif
+
   /* Lock the QuadSPI bus and select this FLASH part */
 
-  n25qxxx_lock(priv->qspi);
+  n25qxxx_lock(priv);
   ret = n25qxxx_read_byte(priv, buffer, offset, nbytes);
-  n25qxxx_unlock(priv->qspi);
+  n25qxxx_unlock(priv);
 
   if (ret < 0)
     {
@@ -1343,9 +1412,9 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         {
           /* Erase the entire device */
 
-          n25qxxx_lock(priv->qspi);
+          n25qxxx_lock(priv);
           ret = n25qxxx_erase_chip(priv);
-          n25qxxx_unlock(priv->qspi);
+          n25qxxx_unlock(priv);
         }
         break;
 
@@ -1369,6 +1438,22 @@ static int n25qxxx_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_N25QXXX_XIP
+      case MTDIOC_XIPBASE:
+        {
+          FAR void **ppv = (FAR void**)arg;
+
+          /* Only valid while nothing writes to the FLASH */
+
+          if (ppv != NULL && priv->xipbase != NULL)
+            {
+              *ppv = (FAR void *)priv->xipbase;
+              ret  = OK;
+            }
+        }
+        break;
+#endif
+
       default:
         ret = -ENOTTY; /* Bad/unsupported command */
         break;
@@ -1485,6 +1570,19 @@ FAR struct mtd_dev_s *n25qxxx_initialize(FAR struct qspi_dev_s *qspi, bool unpro
           goto errout_with_readbuf;
         }
 #endif
+
+#ifdef CONFIG_N25QXXX_XIP
+      /* Switch to memory-mapped reads if the QuadSPI supports them */
+
+      (void)QSPI_LOCK(qspi, true);
+      n25qxxx_memmap(priv);
+      (void)QSPI_LOCK(qspi, false);
+
+      if (priv->xipbase == NULL)
+        {
+          fwarn("WARNING: QuadSPI does not support memory-mapped reads\n");
+        }
+#endif
     }
 
 #ifdef CONFIG_MTD_REGISTRATION
@@ -0,0 +1,1250 @@
+/****************************************************************************
+ * drivers/mtd/nftl.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * The NAND flash translation layer (NFTL) maps logical sectors onto NAND
+ * pages without ever rewriting a page in place:
+ *
+ * - Every write goes to the next free page of the one "open" erase block.
+ *   The logical-to-physical page map is held in RAM.
+ * - The last page of each erase block holds a summary: a sequence number,
+ *   the erase count and the logical sector of every data page.  The
+ *   summary is written when the block fills (or on BIOC_FLUSH or close)
+ *   and only then are the pages of the block "committed".
+ * - On initialization, the map is rebuilt from the summaries; where a
+ *   sector appears more than once, the copy in the block with the highest
+ *   sequence number wins.  Blocks without a valid summary only hold
+ *   uncommitted data and are erased.
+ * - Garbage collection relocates the live pages of the block with the
+ *   fewest live pages (or, to level wear, of the least erased block) into
+ *   the open block.  The victim is erased only after the block that
+ *   received its pages has been committed, so a power loss at any point
+ *   leaves the most recently committed copy of every sector intact.
+ * - Free blocks are allocated least-erased first.  Blocks that fail to
+ *   erase, or that the MTD driver reports as bad, are never used again.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <crc32.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+#ifdef CONFIG_MTD_NFTL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_MTD_NFTL_NRESERVED
+#  define CONFIG_MTD_NFTL_NRESERVED 8
+#endif
+
+#ifndef CONFIG_MTD_NFTL_WLTHRESHOLD
+#  define CONFIG_MTD_NFTL_WLTHRESHOLD 64
+#endif
+
+/* Garbage collection runs when no more than this number of erase blocks
+ * are free (or about to be freed) as a new block is opened.  Relocating
+ * one victim may span two open blocks, so this must be at least two.
+ */
+
+#define NFTL_GCRESERVE     2
+
+#if CONFIG_MTD_NFTL_NRESERVED <= NFTL_GCRESERVE
+#  error CONFIG_MTD_NFTL_NRESERVED is too small
+#endif
+
+#define NFTL_MAGIC         0x4c54464e /* "NFTL" */
+#define NFTL_UNMAPPED      0xffffffff
+
+/* Erase block states */
+
+#define NFTL_BLOCK_FREE    0          /* Erased and available */
+#define NFTL_BLOCK_OPEN    1          /* Receiving writes, not committed */
+#define NFTL_BLOCK_CLOSED  2          /* Summary written */
+#define NFTL_BLOCK_STALE   3          /* No live data, erase when safe */
+#define NFTL_BLOCK_BAD     4          /* Never used */
+
+/* Size of a summary describing 'n' data pages */
+
+#define SIZEOF_NFTL_SUMMARY(n) \
+  (sizeof(struct nftl_summary_s) + ((n) - 1) * sizeof(uint32_t))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The summary held in the last page of every committed erase block */
+
+struct nftl_summary_s
+{
+  uint32_t magic;                /* NFTL_MAGIC */
+  uint32_t crc;                  /* CRC32 of the following fields */
+  uint32_t seqno;                /* Order in which blocks were committed */
+  uint32_t erasecount;           /* Times this block has been erased */
+  uint32_t npages;               /* Number of data pages described */
+  uint32_t lsector[1];           /* Logical sector of each data page */
+};
+
+/* RAM state of one erase block */
+
+struct nftl_block_s
+{
+  uint32_t erasecount;           /* Times this block has been erased */
+  uint16_t nlive;                /* Number of pages holding live data */
+  uint8_t  state;                /* See NFTL_BLOCK_* definitions */
+};
+
+struct nftl_dev_s
+{
+  FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
+  struct mtd_geometry_s geo;     /* Device geometry */
+  sem_t    exclsem;              /* Mutually exclusive access */
+  bool     ingc;                 /* Garbage collection in progress */
+  uint16_t ppb;                  /* Pages per erase block */
+  uint16_t ndata;                /* Data pages per erase block */
+  uint16_t openpage;             /* Next free page of the open block */
+  uint32_t openblock;            /* Open block or NFTL_UNMAPPED */
+  uint32_t nsectors;             /* Number of logical sectors */
+  uint32_t seqno;                /* Sequence number of the next commit */
+  uint32_t nfree;                /* Number of free erase blocks */
+  uint32_t nstale;               /* Number of stale erase blocks */
+  FAR uint32_t *map;             /* Logical sector to physical page */
+  FAR struct nftl_block_s *blocks;  /* State of each erase block */
+  FAR struct nftl_summary_s *summary;  /* Summary of the open block */
+  FAR struct nftl_summary_s *vsummary; /* Summary of the GC victim */
+  FAR uint8_t *buffer;           /* One page used for relocation */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    nftl_semtake(FAR struct nftl_dev_s *dev);
+#define        nftl_semgive(d) sem_post(&(d)->exclsem)
+static uint32_t nftl_checksum(FAR const struct nftl_summary_s *summary,
+                 uint16_t ndata);
+static bool    nftl_erased(FAR const uint8_t *buffer, size_t size);
+static void    nftl_markbad(FAR struct nftl_dev_s *dev, uint32_t block);
+static void    nftl_erasestale(FAR struct nftl_dev_s *dev);
+static int     nftl_allocblock(FAR struct nftl_dev_s *dev);
+static int     nftl_commit(FAR struct nftl_dev_s *dev);
+static int     nftl_writepage(FAR struct nftl_dev_s *dev, uint32_t lsector,
+                 FAR const uint8_t *buffer);
+static int     nftl_victim(FAR struct nftl_dev_s *dev, bool wear);
+static int     nftl_relocate(FAR struct nftl_dev_s *dev, uint32_t victim);
+static int     nftl_gc(FAR struct nftl_dev_s *dev);
+static int     nftl_scan(FAR struct nftl_dev_s *dev);
+
+static int     nftl_open(FAR struct inode *inode);
+static int     nftl_close(FAR struct inode *inode);
+static ssize_t nftl_read(FAR struct inode *inode, unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+static ssize_t nftl_write(FAR struct inode *inode,
+                 const unsigned char *buffer, size_t start_sector,
+                 unsigned int nsectors);
+static int     nftl_geometry(FAR struct inode *inode,
+                 struct geometry *geometry);
+static int     nftl_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bops =
+{
+  nftl_open,     /* open     */
+  nftl_close,    /* close    */
+  nftl_read,     /* read     */
+  nftl_write,    /* write    */
+  nftl_geometry, /* geometry */
+  nftl_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0            /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nftl_semtake
+ ****************************************************************************/
+
+static void nftl_semtake(FAR struct nftl_dev_s *dev)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: nftl_checksum
+ *
+ * Description:
+ *   Return the CRC32 of a summary, covering everything after the crc
+ *   field.
+ *
+ ****************************************************************************/
+
+static uint32_t nftl_checksum(FAR const struct nftl_summary_s *summary,
+                              uint16_t ndata)
+{
+  return crc32((FAR const uint8_t *)&summary->seqno,
+               SIZEOF_NFTL_SUMMARY(ndata) -
+               offsetof(struct nftl_summary_s, seqno));
+}
+
+/****************************************************************************
+ * Name: nftl_erased
+ *
+ * Description:
+ *   Return true if a page buffer holds nothing but the erased value.
+ *
+ ****************************************************************************/
+
+static bool nftl_erased(FAR const uint8_t *buffer, size_t size)
+{
+  while (size-- > 0)
+    {
+      if (*buffer++ != 0xff)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: nftl_markbad
+ *
+ * Description:
+ *   Retire an erase block.  The MTD driver is asked to record the bad
+ *   block on the media, if it can, so that it is skipped on the next scan.
+ *
+ ****************************************************************************/
+
+static void nftl_markbad(FAR struct nftl_dev_s *dev, uint32_t block)
+{
+  ferr("ERROR: Retiring erase block %lu\n", (unsigned long)block);
+
+  dev->blocks[block].state = NFTL_BLOCK_BAD;
+  dev->blocks[block].nlive = 0;
+  (void)MTD_IOCTL(dev->mtd, MTDIOC_MARKBAD, (unsigned long)block);
+}
+
+/****************************************************************************
+ * Name: nftl_erasestale
+ *
+ * Description:
+ *   Erase all stale blocks and return them to the free pool.  This must
+ *   only be called when no uncommitted page supersedes data held in a
+ *   stale block, i.e. just after the open block has been committed (or
+ *   while scanning, when no block is open).
+ *
+ ****************************************************************************/
+
+static void nftl_erasestale(FAR struct nftl_dev_s *dev)
+{
+  FAR struct nftl_block_s *blk;
+  uint32_t block;
+  int ret;
+
+  for (block = 0; dev->nstale > 0 && block < dev->geo.neraseblocks; block++)
+    {
+      blk = &dev->blocks[block];
+      if (blk->state != NFTL_BLOCK_STALE)
+        {
+          continue;
+        }
+
+      dev->nstale--;
+
+      ret = MTD_ERASE(dev->mtd, block, 1);
+      if (ret != 1)
+        {
+          ferr("ERROR: Erase of block %lu failed: %d\n",
+               (unsigned long)block, ret);
+          nftl_markbad(dev, block);
+          continue;
+        }
+
+      blk->erasecount++;
+      blk->nlive = 0;
+      blk->state = NFTL_BLOCK_FREE;
+      dev->nfree++;
+    }
+}
+
+/****************************************************************************
+ * Name: nftl_allocblock
+ *
+ * Description:
+ *   Open the least erased free block for writing.
+ *
+ ****************************************************************************/
+
+static int nftl_allocblock(FAR struct nftl_dev_s *dev)
+{
+  FAR struct nftl_block_s *blk;
+  uint32_t best = NFTL_UNMAPPED;
+  uint32_t block;
+
+  for (block = 0; block < dev->geo.neraseblocks; block++)
+    {
+      blk = &dev->blocks[block];
+      if (blk->state == NFTL_BLOCK_FREE &&
+          (best == NFTL_UNMAPPED ||
+           blk->erasecount < dev->blocks[best].erasecount))
+        {
+          best = block;
+        }
+    }
+
+  if (best == NFTL_UNMAPPED)
+    {
+      ferr("ERROR: No free erase blocks\n");
+      return -ENOSPC;
+    }
+
+  dev->blocks[best].state = NFTL_BLOCK_OPEN;
+  dev->nfree--;
+
+  dev->openblock = best;
+  dev->openpage  = 0;
+  memset(dev->summary, 0xff, dev->geo.blocksize);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nftl_commit
+ *
+ * Description:
+ *   Write the summary of the open block, committing all of its pages, and
+ *   then reclaim any stale blocks whose data it superseded.
+ *
+ ****************************************************************************/
+
+static int nftl_commit(FAR struct nftl_dev_s *dev)
+{
+  FAR struct nftl_summary_s *summary = dev->summary;
+  FAR struct nftl_block_s *blk;
+  ssize_t nwritten;
+  int ret = OK;
+
+  if (dev->openblock == NFTL_UNMAPPED)
+    {
+      return OK;
+    }
+
+  blk                 = &dev->blocks[dev->openblock];
+  summary->magic      = NFTL_MAGIC;
+  summary->seqno      = dev->seqno++;
+  summary->erasecount = blk->erasecount;
+  summary->npages     = dev->openpage;
+  summary->crc        = nftl_checksum(summary, dev->ndata);
+
+  nwritten = MTD_BWRITE(dev->mtd,
+                        (off_t)dev->openblock * dev->ppb + dev->ndata, 1,
+                        (FAR const uint8_t *)summary);
+  if (nwritten != 1)
+    {
+      /* The data remains readable until the next scan, but it will not be
+       * found then.  Relocate the block as soon as possible.
+       */
+
+      ferr("ERROR: Summary write to block %lu failed: %d\n",
+           (unsigned long)dev->openblock, (int)nwritten);
+      ret = nwritten < 0 ? (int)nwritten : -EIO;
+    }
+
+  blk->state     = blk->nlive > 0 ? NFTL_BLOCK_CLOSED : NFTL_BLOCK_STALE;
+  if (blk->state == NFTL_BLOCK_STALE)
+    {
+      dev->nstale++;
+    }
+
+  dev->openblock = NFTL_UNMAPPED;
+  dev->openpage  = 0;
+
+  nftl_erasestale(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nftl_writepage
+ *
+ * Description:
+ *   Write one logical sector to the next free page of the open block,
+ *   opening (and garbage collecting) as needed.
+ *
+ ****************************************************************************/
+
+static int nftl_writepage(FAR struct nftl_dev_s *dev, uint32_t lsector,
+                          FAR const uint8_t *buffer)
+{
+  FAR struct nftl_block_s *blk;
+  uint32_t oldpage;
+  uint32_t page;
+  ssize_t nwritten;
+  int retries;
+  int ret;
+
+  for (retries = 0; retries < 3; retries++)
+    {
+      if (dev->openblock == NFTL_UNMAPPED)
+        {
+          /* A failure to reclaim anything only matters once there are
+           * no free blocks left at all.
+           */
+
+          if (!dev->ingc && dev->nfree <= NFTL_GCRESERVE)
+            {
+              (void)nftl_gc(dev);
+            }
+
+          /* Garbage collection may have left a block open */
+
+          if (dev->openblock == NFTL_UNMAPPED)
+            {
+              ret = nftl_allocblock(dev);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+
+      page     = dev->openblock * dev->ppb + dev->openpage;
+      nwritten = MTD_BWRITE(dev->mtd, page, 1, buffer);
+      if (nwritten == 1)
+        {
+          /* Update the map.  The previous copy becomes dead, but it stays
+           * on the media until this block has been committed.
+           */
+
+          dev->summary->lsector[dev->openpage] = lsector;
+          dev->blocks[dev->openblock].nlive++;
+
+          oldpage = dev->map[lsector];
+          dev->map[lsector] = page;
+
+          if (oldpage != NFTL_UNMAPPED)
+            {
+              blk = &dev->blocks[oldpage / dev->ppb];
+              DEBUGASSERT(blk->nlive > 0);
+
+              if (--blk->nlive == 0 && blk->state == NFTL_BLOCK_CLOSED)
+                {
+                  blk->state = NFTL_BLOCK_STALE;
+                  dev->nstale++;
+                }
+            }
+        }
+      else
+        {
+          /* Skip the failed page and try the next one */
+
+          ferr("ERROR: Write of page %lu failed: %d\n",
+               (unsigned long)page, (int)nwritten);
+        }
+
+      if (++dev->openpage >= dev->ndata)
+        {
+          (void)nftl_commit(dev);
+        }
+
+      if (nwritten == 1)
+        {
+          return OK;
+        }
+    }
+
+  return -EIO;
+}
+
+/****************************************************************************
+ * Name: nftl_victim
+ *
+ * Description:
+ *   Select a committed block to garbage collect: normally the one with the
+ *   fewest live pages.  If 'wear' is true and the least erased committed
+ *   block lags the most erased block by more than the configured
+ *   threshold, that (cold) block is selected instead so that its erase
+ *   cycles are not wasted.
+ *
+ ****************************************************************************/
+
+static int nftl_victim(FAR struct nftl_dev_s *dev, bool wear)
+{
+  FAR struct nftl_block_s *blk;
+  uint32_t maxerase = 0;
+  uint32_t coldest  = NFTL_UNMAPPED;
+  uint32_t best     = NFTL_UNMAPPED;
+  uint32_t block;
+
+  for (block = 0; block < dev->geo.neraseblocks; block++)
+    {
+      blk = &dev->blocks[block];
+      if (blk->state == NFTL_BLOCK_BAD)
+        {
+          continue;
+        }
+
+      if (blk->erasecount > maxerase)
+        {
+          maxerase = blk->erasecount;
+        }
+
+      if (blk->state != NFTL_BLOCK_CLOSED)
+        {
+          continue;
+        }
+
+      if (best == NFTL_UNMAPPED || blk->nlive < dev->blocks[best].nlive)
+        {
+          best = block;
+        }
+
+      if (coldest == NFTL_UNMAPPED ||
+          blk->erasecount < dev->blocks[coldest].erasecount)
+        {
+          coldest = block;
+        }
+    }
+
+  if (wear && coldest != NFTL_UNMAPPED &&
+      maxerase - dev->blocks[coldest].erasecount >
+      CONFIG_MTD_NFTL_WLTHRESHOLD)
+    {
+      finfo("Wear leveling block %lu\n", (unsigned long)coldest);
+      return (int)coldest;
+    }
+
+  /* Relocating a block without dead pages reclaims nothing */
+
+  if (best == NFTL_UNMAPPED || dev->blocks[best].nlive >= dev->ndata)
+    {
+      return -ENOSPC;
+    }
+
+  return (int)best;
+}
+
+/****************************************************************************
+ * Name: nftl_relocate
+ *
+ * Description:
+ *   Copy the live pages of a committed block to the open block and mark
+ *   the block stale.
+ *
+ ****************************************************************************/
+
+static int nftl_relocate(FAR struct nftl_dev_s *dev, uint32_t victim)
+{
+  FAR struct nftl_summary_s *summary = dev->vsummary;
+  FAR uint32_t *lsectors = NULL;
+  uint32_t first = victim * dev->ppb;
+  uint32_t lsector;
+  uint32_t page;
+  ssize_t nread;
+  int ret;
+
+  /* Find the logical sector of each page from the summary of the victim.
+   * If the summary cannot be read, search the map instead.
+   */
+
+  nread = MTD_BREAD(dev->mtd, first + dev->ndata, 1,
+                    (FAR uint8_t *)summary);
+  if (nread == 1 && summary->magic == NFTL_MAGIC &&
+      summary->npages <= dev->ndata &&
+      summary->crc == nftl_checksum(summary, dev->ndata))
+    {
+      lsectors = summary->lsector;
+    }
+  else
+    {
+      ferr("ERROR: Block %lu has no summary\n", (unsigned long)victim);
+    }
+
+  for (page = 0; page < dev->ndata; page++)
+    {
+      if (lsectors != NULL)
+        {
+          lsector = lsectors[page];
+          if (lsector >= dev->nsectors || dev->map[lsector] != first + page)
+            {
+              continue;
+            }
+        }
+      else
+        {
+          for (lsector = 0; lsector < dev->nsectors; lsector++)
+            {
+              if (dev->map[lsector] == first + page)
+                {
+                  break;
+                }
+            }
+
+          if (lsector >= dev->nsectors)
+            {
+              continue;
+            }
+        }
+
+      nread = MTD_BREAD(dev->mtd, first + page, 1, dev->buffer);
+      if (nread != 1)
+        {
+          /* The data is lost either way.  Drop the sector rather than
+           * stalling reclamation of the block.
+           */
+
+          ferr("ERROR: Lost sector %lu: %d\n",
+               (unsigned long)lsector, (int)nread);
+
+          dev->map[lsector] = NFTL_UNMAPPED;
+          dev->blocks[victim].nlive--;
+          continue;
+        }
+
+      ret = nftl_writepage(dev, lsector, dev->buffer);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* The block is erased after the pages copied from it are committed */
+
+  DEBUGASSERT(dev->blocks[victim].nlive == 0);
+  if (dev->blocks[victim].state == NFTL_BLOCK_CLOSED)
+    {
+      dev->blocks[victim].state = NFTL_BLOCK_STALE;
+      dev->nstale++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nftl_gc
+ *
+ * Description:
+ *   Relocate committed blocks until enough blocks are free or waiting to
+ *   be erased.
+ *
+ ****************************************************************************/
+
+static int nftl_gc(FAR struct nftl_dev_s *dev)
+{
+  bool wear = true;
+  int victim;
+  int ret = OK;
+
+  dev->ingc = true;
+  while (dev->nfree + dev->nstale <= NFTL_GCRESERVE)
+    {
+      victim = nftl_victim(dev, wear);
+      if (victim < 0)
+        {
+          ret = victim;
+          break;
+        }
+
+      ret = nftl_relocate(dev, (uint32_t)victim);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      wear = false;
+    }
+
+  dev->ingc = false;
+
+  /* Reclaim stale blocks now if there is no open block to commit */
+
+  if (dev->openblock == NFTL_UNMAPPED)
+    {
+      nftl_erasestale(dev);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nftl_scan
+ *
+ * Description:
+ *   Rebuild the map and the block states from the media.
+ *
+ ****************************************************************************/
+
+static int nftl_scan(FAR struct nftl_dev_s *dev)
+{
+  FAR struct nftl_summary_s *summary = dev->summary;
+  FAR struct nftl_block_s *blk;
+  FAR uint32_t *seqnos;
+  uint64_t erasesum = 0;
+  uint32_t nclosed = 0;
+  uint32_t lsector;
+  uint32_t block;
+  uint32_t page;
+  uint32_t old;
+  ssize_t nsum;
+  ssize_t nread;
+
+  seqnos = (FAR uint32_t *)
+           kmm_malloc(dev->geo.neraseblocks * sizeof(uint32_t));
+  if (seqnos == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(dev->map, 0xff, dev->nsectors * sizeof(uint32_t));
+  dev->seqno = 0;
+  dev->nfree = 0;
+  dev->nstale = 0;
+
+  for (block = 0; block < dev->geo.neraseblocks; block++)
+    {
+      blk = &dev->blocks[block];
+      blk->erasecount = 0;
+      blk->nlive = 0;
+
+      if (MTD_IOCTL(dev->mtd, MTDIOC_ISBAD, (unsigned long)block) > 0)
+        {
+          blk->state = NFTL_BLOCK_BAD;
+          continue;
+        }
+
+      nsum = MTD_BREAD(dev->mtd, block * dev->ppb + dev->ndata, 1,
+                       (FAR uint8_t *)summary);
+      if (nsum == 1 && summary->magic == NFTL_MAGIC &&
+          summary->npages <= dev->ndata &&
+          summary->crc == nftl_checksum(summary, dev->ndata))
+        {
+          /* A committed block.  The newest copy of each sector wins; within
+           * one block, the later page is the newer.
+           */
+
+          blk->state      = NFTL_BLOCK_CLOSED;
+          blk->erasecount = summary->erasecount;
+          seqnos[block]   = summary->seqno;
+
+          if (summary->seqno >= dev->seqno)
+            {
+              dev->seqno = summary->seqno + 1;
+            }
+
+          for (page = 0; page < summary->npages; page++)
+            {
+              lsector = summary->lsector[page];
+              if (lsector >= dev->nsectors)
+                {
+                  continue;
+                }
+
+              old = dev->map[lsector];
+              if (old == NFTL_UNMAPPED ||
+                  seqnos[old / dev->ppb] <= summary->seqno)
+                {
+                  dev->map[lsector] = block * dev->ppb + page;
+                }
+            }
+
+          erasesum += blk->erasecount;
+          nclosed++;
+          continue;
+        }
+
+      /* Not committed.  Either erased or holding data written before a
+       * power loss; pages are written in order, so the first page tells.
+       */
+
+      nread = MTD_BREAD(dev->mtd, block * dev->ppb, 1, dev->buffer);
+      if (nsum == 1 && nread == 1 &&
+          nftl_erased(dev->buffer, dev->geo.blocksize) &&
+          nftl_erased((FAR const uint8_t *)summary, dev->geo.blocksize))
+        {
+          blk->state = NFTL_BLOCK_FREE;
+          dev->nfree++;
+        }
+      else
+        {
+          blk->state = NFTL_BLOCK_STALE;
+          dev->nstale++;
+        }
+    }
+
+  kmm_free(seqnos);
+
+  /* Count live pages.  Committed blocks left without any are stale. */
+
+  for (lsector = 0; lsector < dev->nsectors; lsector++)
+    {
+      if (dev->map[lsector] != NFTL_UNMAPPED)
+        {
+          dev->blocks[dev->map[lsector] / dev->ppb].nlive++;
+        }
+    }
+
+  for (block = 0; block < dev->geo.neraseblocks; block++)
+    {
+      blk = &dev->blocks[block];
+      if (blk->state == NFTL_BLOCK_CLOSED && blk->nlive == 0)
+        {
+          blk->state = NFTL_BLOCK_STALE;
+          dev->nstale++;
+        }
+
+      /* Erase counts of uncommitted blocks are lost; assume the average */
+
+      else if (blk->state != NFTL_BLOCK_CLOSED && nclosed > 0)
+        {
+          blk->erasecount = (uint32_t)(erasesum / nclosed);
+        }
+    }
+
+  nftl_erasestale(dev);
+
+  finfo("free: %lu seqno: %lu\n",
+        (unsigned long)dev->nfree, (unsigned long)dev->seqno);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nftl_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int nftl_open(FAR struct inode *inode)
+{
+  finfo("Entry\n");
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nftl_close
+ *
+ * Description: Close the block device, committing the open block
+ *
+ ****************************************************************************/
+
+static int nftl_close(FAR struct inode *inode)
+{
+  FAR struct nftl_dev_s *dev;
+  int ret;
+
+  finfo("Entry\n");
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct nftl_dev_s *)inode->i_private;
+
+  nftl_semtake(dev);
+  ret = nftl_commit(dev);
+  nftl_semgive(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nftl_read
+ *
+ * Description:  Read the specified numer of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t nftl_read(FAR struct inode *inode, unsigned char *buffer,
+                         size_t start_sector, unsigned int nsectors)
+{
+  FAR struct nftl_dev_s *dev;
+  size_t sector = start_sector;
+  size_t end = start_sector + nsectors;
+  uint32_t page;
+  size_t nrun;
+  ssize_t nread;
+
+  finfo("sector: %d nsectors: %d\n", (int)start_sector, nsectors);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct nftl_dev_s *)inode->i_private;
+
+  if (end > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nftl_semtake(dev);
+  while (sector < end)
+    {
+      page = dev->map[sector];
+      if (page == NFTL_UNMAPPED)
+        {
+          /* Never written */
+
+          memset(buffer, 0xff, dev->geo.blocksize);
+          nrun = 1;
+        }
+      else
+        {
+          /* Read physically contiguous sectors together */
+
+          nrun = 1;
+          while (sector + nrun < end &&
+                 dev->map[sector + nrun] == page + nrun)
+            {
+              nrun++;
+            }
+
+          nread = MTD_BREAD(dev->mtd, page, nrun, buffer);
+          if (nread != (ssize_t)nrun)
+            {
+              ferr("ERROR: Read %d pages from %lu failed: %d\n",
+                   (int)nrun, (unsigned long)page, (int)nread);
+              nftl_semgive(dev);
+              return nread < 0 ? nread : -EIO;
+            }
+        }
+
+      sector += nrun;
+      buffer += nrun * dev->geo.blocksize;
+    }
+
+  nftl_semgive(dev);
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: nftl_write
+ *
+ * Description: Write (or buffer) the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t nftl_write(FAR struct inode *inode,
+                          const unsigned char *buffer, size_t start_sector,
+                          unsigned int nsectors)
+{
+  FAR struct nftl_dev_s *dev;
+  unsigned int i;
+  int ret;
+
+  finfo("sector: %d nsectors: %d\n", (int)start_sector, nsectors);
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct nftl_dev_s *)inode->i_private;
+
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  nftl_semtake(dev);
+  for (i = 0; i < nsectors; i++)
+    {
+      ret = nftl_writepage(dev, start_sector + i, buffer);
+      if (ret < 0)
+        {
+          nftl_semgive(dev);
+          return ret;
+        }
+
+      buffer += dev->geo.blocksize;
+    }
+
+  nftl_semgive(dev);
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: nftl_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int nftl_geometry(FAR struct inode *inode, struct geometry *geometry)
+{
+  FAR struct nftl_dev_s *dev;
+
+  finfo("Entry\n");
+
+  DEBUGASSERT(inode && inode->i_private);
+  if (geometry)
+    {
+      dev = (FAR struct nftl_dev_s *)inode->i_private;
+      geometry->geo_available     = true;
+      geometry->geo_mediachanged  = false;
+      geometry->geo_writeenabled  = true;
+      geometry->geo_nsectors      = dev->nsectors;
+      geometry->geo_sectorsize    = dev->geo.blocksize;
+
+      finfo("nsectors: %d sectorsize: %d\n",
+            geometry->geo_nsectors, geometry->geo_sectorsize);
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: nftl_ioctl
+ *
+ * Description: Pass harmless commands through to the MTD driver
+ *
+ ****************************************************************************/
+
+static int nftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct nftl_dev_s *dev;
+  int ret;
+
+  finfo("Entry\n");
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct nftl_dev_s *)inode->i_private;
+
+  /* Erasing or remapping the media underneath the translation layer
+   * would corrupt it.  Only pass through commands that do neither.
+   */
+
+  switch (cmd)
+    {
+      case BIOC_FLUSH:
+        nftl_semtake(dev);
+        ret = nftl_commit(dev);
+        nftl_semgive(dev);
+        break;
+
+      case MTDIOC_GEOMETRY:
+      case MTDIOC_SETSPEED:
+        ret = MTD_IOCTL(dev->mtd, cmd, arg);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nftl_initialize
+ *
+ * Description:
+ *   Initialize a log-structured NAND flash translation layer on top of an
+ *   MTD interface and register it as a block driver.
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The block device will be
+ *      registered as as /dev/nftlN where N is the minor number.
+ *   mtd - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+int nftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
+{
+  FAR struct nftl_dev_s *dev;
+  char devname[16];
+  int ret;
+
+  /* Sanity check */
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (minor < 0 || minor > 255 || !mtd)
+    {
+      return -EINVAL;
+    }
+#endif
+
+  /* Allocate a NFTL device structure */
+
+  dev = (FAR struct nftl_dev_s *)kmm_zalloc(sizeof(struct nftl_dev_s));
+  if (!dev)
+    {
+      return -ENOMEM;
+    }
+
+  dev->mtd       = mtd;
+  dev->openblock = NFTL_UNMAPPED;
+  sem_init(&dev->exclsem, 0, 1);
+
+  /* Get the device geometry. (casting to uintptr_t first eliminates
+   * complaints on some architectures where the sizeof long is different
+   * from the size of a pointer).
+   */
+
+  ret = MTD_IOCTL(mtd, MTDIOC_GEOMETRY,
+                  (unsigned long)((uintptr_t)&dev->geo));
+  if (ret < 0)
+    {
+      ferr("ERROR: MTD ioctl(MTDIOC_GEOMETRY) failed: %d\n", ret);
+      goto errout_with_dev;
+    }
+
+  /* The last page of each erase block holds its summary, which must fit
+   * in one page.  The capacity leaves room for garbage collection and for
+   * blocks going bad.
+   */
+
+  ret = -EINVAL;
+  dev->ppb   = dev->geo.erasesize / dev->geo.blocksize;
+  dev->ndata = dev->ppb - 1;
+
+  if (dev->ppb < 2 || SIZEOF_NFTL_SUMMARY(dev->ndata) > dev->geo.blocksize ||
+      dev->geo.neraseblocks <= CONFIG_MTD_NFTL_NRESERVED)
+    {
+      ferr("ERROR: Unsupported geometry\n");
+      goto errout_with_dev;
+    }
+
+  dev->nsectors = (dev->geo.neraseblocks - CONFIG_MTD_NFTL_NRESERVED) *
+                  dev->ndata;
+
+  /* Allocate the map and the working buffers */
+
+  ret         = -ENOMEM;
+  dev->map    = (FAR uint32_t *)
+                kmm_malloc(dev->nsectors * sizeof(uint32_t));
+  dev->blocks = (FAR struct nftl_block_s *)
+                kmm_malloc(dev->geo.neraseblocks *
+                           sizeof(struct nftl_block_s));
+  dev->summary = (FAR struct nftl_summary_s *)
+                 kmm_malloc(dev->geo.blocksize);
+  dev->vsummary = (FAR struct nftl_summary_s *)
+                  kmm_malloc(dev->geo.blocksize);
+  dev->buffer = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+
+  if (!dev->map || !dev->blocks || !dev->summary || !dev->vsummary ||
+      !dev->buffer)
+    {
+      ferr("ERROR: Failed to allocate the map\n");
+      goto errout_with_buffers;
+    }
+
+  /* Rebuild the map from the media */
+
+  ret = nftl_scan(dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: nftl_scan failed: %d\n", ret);
+      goto errout_with_buffers;
+    }
+
+  /* Create a MTD block device name */
+
+  snprintf(devname, 16, "/dev/nftl%d", minor);
+
+  /* Inode private data is a reference to the NFTL device structure */
+
+  ret = register_blockdriver(devname, &g_bops, 0, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_blockdriver failed: %d\n", -ret);
+      goto errout_with_buffers;
+    }
+
+  return OK;
+
+errout_with_buffers:
+  if (dev->buffer)
+    {
+      kmm_free(dev->buffer);
+    }
+
+  if (dev->vsummary)
+    {
+      kmm_free(dev->vsummary);
+    }
+
+  if (dev->summary)
+    {
+      kmm_free(dev->summary);
+    }
+
+  if (dev->blocks)
+    {
+      kmm_free(dev->blocks);
+    }
+
+  if (dev->map)
+    {
+      kmm_free(dev->map);
+    }
+
+errout_with_dev:
+  sem_destroy(&dev->exclsem);
+  kmm_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_MTD_NFTL */
@@ -51,6 +51,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
+#include <semaphore.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -58,6 +59,8 @@
 #include <crc16.h>
 #include <crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -130,6 +133,18 @@
 #  define  CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+/* Without the background garbage collector, there is no concurrent access
+ * to serialize.
+ */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  define smart_semgive(d)    sem_post(&(d)->exclsem)
+#else
+#  define smart_semtake(d)
+#  define smart_semgive(d)
+#  define smart_bggc_kick(d)
+#endif
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
@@ -265,6 +280,16 @@ struct smart_struct_s
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  uint32_t              ckptblock;        /* First erase block of the checkpoint */
+  uint16_t              ckptblocks;       /* Erase blocks reserved for the checkpoint */
+  uint8_t               ckptstate;        /* See SMART_CKPT_* definitions */
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  sem_t                 exclsem;          /* Serializes callers and the GC worker */
+  struct work_s         gcwork;           /* Background garbage collection work */
+  systime_t             lastaccess;       /* Time of the last device access */
+#endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
@@ -277,6 +302,36 @@ struct smart_struct_s
 #define SMART_WEARFLAGS_FORCE_REORG    0x01
 #define SMART_WEARFLAGS_WRITE_NEEDED   0x02
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* Sector map checkpoint.  This header is written at the start of the first
+ * reserved erase block (in its own MTD block) after the payload has been
+ * written.  The payload follows in the next MTD block and consists of the
+ * freecount and releasecount arrays followed by a physical to logical
+ * sector table (0xffff = physical sector does not hold a live sector).
+ */
+
+#define SMART_CKPT_NONE       0    /* No usable checkpoint on the device */
+#define SMART_CKPT_STALE      1    /* Checkpoint is older than the volume */
+#define SMART_CKPT_CLEAN      2    /* Checkpoint matches the volume */
+
+#define SMART_CKPT_VERSION    1
+
+struct smart_ckpt_s
+{
+  uint8_t               magic[4];         /* "SMCP" */
+  uint8_t               version;          /* Checkpoint layout version */
+  uint8_t               state;            /* Erased state:  Valid
+                                           * Otherwise:     Stale */
+  uint16_t              sectorsize;       /* Sector size of the volume */
+  uint16_t              totalsectors;     /* Total sectors on the volume */
+  uint16_t              neraseblocks;     /* Erase blocks on the volume */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint32_t              length;           /* Length of the payload */
+  uint32_t              crc;              /* CRC-32 of the payload */
+};
+#endif
+
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 struct smart_multiroot_device_s
 {
@@ -388,6 +443,20 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_semtake(FAR struct smart_struct_s *dev);
+static void smart_bggc_kick(FAR struct smart_struct_s *dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_invalidate(FAR struct smart_struct_s *dev);
+static int smart_ckpt_write(FAR struct smart_struct_s *dev);
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static uint16_t smart_ckpt_lookup(FAR struct smart_struct_s *dev,
+                 uint16_t logical);
+#endif
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -433,6 +502,30 @@ static const struct file_operations g_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: smart_semtake
+ *
+ * Description: Take the device exclusion semaphore.  This serializes the
+ *              block driver methods with the background garbage collector.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_semtake(FAR struct smart_struct_s *dev)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(errno == EINTR);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_open
  *
@@ -455,8 +548,30 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR struct smart_struct_s *dev;
+  int ret;
+#endif
+
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  DEBUGASSERT(inode && inode->i_private);
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+  /* Write a new checkpoint of the sector map if the volume has changed */
+
+  smart_semtake(dev);
+  ret = smart_ckpt_write(dev);
+  smart_semgive(dev);
+  return ret;
+#else
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -826,6 +941,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -835,7 +951,12 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_semtake(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_bggc_kick(dev);
+  smart_semgive(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -872,7 +993,18 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_semtake(dev);
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint must be marked stale before the volume is modified */
+
+  ret = smart_ckpt_invalidate(dev);
+  if (ret < 0)
+    {
+      smart_semgive(dev);
+      return ret;
+    }
+#endif
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -911,9 +1043,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_semgive(dev);
               return ret;
             }
         }
@@ -940,9 +1070,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_semgive(dev);
           return -EIO;
         }
 
@@ -954,6 +1082,8 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
+  smart_bggc_kick(dev);
+  smart_semgive(dev);
   return nsectors;
 }
 #endif /* CONFIG_FS_WRITABLE */
@@ -1498,6 +1628,21 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
    * for it and add it to the cache.
    */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Next try the sector table of the checkpoint.  That is a few large
+   * sequential reads instead of reading every sector header.
+   */
+
+  if (physical == 0xffff)
+    {
+      physical = smart_ckpt_lookup(dev, logical);
+      if (physical != 0xffff)
+        {
+          smart_add_sector_to_cache(dev, logical, physical, __LINE__);
+        }
+    }
+#endif
+
   if (physical == 0xffff)
     {
       /* Now scan the MTD device.  Instead of scanning start to end, we
@@ -1809,14 +1954,732 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 
       if (oldlevel == dev->minwearlevel)
         {
-          smart_find_wear_minmax(dev);
+          smart_find_wear_minmax(dev);
+
+          if (oldlevel != dev->minwearlevel)
+              finfo("##### New min wear level = %d\n", dev->minwearlevel);
+        }
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_scan_format
+ *
+ * Description: Validates the format signature in the physical sector that
+ *              holds logical sector zero and, if it is valid, sets the
+ *              volume format information.  Returns OK if the volume is
+ *              formatted, 1 if the signature is invalid, or a negated errno
+ *              value on failure.
+ *
+ ****************************************************************************/
+
+static int smart_scan_format(FAR struct smart_struct_s *dev, int sector)
+{
+  uint32_t  readaddress;
+  int       ret;
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  int       x;
+  char      devname[22];
+  FAR struct smart_multiroot_device_s *rootdirdev;
+#endif
+
+  readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+
+  /* Read the sector data */
+
+  ret = MTD_READ(dev->mtd, readaddress, 32,
+                 (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 32)
+    {
+      ferr("ERROR: Error reading physical sector %d.\n", sector);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  /* Validate the format signature */
+
+  if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
+      dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
+      dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
+      dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
+    {
+      /* Invalid signature on a sector claiming to be sector 0!
+       * What should we do?  Release it?
+       */
+
+      return 1;
+    }
+
+  /* Mark the volume as formatted and set the sector size */
+
+  dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+  dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
+  dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
+
+  /* If rootdirentries is greater than 1, then we need to register
+   * additional block devices.
+   */
+
+  for (x = 1; x < dev->rootdirentries; x++)
+    {
+      if (dev->partname[0] != '\0')
+        {
+          snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
+                  dev->minor, dev->partname, x+1);
+        }
+      else
+        {
+          snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
+                   x + 1);
+        }
+
+      /* Inode private data is a reference to a struct containing
+       * the SMART device structure and the root directory number.
+       */
+
+      rootdirdev = (struct smart_multiroot_device_s *)
+        smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
+      if (rootdirdev == NULL)
+        {
+          ferr("ERROR: Memory alloc failed\n");
+          return -ENOMEM;
+        }
+
+      /* Populate the rootdirdev */
+
+      rootdirdev->dev = dev;
+      rootdirdev->rootdirnum = x;
+      ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+
+      /* Inode private data is a reference to the SMART device structure */
+
+      ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_ckpt_reserve
+ *
+ * Description: Reserves erase blocks at the end of the MTD device for the
+ *              sector map checkpoint.  This must be called before the
+ *              sector size is set since it reduces the number of erase
+ *              blocks available to the volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_reserve(FAR struct smart_struct_s *dev)
+{
+  uint32_t  nsectors;
+  uint32_t  length;
+  uint32_t  nblocks;
+
+  /* Size the area for the default sector size: The header block, the
+   * free and release counts, the sector table plus one sector of slack
+   * for rounding the payload up to whole sectors.
+   */
+
+  nsectors = dev->geo.erasesize / CONFIG_MTD_SMART_SECTOR_SIZE;
+  if (nsectors == 0)
+    {
+      nsectors = 1;
+    }
+
+  nsectors *= dev->geo.neraseblocks;
+  length    = dev->geo.blocksize + 2 * dev->geo.neraseblocks +
+              2 * nsectors + CONFIG_MTD_SMART_SECTOR_SIZE;
+  nblocks   = (length + dev->geo.erasesize - 1) / dev->geo.erasesize;
+
+  /* Don't give up more than 1/8 of a (small) device for the checkpoint */
+
+  if (nblocks > (dev->geo.neraseblocks >> 3))
+    {
+      fwarn("WARNING: Device too small for a sector map checkpoint\n");
+      dev->ckptblocks = 0;
+      dev->ckptstate  = SMART_CKPT_NONE;
+      return;
+    }
+
+  dev->geo.neraseblocks -= nblocks;
+  dev->ckptblock  = dev->geo.neraseblocks;
+  dev->ckptblocks = nblocks;
+  dev->ckptstate  = SMART_CKPT_NONE;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_length
+ *
+ * Description: Returns the length of the checkpoint payload for the
+ *              current sector size, or zero if the payload would not fit
+ *              in the reserved erase blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static uint32_t smart_ckpt_length(FAR struct smart_struct_s *dev)
+{
+  uint32_t  length;
+  uint32_t  rounded;
+
+  length  = 2 * (uint32_t)dev->neraseblocks +
+            2 * (uint32_t)dev->neraseblocks * dev->sectorsPerBlk;
+  rounded = (length + dev->sectorsize - 1) / dev->sectorsize *
+            dev->sectorsize;
+
+  if (dev->ckptblocks == 0 || dev->geo.blocksize + rounded >
+      (uint32_t)dev->ckptblocks * dev->geo.erasesize)
+    {
+      return 0;
+    }
+
+  return length;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_readheader
+ *
+ * Description: Reads the header of a physical sector and returns the
+ *              logical sector it holds, or 0xffff if the sector does not
+ *              hold a live (committed, not released) logical sector.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && \
+    defined(CONFIG_MTD_SMART_MINIMIZE_RAM)
+static uint16_t smart_ckpt_readheader(FAR struct smart_struct_s *dev,
+                                      uint16_t physical)
+{
+  struct    smart_sect_header_s header;
+  uint32_t  readaddress;
+  uint16_t  logicalsector;
+  int       ret;
+
+  readaddress = physical * dev->mtdBlksPerSector * dev->geo.blocksize;
+  ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+                 (FAR uint8_t *) &header);
+  if (ret != sizeof(struct smart_sect_header_s))
+    {
+      return 0xffff;
+    }
+
+  logicalsector = *((FAR uint16_t *) header.logicalsector);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+  if (logicalsector == 0)
+    {
+      return 0xffff;
+    }
+#endif
+
+  if ((header.status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED) ||
+      (header.status & SMART_STATUS_RELEASED) !=
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED) ||
+      (header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION ||
+      logicalsector >= dev->totalsectors)
+    {
+      return 0xffff;
+    }
+
+  return logicalsector;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_fill
+ *
+ * Description: Fills a buffer with len bytes of the checkpoint payload
+ *              starting at payload offset pos.  pos and len must be even
+ *              so that no sector table entry is split.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_fill(FAR struct smart_struct_s *dev,
+                            FAR uint8_t *buffer, uint32_t pos, uint32_t len)
+{
+  FAR uint16_t *table;
+  uint32_t  first;
+  uint32_t  last;
+  uint32_t  x;
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  uint16_t  physical;
+#endif
+
+  /* First the free and release counts of each erase block */
+
+  while (len > 0 && pos < 2 * (uint32_t)dev->neraseblocks)
+    {
+      if (pos < dev->neraseblocks)
+        {
+          *buffer = dev->freecount[pos];
+        }
+      else
+        {
+          *buffer = dev->releasecount[pos - dev->neraseblocks];
+        }
+
+      buffer++;
+      pos++;
+      len--;
+    }
+
+  if (len == 0)
+    {
+      return;
+    }
+
+  /* Then the physical to logical sector table */
+
+  table = (FAR uint16_t *)buffer;
+  first = (pos - 2 * (uint32_t)dev->neraseblocks) >> 1;
+  last  = first + (len >> 1);
+  memset(table, 0xff, len);
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  /* Invert the part of the logical to physical map in this window */
+
+  for (x = 0; x < dev->totalsectors; x++)
+    {
+      physical = dev->sMap[x];
+      if (physical != 0xffff && physical >= first && physical < last)
+        {
+          table[physical - first] = (uint16_t)x;
+        }
+    }
+#else
+  /* There is no map in RAM.  Read the sector headers in this window */
+
+  for (x = first; x < last; x++)
+    {
+      table[x - first] = smart_ckpt_readheader(dev, (uint16_t)x);
+    }
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_invalidate
+ *
+ * Description: Marks a valid checkpoint as stale.  This must be done
+ *              before the volume is modified and before the caller puts
+ *              anything into the rwbuffer (which may be used here).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_invalidate(FAR struct smart_struct_s *dev)
+{
+  uint8_t   state;
+  ssize_t   ret;
+
+  if (dev->ckptstate != SMART_CKPT_CLEAN)
+    {
+      return OK;
+    }
+
+  state = (uint8_t)~CONFIG_SMARTFS_ERASEDSTATE;
+  ret   = smart_bytewrite(dev, dev->ckptblock * dev->geo.erasesize +
+                          offsetof(struct smart_ckpt_s, state), 1, &state);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d invalidating the checkpoint\n", (int)-ret);
+      return (int)ret;
+    }
+
+  dev->ckptstate = SMART_CKPT_STALE;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_write
+ *
+ * Description: Writes a new checkpoint of the sector map and counts if the
+ *              volume has changed since the last one.  The payload is
+ *              written first and the header last, so an interrupted write
+ *              leaves no valid checkpoint behind.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_write(FAR struct smart_struct_s *dev)
+{
+  struct    smart_ckpt_s ckpt;
+  uint32_t  length;
+  uint32_t  pos;
+  uint32_t  nbytes;
+  uint32_t  crc;
+  off_t     startblock;
+  int       ret;
+
+  if (dev->ckptstate == SMART_CKPT_CLEAN ||
+      dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+  /* Allocated sectors that have not been written yet exist only in RAM */
+
+  if (dev->allocsector != NULL)
+    {
+      return OK;
+    }
+#endif
+
+  length = smart_ckpt_length(dev);
+  if (length == 0)
+    {
+      return OK;
+    }
+
+  /* Erase the checkpoint area */
+
+  dev->ckptstate = SMART_CKPT_NONE;
+  ret = MTD_ERASE(dev->mtd, dev->ckptblock, dev->ckptblocks);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d erasing the checkpoint\n", -ret);
+      return ret;
+    }
+
+  /* Write the payload one sector at a time after the header block */
+
+  startblock = dev->ckptblock * (dev->geo.erasesize / dev->geo.blocksize) + 1;
+  crc = 0;
+
+  for (pos = 0; pos < length; pos += dev->sectorsize)
+    {
+      nbytes = length - pos;
+      if (nbytes > dev->sectorsize)
+        {
+          nbytes = dev->sectorsize;
+        }
+
+      memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->sectorsize);
+      smart_ckpt_fill(dev, (FAR uint8_t *)dev->rwbuffer, pos, nbytes);
+      crc = crc32part((FAR uint8_t *)dev->rwbuffer, nbytes, crc);
+
+      ret = MTD_BWRITE(dev->mtd, startblock + pos / dev->geo.blocksize,
+                       dev->mtdBlksPerSector, (FAR uint8_t *)dev->rwbuffer);
+      if (ret != dev->mtdBlksPerSector)
+        {
+          ferr("ERROR: Error %d writing the checkpoint\n", ret);
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  /* Now write the header.  The state byte is left in the erased state */
+
+  memcpy(ckpt.magic, "SMCP", 4);
+  ckpt.version        = SMART_CKPT_VERSION;
+  ckpt.state          = CONFIG_SMARTFS_ERASEDSTATE;
+  ckpt.sectorsize     = dev->sectorsize;
+  ckpt.totalsectors   = dev->totalsectors;
+  ckpt.neraseblocks   = dev->neraseblocks;
+  ckpt.freesectors    = dev->freesectors;
+  ckpt.releasesectors = dev->releasesectors;
+  ckpt.length         = length;
+  ckpt.crc            = crc;
+
+  memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  memcpy(dev->rwbuffer, &ckpt, sizeof(struct smart_ckpt_s));
+
+  ret = MTD_BWRITE(dev->mtd, startblock - 1, 1, (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 1)
+    {
+      ferr("ERROR: Error %d writing the checkpoint header\n", ret);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  finfo("Checkpoint written: %d bytes\n", length);
+  dev->ckptstate = SMART_CKPT_CLEAN;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_read
+ *
+ * Description: Reads the checkpoint payload one sector at a time.  If
+ *              apply is false, only the CRC is computed and returned.
+ *              Otherwise the counts and the sector map are restored from
+ *              the payload.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_read(FAR struct smart_struct_s *dev, uint32_t length,
+                           bool apply, FAR uint32_t *crc)
+{
+  FAR uint8_t *buffer;
+  FAR uint16_t *table;
+  uint32_t  pos;
+  uint32_t  nbytes;
+  uint32_t  offset;
+  uint32_t  physical;
+  uint16_t  logical;
+  off_t     startblock;
+  int       ret;
+
+  startblock = dev->ckptblock * (dev->geo.erasesize / dev->geo.blocksize) + 1;
+  buffer     = (FAR uint8_t *)dev->rwbuffer;
+  *crc       = 0;
+
+  for (pos = 0; pos < length; pos += dev->sectorsize)
+    {
+      nbytes = length - pos;
+      if (nbytes > dev->sectorsize)
+        {
+          nbytes = dev->sectorsize;
+        }
+
+      ret = MTD_BREAD(dev->mtd, startblock + pos / dev->geo.blocksize,
+                      dev->mtdBlksPerSector, buffer);
+      if (ret != dev->mtdBlksPerSector)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+
+      if (!apply)
+        {
+          *crc = crc32part(buffer, nbytes, *crc);
+          continue;
+        }
+
+      /* Restore the free and release counts */
+
+      for (offset = 0;
+           offset < nbytes && pos + offset < 2 * (uint32_t)dev->neraseblocks;
+           offset++)
+        {
+          if (pos + offset < dev->neraseblocks)
+            {
+              dev->freecount[pos + offset] = buffer[offset];
+            }
+          else
+            {
+              dev->releasecount[pos + offset - dev->neraseblocks] =
+                buffer[offset];
+            }
+        }
+
+      /* Restore the sector map from the sector table */
+
+      table    = (FAR uint16_t *)&buffer[offset];
+      physical = (pos + offset - 2 * (uint32_t)dev->neraseblocks) >> 1;
+
+      for (; offset < nbytes; offset += 2, table++, physical++)
+        {
+          logical = *table;
+          if (logical == 0xffff)
+            {
+              continue;
+            }
+
+          if (logical >= dev->totalsectors)
+            {
+              return -EINVAL;
+            }
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+          dev->sMap[logical] = (uint16_t)physical;
+#else
+          dev->sBitMap[logical >> 3] |= 1 << (logical & 0x07);
+
+          if (logical < SMART_FIRST_ALLOC_SECTOR)
+            {
+              smart_add_sector_to_cache(dev, logical, (uint16_t)physical,
+                                        __LINE__);
+            }
+#endif
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_load
+ *
+ * Description: Restores the sector map, the free and release counts and
+ *              the format information from a valid checkpoint.  Returns OK
+ *              on success, or a negated errno if the volume must be
+ *              scanned instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_load(FAR struct smart_struct_s *dev)
+{
+  struct    smart_ckpt_s ckpt;
+  uint32_t  length;
+  uint32_t  crc;
+  uint16_t  physical;
+  int       ret;
+
+  dev->ckptstate = SMART_CKPT_NONE;
+
+  length = smart_ckpt_length(dev);
+  if (length == 0)
+    {
+      return -ENOSPC;
+    }
+
+  ret = MTD_READ(dev->mtd, dev->ckptblock * dev->geo.erasesize,
+                 sizeof(struct smart_ckpt_s), (FAR uint8_t *)&ckpt);
+  if (ret != sizeof(struct smart_ckpt_s))
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  /* The checkpoint must have been written for this volume geometry */
+
+  if (memcmp(ckpt.magic, "SMCP", 4) != 0 ||
+      ckpt.version != SMART_CKPT_VERSION ||
+      ckpt.sectorsize != dev->sectorsize ||
+      ckpt.totalsectors != dev->totalsectors ||
+      ckpt.neraseblocks != dev->neraseblocks ||
+      ckpt.length != length)
+    {
+      return -ENOENT;
+    }
+
+  /* A stale checkpoint is not loaded, but it is still a useful hint */
+
+  dev->ckptstate = SMART_CKPT_STALE;
+  if (ckpt.state != CONFIG_SMARTFS_ERASEDSTATE)
+    {
+      return -ESTALE;
+    }
+
+  /* Verify the payload before anything is restored from it */
+
+  ret = smart_ckpt_read(dev, length, false, &crc);
+  if (ret < 0 || crc != ckpt.crc)
+    {
+      ferr("ERROR: Bad sector map checkpoint\n");
+      dev->ckptstate = SMART_CKPT_NONE;
+      return ret < 0 ? ret : -EINVAL;
+    }
+
+  /* Now restore the counts and the map */
+
+  dev->formatstatus = SMART_FMT_STAT_NOFMT;
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  memset(dev->sMap, 0xff, dev->totalsectors * sizeof(uint16_t));
+#else
+  memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#endif
+
+  ret = smart_ckpt_read(dev, length, true, &crc);
+  if (ret < 0)
+    {
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+      dev->cache_entries = 0;
+      dev->cache_lastlog = 0xffff;
+#endif
+      dev->ckptstate = SMART_CKPT_NONE;
+      return ret;
+    }
+
+  dev->freesectors    = ckpt.freesectors;
+  dev->releasesectors = ckpt.releasesectors;
+
+  /* Get the format information from logical sector 0 */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  physical = dev->sMap[0];
+#else
+  physical = smart_cache_lookup(dev, 0);
+#endif
+
+  if (physical != 0xffff)
+    {
+      ret = smart_scan_format(dev, physical);
+      if (ret < 0)
+        {
+          dev->ckptstate = SMART_CKPT_NONE;
+          return ret;
+        }
+    }
+
+  finfo("Sector map restored from checkpoint\n");
+  dev->ckptstate = SMART_CKPT_CLEAN;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_lookup
+ *
+ * Description: Searches the sector table of the checkpoint for the
+ *              physical sector holding a logical sector.  The checkpoint
+ *              may be stale, so the header of the candidate sector is
+ *              checked before it is returned.  Returns 0xffff if the
+ *              sector was not found.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_SMART_CHECKPOINT) && \
+    defined(CONFIG_MTD_SMART_MINIMIZE_RAM)
+static uint16_t smart_ckpt_lookup(FAR struct smart_struct_s *dev,
+                                  uint16_t logical)
+{
+  uint16_t  table[32];
+  uint32_t  readaddress;
+  uint32_t  nphys;
+  uint32_t  physical;
+  uint32_t  nentries;
+  uint32_t  x;
+  int       ret;
+
+  if (dev->ckptstate == SMART_CKPT_NONE)
+    {
+      return 0xffff;
+    }
+
+  readaddress = dev->ckptblock * dev->geo.erasesize + dev->geo.blocksize +
+                2 * (uint32_t)dev->neraseblocks;
+  nphys       = (uint32_t)dev->neraseblocks * dev->sectorsPerBlk;
+
+  for (physical = 0; physical < nphys; physical += nentries)
+    {
+      nentries = nphys - physical;
+      if (nentries > 32)
+        {
+          nentries = 32;
+        }
+
+      ret = MTD_READ(dev->mtd, readaddress + 2 * physical,
+                     2 * nentries, (FAR uint8_t *)table);
+      if (ret != 2 * nentries)
+        {
+          return 0xffff;
+        }
 
-          if (oldlevel != dev->minwearlevel)
-              finfo("##### New min wear level = %d\n", dev->minwearlevel);
+      for (x = 0; x < nentries; x++)
+        {
+          if (table[x] == logical &&
+              smart_ckpt_readheader(dev, physical + x) == logical)
+            {
+              return (uint16_t)(physical + x);
+            }
         }
     }
 
-  return 0;
+  return 0xffff;
 }
 #endif
 
@@ -1846,11 +2709,6 @@ static int smart_scan(FAR struct smart_struct_s *dev)
   int       dupsector;
   uint16_t  duplogsector;
 #endif
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-  int       x;
-  char      devname[22];
-  FAR struct smart_multiroot_device_s *rootdirdev;
-#endif
 
   finfo("Entry\n");
 
@@ -1908,6 +2766,15 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       goto err_out;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Restore the map from a checkpoint instead of scanning if possible */
+
+  if (smart_ckpt_load(dev) == OK)
+    {
+      goto scan_done;
+    }
+#endif
+
   /* Initialize the device variables */
 
   totalsectors = dev->totalsectors;
@@ -2040,80 +2907,15 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
       if (logicalsector == 0)
         {
-          /* Read the sector data */
-
-          ret = MTD_READ(dev->mtd, readaddress, 32,
-                         (FAR uint8_t *)dev->rwbuffer);
-          if (ret != 32)
+          ret = smart_scan_format(dev, sector);
+          if (ret < 0)
             {
-              ferr("ERROR: Error reading physical sector %d.\n", sector);
               goto err_out;
             }
-
-          /* Validate the format signature */
-
-          if (dev->rwbuffer[SMART_FMT_POS1] != SMART_FMT_SIG1 ||
-              dev->rwbuffer[SMART_FMT_POS2] != SMART_FMT_SIG2 ||
-              dev->rwbuffer[SMART_FMT_POS3] != SMART_FMT_SIG3 ||
-              dev->rwbuffer[SMART_FMT_POS4] != SMART_FMT_SIG4)
+          else if (ret > 0)
             {
-              /* Invalid signature on a sector claiming to be sector 0!
-               * What should we do?  Release it?
-               */
-
               continue;
             }
-
-          /* Mark the volume as formatted and set the sector size */
-
-          dev->formatstatus = SMART_FMT_STAT_FORMATTED;
-          dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
-          dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
-
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-          dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
-
-          /* If rootdirentries is greater than 1, then we need to register
-           * additional block devices.
-           */
-
-          for (x = 1; x < dev->rootdirentries; x++)
-            {
-              if (dev->partname[0] != '\0')
-                {
-                  snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d",
-                          dev->minor, dev->partname, x+1);
-                }
-              else
-                {
-                  snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor,
-                           x + 1);
-                }
-
-              /* Inode private data is a reference to a struct containing
-               * the SMART device structure and the root directory number.
-               */
-
-              rootdirdev = (struct smart_multiroot_device_s *)
-                smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
-              if (rootdirdev == NULL)
-                {
-                  ferr("ERROR: Memory alloc failed\n");
-                  ret = -ENOMEM;
-                  goto err_out;
-                }
-
-              /* Populate the rootdirdev */
-
-              rootdirdev->dev = dev;
-              rootdirdev->rootdirnum = x;
-              ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
-
-              /* Inode private data is a reference to the SMART device structure */
-
-              ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
-            }
-#endif
         }
 
       /* Test for duplicate logical sectors on the device */
@@ -2287,6 +3089,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #endif
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan_done:
+#endif
+
 #if defined (CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
 
@@ -2334,6 +3140,26 @@ static int smart_scan(FAR struct smart_struct_s *dev)
               goto err_out;
             }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+          /* Mark the checkpoint stale first.  That may use the rwbuffer,
+           * so the sector must be read again.
+           */
+
+          ret = smart_ckpt_invalidate(dev);
+          if (ret < 0)
+            {
+              goto err_out;
+            }
+
+          ret = MTD_BREAD(dev->mtd, sector * dev->mtdBlksPerSector,
+                          dev->mtdBlksPerSector, (uint8_t *) dev->rwbuffer);
+          if (ret != dev->mtdBlksPerSector)
+            {
+              ferr("ERROR: Error reading physical sector %d.\n", sector);
+              goto err_out;
+            }
+#endif
+
           memset(&dev->rwbuffer[SMART_WEAR_LEVEL_FORMAT_SIG], 0xff,
               dev->mtdBlksPerSector * dev->geo.blocksize -
               SMART_WEAR_LEVEL_FORMAT_SIG);
@@ -2927,6 +3753,12 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
       return ret;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* The checkpoint area was erased too */
+
+  dev->ckptstate = SMART_CKPT_NONE;
+#endif
+
   /* Now construct a logical sector zero header to write to the device. */
 
   sectorheader = (FAR struct smart_sect_header_s *) dev->rwbuffer;
@@ -3702,120 +4534,139 @@ retry:
 }
 
 /****************************************************************************
- * Name: smart_garbagecollect
+ * Name: smart_collectblock
  *
- * Description:  Performs garbage collection if needed.  This is determined
- *               by the count of released sectors relative to free and
- *               total sectors.
+ * Description:  Relocates the active data in the erase block with the most
+ *               released sectors and erases it.  Only blocks with at least
+ *               minreleased released sectors are considered.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+static int smart_collectblock(FAR struct smart_struct_s *dev,
+                              uint16_t minreleased)
 {
   uint16_t  collectblock;
   uint16_t  releasemax;
-  bool      collect = TRUE;
   int       x;
   int       ret;
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   uint8_t   count;
 #endif
 
-  while (collect)
-    {
-      collect = FALSE;
+  /* Find the block with the most released sectors */
 
-      /* Test if the released sectors count is greater than the
-       * free sectors.  If it is, then we will do garbage collection.
-       */
+  collectblock = 0xffff;
+  releasemax = minreleased - 1;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
 
-      if (dev->releasesectors > dev->freesectors && dev->freesectors <
-          (dev->totalsectors >> 5))
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
         {
-          collect = TRUE;
+          continue;
         }
+#endif
 
-      /* Test if we have more reached our reserved free sector limit */
-
-      if (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4)
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+      if (count > releasemax)
         {
-          collect = TRUE;
+          releasemax = count;
+          collectblock = x;
+        }
+#else
+      if (dev->releasecount[x] > releasemax)
+        {
+          releasemax = dev->releasecount[x];
+          collectblock = x;
         }
+#endif
+    }
 
-      /* Test if we need to garbage collect */
+  //releasemax = smart_get_count(dev, dev->releasecount, collectblock);
 
-      if (collect)
-        {
-          /* Find the block with the most released sectors */
+  if (collectblock == 0xffff)
+    {
+      /* Need to collect, but no sectors with released blocks! */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
+      return -ENOSPC;
+    }
 
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
+#ifdef CONFIG_SMART_LOCAL_CHECKFREE
+  if (smart_checkfree(dev, __LINE__) != OK)
+    {
+      fwarn("   ...before collecting block %d\n", collectblock);
+    }
 #endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
+  finfo("Collecting block %d, free=%d released=%d, totalfree=%d, totalrelease=%d\n",
+      collectblock, smart_get_count(dev, dev->freecount, collectblock),
+      smart_get_count(dev, dev->releasecount, collectblock), dev->freesectors, dev->releasesectors);
 #else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
+  finfo("Collecting block %d, free=%d released=%d\n",
+      collectblock, dev->freecount[collectblock],
+      dev->releasecount[collectblock]);
 #endif
-            }
 
-          //releasemax = smart_get_count(dev, dev->releasecount, collectblock);
+  /* Relocate the active data in the collection block */
 
-          if (collectblock == 0xffff)
-            {
-              /* Need to collect, but no sectors with released blocks! */
-
-              ret = -ENOSPC;
-              goto errout;
-            }
+  ret = smart_relocate_block(dev, collectblock);
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...before collecting block %d\n", collectblock);
-            }
+  if (smart_checkfree(dev, __LINE__) != OK)
+    {
+      fwarn("   ...while collecting block %d\n", collectblock);
+    }
 #endif
 
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-          finfo("Collecting block %d, free=%d released=%d, totalfree=%d, totalrelease=%d\n",
-              collectblock, smart_get_count(dev, dev->freecount, collectblock),
-              smart_get_count(dev, dev->releasecount, collectblock), dev->freesectors, dev->releasesectors);
-#else
-          finfo("Collecting block %d, free=%d released=%d\n",
-              collectblock, dev->freecount[collectblock],
-              dev->releasecount[collectblock]);
-#endif
+  return ret;
+}
+#endif /* CONFIG_FS_WRITABLE */
+
+/****************************************************************************
+ * Name: smart_garbagecollect
+ *
+ * Description:  Performs garbage collection if needed.  This is determined
+ *               by the count of released sectors relative to free and
+ *               total sectors.
+ *
+ ****************************************************************************/
 
-          /* Relocate the active data in the collection block */
+#ifdef CONFIG_FS_WRITABLE
+static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+{
+  bool      collect = TRUE;
+  int       ret;
 
-          ret = smart_relocate_block(dev, collectblock);
+  while (collect)
+    {
+      collect = FALSE;
 
-#ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...while collecting block %d\n", collectblock);
-            }
-#endif
+      /* Test if the released sectors count is greater than the
+       * free sectors.  If it is, then we will do garbage collection.
+       */
 
+      if (dev->releasesectors > dev->freesectors && dev->freesectors <
+          (dev->totalsectors >> 5))
+        {
+          collect = TRUE;
+        }
+
+      /* Test if we have more reached our reserved free sector limit */
+
+      if (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4)
+        {
+          collect = TRUE;
+        }
+
+      /* Test if we need to garbage collect */
+
+      if (collect)
+        {
+          ret = smart_collectblock(dev, 1);
           if (ret != OK)
             {
               goto errout;
@@ -5122,6 +5973,128 @@ errout:
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Returns true if the free sectors are below the high
+ *               watermark and there are released sectors to reclaim.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+  return dev->formatstatus == SMART_FMT_STAT_FORMATTED &&
+         dev->releasesectors > 0 &&
+         (uint32_t)dev->freesectors * 100 <
+         (uint32_t)dev->totalsectors * CONFIG_MTD_SMART_BGGC_HIWATER;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Reclaims one erase block on the low priority work queue
+ *               once the device has been idle for MTD_SMART_BGGC_IDLE
+ *               milliseconds, or at once if the free sectors are below the
+ *               low watermark.  The worker re-queues itself until the free
+ *               sectors are above the high watermark or there is no block
+ *               worth collecting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  systime_t elapsed;
+  systime_t idle;
+  uint16_t  minreleased;
+  bool      urgent;
+  int       ret;
+
+  smart_semtake(dev);
+
+  if (!smart_bggc_needed(dev))
+    {
+      goto out;
+    }
+
+  /* Wait until the device is idle unless free sectors are running out */
+
+  urgent  = (uint32_t)dev->freesectors * 100 <
+            (uint32_t)dev->totalsectors * CONFIG_MTD_SMART_BGGC_LOWATER;
+  idle    = MSEC2TICK(CONFIG_MTD_SMART_BGGC_IDLE);
+  elapsed = clock_systimer() - dev->lastaccess;
+
+  if (!urgent && elapsed < idle)
+    {
+      (void)work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                       idle - elapsed);
+      goto out;
+    }
+
+  /* Relocating live sectors costs erase cycles.  Unless free sectors are
+   * running out, only collect blocks that are at least half released.
+   */
+
+  minreleased = urgent ? 1 : (dev->availSectPerBlk + 1) >> 1;
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  ret = smart_ckpt_invalidate(dev);
+  if (ret < 0)
+    {
+      goto out;
+    }
+#endif
+
+  ret = smart_collectblock(dev, minreleased);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      /* Write new wear status bits to the device */
+
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  /* Only one block is collected per run so that callers are not held off
+   * for long.  Come back right away if there is more to do.
+   */
+
+  if (ret == OK && smart_bggc_needed(dev))
+    {
+      (void)work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, 0);
+    }
+
+out:
+  smart_semgive(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_bggc_kick
+ *
+ * Description:  Called with the device locked after each access.  Records
+ *               the time of the access and starts the background garbage
+ *               collector if the free sectors are below the high watermark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_bggc_kick(FAR struct smart_struct_s *dev)
+{
+  dev->lastaccess = clock_systimer();
+
+  if (smart_bggc_needed(dev) && work_available(&dev->gcwork))
+    {
+      (void)work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev,
+                       MSEC2TICK(CONFIG_MTD_SMART_BGGC_IDLE));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -5147,6 +6120,22 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  smart_semtake(dev);
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Requests that modify the volume make the sector map checkpoint stale */
+
+  if (cmd == BIOC_LLFORMAT || cmd == BIOC_ALLOCSECT ||
+      cmd == BIOC_FREESECT || cmd == BIOC_WRITESECT)
+    {
+      ret = smart_ckpt_invalidate(dev);
+      if (ret < 0)
+        {
+          goto ok_out;
+        }
+    }
+#endif
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5163,7 +6152,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5305,6 +6295,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_bggc_kick(dev);
+  smart_semgive(dev);
   return ret;
 }
 
@@ -5352,6 +6344,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      sem_init(&dev->exclsem, 0, 1);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -5367,6 +6362,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Reserve erase blocks at the end of the device for the checkpoint */
+
+      smart_ckpt_reserve(dev);
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
@@ -5501,6 +6502,9 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  sem_destroy(&dev->exclsem);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -102,6 +102,7 @@ struct lo_driver_s
 {
   bool lo_bifup;               /* true:ifup false:ifdown */
   bool lo_txdone;              /* One RX packet was looped back */
+  bool lo_busy;                /* The device is being polled */
   WDOG_ID lo_polldog;          /* TX poll timer */
   struct work_s lo_work;       /* For deferring poll work to the work queue */
 
@@ -124,6 +125,7 @@ static uint8_t g_iobuffer[MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE];
 /* Polling logic */
 
 static int  lo_txpoll(FAR struct net_driver_s *dev);
+static void lo_loopback(FAR struct lo_driver_s *priv);
 static void lo_poll_work(FAR void *arg);
 static void lo_poll_expiry(int argc, wdparm_t arg, ...);
 
@@ -216,6 +218,48 @@ static int lo_txpoll(FAR struct net_driver_s *dev)
   return 0;
 }
 
+/****************************************************************************
+ * Name: lo_loopback
+ *
+ * Description:
+ *   Poll the network until no more packets are sent.  If the device is
+ *   already being polled, which happens when the delivery of a packet
+ *   notifies the device of new TX data, then only request that the poll in
+ *   progress polls again.
+ *
+ * Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void lo_loopback(FAR struct lo_driver_s *priv)
+{
+  if (priv->lo_busy)
+    {
+      priv->lo_txdone = true;
+      return;
+    }
+
+  priv->lo_busy = true;
+
+  do
+    {
+      /* Poll the network for new XMIT data */
+
+      priv->lo_txdone = false;
+      (void)devif_poll(&priv->lo_dev, lo_txpoll);
+    }
+  while (priv->lo_txdone);
+
+  priv->lo_busy = false;
+}
+
 /****************************************************************************
  * Name: lo_poll_work
  *
@@ -240,17 +284,18 @@ static void lo_poll_work(FAR void *arg)
   /* Perform the poll */
 
   net_lock();
+  priv->lo_busy   = true;
   priv->lo_txdone = false;
   (void)devif_timer(&priv->lo_dev, lo_txpoll);
+  priv->lo_busy   = false;
 
-  /* Was something received and looped back? */
+  /* Was something received and looped back?  If so, poll again for more TX
+   * data.
+   */
 
-  while (priv->lo_txdone)
+  if (priv->lo_txdone)
     {
-      /* Yes, poll again for more TX data */
-
-      priv->lo_txdone = false;
-      (void)devif_poll(&priv->lo_dev, lo_txpoll);
+      lo_loopback(priv);
     }
 
   /* Setup the watchdog poll timer again */
@@ -384,14 +429,9 @@ static void lo_txavail_work(FAR void *arg)
   net_lock();
   if (priv->lo_bifup)
     {
-      do
-        {
-          /* If so, then poll the network for new XMIT data */
+      /* If so, then poll the network for new XMIT data */
 
-          priv->lo_txdone = false;
-          (void)devif_poll(&priv->lo_dev, lo_txpoll);
-        }
-      while (priv->lo_txdone);
+      lo_loopback(priv);
     }
 
   net_unlock();
@@ -412,7 +452,7 @@ static void lo_txavail_work(FAR void *arg)
  *   None
  *
  * Assumptions:
- *   Called in normal user mode
+ *   Called from the network stack with the network locked.
  *
  ****************************************************************************/
 
@@ -420,6 +460,24 @@ static int lo_txavail(FAR struct net_driver_s *dev)
 {
   FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)dev->d_private;
 
+#ifdef CONFIG_LOOPBACK_DIRECT
+  /* Deliver the new TX data now, in the context of the sender, unless this
+   * is an interrupt handler.
+   */
+
+  if (!up_interrupt_context())
+    {
+      net_lock();
+      if (priv->lo_bifup)
+        {
+          lo_loopback(priv);
+        }
+
+      net_unlock();
+      return OK;
+    }
+#endif
+
   /* Is our single work structure available?  It may not be if there are
    * pending interrupt actions and we will have to ignore the Tx
    * availability action.
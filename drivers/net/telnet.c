@@ -145,13 +145,12 @@ static inline void telnet_dumpbuffer(FAR const char *msg,
 #else
 # define telnet_dumpbuffer(msg,buffer,nbytes)
 #endif
-static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 FAR char *dest, int *nread);
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 int *nwritten);
+static size_t  telnet_txspan(FAR const char *src, size_t srclen);
+static int     telnet_flush(FAR struct telnet_dev_s *priv,
+                 FAR const char *buffer, size_t buflen);
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
 
@@ -238,31 +237,6 @@ static inline void telnet_dumpbuffer(FAR const char *msg,
 }
 #endif
 
-/****************************************************************************
- * Name: telnet_getchar
- *
- * Description:
- *   Get another character for the user received buffer from the RX buffer
- *
- ****************************************************************************/
-
-static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           FAR char *dest, int *nread)
-{
-  register int index;
-
-  /* Ignore carriage returns */
-
-  if (ch != ISO_cr)
-    {
-      /* Add all other characters to the destination buffer */
-
-      index = *nread;
-      dest[index++] = ch;
-      *nread = index;
-    }
-}
-
 /****************************************************************************
  * Name: telnet_receive
  *
@@ -274,14 +248,56 @@ static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src,
                               size_t srclen, FAR char *dest, size_t destlen)
 {
-  int nread;
+  size_t nread;
+  size_t span;
   uint8_t ch;
 
   ninfo("srclen: %d destlen: %d\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  nread = 0;
+  while (srclen > 0 && nread < destlen)
     {
-      ch = *src++;
+      if (priv->td_state == STATE_NORMAL)
+        {
+          /* Find the run of user data that precedes the next byte that
+           * needs special handling (IAC or a carriage return) and copy it
+           * all at once.
+           */
+
+          for (span = 0; span < srclen && span < destlen - nread; span++)
+            {
+              ch = (uint8_t)src[span];
+              if (ch == TELNET_IAC || ch == ISO_cr)
+                {
+                  break;
+                }
+            }
+
+          if (span > 0)
+            {
+              memcpy(&dest[nread], src, span);
+              nread  += span;
+              src    += span;
+              srclen -= span;
+              continue;
+            }
+
+          /* Ignore carriage returns */
+
+          ch = (uint8_t)*src++;
+          srclen--;
+
+          if (ch == TELNET_IAC)
+            {
+              priv->td_state = STATE_IAC;
+            }
+
+          continue;
+        }
+
+      ch = (uint8_t)*src++;
+      srclen--;
+
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
       switch (priv->td_state)
@@ -289,9 +305,11 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
           case STATE_IAC:
             if (ch == TELNET_IAC)
               {
-                telnet_getchar(priv, ch, dest, &nread);
+                /* An escaped IAC is user data */
+
+                dest[nread++] = ch;
                 priv->td_state = STATE_NORMAL;
-             }
+              }
             else
               {
                 switch (ch)
@@ -347,15 +365,8 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
             priv->td_state = STATE_NORMAL;
             break;
 
-          case STATE_NORMAL:
-            if (ch == TELNET_IAC)
-              {
-                priv->td_state = STATE_IAC;
-              }
-            else
-              {
-                telnet_getchar(priv, ch, dest, &nread);
-              }
+          default:
+            priv->td_state = STATE_NORMAL;
             break;
         }
     }
@@ -385,46 +396,53 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
 }
 
 /****************************************************************************
- * Name: telnet_putchar
+ * Name: telnet_txspan
  *
  * Description:
- *   Put another character from the user buffer to the TX buffer.
+ *   Return the number of bytes at the beginning of the user buffer that can
+ *   be sent as they are, i.e., that precede the next line feed, carriage
+ *   return or IAC.
  *
  ****************************************************************************/
 
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           int *nread)
+static size_t telnet_txspan(FAR const char *src, size_t srclen)
 {
-  register int index;
-  bool ret = false;
-
-  /* Ignore carriage returns (we will put these in automatically as necesary) */
+  size_t span;
+  uint8_t ch;
 
-  if (ch != ISO_cr)
+  for (span = 0; span < srclen; span++)
     {
-      /* Add all other characters to the destination buffer */
-
-      index = *nread;
-      priv->td_txbuffer[index++] = ch;
-
-      /* Check for line feeds */
-
-      if (ch == ISO_nl)
+      ch = (uint8_t)src[span];
+      if (ch == ISO_nl || ch == ISO_cr || ch == TELNET_IAC)
         {
-          /* Now add the carriage return */
+          break;
+        }
+    }
 
-          priv->td_txbuffer[index++] = ISO_cr;
-          priv->td_txbuffer[index++] = '\0';
+  return span;
+}
 
-          /* End of line */
+/****************************************************************************
+ * Name: telnet_flush
+ *
+ * Description:
+ *   Send a buffer of data to the telnet client.
+ *
+ ****************************************************************************/
 
-          ret = true;
-        }
+static int telnet_flush(FAR struct telnet_dev_s *priv,
+                        FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
 
-      *nread = index;
+  ret = psock_send(&priv->td_psock, buffer, buflen, 0);
+  if (ret < 0)
+    {
+      nerr("ERROR: psock_send failed: %d\n", ret);
+      return ret;
     }
 
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -675,55 +693,119 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer, size
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
-  ssize_t nsent;
-  ssize_t ret;
-  int ncopied;
-  char ch;
-  bool eol;
+  size_t remaining = len;
+  size_t ncopied = 0;
+  size_t span;
+  int ret;
+  uint8_t ch;
 
   ninfo("len: %d\n", len);
 
-  /* Process each character from the user buffer */
-
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  while (remaining > 0)
     {
-      /* Get the next character from the user buffer */
+      /* Bytes up to the next line feed, carriage return or IAC are sent as
+       * they are.
+       */
 
-      ch = *src++;
+      span = telnet_txspan(src, remaining);
 
-      /* Add the character to the TX buffer */
+      /* A large run of data with nothing buffered ahead of it is sent
+       * directly from the user buffer.
+       */
 
-      eol = telnet_putchar(priv, ch, &ncopied);
+      if (ncopied == 0 && span >= CONFIG_TELNET_TXBUFFER_SIZE)
+        {
+          ret = telnet_flush(priv, src, span);
+          if (ret < 0)
+            {
+              return ret;
+            }
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n\0")?
-       */
+          src       += span;
+          remaining -= span;
+          continue;
+        }
+
+      /* Otherwise, add as much as fits to the TX buffer */
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE-3)
+      while (span > 0)
         {
-          /* Yes... send the data now */
+          size_t ncopy = CONFIG_TELNET_TXBUFFER_SIZE - ncopied;
+
+          if (ncopy > span)
+            {
+              ncopy = span;
+            }
 
-          ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
+          memcpy(&priv->td_txbuffer[ncopied], src, ncopy);
+          ncopied   += ncopy;
+          src       += ncopy;
+          remaining -= ncopy;
+          span      -= ncopy;
+
+          if (ncopied >= CONFIG_TELNET_TXBUFFER_SIZE)
+            {
+              ret = telnet_flush(priv, priv->td_txbuffer, ncopied);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              ncopied = 0;
+            }
+        }
+
+      if (remaining == 0)
+        {
+          break;
+        }
+
+      /* Make sure that there is room for the largest expansion
+       * ("\n\r\0")
+       */
+
+      if (ncopied > CONFIG_TELNET_TXBUFFER_SIZE - 3)
+        {
+          ret = telnet_flush(priv, priv->td_txbuffer, ncopied);
           if (ret < 0)
             {
-              nerr("ERROR: psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
               return ret;
             }
 
-          /* Reset the index to the beginning of the TX buffer. */
-
           ncopied = 0;
         }
+
+      ch = (uint8_t)*src++;
+      remaining--;
+
+      if (ch == ISO_nl)
+        {
+          /* Add the carriage return after a line feed */
+
+          priv->td_txbuffer[ncopied++] = ISO_nl;
+          priv->td_txbuffer[ncopied++] = ISO_cr;
+          priv->td_txbuffer[ncopied++] = '\0';
+        }
+      else if (ch == TELNET_IAC)
+        {
+          /* Data bytes equal to IAC must be doubled */
+
+          priv->td_txbuffer[ncopied++] = TELNET_IAC;
+          priv->td_txbuffer[ncopied++] = TELNET_IAC;
+        }
+
+      /* Carriage returns are ignored (we put these in automatically as
+       * necessary).
+       */
     }
 
   /* Send anything remaining in the TX buffer */
 
   if (ncopied > 0)
     {
-      ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
+      ret = telnet_flush(priv, priv->td_txbuffer, ncopied);
       if (ret < 0)
         {
-          nerr("ERROR: psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
           return ret;
         }
     }
@@ -64,6 +64,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ethernet.h>
@@ -105,10 +106,49 @@
 
 #define TUN_WDDELAY   (1*CLK_TCK)
 
+/* The number of files that may be attached to one interface and the number
+ * of packets that may wait to be read from each.
+ */
+
+#ifndef CONFIG_NET_TUN_NQUEUES
+#  define CONFIG_NET_TUN_NQUEUES 1
+#endif
+
+#ifndef CONFIG_NET_TUN_QUEUELEN
+#  define CONFIG_NET_TUN_QUEUELEN 4
+#endif
+
+/* Size of the length field that precedes each IFF_MULTI_PKT packet */
+
+#define TUN_PKTHDRLEN 2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The tun_queue_s holds the state of one file attached to an interface.
+ * Packets sent by the network wait in the queue, in IOBs, until the file
+ * is read.
+ */
+
+struct tun_device_s;
+struct tun_queue_s
+{
+  FAR struct tun_device_s *priv;  /* The interface */
+  FAR struct file  *filep;        /* The attached file; NULL if unused */
+
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *poll_fds;
+#endif
+
+  bool              read_wait;
+  sem_t             read_wait_sem;
+
+  uint8_t           head;    /* Index of the oldest packet */
+  uint8_t           count;   /* Number of packets waiting to be read */
+  FAR struct iob_s *pkts[CONFIG_NET_TUN_QUEUELEN];
+};
+
 /* The tun_device_s encapsulates all state information for a single hardware
  * interface
  */
@@ -119,21 +159,14 @@ struct tun_device_s
   WDOG_ID           txpoll;  /* TX poll timer */
   struct work_s     work;    /* For deferring poll work to the work queue */
 
-  FAR struct file  *filep;
-
-#ifndef CONFIG_DISABLE_POLL
-  FAR struct pollfd *poll_fds;
-#endif
-
-  bool              read_wait;
+  uint8_t           flags;   /* TUNSETIFF flags */
+  uint8_t           nqueues; /* Number of attached files */
 
-  uint8_t           read_buf[CONFIG_NET_TUN_MTU];
-  size_t            read_d_len;
-  uint8_t           write_buf[CONFIG_NET_TUN_MTU];
-  size_t            write_d_len;
+  uint8_t           buf[CONFIG_NET_TUN_MTU]; /* Packet buffer (d_buf) */
 
   sem_t             waitsem;
-  sem_t             read_wait_sem;
+
+  struct tun_queue_s queues[CONFIG_NET_TUN_NQUEUES];
 
   /* This holds the information visible to the NuttX network */
 
@@ -181,6 +214,10 @@ static int tun_rmmac(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 static void tun_ipv6multicast(FAR struct tun_device_s *priv);
 #endif
 
+static void tun_queue_attach(FAR struct tun_device_s *priv,
+                             FAR struct tun_queue_s *q,
+                             FAR struct file *filep);
+static void tun_queue_detach(FAR struct tun_queue_s *q);
 static int tun_dev_init(FAR struct tun_device_s *priv,
                         FAR struct file *filep, FAR const char *devfmt);
 static int tun_dev_uninit(FAR struct tun_device_s *priv);
@@ -282,9 +319,9 @@ static void tun_unlock(FAR struct tun_device_s *priv)
  ****************************************************************************/
 
 #ifndef CONFIG_DISABLE_POLL
-static void tun_pollnotify(FAR struct tun_device_s *priv, pollevent_t eventset)
+static void tun_pollnotify(FAR struct tun_queue_s *q, pollevent_t eventset)
 {
-  FAR struct pollfd *fds = priv->poll_fds;
+  FAR struct pollfd *fds = q->poll_fds;
 
   if (fds == NULL)
     {
@@ -300,9 +337,116 @@ static void tun_pollnotify(FAR struct tun_device_s *priv, pollevent_t eventset)
     }
 }
 #else
-#  define tun_pollnotify(dev, event)
+#  define tun_pollnotify(q, event)
 #endif
 
+/****************************************************************************
+ * Name: tun_txready
+ *
+ * Description:
+ *   Return true if every attached queue has room for another packet.
+ *
+ ****************************************************************************/
+
+static bool tun_txready(FAR struct tun_device_s *priv)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      FAR struct tun_queue_s *q = &priv->queues[i];
+
+      if (q->filep != NULL && q->count >= CONFIG_NET_TUN_QUEUELEN)
+        {
+          return false;
+        }
+    }
+
+  return priv->nqueues > 0;
+}
+
+/****************************************************************************
+ * Name: tun_selectq
+ *
+ * Description:
+ *   Select the queue for the packet in d_buf.  With several queues, the
+ *   queue is selected by a hash of the IP addresses so that the packets of
+ *   one flow stay in order.
+ *
+ ****************************************************************************/
+
+static FAR struct tun_queue_s *tun_selectq(FAR struct tun_device_s *priv)
+{
+  FAR const uint8_t *ip;
+  unsigned int hash = 0;
+  unsigned int start = 0;
+  unsigned int end = 0;
+  unsigned int n;
+  int i;
+
+  if (priv->nqueues > 1)
+    {
+      ip = priv->dev.d_buf + priv->dev.d_llhdrlen;
+      n  = priv->dev.d_len > priv->dev.d_llhdrlen ?
+           priv->dev.d_len - priv->dev.d_llhdrlen : 0;
+
+      if (n >= 20 && (ip[0] >> 4) == 4)
+        {
+          start = 12;  /* IPv4 source and destination addresses */
+          end   = 20;
+        }
+      else if (n >= 40 && (ip[0] >> 4) == 6)
+        {
+          start = 8;   /* IPv6 source and destination addresses */
+          end   = 40;
+        }
+
+      for (i = start; i < end; i++)
+        {
+          hash = hash * 31 + ip[i];
+        }
+
+      hash %= priv->nqueues;
+    }
+
+  /* Return the selected one of the attached queues */
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queues[i].filep != NULL && hash-- == 0)
+        {
+          return &priv->queues[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tun_dequeue
+ *
+ * Description:
+ *   Remove and return the oldest packet of a queue.  The queue must not be
+ *   empty.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *tun_dequeue(FAR struct tun_queue_s *q)
+{
+  FAR struct iob_s *iob = q->pkts[q->head];
+
+  DEBUGASSERT(q->count > 0);
+
+  q->pkts[q->head] = NULL;
+  if (++q->head >= CONFIG_NET_TUN_QUEUELEN)
+    {
+      q->head = 0;
+    }
+
+  q->count--;
+  return iob;
+}
+
 /****************************************************************************
  * Name: tun_transmit
  *
@@ -325,20 +469,55 @@ static void tun_pollnotify(FAR struct tun_device_s *priv, pollevent_t eventset)
 
 static int tun_fd_transmit(FAR struct tun_device_s *priv)
 {
+  FAR struct tun_queue_s *q;
+  FAR struct iob_s *iob;
+  int index;
+
   NETDEV_TXPACKETS(&priv->dev);
 
-  /* Verify that the hardware is ready to send another packet.  If we get
-   * here, then we are committed to sending a packet; Higher level logic
-   * must have assured that there is no transmission in progress.
+  /* Copy the packet into an IOB chain on the selected queue.  The packet is
+   * dropped if the queue is full or no IOBs are available.
    */
 
-  if (priv->read_wait)
+  q = tun_selectq(priv);
+  if (q == NULL || q->count >= CONFIG_NET_TUN_QUEUELEN)
+    {
+      NETDEV_TXERRORS(&priv->dev);
+      return -EBUSY;
+    }
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
     {
-      priv->read_wait = false;
-      sem_post(&priv->read_wait_sem);
+      NETDEV_TXERRORS(&priv->dev);
+      return -ENOMEM;
     }
 
-  tun_pollnotify(priv, POLLIN);
+  if (iob_trycopyin(iob, priv->dev.d_buf, priv->dev.d_len, 0, false) < 0)
+    {
+      iob_free_chain(iob);
+      NETDEV_TXERRORS(&priv->dev);
+      return -ENOMEM;
+    }
+
+  index = q->head + q->count;
+  if (index >= CONFIG_NET_TUN_QUEUELEN)
+    {
+      index -= CONFIG_NET_TUN_QUEUELEN;
+    }
+
+  q->pkts[index] = iob;
+  q->count++;
+
+  /* Wake up the reader */
+
+  if (q->read_wait)
+    {
+      q->read_wait = false;
+      sem_post(&q->read_wait_sem);
+    }
+
+  tun_pollnotify(q, POLLIN);
   return OK;
 }
 
@@ -379,10 +558,14 @@ static int tun_txpoll(struct net_driver_s *dev)
     {
       /* Send the packet */
 
-      priv->read_d_len = priv->dev.d_len;
-      tun_fd_transmit(priv);
+      (void)tun_fd_transmit(priv);
+
+      /* Continue polling while every queue has room for another packet */
 
-      return 1;
+      if (!tun_txready(priv))
+        {
+          return 1;
+        }
     }
 
   /* If zero is returned, the polling will continue until all connections have
@@ -444,18 +627,12 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
 
       if (priv->dev.d_len > 0)
         {
-          priv->write_d_len = priv->dev.d_len;
-          tun_fd_transmit(priv);
-        }
-      else
-        {
-          tun_pollnotify(priv, POLLOUT);
+          (void)tun_fd_transmit(priv);
         }
     }
   else
     {
       priv->dev.d_len = 0;
-      tun_pollnotify(priv, POLLOUT);
     }
 
 #elif defined(CONFIG_NET_IPv6)
@@ -475,18 +652,12 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
 
       if (priv->dev.d_len > 0)
         {
-          priv->write_d_len = priv->dev.d_len;
-          tun_fd_transmit(priv);
-        }
-      else
-        {
-          tun_pollnotify(priv, POLLOUT);
+          (void)tun_fd_transmit(priv);
         }
     }
   else
     {
-      priv->write_d_len = 0;
-      tun_pollnotify(priv, POLLOUT);
+      priv->dev.d_len = 0;
     }
 
 #else
@@ -513,14 +684,13 @@ static void tun_net_receive(FAR struct tun_device_s *priv)
 
 static void tun_txdone(FAR struct tun_device_s *priv)
 {
-  /* Check for errors and update statistics */
-
-  NETDEV_TXDONE(&priv->dev);
+  /* Poll the network for new XMIT data if there is room for it */
 
-  /* Then poll the network for new XMIT data */
-
-  priv->dev.d_buf = priv->read_buf;
-  (void)devif_poll(&priv->dev, tun_txpoll);
+  if (tun_txready(priv))
+    {
+      priv->dev.d_buf = priv->buf;
+      (void)devif_poll(&priv->dev, tun_txpoll);
+    }
 }
 
 /****************************************************************************
@@ -553,11 +723,11 @@ static void tun_poll_work(FAR void *arg)
    * the TX poll if he are unable to accept another packet for transmission.
    */
 
-  if (priv->read_d_len == 0)
+  if (tun_txready(priv))
     {
       /* If so, poll the network for new XMIT data. */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = priv->buf;
       (void)devif_timer(&priv->dev, tun_txpoll);
     }
 
@@ -710,7 +880,7 @@ static void tun_txavail_work(FAR void *arg)
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len != 0 || priv->write_d_len != 0)
+  if (!tun_txready(priv))
     {
       tun_unlock(priv);
       return;
@@ -721,7 +891,7 @@ static void tun_txavail_work(FAR void *arg)
     {
       /* Poll the network for new XMIT data */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = priv->buf;
       (void)devif_poll(&priv->dev, tun_txpoll);
     }
 
@@ -838,6 +1008,55 @@ static void tun_ipv6multicast(FAR struct tun_device_s *priv)
 }
 #endif /* CONFIG_NET_ICMPv6 */
 
+/****************************************************************************
+ * Name: tun_queue_attach
+ *
+ * Description:
+ *   Attach a file to an unused queue of the TUN device
+ *
+ ****************************************************************************/
+
+static void tun_queue_attach(FAR struct tun_device_s *priv,
+                             FAR struct tun_queue_s *q,
+                             FAR struct file *filep)
+{
+  memset(q, 0, sizeof(struct tun_queue_s));
+  q->priv  = priv;
+  q->filep = filep;
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_init(&q->read_wait_sem, 0, 0);
+  sem_setprotocol(&q->read_wait_sem, SEM_PRIO_NONE);
+
+  priv->nqueues++;
+  filep->f_priv = q;                  /* Set link to TUN queue */
+}
+
+/****************************************************************************
+ * Name: tun_queue_detach
+ *
+ * Description:
+ *   Detach a file from its queue, discarding any packets not yet read
+ *
+ ****************************************************************************/
+
+static void tun_queue_detach(FAR struct tun_queue_s *q)
+{
+  while (q->count > 0)
+    {
+      iob_free_chain(tun_dequeue(q));
+    }
+
+  sem_destroy(&q->read_wait_sem);
+
+  q->filep->f_priv = NULL;
+  q->filep = NULL;
+  q->priv->nqueues--;
+}
+
 /****************************************************************************
  * Name: tun_dev_init
  *
@@ -868,28 +1087,17 @@ static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
   priv->dev.d_addmac  = tun_addmac;   /* Add multicast MAC address */
   priv->dev.d_rmmac   = tun_rmmac;    /* Remove multicast MAC address */
 #endif
+  priv->dev.d_buf     = priv->buf;    /* Single packet buffer */
   priv->dev.d_private = (FAR void *)priv; /* Used to recover private state from dev */
 
-  /* Initialize the mutual exlcusion and wait semaphore */
+  /* Initialize the mutual exlcusion semaphore */
 
   sem_init(&priv->waitsem, 0, 1);
-  sem_init(&priv->read_wait_sem, 0, 0);
-
-  /* The wait semaphore is used for signaling and, hence, should not have
-   * priority inheritance enabled.
-   */
-
-  sem_setprotocol(&priv->read_wait_sem, SEM_PRIO_NONE);
 
   /* Create a watchdog for timing polling for and timing of transmisstions */
 
   priv->txpoll        = wd_create();  /* Create periodic poll timer */
 
-  /* Initialize other variables */
-
-  priv->write_d_len   = 0;
-  priv->read_wait     = false;
-
   /* Put the interface in the down state */
 
   tun_ifdown(&priv->dev);
@@ -905,13 +1113,12 @@ static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
   if (ret != OK)
     {
       sem_destroy(&priv->waitsem);
-      sem_destroy(&priv->read_wait_sem);
       return ret;
     }
 
-  priv->filep         = filep;        /* Set link to file */
-  filep->f_priv       = priv;         /* Set link to TUN device */
+  /* Attach the file to the first queue */
 
+  tun_queue_attach(priv, &priv->queues[0], filep);
   return ret;
 }
 
@@ -930,7 +1137,6 @@ static int tun_dev_uninit(FAR struct tun_device_s *priv)
   (void)netdev_unregister(&priv->dev);
 
   sem_destroy(&priv->waitsem);
-  sem_destroy(&priv->read_wait_sem);
 
   return OK;
 }
@@ -954,19 +1160,32 @@ static int tun_close(FAR struct file *filep)
 {
   FAR struct inode *inode       = filep->f_inode;
   FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *q     = filep->f_priv;
+  FAR struct tun_device_s *priv;
   int intf;
 
-  if (!priv)
+  if (!q)
     {
       return OK;
     }
 
+  priv = q->priv;
   intf = priv - g_tun_devices;
   tundev_lock(tun);
 
-  tun->free_tuns |= (1 << intf);
-  (void)tun_dev_uninit(priv);
+  tun_lock(priv);
+  net_lock();
+  tun_queue_detach(q);
+  net_unlock();
+  tun_unlock(priv);
+
+  /* The interface is removed when its last file is closed */
+
+  if (priv->nqueues == 0)
+    {
+      tun->free_tuns |= (1 << intf);
+      (void)tun_dev_uninit(priv);
+    }
 
   tundev_unlock(tun);
 
@@ -975,125 +1194,192 @@ static int tun_close(FAR struct file *filep)
 
 /****************************************************************************
  * Name: tun_write
+ *
+ * Description:
+ *   Pass packets to the network.  The buffer holds one packet or, with
+ *   IFF_MULTI_PKT, a sequence of packets each preceded by its length as a
+ *   2-byte, big-endian value.  The number of bytes of the whole packets
+ *   taken is returned.
+ *
  ****************************************************************************/
 
 static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
-  ssize_t ret;
-
-  if (!priv)
+  FAR struct tun_queue_s *q = filep->f_priv;
+  FAR struct tun_device_s *priv;
+  size_t nwritten = 0;
+  size_t offset;
+  size_t pktlen;
+  ssize_t ret = OK;
+
+  if (!q)
     {
       return -EINVAL;
     }
 
+  priv = q->priv;
   tun_lock(priv);
+  net_lock();
 
-  if (priv->write_d_len > 0)
+  while (nwritten < buflen)
     {
-      tun_unlock(priv);
-      return -EBUSY;
-    }
+      /* There must be room for any response to the packet */
 
-  net_lock();
+      if (!tun_txready(priv))
+        {
+          ret = -EBUSY;
+          break;
+        }
 
-  if (buflen > CONFIG_NET_TUN_MTU)
-    {
-      ret = -EINVAL;
-    }
-  else
-    {
-      memcpy(priv->write_buf, buffer, buflen);
+      offset = nwritten;
+      if ((priv->flags & IFF_MULTI_PKT) != 0)
+        {
+          if (buflen - offset < TUN_PKTHDRLEN)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          pktlen  = (size_t)(uint8_t)buffer[offset] << 8 |
+                    (uint8_t)buffer[offset + 1];
+          offset += TUN_PKTHDRLEN;
+
+          if (pktlen > buflen - offset)
+            {
+              ret = -EINVAL;
+              break;
+            }
+        }
+      else
+        {
+          pktlen = buflen;
+        }
+
+      if (pktlen > CONFIG_NET_TUN_MTU)
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      memcpy(priv->buf, &buffer[offset], pktlen);
 
-      priv->dev.d_buf = priv->write_buf;
-      priv->dev.d_len = buflen;
+      priv->dev.d_buf = priv->buf;
+      priv->dev.d_len = pktlen;
 
       tun_net_receive(priv);
 
-      ret = (ssize_t)buflen;
+      nwritten = offset + pktlen;
     }
 
   net_unlock();
   tun_unlock(priv);
 
-  return ret;
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
 }
 
 /****************************************************************************
  * Name: tun_read
+ *
+ * Description:
+ *   Return the oldest packet of the queue or, with IFF_MULTI_PKT, as many
+ *   of the queued packets as fit, each preceded by its length as a 2-byte,
+ *   big-endian value.
+ *
  ****************************************************************************/
 
 static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
-  ssize_t ret;
-  size_t write_d_len;
-  size_t read_d_len;
-
-  if (!priv)
+  FAR struct tun_queue_s *q = filep->f_priv;
+  FAR struct tun_device_s *priv;
+  FAR struct iob_s *iob;
+  size_t nread = 0;
+  size_t hdrlen;
+  size_t pktlen;
+  ssize_t ret = OK;
+  bool ready;
+  int i;
+
+  if (!q)
     {
       return -EINVAL;
     }
 
+  priv = q->priv;
   tun_lock(priv);
 
-  /* Check if there are data to read in write buffer */
+  /* Wait for a packet */
 
-  write_d_len = priv->write_d_len;
-  if (write_d_len > 0)
+  while (q->count == 0)
     {
-      if (buflen < write_d_len)
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
-          ret = -EINVAL;
+          ret = -EAGAIN;
           goto out;
         }
 
-      memcpy(buffer, priv->write_buf, write_d_len);
-      ret = (ssize_t)write_d_len;
+      q->read_wait = true;
+      tun_unlock(priv);
+      sem_wait(&q->read_wait_sem);
+      tun_lock(priv);
+    }
+
+  net_lock();
 
-      priv->write_d_len = 0;
-      tun_pollnotify(priv, POLLOUT);
+  ready  = tun_txready(priv);
+  hdrlen = (priv->flags & IFF_MULTI_PKT) != 0 ? TUN_PKTHDRLEN : 0;
+
+  while (q->count > 0)
+    {
+      iob    = q->pkts[q->head];
+      pktlen = iob->io_pktlen;
 
-      if (priv->read_d_len == 0)
+      if (buflen - nread < hdrlen + pktlen)
         {
-          net_lock();
-          tun_txdone(priv);
-          net_unlock();
-        }
+          if (nread == 0)
+            {
+              /* The packet does not fit, drop it */
 
-      goto out;
-    }
+              iob_free_chain(tun_dequeue(q));
+              ret = -EINVAL;
+            }
 
-  if (priv->read_d_len == 0)
-    {
-      if ((filep->f_oflags & O_NONBLOCK) != 0)
+          break;
+        }
+
+      if (hdrlen > 0)
         {
-          ret = -EAGAIN;
-          goto out;
+          buffer[nread]     = (char)(pktlen >> 8);
+          buffer[nread + 1] = (char)(pktlen & 0xff);
         }
 
-      priv->read_wait = true;
-      tun_unlock(priv);
-      sem_wait(&priv->read_wait_sem);
-      tun_lock(priv);
-    }
+      (void)iob_copyout((FAR uint8_t *)&buffer[nread + hdrlen], iob,
+                        pktlen, 0);
+      nread += hdrlen + pktlen;
 
-  net_lock();
+      iob_free_chain(tun_dequeue(q));
+      NETDEV_TXDONE(&priv->dev);
 
-  read_d_len = priv->read_d_len;
-  if (buflen < read_d_len)
-    {
-      ret = -EINVAL;
+      if (hdrlen == 0)
+        {
+          break;
+        }
     }
-  else
+
+  /* Writes may proceed again if this read made room */
+
+  if (!ready && tun_txready(priv))
     {
-      memcpy(buffer, priv->read_buf, read_d_len);
-      ret = (ssize_t)read_d_len;
+      for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+        {
+          if (priv->queues[i].filep != NULL)
+            {
+              tun_pollnotify(&priv->queues[i], POLLOUT);
+            }
+        }
     }
 
-  priv->read_d_len = 0;
   tun_txdone(priv);
 
   net_unlock();
@@ -1101,7 +1387,7 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 out:
   tun_unlock(priv);
 
-  return ret;
+  return nread > 0 ? (ssize_t)nread : ret;
 }
 
 /****************************************************************************
@@ -1111,60 +1397,55 @@ out:
 #ifndef CONFIG_DISABLE_POLL
 int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 {
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *q = filep->f_priv;
+  FAR struct tun_device_s *priv;
   pollevent_t eventset;
   int ret = OK;
 
-  if (!priv)
-    {
-      return -EINVAL;
-    }
-
   /* Some sanity checking */
 
-  if (!priv || !fds)
+  if (!q || !fds)
     {
       return -ENODEV;
     }
 
+  priv = q->priv;
   tun_lock(priv);
 
   if (setup)
     {
-      if (priv->poll_fds)
+      if (q->poll_fds)
         {
           ret = -EBUSY;
           goto errout;
         }
 
-      priv->poll_fds = fds;
+      q->poll_fds = fds;
 
       eventset = 0;
 
-      /* If write buffer is empty notify App.  */
+      /* If there is room for responses notify App.  */
 
-      if (priv->write_d_len == 0)
+      if (tun_txready(priv))
         {
           eventset |= (fds->events & POLLOUT);
         }
 
-      /* The write buffer sometimes could be used for TX.
-       * So check it too.
-       */
+      /* Are there packets to read? */
 
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (q->count > 0)
         {
           eventset |= (fds->events & POLLIN);
         }
 
       if (eventset)
         {
-          tun_pollnotify(priv, eventset);
+          tun_pollnotify(q, eventset);
         }
     }
   else
     {
-      priv->poll_fds = 0;
+      q->poll_fds = 0;
     }
 
 errout:
@@ -1174,6 +1455,49 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: tun_queue_add
+ *
+ * Description:
+ *   Attach a file to another queue of an existing IFF_MULTI_QUEUE interface.
+ *
+ ****************************************************************************/
+
+static int tun_queue_add(FAR struct tun_device_s *priv,
+                         FAR struct file *filep, uint8_t flags)
+{
+  int ret = -EBUSY;
+  int i;
+
+  if ((priv->flags & IFF_MULTI_QUEUE) == 0)
+    {
+      return -EBUSY;
+    }
+
+  if (priv->flags != flags)
+    {
+      return -EINVAL;
+    }
+
+  tun_lock(priv);
+  net_lock();
+
+  for (i = 0; i < CONFIG_NET_TUN_NQUEUES; i++)
+    {
+      if (priv->queues[i].filep == NULL)
+        {
+          tun_queue_attach(priv, &priv->queues[i], filep);
+          ret = OK;
+          break;
+        }
+    }
+
+  net_unlock();
+  tun_unlock(priv);
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: tun_ioctl
  ****************************************************************************/
@@ -1182,10 +1506,11 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct inode *inode       = filep->f_inode;
   FAR struct tun_driver_s *tun  = inode->i_private;
-  FAR struct tun_device_s *priv = filep->f_priv;
+  FAR struct tun_queue_s *q     = filep->f_priv;
+  FAR struct tun_device_s *priv;
   int ret = OK;
 
-  if (cmd == TUNSETIFF && priv == NULL)
+  if (cmd == TUNSETIFF && q == NULL)
     {
       uint8_t free_tuns;
       int intf;
@@ -1199,6 +1524,24 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       tundev_lock(tun);
 
+      /* A multi-queue interface of the same name gets another queue */
+
+      if ((ifr->ifr_flags & IFF_MULTI_QUEUE) != 0 && *ifr->ifr_name)
+        {
+          for (intf = 0; intf < CONFIG_TUN_NINTERFACES; intf++)
+            {
+              priv = &g_tun_devices[intf];
+              if ((tun->free_tuns & (1 << intf)) == 0 &&
+                  strncmp(priv->dev.d_ifname, ifr->ifr_name,
+                          IFNAMSIZ) == 0)
+                {
+                  ret = tun_queue_add(priv, filep, ifr->ifr_flags);
+                  tundev_unlock(tun);
+                  return ret;
+                }
+            }
+        }
+
       free_tuns = tun->free_tuns;
 
       if (free_tuns == 0)
@@ -1221,7 +1564,8 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       tun->free_tuns &= ~(1 << intf);
 
-      priv = filep->f_priv;
+      priv = &g_tun_devices[intf];
+      priv->flags = ifr->ifr_flags;
       strncpy(ifr->ifr_name, priv->dev.d_ifname, IFNAMSIZ);
 
 #ifdef CONFIG_NET_ETHERNET
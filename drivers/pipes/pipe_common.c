@@ -79,11 +79,25 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+#ifndef MIN
+#  define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static void pipecommon_semtake(sem_t *sem);
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR char *buffer, size_t len);
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const char *buffer, size_t len);
+#ifdef CONFIG_DEV_PIPE_FASTPATH
+static ssize_t pipecommon_fastread(FAR struct pipe_dev_s *dev,
+                                   FAR char *buffer, size_t len);
+static ssize_t pipecommon_fastwrite(FAR struct pipe_dev_s *dev,
+                                    FAR const char *buffer, size_t len);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -138,7 +152,7 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              sem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -147,6 +161,193 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the circular buffer.  The data may wrap
+ *   around the end of d_buffer, so this takes at most two copies.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR char *buffer, size_t len)
+{
+  size_t nread = 0;
+  size_t nbytes;
+
+  while (nread < len && dev->d_wrndx != dev->d_rdndx)
+    {
+      if (dev->d_wrndx > dev->d_rdndx)
+        {
+          nbytes = dev->d_wrndx - dev->d_rdndx;
+        }
+      else
+        {
+          nbytes = dev->d_bufsize - dev->d_rdndx;
+        }
+
+      nbytes = MIN(nbytes, len - nread);
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+
+      if (dev->d_rdndx + nbytes >= dev->d_bufsize)
+        {
+          dev->d_rdndx = 0;
+        }
+      else
+        {
+          dev->d_rdndx += nbytes;
+        }
+
+      buffer += nbytes;
+      nread  += nbytes;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Add up to 'len' bytes to the circular buffer.  One byte is always left
+ *   unused so that a full buffer can be distinguished from an empty one.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const char *buffer, size_t len)
+{
+  size_t nwritten = 0;
+  size_t nbytes;
+
+  while (nwritten < len)
+    {
+      /* How much contiguous space is there at d_wrndx? */
+
+      if (dev->d_rdndx > dev->d_wrndx)
+        {
+          nbytes = dev->d_rdndx - dev->d_wrndx - 1;
+        }
+      else
+        {
+          nbytes = dev->d_bufsize - dev->d_wrndx;
+          if (dev->d_rdndx == 0)
+            {
+              nbytes--;
+            }
+        }
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+
+      nbytes = MIN(nbytes, len - nwritten);
+      memcpy(&dev->d_buffer[dev->d_wrndx], buffer, nbytes);
+
+      if (dev->d_wrndx + nbytes >= dev->d_bufsize)
+        {
+          dev->d_wrndx = 0;
+        }
+      else
+        {
+          dev->d_wrndx += nbytes;
+        }
+
+      buffer   += nbytes;
+      nwritten += nbytes;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_fastread/pipecommon_fastwrite
+ *
+ * Description:
+ *   Transfer data without taking d_bfsem.  This is only possible when the
+ *   transfer can complete without waiting and no other thread is inside
+ *   the locked read/write logic.  With only one CPU, locking the scheduler
+ *   is all that is needed to keep other threads out while the buffer is
+ *   updated.  The normal, semaphore-based logic is used whenever these
+ *   return zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_FASTPATH
+static ssize_t pipecommon_fastread(FAR struct pipe_dev_s *dev,
+                                   FAR char *buffer, size_t len)
+{
+  ssize_t nread = 0;
+  int sval;
+
+  sched_lock();
+  if (sem_getvalue(&dev->d_bfsem, &sval) == 0 && sval > 0 &&
+      dev->d_buffer != NULL && dev->d_wrndx != dev->d_rdndx)
+    {
+      nread = pipecommon_copyout(dev, buffer, len);
+
+      /* Notify all waiting writers that bytes have been removed from the
+       * buffer and all poll/select waiters that they can write.
+       */
+
+      while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
+        {
+          sem_post(&dev->d_wrsem);
+        }
+
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  sched_unlock();
+  return nread;
+}
+
+static ssize_t pipecommon_fastwrite(FAR struct pipe_dev_s *dev,
+                                    FAR const char *buffer, size_t len)
+{
+  ssize_t nwritten = 0;
+  size_t nfree;
+  int sval;
+
+  sched_lock();
+  if (sem_getvalue(&dev->d_bfsem, &sval) == 0 && sval > 0 &&
+      dev->d_buffer != NULL && dev->d_rdwait == NULL)
+    {
+      /* The whole write must fit or we would have to wait */
+
+      if (dev->d_wrndx >= dev->d_rdndx)
+        {
+          nfree = dev->d_bufsize - 1 - (dev->d_wrndx - dev->d_rdndx);
+        }
+      else
+        {
+          nfree = dev->d_rdndx - dev->d_wrndx - 1;
+        }
+
+      if (len <= nfree)
+        {
+          nwritten = pipecommon_copyin(dev, buffer, len);
+
+          /* Notify all waiting readers and all poll/select waiters that
+           * more data is available.
+           */
+
+          while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+            {
+              sem_post(&dev->d_rdsem);
+            }
+
+          pipecommon_pollnotify(dev, POLLIN);
+        }
+    }
+
+  sched_unlock();
+  return nwritten;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -427,6 +628,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 #ifdef CONFIG_DEV_PIPEDUMP
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
+  struct pipe_rdwait_s   rdwait;
   ssize_t                nread  = 0;
   int                    sval;
   int                    ret;
@@ -438,6 +640,17 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
+#ifdef CONFIG_DEV_PIPE_FASTPATH
+  /* Try to get the data without taking the semaphore */
+
+  nread = pipecommon_fastread(dev, buffer, len);
+  if (nread > 0)
+    {
+      pipe_dumpbuffer("From PIPE:", start, nread);
+      return nread;
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   if (sem_wait(&dev->d_bfsem) < 0)
@@ -465,33 +678,57 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
           return 0;
         }
 
-      /* Otherwise, wait for something to be written to the pipe */
+      /* Otherwise, wait for something to be written to the pipe.  If no
+       * other reader is already waiting, then offer our buffer to the
+       * writer so that it can copy its data directly into it, bypassing
+       * d_buffer.
+       */
+
+      rdwait.rw_buffer = (FAR uint8_t *)buffer;
+      rdwait.rw_buflen = len;
+      rdwait.rw_nread  = 0;
+
+      if (dev->d_rdwait == NULL)
+        {
+          dev->d_rdwait = &rdwait;
+        }
 
       sched_lock();
       sem_post(&dev->d_bfsem);
       ret = sem_wait(&dev->d_rdsem);
       sched_unlock();
 
-      if (ret < 0 || sem_wait(&dev->d_bfsem) < 0)
+      /* We must get d_bfsem back even if we were interrupted:  A writer
+       * may already have copied data into our buffer.
+       */
+
+      pipecommon_semtake(&dev->d_bfsem);
+      if (dev->d_rdwait == &rdwait)
         {
-          return ERROR;
+          dev->d_rdwait = NULL;
         }
-    }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
-
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      if (rdwait.rw_nread > 0)
         {
-          dev->d_rdndx = 0;
+          nread = rdwait.rw_nread;
+          sem_post(&dev->d_bfsem);
+          pipe_dumpbuffer("From PIPE:", start, nread);
+          return nread;
         }
 
-      nread++;
+      if (ret < 0)
+        {
+          sem_post(&dev->d_bfsem);
+          return ERROR;
+        }
     }
 
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).
+   */
+
+  nread = pipecommon_copyout(dev, buffer, len);
+
   /* Notify all waiting writers that bytes have been removed from the buffer */
 
   while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
@@ -517,9 +754,10 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
+  FAR struct pipe_rdwait_s *rdwait;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
+  size_t                 nbytes;
   int                    sval;
 
   DEBUGASSERT(dev);
@@ -544,6 +782,15 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
+#ifdef CONFIG_DEV_PIPE_FASTPATH
+  /* Try to add the data without taking the semaphore */
+
+  if (pipecommon_fastwrite(dev, buffer, len) > 0)
+    {
+      return len;
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
   if (sem_wait(&dev->d_bfsem) < 0)
@@ -556,26 +803,44 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   last = 0;
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* If a reader is blocked on the empty pipe, then copy directly into
+       * the reader's buffer.  All waiting readers are awakened; those that
+       * did not receive the data will just wait again.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      rdwait = dev->d_rdwait;
+      if (rdwait != NULL && dev->d_wrndx == dev->d_rdndx)
         {
-          nxtwrndx = 0;
+          nbytes = MIN(rdwait->rw_buflen, len - nwritten);
+          memcpy(rdwait->rw_buffer, buffer, nbytes);
+          rdwait->rw_nread = nbytes;
+          dev->d_rdwait    = NULL;
+
+          buffer   += nbytes;
+          nwritten += nbytes;
+
+          while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
+            {
+              sem_post(&dev->d_rdsem);
+            }
+
+          if ((size_t)nwritten >= len)
+            {
+              sem_post(&dev->d_bfsem);
+              return len;
+            }
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Copy as much as will fit into the circular buffer */
 
-      if (nxtwrndx != dev->d_rdndx)
+      nbytes = pipecommon_copyin(dev, buffer, len - nwritten);
+      if (nbytes > 0)
         {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          buffer += nbytes;
 
           /* Is the write complete? */
 
-          nwritten++;
+          nwritten += nbytes;
           if ((size_t)nwritten >= len)
             {
               /* Yes.. Notify all of the waiting readers that more data is available */
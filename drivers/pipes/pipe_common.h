@@ -127,6 +127,17 @@ typedef uint8_t pipe_ndx_t;   /*  8-bit index */
  * device is registered.
  */
 
+/* This describes a reader that is blocked waiting for data.  A writer
+ * that finds the pipe empty copies directly into the reader's buffer.
+ */
+
+struct pipe_rdwait_s
+{
+  FAR uint8_t *rw_buffer;  /* The reader's buffer */
+  size_t       rw_buflen;  /* Size of the reader's buffer */
+  size_t       rw_nread;   /* Number of bytes copied by the writer */
+};
+
 struct pipe_dev_s
 {
   sem_t      d_bfsem;       /* Used to serialize access to d_buffer and indices */
@@ -141,6 +152,7 @@ struct pipe_dev_s
   uint8_t    d_pipeno;      /* Pipe minor number */
   uint8_t    d_flags;       /* See PIPE_FLAG_* definitions */
   uint8_t   *d_buffer;      /* Buffer allocated when device opened */
+  FAR struct pipe_rdwait_s *d_rdwait; /* Blocked reader, if any */
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -359,7 +359,7 @@ static int rd_geometry(FAR struct inode *inode, struct geometry *geometry)
  * Name: rd_ioctl
  *
  * Description:
- *   Return device geometry
+ *   Return the address of the RAM disk memory
  *
  ****************************************************************************/
 
@@ -370,10 +370,13 @@ static int rd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
   finfo("Entry\n");
 
-  /* Only one ioctl command is supported */
+  /* The RAM disk content is always directly accessible in memory, so both
+   * the XIP and the direct memory queries are answered with the same
+   * address.
+   */
 
   DEBUGASSERT(inode && inode->i_private);
-  if (cmd == BIOC_XIPBASE && ppv)
+  if ((cmd == BIOC_XIPBASE || cmd == BIOC_MEMBASE) && ppv)
     {
       dev  = (FAR struct rd_struct_s *)inode->i_private;
       *ppv = (FAR void *)dev->rd_buffer;
@@ -816,6 +816,25 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
                 }
             }
 
+          /* If the remaining data would fill the read-ahead buffer anyway,
+           * then there is nothing to be gained by buffering it:  Transfer
+           * it directly into the user buffer with one multi-block read.
+           */
+
+          if (remaining >= rwb->rhmaxblocks)
+            {
+              ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, remaining);
+              if (ret != remaining)
+                {
+                  ferr("ERROR: Failed to read %ld blocks: %d\n",
+                       (long)remaining, ret);
+                  rwb_semgive(&rwb->rhsem);
+                  return ret < 0 ? (ssize_t)ret : -EIO;
+                }
+
+              break;
+            }
+
           /* If we did not get all of the data from the buffer, then we have
            * to refill the buffer and try again.
            */
@@ -826,6 +845,7 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
               if (ret < 0)
                 {
                   ferr("ERROR: Failed to fill the read-ahead buffer: %d\n", ret);
+                  rwb_semgive(&rwb->rhsem);
                   return (ssize_t)ret;
                 }
             }
@@ -840,7 +860,7 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
       ret = nblocks;
     }
   else
-#else
+#endif
     {
       /* No read-ahead buffering, (re)load the data directly into
        * the user buffer.
@@ -848,7 +868,6 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 
       ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, nblocks);
     }
-#endif
 
   return (ssize_t)ret;
 }
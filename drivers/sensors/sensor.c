@@ -0,0 +1,672 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of the upper half driver */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* Lower half state */
+  sem_t exclsem;                 /* Supports mutual exclusion */
+  sem_t waitsem;                 /* Used to wait for samples */
+  uint8_t crefs;                 /* Number of times the device is open */
+  volatile uint8_t nwaiters;     /* Number of readers waiting on waitsem */
+
+  /* The FIFO.  head and tail count the samples ever added and
+   * removed; their difference is the number of samples in the FIFO.
+   */
+
+  volatile uint32_t head;        /* Number of samples added */
+  volatile uint32_t tail;        /* Number of samples removed */
+  uint32_t nsamples;             /* FIFO size in samples */
+  uint32_t overruns;             /* Number of samples discarded */
+  FAR uint8_t *buffer;           /* nsamples * lower->samplesize bytes */
+
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_SENSORS_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_sensorops =
+{
+  sensor_open,  /* open */
+  sensor_close, /* close */
+  sensor_read,  /* read */
+  sensor_write, /* write */
+  NULL,         /* seek */
+  sensor_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , sensor_poll /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL        /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_pollnotify
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void sensor_pollnotify(FAR struct sensor_upperhalf_s *upper,
+                              pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+    {
+      fds = upper->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              sem_post(fds->sem);
+            }
+        }
+    }
+}
+#else
+#  define sensor_pollnotify(upper,eventset)
+#endif
+
+/****************************************************************************
+ * Name: sensor_open
+ *
+ * Description:
+ *   This function is called whenever the sensor device is opened.  The
+ *   first open empties the FIFO and starts the sensor.
+ *
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  uint8_t tmp;
+  int ret;
+
+  ret = sem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  tmp = upper->crefs + 1;
+  if (tmp == 0)
+    {
+      /* More than 255 opens; uint8_t overflows to zero */
+
+      ret = -EMFILE;
+      goto errout_with_sem;
+    }
+
+  if (tmp == 1)
+    {
+      upper->head     = 0;
+      upper->tail     = 0;
+      upper->overruns = 0;
+
+      ret = lower->ops->activate(lower, true);
+      if (ret < 0)
+        {
+          goto errout_with_sem;
+        }
+    }
+
+  upper->crefs = tmp;
+  ret = OK;
+
+errout_with_sem:
+  sem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ *
+ * Description:
+ *   This function is called when the sensor device is closed.  The last
+ *   close stops the sensor.
+ *
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  ret = sem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  if (upper->crefs > 1)
+    {
+      upper->crefs--;
+    }
+  else
+    {
+      upper->crefs = 0;
+      (void)lower->ops->activate(lower, false);
+    }
+
+  sem_post(&upper->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Return as many whole samples as there are in the FIFO and as fit in
+ *   the user buffer.  Blocks until at least one sample is available unless
+ *   the device was opened with O_NONBLOCK.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t samplesize = lower->samplesize;
+  irqstate_t flags;
+  ssize_t nread = 0;
+  bool fetched = false;
+  int ret;
+
+  if (buflen < samplesize)
+    {
+      return -EINVAL;
+    }
+
+  /* Samples are removed one at a time with interrupts disabled:  The lower
+   * half may discard the oldest sample at any time when the FIFO is full.
+   */
+
+  flags = enter_critical_section();
+  while (buflen >= samplesize)
+    {
+      if (upper->head == upper->tail)
+        {
+          if (nread > 0)
+            {
+              break;
+            }
+
+          /* A polled lower half can provide a sample right away */
+
+          if (lower->ops->fetch != NULL && !fetched)
+            {
+              leave_critical_section(flags);
+              ret = lower->ops->fetch(lower);
+              flags = enter_critical_section();
+
+              if (ret < 0)
+                {
+                  nread = ret;
+                  break;
+                }
+
+              fetched = true;
+              continue;
+            }
+
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              nread = -EAGAIN;
+              break;
+            }
+
+          /* Wait for sensor_push() */
+
+          upper->nwaiters++;
+          ret = sem_wait(&upper->waitsem);
+          if (ret < 0)
+            {
+              if (upper->nwaiters > 0)
+                {
+                  upper->nwaiters--;
+                }
+
+              nread = -get_errno();
+              break;
+            }
+
+          continue;
+        }
+
+      memcpy(buffer, &upper->buffer[(upper->tail % upper->nsamples) *
+                                    samplesize], samplesize);
+      upper->tail++;
+
+      buffer += samplesize;
+      buflen -= samplesize;
+      nread  += samplesize;
+    }
+
+  leave_critical_section(flags);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: sensor_write
+ *
+ * Description:
+ *   A dummy write method.  This is provided only to satisfy the VFS layer.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  return -EPERM;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+  int ret;
+
+  ret = sem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  switch (cmd)
+    {
+      /* SNIOC_SET_INTERVAL - Set the sampling interval.
+       *   Argument: uint32_t pointer to the interval in microseconds.
+       */
+
+      case SNIOC_SET_INTERVAL:
+        {
+          FAR uint32_t *period = (FAR uint32_t *)((uintptr_t)arg);
+
+          DEBUGASSERT(period != NULL);
+          if (lower->ops->set_interval != NULL)
+            {
+              ret = lower->ops->set_interval(lower, period);
+            }
+          else
+            {
+              ret = -ENOTSUP;
+            }
+        }
+        break;
+
+      /* SNIOC_BATCH - Set the maximum delivery latency.
+       *   Argument: uint32_t latency in microseconds.
+       */
+
+      case SNIOC_BATCH:
+        if (lower->ops->batch != NULL)
+          {
+            ret = lower->ops->batch(lower, (uint32_t)arg);
+          }
+        else
+          {
+            /* Without a hardware FIFO, every sample is delivered right
+             * away, which satisfies any latency.
+             */
+
+            ret = OK;
+          }
+        break;
+
+      /* SNIOC_GET_OVERRUNS - Get and reset the number of lost samples.
+       *   Argument: uint32_t pointer to the location to return the count.
+       */
+
+      case SNIOC_GET_OVERRUNS:
+        {
+          FAR uint32_t *overruns = (FAR uint32_t *)((uintptr_t)arg);
+
+          DEBUGASSERT(overruns != NULL);
+          flags = enter_critical_section();
+          *overruns = upper->overruns;
+          upper->overruns = 0;
+          leave_critical_section(flags);
+        }
+        break;
+
+      /* Anything else might be a lower half specific command */
+
+      default:
+        if (lower->ops->ioctl != NULL)
+          {
+            ret = lower->ops->ioctl(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  sem_post(&upper->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = sem_wait(&upper->exclsem);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      flags = enter_critical_section();
+      for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (upper->head != upper->tail)
+        {
+          /* Samples are already available */
+
+          sensor_pollnotify(upper, POLLIN);
+        }
+
+      leave_critical_section(flags);
+    }
+  else if (fds->priv != NULL)
+    {
+      /* Tear down the poll */
+
+      slot       = (FAR struct pollfd **)fds->priv;
+      flags      = enter_critical_section();
+      *slot      = NULL;
+      fds->priv  = NULL;
+      leave_critical_section(flags);
+    }
+
+  sem_post(&upper->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Add samples to the FIFO of the sensor and wake up any readers.  If the
+ *   FIFO is full, the oldest samples are discarded.  May be called from
+ *   interrupt handlers.
+ *
+ * Input Parameters:
+ *   lower    - The lower half that the samples are from
+ *   samples  - 'nsamples' samples of lower->samplesize bytes each
+ *   nsamples - The number of samples
+ *
+ ****************************************************************************/
+
+void sensor_push(FAR struct sensor_lowerhalf_s *lower,
+                 FAR const void *samples, unsigned int nsamples)
+{
+  FAR struct sensor_upperhalf_s *upper = lower->upper;
+  FAR const uint8_t *src = (FAR const uint8_t *)samples;
+  size_t samplesize = lower->samplesize;
+  irqstate_t flags;
+
+  DEBUGASSERT(upper != NULL);
+
+  flags = enter_critical_section();
+  for (; nsamples > 0; nsamples--)
+    {
+      /* The newest samples are the most useful ones, so discard the oldest
+       * if the FIFO is full.
+       */
+
+      if (upper->head - upper->tail >= upper->nsamples)
+        {
+          upper->tail++;
+          upper->overruns++;
+        }
+
+      memcpy(&upper->buffer[(upper->head % upper->nsamples) * samplesize],
+             src, samplesize);
+      upper->head++;
+      src += samplesize;
+    }
+
+  /* Wake up all readers and pollers */
+
+  while (upper->nwaiters > 0)
+    {
+      upper->nwaiters--;
+      sem_post(&upper->waitsem);
+    }
+
+  sensor_pollnotify(upper, POLLIN);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds, as used for the timestamp of
+ *   the samples.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor lower half as the character device 'devpath' with a
+ *   FIFO of 'nsamples' samples.
+ *
+ * Input Parameters:
+ *   devpath  - The full path to the driver to register, e.g. "/dev/accel0"
+ *   lower    - An instance of the lower half interface
+ *   nsamples - The number of samples the FIFO can hold
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *devpath,
+                    FAR struct sensor_lowerhalf_s *lower,
+                    unsigned int nsamples)
+{
+  FAR struct sensor_upperhalf_s *upper;
+  int ret;
+
+  DEBUGASSERT(devpath != NULL && lower != NULL && lower->ops != NULL &&
+              lower->ops->activate != NULL && nsamples > 0 &&
+              lower->samplesize >= sizeof(struct sensor_sample_s));
+
+  upper = (FAR struct sensor_upperhalf_s *)
+    kmm_zalloc(sizeof(struct sensor_upperhalf_s));
+  if (upper == NULL)
+    {
+      snerr("ERROR: Allocation failed\n");
+      return -ENOMEM;
+    }
+
+  upper->buffer = (FAR uint8_t *)kmm_malloc(nsamples * lower->samplesize);
+  if (upper->buffer == NULL)
+    {
+      snerr("ERROR: FIFO allocation failed\n");
+      ret = -ENOMEM;
+      goto errout_with_upper;
+    }
+
+  sem_init(&upper->exclsem, 0, 1);
+  sem_init(&upper->waitsem, 0, 0);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_setprotocol(&upper->waitsem, SEM_PRIO_NONE);
+
+  upper->lower    = lower;
+  upper->nsamples = nsamples;
+  lower->upper    = upper;
+
+  ret = register_driver(devpath, &g_sensorops, 0444, upper);
+  if (ret < 0)
+    {
+      snerr("ERROR: register_driver failed: %d\n", ret);
+      goto errout_with_sem;
+    }
+
+  return OK;
+
+errout_with_sem:
+  lower->upper = NULL;
+  sem_destroy(&upper->waitsem);
+  sem_destroy(&upper->exclsem);
+  kmm_free(upper->buffer);
+
+errout_with_upper:
+  kmm_free(upper);
+  return ret;
+}
+
+#endif /* CONFIG_SENSORS_UPPERHALF */
@@ -88,6 +88,8 @@ static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 /* Write support */
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static size_t  uart_putxmitblock(FAR uart_dev_t *dev, FAR const char *buffer,
+                                 size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev);
@@ -96,6 +98,8 @@ static int     uart_tcdrain(FAR uart_dev_t *dev);
 
 static int     uart_open(FAR struct file *filep);
 static int     uart_close(FAR struct file *filep);
+static size_t  uart_getrecvblock(FAR uart_dev_t *dev, FAR char *buffer,
+                                 size_t buflen);
 static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
 static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer, size_t buflen);
 static int     uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
@@ -184,7 +188,7 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              sem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -331,6 +335,61 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
   return OK;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitblock
+ *
+ * Description:
+ *   Copy as many characters as will fit contiguously at the head of the TX buffer.
+ *   This never blocks and performs no output processing.  Returns the number of
+ *   characters copied, which is zero if the TX buffer is full.
+ *
+ ************************************************************************************/
+
+static size_t uart_putxmitblock(FAR uart_dev_t *dev, FAR const char *buffer,
+                                size_t buflen)
+{
+  int16_t head = dev->xmit.head;
+  int16_t tail = dev->xmit.tail;
+  size_t nbytes;
+
+  /* One slot is always left empty so that a full buffer can be distinguished
+   * from an empty one.
+   */
+
+  if (tail > head)
+    {
+      nbytes = tail - head - 1;
+    }
+  else
+    {
+      nbytes = dev->xmit.size - head;
+      if (tail == 0)
+        {
+          nbytes--;
+        }
+    }
+
+  if (nbytes > buflen)
+    {
+      nbytes = buflen;
+    }
+
+  if (nbytes > 0)
+    {
+      memcpy(&dev->xmit.buffer[head], buffer, nbytes);
+
+      head += nbytes;
+      if (head >= dev->xmit.size)
+        {
+          head = 0;
+        }
+
+      dev->xmit.head = head;
+    }
+
+  return nbytes;
+}
+
 /************************************************************************************
  * Name: uart_irqwrite
  ************************************************************************************/
@@ -662,6 +721,58 @@ static int uart_close(FAR struct file *filep)
   return OK;
 }
 
+/************************************************************************************
+ * Name: uart_getrecvblock
+ *
+ * Description:
+ *   Copy the contiguous run of characters at the tail of the RX buffer.  No input
+ *   processing is performed.  Returns the number of characters copied.
+ *
+ ************************************************************************************/
+
+static size_t uart_getrecvblock(FAR uart_dev_t *dev, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  int16_t head = rxbuf->head;
+  int16_t tail = rxbuf->tail;
+  size_t nbytes;
+
+  /* Rx interrupt handling logic may asynchronously increment the head index
+   * but must not modify the tail index.  Using a snapshot of the head can
+   * only under-estimate what is available.
+   */
+
+  if (head >= tail)
+    {
+      nbytes = head - tail;
+    }
+  else
+    {
+      nbytes = rxbuf->size - tail;
+    }
+
+  if (nbytes > buflen)
+    {
+      nbytes = buflen;
+    }
+
+  if (nbytes > 0)
+    {
+      memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+
+      tail += nbytes;
+      if (tail >= rxbuf->size)
+        {
+          tail = 0;
+        }
+
+      rxbuf->tail = tail;
+    }
+
+  return nbytes;
+}
+
 /************************************************************************************
  * Name: uart_read
  ************************************************************************************/
@@ -677,10 +788,22 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  size_t nbytes;
   int16_t tail;
+  bool raw;
   char ch;
   int ret;
 
+  /* If no input processing is needed, then whole runs of characters can be
+   * copied out of the RX buffer at once.
+   */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  raw = ((dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0);
+#else
+  raw = true;
+#endif
+
   /* Only one user can access rxbuf->tail at a time */
 
   ret = uart_takesem(&rxbuf->sem, true);
@@ -729,7 +852,15 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (raw && rxbuf->head != tail)
+        {
+          /* Take a contiguous run of characters from the tail of the buffer */
+
+          nbytes  = uart_getrecvblock(dev, buffer, buflen - recvd);
+          buffer += nbytes;
+          recvd  += nbytes;
+        }
+      else if (rxbuf->head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
@@ -857,9 +988,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
               flags = enter_critical_section();
 
 #ifdef CONFIG_SERIAL_DMA
-              /* If RX buffer is empty move tail and head to zero position */
+              /* If RX buffer is empty move tail and head to zero position.
+               * This is not possible while an RX DMA transfer is active.
+               */
 
-              if (rxbuf->head == rxbuf->tail)
+              if (rxbuf->head == rxbuf->tail && dev->dmarx.length == 0)
                 {
                   rxbuf->head = rxbuf->tail = 0;
                 }
@@ -943,9 +1076,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #ifdef CONFIG_SERIAL_DMA
   flags = enter_critical_section();
 
-  /* If RX buffer is empty move tail and head to zero position */
+  /* If RX buffer is empty move tail and head to zero position.  This is not
+   * possible while an RX DMA transfer is active.
+   */
 
-  if (rxbuf->head == rxbuf->tail)
+  if (rxbuf->head == rxbuf->tail && dev->dmarx.length == 0)
     {
       rxbuf->head = rxbuf->tail = 0;
     }
@@ -1012,7 +1147,9 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nbytes;
   bool              oktoblock;
+  bool              raw;
   int               ret;
   char              ch;
 
@@ -1084,6 +1221,17 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
   oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
+  /* If no output processing is needed, then whole runs of characters can be
+   * copied into the TX buffer at once.
+   */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  raw = ((dev->tc_oflag & OPOST) == 0 ||
+         (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0);
+#else
+  raw = !dev->isconsole;
+#endif
+
   /* Loop while we still have data to copy to the transmit buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -1092,6 +1240,23 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   uart_disabletxint(dev);
   for (; buflen; buflen--)
     {
+      if (raw)
+        {
+          /* Copy as much as fits.  If nothing fits, fall through and let
+           * uart_putxmitchar() wait for space for the next character.
+           */
+
+          nbytes = uart_putxmitblock(dev, buffer, buflen);
+          if (nbytes > 0)
+            {
+              /* The loop decrements buflen by one more */
+
+              buffer += nbytes;
+              buflen -= nbytes - 1;
+              continue;
+            }
+        }
+
       ch  = *buffer++;
       ret = OK;
 
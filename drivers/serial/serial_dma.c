@@ -251,11 +251,16 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
   FAR struct uart_buffer_s *rxbuf = &dev->recv;
   size_t nbytes = xfer->nbytes;
 
+  /* Some of the bytes may already have been added by uart_recvchars_idle() */
+
+  nbytes = nbytes > xfer->nreported ? nbytes - xfer->nreported : 0;
+
   /* Move head for nbytes. */
 
-  rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
-  xfer->nbytes = 0;
-  xfer->length = xfer->nlength = 0;
+  rxbuf->head     = (rxbuf->head + nbytes) % rxbuf->size;
+  xfer->nbytes    = 0;
+  xfer->nreported = 0;
+  xfer->length    = xfer->nlength = 0;
 
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
@@ -267,4 +272,35 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
     }
 }
 
+/************************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *   Make the bytes received so far by the active RX DMA transfer available to
+ *   readers without ending the transfer.  This should be called by the lower half
+ *   on an idle-line or receive timeout event with 'nbytes' set to the total number
+ *   of bytes that the transfer has written so far.  A later uart_recvchars_done()
+ *   accounts only for the bytes that were not yet reported.
+ *
+ ************************************************************************************/
+
+void uart_recvchars_idle(FAR uart_dev_t *dev, size_t nbytes)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+
+  if (nbytes > xfer->nreported)
+    {
+      /* Move head past the bytes that have arrived since the last report.  The
+       * transfer keeps writing beyond the new head, into space that it already
+       * owns.
+       */
+
+      rxbuf->head     = (rxbuf->head + nbytes - xfer->nreported) % rxbuf->size;
+      xfer->nreported = nbytes;
+
+      uart_datareceived(dev);
+    }
+}
+
 #endif /* CONFIG_SERIAL_DMA */
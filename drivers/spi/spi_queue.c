@@ -0,0 +1,146 @@
+/****************************************************************************
+ * drivers/spi/spi_queue.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* spi_transfer() waits for the bus lock, so prefer the low priority work
+ * queue if it is available.
+ */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define SPIWORK LPWORK
+#else
+#  define SPIWORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_worker
+ *
+ * Description:
+ *   Perform a chain that the SPI driver could not queue itself, one
+ *   sequence after the other, and report the completion of the chain.
+ *
+ ****************************************************************************/
+
+static void spi_queue_worker(FAR void *arg)
+{
+  FAR struct spi_chain_s *chain = (FAR struct spi_chain_s *)arg;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < (int)chain->nseq; i++)
+    {
+      ret = spi_transfer(chain->spi, &chain->seq[i]);
+      if (ret < 0)
+        {
+          spierr("ERROR: Sequence %d failed: %d\n", i, ret);
+          break;
+        }
+    }
+
+  chain->done(chain, ret);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue
+ *
+ * Description:
+ *   Start a chain of transfer sequences and return without waiting for
+ *   them.  chain->done() is called when the last sequence has completed.
+ *   If the SPI driver can perform the chain with linked DMA descriptors,
+ *   only one interrupt is taken for the whole chain.  Otherwise the
+ *   sequences are performed one after the other with spi_transfer() on
+ *   the work queue.
+ *
+ * Input Parameters:
+ *   spi   - An instance of the SPI device to use for the transfers
+ *   chain - Describes the chain of sequences.
+ *
+ * Returned Value:
+ *   Zero (OK) if the chain was started; a negated errno value on failure.
+ *   done() is not called if the chain was not started.
+ *
+ ****************************************************************************/
+
+int spi_queue(FAR struct spi_dev_s *spi, FAR struct spi_chain_s *chain)
+{
+  int ret;
+
+  DEBUGASSERT(spi != NULL && chain != NULL && chain->seq != NULL &&
+              chain->done != NULL);
+
+  chain->spi = spi;
+
+  /* Let the SPI driver program the chain as DMA descriptors if it can */
+
+  ret = SPI_QUEUE(spi, chain);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+
+  /* Otherwise perform the sequences on the work queue */
+
+  spiinfo("Queuing %d sequences on the work queue\n", chain->nseq);
+  return work_queue(SPIWORK, &chain->work, spi_queue_worker, chain, 0);
+}
+
+#endif /* CONFIG_SPI_QUEUE */
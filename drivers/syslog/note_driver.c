@@ -40,6 +40,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <sched.h>
 #include <assert.h>
 #include <errno.h>
@@ -50,12 +53,28 @@
 #if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
     defined(CONFIG_DRIVER_NOTE)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+#  ifdef CONFIG_SMP
+#    define NOTE_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define NOTE_NCPUS 1
+#  endif
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+static ssize_t note_streamread(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -77,6 +96,24 @@ static const struct file_operations note_fops =
 #endif
 };
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+static const struct file_operations note_streamfops =
+{
+  0,               /* open */
+  0,               /* close */
+  note_streamread, /* read */
+  0,               /* write */
+  0,               /* seek */
+  0                /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , 0              /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0              /* unlink */
+#endif
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -141,6 +178,62 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
   return retlen;
 }
 
+/****************************************************************************
+ * Name: note_streamread
+ *
+ * Description:
+ *   Stream the raw content of the note buffer of one CPU.  The CPU index
+ *   is the private data of the inode.  Data is copied in bulk directly from
+ *   the note buffer; a note may be split between two reads.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+static ssize_t note_streamread(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR const uint8_t *data;
+  ssize_t retlen = 0;
+  ssize_t nbytes;
+  int cpu;
+
+  DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
+  cpu = (int)((uintptr_t)filep->f_inode->i_private);
+
+  /* At most two passes are needed if the data wraps around the end of the
+   * circular buffer.
+   */
+
+  while (buflen > 0)
+    {
+      nbytes = sched_note_peek(cpu, &data);
+      if (nbytes <= 0)
+        {
+          if (retlen == 0)
+            {
+              retlen = nbytes;
+            }
+
+          break;
+        }
+
+      if (nbytes > buflen)
+        {
+          nbytes = buflen;
+        }
+
+      memcpy(buffer, data, nbytes);
+      sched_note_release(cpu, nbytes);
+
+      retlen += nbytes;
+      buffer += nbytes;
+      buflen -= nbytes;
+    }
+
+  return retlen;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -163,7 +256,34 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
 
 int note_register(void)
 {
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  char devname[16];
+  int ret;
+  int cpu;
+
+  ret = register_driver("/dev/note", &note_fops, 0666, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Register a streaming device for the buffer of each CPU */
+
+  for (cpu = 0; cpu < NOTE_NCPUS; cpu++)
+    {
+      snprintf(devname, sizeof(devname), "/dev/note%d", cpu);
+      ret = register_driver(devname, &note_streamfops, 0444,
+                            (FAR void *)((uintptr_t)cpu));
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+#else
   return register_driver("/dev/note", &note_fops, 0666, NULL);
+#endif
 }
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER && CONFIG_DRIVER_NOTE */
\ No newline at end of file
@@ -54,6 +54,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
@@ -61,8 +62,19 @@
 
 #include <nuttx/irq.h>
 
+#include "syslog.h"
+
 #ifdef CONFIG_RAMLOG
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Binary frames are <RAMLOG_SYNC> <payload length> <payload> */
+
+#define RAMLOG_SYNC         0xa5
+#define RAMLOG_MAXPAYLOAD   255
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -108,6 +120,11 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                               pollevent_t eventset);
 #endif
 static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+#ifdef CONFIG_RAMLOG_BINARY
+static int     ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                             FAR const uint8_t *buffer, size_t buflen);
+static FAR uint8_t *ramlog_putvarint(FAR uint8_t *ptr, uint64_t value);
+#endif
 
 /* Character driver methods */
 
@@ -182,6 +199,12 @@ static struct ramlog_dev_s g_sysdev =
   CONFIG_RAMLOG_BUFSIZE,         /* rl_bufsize */
   g_sysbuffer                    /* rl_buffer */
 };
+
+#ifdef CONFIG_RAMLOG_BINARY
+/* The system timer at the time of the last binary frame */
+
+static systime_t g_lastframe;
+#endif
 #endif
 
 /****************************************************************************
@@ -271,6 +294,82 @@ static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
   return OK;
 }
 
+/****************************************************************************
+ * Name: ramlog_addbuf
+ *
+ * Description:
+ *   Add a binary frame to the circular buffer.  Either all of the frame is
+ *   saved or, if there is not enough space, none of it so that the frames
+ *   in the buffer remain decodable.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+static int ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                         FAR const uint8_t *buffer, size_t buflen)
+{
+  irqstate_t flags;
+  size_t nfree;
+  size_t head;
+
+  flags = enter_critical_section();
+
+  /* One byte is always left unused to distinguish full from empty */
+
+  head = priv->rl_head;
+  if (head >= priv->rl_tail)
+    {
+      nfree = priv->rl_bufsize - (head - priv->rl_tail) - 1;
+    }
+  else
+    {
+      nfree = priv->rl_tail - head - 1;
+    }
+
+  if (buflen > nfree)
+    {
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+
+  while (buflen-- > 0)
+    {
+      priv->rl_buffer[head] = (char)*buffer++;
+      if (++head >= priv->rl_bufsize)
+        {
+          head = 0;
+        }
+    }
+
+  priv->rl_head = head;
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ramlog_putvarint
+ *
+ * Description:
+ *   Save an unsigned value as a LEB128 varint:  Seven bits per byte, least
+ *   significant first, with bit 7 set in all but the last byte.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+static FAR uint8_t *ramlog_putvarint(FAR uint8_t *ptr, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      *ptr++ = (uint8_t)(value | 0x80);
+      value >>= 7;
+    }
+
+  *ptr++ = (uint8_t)value;
+  return ptr;
+}
+#endif
+
 /****************************************************************************
  * Name: ramlog_read
  ****************************************************************************/
@@ -827,4 +926,149 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vbinary
+ *
+ * Description:
+ *   Save a SYSLOG message in the RAMLOG as a binary frame instead of as
+ *   text.  The frame holds:
+ *
+ *   - The time in microseconds since the previous frame (varint)
+ *   - The address of the format string, used as the message ID (varint)
+ *   - The arguments:  Integers as zigzag varints, pointers as varints,
+ *     doubles as 8 little-endian bytes and strings NUL terminated.
+ *
+ *   The format string itself never leaves the target.  It is recovered on
+ *   the host from the ELF file by tools/ramlogdecode.py.
+ *
+ * Returned Value:
+ *   Zero (OK) if the frame was saved or dropped because the RAMLOG is
+ *   full.  A negated errno value is returned if the message cannot be
+ *   encoded; it must then be saved as text.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+int ramlog_vbinary(FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  uint8_t frame[2 + RAMLOG_MAXPAYLOAD];
+  struct syslog_args_s args;
+  FAR union syslog_arg_u *arg;
+  FAR uint8_t *ptr;
+  FAR const char *str;
+  systime_t now;
+  irqstate_t flags;
+  int64_t value;
+  size_t len;
+  va_list copy;
+  int ret;
+  int i;
+
+  va_copy(copy, *ap);
+  ret = syslog_parseargs(&args, fmt, copy);
+  va_end(copy);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Get the time since the previous frame */
+
+  flags = enter_critical_section();
+  now   = clock_systimer();
+  value = (int64_t)TICK2USEC((uint64_t)(now - g_lastframe));
+  g_lastframe = now;
+  leave_critical_section(flags);
+
+  ptr = ramlog_putvarint(&frame[2], (uint64_t)value);
+  ptr = ramlog_putvarint(ptr, (uintptr_t)fmt);
+
+  for (i = 0; i < args.sa_nargs; i++)
+    {
+      /* Leave space for the largest fixed size argument */
+
+      if (ptr - &frame[2] > RAMLOG_MAXPAYLOAD - 10)
+        {
+          return -E2BIG;
+        }
+
+      arg = &args.sa_args[i];
+      switch (args.sa_types[i])
+        {
+          case SYSLOG_ARG_INT:
+            value = arg->i;
+            goto zigzag;
+
+          case SYSLOG_ARG_LONG:
+            value = arg->l;
+            goto zigzag;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            value = arg->ll;
+#endif
+
+          zigzag:
+            /* Map small negative values onto small varints */
+
+            ptr = ramlog_putvarint(ptr, ((uint64_t)value << 1) ^
+                                        (uint64_t)(value >> 63));
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case SYSLOG_ARG_DOUBLE:
+            {
+              uint64_t bits;
+              int j;
+
+              memcpy(&bits, &arg->d, sizeof(bits));
+              for (j = 0; j < 8; j++)
+                {
+                  *ptr++ = (uint8_t)bits;
+                  bits >>= 8;
+                }
+            }
+            break;
+#endif
+
+          case SYSLOG_ARG_PTR:
+            ptr = ramlog_putvarint(ptr, (uintptr_t)arg->p);
+            break;
+
+          case SYSLOG_ARG_STR:
+            str = &args.sa_strings[arg->offset];
+            len = strlen(str) + 1;
+            if (ptr - &frame[2] + len > RAMLOG_MAXPAYLOAD)
+              {
+                return -E2BIG;
+              }
+
+            memcpy(ptr, str, len);
+            ptr += len;
+            break;
+
+          default:
+            return -EINVAL;
+        }
+    }
+
+  len = ptr - &frame[2];
+  if (len > RAMLOG_MAXPAYLOAD)
+    {
+      return -E2BIG;
+    }
+
+  frame[0] = RAMLOG_SYNC;
+  frame[1] = (uint8_t)len;
+
+  /* A full RAMLOG silently drops the message, just as ramlog_putc() would
+   * drop the characters.
+   */
+
+  (void)ramlog_addbuf(&g_sysdev, frame, len + 2);
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_RAMLOG */
@@ -42,7 +42,86 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/compiler.h>
+
 #include <stdbool.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Saved SYSLOG arguments are used both for deferred formatting and for the
+ * binary RAMLOG.
+ */
+
+#if defined(CONFIG_SYSLOG_DEFERRED) || defined(CONFIG_RAMLOG_BINARY)
+#  define HAVE_SYSLOG_ARGS 1
+
+#  ifdef CONFIG_SYSLOG_DEFERRED_NARGS
+#    define SYSLOG_MAXARGS CONFIG_SYSLOG_DEFERRED_NARGS
+#  else
+#    define SYSLOG_MAXARGS 8
+#  endif
+
+#  ifdef CONFIG_SYSLOG_DEFERRED_STRSIZE
+#    define SYSLOG_STRSIZE CONFIG_SYSLOG_DEFERRED_STRSIZE
+#  else
+#    define SYSLOG_STRSIZE 32
+#  endif
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+#ifdef HAVE_SYSLOG_ARGS
+/* The type of one saved argument */
+
+enum syslog_argtype_e
+{
+  SYSLOG_ARG_INT = 0,            /* int (and all promoted smaller types) */
+  SYSLOG_ARG_LONG,               /* long */
+#ifdef CONFIG_HAVE_LONG_LONG
+  SYSLOG_ARG_LLONG,              /* long long */
+#endif
+#ifdef CONFIG_HAVE_DOUBLE
+  SYSLOG_ARG_DOUBLE,             /* double */
+#endif
+  SYSLOG_ARG_PTR,                /* void pointer */
+  SYSLOG_ARG_STR                 /* String copied into sa_strings[] */
+};
+
+/* One saved argument */
+
+union syslog_arg_u
+{
+  int i;
+  long l;
+#ifdef CONFIG_HAVE_LONG_LONG
+  long long ll;
+#endif
+#ifdef CONFIG_HAVE_DOUBLE
+  double d;
+#endif
+  FAR const void *p;
+  size_t offset;                 /* Offset of a string in sa_strings[] */
+};
+
+/* The arguments of one message, saved by syslog_parseargs() */
+
+struct syslog_args_s
+{
+  uint8_t sa_nargs;              /* Number of arguments in sa_args[] */
+  uint8_t sa_types[SYSLOG_MAXARGS];
+  union syslog_arg_u sa_args[SYSLOG_MAXARGS];
+  char sa_strings[SYSLOG_STRSIZE];
+};
+#endif /* HAVE_SYSLOG_ARGS */
+#endif /* __ASSEMBLY__ */
 
 /****************************************************************************
  * Public Data
@@ -367,6 +446,67 @@ int syslog_dev_putc(int ch);
 int syslog_dev_flush(void);
 #endif
 
+/****************************************************************************
+ * Name: syslog_defer_initialize
+ *
+ * Description:
+ *   Start the daemon that formats deferred messages.  Messages are
+ *   formatted synchronously until this has been called.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_defer_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Save a message so that it can be formatted later by the SYSLOG daemon.
+ *   The format string is not copied and must remain valid.
+ *
+ * Input Parameters:
+ *   priority - The message priority (LOG_EMERG is never deferred)
+ *   ts       - The message timestamp (if CONFIG_SYSLOG_TIMESTAMP)
+ *   fmt      - The printf-style format string
+ *   ap       - The arguments
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was deferred or dropped because the ring was
+ *   full.  A negated errno value is returned if the message cannot be
+ *   deferred and must be formatted by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+struct timespec; /* Forward reference */
+int syslog_defer(int priority, FAR const struct timespec *ts,
+                 FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_parseargs
+ *
+ * Description:
+ *   Walk the format string and save each argument from the va_list in
+ *   'args'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -ENOTSUP is returned if the arguments cannot be
+ *   saved (too many arguments or an unsupported conversion); the message
+ *   must then be formatted right away.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_SYSLOG_ARGS
+int syslog_parseargs(FAR struct syslog_args_s *args,
+                     FAR const IPTR char *fmt, va_list ap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
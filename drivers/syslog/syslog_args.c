@@ -0,0 +1,232 @@
+/****************************************************************************
+ * drivers/syslog/syslog_args.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+
+#include "syslog.h"
+
+#ifdef HAVE_SYSLOG_ARGS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parseargs
+ *
+ * Description:
+ *   Walk the format string and save each argument from the va_list in
+ *   'args'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -ENOTSUP is returned if the arguments cannot be
+ *   saved (too many arguments or an unsupported conversion); the message
+ *   must then be formatted right away.
+ *
+ ****************************************************************************/
+
+int syslog_parseargs(FAR struct syslog_args_s *args,
+                     FAR const IPTR char *fmt, va_list ap)
+{
+  FAR const char *str;
+  size_t strused = 0;
+  size_t len;
+  int nlong;
+  int type;
+  char ch;
+
+  args->sa_nargs = 0;
+
+  for (; *fmt != '\0'; fmt++)
+    {
+      if (*fmt != '%')
+        {
+          continue;
+        }
+
+      fmt++;
+      if (*fmt == '%')
+        {
+          continue;
+        }
+
+      /* Skip over the flags */
+
+      while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' ||
+             *fmt == '0')
+        {
+          fmt++;
+        }
+
+      /* The width and the precision may each be given as an int argument */
+
+      for (; ; fmt++)
+        {
+          ch = *fmt;
+          if (ch == '*')
+            {
+              if (args->sa_nargs >= SYSLOG_MAXARGS)
+                {
+                  return -ENOTSUP;
+                }
+
+              args->sa_types[args->sa_nargs]  = SYSLOG_ARG_INT;
+              args->sa_args[args->sa_nargs].i = va_arg(ap, int);
+              args->sa_nargs++;
+            }
+          else if ((ch < '0' || ch > '9') && ch != '.')
+            {
+              break;
+            }
+        }
+
+      /* Length modifiers.  Those with types that may not match int, long or
+       * long long (z, j, t, L) are not supported.
+       */
+
+      nlong = 0;
+      while (*fmt == 'h')
+        {
+          fmt++;
+        }
+
+      while (*fmt == 'l')
+        {
+          nlong++;
+          fmt++;
+        }
+
+      if (args->sa_nargs >= SYSLOG_MAXARGS)
+        {
+          return -ENOTSUP;
+        }
+
+      switch (*fmt)
+        {
+          case 'd':
+          case 'i':
+          case 'u':
+          case 'o':
+          case 'x':
+          case 'X':
+          case 'c':
+            if (nlong == 0)
+              {
+                type = SYSLOG_ARG_INT;
+                args->sa_args[args->sa_nargs].i = va_arg(ap, int);
+              }
+            else if (nlong == 1)
+              {
+                type = SYSLOG_ARG_LONG;
+                args->sa_args[args->sa_nargs].l = va_arg(ap, long);
+              }
+#ifdef CONFIG_HAVE_LONG_LONG
+            else if (nlong == 2)
+              {
+                type = SYSLOG_ARG_LLONG;
+                args->sa_args[args->sa_nargs].ll = va_arg(ap, long long);
+              }
+#endif
+            else
+              {
+                return -ENOTSUP;
+              }
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case 'f':
+          case 'F':
+          case 'e':
+          case 'E':
+          case 'g':
+          case 'G':
+            type = SYSLOG_ARG_DOUBLE;
+            args->sa_args[args->sa_nargs].d = va_arg(ap, double);
+            break;
+#endif
+
+          case 'p':
+            type = SYSLOG_ARG_PTR;
+            args->sa_args[args->sa_nargs].p = va_arg(ap, FAR void *);
+            break;
+
+          case 's':
+            /* Copy as much of the string as there is space for */
+
+            str = va_arg(ap, FAR const char *);
+            if (str == NULL)
+              {
+                str = "(null)";
+              }
+
+            len = strlen(str);
+            if (len >= SYSLOG_STRSIZE - strused)
+              {
+                len = SYSLOG_STRSIZE - strused - 1;
+              }
+
+            type = SYSLOG_ARG_STR;
+            args->sa_args[args->sa_nargs].offset = strused;
+            memcpy(&args->sa_strings[strused], str, len);
+            args->sa_strings[strused + len] = '\0';
+
+            if (strused + len + 1 < SYSLOG_STRSIZE)
+              {
+                strused += len + 1;
+              }
+            break;
+
+          default:
+            /* %n, unsupported length modifiers, or a malformed format */
+
+            return -ENOTSUP;
+        }
+
+      args->sa_types[args->sa_nargs] = type;
+      args->sa_nargs++;
+    }
+
+  return OK;
+}
+
+#endif /* HAVE_SYSLOG_ARGS */
@@ -0,0 +1,478 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <semaphore.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_DEFER_NCPUS     CONFIG_SMP_NCPUS
+#else
+#  define SYSLOG_DEFER_NCPUS     1
+#endif
+
+/* The largest conversion specification that will be re-assembled for
+ * lib_sprintf(), including the '%', any substituted '*' values and the NUL
+ * terminator.
+ */
+
+#define SYSLOG_DEFER_SPECSIZE    32
+
+/* Memory barriers are needed only if the rings are shared between CPUs.
+ * SP_DMB orders the producer's stores; the daemon needs the full barrier
+ * to order its loads.
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+#ifndef SP_DSB
+#  define SP_DSB()
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One deferred message.  The format string itself is not copied; it must
+ * remain valid, as do all string literals.  The strings for %s
+ * conversions are copied (and possibly truncated) since they often live in
+ * the caller's stack.
+ */
+
+struct syslog_record_s
+{
+  FAR const IPTR char *sr_fmt;   /* Format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec sr_ts;         /* Time that the message was logged */
+#endif
+  struct syslog_args_s sr_args;  /* The saved arguments */
+};
+
+/* The ring of deferred messages for one CPU.  Only that CPU adds to the
+ * ring (with its local interrupts disabled) and only the daemon removes
+ * from it, so no lock is shared between CPUs.
+ */
+
+struct syslog_ring_s
+{
+  volatile uint16_t sd_head;     /* Next record to be added */
+  volatile uint16_t sd_tail;     /* Next record to be formatted */
+  volatile uint32_t sd_dropped;  /* Messages lost because the ring was full */
+  uint32_t sd_reported;          /* Messages reported lost by the daemon */
+  struct syslog_record_s sd_records[CONFIG_SYSLOG_DEFERRED_NRECORDS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_rings[SYSLOG_DEFER_NCPUS];
+static sem_t g_syslog_defersem;
+static volatile bool g_syslog_deferring;
+static pid_t g_syslog_daemonpid;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_defer_format
+ *
+ * Description:
+ *   Format one deferred message to the SYSLOG channel.  Each conversion is
+ *   re-assembled into a separate format string (with any '*' width or
+ *   precision replaced by its value) and passed to lib_sprintf() with its
+ *   single saved argument.
+ *
+ ****************************************************************************/
+
+static void syslog_defer_format(FAR struct syslog_record_s *rec)
+{
+  struct lib_syslogstream_s stream;
+  FAR const IPTR char *fmt;
+  FAR struct lib_outstream_s *out;
+  FAR struct syslog_args_s *args = &rec->sr_args;
+  FAR union syslog_arg_u *arg;
+  char spec[SYSLOG_DEFER_SPECSIZE];
+  int argndx = 0;
+  int len;
+  char ch;
+
+  syslogstream_create(&stream);
+  out = &stream.public;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  (void)lib_sprintf(out, "[%6d.%06d]", rec->sr_ts.tv_sec,
+                    rec->sr_ts.tv_nsec / 1000);
+#endif
+
+  for (fmt = rec->sr_fmt; *fmt != '\0'; fmt++)
+    {
+      if (*fmt != '%' || fmt[1] == '%')
+        {
+          if (*fmt == '%')
+            {
+              fmt++;
+            }
+
+          out->put(out, *fmt);
+          continue;
+        }
+
+      /* Collect the conversion specification */
+
+      len = 0;
+      spec[len++] = *fmt++;
+
+      for (; ; fmt++)
+        {
+          ch = *fmt;
+          if (ch == '*')
+            {
+              /* Substitute the saved width or precision.  A negative
+               * precision is the same as no precision.
+               */
+
+              if (len > 0 && spec[len - 1] == '.' &&
+                  args->sa_args[argndx].i < 0)
+                {
+                  len--;
+                }
+              else
+                {
+                  len += snprintf(&spec[len], SYSLOG_DEFER_SPECSIZE - len,
+                                  "%d", args->sa_args[argndx].i);
+                  if (len > SYSLOG_DEFER_SPECSIZE - 1)
+                    {
+                      len = SYSLOG_DEFER_SPECSIZE - 1;
+                    }
+                }
+
+              argndx++;
+            }
+          else if (ch == '\0')
+            {
+              break;
+            }
+          else
+            {
+              spec[len++] = ch;
+
+              /* Stop after the conversion character */
+
+              if ((ch >= 'a' && ch <= 'z' && ch != 'h' && ch != 'l') ||
+                  (ch >= 'A' && ch <= 'Z'))
+                {
+                  break;
+                }
+            }
+
+          if (len >= SYSLOG_DEFER_SPECSIZE - 1)
+            {
+              break;
+            }
+        }
+
+      spec[len] = '\0';
+      if (*fmt == '\0' || argndx >= args->sa_nargs)
+        {
+          break;
+        }
+
+      arg = &args->sa_args[argndx];
+      switch (args->sa_types[argndx])
+        {
+          case SYSLOG_ARG_INT:
+            (void)lib_sprintf(out, spec, arg->i);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            (void)lib_sprintf(out, spec, arg->l);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            (void)lib_sprintf(out, spec, arg->ll);
+            break;
+#endif
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case SYSLOG_ARG_DOUBLE:
+            (void)lib_sprintf(out, spec, arg->d);
+            break;
+#endif
+
+          case SYSLOG_ARG_PTR:
+            (void)lib_sprintf(out, spec, arg->p);
+            break;
+
+          case SYSLOG_ARG_STR:
+            (void)lib_sprintf(out, spec, &args->sa_strings[arg->offset]);
+            break;
+        }
+
+      argndx++;
+    }
+
+  syslogstream_destroy(&stream);
+}
+
+/****************************************************************************
+ * Name: syslog_defer_daemon
+ *
+ * Description:
+ *   The low priority thread that formats the deferred messages.
+ *
+ ****************************************************************************/
+
+static int syslog_defer_daemon(int argc, FAR char *argv[])
+{
+  FAR struct syslog_ring_s *ring;
+  uint32_t dropped;
+  uint16_t tail;
+  bool more;
+  int cpu;
+
+  for (; ; )
+    {
+      /* Wait until something is logged.  The count may be larger than the
+       * number of queued messages; the loops below simply find the rings
+       * empty.
+       */
+
+      while (sem_wait(&g_syslog_defersem) < 0)
+        {
+        }
+
+      do
+        {
+          more = false;
+          for (cpu = 0; cpu < SYSLOG_DEFER_NCPUS; cpu++)
+            {
+              ring = &g_syslog_rings[cpu];
+
+              dropped = ring->sd_dropped;
+              if (dropped != ring->sd_reported)
+                {
+                  syslog(LOG_WARNING, "[%lu deferred messages lost]\n",
+                         (unsigned long)(dropped - ring->sd_reported));
+                  ring->sd_reported = dropped;
+                }
+
+              tail = ring->sd_tail;
+              if (tail != ring->sd_head)
+                {
+                  /* Make sure that the record contents are seen after the
+                   * head index that published them.
+                   */
+
+                  SP_DSB();
+                  syslog_defer_format(&ring->sd_records[tail]);
+
+                  /* Then release the record to the producer */
+
+                  SP_DSB();
+                  if (++tail >= CONFIG_SYSLOG_DEFERRED_NRECORDS)
+                    {
+                      tail = 0;
+                    }
+
+                  ring->sd_tail = tail;
+                  more = true;
+                }
+            }
+        }
+      while (more);
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_defer_initialize
+ *
+ * Description:
+ *   Start the daemon that formats deferred messages.  Messages are
+ *   formatted synchronously until this has been called.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int syslog_defer_initialize(void)
+{
+  int pid;
+
+  sem_init(&g_syslog_defersem, 0, 0);
+  pid = kernel_thread("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                      CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                      (main_t)syslog_defer_daemon, NULL);
+  if (pid < 0)
+    {
+      return -errno;
+    }
+
+  g_syslog_daemonpid = (pid_t)pid;
+  g_syslog_deferring = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Save a message so that it can be formatted later by the SYSLOG daemon.
+ *   The format string is not copied and must remain valid.
+ *
+ * Input Parameters:
+ *   priority - The message priority (LOG_EMERG is never deferred)
+ *   ts       - The message timestamp (if CONFIG_SYSLOG_TIMESTAMP)
+ *   fmt      - The printf-style format string
+ *   ap       - The arguments
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was deferred or dropped because the ring was
+ *   full.  A negated errno value is returned if the message cannot be
+ *   deferred and must be formatted by the caller.
+ *
+ ****************************************************************************/
+
+int syslog_defer(int priority, FAR const struct timespec *ts,
+                 FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  struct syslog_record_s rec;
+  irqstate_t flags;
+  va_list copy;
+  uint16_t head;
+  uint16_t next;
+  int ret;
+
+  /* Don't defer messages from the daemon itself */
+
+  if (!g_syslog_deferring ||
+      (!up_interrupt_context() && getpid() == g_syslog_daemonpid))
+    {
+      return -EAGAIN;
+    }
+
+  /* Save the message in a local record.  The caller's va_list is left for
+   * the synchronous path if this fails.
+   */
+
+  va_copy(copy, *ap);
+  ret = syslog_parseargs(&rec.sr_args, fmt, copy);
+  va_end(copy);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  rec.sr_fmt = fmt;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  rec.sr_ts  = *ts;
+#endif
+
+  /* Add it to this CPU's ring.  Disabling local interrupts is all that is
+   * needed to keep this CPU in this function and to exclude the other
+   * producers on this CPU.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_rings[up_cpu_index()];
+  head  = ring->sd_head;
+  next  = head + 1;
+
+  if (next >= CONFIG_SYSLOG_DEFERRED_NRECORDS)
+    {
+      next = 0;
+    }
+
+  if (next == ring->sd_tail)
+    {
+      ring->sd_dropped++;
+      up_irq_restore(flags);
+      return OK;
+    }
+
+  ring->sd_records[head] = rec;
+
+  /* The record must be complete before the daemon can see it */
+
+  SP_DMB();
+  ring->sd_head = next;
+  up_irq_restore(flags);
+
+  sem_post(&g_syslog_defersem);
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
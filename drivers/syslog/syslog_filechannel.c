@@ -1,7 +1,7 @@
 /****************************************************************************
  * drivers/syslog/syslog_filechannel.c
  *
- *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Copyright (C) 2016, 2018 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,9 +40,16 @@
 #include <nuttx/config.h>
 
 #include <sys/stat.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include <sched.h>
 #include <fcntl.h>
+#include <errno.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/syslog/syslog.h>
 
 #include "syslog.h"
@@ -56,6 +63,54 @@
 #define OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND)
 #define OPEN_MODE  (S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR)
 
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+/* The buffered file channel uses two buffers:  One is filled by the SYSLOG
+ * callers while the other is being written to the file.  A flush is
+ * scheduled CONFIG_SYSLOG_FILE_FLUSHDELAY milliseconds after data is added
+ * to an empty buffer, or immediately once the buffer is half full.
+ */
+
+#  define FILEBUF_SIZE      CONFIG_SYSLOG_FILE_BUFSIZE
+#  define FILEBUF_THRESHOLD (CONFIG_SYSLOG_FILE_BUFSIZE / 2)
+#  define FILEBUF_DELAY     MSEC2TICK(CONFIG_SYSLOG_FILE_FLUSHDELAY)
+
+#  ifndef CONFIG_SYSLOG_FILE_ROTATESIZE
+#    define CONFIG_SYSLOG_FILE_ROTATESIZE 0
+#  endif
+
+#  ifndef CONFIG_SYSLOG_FILE_ROTATECOUNT
+#    define CONFIG_SYSLOG_FILE_ROTATECOUNT 1
+#  endif
+
+/* An invalid thread ID */
+
+#  define NO_HOLDER         ((pid_t)-1)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+/* This structure holds the state of the buffered file channel */
+
+struct syslog_filebuf_s
+{
+  sem_t         fb_sem;       /* Serializes writes to the file */
+  pid_t         fb_holder;    /* Thread that is writing to the file */
+  uint8_t       fb_active;    /* Index of the buffer being filled */
+  size_t        fb_nbytes;    /* Number of bytes in the active buffer */
+  struct work_s fb_work;      /* Delayed flush work */
+#if CONFIG_SYSLOG_FILE_ROTATESIZE > 0
+  off_t         fb_filesize;  /* Current size of the log file */
+  FAR char     *fb_devpath;   /* Path to the log file */
+  FAR char     *fb_from;      /* Path name buffers used when rotating */
+  FAR char     *fb_to;
+#endif
+  char          fb_buffer[2][FILEBUF_SIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -63,6 +118,13 @@
 /* SYSLOG channel methods */
 
 static int syslog_file_force(int ch);
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+#ifdef CONFIG_SYSLOG_WRITE
+static ssize_t syslog_file_write(FAR const char *buffer, size_t buflen);
+#endif
+static int syslog_file_putc(int ch);
+static int syslog_file_flush(void);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -72,14 +134,27 @@ static int syslog_file_force(int ch);
 
 static const struct syslog_channel_s g_syslog_file_channel =
 {
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+#ifdef CONFIG_SYSLOG_WRITE
+  syslog_file_write,
+#endif
+  syslog_file_putc,
+  syslog_file_force,
+  syslog_file_flush,
+#else
 #ifdef CONFIG_SYSLOG_WRITE
   syslog_dev_write,
 #endif
   syslog_dev_putc,
   syslog_file_force,
   syslog_dev_flush,
+#endif
 };
 
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+static struct syslog_filebuf_s g_syslog_filebuf;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -97,6 +172,344 @@ static int syslog_file_force(int ch)
   return ch;
 }
 
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+/****************************************************************************
+ * Name: syslog_file_rotate
+ *
+ * Description:
+ *   Close the log file, rename it to <devpath>.1 (shifting older logs up to
+ *   <devpath>.CONFIG_SYSLOG_FILE_ROTATECOUNT) and start a new log file.
+ *
+ * Assumptions:
+ *   The caller holds fb_sem.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SYSLOG_FILE_ROTATESIZE > 0
+static void syslog_file_rotate(void)
+{
+  FAR struct syslog_filebuf_s *fb = &g_syslog_filebuf;
+  FAR const char *devpath = fb->fb_devpath;
+  int i;
+
+  (void)syslog_dev_uninitialize();
+
+  for (i = CONFIG_SYSLOG_FILE_ROTATECOUNT; i > 0; i--)
+    {
+      if (i > 1)
+        {
+          sprintf(fb->fb_from, "%s.%d", devpath, i - 1);
+        }
+      else
+        {
+          strcpy(fb->fb_from, devpath);
+        }
+
+      sprintf(fb->fb_to, "%s.%d", devpath, i);
+
+      /* Not all file systems will rename over an existing file.  Errors are
+       * ignored:  The older logs may not exist yet.
+       */
+
+      (void)unlink(fb->fb_to);
+      (void)rename(fb->fb_from, fb->fb_to);
+    }
+
+  fb->fb_filesize = 0;
+  (void)syslog_dev_initialize(devpath, OPEN_FLAGS, OPEN_MODE);
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_file_flushbuf
+ *
+ * Description:
+ *   Write the content of the active buffer to the file.  SYSLOG output may
+ *   continue into the other buffer while the file is being written.
+ *
+ ****************************************************************************/
+
+static int syslog_file_flushbuf(void)
+{
+  FAR struct syslog_filebuf_s *fb = &g_syslog_filebuf;
+  FAR const char *buffer;
+  irqstate_t flags;
+  ssize_t nwritten;
+  size_t nbytes;
+  pid_t me;
+  int ret;
+
+  /* The file cannot be written from interrupt handlers or from the IDLE
+   * thread.  If this thread is already writing to the file, then we were
+   * re-entered from the file system logic.
+   */
+
+  me = getpid();
+  if (up_interrupt_context() || me == 0)
+    {
+      return -ENOSYS;
+    }
+
+  if (fb->fb_holder == me)
+    {
+      return -EWOULDBLOCK;
+    }
+
+  ret = sem_wait(&fb->fb_sem);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  fb->fb_holder = me;
+
+  /* Switch buffers */
+
+  flags         = enter_critical_section();
+  buffer        = fb->fb_buffer[fb->fb_active];
+  nbytes        = fb->fb_nbytes;
+  fb->fb_active ^= 1;
+  fb->fb_nbytes = 0;
+  leave_critical_section(flags);
+
+  /* Newlines were already expanded to CR-LF as the data was buffered so
+   * syslog_dev_write() will pass the data to the file in one write.
+   */
+
+  if (nbytes > 0)
+    {
+      nwritten = syslog_dev_write(buffer, nbytes);
+      if (nwritten < 0)
+        {
+          ret = -get_errno();
+        }
+      else
+        {
+          (void)syslog_dev_flush();
+
+#if CONFIG_SYSLOG_FILE_ROTATESIZE > 0
+          fb->fb_filesize += nwritten;
+          if (fb->fb_filesize >= CONFIG_SYSLOG_FILE_ROTATESIZE)
+            {
+              syslog_file_rotate();
+            }
+#endif
+        }
+    }
+
+  fb->fb_holder = NO_HOLDER;
+  sem_post(&fb->fb_sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_file_worker
+ *
+ * Description:
+ *   Flush the buffered SYSLOG data on the low priority work queue.
+ *
+ ****************************************************************************/
+
+static void syslog_file_worker(FAR void *arg)
+{
+  (void)syslog_file_flushbuf();
+}
+
+/****************************************************************************
+ * Name: syslog_file_fill
+ *
+ * Description:
+ *   Add data to the active buffer, expanding newlines to CR-LF and dropping
+ *   carriage returns as syslog_dev_putc() does.  Returns the number of
+ *   bytes of 'buffer' that were consumed.  This is less than 'buflen' only
+ *   if the active buffer is full.
+ *
+ ****************************************************************************/
+
+static size_t syslog_file_fill(FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_filebuf_s *fb = &g_syslog_filebuf;
+  FAR char *dest;
+  irqstate_t flags;
+  size_t oldbytes;
+  size_t nbytes;
+  size_t i;
+
+  flags    = enter_critical_section();
+  dest     = fb->fb_buffer[fb->fb_active];
+  oldbytes = fb->fb_nbytes;
+  nbytes   = oldbytes;
+
+  for (i = 0; i < buflen; i++)
+    {
+      if (buffer[i] == '\n')
+        {
+          if (nbytes + 2 > FILEBUF_SIZE)
+            {
+              break;
+            }
+
+          dest[nbytes++] = '\r';
+          dest[nbytes++] = '\n';
+        }
+      else if (buffer[i] != '\r')
+        {
+          if (nbytes >= FILEBUF_SIZE)
+            {
+              break;
+            }
+
+          dest[nbytes++] = buffer[i];
+        }
+    }
+
+  fb->fb_nbytes = nbytes;
+
+  /* Start the flush timer when the first data is buffered and flush at
+   * once when the buffer becomes half full.
+   */
+
+  if (oldbytes < FILEBUF_THRESHOLD && nbytes >= FILEBUF_THRESHOLD)
+    {
+      (void)work_queue(LPWORK, &fb->fb_work, syslog_file_worker, NULL, 0);
+    }
+  else if (oldbytes == 0 && nbytes > 0)
+    {
+      (void)work_queue(LPWORK, &fb->fb_work, syslog_file_worker, NULL,
+                       FILEBUF_DELAY);
+    }
+
+  leave_critical_section(flags);
+  return i;
+}
+
+/****************************************************************************
+ * Name: syslog_file_write
+ *
+ * Description:
+ *   Buffer SYSLOG data for the file.  If the buffer is full, the calling
+ *   thread writes it to the file.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_WRITE
+static ssize_t syslog_file_write(FAR const char *buffer, size_t buflen)
+{
+  size_t remaining = buflen;
+  size_t nfilled;
+  int ret;
+
+  for (; ; )
+    {
+      nfilled    = syslog_file_fill(buffer, remaining);
+      buffer    += nfilled;
+      remaining -= nfilled;
+
+      if (remaining == 0)
+        {
+          return buflen;
+        }
+
+      ret = syslog_file_flushbuf();
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return -1;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_file_putc
+ *
+ * Description:
+ *   Buffer one character of SYSLOG data for the file.
+ *
+ ****************************************************************************/
+
+static int syslog_file_putc(int ch)
+{
+  char uch = (char)ch;
+  int ret;
+
+  while (syslog_file_fill(&uch, 1) == 0)
+    {
+      ret = syslog_file_flushbuf();
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return EOF;
+        }
+    }
+
+  return ch;
+}
+
+/****************************************************************************
+ * Name: syslog_file_flush
+ *
+ * Description:
+ *   Write all buffered SYSLOG data to the file.
+ *
+ ****************************************************************************/
+
+static int syslog_file_flush(void)
+{
+  (void)syslog_file_flushbuf();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_file_bufinit
+ *
+ * Description:
+ *   (Re-)initialize the buffered file channel for the file at 'devpath'.
+ *
+ ****************************************************************************/
+
+static int syslog_file_bufinit(FAR const char *devpath)
+{
+  FAR struct syslog_filebuf_s *fb = &g_syslog_filebuf;
+#if CONFIG_SYSLOG_FILE_ROTATESIZE > 0
+  struct stat buf;
+  size_t pathlen;
+#endif
+
+  (void)work_cancel(LPWORK, &fb->fb_work);
+  sem_init(&fb->fb_sem, 0, 1);
+  fb->fb_holder = NO_HOLDER;
+  fb->fb_active = 0;
+  fb->fb_nbytes = 0;
+
+#if CONFIG_SYSLOG_FILE_ROTATESIZE > 0
+  /* Keep the path and room for the rotated file names "<devpath>.<n>" */
+
+  if (fb->fb_devpath != NULL)
+    {
+      kmm_free(fb->fb_devpath);
+    }
+
+  pathlen        = strlen(devpath) + 12;
+  fb->fb_devpath = (FAR char *)kmm_malloc(3 * pathlen);
+  if (fb->fb_devpath == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fb->fb_from = fb->fb_devpath + pathlen;
+  fb->fb_to   = fb->fb_from + pathlen;
+  strcpy(fb->fb_devpath, devpath);
+
+  /* New output is appended to an existing log file */
+
+  fb->fb_filesize = stat(devpath, &buf) < 0 ? 0 : buf.st_size;
+#endif
+
+  return OK;
+}
+#endif /* CONFIG_SYSLOG_FILE_BUFFER */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -158,6 +571,15 @@ int syslog_file_channel(FAR const char *devpath)
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+  /* Write out any output still buffered for the previous file */
+
+  if (saved_channel == &g_syslog_file_channel)
+    {
+      (void)syslog_file_flushbuf();
+    }
+#endif
+
   /* Uninitialize any driver interface that may have been in place */
 
   ret = syslog_dev_uninitialize();
@@ -183,6 +605,17 @@ int syslog_file_channel(FAR const char *devpath)
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_SYSLOG_FILE_BUFFER
+  ret = syslog_file_bufinit(devpath);
+  if (ret < 0)
+    {
+      (void)syslog_dev_uninitialize();
+      (void)syslog_initialize(SYSLOG_INIT_EARLY);
+      (void)syslog_initialize(SYSLOG_INIT_LATE);
+      goto errout_with_lock;
+    }
+#endif
+
   /* Use the file as the SYSLOG channel. If this fails we are pretty much
    * screwed.
    */
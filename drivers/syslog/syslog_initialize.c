@@ -109,6 +109,15 @@ int syslog_initialize(enum syslog_init_e phase)
 
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  if (phase == SYSLOG_INIT_LATE && ret >= 0)
+    {
+      /* Start the daemon that formats deferred SYSLOG messages */
+
+      ret = syslog_defer_initialize();
+    }
+#endif
+
   return ret;
 }
 
@@ -114,7 +114,7 @@ static void syslogstream_addchar(FAR struct lib_syslogstream_s *stream, int ch)
 
   /* Is the buffer full? */
 
-  if (iob->io_len >= CONFIG_IOB_BUFSIZE)
+  if (iob->io_len >= IOB_BUFSIZE(iob))
     {
       /* Yes.. then flush the buffer */
 
@@ -219,6 +219,7 @@ void syslogstream_create(FAR struct lib_syslogstream_s *stream)
   /* Initialize the common fields */
 
   stream->public.put   = syslogstream_putc;
+  stream->public.puts  = NULL;
   stream->public.flush = lib_noflush;
   stream->public.nput  = 0;
 
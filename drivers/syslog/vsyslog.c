@@ -48,6 +48,9 @@
 #include <nuttx/clock.h>
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
+#include <nuttx/syslog/ramlog.h>
+
+#include "syslog.h"
 
 /****************************************************************************
  * Public Functions
@@ -110,6 +113,36 @@ int _vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     }
 #endif
 
+#ifdef CONFIG_RAMLOG_BINARY
+  /* Save the message as a binary RAMLOG frame if possible.  Emergency
+   * output is always saved as text.
+   */
+
+  if (priority != LOG_EMERG && ramlog_vbinary(fmt, ap) >= 0)
+    {
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Save the message for the SYSLOG daemon if possible.  Emergency output
+   * is always generated right away.
+   */
+
+  if (priority != LOG_EMERG)
+    {
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      ret = syslog_defer(priority, &ts, fmt, ap);
+#else
+      ret = syslog_defer(priority, NULL, fmt, ap);
+#endif
+      if (ret >= 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.  NOTE that emergency priority output is handled
    * differently.. it will use the SYSLOG emergency stream.
@@ -171,6 +171,9 @@ struct cdcacm_alloc_s
 static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
                  uint8_t *reqbuf, uint16_t reqlen);
 static int     cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv);
+#ifdef CONFIG_CDCACM_TXCOALESCE
+static uint16_t cdcacm_txpending(FAR struct cdcacm_dev_s *priv);
+#endif
 static int     cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
                 FAR struct cdcacm_rdreq_s *rdcontainer);
 static int     cdcacm_requeue_rdrequest(FAR struct cdcacm_dev_s *priv,
@@ -365,6 +368,30 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
   return nbytes;
 }
 
+/****************************************************************************
+ * Name: cdcacm_txpending
+ *
+ * Description:
+ *   Return the number of bytes waiting in the serial TX buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCACM_TXCOALESCE
+static uint16_t cdcacm_txpending(FAR struct cdcacm_dev_s *priv)
+{
+  FAR uart_dev_t *serdev = &priv->serdev;
+  int16_t head = serdev->xmit.head;
+  int16_t tail = serdev->xmit.tail;
+
+  if (head >= tail)
+    {
+      return head - tail;
+    }
+
+  return serdev->xmit.size - tail + head;
+}
+#endif
+
 /****************************************************************************
  * Name: cdcacm_sndpacket
  *
@@ -420,6 +447,19 @@ static int cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv)
       wrcontainer = (FAR struct cdcacm_wrreq_s *)sq_peek(&priv->txfree);
       req         = wrcontainer->req;
 
+#ifdef CONFIG_CDCACM_TXCOALESCE
+      /* Don't send a partial request while another request is in flight.
+       * The completion of that request will call us again and send what
+       * has accumulated in the meantime.
+       */
+
+      if (priv->nwrq < CONFIG_CDCACM_NWRREQS &&
+          cdcacm_txpending(priv) < reqlen)
+        {
+          break;
+        }
+#endif
+
       /* Fill the request with serial TX data */
 
       len = cdcacm_fillrequest(priv, req->buf, reqlen);
@@ -76,7 +76,9 @@
 #define CONFIG_RNDIS_PRODUCTSTR "USB RNDIS device"
 #define CONFIG_RNDIS_SERIALSTR  "0"
 
-#define CONFIG_RNDIS_NWRREQS    (2)
+#ifndef CONFIG_RNDIS_NWRREQS
+#  define CONFIG_RNDIS_NWRREQS  (2)
+#endif
 
 #define RNDIS_PACKET_HDR_SIZE   (sizeof(struct rndis_packet_msg))
 #define CONFIG_RNDIS_BULKIN_REQLEN (CONFIG_NET_ETH_MTU + RNDIS_PACKET_HDR_SIZE)
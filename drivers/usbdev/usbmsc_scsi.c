@@ -2121,6 +2121,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
+  int nsect;
   int ret;
 
   /* Loop transferring data until either (1) all of the data has been
@@ -2132,6 +2133,58 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
+      /* If nothing is buffered and whole sectors fit into the next request,
+       * then read as many sectors as fit directly into the request buffer.
+       * While that request is on the wire, the next one is read from the
+       * media.
+       */
+
+      privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+      nsect   = CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize;
+
+      if (privreq != NULL && priv->nsectbytes <= 0 && priv->nreqbytes == 0 &&
+          priv->u.xfrlen > 0 && nsect > 0)
+        {
+          req = privreq->req;
+          if (nsect > (int)priv->u.xfrlen)
+            {
+              nsect = priv->u.xfrlen;
+            }
+
+          nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector, nsect);
+          if (nread <= 0)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          flags = enter_critical_section();
+          (void)sq_remfirst(&priv->wrreqlist);
+          leave_critical_section(flags);
+
+          req->len      = nread * lun->sectorsize;
+          req->priv     = privreq;
+          req->callback = usbmsc_wrcomplete;
+          req->flags    = 0;
+
+          priv->u.xfrlen -= nread;
+          priv->sector   += nread;
+
+          ret = EP_SUBMIT(priv->epbulkin, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADSUBMIT), (uint16_t)-ret);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          priv->residue -= req->len;
+          continue;
+        }
+
       /* Is the I/O buffer empty? */
 
       if (priv->nsectbytes <= 0)
@@ -2268,6 +2321,7 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
+  int nsect;
   int ret;
 
   /* Loop transferring data until either (1) all of the data has been
@@ -2310,9 +2364,37 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       while (priv->nreqbytes > 0 && priv->u.xfrlen > 0)
         {
-          /* Copy the data received in the read request into the sector I/O buffer */
-
           src  = &req->buf[xfrd - priv->nreqbytes];
+
+          /* If no partial sector is buffered, then write all whole sectors
+           * in the request directly from the request buffer.
+           */
+
+          nsect = priv->nreqbytes / lun->sectorsize;
+          if (priv->nsectbytes == 0 && nsect > 0)
+            {
+              if (nsect > (int)priv->u.xfrlen)
+                {
+                  nsect = priv->u.xfrlen;
+                }
+
+              nwritten = USBMSC_DRVR_WRITE(lun, src, priv->sector, nsect);
+              if (nwritten <= 0)
+                {
+                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
+                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+                  lun->sdinfo = priv->sector;
+                  goto errout;
+                }
+
+              priv->nreqbytes -= nwritten * lun->sectorsize;
+              priv->residue   -= nwritten * lun->sectorsize;
+              priv->u.xfrlen  -= nwritten;
+              priv->sector    += nwritten;
+              continue;
+            }
+
+          /* Copy the data received in the read request into the sector I/O buffer */
           dest = &priv->iobuffer[priv->nsectbytes];
 
           nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
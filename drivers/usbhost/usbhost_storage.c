@@ -108,6 +108,12 @@
 #define USBHOST_MAX_RETRIES 100        /* Give up after 5 seconds */
 #define USBHOST_MAX_CREFS   INT16_MAX  /* Max cref count before signed overflow */
 
+/* Largest number of sectors moved by one READ10/WRITE10 command */
+
+#ifndef CONFIG_USBHOST_MSC_MAXSECTORS
+#  define CONFIG_USBHOST_MSC_MAXSECTORS 65535
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -195,6 +201,9 @@ static inline int usbhost_testunitready(FAR struct usbhost_state_s *priv);
 static inline int usbhost_requestsense(FAR struct usbhost_state_s *priv);
 static inline int usbhost_readcapacity(FAR struct usbhost_state_s *priv);
 static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv);
+static ssize_t usbhost_rwsectors(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 unsigned int nsectors, bool write);
 
 /* Worker thread actions */
 
@@ -895,6 +904,129 @@ static inline int usbhost_inquiry(FAR struct usbhost_state_s *priv)
   return nbytes < 0 ? (int)nbytes : OK;
 }
 
+/****************************************************************************
+ * Name: usbhost_rwsectors
+ *
+ * Description:
+ *   Transfer sectors between the caller's buffer and the device.  Each
+ *   READ10/WRITE10 command moves up to CONFIG_USBHOST_MSC_MAXSECTORS
+ *   sectors with a single bulk transfer directly to or from the caller's
+ *   buffer.  Larger requests are broken up into several commands.
+ *
+ * Input Parameters:
+ *   priv        - A reference to the class instance.
+ *   buffer      - The sector data
+ *   startsector - The first sector to transfer
+ *   nsectors    - The number of sectors to transfer
+ *   write       - True: Write to the device; false: Read from the device
+ *
+ * Returned Values:
+ *   The number of sectors transferred or a negated errno value if no
+ *   sectors could be transferred.
+ *
+ * Assumptions:
+ *   The caller holds the exclusive access semaphore.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_rwsectors(FAR struct usbhost_state_s *priv,
+                                 FAR uint8_t *buffer, size_t startsector,
+                                 unsigned int nsectors, bool write)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_cbw_s *cbw;
+  FAR struct usbmsc_csw_s *csw;
+  unsigned int ndone = 0;
+  unsigned int nxfr;
+  uint32_t residue;
+  ssize_t nbytes = 0;
+
+  while (ndone < nsectors)
+    {
+      nxfr = nsectors - ndone;
+      if (nxfr > CONFIG_USBHOST_MSC_MAXSECTORS)
+        {
+          nxfr = CONFIG_USBHOST_MSC_MAXSECTORS;
+        }
+
+      /* Loop in the event that EAGAIN is returned (mean that the
+       * transaction was NAKed and we should try again.
+       */
+
+      do
+        {
+          /* Initialize a CBW (re-using the allocated transfer buffer) */
+
+          cbw = usbhost_cbwalloc(priv);
+          if (write)
+            {
+              usbhost_writecbw(startsector + ndone, priv->blocksize, nxfr,
+                               cbw);
+            }
+          else
+            {
+              usbhost_readcbw(startsector + ndone, priv->blocksize, nxfr,
+                              cbw);
+            }
+
+          /* Send the CBW */
+
+          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                                 (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+          if (nbytes >= 0)
+            {
+              /* Send or receive all of the sector data at once */
+
+              nbytes = DRVR_TRANSFER(hport->drvr,
+                                     write ? priv->bulkout : priv->bulkin,
+                                     buffer, priv->blocksize * nxfr);
+              if (nbytes >= 0)
+                {
+                  /* Receive the CSW */
+
+                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                         priv->tbuffer, USBMSC_CSW_SIZEOF);
+                }
+            }
+        }
+      while (nbytes == -EAGAIN);
+
+      if (nbytes < 0)
+        {
+          break;
+        }
+
+      /* Check the CSW status */
+
+      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+      if (csw->status != 0)
+        {
+          uerr("ERROR: CSW status error: %d\n", csw->status);
+          nbytes = -ENODEV;
+          break;
+        }
+
+      /* A non-zero residue means that the device stopped short */
+
+      residue = usbhost_getle32(csw->residue);
+      if (residue > 0)
+        {
+          residue = (residue + priv->blocksize - 1) / priv->blocksize;
+          if (residue < nxfr)
+            {
+              ndone += nxfr - residue;
+            }
+
+          break;
+        }
+
+      ndone  += nxfr;
+      buffer += priv->blocksize * nxfr;
+    }
+
+  return ndone > 0 ? (ssize_t)ndone : (nbytes < 0 ? nbytes : 0);
+}
+
 /****************************************************************************
  * Name: usbhost_destroy
  *
@@ -1977,14 +2109,11 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                             size_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes = 0;
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
-
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   uinfo("startsector: %d nsectors: %d sectorsize: %d\n",
         startsector, nsectors, priv->blocksize);
@@ -2002,71 +2131,14 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
     }
   else if (nsectors > 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
-
       usbhost_takesem(&priv->exclsem);
-
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
-        {
-          /* Loop in the event that EAGAIN is returned (mean that the
-           * transaction was NAKed and we should try again.
-           */
-
-          do
-            {
-              /* Assume some device failure */
-
-              nbytes = -ENODEV;
-
-              /* Construct and send the CBW */
-
-              usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-              if (nbytes >= 0)
-                {
-                  /* Receive the user data */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
-                    {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer, USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
-
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n", csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
-                    }
-                }
-            }
-          while (nbytes == -EAGAIN);
-        }
-
+      nbytes = usbhost_rwsectors(priv, buffer, startsector, nsectors, false);
       usbhost_givesem(&priv->exclsem);
     }
 
   /* On success, return the number of blocks read */
 
-  return nbytes < 0 ? (int)nbytes : nsectors;
+  return nbytes;
 }
 
 /****************************************************************************
@@ -2083,16 +2155,13 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
                            size_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
-  ssize_t nbytes;
+  ssize_t nbytes = 0;
 
-  uinfo("sector: %d nsectors: %d sectorsize: %d\n");
+  uinfo("sector: %d nsectors: %d\n", startsector, nsectors);
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
-
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   /* Check if the mass storage device is still connected */
 
@@ -2105,65 +2174,17 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 
       nbytes = -ENODEV;
     }
-  else
+  else if (nsectors > 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
-
       usbhost_takesem(&priv->exclsem);
-
-     /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
-        {
-          /* Assume some device failure */
-
-          nbytes = -ENODEV;
-
-          /* Construct and send the CBW */
-
-          usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
-          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                 (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-          if (nbytes >= 0)
-            {
-              /* Send the user data */
-
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)buffer, priv->blocksize * nsectors);
-              if (nbytes >= 0)
-                {
-                  /* Receive the CSW */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         priv->tbuffer, USBMSC_CSW_SIZEOF);
-                  if (nbytes >= 0)
-                    {
-                      FAR struct usbmsc_csw_s *csw;
-
-                      /* Check the CSW status */
-
-                      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                      if (csw->status != 0)
-                        {
-                          uerr("ERROR: CSW status error: %d\n", csw->status);
-                          nbytes = -ENODEV;
-                        }
-                    }
-                }
-            }
-        }
-
+      nbytes = usbhost_rwsectors(priv, (FAR uint8_t *)buffer, startsector,
+                                 nsectors, true);
       usbhost_givesem(&priv->exclsem);
     }
 
   /* On success, return the number of blocks written */
 
-  return nbytes < 0 ? (int)nbytes : nsectors;
+  return nbytes;
 }
 #endif
 
@@ -44,15 +44,29 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <poll.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxglib.h>
 #include <nuttx/video/fb.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_FB_PANDISPLAY) && !defined(CONFIG_DISABLE_POLL)
+#  define FB_HAVE_POLL 1
+#  ifndef CONFIG_FB_NPOLLWAITERS
+#    define CONFIG_FB_NPOLLWAITERS 2
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -60,7 +74,9 @@
 /* This structure defines one framebuffer device.  Note that which is
  * everything in this structure is constant data set up and initialization
  * time.  Therefore, no there is requirement for serialized access to this
- * structure.
+ * structure.  The exception is the page flip state which is modified from
+ * the driver's vertical synchronization interrupt and, hence, is accessed
+ * only from within a critical section.
  */
 
 struct fb_chardev_s
@@ -70,6 +86,14 @@ struct fb_chardev_s
   size_t fblen;                   /* Size of the framebuffer */
   uint8_t plane;                  /* Video plan number */
   uint8_t bpp;                    /* Bits per pixel */
+#ifdef CONFIG_FB_PANDISPLAY
+  volatile bool panpending;       /* A pan waits for the next vsync */
+  uint8_t nwaiters;               /* Number of threads waiting for vsync */
+  sem_t vsyncsem;                 /* Wakes up threads waiting for vsync */
+#endif
+#ifdef FB_HAVE_POLL
+  FAR struct pollfd *fds[CONFIG_FB_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -84,6 +108,10 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
 static off_t   fb_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+#ifdef FB_HAVE_POLL
+static int     fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                 bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -97,7 +125,9 @@ static const struct file_operations fb_fops =
   fb_write,      /* write */
   fb_seek,       /* seek */
   fb_ioctl       /* ioctl */
-#ifndef CONFIG_DISABLE_POLL
+#ifdef FB_HAVE_POLL
+  , fb_poll      /* poll */
+#elif !defined(CONFIG_DISABLE_POLL)
   , NULL         /* poll */
 #endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
@@ -175,7 +205,7 @@ static ssize_t fb_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* And transfer the data from the frame buffer */
 
-  memcpy(buffer, fb->fbmem, size);
+  memcpy(buffer, (FAR uint8_t *)fb->fbmem + start, size);
   filep->f_pos += size;
   return size;
 }
@@ -219,7 +249,7 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
 
   /* And transfer the data into the frame buffer */
 
-  memcpy(fb->fbmem, buffer, size);
+  memcpy((FAR uint8_t *)fb->fbmem + start, buffer, size);
   filep->f_pos += size;
   return size;
 }
@@ -404,6 +434,60 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_FB_PANDISPLAY
+      case FBIOPAN_DISPLAY:  /* Display the buffer at yoffset */
+        {
+          FAR const struct fb_planeinfo_s *pinfo =
+            (FAR const struct fb_planeinfo_s *)((uintptr_t)arg);
+          irqstate_t flags;
+
+          DEBUGASSERT(pinfo != NULL && fb->vtable != NULL);
+          if (fb->vtable->pandisplay == NULL)
+            {
+              ret = -ENOTTY;
+              break;
+            }
+
+          /* The driver may complete the pan before returning */
+
+          flags = enter_critical_section();
+          fb->panpending = true;
+          ret = fb->vtable->pandisplay(fb->vtable, fb->plane, pinfo);
+          if (ret < 0)
+            {
+              fb->panpending = false;
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      case FBIO_WAITFORVSYNC:  /* Wait until a pending pan is displayed */
+        {
+          irqstate_t flags;
+
+          ret   = OK;
+          flags = enter_critical_section();
+          while (fb->panpending)
+            {
+              fb->nwaiters++;
+              if (sem_wait(&fb->vsyncsem) < 0)
+                {
+                  /* Interrupted.  The waiter count is not decremented by
+                   * fb_notify_vsync() in this case.
+                   */
+
+                  fb->nwaiters--;
+                  ret = -get_errno();
+                  break;
+                }
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NX_UPDATE
       case FBIO_UPDATE:  /* Get video plane info */
         {
@@ -430,6 +514,79 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: fb_poll
+ *
+ * Description:
+ *   The standard poll method.  POLLOUT is reported when no pan is pending,
+ *   i.e. when the buffer that was displayed before the last FBIOPAN_DISPLAY
+ *   is no longer scanned out and may be drawn.
+ *
+ ****************************************************************************/
+
+#ifdef FB_HAVE_POLL
+static int fb_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                   bool setup)
+{
+  FAR struct inode *inode;
+  FAR struct fb_chardev_s *fb;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  DEBUGASSERT(filep != NULL && filep->f_inode != NULL);
+  inode = filep->f_inode;
+  fb    = (FAR struct fb_chardev_s *)inode->i_private;
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_FB_NPOLLWAITERS; i++)
+        {
+          if (fb->fds[i] == NULL)
+            {
+              /* Bind the poll structure and this slot */
+
+              fb->fds[i] = fds;
+              fds->priv  = &fb->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FB_NPOLLWAITERS)
+        {
+          gerr("ERROR: Too many poll waiters\n");
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (!fb->panpending)
+        {
+          /* The display is ready now */
+
+          fds->revents |= (fds->events & POLLOUT);
+          if (fds->revents != 0)
+            {
+              sem_post(fds->sem);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll */
+
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -518,6 +675,16 @@ int fb_register(int display, int plane)
   fb->fblen  = pinfo.fblen;
   fb->bpp    = pinfo.bpp;
 
+#ifdef CONFIG_FB_PANDISPLAY
+  /* Initialize the page flip state.  vsyncsem is a signaling semaphore and,
+   * hence, must not have priority inheritance enabled.
+   */
+
+  sem_init(&fb->vsyncsem, 0, 0);
+  sem_setprotocol(&fb->vsyncsem, SEM_PRIO_NONE);
+  fb->vtable->priv = fb;
+#endif
+
   /* Clear the framebuffer memory */
 
   memset(pinfo.fbmem, 0, pinfo.fblen);
@@ -543,6 +710,80 @@ int fb_register(int display, int plane)
   return OK;
 
 errout_with_fb:
+#ifdef CONFIG_FB_PANDISPLAY
+  if (fb->vtable != NULL && fb->vtable->priv == fb)
+    {
+      fb->vtable->priv = NULL;
+      sem_destroy(&fb->vsyncsem);
+    }
+
+#endif
   kmm_free(fb);
   return ret;
 }
+
+/****************************************************************************
+ * Name: fb_notify_vsync
+ *
+ * Description:
+ *   Called by the framebuffer driver, normally from its vertical
+ *   synchronization interrupt handler, when the offset set by the last
+ *   pandisplay() call has taken effect.  This wakes up the threads waiting
+ *   in FBIO_WAITFORVSYNC or poll().
+ *
+ * Input Parameters:
+ *   vtable - The framebuffer object passed to pandisplay()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PANDISPLAY
+void fb_notify_vsync(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb;
+  irqstate_t flags;
+#ifdef FB_HAVE_POLL
+  FAR struct pollfd *fds;
+  int i;
+#endif
+
+  DEBUGASSERT(vtable != NULL);
+  fb = (FAR struct fb_chardev_s *)vtable->priv;
+  if (fb == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  fb->panpending = false;
+
+  /* Wake up all threads waiting for the pan to complete */
+
+  while (fb->nwaiters > 0)
+    {
+      fb->nwaiters--;
+      sem_post(&fb->vsyncsem);
+    }
+
+#ifdef FB_HAVE_POLL
+  /* And notify the poll waiters that the display is ready */
+
+  for (i = 0; i < CONFIG_FB_NPOLLWAITERS; i++)
+    {
+      fds = fb->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & POLLOUT);
+          if (fds->revents != 0)
+            {
+              sem_post(fds->sem);
+            }
+        }
+    }
+#endif
+
+  leave_critical_section(flags);
+}
+#endif
@@ -48,6 +48,7 @@
 #include <queue.h>
 
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #ifdef CONFIG_FS_AIO
@@ -87,6 +88,10 @@
  */
 
 struct file;
+#ifdef CONFIG_FS_AIO_ENGINE
+struct aio_devq_s;
+#endif
+
 struct aio_container_s
 {
   dq_entry_t aioc_link;            /* Supports a doubly linked list */
@@ -101,11 +106,22 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
+#ifdef CONFIG_FS_AIO_ENGINE
+  dq_entry_t aioc_qlink;           /* Links the device or completion queue */
+  FAR struct aio_devq_s *aioc_devq; /* Device queue of the request */
+  worker_t aioc_worker;            /* Performs the I/O on an AIO thread */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
+#ifdef CONFIG_FS_AIO_DRIVER
+  uint8_t aioc_op;                 /* LIO_READ, LIO_WRITE, or LIO_NOP */
+  ssize_t aioc_result;             /* Result reported by the driver */
+  struct aio_request_s aioc_req;   /* Request offered to the driver */
+#endif
 };
 
 /****************************************************************************
@@ -244,7 +260,9 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_ENGINE is selected, on the submission queue of the
+ *   device.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -258,6 +276,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been started from the queue.
+ *   The caller must hold the lock on the pending transfer list.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue; -ENOENT if the I/O
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -0,0 +1,697 @@
+/****************************************************************************
+ * fs/aio/aio_engine.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_ENGINE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_AIO_NTHREADS
+#  define CONFIG_FS_AIO_NTHREADS 2
+#endif
+
+#ifndef CONFIG_FS_AIO_PRIORITY
+#  define CONFIG_FS_AIO_PRIORITY 100
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#  define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
+/* Each device queue in use holds at least one container or is being
+ * serviced by an AIO thread.
+ */
+
+#define AIO_NDEVQ (CONFIG_FS_NAIOC + CONFIG_FS_AIO_NTHREADS)
+
+/* Recover the container from its device or completion queue link */
+
+#define AIOC_FROM_QLINK(e) \
+  ((FAR struct aio_container_s *) \
+   ((uintptr_t)(e) - offsetof(struct aio_container_s, aioc_qlink)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the submission queue of one device */
+
+struct aio_devq_s
+{
+  FAR void *key;                   /* Inode or socket; NULL if unused */
+  dq_queue_t pending;              /* Requests that have not been started */
+  uint8_t inflight;                /* Requests accepted by the driver */
+  bool active;                     /* An AIO thread services the queue */
+  bool stalled;                    /* Head waits for in-flight requests */
+#ifdef CONFIG_FS_AIO_DRIVER
+  bool driver;                     /* Requests may be offered to driver */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The device submission queues.  These, and the completion queue, are
+ * protected by a critical section because the driver may complete
+ * requests from interrupt level.
+ */
+
+static struct aio_devq_s g_aio_devq[AIO_NDEVQ];
+
+#ifdef CONFIG_FS_AIO_DRIVER
+/* Requests that have been completed by the driver */
+
+static dq_queue_t g_aio_done;
+#endif
+
+/* The AIO threads wait on this semaphore for new work */
+
+static sem_t g_aio_enginesem;
+
+/* The next device queue to be considered for service */
+
+static uint8_t g_aio_nextq;
+
+/* True if the AIO threads have been started */
+
+static bool g_aio_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_engine_wakeup
+ *
+ * Description:
+ *   Wake up one AIO thread if any thread is waiting for work.  A thread
+ *   that is busy will look for more work before it waits again.  Must be
+ *   called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void aio_engine_wakeup(void)
+{
+  int semcount;
+
+  (void)sem_getvalue(&g_aio_enginesem, &semcount);
+  if (semcount < 0)
+    {
+      sem_post(&g_aio_enginesem);
+    }
+}
+
+/****************************************************************************
+ * Name: aio_engine_release
+ *
+ * Description:
+ *   Release a device queue if it is no longer in use.  Must be called from
+ *   within a critical section.
+ *
+ ****************************************************************************/
+
+static void aio_engine_release(FAR struct aio_devq_s *devq)
+{
+  if (!devq->active && devq->inflight == 0 && devq->pending.head == NULL)
+    {
+      devq->key = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: aio_engine_devq
+ *
+ * Description:
+ *   Find the submission queue of the device that the request is directed
+ *   to, allocating a new queue if necessary.  Must be called from within a
+ *   critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_devq_s *
+aio_engine_devq(FAR struct aio_container_s *aioc)
+{
+  FAR struct aio_devq_s *devq = NULL;
+  FAR void *key = NULL;
+#ifdef CONFIG_FS_AIO_DRIVER
+  bool driver = false;
+#endif
+  int i;
+
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  if (aioc->aioc_aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+#endif
+#ifdef AIO_HAVE_FILEP
+    {
+      FAR struct inode *inode = aioc->u.aioc_filep->f_inode;
+
+      /* All files on a mounted volume share the inode of the mountpoint,
+       * so there is one queue for each device or volume.
+       */
+
+      key = inode;
+#ifdef CONFIG_FS_AIO_DRIVER
+      driver = INODE_IS_DRIVER(inode) && inode->u.i_ops != NULL &&
+               inode->u.i_ops->ioctl != NULL;
+#endif
+    }
+#endif
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  else
+#endif
+#ifdef AIO_HAVE_PSOCK
+    {
+      key = aioc->u.aioc_psock;
+    }
+#endif
+
+  DEBUGASSERT(key != NULL);
+
+  for (i = 0; i < AIO_NDEVQ; i++)
+    {
+      if (g_aio_devq[i].key == key)
+        {
+          return &g_aio_devq[i];
+        }
+      else if (devq == NULL && g_aio_devq[i].key == NULL)
+        {
+          devq = &g_aio_devq[i];
+        }
+    }
+
+  DEBUGASSERT(devq != NULL);
+
+  dq_init(&devq->pending);
+  devq->key      = key;
+  devq->inflight = 0;
+  devq->active   = false;
+  devq->stalled  = false;
+#ifdef CONFIG_FS_AIO_DRIVER
+  devq->driver   = driver;
+#endif
+  return devq;
+}
+
+/****************************************************************************
+ * Name: aio_engine_select
+ *
+ * Description:
+ *   Select the next device queue that needs service.  The queues are
+ *   considered in round-robin order.  Must be called from within a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_devq_s *aio_engine_select(void)
+{
+  FAR struct aio_devq_s *devq;
+  int ndx;
+  int i;
+
+  for (i = 0, ndx = g_aio_nextq; i < AIO_NDEVQ; i++)
+    {
+      devq = &g_aio_devq[ndx];
+      if (++ndx >= AIO_NDEVQ)
+        {
+          ndx = 0;
+        }
+
+      if (devq->key != NULL && !devq->active && !devq->stalled &&
+          devq->pending.head != NULL)
+        {
+          g_aio_nextq = ndx;
+          return devq;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: aio_engine_perform
+ *
+ * Description:
+ *   Perform the I/O synchronously on this AIO thread.  The worker decants
+ *   the container and signals the client.
+ *
+ ****************************************************************************/
+
+static void aio_engine_perform(FAR struct aio_container_s *aioc)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  struct sched_param param;
+  bool boost;
+
+  /* Run at the priority of the waiting task if that is higher */
+
+  boost = (aioc->aioc_prio > CONFIG_FS_AIO_PRIORITY);
+  if (boost)
+    {
+      param.sched_priority = aioc->aioc_prio;
+      (void)sched_setparam(0, &param);
+    }
+#endif
+
+  aioc->aioc_worker(aioc);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (boost)
+    {
+      param.sched_priority = CONFIG_FS_AIO_PRIORITY;
+      (void)sched_setparam(0, &param);
+    }
+#endif
+}
+
+#ifdef CONFIG_FS_AIO_DRIVER
+/****************************************************************************
+ * Name: aio_engine_done
+ *
+ * Description:
+ *   Called by the driver when a transfer that it accepted has completed.
+ *   This may run at interrupt level so the request is only moved to the
+ *   completion queue; the client is signalled from an AIO thread.
+ *
+ ****************************************************************************/
+
+static void aio_engine_done(FAR struct aio_request_s *req, ssize_t result)
+{
+  FAR struct aio_container_s *aioc;
+  irqstate_t flags;
+
+  aioc = (FAR struct aio_container_s *)req->ar_priv;
+  aioc->aioc_result = result;
+
+  flags = enter_critical_section();
+  dq_addlast(&aioc->aioc_qlink, &g_aio_done);
+  aio_engine_wakeup();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: aio_engine_submit
+ *
+ * Description:
+ *   Offer a read or write transfer to the driver.
+ *
+ * Returned Value:
+ *   Zero (OK) if the driver accepted the request and will call
+ *   aio_engine_done() when it completes.  Otherwise, a negated errno value
+ *   and the I/O must be performed synchronously.  -ENOTTY means that the
+ *   driver does not support queued transfers at all.
+ *
+ ****************************************************************************/
+
+static int aio_engine_submit(FAR struct aio_container_s *aioc)
+{
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  FAR struct aio_request_s *req = &aioc->aioc_req;
+  FAR struct file *filep = aioc->u.aioc_filep;
+  FAR struct inode *inode = filep->f_inode;
+
+  /* Appending writes need the current end of the file */
+
+  if (aioc->aioc_op == LIO_WRITE && (filep->f_oflags & O_APPEND) != 0)
+    {
+      return -EINVAL;
+    }
+
+  req->ar_buffer   = (FAR uint8_t *)aiocbp->aio_buf;
+  req->ar_offset   = aiocbp->aio_offset;
+  req->ar_nbytes   = aiocbp->aio_nbytes;
+  req->ar_sector   = 0;
+  req->ar_nsectors = 0;
+  req->ar_write    = (aioc->aioc_op == LIO_WRITE);
+  req->ar_done     = aio_engine_done;
+  req->ar_priv     = aioc;
+
+  return inode->u.i_ops->ioctl(filep, BIOC_AIOSUBMIT,
+                               (unsigned long)((uintptr_t)req));
+}
+
+/****************************************************************************
+ * Name: aio_engine_complete
+ *
+ * Description:
+ *   Finish a request that was completed by the driver:  Release the
+ *   container and signal the client.
+ *
+ ****************************************************************************/
+
+static void aio_engine_complete(FAR struct aio_container_s *aioc)
+{
+  FAR struct aio_devq_s *devq = aioc->aioc_devq;
+  FAR struct aio_request_s *req = &aioc->aioc_req;
+  FAR struct aiocb *aiocbp;
+  irqstate_t flags;
+  ssize_t result;
+  pid_t pid;
+
+  /* The driver reports the number of sectors transferred */
+
+  result = aioc->aioc_result;
+  if (result >= (ssize_t)req->ar_nsectors)
+    {
+      result = req->ar_nbytes;
+    }
+  else if (result > 0)
+    {
+      result *= req->ar_nbytes / req->ar_nsectors;
+    }
+
+  pid = aioc->aioc_pid;
+
+  /* I/O that was held back for the in-flight transfers may now start */
+
+  flags = enter_critical_section();
+  DEBUGASSERT(devq->inflight > 0);
+  if (--devq->inflight == 0)
+    {
+      devq->stalled = false;
+      aio_engine_release(devq);
+    }
+
+  leave_critical_section(flags);
+
+  aiocbp = aioc_decant(aioc);
+  aiocbp->aio_result = result;
+  (void)aio_signal(pid, aiocbp);
+}
+#endif /* CONFIG_FS_AIO_DRIVER */
+
+/****************************************************************************
+ * Name: aio_engine_thread
+ *
+ * Description:
+ *   The AIO threads.  Each thread takes one device queue at a time and
+ *   services it until the queue is empty.
+ *
+ ****************************************************************************/
+
+static int aio_engine_thread(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_devq_s *devq;
+  FAR dq_entry_t *entry;
+  irqstate_t flags;
+#ifdef CONFIG_FS_AIO_DRIVER
+  int ret;
+#endif
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+
+#ifdef CONFIG_FS_AIO_DRIVER
+      /* Finish the transfers completed by the driver first */
+
+      entry = dq_remfirst(&g_aio_done);
+      if (entry != NULL)
+        {
+          leave_critical_section(flags);
+          aio_engine_complete(AIOC_FROM_QLINK(entry));
+          continue;
+        }
+#endif
+
+      devq = aio_engine_select();
+      if (devq == NULL)
+        {
+          /* Nothing to do.  The critical section is released while we
+           * wait.
+           */
+
+          (void)sem_wait(&g_aio_enginesem);
+          leave_critical_section(flags);
+          continue;
+        }
+
+      devq->active = true;
+      while ((entry = devq->pending.head) != NULL)
+        {
+          aioc = AIOC_FROM_QLINK(entry);
+
+#ifdef CONFIG_FS_AIO_DRIVER
+          if (devq->driver && aioc->aioc_op != LIO_NOP)
+            {
+              /* Offer the transfer to the driver.  The in-flight count is
+               * incremented first because the driver may complete the
+               * transfer before the ioctl returns.
+               */
+
+              dq_rem(entry, &devq->pending);
+              devq->inflight++;
+              leave_critical_section(flags);
+
+              ret = aio_engine_submit(aioc);
+
+              flags = enter_critical_section();
+              if (ret >= 0)
+                {
+                  continue;
+                }
+
+              /* Not accepted.  Put it back and perform it below. */
+
+              devq->inflight--;
+              if (ret == -ENOTTY)
+                {
+                  devq->driver = false;
+                }
+
+              dq_addfirst(entry, &devq->pending);
+            }
+#endif
+
+          /* Any other I/O waits until the driver has completed all of the
+           * transfers that it accepted.
+           */
+
+          if (devq->inflight > 0)
+            {
+              devq->stalled = true;
+              break;
+            }
+
+          dq_rem(entry, &devq->pending);
+          leave_critical_section(flags);
+
+          aio_engine_perform(aioc);
+
+          flags = enter_critical_section();
+        }
+
+      devq->active = false;
+      aio_engine_release(devq);
+      leave_critical_section(flags);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Name: aio_engine_start
+ *
+ * Description:
+ *   Start the AIO threads when the first request is queued.
+ *
+ ****************************************************************************/
+
+static int aio_engine_start(void)
+{
+  int ret = OK;
+  int i;
+
+  aio_lock();
+  if (!g_aio_started)
+    {
+      /* This semaphore is used for signaling and, hence, should not have
+       * priority inheritance enabled.
+       */
+
+      sem_init(&g_aio_enginesem, 0, 0);
+      sem_setprotocol(&g_aio_enginesem, SEM_PRIO_NONE);
+
+      for (i = 0; i < CONFIG_FS_AIO_NTHREADS; i++)
+        {
+          ret = kernel_thread("aio", CONFIG_FS_AIO_PRIORITY,
+                              CONFIG_FS_AIO_STACKSIZE,
+                              (main_t)aio_engine_thread,
+                              (FAR char * const *)NULL);
+          if (ret < 0)
+            {
+              ret = -get_errno();
+              ferr("ERROR: kernel_thread %d failed: %d\n", i, ret);
+              break;
+            }
+        }
+
+      /* Run with the threads that could be started */
+
+      if (i > 0)
+        {
+          g_aio_started = true;
+          ret = OK;
+        }
+    }
+
+  aio_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_queue
+ *
+ * Description:
+ *   Add the asynchronous I/O to the submission queue of its device
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   worker - The function that performs the I/O synchronously
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  FAR struct aio_devq_s *devq;
+  irqstate_t flags;
+  int ret;
+
+  ret = aio_engine_start();
+  if (ret < 0)
+    {
+      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+      DEBUGASSERT(aiocbp);
+
+      aiocbp->aio_result = ret;
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  aioc->aioc_worker = worker;
+
+  flags = enter_critical_section();
+  devq = aio_engine_devq(aioc);
+  aioc->aioc_devq = devq;
+  dq_addlast(&aioc->aioc_qlink, &devq->pending);
+  aio_engine_wakeup();
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been started from the queue.
+ *   The caller must hold the lock on the pending transfer list.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue; -ENOENT if the I/O
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  FAR struct aio_devq_s *devq = aioc->aioc_devq;
+  FAR dq_entry_t *entry;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  if (devq == NULL)
+    {
+      return -ENOENT;
+    }
+
+  flags = enter_critical_section();
+  for (entry = devq->pending.head; entry != NULL; entry = entry->flink)
+    {
+      if (entry == &aioc->aioc_qlink)
+        {
+          dq_rem(entry, &devq->pending);
+          aio_engine_release(devq);
+          ret = OK;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_AIO_ENGINE */
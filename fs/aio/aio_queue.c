@@ -75,20 +75,17 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   int ret;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Prohibit context switches until we complete the queuing */
-
-  sched_lock();
-
-  /* Make sure that the low-priority worker thread is running at at least
-   * the priority specified for this action.
+  /* Schedule the work on the low priority worker thread.  It will be
+   * performed ahead of lower priority work and at the priority of the
+   * task that requested the I/O.
    */
 
-  lpwork_boostpriority(aioc->aioc_prio);
-#endif
-
+  ret = lpwork_queue(&aioc->aioc_work, worker, aioc, 0, aioc->aioc_prio);
+#else
   /* Schedule the work on the low priority worker thread */
 
   ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
+#endif
   if (ret < 0)
     {
       FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
@@ -99,12 +96,28 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
       ret = ERROR;
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Now the low-priority work queue might run at its new priority */
-
-  sched_unlock();
-#endif
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove asynchronous I/O that has not yet been started from the queue.
+ *   The caller must hold the lock on the pending transfer list.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue; -ENOENT if the I/O
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  return work_cancel(LPWORK, &aioc->aioc_work);
+}
+
 #endif /* CONFIG_FS_AIO */
@@ -77,9 +77,6 @@ static void aio_read_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
-#endif
   ssize_t nread = 0;
 
   /* Get the information from the container, decant the AIO control block,
@@ -89,9 +86,6 @@ static void aio_read_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
-#endif
   aiocbp = aioc_decant(aioc);
 
 #if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
@@ -145,12 +139,6 @@ static void aio_read_worker(FAR void *arg)
   /* Signal the client */
 
   (void)aio_signal(pid, aiocbp);
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
-
-  lpwork_restorepriority(prio);
-#endif
 }
 
 /****************************************************************************
@@ -278,6 +266,12 @@ int aio_read(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
+#ifdef CONFIG_FS_AIO_DRIVER
+  /* The AIO engine may offer the transfer to the driver */
+
+  aioc->aioc_op = LIO_READ;
+
+#endif
   /* Defer the work to the worker thread */
 
   ret = aio_queue(aioc, aio_read_worker);
@@ -62,6 +62,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/dirent.h>
 
 #include "inode/inode.h"
@@ -486,6 +487,11 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   bool force_indirect = false;
 #endif
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint32_t request;
+  uint32_t index;
+#endif
+
   /* Sanity checks */
 
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -569,15 +575,31 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
       if (ff->ff_sectorsincluster < 1)
         {
-          /* Find the next cluster in the FAT. */
+#ifdef CONFIG_FAT_EXTENTCACHE
+          /* The next cluster may already be known from the extent map */
+
+          index   = filep->f_pos /
+                    (fs->fs_fatsecperclus * fs->fs_hwsectorsize);
+          request = index;
+          cluster = fat_ffextent_find(ff, &index);
+          if (cluster == 0 || index != request)
+#endif
+            {
+              /* Find the next cluster in the FAT. */
+
+              cluster = fat_getcluster(fs, ff->ff_currentcluster);
+            }
 
-          cluster = fat_getcluster(fs, ff->ff_currentcluster);
           if (cluster < 2 || cluster >= fs->fs_nclusters)
             {
               ret = -EINVAL; /* Not the right error */
               goto errout_with_semaphore;
             }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+          fat_ffextent_add(ff, request, cluster);
+#endif
+
           /* Setup to read the first sector from the new cluster */
 
           ff->ff_currentcluster   = cluster;
@@ -603,13 +625,11 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in any physically contiguous clusters
+           * that follow it in the chain.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contiguous(fs, ff, nsectors, filep->f_pos, false);
 
           /* We are not sure of the state of the file buffer so
            * the safest thing to do is just invalidate it
@@ -642,23 +662,41 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
+          fat_ffadvance(fs, ff, nsectors);
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
         {
+          FAR const uint8_t *src;
+
           /* We are reading a partial sector, or handling a non-DMA-able
-           * whole-sector transfer.  First, read the whole sector
-           * into the file data buffer.  This is a caching buffer so if
-           * it is already there then all is well.
+           * whole-sector transfer.  If the sector is held in memory and
+           * the file buffer does not hold a newer copy of it, then copy
+           * it directly from there.
            */
 
-          ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
-          if (ret < 0)
+          if (fs->fs_membase != NULL &&
+              ((ff->ff_bflags & FFBUFF_DIRTY) == 0 ||
+               ff->ff_cachesector != ff->ff_currentsector))
             {
-              goto errout_with_semaphore;
+              src = &fs->fs_membase[ff->ff_currentsector *
+                                    fs->fs_hwsectorsize];
+            }
+          else
+            {
+              /* Otherwise, read the whole sector into the file data
+               * buffer.  This is a caching buffer so if it is already
+               * there then all is well.
+               */
+
+              ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
+              if (ret < 0)
+                {
+                  goto errout_with_semaphore;
+                }
+
+              src = ff->ff_buffer;
             }
 
           /* Copy the requested part of the sector into the user buffer */
@@ -678,7 +716,7 @@ fat_read_restart:
               ff->ff_currentsector++;
             }
 
-          memcpy(userbuffer, &ff->ff_buffer[sectorindex], bytesread);
+          memcpy(userbuffer, &src[sectorindex], bytesread);
         }
 
       /* Set up for the next sector read */
@@ -838,6 +876,12 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
               goto errout_with_semaphore;
             }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+          fat_ffextent_add(ff, filep->f_pos /
+                           (fs->fs_fatsecperclus * fs->fs_hwsectorsize),
+                           cluster);
+#endif
+
           /* Setup to write the first sector from the new cluster */
 
           ff->ff_currentcluster   = cluster;
@@ -862,13 +906,12 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in any physically contiguous clusters
+           * that follow it in the chain (extending the chain as
+           * necessary).
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
-            {
-              nsectors = ff->ff_sectorsincluster;
-            }
+          nsectors = fat_contiguous(fs, ff, nsectors, filep->f_pos, true);
 
           /* We are not sure of the state of the sector cache so the
            * safest thing to do is write back any dirty, cached sector
@@ -902,8 +945,7 @@ fat_write_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
+          fat_ffadvance(fs, ff, nsectors);
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
         }
@@ -1019,6 +1061,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   unsigned int clustersize;
   int ret;
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint32_t index;
+#endif
+
   /* Sanity checks */
 
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1139,6 +1185,21 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      /* Skip directly to the last known cluster at or before the one
+       * containing the requested position.
+       */
+
+      fat_ffextent_add(ff, 0, cluster);
+
+      index   = position / clustersize;
+      cluster = fat_ffextent_find(ff, &index);
+
+      filep->f_pos = (off_t)index * clustersize;
+      position    -= filep->f_pos;
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1209,6 +1270,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
           filep->f_pos += clustersize;
           position     -= clustersize;
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+          fat_ffextent_add(ff, filep->f_pos / clustersize, cluster);
+#endif
         }
 
       /* We get here after we have found the sector containing
@@ -1397,6 +1462,22 @@ static int fat_sync(FAR struct file *filep)
 
       fs->fs_dirty = true;
       ret          = fat_updatefsinfo(fs);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+
+      /* Ask the block driver to write back anything that it buffers */
+
+      inode = fs->fs_blkdriver;
+      if (inode->u.i_bops->ioctl)
+        {
+          ret = inode->u.i_bops->ioctl(inode, BIOC_FLUSH, 0);
+          if (ret == -ENOTTY || ret == -EINVAL)
+            {
+              ret = OK;
+            }
+        }
     }
 
 errout_with_semaphore:
@@ -1502,6 +1583,14 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+  /* The cluster chain map remains valid for the new file structure */
+
+  newff->ff_nextents         = oldff->ff_nextents;
+  memcpy(newff->ff_extents, oldff->ff_extents,
+         oldff->ff_nextents * sizeof(struct fat_extent_s));
+#endif
+
   /* Attach the private date to the struct file instance */
 
   newp->f_priv = newff;
@@ -2023,6 +2112,15 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+#ifdef CONFIG_FAT_SECTCACHE
+  /* Write back any dirty sectors held in the sector cache */
+
+  if (fs->fs_mounted)
+    {
+      (void)fat_cache_flush(fs);
+    }
+#endif
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2055,6 +2153,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_SECTCACHE
+  fat_cache_release(fs);
+#endif
+
   sem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
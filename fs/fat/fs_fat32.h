@@ -55,6 +55,26 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifdef CONFIG_FAT_SECTCACHE
+#  ifndef CONFIG_FAT_SECTCACHE_NSECTORS
+#    define CONFIG_FAT_SECTCACHE_NSECTORS 8
+#  endif
+
+#  ifndef CONFIG_FAT_SECTCACHE_NFAT
+#    define CONFIG_FAT_SECTCACHE_NFAT 2
+#  endif
+
+#  if CONFIG_FAT_SECTCACHE_NFAT >= CONFIG_FAT_SECTCACHE_NSECTORS
+#    error CONFIG_FAT_SECTCACHE_NFAT must be less than CONFIG_FAT_SECTCACHE_NSECTORS
+#  endif
+#endif
+
+#if defined(CONFIG_FAT_EXTENTCACHE) && !defined(CONFIG_FAT_EXTENTCACHE_NEXTENTS)
+#  define CONFIG_FAT_EXTENTCACHE_NEXTENTS 8
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record.
  *
@@ -713,6 +733,23 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FAT_SECTCACHE
+/* This structure describes one sector held in the mountpoint sector cache.
+ * The sector cache holds recently used directory and FAT sectors that have
+ * been displaced from fs_buffer.  A sector is never held in both fs_buffer
+ * and in the sector cache at the same time.
+ */
+
+struct fat_cachesect_s
+{
+  off_t    cs_sector;              /* The sector number held in cs_buffer */
+  uint32_t cs_lastuse;             /* Value of fs_cachetick when last used */
+  bool     cs_valid;               /* true: cs_buffer holds valid data */
+  bool     cs_dirty;               /* true: cs_buffer must be written to disk */
+  uint8_t *cs_buffer;              /* Allocated buffer to hold one sector */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -747,7 +784,31 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+  FAR const uint8_t *fs_membase;   /* Device content if held in memory (or NULL) */
+#ifdef CONFIG_FAT_SECTCACHE
+  uint32_t fs_cachetick;           /* Incremented on each sector cache access */
+
+  /* The sector cache.  The first CONFIG_FAT_SECTCACHE_NFAT entries are
+   * reserved for sectors from the FAT region.
+   */
+
+  struct fat_cachesect_s fs_cache[CONFIG_FAT_SECTCACHE_NSECTORS];
+#endif
+};
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+/* This structure describes one run of contiguous clusters in a file.  The
+ * extents of an open file describe the beginning of its cluster chain with
+ * no gaps:  Each extent begins at the index where the previous one ends.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* Cluster number of the first cluster */
+  uint32_t fe_count;               /* Number of contiguous clusters */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -768,6 +829,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTCACHE_NEXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -890,6 +955,8 @@ EXTERN int    fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+EXTERN int    fat_fswrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                          off_t sector);
 
 /* Cluster / cluster chain access helpers */
 
@@ -928,12 +995,44 @@ EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 
+/* Per-file map of the cluster chain */
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+EXTERN void   fat_ffextent_add(struct fat_file_s *ff, uint32_t index,
+                               uint32_t cluster);
+EXTERN uint32_t fat_ffextent_find(struct fat_file_s *ff, uint32_t *index);
+#endif
+
+/* Multi-sector cache of directory and FAT sectors */
+
+#ifdef CONFIG_FAT_SECTCACHE
+EXTERN int    fat_cache_initialize(struct fat_mountpt_s *fs);
+EXTERN void   fat_cache_release(struct fat_mountpt_s *fs);
+EXTERN int    fat_cache_retire(struct fat_mountpt_s *fs);
+EXTERN bool   fat_cache_load(struct fat_mountpt_s *fs, off_t sector);
+EXTERN int    fat_cache_flush(struct fat_mountpt_s *fs);
+EXTERN unsigned int fat_cache_read(struct fat_mountpt_s *fs, uint8_t *buffer,
+                                   off_t sector, unsigned int nsectors,
+                                   bool dirtyonly);
+EXTERN void   fat_cache_update(struct fat_mountpt_s *fs, uint8_t *buffer,
+                               off_t sector, unsigned int nsectors);
+#endif
+
 /* FSINFO sector support */
 
 EXTERN int    fat_updatefsinfo(struct fat_mountpt_s *fs);
 EXTERN int    fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters);
 EXTERN int    fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t position);
 
+/* Multi-sector transfer support */
+
+EXTERN unsigned int fat_contiguous(struct fat_mountpt_s *fs,
+                                   struct fat_file_s *ff,
+                                   unsigned int nsectors, off_t position,
+                                   bool extend);
+EXTERN void   fat_ffadvance(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                            unsigned int nsectors);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
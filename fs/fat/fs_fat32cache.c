@@ -0,0 +1,383 @@
+/****************************************************************************
+ * fs/fat/fs_fat32cache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/fat.h>
+
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_SECTCACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cache_isfat
+ *
+ * Description:
+ *   Return true if the sector lies in the (first) FAT
+ *
+ ****************************************************************************/
+
+static inline bool fat_cache_isfat(FAR struct fat_mountpt_s *fs,
+                                   off_t sector)
+{
+  return sector >= fs->fs_fatbase &&
+         sector < fs->fs_fatbase + fs->fs_nfatsects;
+}
+
+/****************************************************************************
+ * Name: fat_cache_writeback
+ *
+ * Description:
+ *   Write one dirty cache entry back to the media.
+ *
+ ****************************************************************************/
+
+static int fat_cache_writeback(FAR struct fat_mountpt_s *fs,
+                               FAR struct fat_cachesect_s *cs)
+{
+  int ret;
+
+  ret = fat_fswrite(fs, cs->cs_buffer, cs->cs_sector);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to write sector %ld: %d\n",
+           (long)cs->cs_sector, ret);
+      return ret;
+    }
+
+  cs->cs_dirty = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_cache_initialize
+ *
+ * Description:
+ *   Allocate the sector buffers of the mountpoint sector cache.  This must
+ *   be called after the hardware sector size is known.
+ *
+ ****************************************************************************/
+
+int fat_cache_initialize(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *cs;
+  int i;
+
+  fs->fs_cachetick = 0;
+
+  for (i = 0; i < CONFIG_FAT_SECTCACHE_NSECTORS; i++)
+    {
+      cs            = &fs->fs_cache[i];
+      cs->cs_sector = 0;
+      cs->cs_valid  = false;
+      cs->cs_dirty  = false;
+      cs->cs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+
+      if (cs->cs_buffer == NULL)
+        {
+          fat_cache_release(fs);
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_release
+ *
+ * Description:
+ *   Free the sector buffers of the mountpoint sector cache.  Dirty sectors
+ *   are discarded; fat_cache_flush() should be called first if they are to
+ *   be preserved.
+ *
+ ****************************************************************************/
+
+void fat_cache_release(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *cs;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTCACHE_NSECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_buffer != NULL)
+        {
+          fat_io_free(cs->cs_buffer, fs->fs_hwsectorsize);
+          cs->cs_buffer = NULL;
+        }
+
+      cs->cs_valid = false;
+      cs->cs_dirty = false;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_cache_retire
+ *
+ * Description:
+ *   Move the sector currently held in fs_buffer into the sector cache,
+ *   together with its dirty state.  FAT sectors replace the least recently
+ *   used of the entries reserved for the FAT; all other sectors replace the
+ *   least recently used of the remaining entries.  A dirty sector that is
+ *   replaced is written back to the media first (including any FAT copies).
+ *
+ *   On return, fs_buffer is clean and may be overwritten.  fs_currentsector
+ *   is not changed.
+ *
+ ****************************************************************************/
+
+int fat_cache_retire(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *victim = NULL;
+  FAR struct fat_cachesect_s *cs;
+  off_t sector = fs->fs_currentsector;
+  int first;
+  int last;
+  int ret;
+  int i;
+
+  /* Select the class of cache entries that may hold this sector */
+
+  if (fat_cache_isfat(fs, sector))
+    {
+      first = 0;
+      last  = CONFIG_FAT_SECTCACHE_NFAT;
+    }
+  else
+    {
+      first = CONFIG_FAT_SECTCACHE_NFAT;
+      last  = CONFIG_FAT_SECTCACHE_NSECTORS;
+    }
+
+  /* Re-use an entry that already holds this sector.  Otherwise, prefer an
+   * unused entry and then the least recently used entry.
+   */
+
+  for (i = first; i < last; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid && cs->cs_sector == sector)
+        {
+          victim = cs;
+          break;
+        }
+
+      if (victim == NULL ||
+          (victim->cs_valid &&
+           (!cs->cs_valid ||
+            (int32_t)(cs->cs_lastuse - victim->cs_lastuse) < 0)))
+        {
+          victim = cs;
+        }
+    }
+
+  /* Write back the replaced sector if it is dirty */
+
+  if (victim->cs_valid && victim->cs_dirty && victim->cs_sector != sector)
+    {
+      ret = fat_cache_writeback(fs, victim);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Then move the contents of fs_buffer into the cache entry */
+
+  memcpy(victim->cs_buffer, fs->fs_buffer, fs->fs_hwsectorsize);
+  victim->cs_sector  = sector;
+  victim->cs_lastuse = ++fs->fs_cachetick;
+  victim->cs_valid   = true;
+  victim->cs_dirty   = fs->fs_dirty;
+
+  fs->fs_dirty       = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_load
+ *
+ * Description:
+ *   If the sector is held in the sector cache, move it into fs_buffer
+ *   (together with its dirty state) and return true.  fs_buffer must be
+ *   clean on entry.
+ *
+ ****************************************************************************/
+
+bool fat_cache_load(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  FAR struct fat_cachesect_s *cs;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTCACHE_NSECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid && cs->cs_sector == sector)
+        {
+          memcpy(fs->fs_buffer, cs->cs_buffer, fs->fs_hwsectorsize);
+          fs->fs_currentsector = sector;
+          fs->fs_dirty         = cs->cs_dirty;
+
+          cs->cs_valid         = false;
+          cs->cs_dirty         = false;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: fat_cache_flush
+ *
+ * Description:
+ *   Write all dirty sectors in the sector cache back to the media.  The
+ *   sectors remain in the cache.
+ *
+ ****************************************************************************/
+
+int fat_cache_flush(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cachesect_s *cs;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTCACHE_NSECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid && cs->cs_dirty)
+        {
+          ret = fat_cache_writeback(fs, cs);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cache_read
+ *
+ * Description:
+ *   Copy any cached sectors in the range sector..sector+nsectors-1 into the
+ *   caller's buffer.  If dirtyonly is true, only dirty sectors (i.e., those
+ *   that differ from the media) are copied.  Returns the number of sectors
+ *   copied.
+ *
+ ****************************************************************************/
+
+unsigned int fat_cache_read(FAR struct fat_mountpt_s *fs,
+                            FAR uint8_t *buffer, off_t sector,
+                            unsigned int nsectors, bool dirtyonly)
+{
+  FAR struct fat_cachesect_s *cs;
+  unsigned int ncopied = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTCACHE_NSECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid && (cs->cs_dirty || !dirtyonly) &&
+          cs->cs_sector >= sector && cs->cs_sector < sector + nsectors)
+        {
+          memcpy(&buffer[(cs->cs_sector - sector) * fs->fs_hwsectorsize],
+                 cs->cs_buffer, fs->fs_hwsectorsize);
+          cs->cs_lastuse = ++fs->fs_cachetick;
+          ncopied++;
+        }
+    }
+
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: fat_cache_update
+ *
+ * Description:
+ *   Called after sectors have been written to the media.  Any cached copies
+ *   of those sectors are updated and marked clean.
+ *
+ ****************************************************************************/
+
+void fat_cache_update(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                      off_t sector, unsigned int nsectors)
+{
+  FAR struct fat_cachesect_s *cs;
+  FAR uint8_t *src;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_SECTCACHE_NSECTORS; i++)
+    {
+      cs = &fs->fs_cache[i];
+      if (cs->cs_valid &&
+          cs->cs_sector >= sector && cs->cs_sector < sector + nsectors)
+        {
+          src = &buffer[(cs->cs_sector - sector) * fs->fs_hwsectorsize];
+          if (src != cs->cs_buffer)
+            {
+              memcpy(cs->cs_buffer, src, fs->fs_hwsectorsize);
+            }
+
+          cs->cs_dirty = false;
+        }
+    }
+}
+
+#endif /* CONFIG_FAT_SECTCACHE */
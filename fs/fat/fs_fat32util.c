@@ -59,6 +59,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -532,6 +533,22 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
+  /* If the device content is held in memory (a RAM disk, for example), then
+   * sectors can be copied from that memory directly.
+   */
+
+  fs->fs_membase = NULL;
+  if (inode->u.i_bops->ioctl != NULL)
+    {
+      FAR void *membase;
+
+      if (inode->u.i_bops->ioctl(inode, BIOC_MEMBASE,
+                                 (unsigned long)((uintptr_t)&membase)) >= 0)
+        {
+          fs->fs_membase = (FAR const uint8_t *)membase;
+        }
+    }
+
   /* Allocate a buffer to hold one hardware sector */
 
   fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
@@ -541,6 +558,16 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#ifdef CONFIG_FAT_SECTCACHE
+  /* Allocate the buffers of the multi-sector cache */
+
+  ret = fat_cache_initialize(fs);
+  if (ret < 0)
+    {
+      goto errout_with_buffer;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check at sector zero.  This
    * could be either the boot record or a partition that refers to the boot
    * record.
@@ -629,6 +656,12 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
+  /* fs_buffer now holds the boot record.  Make sure that it is identified
+   * correctly in the case of a partitioned device.
+   */
+
+  fs->fs_currentsector = fs->fs_fatbase - fs->fs_fatresvdseccount;
+
   /* We have what appears to be a valid FAT filesystem! Now read the
    * FSINFO sector (FAT32 only)
    */
@@ -664,6 +697,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_SECTCACHE
+  fat_cache_release(fs);
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
@@ -728,6 +764,33 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
 {
   int ret = -ENODEV;
+
+#ifdef CONFIG_FAT_SECTCACHE
+  /* A single sector read may be satisfied from the sector cache */
+
+  if (fs && nsectors == 1 && fat_cache_read(fs, buffer, sector, 1, false) > 0)
+    {
+      return OK;
+    }
+#endif
+
+  /* A memory-backed device is read by copying from its memory */
+
+  if (fs && fs->fs_membase)
+    {
+      if (sector < 0 || sector + nsectors > fs->fs_hwnsectors)
+        {
+          return -EINVAL;
+        }
+
+      memcpy(buffer, &fs->fs_membase[sector * fs->fs_hwsectorsize],
+             nsectors * fs->fs_hwsectorsize);
+#ifdef CONFIG_FAT_SECTCACHE
+      (void)fat_cache_read(fs, buffer, sector, nsectors, true);
+#endif
+      return OK;
+    }
+
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
@@ -737,6 +800,11 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                                                        sector, nsectors);
           if (nSectorsRead == nsectors)
             {
+#ifdef CONFIG_FAT_SECTCACHE
+              /* Dirty, cached sectors are newer than the media content */
+
+              (void)fat_cache_read(fs, buffer, sector, nsectors, true);
+#endif
               ret = OK;
             }
           else if (nSectorsRead < 0)
@@ -771,6 +839,11 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
 
           if (nSectorsWritten == nsectors)
             {
+#ifdef CONFIG_FAT_SECTCACHE
+              /* Keep any cached copies of these sectors coherent */
+
+              fat_cache_update(fs, buffer, sector, nsectors);
+#endif
               ret = OK;
             }
           else if (nSectorsWritten < 0)
@@ -783,6 +856,50 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_fswrite
+ *
+ * Description:
+ *   Write one file system sector to the specified sector.  If the sector
+ *   lies in the FAT region, then the change is made in all of the FAT
+ *   copies as well.
+ *
+ ****************************************************************************/
+
+int fat_fswrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector)
+{
+  int ret;
+
+  /* Write the sector */
+
+  ret = fat_hwwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase && sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      /* Yes, then make the change in the FAT copy as well */
+
+      int i;
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -1490,33 +1607,16 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
+      /* Write the dirty sector (and any FAT copies).  NOTE that
+       * fs_currentsector still refers to the buffered sector afterward.
+       */
 
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_fswrite(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
-
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          /* Yes, then make the change in the FAT copy as well */
-          int i;
-
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
-            {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-            }
-        }
-
       /* No longer dirty */
 
       fs->fs_dirty = false;
@@ -1545,6 +1645,25 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   if (fs->fs_currentsector != sector)
     {
+#ifdef CONFIG_FAT_SECTCACHE
+      /* Move the current sector into the sector cache.  Dirty sectors are
+       * retained there and are written back only when they are replaced or
+       * when the cache is flushed.
+       */
+
+      ret = fat_cache_retire(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The requested sector may already be in the sector cache */
+
+      if (fat_cache_load(fs, sector))
+        {
+          return OK;
+        }
+#else
       /* We will need to read the new sector.  First, flush the cached
        * sector if it is dirty.
        */
@@ -1554,12 +1673,18 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
         {
           return ret;
         }
+#endif
 
       /* Then read the specified sector into the cache */
 
       ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
       if (ret < 0)
         {
+#ifdef CONFIG_FAT_SECTCACHE
+          /* Restore the previous contents of fs_buffer */
+
+          (void)fat_cache_load(fs, fs->fs_currentsector);
+#endif
           return ret;
         }
 
@@ -1687,6 +1812,110 @@ int fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff)
   return OK;
 }
 
+#ifdef CONFIG_FAT_EXTENTCACHE
+/****************************************************************************
+ * Name: fat_ffextent_add
+ *
+ * Description:
+ *   Record that the cluster with the given index in the file's cluster
+ *   chain is 'cluster'.  This is only recorded if it immediately follows
+ *   the last cluster already described by the extent map; other clusters
+ *   are ignored.
+ *
+ ****************************************************************************/
+
+void fat_ffextent_add(struct fat_file_s *ff, uint32_t index, uint32_t cluster)
+{
+  FAR struct fat_extent_s *fe;
+
+  if (ff->ff_nextents == 0)
+    {
+      /* The map always begins with the first cluster of the file */
+
+      if (index == 0)
+        {
+          fe             = &ff->ff_extents[0];
+          fe->fe_index   = 0;
+          fe->fe_cluster = cluster;
+          fe->fe_count   = 1;
+          ff->ff_nextents = 1;
+        }
+
+      return;
+    }
+
+  fe = &ff->ff_extents[ff->ff_nextents - 1];
+  if (index != fe->fe_index + fe->fe_count)
+    {
+      /* Already known or not adjacent to the known part of the chain */
+
+      return;
+    }
+
+  if (cluster == fe->fe_cluster + fe->fe_count)
+    {
+      /* Contiguous with the last extent.. just extend it */
+
+      fe->fe_count++;
+    }
+  else if (ff->ff_nextents < CONFIG_FAT_EXTENTCACHE_NEXTENTS)
+    {
+      /* Start a new extent */
+
+      fe++;
+      fe->fe_index   = index;
+      fe->fe_cluster = cluster;
+      fe->fe_count   = 1;
+      ff->ff_nextents++;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_ffextent_find
+ *
+ * Description:
+ *   Find the cluster for the given index in the file's cluster chain.  If
+ *   that cluster is not described by the extent map, then the last known
+ *   cluster before it is returned instead.  On return, *index holds the
+ *   index of the returned cluster.  Zero is returned if the extent map is
+ *   empty.
+ *
+ ****************************************************************************/
+
+uint32_t fat_ffextent_find(struct fat_file_s *ff, uint32_t *index)
+{
+  FAR struct fat_extent_s *fe;
+  int i;
+
+  if (ff->ff_nextents == 0)
+    {
+      return 0;
+    }
+
+  /* Search backward for the extent that contains the index */
+
+  for (i = ff->ff_nextents - 1; i > 0; i--)
+    {
+      if (ff->ff_extents[i].fe_index <= *index)
+        {
+          break;
+        }
+    }
+
+  fe = &ff->ff_extents[i];
+  if (*index >= fe->fe_index + fe->fe_count)
+    {
+      /* Beyond the known part of the chain.  Return the last known
+       * cluster.
+       */
+
+      *index = fe->fe_index + fe->fe_count - 1;
+    }
+
+  return fe->fe_cluster + (*index - fe->fe_index);
+}
+#endif
+
 /****************************************************************************
  * Name: fat_updatefsinfo
  *
@@ -1703,6 +1932,16 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
   /* Flush the fs_buffer if it is dirty */
 
   ret = fat_fscacheflush(fs);
+
+#ifdef CONFIG_FAT_SECTCACHE
+  /* Then flush all dirty sectors in the sector cache */
+
+  if (ret == OK)
+    {
+      ret = fat_cache_flush(fs);
+    }
+#endif
+
   if (ret == OK)
     {
       /* The FSINFO sector only has to be update for the case of a FAT32 file
@@ -1885,3 +2124,107 @@ int fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff,
 
   return -ENOSPC;
 }
+
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Return the number of sectors, up to nsectors, that are physically
+ *   contiguous on the media beginning with the current sector of the file.
+ *   The cluster chain is followed beyond the current cluster for as long as
+ *   the next cluster immediately follows the previous one.  If 'extend' is
+ *   true, then the chain is extended as necessary (this is only used for
+ *   write access).  'position' is the current file position.
+ *
+ *   The file state is not modified:  After the transfer succeeds, the
+ *   caller should use fat_ffadvance() to move past the transferred sectors.
+ *
+ ****************************************************************************/
+
+unsigned int fat_contiguous(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                            unsigned int nsectors, off_t position,
+                            bool extend)
+{
+  unsigned int ncontig;
+  int32_t cluster;
+  int32_t next;
+#ifdef CONFIG_FAT_EXTENTCACHE
+  uint32_t index;
+#endif
+
+  ncontig = ff->ff_sectorsincluster;
+  if (nsectors <= ncontig)
+    {
+      return nsectors;
+    }
+
+  cluster = ff->ff_currentcluster;
+#ifdef CONFIG_FAT_EXTENTCACHE
+  index   = position / (fs->fs_fatsecperclus * fs->fs_hwsectorsize);
+#endif
+
+  while (ncontig < nsectors)
+    {
+      /* Get the next cluster in the chain.  Any failure here is left to be
+       * reported when the cluster is really needed.
+       */
+
+      if (extend)
+        {
+          next = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          next = fat_getcluster(fs, cluster);
+        }
+
+      if (next != cluster + 1 || next >= fs->fs_nclusters)
+        {
+          break;
+        }
+
+#ifdef CONFIG_FAT_EXTENTCACHE
+      fat_ffextent_add(ff, ++index, next);
+#endif
+
+      cluster  = next;
+      ncontig += fs->fs_fatsecperclus;
+    }
+
+  return ncontig < nsectors ? ncontig : nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_ffadvance
+ *
+ * Description:
+ *   Advance the current cluster and sector of the file past nsectors that
+ *   were transferred directly.  The sectors must have been obtained from
+ *   fat_contiguous().
+ *
+ ****************************************************************************/
+
+void fat_ffadvance(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                   unsigned int nsectors)
+{
+  unsigned int remainder;
+
+  if (nsectors <= ff->ff_sectorsincluster)
+    {
+      ff->ff_sectorsincluster -= nsectors;
+    }
+  else
+    {
+      /* The transfer continued into the following (contiguous) clusters.
+       * Find the last cluster that was touched and how much of it is left.
+       */
+
+      remainder                = nsectors - ff->ff_sectorsincluster;
+      ff->ff_currentcluster   += (remainder + fs->fs_fatsecperclus - 1) /
+                                 fs->fs_fatsecperclus;
+      ff->ff_sectorsincluster  = fs->fs_fatsecperclus -
+                                 ((remainder - 1) % fs->fs_fatsecperclus + 1);
+    }
+
+  ff->ff_currentsector += nsectors;
+}
@@ -52,6 +52,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
@@ -61,6 +62,36 @@
 
 #include "hostfs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_HOSTFS_DIRCACHE
+#  define CONFIG_FS_HOSTFS_DIRCACHE 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE_TTL
+#  define CONFIG_FS_HOSTFS_ATTRCACHE_TTL 1000
+#endif
+
+#define HOSTFS_ATTR_TTL   MSEC2TICK(CONFIG_FS_HOSTFS_ATTRCACHE_TTL)
+
+/* Buffered files are either read-only (read-ahead) or write-only
+ * (write-behind).
+ */
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+#  define HOSTFS_RDBUF(hf) ((hf)->buffer != NULL && ((hf)->oflags & O_WROK) == 0)
+#  define HOSTFS_WRBUF(hf) ((hf)->buffer != NULL && ((hf)->oflags & O_WROK) != 0)
+#else
+#  define HOSTFS_RDBUF(hf) (false)
+#  define HOSTFS_WRBUF(hf) (false)
+#endif
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE == 0
+#  define hostfs_attrflush(fs)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -247,6 +278,286 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+/****************************************************************************
+ * Name: hostfs_hash
+ *
+ * Description: Hash a host path name (FNV-1a).
+ *
+ ****************************************************************************/
+
+static uint32_t hostfs_hash(FAR const char *path)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*path != '\0')
+    {
+      hash ^= (uint8_t)*path++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: hostfs_attrfind
+ *
+ * Description: Find unexpired cached attributes of the host file 'path'.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_attr_s *
+hostfs_attrfind(FAR struct hostfs_mountpt_s *fs, FAR const char *path,
+                uint32_t hash)
+{
+  FAR struct hostfs_attr_s *attr;
+  clock_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      attr = &fs->fs_attr[i];
+      if (attr->hash == hash && attr->path[0] != '\0' &&
+          (clock_t)(now - attr->time) < HOSTFS_ATTR_TTL &&
+          strcmp(attr->path, path) == 0)
+        {
+          return attr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_attradd
+ *
+ * Description: Remember the attributes of the host file 'path'.
+ *
+ ****************************************************************************/
+
+static void hostfs_attradd(FAR struct hostfs_mountpt_s *fs,
+                           FAR const char *path, uint32_t hash,
+                           FAR const struct stat *buf)
+{
+  FAR struct hostfs_attr_s *attr;
+
+  attr = &fs->fs_attr[fs->fs_attrnext];
+  if (++fs->fs_attrnext >= CONFIG_FS_HOSTFS_ATTRCACHE)
+    {
+      fs->fs_attrnext = 0;
+    }
+
+  attr->hash = hash;
+  attr->time = clock_systimer();
+  memcpy(&attr->buf, buf, sizeof(struct stat));
+  strncpy(attr->path, path, HOSTFS_MAX_PATH);
+}
+
+/****************************************************************************
+ * Name: hostfs_attrflush
+ *
+ * Description: Forget all cached attributes after a modification.
+ *
+ ****************************************************************************/
+
+static void hostfs_attrflush(FAR struct hostfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      fs->fs_attr[i].path[0] = '\0';
+    }
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+/****************************************************************************
+ * Name: hostfs_flushbuf
+ *
+ * Description: Write the content of the write-behind buffer to the host.
+ *
+ ****************************************************************************/
+
+static int hostfs_flushbuf(FAR struct hostfs_ofile_s *hf)
+{
+  ssize_t nwritten;
+  size_t offset = 0;
+
+  while (offset < hf->buflen)
+    {
+      nwritten = host_write(hf->fd, &hf->buffer[offset],
+                            hf->buflen - offset);
+      if (nwritten <= 0)
+        {
+          /* Discard the data rather than failing every later write */
+
+          hf->buflen = 0;
+          return -EIO;
+        }
+
+      offset += nwritten;
+    }
+
+  hf->buflen = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_syncpos
+ *
+ * Description: Discard the read-ahead data and move the host file position
+ *   to the file position seen by NuttX.
+ *
+ ****************************************************************************/
+
+static int hostfs_syncpos(FAR struct hostfs_ofile_s *hf)
+{
+  off_t ret;
+
+  hf->buflen = 0;
+  if (hf->hostpos != hf->pos)
+    {
+      ret = host_lseek(hf->fd, hf->pos, SEEK_SET);
+      if (ret < 0)
+        {
+          return (int)ret;
+        }
+
+      hf->hostpos = hf->pos;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufread
+ *
+ * Description: Read from a read-only file through the read-ahead buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_bufread(FAR struct hostfs_ofile_s *hf,
+                              FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+  size_t offset;
+  size_t ncopy;
+
+  while (buflen > 0)
+    {
+      /* Copy whatever the buffer holds at the current position */
+
+      if (hf->pos >= hf->bufpos &&
+          hf->pos < hf->bufpos + (off_t)hf->buflen)
+        {
+          offset  = hf->pos - hf->bufpos;
+          ncopy   = MIN(hf->buflen - offset, buflen);
+          memcpy(buffer, &hf->buffer[offset], ncopy);
+
+          buffer  += ncopy;
+          buflen  -= ncopy;
+          hf->pos += ncopy;
+          nread   += ncopy;
+          continue;
+        }
+
+      ret = hostfs_syncpos(hf);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Large reads go directly to the caller's buffer */
+
+      if (buflen >= CONFIG_FS_HOSTFS_BUFSIZE)
+        {
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              hf->pos     += ret;
+              hf->hostpos += ret;
+              nread       += ret;
+            }
+
+          break;
+        }
+
+      /* Otherwise, read ahead into the buffer */
+
+      ret = host_read(hf->fd, hf->buffer, CONFIG_FS_HOSTFS_BUFSIZE);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->bufpos   = hf->pos;
+      hf->buflen   = ret;
+      hf->hostpos += ret;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufwrite
+ *
+ * Description: Write to a write-only file through the write-behind buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_bufwrite(FAR struct hostfs_ofile_s *hf,
+                               FAR const char *buffer, size_t buflen)
+{
+  int ret;
+
+  if (hf->buflen + buflen > CONFIG_FS_HOSTFS_BUFSIZE)
+    {
+      ret = hostfs_flushbuf(hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Large writes go directly to the host */
+
+  if (buflen >= CONFIG_FS_HOSTFS_BUFSIZE)
+    {
+      return host_write(hf->fd, buffer, buflen);
+    }
+
+  memcpy(&hf->buffer[hf->buflen], buffer, buflen);
+  hf->buflen += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufsync
+ *
+ * Description: Make the host file consistent with the buffered state before
+ *   an operation that goes directly to the host file.
+ *
+ ****************************************************************************/
+
+static int hostfs_bufsync(FAR struct hostfs_ofile_s *hf)
+{
+  if (HOSTFS_WRBUF(hf))
+    {
+      return hostfs_flushbuf(hf);
+    }
+  else if (HOSTFS_RDBUF(hf))
+    {
+      return hostfs_syncpos(hf);
+    }
+
+  return OK;
+}
+#else
+#  define hostfs_bufsync(hf) (OK)
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -302,6 +613,30 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* Buffer files that are opened only for reading or only for writing.
+   * The file is simply unbuffered if there is no memory for the buffer.
+   */
+
+  hf->buffer  = NULL;
+  hf->bufpos  = 0;
+  hf->hostpos = 0;
+  hf->pos     = 0;
+  hf->buflen  = 0;
+
+  if ((oflags & O_RDWR) != O_RDWR)
+    {
+      hf->buffer = (FAR char *)kmm_malloc(CONFIG_FS_HOSTFS_BUFSIZE);
+    }
+#endif
+
+  /* The open may have created or truncated the file */
+
+  if ((oflags & (O_WROK | O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_attrflush(fs);
+    }
+
   /* Attach the private date to the struct file instance */
 
   filep->f_priv = hf;
@@ -401,13 +736,26 @@ static int hostfs_close(FAR struct file *filep)
         }
     }
 
-  /* Close the host file */
+  /* Write out any buffered data and close the host file */
 
+  (void)hostfs_bufsync(hf);
   host_close(hf->fd);
 
+  if ((hf->oflags & O_WROK) != 0)
+    {
+      hostfs_attrflush(fs);
+    }
+
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      kmm_free(hf->buffer);
+    }
+#endif
+
   kmm_free(hf);
 
 okout:
@@ -445,7 +793,16 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
-  ret = host_read(hf->fd, buffer, buflen);
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (HOSTFS_RDBUF(hf))
+    {
+      ret = hostfs_bufread(hf, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = host_read(hf->fd, buffer, buflen);
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -503,7 +860,18 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
-  ret = host_write(hf->fd, buffer, buflen);
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (HOSTFS_WRBUF(hf))
+    {
+      ret = hostfs_bufwrite(hf, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = host_write(hf->fd, buffer, buflen);
+    }
+
+  hostfs_attrflush(fs);
 
 errout_with_semaphore:
   hostfs_semgive(fs);
@@ -539,7 +907,45 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
-  ret = host_lseek(hf->fd, offset, whence);
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (HOSTFS_RDBUF(hf) && whence != SEEK_END)
+    {
+      /* Just move the file position.  The host file is positioned when
+       * data outside of the read-ahead buffer is needed.
+       */
+
+      if (whence == SEEK_CUR)
+        {
+          offset += hf->pos;
+        }
+
+      if (offset < 0)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          hf->pos = offset;
+          ret     = offset;
+        }
+    }
+  else
+#endif
+    {
+      ret = hostfs_bufsync(hf);
+      if (ret >= 0)
+        {
+          ret = host_lseek(hf->fd, offset, whence);
+        }
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+      if (ret >= 0 && HOSTFS_RDBUF(hf))
+        {
+          hf->pos     = ret;
+          hf->hostpos = ret;
+        }
+#endif
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -574,7 +980,11 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
-  ret = host_ioctl(hf->fd, cmd, arg);
+  ret = hostfs_bufsync(hf);
+  if (ret >= 0)
+    {
+      ret = host_ioctl(hf->fd, cmd, arg);
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -610,6 +1020,7 @@ static int hostfs_sync(FAR struct file *filep)
 
   hostfs_semtake(fs);
 
+  (void)hostfs_bufsync(hf);
   host_sync(hf->fd);
 
   hostfs_semgive(fs);
@@ -680,9 +1091,21 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   hostfs_semtake(fs);
 
-  /* Call the host to perform the read */
+  /* Call the host to perform the fstat.  Buffered data must be written
+   * first so that the size of the file is right.
+   */
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (HOSTFS_WRBUF(hf))
+    {
+      ret = hostfs_flushbuf(hf);
+    }
 
-  ret = host_fstat(hf->fd, buf);
+  if (ret >= 0)
+#endif
+    {
+      ret = host_fstat(hf->fd, buf);
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -727,6 +1150,17 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
+#if CONFIG_FS_HOSTFS_DIRCACHE > 0
+  /* Allocate the buffer for the directory entries read from the host.
+   * Entries are read one at a time if there is no memory for it.
+   */
+
+  dir->u.hostfs.fs_cache = (FAR struct dirent *)
+    kmm_malloc(CONFIG_FS_HOSTFS_DIRCACHE * sizeof(struct dirent));
+  dir->u.hostfs.fs_index = 0;
+  dir->u.hostfs.fs_count = 0;
+#endif
+
   ret = OK;
 
 errout_with_semaphore:
@@ -763,6 +1197,14 @@ static int hostfs_closedir(FAR struct inode *mountpt,
 
   host_closedir(dir->u.hostfs.fs_dir);
 
+#if CONFIG_FS_HOSTFS_DIRCACHE > 0
+  if (dir->u.hostfs.fs_cache != NULL)
+    {
+      kmm_free(dir->u.hostfs.fs_cache);
+      dir->u.hostfs.fs_cache = NULL;
+    }
+#endif
+
   hostfs_semgive(fs);
   return OK;
 }
@@ -792,9 +1234,40 @@ static int hostfs_readdir(FAR struct inode *mountpt,
 
   hostfs_semtake(fs);
 
-  /* Call the host OS's readdir function */
+#if CONFIG_FS_HOSTFS_DIRCACHE > 0
+  if (dir->u.hostfs.fs_cache != NULL)
+    {
+      FAR struct fs_hostfsdir_s *hdir = &dir->u.hostfs;
+
+      /* Fetch the next batch of entries from the host when all of the
+       * cached entries have been returned.
+       */
+
+      if (hdir->fs_index >= hdir->fs_count)
+        {
+          hdir->fs_index = 0;
+          hdir->fs_count = host_readdirs(hdir->fs_dir, hdir->fs_cache,
+                                         CONFIG_FS_HOSTFS_DIRCACHE);
+        }
+
+      if (hdir->fs_index < hdir->fs_count)
+        {
+          memcpy(&dir->fd_dir, &hdir->fs_cache[hdir->fs_index++],
+                 sizeof(struct dirent));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+  else
+#endif
+    {
+      /* Call the host OS's readdir function */
 
-  ret = host_readdir(dir->u.hostfs.fs_dir, &dir->fd_dir);
+      ret = host_readdir(dir->u.hostfs.fs_dir, &dir->fd_dir);
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -818,6 +1291,11 @@ static int hostfs_rewinddir(FAR struct inode *mountpt,
 
   host_rewinddir(dir->u.hostfs.fs_dir);
 
+#if CONFIG_FS_HOSTFS_DIRCACHE > 0
+  dir->u.hostfs.fs_index = 0;
+  dir->u.hostfs.fs_count = 0;
+#endif
+
   return OK;
 }
 
@@ -1027,6 +1505,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1063,6 +1542,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1100,6 +1580,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1140,6 +1621,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1156,6 +1638,10 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                        FAR struct stat *buf)
 {
   FAR struct hostfs_mountpt_s *fs;
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  FAR struct hostfs_attr_s *attr;
+  uint32_t hash;
+#endif
   char path[HOSTFS_MAX_PATH];
   int ret;
 
@@ -1175,7 +1661,25 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  hash = hostfs_hash(path);
+  attr = hostfs_attrfind(fs, path, hash);
+  if (attr != NULL)
+    {
+      memcpy(buf, &attr->buf, sizeof(struct stat));
+      ret = OK;
+    }
+  else
+    {
+      ret = host_stat(path, buf);
+      if (ret == 0)
+        {
+          hostfs_attradd(fs, path, hash, buf);
+        }
+    }
+#else
   ret = host_stat(path, buf);
+#endif
 
   hostfs_semgive(fs);
   return ret;
@@ -46,6 +46,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#include <time.h>
+#include <sys/stat.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -63,6 +65,14 @@
 
 #define HOSTFS_MAX_PATH     256
 
+#ifndef CONFIG_FS_HOSTFS_BUFSIZE
+#  define CONFIG_FS_HOSTFS_BUFSIZE 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE
+#  define CONFIG_FS_HOSTFS_ATTRCACHE 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,8 +87,27 @@ struct hostfs_ofile_s
   int16_t                   crefs;      /* Reference count */
   mode_t                    oflags;     /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  FAR char                 *buffer;     /* Read-ahead/write-behind buffer */
+  off_t                     bufpos;     /* File position of buffer[0] */
+  off_t                     hostpos;    /* File position of the host fd */
+  off_t                     pos;        /* Current file position */
+  size_t                    buflen;     /* Valid bytes in buffer */
+#endif
 };
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+/* This structure holds one cached stat() result */
+
+struct hostfs_attr_s
+{
+  uint32_t                  hash;       /* Hash of the host path */
+  clock_t                   time;       /* When the attributes were read */
+  struct stat               buf;        /* The attributes */
+  char                      path[HOSTFS_MAX_PATH];
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a hostfs filesystem.
@@ -89,6 +118,10 @@ struct hostfs_mountpt_s
   sem_t                      *fs_sem;       /* Used to assure thread-safe access */
   FAR struct hostfs_ofile_s  *fs_head;      /* A singly-linked list of open files */
   char                        fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  uint16_t                    fs_attrnext;  /* Next attribute entry to replace */
+  struct hostfs_attr_s        fs_attr[CONFIG_FS_HOSTFS_ATTRCACHE];
+#endif
 };
 
 /****************************************************************************
@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <strings.h>
 #include <string.h>
 #include <semaphore.h>
 #include <assert.h>
@@ -79,6 +81,44 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) sem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Return the file structure for 'fd', allocating the row of the file
+ *   list that holds it if necessary.
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore and 'fd' is in range.
+ *
+ ****************************************************************************/
+
+static FAR struct file *_files_extend(FAR struct filelist *list, int fd)
+{
+  FAR struct file *row;
+  int rowndx = fd / FILELIST_ROWSIZE;
+
+  row = list->fl_rows[rowndx];
+  if (row == NULL)
+    {
+      row = (FAR struct file *)
+        kmm_zalloc(FILELIST_ROWSIZE * sizeof(struct file));
+
+      if (row == NULL)
+        {
+          return NULL;
+        }
+
+      /* The row is visible to files_fget() only once it has been
+       * initialized.
+       */
+
+      list->fl_rows[rowndx] = row;
+    }
+
+  return &row[fd % FILELIST_ROWSIZE];
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -152,6 +192,10 @@ void files_initlist(FAR struct filelist *list)
   /* Initialize the list access mutex */
 
   (void)sem_init(&list->fl_sem, 0, 1);
+
+  /* The first row of the table is always present */
+
+  list->fl_rows[0] = list->fl_row0;
 }
 
 /****************************************************************************
@@ -164,7 +208,9 @@ void files_initlist(FAR struct filelist *list)
 
 void files_releaselist(FAR struct filelist *list)
 {
+  FAR struct file *row;
   int i;
+  int j;
 
   DEBUGASSERT(list);
 
@@ -173,11 +219,31 @@ void files_releaselist(FAR struct filelist *list)
    * there should not be any references in this context.
    */
 
-  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (i = 0; i < FILELIST_NROWS; i++)
     {
-      (void)_files_close(&list->fl_files[i]);
+      row = list->fl_rows[i];
+      if (row == NULL)
+        {
+          continue;
+        }
+
+      for (j = 0; j < FILELIST_ROWSIZE; j++)
+        {
+          (void)_files_close(&row[j]);
+        }
+
+      /* Free the rows that were allocated as the list grew */
+
+      if (row != list->fl_row0)
+        {
+          sched_kfree(row);
+        }
+
+      list->fl_rows[i] = NULL;
     }
 
+  memset(list->fl_inuse, 0, sizeof(list->fl_inuse));
+
   /* Destroy the semaphore */
 
   (void)sem_destroy(&list->fl_sem);
@@ -197,6 +263,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
   FAR struct filelist *list;
   FAR struct inode *inode;
   int errcode;
+  int fd = -1;
   int ret;
 
   if (!filep1 || !filep1->f_inode || !filep2)
@@ -217,6 +284,13 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
   if (list != NULL)
     {
       _files_semtake(list);
+
+      /* filep2 may also be a detached file structure or belong to the
+       * file list of another task group.  Then there is no descriptor of
+       * this list to be accounted for.
+       */
+
+      fd = files_getfd(list, filep2);
     }
 
   /* If there is already an inode contained in the new file structure,
@@ -224,6 +298,11 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
    */
 
   ret = _files_close(filep2);
+  if (fd >= 0)
+    {
+      FILES_CLRINUSE(list, fd);
+    }
+
   if (ret < 0)
     {
       /* An error occurred while closing the driver */
@@ -271,6 +350,11 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
         }
     }
 
+  if (fd >= 0)
+    {
+      FILES_SETINUSE(list, fd);
+    }
+
   if (list != NULL)
     {
       _files_semgive(list);
@@ -311,24 +395,60 @@ errout:
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
-  int i;
+  FAR struct file *filep;
+  uint32_t avail;
+  int fd;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
 
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  if (minfd < 0)
+    {
+      minfd = 0;
+    }
+
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (fd = minfd; fd < CONFIG_NFILE_DESCRIPTORS; fd++)
     {
-      if (!list->fl_files[i].f_inode)
+      /* Skip over words of the bitmap in which every descriptor at or
+       * above 'fd' is in use.
+       */
+
+      avail = ~list->fl_inuse[fd >> 5] & (UINT32_MAX << (fd & 31));
+      if (avail == 0)
+        {
+          fd |= 31;
+          continue;
+        }
+
+      fd = (fd & ~31) + ffs((int)avail) - 1;
+      if (fd >= CONFIG_NFILE_DESCRIPTORS)
         {
-           list->fl_files[i].f_oflags = oflags;
-           list->fl_files[i].f_pos    = pos;
-           list->fl_files[i].f_inode  = inode;
-           list->fl_files[i].f_priv   = NULL;
-           _files_semgive(list);
-           return i;
+          break;
+        }
+
+      filep = _files_extend(list, fd);
+      if (filep == NULL)
+        {
+          break;
+        }
+
+      /* A descriptor may be occupied without its bit being set when
+       * file_dup2() filled it in on behalf of another task group (as when
+       * a new task inherits its parent's files).  Just account for it.
+       */
+
+      FILES_SETINUSE(list, fd);
+      if (filep->f_inode == NULL)
+        {
+          filep->f_oflags = oflags;
+          filep->f_pos    = pos;
+          filep->f_inode  = inode;
+          filep->f_priv   = NULL;
+          _files_semgive(list);
+          return fd;
         }
     }
 
@@ -336,6 +456,65 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that the row of the file list holding the file descriptor
+ *   'fd' has been allocated and return the file structure for 'fd'.
+ *   Returns NULL if 'fd' is out of range or if the row could not be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_extend(FAR struct filelist *list, int fd)
+{
+  FAR struct file *filep;
+
+  DEBUGASSERT(list != NULL);
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  filep = files_fget(list, fd);
+  if (filep == NULL)
+    {
+      _files_semtake(list);
+      filep = _files_extend(list, fd);
+      _files_semgive(list);
+    }
+
+  return filep;
+}
+
+/****************************************************************************
+ * Name: files_getfd
+ *
+ * Description:
+ *   Return the file descriptor of the file structure 'filep' in 'list' or
+ *   a negated errno value if 'filep' is not a member of 'list'.
+ *
+ ****************************************************************************/
+
+int files_getfd(FAR struct filelist *list, FAR struct file *filep)
+{
+  FAR struct file *row;
+  int i;
+
+  for (i = 0; i < FILELIST_NROWS; i++)
+    {
+      row = list->fl_rows[i];
+      if (row != NULL && filep >= row && filep < row + FILELIST_ROWSIZE)
+        {
+          return i * FILELIST_ROWSIZE + (int)(filep - row);
+        }
+    }
+
+  return -EBADF;
+}
+
 /****************************************************************************
  * Name: files_close
  *
@@ -350,6 +529,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -361,7 +541,13 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS || !list->fl_files[fd].f_inode)
+  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  filep = files_fget(list, fd);
+  if (filep == NULL || filep->f_inode == NULL)
     {
       return -EBADF;
     }
@@ -369,7 +555,8 @@ int files_close(int fd)
   /* Perform the protected close operation */
 
   _files_semtake(list);
-  ret = _files_close(&list->fl_files[fd]);
+  ret = _files_close(filep);
+  FILES_CLRINUSE(list, fd);
   _files_semgive(list);
   return ret;
 }
@@ -386,16 +573,19 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
 
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS &&
+      (filep = files_fget(list, fd)) != NULL)
     {
       _files_semtake(list);
-      list->fl_files[fd].f_oflags  = 0;
-      list->fl_files[fd].f_pos     = 0;
-      list->fl_files[fd].f_inode = NULL;
+      filep->f_oflags  = 0;
+      filep->f_pos     = 0;
+      filep->f_inode = NULL;
+      FILES_CLRINUSE(list, fd);
       _files_semgive(list);
     }
 }
@@ -0,0 +1,220 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds one cached path resolution.  Only successful
+ * searches that did not pass through a soft link are cached.  For those,
+ * the residual path and the relative path are the same position in the
+ * search path.
+ */
+
+struct inode_cache_s
+{
+  uint32_t          hash;    /* Hash of the path; zero if unused */
+  FAR struct inode *node;    /* The inode found */
+  FAR struct inode *peer;    /* Node to the "left" of the inode found */
+  FAR struct inode *parent;  /* Node "above" the inode found */
+  uint16_t          reloff;  /* Offset of relpath in the search path */
+  char path[CONFIG_FS_INODE_CACHE_PATHLEN]; /* The search path */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_NENTRIES];
+static uint8_t g_inode_cachenext;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of a path and its length.  Zero is
+ *   reserved to mark unused cache entries.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  for (ptr = path; *ptr != '\0'; ptr++)
+    {
+      hash ^= (uint8_t)*ptr;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up a previous resolution of the search path.  On a hit, the
+ *   search descriptor is completed as inode_search() would complete it.
+ *
+ * Returned Value:
+ *   true if the path was found in the cache.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  uint32_t hash;
+  size_t len;
+  int i;
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  for (i = 0; i < CONFIG_FS_INODE_CACHE_NENTRIES; i++)
+    {
+      entry = &g_inode_cache[i];
+      if (entry->hash == hash && strcmp(entry->path, path) == 0)
+        {
+          desc->path    = &path[entry->reloff];
+          desc->node    = entry->node;
+          desc->peer    = entry->peer;
+          desc->parent  = entry->parent;
+          desc->relpath = &path[entry->reloff];
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result of a successful inode_search() of 'path'.  The least
+ *   recently added entry is replaced.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path, FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  uint32_t hash;
+  size_t len;
+
+  DEBUGASSERT(desc->node != NULL && desc->relpath != NULL);
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN)
+    {
+      return;
+    }
+
+  entry = &g_inode_cache[g_inode_cachenext];
+  if (++g_inode_cachenext >= CONFIG_FS_INODE_CACHE_NENTRIES)
+    {
+      g_inode_cachenext = 0;
+    }
+
+  entry->hash   = hash;
+  entry->node   = desc->node;
+  entry->peer   = desc->peer;
+  entry->parent = desc->parent;
+  entry->reloff = (uint16_t)(desc->relpath - path);
+  memcpy(entry->path, path, len + 1);
+}
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Discard all cached path resolutions.  This must be called whenever an
+ *   inode is inserted into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_INODE_CACHE_NENTRIES; i++)
+    {
+      g_inode_cache[i].hash = 0;
+    }
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -91,6 +91,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      /* Cached path resolutions may refer to the node being unlinked */
+
+      inode_cache_flush();
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -104,6 +104,10 @@ static void inode_insert(FAR struct inode *node,
                          FAR struct inode *peer,
                          FAR struct inode *parent)
 {
+  /* Cached path resolutions may refer to the old peer and parent links */
+
+  inode_cache_flush();
+
   /* If peer is non-null, then new node simply goes to the right
    * of that peer node.
    */
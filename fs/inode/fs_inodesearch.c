@@ -459,6 +459,9 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODE_CACHE
+  FAR const char *path;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -471,8 +474,31 @@ int inode_search(FAR struct inode_search_s *desc)
   desc->linktgt = NULL;
 #endif
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Check if the same path was resolved recently */
+
+  path = desc->path;
+  if (inode_cache_lookup(desc))
+    {
+      return OK;
+    }
+#endif
+
   ret = _inode_search(desc);
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Remember the result unless it depends on a soft link */
+
+  if (ret >= 0
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+      && desc->linktgt == NULL && !INODE_IS_SOFTLINK(desc->node)
+#endif
+     )
+    {
+      inode_cache_add(path, desc);
+    }
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
     {
@@ -47,6 +47,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <dirent.h>
+#include <poll.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
@@ -95,6 +96,13 @@
 
 #endif
 
+/* Manage the bitmap of allocated file descriptors in struct filelist */
+
+#define FILES_SETINUSE(list, fd) \
+  ((list)->fl_inuse[(fd) >> 5] |= (uint32_t)1 << ((fd) & 31))
+#define FILES_CLRINUSE(list, fd) \
+  ((list)->fl_inuse[(fd) >> 5] &= ~((uint32_t)1 << ((fd) & 31)))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -226,6 +234,29 @@ void inode_semgive(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_add, and inode_cache_flush
+ *
+ * Description:
+ *   If CONFIG_FS_INODE_CACHE is selected, inode_search() keeps a small
+ *   cache of recent, successful path resolutions.  inode_cache_lookup()
+ *   completes the search descriptor from the cache, inode_cache_add()
+ *   remembers a result, and inode_cache_flush() discards all results.  The
+ *   cache must be flushed whenever the inode tree is modified.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc);
+void inode_cache_add(FAR const char *path, FAR struct inode_search_s *desc);
+void inode_cache_flush(void);
+#else
+#  define inode_cache_flush()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -424,6 +455,27 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: anonfd_allocate, anonfd_lastref, anonfd_poll, anonfd_pollnotify
+ *
+ * Description:
+ *   Support for files that refer to unnamed inodes (eventfd, timerfd and
+ *   signalfd).  See fs/vfs/fs_anonfd.c.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ANONFD
+int anonfd_allocate(FAR struct inode *inode,
+                    FAR const struct file_operations *ops,
+                    FAR void *priv, int oflags);
+bool anonfd_lastref(FAR struct file *filep);
+#ifndef CONFIG_DISABLE_POLL
+int anonfd_poll(FAR struct pollfd **slots, FAR struct pollfd *fds,
+                bool setup, pollevent_t eventset);
+void anonfd_pollnotify(FAR struct pollfd **slots, pollevent_t eventset);
+#endif
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   Write the modified in-memory image of a writable, shared mapping back
+ *   to the mapped file.  This is only meaningful for the RAM copies of
+ *   files created by rammap():  Mappings that refer directly to the media
+ *   (FIOC_MMAP) need no synchronization.
+ *
+ * Parameters:
+ *   addr   The start of the range to synchronize.  This must lie within a
+ *          region returned by mmap().
+ *   len    The length of the range.  The range is clipped to the end of the
+ *          region.
+ *   flags  MS_ASYNC, MS_SYNC, or MS_INVALIDATE.  Write-back is always
+ *          performed before msync() returns.  With MS_SYNC, the file is
+ *          also flushed to the media with fsync().
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set
+ *   appropriately:
+ *
+ *     EINVAL
+ *       'flags' contains both MS_ASYNC and MS_SYNC.
+ *     ENOMEM
+ *       The address range is not mapped.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t len, int flags)
+{
+  FAR struct fs_rammap_s *curr;
+  uintptr_t start;
+  uintptr_t end;
+  size_t offset;
+  int errcode;
+  int ret;
+
+  if ((flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  rammap_initialize();
+  ret = sem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      return ERROR;
+    }
+
+  /* Find the region that contains the start address */
+
+  for (curr = g_rammaps.head; curr; curr = curr->flink)
+    {
+      start = (uintptr_t)curr->addr;
+      end   = start + curr->length;
+
+      if ((uintptr_t)addr >= start && (uintptr_t)addr < end)
+        {
+          break;
+        }
+    }
+
+  if (!curr)
+    {
+      ferr("ERROR: Region not found\n");
+      errcode = ENOMEM;
+      goto errout_with_semaphore;
+    }
+
+  /* Write back the requested part of the region */
+
+  offset = (uintptr_t)addr - start;
+  if (len > curr->length - offset)
+    {
+      len = curr->length - offset;
+    }
+
+  ret = rammap_writeback(curr, offset, len);
+  if (ret >= 0 && (flags & MS_SYNC) != 0 && curr->file.f_inode != NULL)
+    {
+      ret = file_fsync(&curr->file);
+      if (ret < 0)
+        {
+          ret = -get_errno();
+        }
+    }
+
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_semaphore;
+    }
+
+  sem_post(&g_rammaps.exclsem);
+  return OK;
+
+errout_with_semaphore:
+  sem_post(&g_rammaps.exclsem);
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_RAMMAP_WRITEBACK */
@@ -169,6 +169,17 @@ int munmap(FAR void *start, size_t length)
 
   length = curr->length - offset;
 
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  /* Write back the part of a writable mapping that is being removed */
+
+  ret = rammap_writeback(curr, offset, length);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Are we unmapping the entire region (offset == 0)? */
 
   if (length >= curr->length)
@@ -186,18 +197,29 @@ int munmap(FAR void *start, size_t length)
 
       /* Then free the region */
 
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+      (void)file_close_detached(&curr->file);
+#endif
       kumm_free(curr);
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  Keep the first 'offset' bytes of the region.
    */
 
   else
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      curr->length = length;
+      newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+      DEBUGASSERT(newaddr == (FAR void *)curr);
+      UNUSED(newaddr);
+
+      curr->length = offset;
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+      if (curr->filelen > offset)
+        {
+          curr->filelen = offset;
+        }
+#endif
     }
 
   sem_post(&g_rammaps.exclsem);
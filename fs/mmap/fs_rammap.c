@@ -44,10 +44,12 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
 #include "fs_rammap.h"
@@ -100,11 +102,15 @@ void rammap_initialize(void)
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    See the PROT_* definitions in sys/mman.h.  Only PROT_WRITE is
+ *           used, and only if CONFIG_FS_RAMMAP_WRITEBACK is selected.
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *      PROT_WRITE was requested but 'fd' is not open for writing.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -114,8 +120,11 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, int prot)
 {
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  FAR struct file *filep;
+#endif
   FAR struct fs_rammap_s *map;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
@@ -217,12 +226,46 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
   memset(rdbuffer, 0, length);
 
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  /* A writable mapping keeps its own, task-independent reference to the
+   * file so that it can be written back after 'fd' has been closed.
+   */
+
+  map->filelen = rdbuffer - (FAR uint8_t *)map->addr;
+  if ((prot & PROT_WRITE) != 0)
+    {
+      filep = fs_getfilep(fd);
+      if (filep == NULL)
+        {
+          errcode = EBADF;
+          goto errout_with_region;
+        }
+
+      if ((filep->f_oflags & O_WROK) == 0)
+        {
+          ferr("ERROR: File is not open for writing\n");
+          errcode = EACCES;
+          goto errout_with_region;
+        }
+
+      ret = file_dup2(filep, &map->file);
+      if (ret < 0)
+        {
+          errcode = get_errno();
+          goto errout_with_region;
+        }
+    }
+#endif
+
   /* Add the buffer to the list of regions */
 
   rammap_initialize();
   ret = sem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+      (void)file_close_detached(&map->file);
+#endif
       goto errout_with_errno;
     }
 
@@ -243,4 +286,83 @@ errout_with_errno:
   return MAP_FAILED;
 }
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of the in-memory image of a writable mapping back to the
+ *   file.  The caller must hold g_rammaps.exclsem.
+ *
+ * Parameters:
+ *   map     The mapping
+ *   start   Offset of the first byte to write back, relative to the start
+ *           of the mapping
+ *   length  The number of bytes to write back
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success (including the case where the mapping
+ *   is not writable); a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t start,
+                     size_t length)
+{
+  FAR const uint8_t *wrbuffer;
+  ssize_t nwritten;
+  off_t fpos;
+
+  /* Nothing to do if the mapping is not writable.  Never write beyond the
+   * part of the region that was read from the file.
+   */
+
+  if (map->file.f_inode == NULL || start >= map->filelen)
+    {
+      return OK;
+    }
+
+  if (length > map->filelen - start)
+    {
+      length = map->filelen - start;
+    }
+
+  /* Seek to the file position corresponding to 'start' */
+
+  fpos = file_seek(&map->file, map->offset + start, SEEK_SET);
+  if (fpos == (off_t)-1)
+    {
+      return -get_errno();
+    }
+
+  /* Then write the in-memory image back to the file */
+
+  wrbuffer = (FAR const uint8_t *)map->addr + start;
+  while (length > 0)
+    {
+      nwritten = file_write(&map->file, wrbuffer, length);
+      if (nwritten < 0)
+        {
+          int errcode = get_errno();
+          if (errcode != EINTR)
+            {
+              ferr("ERROR: Write-back failed: %d\n", errcode);
+              return -errcode;
+            }
+
+          continue;
+        }
+      else if (nwritten == 0)
+        {
+          return -ENOSPC;
+        }
+
+      wrbuffer += nwritten;
+      length   -= nwritten;
+    }
+
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_FS_RAMMAP */
@@ -47,6 +47,8 @@
 #include <sys/types.h>
 #include <semaphore.h>
 
+#include <nuttx/fs/fs.h>
+
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
@@ -66,7 +68,9 @@
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
  * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ *   but the file contents will not change.  Unless CONFIG_FS_RAMMAP_WRITEBACK
+ *   is selected:  Then a mapping created with PROT_WRITE is written back
+ *   to the file by msync() and munmap().
  * - There are not access privileges.
  */
 
@@ -76,6 +80,10 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  size_t              filelen;     /* Bytes of the region backed by the file */
+  struct file         file;        /* Detached reference for write-back */
+#endif
 };
 
 /* This structure defines all "mapped" files */
@@ -126,11 +134,15 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    See the PROT_* definitions in sys/mman.h.  Only PROT_WRITE is
+ *           used, and only if CONFIG_FS_RAMMAP_WRITEBACK is selected.
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *      PROT_WRITE was requested but 'fd' is not open for writing.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -140,7 +152,31 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, int prot);
+
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of the in-memory image of a writable mapping back to the
+ *   file.  The caller must hold g_rammaps.exclsem.
+ *
+ * Parameters:
+ *   map     The mapping
+ *   start   Offset of the first byte to write back, relative to the start
+ *           of the mapping
+ *   length  The number of bytes to write back
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success (including the case where the mapping
+ *   is not writable); a negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t start,
+                     size_t length);
+#endif
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
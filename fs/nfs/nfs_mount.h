@@ -49,6 +49,10 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#include <nuttx/clock.h>
 
 #include "rpc.h"
 
@@ -60,6 +64,26 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_NFS_ATTRCACHE
+/* One cached LOOKUP result:  The file handle and attributes of the object
+ * named nc_name in the directory nc_dirfh.  The entry is used until it is
+ * older than CONFIG_NFS_ACREGTIMEO (or CONFIG_NFS_ACDIRTIMEO if the object
+ * is a directory) or until something is modified through this mount.
+ */
+
+struct nfs_cache_s
+{
+  systime_t          nc_time;       /* Time (in ticks) the entry was filled */
+  bool               nc_valid;      /* True: The entry is in use */
+  bool               nc_hasdir;     /* True: nc_dirattr is valid */
+  char               nc_name[NAME_MAX + 1]; /* Object name */
+  struct file_handle nc_dirfh;      /* File handle of the directory */
+  struct file_handle nc_fh;         /* File handle of the object */
+  struct nfs_fattr   nc_attr;       /* Attributes of the object */
+  struct nfs_fattr   nc_dirattr;    /* Attributes of the directory */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -84,6 +108,12 @@ struct nfsmount
   uint16_t         nm_readdirsize;            /* Size of a readdir RPC */
   uint16_t         nm_buflen;                 /* Size of I/O buffer */
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Cache of recent LOOKUP results */
+
+  struct nfs_cache_s nm_cache[CONFIG_NFS_ATTRCACHE_NENTRIES];
+#endif
+
   /* Set aside memory on the stack to hold the largest call message.  NOTE
    * that for the case of the write call message, it is the reply message that
    * is in this union.
@@ -96,6 +126,7 @@ struct nfsmount
     struct rpc_call_create  create;
     struct rpc_call_lookup  lookup;
     struct rpc_call_read    read;
+    struct rpc_call_commit  commit;
     struct rpc_call_remove  removef;
     struct rpc_call_rename  renamef;
     struct rpc_call_mkdir   mkdir;
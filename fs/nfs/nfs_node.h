@@ -58,6 +58,7 @@
 
 #define NFSNODE_OPEN           (1 << 0) /* File is still open */
 #define NFSNODE_MODIFIED       (1 << 1) /* Might have a modified buffer */
+#define NFSNODE_UNSTABLE       (1 << 2) /* Has UNSTABLE writes to COMMIT */
 
 /****************************************************************************
  * Public Types
@@ -79,6 +80,16 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file */
+#ifdef CONFIG_NFS_READAHEAD
+  FAR uint8_t       *n_rabuffer;    /* Readahead buffer (nm_rsize bytes) */
+  off_t              n_raoffset;    /* File offset of the readahead data */
+  uint16_t           n_ralen;       /* Bytes of valid data in n_rabuffer */
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+  FAR uint8_t       *n_wbbuffer;    /* Write-behind buffer (nm_wsize bytes) */
+  off_t              n_wboffset;    /* File offset of the buffered data */
+  uint16_t           n_wblen;       /* Bytes of data held in n_wbbuffer */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
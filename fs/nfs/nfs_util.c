@@ -117,6 +117,121 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_cachefind
+ *
+ * Desciption:
+ *   Find an unexpired LOOKUP result for 'filename' in the directory
+ *   'dirfh'.
+ *
+ * Return Value:
+ *   The matching cache entry or NULL if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static FAR struct nfs_cache_s *
+nfs_cachefind(FAR struct nfsmount *nmp, FAR const char *filename,
+              FAR const struct file_handle *dirfh)
+{
+  FAR struct nfs_cache_s *ncp;
+  systime_t now = clock_systimer();
+  systime_t timeout;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      ncp = &nmp->nm_cache[i];
+      if (!ncp->nc_valid)
+        {
+          continue;
+        }
+
+      /* Discard the entry if it has aged out */
+
+      if (fxdr_unsigned(uint32_t, ncp->nc_attr.fa_type) == NFDIR)
+        {
+          timeout = SEC2TICK(CONFIG_NFS_ACDIRTIMEO);
+        }
+      else
+        {
+          timeout = SEC2TICK(CONFIG_NFS_ACREGTIMEO);
+        }
+
+      if (now - ncp->nc_time >= timeout)
+        {
+          ncp->nc_valid = false;
+          continue;
+        }
+
+      if (ncp->nc_dirfh.length == dirfh->length &&
+          memcmp(&ncp->nc_dirfh.handle, &dirfh->handle, dirfh->length) == 0 &&
+          strcmp(ncp->nc_name, filename) == 0)
+        {
+          return ncp;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_cacheadd
+ *
+ * Desciption:
+ *   Save a LOOKUP result, replacing an unused entry or the oldest entry
+ *   in the cache.
+ *
+ * Return Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static void nfs_cacheadd(FAR struct nfsmount *nmp, FAR const char *filename,
+                         FAR const struct file_handle *dirfh,
+                         FAR const struct file_handle *fhandle,
+                         FAR const struct nfs_fattr *obj_attributes,
+                         FAR const struct nfs_fattr *dir_attributes)
+{
+  FAR struct nfs_cache_s *ncp;
+  systime_t now = clock_systimer();
+  int i;
+
+  ncp = &nmp->nm_cache[0];
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      if (!nmp->nm_cache[i].nc_valid)
+        {
+          ncp = &nmp->nm_cache[i];
+          break;
+        }
+
+      if (now - nmp->nm_cache[i].nc_time > now - ncp->nc_time)
+        {
+          ncp = &nmp->nm_cache[i];
+        }
+    }
+
+  strncpy(ncp->nc_name, filename, NAME_MAX);
+  ncp->nc_name[NAME_MAX] = '\0';
+
+  memcpy(&ncp->nc_dirfh, dirfh, sizeof(struct file_handle));
+  memcpy(&ncp->nc_fh, fhandle, sizeof(struct file_handle));
+  memcpy(&ncp->nc_attr, obj_attributes, sizeof(struct nfs_fattr));
+
+  ncp->nc_hasdir = (dir_attributes != NULL);
+  if (dir_attributes != NULL)
+    {
+      memcpy(&ncp->nc_dirattr, dir_attributes, sizeof(struct nfs_fattr));
+    }
+
+  ncp->nc_time  = now;
+  ncp->nc_valid = true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -246,6 +361,30 @@ tryagain:
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_cachepurge
+ *
+ * Desciption:
+ *   Discard all cached LOOKUP results.  This is called whenever a file or
+ *   directory is modified through this mount.
+ *
+ * Return Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+void nfs_cachepurge(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      nmp->nm_cache[i].nc_valid = false;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_lookup
  *
@@ -266,6 +405,12 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
                FAR struct nfs_fattr *dir_attributes)
 {
   FAR uint32_t *ptr;
+#ifdef CONFIG_NFS_ATTRCACHE
+  FAR struct nfs_cache_s *ncp;
+  FAR struct nfs_fattr *objattr = NULL;
+  FAR struct nfs_fattr *dirattr = NULL;
+  struct file_handle dirfh;
+#endif
   uint32_t value;
   int reqlen;
   int namelen;
@@ -282,6 +427,33 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
       return E2BIG;
     }
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Check if the result of this LOOKUP is still in the cache */
+
+  ncp = nfs_cachefind(nmp, filename, fhandle);
+  if (ncp != NULL && (dir_attributes == NULL || ncp->nc_hasdir))
+    {
+      memcpy(fhandle, &ncp->nc_fh, sizeof(struct file_handle));
+
+      if (obj_attributes)
+        {
+          memcpy(obj_attributes, &ncp->nc_attr, sizeof(struct nfs_fattr));
+        }
+
+      if (dir_attributes)
+        {
+          memcpy(dir_attributes, &ncp->nc_dirattr,
+                 sizeof(struct nfs_fattr));
+        }
+
+      return OK;
+    }
+
+  /* The directory file handle will be overwritten by the result */
+
+  memcpy(&dirfh, fhandle, sizeof(struct file_handle));
+#endif
+
   /* Initialize the request */
 
   ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.lookup.lookup;
@@ -351,6 +523,10 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
         {
           memcpy(obj_attributes, ptr, sizeof(struct nfs_fattr));
         }
+
+#ifdef CONFIG_NFS_ATTRCACHE
+      objattr = (FAR struct nfs_fattr *)ptr;
+#endif
       ptr += uint32_increment(sizeof(struct nfs_fattr));
     }
 
@@ -364,6 +540,20 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
       memcpy(dir_attributes, ptr, sizeof(struct nfs_fattr));
     }
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Cache the result if the server returned the object attributes */
+
+  if (value)
+    {
+      dirattr = (FAR struct nfs_fattr *)ptr;
+    }
+
+  if (objattr != NULL)
+    {
+      nfs_cacheadd(nmp, filename, &dirfh, fhandle, objattr, dirattr);
+    }
+#endif
+
   return OK;
 }
 
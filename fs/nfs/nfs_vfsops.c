@@ -91,6 +91,16 @@
 
 #define USE_GUARDED_CREATE    1
 
+/* With write-behind, data is written UNSTABLE and COMMITted when the file
+ * is synced or closed.  Otherwise, each WRITE goes to stable storage.
+ */
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+#  define NFS_WRITE_STABLE    NFSV3WRITE_UNSTABLE
+#else
+#  define NFS_WRITE_STABLE    NFSV3WRITE_FILESYNC
+#endif
+
 /* include/nuttx/fs/dirent.h has its own version of these lengths.  They must
  * match the NFS versions.
  */
@@ -143,9 +153,22 @@ static int     nfs_fileopen(FAR struct nfsmount *nmp, struct nfsnode *np,
 static int     nfs_open(FAR struct file *filep, const char *relpath,
                    int oflags, mode_t mode);
 static int     nfs_close(FAR struct file *filep);
+static int     nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   off_t offset, FAR uint8_t *buffer, size_t buflen,
+                   FAR size_t *nread, FAR bool *eof);
+static int     nfs_writerpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   off_t offset, FAR const uint8_t *buffer, size_t buflen,
+                   FAR size_t *nwritten, FAR int *committed);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_wbflush(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+static int     nfs_filesync(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_sync(FAR struct file *filep);
+#endif
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_fstat(FAR const struct file *filep, FAR struct stat *buf);
 static int     nfs_opendir(struct inode *mountpt, const char *relpath,
@@ -188,7 +211,11 @@ const struct mountpt_operations nfs_operations =
   NULL,                         /* seek */
   NULL,                         /* ioctl */
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  nfs_sync,                     /* sync */
+#else
   NULL,                         /* sync */
+#endif
   nfs_dup,                      /* dup */
   nfs_fstat,                    /* fstat */
 
@@ -339,6 +366,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, struct nfsnode *np,
 
   do
     {
+      nfs_cachepurge(nmp);
       nfs_statistics(NFSPROC_CREATE);
       error = nfs_request(nmp, NFSPROC_CREATE,
                           (FAR void *)&nmp->nm_msgbuffer.create, reqlen,
@@ -444,6 +472,7 @@ static int nfs_filetruncate(FAR struct nfsmount *nmp, struct nfsnode *np)
 
   /* Perform the SETATTR RPC */
 
+  nfs_cachepurge(nmp);
   nfs_statistics(NFSPROC_SETATTR);
   error = nfs_request(nmp, NFSPROC_SETATTR,
                       (FAR void *)&nmp->nm_msgbuffer.setattr, reqlen,
@@ -697,6 +726,9 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+#ifdef CONFIG_NFS_WRITEBEHIND
+  int error = OK;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -733,6 +765,18 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_WRITEBEHIND
+      /* Send any buffered write data to the server and COMMIT it.  A
+       * failure is reported to the caller, but the file is closed anyway.
+       */
+
+      error = nfs_filesync(nmp, np);
+      if (error != OK)
+        {
+          ferr("ERROR: nfs_filesync failed: %d\n", error);
+        }
+
+#endif
       /* Assume file structure will not be found.  This should never happen. */
 
       ret = -EINVAL;
@@ -762,17 +806,427 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+#ifdef CONFIG_NFS_READAHEAD
+              if (np->n_rabuffer != NULL)
+                {
+                  kmm_free(np->n_rabuffer);
+                }
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+              if (np->n_wbbuffer != NULL)
+                {
+                  kmm_free(np->n_wbbuffer);
+                }
+#endif
+
               kmm_free(np);
               ret = OK;
               break;
             }
         }
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+      if (ret == OK && error != OK)
+        {
+          ret = -error;
+        }
+#endif
     }
 
   filep->f_priv = NULL;
   nfs_semgive(nmp);
   return ret;
 }
+/****************************************************************************
+ * Name: nfs_readrpc
+ *
+ * Description:
+ *   Perform one READ RPC, transferring no more than one RPC's worth of data
+ *   from 'offset' in the file into 'buffer'.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  On success, the number
+ *   of bytes read is returned in 'nread' and the server's end-of-file
+ *   indication is returned in 'eof'.
+ *
+ ****************************************************************************/
+
+static int nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                       off_t offset, FAR uint8_t *buffer, size_t buflen,
+                       FAR size_t *nread, FAR bool *eof)
+{
+  FAR uint32_t *ptr;
+  size_t        readsize;
+  size_t        reqlen;
+  size_t        tmp;
+  uint32_t      count;
+  uint32_t      eofflag;
+  int           error;
+
+  /* Make sure that the attempted read size does not exceed the RPC maximum */
+
+  readsize = buflen;
+  if (readsize > nmp->nm_rsize)
+    {
+      readsize = nmp->nm_rsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO buffer size */
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %d bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  error = nfs_request(nmp, NFSPROC_READ,
+                      (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  if (*ptr++ != 0)
+    {
+      /* Yes... just skip over the attributes for now */
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication. */
+
+  eofflag = *ptr++;
+
+  /* Then the length of the read data followed by the read data itself */
+
+  count = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (count > readsize)
+    {
+      return EIO;
+    }
+
+  memcpy(buffer, ptr, count);
+
+  *nread = count;
+  *eof   = (eofflag != 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_writerpc
+ *
+ * Description:
+ *   Perform one WRITE RPC, transferring no more than one RPC's worth of data
+ *   from 'buffer' to 'offset' in the file.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  On success, the number
+ *   of bytes written is returned in 'nwritten' and the 'committed' value is
+ *   lowered to the commitment level reported by the server, if that is
+ *   lower.
+ *
+ ****************************************************************************/
+
+static int nfs_writerpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        off_t offset, FAR const uint8_t *buffer,
+                        size_t buflen, FAR size_t *nwritten,
+                        FAR int *committed)
+{
+  FAR uint32_t *ptr;
+  size_t        writesize;
+  size_t        bufsize;
+  size_t        reqlen;
+  uint32_t      tmp;
+  int           error;
+
+  /* Make sure that the attempted write size does not exceed the RPC maximum */
+
+  writesize = buflen;
+  if (writesize > nmp->nm_wsize)
+    {
+      writesize = nmp->nm_wsize;
+    }
+
+  /* Make sure that the attempted write size does not exceed the IO buffer size */
+
+  bufsize = SIZEOF_rpc_call_write(writesize);
+  if (bufsize > nmp->nm_buflen)
+    {
+      writesize -= (bufsize - nmp->nm_buflen);
+    }
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(writesize);
+  *ptr++  = txdr_unsigned(NFS_WRITE_STABLE);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(writesize);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, writesize);
+  reqlen += uint32_alignup(writesize);
+
+  /* Perform the write */
+
+  nfs_cachepurge(nmp);
+  nfs_statistics(NFSPROC_WRITE);
+  error = nfs_request(nmp, NFSPROC_WRITE,
+                      (FAR void *)nmp->nm_iobuffer, reqlen,
+                      (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
+  if (error)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < 1 || tmp > writesize)
+    {
+      return EIO;
+    }
+
+  *nwritten = tmp;
+
+  /* Determine the lowest committment level obtained by any of the RPCs. */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  if ((int)tmp < *committed)
+    {
+      *committed = (int)tmp;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_wbflush
+ *
+ * Description:
+ *   Send any data held in the write-behind buffer of the file to the
+ *   server.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_wbflush(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  size_t nwritten;
+  size_t offset;
+  int committed = NFSV3WRITE_FILESYNC;
+  int error;
+
+  for (offset = 0; offset < np->n_wblen; offset += nwritten)
+    {
+      error = nfs_writerpc(nmp, np, np->n_wboffset + offset,
+                           &np->n_wbbuffer[offset], np->n_wblen - offset,
+                           &nwritten, &committed);
+      if (error != OK)
+        {
+          /* Keep whatever was not yet written in the buffer */
+
+          if (offset > 0)
+            {
+              memmove(np->n_wbbuffer, &np->n_wbbuffer[offset],
+                      np->n_wblen - offset);
+              np->n_wboffset += offset;
+              np->n_wblen    -= offset;
+            }
+
+          return error;
+        }
+    }
+
+  np->n_wboffset += np->n_wblen;
+  np->n_wblen     = 0;
+
+  /* Data written UNSTABLE must be followed by a COMMIT before the file
+   * is closed.
+   */
+
+  if (committed == NFSV3WRITE_UNSTABLE)
+    {
+      np->n_flags |= NFSNODE_UNSTABLE;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_filesync
+ *
+ * Description:
+ *   Flush the write-behind buffer of the file and COMMIT any data that the
+ *   server accepted as UNSTABLE.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_filesync(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+  int           error;
+
+  error = nfs_wbflush(nmp, np);
+  if (error != OK)
+    {
+      return error;
+    }
+
+  if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+    {
+      return OK;
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* An offset and count of zero commit the entire file */
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the commit */
+
+  nfs_statistics(NFSPROC_COMMIT);
+  error = nfs_request(nmp, NFSPROC_COMMIT,
+                      (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
+  if (error)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", error);
+      return error;
+    }
+
+  np->n_flags &= ~NFSNODE_UNSTABLE;
+  return OK;
+}
+#endif
 
 /****************************************************************************
  * Name: nfs_read
@@ -787,11 +1241,9 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
+  size_t                     readsize;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  bool                       eof;
   int                        error = 0;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
@@ -817,112 +1269,105 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* The server must see any buffered write data before we read it back */
+
+  error = nfs_wbflush(nmp, np);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_wbflush failed: %d\n", error);
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Get the number of bytes left in the file and truncate read count so that
    * it does not exceed the number of bytes left in the file.
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  if (filep->f_pos >= np->n_size)
     {
-      buflen = tmp;
+      buflen = 0;
+    }
+  else if (buflen > np->n_size - filep->f_pos)
+    {
+      buflen = np->n_size - filep->f_pos;
       finfo("Read size truncated to %d\n", buflen);
     }
 
+#ifdef CONFIG_NFS_READAHEAD
+  /* Allocate the readahead buffer on the first read of the file.  If the
+   * allocation fails, we just read without it.
+   */
+
+  if (np->n_rabuffer == NULL && buflen < nmp->nm_rsize)
+    {
+      np->n_rabuffer = (FAR uint8_t *)kmm_malloc(nmp->nm_rsize);
+      np->n_ralen    = 0;
+    }
+#endif
+
   /* Now loop until we fill the user buffer (or hit the end of the file) */
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
+#ifdef CONFIG_NFS_READAHEAD
+      /* Can this read be satisfied (at least in part) from the readahead
+       * buffer?
+       */
 
-      readsize = buflen;
-      if (readsize > nmp->nm_rsize)
+      if (np->n_ralen > 0 && filep->f_pos >= np->n_raoffset &&
+          filep->f_pos < np->n_raoffset + np->n_ralen)
         {
-          readsize = nmp->nm_rsize;
-        }
+          readsize = np->n_raoffset + np->n_ralen - filep->f_pos;
+          if (readsize > buflen - bytesread)
+            {
+              readsize = buflen - bytesread;
+            }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
+          memcpy(buffer, &np->n_rabuffer[filep->f_pos - np->n_raoffset],
+                 readsize);
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+          continue;
         }
 
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
+      /* No.. If what is left to read is smaller than one RPC, then read a
+       * full RPC's worth of data into the readahead buffer so that the
+       * following, sequential reads can be satisfied without going back to
+       * the server.  Larger reads go directly into the user buffer.
+       */
 
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
+      if (np->n_rabuffer != NULL && buflen - bytesread < nmp->nm_rsize)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
-          goto errout_with_semaphore;
-        }
+          np->n_ralen = 0;
+          error = nfs_readrpc(nmp, np, filep->f_pos, np->n_rabuffer,
+                              nmp->nm_rsize, &readsize, &eof);
+          if (error != OK)
+            {
+              goto errout_with_semaphore;
+            }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+          np->n_raoffset = filep->f_pos;
+          np->n_ralen    = readsize;
 
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+          if (readsize == 0)
+            {
+              break;
+            }
 
-      /* Check if attributes are included in the responses */
+          continue;
+        }
+#endif
 
-      tmp = *ptr++;
-      if (*ptr != 0)
+      error = nfs_readrpc(nmp, np, filep->f_pos, (FAR uint8_t *)buffer,
+                          buflen - bytesread, &readsize, &eof);
+      if (error != OK)
         {
-          /* Yes... just skip over the attributes for now */
-
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          goto errout_with_semaphore;
         }
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
-
       /* Update the read state data */
 
       filep->f_pos += readsize;
@@ -931,7 +1376,7 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
       /* Check if we hit the end of file */
 
-      if (tmp != 0)
+      if (eof || readsize == 0)
         {
           break;
         }
@@ -960,13 +1405,8 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 {
   struct nfsmount       *nmp;
   struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
+  size_t                 writesize;
   ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
   int                    committed = NFSV3WRITE_FILESYNC;
   int                    error;
 
@@ -1001,140 +1441,171 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Now loop until we send the entire user buffer */
+#ifdef CONFIG_NFS_READAHEAD
+  /* Any data in the readahead buffer may be stale after this write */
 
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
+  np->n_ralen = 0;
+#endif
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Writes smaller than one RPC are gathered in the write-behind buffer and
+   * sent to the server when the buffer fills, when a non-contiguous write
+   * is made, or when the file is read, synced or closed.
+   */
+
+  if (np->n_wbbuffer == NULL && buflen < nmp->nm_wsize)
+    {
+      np->n_wbbuffer = (FAR uint8_t *)kmm_malloc(nmp->nm_wsize);
+      np->n_wblen    = 0;
+    }
+
+  if (np->n_wbbuffer != NULL && buflen < nmp->nm_wsize)
     {
-      /* Make sure that the attempted write size does not exceed the RPC maximum */
+      /* The buffered data must be contiguous with this write */
 
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
+      if (np->n_wblen > 0 && filep->f_pos != np->n_wboffset + np->n_wblen)
         {
-          writesize = nmp->nm_wsize;
+          error = nfs_wbflush(nmp, np);
+          if (error != OK)
+            {
+              ferr("ERROR: nfs_wbflush failed: %d\n", error);
+              goto errout_with_semaphore;
+            }
         }
 
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+      if (np->n_wblen == 0)
         {
-          writesize -= (bufsize - nmp->nm_buflen);
+          np->n_wboffset = filep->f_pos;
         }
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
-      reqlen  = 0;
+      for (byteswritten = 0; byteswritten < buflen; )
+        {
+          writesize = nmp->nm_wsize - np->n_wblen;
+          if (writesize > buflen - byteswritten)
+            {
+              writesize = buflen - byteswritten;
+            }
 
-      /* Copy the variable length, file handle */
+          memcpy(&np->n_wbbuffer[np->n_wblen], buffer, writesize);
+          np->n_wblen  += writesize;
 
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+          filep->f_pos += writesize;
+          byteswritten += writesize;
+          buffer       += writesize;
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
+          if (np->n_wblen >= nmp->nm_wsize)
+            {
+              error = nfs_wbflush(nmp, np);
+              if (error != OK)
+                {
+                  ferr("ERROR: nfs_wbflush failed: %d\n", error);
+                  goto errout_with_semaphore;
+                }
+            }
+        }
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
+      /* The server has not seen the buffered data, so update the locally
+       * cached size of the file.
+       */
 
-      /* Copy the count and stable values */
+      if (filep->f_pos > np->n_size)
+        {
+          np->n_size = filep->f_pos;
+        }
 
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+      nfs_semgive(nmp);
+      return byteswritten;
+    }
 
-      /* Copy a chunk of the user data into the I/O buffer */
+  /* This write will go directly to the server.  First send any buffered
+   * data so that the writes reach the server in order.
+   */
 
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+  error = nfs_wbflush(nmp, np);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_wbflush failed: %d\n", error);
+      goto errout_with_semaphore;
+    }
+#endif
 
-      /* Perform the write */
+  /* Now loop until we send the entire user buffer */
 
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
-      if (error)
+  for (byteswritten = 0; byteswritten < buflen; )
+    {
+      error = nfs_writerpc(nmp, np, filep->f_pos,
+                           (FAR const uint8_t *)buffer,
+                           buflen - byteswritten, &writesize, &committed);
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
           goto errout_with_semaphore;
         }
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+      /* Update the write state data */
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+      filep->f_pos += writesize;
+      byteswritten += writesize;
+      buffer       += writesize;
+    }
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
+#ifdef CONFIG_NFS_WRITEBEHIND
+  if (committed == NFSV3WRITE_UNSTABLE)
+    {
+      np->n_flags |= NFSNODE_UNSTABLE;
+    }
+#endif
 
-      /* Check if normal file attributes follow */
+  nfs_semgive(nmp);
+  return byteswritten;
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Send any buffered write data to the server and COMMIT all data that
+ *   was written UNSTABLE.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-      /* Get the count of bytes actually written */
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int error;
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+  /* Sanity checks */
 
-      if (tmp < 1 || tmp > writesize)
-        {
-           error = EIO;
-           goto errout_with_semaphore;
-        }
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      writesize = tmp;
+  /* Recover our private data from the struct file instance */
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  DEBUGASSERT(nmp != NULL);
 
-      /* Update the read state data */
+  /* Make sure that the mount is still healthy */
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error == OK)
+    {
+      error = nfs_filesync(nmp, np);
     }
 
-  nfs_semgive(nmp);
-  return writesize;
-
-errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
+#endif
 
 /****************************************************************************
  * Name: nfs_dup
@@ -2260,6 +2731,7 @@ static int nfs_remove(struct inode *mountpt, const char *relpath)
 
   /* Perform the REMOVE RPC call */
 
+  nfs_cachepurge(nmp);
   nfs_statistics(NFSPROC_REMOVE);
   error = nfs_request(nmp, NFSPROC_REMOVE,
                       (FAR void *)&nmp->nm_msgbuffer.removef, reqlen,
@@ -2383,6 +2855,7 @@ static int nfs_mkdir(struct inode *mountpt, const char *relpath, mode_t mode)
 
   /* Perform the MKDIR RPC */
 
+  nfs_cachepurge(nmp);
   nfs_statistics(NFSPROC_MKDIR);
   error = nfs_request(nmp, NFSPROC_MKDIR,
                       (FAR void *)&nmp->nm_msgbuffer.mkdir, reqlen,
@@ -2472,6 +2945,7 @@ static int nfs_rmdir(struct inode *mountpt, const char *relpath)
 
   /* Perform the RMDIR RPC */
 
+  nfs_cachepurge(nmp);
   nfs_statistics(NFSPROC_RMDIR);
   error = nfs_request(nmp, NFSPROC_RMDIR,
                           (FAR void *)&nmp->nm_msgbuffer.rmdir, reqlen,
@@ -2589,6 +3063,7 @@ static int nfs_rename(struct inode *mountpt, const char *oldrelpath,
 
   /* Perform the RENAME RPC */
 
+  nfs_cachepurge(nmp);
   nfs_statistics(NFSPROC_RENAME);
   error = nfs_request(nmp, NFSPROC_RENAME,
                       (FAR void *)&nmp->nm_msgbuffer.renamef, reqlen,
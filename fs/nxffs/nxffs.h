@@ -246,6 +246,19 @@ struct nxffs_entry_s
   uint32_t                  datlen;    /* Length of inode data */
 };
 
+/* This structure describes one entry in the in-memory name index.  Only the
+ * hash of the name is kept; the name itself is verified on FLASH.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  FAR struct nxffs_index_s *flink;     /* Next entry in the hash bucket */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+  uint32_t                  hash;      /* Hash of the inode name */
+};
+#endif
+
 /* This structure describes int in-memory representation of the data block */
 
 struct nxffs_blkentry_s
@@ -301,6 +314,10 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  bool                      idxvalid;  /* True: The name index is complete */
+  FAR struct nxffs_index_s *index[CONFIG_NXFFS_INDEX_NBUCKETS];
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -615,6 +632,33 @@ void nxffs_freeentry(FAR struct nxffs_entry_s *entry);
 int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
                     FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_getentry
+ *
+ * Description:
+ *   Read the valid inode whose header is at exactly the provided FLASH
+ *   offset.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   offset - The FLASH memory offset of the inode header.
+ *   entry  - A pointer to memory provided by the caller in which to return
+ *     the inode description.
+ *
+ * Returned Value:
+ *   Zero is returned on success. -ENOENT is returned if there is no valid
+ *   inode header at that offset.  Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ * Defined in nxffs_inode.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_getentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                   FAR struct nxffs_entry_s *entry);
+#endif
+
 /****************************************************************************
  * Name: nxffs_findinode
  *
@@ -639,6 +683,122 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
 int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
                     FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_index_reset
+ *
+ * Description:
+ *   Discard the in-memory name index.  If valid is true, the index is then
+ *   marked complete (i.e., the caller will add every valid inode on the
+ *   volume or the volume is empty).  Otherwise, it is not used until the
+ *   next call to nxffs_index_build().
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   valid  - The new state of the index
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_reset(FAR struct nxffs_volume_s *volume, bool valid);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_add
+ *
+ * Description:
+ *   Add a valid inode to the name index.  If memory cannot be allocated,
+ *   the index is discarded and inodes are located by scanning the FLASH
+ *   until the index is rebuilt.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   entry  - Describes the inode
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_add(FAR struct nxffs_volume_s *volume,
+                     FAR const struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_remove
+ *
+ * Description:
+ *   Remove a deleted inode from the name index.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   entry  - Describes the inode
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume,
+                        FAR const struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_build
+ *
+ * Description:
+ *   Rebuild the name index from the valid inodes on FLASH.  This is
+ *   necessary after the file system has been packed.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_build(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ *
+ * Description:
+ *   Use the name index to find the inode with the provided name.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if there is no such
+ *   inode.  -ENOSYS is returned if the index cannot be used and the FLASH
+ *   must be searched.  Other negated errno values indicate FLASH failures.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_index_find(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                     FAR struct nxffs_entry_s *entry);
+#endif
+
 /****************************************************************************
  * Name: nxffs_inodeend
  *
@@ -0,0 +1,307 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_hash
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of an inode name.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_index_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_reset
+ *
+ * Description:
+ *   Discard the in-memory name index.  If valid is true, the index is then
+ *   marked complete (i.e., the caller will add every valid inode on the
+ *   volume or the volume is empty).  Otherwise, it is not used until the
+ *   next call to nxffs_index_build().
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   valid  - The new state of the index
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_reset(FAR struct nxffs_volume_s *volume, bool valid)
+{
+  FAR struct nxffs_index_s *idx;
+  int i;
+
+  for (i = 0; i < CONFIG_NXFFS_INDEX_NBUCKETS; i++)
+    {
+      while ((idx = volume->index[i]) != NULL)
+        {
+          volume->index[i] = idx->flink;
+          kmm_free(idx);
+        }
+    }
+
+  volume->idxvalid = valid;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_add
+ *
+ * Description:
+ *   Add a valid inode to the name index.  If memory cannot be allocated,
+ *   the index is discarded and inodes are located by scanning the FLASH
+ *   until the index is rebuilt.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   entry  - Describes the inode
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_add(FAR struct nxffs_volume_s *volume,
+                     FAR const struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *idx;
+  int ndx;
+
+  if (!volume->idxvalid)
+    {
+      return;
+    }
+
+  idx = (FAR struct nxffs_index_s *)kmm_malloc(sizeof(struct nxffs_index_s));
+  if (idx == NULL)
+    {
+      ferr("ERROR: Failed to allocate index entry\n");
+      nxffs_index_reset(volume, false);
+      return;
+    }
+
+  idx->hoffset       = entry->hoffset;
+  idx->hash          = nxffs_index_hash(entry->name);
+
+  ndx                = idx->hash % CONFIG_NXFFS_INDEX_NBUCKETS;
+  idx->flink         = volume->index[ndx];
+  volume->index[ndx] = idx;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_remove
+ *
+ * Description:
+ *   Remove a deleted inode from the name index.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   entry  - Describes the inode
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume,
+                        FAR const struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *prev;
+  FAR struct nxffs_index_s *idx;
+  uint32_t hash;
+  int ndx;
+
+  hash = nxffs_index_hash(entry->name);
+  ndx  = hash % CONFIG_NXFFS_INDEX_NBUCKETS;
+
+  for (prev = NULL, idx = volume->index[ndx];
+       idx != NULL;
+       prev = idx, idx = idx->flink)
+    {
+      if (idx->hoffset == entry->hoffset)
+        {
+          if (prev != NULL)
+            {
+              prev->flink = idx->flink;
+            }
+          else
+            {
+              volume->index[ndx] = idx->flink;
+            }
+
+          kmm_free(idx);
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_index_build
+ *
+ * Description:
+ *   Rebuild the name index from the valid inodes on FLASH.  This is
+ *   necessary after the file system has been packed.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_index_build(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+
+  nxffs_index_reset(volume, true);
+
+  offset = volume->inoffset;
+  while (volume->idxvalid && nxffs_nextentry(volume, offset, &entry) == OK)
+    {
+      nxffs_index_add(volume, &entry);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ *
+ * Description:
+ *   Use the name index to find the inode with the provided name.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if there is no such
+ *   inode.  -ENOSYS is returned if the index cannot be used and the FLASH
+ *   must be searched.  Other negated errno values indicate FLASH failures.
+ *
+ ****************************************************************************/
+
+int nxffs_index_find(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                     FAR struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *idx;
+  uint32_t hash;
+  int ret;
+
+  if (!volume->idxvalid)
+    {
+      return -ENOSYS;
+    }
+
+  hash = nxffs_index_hash(name);
+  for (idx = volume->index[hash % CONFIG_NXFFS_INDEX_NBUCKETS];
+       idx != NULL;
+       idx = idx->flink)
+    {
+      if (idx->hash != hash)
+        {
+          continue;
+        }
+
+      /* The hash matches.  Verify the name against the inode on FLASH */
+
+      ret = nxffs_getentry(volume, idx->hoffset, entry);
+      if (ret == -ENOENT)
+        {
+          /* The index is out of date.  Don't trust it any longer */
+
+          ferr("ERROR: Stale index entry at %ld\n", (long)idx->hoffset);
+          nxffs_index_reset(volume, false);
+          return -ENOSYS;
+        }
+      else if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (strcmp(name, entry->name) == 0)
+        {
+          return OK;
+        }
+
+      nxffs_freeentry(entry);
+    }
+
+  return -ENOENT;
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
@@ -361,6 +361,12 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Every valid inode found below is added to the name index */
+
+  nxffs_index_reset(volume, true);
+#endif
+
   /* Then find the first valid inode in or beyond the first valid block */
 
   offset = block * volume->geo.blocksize;
@@ -394,6 +400,10 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
       volume->inoffset = entry.hoffset;
       finfo("First inode at offset %d\n", volume->inoffset);
 
+#ifdef CONFIG_NXFFS_INDEX
+      nxffs_index_add(volume, &entry);
+#endif
+
       /* Discard this entry and set the next offset. */
 
       offset = nxffs_inodeend(volume, &entry);
@@ -406,6 +416,10 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
     {
       while (nxffs_nextentry(volume, offset, &entry) == OK)
         {
+#ifdef CONFIG_NXFFS_INDEX
+          nxffs_index_add(volume, &entry);
+#endif
+
           /* Discard the entry and guess the next offset. */
 
           offset = nxffs_inodeend(volume, &entry);
@@ -353,6 +353,61 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: nxffs_getentry
+ *
+ * Description:
+ *   Read the valid inode whose header is at exactly the provided FLASH
+ *   offset.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume.
+ *   offset - The FLASH memory offset of the inode header.
+ *   entry  - A pointer to memory provided by the caller in which to return
+ *     the inode description.
+ *
+ * Returned Value:
+ *   Zero is returned on success. -ENOENT is returned if there is no valid
+ *   inode header at that offset.  Otherwise, a negated errno is returned
+ *   that indicates the nature of the failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_getentry(FAR struct nxffs_volume_s *volume, off_t offset,
+                   FAR struct nxffs_entry_s *entry)
+{
+  int ret;
+
+  /* Make sure that the block containing the inode header is in memory */
+
+  nxffs_ioseek(volume, offset);
+  ret = nxffs_rdcache(volume, volume->ioblock);
+  if (ret < 0)
+    {
+      ferr("ERROR: nxffs_rdcache failed: %d\n", -ret);
+      return ret;
+    }
+
+  /* Inode headers never span erase blocks (see nxffs_getc()) */
+
+  if (volume->iooffset + SIZEOF_NXFFS_INODE_HDR > volume->geo.blocksize)
+    {
+      return -ENOENT;
+    }
+
+  /* Verify the magic number, then read and verify the rest of the header */
+
+  if (memcmp(&volume->cache[volume->iooffset], g_inodemagic,
+             NXFFS_MAGICSIZE) != 0)
+    {
+      return -ENOENT;
+    }
+
+  return nxffs_rdentry(volume, offset, entry);
+}
+#endif
+
 /****************************************************************************
  * Name: nxffs_findinode
  *
@@ -378,6 +433,18 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Try the name index first.  Fall back to scanning FLASH if the index
+   * is not available.
+   */
+
+  ret = nxffs_index_find(volume, name, entry);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -1272,6 +1272,12 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
       ferr("ERROR: Failed to write inode header block %d: %d\n",
            volume->ioblock, -ret);
     }
+#ifdef CONFIG_NXFFS_INDEX
+  else
+    {
+      nxffs_index_add(volume, entry);
+    }
+#endif
 
   /* The volume is now available for other writers */
 
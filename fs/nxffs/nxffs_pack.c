@@ -178,6 +178,54 @@ static inline bool nxffs_packvalid(FAR struct nxffs_pack_s *pack)
           blkhdr->state == BLOCK_STATE_GOOD);
 }
 
+/****************************************************************************
+ * Name: nxffs_packerased
+ *
+ * Description:
+ *   Check if the erase block in the volume->pack buffer is already in the
+ *   state that packing would leave it in after all data has been packed:
+ *   Every I/O block has a good block header and the remainder of each
+ *   I/O block is erased.  Such an erase block does not need to be erased
+ *   and re-written.
+ *
+ * Input Parameters:
+ *   volume - The volume being packed.
+ *
+ * Returned Values:
+ *   True if the erase block does not need to be re-written.
+ *
+ ****************************************************************************/
+
+static bool nxffs_packerased(FAR struct nxffs_volume_s *volume)
+{
+  FAR struct nxffs_block_s *blkhdr;
+  FAR const uint8_t *iobuffer;
+  int i;
+  int j;
+
+  for (i = 0, iobuffer = volume->pack;
+       i < volume->blkper;
+       i++, iobuffer += volume->geo.blocksize)
+    {
+      blkhdr = (FAR struct nxffs_block_s *)iobuffer;
+      if (memcmp(blkhdr->magic, g_blockmagic, NXFFS_MAGICSIZE) != 0 ||
+          blkhdr->state != BLOCK_STATE_GOOD)
+        {
+          return false;
+        }
+
+      for (j = SIZEOF_NXFFS_BLOCK_HDR; j < volume->geo.blocksize; j++)
+        {
+          if (iobuffer[j] != CONFIG_NXFFS_ERASEDSTATE)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
  * Name: nxffs_mediacheck
  *
@@ -1393,6 +1441,14 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
 
 start_pack:
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Inodes are about to move.  Don't use the name index until it has been
+   * rebuilt.
+   */
+
+  nxffs_index_reset(volume, false);
+#endif
+
   pack.ioblock     = nxffs_getblock(volume, iooffset);
   pack.iooffset    = nxffs_getoffset(volume, iooffset, pack.ioblock);
   volume->froffset = iooffset;
@@ -1452,6 +1508,17 @@ start_pack:
         }
 #endif
 
+      /* If all of the inode data has already been packed and this erase
+       * block is already formatted and empty, then there is nothing to
+       * change.  Don't wear the FLASH by erasing and re-writing it.  This
+       * is the usual case for the free region at the end of the volume.
+       */
+
+      if (packed && wrfile == NULL && nxffs_packerased(volume))
+        {
+          continue;
+        }
+
       /* Now pack each I/O block */
 
       for (i = 0, block = pack.block0, pack.iobuffer = volume->pack;
@@ -1599,5 +1666,12 @@ start_pack:
 errout_with_pack:
   nxffs_freeentry(&pack.src.entry);
   nxffs_freeentry(&pack.dest.entry);
+
+#ifdef CONFIG_NXFFS_INDEX
+  /* Re-index the inodes at their new locations */
+
+  nxffs_index_build(volume);
+#endif
+
   return ret;
 }
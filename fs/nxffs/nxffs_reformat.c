@@ -287,6 +287,12 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
       return ret;
     }
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* The volume is now empty */
+
+  nxffs_index_reset(volume, true);
+#endif
+
   /* Check for bad blocks */
 
   ret = nxffs_badblocks(volume);
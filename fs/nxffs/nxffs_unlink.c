@@ -129,6 +129,12 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+#ifdef CONFIG_NXFFS_INDEX
+  else
+    {
+      nxffs_index_remove(volume, &entry);
+    }
+#endif
 
 errout_with_entry:
   nxffs_freeentry(&entry);
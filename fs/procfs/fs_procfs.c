@@ -75,9 +75,16 @@
  ****************************************************************************/
 
 extern const struct procfs_operations proc_operations;
+extern const struct procfs_operations bench_operations;
 extern const struct procfs_operations cpuload_operations;
+extern const struct procfs_operations cpustat_operations;
+extern const struct procfs_operations critmon_operations;
+extern const struct procfs_operations heap_operations;
 extern const struct procfs_operations kmm_operations;
+extern const struct procfs_operations mempool_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations smp_operations;
+extern const struct procfs_operations snapshot_operations;
 extern const struct procfs_operations uptime_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -117,18 +124,47 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",        &proc_operations,            PROCFS_DIR_TYPE    },
 #endif
 
+#ifdef CONFIG_FS_PROCFS_BENCH
+  { "bench",         &bench_operations,           PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
   { "cpuload",       &cpuload_operations,         PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SCHED_RUNTIME) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPUSTAT)
+  { "cpustat",       &cpustat_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SCHED_CRITMONITOR) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CRITMON)
+  { "csection",      &critmon_operations,         PROCFS_FILE_TYPE   },
+  { "irqs",          &critmon_operations,         PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_MM_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP)
+  { "heap",          &heap_operations,            PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_KERNEL_HEAP) && !defined(CONFIG_FS_PROCFS_EXCLUDE_KMM)
   { "kmm",           &kmm_operations,             PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_MEMPOOL) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
+  { "mempool",       &mempool_operations,         PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",       &module_operations,          PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_SMP_BALANCE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMP)
+  { "smp",           &smp_operations,             PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+  { "snapshot",      &snapshot_operations,        PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   { "fs/smartfs**",  &smartfs_procfsoperations,   PROCFS_UNKOWN_TYPE },
 #endif
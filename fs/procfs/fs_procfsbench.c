@@ -0,0 +1,1298 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsbench.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <mqueue.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/kthread.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_FS_PROCFS_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FS_PROCFS_BENCH_NITER
+#  define CONFIG_FS_PROCFS_BENCH_NITER 1000
+#endif
+
+#ifndef CONFIG_FS_PROCFS_BENCH_STACKSIZE
+#  define CONFIG_FS_PROCFS_BENCH_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_FS_PROCFS_BENCH_FSPATH
+#  define CONFIG_FS_PROCFS_BENCH_FSPATH ""
+#endif
+
+#ifndef CONFIG_FS_PROCFS_BENCH_FSSIZE
+#  define CONFIG_FS_PROCFS_BENCH_FSSIZE 65536
+#endif
+
+/* Which benchmarks can be built */
+
+#ifndef CONFIG_DISABLE_MQUEUE
+#  define HAVE_BENCH_MQ 1
+#endif
+
+#if !defined(CONFIG_DISABLE_POLL) && defined(CONFIG_DEV_NULL) && \
+    CONFIG_NFILE_DESCRIPTORS > 0
+#  define HAVE_BENCH_POLL 1
+#endif
+
+#if defined(CONFIG_NET_LOOPBACK) && defined(CONFIG_NET_IPv4) && \
+    CONFIG_NSOCKET_DESCRIPTORS > 0
+#  if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_READAHEAD)
+#    define HAVE_BENCH_UDP 1
+#  endif
+#  if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_READAHEAD)
+#    define HAVE_BENCH_TCP 1
+#  endif
+#endif
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+#  define HAVE_BENCH_FS 1
+#endif
+
+/* The time base.  The cycle counter is used if the architecture has one.
+ * Otherwise, times are taken from the system clock in microseconds (which
+ * is only as precise as the system timer, so the benchmarks then depend
+ * on the iteration count for their precision).
+ */
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+#  define bench_gettime() up_perf_gettime()
+#  define bench_getfreq() up_perf_getfreq()
+#else
+#  define bench_getfreq() USEC_PER_SEC
+#endif
+
+/* Output */
+
+#define BENCH_NTESTS   16
+#define BENCH_LINELEN  64
+#define BENCH_BUFSIZE  (BENCH_LINELEN * (BENCH_NTESTS + 1))
+
+/* Benchmark parameters */
+
+#define BENCH_MSGSIZE  16             /* Message queue message size */
+#define BENCH_PKTSIZE  1024           /* Socket transfer size */
+#define BENCH_BLKSIZE  512            /* File I/O transfer size */
+#define BENCH_PORT     5471           /* Loopback port */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The result of one benchmark */
+
+struct bench_result_s
+{
+  uint32_t ops;                       /* Operations performed */
+  uint32_t elapsed;                   /* Total time in bench_gettime() units */
+  uint32_t nbytes;                    /* Bytes transferred (or zero) */
+};
+
+/* One benchmark */
+
+typedef CODE int (*bench_func_t)(FAR struct bench_result_s *result);
+
+struct bench_case_s
+{
+  FAR const char *name;
+  bench_func_t func;
+};
+
+/* State shared between a benchmark and its helper thread.  Only one
+ * benchmark runs at a time.
+ */
+
+struct bench_state_s
+{
+  sem_t lock;                         /* Only one reader runs benchmarks */
+  sem_t sem[2];                       /* Ping/pong semaphores */
+  sem_t done;                         /* Posted when the helper exits */
+  volatile uint32_t tpost;            /* Time of the last post */
+  volatile uint32_t elapsed;          /* Time measured by the helper */
+  int result;                         /* Result of the helper */
+};
+
+/* This structure describes one open "file" */
+
+struct bench_file_s
+{
+  struct procfs_file_s  base;         /* Base open file structure */
+  unsigned int linesize;              /* Number of valid characters in line[] */
+  char line[BENCH_BUFSIZE];           /* Pre-allocated buffer for the output */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Benchmarks */
+
+static int     bench_ctxsw(FAR struct bench_result_s *result);
+static int     bench_semwake(FAR struct bench_result_s *result);
+#ifdef HAVE_BENCH_MQ
+static int     bench_mq(FAR struct bench_result_s *result);
+#endif
+static int     bench_malloc(FAR struct bench_result_s *result);
+static int     bench_wdog(FAR struct bench_result_s *result);
+#ifdef HAVE_BENCH_POLL
+static int     bench_poll1(FAR struct bench_result_s *result);
+static int     bench_poll8(FAR struct bench_result_s *result);
+static int     bench_poll32(FAR struct bench_result_s *result);
+#endif
+#ifdef HAVE_BENCH_UDP
+static int     bench_udp(FAR struct bench_result_s *result);
+#endif
+#ifdef HAVE_BENCH_TCP
+static int     bench_tcp(FAR struct bench_result_s *result);
+#endif
+#ifdef HAVE_BENCH_FS
+static int     bench_fswrite(FAR struct bench_result_s *result);
+static int     bench_fsread(FAR struct bench_result_s *result);
+#endif
+
+/* File system methods */
+
+static int     bench_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     bench_close(FAR struct file *filep);
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     bench_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     bench_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All benchmarks, in the order in which they are run and reported */
+
+static const struct bench_case_s g_bench_cases[] =
+{
+  { "ctxsw",    bench_ctxsw   },     /* Context switch */
+  { "semwake",  bench_semwake },     /* sem_post() to higher priority waiter */
+#ifdef HAVE_BENCH_MQ
+  { "mq",       bench_mq      },     /* mq_send()/mq_receive() round trip */
+#endif
+  { "malloc",   bench_malloc  },     /* kmm_malloc()/kmm_free() pair */
+  { "wdog",     bench_wdog    },     /* wd_start()/wd_cancel() pair */
+#ifdef HAVE_BENCH_POLL
+  { "poll1",    bench_poll1   },     /* poll() on 1 descriptor */
+  { "poll8",    bench_poll8   },     /* poll() on 8 descriptors */
+  { "poll32",   bench_poll32  },     /* poll() on 32 descriptors */
+#endif
+#ifdef HAVE_BENCH_UDP
+  { "udp-lo",   bench_udp     },     /* UDP loopback throughput */
+#endif
+#ifdef HAVE_BENCH_TCP
+  { "tcp-lo",   bench_tcp     },     /* TCP loopback throughput */
+#endif
+#ifdef HAVE_BENCH_FS
+  { "fs-write", bench_fswrite },     /* File write throughput */
+  { "fs-read",  bench_fsread  },     /* File read throughput */
+#endif
+};
+
+#define BENCH_NCASES (sizeof(g_bench_cases) / sizeof(struct bench_case_s))
+
+static struct bench_state_s g_bench =
+{
+  SEM_INITIALIZER(1)
+};
+
+#ifdef HAVE_BENCH_FS
+static uint8_t g_bench_block[BENCH_BLKSIZE];
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations bench_operations =
+{
+  bench_open,        /* open */
+  bench_close,       /* close */
+  bench_read,        /* read */
+  NULL,              /* write */
+
+  bench_dup,         /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  bench_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_gettime
+ ****************************************************************************/
+
+#ifndef CONFIG_ARCH_HAVE_PERF_EVENTS
+static uint32_t bench_gettime(void)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_priority
+ *
+ * Description:
+ *   Return the priority of the calling thread plus an increment.
+ *
+ ****************************************************************************/
+
+static int bench_priority(int increment)
+{
+  int priority = sched_self()->sched_priority + increment;
+
+  return priority > SCHED_PRIORITY_MAX ? SCHED_PRIORITY_MAX : priority;
+}
+
+/****************************************************************************
+ * Name: bench_spawn and bench_join
+ *
+ * Description:
+ *   Start a helper thread and wait for it to exit.  The helper must post
+ *   g_bench.done as the last thing that it does.
+ *
+ ****************************************************************************/
+
+static int bench_spawn(main_t entry, int increment)
+{
+  int pid;
+
+  g_bench.result = OK;
+  pid = kernel_thread("bench", bench_priority(increment),
+                      CONFIG_FS_PROCFS_BENCH_STACKSIZE, entry, NULL);
+  return pid < 0 ? -get_errno() : OK;
+}
+
+static int bench_join(void)
+{
+  while (sem_wait(&g_bench.done) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  return g_bench.result;
+}
+
+/****************************************************************************
+ * Name: bench_pong
+ *
+ * Description:
+ *   Helper thread for bench_ctxsw:  Answer each post of sem[0] with a post
+ *   of sem[1].
+ *
+ ****************************************************************************/
+
+static int bench_pong(int argc, FAR char *argv[])
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      (void)sem_wait(&g_bench.sem[0]);
+      sem_post(&g_bench.sem[1]);
+    }
+
+  sem_post(&g_bench.done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_ctxsw
+ *
+ * Description:
+ *   Ping-pong with a thread of the same priority.  Each round trip is two
+ *   context switches.
+ *
+ ****************************************************************************/
+
+static int bench_ctxsw(FAR struct bench_result_s *result)
+{
+  uint32_t start;
+  int ret;
+  int i;
+
+  ret = bench_spawn(bench_pong, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  start = bench_gettime();
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      sem_post(&g_bench.sem[0]);
+      (void)sem_wait(&g_bench.sem[1]);
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = 2 * CONFIG_FS_PROCFS_BENCH_NITER;
+  return bench_join();
+}
+
+/****************************************************************************
+ * Name: bench_waiter
+ *
+ * Description:
+ *   Helper thread for bench_semwake:  Measure the time from each post of
+ *   sem[0] until this thread runs.
+ *
+ ****************************************************************************/
+
+static int bench_waiter(int argc, FAR char *argv[])
+{
+  uint32_t elapsed = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      (void)sem_wait(&g_bench.sem[0]);
+      elapsed += bench_gettime() - g_bench.tpost;
+    }
+
+  g_bench.elapsed = elapsed;
+  sem_post(&g_bench.done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_semwake
+ *
+ * Description:
+ *   Post a semaphore that a higher priority thread waits for.  The time
+ *   from sem_post() until the waiter runs is measured by the waiter.
+ *
+ ****************************************************************************/
+
+static int bench_semwake(FAR struct bench_result_s *result)
+{
+  int ret;
+  int i;
+
+  ret = bench_spawn(bench_waiter, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      g_bench.tpost = bench_gettime();
+      sem_post(&g_bench.sem[0]);
+    }
+
+  ret = bench_join();
+  result->elapsed = g_bench.elapsed;
+  result->ops     = CONFIG_FS_PROCFS_BENCH_NITER;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_mqecho
+ *
+ * Description:
+ *   Helper thread for bench_mq:  Echo each message received on the first
+ *   queue to the second queue.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_BENCH_MQ
+static int bench_mqecho(int argc, FAR char *argv[])
+{
+  char msg[BENCH_MSGSIZE];
+  mqd_t mqin;
+  mqd_t mqout;
+  int i;
+
+  mqin  = mq_open("/bench0", O_RDONLY);
+  mqout = mq_open("/bench1", O_WRONLY);
+  if (mqin == (mqd_t)ERROR || mqout == (mqd_t)ERROR)
+    {
+      g_bench.result = -ENOENT;
+    }
+  else
+    {
+      for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+        {
+          if (mq_receive(mqin, msg, BENCH_MSGSIZE, NULL) < 0 ||
+              mq_send(mqout, msg, BENCH_MSGSIZE, 0) < 0)
+            {
+              g_bench.result = -get_errno();
+              break;
+            }
+        }
+    }
+
+  if (mqin != (mqd_t)ERROR)
+    {
+      (void)mq_close(mqin);
+    }
+
+  if (mqout != (mqd_t)ERROR)
+    {
+      (void)mq_close(mqout);
+    }
+
+  sem_post(&g_bench.done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_mq
+ *
+ * Description:
+ *   Round trips of a message through two message queues and a helper
+ *   thread of the same priority.
+ *
+ ****************************************************************************/
+
+static int bench_mq(FAR struct bench_result_s *result)
+{
+  char msg[BENCH_MSGSIZE];
+  struct mq_attr attr;
+  uint32_t start;
+  mqd_t mqout;
+  mqd_t mqin;
+  int ret;
+  int i;
+
+  memset(msg, 0, BENCH_MSGSIZE);
+  memset(&attr, 0, sizeof(struct mq_attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = BENCH_MSGSIZE;
+
+  mqout = mq_open("/bench0", O_WRONLY | O_CREAT, 0666, &attr);
+  mqin  = mq_open("/bench1", O_RDONLY | O_CREAT, 0666, &attr);
+  if (mqout == (mqd_t)ERROR || mqin == (mqd_t)ERROR)
+    {
+      ret = -get_errno();
+      goto errout;
+    }
+
+  ret = bench_spawn(bench_mqecho, 0);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  start = bench_gettime();
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      if (mq_send(mqout, msg, BENCH_MSGSIZE, 0) < 0 ||
+          mq_receive(mqin, msg, BENCH_MSGSIZE, NULL) < 0)
+        {
+          break;
+        }
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = i;
+
+  /* The queues are private to the benchmark, so the loop cannot fail
+   * (and if it did, the helper would wait forever for a message).
+   */
+
+  DEBUGASSERT(i == CONFIG_FS_PROCFS_BENCH_NITER);
+  ret = bench_join();
+
+errout:
+  if (mqout != (mqd_t)ERROR)
+    {
+      (void)mq_close(mqout);
+    }
+
+  if (mqin != (mqd_t)ERROR)
+    {
+      (void)mq_close(mqin);
+    }
+
+  (void)mq_unlink("/bench0");
+  (void)mq_unlink("/bench1");
+  return ret;
+}
+#endif /* HAVE_BENCH_MQ */
+
+/****************************************************************************
+ * Name: bench_malloc
+ *
+ * Description:
+ *   Allocate and free blocks of 16 to 1024 bytes.
+ *
+ ****************************************************************************/
+
+static int bench_malloc(FAR struct bench_result_s *result)
+{
+  FAR void *mem;
+  uint32_t start;
+  int i;
+
+  start = bench_gettime();
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      mem = kmm_malloc(16 << (i & 7));
+      if (mem == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      kmm_free(mem);
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = CONFIG_FS_PROCFS_BENCH_NITER;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_wdog
+ *
+ * Description:
+ *   Start and cancel a watchdog timer.
+ *
+ ****************************************************************************/
+
+static void bench_wdentry(int argc, wdparm_t arg1, ...)
+{
+}
+
+static int bench_wdog(FAR struct bench_result_s *result)
+{
+  uint32_t start;
+  WDOG_ID wdog;
+  int i;
+
+  wdog = wd_create();
+  if (wdog == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  start = bench_gettime();
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      (void)wd_start(wdog, 100 * TICK_PER_SEC, bench_wdentry, 0);
+      (void)wd_cancel(wdog);
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = CONFIG_FS_PROCFS_BENCH_NITER;
+
+  (void)wd_delete(wdog);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_poll
+ *
+ * Description:
+ *   poll() a number of descriptors that are all ready.  This measures the
+ *   cost of setting up and tearing down the poll on each descriptor.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_BENCH_POLL
+static int bench_poll(FAR struct bench_result_s *result, int nfds)
+{
+  FAR struct pollfd *fds;
+  uint32_t start;
+  int ret = OK;
+  int fd;
+  int i;
+
+  fds = (FAR struct pollfd *)kmm_zalloc(nfds * sizeof(struct pollfd));
+  if (fds == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      fds[i].fd = -1;
+    }
+
+  fd = open("/dev/null", O_RDONLY);
+  for (i = 0; i < nfds && fd >= 0; i++)
+    {
+      fds[i].fd     = i == 0 ? fd : dup(fd);
+      fds[i].events = POLLIN;
+      if (fds[i].fd < 0)
+        {
+          break;
+        }
+    }
+
+  if (i < nfds)
+    {
+      ret = -EMFILE;
+      goto errout;
+    }
+
+  start = bench_gettime();
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      if (poll(fds, nfds, 0) < 0)
+        {
+          ret = -get_errno();
+          goto errout;
+        }
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = CONFIG_FS_PROCFS_BENCH_NITER;
+
+errout:
+  for (i = 0; i < nfds; i++)
+    {
+      if (fds[i].fd >= 0)
+        {
+          (void)close(fds[i].fd);
+        }
+    }
+
+  kmm_free(fds);
+  return ret;
+}
+
+static int bench_poll1(FAR struct bench_result_s *result)
+{
+  return bench_poll(result, 1);
+}
+
+static int bench_poll8(FAR struct bench_result_s *result)
+{
+  return bench_poll(result, 8);
+}
+
+static int bench_poll32(FAR struct bench_result_s *result)
+{
+  return bench_poll(result, 32);
+}
+#endif /* HAVE_BENCH_POLL */
+
+/****************************************************************************
+ * Name: bench_loaddr
+ ****************************************************************************/
+
+#if defined(HAVE_BENCH_UDP) || defined(HAVE_BENCH_TCP)
+static void bench_loaddr(FAR struct sockaddr_in *addr)
+{
+  memset(addr, 0, sizeof(struct sockaddr_in));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(BENCH_PORT);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_udp
+ *
+ * Description:
+ *   Send datagrams to ourselves through the loopback device.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_BENCH_UDP
+static int bench_udp(FAR struct bench_result_s *result)
+{
+  char pkt[BENCH_PKTSIZE];
+  struct sockaddr_in addr;
+  uint32_t start;
+  int ret = OK;
+  int sd;
+  int i;
+
+  sd = socket(PF_INET, SOCK_DGRAM, 0);
+  if (sd < 0)
+    {
+      return -get_errno();
+    }
+
+  bench_loaddr(&addr);
+  if (bind(sd, (FAR struct sockaddr *)&addr, sizeof(struct sockaddr_in)) < 0)
+    {
+      ret = -get_errno();
+      goto errout;
+    }
+
+  memset(pkt, 0x55, BENCH_PKTSIZE);
+
+  start = bench_gettime();
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      if (sendto(sd, pkt, BENCH_PKTSIZE, 0, (FAR struct sockaddr *)&addr,
+                 sizeof(struct sockaddr_in)) < 0 ||
+          recv(sd, pkt, BENCH_PKTSIZE, 0) < 0)
+        {
+          ret = -get_errno();
+          goto errout;
+        }
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = CONFIG_FS_PROCFS_BENCH_NITER;
+  result->nbytes  = CONFIG_FS_PROCFS_BENCH_NITER * BENCH_PKTSIZE;
+
+errout:
+  (void)close(sd);
+  return ret;
+}
+#endif /* HAVE_BENCH_UDP */
+
+/****************************************************************************
+ * Name: bench_tcpsource
+ *
+ * Description:
+ *   Helper thread for bench_tcp:  Connect to the listener and send the
+ *   data.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_BENCH_TCP
+static int bench_tcpsource(int argc, FAR char *argv[])
+{
+  char pkt[BENCH_PKTSIZE];
+  struct sockaddr_in addr;
+  ssize_t nsent;
+  int sd;
+  int i;
+
+  sd = socket(PF_INET, SOCK_STREAM, 0);
+  if (sd < 0)
+    {
+      g_bench.result = -get_errno();
+      goto errout;
+    }
+
+  bench_loaddr(&addr);
+  if (connect(sd, (FAR struct sockaddr *)&addr,
+              sizeof(struct sockaddr_in)) < 0)
+    {
+      g_bench.result = -get_errno();
+      goto errout_with_socket;
+    }
+
+  memset(pkt, 0x55, BENCH_PKTSIZE);
+  for (i = 0; i < CONFIG_FS_PROCFS_BENCH_NITER; i++)
+    {
+      nsent = send(sd, pkt, BENCH_PKTSIZE, 0);
+      if (nsent < 0)
+        {
+          g_bench.result = -get_errno();
+          break;
+        }
+    }
+
+errout_with_socket:
+  (void)close(sd);
+
+errout:
+  sem_post(&g_bench.done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_tcp
+ *
+ * Description:
+ *   Receive a stream of data from a helper thread through the loopback
+ *   device.  The time is measured from accept() until the helper closes
+ *   the connection.
+ *
+ ****************************************************************************/
+
+static int bench_tcp(FAR struct bench_result_s *result)
+{
+  char pkt[BENCH_PKTSIZE];
+  struct sockaddr_in addr;
+  socklen_t addrlen;
+  uint32_t nbytes = 0;
+  uint32_t start;
+  ssize_t nrecvd;
+  int listensd;
+  int sd;
+  int ret;
+
+  listensd = socket(PF_INET, SOCK_STREAM, 0);
+  if (listensd < 0)
+    {
+      return -get_errno();
+    }
+
+  bench_loaddr(&addr);
+  if (bind(listensd, (FAR struct sockaddr *)&addr,
+           sizeof(struct sockaddr_in)) < 0 ||
+      listen(listensd, 1) < 0)
+    {
+      ret = -get_errno();
+      goto errout;
+    }
+
+  ret = bench_spawn(bench_tcpsource, 0);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  addrlen = sizeof(struct sockaddr_in);
+  sd = accept(listensd, (FAR struct sockaddr *)&addr, &addrlen);
+  if (sd < 0)
+    {
+      ret = -get_errno();
+      (void)bench_join();
+      goto errout;
+    }
+
+  start = bench_gettime();
+  while ((nrecvd = recv(sd, pkt, BENCH_PKTSIZE, 0)) > 0)
+    {
+      nbytes += nrecvd;
+    }
+
+  result->elapsed = bench_gettime() - start;
+  result->ops     = nbytes / BENCH_PKTSIZE;
+  result->nbytes  = nbytes;
+
+  (void)close(sd);
+  ret = bench_join();
+
+errout:
+  (void)close(listensd);
+  return ret;
+}
+#endif /* HAVE_BENCH_TCP */
+
+/****************************************************************************
+ * Name: bench_fswrite and bench_fsread
+ *
+ * Description:
+ *   Write a file in CONFIG_FS_PROCFS_BENCH_FSPATH (i.e., on a FAT, SmartFS
+ *   or other volume mounted there) and read it back.  The benchmarks are
+ *   skipped if no path is configured.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_BENCH_FS
+static int bench_fsio(FAR struct bench_result_s *result, bool wr)
+{
+  char path[64];
+  uint32_t nbytes = 0;
+  uint32_t start;
+  ssize_t nxfrd;
+  int ret = OK;
+  int fd;
+
+  if (CONFIG_FS_PROCFS_BENCH_FSPATH[0] == '\0')
+    {
+      return -ENOSYS;
+    }
+
+  snprintf(path, sizeof(path), "%s/bench.tmp",
+           CONFIG_FS_PROCFS_BENCH_FSPATH);
+
+  start = bench_gettime();
+  if (wr)
+    {
+      fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    }
+  else
+    {
+      fd = open(path, O_RDONLY);
+    }
+
+  if (fd < 0)
+    {
+      return -get_errno();
+    }
+
+  while (nbytes < CONFIG_FS_PROCFS_BENCH_FSSIZE)
+    {
+      if (wr)
+        {
+          nxfrd = write(fd, g_bench_block, BENCH_BLKSIZE);
+        }
+      else
+        {
+          nxfrd = read(fd, g_bench_block, BENCH_BLKSIZE);
+        }
+
+      if (nxfrd <= 0)
+        {
+          ret = nxfrd < 0 ? -get_errno() : -ENODATA;
+          break;
+        }
+
+      nbytes += nxfrd;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (wr && ret == OK)
+    {
+      (void)fsync(fd);
+    }
+#endif
+
+  (void)close(fd);
+  result->elapsed = bench_gettime() - start;
+  result->ops     = nbytes / BENCH_BLKSIZE;
+  result->nbytes  = nbytes;
+
+  if (!wr || ret < 0)
+    {
+      (void)unlink(path);
+    }
+
+  return ret;
+}
+
+static int bench_fswrite(FAR struct bench_result_s *result)
+{
+  return bench_fsio(result, true);
+}
+
+static int bench_fsread(FAR struct bench_result_s *result)
+{
+  return bench_fsio(result, false);
+}
+#endif /* HAVE_BENCH_FS */
+
+/****************************************************************************
+ * Name: bench_run
+ *
+ * Description:
+ *   Run all benchmarks and format the results.  Each line holds the
+ *   number of operations, the average time per operation in nanoseconds
+ *   and in counts of the time base (cycles if there is a cycle counter,
+ *   otherwise microseconds), and the throughput in KiB per second for
+ *   transfers.
+ *
+ ****************************************************************************/
+
+static size_t bench_run(FAR char *line)
+{
+  struct bench_result_s result;
+  uint64_t nsec;
+  uint32_t freq = bench_getfreq();
+  size_t linesize;
+  int ret;
+  int i;
+
+  linesize = snprintf(line, BENCH_LINELEN, "%-9s %7s %10s %10s %10s\n",
+                      "TEST", "OPS", "NSEC/OP", "COUNT/OP", "KIB/S");
+
+  for (i = 0; i < BENCH_NCASES && i < BENCH_NTESTS; i++)
+    {
+      memset(&result, 0, sizeof(struct bench_result_s));
+
+      sem_init(&g_bench.sem[0], 0, 0);
+      sem_init(&g_bench.sem[1], 0, 0);
+      sem_init(&g_bench.done, 0, 0);
+      sem_setprotocol(&g_bench.sem[0], SEM_PRIO_NONE);
+      sem_setprotocol(&g_bench.sem[1], SEM_PRIO_NONE);
+      sem_setprotocol(&g_bench.done, SEM_PRIO_NONE);
+
+      ret = g_bench_cases[i].func(&result);
+
+      sem_destroy(&g_bench.sem[0]);
+      sem_destroy(&g_bench.sem[1]);
+      sem_destroy(&g_bench.done);
+
+      if (ret == -ENOSYS)
+        {
+          continue;
+        }
+      else if (ret < 0 || result.ops == 0)
+        {
+          linesize += snprintf(&line[linesize], BENCH_LINELEN,
+                               "%-9s error %d\n",
+                               g_bench_cases[i].name, ret);
+          continue;
+        }
+
+      nsec = (uint64_t)result.elapsed * NSEC_PER_SEC / freq;
+      linesize += snprintf(&line[linesize], BENCH_LINELEN,
+                           "%-9s %7lu %10lu %10lu %10lu\n",
+                           g_bench_cases[i].name,
+                           (unsigned long)result.ops,
+                           (unsigned long)(nsec / result.ops),
+                           (unsigned long)(result.elapsed / result.ops),
+                           nsec > 0 ? (unsigned long)
+                             (((uint64_t)result.nbytes * NSEC_PER_SEC /
+                               1024) / nsec) : 0ul);
+    }
+
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: bench_open
+ ****************************************************************************/
+
+static int bench_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct bench_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "bench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "bench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct bench_file_s *)
+    kmm_zalloc(sizeof(struct bench_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_close
+ ****************************************************************************/
+
+static int bench_close(FAR struct file *filep)
+{
+  FAR struct bench_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_read
+ *
+ * Description:
+ *   The benchmarks are run whenever a read starts at offset zero.  This
+ *   may take a while.
+ *
+ ****************************************************************************/
+
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct bench_file_s *attr;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bench_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* If f_pos is zero, then run the benchmarks.  Otherwise, return the
+   * results of the previous run.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      if (sem_wait(&g_bench.lock) < 0)
+        {
+          return -get_errno();
+        }
+
+      attr->linesize = bench_run(attr->line);
+      sem_post(&g_bench.lock);
+    }
+
+  /* Transfer the results to user receive buffer */
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(attr->line, attr->linesize, buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct bench_file_s *oldattr;
+  FAR struct bench_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct bench_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct bench_file_s *)
+    kmm_malloc(sizeof(struct bench_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct bench_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bench_stat(const char *relpath, struct stat *buf)
+{
+  /* "bench" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "bench") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "bench" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS_BENCH */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,519 @@
+/****************************************************************************
+ * fs/procfs/fs_procfscritmon.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_SCHED_CRITMONITOR) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_CRITMON)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define CRITMON_LINELEN 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct critmon_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  bool irqs;                    /* True: "irqs", false: "csection" */
+  char line[CRITMON_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+static int     critmon_relpath(FAR const char *relpath);
+static size_t  critmon_hist(FAR char *line, size_t linesize,
+                 FAR const uint32_t *hist);
+static size_t  critmon_header(FAR char *line, size_t linesize);
+
+/* File system methods */
+
+static int     critmon_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     critmon_close(FAR struct file *filep);
+static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t critmon_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     critmon_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations critmon_operations =
+{
+  critmon_open,       /* open */
+  critmon_close,      /* close */
+  critmon_read,       /* read */
+  critmon_write,      /* write */
+
+  critmon_dup,        /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  critmon_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_critmon_types[] =
+{
+  "CSECTION",                   /* CRITMON_CSECTION */
+  "PREEMPT"                     /* CRITMON_PREEMPTION */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critmon_relpath
+ *
+ * Description:
+ *   Return 1 for "irqs", 0 for "csection", and -ENOENT otherwise.
+ *
+ ****************************************************************************/
+
+static int critmon_relpath(FAR const char *relpath)
+{
+  if (strcmp(relpath, "irqs") == 0)
+    {
+      return 1;
+    }
+  else if (strcmp(relpath, "csection") == 0)
+    {
+      return 0;
+    }
+
+  ferr("ERROR: relpath is '%s'\n", relpath);
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: critmon_header and critmon_hist
+ *
+ * Description:
+ *   Append the labels or the counts of the histogram buckets to a line.
+ *
+ ****************************************************************************/
+
+static size_t critmon_header(FAR char *line, size_t linesize)
+{
+  char label[8];
+  int i;
+
+  for (i = 0; i < CRITMON_NBUCKETS - 1; i++)
+    {
+      snprintf(label, sizeof(label), "<%u", 1u << i);
+      linesize += snprintf(&line[linesize], CRITMON_LINELEN - linesize,
+                           " %6s", label);
+    }
+
+  snprintf(label, sizeof(label), ">=%u", 1u << (CRITMON_NBUCKETS - 2));
+  linesize += snprintf(&line[linesize], CRITMON_LINELEN - linesize,
+                       " %6s\n", label);
+  return linesize;
+}
+
+static size_t critmon_hist(FAR char *line, size_t linesize,
+                           FAR const uint32_t *hist)
+{
+  int i;
+
+  for (i = 0; i < CRITMON_NBUCKETS; i++)
+    {
+      linesize += snprintf(&line[linesize], CRITMON_LINELEN - linesize,
+                           " %6lu", (unsigned long)hist[i]);
+    }
+
+  linesize += snprintf(&line[linesize], CRITMON_LINELEN - linesize, "\n");
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: critmon_open
+ ****************************************************************************/
+
+static int critmon_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct critmon_file_s *attr;
+  int ret;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* "csection" and "irqs" are the only acceptable values for the relpath.
+   * Both may be opened for writing in order to reset the statistics.
+   */
+
+  ret = critmon_relpath(relpath);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct critmon_file_s *)
+    kmm_zalloc(sizeof(struct critmon_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  attr->irqs = (ret != 0);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critmon_close
+ ****************************************************************************/
+
+static int critmon_close(FAR struct file *filep)
+{
+  FAR struct critmon_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critmon_read
+ ****************************************************************************/
+
+static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct critmon_file_s *attr;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int index;
+  int type;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  remaining = buflen;
+  totalsize = 0;
+  offset    = filep->f_pos;
+
+  /* The header line, then one line per IRQ or per call site.  All times
+   * are in microseconds.
+   */
+
+  if (attr->irqs)
+    {
+      linesize = snprintf(attr->line, CRITMON_LINELEN,
+                          "%-4s %10s %12s %8s", "IRQ", "COUNT", "TIME",
+                          "MAX");
+    }
+  else
+    {
+      linesize = snprintf(attr->line, CRITMON_LINELEN,
+                          "%-8s %-18s %10s %8s", "TYPE", "CALLER", "COUNT",
+                          "MAX");
+    }
+
+  linesize   = critmon_header(attr->line, linesize);
+  copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (attr->irqs)
+    {
+      struct critmon_irq_s stats;
+
+      for (index = 0; index < NR_IRQS && totalsize < buflen; index++)
+        {
+          if (sched_critmon_getirq(index, &stats) < 0)
+            {
+              continue;
+            }
+
+          linesize   = snprintf(attr->line, CRITMON_LINELEN,
+                                "%-4d %10lu %12llu %8lu", index,
+                                (unsigned long)stats.count,
+                                (unsigned long long)stats.total,
+                                (unsigned long)stats.max);
+          linesize   = critmon_hist(attr->line, linesize, stats.hist);
+          copysize   = procfs_memcpy(attr->line, linesize, buffer,
+                                     remaining, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          remaining -= copysize;
+        }
+
+      /* Then the latencies from the start of each interrupt to the first
+       * run of the threads that its handler made ready-to-run.
+       */
+
+      linesize   = snprintf(attr->line, CRITMON_LINELEN,
+                            "\n%-4s %10s %12s %8s", "IRQ", "WAKEUPS", "",
+                            "LATMAX");
+      linesize   = critmon_header(attr->line, linesize);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+
+      for (index = 0; index < NR_IRQS && totalsize < buflen; index++)
+        {
+          if (sched_critmon_getirq(index, &stats) < 0 || stats.wakeups == 0)
+            {
+              continue;
+            }
+
+          linesize   = snprintf(attr->line, CRITMON_LINELEN,
+                                "%-4d %10lu %12s %8lu", index,
+                                (unsigned long)stats.wakeups, "",
+                                (unsigned long)stats.latmax);
+          linesize   = critmon_hist(attr->line, linesize, stats.lathist);
+          copysize   = procfs_memcpy(attr->line, linesize, buffer,
+                                     remaining, &offset);
+          totalsize += copysize;
+          buffer    += copysize;
+          remaining -= copysize;
+        }
+    }
+  else
+    {
+      struct critmon_site_s site;
+
+      for (type = CRITMON_CSECTION; type <= CRITMON_PREEMPTION; type++)
+        {
+          for (index = 0;
+               index <= CONFIG_SCHED_CRITMONITOR_NSITES && totalsize < buflen;
+               index++)
+            {
+              if (sched_critmon_getsite(type, index, &site) < 0)
+                {
+                  continue;
+                }
+
+              /* The last entry collects all callers that did not fit */
+
+              if (site.caller != NULL)
+                {
+                  linesize = snprintf(attr->line, CRITMON_LINELEN,
+                                      "%-8s %-18p", g_critmon_types[type],
+                                      site.caller);
+                }
+              else
+                {
+                  linesize = snprintf(attr->line, CRITMON_LINELEN,
+                                      "%-8s %-18s", g_critmon_types[type],
+                                      "other");
+                }
+
+              linesize  += snprintf(&attr->line[linesize],
+                                    CRITMON_LINELEN - linesize,
+                                    " %10lu %8lu",
+                                    (unsigned long)site.count,
+                                    (unsigned long)site.max);
+              linesize   = critmon_hist(attr->line, linesize, site.hist);
+              copysize   = procfs_memcpy(attr->line, linesize, buffer,
+                                         remaining, &offset);
+              totalsize += copysize;
+              buffer    += copysize;
+              remaining -= copysize;
+            }
+        }
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: critmon_write
+ *
+ * Description:
+ *   Any write discards all statistics.
+ *
+ ****************************************************************************/
+
+static ssize_t critmon_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  sched_critmon_reset();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: critmon_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int critmon_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct critmon_file_s *oldattr;
+  FAR struct critmon_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct critmon_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct critmon_file_s *)
+    kmm_malloc(sizeof(struct critmon_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct critmon_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critmon_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int critmon_stat(const char *relpath, struct stat *buf)
+{
+  int ret;
+
+  ret = critmon_relpath(relpath);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Both are regular files that may be written to reset the statistics */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_SCHED_CRITMONITOR && !CONFIG_FS_PROCFS_EXCLUDE_CRITMON */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,418 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheap.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_MM_PROFILE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAP_LINELEN 96
+
+/* The heap that is profiled:  The kernel heap if there is one */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+#  define HEAP_PROFILED (&g_kmmheap)
+#else
+#  define HEAP_PROFILED (&g_mmheap)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file".  The heap is walked when the
+ * file is opened so that all reads see the same snapshot.
+ */
+
+struct heap_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  int nsites;                     /* Number of valid entries in sites[] */
+  struct mm_profsite_s sites[CONFIG_FS_PROCFS_HEAP_NSITES];
+  struct mm_fraginfo_s frag;      /* Free chunks by bin */
+  char line[HEAP_LINELEN];        /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+static size_t  heap_binsize(int bin);
+
+/* File system methods */
+
+static int     heap_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heap_close(FAR struct file *filep);
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heap_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heap_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heap_operations =
+{
+  heap_open,      /* open */
+  heap_close,     /* close */
+  heap_read,      /* read */
+  NULL,           /* write */
+  heap_dup,       /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  heap_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heap_binsize
+ *
+ * Description:
+ *   Return the smallest chunk size that goes into a mm_nodelist[] bin.
+ *
+ ****************************************************************************/
+
+static size_t heap_binsize(int bin)
+{
+#ifdef CONFIG_MM_SEGFIT
+  size_t base = (size_t)MM_MIN_CHUNK << (bin / MM_NSLBINS);
+
+  return base + (bin % MM_NSLBINS) * (base >> CONFIG_MM_SEGFIT_SLBITS);
+#else
+  return (size_t)MM_MIN_CHUNK << bin;
+#endif
+}
+
+/****************************************************************************
+ * Name: heap_open
+ ****************************************************************************/
+
+static int heap_open(FAR struct file *filep, FAR const char *relpath,
+                     int oflags, mode_t mode)
+{
+  FAR struct heap_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "heap" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heap") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct heap_file_s *)kmm_zalloc(sizeof(struct heap_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take the snapshot of the heap */
+
+  attr->nsites = mm_profile(HEAP_PROFILED, attr->sites,
+                            CONFIG_FS_PROCFS_HEAP_NSITES);
+  (void)mm_fraginfo(HEAP_PROFILED, &attr->frag);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_close
+ ****************************************************************************/
+
+static int heap_close(FAR struct file *filep)
+{
+  FAR struct heap_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_read
+ ****************************************************************************/
+
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct heap_file_s *attr;
+  FAR struct mm_profsite_s *site;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  remaining = buflen;
+  totalsize = 0;
+  offset    = filep->f_pos;
+
+  /* The live allocations by call site */
+
+  linesize   = snprintf(attr->line, HEAP_LINELEN,
+                        "%-18s %7s %10s %10s %10s %10s %5s\n",
+                        "CALLER", "ALLOCS", "REQUESTED", "CHUNKS",
+                        "OLDEST", "NEWEST", "PID");
+  copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  for (i = 0; i < attr->nsites && totalsize < buflen; i++)
+    {
+      site = &attr->sites[i];
+
+      if (site->caller != NULL)
+        {
+          linesize = snprintf(attr->line, HEAP_LINELEN, "%-18p",
+                              site->caller);
+        }
+      else
+        {
+          linesize = snprintf(attr->line, HEAP_LINELEN, "%-18s", "other");
+        }
+
+      linesize  += snprintf(&attr->line[linesize], HEAP_LINELEN - linesize,
+                            " %7lu %10lu %10lu %10lu %10lu %5d\n",
+                            (unsigned long)site->nallocs,
+                            (unsigned long)site->reqbytes,
+                            (unsigned long)site->chunkbytes,
+                            (unsigned long)site->minseq,
+                            (unsigned long)site->maxseq,
+                            (int)site->pid);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  /* Then the fragmentation of the free memory */
+
+  linesize   = snprintf(attr->line, HEAP_LINELEN,
+                        "\nFree: %lu bytes in %lu chunks, largest %lu, "
+                        "cached %lu\n",
+                        (unsigned long)attr->frag.fbytes,
+                        (unsigned long)attr->frag.nfree,
+                        (unsigned long)attr->frag.largest,
+                        (unsigned long)attr->frag.ncached);
+  copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  linesize   = snprintf(attr->line, HEAP_LINELEN, "%10s %7s %10s\n",
+                        "BIN>=", "CHUNKS", "BYTES");
+  copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                             &offset);
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  for (i = 0; i < MM_NBINS && totalsize < buflen; i++)
+    {
+      if (attr->frag.nchunks[i] == 0)
+        {
+          continue;
+        }
+
+      linesize   = snprintf(attr->line, HEAP_LINELEN, "%10lu %7lu %10lu\n",
+                            (unsigned long)heap_binsize(i),
+                            (unsigned long)attr->frag.nchunks[i],
+                            (unsigned long)attr->frag.nbytes[i]);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer, remaining,
+                                 &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heap_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heap_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heap_file_s *oldattr;
+  FAR struct heap_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heap_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct heap_file_s *)kmm_malloc(sizeof(struct heap_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes (and the snapshot) from the old
+   * attributes to the new
+   */
+
+  memcpy(newattr, oldattr, sizeof(struct heap_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heap_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "heap" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "heap") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "heap" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_MM_PROFILE && !CONFIG_FS_PROCFS_EXCLUDE_HEAP */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -0,0 +1,452 @@
+/****************************************************************************
+ * fs/procfs/fs_procfssnapshot.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#ifdef CONFIG_NET_STATISTICS
+#  include <nuttx/net/netstats.h>
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct snapshot_file_s
+{
+  struct procfs_file_s  base;        /* Base open file structure */
+  struct procfs_snapshot_s snap;     /* The last sample taken */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Helpers */
+
+static void    snapshot_task(FAR struct tcb_s *tcb, FAR void *arg);
+static void    snapshot_heap(FAR struct procfs_snapheap_s *heap,
+                 FAR struct mallinfo *mem);
+static void    snapshot_sample(FAR struct procfs_snapshot_s *snap);
+
+/* File system methods */
+
+static int     snapshot_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     snapshot_close(FAR struct file *filep);
+static ssize_t snapshot_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     snapshot_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     snapshot_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations snapshot_operations =
+{
+  snapshot_open,     /* open */
+  snapshot_close,    /* close */
+  snapshot_read,     /* read */
+  NULL,              /* write */
+
+  snapshot_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  snapshot_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: snapshot_task
+ *
+ * Description:
+ *   sched_foreach() callback:  Add one task to the snapshot.  This runs
+ *   in a critical section, so the set of tasks cannot change while the
+ *   snapshot is being taken.
+ *
+ ****************************************************************************/
+
+static void snapshot_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct procfs_snapshot_s *snap = (FAR struct procfs_snapshot_s *)arg;
+  FAR struct procfs_snaptask_s *task;
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+
+  if (snap->ss_ntasks >= CONFIG_MAX_TASKS)
+    {
+      return;
+    }
+
+  task               = &snap->ss_tasks[snap->ss_ntasks++];
+  task->st_pid       = tcb->pid;
+  task->st_state     = tcb->task_state;
+  task->st_priority  = tcb->sched_priority;
+  task->st_flags     = tcb->flags;
+  task->st_stacksize = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+  task->st_stackused = up_check_tcbstack(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD
+  if (clock_cpuload(tcb->pid, &cpuload) == OK)
+    {
+      task->st_cpuactive = cpuload.active;
+      snap->ss_cputotal  = cpuload.total;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: snapshot_heap
+ ****************************************************************************/
+
+static void snapshot_heap(FAR struct procfs_snapheap_s *heap,
+                          FAR struct mallinfo *mem)
+{
+  heap->sh_arena    = mem->arena;
+  heap->sh_ordblks  = mem->ordblks;
+  heap->sh_mxordblk = mem->mxordblk;
+  heap->sh_uordblks = mem->uordblks;
+  heap->sh_fordblks = mem->fordblks;
+}
+
+/****************************************************************************
+ * Name: snapshot_sample
+ *
+ * Description:
+ *   Take one sample of all counters.
+ *
+ ****************************************************************************/
+
+static void snapshot_sample(FAR struct procfs_snapshot_s *snap)
+{
+  struct mallinfo mem;
+
+  memset(snap, 0, sizeof(struct procfs_snapshot_s));
+  snap->ss_version = PROCFS_SNAPSHOT_VERSION;
+  snap->ss_systime = (uint32_t)clock_systimer();
+
+  /* Tasks and CPU load */
+
+  sched_foreach(snapshot_task, snap);
+
+  /* Heaps */
+
+#if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_BUILD_KERNEL)
+#ifdef CONFIG_CAN_PASS_STRUCTS
+  mem = mallinfo();
+#else
+  (void)mallinfo(&mem);
+#endif
+  snapshot_heap(&snap->ss_umm, &mem);
+#endif
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+#ifdef CONFIG_CAN_PASS_STRUCTS
+  mem = kmm_mallinfo();
+#else
+  (void)kmm_mallinfo(&mem);
+#endif
+  snapshot_heap(&snap->ss_kmm, &mem);
+#endif
+
+  UNUSED(mem);
+
+  /* Network */
+
+#ifdef CONFIG_NET_STATISTICS
+#ifdef CONFIG_NET_IPv4
+  snap->ss_ipv4.sn_recv = g_netstats.ipv4.recv;
+  snap->ss_ipv4.sn_sent = g_netstats.ipv4.sent;
+  snap->ss_ipv4.sn_drop = g_netstats.ipv4.drop;
+#endif
+#ifdef CONFIG_NET_IPv6
+  snap->ss_ipv6.sn_recv = g_netstats.ipv6.recv;
+  snap->ss_ipv6.sn_sent = g_netstats.ipv6.sent;
+  snap->ss_ipv6.sn_drop = g_netstats.ipv6.drop;
+#endif
+#ifdef CONFIG_NET_ICMP
+  snap->ss_icmp.sn_recv = g_netstats.icmp.recv;
+  snap->ss_icmp.sn_sent = g_netstats.icmp.sent;
+  snap->ss_icmp.sn_drop = g_netstats.icmp.drop;
+#endif
+#ifdef CONFIG_NET_TCP
+  snap->ss_tcp.sn_recv  = g_netstats.tcp.recv;
+  snap->ss_tcp.sn_sent  = g_netstats.tcp.sent;
+  snap->ss_tcp.sn_drop  = g_netstats.tcp.drop;
+#endif
+#ifdef CONFIG_NET_UDP
+  snap->ss_udp.sn_recv  = g_netstats.udp.recv;
+  snap->ss_udp.sn_sent  = g_netstats.udp.sent;
+  snap->ss_udp.sn_drop  = g_netstats.udp.drop;
+#endif
+#endif
+}
+
+/****************************************************************************
+ * Name: snapshot_open
+ ****************************************************************************/
+
+static int snapshot_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct snapshot_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "snapshot" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "snapshot") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct snapshot_file_s *)
+    kmm_zalloc(sizeof(struct snapshot_file_s));
+
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_close
+ ****************************************************************************/
+
+static int snapshot_close(FAR struct file *filep)
+{
+  FAR struct snapshot_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct snapshot_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_read
+ *
+ * Description:
+ *   Return the binary snapshot.  A new sample is taken whenever the read
+ *   starts at offset zero so that a monitor may keep the file open and
+ *   just lseek() back to the beginning before each read.
+ *
+ ****************************************************************************/
+
+static ssize_t snapshot_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct snapshot_file_s *attr;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct snapshot_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* If f_pos is zero, then take a new sample.  Otherwise, continue to
+   * return the sample taken by the previous read().
+   */
+
+  if (filep->f_pos == 0)
+    {
+      snapshot_sample(&attr->snap);
+    }
+
+  /* Transfer the snapshot to user receive buffer */
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy((FAR const char *)&attr->snap,
+                         sizeof(struct procfs_snapshot_s),
+                         buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snapshot_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int snapshot_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct snapshot_file_s *oldattr;
+  FAR struct snapshot_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct snapshot_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct snapshot_file_s *)
+    kmm_malloc(sizeof(struct snapshot_file_s));
+
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct snapshot_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int snapshot_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "snapshot" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "snapshot") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "snapshot" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  buf->st_size = sizeof(struct procfs_snapshot_s);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_FS_PROCFS_SNAPSHOT */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -401,6 +401,20 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* If the media is directly accessible, just copy the data.  There is no
+   * need to go through the block driver or the file sector buffer.
+   */
+
+  if (rm->rm_xipbase)
+    {
+      memcpy(userbuffer, rm->rm_xipbase + rf->rf_startoffset + filep->f_pos,
+             buflen);
+
+      filep->f_pos += buflen;
+      romfs_semgive(rm);
+      return buflen;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
@@ -1015,6 +1029,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  /* Build the directory index.  Failure is not fatal:  Directories will
+   * just be searched on the media.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fwarn("WARNING: romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (FAR void *)rm;
@@ -1100,6 +1126,10 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
       /* Release the mountpoint private data */
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+      romfs_freeindex(rm);
+#endif
+
       if (!rm->rm_xipbase && rm->rm_buffer)
         {
           kmm_free(rm->rm_buffer);
@@ -125,10 +125,35 @@
 
 #define ROMF_MAX_LINKS 64
 
+/* Marks the end of a directory index hash chain */
+
+#define ROMFS_INDEX_NONE 0xffffffff
+
+/* The index array is grown by this many entries at a time while it is
+ * built.
+ */
+
+#define ROMFS_INDEX_ALLOCGUARD 32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one directory entry in the mount-time directory
+ * index.  Only the hash of the name is kept; the name is verified on the
+ * media.
+ */
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+struct romfs_index_s
+{
+  uint32_t ri_dirofs;               /* Offset to the first entry in the parent directory */
+  uint32_t ri_offset;               /* Offset to the file header of this entry */
+  uint32_t ri_hash;                 /* Hash of the parent directory and the name */
+  uint32_t ri_flink;                /* Index of the next entry in the hash chain */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -149,6 +174,11 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_INDEX
+  FAR struct romfs_index_s *rm_index; /* Directory index (NULL if not available) */
+  FAR uint32_t *rm_buckets;         /* Index hash chain heads */
+  uint32_t rm_nindex;               /* Number of entries (and buckets) in the index */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -223,6 +253,10 @@ int  romfs_parsefilename(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR char *pname);
 int  romfs_datastart(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_INDEX
+int  romfs_buildindex(FAR struct romfs_mountpt_s *rm);
+void romfs_freeindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
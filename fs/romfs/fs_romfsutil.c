@@ -277,6 +277,79 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_namehash
+ *
+ * Desciption:
+ *   Return the FNV-1a hash of a name, seeded with the offset of the
+ *   directory that contains it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static uint32_t romfs_namehash(uint32_t dirofs, const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u ^ dirofs;
+
+  while (namelen-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Desciption:
+ *   This is part of the romfs_finddirentry log.  Use the directory index to
+ *   find entryname in the directory beginning at dirinfo->fr_firstoffset.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+static int romfs_searchindex(struct romfs_mountpt_s *rm,
+                             const char *entryname, int entrylen,
+                             struct romfs_dirinfo_s *dirinfo)
+{
+  FAR struct romfs_index_s *entry;
+  uint32_t dirofs;
+  uint32_t hash;
+  uint32_t i;
+  int ret;
+
+  dirofs = dirinfo->rd_dir.fr_firstoffset;
+  hash   = romfs_namehash(dirofs, entryname, entrylen);
+
+  for (i = rm->rm_buckets[hash % rm->rm_nindex];
+       i != ROMFS_INDEX_NONE;
+       i = entry->ri_flink)
+    {
+      entry = &rm->rm_index[i];
+      if (entry->ri_hash == hash && entry->ri_dirofs == dirofs)
+        {
+          /* Verify the name on the media */
+
+          ret = romfs_checkentry(rm, entry->ri_offset, entryname, entrylen,
+                                 dirinfo);
+          if (ret != -ENOENT)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* The index is complete:  There is nothing in this directory with that
+   * name.
+   */
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -295,6 +368,15 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_INDEX
+  /* Use the directory index if one was built when the volume was mounted */
+
+  if (rm->rm_index != NULL)
+    {
+      return romfs_searchindex(rm, entryname, entrylen, dirinfo);
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -963,3 +1045,191 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Desciption:
+ *   Walk the whole directory tree of the mounted volume and build the
+ *   directory index used by romfs_finddirentry().  On failure, no index
+ *   is built and directories are searched on the media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+int romfs_buildindex(struct romfs_mountpt_s *rm)
+{
+  FAR struct romfs_index_s *index = NULL;
+  FAR struct romfs_index_s *newindex;
+  FAR uint32_t *buckets;
+  char     name[NAME_MAX+1];
+  uint32_t maxindex;
+  uint32_t nalloc = 0;
+  uint32_t nindex = 0;
+  uint32_t cursor = 0;
+  uint32_t dirofs;
+  uint32_t offset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t i;
+  int16_t  ndx;
+  int      ret;
+
+  /* Every file header occupies at least 32 bytes of the volume.  Anything
+   * more than that means that the directory structure is corrupted.
+   */
+
+  maxindex = rm->rm_volsize / 32;
+
+  /* Walk the tree breadth-first.  The index array is also the work queue:
+   * Until the hash chains are built, ri_flink holds the first entry offset
+   * of each sub-directory that still must be added.
+   */
+
+  dirofs = rm->rm_rootoffset;
+  for (; ; )
+    {
+      /* Add every entry in the directory that begins at dirofs */
+
+      offset = dirofs;
+      do
+        {
+          ndx = romfs_devcacheread(rm, offset);
+          if (ndx < 0)
+            {
+              ret = ndx;
+              goto errout;
+            }
+
+          next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT);
+          info = romfs_devread32(rm, ndx + ROMFS_FHDR_INFO);
+
+          ret = romfs_parsefilename(rm, offset, name);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (nindex >= nalloc)
+            {
+              if (nindex >= maxindex)
+                {
+                  ret = -EINVAL;
+                  goto errout;
+                }
+
+              nalloc  += ROMFS_INDEX_ALLOCGUARD;
+              newindex = (FAR struct romfs_index_s *)
+                kmm_realloc(index, nalloc * sizeof(struct romfs_index_s));
+              if (newindex == NULL)
+                {
+                  ret = -ENOMEM;
+                  goto errout;
+                }
+
+              index = newindex;
+            }
+
+          index[nindex].ri_dirofs = dirofs;
+          index[nindex].ri_offset = offset;
+          index[nindex].ri_hash   = romfs_namehash(dirofs, name,
+                                                   strlen(name));
+
+          /* Queue real sub-directories.  Hard links (such as "..") and
+           * the root's own "." entry refer to directories that are
+           * already queued.
+           */
+
+          index[nindex].ri_flink  =
+            (IS_DIRECTORY(next) && info != dirofs) ? info : 0;
+          nindex++;
+
+          offset = next & RFNEXT_OFFSETMASK;
+        }
+      while (offset != 0);
+
+      /* Go on to the next queued sub-directory */
+
+      while (cursor < nindex && index[cursor].ri_flink == 0)
+        {
+          cursor++;
+        }
+
+      if (cursor >= nindex)
+        {
+          break;
+        }
+
+      dirofs = index[cursor++].ri_flink;
+    }
+
+  /* Now build the hash chains, one bucket per entry */
+
+  buckets = (FAR uint32_t *)kmm_malloc(nindex * sizeof(uint32_t));
+  if (buckets == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (i = 0; i < nindex; i++)
+    {
+      buckets[i] = ROMFS_INDEX_NONE;
+    }
+
+  for (i = 0; i < nindex; i++)
+    {
+      uint32_t bucket = index[i].ri_hash % nindex;
+
+      index[i].ri_flink = buckets[bucket];
+      buckets[bucket]   = i;
+    }
+
+  /* Release the unused part of the index array */
+
+  newindex = (FAR struct romfs_index_s *)
+    kmm_realloc(index, nindex * sizeof(struct romfs_index_s));
+  if (newindex != NULL)
+    {
+      index = newindex;
+    }
+
+  finfo("Indexed %lu directory entries\n", (unsigned long)nindex);
+
+  rm->rm_index   = index;
+  rm->rm_buckets = buckets;
+  rm->rm_nindex  = nindex;
+  return OK;
+
+errout:
+  if (index != NULL)
+    {
+      kmm_free(index);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: romfs_freeindex
+ *
+ * Desciption:
+ *   Free the directory index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_INDEX
+void romfs_freeindex(struct romfs_mountpt_s *rm)
+{
+  if (rm->rm_index != NULL)
+    {
+      kmm_free(rm->rm_index);
+      kmm_free(rm->rm_buckets);
+
+      rm->rm_index   = NULL;
+      rm->rm_buckets = NULL;
+      rm->rm_nindex  = 0;
+    }
+}
+#endif
@@ -71,6 +71,12 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+/* The chunk table is allocated in units of this many entries so that it
+ * does not have to be reallocated each time a chunk is added.
+ */
+
+#define TMPFS_CHUNKTAB_GUARD 8
+
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -95,6 +101,7 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
               size_t newsize);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -326,10 +333,11 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
     }
 
   /* Added some additional amount to the new size to account frequent
-   * reallocations.
+   * reallocations.  The directory grows geometrically.
    */
 
-  objsize += CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD;
+  objsize = mm_growsize(oldtdo->tdo_alloc,
+                        objsize + CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD);
 
   /* Realloc the directory object */
 
@@ -364,6 +372,96 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+                              size_t newsize)
+{
+  FAR struct tmpfs_file_s *file = *tfo;
+  FAR uint8_t **chunks;
+  FAR uint8_t *chunk;
+  size_t nchunks;
+  size_t ntab;
+  size_t offset;
+  size_t i;
+
+  /* The file object itself never moves.  Only the chunk table is resized. */
+
+  nchunks = TMPFS_NCHUNKS(newsize);
+
+  /* Free any chunks that lie wholly beyond the new end of the file */
+
+  for (i = nchunks; i < file->tfo_nchunks; i++)
+    {
+      if (file->tfo_chunks[i] != NULL)
+        {
+          kmm_free(file->tfo_chunks[i]);
+          file->tfo_chunks[i] = NULL;
+          file->tfo_alloc -= CONFIG_FS_TMPFS_CHUNKSIZE;
+        }
+    }
+
+  /* If the file is shrinking into the middle of a chunk, zero the tail of
+   * that chunk so that it reads back as zero if the file is later extended.
+   */
+
+  if (newsize < file->tfo_size)
+    {
+      offset = newsize % CONFIG_FS_TMPFS_CHUNKSIZE;
+      if (offset > 0)
+        {
+          chunk = file->tfo_chunks[nchunks - 1];
+          if (chunk != NULL)
+            {
+              memset(&chunk[offset], 0, CONFIG_FS_TMPFS_CHUNKSIZE - offset);
+            }
+        }
+    }
+
+  /* Resize the chunk table if it is too small or much too large.  New
+   * entries are holes.
+   */
+
+  ntab = (nchunks + TMPFS_CHUNKTAB_GUARD - 1) & ~(TMPFS_CHUNKTAB_GUARD - 1);
+  if (ntab == 0)
+    {
+      if (file->tfo_chunks != NULL)
+        {
+          kmm_free(file->tfo_chunks);
+          file->tfo_alloc  -= file->tfo_nchunks * sizeof(FAR uint8_t *);
+          file->tfo_chunks  = NULL;
+          file->tfo_nchunks = 0;
+        }
+    }
+  else if (ntab > file->tfo_nchunks ||
+           ntab + TMPFS_CHUNKTAB_GUARD < file->tfo_nchunks)
+    {
+      chunks = (FAR uint8_t **)
+        kmm_realloc(file->tfo_chunks, ntab * sizeof(FAR uint8_t *));
+      if (chunks != NULL)
+        {
+          for (i = file->tfo_nchunks; i < ntab; i++)
+            {
+              chunks[i] = NULL;
+            }
+
+          file->tfo_alloc  -= file->tfo_nchunks * sizeof(FAR uint8_t *);
+          file->tfo_alloc  += ntab * sizeof(FAR uint8_t *);
+          file->tfo_chunks  = chunks;
+          file->tfo_nchunks = ntab;
+        }
+
+      /* Failing to shrink the table is harmless */
+
+      else if (ntab > file->tfo_nchunks)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  file->tfo_size = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
                               size_t newsize)
 {
@@ -388,9 +486,15 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
       if (newsize > 0)
         {
           /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
+           * lot.  A file that grows within its allocation is not shrunk.
            */
 
+          if (newsize >= oldtfo->tfo_size)
+            {
+              oldtfo->tfo_size = newsize;
+              return OK;
+            }
+
           delta = oldtfo->tfo_alloc - objsize;
           if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
             {
@@ -403,10 +507,14 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
     }
 
   /* Added some additional amount to the new size to account frequent
-   * reallocations.
+   * reallocations.  A growing file grows geometrically.
    */
 
   allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  if (objsize > oldtfo->tfo_alloc)
+    {
+      allocsize = mm_growsize(oldtfo->tfo_alloc, allocsize);
+    }
 
   /* Realloc the file object */
 
@@ -428,6 +536,7 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
   *tfo              = newtfo;
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -464,8 +573,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      sem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -477,6 +585,35 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     }
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  size_t i;
+
+  /* Free all of the file data chunks and the chunk table */
+
+  for (i = 0; i < tfo->tfo_nchunks; i++)
+    {
+      if (tfo->tfo_chunks[i] != NULL)
+        {
+          kmm_free(tfo->tfo_chunks[i]);
+        }
+    }
+
+  if (tfo->tfo_chunks != NULL)
+    {
+      kmm_free(tfo->tfo_chunks);
+    }
+#endif
+
+  sem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
+}
+
 /****************************************************************************
  * Name: tmpfs_find_dirent
  ****************************************************************************/
@@ -631,6 +768,10 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
   tfo->tfo_refs  = 1;
   tfo->tfo_flags = 0;
   tfo->tfo_size  = 0;
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_chunks  = NULL;
+#endif
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -746,8 +887,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
 /* Error exits */
 
 errout_with_file:
-  sem_destroy(&newtfo->tfo_exclsem.ts_sem);
-  kmm_free(newtfo);
+  tmpfs_free_file(newtfo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -1264,6 +1404,11 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           tfo->tfo_flags |= TFO_FLAG_UNLINKED;
           return TMPFS_UNLINKED;
         }
+
+      /* No.. free the file object and its data now */
+
+      tmpfs_free_file(tfo);
+      return TMPFS_DELETED;
     }
 
   /* Free the object now */
@@ -1532,7 +1677,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1550,6 +1695,13 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  FAR uint8_t *chunk;
+  size_t remaining;
+  size_t offset;
+  size_t ncopy;
+  off_t pos;
+#endif
   ssize_t nread;
   off_t startpos;
   off_t endpos;
@@ -1572,7 +1724,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1580,7 +1736,36 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  for (pos = startpos, remaining = nread; remaining > 0; )
+    {
+      offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+      ncopy  = CONFIG_FS_TMPFS_CHUNKSIZE - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      /* Holes in the file read as zero */
+
+      chunk = tfo->tfo_chunks[pos / CONFIG_FS_TMPFS_CHUNKSIZE];
+      if (chunk == NULL)
+        {
+          memset(buffer, 0, ncopy);
+        }
+      else
+        {
+          memcpy(buffer, &chunk[offset], ncopy);
+        }
+
+      buffer    += ncopy;
+      pos       += ncopy;
+      remaining -= ncopy;
+    }
+#else
   memcpy(buffer, &tfo->tfo_data[startpos], nread);
+#endif
+
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1597,9 +1782,17 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  FAR uint8_t **pchunk;
+  size_t remaining;
+  size_t offset;
+  size_t ncopy;
+  off_t pos;
+#endif
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  off_t oldsize;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1619,6 +1812,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   startpos = filep->f_pos;
   nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1633,9 +1827,68 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
       filep->f_priv = tfo;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
+
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  for (pos = startpos, remaining = nwritten; remaining > 0; )
+    {
+      offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+      ncopy  = CONFIG_FS_TMPFS_CHUNKSIZE - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      /* Allocate the chunk if this is the first write into a hole */
+
+      pchunk = &tfo->tfo_chunks[pos / CONFIG_FS_TMPFS_CHUNKSIZE];
+      if (*pchunk == NULL)
+        {
+          *pchunk = (FAR uint8_t *)kmm_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+          if (*pchunk == NULL)
+            {
+              /* Don't leave the file extended past the data that was
+               * actually written.
+               */
+
+              if (endpos > oldsize)
+                {
+                  (void)tmpfs_realloc_file(&tfo,
+                                           pos > oldsize ? pos : oldsize);
+                }
+
+              nwritten = pos - startpos;
+              if (nwritten == 0)
+                {
+                  ret = -ENOMEM;
+                  goto errout_with_lock;
+                }
+
+              break;
+            }
+
+          tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+        }
+
+      memcpy(&(*pchunk)[offset], buffer, ncopy);
+
+      buffer    += ncopy;
+      pos       += ncopy;
+      remaining -= ncopy;
+    }
+#else
+  /* If the write starts beyond the old end of the file, the gap reads as
+   * zero.
+   */
+
+  if (startpos > oldsize)
+    {
+      memset(&tfo->tfo_data[oldsize], 0, startpos - oldsize);
+    }
 
   memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+#endif
+
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1722,7 +1975,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Recover our private data from the struct file instance */
 
-  tfo = filep->f_inode->i_private;
+  tfo = filep->f_priv;
 
   DEBUGASSERT(tfo != NULL);
 
@@ -1730,12 +1983,49 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+      FAR uint8_t **pchunk;
+      int ret = -ENOTTY;
+
+      /* The file can be mapped in place only if it lies entirely within
+       * the first chunk.  Otherwise, mmap() must fall back to copying the
+       * file into RAM.
+       */
+
+      tmpfs_lock_file(tfo);
+      if (tfo->tfo_size > 0 && tfo->tfo_size <= CONFIG_FS_TMPFS_CHUNKSIZE)
+        {
+          pchunk = &tfo->tfo_chunks[0];
+          if (*pchunk == NULL)
+            {
+              *pchunk = (FAR uint8_t *)kmm_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+              if (*pchunk != NULL)
+                {
+                  tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+                }
+            }
+
+          if (*pchunk != NULL)
+            {
+              *ppv = (FAR void *)*pchunk;
+              ret  = OK;
+            }
+          else
+            {
+              ret  = -ENOMEM;
+            }
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
+#else
       /* Return the address on the media corresponding to the start of
        * the file.
        */
 
       *ppv = (FAR void *)tfo->tfo_data;
       return OK;
+#endif
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -2207,8 +2497,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      sem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
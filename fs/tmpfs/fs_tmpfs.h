@@ -54,6 +54,13 @@
 
 #define TMPFS_NO_HOLDER   -1
 
+/* Number of chunks needed to hold n bytes of file data */
+
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+#  define TMPFS_NCHUNKS(n) \
+     (((n) + CONFIG_FS_TMPFS_CHUNKSIZE - 1) / CONFIG_FS_TMPFS_CHUNKSIZE)
+#endif
+
 /* Bit definitions for file object flags */
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
@@ -137,6 +144,12 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * If CONFIG_FS_TMPFS_CHUNKED is selected, the file data is held in
+ * separately allocated chunks of CONFIG_FS_TMPFS_CHUNKSIZE bytes.  A NULL
+ * entry in the chunk table is a hole that reads as zero.  The file object
+ * then never moves and tfo_alloc also accounts for the chunk table and for
+ * all allocated chunks.
  */
 
 struct tmpfs_file_s
@@ -154,10 +167,19 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+  size_t   tfo_nchunks;  /* Number of entries in tfo_chunks[] */
+  FAR uint8_t **tfo_chunks; /* Table of file data chunks */
+#else
   uint8_t  tfo_data[1];  /* File data starts here */
+#endif
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#ifdef CONFIG_FS_TMPFS_CHUNKED
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s))
+#else
+#  define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#endif
 
 /* This structure represents one instance of a TMPFS file system */
 
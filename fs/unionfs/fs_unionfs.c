@@ -86,6 +86,19 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+#ifdef CONFIG_FS_UNIONFS_CACHE
+/* This structure describes one cached lookup:  Which of the contained file
+ * systems are known to hold, or known not to hold, something at uc_relpath.
+ */
+
+struct unionfs_cache_s
+{
+  FAR char *uc_relpath;              /* Relative path (NULL if unused) */
+  uint8_t uc_known;                  /* Bit n: Presence on fs n is known */
+  uint8_t uc_present;                /* Bit n: Something exists on fs n */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -94,6 +107,10 @@ struct unionfs_inode_s
   sem_t ui_exclsem;                  /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#ifdef CONFIG_FS_UNIONFS_CACHE
+  uint8_t ui_cachenext;              /* Next cache entry to replace */
+  struct unionfs_cache_s ui_cache[CONFIG_FS_UNIONFS_CACHE_NENTRIES];
+#endif
 };
 
 /* This structure descries one opened file */
@@ -142,6 +159,21 @@ static int     unionfs_trystatfile(FAR struct inode *inode,
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
 
+#ifdef CONFIG_FS_UNIONFS_CACHE
+static FAR struct unionfs_cache_s *
+               unionfs_cachefind(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static bool    unionfs_cacheabsent(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx);
+static void    unionfs_cacheupdate(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx, int ret);
+static void    unionfs_cachepurge(FAR struct unionfs_inode_s *ui);
+#else
+#  define      unionfs_cacheabsent(ui,relpath,ndx) false
+#  define      unionfs_cacheupdate(ui,relpath,ndx,ret)
+#  define      unionfs_cachepurge(ui)
+#endif
+
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
 
@@ -732,6 +764,154 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+/****************************************************************************
+ * Name: unionfs_cachefind
+ *
+ * Description:
+ *   Find the lookup cache entry for 'relpath', if there is one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_CACHE
+static FAR struct unionfs_cache_s *
+unionfs_cachefind(FAR struct unionfs_inode_s *ui, FAR const char *relpath)
+{
+  FAR struct unionfs_cache_s *uc;
+  int i;
+
+  if (relpath == NULL)
+    {
+      relpath = "";
+    }
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_CACHE_NENTRIES; i++)
+    {
+      uc = &ui->ui_cache[i];
+      if (uc->uc_relpath != NULL && strcmp(uc->uc_relpath, relpath) == 0)
+        {
+          return uc;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_cacheabsent
+ *
+ * Description:
+ *   Return true if file system 'ndx' is known to have nothing at
+ *   'relpath'.  The caller may then skip probing that file system.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_CACHE
+static bool unionfs_cacheabsent(FAR struct unionfs_inode_s *ui,
+                                FAR const char *relpath, int ndx)
+{
+  FAR struct unionfs_cache_s *uc;
+  uint8_t bit = (uint8_t)(1 << ndx);
+
+  uc = unionfs_cachefind(ui, relpath);
+  return (uc != NULL && (uc->uc_known & bit) != 0 &&
+          (uc->uc_present & bit) == 0);
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_cacheupdate
+ *
+ * Description:
+ *   Record the result of probing file system 'ndx' for 'relpath'.  Success
+ *   means that something exists at that path; -ENOENT means that nothing
+ *   does.  Any other result tells us nothing and is not recorded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_CACHE
+static void unionfs_cacheupdate(FAR struct unionfs_inode_s *ui,
+                                FAR const char *relpath, int ndx, int ret)
+{
+  FAR struct unionfs_cache_s *uc;
+  uint8_t bit = (uint8_t)(1 << ndx);
+
+  if (ret < 0 && ret != -ENOENT)
+    {
+      return;
+    }
+
+  if (relpath == NULL)
+    {
+      relpath = "";
+    }
+
+  uc = unionfs_cachefind(ui, relpath);
+  if (uc == NULL)
+    {
+      /* Replace the entries round-robin */
+
+      uc = &ui->ui_cache[ui->ui_cachenext];
+      if (++ui->ui_cachenext >= CONFIG_FS_UNIONFS_CACHE_NENTRIES)
+        {
+          ui->ui_cachenext = 0;
+        }
+
+      if (uc->uc_relpath != NULL)
+        {
+          kmm_free(uc->uc_relpath);
+        }
+
+      uc->uc_known   = 0;
+      uc->uc_present = 0;
+      uc->uc_relpath = strdup(relpath);
+      if (uc->uc_relpath == NULL)
+        {
+          return;
+        }
+    }
+
+  uc->uc_known |= bit;
+  if (ret >= 0)
+    {
+      uc->uc_present |= bit;
+    }
+  else
+    {
+      uc->uc_present &= ~bit;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_cachepurge
+ *
+ * Description:
+ *   Discard all lookup cache entries.  This must be called before anything
+ *   is created, removed or renamed through the union.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_CACHE
+static void unionfs_cachepurge(FAR struct unionfs_inode_s *ui)
+{
+  FAR struct unionfs_cache_s *uc;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_CACHE_NENTRIES; i++)
+    {
+      uc = &ui->ui_cache[i];
+      if (uc->uc_relpath != NULL)
+        {
+          kmm_free(uc->uc_relpath);
+          uc->uc_relpath = NULL;
+        }
+    }
+
+  ui->ui_cachenext = 0;
+}
+#endif
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -823,6 +1003,10 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       kmm_free(ui->ui_fs[1].um_prefix);
     }
 
+  /* Discard the lookup cache */
+
+  unionfs_cachepurge(ui);
+
   /* And finally free the allocated unionfs state structure as well */
 
   sem_destroy(&ui->ui_exclsem);
@@ -875,7 +1059,21 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   uf->uf_file.f_inode  = um->um_node;
   uf->uf_file.f_priv   = NULL;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+  /* Creating a file may change what exists in the union */
+
+  if ((oflags & O_CREAT) != 0)
+    {
+      unionfs_cachepurge(ui);
+    }
+
+  ret = -ENOENT;
+  if (!unionfs_cacheabsent(ui, relpath, 0))
+    {
+      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                            mode);
+      unionfs_cacheupdate(ui, relpath, 0, ret);
+    }
+
   if (ret >= 0)
     {
       /* Successfully opened on file system 1 */
@@ -893,7 +1091,14 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_file.f_inode  = um->um_node;
       uf->uf_file.f_priv   = NULL;
 
-      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+      ret = -ENOENT;
+      if (!unionfs_cacheabsent(ui, relpath, 1))
+        {
+          ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                oflags, mode);
+          unionfs_cacheupdate(ui, relpath, 1, ret);
+        }
+
       if (ret < 0)
         {
           goto errout_with_semaphore;
@@ -1422,7 +1627,14 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   um = &ui->ui_fs[1];
   lowerdir->fd_root = um->um_node;
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, lowerdir);
+  ret = -ENOENT;
+  if (!unionfs_cacheabsent(ui, relpath, 1))
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               lowerdir);
+      unionfs_cacheupdate(ui, relpath, 1, ret);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 2 access info */
@@ -1456,7 +1668,14 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   um = &ui->ui_fs[0];
   lowerdir->fd_root = um->um_node;
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, lowerdir);
+  ret = -ENOENT;
+  if (!unionfs_cacheabsent(ui, relpath, 0))
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               lowerdir);
+      unionfs_cacheupdate(ui, relpath, 0, ret);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 1 access info */
@@ -2135,6 +2354,10 @@ static int unionfs_unlink(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* Anything cached about the union contents may become stale */
+
+  unionfs_cachepurge(ui);
+
   /* Check if some exists at this path on file system 1.  This might be
    * a file or a directory
    */
@@ -2207,6 +2430,10 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+  /* Anything cached about the union contents may become stale */
+
+  unionfs_cachepurge(ui);
+
   /* Is there anything with this name on either file system? */
 
   um  = &ui->ui_fs[0];
@@ -2280,6 +2507,10 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       return ret;
     }
 
+  /* Anything cached about the union contents may become stale */
+
+  unionfs_cachepurge(ui);
+
   ret = -ENOENT;
 
   /* We really don't know any better so we will try to remove the directory
@@ -2355,6 +2586,10 @@ static int unionfs_rename(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* Anything cached about the union contents may become stale */
+
+  unionfs_cachepurge(ui);
+
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
 
   /* Is there a file with this name on file system 1 */
@@ -2432,7 +2667,13 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   /* stat this path on file system 1 */
 
   um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = -ENOENT;
+  if (!unionfs_cacheabsent(ui, relpath, 0))
+    {
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      unionfs_cacheupdate(ui, relpath, 0, ret);
+    }
+
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
@@ -2446,7 +2687,13 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
   /* stat failed on the file system 1.  Try again on file system 2. */
 
   um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = -ENOENT;
+  if (!unionfs_cacheabsent(ui, relpath, 1))
+    {
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      unionfs_cacheupdate(ui, relpath, 1, ret);
+    }
+
   if (ret >= 0)
     {
       /* Return on the first success.  The first instance of the file will
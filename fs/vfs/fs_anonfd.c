@@ -0,0 +1,206 @@
+/****************************************************************************
+ * fs/vfs/fs_anonfd.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_ANONFD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: anonfd_allocate
+ *
+ * Description:
+ *   Allocate a file descriptor that refers to an unnamed inode.  The inode
+ *   is never part of the inode tree.  It is embedded at the beginning of an
+ *   object allocated with kmm_malloc() and is marked as deleted so that
+ *   inode_release() frees the object when the last descriptor that refers
+ *   to it is closed.  Hence, the descriptor may be dup'ed.
+ *
+ * Input Parameters:
+ *   inode  - The zeroed inode at the beginning of the object
+ *   ops    - The file operations of the object
+ *   priv   - The private data of the object (normally the object)
+ *   oflags - The open flags of the file descriptor
+ *
+ * Returned Value:
+ *   The new file descriptor on success; a negated errno value on failure.
+ *   The object is not freed on failure.
+ *
+ ****************************************************************************/
+
+int anonfd_allocate(FAR struct inode *inode,
+                    FAR const struct file_operations *ops,
+                    FAR void *priv, int oflags)
+{
+  int fd;
+
+  inode->i_crefs   = 1;
+  inode->i_flags   = FSNODEFLAG_TYPE_DRIVER | FSNODEFLAG_DELETED;
+  inode->u.i_ops   = ops;
+  inode->i_private = priv;
+
+  fd = files_allocate(inode, oflags, 0, 0);
+  if (fd < 0)
+    {
+      return -EMFILE;
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: anonfd_lastref
+ *
+ * Description:
+ *   Called from the close method of an unnamed inode.  Returns true if the
+ *   file being closed holds the last reference to the inode.  The object
+ *   should then be torn down, but not freed:  inode_release() will free
+ *   it after the close method returns.
+ *
+ ****************************************************************************/
+
+bool anonfd_lastref(FAR struct file *filep)
+{
+  bool last;
+
+  inode_semtake();
+  last = (filep->f_inode->i_crefs <= 1);
+  inode_semgive();
+
+  return last;
+}
+
+#ifndef CONFIG_DISABLE_POLL
+/****************************************************************************
+ * Name: anonfd_poll
+ *
+ * Description:
+ *   Common poll method logic:  Bind fds to a free slot of the object (or
+ *   unbind it) and report any of the events in eventset that are already
+ *   present.  Must be called in a critical section if the events may be
+ *   reported from interrupt level.
+ *
+ ****************************************************************************/
+
+int anonfd_poll(FAR struct pollfd **slots, FAR struct pollfd *fds,
+                bool setup, pollevent_t eventset)
+{
+  int i;
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_FS_ANONFD_NPOLLWAITERS; i++)
+        {
+          if (slots[i] == NULL)
+            {
+              slots[i]  = fds;
+              fds->priv = &slots[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FS_ANONFD_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          return -EBUSY;
+        }
+
+      eventset &= fds->events;
+      if (eventset != 0)
+        {
+          fds->revents |= eventset;
+          poll_notify(fds);
+        }
+    }
+  else
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: anonfd_pollnotify
+ *
+ * Description:
+ *   Report events to all of the poll waiters of an object.
+ *
+ * Assumptions:
+ *   May be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+void anonfd_pollnotify(FAR struct pollfd **slots, pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_ANONFD_NPOLLWAITERS; i++)
+    {
+      fds = slots[i];
+      if (fds != NULL && (fds->events & eventset) != 0)
+        {
+          fds->revents |= (fds->events & eventset);
+          poll_notify(fds);
+        }
+    }
+}
+#endif /* !CONFIG_DISABLE_POLL */
+
+#endif /* CONFIG_FS_ANONFD */
@@ -90,6 +90,12 @@ int close(int fd)
 
   (void)enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Drop any poll() registration on the descriptor before it goes away */
+
+  pollcache_close(fd);
+#endif
+
 #if CONFIG_NFILE_DESCRIPTORS > 0
   /* Did we get a valid file descriptor? */
 
@@ -67,6 +67,15 @@
 
 int dup2(int fd1, int fd2)
 {
+#ifdef CONFIG_FS_POLLCACHE
+  /* fd2 will be closed; drop any poll() registration on it */
+
+  if (fd1 != fd2)
+    {
+      pollcache_close(fd2);
+    }
+
+#endif
   /* Check the range of the descriptor to see if we got a file or a socket
    * descriptor.
    */
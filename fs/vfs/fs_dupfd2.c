@@ -84,15 +84,19 @@ int dup2(int fd1, int fd2)
   /* Get the file structures corresponding to the file descriptors. */
 
   filep1 = fs_getfilep(fd1);
-  filep2 = fs_getfilep(fd2);
-
-  if (!filep1 || !filep2)
+  if (!filep1)
     {
       /* The errno value has already been set */
 
       return ERROR;
     }
 
+  if ((unsigned int)fd2 >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
   /* Verify that fd1 is a valid, open file descriptor */
 
   if (!DUP_ISOPEN(filep1))
@@ -108,6 +112,15 @@ int dup2(int fd1, int fd2)
       return fd1;
     }
 
+  /* fd2 may lie in a part of the file list that has not been used yet */
+
+  filep2 = files_extend(sched_getfiles(), fd2);
+  if (!filep2)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
   /* Perform the dup2 operation */
 
   return file_dup2(filep1, filep2);
@@ -42,197 +42,803 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
 
 #ifndef CONFIG_DISABLE_POLL
 
 /****************************************************************************
- * Public Functions
+ * Private Types
  ****************************************************************************/
 
+/* One registered descriptor.  The embedded pollfd stays set up on the
+ * driver of the descriptor for as long as the descriptor is armed.
+ */
+
+struct epoll_head_s;
+struct epoll_node_s
+{
+  dq_entry_t rentry;                /* Ready list link (must be first) */
+  FAR struct epoll_node_s *flink;   /* Next registered descriptor */
+  FAR struct epoll_head_s *eph;     /* The containing epoll instance */
+  struct epoll_event ev;            /* Requested events and user data */
+  struct pollfd pfd;                /* Persistent poll registration */
+  bool ready;                       /* True: In the ready list */
+  bool armed;                       /* True: pfd is set up on the driver */
+};
+
+/* The state of one epoll instance (the private data of its file) */
+
+struct epoll_head_s
+{
+  sem_t exclsem;                    /* Serializes epoll_ctl/epoll_wait */
+  sem_t waitsem;                    /* Posted by the drivers */
+  dq_queue_t ready;                 /* Descriptors with pending events */
+  FAR struct epoll_node_s *nodes;   /* All registered descriptors */
+  FAR struct epoll_node_s *rearm;   /* Edge triggered node being re-armed */
+  unsigned int npending;            /* Callbacks not yet matched by posts */
+};
+
 /****************************************************************************
- * Name: epoll_create
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_doclose(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  NULL,          /* open */
+  epoll_doclose, /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL           /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , NULL         /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/* All epoll files refer to this unnamed inode.  It is never in the inode
+ * tree and its reference count never drops to zero.
+ */
+
+static struct inode g_epoll_inode =
+{
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_epoll_ops          /* u */
+  },
+#ifdef CONFIG_FILE_MODE
+  0,                      /* i_mode */
+#endif
+  NULL,                   /* i_private */
+  ""                      /* i_name */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+#define epoll_semgive(sem) (void)sem_post(sem)
+
+/****************************************************************************
+ * Name: epoll_head
  *
  * Description:
+ *   Get the epoll instance associated with a file descriptor.
  *
- * Input Parameters:
+ ****************************************************************************/
+
+static FAR struct epoll_head_s *epoll_head(int epfd)
+{
+  FAR struct file *filep;
+
+  filep = fs_getfilep(epfd);
+  if (filep == NULL)
+    {
+      return NULL;
+    }
+
+  if (filep->f_inode != &g_epoll_inode || filep->f_priv == NULL)
+    {
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  return (FAR struct epoll_head_s *)filep->f_priv;
+}
+
+/****************************************************************************
+ * Name: epoll_pollcb
  *
- * Returned Value:
+ * Description:
+ *   Called by poll_notify() when the driver of a registered descriptor
+ *   reports an event.  Add the descriptor to the ready list.
+ *
+ * Assumptions:
+ *   May be called from interrupt level logic.
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+static void epoll_pollcb(FAR struct pollfd *fds)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_node_s *node = (FAR struct epoll_node_s *)fds->arg;
+  FAR struct epoll_head_s *eph = node->eph;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  /* Account for the semaphore count that will follow */
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  eph->npending++;
+
+  /* Report the state found while re-arming an edge triggered descriptor
+   * only if it changes later.
    */
 
-  return (int)((intptr_t)eph);
+  if (!node->ready && eph->rearm != node)
+    {
+      dq_addlast(&node->rentry, &eph->ready);
+      node->ready = true;
+    }
+
+  leave_critical_section(flags);
 }
 
 /****************************************************************************
- * Name: epoll_close
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a descriptor from the ready list (if it is there).
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR struct epoll_node_s *node)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (node->ready)
+    {
+      dq_rem(&node->rentry, &node->eph->ready);
+      node->ready = false;
+    }
+
+  node->pfd.revents = 0;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Set up the persistent poll registration of a descriptor on its driver.
+ *   The driver reports any events that are already in effect.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_node_s *node)
+{
+  int ret;
+
+  DEBUGASSERT(!node->armed);
+
+  node->pfd.sem     = &node->eph->waitsem;
+  node->pfd.events  = (pollevent_t)node->ev.events | POLLERR | POLLHUP;
+  node->pfd.revents = 0;
+  node->pfd.priv    = NULL;
+  node->pfd.cb      = epoll_pollcb;
+  node->pfd.arg     = node;
+
+  ret = poll_fdsetup(node->pfd.fd, &node->pfd, true);
+  if (ret >= 0)
+    {
+      node->armed = true;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Tear down the poll registration of a descriptor and remove it from the
+ *   ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_node_s *node)
+{
+  if (node->armed)
+    {
+      (void)poll_fdsetup(node->pfd.fd, &node->pfd, false);
+      node->armed = false;
+    }
+
+  epoll_unready(node);
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Renew the poll registration of a descriptor after an event has been
+ *   reported.  Some drivers stop monitoring after the first event.  For a
+ *   level triggered descriptor, the renewed registration will report the
+ *   descriptor again if it is still ready.  For an edge triggered
+ *   descriptor, only later events are reported.
+ *
+ ****************************************************************************/
+
+static void epoll_rearm(FAR struct epoll_node_s *node)
+{
+  FAR struct epoll_head_s *eph = node->eph;
+
+  epoll_disarm(node);
+
+  if ((node->ev.events & EPOLLONESHOT) != 0)
+    {
+      /* Stay disabled until re-armed with EPOLL_CTL_MOD */
+
+      return;
+    }
+
+  if ((node->ev.events & EPOLLET) != 0)
+    {
+      eph->rearm = node;
+      (void)epoll_arm(node);
+      eph->rearm = NULL;
+
+      /* Forget the current state of the descriptor */
+
+      node->pfd.revents = 0;
+    }
+  else
+    {
+      (void)epoll_arm(node);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd,
+                                           FAR struct epoll_node_s **prev)
+{
+  FAR struct epoll_node_s *node;
+
+  *prev = NULL;
+  for (node = eph->nodes; node != NULL; node = node->flink)
+    {
+      if (node->pfd.fd == fd)
+        {
+          break;
+        }
+
+      *prev = node;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: epoll_drain
+ *
+ * Description:
+ *   Consume the posts of the wait semaphore.  Each post should follow a
+ *   call to epoll_pollcb().  Drivers that post the semaphore directly
+ *   bypass the callback;  in that case, fall back to checking the revents
+ *   of every registered descriptor.
+ *
+ * Input Parameters:
+ *   eph    - The epoll instance
+ *   nposts - The number of posts already consumed by the caller
+ *
+ ****************************************************************************/
+
+static void epoll_drain(FAR struct epoll_head_s *eph, unsigned int nposts)
+{
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+  bool scan = false;
+
+  while (sem_trywait(&eph->waitsem) == OK)
+    {
+      nposts++;
+    }
+
+  flags = enter_critical_section();
+  if (nposts > eph->npending)
+    {
+      eph->npending = 0;
+      scan = true;
+    }
+  else
+    {
+      eph->npending -= nposts;
+    }
+
+  if (scan)
+    {
+      for (node = eph->nodes; node != NULL; node = node->flink)
+        {
+          if (node->armed && !node->ready && node->pfd.revents != 0)
+            {
+              dq_addlast(&node->rentry, &eph->ready);
+              node->ready = true;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_collect
  *
  * Description:
+ *   Remove up to 'maxevents' descriptors from the ready list and report
+ *   their events.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_node_s *node;
+  irqstate_t flags;
+  pollevent_t revents;
+  int nevents = 0;
+
+  while (nevents < maxevents)
+    {
+      flags = enter_critical_section();
+      node  = (FAR struct epoll_node_s *)dq_remfirst(&eph->ready);
+      if (node == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      node->ready       = false;
+      revents           = node->pfd.revents &
+                          ((pollevent_t)node->ev.events | POLLERR | POLLHUP);
+      node->pfd.revents = 0;
+      leave_critical_section(flags);
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[nevents].events = revents;
+      evs[nevents].data   = node->ev.data;
+      nevents++;
+
+      /* Renew the registration (which may put the descriptor back in the
+       * ready list for a later call).
+       */
+
+      epoll_rearm(node);
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_doclose
+ *
+ * Description:
+ *   Close an epoll file, tearing down all registrations.
+ *
+ ****************************************************************************/
+
+static int epoll_doclose(FAR struct file *filep)
+{
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)filep->f_priv;
+  FAR struct epoll_node_s *node;
+
+  if (eph == NULL)
+    {
+      return OK;
+    }
+
+  while ((node = eph->nodes) != NULL)
+    {
+      eph->nodes = node->flink;
+      epoll_disarm(node);
+      kmm_free(node);
+    }
+
+  sem_destroy(&eph->waitsem);
+  sem_destroy(&eph->exclsem);
+  kmm_free(eph);
+
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Create a new epoll instance.  The instance is a file:  It is released
+ *   with close() (or epoll_close()).
  *
  * Input Parameters:
+ *   size - Ignored, but must be greater than zero
  *
  * Returned Value:
+ *   A file descriptor referring to the epoll instance on success.
+ *   Otherwise -1 (ERROR) is returned and errno is set appropriately.
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+int epoll_create(int size)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  FAR struct epoll_head_s *eph;
+  FAR struct file *filep;
+  int errcode;
+  int fd;
+
+  if (size <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  sem_init(&eph->exclsem, 0, 1);
+  sem_init(&eph->waitsem, 0, 0);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  sem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+  dq_init(&eph->ready);
+
+  /* Allocate a file descriptor referring to the epoll inode */
+
+  inode_addref(&g_epoll_inode);
+  fd = files_allocate(&g_epoll_inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      inode_release(&g_epoll_inode);
+      errcode = EMFILE;
+      goto errout_with_eph;
+    }
 
-  kmm_free(eph->evs);
+  filep = fs_getfilep(fd);
+  DEBUGASSERT(filep != NULL);
+  filep->f_priv = eph;
+
+  finfo("epfd=%d\n", fd);
+  return fd;
+
+errout_with_eph:
+  sem_destroy(&eph->waitsem);
+  sem_destroy(&eph->exclsem);
   kmm_free(eph);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Release an epoll instance.  This is equivalent to close(epfd).
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  (void)close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a descriptor in the interest list of an epoll
+ *   instance.  A descriptor must be removed (EPOLL_CTL_DEL) before it is
+ *   closed.
  *
  * Input Parameters:
+ *   epfd - The epoll instance
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The events of interest and user data (ignored for
+ *          EPOLL_CTL_DEL)
  *
  * Returned Value:
+ *   Zero (OK) on success.  Otherwise -1 (ERROR) is returned and errno is
+ *   set appropriately.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  FAR struct epoll_node_s *prev;
+  int ret = OK;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  eph = epoll_head(epfd);
+  if (eph == NULL)
+    {
+      return ERROR;
+    }
+
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      set_errno(EFAULT);
+      return ERROR;
+    }
+
+  epoll_semtake(&eph->exclsem);
+  node = epoll_find(eph, fd, &prev);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
-
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        finfo("%d CTL ADD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (node != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        node = (FAR struct epoll_node_s *)
+          kmm_zalloc(sizeof(struct epoll_node_s));
+        if (node == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        node->eph    = eph;
+        node->ev     = *ev;
+        node->pfd.fd = fd;
+
+        ret = epoll_arm(node);
+        if (ret < 0)
+          {
+            kmm_free(node);
+            break;
+          }
+
+        node->flink = eph->nodes;
+        eph->nodes  = node;
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
-
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied-1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
-
-          return -ENOENT;
-        }
+        finfo("%d CTL DEL: fd=%d\n", epfd, fd);
+
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        if (prev != NULL)
+          {
+            prev->flink = node->flink;
+          }
+        else
+          {
+            eph->nodes = node->flink;
+          }
+
+        epoll_disarm(node);
+        kmm_free(node);
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
-
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        finfo("%d CTL MOD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        /* Re-register with the new events.  This also re-arms a one-shot
+         * descriptor.
+         */
+
+        epoll_disarm(node);
+        node->ev = *ev;
+        ret = epoll_arm(node);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+  epoll_semgive(&eph->exclsem);
 
-          return -ENOENT;
-        }
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the descriptors registered with an epoll instance.
+ *   Only the descriptors in the ready list are examined, so the cost does
+ *   not depend on the number of registered descriptors.
  *
  * Input Parameters:
+ *   epfd      - The epoll instance
+ *   evs       - Location to return the events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The maximum time to wait in milliseconds.  A negative value
+ *               means wait forever; zero means do not wait.
  *
  * Returned Value:
+ *   The number of events returned (zero if the timeout expired).  On
+ *   failure, -1 (ERROR) is returned and errno is set appropriately.
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  systime_t start;
+  systime_t ticks = 0;
+  int errcode = 0;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  (void)enter_cancellation_point();
 
-  if (rc <= 0)
+  eph = epoll_head(epfd);
+  if (eph == NULL)
     {
-      if (rc < 0)
-        {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+      leave_cancellation_point();
+      return ERROR;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
-            }
-        }
+  if (evs == NULL || maxevents <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
 
-      return rc;
+  if (timeout > 0)
+    {
+      /* Round timeout up to next full tick (as poll() does) */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) / USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) / MSEC_PER_TICK;
+#endif
     }
 
-  /* Iterate over non NULL event fds */
+  start = clock_systimer();
 
-  for (i = 0, counter = 0; i < rc && counter < eph->size; counter++)
+  for (; ; )
     {
-      if (eph->evs[counter].revents != 0)
+      /* Account for any events reported since the last time */
+
+      epoll_semtake(&eph->exclsem);
+      epoll_drain(eph, 0);
+      ret = epoll_collect(eph, evs, maxevents);
+      epoll_semgive(&eph->exclsem);
+
+      if (ret > 0 || timeout == 0)
         {
-          evs[i].data.fd = eph->evs[counter].data.fd;
-          evs[i].events  = eph->evs[counter].revents;
-          i += 1;
+          break;
         }
+
+      /* Wait for the next event to be reported */
+
+      if (timeout > 0)
+        {
+          ret = sem_tickwait(&eph->waitsem, start, ticks);
+          if (ret == -ETIMEDOUT)
+            {
+              ret = 0;
+              break;
+            }
+          else if (ret < 0)
+            {
+              errcode = -ret;
+              goto errout;
+            }
+        }
+      else if (sem_wait(&eph->waitsem) < 0)
+        {
+          errcode = get_errno();
+          goto errout;
+        }
+
+      /* One post was consumed by the wait */
+
+      epoll_semtake(&eph->exclsem);
+      epoll_drain(eph, 1);
+      epoll_semgive(&eph->exclsem);
     }
 
-  return i;
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  leave_cancellation_point();
+  set_errno(errcode);
+  return ERROR;
 }
 
 #endif /* CONFIG_DISABLE_POLL */
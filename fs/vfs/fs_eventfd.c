@@ -0,0 +1,418 @@
+/****************************************************************************
+ * fs/vfs/fs_eventfd.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/eventfd.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_EVENTFD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest value that the counter may hold */
+
+#define EVENTFD_MAX  ((eventfd_t)-2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct eventfd_s
+{
+  struct inode ef_inode;          /* Unnamed inode (must be first) */
+  sem_t ef_rdsem;                 /* Readers wait here for a count */
+  sem_t ef_wrsem;                 /* Writers wait here for space */
+  eventfd_t ef_count;             /* The counter */
+  uint8_t ef_flags;               /* EFD_SEMAPHORE */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *ef_fds[CONFIG_FS_ANONFD_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     eventfd_close(FAR struct file *filep);
+static ssize_t eventfd_doread(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen);
+static ssize_t eventfd_dowrite(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen);
+#ifndef CONFIG_DISABLE_POLL
+static int     eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_eventfd_ops =
+{
+  NULL,            /* open */
+  eventfd_close,   /* close */
+  eventfd_doread,  /* read */
+  eventfd_dowrite, /* write */
+  NULL,            /* seek */
+  NULL             /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , eventfd_poll   /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd_wakeall
+ *
+ * Description:
+ *   Wake up all threads waiting on a semaphore.  They will re-test the
+ *   counter.
+ *
+ ****************************************************************************/
+
+static void eventfd_wakeall(FAR sem_t *sem)
+{
+  int sval;
+
+  while (sem_getvalue(sem, &sval) == OK && sval < 0)
+    {
+      sem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: eventfd_wait
+ *
+ * Description:
+ *   Wait for the counter to change.  Called in a critical section.
+ *
+ ****************************************************************************/
+
+static int eventfd_wait(FAR struct file *filep, FAR sem_t *sem)
+{
+  if ((filep->f_oflags & O_NONBLOCK) != 0)
+    {
+      return -EAGAIN;
+    }
+
+  if (sem_wait(sem) < 0)
+    {
+      return -get_errno();
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_close
+ ****************************************************************************/
+
+static int eventfd_close(FAR struct file *filep)
+{
+  FAR struct eventfd_s *dev = filep->f_inode->i_private;
+
+  /* The object itself is freed by inode_release() */
+
+  if (anonfd_lastref(filep))
+    {
+      sem_destroy(&dev->ef_rdsem);
+      sem_destroy(&dev->ef_wrsem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: eventfd_doread
+ ****************************************************************************/
+
+static ssize_t eventfd_doread(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct eventfd_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  eventfd_t value;
+  int ret;
+
+  if (buflen < sizeof(eventfd_t))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (dev->ef_count == 0)
+    {
+      ret = eventfd_wait(filep, &dev->ef_rdsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  value = (dev->ef_flags & EFD_SEMAPHORE) != 0 ? 1 : dev->ef_count;
+  dev->ef_count -= value;
+
+  /* There is now space for writers */
+
+  eventfd_wakeall(&dev->ef_wrsem);
+#ifndef CONFIG_DISABLE_POLL
+  anonfd_pollnotify(dev->ef_fds, POLLOUT);
+#endif
+  leave_critical_section(flags);
+
+  memcpy(buffer, &value, sizeof(eventfd_t));
+  return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_dowrite
+ ****************************************************************************/
+
+static ssize_t eventfd_dowrite(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  FAR struct eventfd_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  eventfd_t value;
+  int ret;
+
+  if (buflen < sizeof(eventfd_t))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(&value, buffer, sizeof(eventfd_t));
+  if (value > EVENTFD_MAX)
+    {
+      return -EINVAL;
+    }
+
+  if (value == 0)
+    {
+      return sizeof(eventfd_t);
+    }
+
+  flags = enter_critical_section();
+  while (dev->ef_count > EVENTFD_MAX - value)
+    {
+      ret = eventfd_wait(filep, &dev->ef_wrsem);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  dev->ef_count += value;
+
+  eventfd_wakeall(&dev->ef_rdsem);
+#ifndef CONFIG_DISABLE_POLL
+  anonfd_pollnotify(dev->ef_fds, POLLIN);
+#endif
+  leave_critical_section(flags);
+
+  return sizeof(eventfd_t);
+}
+
+/****************************************************************************
+ * Name: eventfd_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int eventfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup)
+{
+  FAR struct eventfd_s *dev = filep->f_inode->i_private;
+  pollevent_t eventset = 0;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  if (dev->ef_count > 0)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (dev->ef_count < EVENTFD_MAX)
+    {
+      eventset |= POLLOUT;
+    }
+
+  ret = anonfd_poll(dev->ef_fds, fds, setup, eventset);
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: eventfd
+ *
+ * Description:
+ *   Create an event counter.  write() adds its 8 byte (or, without long
+ *   long support, 4 byte) value to the counter.  read() returns the counter
+ *   and resets it to zero or, with EFD_SEMAPHORE, returns one and
+ *   decrements the counter.  read() blocks while the counter is zero and
+ *   write() blocks if the counter would overflow, unless the file is
+ *   non-blocking.  The file is readable in poll() when the counter is
+ *   non-zero.
+ *
+ * Input Parameters:
+ *   initval - The initial value of the counter
+ *   flags   - EFD_SEMAPHORE, EFD_NONBLOCK and/or EFD_CLOEXEC
+ *
+ * Returned Value:
+ *   A file descriptor referring to the counter on success.  Otherwise -1
+ *   (ERROR) is returned and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int eventfd(unsigned int initval, int flags)
+{
+  FAR struct eventfd_s *dev;
+  int errcode;
+  int fd;
+
+  if ((flags & ~(EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  dev = (FAR struct eventfd_s *)kmm_zalloc(sizeof(struct eventfd_s));
+  if (dev == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  dev->ef_count = initval;
+  dev->ef_flags = flags & EFD_SEMAPHORE;
+
+  /* The wait semaphores are used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  sem_init(&dev->ef_rdsem, 0, 0);
+  sem_init(&dev->ef_wrsem, 0, 0);
+  sem_setprotocol(&dev->ef_rdsem, SEM_PRIO_NONE);
+  sem_setprotocol(&dev->ef_wrsem, SEM_PRIO_NONE);
+
+  fd = anonfd_allocate(&dev->ef_inode, &g_eventfd_ops, dev,
+                       O_RDWR | (flags & EFD_NONBLOCK));
+  if (fd < 0)
+    {
+      errcode = -fd;
+      goto errout_with_dev;
+    }
+
+  finfo("fd=%d initval=%u\n", fd, initval);
+  return fd;
+
+errout_with_dev:
+  sem_destroy(&dev->ef_rdsem);
+  sem_destroy(&dev->ef_wrsem);
+  kmm_free(dev);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: eventfd_read
+ *
+ * Description:
+ *   Read the counter.  Returns 0 on success, -1 (ERROR) with errno set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int eventfd_read(int fd, FAR eventfd_t *value)
+{
+  return read(fd, value, sizeof(eventfd_t)) == sizeof(eventfd_t) ?
+         OK : ERROR;
+}
+
+/****************************************************************************
+ * Name: eventfd_write
+ *
+ * Description:
+ *   Add to the counter.  Returns 0 on success, -1 (ERROR) with errno set
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int eventfd_write(int fd, eventfd_t value)
+{
+  return write(fd, &value, sizeof(eventfd_t)) == sizeof(eventfd_t) ?
+         OK : ERROR;
+}
+
+#endif /* CONFIG_FS_EVENTFD */
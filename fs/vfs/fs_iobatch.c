@@ -0,0 +1,141 @@
+/****************************************************************************
+ * fs/vfs/fs_iobatch.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/iobatch.h>
+#include <sys/socket.h>
+
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+
+#ifdef CONFIG_FS_IOBATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iobatch
+ *
+ * Description:
+ *   Perform the operations in 'ops' in order.  The result of each operation
+ *   is returned in its ib_result field.  A failed operation does not end
+ *   the batch unless its IOBATCH_FLAG_STOP flag is set.
+ *
+ * Input Parameters:
+ *   ops  - The array of operations
+ *   nops - The number of operations in the array
+ *
+ * Returned Value:
+ *   The number of operations that were performed.  -1 (ERROR) is returned
+ *   with errno set to EINVAL if the arguments are invalid.
+ *
+ ****************************************************************************/
+
+int iobatch(FAR struct iobatch_s *ops, int nops)
+{
+  FAR struct iobatch_s *op;
+  ssize_t ret;
+  int i;
+
+  if (ops == NULL || nops < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  for (i = 0; i < nops; i++)
+    {
+      op = &ops[i];
+
+      switch (op->ib_opcode)
+        {
+          case IOBATCH_READ:
+            ret = read(op->ib_fd, op->ib_buf, op->ib_nbytes);
+            break;
+
+          case IOBATCH_WRITE:
+            ret = write(op->ib_fd, op->ib_buf, op->ib_nbytes);
+            break;
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+          case IOBATCH_SEND:
+            ret = send(op->ib_fd, op->ib_buf, op->ib_nbytes, op->ib_arg);
+            break;
+
+          case IOBATCH_RECV:
+            ret = recv(op->ib_fd, op->ib_buf, op->ib_nbytes, op->ib_arg);
+            break;
+#endif
+
+#ifndef CONFIG_DISABLE_POLL
+          case IOBATCH_POLL:
+            ret = poll((FAR struct pollfd *)op->ib_buf,
+                       (nfds_t)op->ib_nbytes, op->ib_arg);
+            break;
+#endif
+
+          default:
+            set_errno(ENOSYS);
+            ret = ERROR;
+            break;
+        }
+
+      if (ret < 0)
+        {
+          op->ib_result = -get_errno();
+          if ((op->ib_flags & IOBATCH_FLAG_STOP) != 0)
+            {
+              i++;
+              break;
+            }
+        }
+      else
+        {
+          op->ib_result = ret;
+        }
+    }
+
+  return i;
+}
+
+#endif /* CONFIG_FS_IOBATCH */
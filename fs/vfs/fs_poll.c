@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <string.h>
 #include <poll.h>
 #include <time.h>
 #include <semaphore.h>
@@ -47,6 +48,8 @@
 #include <errno.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
@@ -64,6 +67,41 @@
 
 #define poll_semgive(sem) sem_post(sem)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+/* One registration of the poll() cache.  The driver is recorded so that the
+ * registration can be torn down without looking up the descriptor, which
+ * may be done from the context of another task when the group is released.
+ */
+
+struct pollcache_entry_s
+{
+  struct pollfd pfd;              /* The registered poll structure */
+  bool          socket;           /* True: u.psock; false: u.filep */
+  union
+  {
+    FAR struct file *filep;       /* The polled file */
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+    FAR struct socket *psock;     /* The polled socket */
+#endif
+  } u;
+};
+
+/* The poll() registration cache of a task group */
+
+struct pollcache_s
+{
+  sem_t  pc_lock;                 /* Protects the cache */
+  sem_t  pc_sem;                  /* Posted by the registered drivers */
+  bool   pc_busy;                 /* In use by a poll() call */
+  nfds_t pc_nfds;                 /* Number of cached entries */
+  struct pollcache_entry_s pc_entries[CONFIG_FS_POLLCACHE_NFDS];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -91,41 +129,6 @@ static int poll_semtake(FAR sem_t *sem)
   return OK;
 }
 
-/****************************************************************************
- * Name: poll_fdsetup
- *
- * Description:
- *   Configure (or unconfigure) one file/socket descriptor for the poll
- *   operation.  If fds and sem are non-null, then the poll is being setup.
- *   if fds and sem are NULL, then the poll is being torn down.
- *
- ****************************************************************************/
-
-#if CONFIG_NFILE_DESCRIPTORS > 0
-static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
-{
-  /* Check for a valid file descriptor */
-
-  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
-    {
-      /* Perform the socket ioctl */
-
-#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
-      if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS+CONFIG_NSOCKET_DESCRIPTORS))
-        {
-          return net_poll(fd, fds, setup);
-        }
-      else
-#endif
-        {
-          return -EBADF;
-        }
-    }
-
-  return fdesc_poll(fd, fds, setup);
-}
-#endif
-
 /****************************************************************************
  * Name: poll_setup
  *
@@ -150,6 +153,8 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
       fds[i].sem     = sem;
       fds[i].revents = 0;
       fds[i].priv    = NULL;
+      fds[i].cb      = NULL;
+      fds[i].arg     = NULL;
 
       /* Check for invalid descriptors. "If the value of fd is less than 0,
        * events shall be ignored, and revents shall be set to 0 in that entry
@@ -240,10 +245,632 @@ static inline int poll_teardown(FAR struct pollfd *fds, nfds_t nfds, int *count,
 }
 #endif
 
+/****************************************************************************
+ * Name: poll_wait
+ *
+ * Description:
+ *   Wait for a poll event, a signal, or for timeout milliseconds after
+ *   start to elapse.  A negative timeout waits forever.  -ETIMEDOUT is
+ *   returned if the timeout elapsed.
+ *
+ ****************************************************************************/
+
+static int poll_wait(FAR sem_t *sem, systime_t start, int timeout)
+{
+  systime_t ticks;
+
+  if (timeout == 0)
+    {
+      return -ETIMEDOUT;
+    }
+  else if (timeout < 0)
+    {
+      /* Wait for the poll event or signal with no timeout */
+
+      return poll_semtake(sem);
+    }
+
+  /* "Implementations may place limitations on the granularity of
+   * timeout intervals. If the requested timeout interval requires
+   * a finer granularity than the implementation supports, the
+   * actual timeout interval will be rounded up to the next
+   * supported value." -- opengroup.org
+   *
+   * Round timeout up to next full tick.
+   */
+
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+  ticks = (((unsigned long long)timeout * USEC_PER_MSEC) + (USEC_PER_TICK - 1)) /
+          USEC_PER_TICK;
+#else
+  ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) / MSEC_PER_TICK;
+#endif
+
+  /* Either wait for either a poll event(s), for a signal to occur,
+   * or for the specified timeout to elapse with no event.
+   *
+   * NOTE: If a poll event is pending (i.e., the semaphore has already
+   * been incremented), sem_tickwait() will not wait, but will return
+   * immediately.
+   */
+
+  return sem_tickwait(sem, start, ticks);
+}
+
+/****************************************************************************
+ * Name: pollcache_fdsetup
+ *
+ * Description:
+ *   Set up or tear down one cached registration.  On setup, the descriptor
+ *   is resolved to its file or socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+static int pollcache_fdsetup(FAR struct pollcache_entry_s *entry, bool setup)
+{
+  int fd = entry->pfd.fd;
+
+  if (fd < 0)
+    {
+      return OK;
+    }
+
+  if (setup)
+    {
+      entry->pfd.revents = 0;
+      entry->pfd.priv    = NULL;
+
+      if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+        {
+          entry->u.filep = fs_getfilep(fd);
+          if (entry->u.filep == NULL)
+            {
+              return -get_errno();
+            }
+
+          entry->socket = false;
+        }
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      else if ((unsigned int)fd <
+               (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS))
+        {
+          entry->u.psock = sockfd_socket(fd);
+          if (entry->u.psock == NULL || entry->u.psock->s_crefs <= 0)
+            {
+              return -EBADF;
+            }
+
+          entry->socket = true;
+        }
+#endif
+      else
+        {
+          return -EBADF;
+        }
+    }
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (entry->socket)
+    {
+      return psock_poll(entry->u.psock, &entry->pfd, setup);
+    }
+#endif
+
+  return file_poll(entry->u.filep, &entry->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: pollcache_flush
+ *
+ * Description:
+ *   Tear down all registrations of the cache.  The cache must be locked.
+ *
+ ****************************************************************************/
+
+static void pollcache_flush(FAR struct pollcache_s *cache)
+{
+  nfds_t i;
+
+  for (i = 0; i < cache->pc_nfds; i++)
+    {
+      (void)pollcache_fdsetup(&cache->pc_entries[i], false);
+    }
+
+  cache->pc_nfds = 0;
+}
+
+/****************************************************************************
+ * Name: pollcache_load
+ *
+ * Description:
+ *   Replace the contents of the cache with registrations of a new
+ *   descriptor set.  The cache must be locked.
+ *
+ ****************************************************************************/
+
+static int pollcache_load(FAR struct pollcache_s *cache,
+                          FAR struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct pollcache_entry_s *entry;
+  nfds_t i;
+  int ret;
+
+  pollcache_flush(cache);
+
+  for (i = 0; i < nfds; i++)
+    {
+      entry = &cache->pc_entries[i];
+      memset(entry, 0, sizeof(struct pollcache_entry_s));
+
+      entry->pfd.fd     = fds[i].fd;
+      entry->pfd.events = fds[i].events;
+      entry->pfd.sem    = &cache->pc_sem;
+
+      ret = pollcache_fdsetup(entry, true);
+      if (ret < 0)
+        {
+          /* Tear down the entries that were set up and report an error on
+           * this descriptor
+           */
+
+          cache->pc_nfds = i;
+          pollcache_flush(cache);
+
+          fds[i].revents |= POLLERR;
+          return ret;
+        }
+
+      cache->pc_nfds = i + 1;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pollcache_match
+ *
+ * Description:
+ *   Return true if the cache holds the registrations of this set.
+ *
+ ****************************************************************************/
+
+static bool pollcache_match(FAR struct pollcache_s *cache,
+                            FAR const struct pollfd *fds, nfds_t nfds)
+{
+  nfds_t i;
+
+  if (cache->pc_nfds != nfds)
+    {
+      return false;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      if (cache->pc_entries[i].pfd.fd != fds[i].fd ||
+          cache->pc_entries[i].pfd.events != fds[i].events)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: pollcache_rearm
+ *
+ * Description:
+ *   Renew the registrations that reported events.  The state of such a
+ *   descriptor may have changed since (e.g., the data was read) and some
+ *   drivers stop monitoring after the first event.  A registration that did
+ *   not report an event would have done so on any change of state and is
+ *   left in place.  The cache must be locked.
+ *
+ ****************************************************************************/
+
+static int pollcache_rearm(FAR struct pollcache_s *cache)
+{
+  FAR struct pollcache_entry_s *entry;
+  nfds_t i;
+  int ret;
+
+  for (i = 0; i < cache->pc_nfds; i++)
+    {
+      entry = &cache->pc_entries[i];
+      if (entry->pfd.fd >= 0 && entry->pfd.revents != 0)
+        {
+          (void)pollcache_fdsetup(entry, false);
+
+          ret = pollcache_fdsetup(entry, true);
+          if (ret < 0)
+            {
+              /* This one is no longer registered */
+
+              entry->pfd.fd = -1;
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pollcache_count
+ *
+ * Description:
+ *   Return the number of cached entries with non-zero revents.
+ *
+ ****************************************************************************/
+
+static int pollcache_count(FAR struct pollcache_s *cache)
+{
+  nfds_t i;
+  int count = 0;
+
+  for (i = 0; i < cache->pc_nfds; i++)
+    {
+      if (cache->pc_entries[i].pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: pollcache_acquire
+ *
+ * Description:
+ *   Get exclusive use of the poll() cache of the current task group,
+ *   creating it if necessary.  NULL is returned if the set is too large or
+ *   if the cache is being used by another thread.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_s *pollcache_acquire(nfds_t nfds)
+{
+  FAR struct task_group_s *group = sched_self()->group;
+  FAR struct pollcache_s *cache;
+  FAR struct pollcache_s *newcache;
+
+  if (nfds == 0 || nfds > CONFIG_FS_POLLCACHE_NFDS || group == NULL)
+    {
+      return NULL;
+    }
+
+  cache = group->tg_pollcache;
+  if (cache == NULL)
+    {
+      newcache = (FAR struct pollcache_s *)
+        kmm_zalloc(sizeof(struct pollcache_s));
+      if (newcache == NULL)
+        {
+          return NULL;
+        }
+
+      sem_init(&newcache->pc_lock, 0, 1);
+
+      /* This semaphore is used for signaling and, hence, should not have
+       * priority inheritance enabled.
+       */
+
+      sem_init(&newcache->pc_sem, 0, 0);
+      sem_setprotocol(&newcache->pc_sem, SEM_PRIO_NONE);
+
+      /* Another thread of the group may have created the cache meanwhile */
+
+      sched_lock();
+      cache = group->tg_pollcache;
+      if (cache == NULL)
+        {
+          group->tg_pollcache = newcache;
+          cache = newcache;
+          newcache = NULL;
+        }
+
+      sched_unlock();
+
+      if (newcache != NULL)
+        {
+          sem_destroy(&newcache->pc_lock);
+          sem_destroy(&newcache->pc_sem);
+          kmm_free(newcache);
+        }
+    }
+
+  if (poll_semtake(&cache->pc_lock) < 0)
+    {
+      return NULL;
+    }
+
+  if (cache->pc_busy)
+    {
+      poll_semgive(&cache->pc_lock);
+      return NULL;
+    }
+
+  cache->pc_busy = true;
+  poll_semgive(&cache->pc_lock);
+  return cache;
+}
+
+/****************************************************************************
+ * Name: pollcache_poll
+ *
+ * Description:
+ *   Perform poll() using the registration cache.  The returned value is
+ *   the count of descriptors with events or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int pollcache_poll(FAR struct pollcache_s *cache,
+                          FAR struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  systime_t start;
+  nfds_t i;
+  int count;
+  int ret;
+
+  while (sem_wait(&cache->pc_lock) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  if (pollcache_match(cache, fds, nfds))
+    {
+      /* Discard the notifications that arrived since the last call.  The
+       * events that they reported are still in revents.
+       */
+
+      (void)sem_reset(&cache->pc_sem, 0);
+      ret = pollcache_rearm(cache);
+      if (ret < 0)
+        {
+          pollcache_flush(cache);
+        }
+    }
+  else
+    {
+      ret = pollcache_load(cache, fds, nfds);
+    }
+
+  poll_semgive(&cache->pc_lock);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait until an event is reported.  Notifications may remain from events
+   * that were already reported, so the wait is repeated until one of the
+   * entries has revents.
+   */
+
+  start = clock_systimer();
+  while ((count = pollcache_count(cache)) == 0)
+    {
+      ret = poll_wait(&cache->pc_sem, start, timeout);
+      if (ret < 0)
+        {
+          if (ret == -ETIMEDOUT)
+            {
+              /* Return zero (OK) in the event of a timeout */
+
+              ret = OK;
+            }
+
+          break;
+        }
+    }
+
+  /* Return the events */
+
+  while (sem_wait(&cache->pc_lock) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  count = 0;
+  for (i = 0; i < nfds; i++)
+    {
+      fds[i].revents = cache->pc_entries[i].pfd.revents;
+      if (fds[i].revents != 0)
+        {
+          count++;
+        }
+    }
+
+  poll_semgive(&cache->pc_lock);
+
+  /* Preserve ret, if negative, since it holds the result of the wait */
+
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: pollcache_unlock
+ *
+ * Description:
+ *   Give up the exclusive use of the cache.
+ *
+ ****************************************************************************/
+
+static void pollcache_unlock(FAR struct pollcache_s *cache)
+{
+  while (sem_wait(&cache->pc_lock) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  cache->pc_busy = false;
+  poll_semgive(&cache->pc_lock);
+}
+#endif /* CONFIG_FS_POLLCACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: poll_fdsetup
+ *
+ * Description:
+ *   Configure (or unconfigure) one file/socket descriptor for the poll
+ *   operation.  If fds and sem are non-null, then the poll is being setup.
+ *   if fds and sem are NULL, then the poll is being torn down.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+{
+  /* Check for a valid file descriptor */
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      /* Perform the socket ioctl */
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS+CONFIG_NSOCKET_DESCRIPTORS))
+        {
+          return net_poll(fd, fds, setup);
+        }
+      else
+#endif
+        {
+          return -EBADF;
+        }
+    }
+
+  return fdesc_poll(fd, fds, setup);
+}
+#endif
+
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report that events have been added to fds->revents.  Drivers should
+ *   use this in place of posting fds->sem directly:  It also calls the
+ *   notification callback, if any, which lets epoll track ready
+ *   descriptors without scanning all of them.
+ *
+ * Input Parameters:
+ *   fds - The poll structure whose revents were updated
+ *
+ * Returned Value:
+ *  None
+ *
+ * Assumptions:
+ *   May be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  DEBUGASSERT(fds != NULL && fds->sem != NULL);
+
+  if (fds->cb != NULL)
+    {
+      fds->cb(fds);
+    }
+
+  sem_post(fds->sem);
+}
+
+/****************************************************************************
+ * Name: pollcache_close
+ *
+ * Description:
+ *   Remove a descriptor that is about to be closed from the poll()
+ *   registration cache of the current task group.  A poll() that is waiting
+ *   on the cache reports POLLNVAL for the descriptor.
+ *
+ * Input Parameters:
+ *   fd - The file or socket descriptor that will be closed
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+void pollcache_close(int fd)
+{
+  FAR struct task_group_s *group = sched_self()->group;
+  FAR struct pollcache_s *cache;
+  FAR struct pollcache_entry_s *entry;
+  bool wake = false;
+  nfds_t i;
+
+  if (group == NULL || (cache = group->tg_pollcache) == NULL || fd < 0)
+    {
+      return;
+    }
+
+  while (sem_wait(&cache->pc_lock) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  for (i = 0; i < cache->pc_nfds; i++)
+    {
+      entry = &cache->pc_entries[i];
+      if (entry->pfd.fd == fd)
+        {
+          (void)pollcache_fdsetup(entry, false);
+          entry->pfd.fd      = -1;
+          entry->pfd.revents = POLLNVAL;
+          wake               = true;
+        }
+    }
+
+  if (wake)
+    {
+      sem_post(&cache->pc_sem);
+    }
+
+  poll_semgive(&cache->pc_lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: pollcache_release
+ *
+ * Description:
+ *   Tear down and free the poll() registration cache of a task group.  This
+ *   must be called while the descriptors of the group are still open.
+ *
+ * Input Parameters:
+ *   group - The task group being released
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+void pollcache_release(FAR struct task_group_s *group)
+{
+  FAR struct pollcache_s *cache = group->tg_pollcache;
+
+  if (cache != NULL)
+    {
+      group->tg_pollcache = NULL;
+
+      pollcache_flush(cache);
+      sem_destroy(&cache->pc_lock);
+      sem_destroy(&cache->pc_sem);
+      kmm_free(cache);
+    }
+}
+#endif
+
+
 /****************************************************************************
  * Name: file_poll
  *
@@ -298,7 +925,7 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
               fds->revents |= (fds->events & (POLLIN | POLLOUT));
               if (fds->revents != 0)
                 {
-                  sem_post(fds->sem);
+                  poll_notify(fds);
                 }
             }
 
@@ -384,6 +1011,9 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 
 int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 {
+#ifdef CONFIG_FS_POLLCACHE
+  FAR struct pollcache_s *cache;
+#endif
   sem_t sem;
   int count = 0;
   int errcode;
@@ -393,6 +1023,26 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   (void)enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Use the registrations cached for the task group, if possible */
+
+  cache = pollcache_acquire(nfds);
+  if (cache != NULL)
+    {
+      ret = pollcache_poll(cache, fds, nfds, timeout);
+      pollcache_unlock(cache);
+      leave_cancellation_point();
+
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      return ret;
+    }
+#endif
+
   /* This semaphore is used for signaling and, hence, should not have
    * priority inheritance enabled.
    */
@@ -403,60 +1053,19 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   ret = poll_setup(fds, nfds, &sem);
   if (ret >= 0)
     {
-      if (timeout == 0)
-        {
-          /* Poll returns immediately whether we have a poll event or not. */
+      /* Poll returns immediately (timeout == 0) whether we have a poll event
+       * or not.  Otherwise, wait for an event, a signal or the timeout.
+       */
 
-          ret = OK;
-        }
-      else if (timeout > 0)
+      ret = poll_wait(&sem, clock_systimer(), timeout);
+      if (ret == -ETIMEDOUT)
         {
-          systime_t ticks;
-
-          /* "Implementations may place limitations on the granularity of
-           * timeout intervals. If the requested timeout interval requires
-           * a finer granularity than the implementation supports, the
-           * actual timeout interval will be rounded up to the next
-           * supported value." -- opengroup.org
-           *
-           * Round timeout up to next full tick.
-           */
+          /* Return zero (OK) in the event of a timeout */
 
-#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
-    defined(CONFIG_HAVE_LONG_LONG)
-          ticks = (((unsigned long long)timeout * USEC_PER_MSEC) + (USEC_PER_TICK - 1)) /
-                  USEC_PER_TICK;
-#else
-          ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) / MSEC_PER_TICK;
-#endif
-
-          /* Either wait for either a poll event(s), for a signal to occur,
-           * or for the specified timeout to elapse with no event.
-           *
-           * NOTE: If a poll event is pending (i.e., the semaphore has already
-           * been incremented), sem_tickwait() will not wait, but will return
-           * immediately.
-           */
-
-           ret = sem_tickwait(&sem, clock_systimer(), ticks);
-           if (ret < 0)
-             {
-               if (ret == -ETIMEDOUT)
-                 {
-                   /* Return zero (OK) in the event of a timeout */
-
-                   ret = OK;
-                 }
-
-               /* EINTR is the only other error expected in normal operation */
-             }
+          ret = OK;
         }
-      else
-        {
-          /* Wait for the poll event or signal with no timeout */
 
-          ret = poll_semtake(&sem);
-        }
+      /* EINTR is the only other error expected in normal operation */
 
       /* Teardown the poll operation and get the count of events.  Zero will be
        * returned in the case of a timeout.
@@ -60,6 +60,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Descriptor lists up to this size are kept on the stack rather than
+ * allocated on each call.
+ */
+
+#define SELECT_NSTACKFDS 8
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -103,6 +109,7 @@
 int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
            FAR fd_set *exceptfds, FAR struct timeval *timeout)
 {
+  struct pollfd stackset[SELECT_NSTACKFDS];
   struct pollfd *pollset;
   int errcode = OK;
   int fd;
@@ -141,11 +148,19 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
 
   /* Allocate the descriptor list for poll() */
 
-  pollset = (struct pollfd *)kmm_zalloc(npfds * sizeof(struct pollfd));
-  if (!pollset)
+  if (npfds <= SELECT_NSTACKFDS)
     {
-      errcode = ENOMEM;
-      goto errout;
+      pollset = stackset;
+      memset(pollset, 0, npfds * sizeof(struct pollfd));
+    }
+  else
+    {
+      pollset = (struct pollfd *)kmm_zalloc(npfds * sizeof(struct pollfd));
+      if (!pollset)
+        {
+          errcode = ENOMEM;
+          goto errout;
+        }
     }
 
   /* Initialize the descriptor list for poll() */
@@ -280,7 +295,10 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
-  kmm_free(pollset);
+  if (pollset != stackset)
+    {
+      kmm_free(pollset);
+    }
 
   /* Did poll() fail above? */
 
@@ -47,14 +47,133 @@
 #include <assert.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
 #if CONFIG_NFILE_DESCRIPTORS > 0 && CONFIG_NET_SENDFILE
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_xip
+ *
+ * Description:
+ *   Write the data of a file that is directly accessible in memory to the
+ *   output descriptor without first copying it through an intermediate
+ *   buffer.
+ *
+ * Returned Value:
+ *   The number of bytes written or -1 with the errno set on a write
+ *   failure.  -ENOTTY is returned (without setting the errno) if the file
+ *   cannot be mapped and the caller must fall back to lib_sendfile().
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_xip(int outfd, FAR struct file *filep,
+                            FAR off_t *offset, size_t count)
+{
+  FAR const uint8_t *addr;
+  ssize_t nwritten;
+  ssize_t avail;
+  off_t pos;
+
+  pos   = offset ? *offset : filep->f_pos;
+  avail = file_xipmap(filep, pos, &addr);
+  if (avail < 0)
+    {
+      return -ENOTTY;
+    }
+
+  if (count > (size_t)avail)
+    {
+      count = avail;
+    }
+
+  nwritten = count > 0 ? write(outfd, addr, count) : 0;
+  if (nwritten > 0)
+    {
+      pos += nwritten;
+      if (offset)
+        {
+          *offset = pos;
+        }
+      else
+        {
+          filep->f_pos = pos;
+        }
+    }
+
+  return nwritten;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: file_xipmap
+ *
+ * Description:
+ *   Get the address in memory of the data of a file that can be accessed
+ *   directly in memory, such as a ROMFS file on XIP media.
+ *
+ * Input Parmeters:
+ *   filep - The open file
+ *   pos   - The file position of interest
+ *   addr  - The location to return the address of the data at 'pos'
+ *
+ * Returned Value:
+ *   The number of bytes from 'pos' to the end of the file on success.  A
+ *   negated errno value is returned if the file cannot be mapped.  The
+ *   file position is not changed and the errno is not modified.
+ *
+ ****************************************************************************/
+
+ssize_t file_xipmap(FAR struct file *filep, off_t pos,
+                    FAR const uint8_t **addr)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR uint8_t *base;
+  off_t curpos;
+  off_t size;
+  int ret;
+
+  if (inode == NULL || inode->u.i_ops == NULL ||
+      inode->u.i_ops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = inode->u.i_ops->ioctl(filep, FIOC_MMAP,
+                              (unsigned long)((uintptr_t)&base));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Get the size of the file while preserving the file position */
+
+  curpos = filep->f_pos;
+  size   = file_seek(filep, 0, SEEK_END);
+  (void)file_seek(filep, curpos, SEEK_SET);
+
+  if (size < 0)
+    {
+      return -ENOTTY;
+    }
+
+  if (pos < 0 || pos > size)
+    {
+      return -EINVAL;
+    }
+
+  *addr = base + pos;
+  return size - pos;
+}
+
 /****************************************************************************
  * Name: sendfile
  *
@@ -131,10 +250,27 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
   else
 #endif
     {
-      /* No... then this is probably a file-to-file transfer.  The generic
-       * lib_sendfile() can handle that case.
+      /* No... then this is probably a file-to-file transfer.  If the input
+       * file is directly accessible in memory, then it can be written from
+       * where it is.  Otherwise, the generic lib_sendfile() can handle that
+       * case.
        */
 
+      if ((unsigned int)infd < CONFIG_NFILE_DESCRIPTORS)
+        {
+          FAR struct file *filep = fs_getfilep(infd);
+          ssize_t ret;
+
+          if (filep != NULL)
+            {
+              ret = sendfile_xip(outfd, filep, offset, count);
+              if (ret != -ENOTTY)
+                {
+                  return ret;
+                }
+            }
+        }
+
       return lib_sendfile(outfd, infd, offset, count);
     }
 }
@@ -0,0 +1,409 @@
+/****************************************************************************
+ * fs/vfs/fs_signalfd.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/signalfd.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_SIGNALFD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct signalfd_s
+{
+  struct inode sf_inode;            /* Unnamed inode (must be first) */
+  FAR struct signalfd_s *sf_flink;  /* Next in g_signalfds */
+  FAR struct task_group_s *sf_group; /* Group whose signals are read */
+  sigset_t sf_mask;                 /* The signals that are read */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *sf_fds[CONFIG_FS_ANONFD_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     signalfd_close(FAR struct file *filep);
+static ssize_t signalfd_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+#ifndef CONFIG_DISABLE_POLL
+static int     signalfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                             bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_signalfd_ops =
+{
+  NULL,           /* open */
+  signalfd_close, /* close */
+  signalfd_read,  /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  NULL            /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , signalfd_poll /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL          /* unlink */
+#endif
+};
+
+/* All signalfd files.  Modified and searched in a critical section since
+ * signals may become pending at interrupt level.
+ */
+
+static FAR struct signalfd_s *g_signalfds;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: signalfd_pending
+ *
+ * Description:
+ *   Return true if one of the signals of the file is pending for the
+ *   calling thread.
+ *
+ ****************************************************************************/
+
+static bool signalfd_pending(FAR struct signalfd_s *dev)
+{
+  sigset_t pending;
+
+  if (sigpending(&pending) < 0)
+    {
+      return false;
+    }
+
+  return (pending & dev->sf_mask) != NULL_SIGNAL_SET;
+}
+
+/****************************************************************************
+ * Name: signalfd_close
+ ****************************************************************************/
+
+static int signalfd_close(FAR struct file *filep)
+{
+  FAR struct signalfd_s *dev = filep->f_inode->i_private;
+  FAR struct signalfd_s *prev;
+  FAR struct signalfd_s *curr;
+  irqstate_t flags;
+
+  /* The object itself is freed by inode_release() */
+
+  if (anonfd_lastref(filep))
+    {
+      flags = enter_critical_section();
+      for (prev = NULL, curr = g_signalfds;
+           curr != NULL && curr != dev;
+           prev = curr, curr = curr->sf_flink);
+
+      if (curr != NULL)
+        {
+          if (prev != NULL)
+            {
+              prev->sf_flink = curr->sf_flink;
+            }
+          else
+            {
+              g_signalfds = curr->sf_flink;
+            }
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: signalfd_read
+ *
+ * Description:
+ *   Accept pending signals of the mask as sigwaitinfo() does and return
+ *   one struct signalfd_siginfo for each.  Blocks until a signal is
+ *   pending unless the file is non-blocking.
+ *
+ ****************************************************************************/
+
+static ssize_t signalfd_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct signalfd_s *dev = filep->f_inode->i_private;
+  FAR struct signalfd_siginfo *ssi;
+  struct timespec notime;
+  struct siginfo info;
+  sigset_t mask;
+  ssize_t nread = 0;
+  int ret;
+
+  if (buflen < sizeof(struct signalfd_siginfo))
+    {
+      return -EINVAL;
+    }
+
+  notime.tv_sec  = 0;
+  notime.tv_nsec = 0;
+  mask = dev->sf_mask;
+
+  while (buflen - nread >= sizeof(struct signalfd_siginfo))
+    {
+      if (nread > 0 || (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          /* Only accept signals that are already pending.  Locking the
+           * scheduler keeps other threads from accepting the signal
+           * first.
+           */
+
+          sched_lock();
+          if (!signalfd_pending(dev))
+            {
+              sched_unlock();
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = sigtimedwait(&mask, &info, &notime);
+          sched_unlock();
+        }
+      else
+        {
+          ret = sigwaitinfo(&mask, &info);
+        }
+
+      if (ret < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      ssi = (FAR struct signalfd_siginfo *)&buffer[nread];
+      memset(ssi, 0, sizeof(struct signalfd_siginfo));
+      ssi->ssi_signo  = info.si_signo;
+      ssi->ssi_errno  = info.si_errno;
+      ssi->ssi_code   = info.si_code;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+      ssi->ssi_pid    = info.si_pid;
+      ssi->ssi_status = info.si_status;
+#endif
+      ssi->ssi_int    = info.si_value.sival_int;
+      memcpy(ssi->ssi_ptr, &info.si_value.sival_ptr,
+             sizeof(info.si_value.sival_ptr));
+
+      nread += sizeof(struct signalfd_siginfo);
+    }
+
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: signalfd_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int signalfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup)
+{
+  FAR struct signalfd_s *dev = filep->f_inode->i_private;
+  pollevent_t eventset = 0;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  if (setup && signalfd_pending(dev))
+    {
+      eventset = POLLIN;
+    }
+
+  ret = anonfd_poll(dev->sf_fds, fds, setup, eventset);
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: signalfd
+ *
+ * Description:
+ *   Create a file from which signals are read.  The file is readable in
+ *   poll() when one of the signals in the mask is pending in the task
+ *   group of the caller and read() accepts the pending signals as
+ *   sigwaitinfo() does.  The signals should be blocked with sigprocmask()
+ *   so that they are not delivered to a signal handler instead.
+ *
+ * Input Parameters:
+ *   fd    - -1 to create a new file, or an existing signalfd file whose
+ *           mask is replaced
+ *   mask  - The signals to read
+ *   flags - SFD_NONBLOCK and/or SFD_CLOEXEC
+ *
+ * Returned Value:
+ *   The file descriptor on success.  Otherwise -1 (ERROR) is returned and
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int signalfd(int fd, FAR const sigset_t *mask, int flags)
+{
+  FAR struct signalfd_s *dev;
+  FAR struct file *filep;
+  irqstate_t irqflags;
+  int errcode;
+
+  if (mask == NULL || (flags & ~(SFD_NONBLOCK | SFD_CLOEXEC)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  /* Replace the mask of an existing file? */
+
+  if (fd != -1)
+    {
+      filep = fs_getfilep(fd);
+      if (filep == NULL || filep->f_inode == NULL ||
+          filep->f_inode->u.i_ops != &g_signalfd_ops)
+        {
+          errcode = EINVAL;
+          goto errout;
+        }
+
+      dev = (FAR struct signalfd_s *)filep->f_inode->i_private;
+
+      irqflags = enter_critical_section();
+      dev->sf_mask = *mask;
+      leave_critical_section(irqflags);
+      return fd;
+    }
+
+  dev = (FAR struct signalfd_s *)kmm_zalloc(sizeof(struct signalfd_s));
+  if (dev == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  dev->sf_group = sched_self()->group;
+  dev->sf_mask  = *mask;
+
+  fd = anonfd_allocate(&dev->sf_inode, &g_signalfd_ops, dev,
+                       O_RDOK | (flags & SFD_NONBLOCK));
+  if (fd < 0)
+    {
+      kmm_free(dev);
+      errcode = -fd;
+      goto errout;
+    }
+
+  irqflags        = enter_critical_section();
+  dev->sf_flink   = g_signalfds;
+  g_signalfds     = dev;
+  leave_critical_section(irqflags);
+
+  finfo("fd=%d mask=%08x\n", fd, (unsigned int)*mask);
+  return fd;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: signalfd_notify
+ *
+ * Description:
+ *   Called by the signal logic when a signal becomes pending in a task
+ *   group.  Reports POLLIN to any signalfd of the group that accepts the
+ *   signal.
+ *
+ * Assumptions:
+ *   May be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+void signalfd_notify(FAR struct task_group_s *group, int signo)
+{
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct signalfd_s *dev;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  for (dev = g_signalfds; dev != NULL; dev = dev->sf_flink)
+    {
+      if (dev->sf_group == group && sigismember(&dev->sf_mask, signo) == 1)
+        {
+          anonfd_pollnotify(dev->sf_fds, POLLIN);
+        }
+    }
+
+  leave_critical_section(flags);
+#endif
+}
+
+#endif /* CONFIG_FS_SIGNALFD */
@@ -0,0 +1,550 @@
+/****************************************************************************
+ * fs/vfs/fs_timerfd.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/timerfd.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_TIMERFD
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The expiration count returned by read() */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+typedef uint64_t timerfd_count_t;
+#else
+typedef uint32_t timerfd_count_t;
+#endif
+
+struct timerfd_s
+{
+  struct inode tf_inode;          /* Unnamed inode (must be first) */
+  sem_t tf_rdsem;                 /* Readers wait here for an expiration */
+  WDOG_ID tf_wdog;                /* The timer */
+  clockid_t tf_clock;             /* Clock for absolute times */
+  int32_t tf_interval;            /* Reload value in ticks (0: one-shot) */
+  timerfd_count_t tf_expired;     /* Expirations since the last read */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *tf_fds[CONFIG_FS_ANONFD_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     timerfd_close(FAR struct file *filep);
+static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+#ifndef CONFIG_DISABLE_POLL
+static int     timerfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_timerfd_ops =
+{
+  NULL,          /* open */
+  timerfd_close, /* close */
+  timerfd_read,  /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL           /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , timerfd_poll /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timerfd_getdev
+ *
+ * Description:
+ *   Return the timer referred to by a file descriptor (or NULL).
+ *
+ ****************************************************************************/
+
+static FAR struct timerfd_s *timerfd_getdev(int fd)
+{
+  FAR struct file *filep = fs_getfilep(fd);
+
+  if (filep == NULL || filep->f_inode == NULL ||
+      filep->f_inode->u.i_ops != &g_timerfd_ops)
+    {
+      return NULL;
+    }
+
+  return (FAR struct timerfd_s *)filep->f_inode->i_private;
+}
+
+/****************************************************************************
+ * Name: timerfd_ts2ticks
+ *
+ * Description:
+ *   Convert a relative time to clock ticks, rounding up.
+ *
+ ****************************************************************************/
+
+static int32_t timerfd_ts2ticks(FAR const struct timespec *ts)
+{
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t ticks;
+
+  ticks = ((uint64_t)ts->tv_sec * NSEC_PER_SEC +
+           (uint64_t)ts->tv_nsec + NSEC_PER_TICK - 1) / NSEC_PER_TICK;
+#else
+  uint32_t ticks;
+
+  if (ts->tv_sec >= UINT32_MAX / MSEC_PER_SEC)
+    {
+      return INT32_MAX;
+    }
+
+  ticks = MSEC2TICK(ts->tv_sec * MSEC_PER_SEC +
+                    (ts->tv_nsec + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC);
+#endif
+
+  return ticks > INT32_MAX ? INT32_MAX : (int32_t)ticks;
+}
+
+/****************************************************************************
+ * Name: timerfd_ticks2ts
+ ****************************************************************************/
+
+static void timerfd_ticks2ts(int32_t ticks, FAR struct timespec *ts)
+{
+  ts->tv_sec  = ticks / TICK_PER_SEC;
+  ts->tv_nsec = (ticks - ts->tv_sec * TICK_PER_SEC) * NSEC_PER_TICK;
+}
+
+/****************************************************************************
+ * Name: timerfd_gettimeout
+ *
+ * Description:
+ *   Get the current setting of a timer.  Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void timerfd_gettimeout(FAR struct timerfd_s *dev,
+                               FAR struct itimerspec *value)
+{
+  int ticks = wd_gettime(dev->tf_wdog);
+
+  timerfd_ticks2ts(ticks, &value->it_value);
+  timerfd_ticks2ts(dev->tf_interval, &value->it_interval);
+}
+
+/****************************************************************************
+ * Name: timerfd_timeout
+ *
+ * Description:
+ *   The watchdog timer has expired.  Count the expiration and restart the
+ *   timer if it is periodic.
+ *
+ * Assumptions:
+ *   Runs in the timer interrupt.
+ *
+ ****************************************************************************/
+
+static void timerfd_timeout(int argc, wdparm_t arg1, ...)
+{
+  FAR struct timerfd_s *dev = (FAR struct timerfd_s *)arg1;
+  int sval;
+
+  DEBUGASSERT(argc == 1 && dev != NULL);
+
+  dev->tf_expired++;
+  if (dev->tf_interval > 0)
+    {
+      (void)wd_start(dev->tf_wdog, dev->tf_interval, timerfd_timeout, 1,
+                     (wdparm_t)dev);
+    }
+
+  while (sem_getvalue(&dev->tf_rdsem, &sval) == OK && sval < 0)
+    {
+      sem_post(&dev->tf_rdsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  anonfd_pollnotify(dev->tf_fds, POLLIN);
+#endif
+}
+
+/****************************************************************************
+ * Name: timerfd_close
+ ****************************************************************************/
+
+static int timerfd_close(FAR struct file *filep)
+{
+  FAR struct timerfd_s *dev = filep->f_inode->i_private;
+
+  /* The object itself is freed by inode_release() */
+
+  if (anonfd_lastref(filep))
+    {
+      (void)wd_delete(dev->tf_wdog);
+      sem_destroy(&dev->tf_rdsem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: timerfd_read
+ ****************************************************************************/
+
+static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct timerfd_s *dev = filep->f_inode->i_private;
+  timerfd_count_t value;
+  irqstate_t flags;
+
+  if (buflen < sizeof(timerfd_count_t))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  while (dev->tf_expired == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      if (sem_wait(&dev->tf_rdsem) < 0)
+        {
+          leave_critical_section(flags);
+          return -get_errno();
+        }
+    }
+
+  value = dev->tf_expired;
+  dev->tf_expired = 0;
+  leave_critical_section(flags);
+
+  memcpy(buffer, &value, sizeof(timerfd_count_t));
+  return sizeof(timerfd_count_t);
+}
+
+/****************************************************************************
+ * Name: timerfd_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int timerfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                        bool setup)
+{
+  FAR struct timerfd_s *dev = filep->f_inode->i_private;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  ret = anonfd_poll(dev->tf_fds, fds, setup,
+                    dev->tf_expired > 0 ? POLLIN : 0);
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: timerfd_create
+ *
+ * Description:
+ *   Create a timer that is read through a file descriptor.  The timer is
+ *   disarmed until timerfd_settime() is called.  The file is readable in
+ *   poll() when the timer has expired at least once and read() returns
+ *   the number of expirations since the last read() (or since the timer
+ *   was last set).
+ *
+ * Input Parameters:
+ *   clockid - The clock used for absolute times:  CLOCK_REALTIME or
+ *             CLOCK_MONOTONIC
+ *   flags   - TFD_NONBLOCK and/or TFD_CLOEXEC
+ *
+ * Returned Value:
+ *   A file descriptor referring to the timer on success.  Otherwise -1
+ *   (ERROR) is returned and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int timerfd_create(clockid_t clockid, int flags)
+{
+  FAR struct timerfd_s *dev;
+  int errcode;
+  int fd;
+
+  if ((flags & ~(TFD_NONBLOCK | TFD_CLOEXEC)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC)
+#else
+  if (clockid != CLOCK_REALTIME)
+#endif
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  dev = (FAR struct timerfd_s *)kmm_zalloc(sizeof(struct timerfd_s));
+  if (dev == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  dev->tf_wdog = wd_create();
+  if (dev->tf_wdog == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_dev;
+    }
+
+  dev->tf_clock = clockid;
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_init(&dev->tf_rdsem, 0, 0);
+  sem_setprotocol(&dev->tf_rdsem, SEM_PRIO_NONE);
+
+  fd = anonfd_allocate(&dev->tf_inode, &g_timerfd_ops, dev,
+                       O_RDOK | (flags & TFD_NONBLOCK));
+  if (fd < 0)
+    {
+      errcode = -fd;
+      goto errout_with_wdog;
+    }
+
+  finfo("fd=%d clockid=%d\n", fd, clockid);
+  return fd;
+
+errout_with_wdog:
+  sem_destroy(&dev->tf_rdsem);
+  (void)wd_delete(dev->tf_wdog);
+
+errout_with_dev:
+  kmm_free(dev);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: timerfd_settime
+ *
+ * Description:
+ *   Arm or disarm a timer.  The expiration count is reset.
+ *
+ * Input Parameters:
+ *   fd        - The timer file descriptor
+ *   flags     - TFD_TIMER_ABSTIME:  new_value->it_value is an absolute
+ *               time on the clock of the timer
+ *   new_value - The first expiration (zero to disarm) and the interval of
+ *               later expirations (zero for a one-shot timer)
+ *   old_value - If not NULL, the previous setting is returned here
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise -1 (ERROR) is returned and errno is
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int timerfd_settime(int fd, int flags,
+                    FAR const struct itimerspec *new_value,
+                    FAR struct itimerspec *old_value)
+{
+  FAR struct timerfd_s *dev;
+  struct timespec delay;
+  irqstate_t irqflags;
+  int32_t ticks;
+  int errcode;
+
+  dev = timerfd_getdev(fd);
+  if (dev == NULL)
+    {
+      errcode = EBADF;
+      goto errout;
+    }
+
+  if (new_value == NULL ||
+      (flags & ~TFD_TIMER_ABSTIME) != 0 ||
+      new_value->it_value.tv_nsec < 0 ||
+      new_value->it_value.tv_nsec >= NSEC_PER_SEC ||
+      new_value->it_interval.tv_nsec < 0 ||
+      new_value->it_interval.tv_nsec >= NSEC_PER_SEC)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  delay = new_value->it_value;
+  if ((flags & TFD_TIMER_ABSTIME) != 0 &&
+      (delay.tv_sec != 0 || delay.tv_nsec != 0))
+    {
+      struct timespec now;
+
+      (void)clock_gettime(dev->tf_clock, &now);
+      if (delay.tv_sec < now.tv_sec ||
+          (delay.tv_sec == now.tv_sec && delay.tv_nsec <= now.tv_nsec))
+        {
+          /* Already passed:  Expire on the next tick */
+
+          delay.tv_sec  = 0;
+          delay.tv_nsec = 1;
+        }
+      else
+        {
+          delay.tv_sec -= now.tv_sec;
+          delay.tv_nsec -= now.tv_nsec;
+          if (delay.tv_nsec < 0)
+            {
+              delay.tv_sec--;
+              delay.tv_nsec += NSEC_PER_SEC;
+            }
+        }
+    }
+
+  ticks = timerfd_ts2ticks(&delay);
+
+  irqflags = enter_critical_section();
+  if (old_value != NULL)
+    {
+      timerfd_gettimeout(dev, old_value);
+    }
+
+  (void)wd_cancel(dev->tf_wdog);
+  dev->tf_expired  = 0;
+  dev->tf_interval = timerfd_ts2ticks(&new_value->it_interval);
+
+  if (ticks > 0)
+    {
+      (void)wd_start(dev->tf_wdog, ticks, timerfd_timeout, 1,
+                     (wdparm_t)dev);
+    }
+
+  leave_critical_section(irqflags);
+  return OK;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: timerfd_gettime
+ *
+ * Description:
+ *   Return the time until the next expiration and the interval of a timer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise -1 (ERROR) is returned and errno is
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
+{
+  FAR struct timerfd_s *dev;
+  irqstate_t flags;
+
+  dev = timerfd_getdev(fd);
+  if (dev == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  if (curr_value == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  flags = enter_critical_section();
+  timerfd_gettimeout(dev, curr_value);
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_FS_TIMERFD */
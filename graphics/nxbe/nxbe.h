@@ -61,6 +61,13 @@
 #define NX_CLIPORDER_BRLT    (3)   /* Bottom-right-left-top */
 #define NX_CLIPORDER_DEFAULT NX_CLIPORDER_TLRB
 
+/* Rasterizing may be accelerated by framebuffer drivers */
+
+#undef NXBE_HWACCEL
+#if defined(CONFIG_FB_HWACCEL) && !defined(CONFIG_NX_LCDDRIVER)
+#  define NXBE_HWACCEL 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -97,6 +104,22 @@ struct nxbe_plane_s
                              FAR const struct nxgl_point_s *origin,
                              unsigned int srcstride);
 
+#ifdef NXBE_HWACCEL
+  /* The framebuffer driver and the software rasterizers that are used when
+   * the driver cannot accelerate an operation.
+   */
+
+  FAR NX_DRIVERTYPE *dev;
+  uint8_t planeno;
+
+  CODE void (*swfillrectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                               FAR const struct nxgl_rect_s *rect,
+                               nxgl_mxpixel_t color);
+  CODE void (*swmoverectangle)(FAR NX_PLANEINFOTYPE *pinfo,
+                               FAR const struct nxgl_rect_s *rect,
+                               FAR struct nxgl_point_s *offset);
+#endif
+
   /* Framebuffer plane info describing destination video plane */
 
   NX_PLANEINFOTYPE pinfo;
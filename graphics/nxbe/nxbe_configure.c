@@ -53,6 +53,12 @@
 #  define CONFIG_NX_BGCOLOR 0
 #endif
 
+/* Get the plane structure containing a plane info structure */
+
+#define NXBE_PLANE(p) \
+  ((FAR struct nxbe_plane_s *)((uintptr_t)(p) - \
+                               offsetof(struct nxbe_plane_s, pinfo)))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -66,6 +72,70 @@ static const nxgl_mxpixel_t g_bgcolor[CONFIG_NX_NPLANES] =
 #endif
 };
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_hwfillrectangle
+ *
+ * Description:
+ *   Fill a rectangle using the framebuffer driver, falling back to the
+ *   software rasterizer if the driver cannot perform the fill.
+ *
+ ****************************************************************************/
+
+#ifdef NXBE_HWACCEL
+static void nxbe_hwfillrectangle(FAR NX_PLANEINFOTYPE *pinfo,
+                                 FAR const struct nxgl_rect_s *rect,
+                                 nxgl_mxpixel_t color)
+{
+  FAR struct nxbe_plane_s *plane = NXBE_PLANE(pinfo);
+  struct fb_area_s area;
+
+  area.x = rect->pt1.x;
+  area.y = rect->pt1.y;
+  area.w = rect->pt2.x - rect->pt1.x + 1;
+  area.h = rect->pt2.y - rect->pt1.y + 1;
+
+  if (plane->dev->fillarea(plane->dev, plane->planeno, &area,
+                           (uint32_t)color) < 0)
+    {
+      plane->swfillrectangle(pinfo, rect, color);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxbe_hwmoverectangle
+ *
+ * Description:
+ *   Move a rectangle using the framebuffer driver, falling back to the
+ *   software rasterizer if the driver cannot perform the move.
+ *
+ ****************************************************************************/
+
+#ifdef NXBE_HWACCEL
+static void nxbe_hwmoverectangle(FAR NX_PLANEINFOTYPE *pinfo,
+                                 FAR const struct nxgl_rect_s *rect,
+                                 FAR struct nxgl_point_s *offset)
+{
+  FAR struct nxbe_plane_s *plane = NXBE_PLANE(pinfo);
+  struct fb_area_s area;
+
+  area.x = rect->pt1.x;
+  area.y = rect->pt1.y;
+  area.w = rect->pt2.x - rect->pt1.x + 1;
+  area.h = rect->pt2.y - rect->pt1.y + 1;
+
+  if (plane->dev->movearea(plane->dev, plane->planeno, &area,
+                           offset->x, offset->y) < 0)
+    {
+      plane->swmoverectangle(pinfo, rect, offset);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -219,6 +289,27 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
           gerr("ERROR: Unsupported pinfo[%d] BPP: %d\n", i, be->plane[i].pinfo.bpp);
           return -ENOSYS;
         }
+
+#ifdef NXBE_HWACCEL
+      /* Let the framebuffer driver perform the operations that it can
+       * accelerate.
+       */
+
+      be->plane[i].dev     = dev;
+      be->plane[i].planeno = i;
+
+      if (dev->fillarea != NULL)
+        {
+          be->plane[i].swfillrectangle = be->plane[i].fillrectangle;
+          be->plane[i].fillrectangle   = nxbe_hwfillrectangle;
+        }
+
+      if (dev->movearea != NULL)
+        {
+          be->plane[i].swmoverectangle = be->plane[i].moverectangle;
+          be->plane[i].moverectangle   = nxbe_hwmoverectangle;
+        }
+#endif
     }
   return OK;
 }
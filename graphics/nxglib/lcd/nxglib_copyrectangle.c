@@ -88,6 +88,21 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   remainder = NXGL_REMAINDERX(xoffset);
 #endif
 
+  /* If the LCD can write a whole area and the source pixels are byte
+   * aligned, then send the image in one operation.
+   */
+
+#if NXGLIB_BITSPERPIXEL < 8
+  if (pinfo->putarea != NULL && remainder == 0)
+#else
+  if (pinfo->putarea != NULL)
+#endif
+    {
+      (void)pinfo->putarea(dest->pt1.y, dest->pt2.y, dest->pt1.x,
+                           dest->pt2.x, sline, srcstride);
+      return;
+    }
+
   /* Copy the image, one row at a time */
 
   for (row = dest->pt1.y; row <= dest->pt2.y; row++)
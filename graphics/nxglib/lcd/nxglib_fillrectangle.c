@@ -84,7 +84,18 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
 
   NXGL_FUNCNAME(nxgl_fillrun, NXGLIB_SUFFIX)((NXGLIB_RUNTYPE *)pinfo->buffer, color, ncols);
 
-  /* Then fill the rectangle line-by-line */
+  /* If the LCD can write a whole area, then write the run into every row
+   * of the rectangle in one operation.
+   */
+
+  if (pinfo->putarea != NULL)
+    {
+      (void)pinfo->putarea(rect->pt1.y, rect->pt2.y, rect->pt1.x,
+                           rect->pt2.x, pinfo->buffer, 0);
+      return;
+    }
+
+  /* Otherwise, fill the rectangle line-by-line */
 
   for (row = rect->pt1.y; row <= rect->pt2.y; row++)
     {
@@ -74,6 +74,10 @@
 
 #define VT100_MAX_SEQUENCE 3
 
+/* Maximum number of characters drawn with one bitmap operation */
+
+#define NXTERM_RUNSIZE     32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -114,6 +118,7 @@ struct nxterm_bitmap_s
 {
   uint8_t code;                        /* Character code */
   uint8_t flags;                       /* See BMFLAGS_* */
+  uint8_t width;                       /* Character width in pixels */
   struct nxgl_point_s pos;             /* Character position */
 };
 
@@ -141,6 +146,18 @@ struct nxterm_state_s
 
   struct nxgl_point_s fpos;                 /* Next display position */
 
+#ifdef CONFIG_NXTERM_BATCHDRAW
+  /* Deferred drawing.  The characters in bm[] starting at index ndrawn have
+   * not yet been drawn and the display has not yet been scrolled by
+   * scrollpend rows.
+   */
+
+  uint16_t ndrawn;                          /* Number of chars on the display */
+  nxgl_coord_t scrollpend;                  /* Pending scroll in rows */
+  unsigned int stride;                      /* Width of a strip row in bytes */
+  FAR uint8_t *strip;                       /* Rendered text for one line */
+#endif
+
   /* VT100 escape sequence processing */
 
   char seq[VT100_MAX_SEQUENCE];             /* Buffered characters */
@@ -222,6 +239,10 @@ int nxterm_hidechar(FAR struct nxterm_state_s *priv,
 int nxterm_backspace(FAR struct nxterm_state_s *priv);
 void nxterm_fillchar(FAR struct nxterm_state_s *priv,
     FAR const struct nxgl_rect_s *rect, FAR const struct nxterm_bitmap_s *bm);
+#ifdef CONFIG_NXTERM_BATCHDRAW
+int nxterm_fillrun(FAR struct nxterm_state_s *priv,
+    FAR const struct nxterm_bitmap_s *bm, int nchars);
+#endif
 
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch);
 void nxterm_showcursor(FAR struct nxterm_state_s *priv);
@@ -230,5 +251,10 @@ void nxterm_hidecursor(FAR struct nxterm_state_s *priv);
 /* Scrolling support */
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight);
+#ifdef CONFIG_NXTERM_BATCHDRAW
+void nxterm_flush(FAR struct nxterm_state_s *priv);
+#else
+#  define nxterm_flush(p)
+#endif
 
 #endif /* __GRAPHICS_NXTERM_NXTERM_H */
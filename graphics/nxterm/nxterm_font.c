@@ -121,6 +121,7 @@ nxterm_addchar(FAR struct nxterm_state_s *priv, uint8_t ch)
           /* No, there is no font for this code.  Just mark this as a space. */
 
           bm->flags |= BMFLAGS_NOGLYPH;
+          bm->width  = priv->spwidth;
 
           /* Set up the next character position */
 
@@ -128,6 +129,8 @@ nxterm_addchar(FAR struct nxterm_state_s *priv, uint8_t ch)
         }
       else
         {
+          bm->width = glyph->width;
+
           /* Set up the next character position */
 
           priv->fpos.x += glyph->width;
@@ -202,7 +205,11 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
 
   if (priv->nchars > 0)
     {
-      /* Yes.. Get the index to the last bitmap on the display */
+      /* Yes.. Make sure that it has been drawn before erasing it */
+
+      nxterm_flush(priv);
+
+      /* Get the index to the last bitmap on the display */
 
       ndx = priv->nchars - 1;
       bm  = &priv->bm[ndx];
@@ -219,6 +226,9 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
       /* Decrement nchars to discard this character */
 
       priv->nchars = ndx;
+#ifdef CONFIG_NXTERM_BATCHDRAW
+      priv->ndrawn = ndx;
+#endif
     }
 
   return ret;
@@ -348,3 +358,78 @@ void nxterm_fillchar(FAR struct nxterm_state_s *priv,
       DEBUGASSERT(ret >= 0);
     }
 }
+
+/****************************************************************************
+ * Name: nxterm_fillrun
+ *
+ * Description:
+ *   Draw a run of characters that follow each other on one line with a
+ *   single bitmap operation.  The run starts with 'bm' and includes at most
+ *   'nchars' characters.
+ *
+ * Returned Value:
+ *   The number of characters that were drawn (always at least one).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXTERM_BATCHDRAW
+int nxterm_fillrun(FAR struct nxterm_state_s *priv,
+                   FAR const struct nxterm_bitmap_s *bm, int nchars)
+{
+  uint8_t codes[NXTERM_RUNSIZE];
+  struct nxgl_rect_s bounds;
+  struct nxgl_size_s size;
+  FAR const void *src;
+  nxgl_coord_t xend;
+  int nrun;
+  int ret;
+
+  /* Without a strip buffer, fall back to drawing one character */
+
+  if (priv->strip == NULL)
+    {
+      nxterm_fillchar(priv, NULL, bm);
+      return 1;
+    }
+
+  /* Collect the characters that directly follow each other on this line */
+
+  codes[0] = bm[0].code;
+  xend     = bm[0].pos.x + bm[0].width;
+
+  for (nrun = 1; nrun < nchars && nrun < NXTERM_RUNSIZE; nrun++)
+    {
+      if (bm[nrun].pos.y != bm[0].pos.y || bm[nrun].pos.x != xend)
+        {
+          break;
+        }
+
+      codes[nrun] = bm[nrun].code;
+      xend       += bm[nrun].width;
+    }
+
+  /* Render them into the strip */
+
+  size.w = priv->wndo.wsize.w - bm[0].pos.x;
+  size.h = priv->fheight;
+
+  ret = nxf_cache_renderstring(priv->fcache, codes, nrun, priv->strip,
+                               priv->stride, &size);
+  if (ret <= 0)
+    {
+      nxterm_fillchar(priv, NULL, bm);
+      return 1;
+    }
+
+  /* And blit the strip into the window */
+
+  bounds.pt1.x = bm[0].pos.x;
+  bounds.pt1.y = bm[0].pos.y;
+  bounds.pt2.x = bm[0].pos.x + size.w - 1;
+  bounds.pt2.y = bm[0].pos.y + size.h - 1;
+
+  src = (FAR const void *)priv->strip;
+  (void)priv->ops->bitmap(priv, &bounds, &src, &bm[0].pos, priv->stride);
+  return ret;
+}
+#endif
@@ -57,7 +57,9 @@
 
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
 {
+#ifndef CONFIG_NXTERM_BATCHDRAW
   FAR const struct nxterm_bitmap_s *bm;
+#endif
   int lineheight;
 
   /* Ignore carriage returns */
@@ -122,11 +124,17 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
    * display.
    */
 
+#ifndef CONFIG_NXTERM_BATCHDRAW
   bm = nxterm_addchar(priv, ch);
   if (bm)
     {
       nxterm_fillchar(priv, NULL, bm);
     }
+#else
+  /* The character will be drawn later by nxterm_flush() */
+
+  (void)nxterm_addchar(priv, ch);
+#endif
 }
 
 /****************************************************************************
@@ -162,6 +170,10 @@ void nxterm_showcursor(FAR struct nxterm_state_s *priv)
       nxterm_scroll(priv, lineheight);
     }
 
+  /* Draw any text that is still pending */
+
+  nxterm_flush(priv);
+
   /* Render the cursor glyph onto the display. */
 
   priv->cursor.pos.x = priv->fpos.x;
@@ -179,5 +191,6 @@ void nxterm_showcursor(FAR struct nxterm_state_s *priv)
 
 void nxterm_hidecursor(FAR struct nxterm_state_s *priv)
 {
+  nxterm_flush(priv);
   (void)nxterm_hidechar(priv, &priv->cursor);
 }
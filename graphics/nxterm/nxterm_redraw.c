@@ -108,6 +108,10 @@ void nxterm_redraw(NXTERM handle, FAR const struct nxgl_rect_s *rect, bool more)
     }
   while (ret < 0);
 
+  /* Bring the display up to date before redrawing part of it */
+
+  nxterm_flush(priv);
+
   /* Fill the rectangular region with the window background color */
 
   ret = priv->ops->fill(priv, rect, priv->wndo.wcolor);
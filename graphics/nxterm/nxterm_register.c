@@ -134,6 +134,19 @@ FAR struct nxterm_state_s *
   priv->fwidth    = fontset->mxwidth;
   priv->spwidth   = fontset->spwidth;
 
+#ifdef CONFIG_NXTERM_BATCHDRAW
+  /* Allocate the strip used to draw one line of text at a time.  If this
+   * fails, characters are simply drawn one at a time.
+   */
+
+  priv->stride    = (wndo->wsize.w * CONFIG_NXTERM_BPP + 7) >> 3;
+  priv->strip     = (FAR uint8_t *)kmm_malloc(priv->stride * priv->fheight);
+  if (priv->strip == NULL)
+    {
+      gwarn("WARNING: Failed to allocate the text strip\n");
+    }
+#endif
+
   /* Set up the text cache */
 
   priv->maxchars  = CONFIG_NXTERM_MXCHARS;
@@ -183,12 +183,17 @@ static inline void nxterm_movedisplay(FAR struct nxterm_state_s *priv,
 
 void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 {
+#ifdef CONFIG_NXTERM_BATCHDRAW
+  int ndrawn = 0;
+#endif
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Adjust the vertical position of each character, compacting the array
+   * in a single pass as characters are deleted.
+   */
 
-  for (i = 0; i < priv->nchars; )
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
       FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
 
@@ -196,40 +201,102 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
 
       if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
-
-          for (j = i; j < priv->nchars-1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j+1],
-                     sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
-           */
+          /* Yes... Delete the character by not keeping it */
 
-          priv->nchars--;
+          continue;
         }
 
       /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
+       * display by one line) and keep it.
        */
 
-      else
+      bm->pos.y -= scrollheight;
+      if (j != i)
         {
-          bm->pos.y -= scrollheight;
-
-          /* We are keeping this one so increment to the next character */
+          memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
+        }
 
-          i++;
+#ifdef CONFIG_NXTERM_BATCHDRAW
+      if (i < priv->ndrawn)
+        {
+          ndrawn++;
         }
+#endif
+
+      j++;
     }
 
+  priv->nchars = j;
+
   /* And move the next display position up by one line as well */
 
   priv->fpos.y -= scrollheight;
 
+#ifdef CONFIG_NXTERM_BATCHDRAW
+  /* Defer moving the display until nxterm_flush() so that all of the
+   * scrolling done by one write is a single move.
+   */
+
+  priv->ndrawn      = ndrawn;
+  priv->scrollpend += scrollheight;
+#else
   /* Move the display in the range of 0-height up one scrollheight. */
 
   nxterm_movedisplay(priv, priv->fpos.y, scrollheight);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxterm_flush
+ *
+ * Description:
+ *   Bring the display up to date:  Apply any pending scrolling and then
+ *   draw all characters that have been added but not yet drawn.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXTERM_BATCHDRAW
+void nxterm_flush(FAR struct nxterm_state_s *priv)
+{
+  struct nxgl_rect_s rect;
+  int ret;
+  int i;
+
+  if (priv->scrollpend > 0)
+    {
+      if (priv->scrollpend + CONFIG_NXTERM_LINESEPARATION >=
+          priv->wndo.wsize.h)
+        {
+          /* Everything that was on the display has scrolled off.  Just
+           * clear the window.
+           */
+
+          rect.pt1.x = 0;
+          rect.pt1.y = 0;
+          rect.pt2.x = priv->wndo.wsize.w - 1;
+          rect.pt2.y = priv->wndo.wsize.h - 1;
+
+          ret = priv->ops->fill(priv, &rect, priv->wndo.wcolor);
+          if (ret < 0)
+            {
+              gerr("ERROR: Fill failed: %d\n", errno);
+            }
+        }
+      else
+        {
+          nxterm_movedisplay(priv, priv->fpos.y, priv->scrollpend);
+        }
+
+      priv->scrollpend = 0;
+    }
+
+  /* Then draw the new characters, one run at a time */
+
+  for (i = priv->ndrawn; i < priv->nchars; )
+    {
+      i += nxterm_fillrun(priv, &priv->bm[i], priv->nchars - i);
+    }
+
+  priv->ndrawn = priv->nchars;
 }
+#endif
@@ -88,6 +88,15 @@ void nxterm_unregister(NXTERM handle)
 
   nxf_cache_disconnect(priv->fcache);
 
+#ifdef CONFIG_NXTERM_BATCHDRAW
+  /* Free the text strip */
+
+  if (priv->strip != NULL)
+    {
+      kmm_free(priv->strip);
+    }
+#endif
+
   /* Unregister the driver */
 
   snprintf(devname, NX_DEVNAME_SIZE, NX_DEVNAME_FORMAT, priv->minor);
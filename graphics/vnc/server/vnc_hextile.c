@@ -0,0 +1,661 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_FEATURES
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  define CONFIG_DEBUG_FEATURES 1
+#  define CONFIG_DEBUG_ERROR    1
+#  define CONFIG_DEBUG_WARN     1
+#  define CONFIG_DEBUG_INFO     1
+#  define CONFIG_DEBUG_GRAPHICS 1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure holds the state of one Hextile encoded rectangle */
+
+struct vnc_hextile_s
+{
+  FAR struct vnc_session_s *session;
+  FAR uint8_t *dest;           /* Next free byte in session->outbuf */
+  FAR uint8_t *end;            /* End of session->outbuf */
+  size_t nbytes;               /* Total number of bytes sent */
+  uint32_t bg;                 /* Background of the previous tile */
+  uint32_t fg;                 /* Foreground of the previous tile */
+  uint8_t colorfmt;            /* Remote color format */
+  uint8_t bytesperpixel;       /* Remote bytes per pixel */
+  bool bigendian;              /* True: Remote expects big-endian pixels */
+  bool bgvalid;                /* True: bg may be carried over */
+  bool fgvalid;                /* True: fg may be carried over */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send the encoded data accumulated in the output buffer.
+ *
+ * Input Parameters:
+ *   hex - The state of the Hextile encoded rectangle
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on a network failure.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct vnc_hextile_s *hex)
+{
+  FAR struct vnc_session_s *session = hex->session;
+  FAR const uint8_t *src;
+  size_t size;
+  ssize_t nsent;
+
+  src  = session->outbuf;
+  size = hex->dest - session->outbuf;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          int errcode = get_errno();
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               errcode);
+          DEBUGASSERT(errcode > 0);
+          return -errcode;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      hex->nbytes += nsent;
+      src         += nsent;
+      size        -= nsent;
+    }
+
+  hex->dest = session->outbuf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_reserve
+ *
+ * Description:
+ *   Make room for 'nbytes' bytes in the output buffer, sending the buffered
+ *   data if necessary.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_reserve(FAR struct vnc_hextile_s *hex, size_t nbytes)
+{
+  if (hex->dest + nbytes > hex->end)
+    {
+      return vnc_hextile_flush(hex);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_putpixel
+ *
+ * Description:
+ *   Add one pixel in the remote color format to the output buffer.  Room
+ *   must have been reserved.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_putpixel(FAR struct vnc_hextile_s *hex,
+                                 uint32_t pixel)
+{
+  switch (hex->bytesperpixel)
+    {
+      case 1:
+        *hex->dest = (uint8_t)pixel;
+        break;
+
+      case 2:
+        if (hex->bigendian)
+          {
+            rfb_putbe16(hex->dest, (uint16_t)pixel);
+          }
+        else
+          {
+            rfb_putle16(hex->dest, (uint16_t)pixel);
+          }
+        break;
+
+      default: /* 4 */
+        if (hex->bigendian)
+          {
+            rfb_putbe32(hex->dest, pixel);
+          }
+        else
+          {
+            rfb_putle32(hex->dest, pixel);
+          }
+        break;
+    }
+
+  hex->dest += hex->bytesperpixel;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_load
+ *
+ * Description:
+ *   Copy one tile from the local framebuffer into session->tile, converting
+ *   each pixel to the remote color format.  The tile is stored with a
+ *   stride of 'width' pixels.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_load(FAR struct vnc_hextile_s *hex,
+                             nxgl_coord_t x, nxgl_coord_t y,
+                             unsigned int width, unsigned int height)
+{
+  FAR struct vnc_session_s *session = hex->session;
+  FAR const lfb_color_t *src;
+  FAR uint32_t *dest;
+  unsigned int col;
+  unsigned int row;
+
+  dest = session->tile;
+  for (row = 0; row < height; row++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + row) + RFB_BYTESPERPIXEL * x);
+
+      switch (hex->colorfmt)
+        {
+          case FB_FMT_RGB8_222:
+            for (col = 0; col < width; col++)
+              {
+                *dest++ = vnc_convert_rgb8_222(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB8_332:
+            for (col = 0; col < width; col++)
+              {
+                *dest++ = vnc_convert_rgb8_332(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB16_555:
+            for (col = 0; col < width; col++)
+              {
+                *dest++ = vnc_convert_rgb16_555(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB16_565:
+            for (col = 0; col < width; col++)
+              {
+                *dest++ = vnc_convert_rgb16_565(*src++);
+              }
+            break;
+
+          default: /* FB_FMT_RGB32 */
+            for (col = 0; col < width; col++)
+              {
+                *dest++ = vnc_convert_rgb32_888(*src++);
+              }
+            break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_subrects
+ *
+ * Description:
+ *   Cover the pixels of the tile in session->tile that are not background
+ *   with sub-rectangles.  Each sub-rectangle is grown to the right and then
+ *   downward as far as the pixels have the same color.
+ *
+ * Returned Value:
+ *   The number of sub-rectangles in session->subrects.  -E2BIG is returned
+ *   if the sub-rectangles would not be smaller than the raw tile; the tile
+ *   should be then sent raw.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_subrects(FAR struct vnc_hextile_s *hex,
+                                unsigned int width, unsigned int height,
+                                uint32_t bg, bool colored)
+{
+  FAR struct vnc_session_s *session = hex->session;
+  FAR const uint32_t *tile = session->tile;
+  FAR struct vnc_subrect_s *subrect;
+  uint16_t covered[VNCSERVER_TILESIZE];
+  uint16_t mask;
+  uint32_t pixel;
+  unsigned int rawsize;
+  unsigned int cost;
+  unsigned int size;
+  unsigned int nsubrects;
+  unsigned int x;
+  unsigned int y;
+  unsigned int x2;
+  unsigned int y2;
+  unsigned int i;
+
+  memset(covered, 0, sizeof(covered));
+
+  /* The header may hold a background and a foreground pixel */
+
+  rawsize   = width * height * hex->bytesperpixel;
+  size      = 2 * hex->bytesperpixel + 1;
+  cost      = colored ? hex->bytesperpixel + 2 : 2;
+  nsubrects = 0;
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          pixel = tile[y * width + x];
+          if (pixel == bg || (covered[y] & (1 << x)) != 0)
+            {
+              continue;
+            }
+
+          /* Grow to the right while the color matches */
+
+          for (x2 = x + 1;
+               x2 < width && tile[y * width + x2] == pixel &&
+               (covered[y] & (1 << x2)) == 0;
+               x2++);
+
+          mask = (uint16_t)(((1ul << (x2 - x)) - 1) << x);
+
+          /* Then grow downward while the whole run matches */
+
+          for (y2 = y + 1; y2 < height && (covered[y2] & mask) == 0; y2++)
+            {
+              for (i = x; i < x2 && tile[y2 * width + i] == pixel; i++);
+              if (i < x2)
+                {
+                  break;
+                }
+            }
+
+          for (i = y; i < y2; i++)
+            {
+              covered[i] |= mask;
+            }
+
+          size += cost;
+          if (nsubrects >= VNCSERVER_MAXSUBRECTS || size >= rawsize)
+            {
+              return -E2BIG;
+            }
+
+          subrect        = &session->subrects[nsubrects++];
+          subrect->pixel = pixel;
+          subrect->xy    = (uint8_t)((x << 4) | y);
+          subrect->wh    = (uint8_t)(((x2 - x - 1) << 4) | (y2 - y - 1));
+        }
+    }
+
+  return nsubrects;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile of at most 16x16 pixels.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_tile(FAR struct vnc_hextile_s *hex,
+                            nxgl_coord_t x, nxgl_coord_t y,
+                            unsigned int width, unsigned int height)
+{
+  FAR struct vnc_session_s *session = hex->session;
+  FAR const uint32_t *tile = session->tile;
+  FAR const struct vnc_subrect_s *subrect;
+  unsigned int npixels;
+  unsigned int ncolors;
+  unsigned int nbg;
+  unsigned int i;
+  uint32_t bg;
+  uint32_t fg;
+  uint8_t subenc;
+  bool colored;
+  int nsubrects;
+  int ret;
+
+  vnc_hextile_load(hex, x, y, width, height);
+
+  /* Count the colors (up to three) and the background occurrences */
+
+  npixels = width * height;
+  bg      = tile[0];
+  fg      = bg;
+  ncolors = 1;
+  nbg     = 1;
+
+  for (i = 1; i < npixels; i++)
+    {
+      if (tile[i] == bg)
+        {
+          nbg++;
+        }
+      else if (ncolors == 1)
+        {
+          fg      = tile[i];
+          ncolors = 2;
+        }
+      else if (tile[i] != fg)
+        {
+          ncolors = 3;
+          break;
+        }
+    }
+
+  /* With two colors, the most frequent one is the background */
+
+  if (ncolors == 2 && 2 * nbg < npixels)
+    {
+      bg = fg;
+      fg = tile[0];
+    }
+
+  subenc = 0;
+  if (!hex->bgvalid || bg != hex->bg)
+    {
+      subenc |= RFB_SUBENCODING_BACK;
+    }
+
+  nsubrects = 0;
+  colored   = (ncolors > 2);
+
+  if (ncolors > 1)
+    {
+      nsubrects = vnc_hextile_subrects(hex, width, height, bg, colored);
+      if (nsubrects < 0)
+        {
+          /* Send the raw pixels.  Neither color carries over. */
+
+          ret = vnc_hextile_reserve(hex, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          *hex->dest++ = RFB_SUBENCODING_RAW;
+
+          for (i = 0; i < npixels; i++)
+            {
+              ret = vnc_hextile_reserve(hex, hex->bytesperpixel);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              vnc_hextile_putpixel(hex, tile[i]);
+            }
+
+          hex->bgvalid = false;
+          hex->fgvalid = false;
+          return OK;
+        }
+
+      subenc |= RFB_SUBENCODING_ANY;
+      if (colored)
+        {
+          subenc |= RFB_SUBENCODING_COLORED;
+        }
+      else if (!hex->fgvalid || fg != hex->fg)
+        {
+          subenc |= RFB_SUBENCODING_FORE;
+        }
+    }
+
+  /* Send the tile header */
+
+  ret = vnc_hextile_reserve(hex, 2 * hex->bytesperpixel + 2);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *hex->dest++ = subenc;
+
+  if ((subenc & RFB_SUBENCODING_BACK) != 0)
+    {
+      vnc_hextile_putpixel(hex, bg);
+    }
+
+  if ((subenc & RFB_SUBENCODING_FORE) != 0)
+    {
+      vnc_hextile_putpixel(hex, fg);
+    }
+
+  if ((subenc & RFB_SUBENCODING_ANY) != 0)
+    {
+      *hex->dest++ = (uint8_t)nsubrects;
+    }
+
+  /* Then the sub-rectangles */
+
+  for (i = 0; i < nsubrects; i++)
+    {
+      ret = vnc_hextile_reserve(hex, hex->bytesperpixel + 2);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      subrect = &session->subrects[i];
+      if (colored)
+        {
+          vnc_hextile_putpixel(hex, subrect->pixel);
+        }
+
+      *hex->dest++ = subrect->xy;
+      *hex->dest++ = subrect->wh;
+    }
+
+  /* Remember the colors that now carry over to the next tile */
+
+  hex->bg      = bg;
+  hex->bgvalid = true;
+
+  if (colored)
+    {
+      hex->fgvalid = false;
+    }
+  else if (ncolors == 2)
+    {
+      hex->fg      = fg;
+      hex->fgvalid = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update region using the Hextile encoding if the client supports
+ *  it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but not error was)
+ *   encountered.  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR struct rfb_rectangle_s *hrect;
+  struct vnc_hextile_s hex;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  int ret;
+
+  /* Check if the client supports the Hextile encoding */
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  /* The color format is sampled once; the whole rectangle must be encoded
+   * in the same format.
+   */
+
+  memset(&hex, 0, sizeof(struct vnc_hextile_s));
+  hex.session       = session;
+  hex.colorfmt      = session->colorfmt;
+  hex.bytesperpixel = (session->bpp + 7) >> 3;
+  hex.bigendian     = session->bigendian;
+
+  switch (hex.colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+      case FB_FMT_RGB8_332:
+      case FB_FMT_RGB16_555:
+      case FB_FMT_RGB16_565:
+      case FB_FMT_RGB32:
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", hex.colorfmt);
+        return -EINVAL;
+    }
+
+  DEBUGASSERT(rect->pt1.x <= rect->pt2.x && rect->pt1.y <= rect->pt2.y);
+  width  = rect->pt2.x - rect->pt1.x + 1;
+  height = rect->pt2.y - rect->pt1.y + 1;
+
+  /* Format the FrameBuffer Update with a single Hextile encoded rectangle */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect,       1);
+
+  hrect           = (FAR struct rfb_rectangle_s *)&update->rect;
+  rfb_putbe16(hrect->xpos,         rect->pt1.x);
+  rfb_putbe16(hrect->ypos,         rect->pt1.y);
+  rfb_putbe16(hrect->width,        width);
+  rfb_putbe16(hrect->height,       height);
+  rfb_putbe32(hrect->encoding,     RFB_ENCODING_HEXTILE);
+
+  hex.dest = session->outbuf +
+             SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+  hex.end  = session->outbuf + VNCSERVER_UPDATE_BUFSIZE;
+
+  /* Then the tiles, left-to-right, top-to-bottom.  The encoded data is
+   * sent whenever the output buffer fills.
+   */
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += VNCSERVER_TILESIZE)
+    {
+      height = MIN(VNCSERVER_TILESIZE, rect->pt2.y - y + 1);
+
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += VNCSERVER_TILESIZE)
+        {
+          width = MIN(VNCSERVER_TILESIZE, rect->pt2.x - x + 1);
+
+          ret = vnc_hextile_tile(&hex, x, y, width, height);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  ret = vnc_hextile_flush(&hex);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return (int)hex.nbytes;
+}
+
+#endif /* CONFIG_VNCSERVER_HEXTILE */
@@ -140,6 +140,12 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   session->nwhupd  = 0;
   session->change  = true;
 
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+  /* A new client has none of the tiles */
+
+  memset(session->tilehash, 0, sizeof(session->tilehash));
+#endif
+
   /* Careful not to disturb the keyboard/mouse callouts set by
    * vnc_fbinitialize().  Client related data left in garbage state.
    */
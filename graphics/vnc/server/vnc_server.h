@@ -166,6 +166,18 @@
 #define RFB_STRIDE          (RFB_BYTESPERPIXEL * CONFIG_VNCSERVER_SCREENWIDTH)
 #define RFB_SIZE            (RFB_STRIDE * CONFIG_VNCSERVER_SCREENHEIGHT)
 
+/* Hextile encoding and dirty tile tracking both work on 16x16 tiles */
+
+#define VNCSERVER_TILESIZE     16
+#define VNCSERVER_TILE_NPIXELS (VNCSERVER_TILESIZE * VNCSERVER_TILESIZE)
+#define VNCSERVER_MAXSUBRECTS  255
+
+#define VNCSERVER_XTILES \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + VNCSERVER_TILESIZE - 1) / VNCSERVER_TILESIZE)
+#define VNCSERVER_YTILES \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + VNCSERVER_TILESIZE - 1) / VNCSERVER_TILESIZE)
+#define VNCSERVER_NTILES       (VNCSERVER_XTILES * VNCSERVER_YTILES)
+
 /* RFB Port Number */
 
 #define RFB_PORT_BASE       5900
@@ -223,6 +235,17 @@ enum vnc_server_e
   VNCSERVER_STOPPED            /* The updater has stopped */
 };
 
+/* One Hextile sub-rectangle */
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+struct vnc_subrect_s
+{
+  uint32_t pixel;              /* Remote color of the sub-rectangle */
+  uint8_t xy;                  /* X and y position in the tile */
+  uint8_t wh;                  /* Width-1 and height-1 */
+};
+#endif
+
 /* This structure is used to queue FrameBufferUpdate event.  It includes a
  * pointer to support singly linked list.
  */
@@ -251,6 +274,9 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -271,6 +297,21 @@ struct vnc_session_s
   sem_t freesem;
   sem_t queuesem;
 
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+  /* Hash of the content of each tile when it was last sent, zero if the
+   * client does not have the tile.
+   */
+
+  uint32_t tilehash[VNCSERVER_NTILES];
+#endif
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  /* Hextile encoder work areas */
+
+  uint32_t tile[VNCSERVER_TILE_NPIXELS];
+  struct vnc_subrect_s subrects[VNCSERVER_MAXSUBRECTS];
+#endif
+
   /* I/O buffers for misc network send/receive */
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
@@ -498,6 +539,53 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the update region using the Hextile encoding if the client supports
+ *  it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but not error was)
+ *   encountered.  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_invalidate_tiles
+ *
+ * Description:
+ *  Forget that the client has the tiles in the rectangle so that they are
+ *  sent on the next update even if unchanged.  Used when the client
+ *  requests a non-incremental update.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The rectangular region in the local framebuffer.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+void vnc_invalidate_tiles(FAR struct vnc_session_s *session,
+                          FAR const struct nxgl_rect_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -351,6 +351,193 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_send_rect
+ *
+ * Description:
+ *  Send one rectangle of the local framebuffer to the client using the
+ *  best encoding that the client supports.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be sent.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_send_rect(FAR struct vnc_session_s *session,
+                         FAR struct nxgl_rect_s *rect)
+{
+  int ret;
+
+  /* Attempt to use RRE encoding (single color rectangles only) */
+
+  ret = vnc_rre(session, rect);
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  /* Then Hextile encoding */
+
+  if (ret == 0)
+    {
+      ret = vnc_hextile(session, rect);
+    }
+#endif
+
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_changed
+ *
+ * Description:
+ *  Hash the current content of one tile (FNV-1a) and compare it with the
+ *  hash of the content last sent to the client.  The saved hash is updated.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   tx, ty  - The tile column and row.
+ *
+ * Returned Value:
+ *   True if the tile must be sent.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+static bool vnc_tile_changed(FAR struct vnc_session_s *session,
+                             unsigned int tx, unsigned int ty)
+{
+  FAR const uint8_t *src;
+  unsigned int width;
+  unsigned int height;
+  unsigned int row;
+  unsigned int i;
+  uint32_t hash;
+  int ndx;
+
+  width  = MIN(VNCSERVER_TILESIZE,
+               CONFIG_VNCSERVER_SCREENWIDTH - tx * VNCSERVER_TILESIZE);
+  height = MIN(VNCSERVER_TILESIZE,
+               CONFIG_VNCSERVER_SCREENHEIGHT - ty * VNCSERVER_TILESIZE);
+
+  src  = session->fb + RFB_STRIDE * ty * VNCSERVER_TILESIZE +
+         RFB_BYTESPERPIXEL * tx * VNCSERVER_TILESIZE;
+  hash = 2166136261ul;
+
+  for (row = 0; row < height; row++)
+    {
+      for (i = 0; i < width * RFB_BYTESPERPIXEL; i++)
+        {
+          hash = (hash ^ src[i]) * 16777619ul;
+        }
+
+      src += RFB_STRIDE;
+    }
+
+  /* Zero is reserved to mark tiles that the client does not have */
+
+  if (hash == 0)
+    {
+      hash = 1;
+    }
+
+  ndx = ty * VNCSERVER_XTILES + tx;
+  if (session->tilehash[ndx] == hash)
+    {
+      return false;
+    }
+
+  session->tilehash[ndx] = hash;
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: vnc_send_dirty
+ *
+ * Description:
+ *  Send only the tiles intersecting the rectangle whose content changed
+ *  since they were last sent.  Adjacent changed tiles in a row of tiles are
+ *  sent as one rectangle.  Whole tiles are sent because the saved hash
+ *  describes the whole tile.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The update rectangle (already clipped to the screen).
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+static int vnc_send_dirty(FAR struct vnc_session_s *session,
+                          FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s dirty;
+  unsigned int tx1;
+  unsigned int tx2;
+  unsigned int ty1;
+  unsigned int ty2;
+  unsigned int tx;
+  unsigned int ty;
+  int start;
+  int ret;
+
+  tx1 = rect->pt1.x / VNCSERVER_TILESIZE;
+  tx2 = rect->pt2.x / VNCSERVER_TILESIZE;
+  ty1 = rect->pt1.y / VNCSERVER_TILESIZE;
+  ty2 = rect->pt2.y / VNCSERVER_TILESIZE;
+
+  for (ty = ty1; ty <= ty2; ty++)
+    {
+      start = -1;
+
+      for (tx = tx1; tx <= tx2 + 1; tx++)
+        {
+          if (tx <= tx2 && vnc_tile_changed(session, tx, ty))
+            {
+              /* Start or extend a run of changed tiles */
+
+              if (start < 0)
+                {
+                  start = tx;
+                }
+            }
+          else if (start >= 0)
+            {
+              /* Send the run of changed tiles ending at tx - 1 */
+
+              dirty.pt1.x = start * VNCSERVER_TILESIZE;
+              dirty.pt1.y = ty * VNCSERVER_TILESIZE;
+              dirty.pt2.x = MIN(tx * VNCSERVER_TILESIZE,
+                                CONFIG_VNCSERVER_SCREENWIDTH) - 1;
+              dirty.pt2.y = MIN((ty + 1) * VNCSERVER_TILESIZE,
+                                CONFIG_VNCSERVER_SCREENHEIGHT) - 1;
+
+              ret = vnc_send_rect(session, &dirty);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              start = -1;
+            }
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -394,15 +581,13 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
-      /* Attempt to use RRE encoding */
+      /* Send the rectangle (or only its changed tiles) */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
-        {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
-        }
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+      ret = vnc_send_dirty(session, &srcrect->rect);
+#else
+      ret = vnc_send_rect(session, &srcrect->rect);
+#endif
 
       /* Release the update structure */
 
@@ -637,3 +822,48 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_invalidate_tiles
+ *
+ * Description:
+ *  Forget that the client has the tiles in the rectangle so that they are
+ *  sent on the next update even if unchanged.  Used when the client
+ *  requests a non-incremental update.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - The rectangular region in the local framebuffer.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_DIRTYTILES
+void vnc_invalidate_tiles(FAR struct vnc_session_s *session,
+                          FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s intersection;
+  unsigned int tx;
+  unsigned int ty;
+
+  nxgl_rectintersect(&intersection, rect, &g_wholescreen);
+  if (nxgl_nullrect(&intersection))
+    {
+      return;
+    }
+
+  for (ty = intersection.pt1.y / VNCSERVER_TILESIZE;
+       ty <= intersection.pt2.y / VNCSERVER_TILESIZE;
+       ty++)
+    {
+      for (tx = intersection.pt1.x / VNCSERVER_TILESIZE;
+           tx <= intersection.pt2.x / VNCSERVER_TILESIZE;
+           tx++)
+        {
+          session->tilehash[ty * VNCSERVER_XTILES + tx] = 0;
+        }
+    }
+}
+#endif
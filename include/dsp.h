@@ -0,0 +1,210 @@
+/****************************************************************************
+ * include/dsp.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_DSP_H
+#define __INCLUDE_DSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_LIB_DSP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Q15 is a signed fraction in [-1, 1) with 15 fractional bits.  Filter
+ * coefficients that may exceed one in magnitude (biquads) use Q14, i.e.
+ * [-2, 2), stored in the same 16-bit type.
+ */
+
+#define q15ONE          0x7fff                  /* ~1.0 (0.999969...) */
+#define q15HALF         0x4000                  /* 0.5 */
+#define q15MAX          0x7fff
+#define q15MIN          (-0x8000)
+
+#define q14ONE          0x4000                  /* 1.0 */
+
+/* Conversions (no saturation; the caller must keep the argument in
+ * range)
+ */
+
+#define ftoq15(f)       ((q15_t)((f) * 32768.0F))
+#define q15tof(q)       (((float)(q)) / 32768.0F)
+#define ftoq14(f)       ((q15_t)((f) * 16384.0F))
+#define q14tof(q)       (((float)(q)) / 16384.0F)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+/* FIR filter instances.  The caller provides the coefficients, which are
+ * in natural order (h[0] .. h[ntaps-1]), and a state buffer of
+ * ntaps + blocksize - 1 samples.  blocksize is the largest number of
+ * samples processed in one pass; longer inputs are processed in several
+ * passes.
+ */
+
+struct dsp_fir_q15_s
+{
+  FAR const q15_t *coeffs;      /* Filter coefficients, Q15 */
+  FAR q15_t *state;             /* ntaps + blocksize - 1 samples */
+  uint16_t ntaps;               /* Number of filter taps */
+  uint16_t blocksize;           /* Samples processed per pass */
+};
+
+struct dsp_fir_f32_s
+{
+  FAR const float *coeffs;      /* Filter coefficients */
+  FAR float *state;             /* ntaps + blocksize - 1 samples */
+  uint16_t ntaps;               /* Number of filter taps */
+  uint16_t blocksize;           /* Samples processed per pass */
+};
+
+/* Biquad IIR cascades.  Each stage has five coefficients, in the order
+ * { b0, b1, b2, a1, a2 }, for the transfer function
+ *
+ *   H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+ *
+ * The Q15 version uses Q14 coefficients and four state samples per stage
+ * (direct form I); the float version uses two (transposed direct form
+ * II).
+ */
+
+struct dsp_biquad_q15_s
+{
+  FAR const q15_t *coeffs;      /* 5 * nstages coefficients, Q14 */
+  FAR q15_t *state;             /* 4 * nstages samples */
+  uint8_t nstages;              /* Number of second order sections */
+};
+
+struct dsp_biquad_f32_s
+{
+  FAR const float *coeffs;      /* 5 * nstages coefficients */
+  FAR float *state;             /* 2 * nstages samples */
+  uint8_t nstages;              /* Number of second order sections */
+};
+
+/* Real FFT instance.  The caller provides a twiddle buffer of n floats. */
+
+struct dsp_rfft_f32_s
+{
+  FAR float *twiddle;           /* n/2 complex twiddle factors */
+  uint16_t n;                   /* Transform length (power of two) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Vector operations.  The Q15 versions saturate. */
+
+void dsp_vadd_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *out,
+                  size_t n);
+void dsp_vsub_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *out,
+                  size_t n);
+void dsp_vscale_q15(FAR const q15_t *in, q15_t scale, FAR q15_t *out,
+                    size_t n);
+int64_t dsp_vdot_q15(FAR const q15_t *a, FAR const q15_t *b, size_t n);
+
+void dsp_vadd_f32(FAR const float *a, FAR const float *b, FAR float *out,
+                  size_t n);
+void dsp_vsub_f32(FAR const float *a, FAR const float *b, FAR float *out,
+                  size_t n);
+void dsp_vscale_f32(FAR const float *in, float scale, FAR float *out,
+                    size_t n);
+float dsp_vdot_f32(FAR const float *a, FAR const float *b, size_t n);
+void dsp_cmag_f32(FAR const float *in, FAR float *out, size_t n);
+
+/* FIR filters */
+
+void dsp_fir_init_q15(FAR struct dsp_fir_q15_s *fir,
+                      FAR const q15_t *coeffs, FAR q15_t *state,
+                      uint16_t ntaps, uint16_t blocksize);
+void dsp_fir_q15(FAR struct dsp_fir_q15_s *fir, FAR const q15_t *in,
+                 FAR q15_t *out, size_t n);
+
+void dsp_fir_init_f32(FAR struct dsp_fir_f32_s *fir,
+                      FAR const float *coeffs, FAR float *state,
+                      uint16_t ntaps, uint16_t blocksize);
+void dsp_fir_f32(FAR struct dsp_fir_f32_s *fir, FAR const float *in,
+                 FAR float *out, size_t n);
+
+/* Biquad IIR filters */
+
+void dsp_biquad_init_q15(FAR struct dsp_biquad_q15_s *iir,
+                         FAR const q15_t *coeffs, FAR q15_t *state,
+                         uint8_t nstages);
+void dsp_biquad_q15(FAR struct dsp_biquad_q15_s *iir, FAR const q15_t *in,
+                    FAR q15_t *out, size_t n);
+
+void dsp_biquad_init_f32(FAR struct dsp_biquad_f32_s *iir,
+                         FAR const float *coeffs, FAR float *state,
+                         uint8_t nstages);
+void dsp_biquad_f32(FAR struct dsp_biquad_f32_s *iir, FAR const float *in,
+                    FAR float *out, size_t n);
+
+/* Real FFT */
+
+int dsp_rfft_init_f32(FAR struct dsp_rfft_f32_s *fft, FAR float *twiddle,
+                      uint16_t n);
+void dsp_rfft_f32(FAR const struct dsp_rfft_f32_s *fft, FAR float *buf);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LIB_DSP */
+#endif /* __INCLUDE_DSP_H */
@@ -105,6 +105,17 @@
 #  define set_errno(e) do { errno = (int)(e); } while (0)
 #  define get_errno(e) errno
 
+#elif defined(CONFIG_TLS_ALIGNED) && !defined(CONFIG_BUILD_KERNEL)
+
+/* With aligned stack TLS, the errno of each thread lives in the TLS area at
+ * the base of its stack.  User code can then read and write it directly,
+ * without a system call, by masking the stack pointer.  set_errno() and
+ * get_errno() are still available as system calls.
+ */
+
+#  define __TLS_ERRNO_ACCESS 1
+#  define errno *__errno()
+
 #else
 
 /* We doing separate user-/kernel-mode builds, then the errno has to be
@@ -418,6 +429,10 @@ extern "C"
 
 FAR int *get_errno_ptr(void);
 
+#ifdef __TLS_ERRNO_ACCESS
+FAR int *__errno(void);
+#endif
+
 #ifndef __DIRECT_ERRNO_ACCESS
 void set_errno(int errcode);
 int  get_errno(void);
@@ -47,6 +47,44 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options at the SOL_PACKET level */
+
+#define PACKET_RX_RING        5    /* Set up the receive ring.
+                                    * arg: struct tpacket_req */
+#define PACKET_TX_RING        13   /* Set up the transmit ring.
+                                    * arg: struct tpacket_req */
+
+/* Values of tpacket_hdr::tp_status for frames in the receive ring */
+
+#define TP_STATUS_KERNEL      0    /* Frame is owned by the kernel */
+#define TP_STATUS_USER        (1 << 0) /* Frame holds data for the user */
+#define TP_STATUS_LOSING      (1 << 2) /* Frames were dropped before this one */
+
+/* Values of tpacket_hdr::tp_status for frames in the transmit ring */
+
+#define TP_STATUS_AVAILABLE   0    /* Frame is free for the user */
+#define TP_STATUS_SEND_REQUEST (1 << 0) /* Frame is ready to be sent */
+#define TP_STATUS_SENDING     (1 << 1) /* Frame is being sent */
+#define TP_STATUS_WRONG_FORMAT (1 << 2) /* Frame was not sent (bad tp_len) */
+
+/* Each frame starts with a struct tpacket_hdr.  A struct sockaddr_ll
+ * describing the frame follows at offset
+ * TPACKET_ALIGN(sizeof(struct tpacket_hdr)).  The frame data begins
+ * TPACKET_HDRLEN bytes from the start of the frame.  Frame sizes must be
+ * multiples of TPACKET_ALIGNMENT.
+ */
+
+#define TPACKET_ALIGNMENT     16
+#define TPACKET_ALIGN(x) \
+  (((x) + TPACKET_ALIGNMENT - 1) & ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN \
+  TPACKET_ALIGN(TPACKET_ALIGN(sizeof(struct tpacket_hdr)) + \
+                sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,4 +96,34 @@ struct sockaddr_ll
   int16_t  sll_ifindex;
 };
 
+/* Argument of the PACKET_RX_RING and PACKET_TX_RING socket options.  The
+ * ring consists of tp_block_nr blocks of tp_block_size bytes each.  Each
+ * block holds tp_block_size / tp_frame_size frames;  frames never cross a
+ * block boundary.  Setting tp_block_nr to zero frees the ring.
+ *
+ * After the rings have been set up, the RX ring followed by the TX ring is
+ * available at the address returned by mmap() on the socket descriptor.
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;  /* Minimal size of contiguous block */
+  unsigned int tp_block_nr;    /* Number of blocks */
+  unsigned int tp_frame_size;  /* Size of frame */
+  unsigned int tp_frame_nr;    /* Total number of frames */
+};
+
+/* Header at the start of each ring frame */
+
+struct tpacket_hdr
+{
+  unsigned long tp_status;     /* TP_STATUS_* values */
+  unsigned int   tp_len;       /* Length of the frame on the wire */
+  unsigned int   tp_snaplen;   /* Length of the data held in the ring */
+  unsigned short tp_mac;       /* Offset of the frame data */
+  unsigned short tp_net;       /* Offset of the network header */
+  unsigned int   tp_sec;       /* Time of reception (seconds) */
+  unsigned int   tp_usec;      /* Time of reception (microseconds) */
+};
+
 #endif  /* __INCLUDE_NETPACKET_PACKET_H */
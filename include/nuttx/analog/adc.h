@@ -55,6 +55,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
+#include <time.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/spi/spi.h>
 
@@ -77,6 +78,21 @@
 #  define CONFIG_ADC_NPOLLWAITERS 2
 #endif
 
+#ifdef CONFIG_ADC_STREAM
+#  ifndef CONFIG_ADC_STREAM_BLOCKSIZE
+#    define CONFIG_ADC_STREAM_BLOCKSIZE 256
+#  endif
+#  ifndef CONFIG_ADC_STREAM_NBLOCKS
+#    define CONFIG_ADC_STREAM_NBLOCKS 4
+#  elif CONFIG_ADC_STREAM_NBLOCKS < 3
+#    undef  CONFIG_ADC_STREAM_NBLOCKS
+#    define CONFIG_ADC_STREAM_NBLOCKS 3
+#  elif CONFIG_ADC_STREAM_NBLOCKS > 255
+#    undef  CONFIG_ADC_STREAM_NBLOCKS
+#    define CONFIG_ADC_STREAM_NBLOCKS 255
+#  endif
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -104,6 +120,27 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_STREAM
+  /* This method is called from the lower half when one half of its DMA double
+   * buffer has been filled while streaming (i.e., between ANIOC_STREAM_START
+   * and ANIOC_STREAM_STOP).  The samples are copied before returning, so the
+   * lower half may refill the buffer as soon as this method returns.
+   *
+   * Input Parameters:
+   *   dev      - The ADC device structure that was previously registered by
+   *              adc_register()
+   *   data     - The converted samples, in the order of the conversion sequence
+   *   nsamples - The number of samples in data
+   *
+   * Returned Value:
+   *   Zero on success; a negated errno value on failure.  -ENOMEM is returned if
+   *   the ring of blocks is full and samples were dropped.
+   */
+
+  CODE int (*au_receiveblock)(FAR struct adc_dev_s *dev,
+                              FAR const uint16_t *data, size_t nsamples);
+#endif
 };
 
 /* This describes on ADC message */
@@ -125,6 +162,22 @@ struct adc_fifo_s
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+#ifdef CONFIG_ADC_STREAM
+/* This describes one block of streamed ADC samples.  Blocks are returned by
+ * read() and by the ANIOC_STREAM_GETBLOCK ioctl command while streaming.
+ */
+
+struct adc_block_s
+{
+  struct timespec ab_time;               /* Time that the block was completed */
+  uint32_t     ab_seqno;                 /* Block sequence number.  A gap in the
+                                          * sequence means that blocks were lost */
+  uint16_t     ab_nsamples;              /* Number of valid samples in ab_data */
+  uint16_t     ab_reserved;
+  uint16_t     ab_data[CONFIG_ADC_STREAM_BLOCKSIZE]; /* The samples */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of can_register().
@@ -188,6 +241,13 @@ struct adc_dev_s
   sem_t                       ad_closesem;   /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+#ifdef CONFIG_ADC_STREAM
+  FAR struct adc_block_s     *ad_blocks;     /* Ring of streamed blocks (while streaming) */
+  uint32_t                    ad_seqno;      /* Sequence number of the next block */
+  uint8_t                     ad_bhead;      /* Index of the oldest filled block */
+  uint8_t                     ad_btail;      /* Index of the next block to fill */
+  bool                        ad_bheld;      /* Oldest block held by ANIOC_STREAM_GETBLOCK */
+#endif
 
   /* The following is a list of poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -65,8 +65,23 @@
                                            * IN: Threshold value
                                            * OUT: None */
 
+/* ADC streaming (CONFIG_ADC_STREAM) */
+
+#define ANIOC_STREAM_START    _ANIOC(0x0004) /* Start continuous conversion
+                                              * IN: None
+                                              * OUT: None */
+#define ANIOC_STREAM_STOP     _ANIOC(0x0005) /* Stop continuous conversion
+                                              * IN: None
+                                              * OUT: None */
+#define ANIOC_STREAM_GETBLOCK _ANIOC(0x0006) /* Get the oldest streamed block
+                                              * IN: Pointer to a block pointer
+                                              * OUT: The block pointer is set */
+#define ANIOC_STREAM_PUTBLOCK _ANIOC(0x0007) /* Release the oldest block
+                                              * IN: None
+                                              * OUT: None */
+
 #define AN_FIRST           0x0001         /* First common command */
-#define AN_NCMDS           3              /* Number of common commands */
+#define AN_NCMDS           7              /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half QE driver to the lower-half QE driver via the ioctl()
@@ -53,7 +53,7 @@
  *    This chip related declarations are retained in this header file.
  *
  *    NOTE: up_ is supposed to stand for microprocessor; the u is like the
- *    Greek letter micron: . So it would be P which is a common shortening
+ *    Greek letter micron: �. So it would be �P which is a common shortening
  *    of the word microprocessor.
  *
  * 2. Microprocessor-Specific Interfaces.
@@ -1630,8 +1630,8 @@ int up_timer_start(FAR const struct timespec *ts);
  *
  * Description:
  *   Return the TLS information structure for the currently executing thread.
- *   When TLS is enabled, up_create_stack() will align allocated stacks to
- *   the TLS_STACK_ALIGN value.  An instance of the following structure will
+ *   When CONFIG_TLS_ALIGNED is enabled, up_create_stack() will align
+ *   allocated stacks to the TLS_STACK_ALIGN value.  An instance of the following structure will
  *   be implicitly positioned at the "lower" end of the stack.  Assuming a
  *   "push down" stack, this is at the "far" end of the stack (and can be
  *   clobbered if the stack overflows).
@@ -1653,7 +1653,7 @@ int up_timer_start(FAR const struct timespec *ts);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_TLS
+#ifdef CONFIG_TLS_ALIGNED
 /* struct tls_info_s;
  * FAR struct tls_info_s *up_tls_info(void);
  *
@@ -1940,6 +1940,24 @@ char up_romgetc(FAR const char *ptr);
 void up_mdelay(unsigned int milliseconds);
 void up_udelay(useconds_t microseconds);
 
+/****************************************************************************
+ * Name: up_perf_init, up_perf_gettime, and up_perf_getfreq
+ *
+ * Description:
+ *   If CONFIG_ARCH_HAVE_PERF_EVENTS is selected, the platform provides a
+ *   free-running, 32-bit counter (such as a CPU cycle counter).
+ *   up_perf_init() starts the counter; its argument is platform-specific.
+ *   up_perf_gettime() returns the current count which wraps silently and
+ *   up_perf_getfreq() returns the frequency of the counter in Hz.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+void up_perf_init(FAR void *arg);
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#endif
+
 /****************************************************************************
  * These are standard interfaces that are exported by the OS for use by the
  * architecture specific logic
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_stage.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_STAGE_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_STAGE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/audio/audio.h>
+
+#ifdef CONFIG_AUDIO_STAGE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An audio processing stage is a software element (a resampler, mixer,
+ * gain or equalizer, ...) that is inserted in front of an audio lower half
+ * driver.  The stage is itself an audio lower half so that stages may be
+ * chained, for example:
+ *
+ *   pcm_decode_initialize(audio_stage_initialize(
+ *     audio_stage_initialize(codec, &g_mixerops, mixer),
+ *     &g_resampleops, resampler))
+ *
+ * Audio pipeline buffers are passed from stage to stage by reference:
+ * each stage operates on the buffer in place and then hands the same
+ * buffer to the next stage.  Since buffer allocation is also forwarded,
+ * buffers are allocated by the final (typically DMA-capable) lower half
+ * if it provides an allocbuffer method.
+ */
+
+struct audio_stageops_s
+{
+  /* Called when the stage is configured (with the same capabilities that
+   * are then passed on to the next stage).  Optional.
+   */
+
+  CODE int (*configure)(FAR void *arg, FAR const struct audio_caps_s *caps);
+
+  /* Process the audio data of one buffer in place.  Data between
+   * apb->curbyte and apb->nbytes is valid; the stage may change both but
+   * may never exceed apb->nmaxbytes.  A negated errno value fails the
+   * enqueue operation.  Required.
+   */
+
+  CODE int (*process)(FAR void *arg, FAR struct ap_buffer_s *apb);
+
+  /* Discard any state retained between buffers when the stream is stopped
+   * or the device is shut down.  Optional.
+   */
+
+  CODE void (*reset)(FAR void *arg);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_stage_initialize
+ *
+ * Description:
+ *   Create an audio processing stage in front of a lower half audio device.
+ *
+ * Input Parameters:
+ *   dev - The lower half audio device (or the next stage) that receives
+ *         the processed audio buffers.
+ *   ops - The processing operations of the new stage.
+ *   arg - An opaque argument passed to each processing operation.
+ *
+ * Returned Value:
+ *   On success, a new audio device instance is returned that wraps the
+ *   lower half device.  NULL is returned on failure.
+ *
+ ****************************************************************************/
+
+FAR struct audio_lowerhalf_s *
+  audio_stage_initialize(FAR struct audio_lowerhalf_s *dev,
+                         FAR const struct audio_stageops_s *ops,
+                         FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_STAGE */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_STAGE_H */
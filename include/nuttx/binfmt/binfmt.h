@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <nxflat.h>
 
 #include <nuttx/arch.h>
@@ -70,6 +71,30 @@ typedef FAR void *EXEPATH_HANDLE;
 typedef FAR void (*binfmt_ctor_t)(void);
 typedef FAR void (*binfmt_dtor_t)(void);
 
+/* This describes the text (I-space) region of a loaded program.  With
+ * CONFIG_BINFMT_SHARED_TEXT, the text of a program that does not depend
+ * on the per-instance data is registered so that later instances of the
+ * same, unmodified file map the same code and only get private data.  The
+ * region is released when the last instance using it is unloaded.
+ */
+
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+struct binfmt_text_s
+{
+  FAR struct binfmt_text_s *flink;     /* Supports a singly linked list */
+  FAR char *filename;                  /* Full path to the program file */
+  off_t filesize;                      /* Size of the file when loaded */
+  time_t mtime;                        /* Modification time when loaded */
+  FAR const struct symtab_s *exports;  /* Symbol table the text is bound to */
+  int nexports;                        /* The number of symbols in exports[] */
+  FAR void *addr;                      /* Start of the text region */
+  size_t size;                         /* Size of the text region */
+  bool mapped;                         /* True: mmap'ed; false: kumm_malloc'ed */
+  bool shared;                         /* Registered for use by other instances */
+  int16_t crefs;                       /* Number of instances using the text */
+};
+#endif
+
 /* This describes the file to be loaded.
  *
  * NOTE 1: The 'filename' must be the full, absolute path to the file to be
@@ -113,6 +138,9 @@ struct binary_s
   main_t entrypt;                      /* Entry point into a program module */
   FAR void *mapped;                    /* Memory-mapped, address space */
   FAR void *alloc[BINFMT_NALLOC];      /* Allocated address spaces */
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  FAR struct binfmt_text_s *text;      /* Text region, possibly shared */
+#endif
 
   /* Constructors/destructors */
 
@@ -315,6 +343,74 @@ int schedule_unload(pid_t pid, FAR struct binary_s *bin);
 int exec(FAR const char *filename, FAR char * const *argv,
          FAR const struct symtab_s *exports, int nexports);
 
+/****************************************************************************
+ * Name: binfmt_text_find
+ *
+ * Description:
+ *   Look for the registered text region of an earlier instance of the
+ *   program file 'filename' that was bound against the same symbol table
+ *   and that has not been modified since.  If found, a reference is added
+ *   that must be dropped with binfmt_text_release().
+ *
+ * Input Parameter:
+ *   filename - Full path to the program file
+ *   exports  - Table of exported symbols the program is bound to (NULL if
+ *              the text does not depend on it)
+ *   nexports - The number of symbols in exports
+ *
+ * Returned Value:
+ *   The text region on success; NULL if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+FAR struct binfmt_text_s *
+binfmt_text_find(FAR const char *filename,
+                 FAR const struct symtab_s *exports, int nexports);
+
+/****************************************************************************
+ * Name: binfmt_text_alloc
+ *
+ * Description:
+ *   Create the descriptor of a newly loaded text region.  The descriptor
+ *   takes over the region (which is freed with kumm_free() or munmap()
+ *   according to 'mapped') and holds one reference to it.  The region is
+ *   not visible to binfmt_text_find() until binfmt_text_share() is called.
+ *
+ * Returned Value:
+ *   The new descriptor on success; NULL if out of memory, in which case the
+ *   caller still owns the region.
+ *
+ ****************************************************************************/
+
+FAR struct binfmt_text_s *
+binfmt_text_alloc(FAR const char *filename,
+                  FAR const struct symtab_s *exports, int nexports,
+                  FAR void *addr, size_t size, bool mapped);
+
+/****************************************************************************
+ * Name: binfmt_text_share
+ *
+ * Description:
+ *   Make a text region created by binfmt_text_alloc() available to later
+ *   instances of the same program.
+ *
+ ****************************************************************************/
+
+void binfmt_text_share(FAR struct binfmt_text_s *text);
+
+/****************************************************************************
+ * Name: binfmt_text_release
+ *
+ * Description:
+ *   Drop one reference to a text region.  The region is freed when the
+ *   last reference is dropped.
+ *
+ ****************************************************************************/
+
+void binfmt_text_release(FAR struct binfmt_text_s *text);
+#endif
+
 /****************************************************************************
  * Name: exepath_init
  *
@@ -72,6 +72,10 @@
 #  define CONFIG_ELF_BUFFERINCR 32
 #endif
 
+#ifndef CONFIG_ELF_XIP_NSYMCACHE
+#  define CONFIG_ELF_XIP_NSYMCACHE 0
+#endif
+
 /* Allocation array size and indices */
 
 #define LIBELF_ELF_ALLOC     0
@@ -87,6 +91,10 @@
  * Public Types
  ****************************************************************************/
 
+#if defined(CONFIG_ELF_XIP) && CONFIG_ELF_XIP_NSYMCACHE > 0
+struct elf_symcache_s; /* Opaque, defined in binfmt/libelf/libelf_symcache.c */
+#endif
+
 /* This struct provides a description of the currently loaded instantiation
  * of an ELF binary.
  */
@@ -107,6 +115,7 @@ struct elf_loadinfo_s
 
   uintptr_t         textalloc;   /* .text memory allocated when ELF file was loaded */
   uintptr_t         dataalloc;   /* .bss/.data memory allocated when ELF file was loaded */
+  uintptr_t         textbase;    /* Address of the first .text section (entry base) */
   size_t            textsize;    /* Size of the ELF .text memory allocation */
   size_t            datasize;    /* Size of the ELF .bss/.data memory allocation */
   off_t             filelen;     /* Length of the entire ELF file */
@@ -114,6 +123,35 @@ struct elf_loadinfo_s
   FAR Elf32_Shdr    *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
 
+  /* Execute-in-place support.
+   *
+   * xipbase  - If the ELF file lies in memory-mapped storage, this is the
+   *   address of the start of the file.  Read-only sections that need no
+   *   relocation are then used in place and all file accesses become memory
+   *   copies.  Zero if the file is not memory mapped.
+   * symcache - Cached values of imported symbols (see libelf_symcache.c)
+   */
+
+#ifdef CONFIG_ELF_XIP
+  uintptr_t          xipbase;    /* Address of the memory-mapped file (or 0) */
+#if CONFIG_ELF_XIP_NSYMCACHE > 0
+  FAR struct elf_symcache_s *symcache; /* Imported symbol values cache */
+#endif
+#endif
+
+  /* Shared text support.
+   *
+   * text        - The text of a running instance of the same file that is
+   *   reused instead of loading another copy (or NULL).
+   * textprivate - Set if the text refers to per-instance data so that it
+   *   cannot be shared with later instances.
+   */
+
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  FAR struct binfmt_text_s *text; /* Text of an earlier instance */
+  bool               textprivate; /* Text may not be shared */
+#endif
+
   /* Constructors and destructors */
 
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
@@ -73,6 +73,9 @@ struct nxflat_loadinfo_s
   uintptr_t ispace;        /* Address where hdr/text is loaded */
   uint32_t entryoffs;      /* Offset from ispace to entry point */
   uint32_t isize;          /* Size of ispace. */
+#ifdef CONFIG_BINFMT_SHARED_TEXT
+  FAR struct binfmt_text_s *text; /* ISpace of an earlier instance */
+#endif
 
   /* Data Space (DSpace): This region contains all information that is
    * referenced as data (other than the stack which is separately allocated).
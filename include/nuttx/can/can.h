@@ -48,6 +48,10 @@
 #include <stdbool.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_CAN_TIMESTAMP
+#  include <sys/time.h>
+#endif
+
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -71,6 +75,10 @@
  *   just means handling encoded DLC values (for values of DLC > 9).
  * CONFIG_CAN_FIFOSIZE - The size of the circular buffer of CAN messages.
  *   Default: 8
+ * CONFIG_CAN_RXFIFOSIZE - The size of the circular buffer of received CAN
+ *   messages.  Default: CONFIG_CAN_FIFOSIZE
+ * CONFIG_CAN_TIMESTAMP - Record the time that each CAN message was received in
+ *   the ch_ts field of the CAN message header.
  * CONFIG_CAN_NPENDINGRTR - The size of the list of pending RTR requests.
  *   Default: 4
  * CONFIG_CAN_LOOPBACK - A CAN driver may or may not support a loopback
@@ -98,6 +106,13 @@
 #  define CONFIG_CAN_FIFOSIZE 255
 #endif
 
+#if !defined(CONFIG_CAN_RXFIFOSIZE)
+#  define CONFIG_CAN_RXFIFOSIZE CONFIG_CAN_FIFOSIZE
+#elif CONFIG_CAN_RXFIFOSIZE > 1024
+#  undef  CONFIG_CAN_RXFIFOSIZE
+#  define CONFIG_CAN_RXFIFOSIZE 1024
+#endif
+
 #if !defined(CONFIG_CAN_NPENDINGRTR)
 #  define CONFIG_CAN_NPENDINGRTR 4
 #elif CONFIG_CAN_NPENDINGRTR > 255
@@ -398,6 +413,10 @@
  *               Bit 7:      Unused
  *   Bytes 5-12: CAN data    Size determined by DLC
  *
+ * If CONFIG_CAN_TIMESTAMP is selected, then a struct timeval holding the time
+ * that the message was received follows the flags (and precedes the CAN data)
+ * in both formats.
+ *
  * NOTE: The error indication if valid only on message reports received from the
  * CAN driver; it is ignored on transmission.  When the error bit is set, the
  * message ID is an encoded set of error indications (see CAN_ERROR_* definitions).
@@ -421,6 +440,9 @@ begin_packed_struct struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time that the message was received */
+#endif
 } end_packed_struct;
 #else
 begin_packed_struct struct can_hdr_s
@@ -432,6 +454,9 @@ begin_packed_struct struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time that the message was received */
+#endif
 } end_packed_struct;
 #endif
 
@@ -446,10 +471,10 @@ begin_packed_struct struct can_msg_s
 struct can_rxfifo_s
 {
   sem_t         rx_sem;                  /* Counting semaphore */
-  uint8_t       rx_head;                 /* Index to the head [IN] in the circular buffer */
-  uint8_t       rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
+  uint16_t      rx_head;                 /* Index to the head [IN] in the circular buffer */
+  uint16_t      rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
                                          /* Circular buffer of CAN messages */
-  struct can_msg_s rx_buffer[CONFIG_CAN_FIFOSIZE];
+  struct can_msg_s rx_buffer[CONFIG_CAN_RXFIFOSIZE];
 };
 
 struct can_txfifo_s
@@ -42,13 +42,38 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stddef.h>
 #include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#define AES_BLOCK_SIZE     16
+
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_MAXROUNDS      14  /* AES-256 */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An expanded AES key.  The key schedule is computed once by
+ * aes_ctx_setkey() and may then be used for any number of blocks.
+ */
+
+struct aes_context_s
+{
+  uint32_t ek[4 * (AES_MAXROUNDS + 1)];  /* Encryption round keys */
+#ifdef CONFIG_CRYPTO_AES_TTABLE
+  uint32_t dk[4 * (AES_MAXROUNDS + 1)];  /* Equivalent inverse cipher keys */
+#endif
+  uint8_t  nrounds;                      /* 10, 12 or 14 rounds */
+};
 
 /****************************************************************************
  * Public Data
@@ -61,7 +86,7 @@ extern "C"
 
 /****************************************************************************
  * Public Function Prototypes
-/****************************************************************************
+ ****************************************************************************/
 
 /****************************************************************************
  * Name: aes_encrypt
@@ -101,6 +126,69 @@ void aes_encrypt(FAR uint8_t *state, FAR const uint8_t *key);
 
 void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
 
+/****************************************************************************
+ * Name: aes_ctx_setkey
+ *
+ * Description:
+ *   Compute the encryption and decryption key schedules of a 128, 192 or
+ *   256-bit AES key.
+ *
+ * Input Parameters:
+ *   ctx    - The context to initialize
+ *   key    - The key
+ *   keylen - The size of the key in bytes:  16, 24 or 32
+ *
+ * Returned Value
+ *   Zero (OK) on success; -EINVAL if the key size is not supported.
+ *
+ ****************************************************************************/
+
+int aes_ctx_setkey(FAR struct aes_context_s *ctx, FAR const uint8_t *key,
+                   size_t keylen);
+
+/****************************************************************************
+ * Name: aes_ctx_encrypt and aes_ctx_decrypt
+ *
+ * Description:
+ *   Encrypt or decrypt one 16 byte block with an expanded key.  'in' and
+ *   'out' may be the same buffer.
+ *
+ ****************************************************************************/
+
+void aes_ctx_encrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                     FAR const uint8_t *in);
+void aes_ctx_decrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                     FAR const uint8_t *in);
+
+/****************************************************************************
+ * Name: aes_ctx_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt a buffer in one of the AES_MODE_* modes of
+ *   include/nuttx/crypto/crypto.h.  This is the software counterpart of
+ *   aes_cypher() but without the key schedule setup.
+ *
+ * Input Parameters:
+ *   ctx     - The expanded key
+ *   out     - The output buffer
+ *   in      - The input buffer.  May be the same as out.
+ *   size    - The size of the buffers; a multiple of AES_BLOCK_SIZE
+ *   iv      - The initialization vector or initial counter block of CBC,
+ *             CFB and CTR modes.  NULL means all zeros.
+ *   mode    - AES_MODE_ECB, AES_MODE_CBC, AES_MODE_CTR or AES_MODE_CFB
+ *   encrypt - CYPHER_ENCRYPT or CYPHER_DECRYPT
+ *
+ * Returned Value
+ *   Zero (OK) on success; -EINVAL if the size or mode is not supported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_AES
+int aes_ctx_cypher(FAR const struct aes_context_s *ctx, FAR void *out,
+                   FAR const void *in, uint32_t size, FAR const void *iv,
+                   int mode, int encrypt);
+#endif
+
 #ifdef  __cplusplus
 }
 #endif /* __cplusplus */
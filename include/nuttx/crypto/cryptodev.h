@@ -41,6 +41,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -65,6 +68,9 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCCRYPTM              104 /* Several operations, struct crypt_mop */
+#define CIOCASYNCCRYPT          105 /* Queue operations, struct crypt_mop */
+#define CIOCASYNCFETCH          106 /* Get results, struct crypt_fetch */
 
 typedef char* caddr_t;
 
@@ -92,4 +98,37 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* CIOCCRYPTM performs the operations in order in the context of the
+ * caller.  CIOCASYNCCRYPT queues them (all or none) to be performed in the
+ * background; the crypt_op structures are copied, but the buffers that
+ * they refer to must remain valid until the operation has been fetched.
+ * Sessions must not be freed while they have operations in progress.
+ */
+
+struct crypt_mop
+{
+  unsigned count;               /* Number of operations in ops[] */
+  FAR struct crypt_op *ops;     /* The operations */
+};
+
+/* The result of one asynchronous operation */
+
+struct crypt_result
+{
+  FAR struct crypt_op *op;      /* The operation passed to CIOCASYNCCRYPT */
+  int status;                   /* OK or a negated errno value */
+};
+
+/* CIOCASYNCFETCH returns up to count results of completed operations in
+ * completion order.  It waits for a completion if there are none yet,
+ * unless the device was opened with O_NONBLOCK.  poll() reports POLLIN
+ * when results are available.
+ */
+
+struct crypt_fetch
+{
+  unsigned count;               /* In: size of results[]; out: number set */
+  FAR struct crypt_result *results;
+};
+
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
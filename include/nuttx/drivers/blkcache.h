@@ -0,0 +1,223 @@
+/****************************************************************************
+ * include/nuttx/drivers/blkcache.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_BLKCACHE_H
+#define __INCLUDE_NUTTX_DRIVERS_BLKCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_DRVR_BLKCACHE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Data transfer callouts.  These must be provided by the block driver
+ * logic in order to read blocks that are not in the cache and to write
+ * dirty blocks back to the media.
+ */
+
+typedef ssize_t (*blkcache_reload_t)(FAR void *dev, FAR uint8_t *buffer,
+                                     off_t startblock, size_t nblocks);
+typedef ssize_t (*blkcache_flush_t)(FAR void *dev,
+                                    FAR const uint8_t *buffer,
+                                    off_t startblock, size_t nblocks);
+
+/* This structure describes one block device that uses the shared block
+ * cache.  Unlike the read-ahead/write buffers of rwbuffer.h, the cached
+ * blocks themselves are not owned by the device:  All devices that are
+ * attached to the cache share one pool of block buffers with a common
+ * least-recently-used replacement order and a common memory limit
+ * (CONFIG_DRVR_BLKCACHE_SIZE).
+ *
+ * An instance of this structure is typically declared within each block
+ * driver status structure like:
+ *
+ *  struct foo_dev_s
+ *  {
+ *    ...
+ *    struct blkcache_s cache;
+ *    ...
+ *  };
+ *
+ *  struct foo_dev_s *priv;
+ *  ...
+ *  ... [Setup blocksize, nblocks, wrmaxblocks, dev, reload, flush] ...
+ *  ret = blkcache_attach(&priv->cache);
+ */
+
+struct blkcache_s
+{
+  /********************************************************************/
+  /* These values must be provided by the user prior to calling
+   * blkcache_attach()
+   */
+
+  /* Supported geometry */
+
+  uint16_t      blocksize;       /* The size of one block */
+  size_t        nblocks;         /* The total number blocks supported */
+
+  /* Up to this many contiguous dirty blocks are written back with one
+   * call to the flush callout.  A value greater than one requires the
+   * allocation of a staging buffer of that many blocks.
+   */
+
+  uint16_t      wrmaxblocks;
+
+  /* Callback functions.
+   *
+   * reload.  Reads blocks from the media.  Runs of missing blocks are read
+   *   with a single call.
+   * flush.  Writes blocks to the media.  May be NULL for read-only media.
+   */
+
+  FAR void     *dev;             /* Device state passed to callouts */
+  blkcache_reload_t reload;      /* Callout to read blocks */
+  blkcache_flush_t  flush;       /* Callout to write blocks */
+
+  /********************************************************************/
+  /* The user should never modify any of the remaining fields */
+
+  FAR uint8_t  *wrbuffer;        /* Staging buffer used by flush */
+  size_t        ncached;         /* Number of blocks held in the cache */
+  size_t        ndirty;          /* Number of cached blocks to be written */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_attach
+ *
+ * Description:
+ *   Start caching the blocks of a device.
+ *
+ ****************************************************************************/
+
+int blkcache_attach(FAR struct blkcache_s *cache);
+
+/****************************************************************************
+ * Name: blkcache_detach
+ *
+ * Description:
+ *   Write back all dirty blocks of the device, then release its cached
+ *   blocks and stop caching.  The dirty blocks are discarded (and an error
+ *   returned) if they cannot be written.
+ *
+ ****************************************************************************/
+
+int blkcache_detach(FAR struct blkcache_s *cache);
+
+/****************************************************************************
+ * Name: blkcache_read
+ *
+ * Description:
+ *   Read blocks through the cache.  Blocks that are not cached are read
+ *   from the media and are added to the cache unless the transfer is large
+ *   compared to the size of the cache.  Returns the number of blocks read
+ *   or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct blkcache_s *cache, off_t startblock,
+                      size_t nblocks, FAR uint8_t *rdbuffer);
+
+/****************************************************************************
+ * Name: blkcache_write
+ *
+ * Description:
+ *   Write blocks through the cache.  Small writes are only placed in the
+ *   cache and are written back to the media later, either when the blocks
+ *   are replaced or after CONFIG_DRVR_BLKCACHE_WRDELAY milliseconds on the
+ *   low priority work queue.  Large writes are passed straight to the
+ *   media.  Returns the number of blocks written or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct blkcache_s *cache, off_t startblock,
+                       size_t nblocks, FAR const uint8_t *wrbuffer);
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write back all dirty blocks of the device.  The blocks remain cached.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct blkcache_s *cache);
+
+/****************************************************************************
+ * Name: blkcache_invalidate
+ *
+ * Description:
+ *   Discard any cached copies of a range of blocks, including unwritten
+ *   modifications.  Used when the media is modified without going through
+ *   the cache.
+ *
+ ****************************************************************************/
+
+void blkcache_invalidate(FAR struct blkcache_s *cache, off_t startblock,
+                         size_t nblocks);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_DRVR_BLKCACHE */
+#endif /* __INCLUDE_NUTTX_DRIVERS_BLKCACHE_H */
@@ -185,6 +185,11 @@ struct fs_unionfsdir_s
 struct fs_hostfsdir_s
 {
   FAR void *fs_dir;                           /* Opaque pointer to host DIR * */
+#if CONFIG_FS_HOSTFS_DIRCACHE > 0
+  FAR struct dirent *fs_cache;                /* Entries read ahead from the host */
+  uint16_t fs_index;                          /* Next entry to return */
+  uint16_t fs_count;                          /* Number of entries in fs_cache */
+#endif
 };
 #endif
 
@@ -223,6 +223,33 @@ struct block_operations
 #endif
 };
 
+#ifdef CONFIG_FS_AIO_DRIVER
+/* This structure describes one asynchronous transfer that is offered to a
+ * block driver with the BIOC_AIOSUBMIT ioctl command.  The submitter
+ * provides the byte offset and length of the transfer; the BCH layer
+ * converts these to ar_sector and ar_nsectors before passing the request
+ * to the block driver.
+ *
+ * A driver that accepts the request returns OK from the ioctl and later
+ * calls ar_done() with the number of sectors transferred or a negated
+ * errno value.  ar_done() may be called from interrupt level.  If the
+ * request is not accepted, a negated errno value is returned from the
+ * ioctl and ar_done() is not called.
+ */
+
+struct aio_request_s
+{
+  FAR uint8_t *ar_buffer;          /* Location of the data to transfer */
+  off_t ar_offset;                 /* Byte offset of the transfer */
+  size_t ar_nbytes;                /* Number of bytes to transfer */
+  size_t ar_sector;                /* First sector of the transfer */
+  unsigned int ar_nsectors;        /* Number of sectors to transfer */
+  bool ar_write;                   /* True: write, false: read */
+  CODE void (*ar_done)(FAR struct aio_request_s *req, ssize_t result);
+  FAR void *ar_priv;               /* For use by the submitter */
+};
+#endif
+
 /* This structure is provided by a filesystem to describe a mount point.
  * Note that this structure differs from file_operations ONLY in the form of
  * the open method.  Once the file is opened, it can be accessed either as a
@@ -366,14 +393,48 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This defines a list of files indexed by the file descriptor.
+ *
+ * The list is a table of rows of FILELIST_ROWSIZE files each.  The first
+ * row is part of the list itself; the remaining rows are allocated the
+ * first time that a descriptor in that row is needed.  A large value of
+ * CONFIG_NFILE_DESCRIPTORS then only costs memory in the task groups that
+ * actually open many files.  Rows are never moved or freed until the list
+ * is released, so a file may be looked up with files_fget() without taking
+ * fl_sem.
+ *
+ * fl_inuse holds one bit per descriptor that is set when the descriptor is
+ * allocated so that files_allocate() can skip over full words of the table.
+ */
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
+#if CONFIG_NFILE_DESCRIPTORS < 32
+#  define FILELIST_ROWSIZE CONFIG_NFILE_DESCRIPTORS
+#else
+#  define FILELIST_ROWSIZE 32
+#endif
+
+#define FILELIST_NROWS \
+  ((CONFIG_NFILE_DESCRIPTORS + FILELIST_ROWSIZE - 1) / FILELIST_ROWSIZE)
+#define FILELIST_NWORDS ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
-  struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+  FAR struct file *fl_rows[FILELIST_NROWS]; /* Rows, NULL if not allocated */
+  uint32_t fl_inuse[FILELIST_NWORDS];       /* Allocated descriptors */
+  struct file fl_row0[FILELIST_ROWSIZE];    /* The first row */
 };
+
+/* Return the file structure for the file descriptor 'fd' in 'list' or NULL
+ * if the row holding 'fd' has not been allocated.  'fd' must be in the
+ * range 0 .. CONFIG_NFILE_DESCRIPTORS-1.
+ */
+
+#define files_fget(list, fd) \
+  ((list)->fl_rows[(unsigned int)(fd) / FILELIST_ROWSIZE] == NULL ? NULL : \
+   &(list)->fl_rows[(unsigned int)(fd) / FILELIST_ROWSIZE] \
+                   [(unsigned int)(fd) % FILELIST_ROWSIZE])
 #endif
 
 /* The following structure defines the list of files used for standard C I/O.
@@ -599,6 +660,34 @@ void files_initlist(FAR struct filelist *list);
 void files_releaselist(FAR struct filelist *list);
 #endif
 
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Make sure that the row of the file list holding the file descriptor
+ *   'fd' has been allocated and return the file structure for 'fd'.
+ *   Returns NULL if 'fd' is out of range or if the row could not be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_extend(FAR struct filelist *list, int fd);
+#endif
+
+/****************************************************************************
+ * Name: files_getfd
+ *
+ * Description:
+ *   Return the file descriptor of the file structure 'filep' in 'list' or
+ *   a negated errno value if 'filep' is not a member of 'list'.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int files_getfd(FAR struct filelist *list, FAR struct file *filep);
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -926,6 +1015,22 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 off_t file_seek(FAR struct file *filep, off_t offset, int whence);
 #endif
 
+/****************************************************************************
+ * Name: file_xipmap
+ *
+ * Description:
+ *   Get the address in memory of the data of a file that can be accessed
+ *   directly in memory (such as a ROMFS file on XIP media) and the number
+ *   of bytes from 'pos' to the end of the file.  Currently used only by
+ *   sendfile().
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0 && defined(CONFIG_NET_SENDFILE)
+ssize_t file_xipmap(FAR struct file *filep, off_t pos,
+                    FAR const uint8_t **addr);
+#endif
+
 /****************************************************************************
  * Name: file_fsync
  *
@@ -1019,6 +1124,116 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 #endif
 
+/****************************************************************************
+ * Name: poll_fdsetup
+ *
+ * Description:
+ *   Configure (or unconfigure) one file or socket descriptor for a poll
+ *   operation.  This dispatches to fdesc_poll() or net_poll() depending on
+ *   the type of the descriptor.
+ *
+ * Input Parameters:
+ *   fd    - The file or socket descriptor of interest
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0 && !defined(CONFIG_DISABLE_POLL)
+int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup);
+#endif
+
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report that events have been added to fds->revents.  Drivers should
+ *   use this in place of posting fds->sem directly:  It also calls the
+ *   notification callback, if any, which lets epoll track ready
+ *   descriptors without scanning all of them.
+ *
+ * Input Parameters:
+ *   fds - The poll structure whose revents were updated
+ *
+ * Returned Value:
+ *  None
+ *
+ * Assumptions:
+ *   May be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+void poll_notify(FAR struct pollfd *fds);
+#endif
+
+/****************************************************************************
+ * Name: pollcache_close
+ *
+ * Description:
+ *   Remove a descriptor that is about to be closed from the poll()
+ *   registration cache of the current task group.
+ *
+ * Input Parameters:
+ *   fd - The file or socket descriptor that will be closed
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+void pollcache_close(int fd);
+#endif
+
+/****************************************************************************
+ * Name: pollcache_release
+ *
+ * Description:
+ *   Tear down and free the poll() registration cache of a task group.  This
+ *   must be called while the descriptors of the group are still open.
+ *
+ * Input Parameters:
+ *   group - The task group being released
+ *
+ * Returned Value:
+ *  None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLLCACHE
+struct task_group_s; /* Forward reference */
+void pollcache_release(FAR struct task_group_s *group);
+#endif
+
+/****************************************************************************
+ * Name: signalfd_notify
+ *
+ * Description:
+ *   Called by the signal logic when a signal becomes pending in a task
+ *   group.  Reports POLLIN to any signalfd of the group that accepts the
+ *   signal.
+ *
+ * Input Parameters:
+ *   group - The task group in which the signal is pending
+ *   signo - The signal number
+ *
+ * Returned Value:
+ *  None
+ *
+ * Assumptions:
+ *   May be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SIGNALFD
+struct task_group_s; /* Forward reference */
+void signalfd_notify(FAR struct task_group_s *group, int signo);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
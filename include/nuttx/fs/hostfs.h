@@ -163,6 +163,8 @@ int           host_dup(int fd);
 int           host_fstat(int fd, struct nuttx_stat_s *buf);
 void         *host_opendir(const char *name);
 int           host_readdir(void* dirp, struct nuttx_dirent_s* entry);
+int           host_readdirs(void *dirp, struct nuttx_dirent_s *entries,
+                            int nentries);
 void          host_rewinddir(void* dirp);
 int           host_closedir(void* dirp);
 int           host_statfs(const char *path, struct nuttx_statfs_s *buf);
@@ -183,6 +185,8 @@ int           host_dup(int fd);
 int           host_fstat(int fd, struct stat *buf);
 void         *host_opendir(const char *name);
 int           host_readdir(void* dirp, struct dirent *entry);
+int           host_readdirs(void *dirp, struct dirent *entries,
+                            int nentries);
 void          host_rewinddir(void* dirp);
 int           host_closedir(void* dirp);
 int           host_statfs(const char *path, struct statfs *buf);
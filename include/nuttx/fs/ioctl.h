@@ -231,6 +231,28 @@
                                            *      the block with specific debug
                                            *      command and data.
                                            * OUT: None.  */
+#define BIOC_AIOSUBMIT  _BIOC(0x000C)     /* Start an asynchronous transfer
+                                           * IN:  Pointer to struct
+                                           *      aio_request_s (see
+                                           *      include/nuttx/fs/fs.h).
+                                           * OUT: None (ioctl return value
+                                           *      indicates if the request was
+                                           *      accepted). */
+#define BIOC_FLUSH      _BIOC(0x000D)     /* Write back any data buffered by
+                                           * the block driver to the media.
+                                           * IN:  None
+                                           * OUT: None (ioctl return value
+                                           *      provides success/failure
+                                           *      indication). */
+#define BIOC_MEMBASE    _BIOC(0x000E)     /* Get the address of the memory that
+                                           * holds the device content.  Unlike
+                                           * BIOC_XIPBASE, sector N is always
+                                           * at base + N * sectorsize and that
+                                           * memory is always coherent with the
+                                           * read and write methods.
+                                           * IN:  Pointer to pointer to void in
+                                           *      which to receive the base.
+                                           * OUT: Base address of sector 0 */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -41,6 +41,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/fs/fs.h>
 
 /****************************************************************************
@@ -133,6 +136,62 @@ struct procfs_dir_priv_s
   FAR const struct procfs_entry_s *procfsentry; /* Pointer to procfs handler entry */
 };
 
+#ifdef CONFIG_FS_PROCFS_SNAPSHOT
+/* Binary layout of /proc/snapshot.  Each read() from offset zero takes one
+ * consistent sample of the task, CPU, heap and network counters.  The
+ * layout does not depend on the configuration:  Counters that are not
+ * available in the configuration always read as zero.
+ */
+
+#define PROCFS_SNAPSHOT_VERSION 1
+
+struct procfs_snaptask_s
+{
+  int32_t  st_pid;            /* Task ID */
+  uint8_t  st_state;          /* Task state (tstate_t) */
+  uint8_t  st_priority;       /* Current priority */
+  uint16_t st_flags;          /* TCB_FLAG_* bits */
+  uint32_t st_stacksize;      /* Size of the stack */
+  uint32_t st_stackused;      /* Stack used (CONFIG_STACK_COLORATION) */
+  uint32_t st_cpuactive;      /* CPU load ticks (CONFIG_SCHED_CPULOAD) */
+};
+
+struct procfs_snapheap_s
+{
+  uint32_t sh_arena;          /* Total size of the heap */
+  uint32_t sh_ordblks;        /* Number of free chunks */
+  uint32_t sh_mxordblk;       /* Largest free chunk */
+  uint32_t sh_uordblks;       /* Total allocated space */
+  uint32_t sh_fordblks;       /* Total free space */
+};
+
+struct procfs_snapnet_s
+{
+  uint32_t sn_recv;           /* Packets received */
+  uint32_t sn_sent;           /* Packets sent */
+  uint32_t sn_drop;           /* Packets dropped */
+};
+
+struct procfs_snapshot_s
+{
+  uint16_t ss_version;        /* PROCFS_SNAPSHOT_VERSION */
+  uint16_t ss_ntasks;         /* Number of valid entries in ss_tasks[] */
+  uint32_t ss_systime;        /* System time in clock ticks */
+  uint32_t ss_cputotal;       /* CPU load total ticks (CONFIG_SCHED_CPULOAD) */
+
+  struct procfs_snapheap_s ss_umm;   /* User heap (flat build only) */
+  struct procfs_snapheap_s ss_kmm;   /* Kernel heap (CONFIG_MM_KERNEL_HEAP) */
+
+  struct procfs_snapnet_s  ss_ipv4;  /* Network (CONFIG_NET_STATISTICS) */
+  struct procfs_snapnet_s  ss_ipv6;
+  struct procfs_snapnet_s  ss_icmp;
+  struct procfs_snapnet_s  ss_tcp;
+  struct procfs_snapnet_s  ss_udp;
+
+  struct procfs_snaptask_s ss_tasks[CONFIG_MAX_TASKS];
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -0,0 +1,198 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <queue.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initialization of a timer structure before its first use */
+
+#define hrtimer_init(h) do { (h)->active = false; } while (0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the form of the function that is called when a high resolution
+ * timer expires.  It is called from the oneshot timer interrupt handler
+ * and may restart the same timer.
+ */
+
+struct hrtimer_s;
+typedef CODE void (*hrtimer_callback_t)(FAR struct hrtimer_s *hrtimer,
+                                        FAR void *arg);
+
+/* One high resolution timer.  The structure is owned by the caller and
+ * must remain valid (and must not be reused) while the timer is active.
+ */
+
+struct hrtimer_s
+{
+  dq_entry_t         node;       /* Support for the ordered active list */
+  uint64_t           expiry;     /* Absolute expiration time (usec) */
+  hrtimer_callback_t callback;   /* Function to call on expiration */
+  FAR void          *arg;        /* Argument passed to the callback */
+  bool               active;     /* True:  Timer is in the active list */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Provide the oneshot timer that will drive all high resolution timers.
+ *   This is called once by board specific logic.  Until then,
+ *   hrtimer_available() reports false and the OS falls back to watchdog
+ *   timers.
+ *
+ * Input Parameters:
+ *   lower - An instance of the oneshot timer interface as defined in
+ *           include/nuttx/timers/oneshot.h
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+struct oneshot_lowerhalf_s;
+void hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: hrtimer_available
+ *
+ * Description:
+ *   Return true if a oneshot timer has been provided by
+ *   hrtimer_initialize().
+ *
+ ****************************************************************************/
+
+bool hrtimer_available(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a high resolution timer.  The callback will be
+ *   called from the oneshot timer interrupt handler no sooner than 'delay'
+ *   after this call.  When called from within an hrtimer callback, the
+ *   delay is measured from the expiration time of the timer being
+ *   serviced so that periodic timers do not drift.
+ *
+ * Input Parameters:
+ *   hrtimer  - The timer to start
+ *   delay    - The relative time until expiration
+ *   callback - The function to call on expiration
+ *   arg      - Argument passed to the callback
+ *
+ * Returned Value:
+ *   OK on success; -ENODEV if no oneshot timer has been provided.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer,
+                  FAR const struct timespec *delay,
+                  hrtimer_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.  It is not an error to cancel a timer
+ *   that is not active.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer to stop
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void hrtimer_cancel(FAR struct hrtimer_s *hrtimer);
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time remaining before a high resolution timer expires, or
+ *   zero if the timer is not active.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer to query
+ *   ts      - Location to return the remaining time
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void hrtimer_gettime(FAR struct hrtimer_s *hrtimer,
+                     FAR struct timespec *ts);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
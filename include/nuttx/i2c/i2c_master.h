@@ -47,6 +47,10 @@
 
 #include <nuttx/fs/ioctl.h>
 
+#ifdef CONFIG_I2C_ASYNC
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -145,6 +149,31 @@
 #  define I2C_RESET(d) ((d)->ops->reset(d))
 #endif
 
+/****************************************************************************
+ * Name: I2C_SUBMIT
+ *
+ * Description:
+ *   Start a batch of transfer requests without waiting for them.  Drivers
+ *   that support this run the requests from their interrupt handler and
+ *   call each request's callback as it completes.  Optional; use
+ *   i2c_submit() rather than calling this directly.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The first request of the batch
+ *
+ * Returned Value:
+ *   Zero (OK) if the batch was started; a negated errno value if the
+ *   driver cannot perform it.  The batch is then performed by i2c_submit()
+ *   itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+#  define I2C_SUBMIT(d,r) \
+     ((d)->ops->submit ? (d)->ops->submit(d,r) : -ENOSYS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -153,6 +182,9 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+#ifdef CONFIG_I2C_ASYNC
+struct i2c_request_s;
+#endif
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -160,6 +192,10 @@ struct i2c_ops_s
 #ifdef CONFIG_I2C_RESET
   CODE int (*reset)(FAR struct i2c_master_s *dev);
 #endif
+#ifdef CONFIG_I2C_ASYNC
+  CODE int (*submit)(FAR struct i2c_master_s *dev,
+                     FAR struct i2c_request_s *req);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -208,6 +244,33 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes one asynchronous transfer as handled by i2c_submit().
+ * Requests linked through 'flink' form a batch that is performed back to
+ * back on the bus; the requests may address different devices.  Each
+ * callback receives the result of I2C_TRANSFER for its own request and may
+ * be called from the interrupt level.  A request must not be modified
+ * until its callback has been called.
+ */
+
+typedef CODE void (*i2c_callback_t)(FAR struct i2c_request_s *req,
+                                    int result);
+
+struct i2c_request_s
+{
+  FAR struct i2c_request_s *flink; /* Next request in the batch */
+  FAR struct i2c_msg_s *msgv;      /* Array of I2C messages */
+  int msgc;                        /* Number of messages in the array */
+  i2c_callback_t callback;         /* Called when the request completed */
+  FAR void *arg;                   /* Caller argument for the callback */
+
+  /* The following are used internally by i2c_submit() */
+
+  FAR struct i2c_master_s *dev;    /* The I2C bus */
+  struct work_s work;              /* Used if the driver cannot submit */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -317,6 +380,30 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+/****************************************************************************
+ * Name: i2c_submit
+ *
+ * Description:
+ *   Queue a batch of transfer requests and return without waiting for
+ *   them.  The requests are performed in order and the callback of each
+ *   is called when it has completed.  Sensor drivers can so overlap their
+ *   processing with the bus transfers instead of blocking a thread on
+ *   each transfer.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The first request of the batch, linked through 'flink'
+ *
+ * Returned Value:
+ *   Zero (OK) if the batch was queued; a negated errno value on failure.
+ *   No callback is called if the batch was not queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_submit(FAR struct i2c_master_s *dev, FAR struct i2c_request_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
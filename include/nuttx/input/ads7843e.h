@@ -66,6 +66,12 @@
 #  define CONFIG_ADS7843E_NPOLLWAITERS 2
 #endif
 
+/* Number of touch samples buffered until they are read */
+
+#ifndef CONFIG_ADS7843E_NEVENTS
+#  define CONFIG_ADS7843E_NEVENTS 8
+#endif
+
 #ifndef CONFIG_ADS7843E_SPIMODE
 #  define CONFIG_ADS7843E_SPIMODE SPIDEV_MODE0
 #endif
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * include/nuttx/input/input_queue.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INPUT_INPUT_QUEUE_H
+#define __INCLUDE_NUTTX_INPUT_INPUT_QUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <poll.h>
+
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_INPUT_QUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Return a time stamp for an input event.  The time is in microseconds and
+ * wraps around after about 71 minutes so only differences between time
+ * stamps are meaningful.
+ */
+
+#define input_timestamp() ((uint32_t)TICK2USEC(clock_systimer()))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An input event queue is shared by the upper half of input drivers that
+ * report a stream of events (touch samples, for example).  Events are fixed
+ * size records whose layout is defined by the driver.  The driver adds each
+ * event as it is sampled with input_queue_put() and the read() and poll()
+ * methods of the driver are implemented with input_queue_read() and
+ * input_queue_poll().  read() returns as many queued events as fit in the
+ * caller's buffer.
+ *
+ * When the queue is full, the oldest event is discarded so that readers
+ * always see the most recent input.
+ */
+
+struct input_queue_s
+{
+  FAR uint8_t *iq_buffer;          /* Storage for iq_nevents events */
+  uint16_t iq_evsize;              /* Size of one event in bytes */
+  uint16_t iq_nevents;             /* Capacity of the queue in events */
+  volatile uint16_t iq_head;       /* Index of the next event to be added */
+  volatile uint16_t iq_count;      /* Number of events in the queue */
+  uint16_t iq_overruns;            /* Number of events discarded */
+  uint8_t iq_nwaiters;             /* Number of threads waiting in read() */
+  sem_t iq_waitsem;                /* Posted when an event is added */
+#ifndef CONFIG_DISABLE_POLL
+  uint8_t iq_npollwaiters;         /* Number of entries in iq_fds[] */
+  FAR struct pollfd **iq_fds;      /* Threads waiting in poll() */
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: input_queue_initialize
+ *
+ * Description:
+ *   Initialize an input event queue and allocate its storage.
+ *
+ * Input Parameters:
+ *   queue        - The queue to initialize
+ *   evsize       - The size of one event in bytes
+ *   nevents      - The number of events the queue can hold
+ *   npollwaiters - The number of threads that may wait in poll()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int input_queue_initialize(FAR struct input_queue_s *queue, size_t evsize,
+                           unsigned int nevents, unsigned int npollwaiters);
+
+/****************************************************************************
+ * Name: input_queue_uninitialize
+ *
+ * Description:
+ *   Release the resources of an input event queue.
+ *
+ ****************************************************************************/
+
+void input_queue_uninitialize(FAR struct input_queue_s *queue);
+
+/****************************************************************************
+ * Name: input_queue_put
+ *
+ * Description:
+ *   Add one event to the queue, discarding the oldest event if the queue is
+ *   full, and wake up any readers.  This may be called from the work queue
+ *   or from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void input_queue_put(FAR struct input_queue_s *queue, FAR const void *event);
+
+/****************************************************************************
+ * Name: input_queue_read
+ *
+ * Description:
+ *   Remove as many whole events as fit in the buffer.  If the queue is
+ *   empty, wait for an event unless 'nonblock' is true.  The caller must not
+ *   hold any lock that input_queue_put() depends on.
+ *
+ * Returned Value:
+ *   The number of bytes returned (always a multiple of the event size) on
+ *   success; -EINVAL if the buffer cannot hold one event, -EAGAIN if the
+ *   queue is empty and 'nonblock' is true, or -EINTR if the wait was
+ *   interrupted.
+ *
+ ****************************************************************************/
+
+ssize_t input_queue_read(FAR struct input_queue_s *queue, FAR char *buffer,
+                         size_t len, bool nonblock);
+
+/****************************************************************************
+ * Name: input_queue_poll
+ *
+ * Description:
+ *   Set up or tear down a poll() on the queue.  POLLIN is reported while
+ *   the queue holds at least one event.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int input_queue_poll(FAR struct input_queue_s *queue, FAR struct pollfd *fds,
+                     bool setup);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_INPUT_QUEUE */
+#endif /* __INCLUDE_NUTTX_INPUT_INPUT_QUEUE_H */
@@ -113,6 +113,12 @@
 #  define CONFIG_STMPE811_NPOLLWAITERS 2
 #endif
 
+/* Number of touch samples buffered until they are read */
+
+#ifndef CONFIG_STMPE811_NEVENTS
+#  define CONFIG_STMPE811_NEVENTS 8
+#endif
+
 /* Check for some required settings.  This can save the user a lot of time
  * in getting the right configuration.
  */
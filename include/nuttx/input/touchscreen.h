@@ -122,6 +122,7 @@ struct touch_point_s
   int16_t  h;        /* Height of touch point (uncalibrated) */
   int16_t  w;        /* Width of touch point (uncalibrated) */
   uint16_t pressure; /* Touch pressure */
+  uint32_t timestamp; /* Time of the sample in microseconds (zero if unknown) */
 };
 
 /* The typical touchscreen driver is a read-only, input character device driver.
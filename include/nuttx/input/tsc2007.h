@@ -65,6 +65,12 @@
 #  define CONFIG_TSC2007_NPOLLWAITERS 2
 #endif
 
+/* Number of touch samples buffered until they are read */
+
+#ifndef CONFIG_TSC2007_NEVENTS
+#  define CONFIG_TSC2007_NEVENTS 8
+#endif
+
 /* Check for some required settings.  This can save the user a lot of time
  * in getting the right configuration.
  */
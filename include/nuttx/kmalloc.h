@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -55,6 +56,19 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+/* Statistics of the deferred de-allocations, see sched_garbage_stats() */
+
+struct garbage_stats_s
+{
+  uint32_t deferred;        /* Total number of deferred de-allocations */
+  uint32_t collected;       /* Total number of deferred de-allocations done */
+  uint32_t passes;          /* Number of garbage collection passes */
+  uint32_t pending;         /* Number of de-allocations still pending */
+  uint32_t maxpending;      /* Maximum number of pending de-allocations */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -95,6 +109,24 @@ extern "C"
 #define kumm_memalign(a,s)       memalign(a,s)
 #define kumm_free(p)             free(p)
 
+/* Allocations with placement hints (see MM_PLACE_* in nuttx/mm/mm.h).  The
+ * hints are simply ignored if memory region attributes are not supported.
+ * In the protected build, the kernel cannot call these user-space
+ * interfaces directly.
+ */
+
+#if defined(CONFIG_MM_REGION_ATTR) && !defined(CONFIG_BUILD_PROTECTED)
+#  define kumm_addregion_attr(h,s,a) umm_addregion_attr(h,s,a)
+#  define kumm_malloc_hint(s,p)      umm_malloc_hint(s,p)
+#  define kumm_zalloc_hint(s,p)      umm_zalloc_hint(s,p)
+#  define kumm_memalign_hint(a,s,p)  umm_memalign_hint(a,s,p)
+#else
+#  define kumm_addregion_attr(h,s,a) kumm_addregion(h,s)
+#  define kumm_malloc_hint(s,p)      kumm_malloc(s)
+#  define kumm_zalloc_hint(s,p)      kumm_zalloc(s)
+#  define kumm_memalign_hint(a,s,p)  kumm_memalign(a,s)
+#endif
+
 /* This family of allocators is used to manage kernel protected memory */
 
 #if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_MM_KERNEL_HEAP)
@@ -113,6 +145,11 @@ extern "C"
 # define kmm_memalign(a,s)      memalign(a,s)
 # define kmm_free(p)            free(p)
 
+# define kmm_addregion_attr(h,s,a) kumm_addregion_attr(h,s,a)
+# define kmm_malloc_hint(s,p)      kumm_malloc_hint(s,p)
+# define kmm_zalloc_hint(s,p)      kumm_zalloc_hint(s,p)
+# define kmm_memalign_hint(a,s,p)  kumm_memalign_hint(a,s,p)
+
 #elif !defined(CONFIG_MM_KERNEL_HEAP)
 /* If this the kernel phase of a kernel build, and there are only user-space
  * allocators, then the following are defined in userspace.h as macros that
@@ -130,11 +167,36 @@ extern "C"
 # define kmm_memalign(a,s)      umm_memalign(a,s)
 # define kmm_free(p)            umm_free(p)
 
+# define kmm_addregion_attr(h,s,a) kumm_addregion_attr(h,s,a)
+# define kmm_malloc_hint(s,p)      kumm_malloc_hint(s,p)
+# define kmm_zalloc_hint(s,p)      kumm_zalloc_hint(s,p)
+# define kmm_memalign_hint(a,s,p)  kumm_memalign_hint(a,s,p)
+
 #else
 /* Otherwise, the kernel-space allocators are declared in include/nuttx/mm/mm.h
  * and we can call them directly.
  */
 
+# ifndef CONFIG_MM_REGION_ATTR
+#   define kmm_addregion_attr(h,s,a) kmm_addregion(h,s)
+#   define kmm_malloc_hint(s,p)      kmm_malloc(s)
+#   define kmm_zalloc_hint(s,p)      kmm_zalloc(s)
+#   define kmm_memalign_hint(a,s,p)  kmm_memalign(a,s)
+# endif
+#endif
+
+/* Placement of the TCBs and of the thread stacks */
+
+#ifdef CONFIG_MM_FAST_TCB
+#  define MM_PLACE_TCB   MM_PLACE_FAST
+#else
+#  define MM_PLACE_TCB   MM_PLACE_NORMAL
+#endif
+
+#ifdef CONFIG_MM_FAST_STACK
+#  define MM_PLACE_STACK MM_PLACE_FAST
+#else
+#  define MM_PLACE_STACK MM_PLACE_NORMAL
 #endif
 
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
@@ -210,6 +272,12 @@ void sched_garbage_collection(void);
 
 bool sched_have_garbage(void);
 
+/* Return a snapshot of the garbage collection statistics */
+
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+void sched_garbage_stats(FAR struct garbage_stats_s *stats);
+#endif
+
 #undef KMALLOC_EXTERN
 #if defined(__cplusplus)
 }
@@ -94,6 +94,30 @@ struct lcd_planeinfo_s
   int (*getrun)(fb_coord_t row, fb_coord_t col, FAR uint8_t *buffer,
                 size_t npixels);
 
+  /* This method can be used to write a rectangular area to the LCD in one
+   * operation.  It is optional and may be NULL, in which case the area is
+   * written with putrun() one row at a time.  A driver that provides it
+   * should select the area once and, when the rows are contiguous, send all
+   * of the pixels in a single (DMA) transfer:
+   *
+   *  row_start - Starting row to write to (range: 0 <= row_start <= row_end)
+   *  row_end   - Ending row to write to (range: row_start <= row_end < yres)
+   *  col_start - Starting column to write to
+   *              (range: 0 <= col_start <= col_end)
+   *  col_end   - Ending column to write to
+   *              (range: col_start <= col_end < xres)
+   *  buffer    - The buffer containing the area to be written to the LCD in
+   *              the pixel format of the plane.  The first pixel of each row
+   *              is byte aligned.
+   *  stride    - The distance in bytes between the rows in the buffer.  A
+   *              stride of zero writes the first row into every row of the
+   *              area.
+   */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, size_t stride);
+
   /* Plane color characteristics ********************************************/
 
   /* This is working memory allocated by the LCD driver for each LCD device
@@ -0,0 +1,245 @@
+/****************************************************************************
+ * include/nuttx/lib/shmring.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __INCLUDE_NUTTX_LIB_SHMRING_H
+#define __INCLUDE_NUTTX_LIB_SHMRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_LIB_SHMRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Identifies a formatted ring in shared memory */
+
+#define SHMRING_MAGIC      0x53524e47  /* 'SRNG' */
+
+/* The smallest shared memory region that can hold a ring */
+
+#define SHMRING_MINSIZE    (sizeof(struct shmring_hdr_s) + 16)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A shared memory ring is a single-producer, single-consumer byte FIFO
+ * that lives entirely in memory shared by the two sides.  The producer only
+ * ever advances 'head' and the consumer only ever advances 'tail', so no
+ * lock is needed to move data.  The indices are free running and are
+ * reduced modulo 'size', which is a power of two.  Because the shared
+ * region holds no pointers, it may be mapped at different addresses in
+ * different address spaces.
+ *
+ * The 'rdwait' and 'wrwait' flags work like a futex:  A side that finds the
+ * ring empty (or full) sets its flag and sleeps on a named semaphore.  The
+ * other side only posts that semaphore if it sees the flag set, so no
+ * system call is made while data is flowing.
+ */
+
+struct shmring_hdr_s
+{
+  uint32_t magic;                 /* SHMRING_MAGIC when formatted */
+  uint32_t size;                  /* Size of data[] in bytes (power of two) */
+  volatile uint32_t head;         /* Total bytes written by the producer */
+  volatile uint32_t tail;         /* Total bytes read by the consumer */
+  volatile uint8_t rdwait;        /* Consumer is waiting for data */
+  volatile uint8_t wrwait;        /* Producer is waiting for space */
+  uint8_t reserved[2];
+  uint8_t data[1];                /* Ring data, actual size varies */
+};
+
+/* This is the per-user view of one shared memory ring */
+
+struct shmring_s
+{
+  FAR struct shmring_hdr_s *hdr;  /* The ring in shared memory */
+  FAR sem_t *datasem;             /* Posted when the consumer may proceed */
+  FAR sem_t *spacesem;            /* Posted when the producer may proceed */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmring_create
+ *
+ * Description:
+ *   Format a region of shared memory as an empty ring and create the named
+ *   semaphores used to wait for data and space.  The region may be static
+ *   memory (FLAT build), user memory (PROTECTED build), or memory attached
+ *   with shmat() (KERNEL build).
+ *
+ * Input Parameters:
+ *   ring - The per-user ring structure to initialize
+ *   name - The name of the ring.  It is used to name the semaphores.
+ *   mem  - The shared memory region
+ *   size - The size of the shared memory region in bytes
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int shmring_create(FAR struct shmring_s *ring, FAR const char *name,
+                   FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: shmring_attach
+ *
+ * Description:
+ *   Attach to a ring that was formatted by shmring_create(), possibly in
+ *   another task or process.
+ *
+ * Input Parameters:
+ *   ring - The per-user ring structure to initialize
+ *   name - The name given to shmring_create()
+ *   mem  - The shared memory region as seen by the caller
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int shmring_attach(FAR struct shmring_s *ring, FAR const char *name,
+                   FAR void *mem);
+
+/****************************************************************************
+ * Name: shmring_detach
+ *
+ * Description:
+ *   Release the semaphores held by this user of the ring.  The shared
+ *   memory itself is not freed.
+ *
+ ****************************************************************************/
+
+void shmring_detach(FAR struct shmring_s *ring);
+
+/****************************************************************************
+ * Name: shmring_unlink
+ *
+ * Description:
+ *   Remove the named semaphores of the ring.  Users that are still
+ *   attached may continue to use the ring.
+ *
+ ****************************************************************************/
+
+int shmring_unlink(FAR const char *name);
+
+/****************************************************************************
+ * Name: shmring_write and shmring_read
+ *
+ * Description:
+ *   Copy data into or out of the ring.  If 'block' is true, wait until at
+ *   least one byte can be transferred.  Only one task may write and only
+ *   one task may read a ring at any time.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, -EAGAIN if nothing could be
+ *   transferred without blocking, or another negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_write(FAR struct shmring_s *ring, FAR const void *buffer,
+                      size_t len, bool block);
+ssize_t shmring_read(FAR struct shmring_s *ring, FAR void *buffer,
+                     size_t len, bool block);
+
+/****************************************************************************
+ * Name: shmring_reserve and shmring_commit
+ *
+ * Description:
+ *   Zero-copy production.  shmring_reserve() returns a pointer to the free
+ *   space in the ring and the number of contiguous bytes available there.
+ *   The producer fills that space in place and then publishes it with
+ *   shmring_commit().
+ *
+ *   NULL is returned with errno set if nothing is available (EAGAIN) or
+ *   if the wait was interrupted.
+ *
+ ****************************************************************************/
+
+FAR void *shmring_reserve(FAR struct shmring_s *ring, FAR size_t *len,
+                          bool block);
+void shmring_commit(FAR struct shmring_s *ring, size_t len);
+
+/****************************************************************************
+ * Name: shmring_peek and shmring_consume
+ *
+ * Description:
+ *   Zero-copy consumption.  shmring_peek() returns a pointer to the oldest
+ *   data in the ring and the number of contiguous bytes available there.
+ *   The consumer processes the data in place and then releases the space
+ *   with shmring_consume().
+ *
+ *   NULL is returned with errno set if nothing is available (EAGAIN) or
+ *   if the wait was interrupted.
+ *
+ ****************************************************************************/
+
+FAR const void *shmring_peek(FAR struct shmring_s *ring, FAR size_t *len,
+                             bool block);
+void shmring_consume(FAR struct shmring_s *ring, size_t len);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_LIB_SHMRING */
+#endif /* __INCLUDE_NUTTX_LIB_SHMRING_H */
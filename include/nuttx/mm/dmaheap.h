@@ -0,0 +1,163 @@
+/****************************************************************************
+ * include/nuttx/mm/dmaheap.h
+ * Allocator for DMA buffers in regions with special memory attributes.
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __INCLUDE_NUTTX_MM_DMAHEAP_H
+#define __INCLUDE_NUTTX_MM_DMAHEAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MM_DMAHEAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+/* CONFIG_MM_DMAHEAP - Enable the DMA heap
+ * CONFIG_MM_DMAHEAP_NREGIONS - The maximum number of DMA heap regions
+ * CONFIG_MM_DMAHEAP_LOG2ALIGN - Log2 of the alignment of every DMA buffer.
+ *   This should be at least the size of a data cache line so that no DMA
+ *   buffer shares a cache line with any other data.
+ */
+
+#ifndef CONFIG_MM_DMAHEAP_NREGIONS
+#  define CONFIG_MM_DMAHEAP_NREGIONS 2
+#endif
+
+#ifndef CONFIG_MM_DMAHEAP_LOG2ALIGN
+#  define CONFIG_MM_DMAHEAP_LOG2ALIGN 5
+#endif
+
+#define DMAHEAP_ALIGN         (1 << CONFIG_MM_DMAHEAP_LOG2ALIGN)
+
+/* Region attributes.  These describe how the board has set up the memory
+ * of a region; the DMA heap only records them.
+ */
+
+#define DMAHEAP_DMA           (1 << 0) /* Reachable by the DMA controllers */
+#define DMAHEAP_NONCACHEABLE  (1 << 1) /* No cache maintenance is needed */
+#define DMAHEAP_TCM           (1 << 2) /* Tightly coupled memory */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dmaheap_addregion
+ *
+ * Description:
+ *   Add a region of memory to the DMA heap.  This is normally called by
+ *   board initialization logic for memory that it has set aside (and, for
+ *   example, configured as non-cacheable in the MPU) for DMA.
+ *
+ * Input Parameters:
+ *   start    - The start of the region.
+ *   size     - The size of the region in bytes.
+ *   log2gran - Log2 of the granule size of the region.  Allocations are
+ *              made in whole granules.  This must be at least
+ *              CONFIG_MM_DMAHEAP_LOG2ALIGN.
+ *   attr     - The DMAHEAP_* attributes of the region.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dmaheap_addregion(FAR void *start, size_t size, uint8_t log2gran,
+                      uint32_t attr);
+
+/****************************************************************************
+ * Name: dmaheap_alloc
+ *
+ * Description:
+ *   Allocate a DMA buffer of at least 'size' bytes from the first region
+ *   (in the order that they were added) that has all of the attributes in
+ *   'attr'.  The buffer is aligned to DMAHEAP_ALIGN and does not share a
+ *   granule with any other allocation.
+ *
+ * Returned Value:
+ *   The allocated buffer or NULL if no region could satisfy the request.
+ *
+ ****************************************************************************/
+
+FAR void *dmaheap_alloc(size_t size, uint32_t attr);
+
+/****************************************************************************
+ * Name: dmaheap_free
+ *
+ * Description:
+ *   Free a DMA buffer previously allocated by dmaheap_alloc().  'size' must
+ *   be the size that was passed to dmaheap_alloc().
+ *
+ ****************************************************************************/
+
+void dmaheap_free(FAR void *mem, size_t size);
+
+/****************************************************************************
+ * Name: dmaheap_attributes
+ *
+ * Description:
+ *   Return the attributes of the region containing 'mem' so that, for
+ *   example, a driver can skip cache maintenance for non-cacheable buffers.
+ *   Zero is returned if 'mem' is not in the DMA heap.
+ *
+ ****************************************************************************/
+
+uint32_t dmaheap_attributes(FAR const void *mem);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_DMAHEAP */
+#endif /* __INCLUDE_NUTTX_MM_DMAHEAP_H */
@@ -80,10 +80,39 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* Large I/O buffers are optional */
+
+#if !defined(CONFIG_IOB_LARGE_NBUFFERS)
+#  define CONFIG_IOB_LARGE_NBUFFERS 0
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0 && \
+    CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#  error CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#endif
+
 /* IOB helpers */
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0 && defined(CONFIG_IOB_SHARED)
+#  define IOB_BUFSIZE(p) ((p)->io_owner->io_bufsize)
+#elif CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
+
+/* I/O buffer users (see CONFIG_IOB_RESERVATIONS).  I/O buffers allocated
+ * on behalf of these users are accounted against the user's reservation.
+ */
+
+#define IOB_USER_NONE      0 /* Not accounted */
+#define IOB_USER_TCP       1 /* TCP read-ahead */
+#define IOB_USER_UDP       2 /* UDP read-ahead */
+#define IOB_USER_IPFORWARD 3 /* IP forwarding */
+#define IOB_NUSERS         4
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -99,6 +128,15 @@
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
+ *
+ * If CONFIG_IOB_LARGE_NBUFFERS > 0, then io_data[] of a large I/O buffer
+ * extends to CONFIG_IOB_LARGE_BUFSIZE bytes.  Use IOB_BUFSIZE() rather
+ * than CONFIG_IOB_BUFSIZE for the size of an I/O buffer.
+ *
+ * If CONFIG_IOB_SHARED is selected, then io_data points to data that may be
+ * shared with other I/O buffers (see iob_clone()).  The data belongs to the
+ * I/O buffer io_owner and is freed when the last reference is dropped.
+ * Logic that modifies io_data[] must first call iob_unshare().
  */
 
 struct iob_s
@@ -109,7 +147,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && CONFIG_IOB_LARGE_NBUFFERS == 0
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -117,8 +155,20 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
+#ifdef CONFIG_IOB_RESERVATIONS
+  uint8_t  io_user;     /* See IOB_USER_* definitions */
+#endif
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  uint16_t io_bufsize;  /* Size of io_data[] */
+#endif
 
+#ifdef CONFIG_IOB_SHARED
+  uint16_t io_refs;     /* References to this I/O buffer and its data */
+  FAR struct iob_s *io_owner; /* The I/O buffer that holds io_data[] */
+  FAR uint8_t *io_data; /* The data (possibly shared) */
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -183,6 +233,42 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_size and iob_tryalloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer of the class that best fits 'size' bytes of
+ *   data:  A large I/O buffer is returned if 'size' exceeds
+ *   CONFIG_IOB_BUFSIZE and one is free; otherwise these behave like
+ *   iob_alloc() and iob_tryalloc().
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_alloc_size(bool throttled, unsigned int size);
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size);
+#else
+#  define iob_alloc_size(t,s)    iob_alloc(t)
+#  define iob_tryalloc_size(t,s) iob_tryalloc(t)
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_user
+ *
+ * Description:
+ *   Try to allocate an I/O buffer on behalf of one of the IOB_USER_* users.
+ *   The allocation fails if it would consume I/O buffers that are reserved
+ *   for the other users.  I/O buffers later added to the chain by
+ *   iob_copyin() or iob_trycopyin() are accounted to the same user.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_RESERVATIONS
+FAR struct iob_s *iob_tryalloc_user(bool throttled, uint8_t user);
+#else
+#  define iob_tryalloc_user(t,u) iob_tryalloc(t)
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -320,10 +406,31 @@ int iob_copyout(FAR uint8_t *dest, FAR const struct iob_s *iob,
  * Description:
  *   Duplicate (and pack) the data in iob1 in iob2.  iob2 must be empty.
  *
+ *   If CONFIG_IOB_SHARED is selected, the data is not copied.  Instead,
+ *   the I/O buffers of the iob2 chain share the data of the iob1 chain.
+ *
  ****************************************************************************/
 
 int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled);
 
+/****************************************************************************
+ * Name: iob_unshare
+ *
+ * Description:
+ *   Make sure that the data of the I/O buffer is not shared with any other
+ *   I/O buffer, copying it if necessary, so that it may be modified.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the data could not be copied.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SHARED
+int iob_unshare(FAR struct iob_s *iob);
+#else
+#  define iob_unshare(iob) (0)
+#endif
+
 /****************************************************************************
  * Name: iob_concat
  *
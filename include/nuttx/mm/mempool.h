@@ -0,0 +1,201 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_H
+#define __INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+
+#ifdef CONFIG_MM_MEMPOOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The aligned size of one block as used by the pool.  Clients that provide
+ * static storage should size it as (ninitial * MEMPOOL_BSIZE(bsize)).
+ */
+
+#define MEMPOOL_BSIZE(s) \
+  (((s) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one pool of fixed-size blocks.  The structure
+ * is provided by the client (usually in .bss) and is initialized by
+ * mempool_initialize().  Free blocks are held in a singly linked list that
+ * is threaded through the first word of each free block.
+ */
+
+struct mempool_s
+{
+  sq_entry_t flink;          /* Supports the list of all pools (procfs) */
+  FAR const char *name;      /* Name of the pool */
+  sq_queue_t freelist;       /* List of free blocks */
+  size_t bsize;              /* Size of one block (aligned) */
+  uint16_t nexpand;          /* Number of blocks added per expansion */
+  uint16_t nmax;             /* Maximum number of blocks (0: unlimited) */
+
+  /* Statistics */
+
+  uint16_t ntotal;           /* Number of blocks in the pool */
+  uint16_t nused;            /* Number of blocks currently allocated */
+  uint16_t nhwm;             /* Maximum nused ever observed */
+  uint16_t nfail;            /* Number of failed allocations */
+};
+
+/* This structure is used to return a snapshot of the pool statistics */
+
+struct mempoolinfo_s
+{
+  FAR const char *name;      /* Name of the pool */
+  size_t bsize;              /* Size of one block (aligned) */
+  uint16_t ntotal;           /* Number of blocks in the pool */
+  uint16_t nused;            /* Number of blocks currently allocated */
+  uint16_t nhwm;             /* Maximum nused ever observed */
+  uint16_t nfail;            /* Number of failed allocations */
+};
+
+/* Callback used with mempool_foreach() */
+
+typedef void (*mempool_handler_t)(FAR const struct mempoolinfo_s *info,
+                                  FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a pool of fixed-size blocks.
+ *
+ * Input Parameters:
+ *   pool     - The pool structure to be initialized.
+ *   name     - The name of the pool (used only for procfs)
+ *   bsize    - The size of one block.  This will be rounded up to a
+ *              multiple of the pointer size.
+ *   storage  - Statically allocated storage for the initial blocks or NULL
+ *              if the initial blocks should be allocated from the kernel
+ *              heap.  If non-NULL, the storage must be large enough to hold
+ *              ninitial blocks of the rounded bsize (see MEMPOOL_BSIZE()).
+ *   ninitial - The initial number of blocks.
+ *   nexpand  - The number of blocks to allocate from the kernel heap when
+ *              the pool is exhausted.  Zero disables dynamic growth.
+ *   nmax     - The maximum number of blocks that the pool may grow to.
+ *              Zero means no limit other than the heap.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       size_t bsize, FAR void *storage, uint16_t ninitial,
+                       uint16_t nexpand, uint16_t nmax);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the pool.  This function may be called from
+ *   interrupt handlers; however, the pool will be expanded from the heap
+ *   only if the call is not made from an interrupt handler.
+ *
+ * Returned Value:
+ *   The allocated (uninitialized) block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the pool.  This function may be called from
+ *   interrupt handlers.
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return a snapshot of the statistics of one pool.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info);
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call the handler with the statistics of each initialized pool.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_MEMPOOL */
+#endif /* __INCLUDE_NUTTX_MM_MEMPOOL_H */
@@ -154,12 +154,37 @@
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 #endif
 
+/* The allocation tag of CONFIG_MM_PROFILE makes the chunk headers larger.
+ * The smallest chunk must still hold a free node.
+ */
+
+#ifdef CONFIG_MM_PROFILE
+#  undef  MM_MIN_SHIFT
+#  if UINTPTR_MAX <= UINT32_MAX
+#    define MM_MIN_SHIFT  5  /* 32 bytes */
+#  else
+#    define MM_MIN_SHIFT  6  /* 64 bytes */
+#  endif
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* In the segregated fit mode, each power-of-two range of chunk sizes
+ * (MM_NNODES first-level ranges) is further divided into MM_NSLBINS equal
+ * second-level bins.  There is one nodelist entry per bin.
+ */
+
+#ifdef CONFIG_MM_SEGFIT
+#  define MM_NSLBINS     (1 << CONFIG_MM_SEGFIT_SLBITS)
+#  define MM_NBINS       (MM_NNODES * MM_NSLBINS)
+#else
+#  define MM_NBINS       MM_NNODES
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -176,6 +201,50 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Small allocation cache.  Size class n holds chunks of at least
+ * (MM_MIN_CHUNK << n) bytes, the same binning used by mm_size2ndx().
+ */
+
+#ifdef CONFIG_MM_CACHE
+#  if CONFIG_MM_CACHE_MAXSHIFT < MM_MIN_SHIFT
+#    error CONFIG_MM_CACHE_MAXSHIFT is smaller than MM_MIN_SHIFT
+#  endif
+
+#  define MM_CACHE_NCLASSES (CONFIG_MM_CACHE_MAXSHIFT - MM_MIN_SHIFT + 1)
+#  define MM_CACHE_MAXCHUNK (1 << CONFIG_MM_CACHE_MAXSHIFT)
+#  define MM_CACHE_BATCH    (CONFIG_MM_CACHE_DEPTH / 2)
+
+#  ifdef CONFIG_SMP
+#    define MM_CACHE_NCPUS  CONFIG_SMP_NCPUS
+#  else
+#    define MM_CACHE_NCPUS  1
+#  endif
+#endif
+
+/* Memory region attributes.  These are given to mm_addregion_attr() to
+ * describe the memory of a heap region.  Regions added with
+ * mm_addregion() are normal memory.
+ */
+
+#define MM_REGION_NORMAL  0x00  /* Normal, on-chip SRAM */
+#define MM_REGION_FAST    0x01  /* Fast memory such as TCM or CCM SRAM */
+#define MM_REGION_SLOW    0x02  /* Slow memory such as external SDRAM */
+#define MM_REGION_NODMA   0x04  /* Memory that DMA cannot access */
+
+/* Placement hints for mm_malloc_hint() and friends.  The hint names the
+ * preferred kind of memory.  If no preferred memory is available, the
+ * allocation falls back to any other region unless MM_PLACE_STRICT is
+ * given.  Ordinary allocations use MM_PLACE_NORMAL:  They avoid fast
+ * regions so that fast memory is kept for the allocations that ask for it.
+ */
+
+#define MM_PLACE_NORMAL   0x00  /* Prefer memory that is not fast */
+#define MM_PLACE_FAST     0x01  /* Prefer fast memory */
+#define MM_PLACE_SLOW     0x02  /* Prefer slow memory */
+#define MM_PLACE_PREFMASK 0x03  /* Mask of the preferred kind of memory */
+#define MM_PLACE_DMA      0x10  /* Memory must be accessible by DMA */
+#define MM_PLACE_STRICT   0x20  /* Never use memory that is not preferred */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -190,6 +259,26 @@
 #  define MMSIZE_MAX UINT32_MAX
 #endif
 
+#ifdef CONFIG_MM_PROFILE
+/* This describes the owner of an allocated chunk.  It follows the sizes in
+ * the chunk header and is set by mm_tag().  The caller is NULL in the
+ * chunks held by the small allocation cache.
+ */
+
+struct mm_alloctag_s
+{
+  FAR void *caller;        /* Return address of the allocation call */
+  uint32_t seqno;          /* Sequence number of the allocation */
+  uint32_t reqsize;        /* Size that was requested */
+  pid_t pid;               /* ID of the allocating thread */
+  uint16_t reserved;       /* Keeps the user memory 8-byte aligned */
+};
+
+#  define SIZEOF_MM_ALLOCTAG sizeof(struct mm_alloctag_s)
+#else
+#  define SIZEOF_MM_ALLOCTAG 0
+#endif
+
 /* This describes an allocated chunk.  An allocated chunk is
  * distinguished from a free chunk by bit 15/31 of the 'preceding' chunk
  * size.  If set, then this is an allocated chunk.
@@ -199,14 +288,17 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_PROFILE
+  struct mm_alloctag_s tag; /* Owner of the chunk */
+#endif
 };
 
 /* What is the size of the allocnode? */
 
 #ifdef CONFIG_MM_SMALL
-# define SIZEOF_MM_ALLOCNODE   4
+# define SIZEOF_MM_ALLOCNODE   (4 + SIZEOF_MM_ALLOCTAG)
 #else
-# define SIZEOF_MM_ALLOCNODE   8
+# define SIZEOF_MM_ALLOCNODE   (8 + SIZEOF_MM_ALLOCTAG)
 #endif
 
 #define CHECK_ALLOCNODE_SIZE \
@@ -218,6 +310,9 @@ struct mm_freenode_s
 {
   mmsize_t size;                   /* Size of this chunk */
   mmsize_t preceding;              /* Size of the preceding chunk */
+#ifdef CONFIG_MM_PROFILE
+  struct mm_alloctag_s tag;        /* Unused, keeps the header layout */
+#endif
   FAR struct mm_freenode_s *flink; /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
 };
@@ -230,6 +325,26 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_CACHE
+/* This describes the magazine of one size class on one CPU.  The
+ * magazine holds allocated chunks (the user memory addresses) ready for
+ * re-use.
+ */
+
+struct mm_cachemag_s
+{
+  uint8_t count;                          /* Number of cached chunks */
+  FAR void *chunk[CONFIG_MM_CACHE_DEPTH]; /* Cached chunks (LIFO) */
+};
+
+/* This describes the small allocation cache of one CPU */
+
+struct mm_cache_s
+{
+  struct mm_cachemag_s mag[MM_CACHE_NCLASSES];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -255,13 +370,72 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_REGION_ATTR
+  /* The MM_REGION_* attributes of each region */
+
+  uint8_t mm_regattr[CONFIG_MM_REGIONS];
+#endif
+
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
-  struct mm_freenode_s mm_nodelist[MM_NNODES];
+  struct mm_freenode_s mm_nodelist[MM_NBINS];
+
+#ifdef CONFIG_MM_SEGFIT
+  /* Bitmaps of possibly non-empty bins.  A clear bit means that the bin
+   * is certainly empty; set bits are cleaned up lazily when an empty bin
+   * is encountered in mm_findfreechunk().
+   */
+
+  uint32_t mm_flbitmap;                /* One bit per first-level range */
+  uint32_t mm_slbitmap[MM_NNODES];     /* One bit per second-level bin */
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Per-CPU caches of small, allocated chunks */
+
+  struct mm_cache_s mm_cache[MM_CACHE_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_PROFILE
+  /* Sequence number of the last tagged allocation */
+
+  uint32_t mm_seqno;
+#endif
+};
+
+#ifdef CONFIG_MM_PROFILE
+/* This structure describes the live allocations of one call site.  It is
+ * returned by mm_profile().
+ */
+
+struct mm_profsite_s
+{
+  FAR void *caller;        /* Return address of the allocation call */
+  size_t nallocs;          /* Number of live allocations */
+  size_t reqbytes;         /* Bytes requested by these allocations */
+  size_t chunkbytes;       /* Bytes of the chunks, headers included */
+  uint32_t minseq;         /* Sequence number of the oldest allocation */
+  uint32_t maxseq;         /* Sequence number of the newest allocation */
+  pid_t pid;               /* Thread of the newest allocation */
+};
+
+/* This structure describes the fragmentation of the free memory.  It is
+ * returned by mm_fraginfo().
+ */
+
+struct mm_fraginfo_s
+{
+  size_t largest;          /* Largest free chunk */
+  size_t nfree;            /* Number of free chunks */
+  size_t fbytes;           /* Total free space */
+  size_t ncached;          /* Number of chunks in the allocation cache */
+  size_t nchunks[MM_NBINS]; /* Free chunks in each mm_nodelist[] bin */
+  size_t nbytes[MM_NBINS];  /* Free space in each mm_nodelist[] bin */
 };
+#endif
 
 /****************************************************************************
  * Public Data
@@ -324,6 +498,13 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heap_start,
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize);
 
+#ifdef CONFIG_MM_REGION_ATTR
+void mm_addregion_attr(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                       size_t heapsize, uint8_t attr);
+#else
+#  define mm_addregion_attr(h,a,s,t) mm_addregion(h,a,s)
+#endif
+
 /* Functions contained in umm_initialize.c **********************************/
 
 void umm_initialize(FAR void *heap_start, size_t heap_size);
@@ -367,6 +548,12 @@ void kmm_givesemaphore(void);
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
 
+#ifdef CONFIG_MM_REGION_ATTR
+FAR void *mm_malloc_hint(FAR struct mm_heap_s *heap, size_t size, int hint);
+#else
+#  define mm_malloc_hint(h,s,p) mm_malloc(h,s)
+#endif
+
 /* Functions contained in kmm_malloc.c **************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -387,6 +574,7 @@ void kmm_free(FAR void *mem);
 
 FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
                      size_t size);
+size_t mm_growsize(size_t cursize, size_t reqsize);
 
 /* Functions contained in kmm_realloc.c *************************************/
 
@@ -419,12 +607,38 @@ FAR void *kmm_zalloc(size_t size);
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size);
 
+#ifdef CONFIG_MM_REGION_ATTR
+FAR void *mm_memalign_hint(FAR struct mm_heap_s *heap, size_t alignment,
+                           size_t size, int hint);
+#else
+#  define mm_memalign_hint(h,a,s,p) mm_memalign(h,a,s)
+#endif
+
 /* Functions contained in kmm_memalign.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_memalign(size_t alignment, size_t size);
 #endif
 
+/* Functions contained in umm_placement.c ***********************************/
+
+#if defined(CONFIG_MM_REGION_ATTR) && \
+   (!defined(CONFIG_BUILD_PROTECTED) || !defined(__KERNEL__))
+void umm_addregion_attr(FAR void *heapstart, size_t heapsize, uint8_t attr);
+FAR void *umm_malloc_hint(size_t size, int hint);
+FAR void *umm_zalloc_hint(size_t size, int hint);
+FAR void *umm_memalign_hint(size_t alignment, size_t size, int hint);
+#endif
+
+/* Functions contained in kmm_placement.c ***********************************/
+
+#if defined(CONFIG_MM_REGION_ATTR) && defined(CONFIG_MM_KERNEL_HEAP)
+void kmm_addregion_attr(FAR void *heapstart, size_t heapsize, uint8_t attr);
+FAR void *kmm_malloc_hint(size_t size, int hint);
+FAR void *kmm_zalloc_hint(size_t size, int hint);
+FAR void *kmm_memalign_hint(size_t alignment, size_t size, int hint);
+#endif
+
 /* Functions contained in kmm_heapmember.c **********************************/
 
 #if defined(CONFIG_MM_KERNEL_HEAP) && defined(CONFIG_DEBUG_FEATURES)
@@ -484,6 +698,20 @@ void kmm_extend(FAR void *mem, size_t size, int region);
 struct mallinfo; /* Forward reference */
 int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
 
+/* Functions contained in mm_profile.c *************************************/
+
+#ifdef CONFIG_MM_PROFILE
+FAR void *mm_tag(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
+                 FAR void *caller);
+int mm_profile(FAR struct mm_heap_s *heap, FAR struct mm_profsite_s *sites,
+               int nsites);
+int mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info);
+#  define MM_CALLER()  __builtin_return_address(0)
+#else
+#  define mm_tag(heap,mem,size,caller) (mem)
+#  define MM_CALLER()  NULL
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -507,6 +735,25 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
+#ifdef CONFIG_MM_SEGFIT
+int mm_size2bin(size_t size);
+#endif
+
+/* Functions contained in mm_findfreechunk.c ********************************/
+
+#ifdef CONFIG_MM_SEGFIT
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_CACHE
+void mm_cache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+int mm_cache_flush(FAR struct mm_heap_s *heap);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
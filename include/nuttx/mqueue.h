@@ -82,6 +82,10 @@ struct mqueue_inode_s
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
 #endif
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+  FAR void *msgpool;          /* Per-queue message allocation */
+  sq_queue_t msgfree;         /* Free messages in msgpool */
+#endif
 };
 
 /* This describes the message queue descriptor that is held in the
@@ -219,6 +223,88 @@ int mq_close_group(mqd_t mqdes, FAR struct task_group_s *group);
 
 void mq_desclose_group(mqd_t mqdes, FAR struct task_group_s *group);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: mq_msgreserve
+ *
+ * Description:
+ *   Reserve a message buffer for a subsequent mq_msgcommit().  The caller
+ *   may write up to mq_msgsize bytes of message data into the returned
+ *   buffer.  The buffer must then be passed to mq_msgcommit() (which
+ *   consumes it whether or not the send succeeds) or to mq_msgrelease().
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor, opened for writing
+ *
+ * Return Value:
+ *   The message buffer on success; NULL on failure with the errno set to
+ *   EINVAL, EPERM, or ENOMEM.
+ *
+ ****************************************************************************/
+
+FAR char *mq_msgreserve(mqd_t mqdes);
+
+/****************************************************************************
+ * Name: mq_msgcommit
+ *
+ * Description:
+ *   Send a message built in place in a buffer obtained from
+ *   mq_msgreserve().  This behaves like mq_send() except that no message
+ *   data is copied.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - Buffer returned by mq_msgreserve()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Return Value:
+ *   As for mq_send().  The buffer is released on failure.
+ *
+ ****************************************************************************/
+
+int mq_msgcommit(mqd_t mqdes, FAR char *buffer, size_t msglen, int prio);
+
+/****************************************************************************
+ * Name: mq_msgborrow
+ *
+ * Description:
+ *   Receive the next message like mq_receive() but, rather than copying
+ *   it, return a reference to the message data in place.  The buffer
+ *   must be returned with mq_msgrelease() before the message queue is
+ *   closed.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor, opened for reading
+ *   buffer - Location to return the message data
+ *   prio   - Location to return the message priority (may be NULL)
+ *
+ * Return Value:
+ *   The length of the message on success; -1 (ERROR) on failure with the
+ *   errno set as for mq_receive().
+ *
+ ****************************************************************************/
+
+ssize_t mq_msgborrow(mqd_t mqdes, FAR char **buffer, FAR int *prio);
+
+/****************************************************************************
+ * Name: mq_msgrelease
+ *
+ * Description:
+ *   Release a buffer obtained from mq_msgborrow() or an unsent buffer
+ *   obtained from mq_msgreserve().
+ *
+ * Parameters:
+ *   buffer - The message buffer to release
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_msgrelease(FAR char *buffer);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
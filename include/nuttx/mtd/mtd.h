@@ -80,6 +80,12 @@
                                            *      0=Use normal memory region
                                            *      1=Use alternate/extended memory
                                            * OUT: None */
+#define MTDIOC_ISBAD      _MTDIOC(0x0008) /* IN:  Erase block number
+                                           * OUT: None (ioctl returns 1 if the
+                                           *      block is marked bad, 0 if
+                                           *      it is good) */
+#define MTDIOC_MARKBAD    _MTDIOC(0x0009) /* IN:  Erase block number
+                                           * OUT: None */
 
 /* Macros to hide implementation */
 
@@ -300,6 +306,25 @@ FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd);
 
 int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd);
 
+/****************************************************************************
+ * Name: nftl_initialize
+ *
+ * Description:
+ *   Initialize a log-structured NAND flash translation layer on top of an
+ *   MTD interface and register it as a block driver.  Logical sectors are
+ *   the size of one MTD read/write block (one NAND page).
+ *
+ * Input Parameters:
+ *   minor - The minor device number.  The block device will be
+ *      registered as as /dev/nftlN where N is the minor number.
+ *   mtd - The MTD device that supports the FLASH interface.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NFTL
+int nftl_initialize(int minor, FAR struct mtd_dev_s *mtd);
+#endif
+
 /****************************************************************************
  * Name: smart_initialize
  *
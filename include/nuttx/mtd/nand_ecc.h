@@ -59,6 +59,34 @@
  * Public Types
  ****************************************************************************/
 
+/* A pluggable ECC engine.  When the raw NAND driver provides one (see
+ * struct nand_raw_s), software ECC uses it instead of the 1-bit Hamming
+ * code.  The data area of a page is divided into steps of 'stepsize' bytes,
+ * each protected by 'eccbytes' of ECC stored at the end of the spare area.
+ *
+ * 'calculate' computes the ECC of one step.  'correct' checks one step
+ * against the ECC read from the spare area and corrects the data in place.
+ * It returns the number of bit errors corrected, or -EBADMSG if the step is
+ * uncorrectable.
+ *
+ * The engine may be a software implementation (see nandecc_bch_initialize)
+ * or a wrapper around a buffer-based hardware accelerator.  Controllers
+ * that compute ECC in-line as the data is transferred (such as the SAMA5
+ * PMECC) continue to use the NANDECC_HWECC path of the raw driver.
+ */
+
+struct nand_eccengine_s
+{
+  uint16_t stepsize;         /* Bytes of data per ECC step */
+  uint8_t  eccbytes;         /* Bytes of ECC per step */
+  uint8_t  strength;         /* Correctable bit errors per step */
+
+  CODE void (*calculate)(FAR const struct nand_eccengine_s *engine,
+                         FAR const uint8_t *data, FAR uint8_t *ecc);
+  CODE int  (*correct)(FAR const struct nand_eccengine_s *engine,
+                       FAR uint8_t *data, FAR const uint8_t *ecc);
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -127,6 +155,27 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
                       unsigned int page,  FAR const void *data,
                       FAR void *spare);
 
+/****************************************************************************
+ * Name: nandecc_bch_initialize
+ *
+ * Description:
+ *   Return the software BCH ECC engine that corrects up to 'strength' bit
+ *   errors in every 512 bytes of data.  The tables used by the engine are
+ *   built on the first call.  Assign the engine to the 'engine' field of
+ *   the raw NAND driver before calling nand_initialize().
+ *
+ * Input parameters:
+ *   strength - Number of correctable bit errors per 512 bytes: 4 or 8.
+ *
+ * Returned value.
+ *   The ECC engine; NULL if the strength is not supported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_BCH
+FAR const struct nand_eccengine_s *nandecc_bch_initialize(int strength);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -241,6 +241,7 @@
  * after this required header information.
  */
 
+struct nand_eccengine_s;
 struct nand_raw_s
 {
   /* NAND data description */
@@ -268,6 +269,12 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_SWECC
+  /* Software ECC engine.  NULL selects the 1-bit Hamming code. */
+
+  FAR const struct nand_eccengine_s *engine;
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers*/
 
@@ -50,6 +50,7 @@
 
 #include <sys/socket.h>
 #include <stdint.h>
+#include <queue.h>
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
@@ -80,9 +81,11 @@
 
 struct arp_entry
 {
+  dq_entry_t        at_node;     /* Supports the use-ordered or free list */
+  FAR struct arp_entry *at_hnext; /* Next entry in the hash chain */
   in_addr_t         at_ipaddr;   /* IP address */
   struct ether_addr at_ethaddr;  /* Hardware address */
-  uint8_t           at_time;     /* Time of last usage */
+  uint8_t           at_time;     /* Time of last update */
 };
 
 /* Used with the SIOCSARP, SIOCDARP, and SIOCGARP IOCTL commands to set,
@@ -130,6 +130,14 @@
 #define SIOCTELNET       _SIOC(0x0029)  /* Create a Telnet sessions.
                                          * See include/nuttx/net/telnet.h */
 
+/* 6LoWPAN IPHC address contexts.  Argument is a reference to struct
+ * sixlowpan_ctxreq_s as defined in include/nuttx/net/sixlowpan.h
+ */
+
+#define SIOCSLOWPANCTX   _SIOC(0x002a)  /* Set an address context */
+#define SIOCDLOWPANCTX   _SIOC(0x002b)  /* Delete an address context */
+#define SIOCGLOWPANCTX   _SIOC(0x002c)  /* Get an address context */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
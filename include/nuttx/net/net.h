@@ -110,6 +110,9 @@ typedef uint8_t sockcaps_t;
 
 struct socket;  /* Forward reference */
 struct pollfd;  /* Forward reference */
+struct iob_s;   /* Forward reference */
+struct file;    /* Forward reference */
+struct mmsghdr; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -142,6 +145,16 @@ struct sock_intf_s
   CODE ssize_t    (*si_recvfrom)(FAR struct socket *psock, FAR void *buf,
                     size_t len, int flags, FAR struct sockaddr *from,
                     FAR socklen_t *fromlen);
+#ifdef CONFIG_NET_RECVIOB
+  CODE ssize_t    (*si_recviob)(FAR struct socket *psock,
+                    FAR struct iob_s **iob, int flags,
+                    FAR struct sockaddr *from, FAR socklen_t *fromlen);
+#endif
+#ifdef CONFIG_NET_MMSG
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+#endif
   CODE int        (*si_close)(FAR struct socket *psock);
 };
 
@@ -261,6 +274,8 @@ void net_initialize(void);
  *   net_unlock()        - Gives the semaphore().
  *   net_lockedwait()    - Like pthread_cond_wait(); releases the semaphore
  *                         momentarily to wait on another semaphore()
+ *   netdev_lock()       - Re-entrant lock on the device list and the routing
+ *   netdev_unlock()       tables only (with CONFIG_NET_DEVLOCK)
  *
  ****************************************************************************/
 
@@ -296,6 +311,31 @@ void net_lock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: netdev_lock and netdev_unlock
+ *
+ * Description:
+ *   Take or release the lock that protects the list of network devices and
+ *   the routing tables.  These may be taken while holding the network lock
+ *   but the network lock must never be acquired while holding only the
+ *   device lock.  Without CONFIG_NET_DEVLOCK, the network lock is used.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_DEVLOCK
+void netdev_lock(void);
+void netdev_unlock(void);
+#else
+#  define netdev_lock()   net_lock()
+#  define netdev_unlock() net_unlock()
+#endif
+
 /****************************************************************************
  * Name: net_timedwait
  *
@@ -889,6 +929,99 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Receive without copying:  Remove the oldest buffered packet (UDP) or
+ *   segment (TCP) from the socket read-ahead queue and return the I/O
+ *   buffer chain that holds it.  The data begins at IOB_DATA() of the head
+ *   of the chain and continues for io_pktlen bytes.  Ownership of the
+ *   chain passes to the caller, who must release it with iob_free_chain()
+ *   when the data has been consumed.
+ *
+ *   If the read-ahead queue is empty, this blocks until data is received
+ *   unless the socket is non-blocking or MSG_DONTWAIT is set in flags.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      The location to return the I/O buffer chain
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned chain.  Zero
+ *   is returned (and no chain) if the TCP peer has performed an orderly
+ *   shutdown.  Otherwise, -1 is returned, and errno is set appropriately
+ *   (see recvfrom() for the list of errors).  EOPNOTSUPP is returned if
+ *   the address family does not support I/O buffer receipt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen);
+#endif
+
+/****************************************************************************
+ * Name: psock_sendmsg and psock_recvmsg
+ *
+ * Description:
+ *   Send or receive one message described by a struct msghdr.  The data is
+ *   gathered from or scattered to the I/O vectors of the message.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to send or the message to receive into
+ *   flags    Send or receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent or received.  On error, -1
+ *   is returned, and errno is set appropriately (see sendto() and
+ *   recvfrom() for the list of errors).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MMSG
+struct msghdr;
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                      int flags);
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+#endif
+
+/****************************************************************************
+ * Name: psock_sendmmsg and psock_recvmmsg
+ *
+ * Description:
+ *   Send or receive up to 'vlen' messages in one call.  The length of each
+ *   message transferred is returned in its msg_len field.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Send or receive flags
+ *   timeout  (recvmmsg only) Limit on the time spent receiving, or NULL
+ *
+ * Returned Value:
+ *   The number of messages transferred.  If an error occurs before any
+ *   message was transferred, -1 is returned, and errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MMSG
+struct timespec;
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+#endif
+
 /****************************************************************************
  * Name: psock_getsockopt
  *
@@ -581,6 +581,14 @@
 #  define CONFIG_NET_ARPTAB_SIZE 8
 #endif
 
+#ifndef CONFIG_NET_ARP_HASHSIZE
+/* The number of hash chains used to look up ARP table entries.  Must be a
+ * power of two.
+ */
+
+#  define CONFIG_NET_ARP_HASHSIZE 8
+#endif
+
 #ifndef CONFIG_NET_ARP_MAXAGE
 /* The maximum age of ARP table entries measured in 10ths of seconds.
  *
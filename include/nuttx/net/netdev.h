@@ -51,6 +51,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <net/if.h>
 
 #include <net/ethernet.h>
@@ -59,6 +60,10 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
 
+#ifdef CONFIG_NETDEV_RXPOLL
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifdef CONFIG_NET_IGMP
 #  include <nuttx/net/igmp.h>
 #endif
@@ -123,6 +128,12 @@
 
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  ifdef CONFIG_NETDEV_RXPOLL
+#    define NETDEV_TXRINGFULL(dev) _NETDEV_STATISTIC(dev,tx_ringfull)
+#  else
+#    define NETDEV_TXRINGFULL(dev)
+#  endif
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -139,12 +150,102 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+#  define NETDEV_TXRINGFULL(dev)
+#endif
+
+#ifdef CONFIG_NETDEV_TSO
+/* Room left for the link layer, IP and TCP headers of a TSO packet */
+
+#  define NETDEV_TSO_HDRMAX   128
+#  define NETDEV_TSO_MAXLEN   (UINT16_MAX - NETDEV_TSO_HDRMAX)
+#endif
+
+/* Checksum offload capabilities (d_csumcaps).  A *_TX capability means
+ * that the hardware inserts the checksum in outgoing packets:  The network
+ * then leaves the checksum field zero.  A *_RX capability means that the
+ * hardware verifies the checksum of incoming packets and that the driver
+ * discards those that fail:  The network then does not verify it again.
+ * The TCP and UDP capabilities apply to both IPv4 and IPv6.
+ */
+
+#define NETDEV_CSUM_IPv4_TX    (1 << 0) /* IPv4 header checksum generation */
+#define NETDEV_CSUM_IPv4_RX    (1 << 1) /* IPv4 header checksum verification */
+#define NETDEV_CSUM_TCP_TX     (1 << 2) /* TCP checksum generation */
+#define NETDEV_CSUM_TCP_RX     (1 << 3) /* TCP checksum verification */
+#define NETDEV_CSUM_UDP_TX     (1 << 4) /* UDP checksum generation */
+#define NETDEV_CSUM_UDP_RX     (1 << 5) /* UDP checksum verification */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define NETDEV_CSUM_OFFLOADED(dev,cap) (((dev)->d_csumcaps & (cap)) != 0)
+#else
+#  define NETDEV_CSUM_OFFLOADED(dev,cap) (false)
 #endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_NETDEV_IOB_TX
+/* One contiguous segment of an outgoing frame (see netdev_txsegments()) */
+
+struct netdev_txseg_s
+{
+  FAR const uint8_t *ts_data;   /* Start of the segment */
+  uint16_t ts_len;              /* Length of the segment in bytes */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+/* Receive coalescing state of a device (see netdev_gro_input()).  The
+ * buffer is provided by the driver and holds the link layer, IPv4 and TCP
+ * headers of the first segment of the flow followed by the payload of all
+ * merged segments.
+ */
+
+struct netdev_gro_s
+{
+  FAR uint8_t *gr_buf;          /* Buffer for the merged packet */
+  uint16_t gr_bufsize;          /* Size of gr_buf in bytes */
+  uint16_t gr_len;              /* Length of the held packet (0: none) */
+  uint8_t  gr_nsegs;            /* Number of segments merged into it */
+  uint32_t gr_nextseq;          /* Sequence number of the next segment */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_RXPOLL
+/* Budgeted receive polling.  Instead of taking one interrupt per received
+ * frame, a driver disables its Rx interrupt when the first frame arrives
+ * and lets netdev_rxpoll_schedule() pull frames from the worker thread,
+ * at most rp_budget per pass.  Rx interrupts are re-enabled only when the
+ * receive ring is empty.  See netdev_rxpoll_initialize().
+ */
+
+struct net_driver_s; /* Forward reference */
+struct tcp_conn_s;   /* Forward reference */
+struct udp_conn_s;   /* Forward reference */
+
+struct netdev_rxpoll_s
+{
+  FAR struct net_driver_s *rp_dev;  /* The polled network device */
+
+  /* Receive one frame from the ring and pass it to the network, exactly as
+   * the interrupt driven receive path would.  Returns a positive value if
+   * a frame was processed, zero if the ring is empty, or a negated errno
+   * value on a receive error (which ends the pass).
+   */
+
+  CODE int (*rp_rxframe)(FAR struct net_driver_s *dev);
+
+  /* Enable or disable the Rx interrupt of the device */
+
+  CODE void (*rp_rxint)(FAR struct net_driver_s *dev, bool enable);
+
+  struct work_s rp_work;            /* Poll pass work */
+  uint16_t rp_budget;               /* Maximum frames per poll pass */
+  uint8_t rp_qid;                   /* Work queue (HPWORK or LPWORK) */
+};
+#endif
+
 #ifdef CONFIG_NETDEV_STATISTICS
 /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
  * statistics, then this structure holds the counts of network driver
@@ -176,6 +277,15 @@ struct netdev_statistics_s
   uint32_t tx_errors;      /* Number of receive errors (incl timeouts) */
   uint32_t tx_timeouts;    /* Number of Tx timeout errors */
 
+#ifdef CONFIG_NETDEV_RXPOLL
+  /* Ring status (see netdev_rxpoll_*()) */
+
+  uint32_t rx_polls;       /* Number of Rx poll passes */
+  uint32_t rx_exhausted;   /* Passes that ended with the budget used up */
+  uint32_t rx_maxbatch;    /* Most packets received in one pass */
+  uint32_t tx_ringfull;    /* Times a packet waited for a free Tx slot */
+#endif
+
   /* Other status */
 
   uint32_t errors;         /* Total umber of errors */
@@ -205,6 +315,8 @@ struct netdev_varaddr_s
  */
 
 struct devif_callback_s; /* Forward reference */
+struct arp_entry;        /* Forward reference.  See arp.h */
+struct neighbor_entry;   /* Forward reference */
 
 struct net_driver_s
 {
@@ -233,8 +345,12 @@ struct net_driver_s
   uint8_t d_llhdrlen;           /* Link layer header size */
   uint16_t d_mtu;               /* Maximum packet size */
 #ifdef CONFIG_NET_TCP
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t d_recvwndo;          /* TCP receive window size */
+#else
   uint16_t d_recvwndo;          /* TCP receive window size */
 #endif
+#endif
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
     defined(CONFIG_NET_IEEE802154)
@@ -324,6 +440,68 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_IOB_RX
+  /* If the driver received the packet into an I/O buffer, d_iob refers to
+   * that I/O buffer and d_buf to its io_data[].  Otherwise NULL.  The
+   * network may take ownership of the I/O buffer to avoid copying data into
+   * a read-ahead queue.  In that case it replaces d_iob (and d_buf) with a
+   * new I/O buffer holding a copy of the headers for use in the response.
+   * On return from the input function, the driver owns whatever d_iob
+   * then refers to.
+   */
+
+  FAR struct iob_s *d_iob;
+#endif
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* Checksum offload capabilities of the hardware.  Set by the driver to
+   * any combination of the NETDEV_CSUM_* bits.
+   */
+
+  uint8_t d_csumcaps;
+#endif
+
+#ifdef CONFIG_NETDEV_IOB_TX
+  /* Scatter-gather transmit.  A driver that can transmit a frame from
+   * several buffers sets d_sgtx.  The network may then leave the TCP
+   * payload of an outgoing packet in the I/O buffer chain where it is
+   * buffered:  d_txiob is then non-NULL and the d_sndlen bytes of payload
+   * begin at d_txoffset in that chain.  They follow the d_len - d_sndlen
+   * bytes of headers in d_buf.  See netdev_txsegments().
+   */
+
+  bool d_sgtx;                  /* Set by the driver: Scatter-gather capable */
+  FAR struct iob_s *d_txiob;    /* Payload of the outgoing packet (or NULL) */
+  uint16_t d_txoffset;          /* Offset of the payload in d_txiob */
+#endif
+
+#ifdef CONFIG_NETDEV_TSO
+  /* TCP segmentation offload.  A scatter-gather driver that can split a
+   * large TCP segment into MSS-sized frames, in hardware or with
+   * netdev_gso_segment(), sets d_tsomax to the largest TCP payload that it
+   * accepts (at most NETDEV_TSO_MAXLEN).  An outgoing packet with more
+   * payload than fits in one frame then has d_txmss set to the MSS that
+   * each frame must use; otherwise d_txmss is zero.
+   */
+
+  uint16_t d_tsomax;            /* Set by the driver: Largest TSO payload */
+  uint16_t d_txmss;             /* MSS of the outgoing packet (or zero) */
+#endif
+
+#ifdef CONFIG_NET_ARP
+  /* The ARP table entry last found for this device.  See arp_lookup(). */
+
+  FAR struct arp_entry *d_arphit;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  /* The Neighbor Table entry last found for this device.  See
+   * neighbor_lookup().
+   */
+
+  FAR struct neighbor_entry *d_nbrhit;
+#endif
+
 #ifdef CONFIG_NET_IGMP
   /* IGMP group list */
 
@@ -363,6 +541,20 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb;
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NETDEV_TXPENDING
+  /* Connections with Tx work pending on this device.  A Tx poll visits only
+   * the connections in these lists; devif_timer() still visits all of
+   * them.
+   */
+
+#ifdef CONFIG_NET_TCP
+  FAR struct tcp_conn_s *d_tcppend;
+#endif
+#ifdef CONFIG_NET_UDP
+  FAR struct udp_conn_s *d_udppend;
+#endif
+#endif
+
   /* Driver callbacks */
 
   int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -690,4 +882,192 @@ uint16_t ipv6_chksum(FAR struct net_driver_s *dev);
 #  define netdev_ipv6_hdrlen(dev) dev->d_llhdrlen
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: netdev_txiob_clear
+ *
+ * Description:
+ *   Indicate that the outgoing packet is entirely in d_buf.  This must be
+ *   done whenever the packet in d_buf is replaced.
+ *
+ * Input Parameters:
+ *   dev Device structure pointer
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_TSO)
+#  define netdev_txiob_clear(dev) \
+  do { (dev)->d_txiob = NULL; (dev)->d_txmss = 0; } while (0)
+#elif defined(CONFIG_NETDEV_IOB_TX)
+#  define netdev_txiob_clear(dev) do { (dev)->d_txiob = NULL; } while (0)
+#else
+#  define netdev_txiob_clear(dev)
+#endif
+
+/****************************************************************************
+ * Name: netdev_txsegments
+ *
+ * Description:
+ *   Describe the outgoing frame as a list of contiguous segments for a
+ *   scatter-gather DMA transfer:  The headers in d_buf followed by the
+ *   payload in the I/O buffer chain (if any).  If the frame needs more than
+ *   'nsegs' segments, then the payload is copied into d_buf and a single
+ *   segment is returned.  In either case, the transmit descriptor is
+ *   consumed (d_txiob is cleared).
+ *
+ *   The I/O buffer chain is valid until the network is next entered, so
+ *   the driver must be finished reading it (normally, the DMA transfer must
+ *   be complete) before it next polls the network or provides a received
+ *   packet.
+ *
+ * Input Parameters:
+ *   dev   - The network device with the outgoing frame of d_len bytes
+ *   segs  - The segment list to be filled in
+ *   nsegs - The number of entries in the segment list (at least one)
+ *
+ * Returned Value:
+ *   The number of segments used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_TX
+int netdev_txsegments(FAR struct net_driver_s *dev,
+                      FAR struct netdev_txseg_s *segs, int nsegs);
+#endif
+
+/****************************************************************************
+ * Name: netdev_gso_segment
+ *
+ * Description:
+ *   Software TCP segmentation for a driver that sets d_tsomax but cannot
+ *   segment in hardware.  Called by the driver in place of transmitting an
+ *   outgoing packet with d_txmss set.  The packet is split into frames of
+ *   up to d_txmss bytes of payload.  Each frame gets a copy of the headers
+ *   with the IP length and identification, the TCP sequence number and
+ *   flags, and the checksums adjusted, and is then passed to 'xmit' in
+ *   d_buf and d_txiob for transmission as any other frame.
+ *
+ * Input Parameters:
+ *   dev  - The network device with the outgoing packet of d_len bytes
+ *   xmit - Transmits one frame (normally with netdev_txsegments())
+ *
+ * Returned Value:
+ *   Zero (OK) on success; otherwise the value returned by 'xmit' that
+ *   stopped segmentation.  The frames that were not sent are recovered by
+ *   TCP retransmission.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TSO
+int netdev_gso_segment(FAR struct net_driver_s *dev,
+                       devif_poll_callback_t xmit);
+#endif
+
+/****************************************************************************
+ * Name: netdev_gro_initialize
+ *
+ * Description:
+ *   Prepare receive coalescing for a device.
+ *
+ * Input Parameters:
+ *   gro     - The coalescing state to initialize
+ *   buffer  - Buffer for the merged packet
+ *   bufsize - Size of the buffer.  Larger than the MTU (but at most 65535)
+ *             for coalescing to be of any use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+void netdev_gro_initialize(FAR struct netdev_gro_s *gro,
+                           FAR uint8_t *buffer, uint16_t bufsize);
+
+/****************************************************************************
+ * Name: netdev_gro_input
+ *
+ * Description:
+ *   Called by the driver in place of ipv4_input() for each received IPv4
+ *   packet in d_buf.  An in-order TCP segment of the flow being held is
+ *   merged into the held packet.  Any other packet causes the held packet
+ *   to be passed to ipv4_input(); a segment that may be merged later is
+ *   then held, while other packets are passed to ipv4_input() at once.
+ *
+ *   Each packet passed to ipv4_input() that produces output (d_len > 0)
+ *   is followed by a call to 'xmit', which must do with the response what
+ *   the driver would do after ipv4_input().  Note that d_buf may then be
+ *   the coalescing buffer.
+ *
+ * Input Parameters:
+ *   dev  - The network device with the received packet of d_len bytes
+ *   gro  - The coalescing state of the device
+ *   xmit - Transmits a response
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if 'xmit' failed.  d_len
+ *   is zero on return.
+ *
+ ****************************************************************************/
+
+int netdev_gro_input(FAR struct net_driver_s *dev,
+                     FAR struct netdev_gro_s *gro,
+                     devif_poll_callback_t xmit);
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the held packet, if any, to ipv4_input().  The driver calls this
+ *   when no more received packets are ready and before it passes a packet
+ *   to the network in any other way.
+ *
+ * Input Parameters:
+ *   dev  - The network device
+ *   gro  - The coalescing state of the device
+ *   xmit - Transmits a response, as for netdev_gro_input()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if 'xmit' failed.
+ *
+ ****************************************************************************/
+
+int netdev_gro_flush(FAR struct net_driver_s *dev,
+                     FAR struct netdev_gro_s *gro,
+                     devif_poll_callback_t xmit);
+#endif
+
+/****************************************************************************
+ * Name: netdev_rxpoll_initialize
+ *
+ * Description:
+ *   Prepare budgeted receive polling for a network device.  rp_dev,
+ *   rp_rxframe, and rp_rxint must be set up by the driver before calling
+ *   this.  A budget of zero selects CONFIG_NETDEV_RXPOLL_BUDGET.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXPOLL
+void netdev_rxpoll_initialize(FAR struct netdev_rxpoll_s *rxpoll, int qid,
+                              uint16_t budget);
+
+/****************************************************************************
+ * Name: netdev_rxpoll_schedule
+ *
+ * Description:
+ *   Called from the Rx interrupt handler of the device.  Disables further
+ *   Rx interrupts and schedules a poll pass on the worker thread.
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_schedule(FAR struct netdev_rxpoll_s *rxpoll);
+
+/****************************************************************************
+ * Name: netdev_rxpoll_cancel
+ *
+ * Description:
+ *   Cancel any pending poll pass, e.g. when the device is brought down.
+ *   Rx interrupts are left disabled.
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_cancel(FAR struct netdev_rxpoll_s *rxpoll);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
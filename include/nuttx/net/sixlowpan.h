@@ -380,10 +380,19 @@ struct sixlowpan_reassbuf_s
 
   bool rb_active;
 
-  /* Supports a singly linked list */
+  /* Supports a singly linked list (the free list or a hash chain of active
+   * reassembly buffers).
+   */
 
   FAR struct sixlowpan_reassbuf_s *rb_flink;
 
+  /* Supports a doubly linked list of the active reassembly buffers in the
+   * order that they were started.
+   */
+
+  FAR struct sixlowpan_reassbuf_s *rb_aflink;
+  FAR struct sixlowpan_reassbuf_s *rb_ablink;
+
   /* Fragmentation is handled frame by frame and requires that certain
    * state information be retained from frame to frame.  That additional
    * information follows the externally visible packet buffer.
@@ -442,6 +451,18 @@ struct sixlowpan_reassbuf_s
   systime_t rb_time;
 };
 
+/* The argument of the SIOCSLOWPANCTX, SIOCDLOWPANCTX, and SIOCGLOWPANCTX
+ * ioctl commands.  An address context supplies the 64-bit prefix that is
+ * elided when an address with that prefix is compressed (RFC 6282).
+ * Context 0 is used when no other context number is sent.
+ */
+
+struct sixlowpan_ctxreq_s
+{
+  uint8_t cr_cid;             /* Context number (0-15) */
+  uint8_t cr_prefix[8];       /* Prefix in network order */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
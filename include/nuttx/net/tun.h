@@ -52,11 +52,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* TUNSETIFF ifr flags */
+/* TUNSETIFF ifr flags.
+ *
+ * IFF_MULTI_PKT:   Each read() and write() may carry several packets, each
+ *                  preceded by its length as a 2-byte, big-endian value.
+ * IFF_MULTI_QUEUE: Further files may be attached to the interface by
+ *                  TUNSETIFF with the same flags and interface name (see
+ *                  CONFIG_NET_TUN_NQUEUES).
+ */
 
 #define IFF_TUN          0x01
 #define IFF_TAP          0x02
-#define IFF_MASK         0x7f
+#define IFF_MASK         0x1f
+#define IFF_MULTI_PKT    0x20
+#define IFF_MULTI_QUEUE  0x40
 #define IFF_NO_PI        0x80
 
 /****************************************************************************
@@ -464,7 +464,9 @@ typedef FAR void *FCACHE;
 
 struct nxfonts_glyph_s
 {
-  FAR struct nxfonts_glyph_s *flink;   /* Implements a singly linked list */
+  FAR struct nxfonts_glyph_s *flink;   /* Next glyph in LRU order */
+  FAR struct nxfonts_glyph_s *blink;   /* Previous glyph in LRU order */
+  FAR struct nxfonts_glyph_s *hlink;   /* Next glyph in the hash bucket */
   uint8_t code;                        /* Character code */
   uint8_t height;                      /* Height of this glyph (in rows) */
   uint8_t width;                       /* Width of this glyph (in pixels) */
@@ -669,6 +671,33 @@ NXHANDLE nxf_cache_getfonthandle(FCACHE fhandle);
 
 FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle, uint8_t ch);
 
+/****************************************************************************
+ * Name: nxf_cache_renderstring
+ *
+ * Description:
+ *   Render a string of characters from the font cache into a caller
+ *   provided strip so that the whole string can be drawn with a single
+ *   bitmap operation.  Characters with no glyph are rendered as spaces.
+ *   Rendering stops at the first character that does not fit in the strip.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by nxf_cache_connect();
+ *   str     - The characters to render
+ *   len     - The number of characters in 'str'
+ *   dest    - The strip memory in the font cache's pixel format
+ *   stride  - The width of one row of the strip in bytes
+ *   size    - On input, the size of the strip in pixels.  On return, the
+ *             size of the region actually rendered.
+ *
+ * Returned Value:
+ *   The number of characters rendered.
+ *
+ ****************************************************************************/
+
+int nxf_cache_renderstring(FCACHE fhandle, FAR const uint8_t *str, int len,
+                           FAR uint8_t *dest, unsigned int stride,
+                           FAR struct nxgl_size_s *size);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -143,15 +143,17 @@
 #define TCB_FLAG_NONCANCELABLE     (1 << 2) /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_DEFERRED   (1 << 3) /* Bit 3: Deferred (vs asynch) cancellation type */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 4) /* Bit 4: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-6: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (5) /* Bit 5-7: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT) /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT) /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT) /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT) /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 7) /* Bit 7: Locked to this CPU */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 8) /* Bit 8: Exitting */
-                                            /* Bits 9-15: Available */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT) /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 8) /* Bit 8: Locked to this CPU */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 9) /* Bit 9: Exitting */
+#define TCB_FLAG_SEM_REQUEUED      (1 << 10) /* Bit 10: Moved to another semaphore */
+                                            /* Bits 11-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -261,6 +263,10 @@ typedef CODE void (*atexitfunc_t)(void);
 typedef CODE void (*onexitfunc_t)(int exitcode, FAR void *arg);
 #endif
 
+#ifdef CONFIG_HRTIMER
+struct hrtimer_s;
+#endif
+
 /* struct sporadic_s *************************************************************/
 
 #ifdef CONFIG_SCHED_SPORADIC
@@ -270,6 +276,9 @@ typedef CODE void (*onexitfunc_t)(int exitcode, FAR void *arg);
  */
 
 struct sporadic_s;
+#ifdef CONFIG_FS_POLLCACHE
+struct pollcache_s;
+#endif
 struct replenishment_s
 {
   FAR struct tcb_s *tcb;            /* The parent TCB structure                 */
@@ -307,6 +316,32 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s *************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure.  It is
+ * allocated when the deadline scheduling policy is assigned to a thread and
+ * holds the deadline parameters and the state of the current period.  All
+ * times are in units of system clock ticks.
+ */
+
+struct deadline_s
+{
+  FAR struct deadline_s *flink;     /* Next in order of absolute deadline       */
+  FAR struct tcb_s *tcb;            /* The parent TCB structure                 */
+  struct wdog_s timer;              /* Timer for the start of the next period   */
+  bool      throttled;              /* Budget of this period is exhausted       */
+  uint32_t  runtime;                /* Execution budget per period              */
+  uint32_t  deadline;               /* Deadline relative to start of period     */
+  uint32_t  period;                 /* Activation period                        */
+  uint32_t  bandwidth;              /* Reserved CPU share (runtime/deadline)    */
+  systime_t release;                /* Start time of the current period         */
+  systime_t abstime;                /* Absolute deadline of the current period  */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s *********************************************************/
 /* This structure is used to maintain information about child tasks.  pthreads
  * work differently, they have join information.  This is only for child tasks.
@@ -474,6 +509,9 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+#ifdef CONFIG_SIG_ACTIONTABLE
+  FAR struct sigactq *tg_sigaction[MAX_SIGNO + 1]; /* Actions by signal number */
+#endif
 #endif
 
 #ifndef CONFIG_DISABLE_ENVIRON
@@ -481,6 +519,11 @@ struct task_group_s
 
   size_t     tg_envsize;            /* Size of environment string allocation    */
   FAR char  *tg_envp;               /* Allocated environment strings            */
+#ifdef CONFIG_ENVIRON_HASH
+  FAR uint16_t *tg_envhash;         /* Hashed index of environment strings      */
+  uint16_t   tg_envhsize;           /* Number of slots in tg_envhash            */
+  uint16_t   tg_envcount;           /* Number of environment strings            */
+#endif
 #endif
 
   /* PIC data space and address environments ************************************/
@@ -516,6 +559,12 @@ struct task_group_s
   struct socketlist tg_socketlist;  /* Maps socket descriptor to socket         */
 #endif
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* poll() registration cache **************************************************/
+
+  FAR struct pollcache_s *tg_pollcache; /* Registrations of the last poll()   */
+#endif
+
 #ifndef CONFIG_DISABLE_MQUEUE
   /* POSIX Named Message Queue Fields *******************************************/
 
@@ -587,15 +636,41 @@ struct tcb_s
   int16_t  cpcount;                      /* Nested cancellation point count     */
 #endif
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
-  int32_t  timeslice;                    /* RR timeslice OR Sporadic budget     */
-                                         /* interval remaining                  */
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+  int32_t  timeslice;                    /* RR timeslice OR Sporadic/Deadline   */
+                                         /* budget interval remaining           */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters      */
+#endif
+
+#ifdef CONFIG_SCHED_RUNTIME
+  uint64_t run_time;                     /* Accumulated run time in counts      */
+  uint32_t run_count;                    /* Number of times the thread resumed  */
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  FAR void *crit_caller;                 /* Caller of the critical section      */
+  uint32_t crit_start;                   /* Counter when entered or resumed     */
+  uint32_t crit_elapsed;                 /* Counts before the last suspension   */
+  FAR void *premp_caller;                /* Caller that locked pre-emption      */
+  uint32_t premp_start;                  /* Counter when locked or resumed      */
+  uint32_t premp_elapsed;                /* Counts before the last suspension   */
+  uint32_t wake_start;                   /* Counter when the waking IRQ began   */
+  int16_t  wake_irq;                     /* Waking IRQ plus one, 0 if none      */
+#ifndef CONFIG_SMP
+  int16_t  crit_nest;                    /* Nesting of critical sections        */
+#endif
 #endif
 
   FAR struct wdog_s *waitdog;            /* All timed waits use this timer      */
+#ifdef CONFIG_HRTIMER
+  FAR struct hrtimer_s *waithrtimer;     /* High resolution timed wait, if any  */
+#endif
 
   /* Stack-Related Fields *******************************************************/
 
@@ -606,6 +681,9 @@ struct tcb_s
                                          /* Need to deallocate stack            */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#ifdef CONFIG_STACK_COLORATION
+  size_t    stack_hwm;                   /* Last stack high-water mark found    */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -616,6 +694,12 @@ struct tcb_s
   /* POSIX Semaphore Control Fields *********************************************/
 
   sem_t *waitsem;                        /* Semaphore ID waiting on             */
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  FAR struct semholder_s *holdsem;       /* List of semaphores held             */
+  FAR struct tcb_s *wchild;              /* Waiter heap:  First child           */
+  FAR struct tcb_s *wnext;               /* Waiter heap:  Next sibling          */
+  FAR struct tcb_s *wprev;               /* Waiter heap:  Prev sibling/parent   */
+#endif
 
   /* POSIX Signal Control Fields ************************************************/
 
@@ -696,6 +780,9 @@ struct pthread_tcb_s
 
   pthread_addr_t arg;                    /* Startup argument                    */
   FAR void *joininfo;                    /* Detach-able info to support join    */
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+  size_t stacksize;                      /* Requested stack size (for the cache)*/
+#endif
 
   /* Robust mutex support *******************************************************/
 
@@ -716,7 +803,11 @@ struct pthread_tcb_s
 
   /* POSIX Thread Specific Data *************************************************/
 
-#if CONFIG_NPTHREAD_KEYS > 0
+  /* With TLS, the thread specific data lives in the TLS area instead (see
+   * include/nuttx/tls.h).
+   */
+
+#if CONFIG_NPTHREAD_KEYS > 0 && !defined(CONFIG_TLS)
   FAR void *pthread_data[CONFIG_NPTHREAD_KEYS];
 #endif
 };
@@ -726,6 +817,90 @@ struct pthread_tcb_s
 
 typedef void (*sched_foreach_t)(FAR struct tcb_s *tcb, FAR void *arg);
 
+#ifdef CONFIG_SMP_BALANCE
+/* This structure holds the load balancing statistics of one CPU.  It is
+ * returned by sched_balance_stats().
+ */
+
+struct sched_balance_s
+{
+  uint32_t migrations;                   /* Threads started here after running
+                                          * on another CPU */
+  uint32_t pulls;                        /* Threads pulled by the IDLE thread */
+};
+#endif
+
+#ifdef CONFIG_SCHED_RUNTIME
+/* This structure holds the precise run time of one thread.  It is returned
+ * by sched_runtime().
+ */
+
+struct sched_runtime_s
+{
+  uint64_t usecs;                        /* Time spent running (microseconds) */
+  uint32_t switches;                     /* Number of times the thread resumed */
+};
+
+/* This structure holds the run time statistics of one CPU.  It is returned
+ * by sched_cpustat().
+ */
+
+struct sched_cpustat_s
+{
+  uint64_t busy;                         /* Time spent running threads other
+                                          * than IDLE (microseconds) */
+  uint64_t idle;                         /* Time spent running the IDLE thread
+                                          * (microseconds) */
+  uint32_t switches;                     /* Number of context switches */
+};
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* The types of sections whose duration is monitored by call site */
+
+enum critmon_type_e
+{
+  CRITMON_CSECTION = 0,                  /* enter_critical_section() */
+  CRITMON_PREEMPTION                     /* sched_lock() */
+};
+
+/* The number of buckets of the duration histograms.  Bucket n counts the
+ * durations of less than 2**n microseconds; the last bucket counts all longer
+ * durations.
+ */
+
+#define CRITMON_NBUCKETS 10
+
+/* This structure holds the statistics of one call site.  It is returned by
+ * sched_critmon_getsite().
+ */
+
+struct critmon_site_s
+{
+  FAR void *caller;                      /* Return address of the call */
+  uint32_t count;                        /* Number of sections */
+  uint32_t max;                          /* Longest section (microseconds) */
+  uint32_t hist[CRITMON_NBUCKETS];       /* Histogram of durations */
+};
+
+/* This structure holds the statistics of the handler of one IRQ and the
+ * latencies from the start of the interrupt to the first run of each thread
+ * that the handler made ready-to-run.  It is returned by
+ * sched_critmon_getirq().
+ */
+
+struct critmon_irq_s
+{
+  uint32_t count;                        /* Number of interrupts handled */
+  uint32_t max;                          /* Longest handler (microseconds) */
+  uint64_t total;                        /* Total time (microseconds) */
+  uint32_t hist[CRITMON_NBUCKETS];       /* Histogram of durations */
+  uint32_t wakeups;                      /* Number of threads woken */
+  uint32_t latmax;                       /* Longest latency (microseconds) */
+  uint32_t lathist[CRITMON_NBUCKETS];    /* Histogram of latencies */
+};
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 /********************************************************************************
@@ -764,6 +939,44 @@ void sched_foreach(sched_foreach_t handler, FAR void *arg);
 
 FAR struct tcb_s *sched_gettcb(pid_t pid);
 
+/* SMP load balancing ***********************************************************/
+/* sched_balance_stats() returns the load balancing statistics of one CPU.  It
+ * returns -EINVAL if the CPU index is not valid.
+ */
+
+#ifdef CONFIG_SMP_BALANCE
+int sched_balance_stats(int cpu, FAR struct sched_balance_s *stats);
+#endif
+
+/* Run time accounting **********************************************************/
+/* sched_runtime() returns the precise run time of the thread with the given
+ * task ID, including the interval in progress if the thread is running.  It
+ * returns -ESRCH if there is no such thread.  sched_cpustat() returns the run
+ * time statistics of one CPU.  It returns -EINVAL if the CPU index is not
+ * valid.
+ */
+
+#ifdef CONFIG_SCHED_RUNTIME
+int sched_runtime(pid_t pid, FAR struct sched_runtime_s *runtime);
+int sched_cpustat(int cpu, FAR struct sched_cpustat_s *stats);
+#endif
+
+/* Critical section monitor ****************************************************/
+/* sched_critmon_getsite() returns the statistics of one entry of the table of
+ * critical section or pre-emption lock call sites.  It returns -ENOENT if the
+ * entry is unused.  sched_critmon_getirq() returns the handler statistics of
+ * one IRQ.  It returns -ENOENT if the interrupt never occurred.  Both return
+ * -EINVAL if the arguments are not valid.  sched_critmon_reset() discards all
+ * statistics.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+int sched_critmon_getsite(int type, int index,
+                          FAR struct critmon_site_s *site);
+int sched_critmon_getirq(int irq, FAR struct critmon_irq_s *stats);
+void sched_critmon_reset(void);
+#endif
+
 /* File system helpers **********************************************************/
 /* These functions all extract lists from the group structure assocated with the
  * currently executing task.
@@ -849,7 +1062,8 @@ void task_vforkabort(FAR struct task_tcb_s *child, int errcode);
  ********************************************************************************/
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
-    defined(CONFIG_SCHED_INSTRUMENTATION)
+    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SCHED_RUNTIME) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 void sched_resume_scheduler(FAR struct tcb_s *tcb);
 #else
 #  define sched_resume_scheduler(tcb)
@@ -871,7 +1085,8 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb);
  *
  ********************************************************************************/
 
-#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION)
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION) || \
+    defined(CONFIG_SCHED_RUNTIME) || defined(CONFIG_SCHED_CRITMONITOR)
 void sched_suspend_scheduler(FAR struct tcb_s *tcb);
 #else
 #  define sched_suspend_scheduler(tcb)
@@ -348,6 +348,71 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen);
 ssize_t sched_note_size(void);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_peek
+ *
+ * Description:
+ *   Return the oldest data in the note buffer of one CPU without removing
+ *   it.  The returned region is contiguous in memory and holds complete
+ *   notes, except that a note may continue at the beginning of the buffer
+ *   if the region ends at the end of the buffer.  The data remains valid
+ *   until it is released with sched_note_release().
+ *
+ *   Only a single reader may use this interface for a given CPU.
+ *
+ * Input Parameters:
+ *   cpu  - The CPU whose note buffer is to be read
+ *   data - Location to return the address of the oldest data
+ *
+ * Returned Value:
+ *   The number of contiguous bytes available at 'data'.  Zero is returned
+ *   if the buffer is empty.  A negated errno value is returned if 'cpu' is
+ *   not valid.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_BUFFER) && \
+    defined(CONFIG_SCHED_NOTE_PERCPU)
+ssize_t sched_note_peek(int cpu, FAR const uint8_t **data);
+
+/****************************************************************************
+ * Name: sched_note_release
+ *
+ * Description:
+ *   Remove data returned by sched_note_peek() from the note buffer of one
+ *   CPU making room for further notes.
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose note buffer was read
+ *   len - The number of bytes to remove (no more than were returned by
+ *         sched_note_peek())
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_note_release(int cpu, size_t len);
+
+/****************************************************************************
+ * Name: sched_note_dropped
+ *
+ * Description:
+ *   Return the number of notes that were lost because the note buffer of
+ *   one CPU was full.
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose note buffer is queried
+ *
+ * Returned Value:
+ *   The number of notes dropped since initialization (zero if 'cpu' is
+ *   not valid).
+ *
+ ****************************************************************************/
+
+unsigned long sched_note_dropped(int cpu);
+#endif
+
 /****************************************************************************
  * Name: note_register
  *
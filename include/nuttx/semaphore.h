@@ -142,6 +142,35 @@ int sem_tickwait(FAR sem_t *sem, systime_t start, uint32_t delay);
 
 int sem_reset(FAR sem_t *sem, int16_t count);
 
+/****************************************************************************
+ * Name: sem_decrement
+ *
+ * Description:
+ *   Take one count from a semaphore without ever blocking.  This is used
+ *   by allocators that keep a counting semaphore along with a free list and
+ *   that may be called from interrupt handlers:  Having removed an entry
+ *   from the free list under their own protection, they already know that
+ *   the count may be taken.  The count may then become negative only if it
+ *   was negative to begin with.
+ *
+ *   Such logic must use sem_decrement() rather than modifying the count
+ *   directly because, with CONFIG_SEM_SPINLOCKS, the count may be modified
+ *   on another CPU outside of the critical section.
+ *
+ * Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_SPINLOCKS
+void sem_decrement(FAR sem_t *sem);
+#else
+#  define sem_decrement(sem) ((sem)->semcount--)
+#endif
+
 /****************************************************************************
  * Name: sem_getprotocol
  *
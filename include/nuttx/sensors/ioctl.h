@@ -143,4 +143,10 @@
 #define SNIOC_WHO_AM_I              _SNIOC(0x003b)
 #define SNIOC_READ_TEMP             _SNIOC(0x003c) /* Arg: int16_t value */
 
+/* IOCTL commands of the common sensor upper half (see sensor.h) */
+
+#define SNIOC_SET_INTERVAL          _SNIOC(0x003d) /* Arg: uint32_t* value */
+#define SNIOC_BATCH                 _SNIOC(0x003e) /* Arg: uint32_t value */
+#define SNIOC_GET_OVERRUNS          _SNIOC(0x003f) /* Arg: uint32_t* value */
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
@@ -0,0 +1,226 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/sensors/ioctl.h>
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************
+ * CONFIG_SENSORS_UPPERHALF - Enables the common sensor upper half
+ * CONFIG_SENSORS_NPOLLWAITERS - Maximum number of poll() waiters per sensor
+ */
+
+#ifndef CONFIG_SENSORS_NPOLLWAITERS
+#  define CONFIG_SENSORS_NPOLLWAITERS 2
+#endif
+
+/* IOCTL Commands ***********************************************************/
+/* SNIOC_SET_INTERVAL - Set the sampling interval.
+ *   Argument: uint32_t pointer to the interval in microseconds.  The
+ *   interval actually used by the sensor is returned.
+ * SNIOC_BATCH - Set the maximum latency with which samples are delivered.
+ *   The lower half may let the samples accumulate in its hardware FIFO
+ *   for up to this time.  Zero delivers every sample right away.
+ *   Argument: uint32_t latency in microseconds.
+ * SNIOC_GET_OVERRUNS - Get the number of samples lost because the FIFO was
+ *   full and reset the count to zero.
+ *   Argument: uint32_t pointer to the location to return the count.
+ *
+ * Other commands are forwarded to the lower half.
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Every sample begins with this header.  The lower half defines the data
+ * that follows it; e.g.:
+ *
+ *   struct accel_sample_s
+ *   {
+ *     struct sensor_sample_s hdr;
+ *     int16_t x;
+ *     int16_t y;
+ *     int16_t z;
+ *   };
+ */
+
+struct sensor_sample_s
+{
+  uint64_t timestamp;             /* Sample time in microseconds */
+};
+
+/* This is the vtable that is used by the upper half sensor driver to call
+ * back into the lower half.
+ */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Start (enable == true) or stop the collection of samples.  Called on
+   * the first open and the last close.  Required.
+   */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Set the sampling interval in microseconds.  The lower half returns the
+   * interval actually used in *period_us.  Optional.
+   */
+
+  CODE int (*set_interval)(FAR struct sensor_lowerhalf_s *lower,
+                           FAR uint32_t *period_us);
+
+  /* Set the maximum delivery latency in microseconds.  Lower halves with a
+   * hardware FIFO use this to program the FIFO watermark and then push
+   * the whole FIFO content in one sensor_push() call.  Optional.
+   */
+
+  CODE int (*batch)(FAR struct sensor_lowerhalf_s *lower,
+                    uint32_t latency_us);
+
+  /* Read a sample right away and sensor_push() it.  Used by polled lower
+   * halves without a data-ready interrupt:  The upper half calls this
+   * when read() finds the FIFO empty.  Optional.
+   */
+
+  CODE int (*fetch)(FAR struct sensor_lowerhalf_s *lower);
+
+  /* Lower-half logic may support device-specific ioctl commands */
+
+  CODE int (*ioctl)(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                    unsigned long arg);
+};
+
+/* This is the interface between the lower half sensor driver and the upper
+ * half.  The lower half normally embeds this structure at the beginning
+ * of its own state structure.
+ */
+
+struct sensor_lowerhalf_s
+{
+  FAR const struct sensor_ops_s *ops; /* Lower half operations */
+  uint16_t samplesize;                /* Size of one sample, including the
+                                       * struct sensor_sample_s header */
+
+  /* The following is set by sensor_register() */
+
+  FAR void *upper;                    /* The upper half state */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Register a sensor lower half as the character device 'devpath' with a
+ *   FIFO of 'nsamples' samples.
+ *
+ * Input Parameters:
+ *   devpath  - The full path to the driver to register, e.g. "/dev/accel0"
+ *   lower    - An instance of the lower half interface
+ *   nsamples - The number of samples the FIFO can hold
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *devpath,
+                    FAR struct sensor_lowerhalf_s *lower,
+                    unsigned int nsamples);
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Add samples to the FIFO of the sensor and wake up any readers.  If the
+ *   FIFO is full, the oldest samples are discarded.  May be called from
+ *   interrupt handlers.
+ *
+ * Input Parameters:
+ *   lower    - The lower half that the samples are from
+ *   samples  - 'nsamples' samples of lower->samplesize bytes each
+ *   nsamples - The number of samples
+ *
+ ****************************************************************************/
+
+void sensor_push(FAR struct sensor_lowerhalf_s *lower,
+                 FAR const void *samples, unsigned int nsamples);
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current time in microseconds, as used for the timestamp of
+ *   the samples.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPERHALF */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
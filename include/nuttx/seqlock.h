@@ -0,0 +1,256 @@
+/****************************************************************************
+ * include/nuttx/seqlock.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SEQLOCK_H
+#define __INCLUDE_NUTTX_SEQLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Memory barriers.  On SMP, the reader must see the sequence count and the
+ * protected data in the order that the writer stored them.  Otherwise, only
+ * the compiler must be kept from moving accesses across the sequence count.
+ */
+
+#ifdef CONFIG_SMP
+#  define SEQ_RMB() SP_DSB()
+#  define SEQ_WMB() SP_DMB()
+#elif defined(__GNUC__)
+#  define SEQ_RMB() __asm__ __volatile__ ("" : : : "memory")
+#  define SEQ_WMB() __asm__ __volatile__ ("" : : : "memory")
+#else
+#  define SEQ_RMB()
+#  define SEQ_WMB()
+#endif
+
+#define SEQCOUNT_INITIALIZER {0}
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A sequence count protects read-mostly data without blocking readers.
+ * The writer increments the count before and after each update, so the
+ * count is odd while an update is in progress.  A reader samples the count
+ * before reading the data and retries if the count was odd or has changed
+ * when it is done.  Writers must be serialized by other means.
+ */
+
+struct seqcount_s
+{
+  volatile uint32_t sequence;
+};
+
+/* A sequence lock is a sequence count together with the spinlock that
+ * serializes its writers.
+ */
+
+struct seqlock_s
+{
+  struct seqcount_s sl_count;  /* The sequence count */
+#ifdef CONFIG_SMP
+  spinlock_t sl_lock;          /* Serializes writers */
+#endif
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: seqcount_read_begin
+ *
+ * Description:
+ *   Begin a read of data protected by a sequence count.  Waits while an
+ *   update is in progress.
+ *
+ * Input Parameters:
+ *   seq - The sequence count.
+ *
+ * Returned Value:
+ *   The sequence to be passed to seqcount_read_retry().
+ *
+ ****************************************************************************/
+
+static inline uint32_t seqcount_read_begin(FAR const struct seqcount_s *seq)
+{
+  uint32_t sequence;
+
+  while (((sequence = seq->sequence) & 1) != 0)
+    {
+    }
+
+  SEQ_RMB();
+  return sequence;
+}
+
+/****************************************************************************
+ * Name: seqcount_read_retry
+ *
+ * Description:
+ *   End a read of data protected by a sequence count.
+ *
+ * Input Parameters:
+ *   seq      - The sequence count.
+ *   sequence - The value returned by seqcount_read_begin().
+ *
+ * Returned Value:
+ *   true if the data was updated during the read and the read must be
+ *   repeated.
+ *
+ ****************************************************************************/
+
+static inline bool seqcount_read_retry(FAR const struct seqcount_s *seq,
+                                       uint32_t sequence)
+{
+  SEQ_RMB();
+  return seq->sequence != sequence;
+}
+
+/****************************************************************************
+ * Name: seqcount_write_begin and seqcount_write_end
+ *
+ * Description:
+ *   Bracket an update of data protected by a sequence count.  The caller
+ *   must serialize writers and must not be interrupted by a reader on the
+ *   same CPU between the two calls (normally, by disabling interrupts).
+ *
+ ****************************************************************************/
+
+static inline void seqcount_write_begin(FAR struct seqcount_s *seq)
+{
+  seq->sequence++;
+  SEQ_WMB();
+}
+
+static inline void seqcount_write_end(FAR struct seqcount_s *seq)
+{
+  SEQ_WMB();
+  seq->sequence++;
+}
+
+/****************************************************************************
+ * Name: seqlock_initialize
+ *
+ * Description:
+ *   Initialize a sequence lock.
+ *
+ ****************************************************************************/
+
+static inline void seqlock_initialize(FAR struct seqlock_s *sl)
+{
+  sl->sl_count.sequence = 0;
+#ifdef CONFIG_SMP
+  sl->sl_lock = SP_UNLOCKED;
+#endif
+}
+
+/****************************************************************************
+ * Name: seqlock_read_begin and seqlock_read_retry
+ *
+ * Description:
+ *   Readers of a sequence lock never take the lock:
+ *
+ *     do
+ *       {
+ *         seq = seqlock_read_begin(&lock);
+ *         ... copy the protected data ...
+ *       }
+ *     while (seqlock_read_retry(&lock, seq));
+ *
+ ****************************************************************************/
+
+#define seqlock_read_begin(sl)   seqcount_read_begin(&(sl)->sl_count)
+#define seqlock_read_retry(sl,s) seqcount_read_retry(&(sl)->sl_count, (s))
+
+/****************************************************************************
+ * Name: seqlock_write_irqsave
+ *
+ * Description:
+ *   Disable local interrupts, exclude other writers and begin an update.
+ *
+ * Returned Value:
+ *   The interrupt state to be passed to seqlock_write_irqrestore().
+ *
+ ****************************************************************************/
+
+static inline irqstate_t seqlock_write_irqsave(FAR struct seqlock_s *sl)
+{
+  irqstate_t flags;
+
+#ifdef CONFIG_SMP
+  flags = spin_lock_irqsave(&sl->sl_lock);
+#else
+  flags = up_irq_save();
+#endif
+
+  seqcount_write_begin(&sl->sl_count);
+  return flags;
+}
+
+/****************************************************************************
+ * Name: seqlock_write_irqrestore
+ *
+ * Description:
+ *   End an update, allow other writers and restore local interrupts.
+ *
+ ****************************************************************************/
+
+static inline void seqlock_write_irqrestore(FAR struct seqlock_s *sl,
+                                            irqstate_t flags)
+{
+  seqcount_write_end(&sl->sl_count);
+
+#ifdef CONFIG_SMP
+  spin_unlock_irqrestore(&sl->sl_lock, flags);
+#else
+  up_irq_restore(flags);
+#endif
+}
+
+#endif /* __INCLUDE_NUTTX_SEQLOCK_H */
@@ -142,6 +142,7 @@ struct uart_dmaxfer_s
   size_t           length;  /* Length of first DMA buffer */
   size_t           nlength; /* Length of next DMA buffer */
   size_t           nbytes;  /* Bytes actually transferred by DMA from both buffers */
+  size_t           nreported; /* Bytes already reported by uart_recvchars_idle() */
 };
 #endif /* CONFIG_SERIAL_DMA */
 
@@ -481,6 +482,22 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *   Make the bytes received so far by the active RX DMA transfer available to
+ *   readers without ending the transfer.  This should be called by the lower half
+ *   on an idle-line or receive timeout event with 'nbytes' set to the total number
+ *   of bytes that the transfer has written so far.  A later uart_recvchars_done()
+ *   accounts only for the bytes that were not yet reported.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_DMA
+void uart_recvchars_idle(FAR uart_dev_t *dev, size_t nbytes);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -226,6 +226,30 @@
 
 #define QSPI_FREE(d,b) (d)->ops->free(d,b)
 
+/****************************************************************************
+ * Name: QSPI_MEMMAP
+ *
+ * Description:
+ *   Switch the controller into memory-mapped read mode, in which the FLASH
+ *   is read by the CPU (or a DMA) from a window in the address space, or
+ *   leave that mode again.  Commands must not be issued while the
+ *   controller is memory-mapped.  The caller must hold the bus lock (see
+ *   QSPI_LOCK).  This method is optional.
+ *
+ * Input Parameters:
+ *   dev     - Device-specific state data
+ *   meminfo - Describes the read command used for the memory-mapped window
+ *             (buflen and buffer are ignored), or NULL to leave
+ *             memory-mapped mode.
+ *
+ * Returned Value:
+ *   The address of the memory-mapped window on entry; NULL if memory-
+ *   mapped mode is not supported or on exit.
+ *
+ ****************************************************************************/
+
+#define QSPI_MEMMAP(d,m) ((d)->ops->memmap ? (d)->ops->memmap(d,m) : NULL)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -283,6 +307,8 @@ struct qspi_ops_s
                     FAR struct qspi_meminfo_s *meminfo);
   CODE FAR void *(*alloc)(FAR struct qspi_dev_s *dev, size_t buflen);
   CODE void      (*free)(FAR struct qspi_dev_s *dev, FAR void *buffer);
+  CODE FAR void *(*memmap)(FAR struct qspi_dev_s *dev,
+                    FAR const struct qspi_meminfo_s *meminfo);
 };
 
 /* QSPI private data.  This structure only defines the initial fields of the
@@ -62,6 +62,8 @@
  *   output that selects between command and data.
  * CONFIG_SPI_HWFEATURES - Include an interface method to support special,
  *   hardware-specific SPI features.
+ * CONFIG_SPI_QUEUE - Include the optional queue() interface method used by
+ *   spi_queue() to hand a chain of sequences to the driver's DMA.
  */
 
 /* Access macros ************************************************************/
@@ -420,6 +422,31 @@
 #define SPI_REGISTERCALLBACK(d,c,a) \
   ((d)->ops->registercallback ? (d)->ops->registercallback(d,c,a) : -ENOSYS)
 
+/****************************************************************************
+ * Name: SPI_QUEUE
+ *
+ * Description:
+ *   Start a chain of transfer sequences without waiting for them to
+ *   complete.  Drivers that support this program the whole chain, including
+ *   the device selection between sequences, as linked DMA descriptors and
+ *   call chain->done() once from the final DMA interrupt.  Optional; use
+ *   spi_queue() rather than calling this directly.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   chain - The chain of sequences to perform (see spi_transfer.h)
+ *
+ * Returned Value:
+ *   0 if the chain was started; negated errno if the driver cannot perform
+ *   this chain.  The chain is then performed by spi_queue() itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_QUEUE
+#  define SPI_QUEUE(d,c) \
+     ((d)->ops->queue ? (d)->ops->queue(d,c) : -ENOSYS)
+#endif
+
 /* SPI Device Macros ********************************************************/
 
 /* This builds a SPI devid from its type and index */
@@ -516,6 +543,9 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+#ifdef CONFIG_SPI_QUEUE
+struct spi_chain_s;
+#endif
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -550,6 +580,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_QUEUE
+  CODE int      (*queue)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_chain_s *chain);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
@@ -49,6 +49,10 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 
+#ifdef CONFIG_SPI_QUEUE
+#  include <nuttx/wqueue.h>
+#endif
+
 #ifdef CONFIG_SPI_EXCHANGE
 
 /* SPI Character Driver IOCTL Commands **************************************/
@@ -125,6 +129,43 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_QUEUE
+/* This describes a chain of sequences as handled by spi_queue().  Each
+ * sequence may address a different device on the bus.  done() is called
+ * once when all of the sequences have completed, possibly from the
+ * interrupt level.  The chain must not be modified until then.
+ *
+ * Example usage:
+ *   struct spi_sequence_s myseq[2];
+ *   struct spi_chain_s mychain;
+ *   ...
+ *   mychain.seq  = myseq;
+ *   mychain.nseq = 2;
+ *   mychain.done = mydone;
+ *   mychain.arg  = mypriv;
+ *   ...
+ *   int ret = spi_queue(spi, &mychain);
+ *   ...
+ */
+
+struct spi_chain_s;
+typedef CODE void (*spi_chaindone_t)(FAR struct spi_chain_s *chain,
+                                     int result);
+
+struct spi_chain_s
+{
+  FAR struct spi_sequence_s *seq; /* The array of sequences */
+  uint8_t nseq;                   /* Number of sequences */
+  spi_chaindone_t done;           /* Called when all sequences completed */
+  FAR void *arg;                  /* Caller argument for done() */
+
+  /* The following are used internally by spi_queue() */
+
+  FAR struct spi_dev_s *spi;      /* The SPI bus */
+  struct work_s work;             /* Used if the driver cannot queue */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -148,6 +189,31 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_queue
+ *
+ * Description:
+ *   Start a chain of transfer sequences and return without waiting for
+ *   them.  chain->done() is called when the last sequence has completed.
+ *   If the SPI driver can perform the chain with linked DMA descriptors,
+ *   only one interrupt is taken for the whole chain.  Otherwise the
+ *   sequences are performed one after the other with spi_transfer() on
+ *   the work queue.
+ *
+ * Input Parameters:
+ *   spi   - An instance of the SPI device to use for the transfers
+ *   chain - Describes the chain of sequences.
+ *
+ * Returned Value:
+ *   Zero (OK) if the chain was started; a negated errno value on failure.
+ *   done() is not called if the chain was not started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_QUEUE
+int spi_queue(FAR struct spi_dev_s *spi, FAR struct spi_chain_s *chain);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
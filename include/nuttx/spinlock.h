@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+#include <arch/irq.h>
+
 #ifdef CONFIG_SPINLOCK
 
 /* The architecture specific spinlock.h header file must also provide the
@@ -55,6 +57,13 @@
  *   spinlock_t  - The type of a spinlock memory object.
  *
  * SP_LOCKED and SP_UNLOCKED must constants of type spinlock_t.
+ *
+ * If CONFIG_SPINLOCK_TICKET is selected, then spinlock_t must be a 32-bit
+ * word holding the next ticket to be issued in the upper 16-bits and the
+ * ticket now being served in the lower 16-bits; SP_UNLOCKED must be zero
+ * and SP_LOCKED must be 0x00010000.  up_testset() must then lock the
+ * spinlock only if the two tickets are equal, and the architecture must
+ * also provide up_ticket().
  */
 
 #include <arch/spinlock.h>
@@ -84,6 +93,17 @@
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
+#if defined(CONFIG_SPINLOCK_TICKET) && !defined(__SP_UNLOCK_FUNCTION)
+#  define __SP_UNLOCK_FUNCTION 1
+#endif
+
+/* Access to the two halves of a ticket spinlock */
+
+#ifdef CONFIG_SPINLOCK_TICKET
+#  define SP_TICKET_NEXT(v)  ((uint16_t)((v) >> 16))
+#  define SP_TICKET_OWNER(v) ((uint16_t)((v) & 0xffff))
+#endif
+
 /* If the target CPU supports a data cache then it may be necessary to
  * manage spinlocks in a special way, perhaps linking them all into a
  * special non-cacheable memory region.
@@ -112,6 +132,20 @@ struct spinlock_s
 #endif
 };
 
+/* A reader-writer spinlock.  Any number of readers may hold the lock at
+ * the same time, but a writer has exclusive access.  A waiting writer
+ * blocks new readers so that writers are not starved.
+ */
+
+struct rw_spinlock_s
+{
+  volatile spinlock_t rw_lock;  /* Protects the fields below */
+  volatile uint16_t rw_readers; /* Number of readers holding the lock */
+  volatile uint8_t  rw_writer;  /* Non-zero: A writer holds or waits */
+};
+
+#define RW_SPINLOCK_INITIALIZER {SP_UNLOCKED, 0, 0}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -138,6 +172,28 @@ struct spinlock_s
 
 spinlock_t up_testset(volatile FAR spinlock_t *lock);
 
+/****************************************************************************
+ * Name: up_ticket
+ *
+ * Description:
+ *   Atomically take the next ticket from a ticket spinlock.
+ *
+ *   This function must be provided via the architecture-specific logic if
+ *   CONFIG_SPINLOCK_TICKET is selected.
+ *
+ * Input Parameters:
+ *   lock - The address of spinlock object.
+ *
+ * Returned Value:
+ *   The value of the spinlock before the upper 16-bits were incremented.
+ *   SP_TICKET_NEXT() of this value is the caller's ticket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_TICKET
+spinlock_t up_ticket(volatile FAR spinlock_t *lock);
+#endif
+
 /****************************************************************************
  * Name: spin_initialize
  *
@@ -302,7 +358,11 @@ void spin_unlockr(FAR struct spinlock_s *lock);
  ****************************************************************************/
 
 /* bool spin_islocked(FAR spinlock_t lock); */
-#define spin_islocked(l) (*(l) == SP_LOCKED)
+#ifdef CONFIG_SPINLOCK_TICKET
+#  define spin_islocked(l) (SP_TICKET_NEXT(*(l)) != SP_TICKET_OWNER(*(l)))
+#else
+#  define spin_islocked(l) (*(l) == SP_LOCKED)
+#endif
 
 /****************************************************************************
  * Name: spin_islockedr
@@ -363,5 +423,121 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *setlock,
                  FAR volatile spinlock_t *orlock);
 
+/****************************************************************************
+ * Name: rw_spin_initialize
+ *
+ * Description:
+ *   Initialize a reader-writer spinlock to its unlocked state.
+ *
+ ****************************************************************************/
+
+#define rw_spin_initialize(l) \
+  do \
+    { \
+      (l)->rw_lock    = SP_UNLOCKED; \
+      (l)->rw_readers = 0; \
+      (l)->rw_writer  = 0; \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Name: rw_spin_rdlock and rw_spin_rdunlock
+ *
+ * Description:
+ *   Take and release a reader-writer spinlock for reading.  Readers only
+ *   wait while a writer holds the lock or is waiting for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller must not be preempted or interrupted by a writer of the same
+ *   lock on the same CPU while it holds the lock.
+ *
+ ****************************************************************************/
+
+void rw_spin_rdlock(FAR struct rw_spinlock_s *lock);
+void rw_spin_rdunlock(FAR struct rw_spinlock_s *lock);
+
+/****************************************************************************
+ * Name: rw_spin_wrlock and rw_spin_wrunlock
+ *
+ * Description:
+ *   Take and release a reader-writer spinlock for writing.  The writer
+ *   first excludes new readers and other writers, then waits for the
+ *   readers that already hold the lock to release it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rw_spin_wrlock(FAR struct rw_spinlock_s *lock);
+void rw_spin_wrunlock(FAR struct rw_spinlock_s *lock);
+
 #endif /* CONFIG_SPINLOCK */
+
+/****************************************************************************
+ * Name: spin_lock_irqsave
+ *
+ * Description:
+ *   Disable interrupts on the local CPU and then lock the spinlock.  This
+ *   provides mutual exclusion with interrupt handlers on this CPU and with
+ *   any logic on other CPUs that holds the same spinlock.
+ *
+ *   Unlike enter_critical_section(), this does not take the global IRQ
+ *   lock and so does not stall other CPUs that are not contending for the
+ *   same object.  It may only be used to protect data that is not also
+ *   protected by the global critical section.  The spinlock must not be
+ *   held across any operation that could block or cause a context switch.
+ *
+ *   In the single CPU case, this is equivalent to up_irq_save() and the
+ *   spinlock is not referenced.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ * Returned Value:
+ *   The prior interrupt state that must be passed to
+ *   spin_unlock_irqrestore().
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.  Not re-entrant.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock);
+#else
+#  define spin_lock_irqsave(l) up_irq_save()
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_irqrestore
+ *
+ * Description:
+ *   Unlock a spinlock that was locked by spin_lock_irqsave() and then
+ *   restore the interrupt state of the local CPU.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   flags - The value returned by spin_lock_irqsave().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void spin_unlock_irqrestore(FAR volatile spinlock_t *lock, irqstate_t flags);
+#else
+#  define spin_unlock_irqrestore(l,f) up_irq_restore(f)
+#endif
+
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
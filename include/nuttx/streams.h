@@ -58,6 +58,8 @@ typedef int  (*lib_getc_t)(FAR struct lib_instream_s *this);
 
 struct lib_outstream_s;
 typedef void (*lib_putc_t)(FAR struct lib_outstream_s *this, int ch);
+typedef void (*lib_puts_t)(FAR struct lib_outstream_s *this,
+                           FAR const char *buf, int len);
 typedef int  (*lib_flush_t)(FAR struct lib_outstream_s *this);
 
 struct lib_instream_s
@@ -70,6 +72,9 @@ struct lib_instream_s
 struct lib_outstream_s
 {
   lib_putc_t             put;     /* Put one character to the outstream */
+  lib_puts_t             puts;    /* Put a buffer of characters to the
+                                   * outstream.  May be NULL, see
+                                   * lib_stream_puts() */
   lib_flush_t            flush;   /* Flush any buffered characters in the outstream */
   int                    nput;    /* Total number of characters put.  Written
                                    * by put method, readable by user */
@@ -430,6 +435,22 @@ void emergstream(FAR struct lib_outstream_s *stream);
 
 int lib_noflush(FAR struct lib_outstream_s *stream);
 
+/****************************************************************************
+ * Name: lib_stream_puts
+ *
+ * Description:
+ *  Write a buffer of characters to an output stream.  The stream's puts
+ *  method is used if it provides one; otherwise the characters are passed
+ *  one at a time to its put method.
+ *
+ * Return:
+ *  None
+ *
+ ****************************************************************************/
+
+void lib_stream_puts(FAR struct lib_outstream_s *stream,
+                     FAR const char *buf, int len);
+
 /****************************************************************************
  * Name: lib_snoflush
  *
@@ -56,6 +56,8 @@
 #include <nuttx/config.h>
 #include <nuttx/syslog/syslog.h>
 
+#include <stdarg.h>
+
 #ifdef CONFIG_RAMLOG
 
 /****************************************************************************
@@ -82,6 +84,8 @@
  * following may also be provided:
  *
  * CONFIG_RAMLOG_BUFSIZE - Size of the console RAM log.  Default: 1024
+ * CONFIG_RAMLOG_BINARY - Save SYSLOG messages as binary frames that are
+ *   decoded on the host.  Requires CONFIG_RAMLOG_SYSLOG.
  */
 
 #ifndef CONFIG_DEV_CONSOLE
@@ -190,6 +194,20 @@ int ramlog_syslog_channel(void);
 int ramlog_putc(int ch);
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vbinary
+ *
+ * Description:
+ *   Save a SYSLOG message as a compact binary frame (see
+ *   tools/ramlogdecode.py).  A negated errno value is returned if the
+ *   message cannot be encoded and must be saved as text instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_BINARY
+int ramlog_vbinary(FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
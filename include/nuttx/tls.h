@@ -51,10 +51,14 @@
  ****************************************************************************/
 /* Configuration ************************************************************/
 
-#ifndef CONFIG_TLS_LOG2_MAXSTACK
+#if defined(CONFIG_TLS_ALIGNED) && !defined(CONFIG_TLS_LOG2_MAXSTACK)
 #  error CONFIG_TLS_LOG2_MAXSTACK is not defined
 #endif
 
+#if !defined(CONFIG_TLS_ALIGNED) && !defined(CONFIG_BUILD_FLAT)
+#  error CONFIG_TLS_ALIGNED is required in the PROTECTED and KERNEL builds
+#endif
+
 #ifndef CONFIG_TLS_NELEM
 #  warning CONFIG_TLS_NELEM is not defined
 #  define CONFIG_TLS_NELEM 1
@@ -68,19 +72,24 @@
 
 /* TLS Definitions **********************************************************/
 
-#define TLS_STACK_ALIGN   (1L << CONFIG_TLS_LOG2_MAXSTACK)
-#define TLS_STACK_MASK    (TLS_STACK_ALIGN - 1)
-#define TLS_MAXSTACK      (TLS_STACK_ALIGN)
-#define TLS_INFO(sp)      ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
+#ifdef CONFIG_TLS_ALIGNED
+#  define TLS_STACK_ALIGN (1L << CONFIG_TLS_LOG2_MAXSTACK)
+#  define TLS_STACK_MASK  (TLS_STACK_ALIGN - 1)
+#  define TLS_MAXSTACK    (TLS_STACK_ALIGN)
+#  define TLS_INFO(sp)    ((FAR struct tls_info_s *)((sp) & ~TLS_STACK_MASK))
+#endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
-/* When TLS is enabled, up_createstack() will align allocated stacks to the
- * TLS_STACK_ALIGN value.  An instance of the following structure will be
- * implicitly positioned at the "lower" end of the stack.  Assuming a
- * "push down" stack, this is at the "far" end of the stack (and can be
- * clobbered if the stack overflows).
+/* When TLS is enabled, an instance of the following structure will be
+ * implicitly positioned at the "lower" end of the stack allocation
+ * (tcb->stack_alloc_ptr).  Assuming a "push down" stack, this is at the
+ * "far" end of the stack (and can be clobbered if the stack overflows).
+ *
+ * With CONFIG_TLS_ALIGNED, up_createstack() also aligns allocated stacks to
+ * the TLS_STACK_ALIGN value so that the structure can be found by masking
+ * the stack pointer.  Otherwise, it is found through the TCB.
  *
  * If an MCU has a "push up" then that TLS structure will lie at the top
  * of the stack and stack allocation and initialization logic must take
@@ -93,12 +102,40 @@
 struct tls_info_s
 {
   uintptr_t tl_elem[CONFIG_TLS_NELEM]; /* TLS elements */
+#if CONFIG_NPTHREAD_KEYS > 0
+  FAR void *tl_data[CONFIG_NPTHREAD_KEYS]; /* pthread-specific data */
+#endif
+  int tl_errno;                        /* Per-thread error number */
 };
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tls_get_info
+ *
+ * Description:
+ *   Return the TLS information structure for the currently executing
+ *   thread.  With CONFIG_TLS_ALIGNED, this is the architecture-specific
+ *   up_tls_info() which masks the stack pointer (see arch/tls.h).
+ *   Otherwise, it is the beginning of the stack allocation of the TCB at
+ *   the head of the ready-to-run list.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   A pointer to TLS info structure of the current thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TLS_ALIGNED
+#  define tls_get_info() up_tls_info()
+#else
+FAR struct tls_info_s *tls_get_info(void);
+#endif
+
 /****************************************************************************
  * Name: tls_get_element
  *
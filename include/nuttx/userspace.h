@@ -45,9 +45,13 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <signal.h>
+#include <time.h>
 #include <pthread.h>
 
 #include <nuttx/arch.h>
+#ifdef CONFIG_CLOCK_VDSO
+#  include <nuttx/seqlock.h>
+#endif
 
 #ifdef CONFIG_BUILD_PROTECTED
 
@@ -89,6 +93,23 @@
 
 struct mm_heaps_s; /* Forward reference */
 
+#ifdef CONFIG_CLOCK_VDSO
+/* The kernel publishes the system clocks to user space through this
+ * structure on each system timer tick.  It resides in user-space memory
+ * but is only written by the kernel; user space reads it under the
+ * sequence count.
+ */
+
+struct clock_vdso_s
+{
+  struct seqcount_s cv_seq;       /* Sequence count of updates */
+  struct timespec   cv_realtime;  /* CLOCK_REALTIME at the last update */
+#ifdef CONFIG_CLOCK_MONOTONIC
+  struct timespec   cv_monotonic; /* CLOCK_MONOTONIC at the last update */
+#endif
+};
+#endif
+
  /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s.  An
  * instance of this structure is expected to reside at CONFIG_NUTTX_USERSPACE.
@@ -132,6 +153,12 @@ struct userspace_s
 #ifdef CONFIG_LIB_USRWORK
   int (*work_usrstart)(void);
 #endif
+
+  /* User-space clock data */
+
+#ifdef CONFIG_CLOCK_VDSO
+  FAR struct clock_vdso_s *us_vdso;
+#endif
 };
 
 /****************************************************************************
@@ -146,6 +173,12 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+/* The user-space instance of the clock data (see libc/time) */
+
+EXTERN struct clock_vdso_s g_clock_vdso;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
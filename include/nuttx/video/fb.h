@@ -215,6 +215,12 @@
 #  define FBIO_UPDATE      _FBIOC(0x0007)  /* Update a rectangular region in the framebuffer */
                                            /* Argument: read-only struct nxgl_rect_s */
 #endif
+#ifdef CONFIG_FB_PANDISPLAY
+#  define FBIOPAN_DISPLAY  _FBIOC(0x0008)  /* Display the buffer at yoffset (page flip) */
+                                           /* Argument: read-only struct fb_planeinfo_s */
+#  define FBIO_WAITFORVSYNC _FBIOC(0x0009) /* Wait until a pending pan is displayed */
+                                           /* Argument: None */
+#endif
 
 /****************************************************************************
  * Public Types
@@ -247,7 +253,25 @@ struct fb_planeinfo_s
   fb_coord_t stride;      /* Length of a line in bytes */
   uint8_t    display;     /* Display number */
   uint8_t    bpp;         /* Bits per pixel */
+#ifdef CONFIG_FB_PANDISPLAY
+  fb_coord_t yres_virtual; /* Rows in fbmem (yres times the number of buffers) */
+  fb_coord_t yoffset;     /* First row of fbmem that is displayed */
+#endif
+};
+
+#ifdef CONFIG_FB_HWACCEL
+/* This structure describes a rectangular area of a color plane for the
+ * accelerated operations.
+ */
+
+struct fb_area_s
+{
+  fb_coord_t x;           /* X position of the upper left pixel */
+  fb_coord_t y;           /* Y position of the upper left pixel */
+  fb_coord_t w;           /* Width in pixels */
+  fb_coord_t h;           /* Height in rows */
 };
+#endif
 
 /* On video controllers that support mapping of a pixel palette value
  * to an RGB encoding, the following structure may be used to define
@@ -369,6 +393,44 @@ struct fb_vtable_s
   int (*setcursor)(FAR struct fb_vtable_s *vtable,
                    FAR struct fb_setcursor_s *settings);
 #endif
+
+#ifdef CONFIG_FB_HWACCEL
+  /* The following are provided only if the video hardware can fill and
+   * move areas of a color plane (a 2D DMA engine, for example).  Either
+   * may be NULL.  A negated errno value is returned if the operation
+   * cannot be performed in hardware (unsupported pixel format, for
+   * example); the caller must then fall back to software rendering.  The
+   * operation is complete when the method returns.
+   *
+   * fillarea - Fill the area with the color (in the plane's pixel format)
+   * movearea - Move the area to the position (destx, desty).  The source
+   *            and destination may overlap.
+   */
+
+  int (*fillarea)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, uint32_t color);
+  int (*movearea)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, fb_coord_t destx,
+                  fb_coord_t desty);
+#endif
+
+#ifdef CONFIG_FB_PANDISPLAY
+  /* The following is provided only if the video hardware can display a
+   * buffer other than the first one in the framebuffer memory (double or
+   * triple buffering).  The framebuffer memory then holds yres_virtual
+   * rows and pandisplay() selects the first row to be displayed
+   * (pinfo->yoffset).  The new offset takes effect at the next vertical
+   * synchronization; the driver then calls fb_notify_vsync().  The method
+   * may be NULL if panning is not supported.
+   */
+
+  int (*pandisplay)(FAR struct fb_vtable_s *vtable, int planeno,
+                    FAR const struct fb_planeinfo_s *pinfo);
+
+  /* Reserved for the framebuffer character driver */
+
+  FAR void *priv;
+#endif
 };
 
 /****************************************************************************
@@ -472,6 +534,27 @@ void up_fbuninitialize(int display);
 
 int fb_register(int display, int plane);
 
+/****************************************************************************
+ * Name: fb_notify_vsync
+ *
+ * Description:
+ *   Called by the framebuffer driver, normally from its vertical
+ *   synchronization interrupt handler, when the offset set by the last
+ *   pandisplay() call has taken effect.  This wakes up the threads waiting
+ *   in FBIO_WAITFORVSYNC or poll().
+ *
+ * Input Parameters:
+ *   vtable - The framebuffer object passed to pandisplay()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_PANDISPLAY
+void fb_notify_vsync(FAR struct fb_vtable_s *vtable);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
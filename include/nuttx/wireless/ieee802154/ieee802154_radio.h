@@ -62,9 +62,14 @@
 
 struct ieee802154_txdesc_s
 {
-  /* Support a singly linked list of tx descriptors */
+  /* Support a singly linked list of tx descriptors.  The list of indirect
+   * transactions is doubly linked and transactions in that list are also
+   * chained in a hash table indexed by the destination address.
+   */
 
   FAR struct ieee802154_txdesc_s *flink;
+  FAR struct ieee802154_txdesc_s *blink; /* Only used for indirect transactions */
+  FAR struct ieee802154_txdesc_s *hlink; /* Only used for indirect transactions */
 
   /* Destination Address */
 
@@ -87,7 +92,11 @@ struct ieee802154_txdesc_s
   bool framepending;    /* Did the ACK have the frame pending bit set */
   uint32_t purgetime;   /* Time to purge transaction */
   uint8_t  retrycount;  /* Number of remaining retries. Set to macMaxFrameRetries
-                         * when txdescriptor is allocated
+                         * when txdescriptor is allocated.  With
+                         * CONFIG_MAC802154_SWRETRY, the MAC resends a frame
+                         * that was not ACKed until this reaches zero.  A
+                         * radio that retries in hardware should set this to
+                         * zero when it reports the final status.
                          */
 
   /* TODO: Add slotting information for GTS transactions */
@@ -294,6 +294,9 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   systime_t qtime;       /* Time work queued */
   systime_t delay;       /* Delay until work performed */
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+  uint8_t   prio;        /* Priority of low priority work */
+#endif
 };
 
 /****************************************************************************
@@ -421,45 +424,39 @@ int work_signal(int qid);
 #define work_available(work) ((work)->worker == NULL)
 
 /****************************************************************************
- * Name: lpwork_boostpriority
+ * Name: lpwork_queue
  *
  * Description:
- *   Called by the work queue client to assure that the priority of the low-
- *   priority worker thread is at least at the requested level, reqprio. This
- *   function would normally be called just before calling work_queue().
+ *   Queue work on the low priority work queue to be performed at the
+ *   requested priority.  The low priority work queue is kept sorted by
+ *   priority so that the work will be performed before any pending work of
+ *   lower priority; work of the same priority is performed in the order
+ *   that it was queued.  While the work is being performed, the worker
+ *   thread runs at (at least) the requested priority.  Work queued with
+ *   work_queue(LPWORK, ...) is performed at CONFIG_SCHED_LPWORKPRIORITY.
  *
- * Parameters:
- *   reqprio - Requested minimum worker thread priority
+ *   This is otherwise equivalent to work_queue(LPWORK, ...).
  *
- * Return Value:
- *   None
- *
- ****************************************************************************/
-
-#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
-void lpwork_boostpriority(uint8_t reqprio);
-#endif
-
-/****************************************************************************
- * Name: lpwork_restorepriority
- *
- * Description:
- *   This function is called to restore the priority after it was previously
- *   boosted.  This is often done by client logic on the worker thread when
- *   the scheduled work completes.  It will check if we need to drop the
- *   priority of the worker thread.
- *
- * Parameters:
- *   reqprio - Previously requested minimum worker thread priority to be
- *     "unboosted"
+ * Input parameters:
+ *   work    - The work structure to queue
+ *   worker  - The worker callback to be invoked.  The callback will invoked
+ *             on the worker thread of execution.
+ *   arg     - The argument that will be passed to the worker callback when
+ *             it is invoked.
+ *   delay   - Delay (in clock ticks) from the time queue until the worker
+ *             is invoked. Zero means to perform the work immediately.
+ *   reqprio - Requested priority of the work.  This is clipped to the range
+ *             CONFIG_SCHED_LPWORKPRIORITY through
+ *             CONFIG_SCHED_LPWORKPRIOMAX.
  *
- * Return Value:
- *   None
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
  *
  ****************************************************************************/
 
 #if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
-void lpwork_restorepriority(uint8_t reqprio);
+int lpwork_queue(FAR struct work_s *work, worker_t worker, FAR void *arg,
+                 systime_t delay, uint8_t reqprio);
 #endif
 
 #undef EXTERN
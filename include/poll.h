@@ -103,7 +103,17 @@ typedef unsigned int nfds_t;
 
 typedef uint8_t pollevent_t;
 
-/* This is the Nuttx variant of the standard pollfd structure. */
+/* This is the form of the function that is called by poll_notify() just
+ * before the semaphore is posted (see struct pollfd).
+ */
+
+struct pollfd;
+typedef CODE void (*pollcb_t)(FAR struct pollfd *fds);
+
+/* This is the Nuttx variant of the standard pollfd structure.  The cb and
+ * arg fields are for use by the OS (e.g., epoll) and are set to NULL by
+ * poll().
+ */
 
 struct pollfd
 {
@@ -112,6 +122,8 @@ struct pollfd
   pollevent_t events;   /* The input event flags */
   pollevent_t revents;  /* The output event flags */
   FAR void   *priv;     /* For use by drivers */
+  pollcb_t    cb;       /* Called by poll_notify() before posting sem */
+  FAR void   *arg;      /* For use by the callback */
 };
 
 /****************************************************************************
@@ -244,15 +244,17 @@ typedef pid_t pthread_t;
 typedef int pthread_condattr_t;
 #define __PTHREAD_CONDATTR_T_DEFINED 1
 
+struct pthread_mutex_s;
 struct pthread_cond_s
 {
   sem_t sem;
+  FAR struct pthread_mutex_s *mutex;  /* The mutex of the last waiter */
 };
 
 typedef struct pthread_cond_s pthread_cond_t;
 #define __PTHREAD_COND_T_DEFINED 1
 
-#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0)}
+#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), NULL}
 
 struct pthread_mutexattr_s
 {
@@ -339,11 +341,11 @@ typedef bool pthread_once_t;
 
 struct pthread_rwlock_s
 {
-    pthread_mutex_t lock;
-    pthread_cond_t  cv;
-    unsigned int num_readers;
-    unsigned int num_writers;
-    bool write_in_progress;
+    pthread_mutex_t lock;          /* Serializes blocked threads */
+    pthread_cond_t  cv;            /* Blocked threads wait here */
+    volatile unsigned int state;   /* Readers count plus writer/waiters bits */
+    unsigned int num_readers;      /* Number of blocked readers */
+    unsigned int num_writers;      /* Number of blocked writers */
 };
 
 typedef struct pthread_rwlock_s pthread_rwlock_t;
@@ -352,7 +354,7 @@ typedef int pthread_rwlockattr_t;
 
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
                                      PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+                                     0, 0, 0}
 
 #ifdef CONFIG_PTHREAD_CLEANUP
 /* This type describes the pthread cleanup callback (non-standard) */
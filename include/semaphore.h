@@ -66,19 +66,22 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 struct tcb_s; /* Forward reference */
+struct sem_s; /* Forward reference */
 struct semholder_s
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   struct semholder_s *flink;     /* Implements singly linked list */
 #endif
+  FAR struct semholder_s *tlink; /* Next semaphore held by the holder */
+  FAR struct sem_s *sem;         /* The semaphore that is held */
   FAR struct tcb_s *htcb;        /* Holder TCB */
   int16_t counts;                /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, 0}
 #else
-#  define SEMHOLDER_INITIALIZER {NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, 0}
 #endif
 #endif /* CONFIG_PRIORITY_INHERITANCE */
 
@@ -99,6 +102,7 @@ struct sem_s
 # else
   struct semholder_s holder[2];  /* Slot for old and new holder */
 # endif
+  FAR struct tcb_s *waiters;     /* Priority heap of waiting threads */
 #endif
 };
 
@@ -109,10 +113,10 @@ typedef struct sem_s sem_t;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
 #  define SEM_INITIALIZER(c) \
-    {(c), 0, NULL}               /* semcount, flags, hhead */
+    {(c), 0, NULL, NULL}         /* semcount, flags, hhead, waiters */
 # else
 #  define SEM_INITIALIZER(c) \
-    {(c), 0, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}} /* semcount, flags, holder[2] */
+    {(c), 0, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}, NULL} /* semcount, flags, holder[2], waiters */
 # endif
 #else
 #  define SEM_INITIALIZER(c) \
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * include/sys/iobatch.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IOBATCH_H
+#define __INCLUDE_SYS_IOBATCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_IOBATCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Operations (ib_opcode):
+ *
+ * IOBATCH_READ  - read(ib_fd, ib_buf, ib_nbytes)
+ * IOBATCH_WRITE - write(ib_fd, ib_buf, ib_nbytes)
+ * IOBATCH_SEND  - send(ib_fd, ib_buf, ib_nbytes, ib_arg)
+ * IOBATCH_RECV  - recv(ib_fd, ib_buf, ib_nbytes, ib_arg)
+ * IOBATCH_POLL  - poll((struct pollfd *)ib_buf, ib_nbytes, ib_arg).
+ *                 ib_fd is ignored.
+ */
+
+#define IOBATCH_READ       0
+#define IOBATCH_WRITE      1
+#define IOBATCH_SEND       2
+#define IOBATCH_RECV       3
+#define IOBATCH_POLL       4
+
+/* Operation flags (ib_flags):
+ *
+ * IOBATCH_FLAG_STOP - If this operation fails, the remaining operations of
+ *   the batch are not performed.
+ */
+
+#define IOBATCH_FLAG_STOP  (1 << 0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One operation of a batch.  The caller fills in all fields except
+ * ib_result, which receives the return value of the operation:  The
+ * non-negative value that the function would have returned, or a negated
+ * errno value on failure.
+ */
+
+struct iobatch_s
+{
+  uint8_t   ib_opcode;   /* See IOBATCH_* definitions */
+  uint8_t   ib_flags;    /* See IOBATCH_FLAG_* definitions */
+  int       ib_fd;       /* File or socket descriptor */
+  FAR void *ib_buf;      /* I/O buffer or array of struct pollfd */
+  size_t    ib_nbytes;   /* Buffer size or number of struct pollfd */
+  int       ib_arg;      /* send()/recv() flags or poll() timeout */
+  ssize_t   ib_result;   /* Returned:  Result of the operation */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: iobatch
+ *
+ * Description:
+ *   Perform the operations in 'ops' in order.  The result of each operation
+ *   is returned in its ib_result field.  A failed operation does not end
+ *   the batch unless its IOBATCH_FLAG_STOP flag is set.
+ *
+ * Input Parameters:
+ *   ops  - The array of operations
+ *   nops - The number of operations in the array
+ *
+ * Returned Value:
+ *   The number of operations that were performed.  -1 (ERROR) is returned
+ *   with errno set to EINVAL if the arguments are invalid.
+ *
+ ****************************************************************************/
+
+int iobatch(FAR struct iobatch_s *ops, int nops);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_IOBATCH */
+#endif /* __INCLUDE_SYS_IOBATCH_H */
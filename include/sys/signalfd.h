@@ -0,0 +1,107 @@
+/****************************************************************************
+ * include/sys/signalfd.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_SIGNALFD_H
+#define __INCLUDE_SYS_SIGNALFD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <signal.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags that may be passed to signalfd() */
+
+#define SFD_NONBLOCK   O_NONBLOCK
+#define SFD_CLOEXEC    (1 << 9)  /* Accepted for compatibility */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One signal as returned by read().  The layout (and the 128 byte size) is
+ * that of Linux.  Fields that have no NuttX equivalent are zero.
+ */
+
+struct signalfd_siginfo
+{
+  uint32_t ssi_signo;    /* Signal number */
+  int32_t  ssi_errno;    /* Error number (unused) */
+  int32_t  ssi_code;     /* Signal code */
+  uint32_t ssi_pid;      /* PID of the sender */
+  uint32_t ssi_uid;      /* Real UID of the sender (unused) */
+  int32_t  ssi_fd;       /* File descriptor (unused) */
+  uint32_t ssi_tid;      /* Timer ID (unused) */
+  uint32_t ssi_band;     /* Band event (unused) */
+  uint32_t ssi_overrun;  /* Timer overrun count (unused) */
+  uint32_t ssi_trapno;   /* Trap number (unused) */
+  int32_t  ssi_status;   /* Exit status (SIGCHLD) */
+  int32_t  ssi_int;      /* Integer sent with sigqueue() */
+  uint32_t ssi_ptr[2];   /* Pointer sent with sigqueue() */
+  uint32_t ssi_utime[2]; /* User CPU time consumed (unused) */
+  uint32_t ssi_stime[2]; /* System CPU time consumed (unused) */
+  uint32_t ssi_addr[2];  /* Fault address (unused) */
+  uint8_t  pad[48];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+int signalfd(int fd, FAR const sigset_t *mask, int flags);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_SYS_SIGNALFD_H */
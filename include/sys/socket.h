@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -109,6 +110,7 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): Block until one message is received */
 
 /* Socket options */
 
@@ -147,7 +149,8 @@
 
 /* Protocol levels supported by get/setsockopt(): */
 
-#define SOL_SOCKET     0  /* Only socket-level options supported */
+#define SOL_SOCKET     0  /* Socket-level options */
+#define SOL_PACKET     263 /* Packet socket options (see netpacket/packet.h) */
 
 /* Values for the 'how' argument of shutdown() */
 
@@ -199,6 +202,30 @@ struct linger
   int  l_linger;  /* Linger time, in seconds. */
 };
 
+/* Describes one message for sendmsg() and recvmsg().  The data of the
+ * message is gathered from (or scattered to) the array of msg_iovlen I/O
+ * vectors at msg_iov.  Ancillary data (msg_control) is not supported.
+ */
+
+struct msghdr
+{
+  FAR void *msg_name;          /* Optional socket address */
+  socklen_t msg_namelen;       /* Size of the socket address */
+  FAR struct iovec *msg_iov;   /* Scatter/gather array */
+  int msg_iovlen;              /* Number of elements in msg_iov */
+  FAR void *msg_control;       /* Ancillary data (ignored) */
+  socklen_t msg_controllen;    /* Size of the ancillary data */
+  int msg_flags;               /* Flags on the received message */
+};
+
+/* One element of the message vector passed to sendmmsg() and recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;       /* The message */
+  unsigned int msg_len;        /* Number of bytes transferred */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -227,6 +254,15 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
                  FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags);
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
+
+struct timespec;
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+
 int shutdown(int sockfd, int how);
 
 int setsockopt(int sockfd, int level, int option,
@@ -509,7 +509,15 @@
 #  define SYS_sendto                   (__SYS_network+8)
 #  define SYS_setsockopt               (__SYS_network+9)
 #  define SYS_socket                   (__SYS_network+10)
-#  define SYS_nnetsocket               (__SYS_network+11)
+#  ifdef CONFIG_NET_MMSG
+#    define SYS_recvmsg                (__SYS_network+11)
+#    define SYS_recvmmsg               (__SYS_network+12)
+#    define SYS_sendmsg                (__SYS_network+13)
+#    define SYS_sendmmsg               (__SYS_network+14)
+#    define SYS_nnetsocket             (__SYS_network+15)
+#  else
+#    define SYS_nnetsocket             (__SYS_network+11)
+#  endif
 #else
 #  define SYS_nnetsocket               __SYS_network
 #endif
@@ -527,9 +535,18 @@
 
 #ifdef CONFIG_CRYPTO_RANDOM_POOL
 #  define SYS_getrandom                (SYS_prctl+1)
-#  define SYS_maxsyscall               (SYS_prctl+2)
+#  define __SYS_iobatch                (SYS_prctl+2)
+#else
+#  define __SYS_iobatch                SYS_prctl
+#endif
+
+/* The following is defined only if batched I/O submission is enabled */
+
+#ifdef CONFIG_FS_IOBATCH
+#  define SYS_iobatch                  __SYS_iobatch
+#  define SYS_maxsyscall               (__SYS_iobatch+1)
 #else
-#  define SYS_maxsyscall               SYS_prctl
+#  define SYS_maxsyscall               __SYS_iobatch
 #endif
 
 /* Note that the reported number of system calls does *NOT* include the
@@ -0,0 +1,246 @@
+/****************************************************************************
+ * libc/dsp/lib_dsp.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_DSP_LIB_DSP_H
+#define __LIBC_DSP_LIB_DSP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <dsp.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error The DSP library requires 64-bit integer support
+#endif
+
+/* The ARMv7E-M (Cortex-M4/M7) and ARMv8-M Mainline DSP extension provides
+ * dual 16-bit multiply-accumulate and saturating SIMD instructions.  The
+ * C fallbacks below compute the same results on other architectures.
+ */
+
+#if defined(__ARM_FEATURE_DSP) && defined(CONFIG_ARCH_TOOLCHAIN_GNU)
+#  define DSP_HAVE_SIMD 1
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_pack2
+ *
+ * Description:
+ *   Load two adjacent Q15 samples as one 32-bit word, p[0] in the lower
+ *   half.  No alignment is required; the compiler merges the two loads
+ *   where the architecture permits unaligned word access.
+ *
+ ****************************************************************************/
+
+static inline uint32_t dsp_pack2(FAR const q15_t *p)
+{
+  return (uint32_t)(uint16_t)p[0] | ((uint32_t)(uint16_t)p[1] << 16);
+}
+
+static inline void dsp_unpack2(FAR q15_t *p, uint32_t w)
+{
+  p[0] = (q15_t)(w & 0xffff);
+  p[1] = (q15_t)(w >> 16);
+}
+
+/****************************************************************************
+ * Name: dsp_sat16
+ *
+ * Description:
+ *   Saturate a 32-bit value to the Q15 range.
+ *
+ ****************************************************************************/
+
+static inline q15_t dsp_sat16(int32_t x)
+{
+#ifdef DSP_HAVE_SIMD
+  __asm__ ("ssat %0, #16, %1" : "=r" (x) : "r" (x));
+  return (q15_t)x;
+#else
+  if (x > q15MAX)
+    {
+      return q15MAX;
+    }
+  else if (x < q15MIN)
+    {
+      return q15MIN;
+    }
+
+  return (q15_t)x;
+#endif
+}
+
+/****************************************************************************
+ * Name: dsp_qadd16 and dsp_qsub16
+ *
+ * Description:
+ *   Saturating add/subtract of two pairs of Q15 values.
+ *
+ ****************************************************************************/
+
+static inline uint32_t dsp_qadd16(uint32_t x, uint32_t y)
+{
+#ifdef DSP_HAVE_SIMD
+  uint32_t result;
+  __asm__ ("qadd16 %0, %1, %2" : "=r" (result) : "r" (x), "r" (y));
+  return result;
+#else
+  q15_t lo = dsp_sat16((int32_t)(int16_t)x + (int16_t)y);
+  q15_t hi = dsp_sat16((int32_t)(int16_t)(x >> 16) + (int16_t)(y >> 16));
+  return (uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+#endif
+}
+
+static inline uint32_t dsp_qsub16(uint32_t x, uint32_t y)
+{
+#ifdef DSP_HAVE_SIMD
+  uint32_t result;
+  __asm__ ("qsub16 %0, %1, %2" : "=r" (result) : "r" (x), "r" (y));
+  return result;
+#else
+  q15_t lo = dsp_sat16((int32_t)(int16_t)x - (int16_t)y);
+  q15_t hi = dsp_sat16((int32_t)(int16_t)(x >> 16) - (int16_t)(y >> 16));
+  return (uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+#endif
+}
+
+/****************************************************************************
+ * Name: dsp_smlald and dsp_smlaldx
+ *
+ * Description:
+ *   Dual 16 x 16 multiply with 64-bit accumulate:
+ *
+ *     smlald:  acc + x.lo * y.lo + x.hi * y.hi
+ *     smlaldx: acc + x.lo * y.hi + x.hi * y.lo
+ *
+ ****************************************************************************/
+
+static inline int64_t dsp_smlald(uint32_t x, uint32_t y, int64_t acc)
+{
+#ifdef DSP_HAVE_SIMD
+  __asm__ ("smlald %Q0, %R0, %1, %2" : "+r" (acc) : "r" (x), "r" (y));
+  return acc;
+#else
+  return acc + (int32_t)(int16_t)x * (int16_t)y +
+         (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+#endif
+}
+
+static inline int64_t dsp_smlaldx(uint32_t x, uint32_t y, int64_t acc)
+{
+#ifdef DSP_HAVE_SIMD
+  __asm__ ("smlaldx %Q0, %R0, %1, %2" : "+r" (acc) : "r" (x), "r" (y));
+  return acc;
+#else
+  return acc + (int32_t)(int16_t)x * (int16_t)(y >> 16) +
+         (int32_t)(int16_t)(x >> 16) * (int16_t)y;
+#endif
+}
+
+/****************************************************************************
+ * Name: dsp_round_q15
+ *
+ * Description:
+ *   Round a wide accumulator to Q15, discarding shift fractional bits,
+ *   and saturate the result.
+ *
+ ****************************************************************************/
+
+static inline q15_t dsp_round_q15(int64_t acc, int shift)
+{
+  acc = (acc + ((int64_t)1 << (shift - 1))) >> shift;
+
+  if (acc > q15MAX)
+    {
+      return q15MAX;
+    }
+  else if (acc < q15MIN)
+    {
+      return q15MIN;
+    }
+
+  return (q15_t)acc;
+}
+
+/****************************************************************************
+ * Name: dsp_dot_q15
+ *
+ * Description:
+ *   Dot product of the sample run x[0..ntaps-1] with the coefficients h[]
+ *   taken in reverse order, i.e. sum(h[k] * x[ntaps - 1 - k]).  This is
+ *   the FIR kernel; the result is Q30.
+ *
+ ****************************************************************************/
+
+static inline int64_t dsp_dot_q15(FAR const q15_t *x, FAR const q15_t *h,
+                                  uint16_t ntaps)
+{
+  FAR const q15_t *hp = h + ntaps;
+  int64_t acc = 0;
+  uint16_t i;
+
+  /* x[i], x[i+1] pair with h[ntaps-1-i], h[ntaps-2-i]: the coefficient
+   * pair loaded from h[ntaps-2-i] is swapped relative to the samples,
+   * which is exactly what the exchanging multiply handles.
+   */
+
+  for (i = 0; i + 1 < ntaps; i += 2)
+    {
+      hp -= 2;
+      acc = dsp_smlaldx(dsp_pack2(&x[i]), dsp_pack2(hp), acc);
+    }
+
+  if (i < ntaps)
+    {
+      acc += (int32_t)x[i] * h[0];
+    }
+
+  return acc;
+}
+
+#endif /* __LIBC_DSP_LIB_DSP_H */
@@ -0,0 +1,202 @@
+/****************************************************************************
+ * libc/dsp/lib_dspbiquad.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_biquad_init_q15
+ *
+ * Description:
+ *   Initialize a Q15 biquad cascade and clear its state.
+ *
+ * Input Parameters:
+ *   iir     - The filter instance to initialize
+ *   coeffs  - { b0, b1, b2, a1, a2 } for each stage, Q14
+ *   state   - Buffer of 4 * nstages samples
+ *   nstages - Number of second order sections
+ *
+ ****************************************************************************/
+
+void dsp_biquad_init_q15(FAR struct dsp_biquad_q15_s *iir,
+                         FAR const q15_t *coeffs, FAR q15_t *state,
+                         uint8_t nstages)
+{
+  DEBUGASSERT(iir != NULL && coeffs != NULL && state != NULL);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+
+  memset(state, 0, 4 * nstages * sizeof(q15_t));
+}
+
+/****************************************************************************
+ * Name: dsp_biquad_q15
+ *
+ * Description:
+ *   Filter n samples through the cascade, direct form I.  Each stage
+ *   accumulates in 64 bits, using dual multiply-accumulates for the tap
+ *   pairs, then rounds and saturates its output to Q15.  in and out may
+ *   be the same buffer.
+ *
+ ****************************************************************************/
+
+void dsp_biquad_q15(FAR struct dsp_biquad_q15_s *iir, FAR const q15_t *in,
+                    FAR q15_t *out, size_t n)
+{
+  FAR const q15_t *c = iir->coeffs;
+  FAR q15_t *s       = iir->state;
+  FAR const q15_t *src = in;
+  uint8_t stage;
+  size_t i;
+
+  for (stage = 0; stage < iir->nstages; stage++, c += 5, s += 4)
+    {
+      /* State word layout: { x[n-1], x[n-2] } and { y[n-1], y[n-2] } */
+
+      int32_t b0    = c[0];
+      uint32_t b12  = dsp_pack2(&c[1]);
+      uint32_t a12  = dsp_pack2(&c[3]);
+      uint32_t xs   = dsp_pack2(&s[0]);
+      uint32_t ys   = dsp_pack2(&s[2]);
+
+      for (i = 0; i < n; i++)
+        {
+          int32_t x = src[i];
+          int64_t acc;
+          q15_t y;
+
+          acc  = dsp_smlald(b12, xs, b0 * x);
+          acc -= dsp_smlald(a12, ys, 0);
+
+          /* Q14 coefficients * Q15 samples = Q29 */
+
+          y = dsp_round_q15(acc, 14);
+
+          xs = (xs << 16) | (uint16_t)x;
+          ys = (ys << 16) | (uint16_t)y;
+
+          out[i] = y;
+        }
+
+      dsp_unpack2(&s[0], xs);
+      dsp_unpack2(&s[2], ys);
+
+      /* Later stages filter the output of the previous stage in place */
+
+      src = out;
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_biquad_init_f32
+ *
+ * Description:
+ *   Initialize a single precision biquad cascade and clear its state.
+ *   coeffs is as for dsp_biquad_init_q15(); state is 2 * nstages floats.
+ *
+ ****************************************************************************/
+
+void dsp_biquad_init_f32(FAR struct dsp_biquad_f32_s *iir,
+                         FAR const float *coeffs, FAR float *state,
+                         uint8_t nstages)
+{
+  DEBUGASSERT(iir != NULL && coeffs != NULL && state != NULL);
+
+  iir->coeffs  = coeffs;
+  iir->state   = state;
+  iir->nstages = nstages;
+
+  memset(state, 0, 2 * nstages * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: dsp_biquad_f32
+ *
+ * Description:
+ *   Filter n samples through the cascade, transposed direct form II.
+ *   in and out may be the same buffer.
+ *
+ ****************************************************************************/
+
+void dsp_biquad_f32(FAR struct dsp_biquad_f32_s *iir, FAR const float *in,
+                    FAR float *out, size_t n)
+{
+  FAR const float *c   = iir->coeffs;
+  FAR float *s         = iir->state;
+  FAR const float *src = in;
+  uint8_t stage;
+  size_t i;
+
+  for (stage = 0; stage < iir->nstages; stage++, c += 5, s += 2)
+    {
+      float b0 = c[0];
+      float b1 = c[1];
+      float b2 = c[2];
+      float a1 = c[3];
+      float a2 = c[4];
+      float d1 = s[0];
+      float d2 = s[1];
+
+      for (i = 0; i < n; i++)
+        {
+          float x = src[i];
+          float y = b0 * x + d1;
+
+          d1 = b1 * x - a1 * y + d2;
+          d2 = b2 * x - a2 * y;
+
+          out[i] = y;
+        }
+
+      s[0] = d1;
+      s[1] = d2;
+      src  = out;
+    }
+}
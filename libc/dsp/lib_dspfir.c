@@ -0,0 +1,198 @@
+/****************************************************************************
+ * libc/dsp/lib_dspfir.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_fir_init_q15
+ *
+ * Description:
+ *   Initialize a Q15 FIR filter instance and clear its history.
+ *
+ * Input Parameters:
+ *   fir       - The filter instance to initialize
+ *   coeffs    - ntaps Q15 coefficients, h[0] first
+ *   state     - Buffer of ntaps + blocksize - 1 samples
+ *   ntaps     - Number of filter taps
+ *   blocksize - Largest number of samples processed in one pass
+ *
+ ****************************************************************************/
+
+void dsp_fir_init_q15(FAR struct dsp_fir_q15_s *fir,
+                      FAR const q15_t *coeffs, FAR q15_t *state,
+                      uint16_t ntaps, uint16_t blocksize)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0 && blocksize > 0);
+
+  fir->coeffs    = coeffs;
+  fir->state     = state;
+  fir->ntaps     = ntaps;
+  fir->blocksize = blocksize;
+
+  memset(state, 0, (ntaps + blocksize - 1) * sizeof(q15_t));
+}
+
+/****************************************************************************
+ * Name: dsp_fir_q15
+ *
+ * Description:
+ *   Filter n samples.  Outputs are rounded and saturated to Q15.  in and
+ *   out may be the same buffer.
+ *
+ ****************************************************************************/
+
+void dsp_fir_q15(FAR struct dsp_fir_q15_s *fir, FAR const q15_t *in,
+                 FAR q15_t *out, size_t n)
+{
+  FAR q15_t *state = fir->state;
+  uint16_t ntaps   = fir->ntaps;
+  size_t nblock;
+  size_t i;
+
+  while (n > 0)
+    {
+      nblock = n < fir->blocksize ? n : fir->blocksize;
+
+      /* Append the new samples after the ntaps - 1 samples of history */
+
+      memcpy(&state[ntaps - 1], in, nblock * sizeof(q15_t));
+
+      for (i = 0; i < nblock; i++)
+        {
+          out[i] = dsp_round_q15(dsp_dot_q15(&state[i], fir->coeffs,
+                                             ntaps), 15);
+        }
+
+      /* Keep the last ntaps - 1 samples for the next pass */
+
+      memmove(state, &state[nblock], (ntaps - 1) * sizeof(q15_t));
+
+      in  += nblock;
+      out += nblock;
+      n   -= nblock;
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_fir_init_f32
+ *
+ * Description:
+ *   Initialize a single precision FIR filter instance and clear its
+ *   history.  The parameters are as for dsp_fir_init_q15().
+ *
+ ****************************************************************************/
+
+void dsp_fir_init_f32(FAR struct dsp_fir_f32_s *fir,
+                      FAR const float *coeffs, FAR float *state,
+                      uint16_t ntaps, uint16_t blocksize)
+{
+  DEBUGASSERT(fir != NULL && coeffs != NULL && state != NULL);
+  DEBUGASSERT(ntaps > 0 && blocksize > 0);
+
+  fir->coeffs    = coeffs;
+  fir->state     = state;
+  fir->ntaps     = ntaps;
+  fir->blocksize = blocksize;
+
+  memset(state, 0, (ntaps + blocksize - 1) * sizeof(float));
+}
+
+/****************************************************************************
+ * Name: dsp_fir_f32
+ *
+ * Description:
+ *   Filter n samples.  in and out may be the same buffer.
+ *
+ ****************************************************************************/
+
+void dsp_fir_f32(FAR struct dsp_fir_f32_s *fir, FAR const float *in,
+                 FAR float *out, size_t n)
+{
+  FAR const float *h = fir->coeffs;
+  FAR float *state   = fir->state;
+  uint16_t ntaps     = fir->ntaps;
+  size_t nblock;
+  size_t i;
+  uint16_t k;
+
+  while (n > 0)
+    {
+      nblock = n < fir->blocksize ? n : fir->blocksize;
+      memcpy(&state[ntaps - 1], in, nblock * sizeof(float));
+
+      for (i = 0; i < nblock; i++)
+        {
+          FAR const float *x = &state[i + ntaps - 1];
+          float acc0 = 0.0F;
+          float acc1 = 0.0F;
+
+          /* Two accumulators hide the multiply-accumulate latency */
+
+          for (k = 0; k + 1 < ntaps; k += 2)
+            {
+              acc0 += h[k] * x[-(int)k];
+              acc1 += h[k + 1] * x[-(int)k - 1];
+            }
+
+          if (k < ntaps)
+            {
+              acc0 += h[k] * x[-(int)k];
+            }
+
+          out[i] = acc0 + acc1;
+        }
+
+      memmove(state, &state[nblock], (ntaps - 1) * sizeof(float));
+
+      in  += nblock;
+      out += nblock;
+      n   -= nblock;
+    }
+}
@@ -0,0 +1,226 @@
+/****************************************************************************
+ * libc/dsp/lib_dsprfft.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <assert.h>
+#include <errno.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_cfft_f32
+ *
+ * Description:
+ *   In place, radix-2 decimation in time complex FFT of m points.  tw
+ *   holds exp(-2*pi*i*k/(2*m)) for k = 0 .. m-1, so the length m twiddle
+ *   for index j is tw[2 * j].
+ *
+ ****************************************************************************/
+
+static void dsp_cfft_f32(FAR float *z, FAR const float *tw, uint16_t m)
+{
+  uint16_t len;
+  uint16_t i;
+  uint16_t j;
+
+  /* Bit reversal permutation */
+
+  for (i = 1, j = 0; i < m; i++)
+    {
+      uint16_t bit = m >> 1;
+
+      for (; (j & bit) != 0; bit >>= 1)
+        {
+          j ^= bit;
+        }
+
+      j |= bit;
+
+      if (i < j)
+        {
+          float tr = z[2 * i];
+          float ti = z[2 * i + 1];
+
+          z[2 * i]     = z[2 * j];
+          z[2 * i + 1] = z[2 * j + 1];
+          z[2 * j]     = tr;
+          z[2 * j + 1] = ti;
+        }
+    }
+
+  /* Butterfly passes.  The twiddle factor is the same for every butterfly
+   * at the same offset j within a group, so loop over j outermost.
+   */
+
+  for (len = 2; len <= m; len <<= 1)
+    {
+      uint16_t half  = len >> 1;
+      uint16_t tstep = 2 * (m / len);
+
+      for (j = 0; j < half; j++)
+        {
+          float wr = tw[2 * j * tstep];
+          float wi = tw[2 * j * tstep + 1];
+
+          for (i = j; i < m; i += len)
+            {
+              FAR float *a = &z[2 * i];
+              FAR float *b = &z[2 * (i + half)];
+              float tr = wr * b[0] - wi * b[1];
+              float ti = wr * b[1] + wi * b[0];
+
+              b[0]  = a[0] - tr;
+              b[1]  = a[1] - ti;
+              a[0] += tr;
+              a[1] += ti;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_rfft_init_f32
+ *
+ * Description:
+ *   Initialize a real FFT instance of length n.
+ *
+ * Input Parameters:
+ *   fft     - The instance to initialize
+ *   twiddle - Buffer of n floats for the twiddle factors
+ *   n       - Transform length; a power of two, at least 4
+ *
+ * Returned Value:
+ *   Zero on success or -EINVAL if n is not supported.
+ *
+ ****************************************************************************/
+
+int dsp_rfft_init_f32(FAR struct dsp_rfft_f32_s *fft, FAR float *twiddle,
+                      uint16_t n)
+{
+  uint16_t k;
+
+  DEBUGASSERT(fft != NULL && twiddle != NULL);
+
+  if (n < 4 || (n & (n - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (k = 0; k < n / 2; k++)
+    {
+      double phase = -2.0 * M_PI * k / n;
+
+      twiddle[2 * k]     = (float)cos(phase);
+      twiddle[2 * k + 1] = (float)sin(phase);
+    }
+
+  fft->twiddle = twiddle;
+  fft->n       = n;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dsp_rfft_f32
+ *
+ * Description:
+ *   In place forward FFT of n real samples.  The result is the n/2 + 1
+ *   non-redundant bins packed into the same n floats:
+ *
+ *     buf[0]          X[0] (real)
+ *     buf[1]          X[n/2] (real)
+ *     buf[2k, 2k+1]   X[k] real and imaginary parts, 0 < k < n/2
+ *
+ *   The n real samples are transformed as n/2 complex points, after which
+ *   the even and odd halves are separated.  This is about twice as fast
+ *   as a complex FFT of the zero padded input.
+ *
+ ****************************************************************************/
+
+void dsp_rfft_f32(FAR const struct dsp_rfft_f32_s *fft, FAR float *buf)
+{
+  FAR const float *tw = fft->twiddle;
+  uint16_t m = fft->n >> 1;
+  uint16_t k;
+  float r0;
+  float i0;
+
+  dsp_cfft_f32(buf, tw, m);
+
+  r0     = buf[0];
+  i0     = buf[1];
+  buf[0] = r0 + i0;
+  buf[1] = r0 - i0;
+
+  /* X[k]   = E + W^k * O
+   * X[m-k] = conj(E - W^k * O)
+   *
+   * where E = (Z[k] + conj(Z[m-k])) / 2
+ *   and O = -i * (Z[k] - conj(Z[m-k])) / 2
+   */
+
+  for (k = 1; k <= m / 2; k++)
+    {
+      FAR float *a = &buf[2 * k];
+      FAR float *b = &buf[2 * (m - k)];
+      float wr = tw[2 * k];
+      float wi = tw[2 * k + 1];
+      float er = 0.5F * (a[0] + b[0]);
+      float ei = 0.5F * (a[1] - b[1]);
+      float odr = 0.5F * (a[1] + b[1]);
+      float odi = -0.5F * (a[0] - b[0]);
+      float tr = wr * odr - wi * odi;
+      float ti = wr * odi + wi * odr;
+
+      a[0] = er + tr;
+      a[1] = ei + ti;
+      b[0] = er - tr;
+      b[1] = ti - ei;
+    }
+}
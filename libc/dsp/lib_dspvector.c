@@ -0,0 +1,238 @@
+/****************************************************************************
+ * libc/dsp/lib_dspvector.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <dsp.h>
+
+#include "dsp/lib_dsp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dsp_vadd_q15
+ *
+ * Description:
+ *   out[i] = sat(a[i] + b[i])
+ *
+ ****************************************************************************/
+
+void dsp_vadd_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *out,
+                  size_t n)
+{
+  for (; n >= 2; n -= 2, a += 2, b += 2, out += 2)
+    {
+      dsp_unpack2(out, dsp_qadd16(dsp_pack2(a), dsp_pack2(b)));
+    }
+
+  if (n > 0)
+    {
+      *out = dsp_sat16((int32_t)*a + *b);
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_vsub_q15
+ *
+ * Description:
+ *   out[i] = sat(a[i] - b[i])
+ *
+ ****************************************************************************/
+
+void dsp_vsub_q15(FAR const q15_t *a, FAR const q15_t *b, FAR q15_t *out,
+                  size_t n)
+{
+  for (; n >= 2; n -= 2, a += 2, b += 2, out += 2)
+    {
+      dsp_unpack2(out, dsp_qsub16(dsp_pack2(a), dsp_pack2(b)));
+    }
+
+  if (n > 0)
+    {
+      *out = dsp_sat16((int32_t)*a - *b);
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_vscale_q15
+ *
+ * Description:
+ *   out[i] = sat(in[i] * scale), rounded
+ *
+ ****************************************************************************/
+
+void dsp_vscale_q15(FAR const q15_t *in, q15_t scale, FAR q15_t *out,
+                    size_t n)
+{
+  for (; n > 0; n--)
+    {
+      *out++ = dsp_sat16(((int32_t)*in++ * scale + 0x4000) >> 15);
+    }
+}
+
+/****************************************************************************
+ * Name: dsp_vdot_q15
+ *
+ * Description:
+ *   Return sum(a[i] * b[i]) as a Q30 value in a 64-bit accumulator, so
+ *   that no intermediate overflow is possible.
+ *
+ ****************************************************************************/
+
+int64_t dsp_vdot_q15(FAR const q15_t *a, FAR const q15_t *b, size_t n)
+{
+  int64_t acc = 0;
+
+  for (; n >= 2; n -= 2, a += 2, b += 2)
+    {
+      acc = dsp_smlald(dsp_pack2(a), dsp_pack2(b), acc);
+    }
+
+  if (n > 0)
+    {
+      acc += (int32_t)*a * *b;
+    }
+
+  return acc;
+}
+
+/****************************************************************************
+ * Name: dsp_vadd_f32, dsp_vsub_f32, dsp_vscale_f32, dsp_vdot_f32
+ *
+ * Description:
+ *   Single precision versions of the above.  The loops are unrolled by
+ *   four so that the FPU pipeline is kept busy.
+ *
+ ****************************************************************************/
+
+void dsp_vadd_f32(FAR const float *a, FAR const float *b, FAR float *out,
+                  size_t n)
+{
+  for (; n >= 4; n -= 4, a += 4, b += 4, out += 4)
+    {
+      out[0] = a[0] + b[0];
+      out[1] = a[1] + b[1];
+      out[2] = a[2] + b[2];
+      out[3] = a[3] + b[3];
+    }
+
+  for (; n > 0; n--)
+    {
+      *out++ = *a++ + *b++;
+    }
+}
+
+void dsp_vsub_f32(FAR const float *a, FAR const float *b, FAR float *out,
+                  size_t n)
+{
+  for (; n >= 4; n -= 4, a += 4, b += 4, out += 4)
+    {
+      out[0] = a[0] - b[0];
+      out[1] = a[1] - b[1];
+      out[2] = a[2] - b[2];
+      out[3] = a[3] - b[3];
+    }
+
+  for (; n > 0; n--)
+    {
+      *out++ = *a++ - *b++;
+    }
+}
+
+void dsp_vscale_f32(FAR const float *in, float scale, FAR float *out,
+                    size_t n)
+{
+  for (; n >= 4; n -= 4, in += 4, out += 4)
+    {
+      out[0] = in[0] * scale;
+      out[1] = in[1] * scale;
+      out[2] = in[2] * scale;
+      out[3] = in[3] * scale;
+    }
+
+  for (; n > 0; n--)
+    {
+      *out++ = *in++ * scale;
+    }
+}
+
+float dsp_vdot_f32(FAR const float *a, FAR const float *b, size_t n)
+{
+  float acc0 = 0.0F;
+  float acc1 = 0.0F;
+  float acc2 = 0.0F;
+  float acc3 = 0.0F;
+
+  /* Four independent accumulators hide the multiply-accumulate latency */
+
+  for (; n >= 4; n -= 4, a += 4, b += 4)
+    {
+      acc0 += a[0] * b[0];
+      acc1 += a[1] * b[1];
+      acc2 += a[2] * b[2];
+      acc3 += a[3] * b[3];
+    }
+
+  for (; n > 0; n--)
+    {
+      acc0 += *a++ * *b++;
+    }
+
+  return (acc0 + acc1) + (acc2 + acc3);
+}
+
+/****************************************************************************
+ * Name: dsp_cmag_f32
+ *
+ * Description:
+ *   Magnitude of n complex values stored as interleaved re/im pairs:
+ *   out[i] = sqrt(in[2i]^2 + in[2i+1]^2)
+ *
+ ****************************************************************************/
+
+void dsp_cmag_f32(FAR const float *in, FAR float *out, size_t n)
+{
+  for (; n > 0; n--, in += 2)
+    {
+      *out++ = sqrtf(in[0] * in[0] + in[1] * in[1]);
+    }
+}
@@ -156,6 +156,12 @@ char *__dtoa(double d, int mode, int ndigits, int *decpt, int *sign,
              char **rve);
 #endif
 
+/* Defined in lib_libstrtod.c */
+
+#if defined(CONFIG_HAVE_DOUBLE) && defined(CONFIG_HAVE_LONG_LONG)
+double lib_strtofp(FAR const char *str, FAR char **endptr, bool single);
+#endif
+
 /* Defined in lib_fopen.c */
 
 int lib_mode2oflags(FAR const char *mode);
@@ -191,6 +197,7 @@ int lib_wrflush(FAR FILE *stream);
 void lib_sem_initialize(FAR struct file_struct *stream);
 void lib_take_semaphore(FAR struct file_struct *stream);
 void lib_give_semaphore(FAR struct file_struct *stream);
+int  lib_trytake_semaphore(FAR struct file_struct *stream);
 #endif
 
 /* Defined in lib_libgetbase.c */
@@ -222,6 +229,12 @@ double lib_expi(size_t n);
 float lib_sqrtapprox(float x);
 #endif
 
+/* Defined in lib_libsincosf.c */
+
+#ifdef CONFIG_LIBM
+float lib_sincosf(float x, int cosine);
+#endif
+
 /* Defined in lib_parsehostfile.c */
 
 #ifdef CONFIG_NETDB_HOSTFILE
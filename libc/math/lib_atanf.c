@@ -29,9 +29,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdbool.h>
 #include <math.h>
-#include <stddef.h>
-#include <stdint.h>
 
 /****************************************************************************
  * Public Functions
@@ -39,5 +40,43 @@
 
 float atanf(float x)
 {
-  return asinf(x / sqrtf(x * x + 1.0F));
+  float y;
+  float z;
+  bool negate;
+
+  if (isnan(x))
+    {
+      return x;
+    }
+
+  negate = (x < 0.0F);
+  if (negate)
+    {
+      x = -x;
+    }
+
+  /* Reduce the argument to |x| <= tan(pi/8) */
+
+  if (x > 2.414213562373095F)          /* tan(3*pi/8) */
+    {
+      y = M_PI_2_F;
+      x = -1.0F / x;
+    }
+  else if (x > 0.4142135623730950F)    /* tan(pi/8) */
+    {
+      y = (float)M_PI_4;
+      x = (x - 1.0F) / (x + 1.0F);
+    }
+  else
+    {
+      y = 0.0F;
+    }
+
+  /* Minimax polynomial for atan(x) */
+
+  z = x * x;
+  y += (((8.05374449538e-2F * z - 1.38776856032e-1F) * z +
+         1.99777106478e-1F) * z - 3.33329491539e-1F) * z * x + x;
+
+  return negate ? -y : y;
 }
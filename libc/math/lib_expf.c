@@ -29,29 +29,50 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
 
 #include "libc.h"
 
 /****************************************************************************
- * Private Data
+ * Pre-processor Definitions
  ****************************************************************************/
 
-static float _flt_inv_fact[] =
+/* ln(2) split into two parts (Cody & Waite) */
+
+#define C1          0.693359375F
+#define C2          -2.12194440e-4F
+
+/* Range of the argument giving a finite, non-zero result */
+
+#define MAXLOGF     88.72283905206835F
+#define MINLOGF     -103.278929903431851103F
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: exp2if
+ *
+ * Description:
+ *   Return 2^n for -126 <= n <= 127 by building the float directly.
+ *
+ ****************************************************************************/
+
+static inline float exp2if(int n)
 {
-  1.0 / 1.0,                    /* 1/0! */
-  1.0 / 1.0,                    /* 1/1! */
-  1.0 / 2.0,                    /* 1/2! */
-  1.0 / 6.0,                    /* 1/3! */
-  1.0 / 24.0,                   /* 1/4! */
-  1.0 / 120.0,                  /* 1/5! */
-  1.0 / 720.0,                  /* 1/6! */
-  1.0 / 5040.0,                 /* 1/7! */
-  1.0 / 40320.0,                /* 1/8! */
-  1.0 / 362880.0,               /* 1/9! */
-  1.0 / 3628800.0,              /* 1/10! */
-};
+  union
+  {
+    float    f;
+    uint32_t u;
+  } v;
+
+  v.u = (uint32_t)(n + 127) << 23;
+  return v.f;
+}
 
 /****************************************************************************
  * Public Functions
@@ -59,54 +80,52 @@ static float _flt_inv_fact[] =
 
 float expf(float x)
 {
-  size_t int_part;
-  bool invert;
-  float value;
-  float x0;
-  size_t i;
+  float k;
+  float z;
+  int n;
 
-  if (x == 0)
+  if (isnan(x))
     {
-      return 1;
+      return x;
     }
-  else if (x < 0)
+
+  if (x > MAXLOGF)
     {
-      invert = true;
-      x = -x;
+      return INFINITY_F;
     }
-  else
+
+  if (x < MINLOGF)
     {
-      invert = false;
+      return 0.0F;
     }
 
-  /* Extract integer component */
+  /* Express e^x = 2^n * e^r, n = round(x / ln(2)), |r| <= ln(2) / 2 */
 
-  int_part = (size_t) x;
+  k = x * (float)M_LOG2E;
+  n = (int)(k >= 0.0F ? k + 0.5F : k - 0.5F);
+  k = (float)n;
 
-  /* set x to fractional component */
+  x = (x - k * C1) - k * C2;
 
-  x -= (float)int_part;
+  /* Minimax polynomial for e^r */
 
-  /* Perform Taylor series approximation with eleven terms */
+  z = x * x;
+  z = (((((1.9875691500e-4F * x + 1.3981999507e-3F) * x +
+          8.3334519073e-3F) * x + 4.1665795894e-2F) * x +
+          1.6666665459e-1F) * x + 5.0000001201e-1F) * z + x + 1.0F;
 
-  value = 0.0F;
-  x0 = 1.0F;
-  for (i = 0; i < 10; i++)
-    {
-      value += x0 * _flt_inv_fact[i];
-      x0 *= x;
-    }
-
-  /* Multiply by exp of the integer component */
+  /* Scale by 2^n.  Results below FLT_MIN (n < -126) are subnormal and the
+   * scaling must be done in two steps.
+   */
 
-  value *= lib_expif(int_part);
-
-  if (invert)
+  if (n < -126)
     {
-      return (1.0F / value);
+      return z * exp2if(n + 64) * exp2if(-64);
     }
-  else
+  else if (n > 127)
     {
-      return value;
+      return z * exp2if(n - 1) * 2.0F;
     }
+
+  return z * exp2if(n);
 }
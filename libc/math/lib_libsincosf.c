@@ -0,0 +1,158 @@
+/****************************************************************************
+ * libc/math/lib_libsincosf.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * The minimax polynomial approximations are from the Cephes Math Library:
+ *
+ *   Copyright 1984, 1985, 1987, 1989, 2000 by Stephen L. Moshier
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 split into three parts (Cody & Waite).  The first two have only a
+ * few significant bits so that k * DP1 and k * DP2 are exact for the
+ * values of k used with the single precision reduction.
+ */
+
+#define DP1         1.5703125F
+#define DP2         4.837512969970703125e-4F
+#define DP3         7.54978995489188216e-8F
+
+/* pi/2 split into two double precision parts.  The first has 33 bits so
+ * that k * PIO2_1 is exact for |k| < 2^20.
+ */
+
+#define PIO2_1      1.57079632673412561417e+00
+#define PIO2_1T     6.07710050650619224932e-11
+
+/* Above this magnitude, the single precision reduction loses accuracy and
+ * the (slower) double precision reduction is used.
+ */
+
+#define REDUCE_MAX  8192.0F
+#define REDUCE_MAXD 1.0e6
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_sincosf
+ *
+ * Description:
+ *   Common kernel of sinf() and cosf().  The argument is reduced to
+ *   r = x - k * pi/2 with |r| <= pi/4 and the sine or cosine of r is
+ *   evaluated with a minimax polynomial.  Since cos(x) = sin(x + pi/2),
+ *   the cosine just selects the next quadrant.
+ *
+ * Input Parameters:
+ *   x      - The argument in radians
+ *   cosine - Zero to return sin(x), one to return cos(x)
+ *
+ ****************************************************************************/
+
+float lib_sincosf(float x, int cosine)
+{
+  float r;
+  float z;
+  float y;
+  int quadrant;
+
+  if (isnan(x) || isinf_f(x))
+    {
+      return NAN_F;
+    }
+
+  /* Reduce the argument */
+
+  if (fabsf(x) <= REDUCE_MAX)
+    {
+      float k = x * (float)M_2_PI;
+
+      k = (float)(int)(k >= 0.0F ? k + 0.5F : k - 0.5F);
+      r = ((x - k * DP1) - k * DP2) - k * DP3;
+      quadrant = (int)k;
+    }
+  else
+    {
+      double xd = (double)x;
+      double k;
+
+      /* The two part reduction is exact only for |k| < 2^20.  Beyond that
+       * the argument is first brought into range with fmod(), which keeps
+       * the result bounded but is not accurate.
+       */
+
+      if (fabs(xd) > REDUCE_MAXD)
+        {
+          xd = fmod(xd, 2.0 * M_PI);
+        }
+
+      k = xd * M_2_PI;
+      quadrant = (int)(k >= 0.0 ? k + 0.5 : k - 0.5);
+      k = (double)quadrant;
+      r = (float)((xd - k * PIO2_1) - k * PIO2_1T);
+    }
+
+  quadrant = (quadrant + cosine) & 3;
+  z = r * r;
+
+  if ((quadrant & 1) == 0)
+    {
+      /* sin(r) */
+
+      y = ((-1.9515295891e-4F * z + 8.3321608736e-3F) * z -
+           1.6666654611e-1F) * z * r + r;
+    }
+  else
+    {
+      /* cos(r) */
+
+      y = ((2.443315711809948e-5F * z - 1.388731625493765e-3F) * z +
+           4.166664568298827e-2F) * z * z - 0.5F * z + 1.0F;
+    }
+
+  return (quadrant & 2) != 0 ? -y : y;
+}
@@ -29,10 +29,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
 #include <math.h>
-#include <float.h>
 
-#define FLT_MAX_EXP_X   88.0F
+#include "libc.h"
 
 /****************************************************************************
  * Public Functions
@@ -40,40 +42,82 @@
 
 float logf(float x)
 {
-  float y, y_old, ey, epsilon;
+  union
+  {
+    float    f;
+    uint32_t u;
+  } v;
+
+  float y;
+  float z;
+  int e;
 
-  y = 0.0F;
-  y_old = 1.0F;
-  epsilon = FLT_EPSILON;
+  /* Handle the special cases */
 
-  while (y > y_old + epsilon || y < y_old - epsilon)
+  if (isnan(x))
     {
-      y_old = y;
-      ey = exp(y);
-      y -= (ey - x) / ey;
+      return x;
+    }
 
-      if (y > FLT_MAX_EXP_X)
-        {
-          y = FLT_MAX_EXP_X;
-        }
+  if (x < 0.0F)
+    {
+      return NAN_F;
+    }
 
-      if (y < -FLT_MAX_EXP_X)
-        {
-          y = -FLT_MAX_EXP_X;
-        }
+  if (x == 0.0F)
+    {
+      return -INFINITY_F;
+    }
 
-      epsilon = (fabsf(y) > 1.0F) ? fabsf(y) * FLT_EPSILON : FLT_EPSILON;
+  if (isinf_f(x))
+    {
+      return x;
     }
 
-  if (y == FLT_MAX_EXP_X)
+  /* Split x into a mantissa in [0.5, 1) and a binary exponent.  Subnormals
+   * are normalized first.
+   */
+
+  v.f = x;
+  e   = 0;
+
+  if (v.u < 0x00800000)
     {
-      return INFINITY;
+      v.f *= 33554432.0F;   /* 2^25 */
+      e    = -25;
     }
 
-  if (y == -FLT_MAX_EXP_X)
+  e    += (int)(v.u >> 23) - 126;
+  v.u   = (v.u & 0x007fffff) | 0x3f000000;
+  x     = v.f;
+
+  /* Use x in [sqrt(1/2), sqrt(2)) so that |x - 1| is small */
+
+  if (x < (float)M_SQRT1_2)
+    {
+      e--;
+      x = x + x - 1.0F;
+    }
+  else
     {
-      return INFINITY;
+      x = x - 1.0F;
     }
 
-  return y;
+  /* Minimax polynomial for log(1 + x) */
+
+  z = x * x;
+  y = ((((((((7.0376836292e-2F * x - 1.1514610310e-1F) * x +
+             1.1676998740e-1F) * x - 1.2420140846e-1F) * x +
+             1.4249322787e-1F) * x - 1.6668057665e-1F) * x +
+             2.0000714765e-1F) * x - 2.4999993993e-1F) * x +
+             3.3333331174e-1F) * x * z;
+
+  /* Add e * ln(2), ln(2) split in two parts to preserve accuracy */
+
+  y += -2.12194440e-4F * (float)e;
+  y += -0.5F * z;
+  z  = x + y;
+  z += 0.693359375F * (float)e;
+
+  return z;
 }
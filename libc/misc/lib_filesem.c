@@ -107,6 +107,43 @@ void lib_take_semaphore(FAR struct file_struct *stream)
     }
 }
 
+/****************************************************************************
+ * lib_trytake_semaphore
+ *
+ * Description:
+ *   Like lib_take_semaphore() but does not wait.  Returns zero if the
+ *   stream was locked or -1 if it is held by another task.
+ *
+ ****************************************************************************/
+
+int lib_trytake_semaphore(FAR struct file_struct *stream)
+{
+  pid_t my_pid = getpid();
+
+  /* Do I already have the semaphore? */
+
+  if (stream->fs_holder == my_pid)
+    {
+      /* Yes, just increment the number of references that I have */
+
+      stream->fs_counts++;
+    }
+  else
+    {
+      /* Take the semaphore only if it is available now */
+
+      if (sem_trywait(&stream->fs_sem) != 0)
+        {
+          return -1;
+        }
+
+      stream->fs_holder = my_pid;
+      stream->fs_counts = 1;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * lib_give_semaphore
  ****************************************************************************/
@@ -0,0 +1,590 @@
+/****************************************************************************
+ * libc/misc/lib_shmring.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/lib/shmring.h>
+
+#ifdef CONFIG_LIB_SHMRING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The ring indices are shared with a task that may run on another CPU, so
+ * data accesses must be ordered with respect to index updates.
+ */
+
+#ifdef __GNUC__
+#  define SHMRING_BARRIER() __sync_synchronize()
+#else
+#  define SHMRING_BARRIER()
+#endif
+
+/* Suffixes of the two named semaphores */
+
+#define SHMRING_DATASUFFIX  'd'
+#define SHMRING_SPACESUFFIX 's'
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_semname
+ *
+ * Description:
+ *   Form the name of one of the ring semaphores.
+ *
+ ****************************************************************************/
+
+static int shmring_semname(FAR char *buffer, FAR const char *name,
+                           char suffix)
+{
+  int ret = snprintf(buffer, NAME_MAX + 1, "%s.%c", name, suffix);
+  return ret > NAME_MAX ? -ENAMETOOLONG : OK;
+}
+
+/****************************************************************************
+ * Name: shmring_opensems
+ *
+ * Description:
+ *   Open (and optionally create) the data and space semaphores.
+ *
+ ****************************************************************************/
+
+static int shmring_opensems(FAR struct shmring_s *ring,
+                            FAR const char *name, bool create)
+{
+  char semname[NAME_MAX + 1];
+  int oflags = create ? O_CREAT : 0;
+  int ret;
+
+  ret = shmring_semname(semname, name, SHMRING_DATASUFFIX);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ring->datasem = sem_open(semname, oflags, 0666, 0);
+  if (ring->datasem == SEM_FAILED)
+    {
+      return -get_errno();
+    }
+
+  ret = shmring_semname(semname, name, SHMRING_SPACESUFFIX);
+  if (ret >= 0)
+    {
+      ring->spacesem = sem_open(semname, oflags, 0666, 0);
+      if (ring->spacesem == SEM_FAILED)
+        {
+          ret = -get_errno();
+        }
+    }
+
+  if (ret < 0)
+    {
+      (void)sem_close(ring->datasem);
+      return ret;
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* The semaphores are used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  if (create)
+    {
+      (void)sem_setprotocol(ring->datasem, SEM_PRIO_NONE);
+      (void)sem_setprotocol(ring->spacesem, SEM_PRIO_NONE);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmring_getspace
+ *
+ * Description:
+ *   Get the contiguous free space at the head of the ring, waiting for
+ *   space if the ring is full and 'block' is true.
+ *
+ ****************************************************************************/
+
+static int shmring_getspace(FAR struct shmring_s *ring, FAR uint8_t **ptr,
+                            FAR size_t *len, bool block)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  uint32_t offset;
+  uint32_t space;
+
+  while (hdr->head - hdr->tail >= hdr->size)
+    {
+      if (!block)
+        {
+          return -EAGAIN;
+        }
+
+      /* Announce that we are about to sleep, then look again in case the
+       * consumer freed space before it could see the announcement.
+       */
+
+      hdr->wrwait = 1;
+      SHMRING_BARRIER();
+
+      if (hdr->head - hdr->tail < hdr->size)
+        {
+          hdr->wrwait = 0;
+          break;
+        }
+
+      if (sem_wait(ring->spacesem) < 0)
+        {
+          hdr->wrwait = 0;
+          return -get_errno();
+        }
+    }
+
+  /* Don't write into the space before the consumer is done with it */
+
+  SHMRING_BARRIER();
+
+  offset = hdr->head & (hdr->size - 1);
+  space  = hdr->size - (hdr->head - hdr->tail);
+  if (space > hdr->size - offset)
+    {
+      space = hdr->size - offset;
+    }
+
+  *ptr = &hdr->data[offset];
+  *len = space;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmring_getdata
+ *
+ * Description:
+ *   Get the contiguous data at the tail of the ring, waiting for data if
+ *   the ring is empty and 'block' is true.
+ *
+ ****************************************************************************/
+
+static int shmring_getdata(FAR struct shmring_s *ring, FAR uint8_t **ptr,
+                           FAR size_t *len, bool block)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+  uint32_t offset;
+  uint32_t avail;
+
+  while (hdr->head == hdr->tail)
+    {
+      if (!block)
+        {
+          return -EAGAIN;
+        }
+
+      /* Announce that we are about to sleep, then look again in case the
+       * producer added data before it could see the announcement.
+       */
+
+      hdr->rdwait = 1;
+      SHMRING_BARRIER();
+
+      if (hdr->head != hdr->tail)
+        {
+          hdr->rdwait = 0;
+          break;
+        }
+
+      if (sem_wait(ring->datasem) < 0)
+        {
+          hdr->rdwait = 0;
+          return -get_errno();
+        }
+    }
+
+  /* Don't read the data before it is known to be complete */
+
+  SHMRING_BARRIER();
+
+  offset = hdr->tail & (hdr->size - 1);
+  avail  = hdr->head - hdr->tail;
+  if (avail > hdr->size - offset)
+    {
+      avail = hdr->size - offset;
+    }
+
+  *ptr = &hdr->data[offset];
+  *len = avail;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_create
+ *
+ * Description:
+ *   Format a region of shared memory as an empty ring and create the named
+ *   semaphores used to wait for data and space.
+ *
+ ****************************************************************************/
+
+int shmring_create(FAR struct shmring_s *ring, FAR const char *name,
+                   FAR void *mem, size_t size)
+{
+  FAR struct shmring_hdr_s *hdr = (FAR struct shmring_hdr_s *)mem;
+  uint32_t rsize;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && name != NULL && mem != NULL);
+
+  if (size < SHMRING_MINSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* Use the largest power of two that fits in the region */
+
+  size -= offsetof(struct shmring_hdr_s, data);
+  for (rsize = 1; rsize <= size / 2 && rsize < 0x80000000; rsize <<= 1);
+
+  hdr->magic  = 0;
+  hdr->size   = rsize;
+  hdr->head   = 0;
+  hdr->tail   = 0;
+  hdr->rdwait = 0;
+  hdr->wrwait = 0;
+
+  ret = shmring_opensems(ring, name, true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The ring is ready.  Publish it. */
+
+  ring->hdr   = hdr;
+  SHMRING_BARRIER();
+  hdr->magic  = SHMRING_MAGIC;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmring_attach
+ *
+ * Description:
+ *   Attach to a ring that was formatted by shmring_create().
+ *
+ ****************************************************************************/
+
+int shmring_attach(FAR struct shmring_s *ring, FAR const char *name,
+                   FAR void *mem)
+{
+  FAR struct shmring_hdr_s *hdr = (FAR struct shmring_hdr_s *)mem;
+
+  DEBUGASSERT(ring != NULL && name != NULL && mem != NULL);
+
+  if (hdr->magic != SHMRING_MAGIC)
+    {
+      return -EINVAL;
+    }
+
+  ring->hdr = hdr;
+  return shmring_opensems(ring, name, false);
+}
+
+/****************************************************************************
+ * Name: shmring_detach
+ *
+ * Description:
+ *   Release the semaphores held by this user of the ring.
+ *
+ ****************************************************************************/
+
+void shmring_detach(FAR struct shmring_s *ring)
+{
+  DEBUGASSERT(ring != NULL);
+
+  (void)sem_close(ring->datasem);
+  (void)sem_close(ring->spacesem);
+  ring->hdr = NULL;
+}
+
+/****************************************************************************
+ * Name: shmring_unlink
+ *
+ * Description:
+ *   Remove the named semaphores of the ring.
+ *
+ ****************************************************************************/
+
+int shmring_unlink(FAR const char *name)
+{
+  char semname[NAME_MAX + 1];
+  int ret;
+
+  ret = shmring_semname(semname, name, SHMRING_DATASUFFIX);
+  if (ret >= 0)
+    {
+      (void)sem_unlink(semname);
+      ret = shmring_semname(semname, name, SHMRING_SPACESUFFIX);
+      if (ret >= 0)
+        {
+          (void)sem_unlink(semname);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmring_commit
+ *
+ * Description:
+ *   Publish 'len' bytes written in place after shmring_reserve().
+ *
+ ****************************************************************************/
+
+void shmring_commit(FAR struct shmring_s *ring, size_t len)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+
+  DEBUGASSERT(len <= hdr->size - (hdr->head - hdr->tail));
+
+  /* Make the data visible before the new head */
+
+  SHMRING_BARRIER();
+  hdr->head += len;
+  SHMRING_BARRIER();
+
+  /* Wake up the consumer only if it is sleeping */
+
+  if (hdr->rdwait)
+    {
+      hdr->rdwait = 0;
+      (void)sem_post(ring->datasem);
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_consume
+ *
+ * Description:
+ *   Release 'len' bytes processed in place after shmring_peek().
+ *
+ ****************************************************************************/
+
+void shmring_consume(FAR struct shmring_s *ring, size_t len)
+{
+  FAR struct shmring_hdr_s *hdr = ring->hdr;
+
+  DEBUGASSERT(len <= hdr->head - hdr->tail);
+
+  /* Finish with the data before releasing the space */
+
+  SHMRING_BARRIER();
+  hdr->tail += len;
+  SHMRING_BARRIER();
+
+  /* Wake up the producer only if it is sleeping */
+
+  if (hdr->wrwait)
+    {
+      hdr->wrwait = 0;
+      (void)sem_post(ring->spacesem);
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_reserve
+ *
+ * Description:
+ *   Return the contiguous free space in the ring for zero-copy production.
+ *   NULL is returned with errno set if there is no space.
+ *
+ ****************************************************************************/
+
+FAR void *shmring_reserve(FAR struct shmring_s *ring, FAR size_t *len,
+                          bool block)
+{
+  FAR uint8_t *ptr;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && ring->hdr != NULL && len != NULL);
+
+  ret = shmring_getspace(ring, &ptr, len, block);
+  if (ret < 0)
+    {
+      *len = 0;
+      set_errno(-ret);
+      return NULL;
+    }
+
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: shmring_peek
+ *
+ * Description:
+ *   Return the contiguous data in the ring for zero-copy consumption.
+ *   NULL is returned with errno set if there is no data.
+ *
+ ****************************************************************************/
+
+FAR const void *shmring_peek(FAR struct shmring_s *ring, FAR size_t *len,
+                             bool block)
+{
+  FAR uint8_t *ptr;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && ring->hdr != NULL && len != NULL);
+
+  ret = shmring_getdata(ring, &ptr, len, block);
+  if (ret < 0)
+    {
+      *len = 0;
+      set_errno(-ret);
+      return NULL;
+    }
+
+  return ptr;
+}
+
+/****************************************************************************
+ * Name: shmring_write
+ *
+ * Description:
+ *   Copy data into the ring.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_write(FAR struct shmring_s *ring, FAR const void *buffer,
+                      size_t len, bool block)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)buffer;
+  FAR uint8_t *dest;
+  size_t nwritten = 0;
+  size_t avail;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && ring->hdr != NULL && buffer != NULL);
+
+  while (nwritten < len)
+    {
+      /* Only wait if nothing has been written yet */
+
+      ret = shmring_getspace(ring, &dest, &avail, block && nwritten == 0);
+      if (ret < 0)
+        {
+          return nwritten > 0 ? (ssize_t)nwritten : ret;
+        }
+
+      if (avail > len - nwritten)
+        {
+          avail = len - nwritten;
+        }
+
+      memcpy(dest, &src[nwritten], avail);
+      shmring_commit(ring, avail);
+      nwritten += avail;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: shmring_read
+ *
+ * Description:
+ *   Copy data out of the ring.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_read(FAR struct shmring_s *ring, FAR void *buffer,
+                     size_t len, bool block)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)buffer;
+  FAR uint8_t *src;
+  size_t nread = 0;
+  size_t avail;
+  int ret;
+
+  DEBUGASSERT(ring != NULL && ring->hdr != NULL && buffer != NULL);
+
+  while (nread < len)
+    {
+      /* Only wait if nothing has been read yet */
+
+      ret = shmring_getdata(ring, &src, &avail, block && nread == 0);
+      if (ret < 0)
+        {
+          return nread > 0 ? (ssize_t)nread : ret;
+        }
+
+      if (avail > len - nread)
+        {
+          avail = len - nread;
+        }
+
+      memcpy(&dest[nread], src, avail);
+      shmring_consume(ring, avail);
+      nread += avail;
+    }
+
+  return nread;
+}
+
+#endif /* CONFIG_LIB_SHMRING */
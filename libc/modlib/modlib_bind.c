@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <elf32.h>
 #include <errno.h>
@@ -50,42 +51,53 @@
 #include <nuttx/lib/modlib.h>
 #include <nuttx/binfmt/symtab.h>
 
+#include "libc.h"
 #include "modlib/modlib.h"
 
 /****************************************************************************
- * Private Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: modlib_readrel
- *
- * Description:
- *   Read the ELF32_Rel structure into memory.
- *
- ****************************************************************************/
+#if !defined(CONFIG_MODLIB_RELOCATION_BUFFERCOUNT) || \
+    CONFIG_MODLIB_RELOCATION_BUFFERCOUNT < 1
+#  undef CONFIG_MODLIB_RELOCATION_BUFFERCOUNT
+#  define CONFIG_MODLIB_RELOCATION_BUFFERCOUNT 32
+#endif
 
-static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
-                                 FAR const Elf32_Shdr *relsec,
-                                 int index, FAR Elf32_Rel *rel)
-{
-  off_t offset;
+#if !defined(CONFIG_MODLIB_SYMBOL_CACHECOUNT) || \
+    CONFIG_MODLIB_SYMBOL_CACHECOUNT < 1
+#  undef CONFIG_MODLIB_SYMBOL_CACHECOUNT
+#  define CONFIG_MODLIB_SYMBOL_CACHECOUNT 32
+#endif
 
-  /* Verify that the symbol table index lies within symbol table */
+#ifndef MIN
+#  define MIN(x,y) ((x) < (y) ? (x) : (y))
+#endif
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
-    {
-      serr("ERROR: Bad relocation symbol index: %d\n", index);
-      return -EINVAL;
-    }
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
 
-  /* Get the file offset to the symbol table entry */
+/* A resolved symbol table entry */
 
-  offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
+struct modlib_symslot_s
+{
+  int symidx;                 /* Symbol table index (-1: slot unused) */
+  bool nameless;              /* Undefined symbol without a name */
+  Elf32_Sym sym;              /* Symbol with its value resolved */
+};
 
-  /* And, finally, read the symbol table entry into memory */
+/* Working buffers of modlib_bind() */
 
-  return modlib_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
-}
+struct modlib_relocbuf_s
+{
+  Elf32_Rel rels[CONFIG_MODLIB_RELOCATION_BUFFERCOUNT];
+  struct modlib_symslot_s syms[CONFIG_MODLIB_SYMBOL_CACHECOUNT];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
 
 /****************************************************************************
  * Name: modlib_relocate and modlib_relocateadd
@@ -93,6 +105,11 @@ static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
  * Description:
  *   Perform all relocations associated with a section.
  *
+ *   Relocation entries are read CONFIG_MODLIB_RELOCATION_BUFFERCOUNT at a
+ *   time and resolved symbols are kept in a small direct-mapped cache,
+ *   since most relocations refer to a handful of section symbols and to the
+ *   same few imported functions.
+ *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
  *   failure.
@@ -100,15 +117,18 @@ static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
  ****************************************************************************/
 
 static int modlib_relocate(FAR struct module_s *modp,
-                           FAR struct mod_loadinfo_s *loadinfo, int relidx)
+                           FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR struct modlib_relocbuf_s *buf)
 
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
-  Elf32_Sym       sym;
+  FAR struct modlib_symslot_s *slot;
+  FAR Elf32_Rel  *rel;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
+  unsigned int    nrels;
+  unsigned int    nread;
   int             symidx;
   int             ret;
   int             i;
@@ -118,79 +138,98 @@ static int modlib_relocate(FAR struct module_s *modp,
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
-    {
-      psym = &sym;
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
 
-      /* Read the relocation entry into memory */
+  for (i = 0; i < nrels; i++)
+    {
+      /* Read the next batch of relocation entries into memory */
 
-      ret = modlib_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if ((i % CONFIG_MODLIB_RELOCATION_BUFFERCOUNT) == 0)
         {
-          serr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          nread = MIN(nrels - i, CONFIG_MODLIB_RELOCATION_BUFFERCOUNT);
+
+          ret = modlib_read(loadinfo, (FAR uint8_t *)buf->rels,
+                            nread * sizeof(Elf32_Rel),
+                            relsec->sh_offset + i * sizeof(Elf32_Rel));
+          if (ret < 0)
+            {
+              serr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              return ret;
+            }
         }
 
+      rel = &buf->rels[i % CONFIG_MODLIB_RELOCATION_BUFFERCOUNT];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
-
-      /* Read the symbol table entry into memory */
+      symidx = ELF32_R_SYM(rel->r_info);
+      slot   = &buf->syms[symidx % CONFIG_MODLIB_SYMBOL_CACHECOUNT];
 
-      ret = modlib_readsym(loadinfo, symidx, &sym);
-      if (ret < 0)
+      if (slot->symidx != symidx)
         {
-          serr("ERROR: Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-               relidx, i, symidx, ret);
-          return ret;
-        }
+          /* Read the symbol table entry into memory */
 
-      /* Get the value of the symbol (in sym.st_value) */
+          slot->symidx = -1;
 
-      ret = modlib_symvalue(modp, loadinfo, &sym);
-      if (ret < 0)
-        {
-          /* The special error -ESRCH is returned only in one condition:  The
-           * symbol has no name.
-           *
-           * There are a few relocations for a few architectures that do
-           * no depend upon a named symbol.  We don't know if that is the
-           * case here, but we will use a NULL symbol pointer to indicate
-           * that case to up_relocate().  That function can then do what
-           * is best.
-           */
-
-          if (ret == -ESRCH)
+          ret = modlib_readsym(loadinfo, symidx, &slot->sym);
+          if (ret < 0)
             {
-              serr("ERROR: Section %d reloc %d: Undefined symbol[%d] has no name: %d\n",
-                  relidx, i, symidx, ret);
-              psym = NULL;
+              serr("ERROR: Section %d reloc %d: Failed to read symbol[%d]: %d\n",
+                   relidx, i, symidx, ret);
+              return ret;
             }
-          else
+
+          /* Get the value of the symbol (in sym.st_value) */
+
+          ret = modlib_symvalue(modp, loadinfo, &slot->sym);
+          if (ret < 0)
             {
-              serr("ERROR: Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
-                  relidx, i, symidx, ret);
-              return ret;
+              /* The special error -ESRCH is returned only in one condition:
+               * The symbol has no name.
+               *
+               * There are a few relocations for a few architectures that do
+               * no depend upon a named symbol.  We don't know if that is the
+               * case here, but we will use a NULL symbol pointer to indicate
+               * that case to up_relocate().  That function can then do what
+               * is best.
+               */
+
+              if (ret == -ESRCH)
+                {
+                  serr("ERROR: Section %d reloc %d: Undefined symbol[%d] has no name: %d\n",
+                      relidx, i, symidx, ret);
+                }
+              else
+                {
+                  serr("ERROR: Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
+                      relidx, i, symidx, ret);
+                  return ret;
+                }
             }
+
+          slot->symidx   = symidx;
+          slot->nameless = (ret == -ESRCH);
         }
 
+      psym = slot->nameless ? NULL : &slot->sym;
+
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           serr("ERROR: Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           serr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
@@ -231,6 +270,7 @@ static int modlib_relocateadd(FAR struct module_s *modp,
 
 int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 {
+  FAR struct modlib_relocbuf_s *buf;
   int ret;
   int i;
 
@@ -253,6 +293,21 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
       return -ENOMEM;
     }
 
+  /* Allocate the relocation buffer and the resolved symbol cache */
+
+  buf = (FAR struct modlib_relocbuf_s *)
+    lib_malloc(sizeof(struct modlib_relocbuf_s));
+  if (buf == NULL)
+    {
+      serr("ERROR: Failed to allocate relocation buffer\n");
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_MODLIB_SYMBOL_CACHECOUNT; i++)
+    {
+      buf->syms[i].symidx = -1;
+    }
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -278,7 +333,7 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 
       if (loadinfo->shdr[i].sh_type == SHT_REL)
         {
-          ret = modlib_relocate(modp, loadinfo, i);
+          ret = modlib_relocate(modp, loadinfo, i, buf);
         }
       else if (loadinfo->shdr[i].sh_type == SHT_RELA)
         {
@@ -291,6 +346,8 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
         }
     }
 
+  lib_free(buf);
+
 #if defined(CONFIG_ARCH_HAVE_COHERENT_DCACHE)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
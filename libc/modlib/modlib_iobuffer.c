@@ -43,6 +43,7 @@
 #include <errno.h>
 
 #include <nuttx/module.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/lib/modlib.h>
 
 #include "libc.h"
@@ -103,9 +104,11 @@ int modlib_reallocbuffer(FAR struct mod_loadinfo_s *loadinfo, size_t increment)
   FAR void *buffer;
   size_t newsize;
 
-  /* Get the new size of the allocation */
+  /* Get the new size of the allocation.  The buffer grows geometrically
+   * so that long symbol names need only a few reallocations.
+   */
 
-  newsize = loadinfo->buflen + increment;
+  newsize = mm_growsize(loadinfo->buflen, loadinfo->buflen + increment);
 
   /* And perform the reallocation */
 
@@ -399,7 +399,10 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_HASHEDBYNAME)
+            symbol = symtab_findhashedbyname(g_modlib_symtab, exportinfo.name,
+                                             g_modlib_nsymbols);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
             symbol = symtab_findorderedbyname(g_modlib_symtab, exportinfo.name,
                                               g_modlib_nsymbols);
 #else
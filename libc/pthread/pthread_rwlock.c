@@ -46,6 +46,44 @@
 
 #include <nuttx/semaphore.h>
 
+#include "pthread/pthread_rwlock.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Drop one hold on the lock.  On return, *wake is true if there are
+ * blocked threads that may now be able to take the lock.
+ */
+
+static int rwlock_release(FAR pthread_rwlock_t *rw_lock, FAR bool *wake)
+{
+  unsigned int state;
+  unsigned int newstate;
+
+  do
+    {
+      state = rw_lock->state;
+      if ((state & RWLOCK_WRITER) != 0)
+        {
+          newstate = state & ~RWLOCK_WRITER;
+        }
+      else if ((state & RWLOCK_READERS) != 0)
+        {
+          newstate = state - 1;
+        }
+      else
+        {
+          return EINVAL;
+        }
+    }
+  while (!rwlock_cas(rw_lock, state, newstate));
+
+  *wake = (newstate & (RWLOCK_WRITER | RWLOCK_READERS | RWLOCK_WAITERS)) ==
+          RWLOCK_WAITERS;
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,9 +98,9 @@ int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
       return -ENOSYS;
     }
 
-  lock->num_readers       = 0;
-  lock->num_writers       = 0;
-  lock->write_in_progress = false;
+  lock->state       = 0;
+  lock->num_readers = 0;
+  lock->num_writers = 0;
 
   err = pthread_cond_init(&lock->cv, NULL);
   if (err != 0)
@@ -95,34 +133,40 @@ int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
 
 int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
 {
+  bool wake;
   int err;
 
-  err = pthread_mutex_lock(&rw_lock->lock);
-  if (err != 0)
-    {
-      return err;
-    }
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  /* Release the lock without the mutex.  The mutex is only needed to wake
+   * up blocked threads.
+   */
 
-  if (rw_lock->num_readers > 0)
+  err = rwlock_release(rw_lock, &wake);
+  if (err == OK && wake)
     {
-      rw_lock->num_readers--;
-
-      if (rw_lock->num_readers == 0)
+      err = pthread_mutex_lock(&rw_lock->lock);
+      if (err == 0)
         {
           err = pthread_cond_broadcast(&rw_lock->cv);
+          pthread_mutex_unlock(&rw_lock->lock);
         }
     }
-  else if (rw_lock->write_in_progress)
-    {
-      rw_lock->write_in_progress = false;
 
-      err = pthread_cond_broadcast(&rw_lock->cv);
+#else
+  err = pthread_mutex_lock(&rw_lock->lock);
+  if (err != 0)
+    {
+      return err;
     }
-  else
+
+  err = rwlock_release(rw_lock, &wake);
+  if (err == OK && wake)
     {
-      err = EINVAL;
+      err = pthread_cond_broadcast(&rw_lock->cv);
     }
 
   pthread_mutex_unlock(&rw_lock->lock);
+#endif
+
   return err;
 }
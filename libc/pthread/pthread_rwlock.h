@@ -0,0 +1,127 @@
+/****************************************************************************
+ * libc/pthread/pthread_rwlock.h
+ *
+ *   Copyright (C) 2017 Mark Schulte. All rights reserved.
+ *   Author: Mark Schulte <mark@mjs.pw>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_PTHREAD_PTHREAD_RWLOCK_H
+#define __LIBC_PTHREAD_PTHREAD_RWLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <pthread.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bits of the rwlock state word.  The state holds the number of readers
+ * that hold the lock, a flag indicating that a writer holds the lock, and
+ * a flag indicating that there are threads waiting on the condition
+ * variable.  Nothing but the state word is touched when a lock is taken
+ * or released without contention.
+ */
+
+#define RWLOCK_READERS      0x3fffffff  /* Number of readers holding the lock */
+#define RWLOCK_WAITERS      0x40000000  /* Threads are blocked on the lock */
+#define RWLOCK_WRITER       0x80000000  /* A writer holds the lock */
+
+/* With CONFIG_PTHREAD_RWLOCK_FASTPATH, the state word is updated with an
+ * atomic compare-and-swap and the mutex only serializes blocked threads.
+ * Otherwise, the state is only modified with the mutex held.
+ */
+
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+#  define rwlock_cas(rw,o,n) \
+     __sync_bool_compare_and_swap(&(rw)->state, (o), (n))
+#else
+#  define rwlock_cas(rw,o,n) \
+     ((rw)->state == (o) ? ((rw)->state = (n), true) : false)
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rwlock_setwaiters
+ *
+ * Description:
+ *   Mark the lock as having blocked threads so that uncontended releases
+ *   take the mutex and wake them up.  Called with the mutex held.
+ *
+ ****************************************************************************/
+
+static inline void rwlock_setwaiters(FAR pthread_rwlock_t *rw_lock)
+{
+  unsigned int state;
+
+  do
+    {
+      state = rw_lock->state;
+      if ((state & RWLOCK_WAITERS) != 0)
+        {
+          return;
+        }
+    }
+  while (!rwlock_cas(rw_lock, state, state | RWLOCK_WAITERS));
+}
+
+/****************************************************************************
+ * Name: rwlock_clrwaiters
+ *
+ * Description:
+ *   Clear the waiters flag when the last blocked thread leaves.  Called
+ *   with the mutex held.
+ *
+ ****************************************************************************/
+
+static inline void rwlock_clrwaiters(FAR pthread_rwlock_t *rw_lock)
+{
+  unsigned int state;
+
+  if (rw_lock->num_readers == 0 && rw_lock->num_writers == 0)
+    {
+      do
+        {
+          state = rw_lock->state;
+        }
+      while (!rwlock_cas(rw_lock, state, state & ~RWLOCK_WAITERS));
+    }
+}
+
+#endif /* __LIBC_PTHREAD_PTHREAD_RWLOCK_H */
@@ -46,6 +46,8 @@
 
 #include <nuttx/semaphore.h>
 
+#include "pthread/pthread_rwlock.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -55,29 +57,47 @@ static void rdlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
+  rw_lock->num_readers--;
+  rwlock_clrwaiters(rw_lock);
   (void)pthread_mutex_unlock(&rw_lock->lock);
 }
 #endif
 
-static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
+/* Try to add a reader to the lock.  'locked' is true if the caller holds
+ * the mutex.  Without the mutex, the lock is not taken if there are
+ * blocked threads so that they are served first.
+ */
+
+static int tryrdlock(FAR pthread_rwlock_t *rw_lock, bool locked)
 {
-  int err;
+  unsigned int state;
 
-  if (rw_lock->num_writers > 0 || rw_lock->write_in_progress)
-    {
-      err = EBUSY;
-    }
-  else if (rw_lock->num_readers == UINT_MAX)
+  do
     {
-      err = EAGAIN;
-    }
-  else
-    {
-      rw_lock->num_readers++;
-      err = OK;
+      state = rw_lock->state;
+      if ((state & RWLOCK_WRITER) != 0 ||
+          (!locked && (state & RWLOCK_WAITERS) != 0))
+        {
+          return EBUSY;
+        }
+
+#ifdef CONFIG_PTHREAD_RWLOCK_PREFER_WRITER
+      /* Waiting writers are served before new readers */
+
+      if (locked && rw_lock->num_writers > 0)
+        {
+          return EBUSY;
+        }
+#endif
+
+      if ((state & RWLOCK_READERS) == RWLOCK_READERS)
+        {
+          return EAGAIN;
+        }
     }
+  while (!rwlock_cas(rw_lock, state, state + 1));
 
-  return err;
+  return OK;
 }
 
 /****************************************************************************
@@ -102,14 +122,25 @@ static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
 int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
+  int err;
+
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  /* Uncontended readers only update the state word */
 
+  err = tryrdlock(rw_lock, false);
+  if (err != EBUSY || (rw_lock->state & RWLOCK_WRITER) != 0)
+    {
+      return err;
+    }
+#endif
+
+  err = pthread_mutex_trylock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
     }
 
-  err = tryrdlock(rw_lock);
+  err = tryrdlock(rw_lock, true);
 
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
@@ -118,17 +149,33 @@ int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  int err;
+
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  /* Uncontended readers only update the state word */
 
+  err = tryrdlock(rw_lock, false);
+  if (err != EBUSY)
+    {
+      return err;
+    }
+#endif
+
+  err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
     }
 
+  /* Announce this reader so that releases will wake it up */
+
+  rw_lock->num_readers++;
+  rwlock_setwaiters(rw_lock);
+
 #ifdef CONFIG_PTHREAD_CLEANUP
   pthread_cleanup_push(&rdlock_cleanup, rw_lock);
 #endif
-  while ((err = tryrdlock(rw_lock)) == EBUSY)
+  while ((err = tryrdlock(rw_lock, true)) == EBUSY)
     {
       if (ts != NULL)
         {
@@ -148,6 +195,9 @@ int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
   pthread_cleanup_pop(0);
 #endif
 
+  rw_lock->num_readers--;
+  rwlock_clrwaiters(rw_lock);
+
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
@@ -46,6 +46,8 @@
 
 #include <nuttx/semaphore.h>
 
+#include "pthread/pthread_rwlock.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -56,10 +58,34 @@ static void wrlock_cleanup(FAR void *arg)
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
   rw_lock->num_writers--;
+  rwlock_clrwaiters(rw_lock);
   (void)pthread_mutex_unlock(&rw_lock->lock);
 }
 #endif
 
+/* Try to take the lock for writing.  'locked' is true if the caller holds
+ * the mutex.  Without the mutex, the lock is not taken if there are
+ * blocked threads so that they are served first.
+ */
+
+static int trywrlock(FAR pthread_rwlock_t *rw_lock, bool locked)
+{
+  unsigned int state;
+
+  do
+    {
+      state = rw_lock->state;
+      if ((state & (RWLOCK_WRITER | RWLOCK_READERS)) != 0 ||
+          (!locked && (state & RWLOCK_WAITERS) != 0))
+        {
+          return EBUSY;
+        }
+    }
+  while (!rwlock_cas(rw_lock, state, state | RWLOCK_WRITER));
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -82,22 +108,27 @@ static void wrlock_cleanup(FAR void *arg)
 
 int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
+  int err;
 
-  if (err != 0)
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  /* An uncontended writer only updates the state word */
+
+  err = trywrlock(rw_lock, false);
+  if (err != EBUSY ||
+      (rw_lock->state & (RWLOCK_WRITER | RWLOCK_READERS)) != 0)
     {
       return err;
     }
+#endif
 
-  if (rw_lock->num_readers > 0 || rw_lock->write_in_progress)
-    {
-      err = EBUSY;
-    }
-  else
+  err = pthread_mutex_trylock(&rw_lock->lock);
+  if (err != 0)
     {
-      rw_lock->write_in_progress = true;
+      return err;
     }
 
+  err = trywrlock(rw_lock, true);
+
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
@@ -105,8 +136,19 @@ int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  int err;
+
+#ifdef CONFIG_PTHREAD_RWLOCK_FASTPATH
+  /* An uncontended writer only updates the state word */
+
+  err = trywrlock(rw_lock, false);
+  if (err != EBUSY)
+    {
+      return err;
+    }
+#endif
 
+  err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
@@ -118,12 +160,15 @@ int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
       goto exit_with_mutex;
     }
 
+  /* Announce this writer so that releases will wake it up */
+
   rw_lock->num_writers++;
+  rwlock_setwaiters(rw_lock);
 
 #ifdef CONFIG_PTHREAD_CLEANUP
   pthread_cleanup_push(&wrlock_cleanup, rw_lock);
 #endif
-  while (rw_lock->write_in_progress || rw_lock->num_readers > 0)
+  while ((err = trywrlock(rw_lock, true)) == EBUSY)
     {
       if (ts != NULL)
         {
@@ -143,11 +188,7 @@ int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
   pthread_cleanup_pop(0);
 #endif
 
-  if (err == 0)
-    {
-      rw_lock->write_in_progress = true;
-    }
-  else
+  if (err != 0)
     {
       /* In case of error, notify any blocked readers. */
 
@@ -155,6 +196,7 @@ int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
     }
 
   rw_lock->num_writers--;
+  rwlock_clrwaiters(rw_lock);
 
 exit_with_mutex:
   pthread_mutex_unlock(&rw_lock->lock);
@@ -97,6 +97,7 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
       sem->holder[1].htcb   = NULL;
       sem->holder[1].counts = 0;
 #  endif
+      sem->waiters          = NULL;
 #endif
       return OK;
     }
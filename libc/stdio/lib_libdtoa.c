@@ -47,6 +47,7 @@
 #include <nuttx/config.h>
 
 #include <math.h>
+#include <string.h>
 #include <assert.h>
 
 #include <nuttx/arch.h>
@@ -81,11 +82,14 @@
 
 static void zeroes(FAR struct lib_outstream_s *obj, int nzeroes)
 {
-  int i;
+  static const char zerobuf[] = "0000000000000000";
+  int nchars;
 
-  for (i = nzeroes; i > 0; i--)
+  while (nzeroes > 0)
     {
-      obj->put(obj, '0');
+      nchars = MIN(nzeroes, (int)sizeof(zerobuf) - 1);
+      lib_stream_puts(obj, zerobuf, nchars);
+      nzeroes -= nchars;
     }
 }
 
@@ -99,10 +103,7 @@ static void zeroes(FAR struct lib_outstream_s *obj, int nzeroes)
 
 static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 {
-  while (*str)
-    {
-      obj->put(obj, *str++);
-    }
+  lib_stream_puts(obj, str, strlen(str));
 }
 
 /****************************************************************************
@@ -136,7 +137,6 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
   int  numlen;          /* Actual number of digits returned by cvt */
   int  nchars;          /* Number of characters to print */
   int  dsgn;            /* Unused sign indicator */
-  int  i;
 
   /* This function may *NOT* be called within interrupt level logic.  That is
    * because the logic in __dtoa may attempt to allocate memory.  That will
@@ -251,20 +251,14 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
 
       else
         {
-          /* Print the integer part to the left of the decimal point */
+          /* Print the integer part to the left of the decimal point.  Any
+           * digits not returned by __dtoa are zeroes.
+           */
 
-          for (i = expt; i > 0; i--)
-            {
-              if (*digits != '\0')
-                {
-                  obj->put(obj, *digits);
-                  digits++;
-                }
-              else
-                {
-                  obj->put(obj, '0');
-                }
-            }
+          nchars = strnlen(digits, expt);
+          lib_stream_puts(obj, digits, nchars);
+          zeroes(obj, expt - nchars);
+          digits += nchars;
 
           /* Get the length of the fractional part */
 
@@ -304,11 +298,7 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
 
       /* Print the fractional part to the right of the decimal point */
 
-      for (i = nchars; i > 0; i--)
-        {
-          obj->put(obj, *digits);
-          digits++;
-        }
+      lib_stream_puts(obj, digits, nchars);
 
       /* Decrement to get the number of trailing zeroes to print */
 
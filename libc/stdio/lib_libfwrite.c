@@ -43,6 +43,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <string.h>
 #include <fcntl.h>
 #include <errno.h>
 
@@ -62,7 +63,7 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
   FAR const unsigned char *start = ptr;
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
-  unsigned char *dest;
+  size_t bufsize;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -104,12 +105,33 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
   /* Loop until all of the bytes have been buffered */
 
+  bufsize = stream->fs_bufend - stream->fs_bufstart;
   while (count > 0)
     {
       /* Determine the number of bytes left in the buffer */
 
       size_t gulp_size = stream->fs_bufend - stream->fs_bufpos;
 
+      /* If the buffer is empty and there is at least a full buffer of user
+       * data remaining, then there is no point in copying it through the
+       * buffer:  Write as many whole buffers of data as possible directly.
+       */
+
+      if (stream->fs_bufpos == stream->fs_bufstart && count >= bufsize)
+        {
+          ssize_t nwritten;
+
+          nwritten = write(stream->fs_fd, src, count - (count % bufsize));
+          if (nwritten <= 0)
+            {
+              goto errout_with_semaphore;
+            }
+
+          src   += nwritten;
+          count -= nwritten;
+          continue;
+        }
+
       /* Will the user data fit into the amount of buffer space
        * that we have left?
        */
@@ -129,16 +151,13 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       /* Transfer the data into the buffer */
 
-      for (dest = stream->fs_bufpos; gulp_size > 0; gulp_size--)
-        {
-          *dest++ = *src++;
-        }
-
-      stream->fs_bufpos = dest;
+      memcpy(stream->fs_bufpos, src, gulp_size);
+      stream->fs_bufpos += gulp_size;
+      src               += gulp_size;
 
       /* Is the buffer full? */
 
-      if (dest >= stream->fs_bufend)
+      if (stream->fs_bufpos >= stream->fs_bufend)
         {
           /* Flush the buffered data to the IO stream */
 
@@ -40,6 +40,7 @@
 #include <nuttx/compiler.h>
 
 #include <wchar.h>
+#include <limits.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -214,6 +215,34 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt,
 
 static const char g_nullstring[] = "(null)";
 
+/* Two-digit decimal conversion table:  Characters 2*n and 2*n+1 are the
+ * decimal representation of n, 0 <= n < 100.
+ */
+
+static const char g_decdigits[200] =
+{
+  '0', '0', '0', '1', '0', '2', '0', '3', '0', '4',
+  '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+  '1', '0', '1', '1', '1', '2', '1', '3', '1', '4',
+  '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+  '2', '0', '2', '1', '2', '2', '2', '3', '2', '4',
+  '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+  '3', '0', '3', '1', '3', '2', '3', '3', '3', '4',
+  '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+  '4', '0', '4', '1', '4', '2', '4', '3', '4', '4',
+  '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+  '5', '0', '5', '1', '5', '2', '5', '3', '5', '4',
+  '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+  '6', '0', '6', '1', '6', '2', '6', '3', '6', '4',
+  '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+  '7', '0', '7', '1', '7', '2', '7', '3', '7', '4',
+  '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+  '8', '0', '8', '1', '8', '2', '8', '3', '8', '4',
+  '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+  '9', '0', '9', '1', '9', '2', '9', '3', '9', '4',
+  '9', '5', '9', '6', '9', '7', '9', '8', '9', '9'
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -284,20 +313,52 @@ static int getpsize(uint8_t flags, FAR void *p)
 #endif /* CONFIG_PTR_IS_NOT_INT */
 
 /****************************************************************************
- * Name: utodec
+ * Name: utodecbuf
+ *
+ * Description:
+ *   Convert an unsigned integer to decimal, two digits at a time, in the
+ *   buffer ending at 'end'.  Returns a pointer to the first digit.
+ *
  ****************************************************************************/
 
-static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
+static FAR char *utodecbuf(FAR char *end, unsigned int n)
 {
-  unsigned int remainder = n % 10;
-  unsigned int dividend  = n / 10;
+  FAR const char *pair;
 
-  if (dividend)
+  while (n >= 100)
     {
-      utodec(obj, dividend);
+      pair   = &g_decdigits[(n % 100) << 1];
+      n     /= 100;
+      *--end = pair[1];
+      *--end = pair[0];
     }
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  if (n >= 10)
+    {
+      pair   = &g_decdigits[n << 1];
+      *--end = pair[1];
+      *--end = pair[0];
+    }
+  else
+    {
+      *--end = (char)(n + '0');
+    }
+
+  return end;
+}
+
+/****************************************************************************
+ * Name: utodec
+ ****************************************************************************/
+
+static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
+{
+  char buffer[3 * sizeof(unsigned int)];
+  FAR char *end = &buffer[sizeof(buffer)];
+  FAR char *ptr;
+
+  ptr = utodecbuf(end, n);
+  lib_stream_puts(obj, ptr, end - ptr);
 }
 
 /****************************************************************************
@@ -559,15 +620,25 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-  unsigned int  remainder = n % 10;
-  unsigned long dividend  = n / 10;
+  char buffer[3 * sizeof(unsigned long)];
+  FAR char *end = &buffer[sizeof(buffer)];
+  FAR char *ptr = end;
+  FAR const char *pair;
 
-  if (dividend)
+  /* Use the (more expensive) long arithmetic only until the remaining
+   * value fits in an unsigned int.
+   */
+
+  while (n > UINT_MAX)
     {
-      lutodec(obj, dividend);
+      pair   = &g_decdigits[(unsigned int)(n % 100) << 1];
+      n     /= 100;
+      *--ptr = pair[1];
+      *--ptr = pair[0];
     }
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  ptr = utodecbuf(ptr, (unsigned int)n);
+  lib_stream_puts(obj, ptr, end - ptr);
 }
 
 /****************************************************************************
@@ -811,15 +882,25 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-  unsigned int remainder = n % 10;
-  unsigned long long dividend = n / 10;
+  char buffer[3 * sizeof(unsigned long long)];
+  FAR char *end = &buffer[sizeof(buffer)];
+  FAR char *ptr = end;
+  FAR const char *pair;
 
-  if (dividend)
+  /* Use the (more expensive) long long arithmetic only until the remaining
+   * value fits in an unsigned int.
+   */
+
+  while (n > UINT_MAX)
     {
-      llutodec(obj, dividend);
+      pair   = &g_decdigits[(unsigned int)(n % 100) << 1];
+      n     /= 100;
+      *--ptr = pair[1];
+      *--ptr = pair[0];
     }
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  ptr = utodecbuf(ptr, (unsigned int)n);
+  lib_stream_puts(obj, ptr, end - ptr);
 }
 
 /****************************************************************************
@@ -1185,9 +1266,25 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR != '%')
         {
+#ifdef CONFIG_ARCH_ROMGETC
            /* Output the character */
 
            obj->put(obj, FMT_CHAR);
+#else
+           /* Output the run of characters up to the next format specifier
+            * or newline as one block.  src is left at the last character
+            * of the run.
+            */
+
+           FAR const char *run = src;
+
+           while (src[1] != '\0' && src[1] != '%' && *src != '\n')
+             {
+               src++;
+             }
+
+           lib_stream_puts(obj, run, src - run + 1);
+#endif
 
            /* Flush the buffer if a newline is encountered */
 
@@ -1353,7 +1450,6 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
         {
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
           int swidth;
-          int left;
 #endif
           /* Get the string to output */
 
@@ -1371,21 +1467,14 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           swidth = (IS_HASDOT(flags) && trunc >= 0)
                       ? strnlen(ptmp, trunc) : strlen(ptmp);
           prejustify(obj, fmt, 0, width, swidth);
-          left = swidth;
 #endif
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
-              if (left-- <= 0)
-                {
-                  break;
-                }
+#ifdef CONFIG_NOPRINTF_FIELDWIDTH
+          lib_stream_puts(obj, ptmp, strlen(ptmp));
+#else
+          lib_stream_puts(obj, ptmp, swidth);
 #endif
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
 
           /* Perform left-justification operations. */
 
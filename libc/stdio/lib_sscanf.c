@@ -779,6 +779,14 @@ int vsscanf(FAR const char *buf, FAR const char *fmt, va_list ap)
 
               if (*buf)
                 {
+                  FAR const char *src;
+                  FAR char *endptr;
+                  int errsave;
+#ifdef CONFIG_HAVE_DOUBLE
+                  double dvalue = 0.0;
+#endif
+                  float fvalue = 0.0;
+
                   /* Skip over any white space before the real string */
 
                   while (isspace(*buf))
@@ -786,57 +794,70 @@ int vsscanf(FAR const char *buf, FAR const char *fmt, va_list ap)
                       buf++;
                     }
 
-                  /* Was a fieldwidth specified? */
+                  /* Was a fieldwidth specified?  If not, the conversion
+                   * stops at the first character that cannot be part of
+                   * the number so it can be performed in place.
+                   * Otherwise, copy at most width characters into the
+                   * temporary working buffer.
+                   */
 
                   if (!width)
                     {
-                      /* No... Guess a field width using some heuristics */
-
-                      width = findwidth(buf, fmt);
+                      src = buf;
                     }
+                  else
+                    {
+                      width = MIN(sizeof(tmp) - 1, width);
+                      strncpy(tmp, buf, width);
+                      tmp[width] = '\0';
+                      src = tmp;
 
-                  /* Copy the real string into a temporary working buffer. */
+                      linfo("vsscanf: tmp[]=\"%s\"\n", tmp);
+                    }
 
-                  strncpy(tmp, buf, width);
-                  tmp[width] = '\0';
-                  buf += width;
+                  /* Perform the floating point conversion.  This is done
+                   * even if the value is not assigned in order to find
+                   * the end of the number.
+                   */
+                  /* Preserve the errno value */
 
-                  linfo("vsscanf: tmp[]=\"%s\"\n", tmp);
+                  errsave = get_errno();
+                  set_errno(0);
 
-                  /* Perform the floating point conversion */
+                  /* We have to check whether we need to return a float or
+                   * a double.
+                   */
 
-                  if (!noassign)
+#ifdef CONFIG_HAVE_DOUBLE
+                  if (lflag)
                     {
                       /* strtod always returns a double */
 
-                      FAR char *endptr;
-                      int       errsave;
+                      dvalue = strtod(src, &endptr);
+                    }
+                  else
+#endif
+                    {
+                      fvalue = strtof(src, &endptr);
+                    }
 
-                      /* Preserve the errno value */
+                  /* Check if the number was successfully converted */
+
+                  if (src == endptr || get_errno() == ERANGE)
+                    {
+                      return count;
+                    }
 
-                      errsave = get_errno();
-                      set_errno(0);
+                  /* Move by the actual number of characters converted */
 
-                      /* We have to check whether we need to return a float
-                       * or a double.
-                       */
+                  buf += (endptr - src);
+                  set_errno(errsave);
 
+                  if (!noassign)
+                    {
 #ifdef CONFIG_HAVE_DOUBLE
                       if (lflag)
                         {
-                          /* Get the converted double value */
-
-                          double dvalue = strtod(tmp, &endptr);
-
-                          /* Check if the number was successfully converted */
-
-                          if (tmp == endptr || get_errno() == ERANGE)
-                            {
-                              return count;
-                            }
-
-                          set_errno(errsave);
-
                           /* Return the double value */
 
                           linfo("vsscanf: Return %f to %p\n", dvalue, pd);
@@ -845,22 +866,10 @@ int vsscanf(FAR const char *buf, FAR const char *fmt, va_list ap)
                       else
 #endif
                         {
-                          /* Get the converted float value */
-
-                          float fvalue = strtof(tmp, &endptr);
-
-                          /* Check if the number was successfully converted */
-
-                          if (tmp == endptr || get_errno() == ERANGE)
-                            {
-                              return count;
-                            }
-
-                          set_errno(errsave);
-
                           /* Return the float value */
 
-                          linfo("vsscanf: Return %f to %p\n", (double)fvalue, pf);
+                          linfo("vsscanf: Return %f to %p\n",
+                                (double)fvalue, pf);
                           *pf = fvalue;
                         }
 
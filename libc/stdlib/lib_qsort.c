@@ -47,6 +47,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
 /****************************************************************************
@@ -85,14 +86,38 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/* Partitions with fewer than this number of elements are sorted with an
+ * insertion sort.
+ */
+
+#define QSORT_INSERTION_THRESHOLD 7
+
+/* If a partitioning pass needed no swaps, the data is probably nearly
+ * sorted and an insertion sort of each partition is attempted.  The
+ * insertion sort is abandoned after this many element moves.
+ */
+
+#define QSORT_PARTIAL_LIMIT       8
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+typedef CODE int (*compar_t)(FAR const void *, FAR const void *);
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             compar_t compar);
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           compar_t compar, int swaptype, int limit);
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int swaptype);
+static void introsort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int depth);
 
 /****************************************************************************
  * Private Functions
@@ -111,8 +136,7 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
@@ -120,50 +144,114 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: insertion_sort
+ *
+ * Description:
+ *   Insertion sort the 'nel' elements at 'base'.  If 'limit' is positive,
+ *   give up (leaving the elements permuted but not sorted) after that
+ *   many element moves.  Returns true if the elements were sorted.
+ *
  ****************************************************************************/
 
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           compar_t compar, int swaptype, int limit)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+  int nmoves = 0;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+        }
+
+      /* Count the number of positions the element moved */
+
+      if (limit > 0)
+        {
+          nmoves += (pm - pl) / width;
+          if (nmoves > limit)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: heap_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
+ *   Heapsort the 'nel' elements at 'base'.  This is used when the quicksort
+ *   recursion becomes too deep, bounding the worst case at O(n log n).
  *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int swaptype)
+{
+  size_t start;
+  size_t end;
+  size_t root;
+  size_t child;
+
+  /* Build a max heap, then repeatedly move the largest remaining element
+   * to the end of the array.
+   */
+
+  start = nel / 2;
+  end   = nel;
+
+  while (end > 1)
+    {
+      if (start > 0)
+        {
+          start--;
+        }
+      else
+        {
+          end--;
+          swap(base, base + end * width);
+        }
+
+      /* Sift the element at 'start' down into the heap of 'end' elements */
+
+      for (root = start; (child = 2 * root + 1) < end; root = child)
+        {
+          if (child + 1 < end &&
+              compar(base + child * width, base + (child + 1) * width) < 0)
+            {
+              child++;
+            }
+
+          if (compar(base + root * width, base + child * width) >= 0)
+            {
+              break;
+            }
+
+          swap(base + root * width, base + child * width);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: introsort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   The Bentley & McIlroy three-way quicksort, modified so that it recurses
+ *   only into the smaller partition (bounding the stack usage to O(log n))
+ *   and switches to heapsort once 'depth' levels of partitioning have been
+ *   used (bounding the run time at O(n log n)).
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void introsort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -172,37 +260,34 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t ls;
+  size_t rs;
+  size_t d;
   int swaptype;
   int swap_cnt;
-  int d;
   int r;
 
 loop:
   SWAPINIT(base, width);
   swap_cnt = 0;
 
-  if (nel < 7)
+  if (nel < QSORT_INSERTION_THRESHOLD)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
+      (void)insertion_sort(base, nel, width, compar, swaptype, 0);
+      return;
+    }
 
+  if (depth-- <= 0)
+    {
+      heap_sort(base, nel, width, compar, swaptype);
       return;
-  }
+    }
 
-  pm = (FAR char *)base + (nel / 2) * width;
+  pm = base + (nel / 2) * width;
   if (nel > 7)
     {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pn = base + (nel - 1) * width;
       if (nel > 40)
         {
           d  = (nel / 8) * width;
@@ -215,9 +300,9 @@ loop:
     }
 
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = base + width;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = base + (nel - 1) * width;
   for (; ; )
     {
       while (pb <= pc && (r = compar(pb, base)) <= 0)
@@ -255,43 +340,129 @@ loop:
       pc      -= width;
     }
 
+  pn = base + nel * width;
+  r  = min(pa - base, pb - pa);
+  vecswap(base, pb - r, r);
+
+  r  = min(pd - pc, pn - pd - width);
+  vecswap(pb, pn - r, r);
+
+  ls = pb - pa;
+  rs = pd - pc;
+
   if (swap_cnt == 0)
     {
-      /* Switch to insertion sort */
-
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      /* The data is probably nearly sorted.  Try an insertion sort of each
+       * partition, but give up if that needs more than a few moves:
+       * Unconditionally switching to insertion sort here is O(n^2) for
+       * some inputs.
+       */
+
+      if (insertion_sort(base, ls / width, width, compar, swaptype,
+                         QSORT_PARTIAL_LIMIT))
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          ls = 0;
         }
 
-      return;
+      if (insertion_sort(pn - rs, rs / width, width, compar, swaptype,
+                         QSORT_PARTIAL_LIMIT))
+        {
+          rs = 0;
+        }
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = min(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+  /* Recurse into the smaller partition and iterate on the larger one so
+   * that the stack depth is at most log2(nel).
+   */
 
-  r  = min(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+  if (ls < rs)
+    {
+      if (ls > width)
+        {
+          introsort(base, ls / width, width, compar, depth);
+        }
 
-  if ((r = pb - pa) > width)
+      if (rs > width)
+        {
+          base = pn - rs;
+          nel  = rs / width;
+          goto loop;
+        }
+    }
+  else
     {
-      qsort(base, r / width, width, compar);
+      if (rs > width)
+        {
+          introsort(pn - rs, rs / width, width, compar, depth);
+        }
+
+      if (ls > width)
+        {
+          nel = ls / width;
+          goto loop;
+        }
     }
+}
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ *   This version recurses only into the smaller partition and falls back
+ *   to heapsort if the partitioning becomes too deep (introsort), so the
+ *   worst case is O(n log n) time and O(log n) stack.
+ *
+ ****************************************************************************/
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth;
+
+  /* Limit the quicksort recursion to 2 * log2(nel) levels */
+
+  for (depth = 0, n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  introsort((FAR char *)base, nel, width, compar, depth);
 }
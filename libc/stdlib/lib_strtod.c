@@ -44,7 +44,29 @@
 #include <ctype.h>
 #include <errno.h>
 
+#include "libc.h"
+
 #ifdef CONFIG_HAVE_DOUBLE
+#ifdef CONFIG_HAVE_LONG_LONG
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strtod
+ *
+ * Description:
+ *   Convert a string to a double value
+ *
+ ****************************************************************************/
+
+double strtod(FAR const char *str, FAR char **endptr)
+{
+  return lib_strtofp(str, endptr, false);
+}
+
+#else /* CONFIG_HAVE_LONG_LONG */
 
 /****************************************************************************
  * Pre-processor definitions
@@ -253,4 +275,5 @@ errout:
   return number;
 }
 
+#endif /* CONFIG_HAVE_LONG_LONG */
 #endif /* CONFIG_HAVE_DOUBLE */
@@ -48,6 +48,29 @@
 #include <ctype.h>
 #include <errno.h>
 
+#include "libc.h"
+
+#if defined(CONFIG_HAVE_DOUBLE) && defined(CONFIG_HAVE_LONG_LONG)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strtof
+ *
+ * Description:
+ *   Convert a string to a float value
+ *
+ ****************************************************************************/
+
+float strtof(FAR const char *str, FAR char **endptr)
+{
+  return (float)lib_strtofp(str, endptr, true);
+}
+
+#else /* CONFIG_HAVE_DOUBLE && CONFIG_HAVE_LONG_LONG */
+
 /****************************************************************************
  * Pre-processor definitions
  ****************************************************************************/
@@ -254,3 +277,5 @@ errout:
 
   return number;
 }
+
+#endif /* CONFIG_HAVE_DOUBLE && CONFIG_HAVE_LONG_LONG */
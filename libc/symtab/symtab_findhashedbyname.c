@@ -0,0 +1,390 @@
+/****************************************************************************
+ * libc/symtab/symtab_findhashedbyname.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <debug.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASHEDBYNAME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of symbol tables for which an index is kept.  Normally there is
+ * only the one symbol table exported by the base code.
+ */
+
+#define SYMTAB_NINDEX   4
+
+/* Marks an empty hash bucket */
+
+#define SYMTAB_NOSLOT   0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A hash index of one symbol table, laid out like the GNU hash section of
+ * an ELF file:  The symbols are sorted by bucket into chains.
+ * buckets[] holds the first chain slot of each bucket, order[] the symbol
+ * table index of each slot and hashes[] the hash of each slot with bit 0
+ * replaced by an end-of-chain marker.  Most misses are thus rejected
+ * without touching the symbol names.
+ */
+
+struct symtab_index_s
+{
+  FAR struct symtab_index_s *flink;  /* Supports a singly linked list */
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* Number of symbols in symtab */
+  uint32_t mask;                     /* Number of buckets - 1 */
+  FAR uint32_t *hashes;              /* Hash of each slot | end marker */
+  FAR uint16_t *order;               /* Symbol index of each slot */
+  FAR uint16_t *buckets;             /* First slot of each bucket */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Indices, most recently used first */
+
+static FAR struct symtab_index_s *g_symtab_index;
+static int g_symtab_nindex;
+static sem_t g_symtab_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   The GNU ELF hash function (Bernstein's h * 33 + c)
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t hash = 5381;
+  uint8_t ch;
+
+  while ((ch = (uint8_t)*name++) != '\0')
+    {
+      hash = (hash << 5) + hash + ch;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_buildindex
+ *
+ * Description:
+ *   Create the hash index of a symbol table.  Returns NULL if the table is
+ *   too large to be indexed or if there is not enough memory.
+ *
+ ****************************************************************************/
+
+static FAR struct symtab_index_s *
+symtab_buildindex(FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR struct symtab_index_s *index;
+  uint32_t hash;
+  int nbuckets;
+  int next;
+  int slot;
+  int i;
+
+  if (nsyms <= 0 || nsyms >= SYMTAB_NOSLOT)
+    {
+      return NULL;
+    }
+
+  /* Use about two symbols per bucket */
+
+  nbuckets = 1;
+  while (nbuckets < (nsyms + 1) / 2)
+    {
+      nbuckets <<= 1;
+    }
+
+  index = (FAR struct symtab_index_s *)
+    lib_malloc(sizeof(struct symtab_index_s) + nsyms * sizeof(uint32_t) +
+               (nsyms + nbuckets) * sizeof(uint16_t));
+
+  if (index == NULL)
+    {
+      return NULL;
+    }
+
+  index->symtab  = symtab;
+  index->nsyms   = nsyms;
+  index->mask    = nbuckets - 1;
+  index->hashes  = (FAR uint32_t *)&index[1];
+  index->order   = (FAR uint16_t *)&index->hashes[nsyms];
+  index->buckets = &index->order[nsyms];
+
+  /* Count the symbols in each bucket, then turn the counts into the end
+   * of each bucket's run of slots.
+   */
+
+  memset(index->buckets, 0, nbuckets * sizeof(uint16_t));
+
+  for (i = 0; i < nsyms; i++)
+    {
+      index->buckets[symtab_hash(symtab[i].sym_name) & index->mask]++;
+    }
+
+  for (next = 0, i = 0; i < nbuckets; i++)
+    {
+      next += index->buckets[i];
+      index->buckets[i] = next;
+    }
+
+  /* Fill the slots backwards so that each bucket ends up pointing at its
+   * first slot and symbols keep their table order within a bucket.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      hash = symtab_hash(symtab[i].sym_name);
+      slot = --index->buckets[hash & index->mask];
+
+      index->hashes[slot] = hash & ~1;
+      index->order[slot]  = i;
+    }
+
+  /* Mark the last slot of each chain and the empty buckets */
+
+  for (next = nsyms, i = nbuckets - 1; i >= 0; i--)
+    {
+      slot = index->buckets[i];
+      if (slot == next)
+        {
+          index->buckets[i] = SYMTAB_NOSLOT;
+        }
+      else
+        {
+          index->hashes[next - 1] |= 1;
+          next = slot;
+        }
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: symtab_getindex
+ *
+ * Description:
+ *   Find or create the hash index of a symbol table and make it the most
+ *   recently used one.  Called with g_symtab_sem held.
+ *
+ ****************************************************************************/
+
+static FAR struct symtab_index_s *
+symtab_getindex(FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR struct symtab_index_s *curr;
+  FAR struct symtab_index_s *prev;
+
+  for (prev = NULL, curr = g_symtab_index; curr != NULL;
+       prev = curr, curr = curr->flink)
+    {
+      if (curr->symtab == symtab && curr->nsyms == nsyms)
+        {
+          if (prev != NULL)
+            {
+              prev->flink    = curr->flink;
+              curr->flink    = g_symtab_index;
+              g_symtab_index = curr;
+            }
+
+          return curr;
+        }
+    }
+
+  curr = symtab_buildindex(symtab, nsyms);
+  if (curr == NULL)
+    {
+      return NULL;
+    }
+
+  /* Drop the least recently used index if there are too many */
+
+  if (g_symtab_nindex >= SYMTAB_NINDEX)
+    {
+      prev = g_symtab_index;
+      while (prev->flink->flink != NULL)
+        {
+          prev = prev->flink;
+        }
+
+      lib_free(prev->flink);
+      prev->flink = NULL;
+      g_symtab_nindex--;
+    }
+
+  curr->flink    = g_symtab_index;
+  g_symtab_index = curr;
+  g_symtab_nindex++;
+  return curr;
+}
+
+/****************************************************************************
+ * Name: symtab_dropindex
+ *
+ * Description:
+ *   Discard an index that no longer matches its symbol table.  Called with
+ *   g_symtab_sem held.
+ *
+ ****************************************************************************/
+
+static void symtab_dropindex(FAR struct symtab_index_s *index)
+{
+  FAR struct symtab_index_s **pprev;
+
+  for (pprev = &g_symtab_index; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == index)
+        {
+          *pprev = index->flink;
+          lib_free(index);
+          g_symtab_nindex--;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version builds a hash index of the table on first use so that
+ *   look-ups take constant time.  The table itself need not be ordered.
+ *
+ *   A hit is always verified against the table itself.  If the name is not
+ *   in the index, the table is searched the slow way; if it is found then,
+ *   the table changed underneath the index and the index is rebuilt on the
+ *   next call.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms)
+{
+  FAR const struct symtab_s *symbol = NULL;
+  FAR struct symtab_index_s *index;
+  uint32_t hash;
+  int slot;
+
+  DEBUGASSERT(symtab != NULL && name != NULL);
+
+  while (sem_wait(&g_symtab_sem) != 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  index = symtab_getindex(symtab, nsyms);
+  if (index != NULL)
+    {
+      hash = symtab_hash(name);
+      slot = index->buckets[hash & index->mask];
+
+      if (slot != SYMTAB_NOSLOT)
+        {
+          for (; ; slot++)
+            {
+              uint32_t slothash = index->hashes[slot];
+
+              if ((slothash | 1) == (hash | 1) &&
+                  strcmp(name, symtab[index->order[slot]].sym_name) == 0)
+                {
+                  symbol = &symtab[index->order[slot]];
+                  break;
+                }
+
+              if ((slothash & 1) != 0)
+                {
+                  break;
+                }
+            }
+        }
+    }
+
+  if (symbol == NULL)
+    {
+#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+      symbol = symtab_findorderedbyname(symtab, name, nsyms);
+#else
+      symbol = symtab_findbyname(symtab, name, nsyms);
+#endif
+      if (symbol != NULL && index != NULL)
+        {
+          symtab_dropindex(index);
+        }
+    }
+
+  sem_post(&g_symtab_sem);
+  return symbol;
+}
+
+#endif /* CONFIG_SYMTAB_HASHEDBYNAME */
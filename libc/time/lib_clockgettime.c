@@ -0,0 +1,116 @@
+/****************************************************************************
+ * libc/time/lib_clockgettime.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/seqlock.h>
+#include <nuttx/userspace.h>
+
+/* This is the user-space implementation of clock_gettime().  The kernel
+ * build uses the implementation in sched/clock.
+ */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The clock data published by the kernel (see struct userspace_s) */
+
+struct clock_vdso_s g_clock_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Clock Functions based on POSIX APIs.  The time is read from the clock
+ *   data that the kernel updates on each system timer tick, without a
+ *   system call.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  uint32_t seq;
+
+  if (tp == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if (clock_id == CLOCK_MONOTONIC)
+    {
+      do
+        {
+          seq = seqcount_read_begin(&g_clock_vdso.cv_seq);
+          *tp = g_clock_vdso.cv_monotonic;
+        }
+      while (seqcount_read_retry(&g_clock_vdso.cv_seq, seq));
+
+      return OK;
+    }
+#endif
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      do
+        {
+          seq = seqcount_read_begin(&g_clock_vdso.cv_seq);
+          *tp = g_clock_vdso.cv_realtime;
+        }
+      while (seqcount_read_retry(&g_clock_vdso.cv_seq, seq));
+
+      return OK;
+    }
+
+  set_errno(EINVAL);
+  return ERROR;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
@@ -44,7 +44,10 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/tls.h>
-#include <arch/tls.h>
+
+#ifdef CONFIG_TLS_ALIGNED
+#  include <arch/tls.h>
+#endif
 
 #ifdef CONFIG_TLS
 
@@ -79,7 +82,7 @@ uintptr_t tls_get_element(int elem)
     {
       /* Get the TLS info structure from the current threads stack */
 
-      info = up_tls_info();
+      info = tls_get_info();
       DEBUGASSERT(info != NULL);
 
       /* Get the element value from the TLS info. */
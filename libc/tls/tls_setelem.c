@@ -44,7 +44,10 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/tls.h>
-#include <arch/tls.h>
+
+#ifdef CONFIG_TLS_ALIGNED
+#  include <arch/tls.h>
+#endif
 
 #ifdef CONFIG_TLS
 
@@ -77,7 +80,7 @@ void tls_set_element(int elem, uintptr_t value)
     {
       /* Get the TLS info structure from the current threads stack */
 
-      info = up_tls_info();
+      info = tls_get_info();
       DEBUGASSERT(info != NULL);
 
       /* Set the element value int the TLS info. */
@@ -49,6 +49,31 @@
 
 #include "nxcontext.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_NXFONTS_CACHE_HASHBITS
+#  define CONFIG_NXFONTS_CACHE_HASHBITS 4
+#endif
+
+#ifndef CONFIG_NXFONTS_CACHE_MAXBYTES
+#  define CONFIG_NXFONTS_CACHE_MAXBYTES 0
+#endif
+
+/* Glyphs are found by hashing the character code into a small table of
+ * buckets.
+ */
+
+#define NXFONTS_HASHSIZE     (1 << CONFIG_NXFONTS_CACHE_HASHBITS)
+#define NXFONTS_HASH(ch)     ((ch) & (NXFONTS_HASHSIZE - 1))
+
+/* The amount of memory allocated for one glyph */
+
+#define NXFONTS_GLYPHSIZE(g) SIZEOF_NXFONTS_GLYPH_S((g)->stride * (g)->height)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -72,14 +97,16 @@ struct nxfonts_fcache_s
   uint8_t maxglyphs;                   /* Maximum size of glyph[] array */
   uint8_t nglyphs;                     /* Current size of glyph[] array */
   uint8_t bpp;                         /* Bits per pixel */
+  size_t nbytes;                       /* Memory used by the cached glyphs */
   nxgl_mxpixel_t fgcolor;              /* Foreground color */
   nxgl_mxpixel_t bgcolor;              /* Background color */
   nxf_renderer_t renderer;             /* Font renderer */
 
   /* Glyph cache data storage */
 
-  FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
-  FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+  FAR struct nxfonts_glyph_s *head;    /* Most recently used glyph */
+  FAR struct nxfonts_glyph_s *tail;    /* Least recently used glyph */
+  FAR struct nxfonts_glyph_s *hash[NXFONTS_HASHSIZE]; /* Glyphs by code */
 };
 
 /****************************************************************************
@@ -180,64 +207,46 @@ static void nxf_cache_lock(FAR struct nxfonts_fcache_s *priv)
  * Name: nxf_removeglyph
  *
  * Description:
- *   Removes the entry 'glyph' from the font cache.
+ *   Removes the entry 'glyph' from the list of glyphs in LRU order.
  *
  ****************************************************************************/
 
 static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+                                   FAR struct nxfonts_glyph_s *glyph)
 {
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
+  /* Unlink the glyph from its predecessor (or the head of the list) */
 
-  if (prev == NULL)
+  if (glyph->blink == NULL)
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
-
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
     }
-
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
-
-  else if (glyph->flink == NULL)
+  else
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      glyph->blink->flink = glyph->flink;
     }
 
-  /* No.. Remove from mid-list */
+  /* And from its successor (or the tail of the list) */
 
+  if (glyph->flink == NULL)
+    {
+      priv->tail = glyph->blink;
+    }
   else
     {
-      prev->flink = glyph->flink;
+      glyph->flink->blink = glyph->blink;
     }
 
   glyph->flink = NULL;
-
-  /* Decrement the count of glyphs in the font cache */
-
-  DEBUGASSERT(priv->nglyphs > 0);
-  priv->nglyphs--;
+  glyph->blink = NULL;
 }
 
 /****************************************************************************
  * Name: nxf_addglyph
  *
  * Description:
- *   Add the entry 'glyph' to the head font cache list.
+ *   Add the entry 'glyph' to the head of the list of glyphs in LRU order.
  *
  ****************************************************************************/
 
@@ -248,35 +257,71 @@ static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
 
   /* Add the glyph to the head of the list */
 
+  glyph->blink = NULL;
   glyph->flink = priv->head;
 
   if (priv->head == NULL)
     {
       priv->tail = glyph;
     }
+  else
+    {
+      priv->head->blink = glyph;
+    }
 
   priv->head = glyph;
+}
+
+/****************************************************************************
+ * Name: nxf_evictglyph
+ *
+ * Description:
+ *   Remove the least recently used glyph from the font cache and free its
+ *   memory.
+ *
+ * Assumptions:
+ *   The caller has exclusive access to the font cache and the cache is not
+ *   empty.
+ *
+ ****************************************************************************/
 
-  /* Increment the count of glyphs in the font cache. */
+static void nxf_evictglyph(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR struct nxfonts_glyph_s *glyph = priv->tail;
+  FAR struct nxfonts_glyph_s **link;
+
+  DEBUGASSERT(glyph != NULL && priv->nglyphs > 0);
+
+  /* Remove the glyph from the LRU list */
 
-  DEBUGASSERT(priv->nglyphs < priv->maxglyphs);
-  priv->nglyphs++;
+  nxf_removeglyph(priv, glyph);
+
+  /* Then from its hash bucket */
+
+  for (link = &priv->hash[NXFONTS_HASH(glyph->code)];
+       *link != glyph;
+       link = &(*link)->hlink)
+    {
+      DEBUGASSERT(*link != NULL);
+    }
+
+  *link = glyph->hlink;
+
+  /* And release the memory */
+
+  priv->nglyphs--;
+  priv->nbytes -= NXFONTS_GLYPHSIZE(glyph);
+  lib_free(glyph);
 }
 
 /****************************************************************************
  * Name: nxf_findglyph
  *
  * Description:
- *   Find the glyph for the specific character 'ch' in the list of pre-
- *   rendered fonts in the font cache.
- *
- *   This is logically a part of nxf_cache_getglyph().  nxf_cache_getglyph()
- *   will attempt to find the cached glyph before rendering a new one.  So
- *   this function has two unexpected side-effects:  (1) If the font cache
- *   is full and the font is not found, then the least-recently-used glyph
- *   is deleted to make space for the new glyph that will be allocated.
+ *   Find the glyph for the specific character 'ch' in the hash table of
+ *   pre-rendered fonts in the font cache.
  *
- *   (2) If the glyph is found, then it is moved to the head of the list of
+ *   If the glyph is found, then it is moved to the head of the LRU list of
  *   glyphs since it is now the most recently used (leaving the least
  *   recently used glyph at the tail of the list).
  *
@@ -289,68 +334,49 @@ static FAR struct nxfonts_glyph_s *
 nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
+  /* Search the (short) hash chain for the glyph */
 
-   for (prev = NULL, glyph = priv->head;
-        glyph != NULL;
-        prev = glyph, glyph = glyph->flink)
+  for (glyph = priv->hash[NXFONTS_HASH(ch)];
+       glyph != NULL;
+       glyph = glyph->hlink)
     {
-      /* Check if we found the glyph for this character */
-
       if (glyph->code == ch)
         {
           /* This is now the most recently used glyph.  Move it to the head
            * of the list (if it is not already at the head of the list).
            */
 
-          if (prev != NULL)
+          if (glyph != priv->head)
             {
-              nxf_removeglyph(priv, glyph, prev);
+              nxf_removeglyph(priv, glyph);
               nxf_addglyph(priv, glyph);
             }
 
-          /* And return the glyph that we found */
-
           return glyph;
         }
-
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
-
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
-
-          nxf_removeglyph(priv, glyph, prev);
-          return NULL;
-        }
     }
 
   return NULL;
 }
 
 /****************************************************************************
- * Name: nxf_fillglyph
+ * Name: nxf_fillbitmap
  *
  * Description:
- *   Fill the glyph memory with the background color
+ *   Fill a glyph or a string strip with the background color
  *
  ****************************************************************************/
 
-static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
-                                 FAR struct nxfonts_glyph_s *glyph)
+static void nxf_fillbitmap(FAR struct nxfonts_fcache_s *priv,
+                           FAR uint8_t *bitmap, unsigned int height,
+                           unsigned int width, unsigned int stride)
 {
-  int row;
-  int col;
+  unsigned int row;
+  unsigned int col;
 
   /* Initialize the glyph memory to the background color. */
 
@@ -401,12 +427,12 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
         }
 #endif
 
-      /* Then fill the glyph with the packed background color */
+      /* Then fill each row with the packed background color */
 
-      ptr = (FAR uint8_t *)glyph->bitmap;
-      for (row = 0; row < glyph->height; row++)
+      for (row = 0; row < height; row++)
         {
-          for (col = 0; col < glyph->stride; col++)
+          ptr = bitmap + row * stride;
+          for (col = 0; col < (width * priv->bpp + 7) >> 3; col++)
             {
               /* Transfer the packed bytes into the buffer */
 
@@ -420,13 +446,14 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
 #if !defined(CONFIG_NX_DISABLE_16BPP)
   if (priv->bpp == 16)
     {
-      FAR uint16_t *ptr = (FAR uint16_t *)glyph->bitmap;
+      FAR uint16_t *ptr;
 
-      for (row = 0; row < glyph->height; row++)
+      for (row = 0; row < height; row++)
         {
           /* Just copy the color value into the glyph memory */
 
-          for (col = 0; col < glyph->width; col++)
+          ptr = (FAR uint16_t *)(bitmap + row * stride);
+          for (col = 0; col < width; col++)
             {
               *ptr++ = priv->bgcolor;
             }
@@ -438,8 +465,8 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
 #ifndef CONFIG_NX_DISABLE_24BPP
   if (priv->bpp == 24)
     {
-      FAR uint32_t *ptr = (FAR uint32_t *)glyph->bitmap;
-      FAR uint32_t pixel[3];
+      FAR uint32_t *ptr;
+      uint32_t pixel[3];
 
       /* Get two 32-bit values for alternating 32 representations */
 
@@ -447,27 +474,28 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
       pixel[1] = (uint32_t)priv->bgcolor << 16 | (uint32_t)priv->bgcolor >> 8;
       pixel[1] = (uint32_t)priv->bgcolor << 24 | (uint32_t)priv->bgcolor;
 
-      for (row = 0; row < glyph->height; row++)
+      for (row = 0; row < height; row++)
         {
           /* Copy the color value into the glyph memory */
 
+          ptr = (FAR uint32_t *)(bitmap + row * stride);
           col = 0;
           for (; ; )
             {
               *ptr++ = pixel[0];
-              if (++col >= glyph->width)
+              if (++col >= width)
                 {
                   break;
                 }
 
               *ptr++ = pixel[1];
-              if (++col >= glyph->width)
+              if (++col >= width)
                 {
                   break;
                 }
 
               *ptr++ = pixel[2];
-              if (++col >= glyph->width)
+              if (++col >= width)
                 {
                   break;
                 }
@@ -480,13 +508,14 @@ static inline void nxf_fillglyph(FAR struct nxfonts_fcache_s *priv,
 #if !defined(CONFIG_NX_DISABLE_32BPP)
   if (priv->bpp == 32)
     {
-      FAR uint32_t *ptr = (FAR uint32_t *)glyph->bitmap;
+      FAR uint32_t *ptr;
 
-      for (row = 0; row < glyph->height; row++)
+      for (row = 0; row < height; row++)
         {
           /* Just copy the color value into the glyph memory */
 
-          for (col = 0; col < glyph->width; col++)
+          ptr = (FAR uint32_t *)(bitmap + row * stride);
+          for (col = 0; col < width; col++)
             {
               *ptr++ = priv->bgcolor;
             }
@@ -534,10 +563,22 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 
   stride = (width * priv->bpp + 7) >> 3;
 
-  /* Allocate the glyph (always succeeds) */
+  /* Make room for the new glyph by discarding the least recently used
+   * glyphs until both the glyph count and the memory budget allow it.
+   */
+
+  bmsize = SIZEOF_NXFONTS_GLYPH_S(stride * height);
+  while (priv->tail != NULL &&
+         (priv->nglyphs >= priv->maxglyphs ||
+          (CONFIG_NXFONTS_CACHE_MAXBYTES > 0 &&
+           priv->nbytes + bmsize > CONFIG_NXFONTS_CACHE_MAXBYTES)))
+    {
+      nxf_evictglyph(priv);
+    }
+
+  /* Allocate the glyph */
 
-  bmsize = stride * height;
-  glyph  = (FAR struct nxfonts_glyph_s *)lib_malloc(SIZEOF_NXFONTS_GLYPH_S(bmsize));
+  glyph  = (FAR struct nxfonts_glyph_s *)lib_malloc(bmsize);
 
   if (glyph != NULL)
     {
@@ -550,7 +591,7 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 
       /* Initialize the glyph memory to the background color. */
 
-      nxf_fillglyph(priv, glyph);
+      nxf_fillbitmap(priv, glyph->bitmap, height, width, stride);
 
       /* Then render the glyph into the allocated, initialized memory */
 
@@ -568,12 +609,128 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 
       /* Add the new glyph to the font cache */
 
+      glyph->hlink = priv->hash[NXFONTS_HASH(ch)];
+      priv->hash[NXFONTS_HASH(ch)] = glyph;
       nxf_addglyph(priv, glyph);
+
+      DEBUGASSERT(priv->nglyphs < priv->maxglyphs);
+      priv->nglyphs++;
+      priv->nbytes += bmsize;
     }
 
   return glyph;
 }
 
+/****************************************************************************
+ * Name: nxf_getglyph
+ *
+ * Description:
+ *   Return the cached glyph for 'ch', rendering it first if necessary.
+ *
+ * Assumptions:
+ *   The caller holds the font cache semaphore.
+ *
+ ****************************************************************************/
+
+static FAR const struct nxfonts_glyph_s *
+nxf_getglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
+{
+  FAR struct nxfonts_glyph_s *glyph;
+  FAR const struct nx_fontbitmap_s *fbm;
+
+  /* First, try to find the glyph in the cache of pre-rendered glyphs */
+
+  glyph = nxf_findglyph(priv, ch);
+  if (glyph == NULL)
+    {
+      /* No, it is not cached... Does the code map to a font? */
+
+      fbm = nxf_getbitmap(priv->font, ch);
+      if (fbm)
+        {
+          /* Yes.. render the glyph for the font */
+
+          glyph = nxf_renderglyph(priv, fbm, ch);
+        }
+    }
+
+  return glyph;
+}
+
+/****************************************************************************
+ * Name: nxf_copyglyph
+ *
+ * Description:
+ *   Copy a pre-rendered glyph into a string strip at pixel column 'xpos'.
+ *
+ ****************************************************************************/
+
+static void nxf_copyglyph(FAR struct nxfonts_fcache_s *priv,
+                          FAR uint8_t *dest, unsigned int stride,
+                          unsigned int height, unsigned int xpos,
+                          FAR const struct nxfonts_glyph_s *glyph)
+{
+  FAR const uint8_t *src = glyph->bitmap;
+  unsigned int row;
+
+  if (height > glyph->height)
+    {
+      height = glyph->height;
+    }
+
+#if !defined(CONFIG_NX_DISABLE_1BPP) || !defined(CONFIG_NX_DISABLE_2BPP) || \
+    !defined(CONFIG_NX_DISABLE_4BPP)
+  if (priv->bpp < 8)
+    {
+      unsigned int bpp = priv->bpp;
+      uint8_t mask = (1 << bpp) - 1;
+      unsigned int col;
+
+      /* Pixels are not byte aligned in the strip.  Move them one at a
+       * time.
+       */
+
+      for (row = 0; row < height; row++)
+        {
+          for (col = 0; col < glyph->width; col++)
+            {
+              unsigned int sbit = col * bpp;
+              unsigned int dbit = (xpos + col) * bpp;
+              unsigned int sshift;
+              unsigned int dshift;
+              uint8_t pixel;
+
+#ifdef CONFIG_NX_PACKEDMSFIRST
+              sshift = 8 - bpp - (sbit & 7);
+              dshift = 8 - bpp - (dbit & 7);
+#else
+              sshift = sbit & 7;
+              dshift = dbit & 7;
+#endif
+              pixel  = (src[sbit >> 3] >> sshift) & mask;
+              dest[dbit >> 3] = (dest[dbit >> 3] & ~(mask << dshift)) |
+                                (pixel << dshift);
+            }
+
+          src  += glyph->stride;
+          dest += stride;
+        }
+    }
+  else
+#endif
+    {
+      /* Whole bytes per pixel.  Copy each glyph row in one piece */
+
+      dest += (xpos * priv->bpp) >> 3;
+      for (row = 0; row < height; row++)
+        {
+          memcpy(dest, src, glyph->stride);
+          src  += glyph->stride;
+          dest += stride;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: nxf_findcache
  *
@@ -905,8 +1062,7 @@ NXHANDLE nxf_cache_getfonthandle(FCACHE fhandle)
 FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle, uint8_t ch)
 {
   FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
-  FAR struct nxfonts_glyph_s *glyph;
-  FAR const struct nx_fontbitmap_s *fbm;
+  FAR const struct nxfonts_glyph_s *glyph;
 
   ginfo("ch=%c (%02x)\n", (ch >= 32 && ch < 128) ? ch : '.', ch);
 
@@ -914,22 +1070,100 @@ FAR const struct nxfonts_glyph_s *nxf_cache_getglyph(FCACHE fhandle, uint8_t ch)
 
   nxf_cache_lock(priv);
 
-  /* First, try to find the glyph in the cache of pre-rendered glyphs */
+  /* Find the glyph in the cache or render it */
 
-  glyph = nxf_findglyph(priv, ch);
-  if (glyph == NULL)
+  glyph = nxf_getglyph(priv, ch);
+
+  nxf_cache_unlock(priv);
+  return glyph;
+}
+
+/****************************************************************************
+ * Name: nxf_cache_renderstring
+ *
+ * Description:
+ *   Render a string of characters from the font cache into a caller
+ *   provided strip so that the whole string can be drawn with a single
+ *   bitmap operation.  The strip is first filled with the background color
+ *   and then each glyph is copied in place, all while holding the font
+ *   cache lock once.  Characters with no glyph are rendered as spaces.
+ *   Rendering stops at the first character that does not fit in the strip.
+ *
+ * Input Parameters:
+ *   fhandle - A font cache handle previously returned by nxf_cache_connect();
+ *   str     - The characters to render
+ *   len     - The number of characters in 'str'
+ *   dest    - The strip memory in the font cache's pixel format
+ *   stride  - The width of one row of the strip in bytes
+ *   size    - On input, the size of the strip in pixels.  On return, the
+ *             size of the region actually rendered.
+ *
+ * Returned Value:
+ *   The number of characters rendered.
+ *
+ ****************************************************************************/
+
+int nxf_cache_renderstring(FCACHE fhandle, FAR const uint8_t *str, int len,
+                           FAR uint8_t *dest, unsigned int stride,
+                           FAR struct nxgl_size_s *size)
+{
+  FAR struct nxfonts_fcache_s *priv = (FAR struct nxfonts_fcache_s *)fhandle;
+  FAR const struct nxfonts_glyph_s *glyph;
+  FAR const struct nx_font_s *fontset;
+  unsigned int height;
+  unsigned int xpos;
+  int nchars;
+
+  DEBUGASSERT(priv != NULL && str != NULL && dest != NULL && size != NULL);
+
+  /* The strip is never taller than the font */
+
+  fontset = nxf_getfontset(priv->font);
+  height  = size->h;
+  if (height > fontset->mxheight)
     {
-      /* No, it is not cached... Does the code map to a font? */
+      height = fontset->mxheight;
+    }
 
-      fbm = nxf_getbitmap(priv->font, ch);
-      if (fbm)
+  /* Get exclusive access to the font cache */
+
+  nxf_cache_lock(priv);
+
+  /* Initialize the strip to the background color */
+
+  nxf_fillbitmap(priv, dest, height, size->w, stride);
+
+  /* Then copy in each glyph */
+
+  for (nchars = 0, xpos = 0; nchars < len; nchars++)
+    {
+      glyph = nxf_getglyph(priv, str[nchars]);
+      if (glyph == NULL)
         {
-          /* Yes.. render the glyph for the font */
+          /* No font for this code.  Leave a space */
 
-          glyph = nxf_renderglyph(priv, fbm, ch);
+          if (xpos + fontset->spwidth > size->w)
+            {
+              break;
+            }
+
+          xpos += fontset->spwidth;
+        }
+      else
+        {
+          if (xpos + glyph->width > size->w)
+            {
+              break;
+            }
+
+          nxf_copyglyph(priv, dest, stride, height, xpos, glyph);
+          xpos += glyph->width;
         }
     }
 
   nxf_cache_unlock(priv);
-  return glyph;
+
+  size->w = xpos;
+  size->h = height;
+  return nchars;
 }
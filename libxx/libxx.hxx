@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <cstddef>
+
 //***************************************************************************
 // Definitions
 //***************************************************************************
@@ -85,4 +87,12 @@ extern "C" FAR void *__dso_handle;
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
 
+#ifdef CONFIG_CXX_NEWPOOL
+// Small object pool used by operator new and operator delete (see
+// libxx_newpool.cxx)
+
+FAR void *libxx_pool_alloc(size_t nbytes);
+bool libxx_pool_free(FAR void *ptr, size_t nbytes);
+#endif
+
 #endif // __LIBXX_LIBXX_HXX
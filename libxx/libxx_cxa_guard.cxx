@@ -37,8 +37,17 @@
 // Included Files
 //***************************************************************************
 
+#include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+#  include <sys/types.h>
+#  include <cassert>
+#  include <cerrno>
+#  include <cunistd>
+#  include <semaphore.h>
+#endif
+
 //***************************************************************************
 // Pre-processor Definitions
 //***************************************************************************
@@ -66,6 +75,83 @@ __extension__ typedef int __guard __attribute__((mode(__DI__)));
 // Private Data
 //***************************************************************************
 
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+// All guarded initializations are serialized by one recursive lock.  It
+// must be recursive because the initializer of one static object may need
+// another static object.  The lock is taken only when the object is not
+// yet initialized; once it is, __cxa_guard_acquire() just reads the guard.
+
+static sem_t g_guard_sem = SEM_INITIALIZER(1);
+static volatile pid_t g_guard_holder = (pid_t)-1;
+static unsigned int g_guard_count;
+#endif
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+//***************************************************************************
+// Name: guard_done
+//
+// Description:
+//   Return true if the object protected by the guard has been initialized.
+//   The barrier orders the read of the guard before any access to the
+//   object itself.
+//
+//***************************************************************************
+
+static inline bool guard_done(FAR __guard *g)
+{
+#ifdef __ARM_EABI__
+  bool done = (*(FAR volatile __guard *)g & 1) != 0;
+#else
+  bool done = *(FAR volatile char *)g != 0;
+#endif
+
+  if (done)
+    {
+      __sync_synchronize();
+    }
+
+  return done;
+}
+
+//***************************************************************************
+// Name: guard_lock and guard_unlock
+//***************************************************************************
+
+static void guard_lock(void)
+{
+  pid_t me = getpid();
+
+  if (g_guard_holder == me)
+    {
+      g_guard_count++;
+      return;
+    }
+
+  while (sem_wait(&g_guard_sem) < 0)
+    {
+      DEBUGASSERT(errno == EINTR);
+    }
+
+  g_guard_holder = me;
+  g_guard_count  = 1;
+}
+
+static void guard_unlock(void)
+{
+  DEBUGASSERT(g_guard_holder == getpid() && g_guard_count > 0);
+
+  if (--g_guard_count == 0)
+    {
+      g_guard_holder = (pid_t)-1;
+      sem_post(&g_guard_sem);
+    }
+}
+#endif
+
 //***************************************************************************
 // Public Functions
 //***************************************************************************
@@ -78,7 +164,27 @@ extern "C"
 
   int __cxa_guard_acquire(FAR __guard *g)
   {
-#ifdef __ARM_EABI__
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+    // Fast path:  The object is already initialized
+
+    if (guard_done(g))
+      {
+        return 0;
+      }
+
+    // Slow path:  Check again with the lock held.  If the object still
+    // needs to be initialized, keep holding the lock until the caller
+    // calls __cxa_guard_release() or __cxa_guard_abort().
+
+    guard_lock();
+    if (guard_done(g))
+      {
+        guard_unlock();
+        return 0;
+      }
+
+    return 1;
+#elif defined(__ARM_EABI__)
     return !(*g & 1);
 #else
     return !*(char *)g;
@@ -91,11 +197,21 @@ extern "C"
 
   void __cxa_guard_release(FAR __guard *g)
   {
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+    // Make the initialized object visible before the guard is set
+
+    __sync_synchronize();
+#endif
+
 #ifdef __ARM_EABI__
     *g = 1;
 #else
     *(char *)g = 1;
 #endif
+
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+    guard_unlock();
+#endif
   }
 
   //*************************************************************************
@@ -104,5 +220,11 @@ extern "C"
 
   void __cxa_guard_abort(FAR __guard *)
   {
+#ifdef CONFIG_CXX_THREADSAFE_STATICS
+    // The initializer failed.  The object is still uninitialized and the
+    // next user will try again.
+
+    guard_unlock();
+#endif
   }
 }
@@ -0,0 +1,211 @@
+//***************************************************************************
+// libxx/libxx_newpool.cxx
+//
+//   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX nor the names of its contributors may be
+//    used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <nuttx/irq.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_CXX_NEWPOOL
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+#ifndef CONFIG_CXX_NEWPOOL_NOBJECTS
+#  define CONFIG_CXX_NEWPOOL_NOBJECTS 16
+#endif
+
+// There are three size classes of 16, 32, and 64 bytes.  The storage is
+// declared as uint64_t so that every object is suitably aligned.
+
+#define NEWPOOL_NCLASSES  3
+#define NEWPOOL_NWORDS(n) ((n) / sizeof(uint64_t) * CONFIG_CXX_NEWPOOL_NOBJECTS)
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+struct newpool_s
+{
+  FAR uint8_t *start;     // First object of the class
+  FAR uint8_t *end;       // End of the storage of the class
+  FAR uint8_t *next;      // First object that was never allocated
+  FAR void *freelist;     // Objects that were freed
+  size_t objsize;         // Size of each object
+};
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+static uint64_t g_newpool16[NEWPOOL_NWORDS(16)];
+static uint64_t g_newpool32[NEWPOOL_NWORDS(32)];
+static uint64_t g_newpool64[NEWPOOL_NWORDS(64)];
+
+static struct newpool_s g_newpool[NEWPOOL_NCLASSES] =
+{
+  {
+    (FAR uint8_t *)g_newpool16,
+    (FAR uint8_t *)&g_newpool16[NEWPOOL_NWORDS(16)],
+    (FAR uint8_t *)g_newpool16, NULL, 16
+  },
+  {
+    (FAR uint8_t *)g_newpool32,
+    (FAR uint8_t *)&g_newpool32[NEWPOOL_NWORDS(32)],
+    (FAR uint8_t *)g_newpool32, NULL, 32
+  },
+  {
+    (FAR uint8_t *)g_newpool64,
+    (FAR uint8_t *)&g_newpool64[NEWPOOL_NWORDS(64)],
+    (FAR uint8_t *)g_newpool64, NULL, 64
+  }
+};
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: newpool_class
+//
+// Description:
+//   Return the smallest size class that holds 'nbytes'.  NEWPOOL_NCLASSES
+//   is returned if the object is too large for the pool.
+//
+//***************************************************************************
+
+static inline int newpool_class(size_t nbytes)
+{
+  int i = 0;
+
+  while (i < NEWPOOL_NCLASSES && nbytes > g_newpool[i].objsize)
+    {
+      i++;
+    }
+
+  return i;
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_pool_alloc
+//
+// Description:
+//   Allocate a small object from the pool.  If the smallest class that
+//   fits is exhausted, a larger class is tried.  NULL is returned if the
+//   object is too large or if the pool is exhausted; the caller then falls
+//   back to the heap.
+//
+//***************************************************************************
+
+FAR void *libxx_pool_alloc(size_t nbytes)
+{
+  FAR struct newpool_s *pool;
+  FAR void *alloc = NULL;
+  irqstate_t flags;
+  int i;
+
+  for (i = newpool_class(nbytes); i < NEWPOOL_NCLASSES && !alloc; i++)
+    {
+      pool  = &g_newpool[i];
+      flags = enter_critical_section();
+
+      if (pool->freelist != NULL)
+        {
+          alloc          = pool->freelist;
+          pool->freelist = *(FAR void **)alloc;
+        }
+      else if (pool->next < pool->end)
+        {
+          alloc          = pool->next;
+          pool->next    += pool->objsize;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return alloc;
+}
+
+//***************************************************************************
+// Name: libxx_pool_free
+//
+// Description:
+//   Return an object to the pool.  'nbytes' is the size of the object if
+//   known (sized delete) or zero.  A known size lets us skip the classes
+//   that are too small to hold the object.
+//
+// Returned Value:
+//   true if the object belonged to the pool; false if it must be freed to
+//   the heap.
+//
+//***************************************************************************
+
+bool libxx_pool_free(FAR void *ptr, size_t nbytes)
+{
+  FAR struct newpool_s *pool;
+  FAR uint8_t *obj = (FAR uint8_t *)ptr;
+  irqstate_t flags;
+  int i;
+
+  for (i = newpool_class(nbytes); i < NEWPOOL_NCLASSES; i++)
+    {
+      pool = &g_newpool[i];
+      if (obj >= pool->start && obj < pool->end)
+        {
+          flags = enter_critical_section();
+          *(FAR void **)ptr = pool->freelist;
+          pool->freelist    = ptr;
+          leave_critical_section(flags);
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif // CONFIG_CXX_NEWPOOL
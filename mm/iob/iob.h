@@ -83,6 +83,41 @@
 #endif
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* Shared I/O buffers.  Each I/O buffer in a pool is followed by its own
+ * data.
+ */
+
+#ifdef CONFIG_IOB_SHARED
+#  ifndef CONFIG_IOB_NCLONES
+#    define CONFIG_IOB_NCLONES 0
+#  endif
+
+#  define IOB_OWNDATA(p) ((FAR uint8_t *)((p) + 1))
+#endif
+
+/* Per-CPU caches and reservations */
+
+#ifndef CONFIG_IOB_PERCPU_CACHE
+#  define CONFIG_IOB_PERCPU_CACHE 0
+#endif
+
+#ifdef CONFIG_IOB_RESERVATIONS
+#  ifndef CONFIG_IOB_RESERVE_TCP
+#    define CONFIG_IOB_RESERVE_TCP 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_UDP
+#    define CONFIG_IOB_RESERVE_UDP 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_IPFORWARD
+#    define CONFIG_IOB_RESERVE_IPFORWARD 0
+#  endif
+
+#  if CONFIG_IOB_RESERVE_TCP + CONFIG_IOB_RESERVE_UDP + \
+      CONFIG_IOB_RESERVE_IPFORWARD >= CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE
+#    error I/O buffer reservations exceed the number of I/O buffers
+#  endif
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -95,6 +130,18 @@ extern FAR struct iob_s *g_iob_freelist;
 
 extern FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+extern FAR struct iob_s *g_iob_largefree;
+#endif
+
+#if defined(CONFIG_IOB_SHARED) && CONFIG_IOB_NCLONES > 0
+/* A list of all free I/O buffer clone heads (I/O buffers without data) */
+
+extern FAR struct iob_s *g_iob_clonefree;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -115,10 +162,114 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_RESERVATIONS
+/* The number of accounted I/O buffers held by each IOB_USER_* user */
+
+extern uint16_t g_iob_inuse[IOB_NUSERS];
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The number of threads waiting in iob_alloc().  The per-CPU caches are
+ * bypassed while this is non-zero.
+ */
+
+extern volatile int g_iob_waiters;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_take
+ *
+ * Description:
+ *   Remove one I/O buffer from the free list and take its semaphore
+ *   count(s), accounting it to 'user'.  The I/O buffer is not otherwise
+ *   initialized.  NULL is returned if no I/O buffer is available for this
+ *   allocation.  Must be called from within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_take(bool throttled, uint8_t user);
+
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the free list (or to the committed list if a
+ *   thread is waiting for it) and give back its semaphore count(s).  Must
+ *   be called from within a critical section.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return an unreferenced I/O buffer to the pool that it came from.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_alloc_clone
+ *
+ * Description:
+ *   Allocate an I/O buffer that will reference the data of another I/O
+ *   buffer, preferably one of the data-less clone heads.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SHARED
+FAR struct iob_s *iob_alloc_clone(bool throttled);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty.  The semaphore counts of the
+ *   returned I/O buffer have already been taken.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+FAR struct iob_s *iob_cache_alloc(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Try to free an I/O buffer into the cache of the current CPU.  Returns
+ *   false if the I/O buffer must be returned to the free list instead.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+bool iob_cache_free(FAR struct iob_s *iob);
+#endif
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the I/O buffers held in all of the per-CPU caches to the free
+ *   list.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+void iob_cache_flush(void);
+#else
+#  define iob_cache_flush()
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_qentry
  *
@@ -46,14 +46,58 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_RESERVATIONS
+/* The number of I/O buffers reserved for each IOB_USER_* user */
+
+static const uint16_t g_iob_reserve[IOB_NUSERS] =
+{
+  0,                            /* IOB_USER_NONE */
+  CONFIG_IOB_RESERVE_TCP,       /* IOB_USER_TCP */
+  CONFIG_IOB_RESERVE_UDP,       /* IOB_USER_UDP */
+  CONFIG_IOB_RESERVE_IPFORWARD  /* IOB_USER_IPFORWARD */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_reserved
+ *
+ * Description:
+ *   Return the number of free I/O buffers that are still reserved for users
+ *   other than 'user'.  Must be called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_RESERVATIONS
+static int iob_reserved(uint8_t user)
+{
+  int reserved = 0;
+  int i;
+
+  for (i = IOB_USER_NONE + 1; i < IOB_NUSERS; i++)
+    {
+      if (i != user && g_iob_inuse[i] < g_iob_reserve[i])
+        {
+          reserved += g_iob_reserve[i] - g_iob_inuse[i];
+        }
+    }
+
+  return reserved;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_alloc_committed
  *
@@ -132,6 +176,19 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
    */
 
   iob = iob_tryalloc(throttled);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep freed I/O buffers out of the per-CPU caches while we wait so that
+   * they are handed to us through the committed list.
+   */
+
+  if (iob == NULL)
+    {
+      g_iob_waiters++;
+      iob_cache_flush();
+    }
+#endif
+
   while (ret == OK && iob == NULL)
     {
       /* If not successful, then the semaphore count was less than or equal
@@ -195,8 +252,90 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
               iob = iob_tryalloc(throttled);
             }
         }
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      if (ret != OK || iob != NULL)
+        {
+          g_iob_waiters--;
+        }
+#endif
+    }
+
+  leave_critical_section(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_alloc_large
+ *
+ * Description:
+ *   Take a large I/O buffer from the head of the large free list.  Large
+ *   I/O buffers are never waited for.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static FAR struct iob_s *iob_alloc_large(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  iob   = g_iob_largefree;
+  if (iob != NULL)
+    {
+      g_iob_largefree = iob->io_flink;
     }
 
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Try to allocate an I/O buffer from the free list on behalf of 'user'
+ *   without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_internal(bool throttled, uint8_t user)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = enter_critical_section();
+  iob   = iob_take(throttled, user);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (iob == NULL)
+    {
+      /* The free I/O buffers may be sitting in the per-CPU caches.  Return
+       * them to the free list and try again.
+       */
+
+      iob_cache_flush();
+      iob = iob_take(throttled, user);
+    }
+#endif
+
   leave_critical_section(flags);
   return iob;
 }
@@ -241,10 +380,131 @@ FAR struct iob_s *iob_alloc(bool throttled)
  ****************************************************************************/
 
 FAR struct iob_s *iob_tryalloc(bool throttled)
+{
+  FAR struct iob_s *iob = NULL;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Throttled allocations must be checked against the throttle semaphore
+   * so they always go to the free list.
+   */
+
+  if (!throttled)
+    {
+      iob = iob_cache_alloc();
+    }
+
+  if (iob == NULL)
+#endif
+    {
+      iob = iob_tryalloc_internal(throttled, IOB_USER_NONE);
+    }
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer of the class that best fits 'size' bytes of
+ *   data, waiting for a small I/O buffer if necessary.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_alloc_size(bool throttled, unsigned int size)
+{
+  FAR struct iob_s *iob = NULL;
+
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_alloc_large();
+    }
+
+  return iob != NULL ? iob : iob_alloc(throttled);
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer of the class that best fits 'size' bytes
+ *   of data without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+FAR struct iob_s *iob_tryalloc_size(bool throttled, unsigned int size)
+{
+  FAR struct iob_s *iob = NULL;
+
+  if (size > CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_alloc_large();
+    }
+
+  return iob != NULL ? iob : iob_tryalloc(throttled);
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_user
+ *
+ * Description:
+ *   Try to allocate an I/O buffer on behalf of one of the IOB_USER_* users.
+ *   The allocation fails if it would consume I/O buffers that are reserved
+ *   for the other users.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_RESERVATIONS
+FAR struct iob_s *iob_tryalloc_user(bool throttled, uint8_t user)
 {
   FAR struct iob_s *iob;
-  irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
+
+  DEBUGASSERT(user < IOB_NUSERS);
+
+  iob = iob_tryalloc_internal(throttled, user);
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  return iob;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_take
+ *
+ * Description:
+ *   Remove one I/O buffer from the free list and take its semaphore
+ *   count(s), accounting it to 'user'.  The I/O buffer is not otherwise
+ *   initialized.  NULL is returned if no I/O buffer is available for this
+ *   allocation.  Must be called from within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_take(bool throttled, uint8_t user)
+{
+  FAR struct iob_s *iob;
+#if CONFIG_IOB_THROTTLE > 0 || defined(CONFIG_IOB_RESERVATIONS)
   FAR sem_t *sem;
 #endif
 
@@ -252,62 +512,71 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   /* Select the semaphore count to check. */
 
   sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+#elif defined(CONFIG_IOB_RESERVATIONS)
+  sem = &g_iob_sem;
 #endif
 
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
+#if defined(CONFIG_IOB_RESERVATIONS)
+  /* If there are free I/O buffers for this allocation that are not reserved
+   * for some other user.
    */
 
-  flags = enter_critical_section();
-
-#if CONFIG_IOB_THROTTLE > 0
+  if (sem->semcount <= iob_reserved(user))
+    {
+      return NULL;
+    }
+#elif CONFIG_IOB_THROTTLE > 0
   /* If there are free I/O buffers for this allocation */
 
-  if (sem->semcount > 0)
-#endif
+  if (sem->semcount <= 0)
     {
-      /* Take the I/O buffer from the head of the free list */
+      return NULL;
+    }
+#else
+  UNUSED(user);
+#endif
 
-      iob = g_iob_freelist;
-      if (iob != NULL)
-        {
-          /* Remove the I/O buffer from the free list and decrement the
-           * counting semaphore(s) that tracks the number of available
-           * IOBs.
-           */
+  /* Take the I/O buffer from the head of the free list */
 
-          g_iob_freelist = iob->io_flink;
+  iob = g_iob_freelist;
+  if (iob != NULL)
+    {
+      /* Remove the I/O buffer from the free list and decrement the
+       * counting semaphore(s) that tracks the number of available
+       * IOBs.
+       */
 
-          /* Take a semaphore count.  Note that we cannot do this in
-           * in the orthodox way by calling sem_wait() or sem_trywait()
-           * because this function may be called from an interrupt
-           * handler. Fortunately we know at at least one free buffer
-           * so a simple decrement is all that is needed.
-           */
+      g_iob_freelist = iob->io_flink;
+
+      /* Take a semaphore count.  Note that we cannot do this in
+       * in the orthodox way by calling sem_wait() or sem_trywait()
+       * because this function may be called from an interrupt
+       * handler. Fortunately we know at at least one free buffer
+       * so a simple decrement is all that is needed.
+       */
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+      sem_decrement(&g_iob_sem);
+      DEBUGASSERT(g_iob_sem.semcount >= 0);
 
 #if CONFIG_IOB_THROTTLE > 0
-          /* The throttle semaphore is a little more complicated because
-           * it can be negative!  Decrementing is still safe, however.
-           */
+      /* The throttle semaphore is a little more complicated because
+       * it can be negative!  Decrementing is still safe, however.
+       */
 
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+      sem_decrement(&g_throttle_sem);
+      DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
-          leave_critical_section(flags);
 
-          /* Put the I/O buffer in a known state */
+#ifdef CONFIG_IOB_RESERVATIONS
+      /* Account the I/O buffer to its user */
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
+      iob->io_user = user;
+      if (user != IOB_USER_NONE)
+        {
+          g_iob_inuse[user]++;
         }
+#endif
     }
 
-  leave_critical_section(flags);
-  return NULL;
+  return iob;
 }
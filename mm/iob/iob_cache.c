@@ -0,0 +1,309 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A per-CPU cache of free I/O buffers.  The semaphore counts of the cached
+ * I/O buffers have already been taken so, as far as the rest of the IOB
+ * logic is concerned, they are allocated.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t ic_lock;           /* Protects the cache from iob_cache_flush() */
+  uint16_t ic_count;            /* Number of I/O buffers in the cache */
+  FAR struct iob_s *ic_head;    /* List of cached I/O buffers */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The number of threads waiting in iob_alloc().  The per-CPU caches are
+ * bypassed while this is non-zero.
+ */
+
+volatile int g_iob_waiters;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_release
+ *
+ * Description:
+ *   Return a list of I/O buffers to the free list.
+ *
+ ****************************************************************************/
+
+static void iob_cache_release(FAR struct iob_s *list)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  while (list != NULL)
+    {
+      next = list->io_flink;
+      iob_release(list);
+      list = next;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the free list if it is empty.  The semaphore counts of the
+ *   returned I/O buffer have already been taken.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *list = NULL;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int i;
+
+  /* Take the I/O buffer at the head of this CPU's cache.  Interrupts are
+   * disabled to keep us on this CPU while we hold its cache.
+   */
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  iob = cache->ic_head;
+  if (iob != NULL)
+    {
+      cache->ic_head = iob->io_flink;
+      cache->ic_count--;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  /* Don't refill the cache while some thread is waiting for I/O buffers */
+
+  if (iob != NULL || g_iob_waiters > 0)
+    {
+      return iob;
+    }
+
+  /* The cache is empty.  Take a batch of I/O buffers from the free list */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_IOB_CACHE_BATCH; i++)
+    {
+      iob = iob_take(false, IOB_USER_NONE);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      iob->io_flink = list;
+      list          = iob;
+    }
+
+  leave_critical_section(flags);
+
+  /* Keep the first I/O buffer for this allocation and cache the rest */
+
+  iob = list;
+  if (iob != NULL)
+    {
+      for (list = iob->io_flink; list != NULL; list = next)
+        {
+          next = list->io_flink;
+          if (!iob_cache_free(list))
+            {
+              list->io_flink = NULL;
+              iob_cache_release(list);
+            }
+        }
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Try to free an I/O buffer into the cache of the current CPU.  Returns
+ *   false if the I/O buffer must be returned to the free list instead.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *drain = NULL;
+  FAR struct iob_s *tmp;
+  irqstate_t flags;
+  bool cached = false;
+  int i;
+
+#ifdef CONFIG_IOB_RESERVATIONS
+  /* Accounted I/O buffers must go back through iob_release() */
+
+  if (iob->io_user != IOB_USER_NONE)
+    {
+      return false;
+    }
+#endif
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[up_cpu_index()];
+  spin_lock(&cache->ic_lock);
+
+  /* g_iob_waiters is checked while holding the cache lock so that an I/O
+   * buffer cannot slip into the cache after iob_cache_flush() has emptied
+   * it for a waiting thread.
+   */
+
+  if (g_iob_waiters == 0)
+    {
+      /* If the cache is full, remove a batch of I/O buffers to be returned
+       * to the free list.
+       */
+
+      if (cache->ic_count >= CONFIG_IOB_PERCPU_CACHE)
+        {
+          for (i = 0; i < CONFIG_IOB_CACHE_BATCH; i++)
+            {
+              tmp            = cache->ic_head;
+              cache->ic_head = tmp->io_flink;
+              tmp->io_flink  = drain;
+              drain          = tmp;
+            }
+
+          cache->ic_count -= CONFIG_IOB_CACHE_BATCH;
+        }
+
+      iob->io_flink  = cache->ic_head;
+      cache->ic_head = iob;
+      cache->ic_count++;
+      cached         = true;
+    }
+
+  spin_unlock(&cache->ic_lock);
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      iob_cache_release(drain);
+    }
+
+  return cached;
+}
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return the I/O buffers held in all of the per-CPU caches to the free
+ *   list.
+ *
+ ****************************************************************************/
+
+void iob_cache_flush(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *list;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+
+      flags = up_irq_save();
+      spin_lock(&cache->ic_lock);
+
+      list            = cache->ic_head;
+      cache->ic_head  = NULL;
+      cache->ic_count = 0;
+
+      spin_unlock(&cache->ic_lock);
+      up_irq_restore(flags);
+
+      if (list != NULL)
+        {
+          iob_cache_release(list);
+        }
+    }
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
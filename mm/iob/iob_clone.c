@@ -44,6 +44,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -56,6 +57,69 @@
 #  define MIN(a,b) ((a) < (b) ? (a) : (b))
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_clone_shared
+ *
+ * Description:
+ *   Make the I/O buffers of the iob2 chain reference the data of the iob1
+ *   chain, one for one.  iob1 is the first non-empty I/O buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SHARED
+static int iob_clone_shared(FAR struct iob_s *iob1, FAR struct iob_s *iob2,
+                            bool throttled)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      /* Take a reference on the data of iob1 */
+
+      flags = enter_critical_section();
+      iob1->io_owner->io_refs++;
+      iob2->io_owner = iob1->io_owner;
+      iob2->io_data  = iob1->io_data;
+      leave_critical_section(flags);
+
+      iob2->io_offset = iob1->io_offset;
+      iob2->io_len    = iob1->io_len;
+
+      /* Skip to the next, non-empty source I/O buffer */
+
+      do
+        {
+          iob1 = iob1->io_flink;
+        }
+      while (iob1 != NULL && iob1->io_len <= 0);
+
+      if (iob1 == NULL)
+        {
+          return 0;
+        }
+
+      /* Allocate the next destination I/O buffer and hook it into the
+       * destination I/O buffer chain.
+       */
+
+      next = iob_alloc_clone(throttled);
+      if (next == NULL)
+        {
+          ioberr("ERROR: Failed to allocate an I/O buffer\n");
+          return -ENOMEM;
+        }
+
+      iob2->io_flink = next;
+      iob2 = next;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -70,6 +134,7 @@
 
 int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
 {
+#ifndef CONFIG_IOB_SHARED
   FAR uint8_t *src;
   FAR uint8_t *dest;
   unsigned int ncopy;
@@ -77,6 +142,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
   unsigned int avail2;
   unsigned int offset1;
   unsigned int offset2;
+#endif
 
   DEBUGASSERT(iob2->io_len == 0 && iob2->io_offset == 0 &&
               iob2->io_pktlen == 0 && iob2->io_flink == NULL);
@@ -94,6 +160,11 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
       iob1 = iob1->io_flink;
     }
 
+#ifdef CONFIG_IOB_SHARED
+  /* Share the data rather than copying it */
+
+  return iob_clone_shared(iob1, iob2, throttled);
+#else
   /* Pack each entry from iob1 to iob2 */
 
   offset1 = 0;
@@ -113,7 +184,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
        */
 
       dest   = &iob2->io_data[offset2];
-      avail2 = CONFIG_IOB_BUFSIZE - offset2;
+      avail2 = IOB_BUFSIZE(iob2) - offset2;
 
       /* Copy the smaller of the two and update the srce and destination
        * offsets.
@@ -150,7 +221,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
        * transferred?
        */
 
-       if (offset2 >= CONFIG_IOB_BUFSIZE && iob1 != NULL)
+       if (offset2 >= IOB_BUFSIZE(iob2) && iob1 != NULL)
         {
           FAR struct iob_s *next;
 
@@ -172,4 +243,5 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
     }
 
   return 0;
+#endif
 }
@@ -79,7 +79,7 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
    * then you will need to increase CONFIG_IOB_BUFSIZE.
    */
 
-  DEBUGASSERT(len <= CONFIG_IOB_BUFSIZE);
+  DEBUGASSERT(len <= IOB_BUFSIZE(iob));
 
   /* Check if there is already sufficient, contiguous space at the beginning
    * of the packet
@@ -98,7 +98,14 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
 
   else if (len <= iob->io_pktlen)
     {
-      /* Yes.. First eliminate any leading offset */
+      /* Yes.. The data of the head is about to be modified */
+
+      if (iob_unshare(iob) < 0)
+        {
+          return -ENOMEM;
+        }
+
+      /* First eliminate any leading offset */
 
       if (iob->io_offset > 0)
         {
@@ -141,7 +148,7 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
 
       /* This should always succeed because we know that:
        *
-       *   pktlen >= CONFIG_IOB_BUFSIZE >= len
+       *   pktlen >= IOB_BUFSIZE(iob) >= len
        */
 
       return 0;
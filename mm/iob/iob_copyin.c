@@ -114,6 +114,16 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
   while (len > 0)
     {
+#ifdef CONFIG_IOB_SHARED
+      /* Copy the data of this I/O buffer first if it is shared */
+
+      int ret = iob_unshare(iob);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+
       next = iob->io_flink;
 
       /* Get the destination I/O buffer address and the amount of data
@@ -148,7 +158,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
               /* Yes.. We can extend this buffer to the up to the very end. */
 
-              maxlen = CONFIG_IOB_BUFSIZE - iob->io_offset;
+              maxlen = IOB_BUFSIZE(iob) - iob->io_offset;
 
               /* This is the new buffer length that we need.  Of course,
                * clipped to the maximum possible size in this buffer.
@@ -202,13 +212,24 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
            * any already don't block, otherwise block if we're allowed.
            */
 
+#ifdef CONFIG_IOB_RESERVATIONS
+          /* Buffers added to an accounted chain are accounted to the same
+           * user and never wait.
+           */
+
+          if (head->io_user != IOB_USER_NONE)
+            {
+              next = iob_tryalloc_user(throttled, head->io_user);
+            }
+          else
+#endif
           if (!can_block || len < total)
             {
-              next = iob_tryalloc(throttled);
+              next = iob_tryalloc_size(throttled, len);
             }
           else
             {
-              next = iob_alloc(throttled);
+              next = iob_alloc_size(throttled, len);
             }
 
           if (next == NULL)
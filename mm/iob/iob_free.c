@@ -65,7 +65,11 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
+#ifdef CONFIG_IOB_SHARED
+  FAR struct iob_s *owner = NULL;
   irqstate_t flags;
+  bool release;
+#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -101,6 +105,104 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
               next, next->io_pktlen, next->io_len);
     }
 
+#ifdef CONFIG_IOB_SHARED
+  /* Drop the reference that this I/O buffer holds on the data of some other
+   * I/O buffer, then the reference on the I/O buffer itself.  The I/O
+   * buffer is not returned to the pool while other I/O buffers still share
+   * its data.
+   */
+
+  flags = enter_critical_section();
+
+  if (iob->io_owner != iob)
+    {
+      owner = iob->io_owner;
+      DEBUGASSERT(owner->io_refs > 0);
+
+      if (--owner->io_refs > 0)
+        {
+          owner = NULL;
+        }
+
+      iob->io_owner = iob;
+    }
+
+  if (iob->io_refs == 0)
+    {
+      /* This is one of the clone heads; it has no data of its own */
+
+#if CONFIG_IOB_NCLONES > 0
+      iob->io_flink   = g_iob_clonefree;
+      g_iob_clonefree = iob;
+#endif
+      release = false;
+    }
+  else
+    {
+      iob->io_data = IOB_OWNDATA(iob);
+      release      = (--iob->io_refs == 0);
+    }
+
+  leave_critical_section(flags);
+
+  if (owner != NULL)
+    {
+      iob_free_pool(owner);
+    }
+
+  if (release)
+    {
+      iob_free_pool(iob);
+    }
+#else
+  iob_free_pool(iob);
+#endif
+
+  /* And return the I/O buffer after the one that was freed */
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return an unreferenced I/O buffer to the pool that it came from.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+#ifdef CONFIG_IOB_SHARED
+  /* A free I/O buffer holds the one reference that its next user gets */
+
+  iob->io_refs = 1;
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  /* Large I/O buffers go back to their own free list */
+
+  if (IOB_BUFSIZE(iob) > CONFIG_IOB_BUFSIZE)
+    {
+      flags = enter_critical_section();
+      iob->io_flink   = g_iob_largefree;
+      g_iob_largefree = iob;
+      leave_critical_section(flags);
+      return;
+    }
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Try to keep the I/O buffer in the cache of this CPU */
+
+  if (iob_cache_free(iob))
+    {
+      return;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -108,6 +210,32 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
    */
 
   flags = enter_critical_section();
+  iob_release(iob);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one I/O buffer to the free list (or to the committed list if a
+ *   thread is waiting for it) and give back its semaphore count(s).  Must
+ *   be called from within a critical section.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob)
+{
+#ifdef CONFIG_IOB_RESERVATIONS
+  /* Remove the I/O buffer from its user's account */
+
+  if (iob->io_user != IOB_USER_NONE)
+    {
+      DEBUGASSERT(g_iob_inuse[iob->io_user] > 0);
+      g_iob_inuse[iob->io_user]--;
+      iob->io_user = IOB_USER_NONE;
+    }
+#endif
 
   /* Which list?  If there is a task waiting for an IOB, then put
    * the IOB on either the free list or on the committed list where
@@ -136,9 +264,4 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 #if CONFIG_IOB_THROTTLE > 0
   sem_post(&g_throttle_sem);
 #endif
-  leave_critical_section(flags);
-
-  /* And return the I/O buffer after the one that was freed */
-
-  return next;
 }
@@ -41,7 +41,9 @@
 
 #include <stdbool.h>
 #include <semaphore.h>
+#include <assert.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -55,12 +57,56 @@
 #endif
 
 /****************************************************************************
- * Private Data
+ * Private Types
  ****************************************************************************/
 
-/* This is a pool of pre-allocated I/O buffers */
+#ifdef CONFIG_IOB_SHARED
+/* An I/O buffer followed by the data that it owns */
+
+struct iob_buffer_s
+{
+  struct iob_s iob;
+  uint8_t      data[CONFIG_IOB_BUFSIZE];
+};
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A large I/O buffer:  The extra space extends io_data[] */
+
+struct iob_large_s
+{
+  struct iob_s iob;
+#ifdef CONFIG_IOB_SHARED
+  uint8_t      data[CONFIG_IOB_LARGE_BUFSIZE];
+#else
+  uint8_t      extra[CONFIG_IOB_LARGE_BUFSIZE - CONFIG_IOB_BUFSIZE];
+#endif
+};
+#endif
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is a pool of pre-allocated I/O buffers.  With CONFIG_IOB_FASTMEM,
+ * the pool is allocated from fast memory by iob_initialize().
+ */
+
+#if defined(CONFIG_IOB_FASTMEM) && defined(CONFIG_IOB_SHARED)
+static FAR struct iob_buffer_s *g_iob_pool;
+#elif defined(CONFIG_IOB_FASTMEM)
+static FAR struct iob_s        *g_iob_pool;
+#elif defined(CONFIG_IOB_SHARED)
+static struct iob_buffer_s g_iob_pool[CONFIG_IOB_NBUFFERS];
+#else
 static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
+#endif
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static struct iob_large_s  g_iob_largepool[CONFIG_IOB_LARGE_NBUFFERS];
+#endif
+#if defined(CONFIG_IOB_SHARED) && CONFIG_IOB_NCLONES > 0
+static struct iob_s        g_iob_clonepool[CONFIG_IOB_NCLONES];
+#endif
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
@@ -77,6 +123,18 @@ FAR struct iob_s *g_iob_freelist;
 
 FAR struct iob_s *g_iob_committed;
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+/* A list of all free, unallocated large I/O buffers */
+
+FAR struct iob_s *g_iob_largefree;
+#endif
+
+#if defined(CONFIG_IOB_SHARED) && CONFIG_IOB_NCLONES > 0
+/* A list of all free I/O buffer clone heads (I/O buffers without data) */
+
+FAR struct iob_s *g_iob_clonefree;
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -97,6 +155,12 @@ sem_t g_throttle_sem;       /* Counts available I/O buffers when throttled */
 sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_RESERVATIONS
+/* The number of accounted I/O buffers held by each IOB_USER_* user */
+
+uint16_t g_iob_inuse[IOB_NUSERS];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -118,20 +182,73 @@ void iob_initialize(void)
 
   if (!initialized)
     {
+#ifdef CONFIG_IOB_FASTMEM
+      /* Allocate the I/O buffers, preferably from fast memory */
+
+      g_iob_pool = kmm_malloc_hint(CONFIG_IOB_NBUFFERS * sizeof(*g_iob_pool),
+                                   MM_PLACE_FAST);
+      DEBUGASSERT(g_iob_pool != NULL);
+#endif
+
       /* Add each I/O buffer to the free list */
 
       for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
         {
+#ifdef CONFIG_IOB_SHARED
+          FAR struct iob_s *iob = &g_iob_pool[i].iob;
+
+          /* The I/O buffer owns the data that follows it */
+
+          iob->io_refs   = 1;
+          iob->io_owner  = iob;
+          iob->io_data   = IOB_OWNDATA(iob);
+#else
           FAR struct iob_s *iob = &g_iob_pool[i];
+#endif
 
           /* Add the pre-allocate I/O buffer to the head of the free list */
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+          iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+#endif
           iob->io_flink  = g_iob_freelist;
           g_iob_freelist = iob;
         }
 
       g_iob_committed = NULL;
 
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+      /* Add each large I/O buffer to the large free list */
+
+      for (i = 0; i < CONFIG_IOB_LARGE_NBUFFERS; i++)
+        {
+          FAR struct iob_s *iob = &g_iob_largepool[i].iob;
+
+#ifdef CONFIG_IOB_SHARED
+          iob->io_refs    = 1;
+          iob->io_owner   = iob;
+          iob->io_data    = IOB_OWNDATA(iob);
+#endif
+          iob->io_bufsize = CONFIG_IOB_LARGE_BUFSIZE;
+          iob->io_flink   = g_iob_largefree;
+          g_iob_largefree = iob;
+        }
+#endif
+
+#if defined(CONFIG_IOB_SHARED) && CONFIG_IOB_NCLONES > 0
+      /* Add each clone head to the clone free list.  Clone heads have no
+       * data of their own and so never hold a reference (io_refs == 0).
+       */
+
+      for (i = 0; i < CONFIG_IOB_NCLONES; i++)
+        {
+          FAR struct iob_s *iob = &g_iob_clonepool[i];
+
+          iob->io_flink   = g_iob_clonefree;
+          g_iob_clonefree = iob;
+        }
+#endif
+
       sem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
 #if CONFIG_IOB_THROTTLE > 0
       sem_init(&g_throttle_sem, 0, CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE);
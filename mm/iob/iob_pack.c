@@ -91,6 +91,13 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
     {
       next = iob->io_flink;
 
+      /* The data of this entry is about to be modified */
+
+      if (iob_unshare(iob) < 0)
+        {
+          break;
+        }
+
       /* Eliminate the data offset in this entry */
 
       if (iob->io_offset > 0)
@@ -109,7 +116,7 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
            */
 
           ncopy  = next->io_len;
-          navail = CONFIG_IOB_BUFSIZE - iob->io_len;
+          navail = IOB_BUFSIZE(iob) - iob->io_len;
           if (ncopy > navail)
             {
               ncopy = navail;
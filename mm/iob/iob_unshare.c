@@ -0,0 +1,186 @@
+/****************************************************************************
+ * mm/iob/iob_unshare.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_SHARED
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_alloc_clone
+ *
+ * Description:
+ *   Allocate an I/O buffer that will reference the data of another I/O
+ *   buffer, preferably one of the data-less clone heads.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_clone(bool throttled)
+{
+#if CONFIG_IOB_NCLONES > 0
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  iob   = g_iob_clonefree;
+  if (iob != NULL)
+    {
+      g_iob_clonefree = iob->io_flink;
+    }
+
+  leave_critical_section(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      return iob;
+    }
+#endif
+
+  /* Use an ordinary I/O buffer.  Its own data will go unused. */
+
+  return iob_alloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_unshare
+ *
+ * Description:
+ *   Make sure that the data of the I/O buffer is not shared with any other
+ *   I/O buffer, copying it if necessary, so that it may be modified.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the data could not be copied.
+ *
+ ****************************************************************************/
+
+int iob_unshare(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *owner;
+  FAR struct iob_s *copy;
+  irqstate_t flags;
+  bool shared;
+
+  flags  = enter_critical_section();
+  shared = (iob->io_owner != iob || iob->io_refs > 1);
+  leave_critical_section(flags);
+
+  if (!shared)
+    {
+      return OK;
+    }
+
+  /* Copy the data to a new I/O buffer at the same offset so that any space
+   * before the data remains available.
+   */
+
+  copy = iob_tryalloc_size(false, IOB_BUFSIZE(iob));
+  if (copy == NULL)
+    {
+      ioberr("ERROR: Failed to allocate an I/O buffer\n");
+      return -ENOMEM;
+    }
+
+  if (iob->io_offset + iob->io_len > IOB_BUFSIZE(copy))
+    {
+      ioberr("ERROR: Only a smaller I/O buffer is available\n");
+      iob_free(copy);
+      return -ENOMEM;
+    }
+
+  memcpy(&copy->io_data[iob->io_offset], &iob->io_data[iob->io_offset],
+         iob->io_len);
+
+  /* Then move the reference on the shared data to the copy.  The reference
+   * that the copy was allocated with now belongs to this I/O buffer.
+   */
+
+  flags         = enter_critical_section();
+  owner         = iob->io_owner;
+  iob->io_owner = copy;
+  iob->io_data  = copy->io_data;
+
+  if (owner != iob)
+    {
+      DEBUGASSERT(owner->io_refs > 0);
+      if (--owner->io_refs > 0)
+        {
+          owner = NULL;
+        }
+    }
+  else
+    {
+      /* The data of this I/O buffer is still shared with others.  The
+       * reference of this I/O buffer itself keeps it allocated until they
+       * are done with it.
+       */
+
+      owner = NULL;
+    }
+
+  leave_critical_section(flags);
+
+  if (owner != NULL)
+    {
+      iob_free_pool(owner);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_IOB_SHARED */
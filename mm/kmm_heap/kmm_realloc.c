@@ -64,7 +64,8 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
-  return mm_realloc(&g_kmmheap, oldmem, newsize);
+  return mm_tag(&g_kmmheap, mm_realloc(&g_kmmheap, oldmem, newsize),
+                newsize, MM_CALLER());
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -0,0 +1,329 @@
+/****************************************************************************
+ * mm/mempool/mempool.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+/* Memory pools are a kernel facility; they are never built into the user-
+ * space half of the protected build.
+ */
+
+#if defined(CONFIG_MM_MEMPOOL) && \
+   (!defined(CONFIG_BUILD_PROTECTED) || defined(__KERNEL__))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* A list of all initialized pools */
+
+static sq_queue_t g_mempools;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_addblocks
+ *
+ * Description:
+ *   Add 'nblocks' contiguous blocks beginning at 'base' to the free list
+ *   of the pool.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void mempool_addblocks(FAR struct mempool_s *pool, FAR char *base,
+                              uint16_t nblocks)
+{
+  uint16_t i;
+
+  for (i = 0; i < nblocks; i++, base += pool->bsize)
+    {
+      sq_addfirst((FAR sq_entry_t *)base, &pool->freelist);
+    }
+
+  pool->ntotal += nblocks;
+}
+
+/****************************************************************************
+ * Name: mempool_expand
+ *
+ * Description:
+ *   Try to add more blocks to the pool from the kernel heap.
+ *
+ * Returned Value:
+ *   true if blocks were added.
+ *
+ ****************************************************************************/
+
+static bool mempool_expand(FAR struct mempool_s *pool)
+{
+  FAR char *base;
+  irqstate_t flags;
+  uint16_t nblocks;
+
+  /* The heap cannot be used from interrupt handlers */
+
+  if (pool->nexpand == 0 || up_interrupt_context())
+    {
+      return false;
+    }
+
+  nblocks = pool->nexpand;
+  if (pool->nmax > 0)
+    {
+      if (pool->ntotal >= pool->nmax)
+        {
+          return false;
+        }
+
+      if (pool->ntotal + nblocks > pool->nmax)
+        {
+          nblocks = pool->nmax - pool->ntotal;
+        }
+    }
+
+  base = (FAR char *)kmm_malloc(nblocks * pool->bsize);
+  if (base == NULL)
+    {
+      return false;
+    }
+
+  /* The expansion memory is never returned to the heap */
+
+  flags = enter_critical_section();
+  mempool_addblocks(pool, base, nblocks);
+  leave_critical_section(flags);
+
+  minfo("%s: Expanded by %u to %u blocks\n",
+        pool->name, nblocks, pool->ntotal);
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Initialize a pool of fixed-size blocks.
+ *
+ * Input Parameters:
+ *   pool     - The pool structure to be initialized.
+ *   name     - The name of the pool (used only for procfs)
+ *   bsize    - The size of one block.
+ *   storage  - Static storage for the initial blocks or NULL
+ *   ninitial - The initial number of blocks.
+ *   nexpand  - The number of blocks to add when the pool is exhausted.
+ *   nmax     - The maximum number of blocks (zero: no limit).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, FAR const char *name,
+                       size_t bsize, FAR void *storage, uint16_t ninitial,
+                       uint16_t nexpand, uint16_t nmax)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && bsize > 0);
+  DEBUGASSERT(nmax == 0 || ninitial <= nmax);
+
+  sq_init(&pool->freelist);
+  pool->name    = name;
+  pool->bsize   = MEMPOOL_BSIZE(bsize);
+  pool->nexpand = nexpand;
+  pool->nmax    = nmax;
+  pool->ntotal  = 0;
+  pool->nused   = 0;
+  pool->nhwm    = 0;
+  pool->nfail   = 0;
+
+  /* Allocate the initial blocks from the heap if no storage was provided */
+
+  if (storage == NULL && ninitial > 0)
+    {
+      storage = kmm_malloc(ninitial * pool->bsize);
+      if (storage == NULL)
+        {
+          merr("ERROR: %s: Failed to allocate %u blocks\n", name, ninitial);
+          return -ENOMEM;
+        }
+    }
+
+  flags = enter_critical_section();
+  if (ninitial > 0)
+    {
+      mempool_addblocks(pool, (FAR char *)storage, ninitial);
+    }
+
+  sq_addlast(&pool->flink, &g_mempools);
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the pool, expanding the pool if necessary and
+ *   possible.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL);
+
+  do
+    {
+      flags = enter_critical_section();
+      blk   = sq_remfirst(&pool->freelist);
+      if (blk != NULL)
+        {
+          if (++pool->nused > pool->nhwm)
+            {
+              pool->nhwm = pool->nused;
+            }
+
+          leave_critical_section(flags);
+          return blk;
+        }
+
+      leave_critical_section(flags);
+    }
+  while (mempool_expand(pool));
+
+  flags = enter_critical_section();
+  pool->nfail++;
+  leave_critical_section(flags);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the pool.
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && blk != NULL && pool->nused > 0);
+
+  flags = enter_critical_section();
+  sq_addfirst((FAR sq_entry_t *)blk, &pool->freelist);
+  pool->nused--;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return a snapshot of the statistics of one pool.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && info != NULL);
+
+  flags        = enter_critical_section();
+  info->name   = pool->name;
+  info->bsize  = pool->bsize;
+  info->ntotal = pool->ntotal;
+  info->nused  = pool->nused;
+  info->nhwm   = pool->nhwm;
+  info->nfail  = pool->nfail;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call the handler with the statistics of each initialized pool.  Pools
+ *   are never uninitialized so the list may be traversed without locking
+ *   once the head has been sampled.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg)
+{
+  FAR sq_entry_t *entry;
+  struct mempoolinfo_s info;
+
+  DEBUGASSERT(handler != NULL);
+
+  for (entry = sq_peek(&g_mempools); entry != NULL; entry = sq_next(entry))
+    {
+      mempool_info((FAR struct mempool_s *)entry, &info);
+      handler(&info, arg);
+    }
+}
+
+#endif /* CONFIG_MM_MEMPOOL && (!CONFIG_BUILD_PROTECTED || __KERNEL__) */
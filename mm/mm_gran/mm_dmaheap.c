@@ -0,0 +1,254 @@
+/****************************************************************************
+ * mm/mm_gran/mm_dmaheap.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/gran.h>
+#include <nuttx/mm/dmaheap.h>
+
+#ifdef CONFIG_MM_DMAHEAP
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One region of the DMA heap */
+
+struct dmaheap_region_s
+{
+  GRAN_HANDLE handle;           /* The granule allocator for the region */
+  uintptr_t start;              /* First address of the region */
+  uintptr_t end;                /* Address following the region */
+  uint32_t attr;                /* DMAHEAP_* attributes */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dmaheap_region_s g_dmaheap[CONFIG_MM_DMAHEAP_NREGIONS];
+static int g_dmaheap_nregions;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmaheap_region
+ *
+ * Description:
+ *   Return the region that contains 'mem' or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct dmaheap_region_s *dmaheap_region(FAR const void *mem)
+{
+  uintptr_t addr = (uintptr_t)mem;
+  int i;
+
+  for (i = 0; i < g_dmaheap_nregions; i++)
+    {
+      if (addr >= g_dmaheap[i].start && addr < g_dmaheap[i].end)
+        {
+          return &g_dmaheap[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dmaheap_addregion
+ *
+ * Description:
+ *   Add a region of memory to the DMA heap.  This is normally called by
+ *   board initialization logic for memory that it has set aside (and, for
+ *   example, configured as non-cacheable in the MPU) for DMA.
+ *
+ * Input Parameters:
+ *   start    - The start of the region.
+ *   size     - The size of the region in bytes.
+ *   log2gran - Log2 of the granule size of the region.  Allocations are
+ *              made in whole granules.  This must be at least
+ *              CONFIG_MM_DMAHEAP_LOG2ALIGN.
+ *   attr     - The DMAHEAP_* attributes of the region.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dmaheap_addregion(FAR void *start, size_t size, uint8_t log2gran,
+                      uint32_t attr)
+{
+  FAR struct dmaheap_region_s *region;
+  GRAN_HANDLE handle;
+  irqstate_t flags;
+
+  if (log2gran < CONFIG_MM_DMAHEAP_LOG2ALIGN)
+    {
+      return -EINVAL;
+    }
+
+  if (g_dmaheap_nregions >= CONFIG_MM_DMAHEAP_NREGIONS)
+    {
+      merr("ERROR: Too many DMA heap regions\n");
+      return -ENOSPC;
+    }
+
+  handle = gran_initialize(start, size, log2gran,
+                           CONFIG_MM_DMAHEAP_LOG2ALIGN);
+  if (handle == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flags = enter_critical_section();
+  if (g_dmaheap_nregions >= CONFIG_MM_DMAHEAP_NREGIONS)
+    {
+      leave_critical_section(flags);
+      gran_release(handle);
+      return -ENOSPC;
+    }
+
+  region         = &g_dmaheap[g_dmaheap_nregions];
+  region->handle = handle;
+  region->start  = (uintptr_t)start;
+  region->end    = (uintptr_t)start + size;
+  region->attr   = attr;
+
+  g_dmaheap_nregions++;
+  leave_critical_section(flags);
+
+  minfo("DMA heap region %p size %lu attr %08lx\n",
+        start, (unsigned long)size, (unsigned long)attr);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dmaheap_alloc
+ *
+ * Description:
+ *   Allocate a DMA buffer of at least 'size' bytes from the first region
+ *   (in the order that they were added) that has all of the attributes in
+ *   'attr'.  The buffer is aligned to DMAHEAP_ALIGN and does not share a
+ *   granule with any other allocation.
+ *
+ * Returned Value:
+ *   The allocated buffer or NULL if no region could satisfy the request.
+ *
+ ****************************************************************************/
+
+FAR void *dmaheap_alloc(size_t size, uint32_t attr)
+{
+  FAR struct dmaheap_region_s *region;
+  FAR void *mem;
+  int i;
+
+  for (i = 0; i < g_dmaheap_nregions; i++)
+    {
+      region = &g_dmaheap[i];
+      if ((region->attr & attr) == attr)
+        {
+          mem = gran_alloc(region->handle, size);
+          if (mem != NULL)
+            {
+              return mem;
+            }
+        }
+    }
+
+  mwarn("WARNING: No DMA memory for %lu bytes attr %08lx\n",
+        (unsigned long)size, (unsigned long)attr);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: dmaheap_free
+ *
+ * Description:
+ *   Free a DMA buffer previously allocated by dmaheap_alloc().  'size' must
+ *   be the size that was passed to dmaheap_alloc().
+ *
+ ****************************************************************************/
+
+void dmaheap_free(FAR void *mem, size_t size)
+{
+  FAR struct dmaheap_region_s *region;
+
+  if (mem != NULL)
+    {
+      region = dmaheap_region(mem);
+      DEBUGASSERT(region != NULL);
+
+      if (region != NULL)
+        {
+          gran_free(region->handle, mem, size);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: dmaheap_attributes
+ *
+ * Description:
+ *   Return the attributes of the region containing 'mem' so that, for
+ *   example, a driver can skip cache maintenance for non-cacheable buffers.
+ *   Zero is returned if 'mem' is not in the DMA heap.
+ *
+ ****************************************************************************/
+
+uint32_t dmaheap_attributes(FAR const void *mem)
+{
+  FAR struct dmaheap_region_s *region = dmaheap_region(mem);
+  return region != NULL ? region->attr : 0;
+}
+
+#endif /* CONFIG_MM_DMAHEAP */
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <strings.h>
 #include <semaphore.h>
 
 #include <arch/types.h>
@@ -59,6 +60,20 @@
 #define SIZEOF_GRAN_S(n) \
   (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
 
+/* Count trailing and leading zero bits of a non-zero GAT entry */
+
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+#  define GRAN_CTZ(v)  __builtin_ctz(v)
+#else
+#  define GRAN_CTZ(v)  (ffs((int)(v)) - 1)
+#endif
+
+#ifdef CONFIG_HAVE_BUILTIN_CLZ
+#  define GRAN_CLZ(v)  __builtin_clz(v)
+#else
+#  define GRAN_CLZ(v)  (32 - fls((int)(v)))
+#endif
+
 /* Debug */
 
 #ifdef CONFIG_CPP_HAVE_VARARGS
@@ -93,6 +108,7 @@ struct gran_s
 {
   uint8_t    log2gran;  /* Log base 2 of the size of one granule */
   uint16_t   ngranules; /* The total number of (aligned) granules in the heap */
+  uint16_t   hint;      /* All granules below this one are allocated */
 #ifdef CONFIG_GRAN_INTR
   irqstate_t irqstate;  /* For exclusive access to the GAT */
 #else
@@ -57,6 +57,14 @@
  * Description:
  *   Allocate memory from the granule heap.
  *
+ *   The granule allocation table (GAT) is searched one 32-bit entry at a
+ *   time, starting with the entry that holds the lowest granule that may be
+ *   free.  A run of free granules that spans entries is built up from the
+ *   free granules at the top of one entry (counted with CLZ), whole free
+ *   entries, and the free granules at the bottom of the next entry (counted
+ *   with CTZ).  Runs within a single entry are found by folding the free bit
+ *   mask onto itself.
+ *
  * Input Parameters:
  *   priv - The granule heap state structure.
  *   size - The size of the memory region to allocate.
@@ -69,183 +77,133 @@
 static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
 {
   unsigned int ngranules;
+  unsigned int nentries;
+  unsigned int gatidx;
+  unsigned int granno;
+  unsigned int start = 0;
+  unsigned int run   = 0;
+  unsigned int avail;
+  unsigned int width;
+  unsigned int shift;
   size_t       tmpmask;
-  uintptr_t    alloc;
   uint32_t     curr;
-  uint32_t     next;
   uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
 
-  DEBUGASSERT(priv && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv);
 
   if (priv && size > 0)
     {
-      /* Get exclusive access to the GAT */
-
-      gran_enter_critical(priv);
-
       /* How many contiguous granules we we need to find? */
 
       tmpmask   = (1 << priv->log2gran) - 1;
       ngranules = (size + tmpmask) >> priv->log2gran;
 
-      /* Then create mask for that number of granules */
-
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
+      if (ngranules > priv->ngranules)
+        {
+          return NULL;
+        }
 
-      /* Now search the granule allocation table for that number of contiguous */
+      /* Get exclusive access to the GAT */
 
-      alloc = priv->heapstart;
+      gran_enter_critical(priv);
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      nentries = SIZEOF_GAT(priv->ngranules);
+      for (gatidx = priv->hint >> 5; gatidx < nentries; gatidx++)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
           curr = priv->gat[gatidx];
 
-          /* Handle the case where there are no free granules in the entry */
+          /* Granules beyond the end of the heap are never free */
 
-          if (curr == 0xffffffff)
+          avail = priv->ngranules - (gatidx << 5);
+          if (avail < 32)
             {
-              alloc += (32 << priv->log2gran);
-              continue;
+              curr |= 0xffffffff << avail;
             }
 
-          /* Get the next entry from the GAT to support a 64 bit shift */
+          /* Skip over entries with no free granules */
 
-          if (granidx < priv->ngranules)
+          if (curr == 0xffffffff)
             {
-              next = priv->gat[gatidx + 1];
+              run = 0;
+              continue;
             }
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
+          /* Can the run of free granules that ended the previous entries
+           * be completed with the free granules at the bottom of this one?
            */
 
-          else
+          if (run == 0)
             {
-              next = 0xffffffff;
+              start = gatidx << 5;
             }
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          for (bitidx = 0;
-               bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
+          avail = (curr == 0) ? 32 : GRAN_CTZ(curr);
+          if (run + avail >= ngranules)
             {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
+              granno = start;
+              goto found;
+            }
 
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
+          if (curr == 0)
+            {
+              run += 32;
+              continue;
+            }
 
-                  shift = 8;
-                }
+          /* Look for a run of free granules within this entry.  After
+           * folding, bit n of 'mask' is set if granules n through
+           * n + width - 1 are all free.
+           */
 
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
+          if (ngranules < 32)
+            {
+              mask  = ~curr;
+              width = 1;
 
-              else if ((curr & 0x00000f) == 0x0000000f)
+              while (width < ngranules && mask != 0)
                 {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
+                  shift  = ngranules - width;
+                  shift  = shift < width ? shift : width;
+                  mask  &= mask >> shift;
+                  width += shift;
                 }
 
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
+              if (mask != 0)
                 {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
+                  granno = (gatidx << 5) + GRAN_CTZ(mask);
+                  goto found;
                 }
+            }
 
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Check if we have the allocation at this bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
+          /* Start a new run with the free granules at the top of this
+           * entry.
+           */
 
-                  /* And return the allocation address */
+          run   = GRAN_CLZ(curr);
+          start = (gatidx << 5) + 32 - run;
+        }
 
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
+      gran_leave_critical(priv);
+    }
 
-              /* The free allocation does not start at this position */
+  return NULL;
 
-              else
-                {
-                  shift = 1;
-                }
+found:
 
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position andi ncrement
-               * to the next candidate allocation address.
-               */
+  /* Mark the granules allocated and advance the hint past them if they
+   * were the lowest free granules.
+   */
 
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
-        }
+  gran_mark_allocated(priv, priv->heapstart + (granno << priv->log2gran),
+                      ngranules);
 
-      gran_leave_critical(priv);
+  if (granno == priv->hint)
+    {
+      priv->hint = granno + ngranules;
     }
 
-  return NULL;
+  gran_leave_critical(priv);
+  return (FAR void *)(priv->heapstart + (granno << priv->log2gran));
 }
 
 /****************************************************************************
@@ -258,10 +216,6 @@ static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
  *   size   - The size of the memory region to allocate.
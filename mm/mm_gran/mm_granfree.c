@@ -77,7 +77,7 @@ static inline void gran_common_free(FAR struct gran_s *priv,
   unsigned int avail;
   uint32_t     gatmask;
 
-  DEBUGASSERT(priv && memory && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv && memory);
 
   /* Get exclusive access to the GAT */
 
@@ -99,38 +99,39 @@ static inline void gran_common_free(FAR struct gran_s *priv,
   granmask =  (1 << priv->log2gran) - 1;
   ngranules = (size + granmask) >> priv->log2gran;
 
-  /* Clear bits in the GAT entry or entries */
+  /* Clear bits in each GAT entry spanned by the allocation */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Clear bits in the first GAT entry */
+      avail = 32 - gatbit;
+      if (ngranules < avail)
+        {
+          /* The allocation ends in this entry */
+
+          gatmask   = 0xffffffff >> (32 - ngranules);
+          gatmask <<= gatbit;
+          avail     = ngranules;
+        }
+      else
+        {
+          /* The allocation extends to the end of this entry */
+
+          gatmask = 0xffffffff << gatbit;
+        }
 
-      gatmask = (0xffffffff << gatbit);
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
-
       priv->gat[gatidx] &= ~gatmask;
-      ngranules -= avail;
-
-      /* Clear bits in the second GAT entry */
 
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == gatmask);
-
-      priv->gat[gatidx+1] &= ~gatmask;
+      ngranules -= avail;
+      gatidx++;
+      gatbit     = 0;
     }
 
-  /* Handle the case where where all of the granules came from one entry */
+  /* These may now be the lowest free granules */
 
-  else
+  if (granno < priv->hint)
     {
-      /* Clear bits in a single GAT entry */
-
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
-
-      priv->gat[gatidx] &= ~gatmask;
+      priv->hint = granno;
     }
 
   gran_leave_critical(priv);
@@ -85,39 +85,32 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
   gatidx = granno >> 5;
   gatbit = granno & 31;
 
-  /* Mark bits in the GAT entry or entries */
+  /* Mark bits in each GAT entry spanned by the allocation */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Mark bits in the first GAT entry */
+      avail = 32 - gatbit;
+      if (ngranules < avail)
+        {
+          /* The allocation ends in this entry */
+
+          gatmask   = 0xffffffff >> (32 - ngranules);
+          gatmask <<= gatbit;
+          avail     = ngranules;
+        }
+      else
+        {
+          /* The allocation extends to the end of this entry */
+
+          gatmask = 0xffffffff << gatbit;
+        }
 
-      gatmask = 0xffffffff << gatbit;
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
       priv->gat[gatidx] |= gatmask;
-      ngranules -= avail;
-
-      /* Mark bits in the second GAT entry */
-
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == 0);
-
-      priv->gat[gatidx+1] |= gatmask;
-    }
-
-  /* Handle the case where where all of the granules come from one entry */
 
-  else
-    {
-      /* Mark bits in a single GAT entry */
-
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
-      priv->gat[gatidx] |= gatmask;
-      return;
+      ngranules -= avail;
+      gatidx++;
+      gatbit     = 0;
     }
 }
 
@@ -59,6 +59,21 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
   FAR struct mm_freenode_s *next;
   FAR struct mm_freenode_s *prev;
 
+#ifdef CONFIG_MM_SEGFIT
+  /* Convert the size to a bin index.  Bins are not sorted; the new node is
+   * simply added at the head of its bin.
+   */
+
+  int bin = mm_size2bin(node->size);
+  int fl  = bin / MM_NSLBINS;
+
+  prev = &heap->mm_nodelist[bin];
+  next = prev->flink;
+
+  heap->mm_flbitmap     |= (uint32_t)1 << fl;
+  heap->mm_slbitmap[fl] |= (uint32_t)1 << (bin - fl * MM_NSLBINS);
+
+#else
   /* Convert the size to a nodelist index */
 
   int ndx = mm_size2ndx(node->size);
@@ -68,6 +83,7 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
   for (prev = &heap->mm_nodelist[ndx], next = heap->mm_nodelist[ndx].flink;
        next && next->size && next->size < node->size;
        prev = next, next = next->flink);
+#endif
 
   /* Does it go in mid next or at the end? */
 
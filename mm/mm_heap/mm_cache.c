@@ -0,0 +1,324 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_refill
+ *
+ * Description:
+ *   Allocate a batch of chunks of size class 'ndx' from the heap free
+ *   lists.  One chunk is returned to the caller; the remainder are placed
+ *   in the magazine of the current CPU.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_cache_refill(FAR struct mm_heap_s *heap, int ndx)
+{
+  FAR struct mm_cachemag_s *mag;
+  FAR void *batch[MM_CACHE_BATCH + 1];
+  irqstate_t flags;
+  size_t size;
+  int nalloc;
+  int i;
+
+  /* Request a user size that results in a chunk of exactly the class
+   * size.
+   */
+
+  size = (MM_MIN_CHUNK << ndx) - SIZEOF_MM_ALLOCNODE;
+
+  /* Holding the semaphore causes mm_malloc() and mm_free() to bypass the
+   * cache and operate directly on the free lists.
+   */
+
+  mm_takesemaphore(heap);
+
+  for (nalloc = 0; nalloc <= MM_CACHE_BATCH; nalloc++)
+    {
+      batch[nalloc] = mm_malloc(heap, size);
+      if (batch[nalloc] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (nalloc > 1)
+    {
+      /* We may have been moved to a different CPU while waiting for the
+       * semaphore.  So stock whatever magazine we are on now and return
+       * anything that does not fit.
+       */
+
+      flags = up_irq_save();
+      mag   = &heap->mm_cache[up_cpu_index()].mag[ndx];
+
+      for (i = 1; i < nalloc && mag->count < CONFIG_MM_CACHE_DEPTH; i++)
+        {
+          mag->chunk[mag->count++] = mm_tag(heap, batch[i], 0, NULL);
+        }
+
+      up_irq_restore(flags);
+
+      for (; i < nalloc; i++)
+        {
+          mm_free(heap, batch[i]);
+        }
+    }
+
+  mm_givesemaphore(heap);
+  return nalloc > 0 ? batch[0] : NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_initialize
+ *
+ * Description:
+ *   Initialize the (empty) small allocation caches of the heap.
+ *
+ ****************************************************************************/
+
+void mm_cache_initialize(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+}
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Try to satisfy an allocation from the cache of the current CPU,
+ *   refilling the cache from the heap if it is empty.
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the allocation is not cacheable or
+ *   could not be satisfied.  In that case, the caller should fall back to
+ *   the normal free list search.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_cachemag_s *mag;
+  FAR void *ret = NULL;
+  irqstate_t flags;
+  size_t chunksize;
+  int ndx;
+
+  /* Only small allocations are cached.  And if we already hold the heap
+   * semaphore, then we are refilling or draining a cache and must go to
+   * the free lists.
+   */
+
+  chunksize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  if (chunksize > MM_CACHE_MAXCHUNK || heap->mm_holder == getpid())
+    {
+      return NULL;
+    }
+
+  /* Round up to the next size class */
+
+  ndx = mm_size2ndx(chunksize);
+  if (chunksize > (MM_MIN_CHUNK << ndx))
+    {
+      ndx++;
+    }
+
+  DEBUGASSERT(ndx < MM_CACHE_NCLASSES);
+
+  /* Disabling local interrupts prevents both interrupt level access and
+   * migration to another CPU.
+   */
+
+  flags = up_irq_save();
+  mag   = &heap->mm_cache[up_cpu_index()].mag[ndx];
+
+  if (mag->count > 0)
+    {
+      ret = mag->chunk[--mag->count];
+    }
+
+  up_irq_restore(flags);
+
+  if (ret == NULL)
+    {
+      ret = mm_cache_refill(heap, ndx);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Try to return an allocated chunk to the cache of the current CPU.  If
+ *   the magazine is full, a batch of chunks is drained back to the heap.
+ *
+ * Returned Value:
+ *   true if the chunk was taken over by the cache; false if the caller
+ *   must return it to the free lists.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cachemag_s *mag;
+  FAR void *batch[MM_CACHE_BATCH];
+  irqstate_t flags;
+  int ndrain = 0;
+  int i;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  if (node->size > MM_CACHE_MAXCHUNK || heap->mm_holder == getpid())
+    {
+      return false;
+    }
+
+  /* Mark the chunk as cached for mm_profile().  A chunk belongs to the
+   * largest class that it can satisfy.
+   */
+
+  (void)mm_tag(heap, mem, 0, NULL);
+
+  flags = up_irq_save();
+  mag   = &heap->mm_cache[up_cpu_index()].mag[mm_size2ndx(node->size)];
+
+  if (mag->count >= CONFIG_MM_CACHE_DEPTH)
+    {
+      /* Take the oldest half of the magazine for draining */
+
+      ndrain      = MM_CACHE_BATCH;
+      memcpy(batch, mag->chunk, ndrain * sizeof(FAR void *));
+      mag->count -= ndrain;
+      memmove(mag->chunk, &mag->chunk[ndrain],
+              mag->count * sizeof(FAR void *));
+    }
+
+  mag->chunk[mag->count++] = mem;
+  up_irq_restore(flags);
+
+  if (ndrain > 0)
+    {
+      mm_takesemaphore(heap);
+      for (i = 0; i < ndrain; i++)
+        {
+          mm_free(heap, batch[i]);
+        }
+
+      mm_givesemaphore(heap);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return all chunks held in the cache of the current CPU to the heap
+ *   free lists.  This is done when an allocation would otherwise fail.
+ *
+ * Returned Value:
+ *   The number of chunks returned to the heap.
+ *
+ ****************************************************************************/
+
+int mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cachemag_s *mag;
+  FAR void *mem;
+  irqstate_t flags;
+  int nfreed = 0;
+  int ndx;
+
+  mm_takesemaphore(heap);
+
+  for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+    {
+      for (; ; )
+        {
+          flags = up_irq_save();
+          mag   = &heap->mm_cache[up_cpu_index()].mag[ndx];
+          mem   = NULL;
+
+          if (mag->count > 0)
+            {
+              mem = mag->chunk[--mag->count];
+            }
+
+          up_irq_restore(flags);
+
+          if (mem == NULL)
+            {
+              break;
+            }
+
+          mm_free(heap, mem);
+          nfreed++;
+        }
+    }
+
+  mm_givesemaphore(heap);
+  return nfreed;
+}
+
+#endif /* CONFIG_MM_CACHE */
@@ -62,5 +62,5 @@ FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
       ret = mm_zalloc(heap, n * elem_size);
     }
 
-  return ret;
+  return mm_tag(heap, ret, n * elem_size, MM_CALLER());
 }
@@ -0,0 +1,180 @@
+/****************************************************************************
+ * mm/mm_heap/mm_findfreechunk.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_SEGFIT
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_binhead
+ *
+ * Description:
+ *   Return the first free chunk in the bin or NULL if the bin is empty.
+ *   The end of a bin is marked by the zero-sized nodelist entry of the
+ *   following bin (or by the end of the list).
+ *
+ ****************************************************************************/
+
+static inline FAR struct mm_freenode_s *
+mm_binhead(FAR struct mm_heap_s *heap, int bin)
+{
+  FAR struct mm_freenode_s *node = heap->mm_nodelist[bin].flink;
+  return (node != NULL && node->size != 0) ? node : NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes (including the chunk
+ *   header) using the two-level bin bitmaps.  This is a good fit rather
+ *   than a best fit search:  The search starts at a bin in which every
+ *   chunk is large enough so that only the head of a bin ever needs to be
+ *   examined.  The search time is therefore independent of the number of
+ *   free chunks (except for requests in the first and last bins).
+ *
+ *   The chunk is not removed from the free list.  It is assumed that the
+ *   caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t slmap;
+  size_t roundup;
+  int bin;
+  int fl;
+  int sl;
+
+  /* The head of the bin that contains the size is a cheap first try and
+   * gives an exact fit for the common case of repeated equal sizes.
+   */
+
+  bin  = mm_size2bin(size);
+  node = mm_binhead(heap, bin);
+  if (node != NULL && node->size >= size)
+    {
+      return node;
+    }
+
+  /* Round the size up to the next bin boundary so that every chunk in the
+   * bin that we start from is large enough.
+   */
+
+  if (size < MM_MAX_CHUNK)
+    {
+      roundup = ((size_t)1 << (mm_size2ndx(size) + MM_MIN_SHIFT -
+                               CONFIG_MM_SEGFIT_SLBITS)) - 1;
+      bin     = mm_size2bin(size + roundup);
+    }
+
+  fl    = bin / MM_NSLBINS;
+  sl    = bin - fl * MM_NSLBINS;
+  slmap = heap->mm_slbitmap[fl] & ~(((uint32_t)1 << sl) - 1);
+
+  for (; ; )
+    {
+      /* Find the next first-level range with possibly non-empty bins */
+
+      if (slmap == 0)
+        {
+          uint32_t flmap;
+
+          flmap = heap->mm_flbitmap & ~(((uint32_t)1 << (fl + 1)) - 1);
+          if (flmap == 0)
+            {
+              return NULL;
+            }
+
+          fl    = ffs((int)flmap) - 1;
+          slmap = heap->mm_slbitmap[fl];
+          continue;
+        }
+
+      sl   = ffs((int)slmap) - 1;
+      bin  = fl * MM_NSLBINS + sl;
+      node = mm_binhead(heap, bin);
+
+      if (node == NULL)
+        {
+          /* The bin was emptied by a removal; clean up the stale bits */
+
+          heap->mm_slbitmap[fl] &= ~((uint32_t)1 << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+      else
+        {
+          /* Every chunk in the bin is large enough except in the first bin
+           * (which also holds the undersized chunks that may be left over
+           * by mm_memalign()) and in the last, unbounded bin.  Only those
+           * bins have to be searched.
+           */
+
+          for (; node && node->size != 0 && node->size < size;
+               node = node->flink);
+
+          if (node != NULL && node->size != 0)
+            {
+              return node;
+            }
+        }
+
+      slmap &= ~((uint32_t)1 << sl);
+    }
+}
+
+#endif /* CONFIG_MM_SEGFIT */
@@ -72,6 +72,15 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
+#ifdef CONFIG_MM_CACHE
+  /* Small chunks are normally kept in the cache of this CPU */
+
+  if (mm_cache_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
   /* We need to hold the MM semaphore while we muck with the
    * nodelist.
    */
@@ -122,6 +122,10 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]->size        = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
 
+#ifdef CONFIG_MM_REGION_ATTR
+  heap->mm_regattr[IDX] = MM_REGION_NORMAL;
+#endif
+
 #undef IDX
 
 #if CONFIG_MM_REGIONS > 1
@@ -133,6 +137,39 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   mm_addfreechunk(heap, node);
 }
 
+/****************************************************************************
+ * Name: mm_addregion_attr
+ *
+ * Description:
+ *   This function adds a region of contiguous memory to the selected heap
+ *   and records the attributes of that memory.  The attributes are used
+ *   to place the allocations that are made with a placement hint.
+ *
+ * Parameters:
+ *   heap      - The selected heap
+ *   heapstart - Start of the heap region
+ *   heapsize  - Size of the heap region
+ *   attr      - The MM_REGION_* attributes of the region
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_REGION_ATTR
+void mm_addregion_attr(FAR struct mm_heap_s *heap, FAR void *heapstart,
+                       size_t heapsize, uint8_t attr)
+{
+  mm_addregion(heap, heapstart, heapsize);
+
+#if CONFIG_MM_REGIONS > 1
+  heap->mm_regattr[heap->mm_nregions - 1] = attr;
+#else
+  heap->mm_regattr[0] = attr;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: mm_initialize
  *
@@ -179,19 +216,32 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   /* Initialize the node array */
 
-  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
-  for (i = 1; i < MM_NNODES; i++)
+  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NBINS);
+  for (i = 1; i < MM_NBINS; i++)
     {
       heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
     }
 
+#ifdef CONFIG_MM_SEGFIT
+  /* All bins are initially empty */
+
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+#endif
+
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
    */
 
   mm_seminitialize(heap);
 
+#ifdef CONFIG_MM_CACHE
+  /* Start with empty small allocation caches */
+
+  mm_cache_initialize(heap);
+#endif
+
   /* Add the initial region of memory to the heap */
 
   mm_addregion(heap, heapstart, heapsize);
@@ -53,43 +53,29 @@
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_findchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
- *
- *  8-byte alignment of the allocated data is assured.
+ *  Find a free chunk of at least 'size' bytes.  The chunk is not removed
+ *  from the nodelist.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+static inline FAR struct mm_freenode_s *
+mm_findchunk(FAR struct mm_heap_s *heap, size_t size)
 {
+#ifdef CONFIG_MM_SEGFIT
+  /* Use the constant time, good fit search of the segregated bins */
+
+  return mm_findfreechunk(heap, size);
+#else
   FAR struct mm_freenode_s *node;
-  void *ret = NULL;
   int ndx;
 
-  /* Handle bad sizes */
-
-  if (size < 1)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
-   */
-
-  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
   /* Get the location in the node list to start the search. Special case
    * really big allocations
    */
@@ -114,9 +100,188 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
        node && node->size < size;
        node = node->flink);
 
+  return node;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_placeok
+ *
+ * Description:
+ *  Return true if the free chunk lies in a region that satisfies the
+ *  placement hint.  If 'preferred' is true, then the region must also hold
+ *  the preferred kind of memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_REGION_ATTR
+static bool mm_placeok(FAR struct mm_heap_s *heap,
+                       FAR struct mm_freenode_s *node, int hint,
+                       bool preferred)
+{
+  uint8_t attr = MM_REGION_NORMAL;
+  int region;
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#else
+  for (region = 0; region < 1; region++)
+#endif
+    {
+      if ((FAR void *)node > (FAR void *)heap->mm_heapstart[region] &&
+          (FAR void *)node < (FAR void *)heap->mm_heapend[region])
+        {
+          attr = heap->mm_regattr[region];
+          break;
+        }
+    }
+
+  if ((hint & MM_PLACE_DMA) != 0 && (attr & MM_REGION_NODMA) != 0)
+    {
+      return false;
+    }
+
+  if (preferred || (hint & MM_PLACE_STRICT) != 0)
+    {
+      switch (hint & MM_PLACE_PREFMASK)
+        {
+          case MM_PLACE_FAST:
+            return (attr & MM_REGION_FAST) != 0;
+
+          case MM_PLACE_SLOW:
+            return (attr & MM_REGION_SLOW) != 0;
+
+          default:
+            return (attr & MM_REGION_FAST) == 0;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_findplaced
+ *
+ * Description:
+ *  Find a free chunk of at least 'size' bytes that satisfies the placement
+ *  hint.  The best (or good) fit is used if it lies in preferred memory.
+ *  Otherwise, the larger free chunks are searched for one in preferred
+ *  memory and then for one in any memory that the hint allows.  The chunk
+ *  is not removed from the nodelist.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *
+mm_findplaced(FAR struct mm_heap_s *heap, size_t size, int hint)
+{
+  FAR struct mm_freenode_s *fallback = NULL;
+  FAR struct mm_freenode_s *node;
+
+  node = mm_findchunk(heap, size);
+  if (node == NULL || mm_placeok(heap, node, hint, true))
+    {
+      return node;
+    }
+
+  /* The free list continues with chunks of the same and of larger bins.
+   * Any zero-sized nodelist entries are skipped by the size check.
+   */
+
+  for (; node; node = node->flink)
+    {
+      if (node->size >= size)
+        {
+          if (mm_placeok(heap, node, hint, true))
+            {
+              return node;
+            }
+
+          if (fallback == NULL && mm_placeok(heap, node, hint, false))
+            {
+              fallback = node;
+            }
+        }
+    }
+
+  return fallback;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_allocchunk
+ *
+ * Description:
+ *  Find a chunk that satisfies the request and the placement hint.  Take
+ *  the memory from that chunk, save the remaining, smaller chunk (if any).
+ *  The allocation is not tagged.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t size,
+                               int hint)
+{
+  FAR struct mm_freenode_s *node;
+  void *ret = NULL;
+
+  /* Handle bad sizes */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_MM_CACHE
+  /* Try the small allocation cache of this CPU first.  The cached chunks
+   * may lie in any region so that the cache is used only for ordinary
+   * allocations.
+   */
+
+  if (hint == MM_PLACE_NORMAL)
+    {
+      ret = mm_cache_alloc(heap, size);
+      if (ret != NULL)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+
+  /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+  mm_takesemaphore(heap);
+
+  /* Search for a large enough chunk */
+
+#ifdef CONFIG_MM_REGION_ATTR
+  node = mm_findplaced(heap, size, hint);
+#else
+  node = mm_findchunk(heap, size);
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* If nothing was found, return the chunks held in the cache of this CPU
+   * to the free lists and search again.
+   */
+
+  if (node == NULL && mm_cache_flush(heap) > 0)
+    {
+#ifdef CONFIG_MM_REGION_ATTR
+      node = mm_findplaced(heap, size, hint);
+#else
+      node = mm_findchunk(heap, size);
+#endif
+    }
+#endif
+
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
-   * available.
+   * available (or, in the segregated fit mode, a good fit).
    */
 
   if (node)
@@ -196,3 +361,40 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   return ret;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  return mm_tag(heap, mm_allocchunk(heap, size, MM_PLACE_NORMAL), size,
+                MM_CALLER());
+}
+
+/****************************************************************************
+ * Name: mm_malloc_hint
+ *
+ * Description:
+ *  Like mm_malloc(), but the chunk is preferably taken from the kind of
+ *  memory named by the MM_PLACE_* placement hint.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_REGION_ATTR
+FAR void *mm_malloc_hint(FAR struct mm_heap_s *heap, size_t size, int hint)
+{
+  return mm_tag(heap, mm_allocchunk(heap, size, hint), size, MM_CALLER());
+}
+#endif
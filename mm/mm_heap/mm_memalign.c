@@ -44,24 +44,24 @@
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_memalign
+ * Name: mm_alignchunk
  *
  * Description:
  *   memalign requests more than enough space from malloc, finds a region
  *   within that chunk that meets the alignment request and then frees any
- *   leading or trailing space.
+ *   leading or trailing space.  The allocation is not tagged.
  *
  *   The alignment argument must be a power of two (not checked).  8-byte
  *   alignment is guaranteed by normal malloc calls.
  *
  ****************************************************************************/
 
-FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
-                      size_t size)
+static FAR void *mm_alignchunk(FAR struct mm_heap_s *heap, size_t alignment,
+                               size_t size, int hint)
 {
   FAR struct mm_allocnode_s *node;
   size_t rawchunk;
@@ -75,7 +75,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_MIN_CHUNK)
     {
-      return mm_malloc(heap, size);
+      return mm_malloc_hint(heap, size, hint);
     }
 
   /* Adjust the size to account for (1) the size of the allocated node, (2)
@@ -95,7 +95,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
-  rawchunk = (size_t)mm_malloc(heap, allocsize);
+  rawchunk = (size_t)mm_malloc_hint(heap, allocsize, hint);
   if (rawchunk == 0)
     {
       return NULL;
@@ -204,3 +204,43 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memalign
+ *
+ * Description:
+ *   Allocate memory with the requested alignment.
+ *
+ *   The alignment argument must be a power of two (not checked).  8-byte
+ *   alignment is guaranteed by normal malloc calls.
+ *
+ ****************************************************************************/
+
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+  return mm_tag(heap, mm_alignchunk(heap, alignment, size, MM_PLACE_NORMAL),
+                size, MM_CALLER());
+}
+
+/****************************************************************************
+ * Name: mm_memalign_hint
+ *
+ * Description:
+ *   Like mm_memalign(), but the memory is preferably taken from the kind of
+ *   memory named by the MM_PLACE_* placement hint.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_REGION_ATTR
+FAR void *mm_memalign_hint(FAR struct mm_heap_s *heap, size_t alignment,
+                           size_t size, int hint)
+{
+  return mm_tag(heap, mm_alignchunk(heap, alignment, size, hint), size,
+                MM_CALLER());
+}
+#endif
@@ -0,0 +1,286 @@
+/****************************************************************************
+ * mm/mm_heap/mm_profile.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_PROFILE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tag
+ *
+ * Description:
+ *   Record the owner of an allocated chunk.  Each allocation function tags
+ *   the chunk that it returns, so the tag of the outermost call, usually
+ *   malloc() or kmm_malloc(), is the one that remains.
+ *
+ * Input Parameters:
+ *   heap   - The heap that the memory was allocated from
+ *   mem    - The allocated memory, possibly NULL
+ *   size   - The size that was requested
+ *   caller - The return address of the allocation function.  NULL marks
+ *            a chunk that is held by the small allocation cache.
+ *
+ * Returned Value:
+ *   mem is returned.
+ *
+ ****************************************************************************/
+
+FAR void *mm_tag(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
+                 FAR void *caller)
+{
+  FAR struct mm_allocnode_s *node;
+
+  if (mem != NULL)
+    {
+      node = (FAR struct mm_allocnode_s *)
+        ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+      if (caller != NULL)
+        {
+          mm_takesemaphore(heap);
+          node->tag.seqno = ++heap->mm_seqno;
+          mm_givesemaphore(heap);
+
+          node->tag.reqsize = size;
+          node->tag.pid     = getpid();
+        }
+
+      node->tag.caller = caller;
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_profile
+ *
+ * Description:
+ *   Walk the heap and sum up the live allocations of each call site.
+ *
+ * Input Parameters:
+ *   heap   - The heap to walk
+ *   sites  - The table to return the call sites in
+ *   nsites - The number of entries of the table.  If there are more call
+ *            sites, the allocations of the additional call sites are
+ *            summed up in the last entry and its caller is set to NULL.
+ *
+ * Returned Value:
+ *   The number of entries used is returned.
+ *
+ ****************************************************************************/
+
+int mm_profile(FAR struct mm_heap_s *heap, FAR struct mm_profsite_s *sites,
+               int nsites)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_profsite_s *site;
+  int nused = 0;
+  int i;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+# define region 0
+#endif
+
+  DEBUGASSERT(sites != NULL && nsites > 0);
+  memset(sites, 0, nsites * sizeof(struct mm_profsite_s));
+
+  /* Visit each region */
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      /* Visit each node in the region, skipping the guard node at the
+       * beginning.  Retake the semaphore for each region to reduce
+       * latencies.
+       */
+
+      mm_takesemaphore(heap);
+
+      for (node = (FAR struct mm_allocnode_s *)
+             ((FAR char *)heap->mm_heapstart[region] + SIZEOF_MM_ALLOCNODE);
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + node->size))
+        {
+          /* Skip free chunks and the chunks held by the cache */
+
+          if ((node->preceding & MM_ALLOC_BIT) == 0 ||
+              node->tag.caller == NULL)
+            {
+              continue;
+            }
+
+          /* Find the call site or add it */
+
+          for (i = 0; i < nused; i++)
+            {
+              if (sites[i].caller == node->tag.caller)
+                {
+                  break;
+                }
+            }
+
+          if (i >= nused)
+            {
+              if (nused < nsites)
+                {
+                  sites[nused].caller = node->tag.caller;
+                  sites[nused].minseq = node->tag.seqno;
+                  nused++;
+                }
+              else
+                {
+                  i = nsites - 1;
+                  sites[i].caller = NULL;
+                }
+            }
+
+          site = &sites[i];
+          site->nallocs++;
+          site->reqbytes   += node->tag.reqsize;
+          site->chunkbytes += node->size;
+
+          if ((int32_t)(node->tag.seqno - site->minseq) < 0)
+            {
+              site->minseq = node->tag.seqno;
+            }
+
+          if (site->nallocs == 1 ||
+              (int32_t)(node->tag.seqno - site->maxseq) > 0)
+            {
+              site->maxseq = node->tag.seqno;
+              site->pid    = node->tag.pid;
+            }
+        }
+
+      DEBUGASSERT(node == heap->mm_heapend[region]);
+      mm_givesemaphore(heap);
+    }
+#undef region
+
+  return nused;
+}
+
+/****************************************************************************
+ * Name: mm_fraginfo
+ *
+ * Description:
+ *   Walk the free lists and return the number and the size of the free
+ *   chunks in each mm_nodelist[] bin.
+ *
+ * Input Parameters:
+ *   heap - The heap to examine
+ *   info - The location to return the information
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int mm_fraginfo(FAR struct mm_heap_s *heap, FAR struct mm_fraginfo_s *info)
+{
+  FAR struct mm_freenode_s *node;
+  int bin;
+#ifdef CONFIG_MM_CACHE
+  int cpu;
+  int ndx;
+#endif
+
+  DEBUGASSERT(info != NULL);
+  memset(info, 0, sizeof(struct mm_fraginfo_s));
+
+  mm_takesemaphore(heap);
+
+  /* The bins are headed by the mm_nodelist[] entries.  Without
+   * CONFIG_MM_SEGFIT, they are one list and the zero-sized head of the
+   * next bin ends the walk of a bin.
+   */
+
+  for (bin = 0; bin < MM_NBINS; bin++)
+    {
+      for (node = heap->mm_nodelist[bin].flink;
+           node != NULL && node->size != 0;
+           node = node->flink)
+        {
+          info->nchunks[bin]++;
+          info->nbytes[bin] += node->size;
+
+          if (node->size > info->largest)
+            {
+              info->largest = node->size;
+            }
+        }
+
+      info->nfree  += info->nchunks[bin];
+      info->fbytes += info->nbytes[bin];
+    }
+
+#ifdef CONFIG_MM_CACHE
+  /* Chunks in the small allocation caches are neither allocated nor on
+   * the free lists.
+   */
+
+  for (cpu = 0; cpu < MM_CACHE_NCPUS; cpu++)
+    {
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          info->ncached += heap->mm_cache[cpu].mag[ndx].count;
+        }
+    }
+#endif
+
+  mm_givesemaphore(heap);
+  return OK;
+}
+
+#endif /* CONFIG_MM_PROFILE */
@@ -64,8 +64,8 @@
  *  extended, it will be extended by:
  *
  *     (1) Taking the additional space from the following free chunk, or
- *     (2) Taking the additional space from the preceding free chunk.
- *     (3) Or both
+ *     (2) Taking the rest of the space from the preceding free chunk and
+ *         moving the data down.
  *
  *  If the request is for more space but the current chunk cannot be
  *  extended, then malloc a new buffer, copy the data into the new buffer,
@@ -89,7 +89,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   if (oldmem == NULL)
     {
-      return mm_malloc(heap, size);
+      return mm_tag(heap, mm_malloc(heap, size), size, MM_CALLER());
     }
 
   /* If size is zero, then realloc is equivalent to free */
@@ -131,7 +131,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       /* Then return the original address */
 
       mm_givesemaphore(heap);
-      return oldmem;
+      return mm_tag(heap, oldmem, size, MM_CALLER());
     }
 
   /* This is a request to increase the size of the allocation,  Get the
@@ -159,58 +159,32 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
+      /* Prefer the next chunk:  Growing into it does not move the data.
+       * The preceding chunk only provides what the next chunk cannot.
        */
 
-      if (prevsize > 0 && (nextsize >= prevsize || nextsize < 1))
+      if (nextsize >= needed)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
-
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
-
-              takeprev = needed;
-              takenext = 0;
-            }
-
-          needed = 0;
+          takenext = needed;
+        }
+      else
+        {
+          takenext = nextsize;
+          takeprev = needed - nextsize;
         }
 
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
+      /* Never leave a fragment that is too small to hold a free node.
+       * Take the whole free chunk instead.
        */
 
-      if (nextsize > 0 && needed)
+      if (takenext > 0 && nextsize - takenext < SIZEOF_MM_FREENODE)
         {
-          /* Can we get everything we need from the next chunk? */
-
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
-
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
+          takenext = nextsize;
+        }
 
-              takeprev = 0;
-              takenext = needed;
-            }
+      if (takeprev > 0 && prevsize - takeprev < SIZEOF_MM_FREENODE)
+        {
+          takeprev = prevsize;
         }
 
       /* Extend into the previous free chunk */
@@ -261,17 +235,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
               next->preceding     = newnode->size | (next->preceding & MM_ALLOC_BIT);
             }
 
+          /* Now we have to move the user contents 'down' in memory.  The
+           * old and new locations overlap.
+           */
+
+          newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
+          memmove(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+
           /* Now we want to return newnode */
 
           oldnode = newnode;
           oldsize = newnode->size;
-
-          /* Now we have to move the user contents 'down' in memory.  memcpy should
-           * should be save for this.
-           */
-
-          newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-          memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
         }
 
       /* Extend into the next free chunk */
@@ -328,7 +302,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         }
 
       mm_givesemaphore(heap);
-      return newmem;
+      return mm_tag(heap, newmem, size, MM_CALLER());
     }
 
   /* The current chunk cannot be extended.  Just allocate a new chunk and copy */
@@ -343,10 +317,53 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       newmem = (FAR void *)mm_malloc(heap, size);
       if (newmem)
         {
-          memcpy(newmem, oldmem, oldsize);
+          memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
           mm_free(heap, oldmem);
         }
 
-      return newmem;
+      return mm_tag(heap, newmem, size, MM_CALLER());
     }
 }
+
+/****************************************************************************
+ * Name: mm_growsize
+ *
+ * Description:
+ *   Return the size that a caller should request when it must grow an
+ *   allocation of 'cursize' bytes to hold at least 'reqsize' bytes.
+ *   Growing by at least half of the current size means that a series of
+ *   small increments needs only a logarithmic number of reallocations.
+ *   The size is then rounded up to a quarter of its power-of-two size
+ *   class so that the slack at the end of the chunk is not wasted and so
+ *   that the chunk is more likely to be reused by a similar request after
+ *   it is freed.
+ *
+ ****************************************************************************/
+
+size_t mm_growsize(size_t cursize, size_t reqsize)
+{
+  size_t size;
+  size_t mask;
+  int shift;
+
+  size = cursize + (cursize >> 1);
+  if (size < reqsize)
+    {
+      size = reqsize;
+    }
+
+  /* Convert to a chunk size and round it up to the size class */
+
+  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  if (size < MM_MAX_CHUNK)
+    {
+      shift = mm_size2ndx(size) + MM_MIN_SHIFT - 2;
+      if (shift > MM_MIN_SHIFT)
+        {
+          mask = ((size_t)1 << shift) - 1;
+          size = (size + mask) & ~mask;
+        }
+    }
+
+  return size - SIZEOF_MM_ALLOCNODE;
+}
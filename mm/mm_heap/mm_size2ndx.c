@@ -71,3 +71,42 @@ int mm_size2ndx(size_t size)
 
   return ndx;
 }
+
+/****************************************************************************
+ * Name: mm_size2bin
+ *
+ * Description:
+ *    Convert the size to a nodelist index in the segregated fit mode.  The
+ *    first-level index is the power-of-two range given by mm_size2ndx();
+ *    the second-level index is given by the next CONFIG_MM_SEGFIT_SLBITS
+ *    most significant bits of the size.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_SEGFIT
+int mm_size2bin(size_t size)
+{
+  int fl;
+  int sl;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+       return MM_NBINS-1;
+    }
+
+  /* Undersized chunks (i.e., those left over by mm_memalign()) all go into
+   * the first bin.
+   */
+
+  if (size < MM_MIN_CHUNK)
+    {
+      return 0;
+    }
+
+  fl = mm_size2ndx(size);
+  sl = (size >> (fl + MM_MIN_SHIFT - CONFIG_MM_SEGFIT_SLBITS)) &
+       (MM_NSLBINS - 1);
+
+  return fl * MM_NSLBINS + sl;
+}
+#endif
@@ -63,5 +63,5 @@ FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
        memset(alloc, 0, size);
     }
 
-  return alloc;
+  return mm_tag(heap, alloc, size, MM_CALLER());
 }
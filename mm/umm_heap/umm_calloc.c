@@ -59,5 +59,6 @@
 
 FAR void *calloc(size_t n, size_t elem_size)
 {
-  return mm_calloc(USR_HEAP, n, elem_size);
+  return mm_tag(USR_HEAP, mm_calloc(USR_HEAP, n, elem_size), n * elem_size,
+                MM_CALLER());
 }
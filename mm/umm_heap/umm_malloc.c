@@ -95,8 +95,8 @@ FAR void *malloc(size_t size)
     }
   while (mem == NULL);
 
-  return mem;
+  return mm_tag(USR_HEAP, mem, size, MM_CALLER());
 #else
-  return mm_malloc(USR_HEAP, size);
+  return mm_tag(USR_HEAP, mm_malloc(USR_HEAP, size), size, MM_CALLER());
 #endif
 }
@@ -64,5 +64,6 @@
 
 FAR void *memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(USR_HEAP, alignment, size);
+  return mm_tag(USR_HEAP, mm_memalign(USR_HEAP, alignment, size), size,
+                MM_CALLER());
 }
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * mm/umm_heap/umm_placement.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "umm_heap/umm_heap.h"
+
+#ifdef CONFIG_MM_REGION_ATTR
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_addregion_attr
+ *
+ * Description:
+ *   Add a region of memory with the given MM_REGION_* attributes to the
+ *   user heap.
+ *
+ * Parameters:
+ *   heapstart - Address of the beginning of the memory region
+ *   heapsize  - The size (in bytes) if the memory region.
+ *   attr      - The MM_REGION_* attributes of the memory region
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void umm_addregion_attr(FAR void *heapstart, size_t heapsize, uint8_t attr)
+{
+  mm_addregion_attr(USR_HEAP, heapstart, heapsize, attr);
+}
+
+/****************************************************************************
+ * Name: umm_malloc_hint
+ *
+ * Description:
+ *   Allocate memory from the user heap, preferably from the kind of memory
+ *   named by the placement hint.
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *   hint - The MM_PLACE_* placement hint
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *umm_malloc_hint(size_t size, int hint)
+{
+  return mm_tag(USR_HEAP, mm_malloc_hint(USR_HEAP, size, hint), size, MM_CALLER());
+}
+
+/****************************************************************************
+ * Name: umm_zalloc_hint
+ *
+ * Description:
+ *   Allocate and zero memory from the user heap, preferably from the kind of
+ *   memory named by the placement hint.
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *   hint - The MM_PLACE_* placement hint
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *umm_zalloc_hint(size_t size, int hint)
+{
+  FAR void *alloc = mm_malloc_hint(USR_HEAP, size, hint);
+  if (alloc)
+    {
+      memset(alloc, 0, size);
+    }
+
+  return mm_tag(USR_HEAP, alloc, size, MM_CALLER());
+}
+
+/****************************************************************************
+ * Name: umm_memalign_hint
+ *
+ * Description:
+ *   Allocate aligned memory from the user heap, preferably from the kind of
+ *   memory named by the placement hint.
+ *
+ * Parameters:
+ *   alignment - The alignment (a power of two)
+ *   size      - Size (in bytes) of the memory region to be allocated.
+ *   hint      - The MM_PLACE_* placement hint
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *umm_memalign_hint(size_t alignment, size_t size, int hint)
+{
+  return mm_tag(USR_HEAP, mm_memalign_hint(USR_HEAP, alignment, size, hint), size,
+                MM_CALLER());
+}
+
+#endif /* CONFIG_MM_REGION_ATTR */
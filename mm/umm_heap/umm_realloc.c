@@ -66,5 +66,6 @@
 
 FAR void *realloc(FAR void *oldmem, size_t size)
 {
-  return mm_realloc(USR_HEAP, oldmem, size);
+  return mm_tag(USR_HEAP, mm_realloc(USR_HEAP, oldmem, size), size,
+                MM_CALLER());
 }
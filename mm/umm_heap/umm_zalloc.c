@@ -75,11 +75,11 @@ FAR void *zalloc(size_t size)
        memset(alloc, 0, size);
     }
 
-  return alloc;
+  return mm_tag(USR_HEAP, alloc, size, MM_CALLER());
 
 #else
   /* Use mm_zalloc() becuase it implements the clear */
 
-  return mm_zalloc(USR_HEAP, size);
+  return mm_tag(USR_HEAP, mm_zalloc(USR_HEAP, size), size, MM_CALLER());
 #endif
 }
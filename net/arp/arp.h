@@ -385,6 +385,27 @@ void arp_notify(in_addr_t ipaddr);
 
 FAR struct arp_entry *arp_find(in_addr_t ipaddr);
 
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Like arp_find(), but first check the entry that was last found for
+ *   this device.  Consecutive packets sent through a device usually go to
+ *   the same host or router, so this usually avoids the table search.
+ *
+ * Input parameters:
+ *   dev    - The device that will send the packet
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Assumptions
+ *   The network is locked; Returned value will become unstable when the
+ *   network is unlocked or if any other network APIs are called.
+ *
+ ****************************************************************************/
+
+FAR struct arp_entry *arp_lookup(FAR struct net_driver_s *dev,
+                                 in_addr_t ipaddr);
+
 /****************************************************************************
  * Name: arp_delete
  *
@@ -394,20 +415,16 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  * Input parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there is no entry for
+ *   this IP address.
+ *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table
- *   (and because arp_find() is called).
+ *   The network is locked to assure exclusive access to the ARP table
  *
  ****************************************************************************/
 
-#define arp_delete(ipaddr) \
-{ \
-  struct arp_entry *tabptr = arp_find(ipaddr); \
-  if (tabptr) \
-    { \
-      tabptr->at_ipaddr = 0; \
-    } \
-}
+int arp_delete(in_addr_t ipaddr);
 
 /****************************************************************************
  * Name: arp_update
@@ -488,7 +505,8 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_wait(n,t) (0)
 #  define arp_notify(i)
 #  define arp_find(i) (NULL)
-#  define arp_delete(i)
+#  define arp_lookup(d,i) (NULL)
+#  define arp_delete(i) (-ENOENT)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
 #  define arp_dump(arp)
@@ -228,7 +228,7 @@ void arp_out(FAR struct net_driver_s *dev)
 
       /* Check if we already have this destination address in the ARP table */
 
-      tabptr = arp_find(ipaddr);
+      tabptr = arp_lookup(dev, ipaddr);
       if (!tabptr)
         {
            ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
@@ -239,6 +239,7 @@ void arp_out(FAR struct net_driver_s *dev)
 
           arp_format(dev, ipaddr);
           arp_dump(ARPBUF);
+          netdev_txiob_clear(dev);
           return;
         }
 
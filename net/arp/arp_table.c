@@ -48,6 +48,9 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <string.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
@@ -62,6 +65,14 @@
 
 #ifdef CONFIG_NET_ARP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_ARP_HASHSIZE & (CONFIG_NET_ARP_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_ARP_HASHSIZE must be a power of two
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -71,6 +82,106 @@
 static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
 static uint8_t g_arptime;
 
+/* The entries in use are held in hash chains, indexed by IP address, and
+ * in a list ordered by use, most recently used first.  The least recently
+ * used entry is replaced when there are no free entries.
+ */
+
+static FAR struct arp_entry *g_arphash[CONFIG_NET_ARP_HASHSIZE];
+static dq_queue_t g_arplru;
+static dq_queue_t g_arpfree;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash chain for an IP address.  All of the bytes of the
+ *   address are folded so that the result does not depend on byte order.
+ *
+ ****************************************************************************/
+
+static inline FAR struct arp_entry **arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_arphash[hash & (CONFIG_NET_ARP_HASHSIZE - 1)];
+}
+
+/****************************************************************************
+ * Name: arp_lookup_entry
+ *
+ * Description:
+ *   Search the hash chain for the entry with this IP address.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry *arp_lookup_entry(in_addr_t ipaddr)
+{
+  FAR struct arp_entry *tabptr;
+
+  for (tabptr = *arp_hash(ipaddr); tabptr != NULL; tabptr = tabptr->at_hnext)
+    {
+      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Make an entry the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(FAR struct arp_entry *tabptr)
+{
+  if (g_arplru.head != &tabptr->at_node)
+    {
+      dq_rem(&tabptr->at_node, &g_arplru);
+      dq_addfirst(&tabptr->at_node, &g_arplru);
+    }
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from its hash chain and return it to the free list.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry *tabptr)
+{
+  FAR struct arp_entry **pptr;
+
+  for (pptr = arp_hash(tabptr->at_ipaddr); *pptr != NULL;
+       pptr = &(*pptr)->at_hnext)
+    {
+      if (*pptr == tabptr)
+        {
+          *pptr = tabptr->at_hnext;
+          break;
+        }
+    }
+
+  dq_rem(&tabptr->at_node, &g_arplru);
+  dq_addlast(&tabptr->at_node, &g_arpfree);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_hnext  = NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,9 +198,15 @@ void arp_reset(void)
 {
   int i;
 
+  dq_init(&g_arplru);
+  dq_init(&g_arpfree);
+  memset(g_arphash, 0, sizeof(g_arphash));
+
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
+      g_arptable[i].at_ipaddr = 0;
+      g_arptable[i].at_hnext  = NULL;
+      dq_addlast(&g_arptable[i].at_node, &g_arpfree);
     }
 }
 
@@ -117,7 +234,7 @@ void arp_timer(void)
       if (tabptr->at_ipaddr != 0 &&
           g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
         {
-          tabptr->at_ipaddr = 0;
+          arp_release(tabptr);
         }
     }
 }
@@ -144,77 +261,38 @@ void arp_timer(void)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  struct arp_entry *tabptr = NULL;
-  int               i;
+  FAR struct arp_entry **pptr;
+  FAR struct arp_entry *tabptr;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  /* Try to find an existing entry to update. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_lookup_entry(ipaddr);
+  if (tabptr == NULL)
     {
-      tabptr = &g_arptable[i];
+      /* If none is found, the IP -> MAC address mapping is inserted in the
+       * ARP table.  Use an unused entry if there is one; otherwise throw
+       * away the least recently used entry.
+       */
 
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
+      if (dq_peek(&g_arpfree) == NULL)
         {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
-
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
-
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return OK;
-            }
+          arp_release((FAR struct arp_entry *)g_arplru.tail);
         }
-    }
 
-  /* If we get here, no existing ARP table entry was found, so we create one. */
-  /* First, we try to find an unused entry in the ARP table. */
+      tabptr = (FAR struct arp_entry *)dq_remfirst(&g_arpfree);
+      DEBUGASSERT(tabptr != NULL);
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr == 0)
-        {
-          break;
-        }
+      tabptr->at_ipaddr = ipaddr;
+      pptr              = arp_hash(ipaddr);
+      tabptr->at_hnext  = *pptr;
+      *pptr             = tabptr;
+      dq_addfirst(&tabptr->at_node, &g_arplru);
     }
-
-  /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
-   */
-
-  if (i == CONFIG_NET_ARPTAB_SIZE)
+  else
     {
-      uint8_t tmpage = 0;
-      int j = 0;
-
-      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-        {
-          tabptr = &g_arptable[i];
-          if (g_arptime - tabptr->at_time > tmpage)
-            {
-              tmpage = g_arptime - tabptr->at_time;
-              j = i;
-            }
-        }
-
-      i = j;
-      tabptr = &g_arptable[i];
+      arp_touch(tabptr);
     }
 
-  /* Now, i is the ARP table entry which we will fill with the new
-   * information.
-   */
-
-  tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = g_arptime;
   return OK;
@@ -267,18 +345,95 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 FAR struct arp_entry *arp_find(in_addr_t ipaddr)
 {
   FAR struct arp_entry *tabptr;
-  int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (ipaddr == 0)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          return tabptr;
-        }
+      return NULL;
     }
 
-  return NULL;
+  tabptr = arp_lookup_entry(ipaddr);
+  if (tabptr != NULL)
+    {
+      arp_touch(tabptr);
+    }
+
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Like arp_find(), but first check the entry that was last found for
+ *   this device.  Consecutive packets sent through a device usually go to
+ *   the same host or router, so this usually avoids the table search.
+ *
+ * Input parameters:
+ *   dev    - The device that will send the packet
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Assumptions
+ *   The network is locked; Returned value will become unstable when the
+ *   network is unlocked or if any other network APIs are called.
+ *
+ ****************************************************************************/
+
+FAR struct arp_entry *arp_lookup(FAR struct net_driver_s *dev,
+                                 in_addr_t ipaddr)
+{
+  FAR struct arp_entry *tabptr = dev->d_arphit;
+
+  /* The cached entry may since have been reused for a different address
+   * or released.  A released entry has a zero address, which is never
+   * looked up.
+   */
+
+  if (tabptr != NULL && ipaddr != 0 &&
+      net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+    {
+      arp_touch(tabptr);
+      return tabptr;
+    }
+
+  tabptr = arp_find(ipaddr);
+  if (tabptr != NULL)
+    {
+      dev->d_arphit = tabptr;
+    }
+
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there is no entry for
+ *   this IP address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_delete(in_addr_t ipaddr)
+{
+  FAR struct arp_entry *tabptr;
+
+  tabptr = arp_find(ipaddr);
+  if (tabptr == NULL)
+    {
+      return -ENOENT;
+    }
+
+  arp_release(tabptr);
+  return OK;
 }
 
 #endif /* CONFIG_NET_ARP */
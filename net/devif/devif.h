@@ -492,6 +492,33 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
                     unsigned int len, unsigned int offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_iob_claim
+ *
+ * Description:
+ *   Take ownership of the I/O buffer into which the driver received the
+ *   current packet (if any) so that its payload can be queued without
+ *   copying.  On success, the returned I/O buffer holds 'prefix' bytes of
+ *   space (for the caller's use) followed by the 'buflen' bytes of payload
+ *   at 'buffer'.  The driver is given a replacement I/O buffer holding a
+ *   copy of the packet headers.  The claimed I/O buffer is accounted to
+ *   'user' (one of the IOB_USER_* definitions).
+ *
+ * Returned Value:
+ *   The claimed I/O buffer or NULL if the packet is not in an I/O buffer
+ *   or no replacement is available.  The caller must then copy the data.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB_RX
+FAR struct iob_s *devif_iob_claim(FAR struct net_driver_s *dev,
+                                  FAR uint8_t *buffer, uint16_t buflen,
+                                  uint16_t prefix, uint8_t user);
+#endif
+
 /****************************************************************************
  * Name: devif_pkt_send
  *
@@ -46,6 +46,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/mm/mempool.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -58,7 +59,11 @@
  ****************************************************************************/
 
 static struct devif_callback_s g_cbprealloc[CONFIG_NET_NACTIVESOCKETS];
+#ifdef CONFIG_NET_DEVIF_CBPOOL
+static struct mempool_s g_cbpool;
+#else
 static FAR struct devif_callback_s *g_cbfreelist = NULL;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -86,7 +91,7 @@ static void devif_callback_free(FAR struct net_driver_s *dev,
     {
       net_lock();
 
-#ifdef CONFIG_DEBUG_FEATURES
+#if defined(CONFIG_DEBUG_FEATURES) && !defined(CONFIG_NET_DEVIF_CBPOOL)
       /* Check for double freed callbacks */
 
       curr = g_cbfreelist;
@@ -156,9 +161,13 @@ static void devif_callback_free(FAR struct net_driver_s *dev,
 
       /* Put the structure into the free list */
 
+#ifdef CONFIG_NET_DEVIF_CBPOOL
+      mempool_free(&g_cbpool, cb);
+#else
       cb->nxtconn  = g_cbfreelist;
       cb->nxtdev   = NULL;
       g_cbfreelist = cb;
+#endif
       net_unlock();
     }
 }
@@ -219,6 +228,16 @@ static bool devif_event_trigger(uint16_t events, uint16_t triggers)
 
 void devif_callback_init(void)
 {
+#ifdef CONFIG_NET_DEVIF_CBPOOL
+  /* The pre-allocated structures are the initial blocks of a pool that may
+   * grow from the heap on demand.
+   */
+
+  (void)mempool_initialize(&g_cbpool, "devif_cb",
+                           sizeof(struct devif_callback_s), g_cbprealloc,
+                           CONFIG_NET_NACTIVESOCKETS,
+                           CONFIG_NET_DEVIF_CBPOOL_EXPAND, 0);
+#else
   int i;
 
   for (i = 0; i < CONFIG_NET_NACTIVESOCKETS; i++)
@@ -226,6 +245,7 @@ void devif_callback_init(void)
       g_cbprealloc[i].nxtconn = g_cbfreelist;
       g_cbfreelist = &g_cbprealloc[i];
     }
+#endif
 }
 
 /****************************************************************************
@@ -253,12 +273,18 @@ FAR struct devif_callback_s *
   /* Check  the head of the free list */
 
   net_lock();
-  ret  = g_cbfreelist;
+#ifdef CONFIG_NET_DEVIF_CBPOOL
+  ret = (FAR struct devif_callback_s *)mempool_alloc(&g_cbpool);
+#else
+  ret = g_cbfreelist;
+#endif
   if (ret)
     {
       /* Remove the next instance from the head of the free list */
 
+#ifndef CONFIG_NET_DEVIF_CBPOOL
       g_cbfreelist = ret->nxtconn;
+#endif
       memset(ret, 0, sizeof(struct devif_callback_s));
 
       /* Add the newly allocated instance to the head of the device event
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * net/devif/devif_iobclaim.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NETDEV_IOB_RX
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_iob_claim
+ *
+ * Description:
+ *   Take ownership of the I/O buffer into which the driver received the
+ *   current packet (if any) so that its payload can be queued without
+ *   copying.  On success, the returned I/O buffer holds 'prefix' bytes of
+ *   space (for the caller's use) followed by the 'buflen' bytes of payload
+ *   at 'buffer'.  The driver is given a replacement I/O buffer holding a
+ *   copy of the packet headers.  The claimed I/O buffer is accounted to
+ *   'user' (one of the IOB_USER_* definitions).
+ *
+ * Returned Value:
+ *   The claimed I/O buffer or NULL if the packet is not in an I/O buffer
+ *   or no replacement is available.  The caller must then copy the data.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *devif_iob_claim(FAR struct net_driver_s *dev,
+                                  FAR uint8_t *buffer, uint16_t buflen,
+                                  uint16_t prefix, uint8_t user)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct iob_s *spare;
+  unsigned int offset;
+
+  /* The payload must lie entirely within the driver's I/O buffer with room
+   * for the prefix in the headers that precede it.
+   */
+
+  if (iob == NULL || dev->d_buf != iob->io_data ||
+      buffer < iob->io_data)
+    {
+      return NULL;
+    }
+
+  offset = buffer - iob->io_data;
+  if (offset < prefix || offset + buflen > IOB_BUFSIZE(iob))
+    {
+      return NULL;
+    }
+
+  /* The response to this packet will be built in d_buf, so the driver
+   * needs a replacement buffer with the same headers.
+   */
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  if (IOB_BUFSIZE(iob) > CONFIG_IOB_BUFSIZE)
+    {
+      /* The driver receives into large I/O buffers */
+
+      spare = iob_tryalloc_size(true, IOB_BUFSIZE(iob));
+      if (spare != NULL && IOB_BUFSIZE(spare) < IOB_BUFSIZE(iob))
+        {
+          iob_free(spare);
+          spare = NULL;
+        }
+    }
+  else
+#endif
+    {
+      spare = iob_tryalloc_user(true, user);
+    }
+
+  if (spare == NULL)
+    {
+      ninfo("No spare I/O buffer, copying\n");
+      return NULL;
+    }
+
+  memcpy(spare->io_data, iob->io_data, offset);
+
+#ifdef CONFIG_IOB_RESERVATIONS
+  /* A small spare was accounted to the user, but it is the claimed I/O
+   * buffer that the user will hold.
+   */
+
+  if (spare->io_user == user)
+    {
+      spare->io_user = iob->io_user;
+      iob->io_user   = user;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCPURGDATA
+  if (dev->d_urgdata != NULL)
+    {
+      dev->d_urgdata = spare->io_data + (dev->d_urgdata - iob->io_data);
+    }
+#endif
+
+  dev->d_iob     = spare;
+  dev->d_buf     = spare->io_data;
+  dev->d_appdata = spare->io_data + offset;
+
+  /* Then reduce the claimed buffer to the prefix and payload */
+
+  iob->io_flink  = NULL;
+  iob->io_offset = offset - prefix;
+  iob->io_len    = prefix + buflen;
+  iob->io_pktlen = prefix + buflen;
+
+  return iob;
+}
+
+#endif /* CONFIG_NETDEV_IOB_RX */
@@ -71,7 +71,30 @@
 void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                     unsigned int len, unsigned int offset)
 {
+#ifdef CONFIG_NETDEV_TSO
+  /* A TSO capable driver may be given more than fits in d_buf */
+
+  DEBUGASSERT(dev && len > 0 &&
+              (len < NET_DEV_MTU(dev) ||
+               (dev->d_sgtx && len <= dev->d_tsomax)));
+  dev->d_txmss = 0;
+#else
   DEBUGASSERT(dev && len > 0 && len < NET_DEV_MTU(dev));
+#endif
+
+#ifdef CONFIG_NETDEV_IOB_TX
+  /* If the driver can transmit from the I/O buffer chain, then just
+   * remember where the data is.
+   */
+
+  if (dev->d_sgtx)
+    {
+      dev->d_txiob    = iob;
+      dev->d_txoffset = offset;
+      dev->d_sndlen   = len;
+      return;
+    }
+#endif
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
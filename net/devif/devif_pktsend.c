@@ -109,6 +109,7 @@ void devif_pkt_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   dev->d_len    = len;
   dev->d_sndlen = len;
+  netdev_txiob_clear(dev);
 }
 
 #endif /* CONFIG_NET_PKT */
@@ -46,6 +46,7 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/tcp.h>
 
 #include "devif/devif.h"
 #include "arp/arp.h"
@@ -384,10 +385,36 @@ static inline int devif_poll_igmp(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IGMP */
 
 /****************************************************************************
- * Name: devif_poll_udp_connections
+ * Name: devif_poll_armed
+ *
+ * Description:
+ *   Return true if any callback in a connection's callback list is armed
+ *   for the poll event.  A pending connection without such a callback has
+ *   nothing more to send and can leave the device's pending list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+static bool devif_poll_armed(FAR struct devif_callback_s *list,
+                             uint16_t pollflag)
+{
+  for (; list != NULL; list = list->nxtconn)
+    {
+      if ((list->flags & pollflag) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: devif_poll_udp_conn
  *
  * Description:
- *   Poll all UDP connections for available packets to send.
+ *   Poll one UDP connection for available packets to send.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -396,19 +423,26 @@ static inline int devif_poll_igmp(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #ifdef NET_UDP_HAVE_STACK
-static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
-                                      devif_poll_callback_t callback)
+static int devif_poll_udp_conn(FAR struct net_driver_s *dev,
+                               FAR struct udp_conn_s *conn,
+                               devif_poll_callback_t callback)
 {
-  FAR struct udp_conn_s *conn = NULL;
-  int bstop = 0;
+  int bstop;
+#if CONFIG_NET_UDP_POLLBATCH > 1
+  int npolls;
+  bool sent;
 
-  /* Traverse all of the allocated UDP connections and perform the poll action */
+  /* Keep polling this connection while it has datagrams to send and
+   * the driver can accept them.
+   */
 
-  while (!bstop && (conn = udp_nextconn(conn)))
+  npolls = 0;
+  do
     {
       /* Perform the UDP TX poll */
 
       udp_poll(dev, conn);
+      sent = (dev->d_len > 0);
 
       /* Perform any necessary conversions on outgoing packets */
 
@@ -418,6 +452,78 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
       bstop = callback(dev);
     }
+  while (!bstop && sent && ++npolls < CONFIG_NET_UDP_POLLBATCH);
+#else
+  /* Perform the UDP TX poll */
+
+  udp_poll(dev, conn);
+
+  /* Perform any necessary conversions on outgoing packets */
+
+  devif_packet_conversion(dev, DEVIF_UDP);
+
+  /* Call back into the driver */
+
+  bstop = callback(dev);
+#endif
+
+  return bstop;
+}
+#endif /* NET_UDP_HAVE_STACK */
+
+/****************************************************************************
+ * Name: devif_poll_udp_connections
+ *
+ * Description:
+ *   Poll all UDP connections for available packets to send.  If sweep is
+ *   false and pending lists are enabled, only the connections pending on
+ *   this device are polled.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef NET_UDP_HAVE_STACK
+static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
+                                      devif_poll_callback_t callback,
+                                      bool sweep)
+{
+  FAR struct udp_conn_s *conn = NULL;
+  int bstop = 0;
+
+#ifdef CONFIG_NETDEV_TXPENDING
+  if (!sweep)
+    {
+      FAR struct udp_conn_s *next;
+
+      /* Traverse only the UDP connections with Tx work pending on this
+       * device.  The poll may move the connection to another device's
+       * list, so get the next connection first.
+       */
+
+      for (conn = dev->d_udppend; !bstop && conn != NULL; conn = next)
+        {
+          next  = conn->txnext;
+          bstop = devif_poll_udp_conn(dev, conn, callback);
+
+          if (conn->txdev == dev && !devif_poll_armed(conn->list, UDP_POLL))
+            {
+              udp_txpending_remove(conn);
+            }
+        }
+
+      return bstop;
+    }
+#endif
+
+  /* Traverse all of the allocated UDP connections and perform the poll action */
+
+  while (!bstop && (conn = udp_nextconn(conn)))
+    {
+      bstop = devif_poll_udp_conn(dev, conn, callback);
+    }
 
   return bstop;
 }
@@ -427,7 +533,9 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
  * Name: devif_poll_tcp_connections
  *
  * Description:
- *   Poll all UDP connections for available packets to send.
+ *   Poll all TCP connections for available packets to send.  If sweep is
+ *   false and pending lists are enabled, only the connections pending on
+ *   this device are polled.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -437,15 +545,66 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
 #ifdef NET_TCP_HAVE_STACK
 static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
-                                             devif_poll_callback_t callback)
+                                             devif_poll_callback_t callback,
+                                             bool sweep)
 {
-  FAR struct tcp_conn_s *conn  = NULL;
+  FAR struct tcp_conn_s *conn;
+  FAR struct tcp_conn_s *next;
   int bstop = 0;
 
-  /* Traverse all of the active TCP connections and perform the poll action */
+#ifdef CONFIG_NETDEV_TXPENDING
+  if (!sweep)
+    {
+      /* Traverse only the TCP connections with Tx work pending on this
+       * device.
+       */
 
-  while (!bstop && (conn = tcp_nextconn(conn)))
+      for (conn = dev->d_tcppend; !bstop && conn != NULL; conn = next)
+        {
+          next = conn->txnext;
+
+          /* Perform the TCP TX poll */
+
+          tcp_poll(dev, conn);
+
+          /* Perform any necessary conversions on outgoing packets */
+
+          devif_packet_conversion(dev, DEVIF_TCP);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+
+          /* tcp_poll() does nothing unless the connection is established
+           * or its timer is due.  Keep the connection pending while it
+           * still has timer or delayed ACK work to do.
+           */
+
+          if (tcp_polldue(conn))
+            {
+              continue;
+            }
+
+          if ((conn->tcpstateflags & TCP_STATE_MASK) != TCP_ESTABLISHED ||
+              !devif_poll_armed(conn->list, TCP_POLL))
+            {
+              tcp_txpending_remove(conn);
+            }
+        }
+
+      return bstop;
+    }
+#endif
+
+  /* Traverse all of the active TCP connections and perform the poll action.
+   * An expired timer may free the connection, so get the next connection
+   * first.
+   */
+
+  for (conn = tcp_nextconn(NULL); !bstop && conn != NULL; conn = next)
     {
+      next = tcp_nextconn(conn);
+
       /* Perform the TCP TX poll */
 
       tcp_poll(dev, conn);
@@ -462,7 +621,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
   return bstop;
 }
 #else
-# define devif_poll_tcp_connections(dev, callback) (0)
+# define devif_poll_tcp_connections(dev, callback, sweep) (0)
 #endif
 
 /****************************************************************************
@@ -478,7 +637,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-#ifdef NET_TCP_HAVE_STACK
+#if defined(NET_TCP_HAVE_STACK) && !defined(CONFIG_NET_TCP_TIMER_WDOG)
 static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
                                        devif_poll_callback_t callback,
                                        int hsec)
@@ -510,27 +669,12 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: devif_poll
+ * Name: devif_poll_internal
  *
  * Description:
- *   This function will traverse each active network connection structure and
- *   will perform network polling operations. devif_poll() may be called
- *   asynchronously with the network driver can accept another outgoing
- *   packet.
- *
- *   This function will call the provided callback function for every active
- *   connection. Polling will continue until all connections have been polled
- *   or until the user-supplied function returns a non-zero value (which it
- *   should do only if it cannot accept further write data).
- *
- *   When the callback function is called, there may be an outbound packet
- *   waiting for service in the device packet buffer, and if so the d_len field
- *   is set to a value larger than zero. The device driver should then send
- *   out the packet.
+ *   Perform network polling operations for devif_poll() and devif_timer().
+ *   If sweep is true, every connection is polled; otherwise, only the
+ *   connections with Tx work pending on the device may be polled.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -538,7 +682,8 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
+static int devif_poll_internal(FAR struct net_driver_s *dev,
+                               devif_poll_callback_t callback, bool sweep)
 {
   int bstop = false;
 
@@ -585,7 +730,7 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        * action.
        */
 
-      bstop = devif_poll_tcp_connections(dev, callback);
+      bstop = devif_poll_tcp_connections(dev, callback, sweep);
     }
 
   if (!bstop)
@@ -596,7 +741,7 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        * the poll action
        */
 
-      bstop = devif_poll_udp_connections(dev, callback);
+      bstop = devif_poll_udp_connections(dev, callback, sweep);
     }
 
   if (!bstop)
@@ -635,6 +780,43 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   return bstop;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_poll
+ *
+ * Description:
+ *   This function will traverse each active network connection structure and
+ *   will perform network polling operations. devif_poll() may be called
+ *   asynchronously with the network driver can accept another outgoing
+ *   packet.
+ *
+ *   This function will call the provided callback function for every active
+ *   connection. Polling will continue until all connections have been polled
+ *   or until the user-supplied function returns a non-zero value (which it
+ *   should do only if it cannot accept further write data).
+ *
+ *   When the callback function is called, there may be an outbound packet
+ *   waiting for service in the device packet buffer, and if so the d_len field
+ *   is set to a value larger than zero. The device driver should then send
+ *   out the packet.
+ *
+ *   With CONFIG_NETDEV_TXPENDING, only the TCP and UDP connections with Tx
+ *   work pending on this device are polled.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
+{
+  return devif_poll_internal(dev, callback, false);
+}
+
 /****************************************************************************
  * Name: devif_timer
  *
@@ -706,9 +888,10 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        neighbor_periodic(hsec);
 #endif
 
-#ifdef NET_TCP_HAVE_STACK
+#if defined(NET_TCP_HAVE_STACK) && !defined(CONFIG_NET_TCP_TIMER_WDOG)
       /* Traverse all of the active TCP connections and perform the
-       * timer action.
+       * timer action.  With per-connection timers, each connection is
+       * processed by tcp_poll() when its own timer expires.
        */
 
       bstop = devif_poll_tcp_timer(dev, callback, hsec);
@@ -721,7 +904,7 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
   if (!bstop)
     {
-      bstop = devif_poll(dev, callback);
+      bstop = devif_poll_internal(dev, callback, true);
     }
 
   return bstop;
@@ -71,4 +71,5 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
 
   memcpy(dev->d_appdata, buf, len);
   dev->d_sndlen = len;
+  netdev_txiob_clear(dev);
 }
@@ -324,7 +324,11 @@ int ipv4_input(FAR struct net_driver_s *dev)
   uint16_t hdrlen;
   uint16_t iplen;
 
-  /* This is where the input processing starts. */
+  /* This is where the input processing starts.  Any previous outgoing
+   * packet has been consumed.
+   */
+
+  netdev_txiob_clear(dev);
 
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.ipv4.recv++;
@@ -485,7 +489,8 @@ int ipv4_input(FAR struct net_driver_s *dev)
         }
     }
 
-  if (ipv4_chksum(dev) != 0xffff)
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_IPv4_RX) &&
+      ipv4_chksum(dev) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
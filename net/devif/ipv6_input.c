@@ -246,7 +246,11 @@ int ipv6_input(FAR struct net_driver_s *dev)
   int ret;
 #endif
 
-  /* This is where the input processing starts. */
+  /* This is where the input processing starts.  Any previous outgoing
+   * packet has been consumed.
+   */
+
+  netdev_txiob_clear(dev);
 
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.ipv6.recv++;
@@ -121,7 +121,10 @@ void icmp_send(FAR struct net_driver_s *dev, FAR in_addr_t *destaddr)
       /* Calculate IP checksum. */
 
       picmp->ipchksum    = 0;
-      picmp->ipchksum    = ~(ipv4_chksum(dev));
+      if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_IPv4_TX))
+        {
+          picmp->ipchksum = ~(ipv4_chksum(dev));
+        }
 
       /* Calculate the ICMP checksum. */
 
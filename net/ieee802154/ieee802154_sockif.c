@@ -107,6 +107,12 @@ const struct sock_intf_s g_ieee802154_sockif =
   NULL,                   /* si_sendfile */
 #endif
   ieee802154_recvfrom,    /* si_recvfrom */
+#ifdef CONFIG_NET_RECVIOB
+  NULL,                   /* si_recviob */
+#endif
+#ifdef CONFIG_NET_MMSG
+  NULL,                   /* si_sendmmsg */
+#endif
   ieee802154_close        /* si_close */
 };
 
@@ -192,6 +192,34 @@ ssize_t inet_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                       int flags, FAR struct sockaddr *from,
                       FAR socklen_t *fromlen);
 
+/****************************************************************************
+ * Name: inet_recviob
+ *
+ * Description:
+ *   Implements the zero-copy receive interface for the case of the AF_INET
+ *   and AF_INET6 address families:  Remove the oldest I/O buffer chain
+ *   from the TCP or UDP read-ahead queue and return it to the caller.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      The location to return the I/O buffer chain
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned chain.  Zero
+ *   is returned if the TCP peer has performed an orderly shutdown.
+ *   Otherwise, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RECVIOB
+ssize_t inet_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                     int flags, FAR struct sockaddr *from,
+                     FAR socklen_t *fromlen);
+#endif
+
 /****************************************************************************
  * Name: inet_close
  *
@@ -70,6 +70,14 @@
 #include "usrsock/usrsock.h"
 #include "inet/inet.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* How long close() waits for buffered UDP datagrams to be sent (seconds) */
+
+#define UDP_CLOSE_DRAINTIME  3
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -280,6 +288,10 @@ end_wait:
 static inline void tcp_close_txnotify(FAR struct socket *psock,
                                       FAR struct tcp_conn_s *conn)
 {
+  /* Put the connection on its device's Tx pending list */
+
+  tcp_txpending(conn->dev, conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -408,6 +420,12 @@ static inline int tcp_close_disconnect(FAR struct socket *psock)
           conn->crefs = 0;
         }
 
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* Don't hold back corked data that must be sent before the FIN */
+
+      conn->cork = false;
+#endif
+
       /* Notify the device driver of the availability of TX data */
 
       tcp_close_txnotify(psock, conn);
@@ -540,6 +558,11 @@ int inet_close(FAR struct socket *psock)
 
           if (conn->crefs <= 1)
             {
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+              /* Give any buffered datagrams a chance to be sent */
+
+              (void)udp_txdrain(conn, UDP_CLOSE_DRAINTIME);
+#endif
               /* Yes... free the connection structure */
 
               conn->crefs = 0;
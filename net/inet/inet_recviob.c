@@ -0,0 +1,402 @@
+/****************************************************************************
+ * net/inet/inet_recviob.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "socket/socket.h"
+#include "inet/inet.h"
+
+#ifdef CONFIG_NET_RECVIOB
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct inet_recviob_s
+{
+  FAR struct devif_callback_s *ri_cb;   /* Reference to callback instance */
+  sem_t                    ri_sem;      /* Signals arrival of data */
+  int                      ri_result;   /* OK or negated errno */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_recviob_eventhandler
+ *
+ * Description:
+ *   Wake up the waiting thread when data arrives or the connection is lost.
+ *   The data is not consumed here:  The event flags are returned unchanged
+ *   so that the data is added to the read-ahead queue where the waiting
+ *   thread will find it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static uint16_t inet_recviob_eventhandler(FAR struct net_driver_s *dev,
+                                          FAR void *pvconn,
+                                          FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct inet_recviob_s *pstate = (FAR struct inet_recviob_s *)pvpriv;
+
+  ninfo("flags: %04x\n", flags);
+
+  if (pstate != NULL)
+    {
+      if ((flags & NETDEV_DOWN) != 0)
+        {
+          pstate->ri_result = -ENETUNREACH;
+        }
+
+      /* Don't allow any further call backs */
+
+      pstate->ri_cb->flags = 0;
+      pstate->ri_cb->priv  = NULL;
+      pstate->ri_cb->event = NULL;
+
+      sem_post(&pstate->ri_sem);
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: inet_recviob_wait
+ *
+ * Description:
+ *   Wait for the next data or connection event on the callback list.
+ *
+ * Returned Value:
+ *   OK when the caller should check the read-ahead queue again; otherwise
+ *   a negated errno value.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int inet_recviob_wait(FAR struct socket *psock,
+                             FAR struct devif_callback_s *cb,
+                             uint16_t flags)
+{
+  struct inet_recviob_s state;
+#ifdef CONFIG_NET_SOCKOPTS
+  struct timespec abstime;
+#endif
+  int ret;
+
+  if (cb == NULL)
+    {
+      return -EBUSY;
+    }
+
+  (void)sem_init(&state.ri_sem, 0, 0); /* Doesn't really fail */
+  (void)sem_setprotocol(&state.ri_sem, SEM_PRIO_NONE);
+
+  state.ri_cb     = cb;
+  state.ri_result = OK;
+
+  cb->flags       = flags;
+  cb->priv        = (FAR void *)&state;
+  cb->event       = inet_recviob_eventhandler;
+
+#ifdef CONFIG_NET_SOCKOPTS
+  if (psock->s_rcvtimeo != 0)
+    {
+      DEBUGVERIFY(clock_gettime(CLOCK_REALTIME, &abstime));
+
+      abstime.tv_sec  += psock->s_rcvtimeo / DSEC_PER_SEC;
+      abstime.tv_nsec += (psock->s_rcvtimeo % DSEC_PER_SEC) * NSEC_PER_DSEC;
+      if (abstime.tv_nsec >= NSEC_PER_SEC)
+        {
+          abstime.tv_sec++;
+          abstime.tv_nsec -= NSEC_PER_SEC;
+        }
+
+      ret = net_timedwait(&state.ri_sem, &abstime);
+      if (ret == -ETIMEDOUT)
+        {
+          ret = -EAGAIN;
+        }
+    }
+  else
+#endif
+    {
+      ret = net_lockedwait(&state.ri_sem);
+    }
+
+  sem_destroy(&state.ri_sem);
+  return ret < 0 ? ret : state.ri_result;
+}
+
+/****************************************************************************
+ * Name: inet_tcp_recviob
+ *
+ * Description:
+ *   Take the next I/O buffer chain from the TCP read-ahead queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+static ssize_t inet_tcp_recviob(FAR struct socket *psock,
+                                FAR struct iob_s **iobp, int flags)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  FAR struct devif_callback_s *cb;
+  FAR struct iob_s *iob;
+  ssize_t ret;
+
+  net_lock();
+  for (; ; )
+    {
+      /* NOTE that there may be read-ahead data to be retrieved even after
+       * the socket has been disconnected.
+       */
+
+      iob = iob_remove_queue(&conn->readahead);
+      if (iob != NULL)
+        {
+          *iobp = iob;
+          ret   = iob->io_pktlen;
+          break;
+        }
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          /* End-of-file if the peer closed the connection gracefully */
+
+          ret = _SS_ISCLOSED(psock->s_flags) ? 0 : -ENOTCONN;
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      cb  = tcp_callback_alloc(conn);
+      ret = inet_recviob_wait(psock, cb, TCP_NEWDATA | TCP_DISCONN_EVENTS);
+      if (cb != NULL)
+        {
+          tcp_callback_free(conn, cb);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif /* CONFIG_NET_TCP_READAHEAD */
+
+/****************************************************************************
+ * Name: inet_udp_recviob
+ *
+ * Description:
+ *   Take the next datagram from the UDP read-ahead queue.  The sender
+ *   address that precedes the datagram in the chain is removed (and
+ *   returned in 'from').
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+static ssize_t inet_udp_recviob(FAR struct socket *psock,
+                                FAR struct iob_s **iobp, int flags,
+                                FAR struct sockaddr *from,
+                                FAR socklen_t *fromlen)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct devif_callback_s *cb;
+  FAR struct net_driver_s *dev;
+  FAR struct iob_s *iob;
+  uint8_t src_addr_size;
+  ssize_t ret;
+
+  net_lock();
+  for (; ; )
+    {
+      iob = iob_remove_queue(&conn->readahead);
+      if (iob != NULL)
+        {
+          break;
+        }
+
+      if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
+        {
+          net_unlock();
+          return -EAGAIN;
+        }
+
+      dev = udp_find_laddr_device(conn);
+      cb  = udp_callback_alloc(dev, conn);
+      ret = inet_recviob_wait(psock, cb, UDP_NEWDATA | NETDEV_DOWN);
+      if (cb != NULL)
+        {
+          udp_callback_free(dev, conn, cb);
+        }
+
+      if (ret < 0)
+        {
+          net_unlock();
+          return ret;
+        }
+    }
+
+  net_unlock();
+
+  /* Each chain begins with the size of the sender address and the address
+   * (see udp_datahandler()).
+   */
+
+  (void)iob_copyout(&src_addr_size, iob, sizeof(uint8_t), 0);
+  if (from != NULL)
+    {
+      socklen_t addrlen = *fromlen < src_addr_size ?
+                          *fromlen : src_addr_size;
+
+      (void)iob_copyout((FAR uint8_t *)from, iob, addrlen, sizeof(uint8_t));
+      *fromlen = src_addr_size;
+    }
+
+  iob = iob_trimhead(iob, sizeof(uint8_t) + src_addr_size);
+  if (iob == NULL)
+    {
+      /* An empty datagram.  REVISIT:  There is no chain to return. */
+
+      return 0;
+    }
+
+  *iobp = iob;
+  return iob->io_pktlen;
+}
+#endif /* CONFIG_NET_UDP_READAHEAD */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_recviob
+ *
+ * Description:
+ *   Implements the zero-copy receive interface for the case of the AF_INET
+ *   and AF_INET6 address families:  Remove the oldest I/O buffer chain
+ *   from the TCP or UDP read-ahead queue and return it to the caller.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      The location to return the I/O buffer chain
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned chain.  Zero
+ *   is returned if the TCP peer has performed an orderly shutdown.
+ *   Otherwise, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+ssize_t inet_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                     int flags, FAR struct sockaddr *from,
+                     FAR socklen_t *fromlen)
+{
+  ssize_t ret;
+
+  *iob = NULL;
+
+  switch (psock->s_type)
+    {
+#ifdef CONFIG_NET_TCP_READAHEAD
+    case SOCK_STREAM:
+      {
+        ret = inet_tcp_recviob(psock, iob, flags);
+      }
+      break;
+#endif
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+    case SOCK_DGRAM:
+      {
+        ret = inet_udp_recviob(psock, iob, flags, from, fromlen);
+      }
+      break;
+#endif
+
+    default:
+      {
+        nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
+        ret = -EOPNOTSUPP;
+      }
+      break;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_RECVIOB */
@@ -86,6 +86,11 @@ static ssize_t    inet_sendto(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    inet_sendfile(FAR struct socket *psock, FAR struct file *infile,
                     FAR off_t *offset, size_t count);
 #endif
+#ifdef CONFIG_NET_MMSG
+static int        inet_sendmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -110,6 +115,12 @@ const struct sock_intf_s g_inet_sockif =
   inet_sendfile,    /* si_sendfile */
 #endif
   inet_recvfrom,    /* si_recvfrom */
+#ifdef CONFIG_NET_RECVIOB
+  inet_recviob,     /* si_recviob */
+#endif
+#ifdef CONFIG_NET_MMSG
+  inet_sendmmsg,    /* si_sendmmsg */
+#endif
   inet_close        /* si_close */
 };
 
@@ -432,6 +443,13 @@ static int inet_bind(FAR struct socket *psock,
 #ifdef NET_UDP_HAVE_STACK
           /* Bind a UDP/IP datagram socket */
 
+#ifdef CONFIG_NET_UDP_HASH
+          /* Several sockets may share a binding if all of them permit it */
+
+          ((FAR struct udp_conn_s *)psock->s_conn)->reuse =
+            _SO_GETOPT(psock->s_options, SO_REUSEADDR);
+#endif
+
           ret = udp_bind(psock->s_conn, addr);
 
           /* Mark the socket bound */
@@ -1194,13 +1212,49 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
                              size_t count)
 {
 #if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
-  return tcp_sendfile(psock, infile, offset, size_t count);
+  return tcp_sendfile(psock, infile, offset, count);
 #else
   return -ENOSYS;
 #endif
 }
 #endif
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Send a batch of datagrams on a UDP socket.
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, the number of messages sent.  On error, a negated errno
+ *   value is returned.  -ENOSYS is returned if the socket has no batched
+ *   send; psock_sendmmsg() then sends the messages one at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MMSG
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+#if defined(NET_UDP_HAVE_STACK) && !defined(CONFIG_NET_6LOWPAN) && \
+   !defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      return psock_udp_sendmmsg(psock, msgvec, vlen, flags);
+    }
+#endif
+
+  return -ENOSYS;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -44,6 +44,8 @@
 
 #include <stdint.h>
 
+#include <nuttx/net/ip.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -375,5 +377,54 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flowcache_lookup, ipv4_flowcache_add, ipv6_flowcache_lookup,
+ *       and ipv6_flowcache_add
+ *
+ * Description:
+ *   Look up or remember the network device that unicast packets to
+ *   'destipaddr' are forwarded on.  This saves the device and routing
+ *   table searches for each forwarded packet.
+ *
+ * Returned Value:
+ *   ipv[4|6]_flowcache_lookup() returns the egress device or NULL if
+ *   there is no valid entry for the destination.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+#ifdef CONFIG_NET_IPv4
+FAR struct net_driver_s *ipv4_flowcache_lookup(in_addr_t destipaddr);
+void ipv4_flowcache_add(in_addr_t destipaddr, FAR struct net_driver_s *dev);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+FAR struct net_driver_s *
+ipv6_flowcache_lookup(const net_ipv6addr_t destipaddr);
+void ipv6_flowcache_add(const net_ipv6addr_t destipaddr,
+                        FAR struct net_driver_s *dev);
+#endif
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Forget all remembered forwarding decisions.  This must be called
+ *   whenever something that affects the route to a destination changes:
+ *   Routes, device addresses and netmasks, or the set of devices.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flowcache_flush(void);
+#else
+#  define ipfwd_flowcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
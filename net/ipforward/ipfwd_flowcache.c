@@ -0,0 +1,260 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPFORWARD_NFLOWS
+#  define CONFIG_NET_IPFORWARD_NFLOWS 8
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One remembered forwarding decision.  The egress device depends only on
+ * the destination address of a unicast packet, so that is the key.
+ */
+
+struct ipfwd_flow_s
+{
+  FAR struct net_driver_s *f_dev;   /* Egress device (NULL: unused) */
+  uint32_t f_gen;                   /* g_ipfwd_flowgen when entered */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t f_domain;                 /* PF_INET or PF_INET6 */
+#endif
+  union
+  {
+#ifdef CONFIG_NET_IPv4
+    in_addr_t ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+    net_ipv6addr_t ipv6;
+#endif
+  } f_dest;                         /* Destination address */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cache is accessed only with the network locked.  Changing the
+ * configuration just bumps the generation number, which makes every
+ * entry stale at once without needing the network lock.
+ */
+
+static struct ipfwd_flow_s g_ipfwd_flows[CONFIG_NET_IPFORWARD_NFLOWS];
+static volatile uint32_t g_ipfwd_flowgen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_hash
+ *
+ * Description:
+ *   Select the cache entry for a destination address given as 16-bit
+ *   words.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfwd_flow_s *ipfwd_flow_hash(FAR const uint16_t *addr,
+                                                int nwords)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = hash * 31 + addr[i];
+    }
+
+  return &g_ipfwd_flows[hash % CONFIG_NET_IPFORWARD_NFLOWS];
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_valid
+ *
+ * Description:
+ *   Check that an entry belongs to the current configuration and that its
+ *   device is still usable.
+ *
+ ****************************************************************************/
+
+static inline bool ipfwd_flow_valid(FAR struct ipfwd_flow_s *flow,
+                                    uint8_t domain)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (flow->f_domain != domain)
+    {
+      return false;
+    }
+#endif
+
+  return flow->f_dev != NULL && flow->f_gen == g_ipfwd_flowgen &&
+         (flow->f_dev->d_flags & IFF_UP) != 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Forget all remembered forwarding decisions.  This must be called
+ *   whenever something that affects the route to a destination changes:
+ *   Routes, device addresses and netmasks, or the set of devices.
+ *
+ ****************************************************************************/
+
+void ipfwd_flowcache_flush(void)
+{
+  g_ipfwd_flowgen++;
+}
+
+/****************************************************************************
+ * Name: ipv4_flowcache_lookup and ipv4_flowcache_add
+ *
+ * Description:
+ *   Look up or remember the device that unicast packets to 'destipaddr'
+ *   are forwarded on.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+FAR struct net_driver_s *ipv4_flowcache_lookup(in_addr_t destipaddr)
+{
+  FAR struct ipfwd_flow_s *flow =
+    ipfwd_flow_hash((FAR const uint16_t *)&destipaddr, 2);
+
+  if (ipfwd_flow_valid(flow, PF_INET) &&
+      net_ipv4addr_cmp(flow->f_dest.ipv4, destipaddr))
+    {
+      return flow->f_dev;
+    }
+
+  return NULL;
+}
+
+void ipv4_flowcache_add(in_addr_t destipaddr, FAR struct net_driver_s *dev)
+{
+  FAR struct ipfwd_flow_s *flow =
+    ipfwd_flow_hash((FAR const uint16_t *)&destipaddr, 2);
+
+  /* The device of a broadcast depends on the source address, too */
+
+  if (!net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST))
+    {
+#ifdef CONFIG_NET_IPv6
+      flow->f_domain    = PF_INET;
+#endif
+      flow->f_dest.ipv4 = destipaddr;
+      flow->f_gen       = g_ipfwd_flowgen;
+      flow->f_dev       = dev;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv6_flowcache_lookup and ipv6_flowcache_add
+ *
+ * Description:
+ *   Look up or remember the device that unicast packets to 'destipaddr'
+ *   are forwarded on.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+FAR struct net_driver_s *
+ipv6_flowcache_lookup(const net_ipv6addr_t destipaddr)
+{
+  FAR struct ipfwd_flow_s *flow = ipfwd_flow_hash(destipaddr, 8);
+
+  if (ipfwd_flow_valid(flow, PF_INET6) &&
+      net_ipv6addr_cmp(flow->f_dest.ipv6, destipaddr))
+    {
+      return flow->f_dev;
+    }
+
+  return NULL;
+}
+
+void ipv6_flowcache_add(const net_ipv6addr_t destipaddr,
+                        FAR struct net_driver_s *dev)
+{
+  FAR struct ipfwd_flow_s *flow = ipfwd_flow_hash(destipaddr, 8);
+
+  /* The device of a multicast depends on the source address, too */
+
+  if ((destipaddr[0] & HTONS(0xff00)) != HTONS(0xff00))
+    {
+#ifdef CONFIG_NET_IPv4
+      flow->f_domain = PF_INET6;
+#endif
+      net_ipv6addr_copy(flow->f_dest.ipv6, destipaddr);
+      flow->f_gen    = g_ipfwd_flowgen;
+      flow->f_dev    = dev;
+    }
+}
+#endif
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
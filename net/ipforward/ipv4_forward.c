@@ -273,10 +273,10 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
    * where waiting for an IOB is a good idea
    */
 
-  fwd->f_iob = iob_tryalloc(false);
+  fwd->f_iob = iob_tryalloc_user(false, IOB_USER_IPFORWARD);
   if (fwd->f_iob == NULL)
     {
-      nwarn("WARNING: iob_tryalloc() failed\n");
+      nwarn("WARNING: iob_tryalloc_user() failed\n");
       ret = -ENOMEM;
       goto errout_with_fwd;
     }
@@ -436,11 +436,21 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
-  fwddev     = netdev_findby_ipv4addr(srcipaddr, destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  fwddev     = ipv4_flowcache_lookup(destipaddr);
   if (fwddev == NULL)
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      return (ssize_t)-ENETUNREACH;
+      fwddev = netdev_findby_ipv4addr(srcipaddr, destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          return (ssize_t)-ENETUNREACH;
+        }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipv4_flowcache_add(destipaddr, fwddev);
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
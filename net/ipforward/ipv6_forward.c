@@ -414,10 +414,10 @@ static int ipv6_dev_forward(FAR struct net_driver_s *dev,
        * waiting for an IOB is a good idea
        */
 
-      fwd->f_iob = iob_tryalloc(false);
+      fwd->f_iob = iob_tryalloc_user(false, IOB_USER_IPFORWARD);
       if (fwd->f_iob == NULL)
         {
-          nwarn("WARNING: iob_tryalloc() failed\n");
+          nwarn("WARNING: iob_tryalloc_user() failed\n");
           ret = -ENOMEM;
           goto errout_with_fwd;
         }
@@ -573,11 +573,21 @@ int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
 
   /* Search for a device that can forward this packet. */
 
-  fwddev = netdev_findby_ipv6addr(ipv6->srcipaddr, ipv6->destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  fwddev = ipv6_flowcache_lookup(ipv6->destipaddr);
   if (fwddev == NULL)
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      return (ssize_t)-ENETUNREACH;
+      fwddev = netdev_findby_ipv6addr(ipv6->srcipaddr, ipv6->destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          return (ssize_t)-ENETUNREACH;
+        }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipv6_flowcache_add(ipv6->destipaddr, fwddev);
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
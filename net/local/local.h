@@ -76,6 +76,13 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+/* The sender always sends 7 sync bytes, so the header that precedes the
+ * packet data has a fixed size and can be written and read at once.
+ */
+
+#define LOCAL_PREAMBLE_SIZE 8
+#define LOCAL_HDR_SIZE    (LOCAL_PREAMBLE_SIZE + sizeof(uint16_t))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
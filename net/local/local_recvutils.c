@@ -128,7 +128,9 @@ errout:
  * Name: local_sync
  *
  * Description:
- *   Read a sync bytes until the start of the packet is found.
+ *   Read the packet header.  If the header is not found at the current
+ *   position of the FIFO, read sync bytes until the start of the packet is
+ *   found.
  *
  * Parameters:
  *   fd - File descriptor of read-only FIFO.
@@ -141,13 +143,43 @@ errout:
 
 int local_sync(int fd)
 {
+  uint8_t hdr[LOCAL_HDR_SIZE];
   size_t readlen;
   uint16_t pktlen;
   uint8_t sync;
   int ret;
+  int i;
 
-  /* Loop until a valid pre-amble is encountered:  SYNC bytes followed
-   * by one END byte.
+  /* Normally, the FIFO is positioned at the start of a packet and the
+   * whole header can be read at once.
+   */
+
+  readlen = LOCAL_HDR_SIZE;
+  ret     = local_fifo_read(fd, hdr, &readlen);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to read packet header: %d\n", ret);
+      return ret;
+    }
+
+  for (i = 0; i < LOCAL_PREAMBLE_SIZE - 1; i++)
+    {
+      if (hdr[i] != LOCAL_SYNC_BYTE)
+        {
+          break;
+        }
+    }
+
+  if (i == LOCAL_PREAMBLE_SIZE - 1 && hdr[i] == LOCAL_END_BYTE)
+    {
+      memcpy(&pktlen, &hdr[LOCAL_PREAMBLE_SIZE], sizeof(uint16_t));
+      return pktlen;
+    }
+
+  nwarn("WARNING: Lost packet sync\n");
+
+  /* Otherwise, loop until a valid pre-amble is encountered:  SYNC bytes
+   * followed by one END byte.
    */
 
   do
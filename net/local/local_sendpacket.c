@@ -43,18 +43,13 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
 #include "local/local.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#define LOCAL_PREAMBLE_SIZE 8
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -140,24 +135,22 @@ static int local_fifo_write(int fd, FAR const uint8_t *buf, size_t len)
 
 int local_send_packet(int fd, FAR const uint8_t *buf, size_t len)
 {
+  uint8_t hdr[LOCAL_HDR_SIZE];
   uint16_t len16;
   int ret;
 
-  /* Send the packet preamble */
+  /* Send the packet preamble and the packet length with one write */
 
-  ret = local_fifo_write(fd, g_preamble, LOCAL_PREAMBLE_SIZE);
+  len16 = len;
+  memcpy(hdr, g_preamble, LOCAL_PREAMBLE_SIZE);
+  memcpy(&hdr[LOCAL_PREAMBLE_SIZE], &len16, sizeof(uint16_t));
+
+  ret = local_fifo_write(fd, hdr, LOCAL_HDR_SIZE);
   if (ret == OK)
     {
-      /* Send the packet length */
-
-      len16 = len;
-      ret = local_fifo_write(fd, (FAR const uint8_t *)&len16, sizeof(uint16_t));
-      if (ret == OK)
-        {
-          /* Send the packet data */
+      /* Send the packet data */
 
-          ret = local_fifo_write(fd, buf, len);
-        }
+      ret = local_fifo_write(fd, buf, len);
     }
 
   return ret;
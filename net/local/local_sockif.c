@@ -111,6 +111,12 @@ const struct sock_intf_s g_local_sockif =
   NULL,              /* si_sendfile */
 #endif
   local_recvfrom,    /* si_recvfrom */
+#ifdef CONFIG_NET_RECVIOB
+  NULL,              /* si_recviob */
+#endif
+#ifdef CONFIG_NET_MMSG
+  NULL,              /* si_sendmmsg */
+#endif
   local_close        /* si_close */
 };
 
@@ -46,6 +46,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <queue.h>
 
 #include <net/ethernet.h>
 
@@ -64,8 +65,26 @@
 #  define CONFIG_NET_IPv6_NCONF_ENTRIES 8
 #endif
 
+#ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#  define CONFIG_NET_IPv6_NCONF_HASHSIZE 8
+#endif
+
+#if (CONFIG_NET_IPv6_NCONF_HASHSIZE & (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_HASHSIZE must be a power of two
+#endif
+
 #define NEIGHBOR_MAXTIME 128
 
+/* Return the hash chain for an IPv6 address.  The interface identifier in
+ * the low 64 bits of the address is what distinguishes the neighbors of a
+ * link.
+ */
+
+#define NEIGHBOR_HASH(a) \
+  (((a)[4] ^ (a)[5] ^ (a)[6] ^ (a)[7] ^ \
+   (((a)[4] ^ (a)[5] ^ (a)[6] ^ (a)[7]) >> 8)) & \
+   (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -94,6 +113,8 @@ struct neighbor_addr_s
 
 struct neighbor_entry
 {
+  dq_entry_t             ne_node;    /* Supports the use-ordered list */
+  FAR struct neighbor_entry *ne_hnext; /* Next entry in the hash chain */
   net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
   struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
   uint8_t                ne_time;    /* For aging, units of half seconds */
@@ -109,6 +130,15 @@ struct neighbor_entry
 
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Entries that have been added to the table are held in hash chains indexed
+ * by IPv6 address.  All entries are held in a list ordered by use, most
+ * recently used first; the entry at the tail is the one that is replaced.
+ */
+
+extern FAR struct neighbor_entry *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+extern dq_queue_t g_neighbor_lru;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -152,6 +182,22 @@ void neighbor_initialize(void);
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make an entry the most recently used entry in the Neighbor Table.
+ *
+ * Input Parameters:
+ *   neighbor - The table entry that was used
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry *neighbor);
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -177,8 +223,11 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
  *
  * Description:
  *   Find an entry in the Neighbor Table and return its link layer address.
+ *   The entry last found for the device is checked first:  Consecutive
+ *   packets sent through a device usually go to the same neighbor.
  *
  * Input Parameters:
+ *   dev    - The device that will send the packet
  *   ipaddr - The IPv6 address to use in the lookup;
  *
  * Returned Value:
@@ -188,7 +237,8 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
  *
  ****************************************************************************/
 
-FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr);
+FAR const struct neighbor_addr_s *
+  neighbor_lookup(FAR struct net_driver_s *dev, const net_ipv6addr_t ipaddr);
 
 /****************************************************************************
  * Name: neighbor_update
@@ -80,55 +80,63 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry *neighbor;
+  FAR struct neighbor_entry **pptr;
   uint8_t lltype;
-  uint8_t oldest_time;
-  int     oldest_ndx;
-  int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the first unused entry or the oldest used entry. */
+  /* Look for an existing entry for this address. */
 
-  oldest_time = 0;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+       neighbor != NULL;
+       neighbor = neighbor->ne_hnext)
     {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
 
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
+  if (neighbor == NULL)
+    {
+      /* There is none.  Replace the least recently used entry, removing it
+       * from its hash chain (if it was ever added).
+       */
 
-      if (g_neighbors[i].ne_time > oldest_time)
+      neighbor = (FAR struct neighbor_entry *)g_neighbor_lru.tail;
+      DEBUGASSERT(neighbor != NULL);
+
+      for (pptr = &g_neighbor_hash[NEIGHBOR_HASH(neighbor->ne_ipaddr)];
+           *pptr != NULL;
+           pptr = &(*pptr)->ne_hnext)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          if (*pptr == neighbor)
+            {
+              *pptr = neighbor->ne_hnext;
+              break;
+            }
         }
-    }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+
+      pptr               = &g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+      neighbor->ne_hnext = *pptr;
+      *pptr              = neighbor;
+    }
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor_touch(neighbor);
+  neighbor->ne_time = 0;
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -224,7 +224,7 @@ void neighbor_out(FAR struct net_driver_s *dev)
 
       /* Check if we already have this destination address in the Neighbor Table */
 
-      naddr = neighbor_lookup(ipaddr);
+      naddr = neighbor_lookup(dev, ipaddr);
       if (!naddr)
         {
            ninfo("IPv6 Neighbor solicitation for IPv6\n");
@@ -235,6 +235,7 @@ void neighbor_out(FAR struct net_driver_s *dev)
            */
 
           icmpv6_solicit(dev, ipaddr);
+          netdev_txiob_clear(dev);
           return;
         }
 
@@ -70,15 +70,16 @@
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+       neighbor != NULL;
+       neighbor = neighbor->ne_hnext)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
-
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
+          neighbor_touch(neighbor);
           return neighbor;
         }
     }
@@ -86,3 +87,26 @@ FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
 }
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make an entry the most recently used entry in the Neighbor Table.
+ *
+ * Input Parameters:
+ *   neighbor - The table entry that was used
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry *neighbor)
+{
+  if (g_neighbor_lru.head != &neighbor->ne_node)
+    {
+      dq_rem(&neighbor->ne_node, &g_neighbor_lru);
+      dq_addfirst(&neighbor->ne_node, &g_neighbor_lru);
+    }
+}
@@ -56,6 +56,13 @@
 
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash chains of the entries in the table and the list of all entries,
+ * ordered by use.
+ */
+
+FAR struct neighbor_entry *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+dq_queue_t g_neighbor_lru;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,8 +88,17 @@ void neighbor_initialize(void)
 {
   int i;
 
+  dq_init(&g_neighbor_lru);
+
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_time  = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_hnext = NULL;
+      dq_addlast(&g_neighbors[i].ne_node, &g_neighbor_lru);
+    }
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_HASHSIZE; ++i)
+    {
+      g_neighbor_hash[i] = NULL;
     }
 }
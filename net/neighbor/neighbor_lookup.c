@@ -58,24 +58,38 @@
  *
  * Description:
  *   Find an entry in the Neighbor Table and return its link layer address.
+ *   The entry last found for the device is checked first:  Consecutive
+ *   packets sent through a device usually go to the same neighbor.
  *
  * Input Parameters:
+ *   dev    - The device that will send the packet
  *   ipaddr - The IPv6 address to use in the lookup;
- *   lladdr - The location to return the link layer address
  *
  * Returned Value:
- *   Returns OK if the address was successfully obtain; a negated errno
- *   value is returned on failure.
+ *   A read-only reference to the link layer address in the Neighbor Table is
+ *   returned on success.  NULL is returned if there is no matching entry in
+ *   the Neighbor Table.
  *
  ****************************************************************************/
 
-FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr)
+FAR const struct neighbor_addr_s *
+  neighbor_lookup(FAR struct net_driver_s *dev, const net_ipv6addr_t ipaddr)
 {
   FAR struct neighbor_entry *neighbor;
 
+  /* The cached entry may since have been reused for a different address */
+
+  neighbor = dev->d_nbrhit;
+  if (neighbor != NULL && net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+    {
+      neighbor_touch(neighbor);
+      return &neighbor->ne_addr;
+    }
+
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      dev->d_nbrhit = neighbor;
       return &neighbor->ne_addr;
     }
 
@@ -158,6 +158,12 @@ void net_setup(void)
   /* Initialize the UDP connection structures */
 
   udp_initialize();
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  /* Initialize the UDP/IP write buffering */
+
+  udp_wrbuffer_initialize();
+#endif
 #endif
 
 #ifdef CONFIG_NET_IGMP
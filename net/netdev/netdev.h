@@ -62,7 +62,8 @@ extern "C"
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0
 /* List of registered Ethernet device drivers.  You must have the network
- * locked in order to access this list.
+ * or the device list locked (see netdev_lock()) in order to access this
+ * list.  Modifications require both locks.
  *
  * NOTE that this duplicates a declaration in net/tcp/tcp.h
  */
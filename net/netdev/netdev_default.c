@@ -79,7 +79,7 @@ FAR struct net_driver_s *netdev_default(void)
 
   /* Examine each registered network device */
 
-  net_lock();
+  netdev_lock();
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -90,12 +90,12 @@ FAR struct net_driver_s *netdev_default(void)
            * state.
            */
 
-          net_unlock();
+          netdev_unlock();
           return dev;
         }
     }
 
-  net_unlock();
+  netdev_unlock();
   return NULL;
 }
 
@@ -86,7 +86,7 @@ static FAR struct net_driver_s *netdev_finddevice_ipv4addr(in_addr_t ripaddr)
 
   /* Examine each registered network device */
 
-  net_lock();
+  netdev_lock();
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -100,7 +100,7 @@ static FAR struct net_driver_s *netdev_finddevice_ipv4addr(in_addr_t ripaddr)
             {
               /* Its a match */
 
-              net_unlock();
+              netdev_unlock();
               return dev;
             }
         }
@@ -108,7 +108,7 @@ static FAR struct net_driver_s *netdev_finddevice_ipv4addr(in_addr_t ripaddr)
 
   /* No device with the matching address found */
 
-  net_unlock();
+  netdev_unlock();
   return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -140,7 +140,7 @@ netdev_finddevice_ipv6addr(const net_ipv6addr_t ripaddr)
 
   /* Examine each registered network device */
 
-  net_lock();
+  netdev_lock();
   for (dev = g_netdevices; dev; dev = dev->flink)
     {
       /* Is the interface in the "up" state? */
@@ -154,7 +154,7 @@ netdev_finddevice_ipv6addr(const net_ipv6addr_t ripaddr)
             {
               /* Its a match */
 
-              net_unlock();
+              netdev_unlock();
               return dev;
             }
         }
@@ -162,7 +162,7 @@ netdev_finddevice_ipv6addr(const net_ipv6addr_t ripaddr)
 
   /* No device with the matching address found */
 
-  net_unlock();
+  netdev_unlock();
   return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
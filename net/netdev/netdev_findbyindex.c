@@ -79,17 +79,17 @@ FAR struct net_driver_s *netdev_findbyindex(int index)
   FAR struct net_driver_s *dev;
   int i;
 
-  net_lock();
+  netdev_lock();
   for (i = 0, dev = g_netdevices; dev; i++, dev = dev->flink)
     {
       if (i == index)
         {
-          net_unlock();
+          netdev_unlock();
           return dev;
         }
     }
 
-  net_unlock();
+  netdev_unlock();
   return NULL;
 }
 
@@ -0,0 +1,378 @@
+/****************************************************************************
+ * net/netdev/netdev_gro.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF(b,d) ((FAR struct ipv4_hdr_s *)&(b)[NET_LL_HDRLEN(d)])
+#define TCPBUF(b,d)  \
+  ((FAR struct tcp_hdr_s *)&(b)[NET_LL_HDRLEN(d) + IPv4_HDRLEN])
+
+/* The only TCP flags that a mergeable segment may have */
+
+#define GRO_TCPFLAGS (TCP_ACK | TCP_PSH)
+
+/* The headers of a mergeable segment:  No IP or TCP options */
+
+#define GRO_HDRLEN(d) (NET_LL_HDRLEN(d) + IPv4_HDRLEN + TCP_HDRLEN)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gro_input
+ *
+ * Description:
+ *   Pass the packet in d_buf to ipv4_input() and any response to 'xmit'.
+ *
+ ****************************************************************************/
+
+static int gro_input(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t xmit)
+{
+  int ret = OK;
+
+  (void)ipv4_input(dev);
+  if (dev->d_len > 0)
+    {
+      ret = xmit(dev);
+      dev->d_len = 0;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: gro_mergeable
+ *
+ * Description:
+ *   Check if the received packet is a TCP data segment without options,
+ *   addressed to this device and with valid checksums.
+ *
+ * Returned Value:
+ *   The payload length if the segment may be merged; zero otherwise.
+ *
+ ****************************************************************************/
+
+static uint16_t gro_mergeable(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF(dev->d_buf, dev);
+  FAR struct tcp_hdr_s *tcp = TCPBUF(dev->d_buf, dev);
+  uint16_t iplen;
+
+  if (dev->d_len <= GRO_HDRLEN(dev) || ipv4->vhl != 0x45 ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                        dev->d_ipaddr) ||
+      tcp->tcpoffset != (TCP_HDRLEN / 4) << 4 ||
+      (tcp->flags & TCP_CTL & ~GRO_TCPFLAGS) != 0 ||
+      (tcp->flags & TCP_ACK) == 0)
+    {
+      return 0;
+    }
+
+  /* Don't merge a malformed packet (or Ethernet padding) */
+
+  iplen = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+  if (iplen + NET_LL_HDRLEN(dev) > dev->d_len ||
+      iplen <= IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  dev->d_len = iplen + NET_LL_HDRLEN(dev);
+
+  /* The checksums cannot be verified after the segment is merged */
+
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_IPv4_RX) &&
+      ipv4_chksum(dev) != 0xffff)
+    {
+      return 0;
+    }
+
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_TCP_RX) &&
+      tcp_ipv4_chksum(dev) != 0xffff)
+    {
+      return 0;
+    }
+
+  return iplen - IPv4_HDRLEN - TCP_HDRLEN;
+}
+
+/****************************************************************************
+ * Name: gro_sameflow
+ *
+ * Description:
+ *   Check if the received segment is the next in-order segment of the held
+ *   packet with the same ACK number and window.
+ *
+ ****************************************************************************/
+
+static bool gro_sameflow(FAR struct net_driver_s *dev,
+                         FAR struct netdev_gro_s *gro)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF(dev->d_buf, dev);
+  FAR struct tcp_hdr_s *tcp = TCPBUF(dev->d_buf, dev);
+  FAR struct ipv4_hdr_s *hipv4 = IPv4BUF(gro->gr_buf, dev);
+  FAR struct tcp_hdr_s *htcp = TCPBUF(gro->gr_buf, dev);
+
+  return net_ipv4addr_hdrcmp(ipv4->srcipaddr, hipv4->srcipaddr) &&
+         tcp->srcport == htcp->srcport &&
+         tcp->destport == htcp->destport &&
+         memcmp(tcp->ackno, htcp->ackno, 4) == 0 &&
+         memcmp(tcp->wnd, htcp->wnd, 2) == 0 &&
+         (htcp->flags & TCP_PSH) == 0 &&
+         tcp_getsequence(tcp->seqno) == gro->gr_nextseq;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_initialize
+ *
+ * Description:
+ *   Prepare receive coalescing for a device.
+ *
+ * Input Parameters:
+ *   gro     - The coalescing state to initialize
+ *   buffer  - Buffer for the merged packet
+ *   bufsize - Size of the buffer.  Larger than the MTU (but at most 65535)
+ *             for coalescing to be of any use.
+ *
+ ****************************************************************************/
+
+void netdev_gro_initialize(FAR struct netdev_gro_s *gro,
+                           FAR uint8_t *buffer, uint16_t bufsize)
+{
+  DEBUGASSERT(gro != NULL && buffer != NULL);
+
+  memset(gro, 0, sizeof(struct netdev_gro_s));
+  gro->gr_buf     = buffer;
+  gro->gr_bufsize = bufsize;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_input
+ *
+ * Description:
+ *   Called by the driver in place of ipv4_input() for each received IPv4
+ *   packet in d_buf.  An in-order TCP segment of the flow being held is
+ *   merged into the held packet.  Any other packet causes the held packet
+ *   to be passed to ipv4_input(); a segment that may be merged later is
+ *   then held, while other packets are passed to ipv4_input() at once.
+ *
+ *   Each packet passed to ipv4_input() that produces output (d_len > 0)
+ *   is followed by a call to 'xmit', which must do with the response what
+ *   the driver would do after ipv4_input().  Note that d_buf may then be
+ *   the coalescing buffer.
+ *
+ * Input Parameters:
+ *   dev  - The network device with the received packet of d_len bytes
+ *   gro  - The coalescing state of the device
+ *   xmit - Transmits a response
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if 'xmit' failed.  d_len
+ *   is zero on return.
+ *
+ ****************************************************************************/
+
+int netdev_gro_input(FAR struct net_driver_s *dev,
+                     FAR struct netdev_gro_s *gro,
+                     devif_poll_callback_t xmit)
+{
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t paylen;
+  int ret;
+
+  DEBUGASSERT(dev != NULL && gro != NULL && xmit != NULL);
+
+  paylen = gro_mergeable(dev);
+
+  /* Append the payload of the next segment of the held flow */
+
+  if (paylen > 0 && gro->gr_len > 0 && gro_sameflow(dev, gro) &&
+      (uint32_t)gro->gr_len + paylen <= gro->gr_bufsize)
+    {
+      tcp = TCPBUF(dev->d_buf, dev);
+
+      memcpy(&gro->gr_buf[gro->gr_len], &dev->d_buf[GRO_HDRLEN(dev)],
+             paylen);
+
+      /* A segment with PSH set is the last one merged */
+
+      TCPBUF(gro->gr_buf, dev)->flags |= (tcp->flags & TCP_PSH);
+
+      gro->gr_len     += paylen;
+      gro->gr_nextseq += paylen;
+      gro->gr_nsegs++;
+
+      dev->d_len = 0;
+      return OK;
+    }
+
+  /* Anything else ends the merge */
+
+  ret = netdev_gro_flush(dev, gro, xmit);
+
+  if (paylen > 0 && dev->d_len <= gro->gr_bufsize)
+    {
+      /* Hold this segment as the start of a new merge */
+
+      tcp = TCPBUF(dev->d_buf, dev);
+
+      memcpy(gro->gr_buf, dev->d_buf, dev->d_len);
+      gro->gr_len     = dev->d_len;
+      gro->gr_nsegs   = 1;
+      gro->gr_nextseq = tcp_getsequence(tcp->seqno) + paylen;
+
+      dev->d_len = 0;
+      return ret;
+    }
+
+  if (ret == OK)
+    {
+      ret = gro_input(dev, xmit);
+    }
+
+  dev->d_len = 0;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the held packet, if any, to ipv4_input().  The driver calls this
+ *   when no more received packets are ready and before it passes a packet
+ *   to the network in any other way.
+ *
+ * Input Parameters:
+ *   dev  - The network device
+ *   gro  - The coalescing state of the device
+ *   xmit - Transmits a response, as for netdev_gro_input()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if 'xmit' failed.
+ *
+ ****************************************************************************/
+
+int netdev_gro_flush(FAR struct net_driver_s *dev,
+                     FAR struct netdev_gro_s *gro,
+                     devif_poll_callback_t xmit)
+{
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR uint8_t *buf;
+  uint16_t len;
+  uint16_t iplen;
+  uint8_t csumcaps;
+#ifdef CONFIG_NETDEV_IOB_RX
+  FAR struct iob_s *iob;
+#endif
+  int ret;
+
+  DEBUGASSERT(dev != NULL && gro != NULL && xmit != NULL);
+
+  if (gro->gr_len == 0)
+    {
+      return OK;
+    }
+
+  ninfo("Flushing %u bytes in %u segments\n", gro->gr_len, gro->gr_nsegs);
+
+  /* Set the IP length of the merged packet */
+
+  ipv4    = IPv4BUF(gro->gr_buf, dev);
+  iplen   = gro->gr_len - NET_LL_HDRLEN(dev);
+  ipv4->len[0] = iplen >> 8;
+  ipv4->len[1] = iplen & 0xff;
+
+  /* Substitute the merged packet for the one in d_buf.  Its checksums were
+   * verified segment by segment.
+   */
+
+  buf          = dev->d_buf;
+  len          = dev->d_len;
+  csumcaps     = dev->d_csumcaps;
+
+  dev->d_buf      = gro->gr_buf;
+  dev->d_len      = gro->gr_len;
+  dev->d_csumcaps = csumcaps | NETDEV_CSUM_IPv4_RX | NETDEV_CSUM_TCP_RX;
+#ifdef CONFIG_NETDEV_IOB_RX
+  iob             = dev->d_iob;
+  dev->d_iob      = NULL;
+#endif
+
+  gro->gr_len     = 0;
+  ret = gro_input(dev, xmit);
+
+  dev->d_buf      = buf;
+  dev->d_len      = len;
+  dev->d_csumcaps = csumcaps;
+#ifdef CONFIG_NETDEV_IOB_RX
+  dev->d_iob      = iob;
+#endif
+
+  return ret;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
@@ -0,0 +1,287 @@
+/****************************************************************************
+ * net/netdev/netdev_gso.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_TSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gso_ipv4_complete
+ *
+ * Description:
+ *   Finish the IPv4 and TCP headers of one frame of the packet.
+ *
+ * Input Parameters:
+ *   dev  - The network device with the frame of d_len bytes
+ *   tcp  - The TCP header of the frame
+ *   ipid - The IP identification of the frame
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static void gso_ipv4_complete(FAR struct net_driver_s *dev,
+                              FAR struct tcp_hdr_s *tcp, uint16_t ipid)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  uint16_t iplen = dev->d_len - NET_LL_HDRLEN(dev);
+
+  ipv4->len[0]  = iplen >> 8;
+  ipv4->len[1]  = iplen & 0xff;
+  ipv4->ipid[0] = ipid >> 8;
+  ipv4->ipid[1] = ipid & 0xff;
+
+  tcp->tcpchksum = 0;
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_TCP_TX))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
+
+  ipv4->ipchksum = 0;
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_IPv4_TX))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: gso_ipv6_complete
+ *
+ * Description:
+ *   Finish the IPv6 and TCP headers of one frame of the packet.
+ *
+ * Input Parameters:
+ *   dev  - The network device with the frame of d_len bytes
+ *   tcp  - The TCP header of the frame
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static void gso_ipv6_complete(FAR struct net_driver_s *dev,
+                              FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+  uint16_t iplen = dev->d_len - NET_LL_HDRLEN(dev) - IPv6_HDRLEN;
+
+  ipv6->len[0] = iplen >> 8;
+  ipv6->len[1] = iplen & 0xff;
+
+  tcp->tcpchksum = 0;
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_TCP_TX))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gso_segment
+ *
+ * Description:
+ *   Software TCP segmentation for a driver that sets d_tsomax but cannot
+ *   segment in hardware.  Called by the driver in place of transmitting an
+ *   outgoing packet with d_txmss set.  The packet is split into frames of
+ *   up to d_txmss bytes of payload.  Each frame gets a copy of the headers
+ *   with the IP length and identification, the TCP sequence number and
+ *   flags, and the checksums adjusted, and is then passed to 'xmit' in
+ *   d_buf and d_txiob for transmission as any other frame.
+ *
+ * Input Parameters:
+ *   dev  - The network device with the outgoing packet of d_len bytes
+ *   xmit - Transmits one frame (normally with netdev_txsegments())
+ *
+ * Returned Value:
+ *   Zero (OK) on success; otherwise the value returned by 'xmit' that
+ *   stopped segmentation.  The frames that were not sent are recovered by
+ *   TCP retransmission.
+ *
+ ****************************************************************************/
+
+int netdev_gso_segment(FAR struct net_driver_s *dev,
+                       devif_poll_callback_t xmit)
+{
+  uint8_t hdr[NETDEV_TSO_HDRMAX];
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *iob;
+  uint32_t seqno;
+  uint16_t payload;
+  uint16_t hdrlen;
+  uint16_t tcpoff;
+  uint16_t txoffset;
+  uint16_t offset;
+  uint16_t seglen;
+  uint16_t mss;
+#ifdef CONFIG_NET_IPv4
+  uint16_t ipid;
+#endif
+  uint8_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(dev != NULL && xmit != NULL);
+
+  mss = dev->d_txmss;
+  if (mss == 0 || dev->d_txiob == NULL || dev->d_sndlen <= mss)
+    {
+      /* Nothing to segment */
+
+      dev->d_txmss = 0;
+      return xmit(dev);
+    }
+
+  /* Save the headers of the packet and the location of its payload */
+
+  payload  = dev->d_sndlen;
+  hdrlen   = dev->d_len - payload;
+  iob      = dev->d_txiob;
+  txoffset = dev->d_txoffset;
+
+  DEBUGASSERT(hdrlen <= NETDEV_TSO_HDRMAX);
+  memcpy(hdr, dev->d_buf, hdrlen);
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  tcpoff = NET_LL_HDRLEN(dev) +
+           (IFF_IS_IPv6(dev->d_flags) ? IPv6_HDRLEN : IPv4_HDRLEN);
+#elif defined(CONFIG_NET_IPv4)
+  tcpoff = NET_LL_HDRLEN(dev) + IPv4_HDRLEN;
+#else
+  tcpoff = NET_LL_HDRLEN(dev) + IPv6_HDRLEN;
+#endif
+
+  tcp   = (FAR struct tcp_hdr_s *)&hdr[tcpoff];
+  seqno = tcp_getsequence(tcp->seqno);
+  flags = tcp->flags;
+
+#ifdef CONFIG_NET_IPv4
+  ipid  = ((uint16_t)IPv4BUF->ipid[0] << 8) | IPv4BUF->ipid[1];
+#endif
+
+  ninfo("Segmenting %u bytes, mss=%u\n", payload, mss);
+
+  for (offset = 0; offset < payload; offset += seglen)
+    {
+      seglen = payload - offset;
+      if (seglen > mss)
+        {
+          seglen = mss;
+        }
+
+      /* Set up the headers of this frame.  Only the last frame may have
+       * PSH or FIN set.
+       */
+
+      memcpy(dev->d_buf, hdr, hdrlen);
+
+      tcp = (FAR struct tcp_hdr_s *)&dev->d_buf[tcpoff];
+      tcp_setsequence(tcp->seqno, seqno + offset);
+
+      if (offset + seglen < payload)
+        {
+          tcp->flags = flags & ~(TCP_PSH | TCP_FIN);
+        }
+
+      dev->d_len      = hdrlen + seglen;
+      dev->d_sndlen   = seglen;
+      dev->d_txiob    = iob;
+      dev->d_txoffset = txoffset + offset;
+      dev->d_txmss    = 0;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(dev->d_flags))
+#endif
+        {
+          gso_ipv4_complete(dev, tcp, ipid++);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          gso_ipv6_complete(dev, tcp);
+        }
+#endif
+
+      /* And send it */
+
+      ret = xmit(dev);
+      if (ret != 0)
+        {
+          nwarn("WARNING: Segmentation stopped at %u of %u bytes: %d\n",
+                offset, payload, ret);
+          break;
+        }
+    }
+
+  netdev_txiob_clear(dev);
+  dev->d_len    = 0;
+  dev->d_sndlen = 0;
+  return ret;
+}
+
+#endif /* CONFIG_NETDEV_TSO */
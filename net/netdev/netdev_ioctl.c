@@ -62,6 +62,7 @@
 
 #ifdef CONFIG_NET_6LOWPAN
 #  include <nuttx/net/sixlowpan.h>
+#  include "sixlowpan/sixlowpan.h"
 #endif
 
 #ifdef CONFIG_NET_IGMP
@@ -90,6 +91,8 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
+#include "pkt/pkt.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -578,6 +581,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
               ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+              ipfwd_flowcache_flush();
               ret = OK;
             }
         }
@@ -604,6 +608,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
               ioctl_set_ipv4addr(&dev->d_draddr, &req->ifr_dstaddr);
+              ipfwd_flowcache_flush();
               ret = OK;
             }
         }
@@ -639,6 +644,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
               ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+              ipfwd_flowcache_flush();
               ret = OK;
             }
         }
@@ -669,6 +675,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               FAR struct lifreq *lreq = (FAR struct lifreq *)req;
 
               ioctl_set_ipv6addr(dev->d_ipv6addr, &lreq->lifr_addr);
+              ipfwd_flowcache_flush();
               ret = OK;
             }
         }
@@ -699,6 +706,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               FAR struct lifreq *lreq = (FAR struct lifreq *)req;
 
               ioctl_set_ipv6addr(dev->d_ipv6draddr, &lreq->lifr_dstaddr);
+              ipfwd_flowcache_flush();
               ret = OK;
             }
         }
@@ -737,6 +745,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             {
               FAR struct lifreq *lreq = (FAR struct lifreq *)req;
               ioctl_set_ipv6addr(dev->d_ipv6netmask, &lreq->lifr_addr);
+              ipfwd_flowcache_flush();
               ret = OK;
             }
         }
@@ -1058,6 +1067,108 @@ static int netdev_imsf_ioctl(FAR struct socket *psock, int cmd,
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_lowpanctx_ioctl
+ *
+ * Description:
+ *   Perform 6LoWPAN address context specific operations.
+ *
+ * Parameters:
+ *   psock  Socket structure
+ *   cmd    The ioctl command
+ *   req    The argument of the ioctl cmd
+ *
+ * Return:
+ *   >=0 on success (positive non-zero values are cmd-specific)
+ *   Negated errno returned on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_6LOWPAN_COMPRESSION_HC06) && \
+    CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+static int netdev_lowpanctx_ioctl(FAR struct socket *psock, int cmd,
+                                  FAR struct sixlowpan_ctxreq_s *req)
+{
+  int ret;
+
+  /* Execute the command */
+
+  switch (cmd)
+    {
+      case SIOCSLOWPANCTX:  /* Set an address context */
+        ret = req != NULL ?
+              sixlowpan_hc06_setcontext(req->cr_cid, req->cr_prefix) :
+              -EINVAL;
+        break;
+
+      case SIOCDLOWPANCTX:  /* Delete an address context */
+        ret = req != NULL ? sixlowpan_hc06_delcontext(req->cr_cid) :
+              -EINVAL;
+        break;
+
+      case SIOCGLOWPANCTX:  /* Get an address context */
+        ret = req != NULL ?
+              sixlowpan_hc06_getcontext(req->cr_cid, req->cr_prefix) :
+              -EINVAL;
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_pkt_ioctl
+ *
+ * Description:
+ *   Perform packet socket specific operations.
+ *
+ * Parameters:
+ *   psock  Socket structure
+ *   cmd    The ioctl command
+ *   arg    The argument of the ioctl cmd
+ *
+ * Return:
+ *   >=0 on success (positive non-zero values are cmd-specific)
+ *   Negated errno returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_MMAP
+static int netdev_pkt_ioctl(FAR struct socket *psock, int cmd,
+                            unsigned long arg)
+{
+  int ret;
+
+  /* Execute the command */
+
+  switch (cmd)
+    {
+      case FIOC_MMAP:  /* mmap() of the packet socket frame rings */
+        if (psock->s_domain == PF_PACKET && psock->s_conn != NULL)
+          {
+            ret = pkt_ring_mmap((FAR struct pkt_conn_s *)psock->s_conn,
+                                (FAR void **)((uintptr_t)arg));
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_arp_ioctl
  *
@@ -1116,22 +1227,9 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
               FAR struct sockaddr_in *addr =
                 (FAR struct sockaddr_in *)&req->arp_pa;
 
-              /* Find the existing ARP table entry for this protocol address. */
-
-              FAR struct arp_entry *entry = arp_find(addr->sin_addr.s_addr);
-              if (entry != NULL)
-                {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
+              /* Delete the ARP table entry for this protocol address. */
 
-                  entry->at_ipaddr = 0;
-                  ret = OK;
-                }
-              else
-                {
-                  ret = -ENOENT;
-                }
+              ret = arp_delete(addr->sin_addr.s_addr);
             }
           else
             {
@@ -1358,6 +1456,26 @@ int psock_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
 #endif
 #endif
 
+#if defined(CONFIG_NET_6LOWPAN_COMPRESSION_HC06) && \
+    CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+  /* Check for 6LoWPAN address context IOCTL commands */
+
+  if (ret == -ENOTTY)
+    {
+      ret = netdev_lowpanctx_ioctl(psock, cmd,
+               (FAR struct sixlowpan_ctxreq_s *)((uintptr_t)arg));
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Check for packet socket IOCTL commands */
+
+  if (ret == -ENOTTY)
+    {
+      ret = netdev_pkt_ioctl(psock, cmd, arg);
+    }
+#endif
+
 #ifdef CONFIG_NET_IGMP
   /* Check for address filtering commands */
 
@@ -57,6 +57,7 @@
 #include "utils/utils.h"
 #include "igmp/igmp.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -266,11 +267,21 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
 
+#ifdef CONFIG_NETDEV_TXPENDING
+#ifdef CONFIG_NET_TCP
+      dev->d_tcppend = NULL;
+#endif
+#ifdef CONFIG_NET_UDP
+      dev->d_udppend = NULL;
+#endif
+#endif
+
       /* Get the next available device number and assign a device name to
        * the interface
        */
 
       net_lock();
+      netdev_lock();
 
 #ifdef CONFIG_NET_LOOPBACK
       /* The local loopback device is a special case:  There can be only one
@@ -301,12 +312,14 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       dev->flink  = g_netdevices;
       g_netdevices = dev;
+      ipfwd_flowcache_flush();
 
       /* Configure the device for IGMP support */
 
 #ifdef CONFIG_NET_IGMP
       igmp_devinit(dev);
 #endif
+      netdev_unlock();
       net_unlock();
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_DRIVERS_IEEE80211)
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * net/netdev/netdev_rxpoll.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_RXPOLL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NETDEV_RXPOLL_BUDGET
+#  define CONFIG_NETDEV_RXPOLL_BUDGET 16
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxpoll_work
+ *
+ * Description:
+ *   One poll pass:  Receive up to rp_budget frames.  If the budget was used
+ *   up, more frames are probably waiting; then another pass is queued
+ *   behind the work that was queued meanwhile (Tx completion, timers, and
+ *   other devices) so that a receive flood cannot starve it.  Otherwise
+ *   the ring is empty and Rx interrupts are enabled again.
+ *
+ ****************************************************************************/
+
+static void netdev_rxpoll_work(FAR void *arg)
+{
+  FAR struct netdev_rxpoll_s *rxpoll = (FAR struct netdev_rxpoll_s *)arg;
+  FAR struct net_driver_s *dev = rxpoll->rp_dev;
+  unsigned int nframes = 0;
+  int ret;
+
+  net_lock();
+
+  while (nframes < rxpoll->rp_budget)
+    {
+      ret = rxpoll->rp_rxframe(dev);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      nframes++;
+    }
+
+#ifdef CONFIG_NETDEV_STATISTICS
+  dev->d_statistics.rx_polls++;
+  if (nframes > dev->d_statistics.rx_maxbatch)
+    {
+      dev->d_statistics.rx_maxbatch = nframes;
+    }
+
+  if (nframes >= rxpoll->rp_budget)
+    {
+      dev->d_statistics.rx_exhausted++;
+    }
+#endif
+
+  net_unlock();
+
+  if (nframes >= rxpoll->rp_budget)
+    {
+      (void)work_queue(rxpoll->rp_qid, &rxpoll->rp_work, netdev_rxpoll_work,
+                       rxpoll, 0);
+    }
+  else
+    {
+      rxpoll->rp_rxint(dev, true);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_rxpoll_initialize
+ *
+ * Description:
+ *   Prepare budgeted receive polling for a network device.  rp_dev,
+ *   rp_rxframe, and rp_rxint must be set up by the driver before calling
+ *   this.  A budget of zero selects CONFIG_NETDEV_RXPOLL_BUDGET.
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_initialize(FAR struct netdev_rxpoll_s *rxpoll, int qid,
+                              uint16_t budget)
+{
+  DEBUGASSERT(rxpoll != NULL && rxpoll->rp_dev != NULL &&
+              rxpoll->rp_rxframe != NULL && rxpoll->rp_rxint != NULL);
+
+  rxpoll->rp_budget = budget > 0 ? budget : CONFIG_NETDEV_RXPOLL_BUDGET;
+  rxpoll->rp_qid    = (uint8_t)qid;
+  rxpoll->rp_work.worker = NULL;
+}
+
+/****************************************************************************
+ * Name: netdev_rxpoll_schedule
+ *
+ * Description:
+ *   Called from the Rx interrupt handler of the device.  Disables further
+ *   Rx interrupts and schedules a poll pass on the worker thread.
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_schedule(FAR struct netdev_rxpoll_s *rxpoll)
+{
+  rxpoll->rp_rxint(rxpoll->rp_dev, false);
+
+  if (work_available(&rxpoll->rp_work))
+    {
+      (void)work_queue(rxpoll->rp_qid, &rxpoll->rp_work, netdev_rxpoll_work,
+                       rxpoll, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_rxpoll_cancel
+ *
+ * Description:
+ *   Cancel any pending poll pass, e.g. when the device is brought down.
+ *   Rx interrupts are left disabled.
+ *
+ ****************************************************************************/
+
+void netdev_rxpoll_cancel(FAR struct netdev_rxpoll_s *rxpoll)
+{
+  rxpoll->rp_rxint(rxpoll->rp_dev, false);
+  (void)work_cancel(rxpoll->rp_qid, &rxpoll->rp_work);
+}
+
+#endif /* CONFIG_NETDEV_RXPOLL */
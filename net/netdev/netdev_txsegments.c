@@ -0,0 +1,153 @@
+/****************************************************************************
+ * net/netdev/netdev_txsegments.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NETDEV_IOB_TX
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_txsegments
+ *
+ * Description:
+ *   Describe the outgoing frame as a list of contiguous segments for a
+ *   scatter-gather DMA transfer:  The headers in d_buf followed by the
+ *   payload in the I/O buffer chain (if any).  If the frame needs more than
+ *   'nsegs' segments, then the payload is copied into d_buf and a single
+ *   segment is returned.  In either case, the transmit descriptor is
+ *   consumed (d_txiob is cleared).
+ *
+ * Input Parameters:
+ *   dev   - The network device with the outgoing frame of d_len bytes
+ *   segs  - The segment list to be filled in
+ *   nsegs - The number of entries in the segment list (at least one)
+ *
+ * Returned Value:
+ *   The number of segments used.
+ *
+ ****************************************************************************/
+
+int netdev_txsegments(FAR struct net_driver_s *dev,
+                      FAR struct netdev_txseg_s *segs, int nsegs)
+{
+  FAR struct iob_s *iob = dev->d_txiob;
+  unsigned int offset;
+  unsigned int remaining;
+  unsigned int ncopy;
+  uint16_t hdrlen;
+  int nused;
+
+  DEBUGASSERT(dev != NULL && segs != NULL && nsegs > 0);
+
+  /* Without I/O buffer data, the whole frame is in d_buf */
+
+  segs[0].ts_data = dev->d_buf;
+  segs[0].ts_len  = dev->d_len;
+
+  if (iob == NULL || dev->d_sndlen == 0)
+    {
+      dev->d_txiob = NULL;
+      return 1;
+    }
+
+  DEBUGASSERT(dev->d_sndlen < dev->d_len);
+  hdrlen          = dev->d_len - dev->d_sndlen;
+  segs[0].ts_len  = hdrlen;
+  nused           = 1;
+
+  /* Skip to the I/O buffer containing the payload offset */
+
+  offset    = dev->d_txoffset;
+  remaining = dev->d_sndlen;
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  /* Then add one segment for each I/O buffer that holds payload */
+
+  while (iob != NULL && remaining > 0 && nused < nsegs)
+    {
+      ncopy = iob->io_len - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      segs[nused].ts_data = &iob->io_data[iob->io_offset + offset];
+      segs[nused].ts_len  = ncopy;
+      nused++;
+
+      remaining -= ncopy;
+      offset     = 0;
+      iob        = iob->io_flink;
+    }
+
+  if (remaining > 0)
+    {
+      /* Too many segments:  Copy the payload to follow the headers */
+
+      ninfo("Flattening %u bytes\n", dev->d_sndlen);
+
+      iob_copyout(&dev->d_buf[hdrlen], dev->d_txiob, dev->d_sndlen,
+                  dev->d_txoffset);
+
+      segs[0].ts_len = dev->d_len;
+      nused          = 1;
+    }
+
+  dev->d_txiob = NULL;
+  return nused;
+}
+
+#endif /* CONFIG_NETDEV_IOB_TX */
@@ -54,6 +54,9 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -95,6 +98,7 @@ int netdev_unregister(FAR struct net_driver_s *dev)
   if (dev)
     {
       net_lock();
+      netdev_lock();
 
       /* Find the device in the list of known network devices */
 
@@ -122,8 +126,27 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             }
 
           curr->flink = NULL;
+          ipfwd_flowcache_flush();
+
+#ifdef CONFIG_NETDEV_TXPENDING
+          /* Nothing can be sent through this device any more */
+
+#ifdef CONFIG_NET_TCP
+          while (dev->d_tcppend != NULL)
+            {
+              tcp_txpending_remove(dev->d_tcppend);
+            }
+#endif
+#ifdef CONFIG_NET_UDP
+          while (dev->d_udppend != NULL)
+            {
+              udp_txpending_remove(dev->d_udppend);
+            }
+#endif
+#endif
         }
 
+      netdev_unlock();
       net_unlock();
 
 #ifdef CONFIG_NET_ETHERNET
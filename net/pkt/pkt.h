@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #ifdef CONFIG_NET_PKT
@@ -62,9 +63,24 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* State of one frame ring shared with the application */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;   /* Start of the ring (NULL: no ring) */
+  uint32_t   blksize;  /* Size of each block */
+  uint16_t   frmsize;  /* Size of each frame */
+  uint16_t   blkfrms;  /* Number of frames in each block */
+  uint32_t   nframes;  /* Total number of frames */
+  uint32_t   head;     /* Index of the next frame to be used */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
+struct pollfd;           /* Forward reference */
 
 struct pkt_conn_s
 {
@@ -77,6 +93,22 @@ struct pkt_conn_s
   /* Defines the list of packet callbacks */
 
   struct devif_callback_s *list;
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Frame rings shared with the application.  Both rings are held in one
+   * allocation, the RX ring first.
+   */
+
+  FAR uint8_t *ring;        /* The allocation holding both rings */
+  struct pkt_ring_s rxring; /* Receive ring */
+  struct pkt_ring_s txring; /* Transmit ring */
+  bool       mapped;        /* True: The rings have been mmap'ed */
+  bool       losing;        /* True: RX frames were dropped */
+
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds;   /* Thread waiting for RX ring frames */
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -339,6 +371,100 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set a SOL_PACKET level socket option.  PACKET_RX_RING and
+ *   PACKET_TX_RING set up the frame rings that are shared with the
+ *   application.
+ *
+ * Parameters:
+ *   conn      The packet connection
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                   FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Return the address of the frame rings.  This implements mmap() of the
+ *   packet socket through the FIOC_MMAP ioctl command.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn, FAR void **addr);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the received frame into the next free frame of the RX ring.  The
+ *   frame is dropped if the ring is full.
+ *
+ * Returned Value:
+ *   true if the connection has an RX ring and the frame was consumed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send each frame of the TX ring that the application has marked with
+ *   TP_STATUS_SEND_REQUEST.  This is the send(sockfd, NULL, 0, 0) operation
+ *   on a socket with a TX ring.
+ *
+ * Returned Value:
+ *   The number of bytes sent;  a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock);
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Setup or teardown poll() on the RX ring.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int pkt_ring_poll(FAR struct pkt_conn_s *conn, FAR struct pollfd *fds,
+                  bool setup);
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the frame rings of a connection.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+#endif /* CONFIG_NET_PKT_MMAP */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -95,6 +95,15 @@ int pkt_input(struct net_driver_s *dev)
     {
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* If the connection has an RX ring, the frame goes into the ring */
+
+      if (pkt_ring_input(dev, conn))
+        {
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -0,0 +1,599 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/arp.h>
+
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ETHBUF ((FAR struct eth_hdr_s *)dev->d_buf)
+
+/* Offset of the struct sockaddr_ll in each frame */
+
+#define PKT_SLLOFFSET TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the address of frame 'index' of a ring.  Frames never cross a
+ *   block boundary.
+ *
+ ****************************************************************************/
+
+static FAR struct tpacket_hdr *pkt_ring_frame(FAR struct pkt_ring_s *ring,
+                                              uint32_t index)
+{
+  return (FAR struct tpacket_hdr *)
+    (ring->base + (index / ring->blkfrms) * ring->blksize +
+     (index % ring->blkfrms) * ring->frmsize);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_next
+ *
+ * Description:
+ *   Advance the head of a ring to the next frame.
+ *
+ ****************************************************************************/
+
+static inline void pkt_ring_next(FAR struct pkt_ring_s *ring)
+{
+  if (++ring->head >= ring->nframes)
+    {
+      ring->head = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_size
+ *
+ * Description:
+ *   Validate a ring request and return the size of the ring that it
+ *   describes.
+ *
+ * Returned Value:
+ *   The ring size (zero if the request frees the ring);  a negated errno
+ *   value if the request is not valid.
+ *
+ ****************************************************************************/
+
+static ssize_t pkt_ring_size(FAR const struct tpacket_req *req)
+{
+  unsigned int blkfrms;
+
+  if (req->tp_block_nr == 0)
+    {
+      return 0;
+    }
+
+  if (req->tp_frame_size < TPACKET_HDRLEN ||
+      req->tp_frame_size > UINT16_MAX ||
+      (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+      req->tp_block_size < req->tp_frame_size)
+    {
+      return -EINVAL;
+    }
+
+  blkfrms = req->tp_block_size / req->tp_frame_size;
+  if (blkfrms > UINT16_MAX ||
+      req->tp_block_nr > (SSIZE_MAX / req->tp_block_size) ||
+      req->tp_frame_nr != blkfrms * req->tp_block_nr)
+    {
+      return -EINVAL;
+    }
+
+  return (ssize_t)req->tp_block_size * req->tp_block_nr;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Initialize the ring state from a validated ring request.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_setup(FAR struct pkt_ring_s *ring,
+                           FAR const struct tpacket_req *req,
+                           FAR uint8_t *base)
+{
+  if (req->tp_block_nr == 0)
+    {
+      memset(ring, 0, sizeof(struct pkt_ring_s));
+      return;
+    }
+
+  ring->base    = base;
+  ring->blksize = req->tp_block_size;
+  ring->frmsize = req->tp_frame_size;
+  ring->blkfrms = req->tp_block_size / req->tp_frame_size;
+  ring->nframes = req->tp_frame_nr;
+  ring->head    = 0;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_getreq
+ *
+ * Description:
+ *   Return the request that describes the current configuration of a ring.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_getreq(FAR const struct pkt_ring_s *ring,
+                            FAR struct tpacket_req *req)
+{
+  if (ring->base == NULL)
+    {
+      memset(req, 0, sizeof(struct tpacket_req));
+    }
+  else
+    {
+      req->tp_block_size = ring->blksize;
+      req->tp_block_nr   = ring->nframes / ring->blkfrms;
+      req->tp_frame_size = ring->frmsize;
+      req->tp_frame_nr   = ring->nframes;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_notify
+ *
+ * Description:
+ *   Wake up a thread waiting in poll() for RX ring frames.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void pkt_ring_notify(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pollfd *fds = conn->fds;
+
+  if (fds != NULL && (fds->events & POLLIN) != 0)
+    {
+      fds->revents |= POLLIN;
+      sem_post(fds->sem);
+    }
+}
+#else
+#  define pkt_ring_notify(c)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set a SOL_PACKET level socket option.  PACKET_RX_RING and
+ *   PACKET_TX_RING set up the frame rings that are shared with the
+ *   application.
+ *
+ * Parameters:
+ *   conn      The packet connection
+ *   option    identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  struct tpacket_req rxreq;
+  struct tpacket_req txreq;
+  FAR uint8_t *ring;
+  ssize_t rxsize;
+  ssize_t txsize;
+
+  if (option != PACKET_RX_RING && option != PACKET_TX_RING)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len < sizeof(struct tpacket_req))
+    {
+      return -EINVAL;
+    }
+
+  /* The application may be using the rings once they have been mapped */
+
+  if (conn->mapped)
+    {
+      return -EBUSY;
+    }
+
+  /* Both rings are held in one allocation so get the new configuration of
+   * both.
+   */
+
+  pkt_ring_getreq(&conn->rxring, &rxreq);
+  pkt_ring_getreq(&conn->txring, &txreq);
+
+  if (option == PACKET_RX_RING)
+    {
+      memcpy(&rxreq, value, sizeof(struct tpacket_req));
+    }
+  else
+    {
+      memcpy(&txreq, value, sizeof(struct tpacket_req));
+    }
+
+  rxsize = pkt_ring_size(&rxreq);
+  txsize = pkt_ring_size(&txreq);
+
+  if (rxsize < 0 || txsize < 0 || rxsize > SSIZE_MAX - txsize)
+    {
+      return -EINVAL;
+    }
+
+  /* Allocate the rings from memory that is accessible to the application.
+   * Zeroed frames are owned by the kernel (RX) or available (TX).
+   */
+
+  ring = NULL;
+  if (rxsize + txsize > 0)
+    {
+      ring = (FAR uint8_t *)kumm_zalloc(rxsize + txsize);
+      if (ring == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* Replace the old rings */
+
+  net_lock();
+  if (conn->ring != NULL)
+    {
+      kumm_free(conn->ring);
+    }
+
+  conn->ring   = ring;
+  conn->losing = false;
+  pkt_ring_setup(&conn->rxring, &rxreq, ring);
+  pkt_ring_setup(&conn->txring, &txreq, ring + rxsize);
+  net_unlock();
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Return the address of the frame rings.  This implements mmap() of the
+ *   packet socket through the FIOC_MMAP ioctl command.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct pkt_conn_s *conn, FAR void **addr)
+{
+  if (addr == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (conn->ring == NULL)
+    {
+      return -ENODEV;
+    }
+
+  conn->mapped = true;
+  *addr        = conn->ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the received frame into the next free frame of the RX ring.  The
+ *   frame is dropped if the ring is full.
+ *
+ * Returned Value:
+ *   true if the connection has an RX ring and the frame was consumed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  unsigned long status;
+  uint16_t snaplen;
+
+  if (ring->base == NULL)
+    {
+      return false;
+    }
+
+  /* If the application has not yet returned the next frame to the kernel,
+   * the ring is full.  Drop the frame and tell the application when the
+   * next frame is delivered.
+   */
+
+  hdr = pkt_ring_frame(ring, ring->head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      ninfo("RX ring full, frame dropped\n");
+      conn->losing = true;
+      return true;
+    }
+
+  snaplen = ring->frmsize - TPACKET_HDRLEN;
+  if (dev->d_len < snaplen)
+    {
+      snaplen = dev->d_len;
+    }
+
+  memcpy((FAR uint8_t *)hdr + TPACKET_HDRLEN, dev->d_buf, snaplen);
+
+  sll               = (FAR struct sockaddr_ll *)
+                      ((FAR uint8_t *)hdr + PKT_SLLOFFSET);
+  sll->sll_family   = AF_PACKET;
+  sll->sll_protocol = ETHBUF->type;
+  sll->sll_ifindex  = conn->ifindex;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = TPACKET_HDRLEN;
+  hdr->tp_net     = TPACKET_HDRLEN + NET_LL_HDRLEN(dev);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / 1000;
+
+  /* Pass the frame to the application.  The status must be written last. */
+
+  status       = conn->losing ? (TP_STATUS_USER | TP_STATUS_LOSING) :
+                 TP_STATUS_USER;
+  conn->losing = false;
+
+  *(FAR volatile unsigned long *)&hdr->tp_status = status;
+
+  pkt_ring_next(ring);
+  pkt_ring_notify(conn);
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send each frame of the TX ring that the application has marked with
+ *   TP_STATUS_SEND_REQUEST.  This is the send(sockfd, NULL, 0, 0) operation
+ *   on a socket with a TX ring.
+ *
+ * Returned Value:
+ *   The number of bytes sent;  a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR struct pkt_ring_s *ring = &conn->txring;
+  FAR volatile struct tpacket_hdr *hdr;
+  ssize_t total = 0;
+  ssize_t ret;
+  uint32_t i;
+
+  if (ring->base == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Send frames in ring order until a frame is found that has not been
+   * filled by the application.
+   */
+
+  for (i = 0; i < ring->nframes; i++)
+    {
+      hdr = pkt_ring_frame(ring, ring->head);
+      if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+        {
+          break;
+        }
+
+      if (hdr->tp_len == 0 || hdr->tp_len > ring->frmsize - TPACKET_HDRLEN)
+        {
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          pkt_ring_next(ring);
+          continue;
+        }
+
+      hdr->tp_status = TP_STATUS_SENDING;
+      ret = psock_pkt_send(psock, (FAR uint8_t *)hdr + TPACKET_HDRLEN,
+                           hdr->tp_len);
+      if (ret < 0)
+        {
+          /* Leave the frame to be sent on the next call */
+
+          hdr->tp_status = TP_STATUS_SEND_REQUEST;
+          return total > 0 ? total : -get_errno();
+        }
+
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+      total         += ret;
+      pkt_ring_next(ring);
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_poll
+ *
+ * Description:
+ *   Setup or teardown poll() on the RX ring.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int pkt_ring_poll(FAR struct pkt_conn_s *conn, FAR struct pollfd *fds,
+                  bool setup)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_hdr *hdr;
+  int ret = OK;
+
+  if (conn->ring == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  net_lock();
+  if (!setup)
+    {
+      if (conn->fds == fds)
+        {
+          conn->fds = NULL;
+        }
+    }
+  else if (conn->fds != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      conn->fds    = fds;
+      fds->revents = 0;
+
+      /* Frames in the TX ring are sent synchronously, so the ring always
+       * has space when no send is in progress.
+       */
+
+      if (conn->txring.base != NULL)
+        {
+          fds->revents |= (fds->events & POLLOUT);
+        }
+
+      /* Data is available if the most recently filled frame has not been
+       * returned to the kernel.
+       */
+
+      if (ring->base != NULL)
+        {
+          hdr = pkt_ring_frame(ring, ring->head > 0 ? ring->head - 1 :
+                                     ring->nframes - 1);
+          if (hdr->tp_status != TP_STATUS_KERNEL)
+            {
+              fds->revents |= (fds->events & POLLIN);
+            }
+        }
+
+      if (fds->revents != 0)
+        {
+          sem_post(fds->sem);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Free the frame rings of a connection.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  net_lock();
+  if (conn->ring != NULL)
+    {
+      kumm_free(conn->ring);
+    }
+
+  conn->ring   = NULL;
+  conn->mapped = false;
+  conn->losing = false;
+  memset(&conn->rxring, 0, sizeof(struct pkt_ring_s));
+  memset(&conn->txring, 0, sizeof(struct pkt_ring_s));
+#ifndef CONFIG_DISABLE_POLL
+  conn->fds    = NULL;
+#endif
+  net_unlock();
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT && CONFIG_NET_PKT_MMAP */
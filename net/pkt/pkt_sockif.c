@@ -105,6 +105,12 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_sendfile */
 #endif
   pkt_recvfrom,    /* si_recvfrom */
+#ifdef CONFIG_NET_RECVIOB
+  NULL,            /* si_recviob */
+#endif
+#ifdef CONFIG_NET_MMSG
+  NULL,            /* si_sendmmsg */
+#endif
   pkt_close        /* si_close */
 };
 
@@ -481,7 +487,13 @@ int pkt_listen(FAR struct socket *psock, int backlog)
 static int pkt_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
                           bool setup)
 {
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Only sockets with frame rings support poll() */
+
+  return pkt_ring_poll((FAR struct pkt_conn_s *)psock->s_conn, fds, setup);
+#else
   return -ENOSYS;
+#endif
 }
 #endif /* !CONFIG_DISABLE_POLL */
 
@@ -513,6 +525,16 @@ static ssize_t pkt_send(FAR struct socket *psock, FAR const void *buf,
 
   if (psock->s_type == SOCK_RAW)
     {
+#ifdef CONFIG_NET_PKT_MMAP
+      /* send() with no data sends the frames queued in the TX ring */
+
+      if (buf == NULL && len == 0 &&
+          ((FAR struct pkt_conn_s *)psock->s_conn)->txring.base != NULL)
+        {
+          return pkt_ring_send(psock);
+        }
+#endif
+
       /* Raw packet send */
 
       ret = psock_pkt_send(psock, buf, len);
@@ -80,6 +80,10 @@ static int netprocfs_txstatistics_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_RXPOLL)
+static int netprocfs_ringstatistics_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_ringstatistics(FAR struct netprocfs_file_s *netfile);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -108,6 +112,10 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#ifdef CONFIG_NETDEV_RXPOLL
+  netprocfs_ringstatistics_header,
+  netprocfs_ringstatistics,
+#endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -531,6 +539,42 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_ringstatistics_header
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_RXPOLL)
+static int netprocfs_ringstatistics_header(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+
+  return snprintf(netfile->line, NET_LINELEN, "\tRING: %-8s %-8s %-8s %-8s\n",
+                 "Polls", "Exhaust", "MaxBatch", "TxFull");
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_ringstatistics
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_RXPOLL)
+static int netprocfs_ringstatistics(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  return snprintf(netfile->line, NET_LINELEN, "\t      %08lx %08lx %08lx %08lx\n",
+                  (unsigned long)stats->rx_polls,
+                  (unsigned long)stats->rx_exhausted,
+                  (unsigned long)stats->rx_maxbatch,
+                  (unsigned long)stats->tx_ringfull);
+}
+#endif
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
@@ -50,10 +50,41 @@
 
 #include <arch/irq.h>
 
+#include "utils/utils.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_ipv4_mask2pref
+ *
+ * Description:
+ *   Return the prefix length of an IPv4 netmask, or -EINVAL if the '1' bits
+ *   of the netmask are not contiguous.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int net_ipv4_mask2pref(in_addr_t netmask)
+{
+  uint32_t mask = NTOHL(netmask);
+  int plen = 0;
+
+  while ((mask & 0x80000000) != 0)
+    {
+      mask <<= 1;
+      plen++;
+    }
+
+  return mask == 0 ? plen : -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -75,6 +106,18 @@
 int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
+  FAR struct net_route_ipv4_s **pptr;
+  FAR struct route_trie_s *node;
+  int plen;
+
+  /* Routes are looked up by prefix, so the netmask must be contiguous */
+
+  plen = net_ipv4_mask2pref(netmask);
+  if (plen < 0)
+    {
+      nerr("ERROR:  Non-contiguous netmask %08lx\n", (unsigned long)netmask);
+      return plen;
+    }
 
   /* Allocate a route entry */
 
@@ -90,16 +133,41 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_ipv4addr_copy(route->target, target);
   net_ipv4addr_copy(route->netmask, netmask);
   net_ipv4addr_copy(route->router, router);
+  route->tnext = NULL;
   net_ipv4_dumproute("New route", route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  netdev_lock();
+
+  /* Index the new entry by its prefix.  Routes with the same prefix are
+   * tried in the order in which they were added.
+   */
+
+  node = net_routetrie_insert(&g_ipv4_trie, (FAR const uint8_t *)&target,
+                              plen);
+  if (node == NULL)
+    {
+      netdev_unlock();
+      net_freeroute_ipv4(route);
+      return -ENOMEM;
+    }
+
+  pptr = (FAR struct net_route_ipv4_s **)&node->routes;
+  while (*pptr != NULL)
+    {
+      pptr = &(*pptr)->tnext;
+    }
+
+  *pptr       = route;
+  route->node = node;
 
   /* Then add the new entry to the table */
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_ipv4_routes);
-  net_unlock();
+  net_flushroutecache();
+  ipfwd_flowcache_flush();
+  netdev_unlock();
   return OK;
 }
 #endif
@@ -109,6 +177,20 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
                       net_ipv6addr_t router)
 {
   FAR struct net_route_ipv6_s *route;
+  FAR struct net_route_ipv6_s **pptr;
+  FAR struct route_trie_s *node;
+  net_ipv6addr_t mask;
+  int plen;
+
+  /* Routes are looked up by prefix, so the netmask must be contiguous */
+
+  plen = net_ipv6_mask2pref(netmask);
+  net_ipv6_pref2mask(plen, mask);
+  if (!net_ipv6addr_cmp(mask, netmask))
+    {
+      nerr("ERROR:  Non-contiguous netmask\n");
+      return -EINVAL;
+    }
 
   /* Allocate a route entry */
 
@@ -124,16 +206,41 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   net_ipv6addr_copy(route->target, target);
   net_ipv6addr_copy(route->netmask, netmask);
   net_ipv6addr_copy(route->router, router);
+  route->tnext = NULL;
   net_ipv6_dumproute("New route", route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
+
+  netdev_lock();
+
+  /* Index the new entry by its prefix.  Routes with the same prefix are
+   * tried in the order in which they were added.
+   */
+
+  node = net_routetrie_insert(&g_ipv6_trie, (FAR const uint8_t *)target,
+                              plen);
+  if (node == NULL)
+    {
+      netdev_unlock();
+      net_freeroute_ipv6(route);
+      return -ENOMEM;
+    }
+
+  pptr = (FAR struct net_route_ipv6_s **)&node->routes;
+  while (*pptr != NULL)
+    {
+      pptr = &(*pptr)->tnext;
+    }
 
-  net_lock();
+  *pptr       = route;
+  route->node = node;
 
   /* Then add the new entry to the table */
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_ipv6_routes);
-  net_unlock();
+  net_flushroutecache();
+  ipfwd_flowcache_flush();
+  netdev_unlock();
   return OK;
 }
 #endif
@@ -113,6 +113,10 @@ void net_initroute(void)
 {
   int i;
 
+  /* Initialize the prefix tries */
+
+  net_routetrie_initialize();
+
   /* Initialize the routing table and the free list */
 
 #ifdef CONFIG_NET_IPv4
@@ -162,16 +166,16 @@ FAR struct net_route_ipv4_s *net_allocroute_ipv4(void)
 {
   FAR struct net_route_ipv4_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  netdev_lock();
 
   /* Then add the new entry to the table */
 
   route = (FAR struct net_route_ipv4_s *)
     sq_remfirst((FAR sq_queue_t *)&g_freeroutes);
 
-  net_unlock();
+  netdev_unlock();
   return route;
 }
 #endif
@@ -181,16 +185,16 @@ FAR struct net_route_ipv6_s *net_allocroute_ipv6(void)
 {
   FAR struct net_route_ipv6_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  netdev_lock();
 
   /* Then add the new entry to the table */
 
   route = (FAR struct net_route_ipv6_s *)
     sq_remfirst((FAR sq_queue_t *)&g_freeroutes_ipv6);
 
-  net_unlock();
+  netdev_unlock();
   return route;
 }
 #endif
@@ -214,14 +218,14 @@ void net_freeroute_ipv4(FAR struct net_route_ipv4_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  netdev_lock();
 
   /* Then add the new entry to the table */
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_freeroutes);
-  net_unlock();
+  netdev_unlock();
 }
 #endif
 
@@ -230,14 +234,14 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  netdev_lock();
 
   /* Then add the new entry to the table */
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_freeroutes_ipv6);
-  net_unlock();
+  netdev_unlock();
 }
 #endif
 
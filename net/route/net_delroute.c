@@ -48,6 +48,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
@@ -77,6 +78,63 @@ struct route_match_ipv6_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_unindexroute_ipv4 and net_unindexroute_ipv6
+ *
+ * Description:
+ *   Remove a route from the list of routes of its trie node, removing the
+ *   trie node if it holds no other routes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static void net_unindexroute_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  FAR struct route_trie_s *node = route->node;
+  FAR struct net_route_ipv4_s **pptr;
+
+  for (pptr = (FAR struct net_route_ipv4_s **)&node->routes;
+       *pptr != NULL;
+       pptr = &(*pptr)->tnext)
+    {
+      if (*pptr == route)
+        {
+          *pptr = route->tnext;
+          break;
+        }
+    }
+
+  if (node->routes == NULL)
+    {
+      net_routetrie_remove(&g_ipv4_trie, node);
+    }
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static void net_unindexroute_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  FAR struct route_trie_s *node = route->node;
+  FAR struct net_route_ipv6_s **pptr;
+
+  for (pptr = (FAR struct net_route_ipv6_s **)&node->routes;
+       *pptr != NULL;
+       pptr = &(*pptr)->tnext)
+    {
+      if (*pptr == route)
+        {
+          *pptr = route->tnext;
+          break;
+        }
+    }
+
+  if (node->routes == NULL)
+    {
+      net_routetrie_remove(&g_ipv6_trie, node);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: net_match_ipv4
  *
@@ -121,6 +179,12 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
           (void)sq_remfirst((FAR sq_queue_t *)&g_ipv4_routes);
         }
 
+      /* Remove the entry from the prefix trie */
+
+      net_unindexroute_ipv4(route);
+      net_flushroutecache();
+      ipfwd_flowcache_flush();
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -174,6 +238,12 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
           (void)sq_remfirst((FAR sq_queue_t *)&g_ipv6_routes);
         }
 
+      /* Remove the entry from the prefix trie */
+
+      net_unindexroute_ipv6(route);
+      net_flushroutecache();
+      ipfwd_flowcache_flush();
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
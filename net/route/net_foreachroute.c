@@ -78,7 +78,7 @@ int net_foreachroute_ipv4(route_handler_t handler, FAR void *arg)
 
   /* Prevent concurrent access to the routing table */
 
-  net_lock();
+  netdev_lock();
 
   /* Visit each entry in the routing table */
 
@@ -94,9 +94,9 @@ int net_foreachroute_ipv4(route_handler_t handler, FAR void *arg)
       ret  = handler(route, arg);
     }
 
-  /* Unlock the network */
+  /* Unlock the routing table */
 
-  net_unlock();
+  netdev_unlock();
   return ret;
 }
 #endif
@@ -110,7 +110,7 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 
   /* Prevent concurrent access to the routing table */
 
-  net_lock();
+  netdev_lock();
 
   /* Visit each entry in the routing table */
 
@@ -126,9 +126,9 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
       ret  = handler(route, arg);
     }
 
-  /* Unlock the network */
+  /* Unlock the routing table */
 
-  net_unlock();
+  netdev_unlock();
   return ret;
 }
 #endif
@@ -0,0 +1,308 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry in the destination cache */
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+#ifdef CONFIG_NET_IPv4
+struct route_cache_ipv4_s
+{
+  FAR struct net_route_ipv4_s *route; /* The route found (NULL if unused) */
+  FAR struct net_driver_s *dev;       /* The device constraint */
+  in_addr_t target;                   /* The destination address */
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct route_cache_ipv6_s
+{
+  FAR struct net_route_ipv6_s *route; /* The route found (NULL if unused) */
+  FAR struct net_driver_s *dev;       /* The device constraint */
+  net_ipv6addr_t target;              /* The destination address */
+};
+#endif
+#endif /* CONFIG_NET_ROUTE_CACHESIZE > 0 */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The destination caches.  These are direct mapped by destination address.
+ * Only routes that were accepted are cached; a cached route is offered
+ * to the handler again, so a route that no longer satisfies its
+ * constraint is never returned from the cache.
+ */
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+#ifdef CONFIG_NET_IPv4
+static struct route_cache_ipv4_s g_ipv4_routecache[CONFIG_NET_ROUTE_CACHESIZE];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_cache_ipv6_s g_ipv6_routecache[CONFIG_NET_ROUTE_CACHESIZE];
+#endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: route_hash_ipv4 and route_hash_ipv6
+ *
+ * Description:
+ *   Return the destination cache index for an address.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+#ifdef CONFIG_NET_IPv4
+static inline unsigned int route_hash_ipv4(in_addr_t target)
+{
+  uint32_t hash = (uint32_t)target;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & (CONFIG_NET_ROUTE_CACHESIZE - 1);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline unsigned int route_hash_ipv6(FAR const net_ipv6addr_t target)
+{
+  uint16_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash ^= target[i];
+    }
+
+  hash ^= hash >> 8;
+  return hash & (CONFIG_NET_ROUTE_CACHESIZE - 1);
+}
+#endif
+#endif /* CONFIG_NET_ROUTE_CACHESIZE > 0 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Visit the routes whose destination network contains the target
+ *   address, longest prefix first, until the handler returns non-zero.
+ *   Recent results are held in a small destination cache, which is tried
+ *   first.
+ *
+ * Parameters:
+ *   dev     - The device to which the routes are constrained, or NULL.
+ *             This is used only to distinguish entries in the destination
+ *             cache; the handler must apply any constraint.
+ *   target  - The destination address to route.
+ *   handler - Called for each candidate route;  Returns non-zero to accept
+ *             the route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   The accepted route; NULL if the handler accepted no route.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+FAR struct net_route_ipv4_s *
+  net_lpmroute_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                    route_handler_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv4_s *route = NULL;
+  FAR struct route_trie_s *node;
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+  FAR struct route_cache_ipv4_s *cache;
+#endif
+
+  /* Prevent concurrent access to the routing table */
+
+  netdev_lock();
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+  /* Try the destination cache first */
+
+  cache = &g_ipv4_routecache[route_hash_ipv4(target)];
+  if (cache->route != NULL && cache->dev == dev &&
+      net_ipv4addr_cmp(cache->target, target) &&
+      handler(cache->route, arg) != 0)
+    {
+      route = cache->route;
+      goto errout_with_lock;
+    }
+#endif
+
+  /* Then visit the matching prefixes, longest first */
+
+  for (node = net_routetrie_match(g_ipv4_trie, (FAR const uint8_t *)&target,
+                                  32);
+       node != NULL;
+       node = node->parent)
+    {
+      for (route = (FAR struct net_route_ipv4_s *)node->routes;
+           route != NULL;
+           route = route->tnext)
+        {
+          if (handler(route, arg) != 0)
+            {
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+              cache->route = route;
+              cache->dev   = dev;
+              net_ipv4addr_copy(cache->target, target);
+#endif
+              goto errout_with_lock;
+            }
+        }
+    }
+
+  route = NULL;
+
+errout_with_lock:
+  netdev_unlock();
+  return route;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+FAR struct net_route_ipv6_s *
+  net_lpmroute_ipv6(FAR struct net_driver_s *dev,
+                    FAR const net_ipv6addr_t target,
+                    route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct net_route_ipv6_s *route = NULL;
+  FAR struct route_trie_s *node;
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+  FAR struct route_cache_ipv6_s *cache;
+#endif
+
+  /* Prevent concurrent access to the routing table */
+
+  netdev_lock();
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+  /* Try the destination cache first */
+
+  cache = &g_ipv6_routecache[route_hash_ipv6(target)];
+  if (cache->route != NULL && cache->dev == dev &&
+      net_ipv6addr_cmp(cache->target, target) &&
+      handler(cache->route, arg) != 0)
+    {
+      route = cache->route;
+      goto errout_with_lock;
+    }
+#endif
+
+  /* Then visit the matching prefixes, longest first */
+
+  for (node = net_routetrie_match(g_ipv6_trie, (FAR const uint8_t *)target,
+                                  128);
+       node != NULL;
+       node = node->parent)
+    {
+      for (route = (FAR struct net_route_ipv6_s *)node->routes;
+           route != NULL;
+           route = route->tnext)
+        {
+          if (handler(route, arg) != 0)
+            {
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+              cache->route = route;
+              cache->dev   = dev;
+              net_ipv6addr_copy(cache->target, target);
+#endif
+              goto errout_with_lock;
+            }
+        }
+    }
+
+  route = NULL;
+
+errout_with_lock:
+  netdev_unlock();
+  return route;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_flushroutecache
+ *
+ * Description:
+ *   Discard the contents of the destination cache.  This must be called
+ *   whenever the routing table changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+void net_flushroutecache(void)
+{
+  netdev_lock();
+#ifdef CONFIG_NET_IPv4
+  memset(g_ipv4_routecache, 0, sizeof(g_ipv4_routecache));
+#endif
+#ifdef CONFIG_NET_IPv6
+  memset(g_ipv6_routecache, 0, sizeof(g_ipv6_routecache));
+#endif
+  netdev_unlock();
+}
+#endif
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE */
@@ -96,9 +96,8 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 {
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
 
-  /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+  /* To match, the masked target addresses must be the same.  Routes are
+   * offered longest prefix first, so the first match is the best.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
@@ -133,9 +132,8 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 {
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
 
-  /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+  /* To match, the masked target addresses must be the same.  Routes are
+   * offered longest prefix first, so the first match is the best.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
@@ -193,8 +191,7 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
    * address
    */
 
-  ret = net_foreachroute_ipv4(net_ipv4_match, &match);
-  if (ret > 0)
+  if (net_lpmroute_ipv4(NULL, target, net_ipv4_match, &match) != NULL)
     {
       /* We found a route.  Return the router address. */
 
@@ -251,8 +248,7 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
    * address
    */
 
-  ret = net_foreachroute_ipv6(net_ipv6_match, &match);
-  if (ret > 0)
+  if (net_lpmroute_ipv6(NULL, target, net_ipv6_match, &match) != NULL)
     {
       /* We found a route.  Return the router address. */
 
@@ -0,0 +1,392 @@
+/****************************************************************************
+ * net/route/net_routetrie.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each route adds at most one prefix node and one branch node */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define ROUTE_NTRIENODES (4 * CONFIG_NET_MAXROUTES)
+#else
+#  define ROUTE_NTRIENODES (2 * CONFIG_NET_MAXROUTES)
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The roots of the prefix tries that index the routing tables */
+
+#ifdef CONFIG_NET_IPv4
+FAR struct route_trie_s *g_ipv4_trie;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+FAR struct route_trie_s *g_ipv6_trie;
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pre-allocated trie nodes and the list of free nodes (linked through
+ * child[0]).
+ */
+
+static struct route_trie_s g_trienodes[ROUTE_NTRIENODES];
+static FAR struct route_trie_s *g_freetrie;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return bit 'bit' of a key, counting from the most significant bit of
+ *   the first byte.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, int bit)
+{
+  return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits (up to maxbits) that two keys have
+ *   in common.
+ *
+ ****************************************************************************/
+
+static int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                       int maxbits)
+{
+  uint8_t diff;
+  int bit;
+  int i;
+
+  for (i = 0; i < ((maxbits + 7) >> 3); i++)
+    {
+      diff = a[i] ^ b[i];
+      if (diff != 0)
+        {
+          for (bit = i << 3; (diff & 0x80) == 0; bit++)
+            {
+              diff <<= 1;
+            }
+
+          return bit < maxbits ? bit : maxbits;
+        }
+    }
+
+  return maxbits;
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Allocate a trie node for the first 'plen' bits of 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_s *trie_alloc(FAR const uint8_t *key, int plen)
+{
+  FAR struct route_trie_s *node = g_freetrie;
+
+  if (node != NULL)
+    {
+      g_freetrie = node->child[0];
+      memset(node, 0, sizeof(struct route_trie_s));
+
+      memcpy(node->prefix, key, plen >> 3);
+      if ((plen & 7) != 0)
+        {
+          node->prefix[plen >> 3] =
+            key[plen >> 3] & (0xff << (8 - (plen & 7)));
+        }
+
+      node->plen = plen;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_free
+ ****************************************************************************/
+
+static inline void trie_free(FAR struct route_trie_s *node)
+{
+  node->child[0] = g_freetrie;
+  g_freetrie     = node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_routetrie_initialize
+ *
+ * Description:
+ *   Initialize the prefix tries and the pool of trie nodes.
+ *
+ ****************************************************************************/
+
+void net_routetrie_initialize(void)
+{
+  int i;
+
+#ifdef CONFIG_NET_IPv4
+  g_ipv4_trie = NULL;
+#endif
+#ifdef CONFIG_NET_IPv6
+  g_ipv6_trie = NULL;
+#endif
+
+  g_freetrie = NULL;
+  for (i = 0; i < ROUTE_NTRIENODES; i++)
+    {
+      trie_free(&g_trienodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: net_routetrie_insert
+ *
+ * Description:
+ *   Return the trie node for the first 'plen' bits of 'key', adding it to
+ *   the trie if necessary.
+ *
+ * Returned Value:
+ *   The trie node; NULL if no trie node could be allocated.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+FAR struct route_trie_s *net_routetrie_insert(FAR struct route_trie_s **root,
+                                              FAR const uint8_t *key,
+                                              int plen)
+{
+  FAR struct route_trie_s **pptr = root;
+  FAR struct route_trie_s *parent = NULL;
+  FAR struct route_trie_s *node;
+  FAR struct route_trie_s *newnode;
+  FAR struct route_trie_s *branch;
+  int common = 0;
+
+  /* Descend while the prefix of the node is an initial part of the key */
+
+  while ((node = *pptr) != NULL)
+    {
+      common = trie_common(key, node->prefix,
+                           plen < node->plen ? plen : node->plen);
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          return node;
+        }
+
+      parent = node;
+      pptr   = &node->child[trie_bit(key, node->plen)];
+    }
+
+  newnode = trie_alloc(key, plen);
+  if (newnode == NULL)
+    {
+      return NULL;
+    }
+
+  newnode->parent = parent;
+
+  if (node == NULL)
+    {
+      /* Add a new leaf */
+
+      *pptr = newnode;
+    }
+  else if (common == plen)
+    {
+      /* The new prefix is an initial part of the node's prefix.  Insert
+       * the new node above it.
+       */
+
+      newnode->child[trie_bit(node->prefix, plen)] = node;
+      node->parent = newnode;
+      *pptr        = newnode;
+    }
+  else
+    {
+      /* The prefixes differ at bit 'common'.  Add a branch node there. */
+
+      branch = trie_alloc(key, common);
+      if (branch == NULL)
+        {
+          trie_free(newnode);
+          return NULL;
+        }
+
+      branch->parent = parent;
+      branch->child[trie_bit(key, common)] = newnode;
+      branch->child[trie_bit(node->prefix, common)] = node;
+      newnode->parent = branch;
+      node->parent    = branch;
+      *pptr           = branch;
+    }
+
+  return newnode;
+}
+
+/****************************************************************************
+ * Name: net_routetrie_match
+ *
+ * Description:
+ *   Return the deepest trie node whose prefix is an initial part of 'key'.
+ *   The nodes for all shorter matching prefixes are then found by
+ *   following the parent links.
+ *
+ * Returned Value:
+ *   The trie node; NULL if no prefix matches.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+FAR struct route_trie_s *net_routetrie_match(FAR struct route_trie_s *root,
+                                             FAR const uint8_t *key,
+                                             int keybits)
+{
+  FAR struct route_trie_s *match = NULL;
+  FAR struct route_trie_s *node  = root;
+
+  while (node != NULL && node->plen <= keybits &&
+         trie_common(key, node->prefix, node->plen) == node->plen)
+    {
+      match = node;
+      if (node->plen == keybits)
+        {
+          break;
+        }
+
+      node = node->child[trie_bit(key, node->plen)];
+    }
+
+  return match;
+}
+
+/****************************************************************************
+ * Name: net_routetrie_remove
+ *
+ * Description:
+ *   Remove a trie node that no longer holds any routes, together with any
+ *   branch node that is no longer needed.
+ *
+ * Assumptions:
+ *   The routing table is locked.
+ *
+ ****************************************************************************/
+
+void net_routetrie_remove(FAR struct route_trie_s **root,
+                          FAR struct route_trie_s *node)
+{
+  FAR struct route_trie_s *parent;
+  FAR struct route_trie_s *child;
+
+  DEBUGASSERT(node != NULL && node->routes == NULL);
+
+  /* A node without routes is needed only if it has two children */
+
+  while (node->child[0] == NULL || node->child[1] == NULL)
+    {
+      child  = node->child[0] != NULL ? node->child[0] : node->child[1];
+      parent = node->parent;
+
+      if (parent == NULL)
+        {
+          *root = child;
+        }
+      else
+        {
+          parent->child[parent->child[1] == node] = child;
+        }
+
+      if (child != NULL)
+        {
+          child->parent = parent;
+        }
+
+      trie_free(node);
+
+      /* The parent may now be an unnecessary branch node */
+
+      if (parent == NULL || parent->routes != NULL)
+        {
+          break;
+        }
+
+      node = parent;
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE */
@@ -103,8 +103,8 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
   /* To match, (1) the masked target addresses must be the same, and (2) the
    * router address must like on the network provided by the device.
    *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+   * Routes are offered longest prefix first, so the first match is the
+   * best.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask) &&
@@ -146,8 +146,8 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
   /* To match, (1) the masked target addresses must be the same, and (2) the
    * router address must like on the network provided by the device.
    *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+   * Routes are offered longest prefix first, so the first match is the
+   * best.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask) &&
@@ -194,7 +194,6 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
   struct route_ipv4_devmatch_s match;
-  int ret;
 
   /* Set up the comparison structure */
 
@@ -206,8 +205,7 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
    * address using this device.
    */
 
-  ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
-  if (ret > 0)
+  if (net_lpmroute_ipv4(dev, target, net_ipv4_devmatch, &match) != NULL)
     {
       /* We found a route.  Return the router address. */
 
@@ -251,7 +249,6 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR net_ipv6addr_t router)
 {
   struct route_ipv6_devmatch_s match;
-  int ret;
 
   /* Set up the comparison structure */
 
@@ -263,8 +260,7 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
    * address using this device.
    */
 
-  ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
-  if (ret > 0)
+  if (net_lpmroute_ipv6(dev, target, net_ipv6_devmatch, &match) != NULL)
     {
       /* We found a route.  Return the router address. */
 
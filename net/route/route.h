@@ -59,15 +59,49 @@
 #  define CONFIG_NET_MAXROUTES 4
 #endif
 
+#ifndef CONFIG_NET_ROUTE_CACHESIZE
+#  define CONFIG_NET_ROUTE_CACHESIZE 4
+#endif
+
+#if (CONFIG_NET_ROUTE_CACHESIZE & (CONFIG_NET_ROUTE_CACHESIZE - 1)) != 0
+#  error CONFIG_NET_ROUTE_CACHESIZE must be zero or a power of two
+#endif
+
+/* The size of the longest key held in a routing trie */
+
+#ifdef CONFIG_NET_IPv6
+#  define ROUTE_KEYSIZE 16
+#else
+#  define ROUTE_KEYSIZE 4
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+/* The routes are indexed by a path-compressed binary trie of their
+ * destination network prefixes so that the longest matching prefix can be
+ * found in a time that depends on the address length, not on the number
+ * of routes.  A node holds the list of routes for exactly its prefix; a
+ * node that holds no routes is a branch point.
+ */
+
+struct route_trie_s
+{
+  FAR struct route_trie_s *parent;    /* Node with the next shorter prefix */
+  FAR struct route_trie_s *child[2];  /* Nodes with the next bit 0 / 1 */
+  FAR void *routes;                   /* Routes with this prefix, or NULL */
+  uint8_t plen;                       /* Prefix length in bits */
+  uint8_t prefix[ROUTE_KEYSIZE];      /* Prefix (network order) */
+};
+
 /* This structure describes one entry in the routing table */
 
 #ifdef CONFIG_NET_IPv4
 struct net_route_ipv4_s
 {
   FAR struct net_route_ipv4_s *flink; /* Supports a singly linked list */
+  FAR struct net_route_ipv4_s *tnext; /* Next route with the same prefix */
+  FAR struct route_trie_s *node;      /* Trie node for the prefix */
   in_addr_t target;                   /* The destination network */
   in_addr_t netmask;                  /* The network address mask */
   in_addr_t router;                   /* Route packets via this router */
@@ -83,6 +117,8 @@ typedef int (*route_handler_t)(FAR struct net_route_ipv4_s *route,
 struct net_route_ipv6_s
 {
   FAR struct net_route_ipv6_s *flink; /* Supports a singly linked list */
+  FAR struct net_route_ipv6_s *tnext; /* Next route with the same prefix */
+  FAR struct route_trie_s *node;      /* Trie node for the prefix */
   net_ipv6addr_t target;              /* The destination network */
   net_ipv6addr_t netmask;             /* The network address mask */
   net_ipv6addr_t router;              /* Route packets via this router */
@@ -116,6 +152,16 @@ EXTERN sq_queue_t g_ipv4_routes;
 EXTERN sq_queue_t g_ipv6_routes;
 #endif
 
+/* These are the prefix tries that index the routing tables */
+
+#ifdef CONFIG_NET_IPv4
+EXTERN FAR struct route_trie_s *g_ipv4_trie;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+EXTERN FAR struct route_trie_s *g_ipv6_trie;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -347,6 +393,79 @@ int net_foreachroute_ipv4(route_handler_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Visit the routes whose destination network contains the target
+ *   address, longest prefix first, until the handler returns non-zero.
+ *   Recent results are held in a small destination cache, which is tried
+ *   first.
+ *
+ * Parameters:
+ *   dev     - The device to which the routes are constrained, or NULL.
+ *             This is used only to distinguish entries in the destination
+ *             cache; the handler must apply any constraint.
+ *   target  - The destination address to route.
+ *   handler - Called for each candidate route;  Returns non-zero to accept
+ *             the route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   The accepted route; NULL if the handler accepted no route.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+struct net_driver_s;
+FAR struct net_route_ipv4_s *
+  net_lpmroute_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                    route_handler_t handler, FAR void *arg);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct net_driver_s;
+FAR struct net_route_ipv6_s *
+  net_lpmroute_ipv6(FAR struct net_driver_s *dev,
+                    FAR const net_ipv6addr_t target,
+                    route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: net_flushroutecache
+ *
+ * Description:
+ *   Discard the contents of the destination cache.  This must be called
+ *   whenever the routing table changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHESIZE > 0
+void net_flushroutecache(void);
+#else
+#  define net_flushroutecache()
+#endif
+
+/****************************************************************************
+ * Name: net_routetrie_initialize, net_routetrie_insert,
+ *       net_routetrie_match, and net_routetrie_remove
+ *
+ * Description:
+ *   Manage the prefix tries that index the routing tables.  Keys are
+ *   addresses in network order.  See net_routetrie.c.
+ *
+ ****************************************************************************/
+
+void net_routetrie_initialize(void);
+FAR struct route_trie_s *net_routetrie_insert(FAR struct route_trie_s **root,
+                                              FAR const uint8_t *key,
+                                              int plen);
+FAR struct route_trie_s *net_routetrie_match(FAR struct route_trie_s *root,
+                                             FAR const uint8_t *key,
+                                             int keybits);
+void net_routetrie_remove(FAR struct route_trie_s **root,
+                          FAR struct route_trie_s *node);
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
@@ -79,6 +79,35 @@ struct sockaddr;     /* Forward reference */
 
 void sixlowpan_initialize(void);
 
+/****************************************************************************
+ * Name: sixlowpan_hc06_setcontext, sixlowpan_hc06_delcontext, and
+ *       sixlowpan_hc06_getcontext
+ *
+ * Description:
+ *   Set, delete, or get the prefix of an IPHC address context.  These
+ *   implement the SIOCSLOWPANCTX, SIOCDLOWPANCTX, and SIOCGLOWPANCTX ioctl
+ *   commands.
+ *
+ * Input Parameters:
+ *   cid    - The context number
+ *   prefix - The 64-bit prefix of the context (in network order)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the context number is not supported
+ *   or -ENOENT if the context is not in use.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_6LOWPAN_COMPRESSION_HC06) && \
+    CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+int sixlowpan_hc06_setcontext(uint8_t cid, FAR const uint8_t *prefix);
+int sixlowpan_hc06_delcontext(uint8_t cid);
+int sixlowpan_hc06_getcontext(uint8_t cid, FAR uint8_t *prefix);
+#endif
+
 /****************************************************************************
  * Name: psock_6lowpan_tcp_send
  *
@@ -60,6 +60,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
@@ -67,6 +68,7 @@
 #include <nuttx/net/radiodev.h>
 #include <nuttx/net/ip.h>
 
+#include "sixlowpan/sixlowpan.h"
 #include "sixlowpan/sixlowpan_internal.h"
 
 #ifdef CONFIG_NET_6LOWPAN_COMPRESSION_HC06
@@ -91,13 +93,13 @@
  ****************************************************************************/
 
 /* An address context for IPHC address compression each context can have up
- * to 8 bytes
+ * to 8 bytes.  The contexts are indexed by context number.
  */
 
 struct sixlowpan_addrcontext_s
 {
   uint8_t used;       /* Possibly use as prefix-length */
-  uint8_t number;
+  uint8_t number;     /* Context number (same as the index) */
   uint8_t prefix[8];
 };
 
@@ -203,15 +205,10 @@ static FAR struct sixlowpan_addrcontext_s *
    */
 
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-  int i;
-
-  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+  if (number < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT &&
+      g_hc06_addrcontexts[number].used == 1)
     {
-      if ((g_hc06_addrcontexts[i].used == 1) &&
-           g_hc06_addrcontexts[i].number == number)
-        {
-          return &g_hc06_addrcontexts[i];
-        }
+      return &g_hc06_addrcontexts[number];
     }
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 
@@ -554,9 +551,14 @@ static void uncompress_addr(FAR const struct netdev_varaddr_s *addr,
 void sixlowpan_hc06_initialize(void)
 {
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
-#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 1
   int i;
-#endif
+
+  /* Each address context is identified by its index in the table */
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT; i++)
+    {
+      g_hc06_addrcontexts[i].number = i;
+    }
 
   /* Preinitialize any address contexts for better header compression
    * (Saves up to 13 bytes per 6lowpan packet).
@@ -603,6 +605,67 @@ void sixlowpan_hc06_initialize(void)
 #endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 }
 
+/****************************************************************************
+ * Name: sixlowpan_hc06_setcontext, sixlowpan_hc06_delcontext, and
+ *       sixlowpan_hc06_getcontext
+ *
+ * Description:
+ *   Set, delete, or get the prefix of an IPHC address context.  These
+ *   implement the SIOCSLOWPANCTX, SIOCDLOWPANCTX, and SIOCGLOWPANCTX ioctl
+ *   commands.
+ *
+ * Input Parameters:
+ *   cid    - The context number
+ *   prefix - The 64-bit prefix of the context (in network order)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the context number is not supported
+ *   or -ENOENT if the context is not in use.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+int sixlowpan_hc06_setcontext(uint8_t cid, FAR const uint8_t *prefix)
+{
+  if (cid >= CONFIG_NET_6LOWPAN_MAXADDRCONTEXT)
+    {
+      return -EINVAL;
+    }
+
+  memcpy(g_hc06_addrcontexts[cid].prefix, prefix, 8);
+  g_hc06_addrcontexts[cid].used = 1;
+  return OK;
+}
+
+int sixlowpan_hc06_delcontext(uint8_t cid)
+{
+  if (find_addrcontext_bynumber(cid) == NULL)
+    {
+      return cid < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT ? -ENOENT : -EINVAL;
+    }
+
+  g_hc06_addrcontexts[cid].used = 0;
+  return OK;
+}
+
+int sixlowpan_hc06_getcontext(uint8_t cid, FAR uint8_t *prefix)
+{
+  FAR struct sixlowpan_addrcontext_s *addrcontext;
+
+  addrcontext = find_addrcontext_bynumber(cid);
+  if (addrcontext == NULL)
+    {
+      return cid < CONFIG_NET_6LOWPAN_MAXADDRCONTEXT ? -ENOENT : -EINVAL;
+    }
+
+  memcpy(prefix, addrcontext->prefix, 8);
+  return OK;
+}
+#endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
+
 /****************************************************************************
  * Name: sixlowpan_compresshdr_hc06
  *
@@ -662,7 +725,8 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
                                FAR uint8_t *fptr)
 {
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
-  FAR struct sixlowpan_addrcontext_s *addrcontext;
+  FAR struct sixlowpan_addrcontext_s *srccontext = NULL;
+  FAR struct sixlowpan_addrcontext_s *destcontext = NULL;
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -688,18 +752,31 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
    * byte with [ SCI | DCI ]
    */
 
-  /* Check if dest address context exists (for allocating third byte)
-   *
-   * TODO: fix this so that it remembers the looked up values for avoiding two
-   * lookups - or set the lookup values immediately
+  /* Look up the address contexts once.  The source address cannot be
+   * compressed with a context if it is unspecified, nor the destination
+   * address if it is multicast.
+   */
+
+  if (!net_is_addr_unspecified(ipv6->srcipaddr))
+    {
+      srccontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+    }
+
+  if (!net_is_addr_mcast(ipv6->destipaddr))
+    {
+      destcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+    }
+
+  /* Context 0 is used by default.  The third byte with the context
+   * numbers is needed only if another context is used.
    */
 
-  if (find_addrcontext_byprefix(ipv6->destipaddr) != NULL ||
-      find_addrcontext_byprefix(ipv6->srcipaddr) != NULL)
+  if ((srccontext != NULL && srccontext->number != 0) ||
+      (destcontext != NULL && destcontext->number != 0))
     {
       /* set address context flag and increase g_hc06ptr */
 
-      ninfo("Decompressing dest or src ipaddr. Setting CID\n");
+      ninfo("Compressing dest or src ipaddr. Setting CID\n");
       iphc1 |= SIXLOWPAN_IPHC_CID;
       g_hc06ptr++;
     }
@@ -814,15 +891,15 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
       iphc1 |= SIXLOWPAN_IPHC_SAC;
       iphc1 |= SIXLOWPAN_IPHC_SAM_128;
     }
-  else if ((addrcontext = find_addrcontext_byprefix(ipv6->srcipaddr)) != NULL)
+  else if (srccontext != NULL)
     {
       /* Elide the prefix - indicate by CID and set address context + SAC */
 
-      ninfo("Compressing src with address context. Setting CID and SAC context: %d\n",
-            addrcontext->number);
+      ninfo("Compressing src with address context. Setting SAC context: %d\n",
+            srccontext->number);
 
-      iphc1   |= SIXLOWPAN_IPHC_CID | SIXLOWPAN_IPHC_SAC;
-      iphc[2] |= addrcontext->number << 4;
+      iphc1   |= SIXLOWPAN_IPHC_SAC;
+      iphc[2] |= srccontext->number << 4;
 
       /* Compression compare with this nodes address (source) */
 
@@ -915,12 +992,12 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
     {
       /* Address is unicast, try to compress */
 
-      if ((addrcontext =  find_addrcontext_byprefix(ipv6->destipaddr)) != NULL)
+      if (destcontext != NULL)
         {
           /* Elide the prefix */
 
           iphc1   |= SIXLOWPAN_IPHC_DAC;
-          iphc[2] |= addrcontext->number;
+          iphc[2] |= destcontext->number;
 
           /* Compession compare with link adress (destination) */
 
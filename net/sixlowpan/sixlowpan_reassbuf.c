@@ -60,6 +60,11 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Number of hash chains of active reassembly buffers (a power of two) */
+
+#define REASS_HASH_SIZE     16
+#define REASS_HASH_MASK     (REASS_HASH_SIZE - 1)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -71,9 +76,15 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* The active, allocated reassemby buffers are kept in hash chains indexed
+ * by reassembly tag and source address.  They are also kept in a list in
+ * the order that they were allocated so that the oldest can be found
+ * quickly when expired buffers are removed.
+ */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_HASH_SIZE];
+static FAR struct sixlowpan_reassbuf_s *g_oldest_reass;
+static FAR struct sixlowpan_reassbuf_s *g_newest_reass;
 
 /* Pool of pre-allocated reassembly buffer stuctures */
 
@@ -83,6 +94,30 @@ static struct sixlowpan_reassbuf_s g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF]
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the index of the hash chain for a reassembly tag and source
+ *   address.
+ *
+ ****************************************************************************/
+
+static unsigned int
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash = (hash * 31) + fragsrc->nv_addr[i];
+    }
+
+  return (hash ^ (hash >> 8)) & REASS_HASH_MASK;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -135,39 +170,32 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
 static void sixlowpan_reass_expire(void)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
-  FAR struct sixlowpan_reassbuf_s *next;
   systime_t elapsed;
 
-  /* If reassembly timed out, cancel it */
+  /* The active reassembly buffers are in the order that they were
+   * allocated, so expired buffers are always at the head of the list.
+   * Inactive reassembly buffers are also freed.  This is done because the
+   * life the reassembly buffer is not cerain.
+   */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  while ((reass = g_oldest_reass) != NULL)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
-
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
+      if (reass->rb_active)
         {
           /* Get the elpased time of the reassembly */
 
           elapsed = clock_systimer() - reass->rb_time;
-
-          /* If the reassembly has expired, then free the reassembly buffer */
-
-          if (elapsed > NET_6LOWPAN_TIMEOUT)
+          if (elapsed <= NET_6LOWPAN_TIMEOUT)
             {
-              nwarn("WARNING: Reassembly timed out\n");
-              sixlowpan_reass_free(reass);
+              /* This and all later reassemblies have not expired */
+
+              break;
             }
+
+          nwarn("WARNING: Reassembly timed out\n");
         }
+
+      sixlowpan_reass_free(reass);
     }
 }
 
@@ -192,10 +220,14 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
+  unsigned int hash;
 
-  /* Find the reassembly buffer in the list of active reassembly buffers */
+  /* Find the reassembly buffer in its hash chain of active reassembly
+   * buffers.
+   */
 
-  for (prev = NULL, curr = g_active_reass;
+  hash = sixlowpan_reass_hash(reass->rb_reasstag, &reass->rb_fragsrc);
+  for (prev = NULL, curr = g_active_reass[hash];
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -205,19 +237,41 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
   if (curr != NULL)
     {
-      /* Yes.. remove it from the active reassembly buffer list */
+      /* Yes.. remove it from the hash chain */
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          g_active_reass[hash] = reass->rb_flink;
         }
       else
         {
           prev->rb_flink = reass->rb_flink;
         }
+
+      /* And from the list of reassembly buffers in allocation order */
+
+      if (reass->rb_ablink == NULL)
+        {
+          g_oldest_reass = reass->rb_aflink;
+        }
+      else
+        {
+          reass->rb_ablink->rb_aflink = reass->rb_aflink;
+        }
+
+      if (reass->rb_aflink == NULL)
+        {
+          g_newest_reass = reass->rb_ablink;
+        }
+      else
+        {
+          reass->rb_aflink->rb_ablink = reass->rb_ablink;
+        }
     }
 
-  reass->rb_flink = NULL;
+  reass->rb_flink  = NULL;
+  reass->rb_aflink = NULL;
+  reass->rb_ablink = NULL;
 }
 
 /****************************************************************************
@@ -295,13 +349,20 @@ FAR struct sixlowpan_reassbuf_s *
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  unsigned int hash;
   uint8_t pool;
 
-  /* First, removed any expired or inactive reassembly buffers.  This might
-   * free up a pre-allocated buffer for this allocation.
+  /* If the first fragment was retransmitted, then restart the reassembly
+   * in a new buffer.  sixlowpan_reass_find() also removes any expired or
+   * inactive reassembly buffers.  This might free up a pre-allocated
+   * buffer for this allocation.
    */
 
-  sixlowpan_reass_expire();
+  reass = sixlowpan_reass_find(reasstag, fragsrc);
+  if (reass != NULL)
+    {
+      sixlowpan_reass_free(reass);
+    }
 
   /* Now, try the free list first */
 
@@ -339,10 +400,27 @@ FAR struct sixlowpan_reassbuf_s *
       reass->rb_reasstag = reasstag;
       reass->rb_time     = clock_systimer();
 
-      /* Add the reassembly buffer to the list of active reassembly buffers */
+      /* Add the reassembly buffer to its hash chain of active reassembly
+       * buffers.
+       */
+
+      hash                 = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink      = g_active_reass[hash];
+      g_active_reass[hash] = reass;
+
+      /* And at the end of the list in allocation order */
+
+      reass->rb_ablink     = g_newest_reass;
+      if (g_newest_reass == NULL)
+        {
+          g_oldest_reass   = reass;
+        }
+      else
+        {
+          g_newest_reass->rb_aflink = reass;
+        }
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      g_newest_reass       = reass;
     }
 
   return reass;
@@ -372,6 +450,7 @@ FAR struct sixlowpan_reassbuf_s *
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  unsigned int hash;
 
   /* First, removed any expired or inactive reassembly buffers (we don't want
    * to return old reassembly buffer with the same tag)
@@ -380,10 +459,11 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_expire();
 
   /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+   * reassembly buffers of the hash chain.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  hash = sixlowpan_reass_hash(reasstag, fragsrc);
+  for (reass = g_active_reass[hash]; reass != NULL; reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -546,6 +546,13 @@ static uint16_t tcp_send_eventhandler(FAR struct net_driver_s *dev,
           sinfo->s_sent   += sndlen;
           conn->unacked   += sndlen;
 
+          /* The frame does not go through tcp_send(); it carries the
+           * current ACK and needs the retransmission timer.
+           */
+
+          tcp_delack_sent(conn);
+          tcp_update_timer(conn);
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
           /* For compability with buffered send logic */
 
@@ -692,6 +699,7 @@ static int sixlowpan_send_packet(FAR struct socket *psock,
 
           /* Notify the IEEE802.15.4 MAC that we have data to send. */
 
+          tcp_txpending(dev, conn);
           netdev_txnotify_dev(dev);
 
           /* Wait for the send to complete or an error to occur:  NOTES: (1)
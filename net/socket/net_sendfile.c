@@ -46,8 +46,11 @@
 #include <sys/socket.h>
 
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -126,11 +129,11 @@ ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset,
   ssize_t ret;
   int errcode;
 
-  DEBUGASSERT(psock->sock != NULL && infile != NULL);
+  DEBUGASSERT(infile != NULL);
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
-  if (psock != NULL || psock->s_crefs <= 0)
+  if (psock == NULL || psock->s_crefs <= 0)
     {
       nerr("ERROR: Invalid socket\n");
       errcode = EBADF;
@@ -144,30 +147,33 @@ ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset,
    * method in the socket interface.
    */
 
-  DEBUGASSERT(psock->sockif != NULL);
-  if (psock->sockif->s_sendfile == NULL)
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_sendfile == NULL)
     {
+      FAR struct filelist *list;
       int infd;
 
       list = sched_getfiles();
       DEBUGASSERT(list != NULL);
 
-      infd = infile - list->fl_files;
+      infd = files_getfd(list, infile);
       return lib_sendfile(outfd, infd, offset, count);
     }
-  else
-    {
-      /* The address family can handle the optimized file send */
 
-      ret = psock->sockif->s_sendfile(psock, offset, count);
-      if (ret < 0)
-        {
-          set_errno(-ret);
-          return ERROR;
-        }
+  /* The address family can handle the optimized file send */
 
-      return ret;
+  ret = psock->s_sockif->si_sendfile(psock, infile, offset, count);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
     }
+
+  return ret;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
 }
 
 #endif /* CONFIG_NET_SENDFILE */
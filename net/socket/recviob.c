@@ -0,0 +1,137 @@
+/****************************************************************************
+ * net/socket/recviob.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_RECVIOB
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recviob
+ *
+ * Description:
+ *   Receive without copying:  Remove the oldest buffered packet (UDP) or
+ *   segment (TCP) from the socket read-ahead queue and return the I/O
+ *   buffer chain that holds it.  Ownership of the chain passes to the
+ *   caller, who must release it with iob_free_chain().
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   iob      The location to return the I/O buffer chain
+ *   flags    Receive flags
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes in the returned chain.  Zero
+ *   is returned (and no chain) if the TCP peer has performed an orderly
+ *   shutdown.  Otherwise, -1 is returned, and errno is set appropriately
+ *   (see recvfrom() for the list of errors).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recviob(FAR struct socket *psock, FAR struct iob_s **iob,
+                      int flags, FAR struct sockaddr *from,
+                      FAR socklen_t *fromlen)
+{
+  ssize_t ret;
+  int errcode;
+
+  /* Treat as a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  if (iob == NULL || (from != NULL && (fromlen == NULL || *fromlen <= 0)))
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      errcode = EBADF;
+      goto errout;
+    }
+
+  /* The address family indicates its support with a non-NULL si_recviob()
+   * method in the socket interface.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_recviob == NULL)
+    {
+      errcode = EOPNOTSUPP;
+      goto errout;
+    }
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+  ret = psock->s_sockif->si_recviob(psock, iob, flags, from, fromlen);
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  set_errno(errcode);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+#endif /* CONFIG_NET_RECVIOB */
@@ -0,0 +1,314 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_MMSG
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   Receive one message into the I/O vectors of 'msg'.  A message with a
+ *   single I/O vector is received directly by psock_recvfrom(); otherwise
+ *   the message is received into a temporary buffer and then scattered to
+ *   the vectors.  On return, msg_namelen holds the size of the source
+ *   address; msg_controllen and msg_flags are cleared.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to receive into
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On error, -1 is
+ *   returned, and errno is set appropriately (see recvfrom() for the list
+ *   of errors).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  FAR struct sockaddr *from;
+  FAR socklen_t *fromlen;
+  FAR uint8_t *buffer;
+  uint8_t dummy;
+  size_t len;
+  size_t ncopy;
+  ssize_t ret;
+  int i;
+
+  if (msg == NULL || msg->msg_iovlen < 0 ||
+      (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  from    = (FAR struct sockaddr *)msg->msg_name;
+  fromlen = from != NULL ? &msg->msg_namelen : NULL;
+
+  msg->msg_controllen = 0;
+  msg->msg_flags      = 0;
+
+  /* Most messages have one I/O vector that can be received into directly */
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_recvfrom(psock, msg->msg_iov[0].iov_base,
+                            msg->msg_iov[0].iov_len, flags, from, fromlen);
+    }
+
+  /* Otherwise, receive into a temporary buffer */
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  if (len == 0)
+    {
+      buffer = &dummy;
+    }
+  else
+    {
+      buffer = (FAR uint8_t *)kmm_malloc(len);
+      if (buffer == NULL)
+        {
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+    }
+
+  ret = psock_recvfrom(psock, buffer, len, flags, from, fromlen);
+
+  /* Scatter the received data to the I/O vectors */
+
+  for (i = 0, len = 0; ret > 0 && len < (size_t)ret; i++)
+    {
+      ncopy = msg->msg_iov[i].iov_len;
+      if (ncopy > (size_t)ret - len)
+        {
+          ncopy = (size_t)ret - len;
+        }
+
+      memcpy(msg->msg_iov[i].iov_base, &buffer[len], ncopy);
+      len += ncopy;
+    }
+
+  if (buffer != &dummy)
+    {
+      kmm_free(buffer);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' messages.  If MSG_WAITFORONE is set in 'flags',
+ *   only the first receive may block; the call returns as soon as no more
+ *   messages are buffered.  If 'timeout' is not NULL, no further receive is
+ *   started once that much time has passed.  As with Linux, the timeout is
+ *   only checked after each message is received.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  Limit on the time spent receiving, or NULL
+ *
+ * Returned Value:
+ *   The number of messages received.  The number of bytes received for each
+ *   message is returned in its msg_len field.  If no message could be
+ *   received, -1 is returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout)
+{
+  unsigned int nrecvd = 0;
+  systime_t start = 0;
+  systime_t ticks = 0;
+  ssize_t ret;
+  int rflags;
+  int errcode = OK;
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  if (timeout != NULL)
+    {
+      start = clock_systimer();
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+    }
+
+  rflags = flags & ~MSG_WAITFORONE;
+
+  while (nrecvd < vlen)
+    {
+      ret = psock_recvmsg(psock, &msgvec[nrecvd].msg_hdr, rflags);
+      if (ret < 0)
+        {
+          errcode = get_errno();
+          break;
+        }
+
+      msgvec[nrecvd].msg_len = ret;
+      nrecvd++;
+
+      /* With MSG_WAITFORONE, take only what is already buffered */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          rflags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          break;
+        }
+    }
+
+  /* Report an error only if nothing was received */
+
+  if (nrecvd == 0 && errcode != OK)
+    {
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return nrecvd;
+}
+
+/****************************************************************************
+ * Name: recvmsg
+ *
+ * Description:
+ *   Receive one message from a socket into the I/O vectors of 'msg'.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      The message to receive into
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   See psock_recvmsg().
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* recvmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let psock_recvmsg() do all of the work */
+
+  ret = psock_recvmsg(sockfd_socket(sockfd), msg, flags);
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' messages from a socket with one call.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  Limit on the time spent receiving, or NULL
+ *
+ * Returned Value:
+ *   See psock_recvmmsg().
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  ret = psock_recvmmsg(sockfd_socket(sockfd), msgvec, vlen, flags,
+                       timeout);
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET_MMSG */
@@ -123,7 +123,7 @@ ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
   ssize_t ret;
   int errcode;
 
-  DEBUGASSERT(psock != NULL && buf != NULL);
+  DEBUGASSERT(psock != NULL && (buf != NULL || len == 0));
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
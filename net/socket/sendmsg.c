@@ -0,0 +1,304 @@
+/****************************************************************************
+ * net/socket/sendmsg.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET_MMSG
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   Send the message described by 'msg'.  A message with a single I/O
+ *   vector is passed directly to psock_sendto(); otherwise the vectors are
+ *   first gathered into one buffer so that the message is still sent as a
+ *   single datagram.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On error, -1 is
+ *   returned, and errno is set appropriately (see sendto() for the list of
+ *   errors).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                      int flags)
+{
+  FAR const struct sockaddr *to;
+  FAR uint8_t *buffer;
+  uint8_t dummy;
+  size_t len;
+  ssize_t ret;
+  int i;
+
+  if (msg == NULL || msg->msg_iovlen < 0 ||
+      (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  to = (FAR const struct sockaddr *)msg->msg_name;
+
+  /* Most messages have one I/O vector that can be sent as it is */
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_sendto(psock, msg->msg_iov[0].iov_base,
+                          msg->msg_iov[0].iov_len, flags, to,
+                          msg->msg_namelen);
+    }
+
+  /* Otherwise, gather the vectors into a temporary buffer */
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  if (len == 0)
+    {
+      buffer = &dummy;
+    }
+  else
+    {
+      buffer = (FAR uint8_t *)kmm_malloc(len);
+      if (buffer == NULL)
+        {
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+
+      for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+        {
+          memcpy(&buffer[len], msg->msg_iov[i].iov_base,
+                 msg->msg_iov[i].iov_len);
+          len += msg->msg_iov[i].iov_len;
+        }
+    }
+
+  ret = psock_sendto(psock, buffer, len, flags, to, msg->msg_namelen);
+
+  if (buffer != &dummy)
+    {
+      kmm_free(buffer);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   Send up to 'vlen' messages.  If the address family provides a batched
+ *   send (si_sendmmsg), the messages are handed to it so that several of
+ *   them can be queued with one wait; otherwise they are sent one at a time
+ *   with psock_sendmsg().
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent.  The number of bytes sent for each message
+ *   is returned in its msg_len field.  If the first message could not be
+ *   sent, -1 is returned, and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  unsigned int nsent = 0;
+  ssize_t ret;
+  int errcode = OK;
+
+  /* Verify that the psock corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+
+  while (nsent < vlen)
+    {
+      /* Try the batched send of the address family first */
+
+      if (psock->s_sockif->si_sendmmsg != NULL)
+        {
+          ret = psock->s_sockif->si_sendmmsg(psock, &msgvec[nsent],
+                                             vlen - nsent, flags);
+          if (ret > 0)
+            {
+              nsent += ret;
+              continue;
+            }
+          else if (ret != -ENOSYS)
+            {
+              errcode = ret < 0 ? -ret : EIO;
+              break;
+            }
+        }
+
+      /* Send the next message by itself */
+
+      ret = psock_sendmsg(psock, &msgvec[nsent].msg_hdr, flags);
+      if (ret < 0)
+        {
+          errcode = get_errno();
+          break;
+        }
+
+      msgvec[nsent].msg_len = ret;
+      nsent++;
+    }
+
+  /* Report an error only if nothing was sent */
+
+  if (nsent == 0 && errcode != OK)
+    {
+      nerr("ERROR: sendmmsg failed: %d\n", errcode);
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return nsent;
+}
+
+/****************************************************************************
+ * Name: sendmsg
+ *
+ * Description:
+ *   Send the message described by 'msg' on a socket.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      The message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On error, -1 is
+ *   returned, and errno is set appropriately (see sendto() for the list of
+ *   errors).
+ *
+ ****************************************************************************/
+
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* sendmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let psock_sendmsg() do all of the work */
+
+  ret = psock_sendmsg(sockfd_socket(sockfd), msg, flags);
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   Send up to 'vlen' messages on a socket with one call.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   See psock_sendmmsg().
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  ret = psock_sendmmsg(sockfd_socket(sockfd), msgvec, vlen, flags);
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET_MMSG */
@@ -44,6 +44,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <netinet/in.h>
 #include <errno.h>
 #include <debug.h>
 #include <assert.h>
@@ -52,6 +53,8 @@
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
+#include "tcp/tcp.h"
+#include "pkt/pkt.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -110,6 +113,57 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
 {
   int errcode;
 
+#if defined(CONFIG_NET_TCPPROTO_OPTIONS) && defined(NET_TCP_HAVE_STACK)
+  /* TCP protocol level options are handled by the TCP layer */
+
+  if (level == IPPROTO_TCP && psock->s_type == SOCK_STREAM)
+    {
+      int ret;
+
+      if ((psock->s_domain != PF_INET && psock->s_domain != PF_INET6) ||
+          psock->s_conn == NULL)
+        {
+          errcode = ENOPROTOOPT;
+          goto errout;
+        }
+
+      ret = tcp_setsockopt((FAR struct tcp_conn_s *)psock->s_conn, option,
+                           value, value_len);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Packet socket level options are handled by the packet socket layer */
+
+  if (level == SOL_PACKET && psock->s_domain == PF_PACKET)
+    {
+      int ret;
+
+      if (psock->s_conn == NULL)
+        {
+          errcode = ENOPROTOOPT;
+          goto errout;
+        }
+
+      ret = pkt_setsockopt((FAR struct pkt_conn_s *)psock->s_conn, option,
+                           value, value_len);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_SETVALID(option) || !value)
@@ -48,6 +48,18 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 
+#if defined(CONFIG_NET_TCP_TIMER_WDOG) || defined(CONFIG_NET_TCP_DELAYED_ACK)
+#  include <stdbool.h>
+#  include <nuttx/clock.h>
+#  include <nuttx/wdog.h>
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+#  include <stdbool.h>
+#  include <nuttx/clock.h>
+#endif
+
 #if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
 
 /****************************************************************************
@@ -63,6 +75,42 @@
 #  define HAVE_TCP_POLL
 #endif
 
+/* Bits in the tcpoptions field of struct tcp_conn_s.  Each is set if the
+ * option was sent by the peer in its SYN and will be honored.
+ */
+
+#define TCP_OPTF_WSCALE  (1 << 0) /* Window scaling in use */
+#define TCP_OPTF_SACK    (1 << 1) /* SACK permitted by both ends */
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+/* Values of the tmrclass field of struct tcp_conn_s */
+
+#  define TCP_TMR_NONE   0        /* No timer is needed */
+#  define TCP_TMR_RTO    1        /* 'timer' counts down to a retransmission */
+#  define TCP_TMR_WAIT   2        /* 'timer' counts up to the TIME_WAIT timeout */
+
+/* Restart the accounting of 'timer' after it has been assigned a new value */
+
+#  define tcp_timer_rebase(conn) \
+  do { (conn)->tmrbase = clock_systimer(); } while (0)
+#else
+#  define tcp_timer_rebase(conn)
+#endif
+
+/* True if a watchdog has marked work that must be done on the next poll of
+ * the connection's device.
+ */
+
+#if defined(CONFIG_NET_TCP_TIMER_WDOG) && defined(CONFIG_NET_TCP_DELAYED_ACK)
+#  define tcp_polldue(conn) ((conn)->tmrdue || (conn)->ackdue)
+#elif defined(CONFIG_NET_TCP_TIMER_WDOG)
+#  define tcp_polldue(conn) ((conn)->tmrdue)
+#elif defined(CONFIG_NET_TCP_DELAYED_ACK)
+#  define tcp_polldue(conn) ((conn)->ackdue)
+#else
+#  define tcp_polldue(conn) false
+#endif
+
 /* Allocate a new TCP data callback */
 
 /* These macros allocate and free callback structures used for receiving
@@ -81,6 +129,7 @@
 #  define WRB_PKTLEN(wrb)         ((wrb)->wb_iob->io_pktlen)
 #  define WRB_SENT(wrb)           ((wrb)->wb_sent)
 #  define WRB_NRTX(wrb)           ((wrb)->wb_nrtx)
+#  define WRB_SACKED(wrb)         ((wrb)->wb_sacked)
 #  define WRB_IOB(wrb)            ((wrb)->wb_iob)
 #  define WRB_COPYOUT(wrb,dest,n) (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define WRB_COPYIN(wrb,src,n)   (iob_copyin((wrb)->wb_iob,src,(n),0,false))
@@ -113,10 +162,15 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_cc_ops_s;      /* Forward reference */
 
 struct tcp_conn_s
 {
   dq_entry_t node;        /* Implements a doubly linked list */
+#ifdef CONFIG_NET_TCP_CONNHASH
+  FAR struct tcp_conn_s *hnext; /* Next in the active connection hash chain */
+  FAR struct tcp_conn_s *pnext; /* Next in the local port hash chain */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -138,7 +192,18 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE) || defined(CONFIG_NET_TCP_SACK)
+  uint8_t  tcpoptions;    /* Options agreed with the peer (TCP_OPTF_*) */
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t  snd_wscale;    /* Shift count applied to the peer's window */
+  uint8_t  rcv_wscale;    /* Shift count applied to our advertised window */
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -152,6 +217,56 @@ struct tcp_conn_s
 
   FAR struct net_driver_s *dev;
 
+#ifdef CONFIG_NETDEV_TXPENDING
+  FAR struct net_driver_s *txdev; /* Device whose pending list holds us */
+  FAR struct tcp_conn_s *txnext;  /* Next in the device's pending list */
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+  /* Per-connection timer.
+   *
+   *   tmrwdog  - Expires when the retransmission or TIME_WAIT timer is due
+   *   tmrwork  - Defers the expiry from the watchdog to the work queue
+   *   tmrbase  - The system time at which 'timer' was last up to date
+   *   tmrdue   - The timer has expired; process it on the next device poll
+   *   tmrclass - What the timer is measuring (see TCP_TMR_* definitions)
+   */
+
+  struct wdog_s tmrwdog;
+  struct work_s tmrwork;
+  systime_t tmrbase;
+  bool      tmrdue;
+  uint8_t   tmrclass;
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Delayed ACKs.
+   *
+   *   ackwdog     - Expires when a delayed ACK must be sent
+   *   ackwork     - Defers the expiry from the watchdog to the work queue
+   *   rcv_unacked - Number of bytes received but not yet ACKed
+   *   ackdue      - The delayed ACK must be sent on the next device poll
+   *   quickack    - Delayed ACKs are disabled (TCP_QUICKACK)
+   */
+
+  struct wdog_s ackwdog;
+  struct work_s ackwork;
+  uint32_t  rcv_unacked;
+  bool      ackdue;
+  bool      quickack;
+#endif
+
+#ifdef CONFIG_NET_TCP_NAGLE
+  /* Coalescing of small writes.
+   *
+   *   nodelay - The Nagle algorithm is disabled (TCP_NODELAY)
+   *   cork    - Send only full-sized segments (TCP_CORK)
+   */
+
+  bool      nodelay;
+  bool      cork;
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Read-ahead buffering.
    *
@@ -181,6 +296,29 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control
+   *
+   *   cc_ops - The congestion control algorithm in use.  The algorithm
+   *            governs the growth of cwnd on new ACKs and its reduction on
+   *            loss; slow start, fast retransmit and NewReno fast recovery
+   *            are common to all algorithms (see tcp_cc.c).
+   */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+  uint32_t   cwnd;        /* Congestion window (bytes) */
+  uint32_t   ssthresh;    /* Slow start threshold (bytes) */
+  uint32_t   cc_lastack;  /* Last cumulative ACK number received */
+  uint32_t   cc_recover;  /* Highest sequence sent on entering recovery */
+  uint8_t    cc_dupacks;  /* Count of consecutive duplicate ACKs */
+  bool       cc_recovery; /* True: In fast recovery */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t   cc_wmax;     /* Window before the last reduction (bytes) */
+  uint32_t   cc_k;        /* Time to grow back to cc_wmax (msec) */
+  uint32_t   cc_epoch;    /* Start of the growth epoch (msec), 0=none */
+#endif
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -252,10 +390,33 @@ struct tcp_wrbuffer_s
   uint16_t   wb_sent;      /* Number of bytes sent from the I/O buffer chain */
   uint8_t    wb_nrtx;      /* The number of retransmissions for the last
                             * segment sent */
+#ifdef CONFIG_NET_TCP_SACK
+  bool       wb_sacked;    /* The entire segment has been SACKed */
+#endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
 #endif
 
+/* Congestion control algorithm operations.  These are called with the
+ * network locked.
+ *
+ *   init     - Initialize algorithm-specific state when the connection is
+ *              established (cwnd and ssthresh are already initialized).
+ *   ack      - 'acked' bytes of new data were ACKed outside of recovery;
+ *              grow cwnd.
+ *   ssthresh - A loss was detected (duplicate ACKs or a retransmission
+ *              timeout); return the new slow start threshold.
+ */
+
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_cc_ops_s
+{
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*ack)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+#endif
+
 /* Support for listen backlog:
  *
  *   struct tcp_blcontainer_s describes one backlogged connection
@@ -277,6 +438,40 @@ struct tcp_backlog_s
 };
 #endif
 
+/* The TCP options received in a SYN or SYNACK segment */
+
+struct tcp_synopts_s
+{
+  uint16_t mss;           /* MSS requested by the peer (capped) */
+  uint8_t  tcpoptions;    /* Options sent by the peer (TCP_OPTF_*) */
+  uint8_t  snd_wscale;    /* Window scale shift count sent by the peer */
+};
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+/* An entry in the SYN cache.  A listener answers a SYN with a SYNACK
+ * built from one of these entries; a connection structure is not
+ * allocated until the handshake is completed by the peer's ACK.
+ */
+
+struct tcp_syncache_s
+{
+  union ip_binding_u u;   /* IP address binding */
+  systime_t time;         /* Time when the first SYN was received */
+  uint8_t  rcvseq[4];     /* The sequence number that we expect to receive next */
+  uint8_t  isn[4];        /* The initial sequence number of our SYNACK */
+  uint16_t lport;         /* The local TCP port, in network byte order */
+  uint16_t rport;         /* The remote TCP port, in network byte order */
+  struct tcp_synopts_s opts; /* Options in the peer's SYN */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t  rcv_wscale;    /* Shift count offered in our SYNACK */
+#endif
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
+#endif
+  bool     inuse;         /* True: The entry holds a connection request */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -299,6 +494,15 @@ extern "C"
 EXTERN struct net_driver_s *g_netdevices;
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+/* Congestion control algorithms */
+
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -470,6 +674,52 @@ int tcp_remote_ipv6_device(FAR struct tcp_conn_s *conn);
 FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
                                         FAR struct tcp_hdr_s *tcp);
 
+/****************************************************************************
+ * Name: tcp_syncache_add
+ *
+ * Description:
+ *   Record the SYN in the device buffer that was received by a listener.
+ *   An existing entry is returned if the SYN is a retransmission.  If
+ *   the cache is full, the oldest entry is replaced.
+ *
+ * Returned Value:
+ *   The SYN cache entry for the connection request.  The mss field of
+ *   the options holds the default MSS on return from a new entry.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+FAR struct tcp_syncache_s *tcp_syncache_add(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_hdr_s *tcp);
+#endif
+
+/****************************************************************************
+ * Name: tcp_syncache_accept
+ *
+ * Description:
+ *   Called for a segment that matches neither an active connection nor a
+ *   SYN to a listener.  If the segment is the ACK that completes the
+ *   handshake of a SYN cache entry, a connection structure is allocated
+ *   for it in the TCP_SYN_RCVD state, just as if it had been allocated
+ *   by tcp_alloc_accept() when the SYN was received.  A RST removes the
+ *   matching entry.
+ *
+ * Returned Value:
+ *   The new connection or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+FAR struct tcp_conn_s *tcp_syncache_accept(FAR struct net_driver_s *dev,
+                                           FAR struct tcp_hdr_s *tcp);
+#endif
+
 /****************************************************************************
  * Name: tcp_bind
  *
@@ -734,6 +984,54 @@ void tcp_nextsequence(void);
 
 void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Add a TCP connection to the list of connections with Tx work pending
+ *   on a device.  A connection is in at most one such list; if it is
+ *   already pending on a different device, it is moved.
+ *
+ * Parameters:
+ *   dev - The device that will send the pending output
+ *   conn - The TCP connection with pending output
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+void tcp_txpending(FAR struct net_driver_s *dev,
+                   FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_txpending(dev,conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_txpending_remove
+ *
+ * Description:
+ *   Remove a TCP connection from the pending list that it is in, if any.
+ *
+ * Parameters:
+ *   conn - The TCP connection
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+void tcp_txpending_remove(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_timer
  *
@@ -756,6 +1054,217 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                int hsec);
 
+/****************************************************************************
+ * Name: tcp_update_timer
+ *
+ * Description:
+ *   Start, restart or cancel the per-connection watchdog timer to match
+ *   the current state of the connection.  This must be called whenever the
+ *   state, the amount of unacknowledged data, or the 'timer' field of the
+ *   connection changes.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+void tcp_update_timer(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_update_timer(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_timer_elapsed
+ *
+ * Description:
+ *   Return the number of whole half seconds that have elapsed since the
+ *   'timer' field was last brought up to date, and advance the base time
+ *   by that amount.  The caller must apply the returned value to 'timer'.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   The elapsed time in half seconds
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+int tcp_timer_elapsed(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timer_cancel
+ *
+ * Description:
+ *   Stop the per-connection timer when the connection is freed.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+void tcp_timer_cancel(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_delack
+ *
+ * Description:
+ *   Decide whether the ACK for newly received data may be delayed.  If so,
+ *   the TCP_SNDACK flag is cleared from the returned flags and the delayed
+ *   ACK timer is started.  If received data was not accepted and an ACK is
+ *   already pending, TCP_SNDACK is set so that the pending ACK is sent now.
+ *
+ * Parameters:
+ *   dev    - The device driver structure
+ *   conn   - The TCP connection structure
+ *   result - The flags returned by the application callback
+ *   len    - The number of bytes of new data in the received segment
+ *
+ * Returned Value:
+ *   The possibly modified flags
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+uint16_t tcp_delack(FAR struct net_driver_s *dev,
+                    FAR struct tcp_conn_s *conn, uint16_t result,
+                    uint16_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_delack_sent
+ *
+ * Description:
+ *   Called whenever a segment carrying an ACK is sent on the connection.
+ *   Any pending delayed ACK is satisfied by that segment.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_delack_sent(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_delack_sent(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_delack_flush
+ *
+ * Description:
+ *   If an ACK is being delayed, mark it due and ask the connection's device
+ *   for a poll so that it is sent without waiting for the timer.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_delack_flush(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_delack_cancel
+ *
+ * Description:
+ *   Stop the delayed ACK timer when the connection is freed.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_delack_cancel(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_setsockopt
+ *
+ * Description:
+ *   Set an IPPROTO_TCP level socket option on a TCP connection.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   option - The option to set (see netinet/tcp.h)
+ *   value  - The value of the option
+ *   len    - The length of the option value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+int tcp_setsockopt(FAR struct tcp_conn_s *conn, int option,
+                   FAR const void *value, socklen_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_getsockopt
+ *
+ * Description:
+ *   Get the value of an IPPROTO_TCP level socket option.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   option - The option to get (see netinet/tcp.h)
+ *   value  - Location to return the value of the option
+ *   len    - On input, the size of 'value'; on return, the size of the
+ *            value returned
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+int tcp_getsockopt(FAR struct tcp_conn_s *conn, int option,
+                   FAR void *value, FAR socklen_t *len);
+#endif
+
 /****************************************************************************
  * Name: tcp_listen_initialize
  *
@@ -872,13 +1381,17 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
  *
  * Description:
  *   The tcp_sendfile() call may be used only when the INET socket is in a
- *   connected state (so that the intended recipient is known).
+ *   connected state (so that the intended recipient is known).  With
+ *   CONFIG_NET_TCP_WRITE_BUFFERS, the file data is read directly into the
+ *   write buffers and the call returns once the data has been queued.
  *
  * Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
+ *   infile   The input file
+ *   offset   If not NULL, the file offset to start from.  It is updated on
+ *            return and the file position is not changed.  Otherwise, the
+ *            transfer starts at the current file position which is updated.
+ *   count    The number of bytes to transfer.
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -933,6 +1446,30 @@ void tcp_reset(FAR struct net_driver_s *dev);
 void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack);
 
+/****************************************************************************
+ * Name: tcp_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK built from a SYN
+ *   cache entry.
+ *
+ * Parameters:
+ *   dev - The device driver structure containing the received SYN
+ *   sc  - The SYN cache entry for the connection request
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+void tcp_synack(FAR struct net_driver_s *dev,
+                FAR struct tcp_syncache_s *sc);
+#endif
+
 /****************************************************************************
  * Name: tcp_appsend
  *
@@ -1380,6 +1917,62 @@ void tcp_wrbuffer_dump(FAR const char *msg, FAR struct tcp_wrbuffer_s *wrb,
 #endif
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_cc_initialize
+ *
+ * Description:
+ *   Initialize the congestion control state of a newly established
+ *   connection using the configured default algorithm.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_initialize(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion state on receipt of an ACK.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure
+ *   ackno  - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment carried no data (so that it may count as
+ *            a duplicate ACK)
+ *
+ * Returned Value:
+ *   True if the oldest un-ACKed segment should be retransmitted now (fast
+ *   retransmit or a partial ACK during fast recovery).
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupack);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion state on a retransmission timeout.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_pollsetup
  *
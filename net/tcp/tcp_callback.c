@@ -93,6 +93,9 @@ tcp_data_event(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       uint8_t *buffer = dev->d_appdata;
       int      buflen = dev->d_len;
       uint16_t recvlen;
+#ifdef CONFIG_NETDEV_IOB_RX
+      FAR struct iob_s *iob;
+#endif
 #endif
 
       ninfo("No listener on connection\n");
@@ -102,7 +105,28 @@ tcp_data_event(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * partial packets will not be buffered.
        */
 
-      recvlen = tcp_datahandler(conn, buffer, buflen);
+#ifdef CONFIG_NETDEV_IOB_RX
+      /* If the driver received the packet into an I/O buffer, then queue
+       * that I/O buffer rather than a copy of the data.
+       */
+
+      iob = devif_iob_claim(dev, buffer, buflen, 0, IOB_USER_TCP);
+      if (iob != NULL)
+        {
+          recvlen = buflen;
+          if (iob_tryadd_queue(iob, &conn->readahead) < 0)
+            {
+              nerr("ERROR: Failed to queue the I/O buffer chain\n");
+              (void)iob_free_chain(iob);
+              recvlen = 0;
+            }
+        }
+      else
+#endif
+        {
+          recvlen = tcp_datahandler(conn, buffer, buflen);
+        }
+
       if (recvlen < buflen)
 #endif
         {
@@ -241,7 +265,7 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
    * packet.
    */
 
-  iob = iob_tryalloc(true);
+  iob = iob_tryalloc_user(true, IOB_USER_TCP);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to create new I/O buffer chain\n");
@@ -0,0 +1,301 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/net/netconfig.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_CC)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of duplicate ACKs that trigger a fast retransmit (RFC 5681) */
+
+#define TCP_CC_DUPTHRESH 3
+
+/* Initial window of RFC 3390:  min(4*MSS, max(2*MSS, 4380 bytes)) */
+
+#define TCP_CC_IW(mss) \
+  ((mss) > 1095 ? ((mss) > 2190 ? 2 * (mss) : 4380) : 4 * (mss))
+
+/* Sequence number comparison (modulo 2**32) */
+
+#define SEQ_LT(a,b)  ((int32_t)((a) - (b)) < 0)
+#define SEQ_GT(a,b)  ((int32_t)((a) - (b)) > 0)
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_newreno)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_init(FAR struct tcp_conn_s *conn);
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  newreno_init,     /* init */
+  newreno_ack,      /* ack */
+  newreno_ssthresh  /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: newreno_init
+ *
+ * Description:
+ *   NewReno has no state beyond cwnd and ssthresh.
+ *
+ ****************************************************************************/
+
+static void newreno_init(FAR struct tcp_conn_s *conn)
+{
+}
+
+/****************************************************************************
+ * Name: newreno_ack
+ *
+ * Description:
+ *   Slow start below ssthresh; one MSS per window of ACKed data above it
+ *   (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void newreno_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t incr;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      incr = acked < conn->mss ? acked : conn->mss;
+    }
+  else
+    {
+      incr = ((uint32_t)conn->mss * conn->mss) / conn->cwnd;
+      if (incr == 0)
+        {
+          incr = 1;
+        }
+    }
+
+  conn->cwnd += incr;
+}
+
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   On loss, halve the amount of data in flight (RFC 5681, equation 4).
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh = conn->unacked / 2;
+  uint32_t minimum  = 2 * (uint32_t)conn->mss;
+
+  return ssthresh > minimum ? ssthresh : minimum;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_initialize
+ *
+ * Description:
+ *   Initialize the congestion control state of a newly established
+ *   connection using the configured default algorithm.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_initialize(FAR struct tcp_conn_s *conn)
+{
+  conn->cc_ops      = TCP_CC_DEFAULT;
+  conn->cwnd        = TCP_CC_IW((uint32_t)conn->mss);
+  conn->ssthresh    = UINT32_MAX;
+  conn->cc_lastack  = tcp_getsequence(conn->sndseq);
+  conn->cc_recover  = conn->cc_lastack;
+  conn->cc_dupacks  = 0;
+  conn->cc_recovery = false;
+
+  conn->cc_ops->init(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion state on receipt of an ACK.  This implements
+ *   fast retransmit and the NewReno fast recovery of RFC 6582; growth and
+ *   reduction of the window are delegated to the algorithm.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection structure
+ *   ackno  - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment carried no data (so that it may count as
+ *            a duplicate ACK)
+ *
+ * Returned Value:
+ *   True if the oldest un-ACKed segment should be retransmitted now (fast
+ *   retransmit or a partial ACK during fast recovery).
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupack)
+{
+  uint32_t mss = conn->mss;
+  uint32_t acked;
+
+  if (SEQ_GT(ackno, conn->cc_lastack))
+    {
+      /* New data has been ACKed */
+
+      acked              = ackno - conn->cc_lastack;
+      conn->cc_lastack   = ackno;
+      conn->cc_dupacks   = 0;
+
+      if (!conn->cc_recovery)
+        {
+          conn->cc_ops->ack(conn, acked);
+          return false;
+        }
+
+      if (!SEQ_LT(ackno, conn->cc_recover))
+        {
+          /* Full ACK:  Leave fast recovery, deflating the window */
+
+          ninfo("CC: Recovered ackno=%u cwnd=%u\n", ackno, conn->ssthresh);
+
+          conn->cc_recovery = false;
+          conn->cwnd        = conn->ssthresh;
+          return false;
+        }
+
+      /* Partial ACK:  The next hole is lost too.  Deflate the window by
+       * the amount ACKed, add back one MSS, and retransmit it.
+       */
+
+      conn->cwnd = conn->cwnd > acked ? conn->cwnd - acked : 0;
+      conn->cwnd += mss;
+      return true;
+    }
+
+  if (ackno != conn->cc_lastack || !dupack || conn->unacked == 0)
+    {
+      return false;
+    }
+
+  /* A duplicate ACK.  In recovery, each one means that another segment
+   * has left the network.
+   */
+
+  if (conn->cc_recovery)
+    {
+      conn->cwnd += mss;
+      return false;
+    }
+
+  if (++conn->cc_dupacks < TCP_CC_DUPTHRESH)
+    {
+      return false;
+    }
+
+  /* Enter fast recovery and retransmit the missing segment */
+
+  conn->ssthresh    = conn->cc_ops->ssthresh(conn);
+  conn->cwnd        = conn->ssthresh + TCP_CC_DUPTHRESH * mss;
+  conn->cc_recover  = conn->sndseq_max;
+  conn->cc_recovery = true;
+  conn->cc_dupacks  = 0;
+
+  ninfo("CC: Fast retransmit ackno=%u ssthresh=%u\n", ackno, conn->ssthresh);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion state on a retransmission timeout:  Reduce
+ *   ssthresh and restart from a window of one segment (RFC 5681).
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  conn->ssthresh    = conn->cc_ops->ssthresh(conn);
+  conn->cwnd        = conn->mss;
+  conn->cc_dupacks  = 0;
+  conn->cc_recovery = false;
+
+  ninfo("CC: Timeout ssthresh=%u\n", conn->ssthresh);
+}
+
+#endif /* CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -0,0 +1,263 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/net/netconfig.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+
+#if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_CC_CUBIC)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CUBIC parameters (RFC 8312):  The multiplicative decrease factor
+ * beta = 0.7 and the scaling constant C = 0.4.  With time in milliseconds
+ * and windows in segments, W(t) = C * t**3 = t**3 / CUBIC_CINV.
+ */
+
+#define CUBIC_BETA_NUM  7
+#define CUBIC_BETA_DEN  10
+#define CUBIC_CINV      2500000000ull  /* 1 / (0.4 * 10**-9) */
+
+/* Limit on |t - K| so that the cube cannot overflow (msec) */
+
+#define CUBIC_MAXDELTA  100000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  cubic_init,       /* init */
+  cubic_ack,        /* ack */
+  cubic_ssthresh    /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root (bit-by-bit, from Hacker's Delight)
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_now
+ *
+ * Description:
+ *   Return the current time in milliseconds, never zero.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_now(void)
+{
+  uint32_t now = (uint32_t)TICK2MSEC(clock_systimer());
+  return now != 0 ? now : 1;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cc_wmax  = 0;
+  conn->cc_k     = 0;
+  conn->cc_epoch = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_ack
+ *
+ * Description:
+ *   Slow start below ssthresh.  Above it, grow cwnd toward the cubic
+ *   function W(t) = C * (t - K)**3 + Wmax of the time since the last
+ *   reduction, but never more slowly than NewReno would.
+ *
+ ****************************************************************************/
+
+static void cubic_ack(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t mss = conn->mss;
+  uint32_t incr;
+  int64_t target;
+  int64_t delta;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      conn->cwnd += acked < mss ? acked : mss;
+      return;
+    }
+
+  /* Start a new epoch on the first ACK after a reduction */
+
+  if (conn->cc_epoch == 0)
+    {
+      conn->cc_epoch = cubic_now();
+      if (conn->cwnd < conn->cc_wmax)
+        {
+          /* K = cbrt((Wmax - cwnd) / C), in milliseconds */
+
+          conn->cc_k = cubic_cbrt((uint64_t)(conn->cc_wmax - conn->cwnd) *
+                                  CUBIC_CINV / mss);
+        }
+      else
+        {
+          conn->cc_wmax = conn->cwnd;
+          conn->cc_k    = 0;
+        }
+    }
+
+  /* The target window in bytes */
+
+  delta = (int64_t)(uint32_t)(cubic_now() - conn->cc_epoch) -
+          (int64_t)conn->cc_k;
+
+  if (delta > CUBIC_MAXDELTA)
+    {
+      delta = CUBIC_MAXDELTA;
+    }
+  else if (delta < -CUBIC_MAXDELTA)
+    {
+      delta = -CUBIC_MAXDELTA;
+    }
+
+  target = (int64_t)conn->cc_wmax +
+           delta * delta * delta * (int64_t)mss / (int64_t)CUBIC_CINV;
+
+  /* Per ACK, increase by (target - cwnd) / cwnd segments, limited to one
+   * segment.  The NewReno increase of MSS * MSS / cwnd is the minimum
+   * (the TCP-friendly region).
+   */
+
+  incr = (mss * mss) / conn->cwnd;
+  if (target > (int64_t)conn->cwnd)
+    {
+      uint64_t cubic = (uint64_t)(target - conn->cwnd) * mss / conn->cwnd;
+      if (cubic > mss)
+        {
+          cubic = mss;
+        }
+
+      if (cubic > incr)
+        {
+          incr = (uint32_t)cubic;
+        }
+    }
+
+  conn->cwnd += incr > 0 ? incr : 1;
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   On loss, remember the window (with fast convergence) and reduce it by
+ *   the factor beta.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t minimum = 2 * (uint32_t)conn->mss;
+  uint32_t ssthresh;
+
+  /* Fast convergence:  If the window is still below the last maximum,
+   * release bandwidth for new flows by lowering Wmax further.
+   */
+
+  if (conn->cwnd < conn->cc_wmax)
+    {
+      conn->cc_wmax = (uint32_t)(((uint64_t)conn->cwnd *
+                                  (CUBIC_BETA_DEN + CUBIC_BETA_NUM)) /
+                                 (2 * CUBIC_BETA_DEN));
+    }
+  else
+    {
+      conn->cc_wmax = conn->cwnd;
+    }
+
+  conn->cc_epoch = 0;
+
+  ssthresh = (uint32_t)(((uint64_t)conn->cwnd * CUBIC_BETA_NUM) /
+                        CUBIC_BETA_DEN);
+  return ssthresh > minimum ? ssthresh : minimum;
+}
+
+#endif /* CONFIG_NET_TCP && CONFIG_NET_TCP_CC_CUBIC */
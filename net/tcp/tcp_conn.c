@@ -70,6 +70,14 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+#  if (CONFIG_NET_TCP_CONNHASH_SIZE & (CONFIG_NET_TCP_CONNHASH_SIZE - 1)) != 0
+#    error CONFIG_NET_TCP_CONNHASH_SIZE must be a power of two
+#  endif
+
+#  define TCP_HASHMASK (CONFIG_NET_TCP_CONNHASH_SIZE - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,10 +98,202 @@ static dq_queue_t g_active_tcp_connections;
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+/* Active connections hashed by local port, remote port and remote address */
+
+static FAR struct tcp_conn_s *g_tcp_connhash[CONFIG_NET_TCP_CONNHASH_SIZE];
+
+/* Connections with a local port assignment hashed by the local port */
+
+static FAR struct tcp_conn_s *g_tcp_porthash[CONFIG_NET_TCP_CONNHASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_connhash_key and tcp_porthash_key
+ *
+ * Description:
+ *   Return the hash table index for a connection with the provided local
+ *   port, remote port and (folded) remote address, or for the provided local
+ *   port.  Port numbers are in network byte order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+static inline unsigned int tcp_connhash_key(uint16_t lport, uint16_t rport,
+                                            uint32_t raddr)
+{
+  uint32_t key = raddr ^ ((uint32_t)lport << 16 | rport);
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return (unsigned int)key & TCP_HASHMASK;
+}
+
+static inline unsigned int tcp_porthash_key(uint16_t lport)
+{
+  return (unsigned int)(lport ^ (lport >> 8)) & TCP_HASHMASK;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Reduce an IPv6 address to 32-bits for hashing.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_CONNHASH) && defined(CONFIG_NET_IPv6)
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *addr)
+{
+  return ((uint32_t)addr[0] << 16 | addr[1]) ^
+         ((uint32_t)addr[2] << 16 | addr[3]) ^
+         ((uint32_t)addr[4] << 16 | addr[5]) ^
+         ((uint32_t)addr[6] << 16 | addr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash_index
+ *
+ * Description:
+ *   Return the active connection hash table index of a connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+static unsigned int tcp_connhash_index(FAR struct tcp_conn_s *conn)
+{
+  uint32_t raddr;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      raddr = (uint32_t)conn->u.ipv4.raddr;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      raddr = tcp_ipv6_fold(conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  return tcp_connhash_key(conn->lport, conn->rport, raddr);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash_add and tcp_connhash_remove
+ *
+ * Description:
+ *   Add a connection to (or remove it from) the active connection hash
+ *   table.  The local port, remote port and remote address must not change
+ *   while the connection is in the table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+static void tcp_connhash_add(FAR struct tcp_conn_s *conn)
+{
+  unsigned int ndx = tcp_connhash_index(conn);
+
+  conn->hnext         = g_tcp_connhash[ndx];
+  g_tcp_connhash[ndx] = conn;
+}
+
+static void tcp_connhash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **pprev;
+
+  for (pprev = &g_tcp_connhash[tcp_connhash_index(conn)];
+       *pprev != NULL;
+       pprev = &(*pprev)->hnext)
+    {
+      if (*pprev == conn)
+        {
+          *pprev      = conn->hnext;
+          conn->hnext = NULL;
+          break;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_porthash_remove
+ *
+ * Description:
+ *   Remove a connection from the local port hash table (if it is there).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+static void tcp_porthash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **pprev;
+
+  for (pprev = &g_tcp_porthash[tcp_porthash_key(conn->lport)];
+       *pprev != NULL;
+       pprev = &(*pprev)->pnext)
+    {
+      if (*pprev == conn)
+        {
+          *pprev      = conn->pnext;
+          conn->pnext = NULL;
+          break;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_setlport
+ *
+ * Description:
+ *   Assign the local port number (network byte order) of a connection,
+ *   keeping the local port hash table up to date.  A port number of zero
+ *   removes the assignment.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_setlport(FAR struct tcp_conn_s *conn, uint16_t lport)
+{
+#ifdef CONFIG_NET_TCP_CONNHASH
+  unsigned int ndx;
+
+  tcp_porthash_remove(conn);
+  conn->lport = lport;
+
+  if (lport != 0)
+    {
+      ndx                 = tcp_porthash_key(lport);
+      conn->pnext         = g_tcp_porthash[ndx];
+      g_tcp_porthash[ndx] = conn;
+    }
+#else
+  conn->lport = lport;
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -111,13 +311,22 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_CONNHASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  for (conn = g_tcp_porthash[tcp_porthash_key(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+    {
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
     {
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -162,13 +371,22 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_CONNHASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  for (conn = g_tcp_porthash[tcp_porthash_key(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+    {
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
     {
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -325,10 +543,16 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  conn       = g_tcp_connhash[tcp_connhash_key(tcp->destport, tcp->srcport,
+                                               (uint32_t)srcipaddr)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -364,7 +588,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -392,10 +620,16 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  conn       = g_tcp_connhash[tcp_connhash_key(tcp->destport, tcp->srcport,
+                                               tcp_ipv6_fold(ip->srcipaddr))];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -431,7 +665,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -472,12 +710,13 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
   /* Find the device that can receive packets on the network associated with
@@ -493,8 +732,9 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
+      net_unlock();
       return ret;
     }
 
@@ -539,12 +779,13 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
   /* Find the device that can receive packets on the network
@@ -560,8 +801,9 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_allzeroaddr);
+      net_unlock();
       return ret;
     }
 
@@ -603,6 +845,11 @@ void tcp_initialize(void)
     }
 
   g_last_tcp_port = 1024;
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+  memset(g_tcp_connhash, 0, sizeof(g_tcp_connhash));
+  memset(g_tcp_porthash, 0, sizeof(g_tcp_porthash));
+#endif
 }
 
 /****************************************************************************
@@ -712,6 +959,12 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
       conn->tcpstateflags = TCP_ALLOCATED;
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+      wd_static(&conn->tmrwdog);
+#endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      wd_static(&conn->ackwdog);
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
 #endif
@@ -764,8 +1017,33 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+      tcp_connhash_remove(conn);
+#endif
     }
 
+#ifdef CONFIG_NETDEV_TXPENDING
+  /* Remove the connection from any device's Tx pending list */
+
+  tcp_txpending_remove(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+  /* Stop the connection's timer */
+
+  tcp_timer_cancel(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Stop the delayed ACK timer */
+
+  tcp_delack_cancel(conn);
+#endif
+
+  /* Release the local port assignment */
+
+  tcp_setlport(conn, 0);
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -992,7 +1270,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = tcp->destport;
+      tcp_setlport(conn, tcp->destport);
       conn->rport         = tcp->srcport;
       conn->tcpstateflags = TCP_SYN_RCVD;
 
@@ -1027,6 +1305,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+      tcp_connhash_add(conn);
+#endif
     }
 
   return conn;
@@ -1238,7 +1519,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
+  tcp_setlport(conn, htons((uint16_t)port));
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1262,6 +1543,13 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+  tcp_connhash_add(conn);
+#endif
+
+  /* Start the timer that sends the SYN */
+
+  tcp_update_timer(conn);
   ret = OK;
 
 errout_with_lock:
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * net/tcp/tcp_delack.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Delayed ACK timer expirations are processed on the low priority work
+ * queue, if there is one.
+ */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define TCP_DELACK_WORK LPWORK
+#else
+#  define TCP_DELACK_WORK HPWORK
+#endif
+
+#define TCP_DELACK_TICKS MSEC2TICK(CONFIG_NET_TCP_DELACK_MSEC)
+
+/* An ACK is sent for at least every second full-sized segment */
+
+#define TCP_DELACK_MAXBYTES(conn) (2 * (uint32_t)(conn)->mss)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_delack_work
+ *
+ * Description:
+ *   The delayed ACK timer has expired.  Have the ACK sent on the next poll
+ *   of the connection's device.
+ *
+ * Parameters:
+ *   arg - The TCP connection structure cast to void *
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs on the work queue.
+ *
+ ****************************************************************************/
+
+static void tcp_delack_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  net_lock();
+  tcp_delack_flush(conn);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_delack_expiry
+ *
+ * Description:
+ *   Watchdog handler.  Defers processing to the work queue.
+ *
+ * Parameters:
+ *   argc - The number of parameters (one)
+ *   arg  - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs in the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+static void tcp_delack_expiry(int argc, wdparm_t arg, ...)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  DEBUGASSERT(argc == 1 && conn != NULL);
+
+  if (work_available(&conn->ackwork))
+    {
+      (void)work_queue(TCP_DELACK_WORK, &conn->ackwork, tcp_delack_work,
+                       conn, 0);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_delack
+ *
+ * Description:
+ *   Decide whether the ACK for newly received data may be delayed.  If so,
+ *   the TCP_SNDACK flag is cleared from the returned flags and the delayed
+ *   ACK timer is started.  If received data was not accepted and an ACK is
+ *   already pending, TCP_SNDACK is set so that the pending ACK is sent now.
+ *
+ * Parameters:
+ *   dev    - The device driver structure
+ *   conn   - The TCP connection structure
+ *   result - The flags returned by the application callback
+ *   len    - The number of bytes of new data in the received segment
+ *
+ * Returned Value:
+ *   The possibly modified flags
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint16_t tcp_delack(FAR struct net_driver_s *dev,
+                    FAR struct tcp_conn_s *conn, uint16_t result,
+                    uint16_t len)
+{
+  if (len == 0)
+    {
+      /* No new data; this is not an ACK that we can delay */
+
+      return result;
+    }
+
+  if ((result & TCP_SNDACK) == 0)
+    {
+      /* The data could not be accepted, probably because the read-ahead
+       * buffers are exhausted.  Don't keep the peer waiting for the ACK
+       * of the data that was accepted before; it lets the peer see the
+       * loss right away and retransmit.
+       */
+
+      if (conn->rcv_unacked > 0)
+        {
+          result |= TCP_SNDACK;
+        }
+
+      return result;
+    }
+
+  conn->rcv_unacked += len;
+
+  /* Send the ACK now if delayed ACKs are disabled, if it will be
+   * piggybacked on outgoing data or a FIN, or if two full-sized segments
+   * have been received since the last ACK.
+   */
+
+  if (conn->quickack || dev->d_sndlen > 0 ||
+      (result & (TCP_CLOSE | TCP_ABORT)) != 0 ||
+      conn->rcv_unacked >= TCP_DELACK_MAXBYTES(conn))
+    {
+      return result;
+    }
+
+  /* Otherwise, hold the ACK until the timer expires (or until some other
+   * segment is sent).  The timer is not restarted for later segments; it
+   * bounds the delay of the oldest unacknowledged data.
+   */
+
+  if (!WDOG_ISACTIVE(&conn->ackwdog))
+    {
+      (void)wd_start(&conn->ackwdog, TCP_DELACK_TICKS, tcp_delack_expiry,
+                     1, (wdparm_t)conn);
+    }
+
+  return result & ~TCP_SNDACK;
+}
+
+/****************************************************************************
+ * Name: tcp_delack_sent
+ *
+ * Description:
+ *   Called whenever a segment carrying an ACK is sent on the connection.
+ *   Any pending delayed ACK is satisfied by that segment.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_delack_sent(FAR struct tcp_conn_s *conn)
+{
+  if (conn->rcv_unacked > 0 || conn->ackdue)
+    {
+      (void)wd_cancel(&conn->ackwdog);
+
+      conn->rcv_unacked = 0;
+      conn->ackdue      = false;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_delack_flush
+ *
+ * Description:
+ *   If an ACK is being delayed, mark it due and ask the connection's device
+ *   for a poll so that it is sent without waiting for the timer.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_delack_flush(FAR struct tcp_conn_s *conn)
+{
+  /* The ACK may have been sent (or the connection closed) after the timer
+   * expired.
+   */
+
+  if (conn->rcv_unacked > 0 && !conn->ackdue && conn->dev != NULL)
+    {
+      (void)wd_cancel(&conn->ackwdog);
+
+      conn->ackdue = true;
+      tcp_txpending(conn->dev, conn);
+      netdev_txnotify_dev(conn->dev);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_delack_cancel
+ *
+ * Description:
+ *   Stop the delayed ACK timer when the connection is freed.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_delack_cancel(FAR struct tcp_conn_s *conn)
+{
+  (void)wd_cancel(&conn->ackwdog);
+  (void)work_cancel(TCP_DELACK_WORK, &conn->ackwork);
+
+  conn->rcv_unacked = 0;
+  conn->ackdue      = false;
+}
+
+#endif /* CONFIG_NET_TCP_DELAYED_ACK */
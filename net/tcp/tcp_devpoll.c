@@ -87,6 +87,21 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
   dev->d_len     = 0;
   dev->d_sndlen  = 0;
 
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+  /* If the connection's timer has expired, process it now instead of
+   * polling for new data.  tcp_timer() also polls an established
+   * connection that has nothing to retransmit.
+   */
+
+  if (conn->tmrdue && dev == conn->dev)
+    {
+      conn->tmrdue = false;
+      tcp_timer(dev, conn, tcp_timer_elapsed(conn));
+      tcp_update_timer(conn);
+      return;
+    }
+#endif
+
   /* Verify that the connection is established. */
 
   if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
@@ -124,11 +139,112 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
           result = tcp_callback(dev, conn, TCP_POLL);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+          /* Send the delayed ACK now if its timer has expired.  It will be
+           * piggybacked on any data provided by the application.
+           */
+
+          if (conn->ackdue)
+            {
+              result |= TCP_SNDACK;
+            }
+#endif
+
           /* Handle the callback response */
 
           tcp_appsend(dev, conn, result);
         }
     }
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  else
+    {
+      /* Leaving the established state always sends a segment, so there
+       * is no delayed ACK left to send.
+       */
+
+      conn->ackdue = false;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Add a TCP connection to the list of connections with Tx work pending
+ *   on a device.  A connection is in at most one such list; if it is
+ *   already pending on a different device, it is moved.
+ *
+ * Parameters:
+ *   dev - The device that will send the pending output
+ *   conn - The TCP connection with pending output
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+void tcp_txpending(FAR struct net_driver_s *dev,
+                   FAR struct tcp_conn_s *conn)
+{
+  if (dev == NULL || conn->txdev == dev)
+    {
+      return;
+    }
+
+  if (conn->txdev != NULL)
+    {
+      tcp_txpending_remove(conn);
+    }
+
+  conn->txnext   = dev->d_tcppend;
+  conn->txdev    = dev;
+  dev->d_tcppend = conn;
+}
+
+/****************************************************************************
+ * Name: tcp_txpending_remove
+ *
+ * Description:
+ *   Remove a TCP connection from the pending list that it is in, if any.
+ *
+ * Parameters:
+ *   conn - The TCP connection
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_txpending_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link;
+
+  if (conn->txdev == NULL)
+    {
+      return;
+    }
+
+  for (link = &conn->txdev->d_tcppend; *link != NULL;
+       link = &(*link)->txnext)
+    {
+      if (*link == conn)
+        {
+          *link = conn->txnext;
+          break;
+        }
+    }
+
+  conn->txnext = NULL;
+  conn->txdev  = NULL;
 }
+#endif /* CONFIG_NETDEV_TXPENDING */
 
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -0,0 +1,142 @@
+/****************************************************************************
+ * net/tcp/tcp_getsockopt.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCPPROTO_OPTIONS)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_getsockopt
+ *
+ * Description:
+ *   Get the value of an IPPROTO_TCP level socket option.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   option - The option to get (see netinet/tcp.h)
+ *   value  - Location to return the value of the option
+ *   len    - On input, the size of 'value'; on return, the size of the
+ *            value returned
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tcp_getsockopt(FAR struct tcp_conn_s *conn, int option,
+                   FAR void *value, FAR socklen_t *len)
+{
+  int ret = OK;
+
+  DEBUGASSERT(conn != NULL);
+
+  if (value == NULL || len == NULL)
+    {
+      return -EINVAL;
+    }
+
+  switch (option)
+    {
+      case TCP_NODELAY: /* The Nagle algorithm is disabled */
+        {
+          if (*len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+          *(FAR int *)value = conn->nodelay ? 1 : 0;
+#else
+          *(FAR int *)value = 1;
+#endif
+          *len              = sizeof(int);
+        }
+        break;
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_CORK: /* Only full-sized segments are sent */
+        {
+          if (*len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->cork ? 1 : 0;
+          *len              = sizeof(int);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      case TCP_QUICKACK: /* Delayed ACKs are disabled */
+        {
+          if (*len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = conn->quickack ? 1 : 0;
+          *len              = sizeof(int);
+        }
+        break;
+#endif
+
+      default:
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCPPROTO_OPTIONS */
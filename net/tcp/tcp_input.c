@@ -65,6 +65,146 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_synopts
+ *
+ * Description:
+ *   Parse the options of a received SYN or SYNACK segment.  The MSS option
+ *   sets the MSS.  The window scale and SACK permitted options are
+ *   recorded (if supported) if the peer sent them.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received TCP packet.
+ *   iplen - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *   opts  - The parsed options.  The mss field must hold the MSS to be
+ *           used if the peer does not send one.
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_synopts(FAR struct net_driver_s *dev,
+                              unsigned int iplen,
+                              FAR struct tcp_synopts_s *opts)
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *options;
+  uint16_t tmp16;
+  uint8_t opt;
+  int optlen;
+  int i;
+
+  tcp     = (FAR struct tcp_hdr_s *)&dev->d_buf[iplen + NET_LL_HDRLEN(dev)];
+  options = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  optlen  = (((tcp->tcpoffset >> 4) - 5) << 2);
+
+  /* Options that the peer does not send are not used */
+
+  opts->tcpoptions = 0;
+  opts->snd_wscale = 0;
+
+  for (i = 0; i < optlen; )
+    {
+      opt = options[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+          continue;
+        }
+
+      /* All other options have a length field, so that we easily can skip
+       * past them.  If the length field is zero (or runs past the end of
+       * the header), the options are malformed and we don't process them
+       * further.
+       */
+
+      if (i + 1 >= optlen || options[i + 1] == 0 ||
+          i + options[i + 1] > optlen)
+        {
+          break;
+        }
+
+      if (opt == TCP_OPT_MSS && options[i + 1] == TCP_OPT_MSS_LEN)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)options[i + 2] << 8) | (uint16_t)options[i + 3];
+          opts->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+        }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (opt == TCP_OPT_WS && options[i + 1] == TCP_OPT_WS_LEN)
+        {
+          /* Window scaling will be used in both directions */
+
+          opts->snd_wscale  = options[i + 2] > TCP_MAX_WSCALE ?
+                              TCP_MAX_WSCALE : options[i + 2];
+          opts->tcpoptions |= TCP_OPTF_WSCALE;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+      else if (opt == TCP_OPT_SACK_PERM &&
+               options[i + 1] == TCP_OPT_SACK_PERM_LEN)
+        {
+          opts->tcpoptions |= TCP_OPTF_SACK;
+        }
+#endif
+
+      i += options[i + 1];
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_parse_option
+ *
+ * Description:
+ *   Parse the options of a received SYN or SYNACK segment and apply them
+ *   to the connection.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received TCP packet.
+ *   conn  - The TCP connection structure to be updated
+ *   iplen - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_option(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             unsigned int iplen)
+{
+  struct tcp_synopts_s opts;
+
+  opts.mss         = conn->mss;
+  tcp_parse_synopts(dev, iplen, &opts);
+
+  conn->mss        = opts.mss;
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE) || defined(CONFIG_NET_TCP_SACK)
+  conn->tcpoptions = opts.tcpoptions;
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  conn->snd_wscale = opts.snd_wscale;
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -90,13 +230,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_hdr_s *tcp;
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
-  unsigned int hdrlen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -114,13 +251,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcpiplen = iplen + TCP_HDRLEN;
 
-  /* Get the size of the link layer header, the IP header, and the TCP header */
-
-  hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
-
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_TCP_RX) &&
+      tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -174,6 +308,20 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
       if (tcp_islistener(tmp16))
 #endif
         {
+#ifdef CONFIG_NET_TCP_SYNCACHE
+          FAR struct tcp_syncache_s *sc;
+
+          /* We matched the incoming packet with a connection in LISTEN.
+           * Record the request in the SYN cache and send a SYNACK in
+           * response.  The connection structure is allocated when the
+           * remote host ACKs the SYNACK.
+           */
+
+          sc = tcp_syncache_add(dev, tcp);
+          tcp_parse_synopts(dev, iplen, &sc->opts);
+          tcp_synack(dev, sc);
+          return;
+#else
           /* We matched the incoming packet with a connection in LISTEN.
            * We now need to create a new connection and send a SYNACK in
            * response.
@@ -226,65 +374,31 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP MSS (and other SYN) options, if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_parse_option(dev, conn, iplen);
 
           /* Our response will be a SYNACK. */
 
           tcp_ack(dev, conn, TCP_ACK | TCP_SYN);
           return;
+#endif /* CONFIG_NET_TCP_SYNCACHE */
+        }
+    }
+#ifdef CONFIG_NET_TCP_SYNCACHE
+  else
+    {
+      /* This may be the ACK that completes the 3-way handshake of a
+       * connection request in the SYN cache.
+       */
+
+      conn = tcp_syncache_accept(dev, tcp);
+      if (conn)
+        {
+          goto found;
         }
     }
+#endif
 
   nwarn("WARNING: SYN with no listener (or old packet) .. reset\n");
 
@@ -313,6 +427,15 @@ found:
 
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of a SYN segment is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_wscale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -477,6 +600,15 @@ found:
       if (conn->nrtx == 0)
         {
           signed char m;
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+          int hsec;
+
+          /* Bring the retransmission timer up to date */
+
+          hsec = tcp_timer_elapsed(conn);
+          conn->timer = conn->timer > hsec ? conn->timer - hsec : 0;
+#endif
+
           m = conn->rto - conn->timer;
 
           /* This is taken directly from VJs original code in his paper */
@@ -500,6 +632,8 @@ found:
        /* Reset the retransmission timer. */
 
        conn->timer = conn->rto;
+       tcp_timer_rebase(conn);
+       tcp_update_timer(conn);
     }
 
   /* Do different things depending on in what state the connection is. */
@@ -557,6 +691,9 @@ found:
             conn->sndseq_max    = 0;
 #endif
             conn->unacked       = 0;
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_initialize(conn);
+#endif
             flags               = TCP_CONNECTED;
             ninfo("TCP state: TCP_ESTABLISHED\n");
 
@@ -591,59 +728,9 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP MSS (and other SYN) options, if present. */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_parse_option(dev, conn, iplen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -654,6 +741,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_initialize(conn);
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -819,6 +909,12 @@ found:
                 net_incr32(conn->rcvseq, len);
               }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+            /* Delay the ACK if it is not needed now */
+
+            result = tcp_delack(dev, conn, result, len);
+#endif
+
             /* Send the response, ACKing the data or not, as appropriate */
 
             tcp_appsend(dev, conn, result);
@@ -859,6 +955,7 @@ found:
                 conn->tcpstateflags = TCP_TIME_WAIT;
                 conn->timer         = 0;
                 conn->unacked       = 0;
+                tcp_timer_rebase(conn);
                 ninfo("TCP state: TCP_TIME_WAIT\n");
               }
             else
@@ -898,6 +995,7 @@ found:
           {
             conn->tcpstateflags = TCP_TIME_WAIT;
             conn->timer         = 0;
+            tcp_timer_rebase(conn);
             ninfo("TCP state: TCP_TIME_WAIT\n");
 
             net_incr32(conn->rcvseq, 1);
@@ -923,6 +1021,7 @@ found:
           {
             conn->tcpstateflags = TCP_TIME_WAIT;
             conn->timer        = 0;
+            tcp_timer_rebase(conn);
             ninfo("TCP state: TCP_TIME_WAIT\n");
           }
 
@@ -931,6 +1030,17 @@ found:
     }
 
 drop:
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+  /* The segment may have changed the state of the connection without
+   * sending a response.
+   */
+
+  if (conn != NULL)
+    {
+      tcp_update_timer(conn);
+    }
+
+#endif
   dev->d_len = 0;
 }
 
@@ -45,6 +45,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -151,7 +152,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_TCP_TX))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -166,7 +170,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_IPv4_TX))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -223,7 +230,10 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+  if (!NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_TCP_TX))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -285,6 +295,89 @@ static void tcp_sendcomplete(FAR struct net_driver_s *dev,
 #endif
 }
 
+/****************************************************************************
+ * Name: tcp_rcvwscale
+ *
+ * Description:
+ *   Return the smallest window scale shift count that lets the receive
+ *   window of the device be advertised in the 16-bit window field.
+ *
+ * Parameters:
+ *   dev - The device driver structure to use in the send operation
+ *
+ * Return:
+ *   The shift count (0 through TCP_MAX_WSCALE)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+static uint8_t tcp_rcvwscale(FAR struct net_driver_s *dev)
+{
+  uint32_t recvwndo = NET_DEV_RCVWNDO(dev);
+  uint8_t shift = 0;
+
+  while ((recvwndo >> shift) > UINT16_MAX && shift < TCP_MAX_WSCALE)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_synoptions
+ *
+ * Description:
+ *   Add the options of a SYN or SYNACK segment.  The MSS is always sent.
+ *   Each of the remaining options is padded to a 32-bit boundary with
+ *   leading NOPs.
+ *
+ * Parameters:
+ *   options - The location of the options in the TCP header
+ *   tcp_mss - The MSS to send
+ *   wscale  - The window scale shift count to send or -1 for none
+ *   sack    - True: Send the SACK permitted option
+ *
+ * Return:
+ *   The length of the options
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_synoptions(FAR uint8_t *options, uint16_t tcp_mss,
+                                   int wscale, bool sack)
+{
+  unsigned int optlen;
+
+  options[0] = TCP_OPT_MSS;
+  options[1] = TCP_OPT_MSS_LEN;
+  options[2] = tcp_mss >> 8;
+  options[3] = tcp_mss & 0xff;
+  optlen     = TCP_OPT_MSS_LEN;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (wscale >= 0)
+    {
+      options[optlen++] = TCP_OPT_NOOP;
+      options[optlen++] = TCP_OPT_WS;
+      options[optlen++] = TCP_OPT_WS_LEN;
+      options[optlen++] = (uint8_t)wscale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  if (sack)
+    {
+      options[optlen++] = TCP_OPT_NOOP;
+      options[optlen++] = TCP_OPT_NOOP;
+      options[optlen++] = TCP_OPT_SACK_PERM;
+      options[optlen++] = TCP_OPT_SACK_PERM_LEN;
+    }
+#endif
+
+  return optlen;
+}
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -354,13 +447,38 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      tcp->wnd[0] = ((NET_DEV_RCVWNDO(dev)) >> 8);
-      tcp->wnd[1] = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+      uint32_t recvwndo = NET_DEV_RCVWNDO(dev);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window field of a SYN segment is never scaled */
+
+      if ((tcp->flags & TCP_SYN) == 0 &&
+          (conn->tcpoptions & TCP_OPTF_WSCALE) != 0)
+        {
+          recvwndo >>= conn->rcv_wscale;
+        }
+#endif
+
+      if (recvwndo > UINT16_MAX)
+        {
+          recvwndo = UINT16_MAX;
+        }
+
+      tcp->wnd[0] = recvwndo >> 8;
+      tcp->wnd[1] = recvwndo & 0xff;
     }
 
   /* Finish the IP portion of the message and calculate checksums */
 
   tcp_sendcomplete(dev, tcp);
+
+  /* Every segment carries the current ACK, satisfying any delayed ACK */
+
+  tcp_delack_sent(conn);
+
+  /* Start the retransmission timer if this segment needs one */
+
+  tcp_update_timer(conn);
 }
 
 /****************************************************************************
@@ -537,7 +655,10 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack)
 {
   struct tcp_hdr_s *tcp;
+  unsigned int optlen;
   uint16_t tcp_mss;
+  int wscale = -1;
+  bool sack = false;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -551,9 +672,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv6BUF;
       tcp_mss = TCP_IPv6_MSS(dev);
 
-      /* Set the packet length for the TCP Maximum Segment Size */
+      /* Set the packet length for the TCP header (options are added below) */
 
-      dev->d_len  = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv6TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -567,9 +688,9 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
       tcp     = TCPIPv4BUF;
       tcp_mss = TCP_IPv4_MSS(dev);
 
-      /* Set the packet length for the TCP Maximum Segment Size */
+      /* Set the packet length for the TCP header (options are added below) */
 
-      dev->d_len  = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+      dev->d_len  = IPv4TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -577,17 +698,138 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   tcp->flags      = ack;
 
-  /* We send out the TCP Maximum Segment Size option with our ack. */
+  /* We send out the TCP Maximum Segment Size option with our ack.  The
+   * remaining options are offered in a SYN, but included in a SYNACK only
+   * if the peer offered them in its SYN.
+   */
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (ack == TCP_SYN || (conn->tcpoptions & TCP_OPTF_WSCALE) != 0)
+    {
+      conn->rcv_wscale = tcp_rcvwscale(dev);
+      wscale           = conn->rcv_wscale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  sack = (ack == TCP_SYN || (conn->tcpoptions & TCP_OPTF_SACK) != 0);
+#endif
 
-  tcp->optdata[0] = TCP_OPT_MSS;
-  tcp->optdata[1] = TCP_OPT_MSS_LEN;
-  tcp->optdata[2] = tcp_mss >> 8;
-  tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optlen          = tcp_synoptions(tcp->optdata, tcp_mss, wscale, sack);
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
+  dev->d_len     += optlen;
 
   /* Complete the common portions of the TCP message */
 
   tcp_sendcommon(dev, conn, tcp);
 }
 
+/****************************************************************************
+ * Name: tcp_synack
+ *
+ * Description:
+ *   Answer the SYN in the device buffer with a SYNACK built from a SYN
+ *   cache entry.
+ *
+ * Parameters:
+ *   dev - The device driver structure containing the received SYN
+ *   sc  - The SYN cache entry for the connection request
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+void tcp_synack(FAR struct net_driver_s *dev,
+                FAR struct tcp_syncache_s *sc)
+{
+  FAR struct tcp_hdr_s *tcp = tcp_header(dev);
+  uint32_t recvwndo;
+  unsigned int optlen;
+  uint16_t tcp_mss;
+  int wscale = -1;
+  bool sack = false;
+
+  /* Swap the IP addresses and get the values that vary with the IP
+   * domain.
+   */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      net_ipv6addr_hdrcopy(ipv6->destipaddr, ipv6->srcipaddr);
+      net_ipv6addr_hdrcopy(ipv6->srcipaddr, dev->d_ipv6addr);
+
+      tcp_mss    = TCP_IPv6_MSS(dev);
+      dev->d_len = IPv6TCP_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      net_ipv4addr_hdrcopy(ipv4->destipaddr, ipv4->srcipaddr);
+      net_ipv4addr_hdrcopy(ipv4->srcipaddr, &dev->d_ipaddr);
+
+      tcp_mss    = TCP_IPv4_MSS(dev);
+      dev->d_len = IPv4TCP_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  /* Set the TCP sequence numbers and port numbers */
+
+  memcpy(tcp->ackno, sc->rcvseq, 4);
+  memcpy(tcp->seqno, sc->isn, 4);
+
+  tcp->srcport  = sc->lport;
+  tcp->destport = sc->rport;
+  tcp->flags    = TCP_ACK | TCP_SYN;
+
+  /* Include the options that the peer offered in its SYN */
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if ((sc->opts.tcpoptions & TCP_OPTF_WSCALE) != 0)
+    {
+      sc->rcv_wscale = tcp_rcvwscale(dev);
+      wscale         = sc->rcv_wscale;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  sack = ((sc->opts.tcpoptions & TCP_OPTF_SACK) != 0);
+#endif
+
+  optlen          = tcp_synoptions(tcp->optdata, tcp_mss, wscale, sack);
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
+  dev->d_len     += optlen;
+
+  /* The window field of a SYN segment is never scaled */
+
+  recvwndo = NET_DEV_RCVWNDO(dev);
+  if (recvwndo > UINT16_MAX)
+    {
+      recvwndo = UINT16_MAX;
+    }
+
+  tcp->wnd[0] = recvwndo >> 8;
+  tcp->wnd[1] = recvwndo & 0xff;
+
+  /* Finish the IP portion of the message and calculate checksums */
+
+  tcp_sendcomplete(dev, tcp);
+}
+#endif /* CONFIG_NET_TCP_SYNCACHE */
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -63,6 +63,7 @@
 
 #include <arch/irq.h>
 #include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
@@ -92,6 +93,18 @@
 #define TCPIPv4BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define TCPIPv6BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
+/* Sequence number comparison (modulo 2**32) */
+
+#define SEQ_LE(a,b) ((int32_t)((a) - (b)) <= 0)
+
+/* sendfile() fills write buffers of at most half of the I/O buffers so
+ * that a single transfer cannot wait forever for buffers that it holds
+ * itself.
+ */
+
+#define SENDFILE_WRBSIZE \
+  (((CONFIG_IOB_NBUFFERS + 1) / 2) * CONFIG_IOB_BUFSIZE)
+
 /* Debug */
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
@@ -155,6 +168,167 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
     }
 }
 
+/****************************************************************************
+ * Name: psock_sack_update
+ *
+ * Description:
+ *   Update the SACK scoreboard from the SACK option (if any) of an incoming
+ *   ACK.  Each write buffer in the unacked_q that lies entirely within one
+ *   of the SACK blocks is marked as SACKed so that it will not be resent on
+ *   the next retransmission timeout.
+ *
+ * Parameters:
+ *   conn  The connection structure associated with the socket
+ *   tcp   The TCP header of the incoming ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+static void psock_sack_update(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR uint8_t *options;
+  uint32_t left;
+  uint32_t right;
+  int optlen;
+  int len;
+  int i;
+  int j;
+
+  options = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  optlen  = (((tcp->tcpoffset >> 4) - 5) << 2);
+
+  for (i = 0; i < optlen; )
+    {
+      if (options[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (options[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+
+      /* All other options have a length field */
+
+      if (i + 1 >= optlen || options[i + 1] == 0 ||
+          i + options[i + 1] > optlen)
+        {
+          break;
+        }
+
+      len = options[i + 1];
+      if (options[i] == TCP_OPT_SACK && len >= 10 && ((len - 2) & 7) == 0)
+        {
+          /* Visit each SACK block:  left edge, right edge (exclusive) */
+
+          for (j = i + 2; j < i + len; j += 8)
+            {
+              left  = tcp_getsequence(&options[j]);
+              right = tcp_getsequence(&options[j + 4]);
+
+              ninfo("SACK: left=%u right=%u\n", left, right);
+
+              for (entry = sq_peek(&conn->unacked_q);
+                   entry != NULL;
+                   entry = sq_next(entry))
+                {
+                  wrb = (FAR struct tcp_wrbuffer_s *)entry;
+                  if (SEQ_LE(left, WRB_SEQNO(wrb)) &&
+                      SEQ_LE(WRB_SEQNO(wrb) + WRB_PKTLEN(wrb), right))
+                    {
+                      WRB_SACKED(wrb) = true;
+                    }
+                }
+            }
+
+          break;
+        }
+
+      i += len;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: psock_fast_rexmit
+ *
+ * Description:
+ *   Move the oldest un-ACKed (and not SACKed) write buffer from the
+ *   unacked_q back to the write_q so that it is resent on the next poll
+ *   without waiting for the retransmission timer.
+ *
+ * Parameters:
+ *   conn  The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static void psock_fast_rexmit(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *prev = NULL;
+  uint16_t sent;
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+#ifdef CONFIG_NET_TCP_SACK
+      if (WRB_SACKED((FAR struct tcp_wrbuffer_s *)entry))
+        {
+          prev = entry;
+          continue;
+        }
+#endif
+
+      break;
+    }
+
+  if (entry == NULL)
+    {
+      return;
+    }
+
+  if (prev != NULL)
+    {
+      sq_remafter(prev, &conn->unacked_q);
+    }
+  else
+    {
+      sq_remfirst(&conn->unacked_q);
+    }
+
+  wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+  sent = WRB_SENT(wrb);
+
+  conn->unacked = conn->unacked > sent ? conn->unacked - sent : 0;
+  conn->sent    = conn->sent > sent ? conn->sent - sent : 0;
+
+  WRB_SENT(wrb) = 0;
+  WRB_NRTX(wrb)++;
+
+  ninfo("FASTREXMIT: wrb=%p seqno=%u unacked=%u\n",
+        wrb, WRB_SEQNO(wrb), conn->unacked);
+
+  psock_insert_segment(wrb, &conn->write_q);
+}
+#endif
+
 /****************************************************************************
  * Name: psock_lost_connection
  *
@@ -503,6 +677,38 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, WRB_SEQNO(wrb), WRB_PKTLEN(wrb), WRB_SENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_SACK
+      /* Record any segments that the peer holds beyond the ACKed data */
+
+      if ((conn->tcpoptions & TCP_OPTF_SACK) != 0)
+        {
+          psock_sack_update(conn, tcp);
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+      /* Update the congestion window.  On a fast retransmit, resend the
+       * missing segment now rather than waiting for the timer.
+       */
+
+      if (tcp_cc_ack(conn, ackno, (flags & TCP_NEWDATA) == 0))
+        {
+          psock_fast_rexmit(conn);
+        }
+#endif
+
+#if defined(CONFIG_NET_TCP_CC) || defined(CONFIG_NET_TCP_NAGLE)
+      /* The window may have opened or held data may now be sent:  Ask for
+       * a poll to send more data
+       */
+
+      if (!sq_empty(&conn->write_q))
+        {
+          tcp_txpending(conn->dev, conn);
+          netdev_txnotify_dev(conn->dev);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -530,9 +736,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     {
       FAR struct tcp_wrbuffer_s *wrb;
       FAR sq_entry_t *entry;
+#ifdef CONFIG_NET_TCP_SACK
+      sq_queue_t sacked;
+#endif
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Restart from a window of one segment */
+
+      tcp_cc_timeout(conn);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -601,6 +816,27 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
         }
 
+#ifdef CONFIG_NET_TCP_SACK
+      /* If the oldest un-ACKed segment has been SACKed, then nothing is
+       * missing before it and yet it was not ACKed:  The peer has discarded
+       * data that it had SACKed.  Forget the scoreboard and resend all.
+       */
+
+      sq_init(&sacked);
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+      if (wrb != NULL && WRB_SACKED(wrb))
+        {
+          nwarn("WARNING: SACKed data reneged\n");
+
+          for (entry = sq_peek(&conn->unacked_q);
+               entry != NULL;
+               entry = sq_next(entry))
+            {
+              WRB_SACKED((FAR struct tcp_wrbuffer_s *)entry) = false;
+            }
+        }
+#endif
+
       /* Move all segments that have been sent but not ACKed to the write
        * queue again note, the un-ACKed segments are put at the head of the
        * write_q so they can be resent as soon as possible.
@@ -611,6 +847,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           wrb = (FAR struct tcp_wrbuffer_s *)entry;
           uint16_t sent;
 
+#ifdef CONFIG_NET_TCP_SACK
+          /* The peer already holds the SACKed segments.  They remain
+           * un-ACKed (and in flight) but do not need to be resent.
+           */
+
+          if (WRB_SACKED(wrb))
+            {
+              ninfo("REXMIT: wrb=%p SACKed, not resent\n", wrb);
+              sq_addfirst(entry, &sacked);
+              continue;
+            }
+#endif
+
           /* Reset the number of bytes sent sent from the write buffer */
 
           sent = WRB_SENT(wrb);
@@ -671,6 +920,14 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               psock_insert_segment(wrb, &conn->write_q);
             }
         }
+
+#ifdef CONFIG_NET_TCP_SACK
+      /* Return the SACKed segments (still in sequence number order) to the
+       * now empty unacked_q.
+       */
+
+      sq_move(&sacked, &conn->unacked_q);
+#endif
     }
 
   /* Check if the outgoing packet is available (it may have been claimed
@@ -705,8 +962,30 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
         {
           FAR struct tcp_wrbuffer_s *wrb;
           uint32_t predicted_seqno;
+          uint32_t wnd;
           size_t sndlen;
 
+          /* Limit the data in flight to the smaller of the receive window
+           * and the congestion window.
+           */
+
+          wnd = conn->winsize;
+#ifdef CONFIG_NET_TCP_CC
+          if (wnd > conn->cwnd)
+            {
+              wnd = conn->cwnd;
+            }
+
+          if (conn->unacked >= wnd)
+            {
+              ninfo("SEND: cwnd full unacked=%u cwnd=%u\n",
+                    conn->unacked, conn->cwnd);
+              return flags;
+            }
+
+          wnd -= conn->unacked;
+#endif
+
           /* Peek at the head of the write queue (but don't remove anything
            * from the write queue yet).  We know from the above test that
            * the write_q is not empty.
@@ -722,14 +1001,46 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            */
 
           sndlen = WRB_PKTLEN(wrb) - WRB_SENT(wrb);
+#ifdef CONFIG_NETDEV_TSO
+          /* A device that segments TCP data itself may be given up to
+           * d_tsomax bytes at once.
+           */
+
+          if (sndlen > conn->mss && dev->d_sgtx &&
+              dev->d_tsomax > conn->mss)
+            {
+              if (sndlen > dev->d_tsomax)
+                {
+                  sndlen = dev->d_tsomax;
+                }
+            }
+          else
+#endif
           if (sndlen > conn->mss)
             {
               sndlen = conn->mss;
             }
 
-          if (sndlen > conn->winsize)
+#ifdef CONFIG_NET_TCP_NAGLE
+          /* Hold back a partial segment of new data if it is the last data
+           * queued and either the connection is corked or, per the Nagle
+           * algorithm, sent data is still waiting to be ACKed.  More
+           * data may then be added to the write buffer.
+           */
+
+          if (sndlen < conn->mss && WRB_NRTX(wrb) == 0 &&
+              sq_next(&wrb->wb_node) == NULL &&
+              (conn->cork || (!conn->nodelay && conn->unacked > 0)))
+            {
+              ninfo("SEND: Hold wrb=%p sndlen=%u unacked=%u\n",
+                    wrb, sndlen, conn->unacked);
+              return flags;
+            }
+#endif
+
+          if (sndlen > wnd)
             {
-              sndlen = conn->winsize;
+              sndlen = wnd;
             }
 
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
@@ -770,6 +1081,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           devif_iob_send(dev, WRB_IOB(wrb), sndlen, WRB_SENT(wrb));
 
+#ifdef CONFIG_NETDEV_TSO
+          if (sndlen > conn->mss)
+            {
+              dev->d_txmss = conn->mss;
+            }
+#endif
+
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
            * the amount of data sent. This will be needed in sequence
@@ -834,6 +1152,74 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: send_coalesce
+ *
+ * Description:
+ *   Append new data to the last write buffer in the write queue if none of
+ *   its data has been sent yet, filling it up to one full segment.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *   buf  - The data to send
+ *   len  - The length of the data to send
+ *
+ * Returned Value:
+ *   The number of bytes added to the write queue
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static size_t send_coalesce(FAR struct tcp_conn_s *conn,
+                            FAR const uint8_t *buf, size_t len)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR struct iob_s *iob;
+  int ret;
+
+  wrb = (FAR struct tcp_wrbuffer_s *)conn->write_q.tail;
+  if (wrb == NULL || WRB_SEQNO(wrb) != (unsigned)-1 ||
+      WRB_PKTLEN(wrb) >= conn->mss)
+    {
+      return 0;
+    }
+
+  /* iob_copyin() would wait for a new I/O buffer if there were no room at
+   * all in the last one.  Once some data has been copied, it allocates
+   * more I/O buffers without waiting.
+   */
+
+  iob = WRB_IOB(wrb);
+  while (iob->io_flink != NULL)
+    {
+      iob = iob->io_flink;
+    }
+
+  if (iob->io_offset + iob->io_len >= IOB_BUFSIZE(iob))
+    {
+      return 0;
+    }
+
+  if (len > conn->mss - WRB_PKTLEN(wrb))
+    {
+      len = conn->mss - WRB_PKTLEN(wrb);
+    }
+
+  ret = iob_copyin(WRB_IOB(wrb), buf, len, WRB_PKTLEN(wrb), false);
+  if (ret <= 0)
+    {
+      return 0;
+    }
+
+  ninfo("Coalesced %d bytes into WRB=%p pktlen=%u\n",
+        ret, wrb, WRB_PKTLEN(wrb));
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: send_txnotify
  *
@@ -853,6 +1239,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Put the connection on its device's Tx pending list */
+
+  tcp_txpending(conn->dev, conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -881,6 +1271,228 @@ static inline void send_txnotify(FAR struct socket *psock,
 #endif /* CONFIG_NET_IPv6 */
 }
 
+/****************************************************************************
+ * Name: send_getmapping
+ *
+ * Description:
+ *   Make sure that the IP address mapping of the remote peer is in the ARP
+ *   table (IPv4) or the Neighbor Table (IPv6).
+ *
+ * Parameters:
+ *   psock - Socket state structure
+ *   conn  - The TCP connection structure
+ *
+ * Returned Value:
+ *   OK if the mapping is available; a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+static inline int send_getmapping(FAR struct socket *psock,
+                                  FAR struct tcp_conn_s *conn)
+{
+  int ret = OK;
+
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
+#ifdef CONFIG_NET_ARP_SEND
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+  if (psock->s_domain == PF_INET)
+#endif
+    {
+      /* Make sure that the IP address mapping is in the ARP table */
+
+      ret = arp_send(conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_ARP_SEND */
+
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+#ifdef CONFIG_NET_ARP_SEND
+  else
+#endif
+    {
+      /* Make sure that the IP address mapping is in the Neighbor Table */
+
+      ret = icmpv6_neighbor(conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_ICMPv6_NEIGHBOR */
+#endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: send_queuewrb
+ *
+ * Description:
+ *   Set up the send callback of the socket, add a filled write buffer to
+ *   the write queue of the connection, and notify the device driver.
+ *
+ * Parameters:
+ *   psock - Socket state structure
+ *   conn  - The TCP connection structure
+ *   wrb   - The write buffer to send
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if no callback could be allocated.  The write
+ *   buffer is not queued in that case.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int send_queuewrb(FAR struct socket *psock,
+                         FAR struct tcp_conn_s *conn,
+                         FAR struct tcp_wrbuffer_s *wrb)
+{
+  /* Allocate resources to receive a callback */
+
+  if (psock->s_sndcb == NULL)
+    {
+      psock->s_sndcb = tcp_callback_alloc(conn);
+    }
+
+  /* Test if the callback has been allocated */
+
+  if (psock->s_sndcb == NULL)
+    {
+      nerr("ERROR: Failed to allocate callback\n");
+      return -ENOMEM;
+    }
+
+  /* Set up the callback in the connection */
+
+  psock->s_sndcb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
+                           TCP_DISCONN_EVENTS);
+  psock->s_sndcb->priv  = (FAR void *)psock;
+  psock->s_sndcb->event = psock_send_eventhandler;
+
+  /* Dump I/O buffer chain */
+
+  WRB_DUMP("I/O buffer chain", wrb, WRB_PKTLEN(wrb), 0);
+
+  /* psock_send_eventhandler() will send data in FIFO order from the
+   * conn->write_q
+   */
+
+  sq_addlast(&wrb->wb_node, &conn->write_q);
+  ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
+        wrb, WRB_PKTLEN(wrb),
+        conn->write_q.head, conn->write_q.tail);
+
+  /* Notify the device driver of the availability of TX data */
+
+  send_txnotify(psock, conn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sendfile_wrbfill
+ *
+ * Description:
+ *   Fill the I/O buffer chain of a write buffer directly from the input
+ *   file (or from the memory holding the file if 'src' is not NULL).  No
+ *   intermediate buffer is used.
+ *
+ * Parameters:
+ *   wrb    - The write buffer to fill
+ *   infile - The input file, read from its current file position
+ *   src    - The address of the file data if the file is mapped in
+ *            memory; NULL otherwise
+ *   len    - The number of bytes to transfer
+ *
+ * Returned Value:
+ *   The number of bytes placed in the write buffer (less than 'len' at
+ *   the end of the file) or a negated errno value if nothing could be
+ *   read.
+ *
+ * Assumptions:
+ *   The network is not locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+static ssize_t sendfile_wrbfill(FAR struct tcp_wrbuffer_s *wrb,
+                                FAR struct file *infile,
+                                FAR const uint8_t *src, size_t len)
+{
+  FAR struct iob_s *head = WRB_IOB(wrb);
+  FAR struct iob_s *prev = NULL;
+  FAR struct iob_s *iob = head;
+  size_t remaining = len;
+  unsigned int avail;
+  ssize_t nread;
+
+  while (remaining > 0)
+    {
+      avail = IOB_BUFSIZE(iob) - (iob->io_offset + iob->io_len);
+      if (avail == 0)
+        {
+          /* This I/O buffer is full.  Extend the chain. */
+
+          iob->io_flink = iob_alloc_size(false, remaining);
+          if (iob->io_flink == NULL)
+            {
+              break;
+            }
+
+          prev = iob;
+          iob  = iob->io_flink;
+          continue;
+        }
+
+      if (avail > remaining)
+        {
+          avail = remaining;
+        }
+
+      if (src != NULL)
+        {
+          memcpy(&iob->io_data[iob->io_offset + iob->io_len], src, avail);
+          src  += avail;
+          nread = avail;
+        }
+      else
+        {
+          nread = file_read(infile,
+                            &iob->io_data[iob->io_offset + iob->io_len],
+                            avail);
+          if (nread < 0)
+            {
+              int errcode = get_errno();
+
+              nerr("ERROR: Failed to read from input file: %d\n", errcode);
+              if (remaining == len)
+                {
+                  return -errcode;
+                }
+
+              break;
+            }
+          else if (nread == 0)
+            {
+              /* End of file */
+
+              break;
+            }
+        }
+
+      iob->io_len     += nread;
+      head->io_pktlen += nread;
+      remaining       -= nread;
+    }
+
+  /* Don't leave an empty I/O buffer at the end of the chain */
+
+  if (iob->io_len == 0 && prev != NULL)
+    {
+      prev->io_flink = NULL;
+      (void)iob_free(iob);
+    }
+
+  return len - remaining;
+}
+#endif /* CONFIG_NET_SENDFILE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -970,38 +1582,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   conn = (FAR struct tcp_conn_s *)psock->s_conn;
   DEBUGASSERT(conn);
 
-#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
-#ifdef CONFIG_NET_ARP_SEND
-#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
-  if (psock->s_domain == PF_INET)
-#endif
-    {
-      /* Make sure that the IP address mapping is in the ARP table */
-
-      ret = arp_send(conn->u.ipv4.raddr);
-    }
-#endif /* CONFIG_NET_ARP_SEND */
-
-#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
-#ifdef CONFIG_NET_ARP_SEND
-  else
-#endif
-    {
-      /* Make sure that the IP address mapping is in the Neighbor Table */
-
-      ret = icmpv6_neighbor(conn->u.ipv6.raddr);
-    }
-#endif /* CONFIG_NET_ICMPv6_NEIGHBOR */
-
-  /* Did we successfully get the address mapping? */
-
+  ret = send_getmapping(psock, conn);
   if (ret < 0)
     {
       nerr("ERROR: Not reachable\n");
       errcode = ENETUNREACH;
       goto errout;
     }
-#endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
   /* Dump the incoming buffer */
 
@@ -1013,68 +1600,57 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
-      /* Allocate a write buffer.  Careful, the network will be momentarily
-       * unlocked here.
-       */
-
       net_lock();
-      wrb = tcp_wrbuffer_alloc();
-      if (!wrb)
-        {
-          /* A buffer allocation error occurred */
 
-          nerr("ERROR: Failed to allocate write buffer\n");
-          errcode = ENOMEM;
-          goto errout_with_lock;
-        }
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* First, add what will fit to the data still waiting to be sent */
 
-      /* Allocate resources to receive a callback */
-
-      if (psock->s_sndcb == NULL)
+      result = send_coalesce(conn, (FAR const uint8_t *)buf, len);
+      if (result > 0)
         {
-          psock->s_sndcb = tcp_callback_alloc(conn);
+          send_txnotify(psock, conn);
         }
 
-      /* Test if the callback has been allocated */
-
-      if (psock->s_sndcb == NULL)
+      if ((size_t)result < len)
+#endif
         {
-          /* A buffer allocation error occurred */
-
-          nerr("ERROR: Failed to allocate callback\n");
-          errcode = ENOMEM;
-          goto errout_with_wrb;
-        }
-
-      /* Set up the callback in the connection */
-
-      psock->s_sndcb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
-                               TCP_DISCONN_EVENTS);
-      psock->s_sndcb->priv  = (FAR void *)psock;
-      psock->s_sndcb->event = psock_send_eventhandler;
-
-      /* Initialize the write buffer */
+          /* Allocate a write buffer.  Careful, the network will be
+           * momentarily unlocked here.
+           */
 
-      WRB_SEQNO(wrb) = (unsigned)-1;
-      WRB_NRTX(wrb)  = 0;
-      result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
+          wrb = tcp_wrbuffer_alloc();
+          if (wrb != NULL)
+            {
+              /* Initialize the write buffer */
 
-      /* Dump I/O buffer chain */
+              WRB_SEQNO(wrb) = (unsigned)-1;
+              WRB_NRTX(wrb)  = 0;
+              result += WRB_COPYIN(wrb, (FAR uint8_t *)buf + result,
+                                   len - result);
 
-      WRB_DUMP("I/O buffer chain", wrb, WRB_PKTLEN(wrb), 0);
+              /* Add the write buffer to the write queue of the connection */
 
-      /* psock_send_eventhandler() will send data in FIFO order from the
-       * conn->write_q
-       */
+              ret = send_queuewrb(psock, conn, wrb);
+              if (ret < 0)
+                {
+                  /* A buffer allocation error occurred */
 
-      sq_addlast(&wrb->wb_node, &conn->write_q);
-      ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
-            wrb, WRB_PKTLEN(wrb),
-            conn->write_q.head, conn->write_q.tail);
+                  errcode = -ret;
+                  goto errout_with_wrb;
+                }
+            }
+          else if (result <= 0)
+            {
+              /* A buffer allocation error occurred (but any data that was
+               * already added to the write queue is reported as sent).
+               */
 
-      /* Notify the device driver of the availability of TX data */
+              nerr("ERROR: Failed to allocate write buffer\n");
+              errcode = ENOMEM;
+              goto errout_with_lock;
+            }
+        }
 
-      send_txnotify(psock, conn);
       net_unlock();
     }
 
@@ -1164,4 +1740,183 @@ int psock_tcp_cansend(FAR struct socket *psock)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tcp_sendfile
+ *
+ * Description:
+ *   Transfer file data to a connected TCP socket.  The data is read from
+ *   the file directly into the I/O buffers of write buffers that are then
+ *   queued for transmission just like the data of send().  If the file is
+ *   directly accessible in memory (see file_xipmap()), the I/O buffers are
+ *   filled from that memory without going through the file system.
+ *
+ *   Like send(), this function returns when the data has been queued for
+ *   transmission; it does not wait for the data to be acknowledged.
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   infile   The input file
+ *   offset   If not NULL, the file offset to start from.  It is updated on
+ *            return and the file position is not changed.  Otherwise, the
+ *            transfer starts at the current file position which is updated.
+ *   count    The number of bytes to transfer.
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes queued.  On error, a negated
+ *   errno value is returned.  See sendfile() for a list of appropriate
+ *   error return values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
+                     FAR off_t *offset, size_t count)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR const uint8_t *xipaddr = NULL;
+  ssize_t nsent = 0;
+  ssize_t nfilled;
+  ssize_t avail;
+  size_t chunk;
+  off_t curpos;
+  off_t pos;
+  int ret = OK;
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      nerr("ERROR: Invalid socket\n");
+      return -EBADF;
+    }
+
+  if (psock->s_type != SOCK_STREAM || !_SS_ISCONNECTED(psock->s_flags))
+    {
+      nerr("ERROR: Not connected\n");
+      return -ENOTCONN;
+    }
+
+  /* Make sure that we have the IP address mapping */
+
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn);
+
+  if (send_getmapping(psock, conn) < 0)
+    {
+      nerr("ERROR: Not reachable\n");
+      return -ENETUNREACH;
+    }
+
+  /* Get the position to start from */
+
+  curpos = infile->f_pos;
+  pos    = offset ? *offset : curpos;
+
+  /* Can the file data be accessed directly in memory?  If not, position
+   * the file for reading.
+   */
+
+  avail = file_xipmap(infile, pos, &xipaddr);
+  if (avail >= 0)
+    {
+      if (count > (size_t)avail)
+        {
+          count = avail;
+        }
+    }
+  else
+    {
+      xipaddr = NULL;
+      if (pos != curpos && file_seek(infile, pos, SEEK_SET) < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  /* Set the socket state to sending */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
+
+  while ((size_t)nsent < count)
+    {
+      chunk = count - nsent;
+      if (chunk > SENDFILE_WRBSIZE)
+        {
+          chunk = SENDFILE_WRBSIZE;
+        }
+
+      /* Allocate a write buffer.  Careful, the network will be momentarily
+       * unlocked here.
+       */
+
+      net_lock();
+      wrb = tcp_wrbuffer_alloc();
+      net_unlock();
+
+      if (wrb == NULL)
+        {
+          nerr("ERROR: Failed to allocate write buffer\n");
+          ret = -ENOMEM;
+          break;
+        }
+
+      WRB_SEQNO(wrb) = (unsigned)-1;
+      WRB_NRTX(wrb)  = 0;
+
+      /* Fill the write buffer with the network unlocked:  Reading the file
+       * may take some time.
+       */
+
+      nfilled = sendfile_wrbfill(wrb, infile,
+                                 xipaddr ? xipaddr + nsent : NULL, chunk);
+
+      net_lock();
+      if (nfilled <= 0)
+        {
+          tcp_wrbuffer_release(wrb);
+          net_unlock();
+          ret = nfilled;
+          break;
+        }
+
+      ret = send_queuewrb(psock, conn, wrb);
+      if (ret < 0)
+        {
+          tcp_wrbuffer_release(wrb);
+          net_unlock();
+          break;
+        }
+
+      net_unlock();
+      nsent += nfilled;
+
+      if ((size_t)nfilled < chunk)
+        {
+          /* End of file (or out of I/O buffers) */
+
+          break;
+        }
+    }
+
+  /* Set the socket state to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  /* Update the offset or the file position */
+
+  pos += nsent;
+  if (offset)
+    {
+      *offset = pos;
+      pos     = curpos;
+    }
+
+  if (infile->f_pos != pos)
+    {
+      (void)file_seek(infile, pos, SEEK_SET);
+    }
+
+  return nsent > 0 ? nsent : ret;
+}
+#endif /* CONFIG_NET_SENDFILE */
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_WRITE_BUFFERS */
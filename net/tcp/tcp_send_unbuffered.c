@@ -103,6 +103,7 @@ struct send_s
   FAR const uint8_t      *snd_buffer;  /* Points to the buffer of data to send */
   size_t                  snd_buflen;  /* Number of bytes in the buffer to send */
   ssize_t                 snd_sent;    /* The number of bytes sent */
+  ssize_t                 snd_max;     /* Highest number of bytes ever sent */
   uint32_t                snd_isn;     /* Initial sequence number */
   uint32_t                snd_acked;   /* The number of bytes acked */
 #ifdef CONFIG_NET_SOCKOPTS
@@ -318,6 +319,7 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
   if ((flags & TCP_ACKDATA) != 0)
     {
       FAR struct tcp_hdr_s *tcp;
+      uint32_t ackno;
 
       /* Update the timeout */
 
@@ -353,7 +355,25 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
        * of bytes to be acknowledged.
        */
 
-      pstate->snd_acked = tcp_getsequence(tcp->ackno) - pstate->snd_isn;
+      /* With several segments in flight, ACKs may be re-ordered.  Never
+       * move the ACKed count backward.
+       */
+
+      ackno = tcp_getsequence(tcp->ackno) - pstate->snd_isn;
+      if ((int32_t)(ackno - pstate->snd_acked) > 0)
+        {
+          pstate->snd_acked = ackno;
+        }
+
+      /* After a retransmission, the peer may ACK data beyond that which
+       * we have resent.  Do not send that data again.
+       */
+
+      if (pstate->snd_sent < (ssize_t)pstate->snd_acked)
+        {
+          pstate->snd_sent = pstate->snd_acked;
+        }
+
       ninfo("ACK: acked=%d sent=%d buflen=%d\n",
             pstate->snd_acked, pstate->snd_sent, pstate->snd_buflen);
 
@@ -376,7 +396,8 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
   else if ((flags & TCP_REXMIT) != 0)
     {
       /* Yes.. in this case, reset the number of bytes that have been sent
-       * to the number of bytes that have been ACKed.
+       * to the number of bytes that have been ACKed.  Everything after that
+       * will be resent (go-back-N); snd_max still records how far we got.
        */
 
       pstate->snd_sent = pstate->snd_acked;
@@ -428,7 +449,9 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
 
   if ((flags & TCP_NEWDATA) == 0 && pstate->snd_sent < pstate->snd_buflen)
     {
+      uint32_t winsize;
       uint32_t seqno;
+      ssize_t sndmax;
 
       /* Get the amount of data that we can send in the next packet */
 
@@ -520,9 +543,22 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
           sndlen = conn->mss;
         }
 
-      /* Check if we have "space" in the window */
+      /* Check if we have "space" in the window.  Several segments may be
+       * in flight at once; each poll or ACK sends the next segment until
+       * the peer's window is full.
+       */
+
+      winsize = conn->winsize;
+#ifndef CONFIG_NET_TCP_WRITE_BUFFERS
+      if (winsize > UINT16_MAX)
+        {
+          /* conn->unacked is only 16-bits wide */
+
+          winsize = UINT16_MAX;
+        }
+#endif
 
-      if ((pstate->snd_sent - pstate->snd_acked + sndlen) < conn->winsize)
+      if ((pstate->snd_sent - pstate->snd_acked + sndlen) < winsize)
         {
           /* Set the sequence number for this packet.  NOTE:  The network updates
            * sndseq on receipt of ACK *before* this function is called.  In that
@@ -555,14 +591,45 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
            * will be replaced with an ARP request or Neighbor Solicitation.
            */
 
+          /* sndseq is rewound to the start of this segment, but the peer
+           * may already hold data up to snd_max.  The network computes the
+           * next expected ACK as sndseq + unacked, so unacked must reach to
+           * the end of everything that has been sent.  tcp_appsend() will
+           * add sndlen for new data; the retransmission path does not.
+           */
+
+          sndmax = pstate->snd_sent + sndlen;
+          if (sndmax < pstate->snd_max)
+            {
+              sndmax = pstate->snd_max;
+            }
+
+          conn->unacked = sndmax - pstate->snd_sent;
+          if ((flags & TCP_REXMIT) == 0)
+            {
+              conn->unacked -= sndlen;
+            }
+
           if (pstate->snd_sent != 0 || psock_send_addrchck(conn))
             {
               /* Update the amount of data sent (but not necessarily ACKed) */
 
               pstate->snd_sent += sndlen;
+              pstate->snd_max   = sndmax;
               ninfo("SEND: acked=%d sent=%d buflen=%d\n",
                     pstate->snd_acked, pstate->snd_sent, pstate->snd_buflen);
 
+              /* If there is more to send and the window is still open, ask
+               * the driver to poll again so that the next segment follows
+               * without waiting for the ACK of this one.
+               */
+
+              if (pstate->snd_sent < pstate->snd_buflen &&
+                  pstate->snd_sent - pstate->snd_acked < winsize)
+                {
+                  tcp_txpending(dev, conn);
+                  netdev_txnotify_dev(dev);
+                }
             }
         }
     }
@@ -622,6 +689,10 @@ end_wait:
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Put the connection on its device's Tx pending list */
+
+  tcp_txpending(conn->dev, conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -51,6 +51,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -99,6 +100,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_xipbase; /* File data in memory, if mapped */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -179,7 +181,7 @@ static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
       if (IFF_IS_IPv6(dev->d_flags))
 #endif
         {
-          DEBUGASSERT(pstate->snd_sock == PF_INET6);
+          DEBUGASSERT(pstate->snd_sock->s_domain == PF_INET6);
           tcp = TCPIPv6BUF;
         }
 #endif /* CONFIG_NET_IPv6 */
@@ -189,7 +191,7 @@ static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
       else
 #endif
         {
-          DEBUGASSERT(pstate->snd_sock == PF_INET);
+          DEBUGASSERT(pstate->snd_sock->s_domain == PF_INET);
           tcp = TCPIPv4BUF;
         }
 #endif /* CONFIG_NET_IPv4 */
@@ -304,7 +306,7 @@ static inline bool sendfile_addrcheck(FAR struct tcp_conn_s *conn)
 }
 
 #else /* CONFIG_NET_ETHERNET */
-#  sendfile_addrcheck(r) (true)
+#  define sendfile_addrcheck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
 /****************************************************************************
@@ -390,23 +392,36 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_xipbase != NULL)
             {
-              int errcode = get_errno();
-              nerr("ERROR: Failed to lseek: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
-            }
+              /* The file data is directly accessible in memory */
 
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+              memcpy(dev->d_appdata,
+                     pstate->snd_xipbase + pstate->snd_sent, sndlen);
+              ret = sndlen;
+            }
+          else
             {
-              int errcode = get_errno();
-              nerr("ERROR: Failed to read from input file: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  int errcode = get_errno();
+                  nerr("ERROR: Failed to lseek: %d\n", errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  int errcode = get_errno();
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -502,6 +517,10 @@ wait:
 static inline void sendfile_txnotify(FAR struct socket *psock,
                                      FAR struct tcp_conn_s *conn)
 {
+  /* Put the connection on its device's Tx pending list */
+
+  tcp_txpending(conn->dev, conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -543,9 +562,11 @@ static inline void sendfile_txnotify(FAR struct socket *psock,
  *
  * Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
+ *   infile   The input file
+ *   offset   If not NULL, the file offset to start from.  It is updated on
+ *            return and the file position is not changed.  Otherwise, the
+ *            transfer starts at the current file position which is updated.
+ *   count    The number of bytes to transfer.
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -558,8 +579,11 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *xipaddr = NULL;
   struct sendfile_s state;
-  int ret;
+  ssize_t avail;
+  off_t curpos;
+  int ret = OK;
 
   /* If this is an un-connected socket, then return ENOTCONN */
 
@@ -605,6 +629,21 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Get the position to start from.  If the file data is directly
+   * accessible in memory, it will be sent from there.
+   */
+
+  curpos = infile->f_pos;
+  avail  = file_xipmap(infile, offset ? *offset : curpos, &xipaddr);
+  if (avail < 0)
+    {
+      xipaddr = NULL;
+    }
+  else if (count > (size_t)avail)
+    {
+      count = avail;
+    }
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -625,9 +664,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   sem_setprotocol(&state.snd_sem, SEM_PRIO_NONE);
 
   state.snd_sock    = psock;                /* Socket descriptor to use */
-  state.snd_foffset = offset ? *offset : 0; /* Input file offset */
+  state.snd_foffset = offset ? *offset : curpos; /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_xipbase = xipaddr;              /* Or memory to copy from */
 
   /* Allocate resources to receive a callback */
 
@@ -636,7 +676,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   if (state.snd_datacb == NULL)
     {
       nerr("ERROR: Failed to allocate data callback\n");
-      ret =- ENOMEM;
+      ret = -ENOMEM;
       goto errout_locked;
     }
 
@@ -697,19 +737,34 @@ errout_datacb:
 
 errout_locked:
 
-  sem_destroy(&state. snd_sem);
+  sem_destroy(&state.snd_sem);
   net_unlock();
 
-errout:
-
   if (ret < 0)
     {
       return ret;
     }
-  else
+
+  /* Update the offset or the file position */
+
+  if (state.snd_sent > 0)
     {
-      return state.snd_sent;
+      if (offset)
+        {
+          *offset += state.snd_sent;
+        }
+      else
+        {
+          curpos += state.snd_sent;
+        }
+    }
+
+  if (infile->f_pos != curpos)
+    {
+      (void)file_seek(infile, curpos, SEEK_SET);
     }
+
+  return state.snd_sent;
 }
 
 #endif /* CONFIG_NET_SENDFILE && CONFIG_NET_TCP && NET_TCP_HAVE_STACK */
@@ -0,0 +1,198 @@
+/****************************************************************************
+ * net/tcp/tcp_setsockopt.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+#if defined(NET_TCP_HAVE_STACK) && defined(CONFIG_NET_TCPPROTO_OPTIONS)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_sockopt_txnotify
+ *
+ * Description:
+ *   Ask for a poll of the connection's device so that write buffered data
+ *   that was held back can be sent.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static void tcp_sockopt_txnotify(FAR struct tcp_conn_s *conn)
+{
+  if (conn->dev != NULL && !sq_empty(&conn->write_q))
+    {
+      tcp_txpending(conn->dev, conn);
+      netdev_txnotify_dev(conn->dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_setsockopt
+ *
+ * Description:
+ *   Set an IPPROTO_TCP level socket option on a TCP connection.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure
+ *   option - The option to set (see netinet/tcp.h)
+ *   value  - The value of the option
+ *   len    - The length of the option value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tcp_setsockopt(FAR struct tcp_conn_s *conn, int option,
+                   FAR const void *value, socklen_t len)
+{
+  int ret = OK;
+
+  DEBUGASSERT(conn != NULL);
+
+  if (value == NULL)
+    {
+      return -EINVAL;
+    }
+
+  switch (option)
+    {
+      case TCP_NODELAY: /* Disable the Nagle algorithm */
+        {
+          if (len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+          net_lock();
+          conn->nodelay = (*(FAR const int *)value != 0);
+          if (conn->nodelay)
+            {
+              tcp_sockopt_txnotify(conn);
+            }
+
+          net_unlock();
+#endif
+        }
+        break;
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_CORK: /* Send only full-sized segments */
+        {
+          if (len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          net_lock();
+          conn->cork = (*(FAR const int *)value != 0);
+
+          /* Uncorking sends any partial segment that was held back */
+
+          if (!conn->cork)
+            {
+              tcp_sockopt_txnotify(conn);
+            }
+
+          net_unlock();
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      case TCP_QUICKACK: /* Disable delayed ACKs */
+        {
+          if (len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          net_lock();
+          conn->quickack = (*(FAR const int *)value != 0);
+
+          /* Don't hold back an ACK that is already being delayed */
+
+          if (conn->quickack)
+            {
+              tcp_delack_flush(conn);
+            }
+
+          net_unlock();
+        }
+        break;
+#endif
+
+      default:
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  return ret;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCPPROTO_OPTIONS */
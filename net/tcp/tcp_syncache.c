@@ -0,0 +1,388 @@
+/****************************************************************************
+ * net/tcp/tcp_syncache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_SYNCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/* An entry that has not been completed in this time is discarded */
+
+#define TCP_SYNCACHE_MAXAGE SEC2TICK(CONFIG_NET_TCP_SYNCACHE_TIMEOUT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The SYN cache.  Entries are not linked; the cache is small enough that
+ * it is simply searched.
+ */
+
+static struct tcp_syncache_s g_syncache[CONFIG_NET_TCP_SYNCACHE_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncache_match
+ *
+ * Description:
+ *   Return true if a SYN cache entry holds the connection request of the
+ *   TCP segment in the device buffer.
+ *
+ ****************************************************************************/
+
+static bool tcp_syncache_match(FAR struct net_driver_s *dev,
+                               FAR struct tcp_syncache_s *sc,
+                               FAR struct tcp_hdr_s *tcp)
+{
+  if (tcp->destport != sc->lport || tcp->srcport != sc->rport)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+#ifdef CONFIG_NET_IPv4
+      if (sc->domain != PF_INET6)
+        {
+          return false;
+        }
+#endif
+
+      return net_ipv6addr_cmp(*(FAR net_ipv6addr_t *)ip->srcipaddr,
+                              sc->u.ipv6.raddr) &&
+             net_ipv6addr_cmp(*(FAR net_ipv6addr_t *)ip->destipaddr,
+                              sc->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+#ifdef CONFIG_NET_IPv6
+      if (sc->domain != PF_INET)
+        {
+          return false;
+        }
+#endif
+
+      return net_ipv4addr_cmp(net_ip4addr_conv32(ip->srcipaddr),
+                              sc->u.ipv4.raddr) &&
+             net_ipv4addr_cmp(net_ip4addr_conv32(ip->destipaddr),
+                              sc->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: tcp_syncache_find
+ *
+ * Description:
+ *   Find the SYN cache entry for the TCP segment in the device buffer.
+ *   Entries that have timed out are discarded along the way.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_syncache_s *
+  tcp_syncache_find(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_syncache_s *sc;
+  systime_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TCP_SYNCACHE_SIZE; i++)
+    {
+      sc = &g_syncache[i];
+      if (sc->inuse && now - sc->time >= TCP_SYNCACHE_MAXAGE)
+        {
+          sc->inuse = false;
+        }
+
+      if (sc->inuse && tcp_syncache_match(dev, sc, tcp))
+        {
+          return sc;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncache_add
+ *
+ * Description:
+ *   Record the SYN in the device buffer that was received by a listener.
+ *   An existing entry is returned if the SYN is a retransmission.  If
+ *   the cache is full, the oldest entry is replaced.
+ *
+ * Returned Value:
+ *   The SYN cache entry for the connection request.  The mss field of
+ *   the options holds the default MSS on return from a new entry.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_syncache_s *tcp_syncache_add(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_syncache_s *sc;
+  FAR struct tcp_syncache_s *oldest = NULL;
+  systime_t now = clock_systimer();
+  int i;
+
+  /* A retransmitted SYN is answered with the same SYNACK.  A SYN with
+   * a new sequence number replaces the old request.
+   */
+
+  sc = tcp_syncache_find(dev, tcp);
+  if (sc != NULL)
+    {
+      uint8_t rcvseq[4];
+
+      memcpy(rcvseq, tcp->seqno, 4);
+      net_incr32(rcvseq, 1);
+
+      if (memcmp(rcvseq, sc->rcvseq, 4) == 0)
+        {
+          return sc;
+        }
+    }
+  else
+    {
+      /* Use a free entry or else replace the oldest one */
+
+      for (i = 0; i < CONFIG_NET_TCP_SYNCACHE_SIZE; i++)
+        {
+          sc = &g_syncache[i];
+          if (!sc->inuse)
+            {
+              break;
+            }
+
+          if (oldest == NULL || now - sc->time > now - oldest->time)
+            {
+              oldest = sc;
+            }
+        }
+
+      if (i >= CONFIG_NET_TCP_SYNCACHE_SIZE)
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.syndrop++;
+#endif
+          nwarn("WARNING: SYN cache full, replacing oldest entry\n");
+          sc = oldest;
+        }
+    }
+
+  /* Set up the addresses and the default MSS */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+      net_ipv6addr_copy(sc->u.ipv6.raddr, ip->srcipaddr);
+      net_ipv6addr_copy(sc->u.ipv6.laddr, ip->destipaddr);
+      sc->opts.mss = TCP_IPv6_INITIAL_MSS(dev);
+#ifdef CONFIG_NET_IPv4
+      sc->domain   = PF_INET6;
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      net_ipv4addr_copy(sc->u.ipv4.raddr,
+                        net_ip4addr_conv32(ip->srcipaddr));
+      net_ipv4addr_copy(sc->u.ipv4.laddr,
+                        net_ip4addr_conv32(ip->destipaddr));
+      sc->opts.mss = TCP_IPv4_INITIAL_MSS(dev);
+#ifdef CONFIG_NET_IPv6
+      sc->domain   = PF_INET;
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  /* rcvseq should be the seqno from the incoming packet + 1. */
+
+  sc->lport = tcp->destport;
+  sc->rport = tcp->srcport;
+  memcpy(sc->rcvseq, tcp->seqno, 4);
+  net_incr32(sc->rcvseq, 1);
+  tcp_initsequence(sc->isn);
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  sc->rcv_wscale = 0;
+#endif
+
+  sc->time  = now;
+  sc->inuse = true;
+  return sc;
+}
+
+/****************************************************************************
+ * Name: tcp_syncache_accept
+ *
+ * Description:
+ *   Called for a segment that matches neither an active connection nor a
+ *   SYN to a listener.  If the segment is the ACK that completes the
+ *   handshake of a SYN cache entry, a connection structure is allocated
+ *   for it in the TCP_SYN_RCVD state, just as if it had been allocated
+ *   by tcp_alloc_accept() when the SYN was received.  A RST removes the
+ *   matching entry.
+ *
+ * Returned Value:
+ *   The new connection or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_syncache_accept(FAR struct net_driver_s *dev,
+                                           FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_syncache_s *sc;
+  FAR struct tcp_conn_s *conn;
+  uint8_t ackno[4];
+
+  sc = tcp_syncache_find(dev, tcp);
+  if (sc == NULL)
+    {
+      return NULL;
+    }
+
+  if ((tcp->flags & TCP_RST) != 0)
+    {
+      /* The remote host aborted the request */
+
+      sc->inuse = false;
+      return NULL;
+    }
+
+  /* The segment must ACK our SYN and be the next in sequence */
+
+  memcpy(ackno, sc->isn, 4);
+  net_incr32(ackno, 1);
+
+  if ((tcp->flags & (TCP_SYN | TCP_ACK)) != TCP_ACK ||
+      memcmp(tcp->ackno, ackno, 4) != 0 ||
+      memcmp(tcp->seqno, sc->rcvseq, 4) != 0)
+    {
+      return NULL;
+    }
+
+  /* The handshake is complete.  Allocate the connection and give it the
+   * state of the entry.
+   */
+
+  sc->inuse = false;
+
+  conn = tcp_alloc_accept(dev, tcp);
+  if (conn == NULL)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.syndrop++;
+#endif
+      nerr("ERROR: No free TCP connections\n");
+      return NULL;
+    }
+
+  conn->crefs      = 1;
+  memcpy(conn->sndseq, sc->isn, 4);
+
+  conn->mss        = sc->opts.mss;
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE) || defined(CONFIG_NET_TCP_SACK)
+  conn->tcpoptions = sc->opts.tcpoptions;
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  conn->snd_wscale = sc->opts.snd_wscale;
+  conn->rcv_wscale = sc->rcv_wscale;
+#endif
+
+  return conn;
+}
+
+#endif /* CONFIG_NET_TCP_SYNCACHE */
@@ -49,14 +49,108 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/tcp.h>
 
+#include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+/* Timer expirations are processed on the low priority work queue, if
+ * there is one.
+ */
+
+#  ifdef CONFIG_SCHED_LPWORK
+#    define TCP_TIMER_WORK LPWORK
+#  else
+#    define TCP_TIMER_WORK HPWORK
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_timer_work
+ *
+ * Description:
+ *   The per-connection timer has expired.  Mark the timer due and ask the
+ *   device that the connection is bound to for a poll; the timer is then
+ *   processed by tcp_poll().
+ *
+ * Parameters:
+ *   arg - The TCP connection structure cast to void *
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs on the work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+static void tcp_timer_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  net_lock();
+
+  /* The connection may have been freed or changed state while the work
+   * was queued.
+   */
+
+  if (conn->tmrclass != TCP_TMR_NONE && conn->dev != NULL)
+    {
+      conn->tmrdue = true;
+      tcp_txpending(conn->dev, conn);
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_timer_expiry
+ *
+ * Description:
+ *   Watchdog handler.  Defers processing to the work queue.
+ *
+ * Parameters:
+ *   argc - The number of parameters (one)
+ *   arg  - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs in the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+static void tcp_timer_expiry(int argc, wdparm_t arg, ...)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  DEBUGASSERT(argc == 1 && conn != NULL);
+
+  if (work_available(&conn->tmrwork))
+    {
+      (void)work_queue(TCP_TIMER_WORK, &conn->tmrwork, tcp_timer_work,
+                       conn, 0);
+    }
+}
+#endif /* CONFIG_NET_TCP_TIMER_WDOG */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -291,6 +385,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              /* Exponential backoff. */
 
               conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
+              tcp_timer_rebase(conn);
               (conn->nrtx)++;
 
               /* Ok, so we need to retransmit. We do this differently
@@ -374,4 +469,148 @@ done:
   return;
 }
 
+/****************************************************************************
+ * Name: tcp_update_timer
+ *
+ * Description:
+ *   Start, restart or cancel the per-connection watchdog timer to match
+ *   the current state of the connection.  This must be called whenever the
+ *   state, the amount of unacknowledged data, or the 'timer' field of the
+ *   connection changes.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WDOG
+void tcp_update_timer(FAR struct tcp_conn_s *conn)
+{
+  systime_t now = clock_systimer();
+  unsigned int remaining;
+  uint8_t tmrclass;
+  int32_t delay;
+
+  /* Decide what the timer is measuring.  These are the same tests that
+   * tcp_timer() applies.
+   */
+
+  if (conn->tcpstateflags == TCP_TIME_WAIT ||
+      conn->tcpstateflags == TCP_FIN_WAIT_2)
+    {
+      tmrclass = TCP_TMR_WAIT;
+    }
+  else if (conn->tcpstateflags != TCP_CLOSED &&
+           conn->tcpstateflags != TCP_ALLOCATED && conn->unacked > 0)
+    {
+      tmrclass = TCP_TMR_RTO;
+    }
+  else
+    {
+      tmrclass = TCP_TMR_NONE;
+    }
+
+  /* The 'timer' value starts being accounted now if it was not measuring
+   * the same thing before.
+   */
+
+  if (tmrclass != conn->tmrclass)
+    {
+      conn->tmrclass = tmrclass;
+      conn->tmrbase  = now;
+    }
+
+  if (tmrclass == TCP_TMR_NONE)
+    {
+      conn->tmrdue = false;
+      (void)wd_cancel(&conn->tmrwdog);
+      return;
+    }
+
+  /* Get the number of half seconds until the timer is due */
+
+  if (tmrclass == TCP_TMR_RTO)
+    {
+      remaining = conn->timer;
+    }
+  else if (conn->timer < TCP_TIME_WAIT_TIMEOUT)
+    {
+      remaining = TCP_TIME_WAIT_TIMEOUT - conn->timer;
+    }
+  else
+    {
+      remaining = 0;
+    }
+
+  delay = (int32_t)(conn->tmrbase + remaining * TICK_PER_HSEC - now);
+  if (delay <= 0)
+    {
+      delay = 1;
+    }
+
+  (void)wd_start(&conn->tmrwdog, delay, tcp_timer_expiry, 1,
+                 (wdparm_t)conn);
+}
+
+/****************************************************************************
+ * Name: tcp_timer_elapsed
+ *
+ * Description:
+ *   Return the number of whole half seconds that have elapsed since the
+ *   'timer' field was last brought up to date, and advance the base time
+ *   by that amount.  The caller must apply the returned value to 'timer'.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   The elapsed time in half seconds
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+int tcp_timer_elapsed(FAR struct tcp_conn_s *conn)
+{
+  systime_t elapsed = clock_systimer() - conn->tmrbase;
+  int hsec = (int)(elapsed / TICK_PER_HSEC);
+
+  conn->tmrbase += TICK_PER_HSEC * (systime_t)hsec;
+  return hsec;
+}
+
+/****************************************************************************
+ * Name: tcp_timer_cancel
+ *
+ * Description:
+ *   Stop the per-connection timer when the connection is freed.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_timer_cancel(FAR struct tcp_conn_s *conn)
+{
+  (void)wd_cancel(&conn->tmrwdog);
+  (void)work_cancel(TCP_TIMER_WORK, &conn->tmrwork);
+
+  conn->tmrdue   = false;
+  conn->tmrclass = TCP_TMR_NONE;
+}
+#endif /* CONFIG_NET_TCP_TIMER_WDOG */
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -43,11 +43,14 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/net/ip.h>
 
-#ifdef CONFIG_NET_UDP_READAHEAD
+#if defined(CONFIG_NET_UDP_READAHEAD) || defined(CONFIG_NET_UDP_WRITE_BUFFERS)
 #  include <nuttx/mm/iob.h>
 #endif
 
@@ -92,6 +95,16 @@ struct udp_conn_s
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
 
+#ifdef CONFIG_NET_UDP_HASH
+  bool     reuse;         /* Binding may be shared (SO_REUSEADDR) */
+  FAR struct udp_conn_s *hnext; /* Next connection in the same hash bucket */
+#endif
+
+#ifdef CONFIG_NETDEV_TXPENDING
+  FAR struct net_driver_s *txdev; /* Device whose pending list holds us */
+  FAR struct udp_conn_s *txnext;  /* Next in the device's pending list */
+#endif
+
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Read-ahead buffering.
    *
@@ -102,11 +115,35 @@ struct udp_conn_s
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 #endif
 
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  /* Write buffering
+   *
+   *   write_q  - The queue of unsent datagrams (struct udp_wrbuffer_s).
+   *   sndcb    - The callback that drains write_q when a device polls.
+   *   drainsem - If non-NULL, posted when write_q becomes empty.
+   */
+
+  sq_queue_t write_q;
+  FAR struct devif_callback_s *sndcb;
+  FAR sem_t *drainsem;
+#endif
+
   /* Defines the list of UDP callbacks */
 
   FAR struct devif_callback_s *list;
 };
 
+/* This structure supports UDP write buffering */
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+struct udp_wrbuffer_s
+{
+  sq_entry_t wb_node;              /* Supports a singly linked list */
+  struct sockaddr_storage wb_dest; /* Destination address of the datagram */
+  struct iob_s *wb_iob;            /* Head of the I/O buffer chain */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -271,6 +308,54 @@ void udp_ipv6_select(FAR struct net_driver_s *dev);
 
 void udp_poll(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_txpending
+ *
+ * Description:
+ *   Add a UDP connection to the list of connections with Tx work pending
+ *   on a device.  A connection is in at most one such list; if it is
+ *   already pending on a different device, it is moved.
+ *
+ * Parameters:
+ *   dev - The device that will send the pending output
+ *   conn - The UDP connection with pending output
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+void udp_txpending(FAR struct net_driver_s *dev,
+                   FAR struct udp_conn_s *conn);
+#else
+#  define udp_txpending(dev,conn)
+#endif
+
+/****************************************************************************
+ * Name: udp_txpending_remove
+ *
+ * Description:
+ *   Remove a UDP connection from the pending list that it is in, if any.
+ *
+ * Parameters:
+ *   conn - The UDP connection
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+void udp_txpending_remove(FAR struct udp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: udp_send
  *
@@ -468,6 +553,115 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: udp_wrbuffer_initialize
+ *
+ * Description:
+ *   Initialize the list of free write buffers
+ *
+ * Assumptions:
+ *   Called once early initialization.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+void udp_wrbuffer_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: udp_wrbuffer_alloc
+ *
+ * Description:
+ *   Allocate a UDP write buffer by taking a pre-allocated buffer from
+ *   the free list.  This function is called from UDP logic when a datagram
+ *   is about to be queued for sending.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+struct udp_wrbuffer_s;
+FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void);
+#endif
+
+/****************************************************************************
+ * Name: udp_wrbuffer_release
+ *
+ * Description:
+ *   Release a UDP write buffer by returning the buffer to the free list.
+ *   This function is called from UDP logic after the buffered datagram has
+ *   been sent (or discarded).
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb);
+#endif
+
+/****************************************************************************
+ * Name: udp_wrbuffer_test
+ *
+ * Description:
+ *   Check if there is a free write buffer.  Does not reserve any space.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+int udp_wrbuffer_test(void);
+#endif
+
+/****************************************************************************
+ * Name: udp_txdrain
+ *
+ * Description:
+ *   Wait for the datagrams queued on a UDP connection to be sent.  This is
+ *   called when the socket is closed.
+ *
+ * Input Parameters:
+ *   conn    - The UDP connection
+ *   timeout - The longest time to wait, in seconds
+ *
+ * Returned Value:
+ *   Zero (OK) if the queue was drained; a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+int udp_txdrain(FAR struct udp_conn_s *conn, unsigned int timeout);
+#endif
+
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   Send a batch of UDP datagrams.  The longest leading run of messages that
+ *   are all routed through the same network device is queued on a single
+ *   callback and the caller sleeps once for the whole run.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, the number of messages sent (which may be less than vlen).
+ *   On failure to send the first message, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_MMSG) && !defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+struct mmsghdr;       /* Forward reference */
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -41,6 +41,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -89,17 +90,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
 #endif
   FAR void  *src_addr;
   uint8_t src_addr_size;
-
-  /* Allocate on I/O buffer to start the chain (throttling as necessary).
-   * We will not wait for an I/O buffer to become available in this context.
-   */
-
-  iob = iob_tryalloc(true);
-  if (iob == NULL)
-    {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
+#ifdef CONFIG_NETDEV_IOB_RX
+  bool claimed;
+#endif
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -164,6 +157,31 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NETDEV_IOB_RX
+  /* If the driver received the packet into an I/O buffer, then keep that
+   * I/O buffer.  The src address info then overwrites the headers that
+   * precede the data.
+   */
+
+  iob = devif_iob_claim(dev, buffer, buflen,
+                        sizeof(uint8_t) + src_addr_size, IOB_USER_UDP);
+  claimed = (iob != NULL);
+  if (!claimed)
+#endif
+    {
+      /* Allocate on I/O buffer to start the chain (throttling as
+       * necessary).  We will not wait for an I/O buffer to become
+       * available in this context.
+       */
+
+      iob = iob_tryalloc_user(true, IOB_USER_UDP);
+      if (iob == NULL)
+        {
+          nerr("ERROR: Failed to create new I/O buffer chain\n");
+          return 0;
+        }
+    }
+
   /* Copy the src address info into the I/O buffer chain.  We will not wait
    * for an I/O buffer to become available in this context.  It there is
    * any failure to allocated, the entire I/O buffer chain will be discarded.
@@ -195,7 +213,11 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       return 0;
     }
 
+#ifdef CONFIG_NETDEV_IOB_RX
+  if (buflen > 0 && !claimed)
+#else
   if (buflen > 0)
+#endif
     {
       /* Copy the new appdata into the I/O buffer chain */
 
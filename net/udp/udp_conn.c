@@ -72,6 +72,21 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_UDP_HASH
+#  if (CONFIG_NET_UDP_NHASH & (CONFIG_NET_UDP_NHASH - 1)) != 0
+#    error CONFIG_NET_UDP_NHASH must be a power of two
+#  endif
+
+/* The port number is in network order; folding both bytes together gives
+ * the same bucket regardless of the host byte order.
+ */
+
+#  define UDP_HASH(p)   ((((p) >> 8) ^ (p)) & (CONFIG_NET_UDP_NHASH - 1))
+#  define UDP_REUSE(c)  ((c)->reuse)
+#else
+#  define UDP_REUSE(c)  false
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,6 +108,12 @@ static dq_queue_t g_active_udp_connections;
 
 static uint16_t g_last_udp_port;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* Bound UDP connections hashed on the local port number */
+
+static FAR struct udp_conn_s *g_udp_hash[CONFIG_NET_UDP_NHASH];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -125,11 +146,54 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) sem_post(sem)
 
+/****************************************************************************
+ * Name: udp_hash_insert() and udp_hash_remove()
+ *
+ * Description:
+ *   Add a bound connection to, or remove it from, the hash bucket selected
+ *   by its local port number.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+static void udp_hash_insert(FAR struct udp_conn_s *conn)
+{
+  int ndx = UDP_HASH(conn->lport);
+
+  net_lock();
+  conn->hnext     = g_udp_hash[ndx];
+  g_udp_hash[ndx] = conn;
+  net_unlock();
+}
+
+static void udp_hash_remove(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s **link;
+
+  net_lock();
+  for (link = &g_udp_hash[UDP_HASH(conn->lport)];
+       *link != NULL;
+       link = &(*link)->hnext)
+    {
+      if (*link == conn)
+        {
+          *link = conn->hnext;
+          break;
+        }
+    }
+
+  conn->hnext = NULL;
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
  * Description:
- *   Find the UDP connection that uses this local port number.
+ *   Find the UDP connection that uses this local port number.  If 'reuse'
+ *   is true, connections that also permit reuse and that are bound to
+ *   exactly the same local address are not reported.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -138,16 +202,26 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             FAR union ip_binding_u *ipaddr,
-                                            uint16_t portno)
+                                            uint16_t portno, bool reuse)
 {
   FAR struct udp_conn_s *conn;
+#ifndef CONFIG_NET_UDP_HASH
   int i;
+#endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure.  With the hash table, only the
+   * connections in the bucket for this port number need to be examined.
+   */
 
+#ifdef CONFIG_NET_UDP_HASH
+  for (conn = g_udp_hash[UDP_HASH(portno)]; conn != NULL; conn = conn->hnext)
+#else
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_UDP_HASH
       conn = &g_udp_connections[i];
+#endif
 
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
@@ -164,7 +238,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
               (net_ipv4addr_cmp(conn->u.ipv4.laddr, ipaddr->ipv4.laddr) ||
                net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY)))
             {
-              return conn;
+              if (!reuse || !UDP_REUSE(conn) ||
+                  !net_ipv4addr_cmp(conn->u.ipv4.laddr, ipaddr->ipv4.laddr))
+                {
+                  return conn;
+                }
             }
         }
 #endif /* CONFIG_NET_IPv4 */
@@ -178,7 +256,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
               (net_ipv6addr_cmp(conn->u.ipv6.laddr, ipaddr->ipv6.laddr) ||
                net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr)))
             {
-              return conn;
+              if (!reuse || !UDP_REUSE(conn) ||
+                  !net_ipv6addr_cmp(conn->u.ipv6.laddr, ipaddr->ipv6.laddr))
+                {
+                  return conn;
+                }
             }
         }
 #endif /* CONFIG_NET_IPv6 */
@@ -199,6 +281,9 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
  *   implementation, it is reasonable to assume that that error cannot happen
  *   and that a port number will always be available.
  *
+ *   With CONFIG_NET_UDP_HASH, each candidate port number is checked against
+ *   only the connections in its own hash bucket.
+ *
  * Input Parameters:
  *   None
  *
@@ -231,7 +316,7 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
           g_last_udp_port = 4096;
         }
     }
-  while (udp_find_conn(domain, u, htons(g_last_udp_port)) != NULL);
+  while (udp_find_conn(domain, u, htons(g_last_udp_port), false) != NULL);
 
   /* Initialize and return the connection structure, bind it to the
    * port number
@@ -244,11 +329,17 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
 }
 
 /****************************************************************************
- * Name: udp_ipv4_active
+ * Name: udp_ipv4_match
  *
  * Description:
- *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   Check if a connection is an appropriate connection to be used with the
+ *   provided UDP header.
+ *
+ * Returned Value:
+ *   A negative value if the connection does not match.  Otherwise, a
+ *   non-negative measure of how specific the match is:  One is added if
+ *   the connection is bound to a local address and two are added if it is
+ *   connected to a remote address.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -256,70 +347,207 @@ static uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u)
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static inline FAR struct udp_conn_s *
-  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+static inline int udp_ipv4_match(FAR struct net_driver_s *dev,
+                                 FAR struct udp_conn_s *conn,
+                                 FAR struct udp_hdr_s *udp)
 {
 #ifdef CONFIG_NET_BROADCAST
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
-  FAR struct udp_conn_s *conn;
+  int score;
+
+  /* If the local UDP port is non-zero, the connection is considered
+   * to be used. If so, then the following checks are performed:
+   *
+   * - The local port number is checked against the destination port
+   *   number in the received packet.
+   * - The remote port number is checked if the connection is bound
+   *   to a remote port.
+   * - If multiple network interfaces are supported, then the local
+   *   IP address is available and we will insist that the
+   *   destination IP matches the bound address (or the destination
+   *   IP address is a broadcast address). If a socket is bound to
+   *   INADDRY_ANY (laddr), then it should receive all packets
+   *   directed to the port.
+   * - Finally, if the connection is bound to a remote IP address,
+   *   the source IP address of the packet is checked. Broadcast
+   *   addresses are also accepted.
+   *
+   * If all of the above are true then the newly received UDP packet
+   * is destined for this UDP connection.
+   *
+   * To send and receive broadcast packets, the application should:
+   *
+   * - Bind socket to INADDR_ANY
+   * - setsockopt to SO_BROADCAST
+   * - call sendto with sendaddr.sin_addr.s_addr = <broadcast-address>
+   * - call recvfrom.
+   *
+   * REVIST: SO_BROADCAST flag is currently ignored.
+   */
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
-    {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - If multiple network interfaces are supported, then the local
-       *   IP address is available and we will insist that the
-       *   destination IP matches the bound address (or the destination
-       *   IP address is a broadcast address). If a socket is bound to
-       *   INADDRY_ANY (laddr), then it should receive all packets
-       *   directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked. Broadcast
-       *   addresses are also accepted.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       *
-       * To send and receive broadcast packets, the application should:
-       *
-       * - Bind socket to INADDR_ANY
-       * - setsockopt to SO_BROADCAST
-       * - call sendto with sendaddr.sin_addr.s_addr = <broadcast-address>
-       * - call recvfrom.
-       *
-       * REVIST: SO_BROADCAST flag is currently ignored.
+  if (conn->lport != 0 && udp->destport == conn->lport &&
+      (conn->rport == 0 || udp->srcport == conn->rport) &&
+
+      /* Local port accepts any address on this port or there
+       * is an exact match in destipaddr and the bound local
+       * address.  This catches the receipt of a broadcast when
+       * the socket is bound to INADDR_ANY.
        */
 
-      if (conn->lport != 0 && udp->destport == conn->lport &&
-          (conn->rport == 0 || udp->srcport == conn->rport) &&
+      (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
+       net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)) &&
+
+      /* If not connected to a remote address, or a broadcast address
+       * destipaddr was received, or there is an exact match between the
+       * srcipaddr and the bound IP address, then accept the packet.
+       */
+
+      (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
+#ifdef CONFIG_NET_BROADCAST
+       net_ipv4addr_hdrcmp(ip->destipaddr, &bcast) ||
+#endif
+       net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
+    {
+      /* Matching connection found.. how specific is it? */
+
+      score = 0;
+      if (!net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
+        {
+          score += 1;
+        }
+
+      if (!net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY))
+        {
+          score += 2;
+        }
+
+      return score;
+    }
+
+  return -1;
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Name: udp_ipv6_match
+ *
+ * Description:
+ *   Check if a connection is an appropriate connection to be used with the
+ *   provided UDP header.
+ *
+ * Returned Value:
+ *   Same as udp_ipv4_match().
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline int udp_ipv6_match(FAR struct net_driver_s *dev,
+                                 FAR struct udp_conn_s *conn,
+                                 FAR struct udp_hdr_s *udp)
+{
+  FAR struct ipv6_hdr_s *ip = IPv6BUF;
+  int score;
+
+  /* If the local UDP port is non-zero, the connection is considered
+   * to be used. If so, then the following checks are performed:
+   *
+   * - The local port number is checked against the destination port
+   *   number in the received packet.
+   * - The remote port number is checked if the connection is bound
+   *   to a remote port.
+   * - If multiple network interfaces are supported, then the local
+   *   IP address is available and we will insist that the
+   *   destination IP matches the bound address. If a socket is bound to
+   *   INADDR6_ANY (laddr), then it should receive all packets directed
+   *   to the port. REVISIT: Should also depend on SO_BROADCAST.
+   * - Finally, if the connection is bound to a remote IP address,
+   *   the source IP address of the packet is checked.
+   *
+   * If all of the above are true then the newly received UDP packet
+   * is destined for this UDP connection.
+   *
+   * To send and receive multicast packets, the application should:
+   *
+   * - Bind socket to INADDR6_ANY (for the all-nodes multicast address)
+   *   or to a specific <multicast-address>
+   * - setsockopt to SO_BROADCAST (for all-nodes address)
+   * - call sendto with sendaddr.sin_addr.s_addr = <multicast-address>
+   * - call recvfrom.
+   *
+   * REVIST: SO_BROADCAST flag is currently ignored.
+   */
+
+  if (conn->lport != 0 && udp->destport == conn->lport &&
+      (conn->rport == 0 || udp->srcport == conn->rport) &&
 
-          /* Local port accepts any address on this port or there
-           * is an exact match in destipaddr and the bound local
-           * address.  This catches the receipt of a broadcast when
-           * the socket is bound to INADDR_ANY.
-           */
+      /* Local port accepts any address on this port or there
+       * is an exact match in destipaddr and the bound local
+       * address.  This catches the cast of the all nodes multicast
+       * when the socket is bound to INADDR6_ANY.
+       */
 
-          (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
-           net_ipv4addr_hdrcmp(ip->destipaddr, &conn->u.ipv4.laddr)) &&
+      (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr) ||
+       net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr)) &&
 
-          /* If not connected to a remote address, or a broadcast address
-           * destipaddr was received, or there is an exact match between the
-           * srcipaddr and the bound IP address, then accept the packet.
-           */
+      /* If not connected to a remote address, or a all-nodes multicast
+       * destipaddr was received, or there is an exact match between the
+       * srcipaddr and the bound remote IP address, then accept the
+       * packet.
+       */
 
-          (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
+      (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_allzeroaddr) ||
 #ifdef CONFIG_NET_BROADCAST
-           net_ipv4addr_hdrcmp(ip->destipaddr, &bcast) ||
+       net_ipv6addr_hdrcmp(ip->destipaddr, g_ipv6_allnodes) ||
 #endif
-           net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
+       net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
+    {
+      /* Matching connection found.. how specific is it? */
+
+      score = 0;
+      if (!net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr))
+        {
+          score += 1;
+        }
+
+      if (!net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_allzeroaddr))
+        {
+          score += 2;
+        }
+
+      return score;
+    }
+
+  return -1;
+}
+#endif /* CONFIG_NET_IPv6 */
+
+/****************************************************************************
+ * Name: udp_ipv4_active
+ *
+ * Description:
+ *   Find a connection structure that is the appropriate connection to be
+ *   used within the provided UDP header
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NET_UDP_HASH)
+static inline FAR struct udp_conn_s *
+  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *conn;
+
+  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  while (conn)
+    {
+      if (udp_ipv4_match(dev, conn, udp) >= 0)
         {
           /* Matching connection found.. return a reference to it */
 
@@ -333,7 +561,7 @@ static inline FAR struct udp_conn_s *
 
   return conn;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_IPv4 && !CONFIG_NET_UDP_HASH */
 
 /****************************************************************************
  * Name: udp_ipv6_active
@@ -347,82 +575,201 @@ static inline FAR struct udp_conn_s *
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NET_UDP_HASH)
 static inline FAR struct udp_conn_s *
   udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
 {
-  FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
   while (conn)
     {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - If multiple network interfaces are supported, then the local
-       *   IP address is available and we will insist that the
-       *   destination IP matches the bound address. If a socket is bound to
-       *   INADDR6_ANY (laddr), then it should receive all packets directed
-       *   to the port. REVISIT: Should also depend on SO_BROADCAST.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       *
-       * To send and receive multicast packets, the application should:
-       *
-       * - Bind socket to INADDR6_ANY (for the all-nodes multicast address)
-       *   or to a specific <multicast-address>
-       * - setsockopt to SO_BROADCAST (for all-nodes address)
-       * - call sendto with sendaddr.sin_addr.s_addr = <multicast-address>
-       * - call recvfrom.
-       *
-       * REVIST: SO_BROADCAST flag is currently ignored.
-       */
+      if (udp_ipv6_match(dev, conn, udp) >= 0)
+        {
+          /* Matching connection found.. return a reference to it */
 
-      if (conn->lport != 0 && udp->destport == conn->lport &&
-          (conn->rport == 0 || udp->srcport == conn->rport) &&
+          break;
+        }
 
-          /* Local port accepts any address on this port or there
-           * is an exact match in destipaddr and the bound local
-           * address.  This catches the cast of the all nodes multicast
-           * when the socket is bound to INADDR6_ANY.
-           */
+      /* Look at the next active connection */
 
-          (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr) ||
-           net_ipv6addr_hdrcmp(ip->destipaddr, conn->u.ipv6.laddr)) &&
+      conn = (FAR struct udp_conn_s *)conn->node.flink;
+    }
 
-          /* If not connected to a remote address, or a all-nodes multicast
-           * destipaddr was received, or there is an exact match between the
-           * srcipaddr and the bound remote IP address, then accept the
-           * packet.
-           */
+  return conn;
+}
+#endif /* CONFIG_NET_IPv6 && !CONFIG_NET_UDP_HASH */
 
-          (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_allzeroaddr) ||
-#ifdef CONFIG_NET_BROADCAST
-           net_ipv6addr_hdrcmp(ip->destipaddr, g_ipv6_allnodes) ||
+/****************************************************************************
+ * Name: udp_hash_match
+ *
+ * Description:
+ *   Check a hashed connection against the provided UDP header using the
+ *   match function for the IP domain of the packet.
+ *
+ * Returned Value:
+ *   Same as udp_ipv4_match().
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+static inline int udp_hash_match(FAR struct net_driver_s *dev,
+                                 FAR struct udp_conn_s *conn,
+                                 FAR struct udp_hdr_s *udp)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
 #endif
-           net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
+    {
+#ifdef CONFIG_NET_IPv4
+      if (conn->domain != PF_INET6)
         {
-          /* Matching connection found.. return a reference to it */
+          return -1;
+        }
+#endif
 
-          break;
+      return udp_ipv6_match(dev, conn, udp);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain != PF_INET)
+        {
+          return -1;
         }
+#endif
 
-      /* Look at the next active connection */
+      return udp_ipv4_match(dev, conn, udp);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+#endif /* CONFIG_NET_UDP_HASH */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+/****************************************************************************
+ * Name: udp_hash_flow
+ *
+ * Description:
+ *   Return a value derived from the source address and port of a received
+ *   UDP packet.  This is used to spread the traffic for a shared binding
+ *   over the sockets that share it while keeping all packets from one
+ *   sender on the same socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+static inline unsigned int udp_hash_flow(FAR struct net_driver_s *dev,
+                                         FAR struct udp_hdr_s *udp)
+{
+  unsigned int flow = udp->srcport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+      int i;
+
+      for (i = 0; i < 8; i++)
+        {
+          flow = (flow * 31) ^ ip->srcipaddr[i];
+        }
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      flow = (flow * 31) ^ ip->srcipaddr[0];
+      flow = (flow * 31) ^ ip->srcipaddr[1];
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return flow ^ (flow >> 16);
+}
+#endif /* CONFIG_NET_UDP_HASH */
+
+/****************************************************************************
+ * Name: udp_hash_active
+ *
+ * Description:
+ *   Find the connection structure that is the appropriate connection to be
+ *   used within the provided UDP header by examining only the hash bucket
+ *   for the destination port.  The most specific matching binding is
+ *   preferred:  A connected socket is chosen over one that is only bound to
+ *   a local address and that is chosen over a wildcard binding.  If several
+ *   sockets share the most specific binding, one of them is selected using
+ *   the source address and port of the packet.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+static FAR struct udp_conn_s *udp_hash_active(FAR struct net_driver_s *dev,
+                                              FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *bucket = g_udp_hash[UDP_HASH(udp->destport)];
+  FAR struct udp_conn_s *conn;
+  unsigned int nshared = 0;
+  unsigned int select;
+  int best = -1;
+  int score;
+
+  /* Find the most specific match and count the sockets that share it */
+
+  for (conn = bucket; conn != NULL; conn = conn->hnext)
+    {
+      score = udp_hash_match(dev, conn, udp);
+      if (score > best)
+        {
+          best    = score;
+          nshared = 1;
+        }
+      else if (score >= 0 && score == best)
+        {
+          nshared++;
+        }
+    }
+
+  if (best < 0)
+    {
+      return NULL;
+    }
+
+  /* Then pick one of the sockets with that binding */
+
+  select = 0;
+  if (nshared > 1)
+    {
+      select = udp_hash_flow(dev, udp) % nshared;
+    }
+
+  for (conn = bucket; conn != NULL; conn = conn->hnext)
+    {
+      if (udp_hash_match(dev, conn, udp) == best && select-- == 0)
+        {
+          break;
+        }
     }
 
   return conn;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_UDP_HASH */
 
 /****************************************************************************
  * Public Functions
@@ -484,6 +831,14 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 #endif
       conn->lport  = 0;
       conn->ttl    = IP_TTL;
+#ifdef CONFIG_NET_UDP_HASH
+      conn->reuse  = false;
+#endif
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      sq_init(&conn->write_q);
+      conn->sndcb    = NULL;
+      conn->drainsem = NULL;
+#endif
 
       /* Enqueue the connection into the active list */
 
@@ -505,13 +860,35 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
 void udp_free(FAR struct udp_conn_s *conn)
 {
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  FAR struct udp_wrbuffer_s *wrb;
+#endif
+
   /* The free list is protected by a semaphore (that behaves like a mutex). */
 
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
+
+#ifdef CONFIG_NET_UDP_HASH
+  /* Remove a bound connection from the hash table */
+
+  if (conn->lport != 0)
+    {
+      udp_hash_remove(conn);
+    }
+#endif
+
   conn->lport = 0;
 
+#ifdef CONFIG_NETDEV_TXPENDING
+  /* Remove the connection from any device's Tx pending list */
+
+  net_lock();
+  udp_txpending_remove(conn);
+  net_unlock();
+#endif
+
   /* Remove the connection from the active list */
 
   dq_rem(&conn->node, &g_active_udp_connections);
@@ -522,6 +899,25 @@ void udp_free(FAR struct udp_conn_s *conn)
   iob_free_queue(&conn->readahead);
 #endif
 
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  /* Release the send callback and any datagrams that were never sent */
+
+  net_lock();
+  if (conn->sndcb != NULL)
+    {
+      udp_callback_free(NULL, conn, conn->sndcb);
+      conn->sndcb = NULL;
+    }
+
+  while ((wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(&conn->write_q))
+         != NULL)
+    {
+      udp_wrbuffer_release(wrb);
+    }
+
+  net_unlock();
+#endif
+
   /* Free the connection */
 
   dq_addlast(&conn->node, &g_free_udp_connections);
@@ -543,6 +939,9 @@ void udp_free(FAR struct udp_conn_s *conn)
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp)
 {
+#ifdef CONFIG_NET_UDP_HASH
+  return udp_hash_active(dev, udp);
+#else
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -560,6 +959,7 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
       return udp_ipv4_active(dev, udp);
     }
 #endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_UDP_HASH */
 }
 
 /****************************************************************************
@@ -646,6 +1046,19 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* Is the user requesting to bind to any port? */
 
+#ifdef CONFIG_NET_UDP_HASH
+  /* The connection may already have been given a local port by
+   * udp_connect().  Take it out of the hash table while it is re-bound so
+   * that it does not collide with itself.
+   */
+
+  net_lock();
+  if (conn->lport != 0)
+    {
+      udp_hash_remove(conn);
+    }
+#endif
+
   if (portno == 0)
     {
       /* Yes.. Select any unused local port number */
@@ -661,7 +1074,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
       /* Is any other UDP connection already bound to this address and port? */
 
-      if (udp_find_conn(conn->domain, &conn->u, portno) == NULL)
+      if (udp_find_conn(conn->domain, &conn->u, portno,
+                        UDP_REUSE(conn)) == NULL)
         {
           /* No.. then bind the socket to the port */
 
@@ -676,6 +1090,15 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
       net_unlock();
     }
 
+#ifdef CONFIG_NET_UDP_HASH
+  if (conn->lport != 0)
+    {
+      udp_hash_insert(conn);
+    }
+
+  net_unlock();
+#endif
+
   return ret;
 }
 
@@ -717,6 +1140,9 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        */
 
       conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+#ifdef CONFIG_NET_UDP_HASH
+      udp_hash_insert(conn);
+#endif
     }
 
   /* Is there a remote port (rport)? */
@@ -114,4 +114,84 @@ void udp_poll(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
   dev->d_len   = 0;
 }
 
+/****************************************************************************
+ * Name: udp_txpending
+ *
+ * Description:
+ *   Add a UDP connection to the list of connections with Tx work pending
+ *   on a device.  A connection is in at most one such list; if it is
+ *   already pending on a different device, it is moved.
+ *
+ * Parameters:
+ *   dev - The device that will send the pending output
+ *   conn - The UDP connection with pending output
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_TXPENDING
+void udp_txpending(FAR struct net_driver_s *dev,
+                   FAR struct udp_conn_s *conn)
+{
+  if (dev == NULL || conn->txdev == dev)
+    {
+      return;
+    }
+
+  if (conn->txdev != NULL)
+    {
+      udp_txpending_remove(conn);
+    }
+
+  conn->txnext   = dev->d_udppend;
+  conn->txdev    = dev;
+  dev->d_udppend = conn;
+}
+
+/****************************************************************************
+ * Name: udp_txpending_remove
+ *
+ * Description:
+ *   Remove a UDP connection from the pending list that it is in, if any.
+ *
+ * Parameters:
+ *   conn - The UDP connection
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_txpending_remove(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_conn_s **link;
+
+  if (conn->txdev == NULL)
+    {
+      return;
+    }
+
+  for (link = &conn->txdev->d_udppend; *link != NULL;
+       link = &(*link)->txnext)
+    {
+      if (*link == conn)
+        {
+          *link = conn->txnext;
+          break;
+        }
+    }
+
+  conn->txnext = NULL;
+  conn->txdev  = NULL;
+}
+#endif /* CONFIG_NETDEV_TXPENDING */
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
@@ -124,7 +124,13 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (NETDEV_CSUM_OFFLOADED(dev, NETDEV_CSUM_UDP_RX))
+    {
+      /* The checksum has already been verified by the hardware */
+
+      chksum = 0;
+    }
+  else if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
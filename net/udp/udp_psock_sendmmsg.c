@@ -0,0 +1,517 @@
+/****************************************************************************
+ * net/udp/udp_psock_sendmmsg.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_MMSG) && \
+    !defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "arp/arp.h"
+#include "icmpv6/icmpv6.h"
+#include "socket/socket.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* If both IPv4 and IPv6 support are both enabled, then we will need to build
+ * in some additional domain selection support.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define NEED_IPDOMAIN_SUPPORT 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct sendmmsg_s
+{
+  FAR struct socket *sm_sock;         /* Points to the parent socket structure */
+  FAR struct devif_callback_s *sm_cb; /* Reference to callback instance */
+  sem_t sm_sem;                       /* Semaphore signals batch completion */
+  FAR struct mmsghdr *sm_msgvec;      /* The messages to send */
+  unsigned int sm_vlen;               /* Number of messages in the batch */
+  unsigned int sm_nsent;              /* Number of messages sent so far */
+  int sm_result;                      /* Negated errno if the batch failed */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendmmsg_msglen
+ *
+ * Description:
+ *   Return the total length of the I/O vectors of a message.
+ *
+ ****************************************************************************/
+
+static size_t sendmmsg_msglen(FAR const struct msghdr *msg)
+{
+  size_t len = 0;
+  int i;
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: sendmmsg_mss
+ *
+ * Description:
+ *   Return the largest UDP payload that can be sent through the device.
+ *
+ ****************************************************************************/
+
+static size_t sendmmsg_mss(FAR struct socket *psock,
+                           FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET)
+#endif
+    {
+      return UDP_MSS(dev, IPv4_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return UDP_MSS(dev, IPv6_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: sendmmsg_resolve
+ *
+ * Description:
+ *   Verify the destination address of a message and make sure that its
+ *   link layer address mapping is known.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int sendmmsg_resolve(FAR struct socket *psock,
+                            FAR const struct msghdr *msg)
+{
+  FAR const struct sockaddr *to = (FAR const struct sockaddr *)msg->msg_name;
+  int ret = OK;
+
+  if (to == NULL)
+    {
+      /* The message goes to the peer set up by connect() */
+
+      return _SS_ISCONNECTED(psock->s_flags) ? OK : -EDESTADDRREQ;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET)
+#endif
+    {
+      FAR const struct sockaddr_in *into =
+        (FAR const struct sockaddr_in *)to;
+
+      if (msg->msg_namelen < sizeof(struct sockaddr_in) ||
+          to->sa_family != AF_INET)
+        {
+          return -EAFNOSUPPORT;
+        }
+
+#ifdef CONFIG_NET_ARP_SEND
+      /* Make sure that the IP address mapping is in the ARP table */
+
+      ret = arp_send(into->sin_addr.s_addr);
+#else
+      UNUSED(into);
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      FAR const struct sockaddr_in6 *into =
+        (FAR const struct sockaddr_in6 *)to;
+
+      if (msg->msg_namelen < sizeof(struct sockaddr_in6) ||
+          to->sa_family != AF_INET6)
+        {
+          return -EAFNOSUPPORT;
+        }
+
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+      /* Make sure that the IP address mapping is in the Neighbor Table */
+
+      ret = icmpv6_neighbor(into->sin6_addr.s6_addr16);
+#else
+      UNUSED(into);
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  return ret < 0 ? -ENETUNREACH : OK;
+}
+
+/****************************************************************************
+ * Name: sendmmsg_eventhandler
+ *
+ * Description:
+ *   This function is called to send the next datagram of the batch when
+ *   polled by the lower, device interfacing layer.  The callback remains
+ *   armed until every datagram has been sent so that, when the device
+ *   polls the connection repeatedly (see CONFIG_NET_UDP_POLLBATCH), several
+ *   datagrams can leave in one poll cycle.
+ *
+ * Parameters:
+ *   dev        The structure of the network driver that caused the event
+ *   conn       An instance of the UDP connection structure cast to void *
+ *   pvpriv     An instance of struct sendmmsg_s cast to void*
+ *   flags      Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   Modified value of the input flags
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static uint16_t sendmmsg_eventhandler(FAR struct net_driver_s *dev,
+                                      FAR void *conn, FAR void *pvpriv,
+                                      uint16_t flags)
+{
+  FAR struct sendmmsg_s *pstate = (FAR struct sendmmsg_s *)pvpriv;
+  FAR struct mmsghdr *mmsg;
+  FAR uint8_t *dest;
+  size_t len;
+  int i;
+
+  ninfo("flags: %04x\n", flags);
+  if (pstate == NULL)
+    {
+      return flags;
+    }
+
+  /* If the network device has gone down, then we will have terminate
+   * the wait now with an error.
+   */
+
+  if ((flags & NETDEV_DOWN) != 0)
+    {
+      nwarn("WARNING: Network is down\n");
+      pstate->sm_result = -ENETUNREACH;
+    }
+
+  /* Check if the outgoing packet is available.  If not, wait for the next
+   * polling cycle.
+   */
+
+  else if (dev->d_sndlen > 0 || (flags & UDP_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  /* Send the next datagram of the batch */
+
+  else
+    {
+      mmsg = &pstate->sm_msgvec[pstate->sm_nsent];
+
+      /* Set the destination of this datagram */
+
+      if (mmsg->msg_hdr.msg_name != NULL)
+        {
+          (void)udp_connect((FAR struct udp_conn_s *)conn,
+                            (FAR const struct sockaddr *)
+                            mmsg->msg_hdr.msg_name);
+        }
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+      if (pstate->sm_sock->s_domain == PF_INET)
+        {
+          udp_ipv4_select(dev);
+        }
+      else
+        {
+          udp_ipv6_select(dev);
+        }
+#endif
+
+      /* Gather the I/O vectors into d_appdata */
+
+      dest = dev->d_appdata;
+      len  = 0;
+
+      for (i = 0; i < mmsg->msg_hdr.msg_iovlen; i++)
+        {
+          memcpy(dest + len, mmsg->msg_hdr.msg_iov[i].iov_base,
+                 mmsg->msg_hdr.msg_iov[i].iov_len);
+          len += mmsg->msg_hdr.msg_iov[i].iov_len;
+        }
+
+      dev->d_sndlen = len;
+      netdev_txiob_clear(dev);
+
+      mmsg->msg_len = len;
+      if (++pstate->sm_nsent < pstate->sm_vlen)
+        {
+          /* More to send on the next poll */
+
+          return flags;
+        }
+    }
+
+  /* Don't allow any further call backs. */
+
+  pstate->sm_cb->flags   = 0;
+  pstate->sm_cb->priv    = NULL;
+  pstate->sm_cb->event   = NULL;
+
+  /* Wake up the waiting thread */
+
+  sem_post(&pstate->sm_sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   Send a batch of UDP datagrams.  The longest leading run of messages that
+ *   are all routed through the same network device is queued on a single
+ *   callback and the caller sleeps once for the whole run.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, the number of messages sent (which may be less than vlen).
+ *   On failure to send the first message, a negated errno value is
+ *   returned.
+ *
+ ****************************************************************************/
+
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  FAR struct udp_conn_s *conn;
+  FAR struct net_driver_s *dev = NULL;
+  FAR struct net_driver_s *msgdev;
+  FAR struct msghdr *msg;
+  struct sendmmsg_s state;
+  unsigned int nmsgs;
+  int ret = OK;
+
+  DEBUGASSERT(psock != NULL && psock->s_type == SOCK_DGRAM && vlen > 0);
+
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn);
+
+  /* Find the leading messages that can be sent through one device */
+
+  for (nmsgs = 0; nmsgs < vlen; nmsgs++)
+    {
+      msg = &msgvec[nmsgs].msg_hdr;
+
+      ret = sendmmsg_resolve(psock, msg);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* udp_connect() sets the remote address that selects the device.  A
+       * message without an address goes to the connected peer.
+       */
+
+      net_lock();
+      if (msg->msg_name != NULL)
+        {
+          ret = udp_connect(conn,
+                            (FAR const struct sockaddr *)msg->msg_name);
+        }
+
+      msgdev = udp_find_raddr_device(conn);
+      net_unlock();
+
+      if (ret < 0 || msgdev == NULL)
+        {
+          ret = ret < 0 ? ret : -ENETUNREACH;
+          break;
+        }
+
+      if (dev != NULL && msgdev != dev)
+        {
+          /* Leave this message for the next batch */
+
+          break;
+        }
+
+      if (sendmmsg_msglen(msg) > sendmmsg_mss(psock, msgdev))
+        {
+          ret = -EMSGSIZE;
+          break;
+        }
+
+      dev = msgdev;
+    }
+
+  if (nmsgs == 0)
+    {
+      nerr("ERROR: Cannot send first message: %d\n", ret);
+      return ret;
+    }
+
+  /* Set the socket state to sending */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
+
+  /* Initialize the state structure.  This is done with the network
+   * locked because we don't want anything to happen until we are
+   * ready.
+   */
+
+  net_lock();
+  memset(&state, 0, sizeof(struct sendmmsg_s));
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_init(&state.sm_sem, 0, 0);
+  sem_setprotocol(&state.sm_sem, SEM_PRIO_NONE);
+
+  state.sm_sock   = psock;
+  state.sm_msgvec = msgvec;
+  state.sm_vlen   = nmsgs;
+
+  /* Set up the callback in the connection */
+
+  state.sm_cb = udp_callback_alloc(dev, conn);
+  if (state.sm_cb)
+    {
+      state.sm_cb->flags   = (UDP_POLL | NETDEV_DOWN);
+      state.sm_cb->priv    = (FAR void *)&state;
+      state.sm_cb->event   = sendmmsg_eventhandler;
+
+      /* Notify the device driver of the availability of TX data */
+
+      udp_txpending(dev, conn);
+      netdev_txnotify_dev(dev);
+
+      /* Wait for the whole batch to be sent or for an error.  NOTE:
+       * net_lockedwait will also terminate if a signal is received.
+       */
+
+      ret = net_lockedwait(&state.sm_sem);
+
+      /* Make sure that no further events are processed */
+
+      udp_callback_free(dev, conn, state.sm_cb);
+    }
+  else
+    {
+      ret = -EBUSY;
+    }
+
+  /* Report the number of messages sent or, if none, the error */
+
+  if (state.sm_nsent > 0)
+    {
+      ret = state.sm_nsent;
+    }
+  else if (state.sm_result < 0)
+    {
+      ret = state.sm_result;
+    }
+  else if (ret >= 0)
+    {
+      ret = -EINTR;
+    }
+
+  sem_destroy(&state.sm_sem);
+
+  /* Set the socket state back to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_UDP && CONFIG_NET_MMSG && !CONFIG_NET_UDP_WRITE_BUFFERS */
@@ -454,6 +454,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
       /* Notify the device driver of the availability of TX data */
 
+      udp_txpending(dev, conn);
       netdev_txnotify_dev(dev);
 
       /* Wait for either the receive to complete or for an error/timeout to
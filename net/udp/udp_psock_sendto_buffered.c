@@ -0,0 +1,511 @@
+/****************************************************************************
+ * net/udp/udp_psock_sendto_buffered.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "arp/arp.h"
+#include "icmpv6/icmpv6.h"
+#include "socket/socket.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* If both IPv4 and IPv6 support are both enabled, then we will need to build
+ * in some additional domain selection support.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define NEED_IPDOMAIN_SUPPORT 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendto_ipselect
+ *
+ * Description:
+ *   If both IPv4 and IPv6 support are enabled, then we will need to select
+ *   which one to use when generating the outgoing packet.  If only one
+ *   domain is selected, then the setup is already in place and we need do
+ *   nothing.
+ *
+ * Parameters:
+ *   dev  - The structure of the network driver that caused the event
+ *   conn - The UDP connection
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+static inline void sendto_ipselect(FAR struct net_driver_s *dev,
+                                   FAR struct udp_conn_s *conn)
+{
+  if (conn->domain == PF_INET)
+    {
+      /* Select the IPv4 domain */
+
+      udp_ipv4_select(dev);
+    }
+  else /* if (conn->domain == PF_INET6) */
+    {
+      /* Select the IPv6 domain */
+
+      DEBUGASSERT(conn->domain == PF_INET6);
+      udp_ipv6_select(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sendto_mss
+ *
+ * Description:
+ *   Return the largest UDP payload that can be sent through the device.
+ *
+ ****************************************************************************/
+
+static size_t sendto_mss(FAR struct udp_conn_s *conn,
+                         FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return UDP_MSS(dev, IPv4_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return UDP_MSS(dev, IPv6_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: sendto_eventhandler
+ *
+ * Description:
+ *   This function is called when a network device polls the connection.  It
+ *   sends the datagram at the head of the write queue if that datagram is
+ *   routed through the polling device.
+ *
+ * Parameters:
+ *   dev        The structure of the network driver that caused the event
+ *   pvconn     An instance of the UDP connection structure cast to void *
+ *   pvpriv     An instance of the UDP connection structure cast to void *
+ *   flags      Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   Modified value of the input flags
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
+                                    FAR void *pvconn, FAR void *pvpriv,
+                                    uint16_t flags)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)pvpriv;
+  FAR struct udp_wrbuffer_s *wrb;
+  unsigned int len;
+
+  ninfo("flags: %04x\n", flags);
+
+  /* Check if the outgoing packet is available.  It may have been claimed
+   * by a sendto event serving a different thread -OR- if the output
+   * buffer currently contains unprocessed incoming data.  In these cases
+   * we will just have to wait for the next polling cycle.
+   */
+
+  if (conn == NULL || (flags & UDP_POLL) == 0 ||
+      dev->d_sndlen > 0 || (flags & UDP_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  wrb = (FAR struct udp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb == NULL)
+    {
+      return flags;
+    }
+
+  /* Set the remote address of the datagram and check that it is routed
+   * through this device.  If not, it will be sent when that device polls.
+   */
+
+  (void)udp_connect(conn, (FAR const struct sockaddr *)&wrb->wb_dest);
+  if (udp_find_raddr_device(conn) != dev)
+    {
+      return flags;
+    }
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  /* If both IPv4 and IPv6 support are enabled, then we will need to
+   * select which one to use when generating the outgoing packet.
+   * If only one domain is selected, then the setup is already in
+   * place and we need do nothing.
+   */
+
+  sendto_ipselect(dev, conn);
+#endif
+
+  /* Copy the buffered datagram into d_appdata and send it */
+
+  len = wrb->wb_iob->io_pktlen;
+  if (len > 0)
+    {
+      (void)iob_copyout(dev->d_appdata, wrb->wb_iob, len, 0);
+    }
+
+  dev->d_sndlen = len;
+  netdev_txiob_clear(dev);
+
+  /* The datagram is gone; release its write buffer */
+
+  (void)sq_remfirst(&conn->write_q);
+  udp_wrbuffer_release(wrb);
+
+  wrb = (FAR struct udp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb == NULL)
+    {
+      /* Nothing more to send.  Stop polling and wake up a close() that is
+       * waiting for the queue to drain.
+       */
+
+      conn->sndcb->flags = 0;
+      if (conn->drainsem != NULL)
+        {
+          sem_post(conn->drainsem);
+          conn->drainsem = NULL;
+        }
+    }
+#ifdef CONFIG_NETDEV_TXPENDING
+  else
+    {
+      /* The next datagram may be routed through a different device */
+
+      (void)udp_connect(conn, (FAR const struct sockaddr *)&wrb->wb_dest);
+      udp_txpending(udp_find_raddr_device(conn), conn);
+    }
+#endif
+
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.  The datagram is copied into an I/O buffer
+ *   chain and queued on the connection; this function returns without
+ *   waiting for the network device to poll.  The queue is drained, in
+ *   order, as devices poll the connection.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ *   NOTE: All input parameters were verified by sendto() before this
+ *   function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn;
+  FAR struct net_driver_s *dev;
+  FAR struct udp_wrbuffer_s *wrb;
+  int ret;
+
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
+#ifdef CONFIG_NET_ARP_SEND
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+  if (psock->s_domain == PF_INET)
+#endif
+    {
+      FAR const struct sockaddr_in *into;
+
+      /* Make sure that the IP address mapping is in the ARP table */
+
+      into = (FAR const struct sockaddr_in *)to;
+      ret = arp_send(into->sin_addr.s_addr);
+    }
+#endif /* CONFIG_NET_ARP_SEND */
+
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+#ifdef CONFIG_NET_ARP_SEND
+  else
+#endif
+    {
+      FAR const struct sockaddr_in6 *into;
+
+      /* Make sure that the IP address mapping is in the Neighbor Table */
+
+      into = (FAR const struct sockaddr_in6 *)to;
+      ret = icmpv6_neighbor(into->sin6_addr.s6_addr16);
+    }
+#endif /* CONFIG_NET_ICMPv6_NEIGHBOR */
+
+  /* Did we successfully get the address mapping? */
+
+  if (ret < 0)
+    {
+      nerr("ERROR: Peer not reachable\n");
+      return -ENETUNREACH;
+    }
+#endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
+
+  if (tolen > sizeof(struct sockaddr_storage))
+    {
+      tolen = sizeof(struct sockaddr_storage);
+    }
+
+  /* Set the socket state to sending */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
+
+  net_lock();
+
+  /* Make sure that the connection has a local port and find the device
+   * that the datagram will be sent through.
+   */
+
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn);
+
+  ret = udp_connect(conn, to);
+  if (ret < 0)
+    {
+      nerr("ERROR: udp_connect failed: %d\n", ret);
+      goto errout_with_lock;
+    }
+
+  dev = udp_find_raddr_device(conn);
+  if (dev == NULL)
+    {
+      nerr("ERROR: udp_find_raddr_device failed\n");
+      ret = -ENETUNREACH;
+      goto errout_with_lock;
+    }
+
+  if (len > sendto_mss(conn, dev))
+    {
+      ret = -EMSGSIZE;
+      goto errout_with_lock;
+    }
+
+  /* A non-blocking socket does not wait for a free write buffer */
+
+  if ((_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0) &&
+      udp_wrbuffer_test() < 0)
+    {
+      ret = -EAGAIN;
+      goto errout_with_lock;
+    }
+
+  /* Allocate the callback that drains the write queue */
+
+  if (conn->sndcb == NULL)
+    {
+      conn->sndcb = udp_callback_alloc(NULL, conn);
+      if (conn->sndcb == NULL)
+        {
+          nerr("ERROR: Failed to allocate callback\n");
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      conn->sndcb->flags = 0;
+      conn->sndcb->priv  = (FAR void *)conn;
+      conn->sndcb->event = sendto_eventhandler;
+    }
+
+  /* Allocate a write buffer.  Careful, the network will be momentarily
+   * unlocked here.
+   */
+
+  wrb = udp_wrbuffer_alloc();
+  if (wrb == NULL)
+    {
+      nerr("ERROR: Failed to allocate write buffer\n");
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  /* Copy the destination address and the data into the write buffer */
+
+  memcpy(&wrb->wb_dest, to, tolen);
+
+  if (len > 0)
+    {
+      ret = iob_copyin(wrb->wb_iob, (FAR const uint8_t *)buf, len, 0, false);
+      if (ret < 0)
+        {
+          nerr("ERROR: iob_copyin failed: %d\n", ret);
+          udp_wrbuffer_release(wrb);
+          goto errout_with_lock;
+        }
+    }
+
+  /* Queue the datagram and notify the device driver of the availability
+   * of TX data.  A datagram queued behind others is sent only after them;
+   * the connection stays on the pending list of the device sending the
+   * datagram at the head of the queue.
+   */
+
+  if (sq_empty(&conn->write_q))
+    {
+      conn->sndcb->flags = UDP_POLL;
+      udp_txpending(dev, conn);
+    }
+
+  sq_addlast(&wrb->wb_node, &conn->write_q);
+  netdev_txnotify_dev(dev);
+  ret = len;
+
+errout_with_lock:
+
+  /* Set the socket state back to idle */
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+
+  /* Unlock the network and return the result of the sendto() operation */
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: udp_txdrain
+ *
+ * Description:
+ *   Wait for the datagrams queued on a UDP connection to be sent.  This is
+ *   called when the socket is closed.
+ *
+ * Input Parameters:
+ *   conn    - The UDP connection
+ *   timeout - The longest time to wait, in seconds
+ *
+ * Returned Value:
+ *   Zero (OK) if the queue was drained; a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+int udp_txdrain(FAR struct udp_conn_s *conn, unsigned int timeout)
+{
+  struct timespec abstime;
+  sem_t sem;
+  int ret = OK;
+
+  net_lock();
+  if (!sq_empty(&conn->write_q))
+    {
+      /* This semaphore is used for signaling and, hence, should not have
+       * priority inheritance enabled.
+       */
+
+      sem_init(&sem, 0, 0);
+      sem_setprotocol(&sem, SEM_PRIO_NONE);
+
+      (void)clock_gettime(CLOCK_REALTIME, &abstime);
+      abstime.tv_sec += timeout;
+
+      conn->drainsem = &sem;
+      ret = net_timedwait(&sem, &abstime);
+      conn->drainsem = NULL;
+
+      sem_destroy(&sem);
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <semaphore.h>
+#include <queue.h>
 #include <string.h>
 #include <poll.h>
 #include <errno.h>
@@ -73,6 +74,19 @@
  * Private Types
  ****************************************************************************/
 
+/* A request waiting to be read by the daemon.  This structure lives on the
+ * stack of the thread that makes the request.
+ */
+
+struct usrsockdev_req_s
+{
+  FAR struct usrsockdev_req_s *flink; /* Supports a singly linked list */
+  FAR const struct iovec *iov;        /* Request buffers */
+  int     iovcnt;                     /* Number of request buffers */
+  sem_t   acksem;                     /* Request read or acknowledged */
+  uint8_t xid;                        /* Exchange id of the request */
+};
+
 struct usrsockdev_s
 {
   sem_t   devsem;     /* Lock for device node */
@@ -80,13 +94,10 @@ struct usrsockdev_s
 
   struct
   {
-    FAR const struct iovec *iov; /* Pending request buffers */
-    int     iovcnt;              /* Number of request buffers */
-    size_t  pos;                 /* Reader position on request buffer */
-    sem_t   sem;                 /* Request semaphore (only one outstanding
-                                  * request) */
-    sem_t   acksem;              /* Request acknowledgment notification */
-    uint8_t ack_xid;             /* Exchange id for which waiting ack */
+    sq_queue_t queue;            /* Requests in order, the head is read by
+                                  * the daemon */
+    size_t  pos;                 /* Reader position on head request */
+    sem_t   donesem;             /* Last request completed after close */
     uint16_t nbusy;              /* Number of requests blocked from different
                                     threads */
   } req;
@@ -332,6 +343,83 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_req_unread
+ *
+ * Description:
+ *   Return true if the daemon has not yet read all of a request.
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_req_unread(FAR struct usrsockdev_s *dev,
+                                  FAR struct usrsockdev_req_s *req)
+{
+  return iovec_get(NULL, 0, req->iov, req->iovcnt, dev->req.pos) >= 0;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_req_retire
+ *
+ * Description:
+ *   Remove a request from the queue and wake up the requesting thread.  The
+ *   request buffers may not be accessed after this.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_req_retire(FAR struct usrsockdev_s *dev,
+                                  FAR struct usrsockdev_req_s *req)
+{
+  if (sq_peek(&dev->req.queue) == (FAR sq_entry_t *)req)
+    {
+      dev->req.pos = 0;
+    }
+
+  sq_rem((FAR sq_entry_t *)req, &dev->req.queue);
+  sem_post(&req->acksem);
+}
+
+/****************************************************************************
+ * Name: usrsockdev_req_next
+ *
+ * Description:
+ *   Return the request to be read next.  A fully read request is retired
+ *   when the daemon reads again so that the daemon may read further
+ *   requests before responding to the first.
+ *
+ ****************************************************************************/
+
+static FAR struct usrsockdev_req_s *
+usrsockdev_req_next(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.queue);
+  if (req != NULL && !usrsockdev_req_unread(dev, req))
+    {
+      usrsockdev_req_retire(dev, req);
+      req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.queue);
+    }
+
+  return req;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_req_available
+ *
+ * Description:
+ *   Return true if there is request data for the daemon to read.
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_req_available(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.queue);
+  return req != NULL &&
+         (usrsockdev_req_unread(dev, req) || req->flink != NULL);
+}
+
 /****************************************************************************
  * Name: usrsockdev_pollnotify
  ****************************************************************************/
@@ -349,7 +437,7 @@ static void usrsockdev_pollnotify(FAR struct usrsockdev_s *dev, pollevent_t even
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              sem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -364,6 +452,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
   FAR struct inode        *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
 
   if (len == 0)
@@ -387,14 +476,14 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 
   /* Is request available? */
 
-  if (dev->req.iov)
+  req = usrsockdev_req_next(dev);
+  if (req)
     {
       ssize_t rlen;
 
       /* Copy request to user-space. */
 
-      rlen = iovec_get(buffer, len, dev->req.iov, dev->req.iovcnt,
-                       dev->req.pos);
+      rlen = iovec_get(buffer, len, req->iov, req->iovcnt, dev->req.pos);
       if (rlen < 0)
         {
           /* Tried reading beyond buffer. */
@@ -425,6 +514,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 {
   FAR struct inode        *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   off_t pos;
 
@@ -442,9 +532,12 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
   usrsockdev_semtake(&dev->devsem);
   net_lock();
 
-  /* Is request available? */
+  /* Is request available?  Seeking applies to the request last read, even
+   * if all of it has been read.
+   */
 
-  if (dev->req.iov)
+  req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.queue);
+  if (req)
     {
       ssize_t rlen;
 
@@ -459,7 +552,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset, int whence)
 
       /* Copy request to user-space. */
 
-      rlen = iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt, pos);
+      rlen = iovec_get(NULL, 0, req->iov, req->iovcnt, pos);
       if (rlen < 0)
         {
           /* Tried seek beyond buffer. */
@@ -725,6 +818,7 @@ static ssize_t usrsockdev_handle_req_response(FAR struct usrsockdev_s *dev,
                                               size_t len)
 {
   FAR const struct usrsock_message_req_ack_s *hdr = buffer;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsock_conn_s *conn;
   unsigned int hdrlen;
   ssize_t ret;
@@ -781,14 +875,19 @@ static ssize_t usrsockdev_handle_req_response(FAR struct usrsockdev_s *dev,
       goto unlock_out;
     }
 
-  if (dev->req.ack_xid == hdr->xid && dev->req.iov)
+  for (req = (FAR struct usrsockdev_req_s *)sq_peek(&dev->req.queue);
+       req != NULL;
+       req = req->flink)
     {
-      /* Signal that request was received and read by daemon and acknowledgment
-       * response was received. */
-
-      dev->req.iov = NULL;
+      if (req->xid == hdr->xid)
+        {
+          /* Signal that request was received and read by daemon and
+           * acknowledgment response was received.
+           */
 
-      sem_post(&dev->req.acksem);
+          usrsockdev_req_retire(dev, req);
+          break;
+        }
     }
 
   ret = handle_response(dev, conn, buffer);
@@ -852,69 +951,92 @@ static ssize_t usrsockdev_write(FAR struct file *filep, FAR const char *buffer,
 
   usrsockdev_semtake(&dev->devsem);
 
-  if (!dev->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header. */
+  /* A write may hold several messages, each of which may be followed by
+   * the data of a data response.
+   */
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!dev->datain_conn)
         {
-          nwarn("message too short, %d < %d.\n", len,
-                sizeof(struct usrsock_message_common_s));
+          /* Start of message, buffer length should be at least size of
+           * common message header. */
 
-          ret = -EINVAL;
-          goto errout;
-        }
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              nwarn("message too short, %d < %d.\n", len,
+                    sizeof(struct usrsock_message_common_s));
 
-      /* Handle message. */
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Handle message. */
+
+          ret = usrsockdev_handle_message(dev, buffer, len);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      ret = usrsockdev_handle_message(dev, buffer, len);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
-          ret = origlen - len;
         }
-    }
 
-  /* Data input handling. */
+      /* Data input handling. */
 
-  if (dev->datain_conn)
-    {
-      conn = dev->datain_conn;
+      if (dev->datain_conn && len > 0)
+        {
+          conn = dev->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
-                      conn->resp.datain.pos, buffer, len);
-      if (ret < 0)
-        {
-          /* Tried writing beyond buffer. */
+          ret = iovec_put(conn->resp.datain.iov, conn->resp.datain.iovcnt,
+                          conn->resp.datain.pos, buffer, len);
+          if (ret < 0)
+            {
+              /* Tried writing beyond buffer. */
 
-          ret = -EINVAL;
-          conn->resp.result = -EINVAL;
-          conn->resp.datain.pos =
-              conn->resp.datain.total;
-        }
-      else
-        {
-          conn->resp.datain.pos += ret;
-          buffer += ret;
-          len -= ret;
-          ret = origlen - len;
+              ret = -EINVAL;
+              conn->resp.result = -EINVAL;
+              conn->resp.datain.pos =
+                  conn->resp.datain.total;
+            }
+          else
+            {
+              conn->resp.datain.pos += ret;
+              buffer += ret;
+              len -= ret;
+            }
         }
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
+      if (dev->datain_conn &&
+          dev->datain_conn->resp.datain.pos ==
+          dev->datain_conn->resp.datain.total)
         {
+          conn = dev->datain_conn;
           dev->datain_conn = NULL;
 
           /* Done with data response. */
 
           (void)usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
         }
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  /* Return the number of bytes handled.  An error is returned only if
+   * nothing could be handled.
+   */
+
+  if (len < origlen)
+    {
+      ret = origlen - len;
     }
 
-errout:
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
@@ -968,6 +1090,7 @@ static int usrsockdev_open(FAR struct file *filep)
 static int usrsockdev_close(FAR struct file *filep)
 {
   FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_req_s *req;
   FAR struct usrsockdev_s *dev;
   FAR struct usrsock_conn_s *conn;
   struct timespec abstime;
@@ -1009,6 +1132,19 @@ static int usrsockdev_close(FAR struct file *filep)
 
   do
     {
+      /* Wake-up pending requests. */
+
+      while ((req = (FAR struct usrsockdev_req_s *)
+                    sq_peek(&dev->req.queue)) != NULL)
+        {
+          usrsockdev_req_retire(dev, req);
+        }
+
+      if (dev->req.nbusy == 0)
+        {
+          break;
+        }
+
       /* Give other threads short time window to complete recently completed
        * requests.
        */
@@ -1023,41 +1159,18 @@ static int usrsockdev_close(FAR struct file *filep)
           abstime.tv_nsec -= NSEC_PER_SEC;
         }
 
-      ret = net_timedwait(&dev->req.sem, &abstime);
-      if (ret < 0)
-        {
-          if (ret != -ETIMEDOUT && ret != -EINTR)
-            {
-              ninfo("net_timedwait errno: %d\n", ret);
-              DEBUGASSERT(false);
-            }
-        }
-      else
-        {
-          usrsockdev_semgive(&dev->req.sem);
-        }
-
-      /* Wake-up pending requests. */
-
-      if (dev->req.nbusy == 0)
+      ret = net_timedwait(&dev->req.donesem, &abstime);
+      if (ret < 0 && ret != -ETIMEDOUT && ret != -EINTR)
         {
-          break;
+          ninfo("net_timedwait errno: %d\n", ret);
+          DEBUGASSERT(false);
         }
-
-      dev->req.iov = NULL;
-      sem_post(&dev->req.acksem);
     }
   while (true);
 
+  ret = OK;
   net_unlock();
 
-  /* Check if request line is active */
-
-  if (dev->req.iov != NULL)
-    {
-      dev->req.iov = NULL;
-    }
-
   usrsockdev_semgive(&dev->devsem);
 
   return ret;
@@ -1127,9 +1240,7 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
-      if (dev->req.iov != NULL &&
-          !(iovec_get(NULL, 0, dev->req.iov,
-                      dev->req.iovcnt, dev->req.pos) < 0))
+      if (usrsockdev_req_available(dev))
         {
           eventset |= POLLIN;
         }
@@ -1177,6 +1288,7 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
 {
   FAR struct usrsockdev_s *dev = conn->dev;
   FAR struct usrsock_request_common_s *req_head = iov[0].iov_base;
+  struct usrsockdev_req_s req;
   int ret;
 
   if (!dev)
@@ -1204,45 +1316,54 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
-  ++dev->req.nbusy; /* net_lock held. */
+  /* Queue the request for the daemon.  Requests from other threads may be
+   * queued, read and answered while this one waits.  This semaphore is
+   * used for signaling and, hence, should not have priority inheritance
+   * enabled.
+   */
 
-  /* Set outstanding request for daemon to handle. */
+  req.iov    = iov;
+  req.iovcnt = iovcnt;
+  req.xid    = req_head->xid;
+  (void)sem_init(&req.acksem, 0, 0);
+  (void)sem_setprotocol(&req.acksem, SEM_PRIO_NONE);
 
-  while ((ret = net_lockedwait(&dev->req.sem)) < 0)
-    {
-      DEBUGASSERT(ret == -EINTR);
-    }
+  ++dev->req.nbusy; /* net_lock held. */
 
-  if (usrsockdev_is_opened(dev))
+  if (sq_empty(&dev->req.queue))
     {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.ack_xid = req_head->xid;
-      dev->req.iov = iov;
       dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+    }
+
+  sq_addlast((FAR sq_entry_t *)&req, &dev->req.queue);
 
-      /* Notify daemon of new request. */
+  /* Notify daemon of new request. */
 
+  if (usrsockdev_req_available(dev))
+    {
       usrsockdev_pollnotify(dev, POLLIN);
+    }
 
-      /* Wait ack for request. */
+  /* Wait until the request has been read by the daemon (or the daemon
+   * closed the device).
+   */
 
-      while ((ret = net_lockedwait(&dev->req.acksem)) < 0)
-        {
-          DEBUGASSERT(ret == -EINTR);
-        }
-    }
-  else
+  while ((ret = net_lockedwait(&req.acksem)) < 0)
     {
-      ninfo("usockid=%d; daemon abruptly closed /usr/usrsock.\n", conn->usockid);
+      DEBUGASSERT(ret == -EINTR);
     }
 
-  /* Free request line for next command. */
-
-  usrsockdev_semgive(&dev->req.sem);
+  sem_destroy(&req.acksem);
 
   --dev->req.nbusy; /* net_lock held. */
 
+  if (dev->req.nbusy == 0 && !usrsockdev_is_opened(dev))
+    {
+      /* Let usrsockdev_close() know that the last request has completed */
+
+      sem_post(&dev->req.donesem);
+    }
+
   return OK;
 }
 
@@ -1260,9 +1381,10 @@ void usrsockdev_register(void)
 
   g_usrsockdev.ocount = 0;
   g_usrsockdev.req.nbusy = 0;
+  g_usrsockdev.req.pos = 0;
+  sq_init(&g_usrsockdev.req.queue);
   sem_init(&g_usrsockdev.devsem, 0, 1);
-  sem_init(&g_usrsockdev.req.sem, 0, 1);
-  sem_init(&g_usrsockdev.req.acksem, 0, 0);
+  sem_init(&g_usrsockdev.req.donesem, 0, 0);
 
   (void)register_driver("/dev/usrsock", &g_usrsockdevops, 0666, &g_usrsockdev);
 }
@@ -52,6 +52,7 @@
 #include <arch/irq.h>
 
 #include <sys/socket.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 #include <nuttx/kmalloc.h>
@@ -145,7 +146,7 @@ static uint16_t poll_event(FAR struct net_driver_s *dev, FAR void *pvconn,
   if (eventset)
     {
       info->fds->revents |= eventset;
-      sem_post(info->fds->sem);
+      poll_notify(info->fds);
     }
 
   return flags;
@@ -290,7 +291,7 @@ static int usrsock_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
     {
       /* Yes.. then signal the poll logic */
 
-      sem_post(fds->sem);
+      poll_notify(fds);
     }
 
 errout_unlock:
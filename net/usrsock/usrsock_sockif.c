@@ -92,6 +92,12 @@ const struct sock_intf_s g_usrsock_sockif =
   NULL,                       /* si_sendfile */
 #endif
   usrsock_recvfrom,           /* si_recvfrom */
+#ifdef CONFIG_NET_RECVIOB
+  NULL,                       /* si_recviob */
+#endif
+#ifdef CONFIG_NET_MMSG
+  NULL,                       /* si_sendmmsg */
+#endif
   usrsock_sockif_close        /* si_close */
 };
 
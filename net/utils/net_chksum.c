@@ -41,8 +41,10 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
@@ -79,7 +81,112 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_RAWCHKSUM)
+#ifdef CONFIG_NET_CHKSUM_WORDS
+uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+{
+  FAR const uint32_t *ptr32;
+  uint64_t acc = 0;
+  uint32_t acc32;
+  uint16_t t;
+  bool odd;
+
+  /* The data is summed in the native byte order of the CPU, as if it were
+   * loaded in aligned 16-bit words.  The one's complement sum is byte order
+   * independent (RFC 1071), so the result only needs to be byte-swapped at
+   * the end if that order differs from network order.  If the data begins
+   * at an odd address, then the first byte falls in the second half of its
+   * 16-bit word.
+   */
+
+  odd = ((uintptr_t)data & 1) != 0;
+  if (odd && len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc = *data;
+#else
+      acc = (uint16_t)*data << 8;
+#endif
+      data++;
+      len--;
+    }
+
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* Sum aligned 32-bit words.  The carries accumulate in the upper half of
+   * the 64-bit sum and are folded back in at the end.
+   */
+
+  ptr32 = (FAR const uint32_t *)data;
+  while (len >= 16)
+    {
+      acc   += ptr32[0];
+      acc   += ptr32[1];
+      acc   += ptr32[2];
+      acc   += ptr32[3];
+      ptr32 += 4;
+      len   -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc += *ptr32++;
+      len -= 4;
+    }
+
+  data = (FAR const uint8_t *)ptr32;
+  if (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint16_t)*data << 8;
+#else
+      acc += *data;
+#endif
+    }
+
+  /* Fold the 64-bit sum to 16 bits */
+
+  acc   = (acc & 0xffffffff) + (acc >> 32);
+  acc   = (acc & 0xffffffff) + (acc >> 32);
+  acc32 = (uint32_t)acc;
+  acc32 = (acc32 & 0xffff) + (acc32 >> 16);
+  acc32 = (acc32 & 0xffff) + (acc32 >> 16);
+  t     = (uint16_t)acc32;
+
+  /* Convert to network order (which depends on the starting address) */
+
+#ifdef CONFIG_ENDIAN_BIG
+  if (odd)
+#else
+  if (!odd)
+#endif
+    {
+      t = (t << 8) | (t >> 8);
+    }
+
+  sum += t;
+  if (sum < t)
+    {
+      sum++; /* carry */
+    }
+
+  /* Return sum in host byte order. */
+
+  return sum;
+}
+#else
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
   FAR const uint8_t *dataptr;
@@ -117,7 +224,82 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 
   return sum;
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif /* CONFIG_NET_CHKSUM_WORDS */
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_NET_ARCH_RAWCHKSUM */
+
+/****************************************************************************
+ * Name: chksum_iob
+ *
+ * Description:
+ *   Like chksum(), but calculate the raw checksum over 'len' bytes of an
+ *   I/O buffer chain beginning at 'offset'.
+ *
+ * Input Parameters:
+ *   sum    - Partial calculations carried over from a previous call.
+ *   iob    - The I/O buffer chain.
+ *   offset - Offset of the data in the chain.
+ *   len    - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_NETDEV_IOB_TX)
+uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset,
+                    uint16_t len)
+{
+  uint16_t ncopy;
+  uint16_t part;
+  bool odd = false;
+
+  /* Skip to the I/O buffer containing the data offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && len > 0)
+    {
+      ncopy = iob->io_len - offset;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      /* If this piece begins at an odd position in the data, then its
+       * bytes fall in the other half of each 16-bit word.  The one's
+       * complement sum is byte order independent (RFC 1071), so the sum of
+       * the piece just needs to be byte-swapped.
+       */
+
+      part = chksum(0, &iob->io_data[iob->io_offset + offset], ncopy);
+      if (odd)
+        {
+          part = (part << 8) | (part >> 8);
+        }
+
+      sum += part;
+      if (sum < part)
+        {
+          sum++; /* carry */
+        }
+
+      if ((ncopy & 1) != 0)
+        {
+          odd = !odd;
+        }
+
+      len   -= ncopy;
+      offset = 0;
+      iob    = iob->io_flink;
+    }
+
+  return sum;
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM && CONFIG_NETDEV_IOB_TX */
 
 /****************************************************************************
  * Name: net_chksum
@@ -109,7 +109,22 @@ uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[IPv4_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
+#ifdef CONFIG_NETDEV_IOB_TX
+  if (dev->d_txiob != NULL && dev->d_sndlen > 0)
+    {
+      /* The payload is not in d_buf but follows in the I/O buffer chain */
+
+      sum = chksum(sum, &dev->d_buf[IPv4_HDRLEN + NET_LL_HDRLEN(dev)],
+                   upperlen - dev->d_sndlen);
+      sum = chksum_iob(sum, dev->d_txiob, dev->d_txoffset, dev->d_sndlen);
+    }
+  else
+#endif
+    {
+      sum = chksum(sum, &dev->d_buf[IPv4_HDRLEN + NET_LL_HDRLEN(dev)],
+                   upperlen);
+    }
+
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -164,7 +179,22 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto)
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[IPv6_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
+#ifdef CONFIG_NETDEV_IOB_TX
+  if (dev->d_txiob != NULL && dev->d_sndlen > 0)
+    {
+      /* The payload is not in d_buf but follows in the I/O buffer chain */
+
+      sum = chksum(sum, &dev->d_buf[IPv6_HDRLEN + NET_LL_HDRLEN(dev)],
+                   upperlen - dev->d_sndlen);
+      sum = chksum_iob(sum, dev->d_txiob, dev->d_txoffset, dev->d_sndlen);
+    }
+  else
+#endif
+    {
+      sum = chksum(sum, &dev->d_buf[IPv6_HDRLEN + NET_LL_HDRLEN(dev)],
+                   upperlen);
+    }
+
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -57,13 +57,30 @@
 
 #define NO_HOLDER (pid_t)-1
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A re-entrant lock built on a semaphore */
+
+struct net_rlock_s
+{
+  sem_t        rl_sem;                 /* Mutual exclusion semaphore */
+  pid_t        rl_holder;              /* Thread that holds the lock */
+  unsigned int rl_count;               /* Number of nested locks held */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static sem_t        g_netlock;
-static pid_t        g_holder  = NO_HOLDER;
-static unsigned int g_count   = 0;
+static struct net_rlock_s g_netlock;
+
+#ifdef CONFIG_NET_DEVLOCK
+/* Protects the list of network devices and the routing tables */
+
+static struct net_rlock_s g_devlock;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -78,9 +95,9 @@ static unsigned int g_count   = 0;
  *
  ****************************************************************************/
 
-static void _net_takesem(void)
+static void _net_takesem(FAR struct net_rlock_s *rlock)
 {
-  while (sem_wait(&g_netlock) != 0)
+  while (sem_wait(&rlock->rl_sem) != 0)
     {
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -91,61 +108,122 @@ static void _net_takesem(void)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: net_lockinitialize
+ * Name: _net_rlockinit
  *
  * Description:
- *   Initialize the locking facility
+ *   Initialize a re-entrant lock
  *
  ****************************************************************************/
 
-void net_lockinitialize(void)
+static void _net_rlockinit(FAR struct net_rlock_s *rlock)
 {
-  sem_init(&g_netlock, 0, 1);
+  sem_init(&rlock->rl_sem, 0, 1);
+  rlock->rl_holder = NO_HOLDER;
+  rlock->rl_count  = 0;
 }
 
 /****************************************************************************
- * Name: net_lock
+ * Name: _net_rlock
  *
  * Description:
- *   Take the network lock
- *
- * Input Parameters:
- *   None
- *
- * Returned value:
- *   None
+ *   Take a re-entrant lock
  *
  ****************************************************************************/
 
-void net_lock(void)
+static void _net_rlock(FAR struct net_rlock_s *rlock)
 {
   pid_t me = getpid();
 
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  if (rlock->rl_holder == me)
     {
       /* Yes.. just increment the reference count */
 
-      g_count++;
+      rlock->rl_count++;
     }
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      _net_takesem();
+      _net_takesem(rlock);
 
       /* Now this thread holds the semaphore */
 
-      g_holder = me;
-      g_count  = 1;
+      rlock->rl_holder = me;
+      rlock->rl_count  = 1;
     }
 }
 
+/****************************************************************************
+ * Name: _net_runlock
+ *
+ * Description:
+ *   Release a re-entrant lock
+ *
+ ****************************************************************************/
+
+static void _net_runlock(FAR struct net_rlock_s *rlock)
+{
+  DEBUGASSERT(rlock->rl_holder == getpid() && rlock->rl_count > 0);
+
+  /* If the count would go to zero, then release the semaphore */
+
+  if (rlock->rl_count == 1)
+    {
+      /* We no longer hold the semaphore */
+
+      rlock->rl_holder = NO_HOLDER;
+      rlock->rl_count  = 0;
+      sem_post(&rlock->rl_sem);
+    }
+  else
+    {
+      /* We still hold the semaphore. Just decrement the count */
+
+      rlock->rl_count--;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lockinitialize
+ *
+ * Description:
+ *   Initialize the locking facility
+ *
+ ****************************************************************************/
+
+void net_lockinitialize(void)
+{
+  _net_rlockinit(&g_netlock);
+#ifdef CONFIG_NET_DEVLOCK
+  _net_rlockinit(&g_devlock);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_lock
+ *
+ * Description:
+ *   Take the network lock
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_lock(void)
+{
+  _net_rlock(&g_netlock);
+}
+
 /****************************************************************************
  * Name: net_unlock
  *
@@ -162,25 +240,53 @@ void net_lock(void)
 
 void net_unlock(void)
 {
-  DEBUGASSERT(g_holder == getpid() && g_count > 0);
+  _net_runlock(&g_netlock);
+}
 
-  /* If the count would go to zero, then release the semaphore */
+/****************************************************************************
+ * Name: netdev_lock
+ *
+ * Description:
+ *   Take the lock that protects the list of network devices and the
+ *   routing tables.  Lock ordering:  This lock may be taken while holding
+ *   the network lock, but the network lock must never be taken while
+ *   holding only this lock.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned value:
+ *   None
+ *
+ ****************************************************************************/
 
-  if (g_count == 1)
-    {
-      /* We no longer hold the semaphore */
+#ifdef CONFIG_NET_DEVLOCK
+void netdev_lock(void)
+{
+  _net_rlock(&g_devlock);
+}
+#endif
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
-    }
-  else
-    {
-      /* We still hold the semaphore. Just decrement the count */
+/****************************************************************************
+ * Name: netdev_unlock
+ *
+ * Description:
+ *   Release the network device and routing table lock.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned value:
+ *   None
+ *
+ ****************************************************************************/
 
-      g_count--;
-    }
+#ifdef CONFIG_NET_DEVLOCK
+void netdev_unlock(void)
+{
+  _net_runlock(&g_devlock);
 }
+#endif
 
 /****************************************************************************
  * Name: net_timedwait
@@ -208,14 +314,14 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
   flags = enter_critical_section(); /* No interrupts */
   sched_lock();      /* No context switches */
-  if (g_holder == me)
+  if (g_netlock.rl_holder == me)
     {
       /* Release the network lock, remembering my count */
 
-      count    = g_count;
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      count               = g_netlock.rl_count;
+      g_netlock.rl_holder = NO_HOLDER;
+      g_netlock.rl_count  = 0;
+      sem_post(&g_netlock.rl_sem);
 
       /* Now take the semaphore, waiting if so requested. */
 
@@ -244,9 +350,9 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
       /* Recover the network lock at the proper count */
 
-      _net_takesem();
-      g_holder = me;
-      g_count  = count;
+      _net_takesem(&g_netlock);
+      g_netlock.rl_holder = me;
+      g_netlock.rl_count  = count;
     }
   else
     {
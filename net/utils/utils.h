@@ -213,6 +213,30 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: chksum_iob
+ *
+ * Description:
+ *   Like chksum(), but calculate the raw checksum over 'len' bytes of an
+ *   I/O buffer chain beginning at 'offset'.
+ *
+ * Input Parameters:
+ *   sum    - Partial calculations carried over from a previous call.
+ *   iob    - The I/O buffer chain.
+ *   offset - Offset of the data in the chain.
+ *   len    - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_NETDEV_IOB_TX)
+struct iob_s;
+uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset,
+                    uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
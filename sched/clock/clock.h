@@ -96,6 +96,12 @@ void weak_function clock_initialize(void);
 void weak_function clock_timer(void);
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_update(void);
+#else
+#  define clock_vdso_update()
+#endif
+
 int  clock_abstime2ticks(clockid_t clockid,
                          FAR const struct timespec *abstime,
                          FAR ssystime_t *ticks);
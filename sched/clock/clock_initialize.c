@@ -265,6 +265,7 @@ void clock_initialize(void)
   /* Initialize the time value to match the RTC */
 
   clock_inittime();
+  clock_vdso_update();
 }
 
 /****************************************************************************
@@ -304,6 +305,7 @@ void clock_synchronize(void)
 
   flags = enter_critical_section();
   clock_inittime();
+  clock_vdso_update();
   leave_critical_section(flags);
 }
 #endif
@@ -474,6 +476,8 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
           g_monotonic_basetime.tv_nsec -= (carry * NSEC_PER_SEC);
         }
 #endif
+
+      clock_vdso_update();
     }
 
 skip:
@@ -497,5 +501,9 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+
+  /* Publish the new time to user space */
+
+  clock_vdso_update();
 }
 #endif
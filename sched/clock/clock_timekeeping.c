@@ -49,6 +49,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/seqlock.h>
 
 #include "clock/clock.h"
 
@@ -68,6 +69,12 @@ static uint64_t        g_clock_last_counter;
 static uint64_t        g_clock_mask;
 static long            g_clock_adjust;
 
+/* Readers of the time base never block; they retry if the time base was
+ * updated while they were reading it.
+ */
+
+static struct seqlock_s g_clock_seqlock;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -79,27 +86,38 @@ static long            g_clock_adjust;
 static int clock_get_current_time(FAR struct timespec *ts,
                                   FAR struct timespec *base)
 {
-  irqstate_t flags;
+  uint32_t sequence;
   uint64_t counter;
   uint64_t offset;
   uint64_t nsec;
+  time_t basesec;
+  long basensec;
   time_t sec;
   int ret;
 
-  flags = enter_critical_section();
+  /* Sample the counter and the time base consistently */
 
-  ret = up_timer_getcounter(&counter);
-  if (ret < 0)
+  do
     {
-      goto errout_in_critical_section;
+      sequence = seqlock_read_begin(&g_clock_seqlock);
+
+      ret = up_timer_getcounter(&counter);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      offset   = (counter - g_clock_last_counter) & g_clock_mask;
+      basesec  = base->tv_sec;
+      basensec = base->tv_nsec;
     }
+  while (seqlock_read_retry(&g_clock_seqlock, sequence));
 
-  offset = (counter - g_clock_last_counter) & g_clock_mask;
   nsec   = offset * NSEC_PER_TICK;
   sec    = nsec   / NSEC_PER_SEC;
   nsec  -= sec    * NSEC_PER_SEC;
 
-  nsec  += base->tv_nsec;
+  nsec  += basensec;
   if (nsec > NSEC_PER_SEC)
     {
       nsec -= NSEC_PER_SEC;
@@ -107,11 +125,8 @@ static int clock_get_current_time(FAR struct timespec *ts,
     }
 
   ts->tv_nsec = nsec;
-  ts->tv_sec = base->tv_sec + sec;
-
-errout_in_critical_section:
-  leave_critical_section(flags);
-  return ret;
+  ts->tv_sec = basesec + sec;
+  return OK;
 }
 
 /****************************************************************************
@@ -146,7 +161,7 @@ int clock_timekeeping_set_wall_time(FAR struct timespec *ts)
   uint64_t counter;
   int ret;
 
-  flags = enter_critical_section();
+  flags = seqlock_write_irqsave(&g_clock_seqlock);
 
   ret = up_timer_getcounter(&counter);
   if (ret < 0)
@@ -159,7 +174,7 @@ int clock_timekeeping_set_wall_time(FAR struct timespec *ts)
   g_clock_last_counter = counter;
 
 errout_in_critical_section:
-  leave_critical_section(flags);
+  seqlock_write_irqrestore(&g_clock_seqlock, flags);
   return ret;
 }
 
@@ -210,7 +225,7 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
       return -1;
     }
 
-  flags = enter_critical_section();
+  flags = seqlock_write_irqsave(&g_clock_seqlock);
 
   adjust_usec = delta->tv_sec * USEC_PER_SEC + delta->tv_usec;
 
@@ -221,7 +236,7 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
 
   g_clock_adjust = adjust_usec;
 
-  leave_critical_section(flags);
+  seqlock_write_irqrestore(&g_clock_seqlock, flags);
 
   return OK;
 }
@@ -239,7 +254,7 @@ void clock_update_wall_time(void)
   time_t sec;
   int ret;
 
-  flags = enter_critical_section();
+  flags = seqlock_write_irqsave(&g_clock_seqlock);
 
   ret = up_timer_getcounter(&counter);
   if (ret < 0)
@@ -301,7 +316,7 @@ void clock_update_wall_time(void)
   g_clock_last_counter = counter;
 
 errout_in_critical_section:
-  leave_critical_section(flags);
+  seqlock_write_irqrestore(&g_clock_seqlock, flags);
 }
 
 /****************************************************************************
@@ -312,6 +327,7 @@ void clock_inittimekeeping(void)
 {
   struct tm rtctime;
 
+  seqlock_initialize(&g_clock_seqlock);
   up_timer_getmask(&g_clock_mask);
 
   /* Get the broken-errout_in_critical_section time from the date/time RTC. */
@@ -130,6 +130,10 @@ int env_dup(FAR struct task_group_s *group)
 
       group->tg_envsize = envlen;
       group->tg_envp    = envp;
+
+      /* Inherit a copy of the hashed index as well */
+
+      env_hashdup(group, ptcb->group);
     }
 
   sched_unlock();
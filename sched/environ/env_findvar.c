@@ -104,6 +104,15 @@ FAR char *env_findvar(FAR struct task_group_s *group, const char *pname)
 
   DEBUGASSERT(group && pname);
 
+#ifdef CONFIG_ENVIRON_HASH
+  /* Use the hashed index if there is one */
+
+  if (group->tg_envhash != NULL)
+    {
+      return env_hashfind(group, pname);
+    }
+#endif
+
   /* Search for a name=value string with matching name */
 
   end = &group->tg_envp[group->tg_envsize];
@@ -0,0 +1,349 @@
+/****************************************************************************
+ * sched/environ/env_hash.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "environ/environ.h"
+
+#ifdef CONFIG_ENVIRON_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The smallest index.  The index is kept at most half full. */
+
+#define ENV_HASH_MINSLOTS  16
+#define ENV_HASH_MAXSLOTS  32768
+
+/* Each slot holds the offset of a name=value string plus one (zero marks an
+ * empty slot).  Larger environments are searched linearly.
+ */
+
+#define ENV_HASH_MAXSIZE   (UINT16_MAX - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashname
+ *
+ * Description:
+ *   Return the FNV-1a hash of the variable name that ends with '\0' or '='
+ *   and return the length of the name in 'len'.
+ *
+ ****************************************************************************/
+
+static uint32_t env_hashname(FAR const char *name, FAR size_t *len)
+{
+  FAR const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  for (ptr = name; *ptr != '\0' && *ptr != '='; ptr++)
+    {
+      hash = (hash ^ (uint8_t)*ptr) * 16777619u;
+    }
+
+  *len = ptr - name;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: env_hashinsert
+ *
+ * Description:
+ *   Add the name=value string at 'offset' to the index.  There must be a
+ *   free slot.
+ *
+ ****************************************************************************/
+
+static void env_hashinsert(FAR struct task_group_s *group, size_t offset)
+{
+  uint16_t mask = group->tg_envhsize - 1;
+  uint16_t slot;
+  size_t len;
+
+  slot = env_hashname(&group->tg_envp[offset], &len) & mask;
+  while (group->tg_envhash[slot] != 0)
+    {
+      slot = (slot + 1) & mask;
+    }
+
+  group->tg_envhash[slot] = (uint16_t)(offset + 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashbuild
+ *
+ * Description:
+ *   (Re-)build the hashed index of the environment strings.  The index is
+ *   left empty if the environment is too large or if the index cannot be
+ *   allocated.  env_findvar() then falls back to a linear search.
+ *
+ * Parameters:
+ *   group The task group containing the environment
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+void env_hashbuild(FAR struct task_group_s *group)
+{
+  FAR char *ptr;
+  FAR char *end;
+  uint16_t count = 0;
+  uint16_t hsize;
+
+  if (group->tg_envp == NULL || group->tg_envsize == 0 ||
+      group->tg_envsize > ENV_HASH_MAXSIZE)
+    {
+      env_hashfree(group);
+      return;
+    }
+
+  /* Count the variables and size the index so that it is at most half
+   * full.
+   */
+
+  end = &group->tg_envp[group->tg_envsize];
+  for (ptr = group->tg_envp; ptr < end; ptr += strlen(ptr) + 1)
+    {
+      count++;
+    }
+
+  if (2 * (count + 1) > ENV_HASH_MAXSLOTS)
+    {
+      env_hashfree(group);
+      return;
+    }
+
+  for (hsize = ENV_HASH_MINSLOTS; hsize < 2 * (count + 1); hsize <<= 1);
+
+  /* Re-use the current index if it is large enough */
+
+  if (group->tg_envhash == NULL || group->tg_envhsize < hsize)
+    {
+      env_hashfree(group);
+
+      group->tg_envhash = (FAR uint16_t *)kmm_malloc(hsize * sizeof(uint16_t));
+      if (group->tg_envhash == NULL)
+        {
+          return;
+        }
+
+      group->tg_envhsize = hsize;
+    }
+
+  memset(group->tg_envhash, 0, group->tg_envhsize * sizeof(uint16_t));
+  group->tg_envcount = count;
+
+  for (ptr = group->tg_envp; ptr < end; ptr += strlen(ptr) + 1)
+    {
+      env_hashinsert(group, ptr - group->tg_envp);
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashadd
+ *
+ * Description:
+ *   Add a name=value string that was appended to the environment to the
+ *   hashed index.
+ *
+ * Parameters:
+ *   group The task group containing the environment
+ *   pvar  The new name=value string in the environment
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+void env_hashadd(FAR struct task_group_s *group, FAR char *pvar)
+{
+  /* Rebuild the index if there is none yet or if it would become more than
+   * half full.
+   */
+
+  if (group->tg_envhash == NULL || group->tg_envsize > ENV_HASH_MAXSIZE ||
+      2 * (group->tg_envcount + 1) > group->tg_envhsize)
+    {
+      env_hashbuild(group);
+    }
+  else
+    {
+      env_hashinsert(group, pvar - group->tg_envp);
+      group->tg_envcount++;
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashfind
+ *
+ * Description:
+ *   Look up the variable of the specified name in the hashed index.
+ *
+ * Parameters:
+ *   group The task group containing the environment
+ *   pname The variable name to find
+ *
+ * Return Value:
+ *   A pointer to the name=value string in the environment or NULL
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *   - The index is not empty
+ *
+ ****************************************************************************/
+
+FAR char *env_hashfind(FAR struct task_group_s *group, FAR const char *pname)
+{
+  uint16_t mask = group->tg_envhsize - 1;
+  uint16_t slot;
+  uint16_t ndx;
+  FAR char *ptr;
+  size_t len;
+
+  slot = env_hashname(pname, &len) & mask;
+  while ((ndx = group->tg_envhash[slot]) != 0)
+    {
+      ptr = &group->tg_envp[ndx - 1];
+      if (strncmp(ptr, pname, len) == 0 && ptr[len] == '=')
+        {
+          return ptr;
+        }
+
+      slot = (slot + 1) & mask;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: env_hashdup
+ *
+ * Description:
+ *   Give the child task group a copy of the index of the parent.  The
+ *   index holds offsets and so it is valid for the copy of the environment
+ *   strings as well.
+ *
+ * Parameters:
+ *   group  The child task group
+ *   parent The parent task group
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+void env_hashdup(FAR struct task_group_s *group,
+                 FAR struct task_group_s *parent)
+{
+  size_t size;
+
+  group->tg_envhash  = NULL;
+  group->tg_envhsize = 0;
+  group->tg_envcount = 0;
+
+  if (group->tg_envp != NULL && parent->tg_envhash != NULL)
+    {
+      size = parent->tg_envhsize * sizeof(uint16_t);
+      group->tg_envhash = (FAR uint16_t *)kmm_malloc(size);
+      if (group->tg_envhash != NULL)
+        {
+          memcpy(group->tg_envhash, parent->tg_envhash, size);
+          group->tg_envhsize = parent->tg_envhsize;
+          group->tg_envcount = parent->tg_envcount;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashfree
+ *
+ * Description:
+ *   Release the hashed index of the environment.
+ *
+ * Parameters:
+ *   group The task group containing the environment
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_hashfree(FAR struct task_group_s *group)
+{
+  if (group->tg_envhash != NULL)
+    {
+      sched_kfree(group->tg_envhash);
+    }
+
+  group->tg_envhash  = NULL;
+  group->tg_envhsize = 0;
+  group->tg_envcount = 0;
+}
+
+#endif /* CONFIG_ENVIRON_HASH */
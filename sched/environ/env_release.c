@@ -92,6 +92,7 @@ void env_release(FAR struct task_group_s *group)
 
   group->tg_envsize = 0;
   group->tg_envp = NULL;
+  env_hashfree(group);
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
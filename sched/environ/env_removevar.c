@@ -108,6 +108,10 @@ int env_removevar(FAR struct task_group_s *group, FAR char *pvar)
 
       group->tg_envsize -= len;
       ret = OK;
+
+      /* The offsets of the following strings have changed */
+
+      env_hashbuild(group);
     }
 
   return ret;
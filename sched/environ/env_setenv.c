@@ -138,7 +138,19 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
           return OK;
         }
 
-      /* Yes.. just remove the name=value pair from the environment.  It will
+      /* If the new value has the same length, then just overwrite the old
+       * value in place.  Neither the buffer nor the index change.
+       */
+
+      varlen = strlen(name);
+      if (strlen(&pvar[varlen + 1]) == strlen(value))
+        {
+          strcpy(&pvar[varlen + 1], value);
+          sched_unlock();
+          return OK;
+        }
+
+      /* Otherwise, remove the name=value pair from the environment.  It will
        * be added again below.  Note that we are responsible for reallocating
        * the environment buffer; this will happen below.
        */
@@ -187,6 +199,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   /* Now, put the new name=value string into the environment buffer */
 
   sprintf(pvar, "%s=%s", name, value);
+  env_hashadd(group, pvar);
   sched_unlock();
   return OK;
 
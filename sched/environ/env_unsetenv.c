@@ -91,11 +91,17 @@ int unsetenv(FAR const char *name)
 
       (void)env_removevar(group, pvar);
 
-      /* Reallocate the new environment buffer */
+      /* Reallocate the new environment buffer.  An empty environment is
+       * freed (realloc() would free it and return NULL).
+       */
 
       newsize = group->tg_envsize;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-      if (!newenvp)
+      if (newsize == 0)
+        {
+          env_release(group);
+        }
+      else if ((newenvp = (FAR char *)kumm_realloc(group->tg_envp,
+                                                   newsize)) == NULL)
         {
           set_errno(ENOMEM);
           ret = ERROR;
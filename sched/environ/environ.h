@@ -78,6 +78,22 @@ void env_release(FAR struct task_group_s *group);
 FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 int env_removevar(FAR struct task_group_s *group, FAR char *pvar);
 
+/* Functions that maintain the hashed index of the environment */
+
+#ifdef CONFIG_ENVIRON_HASH
+void env_hashbuild(FAR struct task_group_s *group);
+void env_hashadd(FAR struct task_group_s *group, FAR char *pvar);
+FAR char *env_hashfind(FAR struct task_group_s *group, FAR const char *pname);
+void env_hashdup(FAR struct task_group_s *group,
+                 FAR struct task_group_s *parent);
+void env_hashfree(FAR struct task_group_s *group);
+#else
+#  define env_hashbuild(group)
+#  define env_hashadd(group,pvar)
+#  define env_hashdup(group,parent)
+#  define env_hashfree(group)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
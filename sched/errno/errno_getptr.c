@@ -105,10 +105,11 @@ FAR int *get_errno_ptr(void)
       if (rtcb && rtcb->task_state == TSTATE_TASK_RUNNING)
         {
           /* Yes.. the task is running normally.  Return a reference to the
-           * thread-private errno in the TCB of the running task.
+           * thread-private errno of the running task (in its TLS area if
+           * TLS is enabled, otherwise in its TCB).
            */
 
-          return &rtcb->pterrno;
+          return &TCB_ERRNO(rtcb);
         }
     }
 
@@ -158,6 +158,12 @@ static inline void group_release(FAR struct task_group_s *group)
   pthread_release(group);
 #endif
 
+#ifdef CONFIG_FS_POLLCACHE
+  /* Tear down the poll() registrations while the descriptors are open */
+
+  pollcache_release(group);
+#endif
+
 #if CONFIG_NFILE_DESCRIPTORS > 0
   /* Free all file-related resources now.  We really need to close files as
    * soon as possible while we still have a functioning task.
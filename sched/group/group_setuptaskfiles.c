@@ -90,6 +90,8 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
   /* The parent task is the one at the head of the ready-to-run list */
 
   FAR struct tcb_s *rtcb = this_task();
+  FAR struct filelist *plist;
+  FAR struct filelist *clist;
   FAR struct file *parent;
   FAR struct file *child;
   int i;
@@ -104,8 +106,8 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
 
   /* Get pointers to the parent and child task file lists */
 
-  parent = rtcb->group->tg_filelist.fl_files;
-  child  = tcb->cmn.group->tg_filelist.fl_files;
+  plist = &rtcb->group->tg_filelist;
+  clist = &tcb->cmn.group->tg_filelist;
 
   /* Check each file in the parent file list */
 
@@ -116,11 +118,16 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
        * i-node structure.
        */
 
-      if (parent[i].f_inode)
+      parent = files_fget(plist, i);
+      if (parent != NULL && parent->f_inode)
         {
           /* Yes... duplicate it for the child */
 
-          (void)file_dup2(&parent[i], &child[i]);
+          child = files_extend(clist, i);
+          if (child != NULL)
+            {
+              (void)file_dup2(parent, child);
+            }
         }
     }
 }
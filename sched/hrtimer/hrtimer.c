@@ -0,0 +1,449 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <queue.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/timers/oneshot.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CONFIG_HRTIMER requires 64-bit integer support
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The oneshot lower half only provides a relative delay and the time
+ * remaining when it is cancelled.  The high resolution time base is
+ * therefore maintained here:  'now' is advanced by the elapsed part of the
+ * programmed delay each time that the oneshot expires or is cancelled.
+ * The time base only needs to advance while some timer is active.
+ */
+
+struct hrtimer_state_s
+{
+  FAR struct oneshot_lowerhalf_s *lower; /* The oneshot timer */
+  dq_queue_t active;                     /* Active timers, by expiry */
+  uint64_t now;                          /* Current time (usec) */
+  uint64_t armed;                        /* Programmed delay (usec) or 0 */
+  uint64_t maxdelay;                     /* Max oneshot delay (usec) */
+  bool     inhandler;                    /* True: Expiring timers */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void hrtimer_expire(FAR struct oneshot_lowerhalf_s *lower,
+                           FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct hrtimer_state_s g_hrtimer;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_ts2usec
+ *
+ * Description:
+ *   Convert a timespec to microseconds, rounding up.
+ *
+ ****************************************************************************/
+
+static inline uint64_t hrtimer_ts2usec(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * USEC_PER_SEC +
+         ((uint64_t)ts->tv_nsec + NSEC_PER_USEC - 1) / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: hrtimer_usec2ts
+ *
+ * Description:
+ *   Convert microseconds to a timespec.
+ *
+ ****************************************************************************/
+
+static inline void hrtimer_usec2ts(uint64_t usec, FAR struct timespec *ts)
+{
+  ts->tv_sec  = (time_t)(usec / USEC_PER_SEC);
+  ts->tv_nsec = (long)(usec % USEC_PER_SEC) * NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: hrtimer_sync
+ *
+ * Description:
+ *   Stop the oneshot timer and advance the time base by the part of the
+ *   programmed delay that has already elapsed.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+static void hrtimer_sync(void)
+{
+  struct timespec ts;
+  uint64_t remaining;
+
+  if (g_hrtimer.armed > 0)
+    {
+      remaining = 0;
+      if (ONESHOT_CANCEL(g_hrtimer.lower, &ts) >= 0)
+        {
+          remaining = hrtimer_ts2usec(&ts);
+          if (remaining > g_hrtimer.armed)
+            {
+              remaining = g_hrtimer.armed;
+            }
+        }
+
+      g_hrtimer.now  += g_hrtimer.armed - remaining;
+      g_hrtimer.armed = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the oneshot timer for the earliest active timer.  If that timer
+ *   lies beyond the range of the oneshot timer, an intermediate expiration
+ *   is programmed instead.
+ *
+ * Assumptions:
+ *   Called from within a critical section with the oneshot timer stopped.
+ *
+ ****************************************************************************/
+
+static void hrtimer_reprogram(void)
+{
+  FAR struct hrtimer_s *head;
+  struct timespec ts;
+  uint64_t delay;
+
+  head = (FAR struct hrtimer_s *)dq_peek(&g_hrtimer.active);
+  if (head != NULL)
+    {
+      delay = head->expiry > g_hrtimer.now ?
+              head->expiry - g_hrtimer.now : 1;
+
+      if (delay > g_hrtimer.maxdelay)
+        {
+          delay = g_hrtimer.maxdelay;
+        }
+
+      hrtimer_usec2ts(delay, &ts);
+      if (ONESHOT_START(g_hrtimer.lower, hrtimer_expire, NULL, &ts) >= 0)
+        {
+          g_hrtimer.armed = delay;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_insert
+ *
+ * Description:
+ *   Add a timer to the active list in order of expiration.  Timers with the
+ *   same expiration time expire in the order that they were started.
+ *
+ ****************************************************************************/
+
+static void hrtimer_insert(FAR struct hrtimer_s *hrtimer)
+{
+  FAR struct hrtimer_s *curr;
+
+  for (curr = (FAR struct hrtimer_s *)g_hrtimer.active.tail;
+       curr != NULL && curr->expiry > hrtimer->expiry;
+       curr = (FAR struct hrtimer_s *)dq_prev(&curr->node));
+
+  if (curr == NULL)
+    {
+      dq_addfirst(&hrtimer->node, &g_hrtimer.active);
+    }
+  else
+    {
+      dq_addafter(&curr->node, &hrtimer->node, &g_hrtimer.active);
+    }
+
+  hrtimer->active = true;
+}
+
+/****************************************************************************
+ * Name: hrtimer_expire
+ *
+ * Description:
+ *   Oneshot timer callback.  Run all timers that are now due and program
+ *   the oneshot timer for the next one.
+ *
+ ****************************************************************************/
+
+static void hrtimer_expire(FAR struct oneshot_lowerhalf_s *lower,
+                          FAR void *arg)
+{
+  FAR struct hrtimer_s *hrtimer;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  g_hrtimer.now      += g_hrtimer.armed;
+  g_hrtimer.armed     = 0;
+  g_hrtimer.inhandler = true;
+
+  while ((hrtimer = (FAR struct hrtimer_s *)dq_peek(&g_hrtimer.active)) !=
+         NULL && hrtimer->expiry <= g_hrtimer.now)
+    {
+      dq_rem(&hrtimer->node, &g_hrtimer.active);
+      hrtimer->active = false;
+
+      /* The callback may restart this or any other timer */
+
+      hrtimer->callback(hrtimer, hrtimer->arg);
+    }
+
+  g_hrtimer.inhandler = false;
+  hrtimer_reprogram();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Provide the oneshot timer that will drive all high resolution timers.
+ *
+ ****************************************************************************/
+
+void hrtimer_initialize(FAR struct oneshot_lowerhalf_s *lower)
+{
+  struct timespec ts;
+  int ret;
+
+  DEBUGASSERT(lower != NULL && g_hrtimer.lower == NULL);
+
+  ret = ONESHOT_MAX_DELAY(lower, &ts);
+  if (ret < 0)
+    {
+      tmrerr("ERROR: ONESHOT_MAX_DELAY failed: %d\n", ret);
+      return;
+    }
+
+  dq_init(&g_hrtimer.active);
+  g_hrtimer.maxdelay = hrtimer_ts2usec(&ts);
+  g_hrtimer.lower    = lower;
+}
+
+/****************************************************************************
+ * Name: hrtimer_available
+ *
+ * Description:
+ *   Return true if a oneshot timer has been provided.
+ *
+ ****************************************************************************/
+
+bool hrtimer_available(void)
+{
+  return g_hrtimer.lower != NULL;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start (or restart) a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer,
+                  FAR const struct timespec *delay,
+                  hrtimer_callback_t callback, FAR void *arg)
+{
+  irqstate_t flags;
+  uint64_t usec;
+
+  DEBUGASSERT(hrtimer != NULL && delay != NULL && callback != NULL);
+
+  if (g_hrtimer.lower == NULL)
+    {
+      return -ENODEV;
+    }
+
+  /* A zero delay would expire again within the same pass of
+   * hrtimer_expire().
+   */
+
+  usec = hrtimer_ts2usec(delay);
+  if (usec == 0)
+    {
+      usec = 1;
+    }
+
+  flags = enter_critical_section();
+
+  if (hrtimer->active)
+    {
+      dq_rem(&hrtimer->node, &g_hrtimer.active);
+    }
+
+  hrtimer->callback = callback;
+  hrtimer->arg      = arg;
+
+  if (g_hrtimer.inhandler)
+    {
+      /* The oneshot timer will be reprogrammed when the handler completes */
+
+      hrtimer->expiry = g_hrtimer.now + usec;
+      hrtimer_insert(hrtimer);
+    }
+  else
+    {
+      hrtimer_sync();
+      hrtimer->expiry = g_hrtimer.now + usec;
+      hrtimer_insert(hrtimer);
+      hrtimer_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.
+ *
+ ****************************************************************************/
+
+void hrtimer_cancel(FAR struct hrtimer_s *hrtimer)
+{
+  irqstate_t flags;
+  bool first;
+
+  DEBUGASSERT(hrtimer != NULL);
+
+  flags = enter_critical_section();
+  if (hrtimer->active)
+    {
+      first = (dq_peek(&g_hrtimer.active) == &hrtimer->node);
+      dq_rem(&hrtimer->node, &g_hrtimer.active);
+      hrtimer->active = false;
+
+      /* The oneshot timer only needs to be reprogrammed if the cancelled
+       * timer was the next one to expire.
+       */
+
+      if (first && !g_hrtimer.inhandler)
+        {
+          hrtimer_sync();
+          hrtimer_reprogram();
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time remaining before a high resolution timer expires.
+ *
+ ****************************************************************************/
+
+void hrtimer_gettime(FAR struct hrtimer_s *hrtimer,
+                     FAR struct timespec *ts)
+{
+  irqstate_t flags;
+  uint64_t remaining = 0;
+
+  DEBUGASSERT(hrtimer != NULL && ts != NULL);
+
+  flags = enter_critical_section();
+  if (hrtimer->active)
+    {
+      /* Bring the time base up to date.  This requires restarting the
+       * oneshot timer.
+       */
+
+      if (!g_hrtimer.inhandler)
+        {
+          hrtimer_sync();
+          hrtimer_reprogram();
+        }
+
+      if (hrtimer->expiry > g_hrtimer.now)
+        {
+          remaining = hrtimer->expiry - g_hrtimer.now;
+        }
+    }
+
+  leave_critical_section(flags);
+  hrtimer_usec2ts(remaining, ts);
+}
+
+#endif /* CONFIG_HRTIMER */
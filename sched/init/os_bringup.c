@@ -60,6 +60,7 @@
 #endif
 # include "wqueue/wqueue.h"
 # include "init/init.h"
+# include "sched/sched.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -431,6 +432,14 @@ int os_bringup(void)
 
   os_workqueues();
 
+#ifdef CONFIG_SCHED_GARBAGE_THREAD
+  /* Start the thread that collects memory de-allocations that had to be
+   * deferred.
+   */
+
+  (void)sched_garbage_start();
+#endif
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
@@ -143,7 +143,7 @@ int os_idle_task(int argc, FAR char *argv[])
        * example, if the memory was freed from an interrupt handler).
        */
 
-#ifndef CONFIG_SCHED_WORKQUEUE
+#if !defined(CONFIG_SCHED_WORKQUEUE) && !defined(CONFIG_SCHED_GARBAGE_THREAD)
       /* We must have exclusive access to the memory manager to do this
        * BUT the idle task cannot wait on a semaphore.  So we only do
        * the cleanup now if we can get the semaphore -- this should be
@@ -163,6 +163,12 @@ int os_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SMP_BALANCE
+      /* Pull any waiting threads that could be running on this CPU */
+
+      sched_idle_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -107,6 +107,17 @@
 
 volatile dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+/* These index the g_readytorun list by priority:  A bit is set in
+ * g_readytorun_prioset[] for each priority that is present in the list and
+ * g_readytorun_priotail[] holds the last TCB of each priority that is
+ * present.
+ */
+
+uint32_t g_readytorun_prioset[SCHED_PRIOSET_NWORDS];
+FAR struct tcb_s *g_readytorun_priotail[SCHED_PRIORITY_MAX + 1];
+#endif
+
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -529,6 +540,13 @@ void os_start(void)
 #endif
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+      /* Record the IDLE task in the priority index of the list */
+
+      g_readytorun_prioset[0] = (1 << SCHED_PRIORITY_IDLE);
+      g_readytorun_priotail[SCHED_PRIORITY_IDLE] = &g_idletcb[cpu].cmn;
+#endif
+
       /* Initialize the processor-specific portion of the TCB */
 
       up_initial_state(&g_idletcb[cpu].cmn);
@@ -819,7 +837,7 @@ void os_start(void)
        * example, if the memory was freed from an interrupt handler).
        */
 
-#ifndef CONFIG_SCHED_WORKQUEUE
+#if !defined(CONFIG_SCHED_WORKQUEUE) && !defined(CONFIG_SCHED_GARBAGE_THREAD)
       /* We must have exclusive access to the memory manager to do this
        * BUT the idle task cannot wait on a semaphore.  So we only do
        * the cleanup now if we can get the semaphore -- this should be
@@ -839,6 +857,12 @@ void os_start(void)
         }
 #endif
 
+#ifdef CONFIG_SMP_BALANCE
+      /* Pull any waiting threads that could be running on this CPU */
+
+      sched_idle_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
@@ -49,7 +49,8 @@
 #include "sched/sched.h"
 #include "irq/irq.h"
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Data
@@ -376,6 +377,13 @@ try_again:
 
               sched_note_csection(rtcb, true);
 #endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+              /* Start the timing of the critical section */
+
+              sched_critmon_csection(rtcb, true,
+                                     __builtin_return_address(0));
+#endif
             }
         }
     }
@@ -384,7 +392,7 @@ try_again:
 
   return ret;
 }
-#else /* defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) */
+#else /* CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
 irqstate_t enter_critical_section(void)
 {
   irqstate_t ret;
@@ -402,9 +410,20 @@ irqstate_t enter_critical_section(void)
       FAR struct tcb_s *rtcb = this_task();
       DEBUGASSERT(rtcb != NULL);
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
       /* Yes.. Note that we have entered the critical section */
 
       sched_note_csection(rtcb, true);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start the timing if this is the outermost critical section */
+
+      if (rtcb->crit_nest++ == 0)
+        {
+          sched_critmon_csection(rtcb, true, __builtin_return_address(0));
+        }
+#endif
     }
 
   /* Return interrupt status */
@@ -501,6 +520,12 @@ void leave_critical_section(irqstate_t flags)
 
               sched_note_csection(rtcb, false);
 #endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+              /* Record the duration of the critical section */
+
+              sched_critmon_csection(rtcb, false, NULL);
+#endif
               /* Decrement our count on the lock.  If all CPUs have
                * released, then unlock the spinlock.
                */
@@ -515,14 +540,15 @@ void leave_critical_section(irqstate_t flags)
 
               if ((g_cpu_irqset & ~(1 << cpu)) == 0)
                 {
-                  /* Yes.. Check if there are pending tasks and that pre-emption
-                   * is also enabled.  This is necessary because we may have
-                   * deferred the up_release_pending() call in sched_unlock()
-                   * because we were within a critical section then.
+                  /* Yes.. Check if there are pending tasks.  This is
+                   * necessary because we may have deferred the
+                   * up_release_pending() call in sched_unlock() because we
+                   * were within a critical section then.  Tasks that must
+                   * run on a CPU with pre-emption disabled will remain
+                   * pending.
                    */
 
-                  if (g_pendingtasks.head != NULL &&
-                      !spin_islocked(&g_cpu_schedlock))
+                  if (g_pendingtasks.head != NULL)
                     {
                       /* Release any ready-to-run tasks that have collected
                        * in g_pendingtasks.  NOTE: This operation has a very
@@ -554,7 +580,7 @@ void leave_critical_section(irqstate_t flags)
 
   up_irq_restore(flags);
 }
-#else /* defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) */
+#else /* CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
 void leave_critical_section(irqstate_t flags)
 {
   /* Check if we were called from an interrupt handler and that the tasks
@@ -566,9 +592,20 @@ void leave_critical_section(irqstate_t flags)
       FAR struct tcb_s *rtcb = this_task();
       DEBUGASSERT(rtcb != NULL);
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
       /* Yes.. Note that we have left the critical section */
 
       sched_note_csection(rtcb, false);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Record the duration if this was the outermost critical section */
+
+      if (rtcb->crit_nest > 0 && --rtcb->crit_nest == 0)
+        {
+          sched_critmon_csection(rtcb, false, NULL);
+        }
+#endif
     }
 
   /* Restore the previous interrupt state. */
@@ -651,4 +688,5 @@ bool irq_cpu_locked(int cpu)
 }
 #endif
 
-#endif /* CONFIG_SMP || CONFIG_SCHED_INSTRUMENTATION_CSECTION */
+#endif /* CONFIG_SMP || CONFIG_SCHED_INSTRUMENTATION_CSECTION ||
+        * CONFIG_SCHED_CRITMONITOR */
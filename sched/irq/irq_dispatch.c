@@ -45,6 +45,7 @@
 #include <nuttx/random.h>
 
 #include "irq/irq.h"
+#include "sched/sched.h"
 
 /****************************************************************************
  * Public Functions
@@ -64,6 +65,9 @@ void irq_dispatch(int irq, FAR void *context)
 {
   xcpt_t vector;
   FAR void *arg;
+#ifdef CONFIG_SCHED_CRITMONITOR
+  struct critmon_irqctx_s save;
+#endif
 
   /* Perform some sanity checks */
 
@@ -110,5 +114,11 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+  sched_critmon_irqenter(irq, &save);
+  vector(irq, context, arg);
+  sched_critmon_irqleave(&save);
+#else
   vector(irq, context, arg);
+#endif
 }
@@ -42,6 +42,7 @@
 #include <stdint.h>
 #include <queue.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 
 #include "mqueue/mqueue.h"
 
@@ -74,6 +75,12 @@ sq_queue_t  g_msgfree;
 
 sq_queue_t  g_msgfreeirq;
 
+#ifdef CONFIG_SMP
+/* This spinlock protects the g_msgfree and g_msgfreeirq lists */
+
+volatile spinlock_t g_msgfreelock SP_SECTION = SP_UNLOCKED;
+#endif
+
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
  * pool is a constant.
@@ -191,6 +198,45 @@ void mq_initialize(void)
   mq_desblockalloc();
 }
 
+/****************************************************************************
+ * Name: mq_msgblockgrow
+ *
+ * Description:
+ *   Allocate a block of CONFIG_MQ_MSGGULP messages and add them to the
+ *   g_msgfree list.  This is called when g_msgfree is found to be empty.
+ *   The messages are never freed.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MQ_MSGGULP > 0
+void mq_msgblockgrow(void)
+{
+  sq_queue_t queue;
+  irqstate_t flags;
+
+  /* Build the new messages on a private list, then add them all to the
+   * free list at once.
+   */
+
+  sq_init(&queue);
+  if (mq_msgblockalloc(&queue, CONFIG_MQ_MSGGULP, MQ_ALLOC_FIXED) != NULL)
+    {
+      flags = spin_lock_irqsave(&g_msgfreelock);
+      sq_cat(&queue, &g_msgfree);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mq_desblockalloc
  *
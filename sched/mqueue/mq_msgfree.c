@@ -44,6 +44,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 
 #include "mqueue/mqueue.h"
 
@@ -56,8 +57,9 @@
  *
  * Description:
  *   The mq_msgfree function will return a message to the free pool of
- *   messages if it was a pre-allocated message. If the message was
- *   allocated dynamically it will be deallocated.
+ *   messages (or to the free list of its message queue) if it was a
+ *   pre-allocated message. If the message was allocated dynamically it
+ *   will be deallocated.
  *
  * Inputs:
  *   mqmsg - message to free
@@ -81,9 +83,9 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_msgfreelock);
       sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfree);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -96,11 +98,24 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
        * list from interrupt handlers.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_msgfreelock);
       sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfreeirq);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
     }
 
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+  /* If this message belongs to a per-queue pool, then return it to the
+   * free list of the owning message queue.
+   */
+
+  else if (mqmsg->type == MQ_ALLOC_QUEUE)
+    {
+      flags = spin_lock_irqsave(&g_msgfreelock);
+      sq_addlast((FAR sq_entry_t *)mqmsg, &mqmsg->msgq->msgfree);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate messages because they will not
    * received them.
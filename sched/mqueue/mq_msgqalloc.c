@@ -76,6 +76,10 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode,
                                         FAR struct mq_attr *attr)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+  FAR struct mqueue_msg_s *mqmsg;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -111,6 +115,31 @@ FAR struct mqueue_inode_s *mq_msgqalloc(mode_t mode,
 #ifndef CONFIG_DISABLE_SIGNALS
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
+
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+      /* Pre-allocate one message for each message that the queue can hold */
+
+      sq_init(&msgq->msgfree);
+      if (msgq->maxmsgs > 0)
+        {
+          mqmsg = (FAR struct mqueue_msg_s *)
+            kmm_malloc(msgq->maxmsgs * sizeof(struct mqueue_msg_s));
+
+          if (mqmsg == NULL)
+            {
+              sched_kfree(msgq);
+              return NULL;
+            }
+
+          msgq->msgpool = (FAR void *)mqmsg;
+          for (i = 0; i < msgq->maxmsgs; i++, mqmsg++)
+            {
+              mqmsg->type = MQ_ALLOC_QUEUE;
+              mqmsg->msgq = msgq;
+              sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msgfree);
+            }
+        }
+#endif
     }
 
   return msgq;
@@ -82,6 +82,15 @@ void mq_msgqfree(FAR struct mqueue_inode_s *msgq)
       curr = next;
     }
 
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+  /* Deallocate the per-queue message pool */
+
+  if (msgq->msgpool != NULL)
+    {
+      sched_kfree(msgq->msgpool);
+    }
+#endif
+
   /* Then deallocate the message queue itself */
 
   sched_kfree(msgq);
@@ -248,9 +248,6 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
 ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                      FAR char *ubuffer, int *prio)
 {
-  FAR struct tcb_s *btcb;
-  irqstate_t flags;
-  FAR struct mqueue_inode_s *msgq;
   ssize_t rcvmsglen;
 
   /* Get the length of the message (also the return value) */
@@ -272,9 +269,39 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   mq_msgfree(mqmsg);
 
-  /* Check if any tasks are waiting for the MQ not full event. */
+  /* Wake up any task waiting for the MQ not full event. */
+
+  mq_notifynotfull(mqdes->msgq);
+
+  /* Return the length of the message transferred to the user buffer */
+
+  return rcvmsglen;
+}
+
+/****************************************************************************
+ * Name: mq_notifynotfull
+ *
+ * Description:
+ *   Wake up the highest priority task (if any) that is waiting for the
+ *   message queue to become not full.  This is called after a message has
+ *   been removed from the message queue.
+ *
+ * Parameters:
+ *   msgq - The message queue
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - Pre-emption should be disabled throughout this call.
+ *
+ ****************************************************************************/
+
+void mq_notifynotfull(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
 
-  msgq = mqdes->msgq;
   if (msgq->nwaitnotfull > 0)
     {
       /* Find the highest priority task that is waiting for
@@ -301,8 +328,4 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
       leave_critical_section(flags);
     }
-
-  /* Return the length of the message transferred to the user buffer */
-
-  return rcvmsglen;
 }
@@ -138,7 +138,7 @@ int mq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
       /* Allocate the message */
 
       leave_critical_section(flags);
-      mqmsg = mq_msgalloc();
+      mqmsg = mq_msgalloc(msgq);
 
       /* Check if the message was sucessfully allocated */
 
@@ -53,6 +53,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/cancelpt.h>
 
 #include "sched/sched.h"
@@ -122,8 +123,9 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *
  * Description:
  *   The mq_msgalloc function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  The message will be allocated from the free list of
+ *   the message queue (if CONFIG_MQ_PERQUEUE_MSGS is selected) or from the
+ *   g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -136,7 +138,7 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *   handler will be notified.
  *
  * Inputs:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Return Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -144,11 +146,26 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *mq_msgalloc(void)
+FAR struct mqueue_msg_s *mq_msgalloc(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+  /* Try the message queue's own pool first.  This is safe from interrupt
+   * handlers as well.
+   */
+
+  flags = spin_lock_irqsave(&g_msgfreelock);
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msgfree);
+  spin_unlock_irqrestore(&g_msgfreelock, flags);
+
+  if (mqmsg != NULL)
+    {
+      return mqmsg;
+    }
+#endif
+
   /* If we were called from an interrupt handler, then try to get the message
    * from generally available list of messages. If this fails, then try the
    * list of messages reserved for interrupt handlers
@@ -156,8 +173,11 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
 
   if (up_interrupt_context())
     {
-      /* Try the general free list */
+      /* Try the general free list.  Interrupts are already disabled on this
+       * CPU but, in the SMP case, the lists may be in use on another CPU.
+       */
 
+      flags = spin_lock_irqsave(&g_msgfreelock);
       mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
       if (mqmsg == NULL)
         {
@@ -165,6 +185,8 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
 
           mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfreeirq);
         }
+
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
     }
 
   /* We were not called from an interrupt handler. */
@@ -175,9 +197,24 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
        * Disable interrupts -- we might be called from an interrupt handler.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave(&g_msgfreelock);
       mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore(&g_msgfreelock, flags);
+
+#if CONFIG_MQ_MSGGULP > 0
+      /* If the free list is empty, then grow it by a block of messages and
+       * try again.
+       */
+
+      if (mqmsg == NULL)
+        {
+          mq_msgblockgrow();
+
+          flags = spin_lock_irqsave(&g_msgfreelock);
+          mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
+          spin_unlock_irqrestore(&g_msgfreelock, flags);
+        }
+#endif
 
       /* If we cannot a message from the free list, then we will have to
        * allocate one.
@@ -355,9 +392,14 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message (unless it was built in place
+   * by mq_msgcommit()).
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
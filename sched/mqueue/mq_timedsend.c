@@ -197,7 +197,7 @@ int mq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio,
 
   /* Pre-allocate a message structure */
 
-  mqmsg = mq_msgalloc();
+  mqmsg = mq_msgalloc(mqdes->msgq);
   if (mqmsg == NULL)
     {
       /* Failed to allocate the message. mq_msgalloc() does not set the
@@ -46,6 +46,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/mqueue.h>
 
+#include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
 /****************************************************************************
@@ -113,7 +114,7 @@ void mq_waitirq(FAR struct tcb_s *wtcb, int errcode)
 
       /* Mark the errno value for the thread. */
 
-      wtcb->pterrno = errcode;
+      TCB_ERRNO(wtcb) = errcode;
 
       /* Restart the task. */
 
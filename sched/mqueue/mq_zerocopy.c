@@ -0,0 +1,279 @@
+/****************************************************************************
+ * sched/mqueue/mq_zerocopy.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_msgreserve
+ *
+ * Description:
+ *   Reserve a message buffer for a subsequent mq_msgcommit().  The caller
+ *   may write up to mq_msgsize bytes of message data into the returned
+ *   buffer.  The buffer must then be passed to mq_msgcommit() (which
+ *   consumes it whether or not the send succeeds) or to mq_msgrelease().
+ *
+ * Parameters:
+ *   mqdes - Message queue descriptor, opened for writing
+ *
+ * Return Value:
+ *   The message buffer on success; NULL on failure with the errno set to
+ *   EINVAL, EPERM, or ENOMEM.
+ *
+ ****************************************************************************/
+
+FAR char *mq_msgreserve(mqd_t mqdes)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mqdes == NULL)
+    {
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  if ((mqdes->oflags & O_WROK) == 0)
+    {
+      set_errno(EPERM);
+      return NULL;
+    }
+
+  mqmsg = mq_msgalloc(mqdes->msgq);
+  if (mqmsg == NULL)
+    {
+      set_errno(ENOMEM);
+      return NULL;
+    }
+
+  return mqmsg->mail;
+}
+
+/****************************************************************************
+ * Name: mq_msgcommit
+ *
+ * Description:
+ *   Send a message built in place in a buffer obtained from
+ *   mq_msgreserve().  This behaves like mq_send() except that no message
+ *   data is copied.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - Buffer returned by mq_msgreserve()
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Return Value:
+ *   As for mq_send().  The buffer is released on failure.
+ *
+ ****************************************************************************/
+
+int mq_msgcommit(mqd_t mqdes, FAR char *buffer, size_t msglen, int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret = ERROR;
+
+  DEBUGASSERT(buffer != NULL);
+  mqmsg = MQ_MAIL2MSG(buffer);
+
+  /* mq_msgcommit() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Verify the input parameters -- setting errno appropriately
+   * on any failures to verify.
+   */
+
+  if (mq_verifysend(mqdes, buffer, msglen, prio) != OK)
+    {
+      mq_msgfree(mqmsg);
+      leave_cancellation_point();
+      return ERROR;
+    }
+
+  /* The message is already allocated.  Send it now if the message queue
+   * is not full or after waiting for the queue to become non-full.  See
+   * mq_send() for the handling of the interrupt-level race.
+   */
+
+  sched_lock();
+  msgq = mqdes->msgq;
+
+  flags = enter_critical_section();
+  if (up_interrupt_context()      || /* In an interrupt handler */
+      msgq->nmsgs < msgq->maxmsgs || /* OR Message queue not full */
+      mq_waitsend(mqdes) == OK)      /* OR Successfully waited for mq not full */
+    {
+      leave_critical_section(flags);
+      ret = mq_dosend(mqdes, mqmsg, buffer, msglen, prio);
+    }
+  else
+    {
+      /* mq_waitsend() has already set the errno value */
+
+      leave_critical_section(flags);
+      mq_msgfree(mqmsg);
+    }
+
+  sched_unlock();
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_msgborrow
+ *
+ * Description:
+ *   Receive the next message like mq_receive() but, rather than copying
+ *   it, return a reference to the message data in place.  The buffer
+ *   must be returned with mq_msgrelease() before the message queue is
+ *   closed.
+ *
+ * Parameters:
+ *   mqdes  - Message queue descriptor, opened for reading
+ *   buffer - Location to return the message data
+ *   prio   - Location to return the message priority (may be NULL)
+ *
+ * Return Value:
+ *   The length of the message on success; -1 (ERROR) on failure with the
+ *   errno set as for mq_receive().
+ *
+ ****************************************************************************/
+
+ssize_t mq_msgborrow(mqd_t mqdes, FAR char **buffer, FAR int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret = ERROR;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* mq_msgborrow() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Verify the input parameters.  There is no user buffer size to check. */
+
+  if (buffer == NULL || mqdes == NULL)
+    {
+      set_errno(EINVAL);
+      leave_cancellation_point();
+      return ERROR;
+    }
+
+  if ((mqdes->oflags & O_RDOK) == 0)
+    {
+      set_errno(EPERM);
+      leave_cancellation_point();
+      return ERROR;
+    }
+
+  /* Get the next message from the message queue as in mq_receive() */
+
+  sched_lock();
+  flags = enter_critical_section();
+  mqmsg = mq_waitreceive(mqdes);
+  leave_critical_section(flags);
+
+  if (mqmsg != NULL)
+    {
+      /* Give the message data to the caller in place */
+
+      *buffer = mqmsg->mail;
+      if (prio)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      ret = mqmsg->msglen;
+
+      /* The message is no longer in the queue, so a waiting sender may
+       * proceed even though the message structure is still in use.
+       */
+
+      mq_notifynotfull(mqdes->msgq);
+    }
+
+  sched_unlock();
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_msgrelease
+ *
+ * Description:
+ *   Release a buffer obtained from mq_msgborrow() or an unsent buffer
+ *   obtained from mq_msgreserve().
+ *
+ * Parameters:
+ *   buffer - The message buffer to release
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_msgrelease(FAR char *buffer)
+{
+  DEBUGASSERT(buffer != NULL);
+  mq_msgfree(MQ_MAIL2MSG(buffer));
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
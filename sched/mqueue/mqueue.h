@@ -46,12 +46,14 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <limits.h>
 #include <mqueue.h>
 #include <sched.h>
 #include <signal.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/spinlock.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -75,6 +77,20 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* This defines the number of messages added to g_msgfree each time it is
+ * exhausted.  Zero means that messages are allocated one at a time.
+ */
+
+#ifndef CONFIG_MQ_MSGGULP
+#  define CONFIG_MQ_MSGGULP 0
+#endif
+
+/* Recover the message structure from a pointer to its data */
+
+#define MQ_MAIL2MSG(m) \
+  ((FAR struct mqueue_msg_s *)((FAR char *)(m) - \
+                               offsetof(struct mqueue_msg_s, mail)))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -83,7 +99,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_QUEUE       /* Preallocated in the per-queue pool */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -91,6 +108,9 @@ enum mqalloc_e
 struct mqueue_msg_s
 {
   FAR struct mqueue_msg_s *next;  /* Forward link to next message */
+#ifdef CONFIG_MQ_PERQUEUE_MSGS
+  FAR struct mqueue_inode_s *msgq; /* Owner of a MQ_ALLOC_QUEUE message */
+#endif
   uint8_t type;                   /* (Used to manage allocations) */
   uint8_t priority;               /* priority of message */
 #if MQ_MAX_BYTES < 256
@@ -125,6 +145,16 @@ EXTERN sq_queue_t  g_msgfree;
 
 EXTERN sq_queue_t  g_msgfreeirq;
 
+#ifdef CONFIG_SMP
+/* This spinlock protects the g_msgfree and g_msgfreeirq lists.  These lists
+ * are accessed from interrupt handlers on any CPU but are not otherwise
+ * related to the scheduler state, so the global critical section is not
+ * needed.
+ */
+
+EXTERN volatile spinlock_t g_msgfreelock SP_SECTION;
+#endif
+
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
  * pool is a constant.
@@ -143,6 +173,9 @@ struct task_group_s; /* Forward reference */
 
 void weak_function mq_initialize(void);
 void mq_desblockalloc(void);
+#if CONFIG_MQ_MSGGULP > 0
+void mq_msgblockgrow(void);
+#endif
 
 FAR struct mqueue_inode_s *mq_findnamed(FAR const char *mq_name);
 void mq_msgfree(FAR struct mqueue_msg_s *mqmsg);
@@ -157,11 +190,12 @@ int mq_verifyreceive(mqd_t mqdes, FAR char *msg, size_t msglen);
 FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes);
 ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                      FAR char *ubuffer, FAR int *prio);
+void mq_notifynotfull(FAR struct mqueue_inode_s *msgq);
 
 /* mq_sndinternal.c ********************************************************/
 
 int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
-FAR struct mqueue_msg_s *mq_msgalloc(void);
+FAR struct mqueue_msg_s *mq_msgalloc(FAR struct mqueue_inode_s *msgq);
 int mq_waitsend(mqd_t mqdes);
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
               FAR const char *msg, size_t msglen, int prio);
@@ -50,6 +50,44 @@
 
 #include <nuttx/compiler.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+/* Only non-robust NORMAL mutexes may be taken and released on the fast
+ * path:  There is no ownership checking, no recursion, and no consistency
+ * logic for such a mutex, so the state of the underlying semaphore count is
+ * all that matters.
+ */
+
+#  if defined(CONFIG_PTHREAD_MUTEX_UNSAFE)
+#    ifdef CONFIG_PTHREAD_MUTEX_TYPES
+#      define pthread_mutex_isfast(m) ((m)->type == PTHREAD_MUTEX_NORMAL)
+#    else
+#      define pthread_mutex_isfast(m) (true)
+#    endif
+#  elif defined(CONFIG_PTHREAD_MUTEX_TYPES)
+#    define pthread_mutex_isfast(m) \
+       (((m)->flags & _PTHREAD_MFLAGS_ROBUST) == 0 && \
+        (m)->type == PTHREAD_MUTEX_NORMAL)
+#  else
+#    define pthread_mutex_isfast(m) \
+       (((m)->flags & _PTHREAD_MFLAGS_ROBUST) == 0)
+#  endif
+
+/* The semaphore count is 1 if the mutex is available, 0 if it is held with
+ * no waiters, and negative if there are waiters.  The fast path succeeds
+ * only in the first two cases; otherwise, the normal semaphore logic must
+ * be used.
+ */
+
+#  define pthread_mutex_fastlock(m) \
+     __sync_bool_compare_and_swap(&(m)->sem.semcount, 1, 0)
+#  define pthread_mutex_fastunlock(m) \
+     __sync_bool_compare_and_swap(&(m)->sem.semcount, 0, 1)
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -101,6 +139,13 @@ int pthread_schedsetup(FAR struct pthread_tcb_s *tcb, int priority, start_t star
 void pthread_cleanup_popall(FAR struct pthread_tcb_s *tcb);
 #endif
 
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+FAR struct pthread_tcb_s *pthread_tcb_alloc(size_t stacksize,
+                                            FAR void **stack,
+                                            FAR size_t *size);
+bool pthread_tcb_recycle(FAR struct pthread_tcb_s *ptcb);
+#endif
+
 int pthread_completejoin(pid_t pid, FAR void *exit_value);
 void pthread_destroyjoin(FAR struct task_group_s *group,
                          FAR struct join_s *pjoin);
@@ -117,11 +162,13 @@ int pthread_sem_give(sem_t *sem);
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
 int pthread_mutex_take(FAR struct pthread_mutex_s *mutex, bool intr);
 int pthread_mutex_trytake(FAR struct pthread_mutex_s *mutex);
+int pthread_mutex_requeued(FAR struct pthread_mutex_s *mutex);
 int pthread_mutex_give(FAR struct pthread_mutex_s *mutex);
 void pthread_mutex_inconsistent(FAR struct pthread_tcb_s *tcb);
 #else
 #  define pthread_mutex_take(m,i)  pthread_sem_take(&(m)->sem,(i))
 #  define pthread_mutex_trytake(m) pthread_sem_trytake(&(m)->sem)
+#  define pthread_mutex_requeued(m) (0)
 #  define pthread_mutex_give(m)    pthread_sem_give(&(m)->sem)
 #endif
 
@@ -45,6 +45,7 @@
 #include <debug.h>
 
 #include "pthread/pthread.h"
+#include "semaphore/semaphore.h"
 
 /****************************************************************************
  * Public Functions
@@ -94,7 +95,27 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
         }
       else
         {
-          /* Loop until all of the waiting threads have been restarted. */
+          /* Restart the highest priority waiting thread.  Then move the
+           * other waiting threads directly to the mutex so that they do not
+           * all wake up only to block on the mutex again.  Each will be
+           * restarted, holding the mutex, when the mutex is released.
+           */
+
+          if (sval < 0)
+            {
+              ret = pthread_sem_give((FAR sem_t *)&cond->sem);
+              sval++;
+
+              if (sval < 0 && cond->mutex != NULL)
+                {
+                  sval += sem_requeue((FAR sem_t *)&cond->sem,
+                                      &cond->mutex->sem);
+                }
+            }
+
+          /* Loop until all of the remaining waiting threads have been
+           * restarted.
+           */
 
           while (sval < 0)
             {
@@ -171,6 +171,7 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
   uint16_t oldstate;
   ssystime_t ticks;
   int mypid = (int)getpid();
+  bool requeued = false;
   int ret = OK;
   int status;
 
@@ -260,7 +261,8 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                 {
                   /* Give up the mutex */
 
-                  mutex->pid = -1;
+                  cond->mutex = mutex;
+                  mutex->pid  = -1;
                   ret = pthread_mutex_give(mutex);
                   if (ret != 0)
                     {
@@ -283,8 +285,18 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                        * are started atomically.
                        */
 
+                      rtcb->flags &= ~TCB_FLAG_SEM_REQUEUED;
                       status = sem_wait((FAR sem_t *)&cond->sem);
 
+                      /* If pthread_cond_broadcast() moved the wait to the
+                       * mutex and the wait completed, then the mutex is
+                       * already held.
+                       */
+
+                      requeued = (rtcb->flags & TCB_FLAG_SEM_REQUEUED) != 0 &&
+                                 status == OK;
+                      rtcb->flags &= ~TCB_FLAG_SEM_REQUEUED;
+
                       /* Did we get the condition semaphore. */
 
                       if (status != OK)
@@ -319,7 +331,15 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                   sinfo("Re-locking...\n");
 
                   oldstate = pthread_disable_cancel();
-                  status = pthread_mutex_take(mutex, false);
+                  if (requeued)
+                    {
+                      status = pthread_mutex_requeued(mutex);
+                    }
+                  else
+                    {
+                      status = pthread_mutex_take(mutex, false);
+                    }
+
                   pthread_enable_cancel(oldstate);
 
                   if (status == OK)
@@ -47,6 +47,7 @@
 
 #include <nuttx/cancelpt.h>
 
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -95,19 +96,58 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
     }
   else
     {
+      FAR struct tcb_s *rtcb = this_task();
       uint16_t oldstate;
+      bool requeued;
 
       /* Give up the mutex */
 
       sinfo("Give up mutex / take cond\n");
 
       sched_lock();
-      mutex->pid = -1;
+      cond->mutex = mutex;
+      mutex->pid  = -1;
       ret = pthread_mutex_give(mutex);
 
-      /* Take the semaphore */
+      /* Take the semaphore.  pthread_cond_broadcast() may move this wait
+       * to the semaphore of the mutex.  In that case, the mutex is already
+       * held when the wait completes.
+       */
+
+      rtcb->flags &= ~TCB_FLAG_SEM_REQUEUED;
+      for (; ; )
+        {
+          if (sem_wait((FAR sem_t *)&cond->sem) == OK)
+            {
+              status = OK;
+              break;
+            }
+
+          /* A signal interrupted the wait.  Wait again unless the condition
+           * was already broadcast.
+           */
+
+          status = get_errno();
+          if (status != EINTR ||
+              (rtcb->flags & TCB_FLAG_SEM_REQUEUED) != 0)
+            {
+              break;
+            }
+        }
+
+      requeued     = (rtcb->flags & TCB_FLAG_SEM_REQUEUED) != 0;
+      rtcb->flags &= ~TCB_FLAG_SEM_REQUEUED;
+
+      if (requeued && status != OK)
+        {
+          /* The condition was broadcast but the wait for the mutex was
+           * interrupted.  The mutex must be taken below.
+           */
+
+          requeued = false;
+          status   = OK;
+        }
 
-      status = pthread_sem_take((FAR sem_t *)&cond->sem, false);
       if (ret == OK)
         {
           /* Report the first failure that occurs */
@@ -127,7 +167,15 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
       sinfo("Reacquire mutex...\n");
 
       oldstate = pthread_disable_cancel();
-      status = pthread_mutex_take(mutex, false);
+      if (requeued)
+        {
+          status = pthread_mutex_requeued(mutex);
+        }
+      else
+        {
+          status = pthread_mutex_take(mutex, false);
+        }
+
       pthread_enable_cancel(oldstate);
 
       if (ret == OK)
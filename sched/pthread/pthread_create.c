@@ -241,6 +241,10 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 {
   FAR struct pthread_tcb_s *ptcb;
   FAR struct join_s *pjoin;
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+  FAR void *stack;
+  size_t stacksize;
+#endif
   struct sched_param param;
   int policy;
   int errcode;
@@ -259,13 +263,29 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 
   /* Allocate a TCB for the new task. */
 
-  ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+  ptcb = pthread_tcb_alloc(attr->stacksize, &stack, &stacksize);
+#else
+  ptcb = (FAR struct pthread_tcb_s *)
+    kmm_zalloc_hint(sizeof(struct pthread_tcb_s), MM_PLACE_TCB);
+#endif
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
       return ENOMEM;
     }
 
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+  /* Give a cached stack back to the TCB now so that it is released with
+   * the TCB on any error below.
+   */
+
+  if (stack != NULL)
+    {
+      (void)up_use_stack((FAR struct tcb_s *)ptcb, stack, stacksize);
+    }
+#endif
+
 #ifdef HAVE_TASK_GROUP
   /* Bind the parent's group to the new TCB (we have not yet joined the
    * group).
@@ -300,14 +320,17 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
       goto errout_with_tcb;
     }
 
-  /* Allocate the stack for the TCB */
+  /* Allocate the stack for the TCB (unless a cached stack was reused) */
 
-  ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
-                        TCB_FLAG_TTYPE_PTHREAD);
-  if (ret != OK)
+  if (ptcb->cmn.stack_alloc_ptr == NULL)
     {
-      errcode = ENOMEM;
-      goto errout_with_join;
+      ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
+                            TCB_FLAG_TTYPE_PTHREAD);
+      if (ret != OK)
+        {
+          errcode = ENOMEM;
+          goto errout_with_join;
+        }
     }
 
   /* Should we use the priority and scheduler specified in the pthread
@@ -97,7 +97,11 @@ FAR void *pthread_getspecific(pthread_key_t key)
     {
       /* Return the stored value. */
 
+#ifdef CONFIG_TLS
+      ret = TCB_TLSINFO(&rtcb->cmn)->tl_data[key];
+#else
       ret = rtcb->pthread_data[key];
+#endif
     }
 
   return ret;
@@ -74,6 +74,17 @@ static void pthread_mutex_add(FAR struct pthread_mutex_s *mutex)
 
   DEBUGASSERT(mutex->flink == NULL);
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+  /* Mutexes that may be taken on the fast path are never retained in the
+   * list; they do not participate in the mutex consistency logic.
+   */
+
+  if (pthread_mutex_isfast(mutex))
+    {
+      return;
+    }
+#endif
+
   /* Check if this is a pthread.  The main thread may also lock and unlock
    * mutexes.  The main thread, however, does not participate in the mutex
    * consistency logic.  Presumably, when the main thread exits, all of the
@@ -115,6 +126,15 @@ static void pthread_mutex_remove(FAR struct pthread_mutex_s *mutex)
 {
   FAR struct tcb_s *rtcb = this_task();
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+  /* Mutexes that may be taken on the fast path are never in the list */
+
+  if (pthread_mutex_isfast(mutex))
+    {
+      return;
+    }
+#endif
+
   /* Check if this is a pthread.  The main thread may also lock and unlock
    * mutexes.  The main thread, however, does not participate in the mutex
    * consistency logic.
@@ -288,6 +308,45 @@ int pthread_mutex_trytake(FAR struct pthread_mutex_s *mutex)
   return ret;
 }
 
+/****************************************************************************
+ * Name: pthread_mutex_requeued
+ *
+ * Description:
+ *   Complete taking a mutex whose semaphore was handed to this thread
+ *   after pthread_cond_broadcast() moved its condition wait to the mutex.
+ *   Add the mutex to the list of mutexes held by this thread.
+ *
+ * Parameters:
+ *  mutex - The mutex that is now held
+ *
+ * Return Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_requeued(FAR struct pthread_mutex_s *mutex)
+{
+  int ret = OK;
+
+  DEBUGASSERT(mutex != NULL);
+
+  sched_lock();
+
+  /* Check if the holder of the mutex has terminated without releasing */
+
+  if ((mutex->flags & _PTHREAD_MFLAGS_INCONSISTENT) != 0)
+    {
+      ret = EOWNERDEAD;
+    }
+  else
+    {
+      pthread_mutex_add(mutex);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
 /****************************************************************************
  * Name: pthread_mutex_give
  *
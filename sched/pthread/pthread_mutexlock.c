@@ -112,6 +112,23 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
   sinfo("mutex=0x%p\n", mutex);
   DEBUGASSERT(mutex != NULL);
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+  /* An uncontended, non-robust NORMAL mutex can be claimed with a single
+   * compare-and-swap on the underlying semaphore count.  The semaphore
+   * logic is only needed if the mutex is already held.
+   */
+
+  if (mutex != NULL && pthread_mutex_isfast(mutex) &&
+      pthread_mutex_fastlock(mutex))
+    {
+      mutex->pid    = mypid;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+      mutex->nlocks = 1;
+#endif
+      return OK;
+    }
+#endif
+
   if (mutex != NULL)
     {
       /* Make sure the semaphore is stable while we make the following
@@ -94,6 +94,18 @@ int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
     {
       int mypid = (int)getpid();
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+      /* An uncontended, non-robust NORMAL mutex can be claimed with a
+       * single compare-and-swap on the underlying semaphore count.
+       */
+
+      if (pthread_mutex_isfast(mutex) && pthread_mutex_fastlock(mutex))
+        {
+          mutex->pid = mypid;
+          return OK;
+        }
+#endif
+
       /* Make sure the semaphore is stable while we make the following
        * checks.  This all needs to be one atomic action.
        */
@@ -123,6 +123,28 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
       return EINVAL;
     }
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+  /* No ownership checks are performed for a non-robust NORMAL mutex.  If
+   * there are no waiters, the mutex can be released with a single compare-
+   * and-swap on the underlying semaphore count.  The holder must be
+   * nullified first:  The mutex may be taken by another thread as soon as
+   * the count is restored.  If the compare-and-swap fails, another thread
+   * is waiting and the semaphore must be posted normally.
+   */
+
+  if (pthread_mutex_isfast(mutex))
+    {
+      mutex->pid    = -1;
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+      mutex->nlocks = 0;
+#endif
+      if (pthread_mutex_fastunlock(mutex))
+        {
+          return OK;
+        }
+    }
+#endif
+
   /* Make sure the semaphore is stable while we make the following checks.
    * This all needs to be one atomic action.
    */
@@ -106,9 +106,13 @@ int pthread_setspecific(pthread_key_t key, FAR const void *value)
 
   if (key < group->tg_nkeys)
     {
-      /* Store the data in the TCB. */
+      /* Store the data in the TLS area or in the TCB. */
 
+#ifdef CONFIG_TLS
+      TCB_TLSINFO(&rtcb->cmn)->tl_data[key] = (FAR void *)value;
+#else
       rtcb->pthread_data[key] = (FAR void *)value;
+#endif
 
       /* Return success. */
 
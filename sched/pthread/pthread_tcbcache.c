@@ -0,0 +1,181 @@
+/****************************************************************************
+ * sched/pthread/pthread_tcbcache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+
+#include "pthread/pthread.h"
+
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A cached TCB together with the stack that it still owns */
+
+struct pthread_tcbcache_s
+{
+  FAR struct pthread_tcb_s *ptcb;  /* The cached TCB (NULL if unused) */
+  size_t stacksize;                /* The stack size requested for it */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pthread_tcbcache_s g_tcbcache[CONFIG_PTHREAD_TCB_CACHE];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_tcb_alloc
+ *
+ * Description:
+ *   Allocate a zeroed pthread TCB.  If a TCB whose stack was created with
+ *   the same requested size is in the cache, it is reused and its stack is
+ *   returned so that it can be given back to the TCB with up_use_stack().
+ *
+ * Input Parameters:
+ *   stacksize - The requested stack size of the new pthread
+ *   stack     - Location to return the cached stack, or NULL
+ *   size      - Location to return the size of the cached stack
+ *
+ * Returned Value:
+ *   The new TCB or NULL if none could be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct pthread_tcb_s *pthread_tcb_alloc(size_t stacksize,
+                                            FAR void **stack,
+                                            FAR size_t *size)
+{
+  FAR struct pthread_tcb_s *ptcb = NULL;
+  irqstate_t flags;
+  int i;
+
+  *stack = NULL;
+  *size  = 0;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_PTHREAD_TCB_CACHE; i++)
+    {
+      if (g_tcbcache[i].ptcb != NULL &&
+          g_tcbcache[i].stacksize == stacksize)
+        {
+          ptcb               = g_tcbcache[i].ptcb;
+          g_tcbcache[i].ptcb = NULL;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (ptcb == NULL)
+    {
+      ptcb = (FAR struct pthread_tcb_s *)
+        kmm_zalloc_hint(sizeof(struct pthread_tcb_s), MM_PLACE_TCB);
+    }
+  else
+    {
+      *stack = ptcb->cmn.stack_alloc_ptr;
+      *size  = ptcb->cmn.adj_stack_size;
+      memset(ptcb, 0, sizeof(struct pthread_tcb_s));
+    }
+
+  if (ptcb != NULL)
+    {
+      ptcb->stacksize = stacksize;
+    }
+
+  return ptcb;
+}
+
+/****************************************************************************
+ * Name: pthread_tcb_recycle
+ *
+ * Description:
+ *   Called by sched_releasetcb() after all other resources of the pthread
+ *   have been released.  Put the TCB and its stack in the cache if there is
+ *   room.
+ *
+ * Input Parameters:
+ *   ptcb - The TCB of the pthread being released.
+ *
+ * Returned Value:
+ *   true if the TCB was cached and must not be freed.
+ *
+ ****************************************************************************/
+
+bool pthread_tcb_recycle(FAR struct pthread_tcb_s *ptcb)
+{
+  irqstate_t flags;
+  bool cached = false;
+  int i;
+
+  if (ptcb->cmn.stack_alloc_ptr == NULL || ptcb->stacksize == 0)
+    {
+      return false;
+    }
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_PTHREAD_TCB_CACHE; i++)
+    {
+      if (g_tcbcache[i].ptcb == NULL)
+        {
+          g_tcbcache[i].ptcb      = ptcb;
+          g_tcbcache[i].stacksize = ptcb->stacksize;
+          cached                  = true;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return cached;
+}
+
+#endif /* CONFIG_PTHREAD_TCB_CACHE > 0 */
@@ -50,6 +50,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/tls.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -66,6 +67,10 @@
 #define MAX_TASKS_MASK           (CONFIG_MAX_TASKS-1)
 #define PIDHASH(pid)             ((pid) & MAX_TASKS_MASK)
 
+/* The number of 32-bit words in the ready-to-run priority bitmap */
+
+#define SCHED_PRIOSET_NWORDS     ((SCHED_PRIORITY_MAX + 32) >> 5)
+
 /* These are macros to access the current CPU and the current task on a CPU.
  * These macros are intended to support a future SMP implementation.
  */
@@ -79,6 +84,26 @@
 #endif
 #define this_task()              (current_task(this_cpu()))
 
+/* Per-thread errno and pthread-specific data.  With TLS, these live in the
+ * TLS area at the base of the stack allocation of each thread so that user
+ * code can reach them without entering the OS.  The IDLE threads have no
+ * TLS area and keep the errno in the TCB.
+ */
+
+#ifdef CONFIG_TLS
+#  ifdef CONFIG_SMP
+#    define TCB_ISIDLE(t)        ((t)->pid < CONFIG_SMP_NCPUS)
+#  else
+#    define TCB_ISIDLE(t)        ((t)->pid == 0)
+#  endif
+#  define TCB_HASTLS(t)          ((t)->stack_alloc_ptr != NULL && !TCB_ISIDLE(t))
+#  define TCB_TLSINFO(t)         ((FAR struct tls_info_s *)(t)->stack_alloc_ptr)
+#  define TCB_ERRNO(t)           (*(TCB_HASTLS(t) ? \
+                                    &TCB_TLSINFO(t)->tl_errno : &(t)->pterrno))
+#else
+#  define TCB_ERRNO(t)           ((t)->pterrno)
+#endif
+
 /* List attribute flags */
 
 #define TLIST_ATTR_PRIORITIZED   (1 << 0) /* Bit 0: List is prioritized */
@@ -136,6 +161,19 @@ struct tasklist_s
   uint8_t attr;                   /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* This structure describes the interrupt being handled by one CPU.  It is
+ * saved by irq_dispatch() across the handler so that nested interrupts are
+ * accounted correctly.
+ */
+
+struct critmon_irqctx_s
+{
+  int irq;                        /* The IRQ being handled plus one, 0 if none */
+  uint32_t start;                 /* Counter when the handler was called */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -159,6 +197,18 @@ struct tasklist_s
 
 extern volatile dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+/* These index the g_readytorun list by priority:  A bit is set in
+ * g_readytorun_prioset[] for each priority that is present in the list and
+ * g_readytorun_priotail[] holds the last TCB of each priority that is
+ * present.  With these, a TCB can be inserted behind the other TCBs of its
+ * priority without searching the list.
+ */
+
+extern uint32_t g_readytorun_prioset[SCHED_PRIOSET_NWORDS];
+extern FAR struct tcb_s *g_readytorun_priotail[SCHED_PRIORITY_MAX + 1];
+#endif
+
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -335,22 +385,17 @@ extern volatile uint32_t g_cpuload_total;
  *    'lockcount' == 0. This might happen when sched_unlock() is called, or
  *    after a context switch that changes the TCB at the head of the
  *    g_assignedtasks[cpu] list.
- * 4. Modification of the global 'g_cpu_lockset' must be protected by a
- *    spinlock, 'g_cpu_schedlock'. That spinlock would be taken when
- *    sched_lock() is called, and released when sched_unlock() is called.
- *    This assures that the scheduler does enforce the critical section.
- *    NOTE: Because of this spinlock, there should never be more than one
- *    bit set in 'g_cpu_lockset'; attempts to set additional bits should
- *    be cause the CPU to block on the spinlock.  However, additional bits
- *    could get set in 'g_cpu_lockset' due to the context switches on the
- *    various CPUs.
- * 5. Each the time the head of a g_assignedtasks[] list changes and the
- *    scheduler modifies 'g_cpu_lockset', it must also set 'g_cpu_schedlock'
- *    depending on the new state of 'g_cpu_lockset'.
- * 5. Logic that currently uses the currently running tasks lockcount
- *    instead uses the global 'g_cpu_schedlock'. A value of SP_UNLOCKED
- *    means that no CPU has pre-emption disabled; SP_LOCKED means that at
- *    least one CPU has pre-emption disabled.
+ * 4. Modification of the global 'g_cpu_lockset' is protected by the
+ *    spinlock 'g_cpu_locksetlock'.  'g_cpu_schedlock' is SP_LOCKED while
+ *    any bit is set in 'g_cpu_lockset'; it is maintained only as a summary
+ *    for instrumentation.
+ * 5. Pre-emption locking is per-CPU:  A CPU with its bit set in
+ *    'g_cpu_lockset' will not be pre-empted, but the other CPUs continue to
+ *    schedule normally.  Tasks that become ready-to-run are placed on the
+ *    CPU running the lowest priority task among the CPUs that do not have
+ *    pre-emption disabled.  Only tasks that must run on a CPU with
+ *    pre-emption disabled are held in g_pendingtasks until that CPU calls
+ *    sched_unlock().  sched_cpu_locked() tests the state of one CPU.
  */
 
 extern volatile spinlock_t g_cpu_schedlock SP_SECTION;
@@ -360,6 +405,12 @@ extern volatile spinlock_t g_cpu_schedlock SP_SECTION;
 extern volatile spinlock_t g_cpu_locksetlock SP_SECTION;
 extern volatile cpu_set_t g_cpu_lockset SP_SECTION;
 
+#ifdef CONFIG_SMP_BALANCE
+/* Declared in sched_balance.c.  Load balancing statistics for each CPU */
+
+extern struct sched_balance_s g_cpu_balance[CONFIG_SMP_NCPUS];
+#endif
+
 #endif /* CONFIG_SMP */
 
 /****************************************************************************
@@ -371,6 +422,11 @@ extern volatile cpu_set_t g_cpu_lockset SP_SECTION;
 bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+void sched_remprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#  define sched_remprioritized(t,l) dq_rem((FAR dq_entry_t *)(t), (l))
+#endif
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
@@ -393,10 +449,12 @@ int  sched_reprioritize(FAR struct tcb_s *tcb, int sched_priority);
 unsigned int sched_timer_cancel(void);
 void sched_timer_resume(void);
 void sched_timer_reassess(void);
+void sched_timer_timeslice(unsigned int ticks);
 #else
 #  define sched_timer_cancel() (0)
 #  define sched_timer_resume()
 #  define sched_timer_reassess()
+#  define sched_timer_timeslice(t)
 #endif
 
 /* Scheduler policy support */
@@ -418,14 +476,43 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  sched_deadline_start(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+int  sched_deadline_stop(FAR struct tcb_s *tcb);
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches);
+#endif
+
 #ifdef CONFIG_SMP
-int  sched_cpu_select(cpu_set_t affinity);
+int  sched_cpu_select(cpu_set_t affinity, int prefer);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
-#  define sched_islocked(tcb) spin_islocked(&g_cpu_schedlock)
+#  define sched_cpu_locked(cpu) ((g_cpu_lockset & (1 << (cpu))) != 0)
 #else
-#  define sched_cpu_select(a) (0)
+#  define sched_cpu_select(a,p) (0)
 #  define sched_cpu_pause(t)  (-38)  /* -ENOSYS */
-#  define sched_islocked(tcb) ((tcb)->lockcount > 0)
+#endif
+
+/* True if pre-emption is disabled on the CPU running tcb (tcb must be
+ * running).
+ */
+
+#define sched_islocked(tcb) ((tcb)->lockcount > 0)
+
+/* SMP load balancing support */
+
+#ifdef CONFIG_SMP_BALANCE
+void sched_idle_balance(void);
+#  define sched_count_migration(tcb,cpu) \
+     do \
+       { \
+         if ((tcb)->cpu != (cpu)) \
+           { \
+             g_cpu_balance[cpu].migrations++; \
+           } \
+       } while (0)
+#else
+#  define sched_count_migration(tcb,cpu)
 #endif
 
 /* CPU load measurement support */
@@ -434,9 +521,47 @@ int  sched_cpu_pause(FAR struct tcb_s *tcb);
 void weak_function sched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+void sched_cpuload_charge(FAR struct tcb_s *tcb, int cpu, uint32_t elapsed);
+#endif
+
+/* Run time accounting support */
+
+#ifdef CONFIG_SCHED_RUNTIME
+void sched_runtime_suspend(FAR struct tcb_s *tcb);
+void sched_runtime_resume(FAR struct tcb_s *tcb);
+void sched_runtime_tick(void);
+#else
+#  define sched_runtime_tick()
+#endif
+
+/* Critical section monitor support */
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+void sched_critmon_csection(FAR struct tcb_s *tcb, bool enter,
+                            FAR void *caller);
+void sched_critmon_preemption(FAR struct tcb_s *tcb, bool enter,
+                              FAR void *caller);
+void sched_critmon_suspend(FAR struct tcb_s *tcb);
+void sched_critmon_resume(FAR struct tcb_s *tcb);
+void sched_critmon_irqenter(int irq, FAR struct critmon_irqctx_s *save);
+void sched_critmon_irqleave(FAR struct critmon_irqctx_s *save);
+void sched_critmon_wakeup(FAR struct tcb_s *tcb);
+#else
+#  define sched_critmon_wakeup(tcb)
+#endif
+
 /* TCB operations */
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int  sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+/* Deferred de-allocations (garbage collection) */
+
+void sched_garbage_signal(void);
+
+#ifdef CONFIG_SCHED_GARBAGE_THREAD
+int  sched_garbage_start(void);
+#endif
+
 #endif /* __SCHED_SCHED_SCHED_H */
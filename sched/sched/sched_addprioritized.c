@@ -42,10 +42,99 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <queue.h>
+#include <strings.h>
 #include <assert.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioabove
+ *
+ * Description:
+ *   Return the lowest priority greater than 'priority' that is present in
+ *   the g_readytorun list, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+static inline int sched_prioabove(int priority)
+{
+  uint32_t set;
+  int bit = (priority + 1) & 31;
+  int ndx = (priority + 1) >> 5;
+
+  if (ndx >= SCHED_PRIOSET_NWORDS)
+    {
+      return -1;
+    }
+
+  /* Ignore the priorities up to and including 'priority' in the first
+   * word, then search word by word.
+   */
+
+  set = g_readytorun_prioset[ndx] & ~(((uint32_t)1 << bit) - 1);
+  while (set == 0)
+    {
+      if (++ndx >= SCHED_PRIOSET_NWORDS)
+        {
+          return -1;
+        }
+
+      set = g_readytorun_prioset[ndx];
+    }
+
+  return (ndx << 5) + ffs((int)set) - 1;
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_addindexed
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list using the priority index.  The TCB
+ *   goes just after the last TCB of the same or of the next higher priority
+ *   so no search of the list is required.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+static bool sched_addindexed(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct tcb_s *prev;
+  uint8_t sched_priority = tcb->sched_priority;
+  int above;
+
+  prev = g_readytorun_priotail[sched_priority];
+  if (prev == NULL)
+    {
+      above = sched_prioabove(sched_priority);
+      if (above >= 0)
+        {
+          prev = g_readytorun_priotail[above];
+        }
+    }
+
+  g_readytorun_prioset[sched_priority >> 5] |=
+    ((uint32_t)1 << (sched_priority & 31));
+  g_readytorun_priotail[sched_priority] = tcb;
+
+  if (prev == NULL)
+    {
+      /* Insert at the head of the list */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      return true;
+    }
+
+  dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,6 +176,15 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   ASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+  /* The ready-to-run list is indexed by priority */
+
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      return sched_addindexed(tcb, list);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
    */
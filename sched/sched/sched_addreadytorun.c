@@ -84,6 +84,10 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+  /* Remember the interrupt that woke the task, if any */
+
+  sched_critmon_wakeup(btcb);
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * pre-empted.  NOTE that IRQs disabled implies that pre-emption is
@@ -173,6 +177,10 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   int cpu;
   int me;
 
+  /* Remember the interrupt that woke the task, if any */
+
+  sched_critmon_wakeup(btcb);
+
   /* Check if the blocked TCB is locked to this CPU */
 
   if ((btcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
@@ -187,7 +195,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        * (possibly its IDLE task).
        */
 
-      cpu = sched_cpu_select(btcb->affinity);
+      cpu = sched_cpu_select(btcb->affinity, btcb->cpu);
     }
 
   /* Get the task currently running on the CPU (maybe the IDLE task) */
@@ -224,20 +232,22 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
   /* If the selected state is TSTATE_TASK_RUNNING, then we would like to
    * start running the task.  Be we cannot do that if pre-emption is
-   * disabled.  If the selected state is TSTATE_TASK_READYTORUN, then it
-   * should also go to the pending task list so that it will have a chance
-   * to be restarted when the scheduler is unlocked.
+   * disabled on the selected CPU.  sched_cpu_select() selects such a CPU
+   * only if the task may not run on any other CPU.  The task then goes
+   * to the pending task list so that it will have a chance to be
+   * restarted when the scheduler is unlocked on that CPU.
    *
    * There is an interaction here with IRQ locking.  Even if the pre-
    * emption is enabled, tasks will be forced to pend if the IRQ lock
    * is also set UNLESS the CPU starting the thread is also the holder of
    * the IRQ lock.  irq_cpu_locked() performs an atomic check for that
-   * situation.
+   * situation.  If the selected state is TSTATE_TASK_READYTORUN, then it
+   * should also go to the pending task list in that case.
    */
 
   me = this_cpu();
-  if ((spin_islocked(&g_cpu_schedlock) || irq_cpu_locked(me)) &&
-      task_state != TSTATE_TASK_ASSIGNED)
+  if ((task_state == TSTATE_TASK_RUNNING && sched_cpu_locked(cpu)) ||
+      (task_state != TSTATE_TASK_ASSIGNED && irq_cpu_locked(me)))
     {
       /* Add the new ready-to-run task to the g_pendingtasks task list for
        * now.
@@ -297,6 +307,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
           DEBUGASSERT(task_state == TSTATE_TASK_RUNNING);
 
+          sched_count_migration(btcb, cpu);
           btcb->cpu        = cpu;
           btcb->task_state = TSTATE_TASK_RUNNING;
 
@@ -378,24 +389,13 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
               dq_rem((FAR dq_entry_t *)next, tasklist);
 
-              /* Add the task to the g_readytorun or to the g_pendingtasks
-               * list.  NOTE: That the above operations may cause the
-               * scheduler to become locked.  It may be assigned to a
-               * different CPU the next time that it runs.
+              /* Add the task to the g_readytorun list.  It may be
+               * assigned to a different CPU the next time that it runs.
                */
 
-              if (spin_islocked(&g_cpu_schedlock))
-                {
-                  next->task_state = TSTATE_TASK_PENDING;
-                  tasklist         = (FAR dq_queue_t *)&g_pendingtasks;
-                }
-              else
-                {
-                  next->task_state = TSTATE_TASK_READYTORUN;
-                  tasklist         = (FAR dq_queue_t *)&g_readytorun;
-                }
-
-              (void)sched_addprioritized(next, tasklist);
+              next->task_state = TSTATE_TASK_READYTORUN;
+              (void)sched_addprioritized(next,
+                                         (FAR dq_queue_t *)&g_readytorun);
             }
 
           doswitch = true;
@@ -0,0 +1,181 @@
+/****************************************************************************
+ * sched/sched/sched_balance.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_BALANCE
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Load balancing statistics for each CPU */
+
+struct sched_balance_s g_cpu_balance[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_idle_balance
+ *
+ * Description:
+ *   Called repeatedly from the IDLE loop of each CPU.  If the CPU is idle
+ *   but runnable threads that are permitted to run on it are waiting in the
+ *   g_readytorun list, pull the highest priority such thread onto this CPU.
+ *
+ *   Threads that are not locked to a CPU and are not running wait in the
+ *   g_readytorun list.  Such a thread is normally picked up as soon as a
+ *   CPU becomes free, but not if that CPU went idle while the scheduler was
+ *   locked or while another CPU held the IRQ lock, or if the thread was
+ *   pre-empted while another CPU was already idle.  In those cases an idle
+ *   CPU and a waiting thread would otherwise co-exist until the next
+ *   context switch on that CPU.
+ *
+ *   Threads locked to a busy CPU (in the g_assignedtasks[] list of that
+ *   CPU) cannot be moved and are not considered.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called only by the IDLE thread of the current CPU.
+ *
+ ****************************************************************************/
+
+void sched_idle_balance(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int me;
+
+  /* Avoid the critical section in the common case where there is nothing
+   * to pull.
+   */
+
+  if (g_readytorun.head == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Do nothing if the scheduler is locked on this CPU, another CPU holds
+   * the IRQ lock, or if this CPU is no longer running its IDLE thread (the
+   * IDLE thread is always the last task in the assigned task list).
+   */
+
+  me   = this_cpu();
+  rtcb = current_task(me);
+
+  if (rtcb->flink == NULL && !sched_cpu_locked(me) && !irq_cpu_locked(me))
+    {
+      /* Find the highest priority waiting thread that can run on this
+       * CPU.
+       */
+
+      for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+           tcb != NULL && !CPU_ISSET(me, &tcb->affinity);
+           tcb = (FAR struct tcb_s *)tcb->flink);
+
+      if (tcb != NULL)
+        {
+          /* Re-adding the thread at its current priority will place it on
+           * an idle CPU (this one, unless the CPU that the thread last ran
+           * on is also idle) and perform the context switch.
+           */
+
+          g_cpu_balance[me].pulls++;
+          up_reprioritize_rtr(tcb, tcb->sched_priority);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sched_balance_stats
+ *
+ * Description:
+ *   Return the load balancing statistics of one CPU.
+ *
+ * Inputs:
+ *   cpu   - The index of the CPU
+ *   stats - The location to return the statistics
+ *
+ * Return Value:
+ *   Zero (OK) on success; -EINVAL if the CPU index is not valid.
+ *
+ ****************************************************************************/
+
+int sched_balance_stats(int cpu, FAR struct sched_balance_s *stats)
+{
+  irqstate_t flags;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags  = enter_critical_section();
+  *stats = g_cpu_balance[cpu];
+  leave_critical_section(flags);
+
+  return OK;
+}
+
+#endif /* CONFIG_SMP_BALANCE */
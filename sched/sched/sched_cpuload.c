@@ -42,6 +42,7 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 
@@ -71,16 +72,31 @@
  */
 
 #ifdef CONFIG_SMP
+#  define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CPULOAD_NCPUS 1
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
 #  define CPULOAD_TIMECONSTANT \
-     (CONFIG_SMP_NCPUS * \
+     (CPULOAD_NCPUS * \
       CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
-      CPULOAD_TICKSPERSEC)
+      (up_perf_getfreq() >> sched_cpuload_shift()))
 #else
 #  define CPULOAD_TIMECONSTANT \
-     (CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
+     (CPULOAD_NCPUS * \
+      CONFIG_SCHED_CPULOAD_TIMECONSTANT * \
       CPULOAD_TICKSPERSEC)
 #endif
 
+/* With CONFIG_SCHED_CPULOAD_PERFCOUNT, the counts of the free-running
+ * counter are scaled down by a power of two to a rate of no more than
+ * CPULOAD_MAXRATE so that the accumulators of the g_pidhash[] table cannot
+ * overflow within the time constant.
+ */
+
+#define CPULOAD_MAXRATE 1000000
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -100,10 +116,51 @@
 
 volatile uint32_t g_cpuload_total;
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+/* The counts not yet charged on each CPU (less than 1 << g_cpuload_shift)
+ * and the scaling of the counter frequency.
+ */
+
+static uint32_t g_cpuload_residue[CPULOAD_NCPUS];
+static uint32_t g_cpuload_freq;
+static uint8_t g_cpuload_shift;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sched_cpuload_shift
+ *
+ * Description:
+ *   Return the right shift that scales counts of the free-running counter
+ *   to a rate of no more than CPULOAD_MAXRATE.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+static uint8_t sched_cpuload_shift(void)
+{
+  uint32_t freq = up_perf_getfreq();
+
+  if (freq != g_cpuload_freq)
+    {
+      uint8_t shift = 0;
+
+      while ((freq >> shift) > CPULOAD_MAXRATE)
+        {
+          shift++;
+        }
+
+      g_cpuload_freq  = freq;
+      g_cpuload_shift = shift;
+    }
+
+  return g_cpuload_shift;
+}
+#endif
+
 /****************************************************************************
  * Name: sched_cpu_process_cpuload
  *
@@ -122,6 +179,7 @@ volatile uint32_t g_cpuload_total;
  *
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_CPULOAD_PERFCOUNT
 static inline void sched_cpu_process_cpuload(int cpu)
 {
   FAR struct tcb_s *rtcb  = current_task(cpu);
@@ -145,11 +203,52 @@ static inline void sched_cpu_process_cpuload(int cpu)
 
   g_cpuload_total++;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sched_cpuload_charge
+ *
+ * Description:
+ *   Charge counts of the free-running counter to the CPU load of a thread.
+ *   This replaces the sampling at each timer interrupt when
+ *   CONFIG_SCHED_CPULOAD_PERFCOUNT is selected.
+ *
+ * Inputs:
+ *   tcb     - The thread that ran for the 'elapsed' counts.
+ *   cpu     - The CPU that the thread ran on.
+ *   elapsed - The elapsed counts of the free-running counter.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions/Limitations:
+ *   Called from sched_runtime_charge() with interrupts disabled (and, in
+ *   the SMP case, within a critical section).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+void sched_cpuload_charge(FAR struct tcb_s *tcb, int cpu, uint32_t elapsed)
+{
+  uint8_t shift = sched_cpuload_shift();
+  uint64_t counts;
+  uint32_t units;
+  uint32_t mask;
+
+  mask   = ((uint32_t)1 << shift) - 1;
+  counts = (uint64_t)g_cpuload_residue[cpu] + elapsed;
+  units  = (uint32_t)(counts >> shift);
+  g_cpuload_residue[cpu] = (uint32_t)counts & mask;
+
+  g_pidhash[PIDHASH(tcb->pid)].ticks += units;
+  g_cpuload_total += units;
+}
+#endif
+
 /****************************************************************************
  * Name: sched_process_cpuload
  *
@@ -175,9 +274,13 @@ void weak_function sched_process_cpuload(void)
 #ifdef CONFIG_SMP
   irqstate_t flags;
 
+  flags = enter_critical_section();
+#endif
+
+#ifndef CONFIG_SCHED_CPULOAD_PERFCOUNT
+#ifdef CONFIG_SMP
   /* Perform scheduler operations on all CPUs. */
 
-  flags = enter_critical_section();
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       sched_cpu_process_cpuload(i);
@@ -189,6 +292,7 @@ void weak_function sched_process_cpuload(void)
   sched_cpu_process_cpuload(0);
 
 #endif
+#endif /* !CONFIG_SCHED_CPULOAD_PERFCOUNT */
 
   /* If the accumulated tick value exceed a time constant, then shift the
    * accumulators and recalculate the total.
@@ -65,8 +65,17 @@
  *   Return the index to the CPU with the lowest priority running task,
  *   possbily its IDLE task.
  *
+ *   If several CPUs qualify, the preferred CPU is selected.  This is
+ *   normally the CPU that the thread last ran on so that the thread returns
+ *   to the CPU whose caches and TLB are most likely to still hold its
+ *   working set.
+ *
+ *   CPUs with pre-emption disabled cannot be pre-empted.  Such a CPU is
+ *   selected only if the thread is not permitted to run on any other CPU.
+ *
  * Inputs:
  *   affinity - The set of CPUs on which the thread is permitted to run.
+ *   prefer   - The CPU to use if there is a tie.
  *
  * Return Value:
  *   Index of the CPU with the lowest priority running task
@@ -76,17 +85,40 @@
  *
  ****************************************************************************/
 
-int sched_cpu_select(cpu_set_t affinity)
+int sched_cpu_select(cpu_set_t affinity, int prefer)
 {
+  FAR struct tcb_s *rtcb;
   uint8_t minprio;
+  int locked;
   int cpu;
   int i;
 
+  /* If the preferred CPU is permitted and is executing its IDLE task, then
+   * there is no better choice.  The IDLE task is always the last task in
+   * the assigned task list.
+   */
+
+  if (prefer >= 0 && prefer < CONFIG_SMP_NCPUS &&
+      (affinity & (1 << prefer)) != 0)
+    {
+      rtcb = (FAR struct tcb_s *)g_assignedtasks[prefer].head;
+      if (rtcb->flink == NULL && !sched_cpu_locked(prefer))
+        {
+          DEBUGASSERT(rtcb->sched_priority == 0);
+          return prefer;
+        }
+    }
+  else
+    {
+      prefer = IMPOSSIBLE_CPU;
+    }
+
   /* Otherwise, find the CPU that is executing the lowest priority task
    * (possibly its IDLE task).
    */
 
   minprio = SCHED_PRIORITY_MAX;
+  locked  = IMPOSSIBLE_CPU;
   cpu     = IMPOSSIBLE_CPU;
 
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
@@ -95,12 +127,24 @@ int sched_cpu_select(cpu_set_t affinity)
 
       if ((affinity & (1 << i)) != 0)
         {
-          FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
-
-          /* If this thread is executing its IDLE task, the use it.  The
-           * IDLE task is always the last task in the assigned task list.
+          /* Skip over CPUs with pre-emption disabled, but remember one in
+           * case there is no other choice.
            */
 
+          if (sched_cpu_locked(i))
+            {
+              if (locked == IMPOSSIBLE_CPU || i == prefer)
+                {
+                  locked = i;
+                }
+
+              continue;
+            }
+
+          rtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+
+          /* If this thread is executing its IDLE task, the use it. */
+
           if (rtcb->flink == NULL)
             {
               /* The IDLE task should always be assigned to this CPU and have
@@ -110,14 +154,29 @@ int sched_cpu_select(cpu_set_t affinity)
               DEBUGASSERT(rtcb->sched_priority == 0);
               return i;
             }
-          else if (rtcb->sched_priority < minprio)
+
+          /* Otherwise, keep the lowest priority CPU seen so far, breaking
+           * ties in favor of the preferred CPU.
+           */
+
+          DEBUGASSERT(rtcb->sched_priority > 0);
+
+          if (cpu == IMPOSSIBLE_CPU || rtcb->sched_priority < minprio ||
+              (rtcb->sched_priority == minprio && i == prefer))
             {
-              DEBUGASSERT(rtcb->sched_priority > 0);
-              cpu = i;
+              minprio = rtcb->sched_priority;
+              cpu     = i;
             }
         }
     }
 
+  /* Use a CPU with pre-emption disabled only if there is no other choice */
+
+  if (cpu == IMPOSSIBLE_CPU)
+    {
+      cpu = locked;
+    }
+
   DEBUGASSERT(cpu != IMPOSSIBLE_CPU);
   return cpu;
 }
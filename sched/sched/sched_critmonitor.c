@@ -0,0 +1,652 @@
+/****************************************************************************
+ * sched/sched/sched_critmonitor.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The last entry of each table of call sites collects the sections of all
+ * callers that did not find a free entry.
+ */
+
+#define CRITMON_NSITES  CONFIG_SCHED_CRITMONITOR_NSITES
+#define CRITMON_OTHER   CRITMON_NSITES
+
+#ifdef CONFIG_SMP
+#  define CRITMON_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CRITMON_NCPUS 1
+#endif
+
+/* Interrupts are disabled on the local CPU whenever the tables are
+ * modified.  In the SMP case, a spinlock is also needed.  Note that
+ * enter_critical_section() may not be used here:  It is being monitored.
+ */
+
+#ifdef CONFIG_SMP
+#  define critmon_lock()   spin_lock(&g_critmon_lock)
+#  define critmon_unlock() spin_unlock(&g_critmon_lock)
+#else
+#  define critmon_lock()
+#  define critmon_unlock()
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The statistics of one call site.  Durations are in counts of the
+ * free-running counter.
+ */
+
+struct critmon_entry_s
+{
+  FAR void *caller;                 /* Return address, NULL if unused */
+  uint32_t count;                   /* Number of sections */
+  uint32_t max;                     /* Longest section */
+  uint32_t hist[CRITMON_NBUCKETS];  /* Histogram of durations */
+};
+
+/* The statistics of one IRQ.  Durations are in counts of the free-running
+ * counter.
+ */
+
+struct critmon_irqentry_s
+{
+  uint32_t count;                     /* Number of interrupts handled */
+  uint32_t max;                       /* Longest handler */
+  uint64_t total;                     /* Total time in the handler */
+  uint32_t hist[CRITMON_NBUCKETS];    /* Histogram of durations */
+  uint32_t wakeups;                   /* Number of threads woken */
+  uint32_t latmax;                    /* Longest latency to thread run */
+  uint32_t lathist[CRITMON_NBUCKETS]; /* Histogram of latencies */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static volatile spinlock_t g_critmon_lock SP_SECTION;
+#endif
+
+/* Statistics of critical sections and of pre-emption locks by caller */
+
+static struct critmon_entry_s g_critmon_csection[CRITMON_NSITES + 1];
+static struct critmon_entry_s g_critmon_preemption[CRITMON_NSITES + 1];
+
+#if NR_IRQS > 0
+/* Statistics of interrupt handlers by IRQ number */
+
+static struct critmon_irqentry_s g_critmon_irq[NR_IRQS];
+#endif
+
+/* The interrupt being handled by each CPU */
+
+static struct critmon_irqctx_s g_critmon_irqctx[CRITMON_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critmon_usec
+ *
+ * Description:
+ *   Convert a count of the free-running counter to microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t critmon_usec(uint64_t counts)
+{
+  uint32_t freq = up_perf_getfreq();
+
+  if (freq == 0)
+    {
+      return 0;
+    }
+
+  return (counts / freq) * USEC_PER_SEC +
+         ((counts % freq) * USEC_PER_SEC) / freq;
+}
+
+/****************************************************************************
+ * Name: critmon_bucket
+ *
+ * Description:
+ *   Return the histogram bucket of a duration.  Bucket n counts durations
+ *   of less than 2**n microseconds; the last bucket counts all longer
+ *   durations.
+ *
+ ****************************************************************************/
+
+static int critmon_bucket(uint32_t counts)
+{
+  uint64_t usec = critmon_usec(counts);
+  int bucket = 0;
+
+  while (bucket < CRITMON_NBUCKETS - 1 && usec >= ((uint64_t)1 << bucket))
+    {
+      bucket++;
+    }
+
+  return bucket;
+}
+
+/****************************************************************************
+ * Name: critmon_record
+ *
+ * Description:
+ *   Add a section of the given duration to the statistics of its caller.
+ *
+ ****************************************************************************/
+
+static void critmon_record(FAR struct critmon_entry_s *table,
+                           FAR void *caller, uint32_t elapsed)
+{
+  FAR struct critmon_entry_s *entry;
+  unsigned int ndx;
+  unsigned int i;
+  irqstate_t flags;
+
+  /* Find the caller in the hash table or add it */
+
+  ndx   = ((uintptr_t)caller >> 1) % CRITMON_NSITES;
+  entry = &table[CRITMON_OTHER];
+
+  flags = up_irq_save();
+  critmon_lock();
+
+  for (i = 0; i < CRITMON_NSITES; i++)
+    {
+      FAR struct critmon_entry_s *probe = &table[ndx];
+
+      if (probe->caller == caller)
+        {
+          entry = probe;
+          break;
+        }
+      else if (probe->caller == NULL)
+        {
+          probe->caller = caller;
+          entry         = probe;
+          break;
+        }
+
+      if (++ndx >= CRITMON_NSITES)
+        {
+          ndx = 0;
+        }
+    }
+
+  entry->count++;
+  if (elapsed > entry->max)
+    {
+      entry->max = elapsed;
+    }
+
+  entry->hist[critmon_bucket(elapsed)]++;
+
+  critmon_unlock();
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: critmon_getentry
+ *
+ * Description:
+ *   Return the statistics of one entry of a table of call sites.
+ *
+ ****************************************************************************/
+
+static int critmon_getentry(FAR struct critmon_entry_s *table, int index,
+                            FAR struct critmon_site_s *site)
+{
+  struct critmon_entry_s entry;
+  irqstate_t flags;
+  int i;
+
+  if (index < 0 || index > CRITMON_OTHER)
+    {
+      return -EINVAL;
+    }
+
+  flags = up_irq_save();
+  critmon_lock();
+  memcpy(&entry, &table[index], sizeof(struct critmon_entry_s));
+  critmon_unlock();
+  up_irq_restore(flags);
+
+  if (entry.count == 0)
+    {
+      return -ENOENT;
+    }
+
+  site->caller = entry.caller;
+  site->count  = entry.count;
+  site->max    = (uint32_t)critmon_usec(entry.max);
+
+  for (i = 0; i < CRITMON_NBUCKETS; i++)
+    {
+      site->hist[i] = entry.hist[i];
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_critmon_csection
+ *
+ * Description:
+ *   Called when a thread enters or leaves the outermost critical section.
+ *
+ * Input Parameters:
+ *   tcb    - The TCB of the thread
+ *   enter  - True if the critical section is being entered
+ *   caller - The return address of enter_critical_section()
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_critmon_csection(FAR struct tcb_s *tcb, bool enter,
+                            FAR void *caller)
+{
+  uint32_t now = up_perf_gettime();
+
+  if (enter)
+    {
+      tcb->crit_caller  = caller;
+      tcb->crit_start   = now;
+      tcb->crit_elapsed = 0;
+    }
+  else if (tcb->crit_caller != NULL)
+    {
+      critmon_record(g_critmon_csection, tcb->crit_caller,
+                     tcb->crit_elapsed + (now - tcb->crit_start));
+      tcb->crit_caller = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_preemption
+ *
+ * Description:
+ *   Called when a thread locks or unlocks pre-emption for the outermost
+ *   time.
+ *
+ * Input Parameters:
+ *   tcb    - The TCB of the thread
+ *   enter  - True if pre-emption is being locked
+ *   caller - The return address of sched_lock()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_critmon_preemption(FAR struct tcb_s *tcb, bool enter,
+                              FAR void *caller)
+{
+  uint32_t now = up_perf_gettime();
+
+  if (enter)
+    {
+      tcb->premp_caller  = caller;
+      tcb->premp_start   = now;
+      tcb->premp_elapsed = 0;
+    }
+  else if (tcb->premp_caller != NULL)
+    {
+      critmon_record(g_critmon_preemption, tcb->premp_caller,
+                     tcb->premp_elapsed + (now - tcb->premp_start));
+      tcb->premp_caller = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_suspend and sched_critmon_resume
+ *
+ * Description:
+ *   Called from sched_suspend_scheduler() and sched_resume_scheduler().  A
+ *   thread may block within a critical section or with pre-emption locked.
+ *   The time that it does not run is not part of the section.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being suspended or resumed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_critmon_suspend(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_perf_gettime();
+
+  if (tcb->crit_caller != NULL)
+    {
+      tcb->crit_elapsed += now - tcb->crit_start;
+    }
+
+  if (tcb->premp_caller != NULL)
+    {
+      tcb->premp_elapsed += now - tcb->premp_start;
+    }
+}
+
+void sched_critmon_resume(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_perf_gettime();
+#if NR_IRQS > 0
+  FAR struct critmon_irqentry_s *entry;
+  uint32_t elapsed;
+#endif
+
+  tcb->crit_start  = now;
+  tcb->premp_start = now;
+
+#if NR_IRQS > 0
+  /* If an interrupt handler woke the thread, this is its first run since.
+   * Record the latency from the start of that interrupt.
+   */
+
+  if (tcb->wake_irq > 0 && tcb->wake_irq <= NR_IRQS)
+    {
+      entry   = &g_critmon_irq[tcb->wake_irq - 1];
+      elapsed = now - tcb->wake_start;
+
+      critmon_lock();
+
+      entry->wakeups++;
+      if (elapsed > entry->latmax)
+        {
+          entry->latmax = elapsed;
+        }
+
+      entry->lathist[critmon_bucket(elapsed)]++;
+
+      critmon_unlock();
+    }
+#endif
+
+  tcb->wake_irq = 0;
+}
+
+/****************************************************************************
+ * Name: sched_critmon_irqenter and sched_critmon_irqleave
+ *
+ * Description:
+ *   Called from irq_dispatch() before the handler of an interrupt is called
+ *   and after it returns.  The interrupt that was being handled by this CPU
+ *   is saved in the caller's context across the handler.
+ *
+ * Input Parameters:
+ *   irq  - The IRQ number
+ *   save - The location to save the interrupted context
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_critmon_irqenter(int irq, FAR struct critmon_irqctx_s *save)
+{
+  FAR struct critmon_irqctx_s *ctx = &g_critmon_irqctx[this_cpu()];
+
+  save->irq   = ctx->irq;
+  save->start = ctx->start;
+
+  ctx->irq   = irq + 1;
+  ctx->start = up_perf_gettime();
+}
+
+void sched_critmon_irqleave(FAR struct critmon_irqctx_s *save)
+{
+  FAR struct critmon_irqctx_s *ctx = &g_critmon_irqctx[this_cpu()];
+#if NR_IRQS > 0
+  FAR struct critmon_irqentry_s *entry;
+  uint32_t elapsed = up_perf_gettime() - ctx->start;
+
+  if (ctx->irq > 0 && ctx->irq <= NR_IRQS)
+    {
+      entry = &g_critmon_irq[ctx->irq - 1];
+
+      critmon_lock();
+
+      entry->count++;
+      entry->total += elapsed;
+      if (elapsed > entry->max)
+        {
+          entry->max = elapsed;
+        }
+
+      entry->hist[critmon_bucket(elapsed)]++;
+
+      critmon_unlock();
+    }
+#endif
+
+  ctx->irq   = save->irq;
+  ctx->start = save->start;
+}
+
+/****************************************************************************
+ * Name: sched_critmon_wakeup
+ *
+ * Description:
+ *   Called from sched_addreadytorun() when a thread is made ready-to-run.
+ *   If this happens in an interrupt handler, the IRQ and its start time are
+ *   remembered in the TCB so that sched_critmon_resume() can measure the
+ *   latency until the thread runs.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being made ready-to-run
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_critmon_wakeup(FAR struct tcb_s *tcb)
+{
+  FAR struct critmon_irqctx_s *ctx = &g_critmon_irqctx[this_cpu()];
+
+  /* Keep the first interrupt if the thread was already woken, e.g. when it
+   * is moved from the pending list.
+   */
+
+  if (ctx->irq > 0 && tcb->wake_irq == 0)
+    {
+      tcb->wake_irq   = ctx->irq;
+      tcb->wake_start = ctx->start;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_getsite
+ *
+ * Description:
+ *   Return the statistics of one call site.
+ *
+ * Input Parameters:
+ *   type  - CRITMON_CSECTION or CRITMON_PREEMPTION
+ *   index - The index of the entry, 0 through
+ *           CONFIG_SCHED_CRITMONITOR_NSITES.  The last entry (with caller
+ *           NULL) collects the sections of callers that did not fit in the
+ *           table.
+ *   site  - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if the entry is
+ *   unused; -EINVAL is returned if the type or the index is not valid.
+ *
+ ****************************************************************************/
+
+int sched_critmon_getsite(int type, int index,
+                          FAR struct critmon_site_s *site)
+{
+  switch (type)
+    {
+      case CRITMON_CSECTION:
+        return critmon_getentry(g_critmon_csection, index, site);
+
+      case CRITMON_PREEMPTION:
+        return critmon_getentry(g_critmon_preemption, index, site);
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_getirq
+ *
+ * Description:
+ *   Return the statistics of the handler of one IRQ.
+ *
+ * Input Parameters:
+ *   irq   - The IRQ number
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if the interrupt
+ *   never occurred; -EINVAL is returned if the IRQ number is not valid.
+ *
+ ****************************************************************************/
+
+int sched_critmon_getirq(int irq, FAR struct critmon_irq_s *stats)
+{
+#if NR_IRQS > 0
+  struct critmon_irqentry_s entry;
+  irqstate_t flags;
+  int i;
+
+  if (irq < 0 || irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  flags = up_irq_save();
+  critmon_lock();
+  memcpy(&entry, &g_critmon_irq[irq], sizeof(struct critmon_irqentry_s));
+  critmon_unlock();
+  up_irq_restore(flags);
+
+  if (entry.count == 0)
+    {
+      return -ENOENT;
+    }
+
+  stats->count   = entry.count;
+  stats->max     = (uint32_t)critmon_usec(entry.max);
+  stats->total   = critmon_usec(entry.total);
+  stats->wakeups = entry.wakeups;
+  stats->latmax  = (uint32_t)critmon_usec(entry.latmax);
+
+  for (i = 0; i < CRITMON_NBUCKETS; i++)
+    {
+      stats->hist[i]    = entry.hist[i];
+      stats->lathist[i] = entry.lathist[i];
+    }
+
+  return OK;
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_critmon_reset
+ *
+ * Description:
+ *   Discard all statistics.
+ *
+ ****************************************************************************/
+
+void sched_critmon_reset(void)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  critmon_lock();
+
+  memset(g_critmon_csection, 0, sizeof(g_critmon_csection));
+  memset(g_critmon_preemption, 0, sizeof(g_critmon_preemption));
+#if NR_IRQS > 0
+  memset(g_critmon_irq, 0, sizeof(g_critmon_irq));
+#endif
+
+  critmon_unlock();
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SCHED_CRITMONITOR */
@@ -0,0 +1,544 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+
+#include <arch/irq.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SMP_NCPUS
+#  define CONFIG_SMP_NCPUS 1
+#endif
+
+#if CONFIG_SCHED_DEADLINE_NTASKS >= CONFIG_SCHED_DEADLINE_PRIORITY
+#  error CONFIG_SCHED_DEADLINE_NTASKS must be less than the deadline priority
+#endif
+
+/* Bandwidth is represented in fixed point with DEADLINE_BW_ONE being the
+ * full capacity of one CPU.
+ */
+
+#define DEADLINE_BW_SHIFT  16
+#define DEADLINE_BW_ONE    (1 << DEADLINE_BW_SHIFT)
+#define DEADLINE_BW_LIMIT \
+  ((uint32_t)CONFIG_SCHED_DEADLINE_MAXUTIL * DEADLINE_BW_ONE / 100 * \
+   CONFIG_SMP_NCPUS)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void deadline_period_expire(int argc, wdparm_t arg1, ...);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All deadline threads in order of ascending absolute deadline */
+
+static FAR struct deadline_s *g_deadline_list;
+
+/* The number of deadline threads and their total reserved bandwidth */
+
+static uint8_t g_deadline_ntasks;
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_insert
+ *
+ * Description:
+ *   Add a deadline thread to g_deadline_list in order of its absolute
+ *   deadline.  Threads with equal deadlines are kept in FIFO order.
+ *
+ ****************************************************************************/
+
+static void deadline_insert(FAR struct deadline_s *dl)
+{
+  FAR struct deadline_s *prev = NULL;
+  FAR struct deadline_s *next;
+
+  for (next = g_deadline_list;
+       next != NULL && (ssystime_t)(next->abstime - dl->abstime) <= 0;
+       next = next->flink)
+    {
+      prev = next;
+    }
+
+  dl->flink = next;
+  if (prev == NULL)
+    {
+      g_deadline_list = dl;
+    }
+  else
+    {
+      prev->flink = dl;
+    }
+}
+
+/****************************************************************************
+ * Name: deadline_remove
+ *
+ * Description:
+ *   Remove a deadline thread from g_deadline_list.
+ *
+ ****************************************************************************/
+
+static void deadline_remove(FAR struct deadline_s *dl)
+{
+  FAR struct deadline_s *prev = NULL;
+  FAR struct deadline_s *curr;
+
+  for (curr = g_deadline_list; curr != NULL && curr != dl;
+       curr = curr->flink)
+    {
+      prev = curr;
+    }
+
+  DEBUGASSERT(curr != NULL);
+  if (prev == NULL)
+    {
+      g_deadline_list = dl->flink;
+    }
+  else
+    {
+      prev->flink = dl->flink;
+    }
+
+  dl->flink = NULL;
+}
+
+/****************************************************************************
+ * Name: deadline_setpriority
+ *
+ * Description:
+ *   Set the priority of one deadline thread, possibly causing a context
+ *   switch.
+ *
+ ****************************************************************************/
+
+static void deadline_setpriority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the priority is currently boosted above the new priority, then
+   * just reset the base priority.  It will be restored when the boost
+   * is removed.
+   */
+
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority > priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  if (tcb->sched_priority != priority)
+    {
+      (void)sched_reprioritize(tcb, priority);
+    }
+}
+
+/****************************************************************************
+ * Name: deadline_rerank
+ *
+ * Description:
+ *   Map the deadline threads onto the deadline priority band:  The thread
+ *   with the earliest absolute deadline runs at the priority
+ *   CONFIG_SCHED_DEADLINE_PRIORITY, the next at one less, and so on.
+ *   Throttled threads run at SCHED_PRIORITY_MIN until their next period.
+ *
+ *   This must be called whenever a deadline changes or a thread is
+ *   throttled.
+ *
+ ****************************************************************************/
+
+static void deadline_rerank(void)
+{
+  FAR struct deadline_s *dl;
+  int priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+
+  for (dl = g_deadline_list; dl != NULL; dl = dl->flink)
+    {
+      if (dl->throttled)
+        {
+          deadline_setpriority(dl->tcb, SCHED_PRIORITY_MIN);
+        }
+      else
+        {
+          deadline_setpriority(dl->tcb, priority--);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: deadline_period_start
+ *
+ * Description:
+ *   Begin a new period that started at 'release':  Replenish the budget,
+ *   advance the absolute deadline and start the timer for the following
+ *   period.  The caller must call deadline_rerank() afterward.
+ *
+ ****************************************************************************/
+
+static void deadline_period_start(FAR struct deadline_s *dl,
+                                  systime_t release, systime_t now)
+{
+  ssystime_t delay;
+
+  dl->release        = release;
+  dl->abstime        = release + dl->deadline;
+  dl->throttled      = false;
+  dl->tcb->timeslice = dl->runtime;
+
+  deadline_remove(dl);
+  deadline_insert(dl);
+
+  delay = (ssystime_t)(release + dl->period - now);
+  if (delay < 1)
+    {
+      delay = 1;
+    }
+
+  DEBUGVERIFY(wd_start(&dl->timer, delay, deadline_period_expire, 1,
+                       (wdparm_t)dl));
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   Handles the start of the next period of a deadline thread.
+ *
+ * Input Parameters:
+ *   Standard watchdog parameters
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_period_expire(int argc, wdparm_t arg1, ...)
+{
+  FAR struct deadline_s *dl = (FAR struct deadline_s *)arg1;
+  irqstate_t flags;
+  systime_t release;
+  systime_t now;
+
+  DEBUGASSERT(argc == 1 && dl != NULL && dl->tcb != NULL);
+
+  flags   = enter_critical_section();
+  now     = clock_systimer();
+
+  /* Periods follow each other without drift.  However, if the timer was
+   * delayed by more than a whole period, then restart the periods now.
+   */
+
+  release = dl->release + dl->period;
+  if ((ssystime_t)(now - release) >= (ssystime_t)dl->period)
+    {
+      release = now;
+    }
+
+  deadline_period_start(dl, release, now);
+  deadline_rerank();
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_deadline_start
+ *
+ * Description:
+ *   Called to begin deadline scheduling of a thread or to change the
+ *   deadline parameters of a thread that already uses the deadline policy.
+ *   This function is called from sched_setscheduler() and sched_setparam().
+ *   The first period starts immediately.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - Holds the runtime, deadline and period.  If the deadline is
+ *           zero, it is equal to the period; if the period is zero, it is
+ *           equal to the deadline.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL - The parameters do not satisfy runtime <= deadline <= period.
+ *   EBUSY  - Admitting the thread would exceed the deadline bandwidth or
+ *            the maximum number of deadline threads.
+ *   ENOMEM - The deadline state could not be allocated.
+ *
+ * Assumptions:
+ *   The caller has already set TCB_FLAG_SCHED_DEADLINE.
+ *
+ ****************************************************************************/
+
+int sched_deadline_start(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *dl;
+  ssystime_t runtime;
+  ssystime_t deadline;
+  ssystime_t period;
+  irqstate_t flags;
+  uint32_t oldbw;
+  uint32_t bw;
+  systime_t now;
+  int ret = OK;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  /* Convert timespec values to system clock ticks */
+
+  (void)clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  (void)clock_time2ticks(&param->sched_dl_deadline, &deadline);
+  (void)clock_time2ticks(&param->sched_dl_period, &period);
+
+  if (deadline <= 0)
+    {
+      deadline = period;
+    }
+  else if (period <= 0)
+    {
+      period = deadline;
+    }
+
+  if (runtime < 1 || runtime > deadline || deadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* The density runtime/deadline is a sufficient EDF schedulability test
+   * for deadlines shorter than the period.
+   */
+
+  bw = (uint32_t)(((uint64_t)runtime << DEADLINE_BW_SHIFT) / deadline);
+
+  flags = enter_critical_section();
+
+  dl    = tcb->deadline;
+  oldbw = (dl != NULL) ? dl->bandwidth : 0;
+
+  /* Admission control */
+
+  if ((dl == NULL && g_deadline_ntasks >= CONFIG_SCHED_DEADLINE_NTASKS) ||
+      g_deadline_bw - oldbw + bw > DEADLINE_BW_LIMIT)
+    {
+      ret = -EBUSY;
+      goto errout_with_irq;
+    }
+
+  if (dl == NULL)
+    {
+      /* Allocate the deadline add-on data structure */
+
+      dl = (FAR struct deadline_s *)kmm_zalloc(sizeof(struct deadline_s));
+      if (dl == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          ret = -ENOMEM;
+          goto errout_with_irq;
+        }
+
+      dl->tcb       = tcb;
+      tcb->deadline = dl;
+      g_deadline_ntasks++;
+    }
+  else
+    {
+      /* Stop the current period */
+
+      wd_cancel(&dl->timer);
+      deadline_remove(dl);
+    }
+
+  g_deadline_bw = g_deadline_bw - oldbw + bw;
+
+  dl->runtime   = (uint32_t)runtime;
+  dl->deadline  = (uint32_t)deadline;
+  dl->period    = (uint32_t)period;
+  dl->bandwidth = bw;
+
+  /* Start the first period now and give the thread its priority */
+
+  now = clock_systimer();
+  deadline_insert(dl);
+  deadline_period_start(dl, now, now);
+  deadline_rerank();
+
+errout_with_irq:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_stop
+ *
+ * Description:
+ *   Called to terminate deadline scheduling of a thread when its policy
+ *   is changed or when the thread exits.  The reserved bandwidth is
+ *   released.  The priority of the thread is not changed.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sched_deadline_stop(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  flags = enter_critical_section();
+
+  wd_cancel(&dl->timer);
+  deadline_remove(dl);
+
+  g_deadline_bw -= dl->bandwidth;
+  g_deadline_ntasks--;
+
+  tcb->deadline  = NULL;
+  tcb->timeslice = 0;
+
+  /* The remaining deadline threads may move up in the band */
+
+  deadline_rerank();
+  leave_critical_section(flags);
+
+  sched_kfree(dl);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_process
+ *
+ * Description:
+ *   Charge the elapsed time interval against the budget of the running
+ *   deadline thread and throttle the thread if its budget is exhausted.
+ *   Called from the timer interrupt handler.
+ *
+ * Input Parameters:
+ *   tcb        - The TCB of the running deadline thread
+ *   ticks      - The number of elapsed ticks since the last time this
+ *                function was called.
+ *   noswitches - We are running in a context where context switching is
+ *                not permitted.
+ *
+ * Returned Value:
+ *   The number of ticks remaining in the budget of the current period.
+ *   Zero is returned if the thread is throttled.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The thread uses the deadline scheduling policy.
+ *
+ ****************************************************************************/
+
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches)
+{
+  FAR struct deadline_s *dl;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  dl = tcb->deadline;
+
+  if (dl->throttled)
+    {
+      return 0;
+    }
+
+  if (ticks < tcb->timeslice)
+    {
+      tcb->timeslice -= ticks;
+      return tcb->timeslice;
+    }
+
+  /* The budget is exhausted.  If the thread has the scheduler locked or if
+   * we cannot switch contexts now, then try again on the next tick.
+   */
+
+  if (sched_islocked(tcb) || noswitches)
+    {
+      tcb->timeslice = 1;
+      return 1;
+    }
+
+  /* Otherwise, throttle the thread until its next period */
+
+  tcb->timeslice = 0;
+  dl->throttled  = true;
+  deadline_rerank();
+  return 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -45,7 +45,6 @@
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/arch.h>
-#include <nuttx/wqueue.h>
 
 #include "sched/sched.h"
 
@@ -103,11 +102,9 @@ void sched_ufree(FAR void *address)
       sq_addlast((FAR sq_entry_t *)address,
                  (FAR sq_queue_t *)&g_delayed_kufree);
 
-      /* Signal the worker thread that is has some clean up to do */
+      /* Signal the thread that has some clean up to do */
 
-#ifdef CONFIG_SCHED_WORKQUEUE
-      work_signal(LPWORK);
-#endif
+      sched_garbage_signal();
       leave_critical_section(flags);
     }
   else
@@ -144,11 +141,9 @@ void sched_kfree(FAR void *address)
       sq_addlast((FAR sq_entry_t *)address,
                  (FAR sq_queue_t *)&g_delayed_kfree);
 
-      /* Signal the worker thread that is has some clean up to do */
+      /* Signal the thread that has some clean up to do */
 
-#ifdef CONFIG_SCHED_WORKQUEUE
-      work_signal(LPWORK);
-#endif
+      sched_garbage_signal();
       leave_critical_section(flags);
     }
   else
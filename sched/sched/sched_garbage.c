@@ -38,15 +38,116 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <queue.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_GARBAGE_BATCH
+#  define CONFIG_SCHED_GARBAGE_BATCH 0
+#endif
+
+#if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
+     defined(CONFIG_MM_KERNEL_HEAP)
+#  define HAVE_KGARBAGE 1
+#endif
+
+#ifndef CONFIG_BUILD_KERNEL
+#  define HAVE_KUGARBAGE 1
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+static struct garbage_stats_s g_garbage_stats;
+#endif
+
+#ifdef CONFIG_SCHED_GARBAGE_THREAD
+/* The garbage collection thread waits on this semaphore */
+
+static sem_t g_garbage_sem = SEM_INITIALIZER(0);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sched_garbage_detach
+ *
+ * Description:
+ *   Remove up to 'budget' deferred de-allocations from the head of 'queue'
+ *   and return them in 'batch'.  A budget of zero removes all of them.
+ *   Only the queue pointers are touched with interrupts disabled; the
+ *   de-allocations themselves are performed later by the caller.
+ *
+ * Input parameters:
+ *   queue  - The queue of delayed de-allocations
+ *   batch  - The list to receive the removed de-allocations
+ *   budget - The maximum number of de-allocations to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(HAVE_KGARBAGE) || defined(HAVE_KUGARBAGE)
+static void sched_garbage_detach(FAR volatile sq_queue_t *queue,
+                                 FAR sq_queue_t *batch,
+                                 unsigned int budget)
+{
+  FAR sq_entry_t *last;
+  irqstate_t flags;
+
+  sq_init(batch);
+
+  flags = enter_critical_section();
+  last  = queue->head;
+  if (last != NULL)
+    {
+      if (budget == 0)
+        {
+          last = queue->tail;
+        }
+      else
+        {
+          while (--budget > 0 && last->flink != NULL)
+            {
+              last = last->flink;
+            }
+        }
+
+      batch->head = queue->head;
+      batch->tail = last;
+
+      queue->head = last->flink;
+      if (queue->head == NULL)
+        {
+          queue->tail = NULL;
+        }
+
+      last->flink = NULL;
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: sched_kucleanup
  *
@@ -54,16 +155,17 @@
  *   Clean-up deferred de-allocations of user memory
  *
  * Input parameters:
- *   None
+ *   budget - The maximum number of de-allocations to perform (zero means
+ *            no limit)
  *
  * Returned Value:
- *   None
+ *   The number of de-allocations performed
  *
  ****************************************************************************/
 
-static inline void sched_kucleanup(void)
+static inline unsigned int sched_kucleanup(unsigned int budget)
 {
-#ifdef CONFIG_BUILD_KERNEL
+#ifndef HAVE_KUGARBAGE
   /* REVISIT:  It is not safe to defer user allocation in the kernel mode
    * build.  Why?  Because the correct user context will not be in place
    * when these deferred de-allocations are performed.  In order to make
@@ -72,35 +174,33 @@ static inline void sched_kucleanup(void)
    * collect garbage on a group-by-group basis.
    */
 
+  return 0;
+
 #else
-  irqstate_t flags;
   FAR void *address;
+  sq_queue_t batch;
+  unsigned int count = 0;
 
   /* Test if the delayed deallocation queue is empty.  No special protection
    * is needed because this is an atomic test.
    */
 
-  while (g_delayed_kufree.head)
+  if (g_delayed_kufree.head != NULL)
     {
-      /* Remove the first delayed deallocation.  This is not atomic and so
-       * we must disable interrupts around the queue operation.
-       */
+      /* Take a batch of delayed deallocations in one step */
 
-      flags = enter_critical_section();
-      address = (FAR void *)sq_remfirst((FAR sq_queue_t *)&g_delayed_kufree);
-      leave_critical_section(flags);
+      sched_garbage_detach(&g_delayed_kufree, &batch, budget);
 
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
+      /* Return the memory to the user heap */
 
-      if (address)
+      while ((address = (FAR void *)sq_remfirst(&batch)) != NULL)
         {
-          /* Return the memory to the user heap */
-
           kumm_free(address);
+          count++;
         }
     }
+
+  return count;
 #endif
 }
 
@@ -118,7 +218,7 @@ static inline void sched_kucleanup(void)
  *
  ****************************************************************************/
 
-#ifndef CONFIG_BUILD_KERNEL
+#ifdef HAVE_KUGARBAGE
 static inline bool sched_have_kugarbage(void)
 {
   return (g_delayed_kufree.head != NULL);
@@ -134,48 +234,44 @@ static inline bool sched_have_kugarbage(void)
  *   Clean-up deferred de-allocations of kernel memory
  *
  * Input parameters:
- *   None
+ *   budget - The maximum number of de-allocations to perform (zero means
+ *            no limit)
  *
  * Returned Value:
- *   None
+ *   The number of de-allocations performed
  *
  ****************************************************************************/
 
-#if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
-     defined(CONFIG_MM_KERNEL_HEAP)
-static inline void sched_kcleanup(void)
+#ifdef HAVE_KGARBAGE
+static inline unsigned int sched_kcleanup(unsigned int budget)
 {
-  irqstate_t flags;
   FAR void *address;
+  sq_queue_t batch;
+  unsigned int count = 0;
 
   /* Test if the delayed deallocation queue is empty.  No special protection
    * is needed because this is an atomic test.
    */
 
-  while (g_delayed_kfree.head)
+  if (g_delayed_kfree.head != NULL)
     {
-      /* Remove the first delayed deallocation.  This is not atomic and so
-       * we must disable interrupts around the queue operation.
-       */
+      /* Take a batch of delayed deallocations in one step */
 
-      flags = enter_critical_section();
-      address = (FAR void *)sq_remfirst((FAR sq_queue_t *)&g_delayed_kfree);
-      leave_critical_section(flags);
+      sched_garbage_detach(&g_delayed_kfree, &batch, budget);
 
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
+      /* Return the memory to the kernel heap */
 
-      if (address)
+      while ((address = (FAR void *)sq_remfirst(&batch)) != NULL)
         {
-          /* Return the memory to the kernel heap */
-
           kmm_free(address);
+          count++;
         }
     }
+
+  return count;
 }
 #else
-#  define sched_kcleanup()
+#  define sched_kcleanup(b) (0)
 #endif
 
 /****************************************************************************
@@ -192,8 +288,7 @@ static inline void sched_kcleanup(void)
  *
  ****************************************************************************/
 
-#if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
-     defined(CONFIG_MM_KERNEL_HEAP)
+#ifdef HAVE_KGARBAGE
 static inline bool sched_have_kgarbage(void)
 {
   return (g_delayed_kfree.head != NULL);
@@ -202,6 +297,32 @@ static inline bool sched_have_kgarbage(void)
 #  define sched_have_kgarbage() false
 #endif
 
+/****************************************************************************
+ * Name: sched_garbage_thread
+ *
+ * Description:
+ *   The dedicated garbage collection thread.  It sleeps until a
+ *   de-allocation is deferred, then collects until both queues are empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_THREAD
+static int sched_garbage_thread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      (void)sem_wait(&g_garbage_sem);
+
+      while (sched_have_garbage())
+        {
+          sched_garbage_collection();
+        }
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -218,7 +339,12 @@ static inline bool sched_have_kgarbage(void)
  *   If, however, CONFIG_SCHED_WORKQUEUE is not defined, then this logic will
  *   be called from the IDLE thread.  It is less optimal for the garbage
  *   collection to be called from the IDLE thread because it runs at a very
- *   low priority and could cause false memory out conditions.
+ *   low priority and could cause false memory out conditions.  If
+ *   CONFIG_SCHED_GARBAGE_THREAD is defined, then it is called only from the
+ *   dedicated garbage collection thread.
+ *
+ *   At most CONFIG_SCHED_GARBAGE_BATCH de-allocations are performed in one
+ *   call (if non-zero).  Any remaining garbage is collected on later calls.
  *
  * Input parameters:
  *   None
@@ -230,13 +356,38 @@ static inline bool sched_have_kgarbage(void)
 
 void sched_garbage_collection(void)
 {
+  unsigned int budget = CONFIG_SCHED_GARBAGE_BATCH;
+  unsigned int count;
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+  irqstate_t flags;
+#endif
+
   /* Handle deferred deallocations for the kernel heap */
 
-  sched_kcleanup();
+  count = sched_kcleanup(budget);
 
-  /* Handle deferred deallocations for the user heap */
+  /* Handle deferred deallocations for the user heap with whatever remains
+   * of the budget.
+   */
+
+  if (budget == 0)
+    {
+      count += sched_kucleanup(0);
+    }
+  else if (count < budget)
+    {
+      count += sched_kucleanup(budget - count);
+    }
 
-  sched_kucleanup();
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+  flags = enter_critical_section();
+  g_garbage_stats.passes++;
+  g_garbage_stats.collected += count;
+  g_garbage_stats.pending   -= count;
+  leave_critical_section(flags);
+#else
+  UNUSED(count);
+#endif
 }
 
 /****************************************************************************
@@ -266,3 +417,111 @@ bool sched_have_garbage(void)
 {
   return (sched_have_kgarbage() || sched_have_kugarbage());
 }
+
+/****************************************************************************
+ * Name: sched_garbage_signal
+ *
+ * Description:
+ *   Called by sched_ufree() and sched_kfree() each time that a
+ *   de-allocation is deferred.  Update the statistics and wake up the
+ *   thread that performs garbage collection.
+ *
+ * Input parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.  This may be called from interrupt
+ *   handlers.
+ *
+ ****************************************************************************/
+
+void sched_garbage_signal(void)
+{
+#ifdef CONFIG_SCHED_GARBAGE_THREAD
+  int semcount;
+#endif
+
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+  g_garbage_stats.deferred++;
+  if (++g_garbage_stats.pending > g_garbage_stats.maxpending)
+    {
+      g_garbage_stats.maxpending = g_garbage_stats.pending;
+    }
+#endif
+
+#if defined(CONFIG_SCHED_GARBAGE_THREAD)
+  /* Wake up the garbage collection thread if it is not already awake */
+
+  if (sem_getvalue(&g_garbage_sem, &semcount) == OK && semcount <= 0)
+    {
+      (void)sem_post(&g_garbage_sem);
+    }
+
+#elif defined(CONFIG_SCHED_WORKQUEUE)
+  /* Signal the worker thread that is has some clean up to do */
+
+  work_signal(LPWORK);
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_garbage_start
+ *
+ * Description:
+ *   Start the dedicated garbage collection thread.
+ *
+ * Input parameters:
+ *   None
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_THREAD
+int sched_garbage_start(void)
+{
+  int pid;
+
+  /* The garbage semaphore is used for signaling and, hence, should not
+   * have priority inheritance enabled.
+   */
+
+  (void)sem_setprotocol(&g_garbage_sem, SEM_PRIO_NONE);
+
+  pid = kernel_thread("garbage", CONFIG_SCHED_GARBAGE_PRIORITY,
+                      CONFIG_SCHED_GARBAGE_STACKSIZE,
+                      (main_t)sched_garbage_thread, (FAR char * const *)NULL);
+
+  DEBUGASSERT(pid > 0);
+  return pid < 0 ? -get_errno() : OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_garbage_stats
+ *
+ * Description:
+ *   Return a snapshot of the garbage collection statistics.
+ *
+ * Input parameters:
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GARBAGE_STATS
+void sched_garbage_stats(FAR struct garbage_stats_s *stats)
+{
+  irqstate_t flags;
+
+  flags  = enter_critical_section();
+  *stats = g_garbage_stats;
+  leave_critical_section(flags);
+}
+#endif
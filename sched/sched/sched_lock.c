@@ -91,22 +91,17 @@
  *    'lockcount' == 0. This might happen when sched_unlock() is called, or
  *    after a context switch that changes the TCB at the head of the
  *    g_assignedtasks[cpu] list.
- * 4. Modification of the global 'g_cpu_lockset' must be protected by a
- *    spinlock, 'g_cpu_schedlock'. That spinlock would be taken when
- *    sched_lock() is called, and released when sched_unlock() is called.
- *    This assures that the scheduler does enforce the critical section.
- *    NOTE: Because of this spinlock, there should never be more than one
- *    bit set in 'g_cpu_lockset'; attempts to set additional bits should
- *    be cause the CPU to block on the spinlock.  However, additional bits
- *    could get set in 'g_cpu_lockset' due to the context switches on the
- *    various CPUs.
- * 5. Each the time the head of a g_assignedtasks[] list changes and the
- *    scheduler modifies 'g_cpu_lockset', it must also set 'g_cpu_schedlock'
- *    depending on the new state of 'g_cpu_lockset'.
- * 5. Logic that currently uses the currently running tasks lockcount
- *    instead uses the global 'g_cpu_schedlock'. A value of SP_UNLOCKED
- *    means that no CPU has pre-emption disabled; SP_LOCKED means that at
- *    least one CPU has pre-emption disabled.
+ * 4. Modification of the global 'g_cpu_lockset' is protected by the
+ *    spinlock 'g_cpu_locksetlock'.  'g_cpu_schedlock' is SP_LOCKED while
+ *    any bit is set in 'g_cpu_lockset'; it is maintained only as a summary
+ *    for instrumentation.
+ * 5. Pre-emption locking is per-CPU:  A CPU with its bit set in
+ *    'g_cpu_lockset' will not be pre-empted, but the other CPUs continue to
+ *    schedule normally.  Tasks that become ready-to-run are placed on the
+ *    CPU running the lowest priority task among the CPUs that do not have
+ *    pre-emption disabled.  Only tasks that must run on a CPU with
+ *    pre-emption disabled are held in g_pendingtasks until that CPU calls
+ *    sched_unlock().  sched_cpu_locked() tests the state of one CPU.
  */
 
 volatile spinlock_t g_cpu_schedlock SP_SECTION = SP_UNLOCKED;
@@ -132,6 +127,9 @@ volatile cpu_set_t g_cpu_lockset SP_SECTION;
  *   either calls  sched_unlock() (the appropriate number of times) or
  *   until it blocks itself.
  *
+ *   In the SMP case, only context switches on the calling CPU are
+ *   disabled.  Tasks continue to be scheduled on the other CPUs.
+ *
  * Inputs
  *   None
  *
@@ -158,17 +156,15 @@ int sched_lock(void)
       DEBUGASSERT(rtcb->lockcount < MAX_LOCK_COUNT);
 
 #ifdef CONFIG_SMP
-      /* We must hold the lock on this CPU before we increment the lockcount
-       * for the first time. Holding the lock is sufficient to lockout context
-       * switching.
+      /* Mark this CPU as having pre-emption disabled before we increment
+       * the lockcount for the first time.  This locks out context switching
+       * on this CPU only; the other CPUs continue to schedule normally.
        */
 
       if (rtcb->lockcount == 0)
         {
-          /* We don't have the scheduler locked.  But logic running on a
-           * different CPU may have the scheduler locked.  It is not
-           * possible for some other task on this CPU to have the scheduler
-           * locked (or we would not be executing!).
+          /* It is not possible for some other task on this CPU to have the
+           * scheduler locked (or we would not be executing!).
            */
 
           spin_setbit(&g_cpu_lockset, this_cpu(), &g_cpu_locksetlock,
@@ -177,12 +173,10 @@ int sched_lock(void)
       else
         {
           /* If this thread already has the scheduler locked, then
-           * g_cpu_schedlock() should indicate that the scheduler is locked
-           * and g_cpu_lockset should include the bit setting for this CPU.
+           * g_cpu_lockset should include the bit setting for this CPU.
            */
 
-          DEBUGASSERT(g_cpu_schedlock == SP_LOCKED &&
-                      (g_cpu_lockset & (1 << this_cpu())) != 0);
+          DEBUGASSERT(sched_cpu_locked(this_cpu()));
         }
 #endif
 
@@ -204,15 +198,13 @@ int sched_lock(void)
         }
 #endif
 
-#ifdef CONFIG_SMP
-      /* Move any tasks in the ready-to-run list to the pending task list
-       * where they will not be available to run until the scheduler is
-       * unlocked and sched_mergepending() is called.
-       */
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start the timing if we just acquired the lock */
 
-      sched_mergeprioritized((FAR dq_queue_t *)&g_readytorun,
-                             (FAR dq_queue_t *)&g_pendingtasks,
-                             TSTATE_TASK_PENDING);
+      if (rtcb->lockcount == 1)
+        {
+          sched_critmon_preemption(rtcb, true, __builtin_return_address(0));
+        }
 #endif
     }
 
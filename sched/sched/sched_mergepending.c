@@ -51,12 +51,6 @@
 #include "irq/irq.h"
 #include "sched/sched.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#define ALL_CPUS ((cpu_set_t)-1)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -89,13 +83,17 @@ bool sched_mergepending(void)
 {
   FAR struct tcb_s *ptcb;
   FAR struct tcb_s *pnext;
+#ifndef CONFIG_SCHED_PRIORITY_BITMAP
   FAR struct tcb_s *rtcb;
   FAR struct tcb_s *rprev;
+#endif
   bool ret = false;
 
+#ifndef CONFIG_SCHED_PRIORITY_BITMAP
   /* Initialize the inner search loop */
 
   rtcb = this_task();
+#endif
 
   /* Process every TCB in the g_pendingtasks list */
 
@@ -105,6 +103,24 @@ bool sched_mergepending(void)
     {
       pnext = ptcb->flink;
 
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+      /* The priority index of the ready-to-run list gives the insertion
+       * point directly.
+       */
+
+      if (sched_addprioritized(ptcb, (FAR dq_queue_t *)&g_readytorun))
+        {
+          /* Special case: ptcb was inserted at the head of the list */
+
+          ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+          ptcb->task_state        = TSTATE_TASK_RUNNING;
+          ret                     = true;
+        }
+      else
+        {
+          ptcb->task_state        = TSTATE_TASK_READYTORUN;
+        }
+#else
       /* REVISIT:  Why don't we just remove the ptcb from pending task list
        * and call sched_addreadytorun?
        */
@@ -155,6 +171,7 @@ bool sched_mergepending(void)
       /* Set up for the next time through */
 
       rtcb = ptcb;
+#endif
     }
 
   /* Mark the input list empty */
@@ -201,12 +218,11 @@ bool sched_mergepending(void)
 
   /* Remove and process every TCB in the g_pendingtasks list.
    *
-   * Do nothing if (1) pre-emption is still disabled (by any CPU), or (2) if
-   * some CPU other than this one is in a critical section.
+   * Do nothing if some CPU other than this one is in a critical section.
    */
 
   me = this_cpu();
-  if (!spin_islocked(&g_cpu_schedlock) && !irq_cpu_locked(me))
+  if (!irq_cpu_locked(me))
     {
       /* Find the CPU that is executing the lowest priority task */
 
@@ -218,7 +234,7 @@ bool sched_mergepending(void)
           return ret;
         }
 
-      cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+      cpu  = sched_cpu_select(ptcb->affinity, ptcb->cpu);
       rtcb = current_task(cpu);
 
       /* Loop while there is a higher priority task in the pending task list
@@ -232,6 +248,17 @@ bool sched_mergepending(void)
 
       while (ptcb->sched_priority > rtcb->sched_priority)
         {
+          /* sched_cpu_select() returns a CPU with pre-emption disabled only
+           * if there is no other choice.  In that case, leave this task and
+           * all lower priority tasks in the pending task list.  They will be
+           * merged again when pre-emption is re-enabled on that CPU.
+           */
+
+          if (sched_cpu_locked(cpu))
+            {
+              return ret;
+            }
+
           /* Remove the task from the pending task list */
 
           tcb = (FAR struct tcb_s *)dq_remfirst((FAR dq_queue_t *)&g_pendingtasks);
@@ -241,11 +268,21 @@ bool sched_mergepending(void)
 
           ret |= sched_addreadytorun(tcb);
 
-          /* This operation could cause the scheduler to become locked.
-           * Check if that happened.
+          /* The task is returned to the pending task list if it may only
+           * run on a CPU with pre-emption disabled.  Leave it there with the
+           * remaining, lower priority tasks.
+           */
+
+          if (tcb->task_state == TSTATE_TASK_PENDING)
+            {
+              return ret;
+            }
+
+          /* This operation could cause some other CPU to enter a critical
+           * section.  Check if that happened.
            */
 
-          if (spin_islocked(&g_cpu_schedlock) || irq_cpu_locked(me))
+          if (irq_cpu_locked(me))
             {
               /* Yes.. then we may have incorrectly placed some TCBs in the
                * g_readytorun list (unlikely, but possible).  We will have to
@@ -273,7 +310,7 @@ bool sched_mergepending(void)
               return ret;
             }
 
-          cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+          cpu  = sched_cpu_select(ptcb->affinity, ptcb->cpu);
           rtcb = current_task(cpu);
         }
 
@@ -39,11 +39,14 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
@@ -57,6 +60,23 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+#  ifdef CONFIG_SMP
+#    define NOTE_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define NOTE_NCPUS 1
+#  endif
+
+/* The memory barriers come from arch/spinlock.h.  Without spinlock support
+ * there is only one CPU and no barriers are needed.
+ */
+
+#  ifndef CONFIG_SPINLOCK
+#    define SP_DMB()
+#    define SP_DSB()
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,6 +85,9 @@ struct note_info_s
 {
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+  volatile unsigned long ni_dropped;
+#endif
   uint8_t ni_buffer[CONFIG_SCHED_NOTE_BUFSIZE];
 };
 
@@ -92,7 +115,21 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen);
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+/* In the per-CPU case, the head index of each buffer is written only by the
+ * owning CPU and the tail index only by the reader.
+ */
+
+static struct note_info_s g_note_info[NOTE_NCPUS];
+
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SMP)
+/* Serializes readers that merge the notes of all CPUs */
+
+static volatile spinlock_t g_note_readlock = SP_UNLOCKED;
+#endif
+#else
 static struct note_info_s g_note_info;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -144,7 +181,22 @@ static inline unsigned int note_next(unsigned int ndx, unsigned int offset)
 static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
                         uint8_t length, uint8_t type)
 {
+#if defined(CONFIG_SCHED_NOTE_PERFCOUNT)
+  /* Get the time in counts of the free-running performance counter */
+
+  uint32_t systime    = up_perf_gettime();
+#elif defined(CONFIG_SCHED_NOTE_HIRES)
+  struct timespec ts;
+  uint32_t systime;
+
+  /* Get the time in microseconds from the high resolution timer */
+
+  (void)up_timer_gettime(&ts);
+  systime = (uint32_t)ts.tv_sec * USEC_PER_SEC +
+            (uint32_t)(ts.tv_nsec / NSEC_PER_USEC);
+#else
   uint32_t systime    = (uint32_t)clock_systimer();
+#endif
 
   /* Save all of the common fields */
 
@@ -198,6 +250,236 @@ void note_spincommon(FAR struct tcb_s *tcb, FAR volatile spinlock_t *spinlock,
 }
 #endif
 
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+/****************************************************************************
+ * Name: note_length
+ *
+ * Description:
+ *   Length of data currently in the circular buffer of one CPU.
+ *
+ * Input Parameters:
+ *   head - The head index of the circular buffer
+ *   tail - The tail index of the circular buffer
+ *
+ * Returned Value:
+ *   Length of data currently in circular buffer.
+ *
+ ****************************************************************************/
+
+static inline unsigned int note_length(unsigned int head, unsigned int tail)
+{
+  if (tail > head)
+    {
+      head += CONFIG_SCHED_NOTE_BUFSIZE;
+    }
+
+  return head - tail;
+}
+
+/****************************************************************************
+ * Name: note_add
+ *
+ * Description:
+ *   Add the variable length note to the head of the circular buffer of the
+ *   current CPU.  The note is dropped if there is not room for it.
+ *
+ * Input Parameters:
+ *   note    - The formatted note
+ *   notelen - The length of the note
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   This may be called from any context.  No lock is taken:  Only the
+ *   current CPU modifies the head index of its buffer and local interrupts
+ *   are disabled while the note is added.
+ *
+ ****************************************************************************/
+
+static void note_add(FAR const uint8_t *note, uint8_t notelen)
+{
+  FAR struct note_info_s *info;
+  irqstate_t flags;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int first;
+  int cpu;
+
+  DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
+
+  /* Disable local interrupts so that the note cannot be interleaved with
+   * a note from an interrupt handler on this CPU.
+   */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+#ifdef CONFIG_SMP
+  /* Ignore notes that are not in the set of monitored CPUs */
+
+  if ((CONFIG_SCHED_INSTRUMENTATION_CPUSET & (1 << cpu)) == 0)
+    {
+      /* Not in the set of monitored CPUs.  Do not log the note. */
+
+      up_irq_restore(flags);
+      return;
+    }
+#endif
+
+  info = &g_note_info[cpu];
+  head = info->ni_head;
+  tail = info->ni_tail;
+
+  /* Is there space for the note?  One byte is always left unused so that
+   * a full buffer can be distinguished from an empty one.
+   */
+
+  if (note_length(head, tail) + notelen >= CONFIG_SCHED_NOTE_BUFSIZE)
+    {
+      /* No.. drop the note rather than overwriting data that the reader
+       * may be accessing.
+       */
+
+      info->ni_dropped++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  /* Copy the note, wrapping to the beginning of the buffer if necessary */
+
+  first = CONFIG_SCHED_NOTE_BUFSIZE - head;
+  if (first >= notelen)
+    {
+      memcpy(&info->ni_buffer[head], note, notelen);
+    }
+  else
+    {
+      memcpy(&info->ni_buffer[head], note, first);
+      memcpy(info->ni_buffer, note + first, notelen - first);
+    }
+
+  /* Make the note visible to the reader only after it has been written */
+
+  SP_DMB();
+  info->ni_head = note_next(head, notelen);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: note_getbyte
+ *
+ * Description:
+ *   Get a byte of the note at the tail of a circular buffer, handling
+ *   wraparound
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_GET
+static inline uint8_t note_getbyte(FAR struct note_info_s *info,
+                                   unsigned int tail, unsigned int offset)
+{
+  return info->ni_buffer[note_next(tail, offset)];
+}
+
+/****************************************************************************
+ * Name: note_oldest
+ *
+ * Description:
+ *   Find the CPU whose buffer holds the note with the oldest timestamp.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The index of the CPU or -1 if all buffers are empty.
+ *
+ * Assumptions:
+ *   The caller holds the reader lock.
+ *
+ ****************************************************************************/
+
+static int note_oldest(void)
+{
+  FAR struct note_info_s *info;
+  unsigned int tail;
+  uint32_t systime;
+  uint32_t oldest = 0;
+  int ret = -1;
+  int cpu;
+  int i;
+
+  for (cpu = 0; cpu < NOTE_NCPUS; cpu++)
+    {
+      info = &g_note_info[cpu];
+      tail = info->ni_tail;
+
+      if (info->ni_head == tail)
+        {
+          continue;
+        }
+
+      /* Make sure that the note is read only after the head index */
+
+      SP_DMB();
+
+      /* Get the timestamp of the note at the tail (little endian) */
+
+      systime = 0;
+      for (i = 3; i >= 0; i--)
+        {
+          systime = (systime << 8) |
+                    note_getbyte(info, tail,
+                                 offsetof(struct note_common_s, nc_systime) + i);
+        }
+
+      if (ret < 0 || (int32_t)(systime - oldest) < 0)
+        {
+          oldest = systime;
+          ret    = cpu;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: note_readlock and note_readunlock
+ *
+ * Description:
+ *   Serialize readers.  This does not block the CPUs that are adding
+ *   notes.  A raw test-and-set is used in the SMP case so that taking the
+ *   lock does not itself generate spinlock notes.
+ *
+ ****************************************************************************/
+
+static inline void note_readlock(void)
+{
+#ifdef CONFIG_SMP
+  while (up_testset(&g_note_readlock) == SP_LOCKED)
+    {
+      SP_DSB();
+    }
+
+  SP_DMB();
+#else
+  sched_lock();
+#endif
+}
+
+static inline void note_readunlock(void)
+{
+#ifdef CONFIG_SMP
+  SP_DMB();
+  g_note_readlock = SP_UNLOCKED;
+  SP_DSB();
+#else
+  sched_unlock();
+#endif
+}
+#endif /* CONFIG_SCHED_NOTE_GET */
+
+#else /* CONFIG_SCHED_NOTE_PERCPU */
 /****************************************************************************
  * Name: note_length
  *
@@ -347,6 +629,8 @@ static void note_add(FAR const uint8_t *note, uint8_t notelen)
   g_note_info.ni_head = head;
 }
 
+#endif /* CONFIG_SCHED_NOTE_PERCPU */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -606,7 +890,70 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_NOTE_GET
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SCHED_NOTE_PERCPU)
+ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct note_info_s *info;
+  unsigned int tail;
+  unsigned int first;
+  ssize_t notelen;
+  int cpu;
+
+  DEBUGASSERT(buffer != NULL);
+  note_readlock();
+
+  /* Get the buffer holding the oldest note */
+
+  cpu = note_oldest();
+  if (cpu < 0)
+    {
+      notelen = 0;
+      goto errout_with_lock;
+    }
+
+  info    = &g_note_info[cpu];
+  tail    = info->ni_tail;
+  notelen = note_getbyte(info, tail, 0);
+  DEBUGASSERT(notelen <= note_length(info->ni_head, tail));
+
+  /* Is the user buffer large enough to hold the note? */
+
+  if (buflen < notelen)
+    {
+      /* Remove the large note so that we do not get constipated and
+       * return an error.
+       */
+
+      SP_DMB();
+      info->ni_tail = note_next(tail, notelen);
+      notelen       = -EFBIG;
+      goto errout_with_lock;
+    }
+
+  /* Copy the note, handling wraparound */
+
+  first = CONFIG_SCHED_NOTE_BUFSIZE - tail;
+  if (first >= notelen)
+    {
+      memcpy(buffer, &info->ni_buffer[tail], notelen);
+    }
+  else
+    {
+      memcpy(buffer, &info->ni_buffer[tail], first);
+      memcpy(buffer + first, info->ni_buffer, notelen - first);
+    }
+
+  /* Release the space only after the note has been copied */
+
+  SP_DMB();
+  info->ni_tail = note_next(tail, notelen);
+
+errout_with_lock:
+  note_readunlock();
+  return notelen;
+}
+
+#elif defined(CONFIG_SCHED_NOTE_GET)
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
   FAR struct note_common_s *note;
@@ -691,7 +1038,25 @@ errout_with_csection:
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_NOTE_GET
+#if defined(CONFIG_SCHED_NOTE_GET) && defined(CONFIG_SCHED_NOTE_PERCPU)
+ssize_t sched_note_size(void)
+{
+  ssize_t notelen = 0;
+  int cpu;
+
+  note_readlock();
+
+  cpu = note_oldest();
+  if (cpu >= 0)
+    {
+      notelen = note_getbyte(&g_note_info[cpu], g_note_info[cpu].ni_tail, 0);
+    }
+
+  note_readunlock();
+  return notelen;
+}
+
+#elif defined(CONFIG_SCHED_NOTE_GET)
 ssize_t sched_note_size(void)
 {
   FAR struct note_common_s *note;
@@ -728,4 +1093,111 @@ errout_with_csection:
 }
 #endif
 
+/****************************************************************************
+ * Name: sched_note_peek
+ *
+ * Description:
+ *   Return the oldest data in the note buffer of one CPU without removing
+ *   it.  The returned region is contiguous in memory and holds complete
+ *   notes, except that a note may continue at the beginning of the buffer
+ *   if the region ends at the end of the buffer.  The data remains valid
+ *   until it is released with sched_note_release().
+ *
+ *   Only a single reader may use this interface for a given CPU.
+ *
+ * Input Parameters:
+ *   cpu  - The CPU whose note buffer is to be read
+ *   data - Location to return the address of the oldest data
+ *
+ * Returned Value:
+ *   The number of contiguous bytes available at 'data'.  Zero is returned
+ *   if the buffer is empty.  A negated errno value is returned if 'cpu' is
+ *   not valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_NOTE_PERCPU
+ssize_t sched_note_peek(int cpu, FAR const uint8_t **data)
+{
+  FAR struct note_info_s *info;
+  unsigned int head;
+  unsigned int tail;
+
+  DEBUGASSERT(data != NULL);
+  if (cpu < 0 || cpu >= NOTE_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  info  = &g_note_info[cpu];
+  head  = info->ni_head;
+  tail  = info->ni_tail;
+
+  /* Make sure that the data is read only after the head index */
+
+  SP_DMB();
+
+  *data = &info->ni_buffer[tail];
+  return head >= tail ? head - tail : CONFIG_SCHED_NOTE_BUFSIZE - tail;
+}
+
+/****************************************************************************
+ * Name: sched_note_release
+ *
+ * Description:
+ *   Remove data returned by sched_note_peek() from the note buffer of one
+ *   CPU making room for further notes.
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose note buffer was read
+ *   len - The number of bytes to remove (no more than were returned by
+ *         sched_note_peek())
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_note_release(int cpu, size_t len)
+{
+  FAR struct note_info_s *info;
+
+  DEBUGASSERT(cpu >= 0 && cpu < NOTE_NCPUS);
+
+  info = &g_note_info[cpu];
+  DEBUGASSERT(len <= note_length(info->ni_head, info->ni_tail));
+
+  /* Release the space only after the data has been consumed */
+
+  SP_DMB();
+  info->ni_tail = note_next(info->ni_tail, len);
+}
+
+/****************************************************************************
+ * Name: sched_note_dropped
+ *
+ * Description:
+ *   Return the number of notes that were lost because the note buffer of
+ *   one CPU was full.
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose note buffer is queried
+ *
+ * Returned Value:
+ *   The number of notes dropped since initialization (zero if 'cpu' is
+ *   not valid).
+ *
+ ****************************************************************************/
+
+unsigned long sched_note_dropped(int cpu)
+{
+  if (cpu < 0 || cpu >= NOTE_NCPUS)
+    {
+      return 0;
+    }
+
+  return g_note_info[cpu].ni_dropped;
+}
+#endif /* CONFIG_SCHED_NOTE_PERCPU */
+
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
@@ -69,7 +69,8 @@
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void sched_cpu_scheduler(int cpu)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
@@ -99,6 +100,17 @@ static inline void sched_cpu_scheduler(int cpu)
       (void)sched_sporadic_process(rtcb, 1, false);
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the tick against its budget. */
+
+      (void)sched_deadline_process(rtcb, 1, false);
+    }
+#endif
 }
 #endif
 
@@ -117,7 +129,8 @@ static inline void sched_cpu_scheduler(int cpu)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void sched_process_scheduler(void)
 {
 #ifdef CONFIG_SMP
@@ -213,6 +226,12 @@ void sched_process_timer(void)
     }
 #endif
 
+  /* Bring the run time of the running thread(s) up to date so that the
+   * free-running counter cannot wrap unnoticed.
+   */
+
+  sched_runtime_tick();
+
   /* Process watchdogs */
 
   wd_timer();
@@ -49,6 +49,7 @@
 #include "sched/sched.h"
 #include "group/group.h"
 #include "timer/timer.h"
+#include "pthread/pthread.h"
 
 /****************************************************************************
  * Private Functions
@@ -112,6 +113,10 @@ static void sched_releasepid(pid_t pid)
 
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 {
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+  FAR void *stack = NULL;
+  size_t stacksize = 0;
+#endif
   int ret = OK;
 
   if (tcb)
@@ -146,6 +151,20 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->stack_alloc_ptr)
         {
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+          /* Keep the stack of a pthread so that it can be cached together
+           * with the TCB below.  The architecture still releases any other
+           * stack-related resources.
+           */
+
+          if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+            {
+              stack                = tcb->stack_alloc_ptr;
+              stacksize            = tcb->adj_stack_size;
+              tcb->stack_alloc_ptr = NULL;
+            }
+
+#endif
 #ifdef CONFIG_BUILD_KERNEL
           /* If the exiting thread is not a kernel thread, then it has an
            * address environment.  Don't bother to release the stack memory
@@ -198,6 +217,23 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
       group_leave(tcb);
 #endif
 
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+      /* Put the pthread TCB and its stack in the cache if there is room */
+
+      if (stack != NULL)
+        {
+          tcb->stack_alloc_ptr = stack;
+          tcb->adj_stack_size  = stacksize;
+
+          if (pthread_tcb_recycle((FAR struct pthread_tcb_s *)tcb))
+            {
+              return ret;
+            }
+
+          sched_ufree(stack);
+        }
+
+#endif
       /* And, finally, release the TCB itself */
 
       sched_kfree(tcb);
@@ -100,7 +100,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  sched_remprioritized(rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -198,12 +198,14 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * g_readytorun list.  We can only select a task from that list if
        * the affinity mask includes the current CPU.
        *
-       * If pre-emption is locked or another CPU is in a critical section,
-       * then use the 'nxttcb' which will probably be the IDLE thread.
+       * If another CPU is in a critical section, then use the 'nxttcb'
+       * which will probably be the IDLE thread.  Pre-emption locks held on
+       * other CPUs do not matter and any lock held on this CPU belongs to
+       * the task that is leaving it.
        * REVISIT: What if it is not the IDLE thread?
        */
 
-      if (!spin_islocked(&g_cpu_schedlock) && !irq_cpu_locked(me))
+      if (!irq_cpu_locked(me))
         {
           /* Search for the highest priority task that can run on this
            * CPU.
@@ -237,6 +239,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
 
           dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
 
+          sched_count_migration(tmptcb, cpu);
           tmptcb->cpu = cpu;
           nxttcb = tmptcb;
         }
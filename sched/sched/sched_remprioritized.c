@@ -0,0 +1,108 @@
+/****************************************************************************
+ * sched/sched/sched_remprioritized.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_remprioritized
+ *
+ * Description:
+ *  This function removes a TCB from a prioritized TCB list.  If the list
+ *  is the g_readytorun list, then its priority index is updated as well.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove from the prioritized list
+ *   list - Points to the prioritized list that holds tcb
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The priority of the TCB has not been changed since it was added to
+ *   the list.
+ *
+ ****************************************************************************/
+
+void sched_remprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct tcb_s *prev;
+  uint8_t sched_priority;
+
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      /* If this TCB is the last one of its priority, then the previous TCB
+       * becomes the last one.  If there is no other TCB of this priority,
+       * the priority is no longer present in the list.
+       */
+
+      sched_priority = tcb->sched_priority;
+      if (g_readytorun_priotail[sched_priority] == tcb)
+        {
+          prev = tcb->blink;
+          if (prev != NULL && prev->sched_priority == sched_priority)
+            {
+              g_readytorun_priotail[sched_priority] = prev;
+            }
+          else
+            {
+              g_readytorun_priotail[sched_priority] = NULL;
+              g_readytorun_prioset[sched_priority >> 5] &=
+                ~((uint32_t)1 << (sched_priority & 31));
+            }
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_PRIORITY_BITMAP */
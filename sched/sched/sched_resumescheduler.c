@@ -48,7 +48,8 @@
 #include "sched/sched.h"
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
-    defined(CONFIG_SCHED_INSTRUMENTATION)
+    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SCHED_RUNTIME) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Functions
@@ -95,6 +96,31 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+  /* In the tickless mode, make sure that the timer will expire by the end
+   * of the time slice or budget of the thread, whichever CPU it runs on.
+   */
+
+  if (tcb->timeslice > 0 &&
+      ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_RR ||
+       (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC))
+    {
+      sched_timer_timeslice(tcb->timeslice);
+    }
+#endif
+
+#ifdef CONFIG_SCHED_RUNTIME
+  /* Count the context switch */
+
+  sched_runtime_resume(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Restart the timing of any section held by the thread */
+
+  sched_critmon_resume(tcb);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   /* Inidicate the task has been resumed */
 
@@ -104,4 +130,5 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
 }
 
 #endif /* CONFIG_RR_INTERVAL > 0 || CONFIG_SCHED_SPORADIC || \
-        * CONFIG_SCHED_INSTRUMENTATION */
+        * CONFIG_SCHED_INSTRUMENTATION || CONFIG_SCHED_RUNTIME || \
+        * CONFIG_SCHED_CRITMONITOR */
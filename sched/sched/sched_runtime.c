@@ -0,0 +1,344 @@
+/****************************************************************************
+ * sched/sched/sched_runtime.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_RUNTIME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The IDLE thread of each CPU has a task ID equal to the CPU index */
+
+#ifdef CONFIG_SMP
+#  define RUNTIME_NCPUS        CONFIG_SMP_NCPUS
+#  define runtime_cpu(t)       ((int)(t)->cpu)
+#  define runtime_isidle(t)    ((t)->pid < CONFIG_SMP_NCPUS)
+#else
+#  define RUNTIME_NCPUS        1
+#  define runtime_cpu(t)       (0)
+#  define runtime_isidle(t)    ((t)->pid == 0)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Run time accounting state of one CPU */
+
+struct runtime_cpu_s
+{
+  uint64_t busy;     /* Counts charged to threads other than IDLE */
+  uint64_t idle;     /* Counts charged to the IDLE thread */
+  uint32_t start;    /* Counter value at the last charge */
+  uint32_t switches; /* Number of context switches */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct runtime_cpu_s g_cpu_runtime[RUNTIME_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_runtime_charge
+ *
+ * Description:
+ *   Charge the counts elapsed since the last charge on this CPU to the
+ *   thread that is running on the CPU.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled (and, in the SMP case, within a
+ *   critical section).
+ *
+ ****************************************************************************/
+
+static void sched_runtime_charge(FAR struct tcb_s *tcb, int cpu,
+                                 uint32_t now)
+{
+  FAR struct runtime_cpu_s *rt = &g_cpu_runtime[cpu];
+  uint32_t elapsed;
+
+  /* Unsigned arithmetic handles one wrap of the counter */
+
+  elapsed   = now - rt->start;
+  rt->start = now;
+
+  tcb->run_time += elapsed;
+  if (runtime_isidle(tcb))
+    {
+      rt->idle += elapsed;
+    }
+  else
+    {
+      rt->busy += elapsed;
+    }
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  /* The same counts are the CPU load of the thread */
+
+  sched_cpuload_charge(tcb, cpu, elapsed);
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_runtime_usec
+ *
+ * Description:
+ *   Convert a count of the free-running counter to microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t sched_runtime_usec(uint64_t counts)
+{
+  uint32_t freq = up_perf_getfreq();
+
+  if (freq == 0)
+    {
+      return 0;
+    }
+
+  return (counts / freq) * USEC_PER_SEC +
+         ((counts % freq) * USEC_PER_SEC) / freq;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_runtime_suspend
+ *
+ * Description:
+ *   Called from sched_suspend_scheduler() when a thread is about to be
+ *   suspended.  The time since the thread was resumed (or since the last
+ *   tick) is charged to the thread.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being suspended.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_runtime_suspend(FAR struct tcb_s *tcb)
+{
+  sched_runtime_charge(tcb, runtime_cpu(tcb), up_perf_gettime());
+}
+
+/****************************************************************************
+ * Name: sched_runtime_resume
+ *
+ * Description:
+ *   Called from sched_resume_scheduler() when a thread is about to be
+ *   restarted.  The time spent in the context switch itself will be
+ *   charged to the restarted thread.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is being restarted.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_runtime_resume(FAR struct tcb_s *tcb)
+{
+  tcb->run_count++;
+  g_cpu_runtime[runtime_cpu(tcb)].switches++;
+}
+
+/****************************************************************************
+ * Name: sched_runtime_tick
+ *
+ * Description:
+ *   Called from the timer interrupt handling.  The elapsed time is charged
+ *   to the running thread of each CPU so that no interval exceeds the
+ *   period of the 32-bit free-running counter.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_runtime_tick(void)
+{
+  uint32_t now = up_perf_gettime();
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+  int cpu;
+
+  flags = enter_critical_section();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      sched_runtime_charge(current_task(cpu), cpu, now);
+    }
+
+  leave_critical_section(flags);
+#else
+  sched_runtime_charge(this_task(), 0, now);
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_runtime
+ *
+ * Description:
+ *   Return the precise run time of a thread.
+ *
+ * Input Parameters:
+ *   pid     - The task ID of the thread of interest
+ *   runtime - The location to return the run time
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ESRCH is returned if there is no
+ *   thread with this task ID.
+ *
+ ****************************************************************************/
+
+int sched_runtime(pid_t pid, FAR struct sched_runtime_s *runtime)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t counts;
+
+  flags = enter_critical_section();
+
+  tcb = sched_gettcb(pid);
+  if (tcb == NULL)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  /* Include the interval in progress if the thread is running */
+
+  counts = tcb->run_time;
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      counts += up_perf_gettime() - g_cpu_runtime[runtime_cpu(tcb)].start;
+    }
+
+  runtime->switches = tcb->run_count;
+  leave_critical_section(flags);
+
+  runtime->usecs = sched_runtime_usec(counts);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_cpustat
+ *
+ * Description:
+ *   Return the run time statistics of one CPU.
+ *
+ * Input Parameters:
+ *   cpu   - The index of the CPU of interest
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if the CPU index
+ *   is not valid.
+ *
+ ****************************************************************************/
+
+int sched_cpustat(int cpu, FAR struct sched_cpustat_s *stats)
+{
+  FAR struct runtime_cpu_s *rt;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t busy;
+  uint64_t idle;
+  uint32_t elapsed;
+
+  if (cpu < 0 || cpu >= RUNTIME_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  rt    = &g_cpu_runtime[cpu];
+  flags = enter_critical_section();
+
+  /* Include the interval in progress */
+
+  tcb     = current_task(cpu);
+  elapsed = up_perf_gettime() - rt->start;
+  busy    = rt->busy;
+  idle    = rt->idle;
+
+  if (runtime_isidle(tcb))
+    {
+      idle += elapsed;
+    }
+  else
+    {
+      busy += elapsed;
+    }
+
+  stats->switches = rt->switches;
+  leave_critical_section(flags);
+
+  stats->busy = sched_runtime_usec(busy);
+  stats->idle = sched_runtime_usec(idle);
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_RUNTIME */
@@ -215,6 +215,25 @@ int sched_setparam(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* The priority of a deadline thread follows from its deadline.  Update
+   * the deadline parameters instead.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      ret = sched_deadline_start(tcb, param);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_lock;
+        }
+
+      sched_unlock();
+      return OK;
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = sched_reprioritize(tcb, param->sched_priority);
@@ -48,6 +48,7 @@
 
 #include "irq/irq.h"
 #include "sched/sched.h"
+#include "semaphore/semaphore.h"
 
 /****************************************************************************
  * Private Functions
@@ -79,11 +80,11 @@ static FAR struct tcb_s *sched_nexttcb(FAR struct tcb_s *tcb)
    * only select a task from that list if the affinity mask includes the
    * current CPU.
    *
-   * If pre-emption is locked or another CPU is in a critical section,
-   * then use the 'nxttcb' which will probably be the IDLE thread.
+   * If pre-emption is locked on this CPU or another CPU is in a critical
+   * section, then use the 'nxttcb' which will probably be the IDLE thread.
    */
 
-  if (!spin_islocked(&g_cpu_schedlock) && !irq_cpu_locked(cpu))
+  if (!sched_cpu_locked(cpu) && !irq_cpu_locked(cpu))
     {
       /* Search for the highest priority task that can run on this CPU. */
 
@@ -164,9 +165,20 @@ static inline void sched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_PRIORITY_BITMAP
+      /* Change the task priority, keeping the priority index of the
+       * ready-to-run list up to date.  The task remains at the head of the
+       * list.
+       */
+
+      sched_remprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      (void)sched_addprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -202,7 +214,7 @@ static void sched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   if (tcb->task_state == TSTATE_TASK_READYTORUN)
     {
-      cpu = sched_cpu_select(tcb->affinity);
+      cpu = sched_cpu_select(tcb->affinity, tcb->cpu);
     }
 
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
@@ -308,6 +320,18 @@ static inline void sched_blocked_setpriority(FAR struct tcb_s *tcb,
 
       tcb->sched_priority = (uint8_t)sched_priority;
     }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the task is waiting for a semaphore, then it must also be
+   * repositioned among the waiters of the semaphore and the priority of
+   * the holders of the semaphore may need to change as well.
+   */
+
+  if (task_state == TSTATE_WAIT_SEM)
+    {
+      sem_requeuewaiter(tcb);
+    }
+#endif
 }
 
 /****************************************************************************
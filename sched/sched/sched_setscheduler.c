@@ -70,7 +70,9 @@
  *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
- *      through SCHED_PRIORITY_MAX.
+ *      through SCHED_PRIORITY_MAX.  For SCHED_DEADLINE, the priority is
+ *      ignored and the members sched_dl_runtime, sched_dl_deadline and
+ *      sched_dl_period provide the deadline parameters instead.
  *
  * Return Value:
  *   On success, sched_setscheduler() returns OK (zero).  On error, ERROR
@@ -78,6 +80,8 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE only:  The deadline parameters could not be
+ *          admitted.
  *
  * Assumptions:
  *
@@ -88,7 +92,8 @@ int sched_setscheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
+  uint16_t oldpolicy;
   int errcode;
 #endif
   int ret;
@@ -101,6 +106,9 @@ int sched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -133,6 +141,19 @@ int sched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
+  oldpolicy   = tcb->flags & TCB_FLAG_POLICY_MASK;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release the bandwidth of any on-going deadline scheduling */
+
+  if (oldpolicy == TCB_FLAG_SCHED_DEADLINE && policy != SCHED_DEADLINE)
+    {
+      DEBUGVERIFY(sched_deadline_stop(tcb));
+    }
+#endif
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -143,7 +164,7 @@ int sched_setscheduler(pid_t pid, int policy,
 #ifdef CONFIG_SCHED_SPORADIC
           /* Cancel any on-going sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               DEBUGVERIFY(sched_sporadic_stop(tcb));
             }
@@ -151,7 +172,8 @@ int sched_setscheduler(pid_t pid, int policy,
           /* Save the FIFO scheduling parameters */
 
           tcb->flags       |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice    = 0;
 #endif
         }
@@ -163,7 +185,7 @@ int sched_setscheduler(pid_t pid, int policy,
 #ifdef CONFIG_SCHED_SPORADIC
           /* Cancel any on-going sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               DEBUGVERIFY(sched_sporadic_stop(tcb));
             }
@@ -226,7 +248,7 @@ int sched_setscheduler(pid_t pid, int policy,
 
           /* Initialize/reset current sporadic scheduling */
 
-          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
             {
               ret = sched_sporadic_reset(tcb);
             }
@@ -267,6 +289,36 @@ int sched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+#ifdef CONFIG_SCHED_SPORADIC
+          /* Cancel any on-going sporadic scheduling */
+
+          if (oldpolicy == TCB_FLAG_SCHED_SPORADIC)
+            {
+              DEBUGVERIFY(sched_sporadic_stop(tcb));
+            }
+#endif
+          /* Admit the thread and start its first period.  This also sets
+           * the priority from the deadline of the thread.
+           */
+
+          tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+          ret = sched_deadline_start(tcb, param);
+          if (ret < 0)
+            {
+              /* Admission failed:  Leave the policy unchanged */
+
+              tcb->flags &= ~TCB_FLAG_POLICY_MASK;
+              tcb->flags |= oldpolicy;
+              errcode     = -ret;
+              goto errout_with_irq;
+            }
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -276,13 +328,21 @@ int sched_setscheduler(pid_t pid, int policy,
 
   leave_critical_section(flags);
 
-  /* Set the new priority */
+  /* Set the new priority.  The priority of a deadline thread follows from
+   * its deadline and has already been set.
+   */
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (policy != SCHED_DEADLINE)
+#endif
+    {
+      ret = sched_reprioritize(tcb, param->sched_priority);
+    }
 
-  ret = sched_reprioritize(tcb, param->sched_priority);
   sched_unlock();
   return (ret >= 0) ? OK : ERROR;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   set_errno(errcode);
   leave_critical_section(flags);
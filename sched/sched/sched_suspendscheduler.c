@@ -50,7 +50,8 @@
 #include "clock/clock.h"
 #include "sched/sched.h"
 
-#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION)
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION) || \
+    defined(CONFIG_SCHED_RUNTIME) || defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Functions
@@ -83,6 +84,18 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_RUNTIME
+  /* Charge the elapsed run time to the thread */
+
+  sched_runtime_suspend(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Stop the timing of any section held by the thread */
+
+  sched_critmon_suspend(tcb);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   /* Inidicate the task has been suspended */
 
@@ -90,4 +103,5 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
 #endif
 }
 
-#endif /* CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION */
+#endif /* CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION || \
+        * CONFIG_SCHED_RUNTIME || CONFIG_SCHED_CRITMONITOR */
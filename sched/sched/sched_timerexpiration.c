@@ -62,26 +62,6 @@
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
-/* In the original design, it was planned that sched_timer_reasses() be
- * called whenever there was a change at the head of the ready-to-run
- * list.  That call was intended to establish a new time-slice or to
- * stop an old time-slice timer.  However, it turns out that that
- * solution is too fragile:  The system is too vulnerable at the time
- * that the read-to-run list is modified in order to muck with timers.
- *
- * The kludge/work-around is simple to keep the timer running all of the
- * time with an interval of no more than the timeslice interval.  If we
- * this, then there is really no need to do anything when on context
- * switches.
- */
-
-#define KEEP_ALIVE_HACK 1
-
-#if CONFIG_RR_INTERVAL > 0
-#  define KEEP_ALIVE_TICKS MSEC2TICK(CONFIG_RR_INTERVAL)
-#else
-#  define KEEP_ALIVE_TICKS MSEC2TICK(80)
-#endif
 
 #ifndef MIN
 #  define MIN(a,b) (((a) < (b)) ? (a) : (b))
@@ -116,10 +96,12 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
  * Private Function Prototypes
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches);
 #endif
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches);
 #endif
 static unsigned int sched_timer_process(unsigned int ticks, bool noswitches);
@@ -136,6 +118,12 @@ static void sched_timer_start(unsigned int ticks);
 
 static unsigned int g_timer_interval;
 
+/* True while timer events are being processed.  Threads resumed during
+ * this time are accounted for when the next interval is determined.
+ */
+
+static bool g_timer_busy;
+
 #ifdef CONFIG_SCHED_SPORADIC
 /* This is the time of the last scheduler assessment */
 
@@ -180,7 +168,8 @@ static struct timespec g_stop_time;
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
 {
   FAR struct tcb_s *rtcb  = current_task(cpu);
@@ -227,6 +216,19 @@ static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the elapsed time against its budget and get the time
+       * remaining until the budget is exhausted.
+       */
+
+      ret = sched_deadline_process(rtcb, ticks, noswitches);
+    }
+#endif
+
   /* If a context switch occurred, then need to return delay remaining for
    * the new task at the head of the ready to run list.
    */
@@ -237,21 +239,18 @@ static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
 
   if (rtcb != ntcb)
     {
-      /* Recurse just to get the correct return value */
+      /* Recurse just to get the correct return value.  Only this CPU
+       * changed so there is no need to re-assess the others.
+       */
 
-      return sched_process_scheduler(0, true);
+      return sched_cpu_scheduler(cpu, 0, true);
     }
 
-  /* Returning zero means that there is no interesting event to be timed */
-
-#ifdef KEEP_ALIVE_HACK
-  if (ret == 0)
-    {
-      /* Apply the keep alive hack */
-
-      return KEEP_ALIVE_TICKS;
-    }
-#endif
+  /* Returning zero means that there is no interesting event to be timed.
+   * There is no need to keep the timer running for a CPU that is not time
+   * slicing:  sched_timer_timeslice() shortens the timer when a thread with
+   * a time slice or budget is resumed.
+   */
 
   return ret;
 }
@@ -281,7 +280,8 @@ static uint32_t sched_cpu_scheduler(int cpu, uint32_t ticks, bool noswitches)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches)
 {
 #ifdef CONFIG_SMP
@@ -346,12 +346,20 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
   unsigned int rettime  = 0;
   unsigned int tmp;
 
+  g_timer_busy = true;
+
 #ifdef CONFIG_CLOCK_TIMEKEEPING
   /* Process wall time */
 
   clock_update_wall_time();
 #endif
 
+  /* Bring the run time of the running thread(s) up to date so that the
+   * free-running counter cannot wrap unnoticed.
+   */
+
+  sched_runtime_tick();
+
   /* Process watchdogs */
 
   tmp = wd_timer(ticks);
@@ -371,6 +379,7 @@ static unsigned int sched_timer_process(unsigned int ticks, bool noswitches)
       rettime  = tmp;
     }
 
+  g_timer_busy = false;
   return rettime;
 }
 
@@ -693,6 +702,107 @@ void sched_timer_resume(void)
   sched_timer_start(nexttime);
 }
 
+/****************************************************************************
+ * Name:  sched_timer_timeslice
+ *
+ * Description:
+ *   Make sure that the timer expires no later than 'ticks' from now.  This
+ *   is called by sched_resume_scheduler() when a thread with a time slice
+ *   or a sporadic budget is about to run on any CPU.
+ *
+ *   Unlike sched_timer_reassess(), no timer events are processed here;
+ *   the ready-to-run lists are being modified by the caller.  The elapsed
+ *   part of the current interval is simply carried over into the shorter
+ *   interval so that it is accounted for when the timer expires.
+ *
+ * Input Parameters:
+ *   ticks - The time slice of the thread that is being resumed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_timer_timeslice(unsigned int ticks)
+{
+  struct timespec ts;
+  unsigned int elapsed;
+
+  /* If we are in the middle of processing timer events, the new thread
+   * will be included when the next interval is determined.
+   */
+
+  if (g_timer_busy || ticks == 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
+  if (g_timer_interval > 0)
+    {
+      /* Get the time elapsed since the timer was started */
+
+      (void)up_alarm_cancel(&ts);
+      clock_timespec_subtract(&ts, &g_stop_time, &ts);
+
+      elapsed  = SEC2TICK(ts.tv_sec);
+      elapsed += NSEC2TICK(ts.tv_nsec);
+
+      if (elapsed + ticks < g_timer_interval)
+        {
+          /* The alarm is relative to g_stop_time so the elapsed time is
+           * simply included in the new interval.
+           */
+
+          sched_timer_start(elapsed + ticks);
+        }
+      else
+        {
+          sched_timer_start(g_timer_interval);
+        }
+    }
+  else
+    {
+      /* No timer is running, so there are no partially timed events.
+       * Time the new interval from now.
+       */
+
+      (void)up_timer_gettime(&g_stop_time);
+      sched_timer_start(ticks);
+    }
+
+#else
+  if (g_timer_interval > 0)
+    {
+      unsigned int remaining;
+
+      /* Get the time remaining on the interval timer */
+
+      (void)up_timer_cancel(&ts);
+
+      remaining  = SEC2TICK(ts.tv_sec);
+      remaining += NSEC2TICK(ts.tv_nsec);
+      DEBUGASSERT(remaining <= g_timer_interval);
+
+      elapsed    = g_timer_interval - remaining;
+
+      /* Restart the timer with the shorter delay, carrying the elapsed
+       * part over so that it is processed when the timer expires.
+       */
+
+      sched_timer_start(MAX(MIN(remaining, ticks), 1));
+      g_timer_interval += elapsed;
+    }
+  else
+    {
+      sched_timer_start(ticks);
+    }
+#endif
+}
+
 /****************************************************************************
  * Name:  sched_timer_reassess
  *
@@ -714,10 +824,10 @@ void sched_timer_resume(void)
  *   system is too vulnerable at the time that the read-to-run list is
  *   modified in order to muck with timers.
  *
- *   The kludge/work-around is simple to keep the timer running all of the
- *   time with an interval of no more than the timeslice interval.  If we
- *   do this, then there is really no need to do anything on context
- *   switches.
+ *   Instead, sched_timer_timeslice() only shortens the running interval
+ *   when a thread with a time slice is resumed, without processing any
+ *   timer events.  The timer then need not be kept running on behalf of
+ *   CPUs that are not time slicing.
  *
  * Input Parameters:
  *   None
@@ -47,6 +47,48 @@
 #include "irq/irq.h"
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  sched_unlock_readytorun
+ *
+ * Description:
+ *   Called when pre-emption is re-enabled on a CPU.  The tasks in the
+ *   g_readytorun list could not pre-empt this CPU while pre-emption was
+ *   disabled.  If the highest priority such task that may run on this CPU
+ *   has a higher priority than the running task, then re-add it to the
+ *   ready-to-run lists to cause it to pre-empt a CPU.
+ *
+ * Inputs:
+ *   cpu  - The index of this CPU
+ *   rtcb - The task running on this CPU
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static void sched_unlock_readytorun(int cpu, FAR struct tcb_s *rtcb)
+{
+  FAR struct tcb_s *tcb;
+
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+       tcb != NULL && !CPU_ISSET(cpu, &tcb->affinity);
+       tcb = (FAR struct tcb_s *)tcb->flink);
+
+  if (tcb != NULL && tcb->sched_priority > rtcb->sched_priority)
+    {
+      up_reprioritize_rtr(tcb, tcb->sched_priority);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,6 +147,12 @@ int sched_unlock(void)
 
           sched_note_premption(rtcb, false);
 #endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+          /* Record the duration of the pre-emption lock */
+
+          sched_critmon_preemption(rtcb, false, NULL);
+#endif
           /* Set the lock count to zero */
 
           rtcb->lockcount = 0;
@@ -114,8 +162,7 @@ int sched_unlock(void)
            * release our hold on the lock.
            */
 
-          DEBUGASSERT(g_cpu_schedlock == SP_LOCKED &&
-                      (g_cpu_lockset & (1 << cpu)) != 0);
+          DEBUGASSERT(sched_cpu_locked(cpu));
 
           spin_clrbit(&g_cpu_lockset, cpu, &g_cpu_locksetlock,
                       &g_cpu_schedlock);
@@ -129,11 +176,13 @@ int sched_unlock(void)
            */
 
 #ifdef CONFIG_SMP
-          /* In the SMP case, the tasks remains pend(1) if we are
-           * in a critical section, i.e., g_cpu_irqlock is locked by other
-           * CPUs, or (2) other CPUs still have pre-emption disabled, i.e.,
-           * g_cpu_schedlock is locked.  In those cases, the release of the
-           * pending tasks must be deferred until those conditions are met.
+          /* In the SMP case, the tasks remain pending if we are in a critical
+           * section, i.e., g_cpu_irqlock is locked by other CPUs.  In that
+           * case, the release of the pending tasks must be deferred until
+           * the critical section is left.  Other CPUs that still have
+           * pre-emption disabled do not prevent the release:
+           * sched_mergepending() leaves the tasks that must run on those
+           * CPUs in the pending task list.
            *
            * There are certain conditions that we must avoid by preventing
            * releasing the pending tasks while within the critical section
@@ -147,8 +196,23 @@ int sched_unlock(void)
            * BEFORE it clears IRQ lock.
            */
 
-          if (!spin_islocked(&g_cpu_schedlock) && !irq_cpu_locked(cpu) &&
-              g_pendingtasks.head != NULL)
+          if (!irq_cpu_locked(cpu))
+            {
+              if (g_pendingtasks.head != NULL)
+                {
+                  up_release_pending();
+                }
+              else
+                {
+                  /* While pre-emption was disabled on this CPU, tasks that
+                   * became ready-to-run were placed on other CPUs or, if
+                   * none could run them, in the g_readytorun list.  One of
+                   * those may now pre-empt this task.
+                   */
+
+                  sched_unlock_readytorun(cpu, rtcb);
+                }
+            }
 #else
           /* In the single CPU case, decrementing irqcount to zero is
            * sufficient to release the pending tasks.  Further, in that
@@ -157,10 +221,10 @@ int sched_unlock(void)
            */
 
           if (g_pendingtasks.head != NULL)
-#endif
             {
               up_release_pending();
             }
+#endif
 
 #if CONFIG_RR_INTERVAL > 0
           /* If (1) the task that was running supported round-robin
@@ -78,6 +78,10 @@ static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
 static FAR struct semholder_s *g_freeholders;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: sem_allocholder
  ****************************************************************************/
@@ -195,15 +199,38 @@ sem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
  * Name: sem_freeholder
  ****************************************************************************/
 
-static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
+static void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *curr;
   FAR struct semholder_s *prev;
-#endif
+
+  /* Remove the holder from the list of semaphores held by the holder
+   * thread.
+   */
+
+  if (pholder->htcb != NULL)
+    {
+      for (prev = NULL, curr = pholder->htcb->holdsem;
+           curr && curr != pholder;
+           prev = curr, curr = curr->tlink);
+
+      if (curr != NULL)
+        {
+          if (prev != NULL)
+            {
+              prev->tlink = pholder->tlink;
+            }
+          else
+            {
+              pholder->htcb->holdsem = pholder->tlink;
+            }
+        }
+    }
 
   /* Release the holder and counts */
 
+  pholder->tlink  = NULL;
+  pholder->sem    = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
 
@@ -235,24 +262,6 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 #endif
 }
 
-/****************************************************************************
- * Name: sem_findandfreeholder
- ****************************************************************************/
-
-static inline void sem_findandfreeholder(sem_t *sem, FAR struct tcb_s *htcb)
-{
-  FAR struct semholder_s *pholder = sem_findholder(sem, htcb);
-
-  /* When no more counts are held, remove the holder from the list.  The
-   * count was decremented in sem_releaseholder.
-   */
-
-  if (pholder != NULL && pholder->counts <= 0)
-    {
-      sem_freeholder(sem, pholder);
-    }
-}
-
 /****************************************************************************
  * Name: sem_foreachholder
  ****************************************************************************/
@@ -307,531 +316,294 @@ static int sem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 }
 
 /****************************************************************************
- * Name: sem_recoverholders
- ****************************************************************************/
-
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-static int sem_recoverholders(FAR struct semholder_s *pholder,
-                              FAR sem_t *sem, FAR void *arg)
-{
-  sem_freeholder(sem, pholder);
-  return 0;
-}
-#endif
-
-/****************************************************************************
- * Name: sem_boostholderprio
+ * Name: sem_heapmerge
+ *
+ * Description:
+ *   The threads waiting for a semaphore are retained in a pairing heap
+ *   ordered by their current priority so that the highest priority waiter
+ *   is always at the root (sem->waiters).  Each node links to its first
+ *   child (wchild) and next sibling (wnext).  wprev links to the previous
+ *   sibling or, for a first child, to the parent.  It is NULL only for the
+ *   root.
+ *
+ *   This function merges two heap roots and returns the new root.
+ *
  ****************************************************************************/
 
-static int sem_boostholderprio(FAR struct semholder_s *pholder,
-                               FAR sem_t *sem, FAR void *arg)
+static FAR struct tcb_s *sem_heapmerge(FAR struct tcb_s *heap1,
+                                       FAR struct tcb_s *heap2)
 {
-  FAR struct tcb_s *htcb = (FAR struct tcb_s *)pholder->htcb;
-  FAR struct tcb_s *rtcb = (FAR struct tcb_s *)arg;
+  FAR struct tcb_s *tmp;
 
-  /* Make sure that the holder thread is still active.  If it exited without
-   * releasing its counts, then that would be a bad thing.  But we can take
-   * no real action because we don't know know that the program is doing.
-   * Perhaps its plan is to kill a thread, then destroy the semaphore.
-   */
-
-  if (!sched_verifytcb(htcb))
+  if (heap1 == NULL)
     {
-      serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
-      DEBUGPANIC();
-      sem_freeholder(sem, pholder);
+      return heap2;
     }
-
-#if CONFIG_SEM_NNESTPRIO > 0
-  /* If the priority of the thread that is waiting for a count is greater
-   * than the base priority of the thread holding a count, then we may need
-   * to adjust the holder's priority now or later to that priority.
-   */
-
-  else if (rtcb->sched_priority > htcb->base_priority)
+  else if (heap2 == NULL)
     {
-      /* If the new priority is greater than the current, possibly already
-       * boosted priority of the holder thread, then we will have to raise
-       * the holder's priority now.
-       */
-
-      if (rtcb->sched_priority > htcb->sched_priority)
-        {
-          /* If the current priority of holder thread has already been
-           * boosted, then add the boost priority to the list of restoration
-           * priorities.  When the higher priority waiter thread gets its
-           * count, then we need to revert the holder thread to this saved
-           * priority (not to its base priority).
-           */
-
-          if (htcb->sched_priority > htcb->base_priority)
-            {
-              /* Save the current, boosted priority of the holder thread. */
-
-              if (htcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
-                {
-                  htcb->pend_reprios[htcb->npend_reprio] = htcb->sched_priority;
-                  htcb->npend_reprio++;
-                }
-              else
-                {
-                  serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
-                  DEBUGASSERT(htcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
-                }
-            }
-
-          /* Raise the priority of the thread holding of the semaphore.
-           * This cannot cause a context switch because we have preemption
-           * disabled.  The holder thread may be marked "pending" and the
-           * switch may occur during up_block_task() processing.
-           */
-
-          (void)sched_setpriority(htcb, rtcb->sched_priority);
-        }
-      else
-        {
-          /* The new priority is above the base priority of the holder,
-           * but not as high as its current working priority.  Just put it
-           * in the list of pending restoration priorities so that when the
-           * higher priority thread gets its count, we can revert to this
-           * saved priority and not to the base priority.
-           */
+      return heap1;
+    }
 
-          if (htcb->npend_reprio < CONFIG_SEM_NNESTPRIO)
-            {
-              htcb->pend_reprios[htcb->npend_reprio] = rtcb->sched_priority;
-              htcb->npend_reprio++;
-            }
-          else
-            {
-              serr("ERROR: CONFIG_SEM_NNESTPRIO exceeded\n");
-              DEBUGASSERT(htcb->npend_reprio < CONFIG_SEM_NNESTPRIO);
-            }
-        }
+  if (heap2->sched_priority > heap1->sched_priority)
+    {
+      tmp   = heap1;
+      heap1 = heap2;
+      heap2 = tmp;
     }
 
-#else
-  /* If the priority of the thread that is waiting for a count is less than
-   * of equal to the priority of the thread holding a count, then do nothing
-   * because the thread is already running at a sufficient priority.
-   */
+  /* heap2 becomes the first child of heap1 */
 
-  else if (rtcb->sched_priority > htcb->sched_priority)
+  heap2->wprev  = heap1;
+  heap2->wnext  = heap1->wchild;
+  if (heap1->wchild != NULL)
     {
-      /* Raise the priority of the holder of the semaphore.  This
-       * cannot cause a context switch because we have preemption
-       * disabled.  The task will be marked "pending" and the switch
-       * will occur during up_block_task() processing.
-       */
-
-      (void)sched_setpriority(htcb, rtcb->sched_priority);
+      heap1->wchild->wprev = heap2;
     }
-#endif
 
-  return 0;
+  heap1->wchild = heap2;
+  heap1->wnext  = NULL;
+  heap1->wprev  = NULL;
+  return heap1;
 }
 
 /****************************************************************************
- * Name: sem_verifyholder
+ * Name: sem_heapcombine
+ *
+ * Description:
+ *   Combine a list of sibling sub-heaps into a single heap using the usual
+ *   two-pass pairing and return its root.  This is O(log n), amortized.
+ *
  ****************************************************************************/
 
-#ifdef CONFIG_DEBUG_ASSERTIONS
-static int sem_verifyholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
-                            FAR void *arg)
+static FAR struct tcb_s *sem_heapcombine(FAR struct tcb_s *first)
 {
-#if 0 /* Need to revisit this, but these assumptions seem to be untrue -- \
-       * OR there is a bug??? */
-  FAR struct tcb_s *htcb = (FAR struct tcb_s *)pholder->htcb;
+  FAR struct tcb_s *pairs = NULL;
+  FAR struct tcb_s *heap1;
+  FAR struct tcb_s *heap2;
+  FAR struct tcb_s *next;
 
-  /* Called after a semaphore has been released (incremented), the semaphore
-   * could is non-negative, and there is no thread waiting for the count.
-   * In this case, the priority of the holder should not be boosted.
+  /* First pass:  Merge the siblings pairwise from left to right, stacking
+   * the results (linked through wnext).
    */
 
-#if CONFIG_SEM_NNESTPRIO > 0
-  DEBUGASSERT(htcb->npend_reprio == 0);
-#endif
-  DEBUGASSERT(htcb->sched_priority == htcb->base_priority);
-#endif
-  return 0;
+  while (first != NULL)
+    {
+      heap1 = first;
+      heap2 = heap1->wnext;
+      next  = heap2 != NULL ? heap2->wnext : NULL;
+
+      heap1->wnext = NULL;
+      heap1->wprev = NULL;
+      if (heap2 != NULL)
+        {
+          heap2->wnext = NULL;
+          heap2->wprev = NULL;
+        }
+
+      heap1        = sem_heapmerge(heap1, heap2);
+      heap1->wnext = pairs;
+      pairs        = heap1;
+      first        = next;
+    }
+
+  /* Second pass:  Merge the stacked pairs from right to left */
+
+  heap1 = NULL;
+  while (pairs != NULL)
+    {
+      next         = pairs->wnext;
+      pairs->wnext = NULL;
+      heap1        = sem_heapmerge(heap1, pairs);
+      pairs        = next;
+    }
+
+  return heap1;
 }
-#endif
 
 /****************************************************************************
- * Name: sem_dumpholder
+ * Name: sem_addwaiter
  ****************************************************************************/
 
-#if defined(CONFIG_DEBUG_INFO) && defined(CONFIG_SEM_PHDEBUG)
-static int sem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
-                          FAR void *arg)
+static void sem_addwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb)
 {
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  _info("  %08x: %08x %08x %04x\n",
-        pholder, pholder->flink, pholder->htcb, pholder->counts);
-#else
-  _info("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
-#endif
-  return 0;
+  wtcb->wchild = NULL;
+  wtcb->wnext  = NULL;
+  wtcb->wprev  = NULL;
+  sem->waiters = sem_heapmerge(sem->waiters, wtcb);
 }
-#endif
 
 /****************************************************************************
- * Name: sem_restoreholderprio
+ * Name: sem_remwaiter
  ****************************************************************************/
 
-static int sem_restoreholderprio(FAR struct tcb_s *htcb,
-                                 FAR sem_t *sem, FAR void *arg)
+static void sem_remwaiter(FAR sem_t *sem, FAR struct tcb_s *wtcb)
 {
-  FAR struct semholder_s *pholder = 0;
-#if CONFIG_SEM_NNESTPRIO > 0
-  FAR struct tcb_s *stcb = (FAR struct tcb_s *)arg;
-  int rpriority;
-  int i;
-  int j;
-#endif
-
-  /* Make sure that the holder thread is still active.  If it exited without
-   * releasing its counts, then that would be a bad thing.  But we can take
-   * no real action because we don't know know that the program is doing.
-   * Perhaps its plan is to kill a thread, then destroy the semaphore.
-   */
+  FAR struct tcb_s *subheap;
 
-  if (!sched_verifytcb(htcb))
+  if (wtcb == sem->waiters)
     {
-      serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
-      DEBUGPANIC();
-      pholder = sem_findholder(sem, htcb);
-      if (pholder != NULL)
-        {
-          sem_freeholder(sem, pholder);
-        }
-    }
-
-  /* Was the priority of the holder thread boosted? If so, then drop its
-   * priority back to the correct level.  What is the correct level?
-   */
+      /* Removing the root:  Combine its children into the new heap */
 
-  else if (htcb->sched_priority != htcb->base_priority)
+      sem->waiters = sem_heapcombine(wtcb->wchild);
+    }
+  else
     {
-#if CONFIG_SEM_NNESTPRIO > 0
-      /* Are there other, pending priority levels to revert to? */
-
-      if (htcb->npend_reprio < 1)
-        {
-          /* No... the holder thread has only been boosted once.
-           * npend_reprio should be 0 and the boosted priority should be the
-           * priority of the task that just got the semaphore
-           * (stcb->sched_priority)
-           *
-           * That latter assumption may not be true if the stcb's priority
-           * was also boosted so that it no longer matches the htcb's
-           * sched_priority.  Or if CONFIG_SEM_NNESTPRIO is too small (so
-           * that we do not have a proper record of the reprioritizations).
-           */
-
-          DEBUGASSERT(/* htcb->sched_priority == stcb->sched_priority && */
-            htcb->npend_reprio == 0);
-
-          /* Reset the holder's priority back to the base priority. */
-
-          sched_reprioritize(htcb, htcb->base_priority);
-        }
+      /* Cut the sub-heap rooted at wtcb out of the sibling list */
 
-      /* There are multiple pending priority levels. The holder thread's
-       * "boosted" priority could greater than or equal to
-       * "stcb->sched_priority" (it could be greater if its priority we
-       * boosted because it also holds another semaphore).
-       */
-
-      else if (htcb->sched_priority <= stcb->sched_priority)
+      DEBUGASSERT(wtcb->wprev != NULL);
+      if (wtcb->wprev->wchild == wtcb)
         {
-          /* The holder thread has been boosted to the same priority as the
-           * waiter thread that just received the count.  We will simply
-           * reprioritize to the next highest priority that we have in
-           * rpriority.
-           */
-
-          /* Find the highest pending priority and remove it from the list */
-
-          for (i = 1, j = 0; i < htcb->npend_reprio; i++)
-            {
-              if (htcb->pend_reprios[i] > htcb->pend_reprios[j])
-                {
-                  j = i;
-                }
-            }
-
-          /* Remove the highest priority pending priority from the list */
-
-          rpriority = htcb->pend_reprios[j];
-          i = htcb->npend_reprio - 1;
-          if (i > 0)
-            {
-              htcb->pend_reprios[j] = htcb->pend_reprios[i];
-            }
-
-          htcb->npend_reprio = i;
-
-          /* And apply that priority to the thread (while retaining the
-           * base_priority)
-           */
-
-          sched_setpriority(htcb, rpriority);
+          wtcb->wprev->wchild = wtcb->wnext;
         }
       else
         {
-          /* The holder thread has been boosted to a higher priority than the
-           * waiter task.  The pending priority should be in the list (unless
-           * it was lost because of of list overflow or because the holder
-           * was reprioritized again unbeknownst to the priority inheritance
-           * logic).
-           *
-           * Search the list for the matching priority.
-           */
+          wtcb->wprev->wnext = wtcb->wnext;
+        }
 
-          for (i = 0; i < htcb->npend_reprio; i++)
-            {
-              /* Does this pending priority match the priority of the thread
-               * that just received the count?
-               */
-
-              if (htcb->pend_reprios[i] == stcb->sched_priority)
-                {
-                  /* Yes, remove it from the list */
-
-                  j = htcb->npend_reprio - 1;
-                  if (j > 0)
-                    {
-                      htcb->pend_reprios[i] = htcb->pend_reprios[j];
-                    }
-
-                  htcb->npend_reprio = j;
-                  break;
-                }
-            }
+      if (wtcb->wnext != NULL)
+        {
+          wtcb->wnext->wprev = wtcb->wprev;
         }
-#else
-      /* There is no alternative restore priorities, drop the priority
-       * of the holder thread all the way back to the threads "base"
-       * priority.
-       */
 
-      sched_reprioritize(htcb, htcb->base_priority);
-#endif
+      /* Then merge the children of wtcb back into the heap */
+
+      subheap      = sem_heapcombine(wtcb->wchild);
+      sem->waiters = sem_heapmerge(sem->waiters, subheap);
     }
 
-  return 0;
+  wtcb->wchild = NULL;
+  wtcb->wnext  = NULL;
+  wtcb->wprev  = NULL;
 }
 
 /****************************************************************************
- * Name: sem_restoreholderprioall
+ * Name: sem_holderprio
  *
  * Description:
- *   Reprioritize all holders
+ *   Return the priority that the holder thread should run at:  Its base
+ *   priority or the priority of the highest priority thread waiting for any
+ *   semaphore that it holds, whichever is greater.
  *
  ****************************************************************************/
 
-static int sem_restoreholderprioall(FAR struct semholder_s *pholder,
-                                    FAR sem_t *sem, FAR void *arg)
+static int sem_holderprio(FAR struct tcb_s *htcb)
 {
-  return sem_restoreholderprio(pholder->htcb, sem, arg);
-}
-
-/****************************************************************************
- * Name: sem_restoreholderprioA
- *
- * Description:
- *   Reprioritize all holders except the currently executing task
- *
- ****************************************************************************/
+  FAR struct semholder_s *pholder;
+  FAR struct tcb_s *wtcb;
+  int priority = htcb->base_priority;
 
-static int sem_restoreholderprioA(FAR struct semholder_s *pholder,
-                                  FAR sem_t *sem, FAR void *arg)
-{
-  FAR struct tcb_s *rtcb = this_task();
-  if (pholder->htcb != rtcb)
+  for (pholder = htcb->holdsem; pholder != NULL; pholder = pholder->tlink)
     {
-      return sem_restoreholderprio(pholder->htcb, sem, arg);
+      wtcb = pholder->sem->waiters;
+      if (wtcb != NULL && wtcb->sched_priority > priority)
+        {
+          priority = wtcb->sched_priority;
+        }
     }
 
-  return 0;
+  return priority;
 }
 
 /****************************************************************************
- * Name: sem_restoreholderprioB
+ * Name: sem_updateholder
  *
  * Description:
- *   Reprioritize only the currently executing task
+ *   Raise or restore the priority of a holder thread after the set of
+ *   threads waiting for the semaphores it holds has changed.
  *
  ****************************************************************************/
 
-static int sem_restoreholderprioB(FAR struct semholder_s *pholder,
-                                  FAR sem_t *sem, FAR void *arg)
+static void sem_updateholder(FAR struct tcb_s *htcb)
 {
-  FAR struct tcb_s *rtcb = this_task();
+  int priority = sem_holderprio(htcb);
 
-  if (pholder->htcb == rtcb)
+  if (priority != htcb->sched_priority)
     {
-
-      /* The running task has given up a count on the semaphore */
-
-#if CONFIG_SEM_PREALLOCHOLDERS == 0
-      /* In the case where there are only 2 holders. This step
-       * is necessary to insure we have space. Release the holder
-       * if all counts have been given up. before reprioritizing
-       * causes a context switch.
+      /* This cannot cause a context switch because we have preemption
+       * disabled.  The holder thread may be marked "pending" and the
+       * switch may occur during sched_unlock() processing.
        */
 
-      sem_findandfreeholder(sem, rtcb);
-#endif
-      (void)sem_restoreholderprio(rtcb, sem, arg);
-      return 1;
+      (void)sched_setpriority(htcb, priority);
     }
-
-  return 0;
 }
 
 /****************************************************************************
- * Name: sem_restorebaseprio_irq
- *
- * Description:
- *   This function is called after the an interrupt handler posts a count on
- *   the semaphore.  It will check if we need to drop the priority of any
- *   threads holding a count on the semaphore.  Their priority could have
- *   been boosted while they held the count.
- *
- * Parameters:
- *   stcb - The TCB of the task that was just started (if any).  If the
- *     post action caused a count to be given to another thread, then stcb
- *     is the TCB that received the count.  Note, just because stcb received
- *     the count, it does not mean that it it is higher priority than other
- *     threads.
- *   sem - A reference to the semaphore being posted.
- *     - If the semaphore count is <0 then there are still threads waiting
- *       for a count.  stcb should be non-null and will be higher priority
- *       than all of the other threads still waiting.
- *     - If it is ==0 then stcb refers to the thread that got the last count;
- *       no other threads are waiting.
- *     - If it is >0 then there should be no threads waiting for counts and
- *       stcb should be null.
- *
- * Return Value:
- *   None
- *
- * Assumptions:
- *   The scheduler is locked.
- *
+ * Name: sem_boostholderprio
  ****************************************************************************/
 
-static inline void sem_restorebaseprio_irq(FAR struct tcb_s *stcb,
-                                           FAR sem_t *sem)
+static int sem_boostholderprio(FAR struct semholder_s *pholder,
+                               FAR sem_t *sem, FAR void *arg)
 {
-  /* Perform the following actions only if a new thread was given a count.
-   * The thread that received the count should be the highest priority
-   * of all threads waiting for a count from the semaphore.  So in that
-   * case, the priority of all holder threads should be dropped to the
-   * next highest pending priority.
+  FAR struct tcb_s *htcb = pholder->htcb;
+  FAR struct tcb_s *rtcb = (FAR struct tcb_s *)arg;
+
+  /* If the priority of the thread that is waiting for a count is less than
+   * of equal to the priority of the thread holding a count, then do nothing
+   * because the thread is already running at a sufficient priority.
    */
 
-  if (stcb != NULL)
+  if (rtcb->sched_priority > htcb->sched_priority)
     {
-      /* Drop the priority of all holder threads */
+      /* Raise the priority of the holder of the semaphore.  This
+       * cannot cause a context switch because we have preemption
+       * disabled.  The task will be marked "pending" and the switch
+       * will occur during up_block_task() processing.
+       */
 
-      (void)sem_foreachholder(sem, sem_restoreholderprioall, stcb);
+      (void)sched_setpriority(htcb, rtcb->sched_priority);
     }
 
-  /* If there are no tasks waiting for available counts, then all holders
-   * should be at their base priority.
-   */
-
-#ifdef CONFIG_DEBUG_ASSERTIONS
-  else
-    {
-      (void)sem_foreachholder(sem, sem_verifyholder, NULL);
-    }
-#endif
+  return 0;
 }
 
 /****************************************************************************
- * Name: sem_restorebaseprio_task
+ * Name: sem_updateholderprio
  *
  * Description:
- *   This function is called after the current running task releases a
- *   count on the semaphore.  It will check if we need to drop the priority
- *   of any threads holding a count on the semaphore.  Their priority could
- *   have been boosted while they held the count.
- *
- * Parameters:
- *   stcb - The TCB of the task that was just started (if any).  If the
- *     post action caused a count to be given to another thread, then stcb
- *     is the TCB that received the count.  Note, just because stcb received
- *     the count, it does not mean that it it is higher priority than other
- *     threads.
- *   sem - A reference to the semaphore being posted.
- *     - If the semaphore count is <0 then there are still threads waiting
- *       for a count.  stcb should be non-null and will be higher priority
- *       than all of the other threads still waiting.
- *     - If it is ==0 then stcb refers to the thread that got the last count;
- *       no other threads are waiting.
- *     - If it is >0 then there should be no threads waiting for counts and
- *       stcb should be null.
- *
- * Return Value:
- *   None
- *
- * Assumptions:
- *   The scheduler is locked.
+ *   Update the priority of every holder except, optionally, one
  *
  ****************************************************************************/
 
-static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb,
-                                            FAR sem_t *sem)
+static int sem_updateholderprio(FAR struct semholder_s *pholder,
+                                FAR sem_t *sem, FAR void *arg)
 {
-  FAR struct tcb_s *rtcb = this_task();
-
-  /* Perform the following actions only if a new thread was given a count.
-   * The thread that received the count should be the highest priority
-   * of all threads waiting for a count from the semaphore.  So in that
-   * case, the priority of all holder threads should be dropped to the
-   * next highest pending priority.
-   */
-
-  if (stcb != NULL)
+  if (pholder->htcb != (FAR struct tcb_s *)arg)
     {
-      /* The currently executed thread should be the lower priority
-       * thread that just posted the count and caused this action.
-       * However, we cannot drop the priority of the currently running
-       * thread -- because that will cause it to be suspended.
-       *
-       * So, do this in two passes.  First, reprioritizing all holders
-       * except for the running thread.
-       */
+      sem_updateholder(pholder->htcb);
+    }
 
-      (void)sem_foreachholder(sem, sem_restoreholderprioA, stcb);
+  return 0;
+}
 
-      /* Now, find an reprioritize only the ready to run task */
+/****************************************************************************
+ * Name: sem_recoverholders
+ ****************************************************************************/
 
-      (void)sem_foreachholder(sem, sem_restoreholderprioB, stcb);
-    }
+static int sem_recoverholders(FAR struct semholder_s *pholder,
+                              FAR sem_t *sem, FAR void *arg)
+{
+  sem_freeholder(sem, pholder);
+  return 0;
+}
 
-  /* If there are no tasks waiting for available counts, then all holders
-   * should be at their base priority.
-   */
+/****************************************************************************
+ * Name: sem_dumpholder
+ ****************************************************************************/
 
-#ifdef CONFIG_DEBUG_ASSERTIONS
-  else
-    {
-      (void)sem_foreachholder(sem, sem_verifyholder, NULL);
-    }
+#if defined(CONFIG_DEBUG_INFO) && defined(CONFIG_SEM_PHDEBUG)
+static int sem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
+                          FAR void *arg)
+{
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  _info("  %08x: %08x %08x %04x\n",
+        pholder, pholder->flink, pholder->htcb, pholder->counts);
+#else
+  _info("  %08x: %08x %04x\n", pholder, pholder->htcb, pholder->counts);
 #endif
-
-  /* In any case, the currently executing task should have an entry in the
-   * list.  Its counts were previously decremented; if it now holds no
-   * counts, then we need to remove it from the list of holders.
-   */
-
-  sem_findandfreeholder(sem, rtcb);
+  return 0;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -897,27 +669,20 @@ void sem_destroyholder(FAR sem_t *sem)
    * state of any of the holder threads.
    *
    * So just recover any stranded holders and hope the task knows what it is
-   * doing.
+   * doing.  The holders must be recovered in any event:  They are also
+   * linked into the list of semaphores held by each holder thread.
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   if (sem->hhead != NULL)
-    {
-      serr("ERROR: Semaphore destroyed with holders\n");
-      DEBUGPANIC();
-      (void)sem_foreachholder(sem, sem_recoverholders, NULL);
-    }
-
 #else
   if (sem->holder[0].htcb != NULL || sem->holder[1].htcb != NULL)
+#endif
     {
-      serr("ERROR: Semaphore destroyed with holder\n");
+      serr("ERROR: Semaphore destroyed with holders\n");
       DEBUGPANIC();
+      (void)sem_foreachholder(sem, sem_recoverholders, NULL);
     }
-
-  sem->holder[0].htcb = NULL;
-  sem->holder[1].htcb = NULL;
-#endif
 }
 
 /****************************************************************************
@@ -955,11 +720,20 @@ void sem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
       pholder = sem_findorallocateholder(sem, htcb);
       if (pholder != NULL)
         {
-          /* Then set the holder and increment the number of counts held by this
-           * holder
+          /* If this is a new holder, then add the semaphore to the list of
+           * semaphores held by the thread.
            */
 
-          pholder->htcb = htcb;
+          if (pholder->htcb == NULL)
+            {
+              pholder->htcb  = htcb;
+              pholder->sem   = sem;
+              pholder->tlink = htcb->holdsem;
+              htcb->holdsem  = pholder;
+            }
+
+          /* Then increment the number of counts held by this holder */
+
           pholder->counts++;
         }
     }
@@ -991,15 +765,19 @@ void sem_addholder(FAR sem_t *sem)
  * Name: void sem_boostpriority(sem_t *sem)
  *
  * Description:
- *
+ *   Called from sem_wait() just before the calling thread blocks waiting
+ *   for a count.  The calling thread is added to the waiters of the
+ *   semaphore and the priority of every holder is raised to the priority
+ *   of the calling thread if that is higher.
  *
  * Parameters:
- *   None
+ *   sem - A reference to the semaphore to be waited for
  *
  * Return Value:
- *   0 (OK) or -1 (ERROR) if unsuccessful
+ *   None
  *
  * Assumptions:
+ *   Interrupts are disabled and the scheduler is locked.
  *
  ****************************************************************************/
 
@@ -1007,6 +785,13 @@ void sem_boostpriority(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
 
+  /* Add the thread to the waiters of the semaphore.  This is done even if
+   * priority inheritance is disabled for the semaphore so that the waiters
+   * are always consistent.
+   */
+
+  sem_addwaiter(sem, rtcb);
+
   /* Boost the priority of every thread holding counts on this semaphore
    * that are lower in priority than the new thread that is waiting for a
    * count.
@@ -1085,11 +870,23 @@ void sem_releaseholder(FAR sem_t *sem)
 
 void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
 {
+  FAR struct semholder_s *pholder;
+  FAR struct tcb_s *rtcb;
+
   /* Check our assumptions */
 
   DEBUGASSERT((sem->semcount > 0  && stcb == NULL) ||
               (sem->semcount <= 0 && stcb != NULL));
 
+  /* The thread that received the count is no longer waiting for the
+   * semaphore.
+   */
+
+  if (stcb != NULL)
+    {
+      sem_remwaiter(sem, stcb);
+    }
+
   /* Handler semaphore counts posed from an interrupt handler differently
    * from interrupts posted from threads.  The primary difference is that
    * if the semaphore is posted from a thread, then the poster thread is
@@ -1100,11 +897,37 @@ void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
 
   if (up_interrupt_context())
     {
-      sem_restorebaseprio_irq(stcb, sem);
+      /* Re-evaluate the priority of all holders (including stcb) against
+       * the remaining waiters.
+       */
+
+      (void)sem_foreachholder(sem, sem_updateholderprio, NULL);
     }
   else
     {
-      sem_restorebaseprio_task(stcb, sem);
+      /* The running task should have an entry in the list (unless the
+       * semaphore is used for signaling).  Its counts were previously
+       * decremented; if it now holds no counts, then it is no longer a
+       * holder.
+       */
+
+      rtcb    = this_task();
+      pholder = sem_findholder(sem, rtcb);
+      if (pholder != NULL && pholder->counts <= 0)
+        {
+          sem_freeholder(sem, pholder);
+        }
+
+      /* Re-evaluate the priority of all holders except for the running
+       * task.  Then restore the running task (which may or may not still
+       * hold counts on the semaphore) last.
+       */
+
+      (void)sem_foreachholder(sem, sem_updateholderprio, rtcb);
+      if (pholder != NULL)
+        {
+          sem_updateholder(rtcb);
+        }
     }
 }
 
@@ -1114,31 +937,99 @@ void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
  * Description:
  *   Called from sem_waitirq() after a thread that was waiting for a semaphore
  *   count was awakened because of a signal and the semaphore wait has been
- *   cancelled.  This function restores the correct thread priority of each
- *   holder of the semaphore.
+ *   cancelled and from sem_recover() when a waiting thread is deleted.  This
+ *   function removes the thread from the waiters of the semaphore and
+ *   restores the correct thread priority of each holder of the semaphore.
  *
  * Parameters:
- *   sem - A reference to the semaphore no longer being waited for
+ *   stcb - The TCB of the thread that is no longer waiting
+ *   sem  - A reference to the semaphore no longer being waited for
  *
  * Return Value:
  *   None
  *
  * Assumptions:
+ *   Interrupts are disabled.
  *
  ****************************************************************************/
 
-#ifndef CONFIG_DISABLE_SIGNALS
 void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
 {
   /* Check our assumptions */
 
   DEBUGASSERT(sem->semcount <= 0);
 
-  /* Adjust the priority of every holder as necessary */
+  /* Remove the thread from the waiters and adjust the priority of every
+   * holder as necessary.
+   */
 
-  (void)sem_foreachholder(sem, sem_restoreholderprioall, stcb);
+  sem_remwaiter(sem, stcb);
+  (void)sem_foreachholder(sem, sem_updateholderprio, NULL);
+}
+
+/****************************************************************************
+ * Name: sem_requeuewaiter
+ *
+ * Description:
+ *   Called from sched_setpriority() after the priority of a thread that is
+ *   waiting for a semaphore has changed.  The thread is repositioned among
+ *   the waiters of the semaphore and the priority of every holder of the
+ *   semaphore is re-evaluated.  If a holder is itself waiting for another
+ *   semaphore, the change then propagates along the chain of holders.
+ *
+ * Parameters:
+ *   wtcb - The TCB of the waiting thread
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sem_requeuewaiter(FAR struct tcb_s *wtcb)
+{
+  FAR sem_t *sem = wtcb->waitsem;
+
+  if (sem != NULL)
+    {
+      sem_remwaiter(sem, wtcb);
+      sem_addwaiter(sem, wtcb);
+      (void)sem_foreachholder(sem, sem_updateholderprio, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: sem_releaseheld
+ *
+ * Description:
+ *   Called from sem_recover() when a thread exits or is deleted.  Discard
+ *   the holder records of all semaphores held by the thread.  The counts
+ *   themselves are not posted; they are lost just as before.  But the
+ *   holder records are returned for re-use and the semaphores no longer
+ *   refer to the stale TCB.
+ *
+ * Parameters:
+ *   htcb - The TCB of the exiting thread
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sem_releaseheld(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+
+  while ((pholder = htcb->holdsem) != NULL)
+    {
+      sem_freeholder(pholder->sem, pholder);
+    }
 }
-#endif
 
 /****************************************************************************
  * Name: sem_enumholders
@@ -41,9 +41,11 @@
 
 #include "semaphore/semaphore.h"
 
-/* Currently only need to setup priority inheritance logic */
+/* Currently only need to setup priority inheritance logic and the semaphore
+ * spinlocks.
+ */
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_SEM_SPINLOCKS)
 
 /****************************************************************************
  * Public Functions
@@ -72,6 +74,12 @@ void sem_initialize(void)
   /* Initialize holder structures needed to support priority inheritance */
 
   sem_initholders();
+
+#ifdef CONFIG_SEM_SPINLOCKS
+  /* Initialize the spinlocks that protect the semaphore counts */
+
+  sem_initspinlocks();
+#endif
 }
 
-#endif /* CONFIG_PRIORITY_INHERITANCE */
+#endif /* CONFIG_PRIORITY_INHERITANCE || CONFIG_SEM_SPINLOCKS */
@@ -85,12 +85,32 @@ int sem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
   irqstate_t flags;
+  int16_t semcount;
   int ret = ERROR;
 
   /* Make sure we were supplied with a valid semaphore. */
 
   if (sem)
     {
+#ifdef CONFIG_SEM_SPINLOCKS
+      FAR volatile spinlock_t *lock = sem_spinlock(sem);
+
+      /* If no thread is waiting for the semaphore, then simply increment
+       * the count.  Only the spinlock of this semaphore is needed for this.
+       */
+
+      flags = spin_lock_irqsave(lock);
+      if (sem->semcount >= 0)
+        {
+          ASSERT(sem->semcount < SEM_VALUE_MAX);
+          sem->semcount++;
+          spin_unlock_irqrestore(lock, flags);
+          return OK;
+        }
+
+      spin_unlock_irqrestore(lock, flags);
+#endif
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -117,7 +137,10 @@ int sem_post(FAR sem_t *sem)
 
       ASSERT(sem->semcount < SEM_VALUE_MAX);
       sem_releaseholder(sem);
-      sem->semcount++;
+
+      sem_lock(sem);
+      semcount = ++sem->semcount;
+      sem_unlock(sem);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       /* Don't let any unblocked tasks run until we complete any priority
@@ -134,7 +157,7 @@ int sem_post(FAR sem_t *sem)
        * there must be some task waiting for the semaphore.
        */
 
-      if (sem->semcount <= 0)
+      if (semcount <= 0)
         {
           /* Check if there are any tasks in the waiting for semaphore
            * task list that are waiting for this semaphore. This is a
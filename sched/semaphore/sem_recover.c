@@ -53,16 +53,16 @@
  * Name: sem_recover
  *
  * Description:
- *   This function is called from task_recover() when a task is deleted via
- *   task_delete() or via pthread_cancel().  It current only checks on the
+ *   This function is called from task_recover() when a task exits or is
+ *   deleted via task_delete() or via pthread_cancel().  It checks on the
  *   case where a task is waiting for semaphore at the time that is was
- *   killed.
+ *   killed.  If priority inheritance is enabled, it also discards the
+ *   holder records of the semaphores held by the task.
  *
  *   REVISIT:  A more complete implementation would release counts on all
- *   semaphores held by the thread.  That would, however, require some
- *   significant extension to the semaphore data structures because given
- *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   semaphores held by the thread.  With priority inheritance, the held
+ *   semaphores can now be traversed but the counts are not posted:  The
+ *   state protected by the semaphore is probably inconsistent.
  *
  * Inputs:
  *   tcb - The TCB of the terminated task or thread
@@ -110,7 +110,9 @@ void sem_recover(FAR struct tcb_s *tcb)
        * place.
        */
 
+      sem_lock(sem);
       sem->semcount++;
+      sem_unlock(sem);
 
       /* Clear the semaphore to assure that it is not reused.  But leave the
        * state as TSTATE_WAIT_SEM.  This is necessary because this is a
@@ -121,5 +123,10 @@ void sem_recover(FAR struct tcb_s *tcb)
       tcb->waitsem = NULL;
     }
 
+  /* Forget any semaphores held by the task so that they do not retain
+   * references to the stale TCB.
+   */
+
+  sem_releaseheld(tcb);
   leave_critical_section(flags);
 }
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * sched/semaphore/sem_requeue.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_requeue
+ *
+ * Description:
+ *   Move the tasks waiting for 'sem' so that they wait for 'target'
+ *   instead, without waking them up.  Each task that is moved has
+ *   TCB_FLAG_SEM_REQUEUED set; when its wait ends normally it holds a count
+ *   of 'target'.  This is used by pthread_cond_broadcast() to move the
+ *   waiters of a condition variable directly to the mutex so that they are
+ *   woken one at a time as the mutex is released.
+ *
+ *   Tasks are only moved while 'target' is unavailable (its count is not
+ *   positive); otherwise a moved task could never be woken.  If priority
+ *   inheritance is enabled on 'target', no tasks are moved because the
+ *   holders of 'target' would not be boosted by the moved tasks.
+ *
+ * Parameters:
+ *   sem    - The semaphore that the tasks are waiting for
+ *   target - The semaphore that the tasks should wait for instead
+ *
+ * Return Value:
+ *   The number of tasks that were moved.
+ *
+ * Assumptions:
+ *   Called with pre-emption disabled.  Not called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+int sem_requeue(FAR sem_t *sem, FAR sem_t *target)
+{
+  FAR struct tcb_s *stcb;
+  irqstate_t flags;
+  int count = 0;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((target->flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return 0;
+    }
+#endif
+
+  flags = enter_critical_section();
+
+  /* The list of waiting tasks is prioritized, so the tasks keep their
+   * order when they are moved.
+   */
+
+  for (stcb = (FAR struct tcb_s *)g_waitingforsemaphore.head;
+       stcb != NULL && sem->semcount < 0 && target->semcount <= 0;
+       stcb = stcb->flink)
+    {
+      if (stcb->waitsem == sem)
+        {
+          sem_lock(sem);
+          sem->semcount++;
+          sem_unlock(sem);
+
+          sem_lock(target);
+          target->semcount--;
+          sem_unlock(target);
+
+          stcb->waitsem = target;
+          stcb->flags  |= TCB_FLAG_SEM_REQUEUED;
+          count++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return count;
+}
@@ -110,11 +110,14 @@ int sem_reset(FAR sem_t *sem, int16_t count)
    * value of sem->semcount is already correct in this case.
    */
 
+  sem_lock(sem);
   if (sem->semcount >= 0)
     {
       sem->semcount = count;
     }
 
+  sem_unlock(sem);
+
   /* Allow any pending context switches to occur now */
 
   leave_critical_section(flags);
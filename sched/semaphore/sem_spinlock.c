@@ -0,0 +1,141 @@
+/****************************************************************************
+ * sched/semaphore/sem_spinlock.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <semaphore.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_SPINLOCKS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The spinlocks that protect the semaphore counts.  Each semaphore uses the
+ * spinlock selected by a hash of its address.
+ */
+
+static volatile spinlock_t g_semlock[CONFIG_SEM_NSPINLOCKS] SP_SECTION;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_initspinlocks
+ *
+ * Description:
+ *   Initialize the spinlocks that protect the semaphore counts.  Called once
+ *   during OS startup initialization.
+ *
+ * Parameters:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sem_initspinlocks(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SEM_NSPINLOCKS; i++)
+    {
+      g_semlock[i] = SP_UNLOCKED;
+    }
+}
+
+/****************************************************************************
+ * Name: sem_spinlock
+ *
+ * Description:
+ *   Return the spinlock that protects the count of the semaphore.  The
+ *   low-order address bits are discarded since they are the same for all
+ *   (aligned) semaphores.
+ *
+ * Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Return Value:
+ *   A reference to the spinlock.
+ *
+ ****************************************************************************/
+
+FAR volatile spinlock_t *sem_spinlock(FAR sem_t *sem)
+{
+  uintptr_t key = (uintptr_t)sem;
+
+  key = (key >> 2) ^ (key >> 9);
+  return &g_semlock[key % CONFIG_SEM_NSPINLOCKS];
+}
+
+/****************************************************************************
+ * Name: sem_decrement
+ *
+ * Description:
+ *   Take one count from a semaphore without ever blocking.  See
+ *   include/nuttx/semaphore.h.
+ *
+ * Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sem_decrement(FAR sem_t *sem)
+{
+  FAR volatile spinlock_t *lock = sem_spinlock(sem);
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(lock);
+  sem->semcount--;
+  spin_unlock_irqrestore(lock, flags);
+}
+
+#endif /* CONFIG_SEM_SPINLOCKS */
@@ -49,12 +49,32 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/cancelpt.h>
 
 #include "sched/sched.h"
 #include "clock/clock.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer variant of sem_timeout().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void sem_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg)
+{
+  sem_timeout(1, (wdparm_t)(uintptr_t)arg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -162,6 +182,55 @@ int sem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime)
       goto errout_with_irqdisabled;
     }
 
+#ifdef CONFIG_HRTIMER
+  if (hrtimer_available())
+    {
+      struct hrtimer_s hrtimer;
+      struct timespec delay;
+
+      /* Get the time remaining until abstime.  We must have interrupts
+       * disabled here so that this time stays valid until the wait begins.
+       */
+
+      (void)clock_gettime(CLOCK_REALTIME, &delay);
+      clock_timespec_subtract(abstime, &delay, &delay);
+
+      /* If the time has already expired return immediately. */
+
+      if (delay.tv_sec == 0 && delay.tv_nsec == 0)
+        {
+          errcode = ETIMEDOUT;
+          goto errout_with_irqdisabled;
+        }
+
+      /* Start the timer and perform the blocking wait.  The timer lives on
+       * this stack; wd_recover() will cancel it if we are deleted.
+       */
+
+      hrtimer_init(&hrtimer);
+      rtcb->waithrtimer = &hrtimer;
+      (void)hrtimer_start(&hrtimer, &delay, sem_hrtimeout,
+                          (FAR void *)(uintptr_t)getpid());
+
+      errcode = OK;
+      ret = sem_wait(sem);
+      if (ret < 0)
+        {
+          errcode = get_errno();
+        }
+
+      hrtimer_cancel(&hrtimer);
+      rtcb->waithrtimer = NULL;
+
+      if (errcode != OK)
+        {
+          goto errout_with_irqdisabled;
+        }
+
+      goto success_with_irqdisabled;
+    }
+#endif
+
   /* Convert the timespec to clock ticks.  We must have interrupts
    * disabled here so that this time stays valid until the wait begins.
    */
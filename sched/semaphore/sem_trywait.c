@@ -89,10 +89,16 @@ int sem_trywait(FAR sem_t *sem)
   if (sem != NULL)
     {
       /* The following operations must be performed with interrupts disabled
-       * because sem_post() may be called from an interrupt handler.
+       * because sem_post() may be called from an interrupt handler.  No
+       * thread is blocked or awakened here so, with CONFIG_SEM_SPINLOCKS,
+       * only the spinlock of this semaphore is needed.
        */
 
+#ifdef CONFIG_SEM_SPINLOCKS
+      flags = spin_lock_irqsave(sem_spinlock(sem));
+#else
       flags = enter_critical_section();
+#endif
 
       /* If the semaphore is available, give it to the requesting task */
 
@@ -113,7 +119,11 @@ int sem_trywait(FAR sem_t *sem)
 
       /* Interrupts may now be enabled. */
 
+#ifdef CONFIG_SEM_SPINLOCKS
+      spin_unlock_irqrestore(sem_spinlock(sem), flags);
+#else
       leave_critical_section(flags);
+#endif
     }
   else
     {
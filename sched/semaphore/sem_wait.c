@@ -87,6 +87,28 @@ int sem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#if defined(CONFIG_SEM_SPINLOCKS) && !defined(CONFIG_CANCELLATION_POINTS)
+  /* If the semaphore is available, take it.  Only the spinlock of this
+   * semaphore is needed for this.
+   */
+
+  if (sem != NULL)
+    {
+      FAR volatile spinlock_t *lock = sem_spinlock(sem);
+
+      flags = spin_lock_irqsave(lock);
+      if (sem->semcount > 0)
+        {
+          sem->semcount--;
+          rtcb->waitsem = NULL;
+          spin_unlock_irqrestore(lock, flags);
+          return OK;
+        }
+
+      spin_unlock_irqrestore(lock, flags);
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -116,11 +138,14 @@ int sem_wait(FAR sem_t *sem)
     {
       /* Check if the lock is available */
 
+      sem_lock(sem);
       if (sem->semcount > 0)
         {
           /* It is, let the task take the semaphore. */
 
           sem->semcount--;
+          sem_unlock(sem);
+
           sem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -141,6 +166,7 @@ int sem_wait(FAR sem_t *sem)
           /* Handle the POSIX semaphore (but don't set the owner yet) */
 
           sem->semcount--;
+          sem_unlock(sem);
 
           /* Save the waited on semaphore in the TCB */
 
@@ -45,6 +45,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 
+#include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
 /****************************************************************************
@@ -109,7 +110,9 @@ void sem_waitirq(FAR struct tcb_s *wtcb, int errcode)
        * place.
        */
 
+      sem_lock(sem);
       sem->semcount++;
+      sem_unlock(sem);
 
       /* Indicate that the semaphore wait is over. */
 
@@ -117,7 +120,7 @@ void sem_waitirq(FAR struct tcb_s *wtcb, int errcode)
 
       /* Mark the errno value for the thread. */
 
-      wtcb->pterrno = errcode;
+      TCB_ERRNO(wtcb) = errcode;
 
       /* Restart the task. */
 
@@ -49,6 +49,8 @@
 #include <sched.h>
 #include <queue.h>
 
+#include <nuttx/spinlock.h>
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -63,7 +65,7 @@ extern "C"
 
 /* Common semaphore logic */
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_SEM_SPINLOCKS)
 void sem_initialize(void);
 #else
 #  define sem_initialize()
@@ -81,6 +83,26 @@ void sem_timeout(int argc, wdparm_t pid);
 
 void sem_recover(FAR struct tcb_s *tcb);
 
+/* Move the waiters of one semaphore to another */
+
+int sem_requeue(FAR sem_t *sem, FAR sem_t *target);
+
+/* Spinlocks that protect the semaphore count.  sem_lock() and sem_unlock()
+ * are used by logic that is already in a critical section.  Logic that does
+ * not take the critical section must use spin_lock_irqsave() on the
+ * spinlock returned by sem_spinlock().
+ */
+
+#ifdef CONFIG_SEM_SPINLOCKS
+void sem_initspinlocks(void);
+FAR volatile spinlock_t *sem_spinlock(FAR sem_t *sem);
+#  define sem_lock(sem)   spin_lock(sem_spinlock(sem))
+#  define sem_unlock(sem) spin_unlock(sem_spinlock(sem))
+#else
+#  define sem_lock(sem)
+#  define sem_unlock(sem)
+#endif
+
 /* Special logic needed only by priority inheritance to manage collections of
  * holders of semaphores.
  */
@@ -93,11 +115,9 @@ void sem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem);
 void sem_boostpriority(FAR sem_t *sem);
 void sem_releaseholder(FAR sem_t *sem);
 void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
-#  ifndef CONFIG_DISABLE_SIGNALS
 void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
-#  else
-#    define sem_canceled(stcb, sem)
-#  endif
+void sem_requeuewaiter(FAR struct tcb_s *wtcb);
+void sem_releaseheld(FAR struct tcb_s *htcb);
 #else
 #  define sem_initholders()
 #  define sem_destroyholder(sem)
@@ -107,6 +127,8 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define sem_releaseholder(sem)
 #  define sem_restorebaseprio(stcb,sem)
 #  define sem_canceled(stcb,sem)
+#  define sem_requeuewaiter(wtcb)
+#  define sem_releaseheld(htcb)
 #endif
 
 #undef EXTERN
@@ -120,16 +120,41 @@ void spin_initializer(FAR struct spinlock_s *lock)
 
 void spin_lock(FAR volatile spinlock_t *lock)
 {
+#ifdef CONFIG_SPINLOCK_TICKET
+  uint16_t ticket;
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock(this_task(), lock);
 #endif
 
-  while (up_testset(lock) == SP_LOCKED)
+#ifdef CONFIG_SPINLOCK_TICKET
+  /* Take a ticket and wait until it is served.  Only the atomic increment
+   * needs exclusive access to the spinlock; the wait uses plain reads.
+   */
+
+  ticket = SP_TICKET_NEXT(up_ticket(lock));
+  while (SP_TICKET_OWNER(*lock) != ticket)
     {
       SP_DSB();
     }
+#else
+  /* Wait until the spinlock appears to be free before each test-and-set so
+   * that waiting CPUs spin on their own cached copy of the spinlock rather
+   * than contending for exclusive access to it.
+   */
+
+  while (up_testset(lock) == SP_LOCKED)
+    {
+      do
+        {
+          SP_DSB();
+        }
+      while (*lock == SP_LOCKED);
+    }
+#endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
@@ -159,14 +184,33 @@ void spin_lock(FAR volatile spinlock_t *lock)
 #ifdef __SP_UNLOCK_FUNCTION
 void spin_unlock(FAR volatile spinlock_t *lock)
 {
+#ifdef CONFIG_SPINLOCK_TICKET
+  FAR volatile uint16_t *owner = (FAR volatile uint16_t *)lock;
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we are unlocking the spinlock */
 
   sched_note_spinunlock(this_task(), lock);
 #endif
 
+#ifdef CONFIG_SPINLOCK_TICKET
+  /* Serve the next ticket.  Only the holder modifies the lower 16-bits, but
+   * other CPUs may be taking tickets in the upper 16-bits at the same time.
+   * A half-word store leaves their tickets intact (and causes any exclusive
+   * access that they have in progress to be retried).
+   */
+
+#ifdef CONFIG_ENDIAN_BIG
+  owner++;
+#endif
+
+  SP_DMB();
+  *owner = SP_TICKET_OWNER(*lock) + 1;
+#else
   *lock = SP_UNLOCKED;
   SP_DMB();
+#endif
 }
 #endif
 
@@ -485,4 +529,187 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
   spin_unlock(setlock);
 }
 
+/****************************************************************************
+ * Name: rw_spin_rdlock
+ *
+ * Description:
+ *   Take a reader-writer spinlock for reading.  Wait while a writer holds
+ *   the lock or is waiting for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rw_spin_rdlock(FAR struct rw_spinlock_s *lock)
+{
+  for (; ; )
+    {
+      spin_lock(&lock->rw_lock);
+      if (lock->rw_writer == 0)
+        {
+          DEBUGASSERT(lock->rw_readers < UINT16_MAX);
+          lock->rw_readers++;
+          spin_unlock(&lock->rw_lock);
+          break;
+        }
+
+      spin_unlock(&lock->rw_lock);
+
+      /* Wait for the writer with plain reads */
+
+      while (lock->rw_writer != 0)
+        {
+          SP_DSB();
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rw_spin_rdunlock
+ *
+ * Description:
+ *   Release a reader-writer spinlock that was taken for reading.
+ *
+ * Input Parameters:
+ *   lock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rw_spin_rdunlock(FAR struct rw_spinlock_s *lock)
+{
+  spin_lock(&lock->rw_lock);
+  DEBUGASSERT(lock->rw_readers > 0);
+  lock->rw_readers--;
+  spin_unlock(&lock->rw_lock);
+}
+
+/****************************************************************************
+ * Name: rw_spin_wrlock
+ *
+ * Description:
+ *   Take a reader-writer spinlock for writing.  New readers and other
+ *   writers are excluded first; then wait until the current readers have
+ *   released the lock.
+ *
+ * Input Parameters:
+ *   lock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rw_spin_wrlock(FAR struct rw_spinlock_s *lock)
+{
+  for (; ; )
+    {
+      spin_lock(&lock->rw_lock);
+      if (lock->rw_writer == 0)
+        {
+          lock->rw_writer = 1;
+          spin_unlock(&lock->rw_lock);
+          break;
+        }
+
+      spin_unlock(&lock->rw_lock);
+
+      while (lock->rw_writer != 0)
+        {
+          SP_DSB();
+        }
+    }
+
+  /* Readers that already hold the lock may still release it */
+
+  while (lock->rw_readers != 0)
+    {
+      SP_DSB();
+    }
+
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: rw_spin_wrunlock
+ *
+ * Description:
+ *   Release a reader-writer spinlock that was taken for writing.
+ *
+ * Input Parameters:
+ *   lock - A reference to the reader-writer spinlock.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rw_spin_wrunlock(FAR struct rw_spinlock_s *lock)
+{
+  DEBUGASSERT(lock->rw_writer != 0 && lock->rw_readers == 0);
+
+  SP_DMB();
+  lock->rw_writer = 0;
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: spin_lock_irqsave
+ *
+ * Description:
+ *   Disable interrupts on the local CPU and then lock the spinlock.  See
+ *   include/nuttx/spinlock.h.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ * Returned Value:
+ *   The prior interrupt state that must be passed to
+ *   spin_unlock_irqrestore().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
+{
+  irqstate_t flags;
+
+  /* Interrupts must be disabled first so that an interrupt handler on this
+   * CPU cannot spin forever on a lock held by the code that it interrupted.
+   */
+
+  flags = up_irq_save();
+  spin_lock(lock);
+  return flags;
+}
+
+/****************************************************************************
+ * Name: spin_unlock_irqrestore
+ *
+ * Description:
+ *   Unlock a spinlock that was locked by spin_lock_irqsave() and then
+ *   restore the interrupt state of the local CPU.
+ *
+ * Input Parameters:
+ *   lock  - A reference to the spinlock object to unlock.
+ *   flags - The value returned by spin_lock_irqsave().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_unlock_irqrestore(FAR volatile spinlock_t *lock, irqstate_t flags)
+{
+  spin_unlock(lock);
+  up_irq_restore(flags);
+}
+#endif /* CONFIG_SMP */
+
 #endif /* CONFIG_SPINLOCK */
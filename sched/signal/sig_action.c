@@ -249,6 +249,9 @@ int sigaction(int signo, FAR const struct sigaction *act, FAR struct sigaction *
           /* Yes.. Remove it from signal action queue */
 
           sq_rem((FAR sq_entry_t *)sigact, &group->tg_sigactionq);
+#ifdef CONFIG_SIG_ACTIONTABLE
+          group->tg_sigaction[signo] = NULL;
+#endif
 
           /* And deallocate it */
 
@@ -285,6 +288,9 @@ int sigaction(int signo, FAR const struct sigaction *act, FAR struct sigaction *
           /* Add the new sigaction to signal action queue */
 
           sq_addlast((FAR sq_entry_t *)sigact, &group->tg_sigactionq);
+#ifdef CONFIG_SIG_ACTIONTABLE
+          group->tg_sigaction[signo] = sigact;
+#endif
         }
 
       /* Set the new sigaction */
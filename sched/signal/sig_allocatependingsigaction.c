@@ -55,15 +55,33 @@
  * Name: sig_allocatependingsigaction
  *
  * Description:
- *   Allocate a new element for the pending signal action queue
+ *   Allocate a new element for the pending signal action queue for the
+ *   signal action 'sigact'.
  *
  ****************************************************************************/
 
-FAR sigq_t *sig_allocatependingsigaction(void)
+FAR sigq_t *sig_allocatependingsigaction(FAR sigactq_t *sigact)
 {
   FAR sigq_t    *sigq;
   irqstate_t flags;
 
+#ifdef CONFIG_SIG_ACTIONSLOT
+  /* Use the slot that is preallocated in the sigaction if it is free */
+
+  flags = enter_critical_section();
+  if (!sigact->slotbusy)
+    {
+      sigact->slotbusy = true;
+      leave_critical_section(flags);
+
+      sigq       = &sigact->slot;
+      sigq->type = SIG_ALLOC_ACTION;
+      return sigq;
+    }
+
+  leave_critical_section(flags);
+#endif
+
   /* Check if we were called from an interrupt handler. */
 
   if (up_interrupt_context())
@@ -100,6 +100,9 @@ void sig_release(FAR struct task_group_s *group)
 
   while ((sigact = (FAR sigactq_t *)sq_remfirst(&group->tg_sigactionq)) != NULL)
     {
+#ifdef CONFIG_SIG_ACTIONTABLE
+      group->tg_sigaction[sigact->signo] = NULL;
+#endif
       sig_releaseaction(sigact);
     }
 
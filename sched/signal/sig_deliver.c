@@ -49,6 +49,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 
+#include "sched/sched.h"
 #include "semaphore/semaphore.h"
 #include "signal/signal.h"
 
@@ -82,7 +83,7 @@ void sig_deliver(FAR struct tcb_s *stcb)
    * was reawakened by a signal must be retained.
    */
 
-  saved_errno = stcb->pterrno;
+  saved_errno = TCB_ERRNO(stcb);
   for (sigq = (FAR sigq_t *)stcb->sigpendactionq.head; (sigq); sigq = next)
     {
       next = sigq->flink;
@@ -164,6 +165,6 @@ void sig_deliver(FAR struct tcb_s *stcb)
       sig_releasependingsigaction(sigq);
     }
 
-  stcb->pterrno = saved_errno;
+  TCB_ERRNO(stcb) = saved_errno;
   sched_unlock();
 }
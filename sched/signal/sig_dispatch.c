@@ -48,6 +48,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 
 #include "sched/sched.h"
 #include "group/group.h"
@@ -94,7 +95,7 @@ static int sig_queueaction(FAR struct tcb_s *stcb, siginfo_t *info)
        * sig_allocatependingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data */
 
-      sigq = sig_allocatependingsigaction();
+      sigq = sig_allocatependingsigaction(sigact);
       if (!sigq)
         {
           ret = -ENOMEM;
@@ -338,6 +339,12 @@ int sig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
         {
           leave_critical_section(flags);
           ASSERT(sig_addpendingsignal(stcb, info));
+
+#ifdef CONFIG_FS_SIGNALFD
+          /* Let any signalfd of the group know that the signal is pending */
+
+          signalfd_notify(stcb->group, info->si_signo);
+#endif
         }
     }
 
@@ -65,6 +65,14 @@ FAR sigactq_t *sig_findaction(FAR struct task_group_s *group, int signo)
        * protection.
        */
 
+#ifdef CONFIG_SIG_ACTIONTABLE
+      /* Just index the table of sigactions */
+
+      if (GOOD_SIGNO(signo))
+        {
+          sigact = group->tg_sigaction[signo];
+        }
+#else
       sched_lock();
 
       /* Seach the list for a sigaction on this signal */
@@ -74,6 +82,7 @@ FAR sigactq_t *sig_findaction(FAR struct task_group_s *group, int signo)
            sigact = sigact->flink);
 
       sched_unlock();
+#endif
     }
 
   return sigact;
@@ -257,6 +257,9 @@ void sig_allocateactionblock(void)
   sigact = g_sigactionalloc;
   for (i = 0; i < NUM_SIGNAL_ACTIONS; i++)
     {
+#ifdef CONFIG_SIG_ACTIONSLOT
+      sigact->slotbusy = false;
+#endif
       sq_addlast((FAR sq_entry_t *)sigact++, &g_sigfreeaction);
     }
 }
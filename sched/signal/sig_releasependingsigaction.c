@@ -98,4 +98,16 @@ void sig_releasependingsigaction(FAR sigq_t *sigq)
     {
       sched_kfree(sigq);
     }
+
+#ifdef CONFIG_SIG_ACTIONSLOT
+  /* If this is the slot embedded in a sigaction, then just mark it free.
+   * The sigaction container itself is never freed so this is safe even if
+   * the action was removed while the slot was queued.
+   */
+
+  else if (sigq->type == SIG_ALLOC_ACTION)
+    {
+      SIG_SLOT2ACTION(sigq)->slotbusy = false;
+    }
+#endif
 }
@@ -52,6 +52,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/cancelpt.h>
 
 #include "sched/sched.h"
@@ -140,6 +141,28 @@ static void sig_timeout(int argc, wdparm_t itcb)
 #endif
 }
 
+/****************************************************************************
+ * Name: sig_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer variant of sig_timeout().
+ *
+ * Assumptions:
+ *   This function executes in the context of the oneshot timer interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void sig_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg)
+{
+  union wdparm_u wdparm;
+
+  wdparm.pvarg = arg;
+  sig_timeout(1, (wdparm_t)wdparm.uiarg);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -254,6 +277,30 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       /* Check if we should wait for the timeout */
 
+#ifdef CONFIG_HRTIMER
+      if (timeout != NULL && hrtimer_available())
+        {
+          /* Use a high resolution timer so that the timeout is not
+           * rounded up to the system timer tick.  The timer is kept on
+           * this stack; wd_recover() will cancel it if we are deleted.
+           */
+
+          struct hrtimer_s hrtimer;
+
+          hrtimer_init(&hrtimer);
+          rtcb->waithrtimer = &hrtimer;
+          (void)hrtimer_start(&hrtimer, timeout, sig_hrtimeout,
+                              (FAR void *)rtcb);
+
+          /* Now wait for either the signal or the timer */
+
+          up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+          hrtimer_cancel(&hrtimer);
+          rtcb->waithrtimer = NULL;
+        }
+      else
+#endif
       if (timeout != NULL)
         {
           /* Convert the timespec to system clock ticks, making sure that
@@ -43,6 +43,8 @@
 #include <nuttx/compiler.h>
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <queue.h>
 #include <sched.h>
 
@@ -62,6 +64,13 @@
 #define NUM_SIGNALS_PENDING     16
 #define NUM_INT_SIGNALS_PENDING  8
 
+/* Recover the sigaction container from its embedded pending action slot */
+
+#ifdef CONFIG_SIG_ACTIONSLOT
+#  define SIG_SLOT2ACTION(q) \
+     ((FAR sigactq_t *)((FAR char *)(q) - offsetof(sigactq_t, slot)))
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -70,20 +79,11 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_ACTION      /* The slot embedded in a sigaction container */
 };
 typedef enum sigalloc_e sigalloc_t;
 
-/* The following defines the sigaction queue entry */
-
-struct sigactq
-{
-  FAR struct sigactq *flink;     /* Forward link */
-  struct sigaction act;          /* Sigaction data */
-  uint8_t   signo;               /* Signal associated with action */
-};
-typedef struct sigactq  sigactq_t;
-
 /* The following defines the queue structure within each TCB to hold pending
  * signals received by the task.  These are signals that cannot be processed
  * because:  (1) the task is not waiting for them, or (2) the task has no
@@ -116,6 +116,20 @@ struct sigq_s
 };
 typedef struct sigq_s sigq_t;
 
+/* The following defines the sigaction queue entry */
+
+struct sigactq
+{
+  FAR struct sigactq *flink;     /* Forward link */
+  struct sigaction act;          /* Sigaction data */
+  uint8_t   signo;               /* Signal associated with action */
+#ifdef CONFIG_SIG_ACTIONSLOT
+  bool      slotbusy;            /* True: slot is queued or being delivered */
+  sigq_t    slot;                /* Preallocated pending signal action */
+#endif
+};
+typedef struct sigactq  sigactq_t;
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -184,7 +198,7 @@ void               sig_release(FAR struct task_group_s *group);
 
 /* In files of the same name */
 
-FAR sigq_t        *sig_allocatependingsigaction(void);
+FAR sigq_t        *sig_allocatependingsigaction(FAR sigactq_t *sigact);
 void               sig_deliver(FAR struct tcb_s *stcb);
 FAR sigactq_t     *sig_findaction(FAR struct task_group_s *group, int signo);
 int                sig_lowest(FAR sigset_t *set);
@@ -95,7 +95,8 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)kmm_zalloc_hint(sizeof(struct task_tcb_s),
+                                                MM_PLACE_TCB);
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -100,4 +100,13 @@ void task_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(sched_sporadic_stop(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Stop current deadline scheduling and release its bandwidth */
+
+      DEBUGVERIFY(sched_deadline_stop(tcb));
+    }
+#endif
 }
@@ -266,7 +266,8 @@ FAR struct task_tcb_s *task_vforksetup(start_t retaddr)
 
   /* Allocate a TCB for the child task. */
 
-  child = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+  child = (FAR struct task_tcb_s *)kmm_zalloc_hint(sizeof(struct task_tcb_s),
+                                                  MM_PLACE_TCB);
   if (!child)
     {
       serr("ERROR: Failed to allocate TCB\n");
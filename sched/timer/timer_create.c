@@ -204,6 +204,9 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_owner = getpid();
   ret->pt_delay = 0;
   ret->pt_wdog  = wdog;
+#ifdef CONFIG_HRTIMER
+  hrtimer_init(&ret->pt_hrtimer);
+#endif
 
   /* Was a struct sigevent provided? */
 
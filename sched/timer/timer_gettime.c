@@ -94,6 +94,17 @@ int timer_gettime(timer_t timerid, FAR struct itimerspec *value)
       return ERROR;
     }
 
+#ifdef CONFIG_HRTIMER
+  if (hrtimer_available())
+    {
+      /* Get the time before the underlying high resolution timer expires */
+
+      hrtimer_gettime(&timer->pt_hrtimer, &value->it_value);
+      value->it_interval = timer->pt_interval;
+      return OK;
+    }
+#endif
+
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(timer->pt_wdog);
@@ -61,6 +61,9 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer);
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer);
 static void timer_timeout(int argc, wdparm_t itimer);
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -230,6 +233,113 @@ static void timer_timeout(int argc, wdparm_t itimer)
 #endif
 }
 
+/****************************************************************************
+ * Name: timer_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer variant of timer_timeout().  A repetitive
+ *   timer is restarted relative to its previous expiration time.
+ *
+ * Parameters:
+ *   hrtimer - The high resolution timer that expired
+ *   arg     - A reference to the POSIX timer that just timed out
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   This function executes in the context of the oneshot timer interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static void timer_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg)
+{
+  FAR struct posix_timer_s *timer = (FAR struct posix_timer_s *)arg;
+
+  /* Send the specified signal to the specified task, holding a reference
+   * so that the timer will not be deleted until after the signal handler
+   * returns.
+   */
+
+  timer->pt_crefs++;
+  timer_signotify(timer);
+
+  if (timer_release(timer))
+    {
+      /* If this is a repetitive timer, then restart it */
+
+      if (timer->pt_interval.tv_sec > 0 || timer->pt_interval.tv_nsec > 0)
+        {
+          (void)hrtimer_start(&timer->pt_hrtimer, &timer->pt_interval,
+                              timer_hrtimeout, timer);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: timer_hrsettime
+ *
+ * Description:
+ *   The high resolution timer variant of the body of timer_settime().
+ *
+ ****************************************************************************/
+
+static int timer_hrsettime(FAR struct posix_timer_s *timer, int flags,
+                           FAR const struct itimerspec *value)
+{
+  struct timespec delay;
+  irqstate_t intflags;
+  int ret = OK;
+
+  /* Setup up any repetitive timer */
+
+  if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
+    {
+      timer->pt_interval = value->it_interval;
+    }
+  else
+    {
+      timer->pt_interval.tv_sec  = 0;
+      timer->pt_interval.tv_nsec = 0;
+    }
+
+  intflags = enter_critical_section();
+
+  /* Check if abstime is selected */
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      /* Calculate a delay corresponding to the absolute time in 'value' */
+
+      (void)clock_gettime(CLOCK_REALTIME, &delay);
+      clock_timespec_subtract(&value->it_value, &delay, &delay);
+    }
+  else
+    {
+      delay = value->it_value;
+    }
+
+  /* If the time is in the past or now, then set up the next interval
+   * instead (assuming a repetitive timer).
+   */
+
+  if (delay.tv_sec == 0 && delay.tv_nsec == 0)
+    {
+      delay = timer->pt_interval;
+    }
+
+  if (delay.tv_sec > 0 || delay.tv_nsec > 0)
+    {
+      ret = hrtimer_start(&timer->pt_hrtimer, &delay, timer_hrtimeout,
+                          timer);
+    }
+
+  leave_critical_section(intflags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -320,6 +430,9 @@ int timer_settime(timer_t timerid, int flags,
    */
 
   (void)wd_cancel(timer->pt_wdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#endif
 
   /* If the it_value member of value is zero, the timer will not be re-armed */
 
@@ -328,6 +441,15 @@ int timer_settime(timer_t timerid, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Use the high resolution timer, if one has been provided */
+
+  if (hrtimer_available())
+    {
+      return timer_hrsettime(timer, flags, value);
+    }
+#endif
+
   /* Setup up any repititive timer */
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
@@ -72,8 +72,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -89,6 +91,15 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Unlink the watchdog from its wheel slot.  There is no cheap way to
+       * know if this was the next watchdog to expire so the interval timer
+       * is always reassessed (this does nothing if not tickless).
+       */
+
+      wd_wheel_remove(wdog);
+      sched_timer_reassess();
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -139,9 +150,11 @@ int wd_cancel(WDOG_ID wdog)
           sched_timer_reassess();
         }
 
+      wdog->next = NULL;
+#endif
+
       /* Mark the watchdog inactive */
 
-      wdog->next = NULL;
       WDOG_CLRACTIVE(wdog);
 
       /* Return success */
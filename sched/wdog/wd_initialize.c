@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
 #include <queue.h>
 
 #include "wdog/wdog.h"
@@ -56,9 +57,17 @@ sq_queue_t g_wdfreelist;
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
+ *
+ * With CONFIG_WDOG_TIMERWHEEL, the active watchdogs are held in the slots
+ * of g_wdwheel instead and g_wdclock is the most recently processed tick.
  */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+FAR struct wdog_s *g_wdwheel[WDOG_WHEELSIZE];
+uint32_t g_wdclock;
+#else
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -108,7 +117,12 @@ void wd_initialize(void)
   /* Initialize watchdog lists */
 
   sq_init(&g_wdfreelist);
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  memset(g_wdwheel, 0, sizeof(g_wdwheel));
+  g_wdclock = 0;
+#else
   sq_init(&g_wdactivelist);
+#endif
 
   /* The g_wdfreelist must be loaded at initialization time to hold the
    * configured number of watchdogs.
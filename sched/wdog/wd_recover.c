@@ -42,6 +42,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/sched.h>
 
 #include "wdog/wdog.h"
@@ -88,5 +89,17 @@ void wd_recover(FAR struct tcb_s *tcb)
       tcb->waitdog = NULL;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* A high resolution timed wait uses a timer that lives on the stack of
+   * the waiting task.  It must be stopped before that stack is released.
+   */
+
+  if (tcb->waithrtimer)
+    {
+      hrtimer_cancel(tcb->waithrtimer);
+      tcb->waithrtimer = NULL;
+    }
+
+#endif
   leave_critical_section(flags);
 }
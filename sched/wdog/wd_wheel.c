@@ -0,0 +1,211 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires 'delay' ticks
+ *   after the current wheel tick.  This is a constant time operation.
+ *
+ * Parameters:
+ *   wdog  - The watchdog to be added.  It must not already be active.
+ *   delay - The delay in clock ticks (must be greater than zero).
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay)
+{
+  FAR struct wdog_s **slot;
+  uint32_t expire;
+
+  DEBUGASSERT(wdog != NULL && delay > 0);
+
+  /* The lag field holds the absolute expiration tick */
+
+  expire    = g_wdclock + (uint32_t)delay;
+  wdog->lag = (int)expire;
+
+  /* Add the watchdog at the head of its slot list */
+
+  slot       = &g_wdwheel[WDOG_SLOT(expire)];
+  wdog->prev = NULL;
+  wdog->next = *slot;
+
+  if (*slot != NULL)
+    {
+      (*slot)->prev = wdog;
+    }
+
+  *slot = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.  This is a constant
+ *   time operation.
+ *
+ * Parameters:
+ *   wdog  - The active watchdog to be removed.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  DEBUGASSERT(wdog != NULL);
+
+  if (wdog->prev != NULL)
+    {
+      wdog->prev->next = wdog->next;
+    }
+  else
+    {
+      DEBUGASSERT(g_wdwheel[WDOG_SLOT(wdog->lag)] == wdog);
+      g_wdwheel[WDOG_SLOT(wdog->lag)] = wdog->next;
+    }
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->prev = wdog->prev;
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_nextdelay
+ *
+ * Description:
+ *   Return the number of ticks from the current wheel tick until the next
+ *   watchdog expires.  This visits at most one revolution of the wheel
+ *   (plus all watchdogs if none expires within that revolution).
+ *
+ * Parameters:
+ *   None
+ *
+ * Return Value:
+ *   The delay to the earliest expiration or zero if there are no active
+ *   watchdogs.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_wheel_nextdelay(void)
+{
+  FAR struct wdog_s *curr;
+  unsigned int offset;
+  int32_t remaining;
+  int32_t best = INT32_MAX;
+  bool found = false;
+
+  /* Visit the slots in the order that the wheel will reach them.  A
+   * watchdog in the slot at 'offset' expires either in 'offset' ticks or
+   * in some later revolution.  So the first watchdog found that expires
+   * in this revolution is the earliest; the later slots can only hold
+   * later expirations.
+   */
+
+  for (offset = 1; offset <= WDOG_WHEELSIZE; offset++)
+    {
+      for (curr = g_wdwheel[WDOG_SLOT(g_wdclock + offset)];
+           curr != NULL;
+           curr = curr->next)
+        {
+          remaining = WDOG_REMAINING(curr);
+          if (remaining < best)
+            {
+              best = remaining;
+            }
+
+          found = true;
+        }
+
+      if (found && best <= (int32_t)offset)
+        {
+          break;
+        }
+    }
+
+  if (!found)
+    {
+      /* There are no active watchdogs */
+
+      return 0;
+    }
+
+  /* A watchdog that is already due expires on the next tick */
+
+  return best > 0 ? (unsigned int)best : 1;
+}
+#endif /* CONFIG_SCHED_TICKLESS */
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -48,6 +48,20 @@
 #include <nuttx/compiler.h>
 #include <nuttx/wdog.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  define WDOG_WHEELSIZE     (1 << CONFIG_WDOG_WHEELBITS)
+#  define WDOG_WHEELMASK     (WDOG_WHEELSIZE - 1)
+#  define WDOG_SLOT(t)       ((uint32_t)(t) & WDOG_WHEELMASK)
+
+/* The number of ticks remaining before the watchdog expires (signed) */
+
+#  define WDOG_REMAINING(w)  ((int32_t)((uint32_t)(w)->lag - g_wdclock))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -71,7 +85,19 @@ extern sq_queue_t g_wdfreelist;
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/* With CONFIG_WDOG_TIMERWHEEL, active watchdogs are instead kept in the
+ * doubly linked slot lists of a hashed timer wheel.  The slot is selected
+ * by the low bits of the absolute expiration tick of the watchdog which is
+ * then held in the lag field.  g_wdclock is the tick of the wheel that was
+ * most recently processed.
+ */
+
+extern FAR struct wdog_s *g_wdwheel[WDOG_WHEELSIZE];
+extern uint32_t g_wdclock;
+#else
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
@@ -136,6 +162,73 @@ unsigned int wd_timer(int ticks);
 void wd_timer(void);
 #endif
 
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires 'delay' ticks
+ *   after the current wheel tick.  This is a constant time operation.
+ *
+ * Parameters:
+ *   wdog  - The watchdog to be added.  It must not already be active.
+ *   delay - The delay in clock ticks (must be greater than zero).
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.  This is a constant
+ *   time operation.
+ *
+ * Parameters:
+ *   wdog  - The active watchdog to be removed.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_nextdelay
+ *
+ * Description:
+ *   Return the number of ticks from the current wheel tick until the next
+ *   watchdog expires.  This visits at most one revolution of the wheel
+ *   (plus all watchdogs if none expires within that revolution).
+ *
+ * Parameters:
+ *   None
+ *
+ * Return Value:
+ *   The delay to the earliest expiration or zero if there are no active
+ *   watchdogs.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_wheel_nextdelay(void);
+#endif
+#endif /* CONFIG_WDOG_TIMERWHEEL */
+
 /****************************************************************************
  * Name: wd_recover
  *
@@ -142,9 +142,25 @@ int work_cancel(int qid, FAR struct work_s *work)
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      FAR struct kwork_wqueue_s *wqueue;
+      irqstate_t flags;
+      int ret;
+
+      /* Cancel high priority work.  The work may be in the queue of any
+       * CPU.
+       */
+
+      flags  = enter_critical_section();
+      wqueue = work_hpqueue(work);
+      ret    = work_qcancel(wqueue, work);
+      leave_critical_section(flags);
+      return ret;
+#else
       /* Cancel high priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork[0], work);
+#endif
     }
   else
 #endif
@@ -39,10 +39,14 @@
 
 #include <nuttx/config.h>
 
+#include <unistd.h>
+#include <sched.h>
 #include <errno.h>
 #include <queue.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
@@ -56,9 +60,9 @@
  * Public Data
  ****************************************************************************/
 
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
 
-struct hp_wqueue_s g_hpwork;
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 
 /****************************************************************************
  * Private Functions
@@ -92,11 +96,34 @@ struct hp_wqueue_s g_hpwork;
 
 static int work_hpthread(int argc, char *argv[])
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  int wndx;
+  pid_t me = getpid();
+  int i;
+
+  /* Find out thread index by search the workers in g_hpwork[].  There is
+   * one worker thread for each CPU and the index is the CPU index.
+   */
+
+  for (wndx = 0, i = 0; i < HPWORK_NQUEUES; i++)
+    {
+      if (g_hpwork[i].worker[0].pid == me)
+        {
+          wndx = i;
+          break;
+        }
+    }
+
+  DEBUGASSERT(i < HPWORK_NQUEUES);
+#else
+  const int wndx = 0;
+#endif
+
   /* Loop forever */
 
   for (; ; )
     {
-#ifndef CONFIG_SCHED_LPWORK
+#if !defined(CONFIG_SCHED_LPWORK) && !defined(CONFIG_SCHED_GARBAGE_THREAD)
       /* First, perform garbage collection.  This cleans-up memory
        * de-allocations that were queued because they could not be freed in
        * that execution context (for example, if the memory was freed from
@@ -108,15 +135,27 @@ static int work_hpthread(int argc, char *argv[])
        * thread instead.
        */
 
-      sched_garbage_collection();
+      if (wndx == 0)
+        {
+          sched_garbage_collection();
+        }
+#endif
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      /* Take over any ready work that is waiting behind a busy worker
+       * thread on another CPU.
+       */
+
+      work_hpsteal(wndx);
 #endif
 
       /* Then process queued work.  work_process will not return until: (1)
        * there is no further work in the work queue, and (2) the polling
-       * period provided by g_hpwork.delay expires.
+       * period provided by g_hpwork[].delay expires.
        */
 
-      work_process((FAR struct kwork_wqueue_s *)&g_hpwork, g_hpwork.delay, 0);
+      work_process((FAR struct kwork_wqueue_s *)&g_hpwork[wndx],
+                   g_hpwork[wndx].delay, 0);
     }
 
   return OK; /* To keep some compilers happy */
@@ -126,6 +165,99 @@ static int work_hpthread(int argc, char *argv[])
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_hpqueue
+ *
+ * Description:
+ *   Return the per-CPU high priority work queue that holds the queued work.
+ *   Queued work may have been moved to the queue of another CPU, but only
+ *   the head and tail of a queue refer to the queue itself.  Work in the
+ *   middle of any queue can be removed using any of the queues.
+ *
+ * Input parameters:
+ *   work - The queued work structure
+ *
+ * Returned Value:
+ *   The work queue that may be used to remove the work
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+FAR struct kwork_wqueue_s *work_hpqueue(FAR struct work_s *work)
+{
+  int cpu;
+
+  for (cpu = 0; cpu < HPWORK_NQUEUES; cpu++)
+    {
+      if (g_hpwork[cpu].q.head == (FAR dq_entry_t *)work ||
+          g_hpwork[cpu].q.tail == (FAR dq_entry_t *)work)
+        {
+          return (FAR struct kwork_wqueue_s *)&g_hpwork[cpu];
+        }
+    }
+
+  return (FAR struct kwork_wqueue_s *)&g_hpwork[0];
+}
+
+/****************************************************************************
+ * Name: work_hpsteal
+ *
+ * Description:
+ *   Move work that is ready to execute from the per-CPU high priority work
+ *   queues with busy worker threads to the queue of the indicated CPU.
+ *   Work whose delay has not yet expired is left where it is.
+ *
+ * Input parameters:
+ *   cpu - The index of the CPU whose worker thread will perform the work
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void work_hpsteal(int cpu)
+{
+  FAR struct work_s *work;
+  FAR struct work_s *next;
+  irqstate_t flags;
+  systime_t ctick;
+  int victim;
+
+  flags = enter_critical_section();
+  ctick = clock_systimer();
+
+  for (victim = 0; victim < HPWORK_NQUEUES; victim++)
+    {
+      /* Only work that is held up by a busy worker thread is taken.  Idle
+       * worker threads will be signalled when their work is queued.
+       */
+
+      if (victim == cpu || !g_hpwork[victim].worker[0].busy)
+        {
+          continue;
+        }
+
+      for (work = (FAR struct work_s *)g_hpwork[victim].q.head;
+           work != NULL;
+           work = next)
+        {
+          next = (FAR struct work_s *)work->dq.flink;
+
+          if (work->worker != NULL && ctick - work->qtime >= work->delay)
+            {
+              dq_rem((FAR dq_entry_t *)work, &g_hpwork[victim].q);
+              dq_addlast((FAR dq_entry_t *)work, &g_hpwork[cpu].q);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif /* CONFIG_SCHED_HPWORK_PERCPU */
+
 /****************************************************************************
  * Name: work_hpstart
  *
@@ -143,35 +275,59 @@ static int work_hpthread(int argc, char *argv[])
 
 int work_hpstart(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  cpu_set_t cpuset;
+#endif
   pid_t pid;
+  int wndx;
 
-  /* Initialize work queue data structures */
-
-  g_hpwork.delay          = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
-  dq_init(&g_hpwork.q);
+  /* Don't permit any of the threads to run until we have fully initialized
+   * g_hpwork[].
+   */
 
-  /* Start the high-priority, kernel mode worker thread */
+  sched_lock();
 
-  sinfo("Starting high-priority kernel worker thread\n");
+  /* Start the high-priority, kernel mode worker thread(s) */
 
-  pid = kernel_thread(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
-                      CONFIG_SCHED_HPWORKSTACKSIZE,
-                      (main_t)work_hpthread,
-                      (FAR char * const *)NULL);
+  sinfo("Starting high-priority kernel worker thread(s)\n");
 
-  DEBUGASSERT(pid > 0);
-  if (pid < 0)
+  for (wndx = 0; wndx < HPWORK_NQUEUES; wndx++)
     {
-      int errcode = errno;
-      DEBUGASSERT(errcode > 0);
+      /* Initialize work queue data structures */
+
+      g_hpwork[wndx].delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
+      dq_init(&g_hpwork[wndx].q);
+
+      pid = kernel_thread(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                          CONFIG_SCHED_HPWORKSTACKSIZE,
+                          (main_t)work_hpthread,
+                          (FAR char * const *)NULL);
+
+      DEBUGASSERT(pid > 0);
+      if (pid < 0)
+        {
+          int errcode = errno;
+          DEBUGASSERT(errcode > 0);
+
+          serr("ERROR: kernel_thread %d failed: %d\n", wndx, errcode);
+          sched_unlock();
+          return -errcode;
+        }
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      /* Each worker thread runs only on the CPU that it serves */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wndx, &cpuset);
+      DEBUGVERIFY(sched_setaffinity(pid, sizeof(cpu_set_t), &cpuset));
+#endif
 
-      serr("ERROR: kernel_thread failed: %d\n", errcode);
-      return -errcode;
+      g_hpwork[wndx].worker[0].pid  = pid;
+      g_hpwork[wndx].worker[0].busy = true;
     }
 
-  g_hpwork.worker[0].pid  = pid;
-  g_hpwork.worker[0].busy = true;
-  return pid;
+  sched_unlock();
+  return g_hpwork[0].worker[0].pid;
 }
 
 #endif /* CONFIG_SCHED_HPWORK */
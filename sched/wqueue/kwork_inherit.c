@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <unistd.h>
 #include <sched.h>
 
 #include <nuttx/irq.h>
@@ -58,11 +59,11 @@
  * Name: lpwork_boostworker
  *
  * Description:
- *   Called by the work queue client to assure that the priority of the low-
- *   priority worker thread is at least at the requested level, reqprio. This
- *   function would normally be called just before calling work_queue().
+ *   Assure that the priority of the low-priority worker thread is at least
+ *   at the requested level, reqprio.
  *
  * Parameters:
+ *   wpid    - The task ID of the worker thread
  *   reqprio - Requested minimum worker thread priority
  *
  * Return Value:
@@ -169,12 +170,12 @@ static void lpwork_boostworker(pid_t wpid, uint8_t reqprio)
  * Name: lpwork_restoreworker
  *
  * Description:
- *   This function is called to restore the priority after it was previously
- *   boosted.  This is often done by client logic on the worker thread when
- *   the scheduled work completes.  It will check if we need to drop the
- *   priority of the worker thread.
+ *   Restore the priority of the worker thread after it was previously
+ *   boosted.  It will check if we need to drop the priority of the worker
+ *   thread.
  *
  * Parameters:
+ *   wpid    - The task ID of the worker thread
  *   reqprio - Previously requested minimum worker thread priority to be
  *     "unboosted"
  *
@@ -317,9 +318,11 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
  * Name: lpwork_boostpriority
  *
  * Description:
- *   Called by the work queue client to assure that the priority of the low-
- *   priority worker thread is at least at the requested level, reqprio. This
- *   function would normally be called just before calling work_queue().
+ *   Called by a low-priority worker thread just before it performs a work
+ *   item to assure that its priority is at least at the priority requested
+ *   for the work item, reqprio.  Only the calling worker thread is
+ *   affected; the other threads of the pool keep the priority of the work
+ *   that they are performing.
  *
  * Parameters:
  *   reqprio - Requested minimum worker thread priority
@@ -332,7 +335,6 @@ static void lpwork_restoreworker(pid_t wpid, uint8_t reqprio)
 void lpwork_boostpriority(uint8_t reqprio)
 {
   irqstate_t flags;
-  int wndx;
 
   /* Clip to the configured maximum priority */
 
@@ -346,12 +348,7 @@ void lpwork_boostpriority(uint8_t reqprio)
   flags = enter_critical_section();
   sched_lock();
 
-  /* Adjust the priority of every worker thread */
-
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
-    {
-      lpwork_boostworker(g_lpwork.worker[wndx].pid, reqprio);
-    }
+  lpwork_boostworker(getpid(), reqprio);
 
   sched_unlock();
   leave_critical_section(flags);
@@ -361,10 +358,8 @@ void lpwork_boostpriority(uint8_t reqprio)
  * Name: lpwork_restorepriority
  *
  * Description:
- *   This function is called to restore the priority after it was previously
- *   boosted.  This is often done by client logic on the worker thread when
- *   the scheduled work completes.  It will check if we need to drop the
- *   priority of the worker thread.
+ *   Called by a low-priority worker thread when it has completed a work
+ *   item to drop the priority boost applied by lpwork_boostpriority().
  *
  * Parameters:
  *   reqprio - Previously requested minimum worker thread priority to be
@@ -378,7 +373,6 @@ void lpwork_boostpriority(uint8_t reqprio)
 void lpwork_restorepriority(uint8_t reqprio)
 {
   irqstate_t flags;
-  int wndx;
 
   /* Clip to the configured maximum priority */
 
@@ -392,12 +386,7 @@ void lpwork_restorepriority(uint8_t reqprio)
   flags = enter_critical_section();
   sched_lock();
 
-  /* Adjust the priority of every worker thread */
-
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
-    {
-      lpwork_restoreworker(g_lpwork.worker[wndx].pid, reqprio);
-    }
+  lpwork_restoreworker(getpid(), reqprio);
 
   sched_unlock();
   leave_critical_section(flags);
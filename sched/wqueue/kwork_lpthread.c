@@ -44,6 +44,7 @@
 #include <string.h>
 #include <errno.h>
 #include <queue.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/wqueue.h>
@@ -141,10 +142,13 @@ static int work_lpthread(int argc, char *argv[])
            * the IDLE thread (at a very, very low priority).
            *
            * In the event of multiple low priority threads, on index == 0 will do
-           * the garbage collection.
+           * the garbage collection.  If there is a dedicated garbage
+           * collection thread, then it does this instead.
            */
 
+#ifndef CONFIG_SCHED_GARBAGE_THREAD
           sched_garbage_collection();
+#endif
 
           /* Then process queued work.  work_process will not return until:
            * (1) there is no further work in the work queue, and (2) the polling
@@ -179,6 +183,9 @@ static int work_lpthread(int argc, char *argv[])
 
 int work_lpstart(void)
 {
+#ifdef CONFIG_SCHED_LPWORK_RR
+  struct sched_param param;
+#endif
   pid_t pid;
   int wndx;
 
@@ -219,6 +226,13 @@ int work_lpstart(void)
 
       g_lpwork.worker[wndx].pid  = pid;
       g_lpwork.worker[wndx].busy = true;
+
+#ifdef CONFIG_SCHED_LPWORK_RR
+      /* Time-slice the worker threads when they run at the same priority */
+
+      param.sched_priority = CONFIG_SCHED_LPWORKPRIORITY;
+      DEBUGVERIFY(sched_setscheduler(pid, SCHED_RR, &param));
+#endif
     }
 
   sched_unlock();
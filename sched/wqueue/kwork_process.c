@@ -98,6 +98,9 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx)
   worker_t  worker;
   irqstate_t flags;
   FAR void *arg;
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+  uint8_t prio;
+#endif
   systime_t elapsed;
   systime_t remaining;
   systime_t stick;
@@ -152,6 +155,9 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx)
               /* Extract the work argument (before re-enabling interrupts) */
 
               arg = work->arg;
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+              prio = work->prio;
+#endif
 
               /* Mark the work as no longer being queued */
 
@@ -162,7 +168,25 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx)
                */
 
               leave_critical_section(flags);
-              worker(arg);
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+              /* Low priority work is performed at the priority requested
+               * when the work was queued.  Only this worker thread is
+               * boosted and only for the duration of this work.
+               */
+
+              if (wqueue == (FAR struct kwork_wqueue_s *)&g_lpwork &&
+                  prio > CONFIG_SCHED_LPWORKPRIORITY)
+                {
+                  lpwork_boostpriority(prio);
+                  worker(arg);
+                  lpwork_restorepriority(prio);
+                }
+              else
+#endif
+                {
+                  worker(arg);
+                }
 
               /* Now, unfortunately, since we re-enabled interrupts we don't
                * know the state of the work list and we will have to start
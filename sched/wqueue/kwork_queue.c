@@ -126,6 +126,82 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: lpwork_qqueue
+ *
+ * Description:
+ *   Queue work on the low priority work queue.  This is the same as
+ *   work_qqueue() except that the work is inserted after all pending work
+ *   of equal or higher priority instead of at the end of the work queue.
+ *
+ * Input parameters:
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   prio   - The priority of the work
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+static void lpwork_qqueue(FAR struct work_s *work, worker_t worker,
+                          FAR void *arg, systime_t delay, uint8_t prio)
+{
+  FAR struct work_s *prev;
+  irqstate_t flags;
+
+  DEBUGASSERT(work != NULL && worker != NULL);
+
+  flags = enter_critical_section();
+
+  /* Is there already pending work? */
+
+  if (work->worker != NULL)
+    {
+      /* Remove the entry from the work queue.  It will be re-inserted below
+       * in priority order.
+       */
+
+      dq_rem((FAR dq_entry_t *)work, &g_lpwork.q);
+    }
+
+  /* Initialize the work structure. */
+
+  work->worker = worker;           /* Work callback. non-NULL means queued */
+  work->arg    = arg;              /* Callback argument */
+  work->delay  = delay;            /* Delay until work performed */
+  work->prio   = prio;             /* Priority of the work */
+  work->qtime  = clock_systimer(); /* Time work queued */
+
+  /* Search backward from the tail of the work queue for the last work of
+   * equal or higher priority.  Most work is queued at the default
+   * priority so this search normally terminates immediately.
+   */
+
+  for (prev = (FAR struct work_s *)g_lpwork.q.tail;
+       prev != NULL && prev->prio < prio;
+       prev = (FAR struct work_s *)prev->dq.blink);
+
+  if (prev != NULL)
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work,
+                  &g_lpwork.q);
+    }
+  else
+    {
+      dq_addfirst((FAR dq_entry_t *)work, &g_lpwork.q);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -149,8 +225,8 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
  *   work   - The work structure to queue
  *   worker - The worker callback to be invoked.  The callback will invoked
  *            on the worker thread of execution.
- *   arg    - The argument that will be passed to the workder callback when
- *            int is invoked.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
  *   delay  - Delay (in clock ticks) from the time queue until the worker
  *            is invoked. Zero means to perform the work immediately.
  *
@@ -167,9 +243,30 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      irqstate_t flags;
+
+      /* Queue high priority work on the queue of this CPU.  Any pending
+       * instance of the work is removed first since it may be in the queue
+       * of another CPU.
+       */
+
+      flags = enter_critical_section();
+      if (work->worker != NULL)
+        {
+          dq_rem((FAR dq_entry_t *)work, &work_hpqueue(work)->q);
+          work->worker = NULL;
+        }
+
+      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork[up_cpu_index()],
+                  work, worker, arg, delay);
+      leave_critical_section(flags);
+#else
       /* Queue high priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
+      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork[0], work, worker,
+                  arg, delay);
+#endif
       return work_signal(HPWORK);
     }
   else
@@ -177,10 +274,17 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 #ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* Queue low priority work at the default priority */
+
+      return lpwork_queue(work, worker, arg, delay,
+                          CONFIG_SCHED_LPWORKPRIORITY);
+#else
       /* Queue low priority work */
 
       work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
       return work_signal(LPWORK);
+#endif
     }
   else
 #endif
@@ -189,4 +293,50 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     }
 }
 
+/****************************************************************************
+ * Name: lpwork_queue
+ *
+ * Description:
+ *   Queue work on the low priority work queue to be performed at the
+ *   requested priority.  The work will be performed before any pending work
+ *   of lower priority and the worker thread will run at (at least) the
+ *   requested priority while it performs the work.
+ *
+ * Input parameters:
+ *   work    - The work structure to queue
+ *   worker  - The worker callback to be invoked.  The callback will invoked
+ *             on the worker thread of execution.
+ *   arg     - The argument that will be passed to the worker callback when
+ *             it is invoked.
+ *   delay   - Delay (in clock ticks) from the time queue until the worker
+ *             is invoked. Zero means to perform the work immediately.
+ *   reqprio - Requested priority of the work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+int lpwork_queue(FAR struct work_s *work, worker_t worker, FAR void *arg,
+                 systime_t delay, uint8_t reqprio)
+{
+  /* Clip to the configured range of worker thread priorities */
+
+  if (reqprio < CONFIG_SCHED_LPWORKPRIORITY)
+    {
+      reqprio = CONFIG_SCHED_LPWORKPRIORITY;
+    }
+  else if (reqprio > CONFIG_SCHED_LPWORKPRIOMAX)
+    {
+      reqprio = CONFIG_SCHED_LPWORKPRIOMAX;
+    }
+
+  /* Queue the work in priority order and wake up a worker thread */
+
+  lpwork_qqueue(work, worker, arg, delay, reqprio);
+  return work_signal(LPWORK);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
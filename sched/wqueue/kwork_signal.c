@@ -42,6 +42,8 @@
 #include <signal.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
 #include <nuttx/wqueue.h>
 
 #include "wqueue/wqueue.h"
@@ -60,6 +62,12 @@
  *   is used internally by the work logic but could also be used by the
  *   user to force an immediate re-assessment of pending work.
  *
+ *   Only a worker thread that is waiting is signalled.  A busy worker
+ *   thread always examines the work queue again before it waits.  The
+ *   signalled worker thread is marked busy immediately so that a burst of
+ *   work queued (for example, from interrupt handlers) before it runs
+ *   results in a single signal.
+ *
  * Input parameters:
  *   qid    - The work queue ID
  *
@@ -70,15 +78,34 @@
 
 int work_signal(int qid)
 {
+  FAR struct kworker_s *worker;
+  irqstate_t flags;
   pid_t pid;
   int ret;
 
-  /* Get the process ID of the worker thread */
+  flags = enter_critical_section();
+
+  /* Select the worker thread */
 
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      pid = g_hpwork.worker[0].pid;
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      int i;
+
+      /* Prefer the worker thread of this CPU.  If it is busy, then wake up
+       * an idle worker thread on another CPU.  That worker thread will take
+       * over the ready work (see work_hpsteal()).
+       */
+
+      worker = &g_hpwork[up_cpu_index()].worker[0];
+      for (i = 0; worker->busy && i < HPWORK_NQUEUES; i++)
+        {
+          worker = &g_hpwork[i].worker[0];
+        }
+#else
+      worker = &g_hpwork[0].worker[0];
+#endif
     }
   else
 #endif
@@ -105,19 +132,35 @@ int work_signal(int qid)
 
       if (i >= CONFIG_SCHED_LPNTHREADS)
         {
+          leave_critical_section(flags);
           return OK;
         }
 
       /* Otherwise, signal the first IDLE thread found */
 
-      pid = g_lpwork.worker[i].pid;
+      worker = &g_lpwork.worker[i];
     }
   else
 #endif
     {
+      leave_critical_section(flags);
       return -EINVAL;
     }
 
+  /* There is nothing to do if the worker thread is busy or has already
+   * been signalled.
+   */
+
+  if (worker->busy)
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  worker->busy = true;
+  pid          = worker->pid;
+  leave_critical_section(flags);
+
   /* Signal the worker thread */
 
   ret = kill(pid, SIGWORK);
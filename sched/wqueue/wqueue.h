@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <queue.h>
 
@@ -59,6 +60,16 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The number of high priority work queues.  With CONFIG_SCHED_HPWORK_PERCPU
+ * there is one queue (and one worker thread) for each CPU.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define HPWORK_NQUEUES CONFIG_SMP_NCPUS
+#else
+#  define HPWORK_NQUEUES 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -113,9 +124,9 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
 
-extern struct hp_wqueue_s g_hpwork;
+extern struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -166,6 +177,43 @@ int work_hpstart(void);
 int work_lpstart(void);
 #endif
 
+/****************************************************************************
+ * Name: work_hpqueue
+ *
+ * Description:
+ *   Return the per-CPU high priority work queue that holds the queued work.
+ *
+ * Input parameters:
+ *   work - The queued work structure
+ *
+ * Returned Value:
+ *   The work queue that may be used to remove the work
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+FAR struct kwork_wqueue_s *work_hpqueue(FAR struct work_s *work);
+#endif
+
+/****************************************************************************
+ * Name: work_hpsteal
+ *
+ * Description:
+ *   Move work that is ready to execute from the per-CPU high priority work
+ *   queues with busy worker threads to the queue of the indicated CPU.
+ *
+ * Input parameters:
+ *   cpu - The index of the CPU whose worker thread will perform the work
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+void work_hpsteal(int cpu);
+#endif
+
 /****************************************************************************
  * Name: work_process
  *
@@ -187,5 +235,45 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx);
 
+/****************************************************************************
+ * Name: lpwork_boostpriority
+ *
+ * Description:
+ *   Called by a low-priority worker thread just before it performs a work
+ *   item to assure that its priority is at least at the priority requested
+ *   for the work item, reqprio.
+ *
+ * Parameters:
+ *   reqprio - Requested minimum worker thread priority
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+void lpwork_boostpriority(uint8_t reqprio);
+#endif
+
+/****************************************************************************
+ * Name: lpwork_restorepriority
+ *
+ * Description:
+ *   Called by a low-priority worker thread when it has completed a work
+ *   item to drop the priority boost applied by lpwork_boostpriority().
+ *
+ * Parameters:
+ *   reqprio - Previously requested minimum worker thread priority to be
+ *     "unboosted"
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_PRIORITY_INHERITANCE)
+void lpwork_restorepriority(uint8_t reqprio);
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
 #endif /* __SCHED_WQUEUE_WQUEUE_H */
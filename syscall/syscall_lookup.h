@@ -364,6 +364,12 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(sendto,                   6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,               5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                   3, STUB_socket)
+#  ifdef CONFIG_NET_MMSG
+  SYSCALL_LOOKUP(recvmsg,                  3, STUB_recvmsg)
+  SYSCALL_LOOKUP(recvmmsg,                 5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(sendmsg,                  3, STUB_sendmsg)
+  SYSCALL_LOOKUP(sendmmsg,                 4, STUB_sendmmsg)
+#  endif
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -379,6 +385,12 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(getrandom,               2, STUB_getrandom)
 #endif
 
+/* The following is defined only if batched I/O submission is enabled */
+
+#ifdef CONFIG_FS_IOBATCH
+  SYSCALL_LOOKUP(iobatch,                 2, STUB_iobatch)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
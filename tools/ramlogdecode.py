@@ -0,0 +1,216 @@
+#!/usr/bin/env python
+############################################################################
+# tools/ramlogdecode.py
+#
+#   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+#   Author: Gregory Nutt <gnutt@nuttx.org>
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name NuttX nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+# Decode a RAMLOG that was written with CONFIG_RAMLOG_BINARY.  Binary frames
+# are:
+#
+#   0xa5 <payload length> <payload>
+#
+# with the payload holding the microseconds since the previous frame, the
+# address of the format string and the arguments.  The format strings are
+# read from the ELF file of the firmware.  Anything outside of a frame is
+# plain text (emergency output, messages that could not be encoded) and is
+# copied through unchanged.
+#
+# Usage: ramlogdecode.py <nuttx ELF file> <RAMLOG dump>
+
+import re
+import struct
+import sys
+
+RAMLOG_SYNC = 0xa5
+
+SPEC = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l)?'
+                  r'([diouxXcfFeEgGps%])')
+
+class Elf:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+
+        self.is64 = self.data[4] == 2
+        self.endian = '<' if self.data[5] == 1 else '>'
+        self.longsize = 8 if self.is64 else 4
+
+        if self.is64:
+            phoff, = struct.unpack_from(self.endian + 'Q', self.data, 0x20)
+            phentsize, phnum = struct.unpack_from(self.endian + 'HH',
+                                                  self.data, 0x36)
+            phfmt = 'IIQQQQQQ'
+        else:
+            phoff, = struct.unpack_from(self.endian + 'I', self.data, 0x1c)
+            phentsize, phnum = struct.unpack_from(self.endian + 'HH',
+                                                  self.data, 0x2a)
+            phfmt = 'IIIIIIII'
+
+        # Keep the loaded segments:  (virtual address, file offset, size)
+
+        self.segments = []
+        for i in range(phnum):
+            ph = struct.unpack_from(self.endian + phfmt, self.data,
+                                    phoff + i * phentsize)
+            if self.is64:
+                ptype, offset, vaddr, filesz = ph[0], ph[2], ph[3], ph[5]
+            else:
+                ptype, offset, vaddr, filesz = ph[0], ph[1], ph[2], ph[4]
+
+            if ptype == 1:
+                self.segments.append((vaddr, offset, filesz))
+
+    def string(self, addr):
+        for vaddr, offset, filesz in self.segments:
+            if vaddr <= addr < vaddr + filesz:
+                start = offset + addr - vaddr
+                end = self.data.index(b'\0', start)
+                return self.data[start:end].decode('utf-8', 'replace')
+
+        return None
+
+def varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, pos
+
+def zigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+def decode(elf, payload):
+    delta, pos = varint(payload, 0)
+    msgid, pos = varint(payload, pos)
+    fmt = elf.string(msgid)
+    if fmt is None:
+        return delta, '<unknown message 0x%x>\n' % msgid
+
+    out = ''
+    last = 0
+    for m in SPEC.finditer(fmt):
+        flags, width, prec, length, conv = m.groups()
+        out += fmt[last:m.start()]
+        last = m.end()
+
+        if conv == '%':
+            out += '%'
+            continue
+
+        # Width and precision given as arguments come first
+
+        if width == '*':
+            value, pos = varint(payload, pos)
+            width = str(zigzag(value))
+        if prec == '*':
+            value, pos = varint(payload, pos)
+            prec = str(zigzag(value))
+
+        spec = '%' + flags + (width or '')
+        if prec is not None:
+            spec += '.' + prec
+
+        if conv == 's':
+            end = payload.index(b'\0', pos)
+            arg = payload[pos:end].decode('utf-8', 'replace')
+            pos = end + 1
+        elif conv in 'fFeEgG':
+            arg, = struct.unpack_from('<d', payload, pos)
+            pos += 8
+        elif conv == 'p':
+            arg, pos = varint(payload, pos)
+            spec += 'x'
+            out += '0x'
+            conv = ''
+        else:
+            value, pos = varint(payload, pos)
+            arg = zigzag(value)
+            if conv in 'ouxX':
+                bits = 64 if length == 'll' else \
+                       elf.longsize * 8 if length == 'l' else 32
+                arg &= (1 << bits) - 1
+            elif conv == 'c':
+                arg = chr(arg & 0xff)
+
+        out += (spec + conv.replace('u', 'd')) % arg
+
+    return delta, out + fmt[last:]
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write('Usage: %s <nuttx ELF file> <RAMLOG dump>\n' %
+                         sys.argv[0])
+        sys.exit(1)
+
+    elf = Elf(sys.argv[1])
+    with open(sys.argv[2], 'rb') as f:
+        buf = bytearray(f.read())
+
+    now = 0
+    pos = 0
+    text = bytearray()
+    while pos < len(buf):
+        if buf[pos] == RAMLOG_SYNC and pos + 1 < len(buf) and \
+           pos + 2 + buf[pos + 1] <= len(buf):
+            payload = buf[pos + 2:pos + 2 + buf[pos + 1]]
+            try:
+                delta, msg = decode(elf, payload)
+            except (IndexError, ValueError, TypeError):
+                # Not a frame after all:  Re-synchronize on the next byte
+
+                text.append(buf[pos])
+                pos += 1
+                continue
+
+            sys.stdout.write(text.decode('utf-8', 'replace'))
+            text = bytearray()
+
+            now += delta
+            sys.stdout.write('[%6d.%06d] %s' %
+                             (now // 1000000, now % 1000000, msg))
+            pos += 2 + buf[pos + 1]
+        else:
+            text.append(buf[pos])
+            pos += 1
+
+    sys.stdout.write(text.decode('utf-8', 'replace'))
+
+if __name__ == '__main__':
+    main()
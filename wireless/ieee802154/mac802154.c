@@ -103,6 +103,107 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mac802154_indirect_hash
+ *
+ * Description:
+ *   Return the index of the indirect transaction hash chain for a
+ *   destination address.
+ *
+ ****************************************************************************/
+
+static unsigned int
+mac802154_indirect_hash(FAR const struct ieee802154_addr_s *addr)
+{
+  FAR const uint8_t *ptr;
+  unsigned int hash;
+  int len;
+
+  if (addr->mode == IEEE802154_ADDRMODE_SHORT)
+    {
+      ptr = addr->saddr;
+      len = IEEE802154_SADDRSIZE;
+    }
+  else
+    {
+      ptr = addr->eaddr;
+      len = IEEE802154_EADDRSIZE;
+    }
+
+  for (hash = 0; len > 0; len--)
+    {
+      hash = hash * 31 + *ptr++;
+    }
+
+  return hash & (CONFIG_MAC802154_INDIRECT_HASHSIZE - 1);
+}
+
+/****************************************************************************
+ * Name: mac802154_indirect_match
+ *
+ * Description:
+ *   Return true if an indirect transaction is destined for the device with
+ *   the provided address.
+ *
+ ****************************************************************************/
+
+static bool
+mac802154_indirect_match(FAR const struct ieee802154_txdesc_s *txdesc,
+                         FAR const struct ieee802154_addr_s *addr)
+{
+  if (txdesc->destaddr.mode != addr->mode)
+    {
+      return false;
+    }
+
+  if (addr->mode == IEEE802154_ADDRMODE_SHORT)
+    {
+      return IEEE802154_SADDRCMP(txdesc->destaddr.saddr, addr->saddr);
+    }
+  else if (addr->mode == IEEE802154_ADDRMODE_EXTENDED)
+    {
+      return IEEE802154_EADDRCMP(txdesc->destaddr.eaddr, addr->eaddr);
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mac802154_findindirect
+ *
+ * Description:
+ *   Find the oldest indirect transaction destined for the device with the
+ *   provided address.
+ *
+ * Assumptions:
+ *   Called with the MAC locked
+ *
+ ****************************************************************************/
+
+static FAR struct ieee802154_txdesc_s *
+mac802154_findindirect(FAR struct ieee802154_privmac_s *priv,
+                       FAR const struct ieee802154_addr_s *addr)
+{
+  FAR struct ieee802154_txdesc_s *txdesc;
+  FAR struct ieee802154_txdesc_s *found = NULL;
+
+  /* Transactions are added at the head of each hash chain and so the
+   * oldest matching transaction is the last one in the chain.
+   */
+
+  for (txdesc = priv->indirect_hash[mac802154_indirect_hash(addr)];
+       txdesc != NULL;
+       txdesc = txdesc->hlink)
+    {
+      if (mac802154_indirect_match(txdesc, addr))
+        {
+          found = txdesc;
+        }
+    }
+
+  return found;
+}
+
 /****************************************************************************
  * Name: mac802154_resetqueues
  *
@@ -117,11 +218,17 @@ static void mac802154_resetqueues(FAR struct ieee802154_privmac_s *priv)
   int i;
 
   sq_init(&priv->txdone_queue);
+  sq_init(&priv->csma_cmdqueue);
   sq_init(&priv->csma_queue);
   sq_init(&priv->gts_queue);
-  sq_init(&priv->indirect_queue);
+  dq_init(&priv->indirect_queue);
   sq_init(&priv->dataind_queue);
 
+  for (i = 0; i < CONFIG_MAC802154_INDIRECT_HASHSIZE; i++)
+    {
+      priv->indirect_hash[i] = NULL;
+    }
+
   /* Initialize the tx descriptor allocation pool */
 
   sq_init(&priv->txdesc_queue);
@@ -470,7 +577,7 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
 
   pendaddrspec_ind = beacon->bf_len++;
 
-  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
+  txdesc = (FAR struct ieee802154_txdesc_s *)dq_peek(&priv->indirect_queue);
 
   while(txdesc != NULL)
     {
@@ -496,7 +603,7 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
 
       /* Get the next pending indirect transation */
 
-      txdesc = (FAR struct ieee802154_txdesc_s *)sq_next((FAR sq_entry_t *)txdesc);
+      txdesc = (FAR struct ieee802154_txdesc_s *)dq_next((FAR dq_entry_t *)txdesc);
     }
 
   /* At this point, we know how many of each transaction we have, we can setup
@@ -531,12 +638,19 @@ void mac802154_updatebeacon(FAR struct ieee802154_privmac_s *priv)
 void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
                              FAR struct ieee802154_txdesc_s *txdesc)
 {
+  FAR struct ieee802154_txdesc_s **head;
   uint32_t ticks;
   uint32_t symbols;
 
-  /* Link the tx descriptor into the list */
+  /* Link the tx descriptor into the list and into the hash chain for its
+   * destination address.
+   */
+
+  dq_addlast((FAR dq_entry_t *)txdesc, &priv->indirect_queue);
 
-  sq_addlast((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+  head          = &priv->indirect_hash[mac802154_indirect_hash(&txdesc->destaddr)];
+  txdesc->hlink = *head;
+  *head         = txdesc;
 
   /* Update the timestamp for purging the transaction */
 
@@ -583,6 +697,38 @@ void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
     }
 }
 
+/****************************************************************************
+ * Name: mac802154_remindirect
+ *
+ * Description:
+ *    Remove a transaction from the indirect list and from its hash chain.
+ *
+ * Assumptions:
+ *    Called with the MAC locked
+ *
+ ****************************************************************************/
+
+void mac802154_remindirect(FAR struct ieee802154_privmac_s *priv,
+                           FAR struct ieee802154_txdesc_s *txdesc)
+{
+  FAR struct ieee802154_txdesc_s **curr;
+
+  dq_rem((FAR dq_entry_t *)txdesc, &priv->indirect_queue);
+
+  for (curr = &priv->indirect_hash[mac802154_indirect_hash(&txdesc->destaddr)];
+       *curr != NULL;
+       curr = &(*curr)->hlink)
+    {
+      if (*curr == txdesc)
+        {
+          *curr = txdesc->hlink;
+          break;
+        }
+    }
+
+  txdesc->hlink = NULL;
+}
+
 /****************************************************************************
  * Name: mac802154_purge_worker
  *
@@ -613,7 +759,7 @@ static void mac802154_purge_worker(FAR void *arg)
      * passed.
      */
 
-    txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
+    txdesc = (FAR struct ieee802154_txdesc_s *)dq_peek(&priv->indirect_queue);
 
     if (txdesc == NULL)
       {
@@ -629,7 +775,7 @@ static void mac802154_purge_worker(FAR void *arg)
       {
         /* Unlink the transaction */
 
-        sq_remfirst(&priv->indirect_queue);
+        mac802154_remindirect(priv, txdesc);
 
         /* Free the IOB, the notification, and the tx descriptor */
 
@@ -687,9 +833,15 @@ static int mac802154_radiopoll(FAR const struct ieee802154_radiocb_s *radiocb,
     }
   else
     {
-      /* Check to see if there are any CSMA transactions waiting */
+      /* Check to see if there are any CSMA transactions waiting.  MAC
+       * command frames take precedence over data frames.
+       */
 
-      *txdesc = (FAR struct ieee802154_txdesc_s *)sq_remfirst(&priv->csma_queue);
+      *txdesc = (FAR struct ieee802154_txdesc_s *)sq_remfirst(&priv->csma_cmdqueue);
+      if (*txdesc == NULL)
+        {
+          *txdesc = (FAR struct ieee802154_txdesc_s *)sq_remfirst(&priv->csma_queue);
+        }
     }
 
   mac802154_unlock(priv)
@@ -731,6 +883,24 @@ static void mac802154_txdone(FAR const struct ieee802154_radiocb_s *radiocb,
 
   mac802154_lock(priv, false);
 
+#ifdef CONFIG_MAC802154_SWRETRY
+  /* If the frame was not acknowledged and retries remain, resend it ahead
+   * of any other queued transactions.  The frame keeps its sequence number.
+   */
+
+  if (txdesc->conf->status == IEEE802154_STATUS_NO_ACK &&
+      txdesc->retrycount > 0)
+    {
+      txdesc->retrycount--;
+      sq_addfirst((FAR sq_entry_t *)txdesc, &priv->csma_cmdqueue);
+      mac802154_unlock(priv)
+
+      wlinfo("Retrying frame, %u retries remain\n", txdesc->retrycount);
+      priv->radio->txnotify(priv->radio, false);
+      return;
+    }
+#endif
+
   sq_addlast((FAR sq_entry_t *)txdesc, &priv->txdone_queue);
 
   mac802154_unlock(priv)
@@ -1351,60 +1521,38 @@ static void mac802154_rxdatareq(FAR struct ieee802154_privmac_s *priv,
    * need to check for this condition.
    */
 
-  txdesc = (FAR struct ieee802154_txdesc_s *)sq_peek(&priv->indirect_queue);
-
-  while(txdesc != NULL)
+  txdesc = mac802154_findindirect(priv, &ind->src);
+  if (txdesc != NULL)
     {
-      if (txdesc->destaddr.mode == ind->src.mode)
-        {
-          if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_SHORT)
-            {
-              if (IEEE802154_SADDRCMP(txdesc->destaddr.saddr, ind->src.saddr))
-                {
-                  /* Remove the transaction from the queue */
-
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+      /* Remove the transaction from the queue */
 
-                  /* NOTE: We don't do anything with the purge timeout, because
-                   * we really don't need to. As of now, I see no disadvantage
-                   * to just letting the timeout expire, which won't purge the
-                   * transaction since it is no longer on the list, and then it
-                   * will reschedule the next timeout appropriately. The logic
-                   * otherwise may get complicated even though it may save a few
-                   * clock cycles.
-                   */
-
-                  /* The addresses match, send the transaction immediately */
-
-                  priv->radio->txdelayed(priv->radio, txdesc, 0);
-                  priv->beaconupdate = true;
-                  mac802154_unlock(priv)
-                  return;
-                }
-            }
-          else if (txdesc->destaddr.mode == IEEE802154_ADDRMODE_EXTENDED)
-            {
-              if (IEEE802154_EADDRCMP(txdesc->destaddr.eaddr, ind->src.eaddr))
-                {
-                  /* Remove the transaction from the queue */
+      mac802154_remindirect(priv, txdesc);
 
-                  sq_rem((FAR sq_entry_t *)txdesc, &priv->indirect_queue);
+      /* NOTE: We don't do anything with the purge timeout, because we
+       * really don't need to. As of now, I see no disadvantage to just
+       * letting the timeout expire, which won't purge the transaction since
+       * it is no longer on the list, and then it will reschedule the next
+       * timeout appropriately. The logic otherwise may get complicated even
+       * though it may save a few clock cycles.
+       */
 
-                  /* The addresses match, send the transaction immediately */
+      /* If more transactions are waiting for the same device, set the Frame
+       * Pending field so that the device requests them without waiting for
+       * the next beacon or poll.
+       */
 
-                  priv->radio->txdelayed(priv->radio, txdesc, 0);
-                  priv->beaconupdate = true;
-                  mac802154_unlock(priv)
-                  return;
-                }
-            }
-          else
-            {
-              DEBUGASSERT(false);
-            }
+      if (mac802154_findindirect(priv, &ind->src) != NULL)
+        {
+          frame_ctrl   = (FAR uint16_t *)&txdesc->frame->io_data[0];
+          *frame_ctrl |= IEEE802154_FRAMECTRL_PEND;
         }
 
-      txdesc = (FAR struct ieee802154_txdesc_s *)sq_next((FAR sq_entry_t *)txdesc);
+      /* The addresses match, send the transaction immediately */
+
+      priv->radio->txdelayed(priv->radio, txdesc, 0);
+      priv->beaconupdate = true;
+      mac802154_unlock(priv)
+      return;
     }
 
   /* If there is no data frame pending for the requesting device, the coordinator
@@ -1810,7 +1958,7 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
 
           /* Link the transaction into the CSMA transaction list */
 
-          sq_addlast((FAR sq_entry_t *)respdesc, &priv->csma_queue);
+          mac802154_csmaqueue(priv, respdesc);
 
           /* Notify the radio driver that there is data available */
 
@@ -1873,7 +2021,7 @@ static void mac802154_rxbeaconframe(FAR struct ieee802154_privmac_s *priv,
 
                   /* Link the transaction into the CSMA transaction list */
 
-                  sq_addlast((FAR sq_entry_t *)respdesc, &priv->csma_queue);
+                  mac802154_csmaqueue(priv, respdesc);
 
                   /* Notify the radio driver that there is data available */
 
@@ -97,6 +97,17 @@
 #  define CONFIG_MAC802154_NTXDESC 3
 #endif
 
+#if !defined(CONFIG_MAC802154_INDIRECT_HASHSIZE) || \
+    CONFIG_MAC802154_INDIRECT_HASHSIZE <= 0
+#  undef CONFIG_MAC802154_INDIRECT_HASHSIZE
+#  define CONFIG_MAC802154_INDIRECT_HASHSIZE 16
+#endif
+
+#if (CONFIG_MAC802154_INDIRECT_HASHSIZE & \
+    (CONFIG_MAC802154_INDIRECT_HASHSIZE - 1)) != 0
+#  error CONFIG_MAC802154_INDIRECT_HASHSIZE must be a power of two
+#endif
+
 #if CONFIG_MAC802154_NTXDESC > CONFIG_MAC802154_NNOTIF
 #  error CONFIG_MAC802154_NNOTIF must be greater than CONFIG_MAC802154_NTXDESC
 #endif
@@ -200,9 +211,11 @@ struct ieee802154_privmac_s
   /* Support a singly linked list of transactions that will be sent using the
    * CSMA algorithm.  On a non-beacon enabled PAN, these transactions will be
    * sent whenever. On a beacon-enabled PAN, these transactions will be sent
-   * during the CAP of the Coordinator's superframe.
+   * during the CAP of the Coordinator's superframe.  MAC command frames are
+   * held in a separate list and are sent before any data frames.
    */
 
+  sq_queue_t csma_cmdqueue;
   sq_queue_t csma_queue;
   sq_queue_t gts_queue;
 
@@ -212,9 +225,16 @@ struct ieee802154_privmac_s
    * device sending a Data Request MAC command or if too much time passes. This
    * list should also be used to populate the address list of the outgoing
    * beacon frame.
+   *
+   * The list is kept in the order that the transactions are to be purged.
+   * The same transactions are also chained in a hash table indexed by the
+   * destination address so that the transactions for a requesting device
+   * can be found without searching the list.
    */
 
-  sq_queue_t indirect_queue;
+  dq_queue_t indirect_queue;
+  FAR struct ieee802154_txdesc_s *
+    indirect_hash[CONFIG_MAC802154_INDIRECT_HASHSIZE];
 
   /* Support a singly linked list of frames received */
 
@@ -361,6 +381,8 @@ int mac802154_txdesc_alloc(FAR struct ieee802154_privmac_s *priv,
 
 void mac802154_setupindirect(FAR struct ieee802154_privmac_s *priv,
                              FAR struct ieee802154_txdesc_s *txdesc);
+void mac802154_remindirect(FAR struct ieee802154_privmac_s *priv,
+                           FAR struct ieee802154_txdesc_s *txdesc);
 
 void mac802154_createdatareq(FAR struct ieee802154_privmac_s *priv,
                              FAR struct ieee802154_addr_s *coordaddr,
@@ -614,6 +636,32 @@ static inline void mac802154_txdesc_free(FAR struct ieee802154_privmac_s *priv,
   mac802154_givesem(&priv->txdesc_sem);
 }
 
+/****************************************************************************
+ * Name: mac802154_csmaqueue
+ *
+ * Description:
+ *   Link a transaction into the CSMA transaction list.  MAC command frames
+ *   are linked into a list that is sent before any data frames so that
+ *   management operations are not delayed by queued data.
+ *
+ * Assumptions:
+ *   priv MAC struct is locked when calling.
+ *
+ ****************************************************************************/
+
+static inline void mac802154_csmaqueue(FAR struct ieee802154_privmac_s *priv,
+                                       FAR struct ieee802154_txdesc_s *txdesc)
+{
+  if (txdesc->frametype == IEEE802154_FRAME_COMMAND)
+    {
+      sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_cmdqueue);
+    }
+  else
+    {
+      sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+    }
+}
+
 /****************************************************************************
  * Name: mac802154_symtoticks
  *
@@ -156,7 +156,7 @@ int mac802154_req_poll(MACHANDLE mac, FAR struct ieee802154_poll_req_s *req)
 
   /* Link the transaction into the CSMA transaction list */
 
-  sq_addlast((FAR sq_entry_t *)txdesc, &priv->csma_queue);
+  mac802154_csmaqueue(priv, txdesc);
 
   /* We no longer need to have the MAC layer locked. */
 